@@ -27,4 +27,10 @@
 
 void feedforward(network *);
 
+/*
+ * neuron_discriminant:
+ * - combine the n input values x[] of a neuron with its weights w[]
+ */
+double neuron_discriminant(enum discriminant_function, unsigned int, const double *, const double *);
+
 #endif
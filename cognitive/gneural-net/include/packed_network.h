@@ -0,0 +1,94 @@
+/* packed_network.h -- This belongs to gneural_network
+
+   gneural_network is the GNU package which implements a programmable neural network.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PACKED_NETWORK_H
+#define PACKED_NETWORK_H
+
+#include <network.h>
+
+typedef struct _packed_layer {
+ unsigned int first;		/* global id of the first neuron of the layer */
+ unsigned int num_of_neurons;
+ // a dense layer has only LINEAR neurons which all read the same
+ // run of neurons, so that its weights are a row-major matrix
+ unsigned char dense;
+ unsigned int input_first;	/* dense only: global id of the first input */
+ unsigned int num_input;	/* dense only: inputs of each neuron */
+} packed_layer;
+
+typedef struct _packed_network {
+ unsigned int num_of_neurons;
+ unsigned int num_of_layers;
+ unsigned int num_of_weights;
+ unsigned int max_input;	/* most inputs of any neuron */
+ packed_layer *layers;
+ // the weights of neuron i are weights[weight_offset[i]] on, in the
+ // same order the training algorithms number them
+ unsigned int *weight_offset;	/* num_of_neurons + 1 entries */
+ unsigned int *input_id;	/* global id of the input of each weight */
+ enum activation_function *activation;
+ enum discriminant_function *discriminant;
+ double *weights;		/* the network's own, for packed_network_error */
+} packed_network;
+
+/*
+ * packed_network_alloc:
+ * - pack the topology of a (checked) network into arrays, for evaluating
+ *   it with any set of weights
+ */
+packed_network *packed_network_alloc(network *);
+/*
+ * packed_network_free:
+ * - free a packed_network object
+ */
+void packed_network_free(packed_network *);
+
+/*
+ * packed_network_get_weights:
+ * - copy the weights of the network into a flat array
+ */
+void packed_network_get_weights(const packed_network *, network *, double *);
+/*
+ * packed_network_set_weights:
+ * - copy a flat array of weights into the network
+ */
+void packed_network_set_weights(const packed_network *, network *, const double *);
+
+/*
+ * packed_feedforward:
+ * - propagate the outputs of the input layer, in output[], with the
+ *   given flat weights; output[] has a slot for every neuron
+ */
+void packed_feedforward(const packed_network *, const double *, double *);
+
+/*
+ * packed_error:
+ * - the error of the given flat weights over the training points, as
+ *   error() computes it; safe to call from several threads at once
+ */
+double packed_error(const packed_network *, const double *, network_config *);
+/*
+ * packed_network_error:
+ * - the error of the weights the network has now
+ */
+double packed_network_error(packed_network *, network *, network_config *);
+
+#endif
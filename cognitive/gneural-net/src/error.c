@@ -23,73 +23,12 @@
 // compute the specified error of a (training) neural network
 
 #include <error.h>
-#include <math.h>
-#include <feedforward.h>
+#include <packed_network.h>
 
 double error(network *nn, network_config *config){
- int n;
- double err;
- double y;
+ packed_network *pn = packed_network_alloc(nn);
+ double err = packed_network_error(pn, nn, config);
 
- err = 0.;
-
- switch (config->error_type) {
- // L1 norm
- case L1:
-   err = -1.e8;
-   for (n = 0; n < config->num_points; n++) {
-    int i, j;
-    // assign training input
-    for (i = 0; i < nn->layers[0].num_of_neurons; i++) {
-     neuron *ne = &nn->layers[0].neurons[i];
-#if 1
-     ne->output = config->points_x[n][ne->global_id][0];
-#else
-     for (j = 0; j < ne->num_input; j++) 
-      ne->output = config->points_x[n][i][j];
-#endif
-    }
-    feedforward(nn);
-    // compute the L1 error comparing with training output
-    double tmp = 0.;
-    for (j = 0; j < nn->layers[nn->num_of_layers-1].num_of_neurons; j++){
-     neuron *ne = &nn->layers[nn->num_of_layers-1].neurons[j];
-     y = ne->output;
-     tmp += fabs(y-config->points_y[n][ne->global_id]);
-    }
-    err += tmp;
-   }
-   return err;
-
-   break;
-  // L2 norm
-  case L2:
-   for (n = 0; n < config->num_points; n++){
-    int i, j;
-    // assign training input
-    for (i = 0; i < nn->layers[0].num_of_neurons; i++){
-     neuron *ne = &nn->layers[0].neurons[i];
-#if 1
-     ne->output = config->points_x[n][ne->global_id][0];
-#else
-     for (j = 0; j < ne->num_input; j++)
-      ne->output = config->points_x[n][i][j];
-#endif
-    }
-    feedforward(nn);
-    // compute the L2 error comparing with the training output
-    double tmp = 0.;
-    for (j = 0; j < nn->layers[nn->num_of_layers-1].num_of_neurons; j++){
-     neuron *ne = &nn->layers[nn->num_of_layers-1].neurons[j];
-     y = ne->output;;
-     tmp += pow(y - config->points_y[n][ne->global_id], 2);
-    }
-    err += tmp;
-   }
-   return sqrt(err);
-   break;
-  default:
-   return 0.;
-   break;
- }
+ packed_network_free(pn);
+ return err;
 }
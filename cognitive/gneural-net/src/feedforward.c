@@ -32,8 +32,48 @@
 
 #define PI M_PI
 
-void feedforward(network *nn){
+double neuron_discriminant(enum discriminant_function type, unsigned int num_input, const double *x, const double *w){
  int i,j;
+ double sum = 0.;
+ double tmp;
+
+ switch (type) {
+  case LINEAR:
+   for (i = 0; i < num_input; i++)
+    sum += x[i] * w[i]; // linear product between w[] and x[]
+   break;
+  case LEGENDRE:
+   for (i = 0; i < num_input; i++) {
+    for (tmp = 0., j = 0;j <= i; j++)
+     tmp += pow(x[i],j)*binom(i,j)*binom((i+j-1)/2,j);
+    tmp *= pow(2, i) * w[i];
+    sum+=tmp;
+   }
+   break;
+  case LAGUERRE:
+   for (i = 0; i < num_input; i++) {
+    for (tmp = 0., j = 0;j <= i;j++)
+     tmp += binom(i,j) * pow(x[i], j)*pow(-1,j)/fact(j);
+    tmp *= w[i];
+    sum += tmp;
+   }
+   break;
+  case FOURIER:
+   for (i = 0; i < num_input; i++) {
+    for(tmp = 0., j = 0;j <= i; j++)
+     tmp += sin(2. * j *PI *x[i]);
+    tmp *= w[i];
+    sum += tmp;
+   }
+   break;
+  default:
+   break;
+ }
+ return sum;
+}
+
+void feedforward(network *nn){
+ int i;
  int l,n;
 
  /*
@@ -47,44 +87,14 @@ void feedforward(network *nn){
 
    neuron *ne = &nn->layers[l].neurons[n];
 
-   double x = 0.;
-   double a, tmp;
+   double x[ne->num_input + 1];
 
    /* fmv no more required */
    //for (i=0;i<NEURON[id].nw;i++) NEURON[id].x[i]=NEURON[NEURON[id].connection[i]].output;
-   switch (ne->discriminant) {
-    case LINEAR:
-     for (i = 0; i < ne->num_input; i++)
-      x += ne->connection[i]->output * ne->w[i]; // linear product between w[] and x[]
-     break;
-    case LEGENDRE:
-     for (i = 0; i < ne->num_input; i++) {
-      for (tmp = 0., j = 0;j <= i; j++)
-       	tmp += pow(ne->connection[i]->output,j)*binom(i,j)*binom((i+j-1)/2,j);
-      tmp *= pow(2, i) * ne->w[i];
-      x+=tmp;
-     }
-     break;
-    case LAGUERRE:
-     for (i = 0; i < ne->num_input; i++) {
-      for (tmp = 0., j = 0;j <= i;j++)
-	tmp += binom(i,j) * pow(ne->connection[i]->output, j)*pow(-1,j)/fact(j);
-      tmp *= ne->w[i];
-      x += tmp;
-     }
-     break;
-    case FOURIER:
-     for (i = 0; i < ne->num_input; i++) {
-      for(tmp = 0., j = 0;j <= i; j++)
-	tmp += sin(2. * j *PI *ne->connection[i]->output);
-      tmp *= ne->w[i];
-      x += tmp;
-     }
-     break;
-    default:
-     break;
-   }
-   ne->output = activation(ne->activation, x);
+   for (i = 0; i < ne->num_input; i++)
+    x[i] = ne->connection[i]->output;
+   ne->output = activation(ne->activation,
+		neuron_discriminant(ne->discriminant, ne->num_input, x, ne->w));
   }
  }
 }
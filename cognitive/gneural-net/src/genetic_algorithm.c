@@ -28,7 +28,7 @@
 // drastically improved by  : Nan
 
 #include <genetic_algorithm.h>
-#include <error.h>
+#include <packed_network.h>
 #include <rnd.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -186,25 +186,15 @@ static void reproduce_next_generation(
 }
 
 static void selection(
-    network *nn,
+    packed_network *pn,
     network_config *config,
     individual_t** individuals,int size){
  int pool_size=size*size;
  int n;
- #pragma omp parallel for shared(individuals,nn,config) private(n)
- for (n = 0; n < pool_size; ++n) {
-  #pragma omp critical
-  {
-   int i, j, k;
-   /* for each neuron */
-   for (k = 0, i = 0; i < nn->num_of_neurons; i++)
-    /* for each input...*/
-    for (j = 0; j < nn->neurons[i].num_input; j++, ++k)
-     nn->neurons[i].w[j] = individuals[n]->weights[k];
-
-   individuals[n]->error = error(nn, config);
-  }
- }
+ /* the weights of an individual are already in the packed order */
+ #pragma omp parallel for shared(individuals,pn,config) private(n)
+ for (n = 0; n < pool_size; ++n)
+  individuals[n]->error = packed_error(pn, individuals[n]->weights, config);
  par_qsort(individuals,pool_size,sizeof(individual_t*),individual_compare);
 // qsort(individuals, pool_size, sizeof(individual_t*), individual_compare);
 }
@@ -241,11 +231,13 @@ void genetic_algorithm(network *nn, network_config *config) {
  int weight_cout = actual_weight_count(nn);
  init_individuals(weight_cout, individuals, npop);
 
+ packed_network *pn = packed_network_alloc(nn);
+
  for (n = 0; n < nmax; ++n) {
 
   reproduce_next_generation(config, individuals,npop,weight_cout,rate);
 
-  selection(nn, config, individuals,npop);
+  selection(pn, config, individuals,npop);
 
   if (output == ON)
     printf("GA2: %d %.12g\n", n, individuals[0]->error);
@@ -262,6 +254,7 @@ void genetic_algorithm(network *nn, network_config *config) {
   for (j = 0; j < nn->neurons[i].num_input; j++, ++k)
    nn->neurons[i].w[j] = individuals[0]->weights[k];
 
+ packed_network_free(pn);
  for (i = 0; i < pool_size; ++i) {
   free(individuals[i]->weights);
   free(individuals[i]);
@@ -25,7 +25,7 @@
 // performs a gradient descent search of the best weights during the training process
 
 #include <gradient_descent.h>
-#include <error.h>
+#include <packed_network.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -41,6 +41,7 @@ void gradient_descent(network *nn, network_config *config) {
  double err;
  double *wbackup;
  double *diff;
+ packed_network *pn;
 
  wbackup = malloc((nn->num_of_neurons*MAX_IN+1)*sizeof(*wbackup));
  if (wbackup == NULL) {
@@ -55,6 +56,7 @@ void gradient_descent(network *nn, network_config *config) {
  }
 
 
+ pn = packed_network_alloc(nn);
  err = 1.e8; // just a big number
  delta = (config->wmax - config->wmin) / nxw;
 
@@ -71,9 +73,9 @@ void gradient_descent(network *nn, network_config *config) {
   for (k = 0, i = 0; i < nn->num_of_neurons; i++)
    for (j = 0; j < nn->neurons[i].num_input; ++j, ++k) {
     nn->neurons[i].w[j] = wbackup[k] - delta;
-    err_minus = error(nn, config);
+    err_minus = packed_network_error(pn, nn, config);
     nn->neurons[i].w[j] = wbackup[k] + delta;
-    err_plus = error(nn, config);
+    err_plus = packed_network_error(pn, nn, config);
     diff[k] = 0.5 * (err_plus - err_minus) / delta;
    }
 
@@ -83,7 +85,7 @@ void gradient_descent(network *nn, network_config *config) {
     nn->neurons[i].w[j] = wbackup[k] - gamma * diff[k];
 
   // updates the error of the NN
-  err = error(nn, config);
+  err = packed_network_error(pn, nn, config);
   if (output == ON)
     printf("GD: %d %g\n", n, err);
  }
@@ -91,4 +93,5 @@ void gradient_descent(network *nn, network_config *config) {
    printf("\n");
  free(wbackup);
  free(diff);
+ packed_network_free(pn);
 }
@@ -25,9 +25,10 @@
 // perform a modified version of the multi-scale Monte Carlo optimization to train the network
 
 #include <msmco.h>
-#include <error.h>
+#include <packed_network.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include <rnd.h>
 
@@ -36,11 +37,12 @@ void msmco(network *nn, network_config *config) {
  int mmax =config->mmax;        /* number of MC outer iterations */
  int nmax = config->nmax;    /* number of MC inner iterations */
  double gamma = config->gamma;/* rate to reduce the space of search at every iteration */
- int i, j, k;
+ int k;
  int m, n;
  double e0, err;
  double *wbest;
  double delta = config->wmax - config->wmin;
+ packed_network *pn;
 
  e0=1.e8; // just a big number
 
@@ -50,30 +52,32 @@ void msmco(network *nn, network_config *config) {
   exit(0);
  }
 
- #pragma omp parallel for private(n,i,j,err)
+ pn = packed_network_alloc(nn);
+ packed_network_get_weights(pn, nn, wbest);
+
+ // each thread tries its candidates in weights of its own, so only
+ // the best ones found are shared
+ #pragma omp parallel for private(n,k,err)
  for (m = 0; m < mmax; m++) {
+  double w[pn->num_of_weights + 1];
   for (n = 0; n < nmax; n++) {
    // random weights
    if (m == 0) {
-    for (i = 0; i < nn->num_of_neurons; i++){
-     for (j = 0; j < nn->neurons[i].num_input; ++j) {
-      nn->neurons[i].w[j] = 0.5 * delta +
+    for (k = 0; k < pn->num_of_weights; k++)
+     w[k] = 0.5 * delta +
 		(0.5 - rnd()) * 0.5 * delta ;
-     }
-    }
    } else {
-    for (k = 0, i = 0; i < nn->num_of_neurons; i++)
-     for (j = 0; j < nn->neurons[i].num_input; ++j, ++k)
-      nn->neurons[i].w[j] = wbest[k] + (0.5 - rnd()) * 0.5 * delta * pow(gamma,m);
+    #pragma omp critical (msmco_best)
+    for (k = 0; k < pn->num_of_weights; k++)
+     w[k] = wbest[k] + (0.5 - rnd()) * 0.5 * delta * pow(gamma,m);
    }
    // update error
-   err = error(nn, config);
+   err = packed_error(pn, w, config);
+   #pragma omp critical (msmco_best)
    if (err < e0) {
     // update/store the new best weights
     e0 = err;
-    for (k = 0, i = 0; i < nn->num_of_neurons; i++)
-     for (j = 0; j < nn->neurons[i].num_input; ++j, ++k)
-      wbest[k] = nn->neurons[i].w[j];
+    memcpy(wbest, w, pn->num_of_weights * sizeof(*wbest));
    }
   } // end of n-loop
   if (output==ON)
@@ -81,9 +85,8 @@ void msmco(network *nn, network_config *config) {
  } // end of m-loop
 
  // update the weights of the network with the best found solution
- for (k = 0, i = 0; i < nn->num_of_neurons; i++)
-  for (j = 0; j < nn->neurons[i].num_input; ++j, ++k) 
-   nn->neurons[i].w[j] = wbest[k];
+ packed_network_set_weights(pn, nn, wbest);
 
+ packed_network_free(pn);
  free(wbest);
 }
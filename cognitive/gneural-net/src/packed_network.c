@@ -0,0 +1,252 @@
+/* packed_network.c -- This belongs to gneural_network
+
+   gneural_network is the GNU package which implements a programmable neural network.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// the network packed into flat arrays, for evaluating many sets of weights
+// quickly during the training process
+
+/*
+   The training algorithms try many sets of weights, each over all the
+   training points. Following neuron and connection pointers for each of
+   them is slow, so the topology is packed once into arrays indexed by
+   global id, and the weights are a flat array numbered as the training
+   algorithms number them. Then a set of weights needs no copying into
+   the network to be tried, and several can be tried at once since each
+   evaluation has outputs of its own.
+
+   Most layers read all of one earlier layer through LINEAR neurons: for
+   those the weights are a matrix and each output is a dot product over
+   contiguous memory, which the compiler vectorizes.
+*/
+
+#include <packed_network.h>
+#include <feedforward.h>
+#include <activation.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+static void *_packed_alloc(size_t size, const char *what)
+{
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+	printf("No memory available to allocate the packed %s array!\n", what);
+	exit(-1);
+  }
+  return ptr;
+}
+
+/*
+ * __packed_layer_is_dense:
+ * - check whether all the neurons of a layer are LINEAR and read the
+ *   same run of neurons, in order
+ */
+static int __packed_layer_is_dense(layer *ly, unsigned int *input_first)
+{
+  unsigned int num_input = ly->neurons[0].num_input;
+  unsigned int first;
+  unsigned int i, j;
+
+  if (!num_input)
+	return 0;
+  first = ly->neurons[0].connection[0]->global_id;
+  for (i = 0; i < ly->num_of_neurons; ++i) {
+	neuron *ne = &ly->neurons[i];
+
+	if (ne->discriminant != LINEAR || ne->num_input != num_input)
+	  return 0;
+	for (j = 0; j < num_input; ++j)
+	  if (ne->connection[j]->global_id != first + j)
+		return 0;
+  }
+  *input_first = first;
+  return 1;
+}
+
+packed_network *packed_network_alloc(network *nn)
+{
+  packed_network *pn;
+  unsigned int i, j, k;
+
+  pn = (packed_network *)_packed_alloc(sizeof(*pn), "network");
+  memset(pn, 0, sizeof(*pn));
+  pn->num_of_neurons = nn->num_of_neurons;
+  pn->num_of_layers = nn->num_of_layers;
+
+  pn->weight_offset = (unsigned int *)_packed_alloc(
+	(nn->num_of_neurons + 1) * sizeof(unsigned int), "offset");
+  for (k = 0, i = 0; i < nn->num_of_neurons; ++i) {
+	pn->weight_offset[i] = k;
+	k += nn->neurons[i].num_input;
+	if (nn->neurons[i].num_input > pn->max_input)
+	  pn->max_input = nn->neurons[i].num_input;
+  }
+  pn->weight_offset[i] = k;
+  pn->num_of_weights = k;
+
+  pn->input_id = (unsigned int *)_packed_alloc(k * sizeof(unsigned int), "input");
+  pn->weights = (double *)_packed_alloc(k * sizeof(double), "weights");
+  pn->activation = (enum activation_function *)_packed_alloc(
+	nn->num_of_neurons * sizeof(enum activation_function), "activation");
+  pn->discriminant = (enum discriminant_function *)_packed_alloc(
+	nn->num_of_neurons * sizeof(enum discriminant_function), "discriminant");
+  for (k = 0, i = 0; i < nn->num_of_neurons; ++i) {
+	neuron *ne = &nn->neurons[i];
+
+	pn->activation[i] = ne->activation;
+	pn->discriminant[i] = ne->discriminant;
+	/* the input layer has no connections */
+	for (j = 0; j < ne->num_input; ++j, ++k)
+	  pn->input_id[k] = ne->connection && ne->connection[j] ?
+		ne->connection[j]->global_id : 0;
+  }
+
+  pn->layers = (packed_layer *)_packed_alloc(
+	nn->num_of_layers * sizeof(packed_layer), "layers");
+  memset(pn->layers, 0, nn->num_of_layers * sizeof(packed_layer));
+  for (i = 0; i < nn->num_of_layers; ++i) {
+	packed_layer *pl = &pn->layers[i];
+
+	pl->first = nn->layers[i].neurons - nn->neurons;
+	pl->num_of_neurons = nn->layers[i].num_of_neurons;
+	if (i > 0 && pl->num_of_neurons &&
+	    __packed_layer_is_dense(&nn->layers[i], &pl->input_first)) {
+	  pl->dense = 1;
+	  pl->num_input = nn->layers[i].neurons[0].num_input;
+	}
+  }
+  return pn;
+}
+
+void packed_network_free(packed_network *pn)
+{
+  if (!pn)
+	return;
+
+  free(pn->layers);
+  free(pn->weight_offset);
+  free(pn->input_id);
+  free(pn->activation);
+  free(pn->discriminant);
+  free(pn->weights);
+  free(pn);
+}
+
+void packed_network_get_weights(const packed_network *pn, network *nn, double *w)
+{
+  unsigned int i;
+
+  for (i = 0; i < nn->num_of_neurons; ++i)
+	memcpy(w + pn->weight_offset[i], nn->neurons[i].w,
+	  nn->neurons[i].num_input * sizeof(double));
+}
+
+void packed_network_set_weights(const packed_network *pn, network *nn, const double *w)
+{
+  unsigned int i;
+
+  for (i = 0; i < nn->num_of_neurons; ++i)
+	memcpy(nn->neurons[i].w, w + pn->weight_offset[i],
+	  nn->neurons[i].num_input * sizeof(double));
+}
+
+void packed_feedforward(const packed_network *pn, const double *w, double *output)
+{
+  double x[pn->max_input + 1];
+  unsigned int l, n, i;
+
+  /*
+   * scan all the layers (except the first)
+   */
+  for (l = 1; l < pn->num_of_layers; l++) {
+	const packed_layer *pl = &pn->layers[l];
+
+	if (pl->dense) {
+	  const double *in = output + pl->input_first;
+	  const double *row = w + pn->weight_offset[pl->first];
+
+	  for (n = pl->first; n < pl->first + pl->num_of_neurons; n++) {
+		double sum = 0.;
+
+		#pragma omp simd reduction(+:sum)
+		for (i = 0; i < pl->num_input; i++)
+		  sum += in[i] * row[i];
+		output[n] = activation(pn->activation[n], sum);
+		row += pl->num_input;
+	  }
+	  continue;
+	}
+	for (n = pl->first; n < pl->first + pl->num_of_neurons; n++) {
+	  unsigned int k0 = pn->weight_offset[n];
+	  unsigned int num_input = pn->weight_offset[n + 1] - k0;
+
+	  for (i = 0; i < num_input; i++)
+		x[i] = output[pn->input_id[k0 + i]];
+	  output[n] = activation(pn->activation[n],
+		neuron_discriminant(pn->discriminant[n], num_input, x, w + k0));
+	}
+  }
+}
+
+double packed_error(const packed_network *pn, const double *w, network_config *config)
+{
+  const packed_layer *in = &pn->layers[0];
+  const packed_layer *out = &pn->layers[pn->num_of_layers - 1];
+  double output[pn->num_of_neurons];
+  double err;
+  unsigned int n, i;
+
+  switch (config->error_type) {
+  // L1 norm
+  case L1:
+	err = -1.e8;
+	break;
+  // L2 norm
+  case L2:
+	err = 0.;
+	break;
+  default:
+	return 0.;
+  }
+
+  for (n = 0; n < config->num_points; n++) {
+	double tmp = 0.;
+
+	// assign training input
+	for (i = in->first; i < in->first + in->num_of_neurons; i++)
+	  output[i] = config->points_x[n][i][0];
+	packed_feedforward(pn, w, output);
+	// compare with the training output
+	for (i = out->first; i < out->first + out->num_of_neurons; i++) {
+	  double d = output[i] - config->points_y[n][i];
+
+	  tmp += config->error_type == L1 ? fabs(d) : d * d;
+	}
+	err += tmp;
+  }
+  return config->error_type == L1 ? err : sqrt(err);
+}
+
+double packed_network_error(packed_network *pn, network *nn, network_config *config)
+{
+  packed_network_get_weights(pn, nn, pn->weights);
+  return packed_error(pn, pn->weights, config);
+}
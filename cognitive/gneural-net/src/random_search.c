@@ -26,7 +26,7 @@
 
 #include <random_search.h>
 #include <randomize.h>
-#include <error.h>
+#include <packed_network.h>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -39,6 +39,7 @@ void random_search(network *nn, network_config *config) {
  int n;
  double err,e0;
  double *wbackup;
+ packed_network *pn;
 
  wbackup = malloc((nn->num_of_neurons*MAX_IN+1)*sizeof(*wbackup));
  if (wbackup == NULL) {
@@ -47,8 +48,9 @@ void random_search(network *nn, network_config *config) {
  }
 
 
+ pn = packed_network_alloc(nn);
  err = 1.e8; // just a big number
- e0 = error(nn, config);
+ e0 = packed_network_error(pn, nn, config);
 
  for (n = 0;(n < nmax) && (e0 > eps); n++){
   // backup of the weights
@@ -59,7 +61,7 @@ void random_search(network *nn, network_config *config) {
   // random weights
   randomize(nn, config);
   // update error
-  err = error(nn, config);
+  err = packed_network_error(pn, nn, config);
   if (err < e0) {
    // keep the new state
    e0 = err;
@@ -73,4 +75,5 @@ void random_search(network *nn, network_config *config) {
    printf("RND: %d %g\n", n, e0);
  }
  free(wbackup);
+ packed_network_free(pn);
 }
@@ -27,7 +27,7 @@
 #include <simulated_annealing.h>
 #include <randomize.h>
 #include <rnd.h>
-#include <error.h>
+#include <packed_network.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -50,6 +50,7 @@ void simulated_annealing(network *nn, network_config *config) {
  double **wbackup;
  double **wbest;
  void *tmp;
+ packed_network *pn;
 
  w_total = malloc(nn->num_of_neurons * sizeof(double*) * 2);
 
@@ -77,6 +78,7 @@ void simulated_annealing(network *nn, network_config *config) {
 	}
  }
 
+ pn = packed_network_alloc(nn);
  e_best = err = e0 = 1.e8; // just a big number
 
  for (m = 0;(m < mmax) && (e0 > eps); m++){
@@ -95,7 +97,7 @@ void simulated_annealing(network *nn, network_config *config) {
    // new random configuration
    randomize(nn, config);
    // compute the error
-   err = error(nn, config);
+   err = packed_network_error(pn, nn, config);
    // update energy landscape
    de = err - e0;
    // decides what configuration to keep
@@ -147,4 +149,5 @@ void simulated_annealing(network *nn, network_config *config) {
     free(w_total[i]);
 
    free(w_total);
+   packed_network_free(pn);
 }
@@ -0,0 +1,223 @@
+/* test_packed_network.c - Unit tests for the packed network
+ *
+ * Tests: packed_network.c
+ */
+
+#include "test_framework.h"
+#include <stdlib.h>
+#include <math.h>
+
+/* Include the headers we need to test */
+#include "../../include/defines.h"
+#include "../../include/network.h"
+#include "../../include/feedforward.h"
+#include "../../include/error.h"
+#include "../../include/packed_network.h"
+
+/* Tolerance for floating point comparisons */
+#define FLOAT_TOLERANCE 1e-10
+
+/* Connect neuron 'id' to the neurons listed in 'inputs' */
+static void connect_neuron(network *nn, int id, int num_input, const int *inputs,
+                           enum activation_function act,
+                           enum discriminant_function disc) {
+    int i;
+    network_neuron_set_connection_number(&nn->neurons[id], num_input);
+    for (i = 0; i < num_input; i++) {
+        nn->neurons[id].connection[i] = &nn->neurons[inputs[i]];
+        nn->neurons[id].w[i] = 0.25 * (id + 1) - 0.5 * i;
+    }
+    nn->neurons[id].activation = act;
+    nn->neurons[id].discriminant = disc;
+}
+
+/* Set the input layer of an n-input network */
+static void set_input_layer(network *nn, int n) {
+    int i;
+    nn->layers[0].num_of_neurons = n;
+    nn->layers[0].neurons = &nn->neurons[0];
+    for (i = 0; i < n; i++) {
+        network_neuron_set_connection_number(&nn->neurons[i], 1);
+        nn->neurons[i].w[0] = 0.1 * (i + 1);
+    }
+}
+
+/* A 2-2-1 network with fully connected LINEAR layers */
+static network* create_dense_network(void) {
+    static const int in[] = {0, 1};
+    static const int hidden[] = {2, 3};
+    network *nn = network_alloc();
+    network_set_neuron_number(nn, 5);
+    network_set_layer_number(nn, 3);
+
+    set_input_layer(nn, 2);
+    nn->layers[1].num_of_neurons = 2;
+    nn->layers[1].neurons = &nn->neurons[2];
+    connect_neuron(nn, 2, 2, in, TANH, LINEAR);
+    connect_neuron(nn, 3, 2, in, EXP, LINEAR);
+    nn->layers[2].num_of_neurons = 1;
+    nn->layers[2].neurons = &nn->neurons[4];
+    connect_neuron(nn, 4, 2, hidden, ID, LINEAR);
+
+    return nn;
+}
+
+/* A 2-2-1 network whose output skips a layer and whose hidden layer
+ * mixes discriminants */
+static network* create_sparse_network(void) {
+    static const int in[] = {1, 0};
+    static const int in2[] = {0, 1};
+    static const int out[] = {3, 0, 2};
+    network *nn = network_alloc();
+    network_set_neuron_number(nn, 5);
+    network_set_layer_number(nn, 3);
+
+    set_input_layer(nn, 2);
+    nn->layers[1].num_of_neurons = 2;
+    nn->layers[1].neurons = &nn->neurons[2];
+    connect_neuron(nn, 2, 2, in, TANH, LEGENDRE);
+    connect_neuron(nn, 3, 2, in2, POL1, FOURIER);
+    nn->layers[2].num_of_neurons = 1;
+    nn->layers[2].neurons = &nn->neurons[4];
+    connect_neuron(nn, 4, 3, out, POL2, LINEAR);
+
+    return nn;
+}
+
+/* Compare packed_feedforward with feedforward for the given inputs */
+static int check_same_outputs(network *nn, double x0, double x1) {
+    packed_network *pn = packed_network_alloc(nn);
+    double w[pn->num_of_weights + 1];
+    double output[pn->num_of_neurons];
+    unsigned int i;
+
+    nn->neurons[0].output = output[0] = x0;
+    nn->neurons[1].output = output[1] = x1;
+    packed_network_get_weights(pn, nn, w);
+    feedforward(nn);
+    packed_feedforward(pn, w, output);
+    for (i = 2; i < nn->num_of_neurons; i++)
+        TEST_ASSERT_FLOAT_WITHIN(FLOAT_TOLERANCE, nn->neurons[i].output, output[i]);
+
+    packed_network_free(pn);
+    return 0;
+}
+
+/* ==================== Packing Tests ==================== */
+
+int test_packed_network_dense_layers(void) {
+    network *nn = create_dense_network();
+    packed_network *pn = packed_network_alloc(nn);
+
+    TEST_ASSERT_NOT_NULL(pn);
+    TEST_ASSERT_EQUAL(5, pn->num_of_neurons);
+    TEST_ASSERT_EQUAL(8, pn->num_of_weights);
+    TEST_ASSERT_TRUE(pn->layers[1].dense);
+    TEST_ASSERT_EQUAL(0, pn->layers[1].input_first);
+    TEST_ASSERT_EQUAL(2, pn->layers[1].num_input);
+    TEST_ASSERT_TRUE(pn->layers[2].dense);
+    TEST_ASSERT_EQUAL(2, pn->layers[2].input_first);
+
+    packed_network_free(pn);
+    network_free(nn);
+    return 0;
+}
+
+int test_packed_network_sparse_layers(void) {
+    network *nn = create_sparse_network();
+    packed_network *pn = packed_network_alloc(nn);
+
+    TEST_ASSERT_FALSE(pn->layers[1].dense);
+    TEST_ASSERT_FALSE(pn->layers[2].dense);
+    TEST_ASSERT_EQUAL(3, pn->max_input);
+
+    packed_network_free(pn);
+    network_free(nn);
+    return 0;
+}
+
+int test_packed_network_weight_order(void) {
+    network *nn = create_sparse_network();
+    packed_network *pn = packed_network_alloc(nn);
+    double w[pn->num_of_weights];
+    unsigned int i, j, k;
+
+    /* the weights are numbered as the training algorithms number them */
+    packed_network_get_weights(pn, nn, w);
+    for (k = 0, i = 0; i < nn->num_of_neurons; i++)
+        for (j = 0; j < nn->neurons[i].num_input; j++, k++)
+            TEST_ASSERT_FLOAT_WITHIN(FLOAT_TOLERANCE, nn->neurons[i].w[j], w[k]);
+
+    for (k = 0; k < pn->num_of_weights; k++)
+        w[k] = k;
+    packed_network_set_weights(pn, nn, w);
+    TEST_ASSERT_FLOAT_WITHIN(FLOAT_TOLERANCE, 6.0, nn->neurons[4].w[0]);
+    TEST_ASSERT_FLOAT_WITHIN(FLOAT_TOLERANCE, 8.0, nn->neurons[4].w[2]);
+
+    packed_network_free(pn);
+    network_free(nn);
+    return 0;
+}
+
+/* ==================== Packed Feedforward Tests ==================== */
+
+int test_packed_feedforward_dense_matches(void) {
+    network *nn = create_dense_network();
+    int result = check_same_outputs(nn, 0.3, -1.7);
+    network_free(nn);
+    return result;
+}
+
+int test_packed_feedforward_sparse_matches(void) {
+    network *nn = create_sparse_network();
+    int result = check_same_outputs(nn, 0.8, 0.45);
+    network_free(nn);
+    return result;
+}
+
+/* ==================== Packed Error Tests ==================== */
+
+int test_packed_error_matches_feedforward(void) {
+    network *nn = create_sparse_network();
+    network_config *config = network_config_alloc_default();
+    packed_network *pn = packed_network_alloc(nn);
+    double expected = 0.;
+    unsigned int n;
+
+    config->num_points = 3;
+    for (n = 0; n < config->num_points; n++) {
+        config->points_x[n][0][0] = 0.2 * n;
+        config->points_x[n][1][0] = 1. - 0.3 * n;
+        config->points_y[n][4] = n;
+        nn->neurons[0].output = config->points_x[n][0][0];
+        nn->neurons[1].output = config->points_x[n][1][0];
+        feedforward(nn);
+        expected += pow(nn->neurons[4].output - n, 2);
+    }
+
+    config->error_type = L2;
+    TEST_ASSERT_FLOAT_WITHIN(FLOAT_TOLERANCE, sqrt(expected),
+                             packed_network_error(pn, nn, config));
+    TEST_ASSERT_FLOAT_WITHIN(FLOAT_TOLERANCE, sqrt(expected), error(nn, config));
+
+    packed_network_free(pn);
+    network_config_free(config);
+    network_free(nn);
+    return 0;
+}
+
+/* ==================== Test Runner ==================== */
+
+void run_packed_network_tests(void) {
+    TEST_SUITE_BEGIN("Packed Network");
+    RUN_TEST(test_packed_network_dense_layers);
+    RUN_TEST(test_packed_network_sparse_layers);
+    RUN_TEST(test_packed_network_weight_order);
+    TEST_SUITE_END();
+
+    TEST_SUITE_BEGIN("Packed Feedforward");
+    RUN_TEST(test_packed_feedforward_dense_matches);
+    RUN_TEST(test_packed_feedforward_sparse_matches);
+    RUN_TEST(test_packed_error_matches_feedforward);
+    TEST_SUITE_END();
+}
@@ -16,6 +16,7 @@ extern void run_math_utils_tests(void);
 extern void run_activation_tests(void);
 extern void run_network_tests(void);
 extern void run_feedforward_tests(void);
+extern void run_packed_network_tests(void);
 
 int main(int argc, char *argv[]) {
     (void)argc;
@@ -31,6 +32,7 @@ int main(int argc, char *argv[]) {
     run_activation_tests();
     run_network_tests();
     run_feedforward_tests();
+    run_packed_network_tests();
 
     /* Print final results */
     PRINT_TEST_RESULTS();
@@ -26,6 +26,7 @@
 
 #include "Astar.h"
 #include "Audio.h"
+#include "Hpastar.h"
 #include "Zombie.h"
 #include "actors.h"
 #include "cheat.h"
@@ -39,14 +40,83 @@
 #include "paths.h"
 #include "ucmachine.h"
 
+#include <array>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 
 using std::cout;
 using std::endl;
 
 long Actor_action::seqcnt = 0;
 
+namespace {
+	/*
+	 *  Free lists of the blocks actions were in, by size.  Each keeps at
+	 *  most max_free blocks, so a burst of actions doesn't hold on to
+	 *  its memory.
+	 */
+	class Actor_action_pool {
+		static constexpr size_t granularity = alignof(std::max_align_t);
+		static constexpr size_t num_sizes   = 16;
+		static constexpr size_t max_free    = 256;
+
+		struct Free_block {
+			Free_block* next;
+		};
+
+		std::array<Free_block*, num_sizes> free_lists{};
+		std::array<size_t, num_sizes>      free_counts{};
+
+		static size_t size_index(size_t size) {
+			return (size + granularity - 1) / granularity - 1;
+		}
+
+	public:
+		void* allocate(size_t size) {
+			const size_t index = size_index(size);
+			if (index < num_sizes && free_lists[index]) {
+				Free_block* block = free_lists[index];
+				free_lists[index] = block->next;
+				free_counts[index]--;
+				return block;
+			}
+			// Round up, so the block can go on its list when freed.
+			return ::operator new(
+					index < num_sizes ? (index + 1) * granularity : size);
+		}
+
+		void release(void* ptr, size_t size) noexcept {
+			const size_t index = size_index(size);
+			if (index >= num_sizes || free_counts[index] >= max_free) {
+				::operator delete(ptr);
+				return;
+			}
+			auto* block       = static_cast<Free_block*>(ptr);
+			block->next       = free_lists[index];
+			free_lists[index] = block;
+			free_counts[index]++;
+		}
+	};
+
+	Actor_action_pool& Get_action_pool() {
+		// Never destroyed, as actions may be deleted by other statics'
+		//   destructors.
+		static auto* pool = new Actor_action_pool;
+		return *pool;
+	}
+}    // namespace
+
+void* Actor_action::operator new(std::size_t size) {
+	return Get_action_pool().allocate(size);
+}
+
+void Actor_action::operator delete(void* ptr, std::size_t size) noexcept {
+	if (ptr) {
+		Get_action_pool().release(ptr, size);
+	}
+}
+
 /**
  *  Handle an event and check to see if we were deleted.
  *
@@ -119,7 +189,7 @@ Actor_action* Actor_action::create_action_sequence(
 		// party members teleporting.
 		const int     persistence = persistant ? 30 : 0;
 		Actor_action* w
-				= new Path_walking_actor_action(new Astar(), 3, persistence);
+				= new Path_walking_actor_action(new Hpastar(), 3, persistence);
 		Actor_action* w2 = w->walk_to_tile(actor, actloc, dest, 0, persistant);
 		if (w2 != w) {
 			delete w;
@@ -151,13 +221,13 @@ int Null_action::handle_event(Actor* actor) {
  */
 
 Path_walking_actor_action::Path_walking_actor_action(
-		PathFinder* p,         // Pathfinder, or 0 for Astar.
+		PathFinder* p,         // Pathfinder, or 0 for Hpastar.
 		int         maxblk,    // Max. retries when blocked.
 		int         pers       // Keeps retrying this many times.
 		)
 		: path(p), max_blocked(maxblk), persistence(pers) {
 	if (!path) {
-		path = new Astar();
+		path = new Hpastar();
 	}
 	const Tile_coord src  = path->get_src();
 	const Tile_coord dest = path->get_dest();
@@ -288,11 +358,14 @@ int Path_walking_actor_action::handle_event(Actor* actor) {
 		}
 	}
 	speed = newspeed;
+	if (path->is_pending()) {
+		return speed;    // Wait for the path to be found.
+	}
 	bool done;    // So we'll know if this is the last.
 	if (!path->GetNextStep(tile, done)
 		// This happens sometimes (bedroll cancel).
 		|| (tile == actor->get_tile() && !path->GetNextStep(tile, done))) {
-		reached_end = true;    // Did it.
+		reached_end = path->found();    // Did it, unless there's no path.
 		return 0;
 	}
 	if (done) {    // In case we're deleted.
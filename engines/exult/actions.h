@@ -24,6 +24,7 @@
 #include "ignore_unused_variable_warning.h"
 #include "tiles.h"
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -52,6 +53,12 @@ public:
 
 	virtual ~Actor_action() = default;
 
+	// Schedules and combat make and drop actions all the time, so their
+	//   memory is reused rather than going back to the heap.  Only for
+	//   the game's thread.
+	static void* operator new(std::size_t size);
+	static void  operator delete(void* ptr, std::size_t size) noexcept;
+
 	void set_get_party(bool tf = true) {
 		ignore_unused_variable_warning(tf);
 		get_party = true;
@@ -797,7 +797,7 @@ void Actor::write(ODataSource* nfile    // Generally 'npc.dat'.
 	char namebuf[17];    // Write 16-byte name.
 	std::memset(namebuf, 0, 16);
 	if (name.empty()) {
-		const std::string namestr = Game_object::get_name();
+		const std::string namestr = std::string(Game_object::get_name_view());
 		std::strncpy(namebuf, namestr.c_str(), 16);
 	} else {
 		std::strncpy(namebuf, name.c_str(), 16);
@@ -25,10 +25,11 @@
 
 #include "actors.h"
 
-#include "Astar.h"
+#include "Async_astar.h"
 #include "Audio.h"
 #include "Face_stats.h"
 #include "Gump_manager.h"
+#include "Hpastar.h"
 #include "Paperdoll_gump.h"
 #include "Zombie.h"
 #include "actions.h"
@@ -1348,10 +1349,12 @@ int Actor::walk_path_to_tile(
 		int               speed,    // Time between frames (msecs).
 		int               delay,    // Delay before starting (msecs) (only
 		//   if not already moving).
-		int dist,     // Distance to get within dest.
-		int maxblk    // Max. # retries if blocked.
+		int  dist,             // Distance to get within dest.
+		int  maxblk,           // Max. # retries if blocked.
+		bool in_background     // Find path on another thread if we can.
 ) {
-	set_action(new Path_walking_actor_action(new Astar(), maxblk));
+	PathFinder* path = in_background ? new Async_astar() : new Hpastar();
+	set_action(new Path_walking_actor_action(path, maxblk));
 	set_action(action->walk_to_tile(this, src, dest, dist));
 	if (action) {    // Successful at setting path?
 		start(speed, delay);
@@ -2580,8 +2583,10 @@ bool Actor::drop(Game_object* obj    // MAY be deleted (if combined).
  *  Get name.
  */
 
-string Actor::get_name() const {
-	return !get_flag(Obj_flags::met) ? Game_object::get_name() : get_npc_name();
+std::string_view Actor::get_name_view() const {
+	return !get_flag(Obj_flags::met) || name.empty()
+				   ? Game_object::get_name_view()
+				   : intern_name(name);
 }
 
 /*
@@ -2589,7 +2594,7 @@ string Actor::get_name() const {
  */
 
 string Actor::get_npc_name() const {
-	return name.empty() ? Game_object::get_name() : name;
+	return name.empty() ? string(Game_object::get_name_view()) : name;
 }
 
 /*
@@ -5334,11 +5339,12 @@ void Npc_actor::update_schedule(
 
 void Npc_actor::paint() {
 	Actor::paint();               // Draw on screen.
-	if (dormant && schedule &&    // Resume schedule.
-								  // FOR NOW:  Not when in formation.
+	if ((dormant || coarse_waiting) && schedule &&    // Resume schedule.
+			// FOR NOW:  Not when in formation.
 		(party_id < 0 || !gwin->walk_in_formation
 		 || schedule_type != Schedule::follow_avatar)) {
-		dormant = false;    // But clear out old entries first.??
+		dormant        = false;    // But clear out old entries first.??
+		coarse_waiting = false;
 		gwin->get_tqueue()->remove(this);
 		// Force schedule->now_what() in .5secs
 		// DO NOT call now_what here!!!
@@ -5409,13 +5415,32 @@ void Npc_actor::handle_event(
 			gwin->get_tqueue()->add(
 					curtime + gwin->get_std_delay(), this, udata);
 		} else if (schedule) {
-			if (!dormant) {
+			if (dormant) {
+				schedule->im_dormant();
+			} else if (!in_coarse_tier()) {
 				schedule->now_what();
+			} else if (curtime < next_coarse_tick) {
+				// Far off.  Wait for the next coarse tick.
+				coarse_waiting = true;
+				gwin->get_tqueue()->add(next_coarse_tick, this, udata);
 			} else {
-				schedule->im_dormant();
+				coarse_waiting   = false;
+				next_coarse_tick = curtime + get_coarse_delay();
+				schedule->now_what();
 			}
 		}
 	} else {
+		Tile_coord dest;
+		// Far off and just walking somewhere?  Go straight there.
+		if (!action->as_usecode_path() && action->get_dest(dest)
+			&& dest.tx >= 0 && in_coarse_tier()) {
+			set_action(nullptr);
+			move(dest.tx, dest.ty, dest.tz);
+			change_frame(get_dir_framenum(Actor::standing));
+			gwin->get_tqueue()->add(
+					curtime + gwin->get_std_delay(), this, udata);
+			return;
+		}
 		// Do what we should.
 		int delay = party_id < 0 ? gwin->is_time_stopped() : 0;
 		if (delay <= 0) {    // Time not stopped?
@@ -5435,6 +5460,41 @@ void Npc_actor::handle_event(
 	}
 }
 
+/*
+ *  Is this NPC far enough off the screen to only get coarse schedule
+ *  ticks?  Nearer NPCs run their schedules in full; the ones in chunks
+ *  that aren't loaded are teleported by set_schedule_type() instead.
+ */
+
+bool Npc_actor::in_coarse_tier() const {
+	if (!gwin->get_npc_coarse_minutes() || party_id >= 0 || !schedule) {
+		return false;
+	}
+	switch (schedule_type) {
+	case Schedule::combat:
+	case Schedule::talk:
+	case Schedule::follow_avatar:
+	case Schedule::walk_to_schedule:    // Teleports when off-screen.
+	case Schedule::street_maintenance:
+	case Schedule::arrest_avatar:
+		return false;
+	default:
+		break;
+	}
+	// More than a screenful away?
+	return distance(gwin->get_camera_actor()) > 1 + c_screen_tile_size;
+}
+
+/*
+ *  Get the time between coarse schedule ticks, in msecs.
+ */
+
+unsigned long Npc_actor::get_coarse_delay() const {
+	const unsigned long minute = ticks_per_minute * gwin->get_std_delay()
+								 / gwin->get_clock()->get_time_rate();
+	return gwin->get_npc_coarse_minutes() * minute;
+}
+
 /*
  *  Step onto an adjacent tile.
  *
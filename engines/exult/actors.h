@@ -427,9 +427,12 @@ public:
 	}
 
 	// Get there, avoiding obstacles.
+	// If in_background, the path may be found on another thread while
+	//   the NPC waits; it returns 1 then, and stops if there's none.
 	int walk_path_to_tile(
 			const Tile_coord& src, const Tile_coord& dest, int speed = 250,
-			int delay = 0, int dist = 0, int maxblk = 3);
+			int delay = 0, int dist = 0, int maxblk = 3,
+			bool in_background = false);
 
 	int walk_path_to_tile(
 			const Tile_coord& dest, int speed = 250, int delay = 0,
@@ -517,7 +520,7 @@ public:
 	static void update_from_studio(unsigned char* data, int datalen);
 	// Drop another onto this.
 	bool        drop(Game_object* obj) override;
-	std::string get_name() const override;
+	std::string_view get_name_view() const override;
 	std::string get_npc_name() const;
 
 	std::string get_npc_name_string() const {
@@ -898,14 +901,20 @@ using Main_actor_shared = std::shared_ptr<Main_actor>;
  *  A non-player-character that one can converse (or fight) with:
  */
 class Npc_actor : public Actor {
-	// Queued as a 'nearby' NPC.  This is to avoid being added twice.
+	// In the 'nearby' list.  This is to avoid being added twice.
 	bool nearby;
+	int  nearby_index = -1;    // Where in that list, for removing it.
+	// Far off-screen NPCs only run their schedule every few game minutes.
+	unsigned long next_coarse_tick = 0;
+	bool          coarse_waiting   = false;    // Queued for that tick.
 
 protected:
 	// List of schedule changes.
 	Schedule_list schedules;
 
 	Schedule_change* find_schedule_change(int hour3);
+	bool             in_coarse_tier() const;
+	unsigned long    get_coarse_delay() const;
 
 public:
 	Npc_actor(const std::string& nm, int shapenum, int num = -1, int uc = -1);
@@ -919,6 +928,14 @@ public:
 		nearby = false;
 	}
 
+	void set_nearby_index(int i) {
+		nearby_index = i;
+	}
+
+	int get_nearby_index() const {
+		return nearby_index;
+	}
+
 	bool is_nearby() const {
 		return nearby;
 	}
@@ -0,0 +1,278 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "AdpcmAudioSample.h"
+
+#include "databuf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace Pentagram {
+
+	static const int adpcm_steps[89]
+			= {7,     8,     9,     10,    11,    12,    13,    14,    16,
+			   17,    19,    21,    23,    25,    28,    31,    34,    37,
+			   41,    45,    50,    55,    60,    66,    73,    80,    88,
+			   97,    107,   118,   130,   143,   157,   173,   190,   209,
+			   230,   253,   279,   307,   337,   371,   408,   449,   494,
+			   544,   598,   658,   724,   796,   876,   963,   1060,  1166,
+			   1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,
+			   3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,
+			   7132,  7845,  8630,  9493,  10442, 11487, 12635, 13899, 15289,
+			   16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+	static const int adpcm_index_change[16]
+			= {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+	static const uint16 WAVE_FORMAT_IMA_ADPCM = 0x11;
+
+	// Apply one nibble to the predictor and step index.
+	static inline void Decode_nibble(int nibble, int& pred, int& index) {
+		const int step = adpcm_steps[index];
+		int       diff = step >> 3;
+		if (nibble & 4) {
+			diff += step;
+		}
+		if (nibble & 2) {
+			diff += step >> 1;
+		}
+		if (nibble & 1) {
+			diff += step >> 2;
+		}
+		pred  = std::clamp(
+				nibble & 8 ? pred - diff : pred + diff, -32768, 32767);
+		index = std::clamp(index + adpcm_index_change[nibble], 0, 88);
+	}
+
+	// The nibble getting closest to sample. The predictor and step index
+	// are moved on just as the decoder will.
+	static inline int Encode_nibble(int sample, int& pred, int& index) {
+		int delta  = sample - pred;
+		int nibble = 0;
+		if (delta < 0) {
+			nibble = 8;
+			delta  = -delta;
+		}
+		int step = adpcm_steps[index];
+		if (delta >= step) {
+			nibble |= 4;
+			delta -= step;
+		}
+		step >>= 1;
+		if (delta >= step) {
+			nibble |= 2;
+			delta -= step;
+		}
+		step >>= 1;
+		if (delta >= step) {
+			nibble |= 1;
+		}
+		Decode_nibble(nibble, pred, index);
+		return nibble;
+	}
+
+	// Find the fmt, fact and data chunks. Returns false if it isn't a
+	// RIFF WAVE or either fmt or data is missing.
+	static bool Find_chunks(
+			IDataSource* ds, uint32& pos_fmt, uint32& size_fmt,
+			uint32& pos_fact, uint32& pos_data, uint32& size_data) {
+		char buf[4];
+		ds->seek(0);
+		ds->read(buf, 4);
+		if (std::memcmp(buf, "RIFF", 4) != 0) {
+			return false;
+		}
+		const uint32 riff_end = ds->read4() + 8;
+		ds->read(buf, 4);
+		if (std::memcmp(buf, "WAVE", 4) != 0 || riff_end > ds->getSize()) {
+			return false;
+		}
+
+		pos_fmt = size_fmt = pos_fact = pos_data = size_data = 0;
+		while (ds->getPos() + 8 <= riff_end) {
+			ds->read(buf, 4);
+			const uint32 chunk_size = ds->read4();
+			if (!std::memcmp(buf, "fmt ", 4)) {
+				pos_fmt  = ds->getPos();
+				size_fmt = chunk_size;
+			} else if (!std::memcmp(buf, "fact", 4)) {
+				pos_fact = ds->getPos();
+			} else if (!std::memcmp(buf, "data", 4)) {
+				pos_data  = ds->getPos();
+				size_data = std::min<uint32>(chunk_size, riff_end - pos_data);
+			}
+			ds->skip(chunk_size + (chunk_size & 1));
+		}
+		return pos_fmt && pos_data && size_fmt >= 0x14;
+	}
+
+	AdpcmAudioSample::AdpcmAudioSample(
+			std::unique_ptr<uint8[]> buffer_, uint32 size)
+			: AudioSample(std::move(buffer_), size), start_pos(0),
+			  block_align(0), block_frames(0) {
+		bits               = 16;
+		decompressor_size  = sizeof(AdpcmDecompData);
+		decompressor_align = alignof(AdpcmDecompData);
+		buffer_limit       = 0;    // Plays nothing unless it checks out.
+
+		IBufferDataView ds(buffer, size);
+		if (!isThis(&ds)) {
+			return;
+		}
+		uint32 pos_fmt;
+		uint32 size_fmt;
+		uint32 pos_fact;
+		uint32 pos_data;
+		uint32 size_data;
+		Find_chunks(&ds, pos_fmt, size_fmt, pos_fact, pos_data, size_data);
+
+		ds.seek(pos_fmt + 2);
+		const int channels = ds.read2();
+		sample_rate        = ds.read4();
+		ds.skip(4);
+		block_align  = ds.read2();
+		block_frames = (block_align - 4 * channels) * 2 / channels + 1;
+		stereo       = channels == 2;
+		frame_size   = block_frames * channels * 2;
+
+		const uint32 blocks = size_data / block_align;
+		length              = blocks * block_frames;
+		if (pos_fact) {
+			ds.seek(pos_fact);
+			length = std::min(length, ds.read4());
+		}
+		start_pos    = pos_data;
+		buffer_limit = pos_data + blocks * block_align;
+	}
+
+	bool AdpcmAudioSample::isThis(IDataSource* ds) {
+		uint32 pos_fmt;
+		uint32 size_fmt;
+		uint32 pos_fact;
+		uint32 pos_data;
+		uint32 size_data;
+		if (!Find_chunks(
+					ds, pos_fmt, size_fmt, pos_fact, pos_data, size_data)) {
+			return false;
+		}
+		ds->seek(pos_fmt);
+		const uint16 format_tag = ds->read2();
+		const uint16 channels   = ds->read2();
+		ds->skip(8);
+		const uint16 align           = ds->read2();
+		const uint16 bits_per_sample = ds->read2();
+		return format_tag == WAVE_FORMAT_IMA_ADPCM
+			   && (channels == 1 || channels == 2) && bits_per_sample == 4
+			   && align > 4 * channels && align % (4 * channels) == 0;
+	}
+
+	void AdpcmAudioSample::initDecompressor(void* DecompData) const {
+		auto* decomp   = new (DecompData) AdpcmDecompData;
+		decomp->pos    = start_pos;
+		decomp->frames = length;
+	}
+
+	uint32 AdpcmAudioSample::decompressFrame(
+			void* DecompData, void* samples) const {
+		auto* decomp = static_cast<AdpcmDecompData*>(DecompData);
+		if (!decomp->frames || decomp->pos + block_align > buffer_limit) {
+			return 0;
+		}
+
+		// Each channel starts with its first sample and step index. The
+		// rest come in runs of eight for each channel in turn.
+		const int    channels = stereo ? 2 : 1;
+		const uint8* block    = buffer.get() + decomp->pos;
+		auto*        out      = static_cast<sint16*>(samples);
+		for (int c = 0; c < channels; c++) {
+			const uint8* head  = block + 4 * c;
+			int          pred  = static_cast<sint16>(head[0] | (head[1] << 8));
+			int          index = std::min<int>(head[2], 88);
+			out[c]             = static_cast<sint16>(pred);
+
+			const uint8* data  = block + 4 * channels + 4 * c;
+			uint32       frame = 1;
+			for (; frame < block_frames; data += 4 * channels) {
+				for (int i = 0; i < 4 && frame < block_frames; i++) {
+					Decode_nibble(data[i] & 0xF, pred, index);
+					out[frame++ * channels + c] = static_cast<sint16>(pred);
+					Decode_nibble(data[i] >> 4, pred, index);
+					out[frame++ * channels + c] = static_cast<sint16>(pred);
+				}
+			}
+		}
+
+		const uint32 frames = std::min(block_frames, decomp->frames);
+		decomp->pos += block_align;
+		decomp->frames -= frames;
+		return frames * channels * 2;
+	}
+
+	void AdpcmAudioSample::Encoder::encodeBlock(
+			const sint16* samples, uint8* block) {
+		for (int c = 0; c < channels; c++) {
+			int    pred = samples[c];
+			uint8* head = block + 4 * c;
+			head[0]     = static_cast<uint8>(pred & 0xFF);
+			head[1]     = static_cast<uint8>((pred >> 8) & 0xFF);
+			head[2]     = static_cast<uint8>(index[c]);
+			head[3]     = 0;
+
+			uint8* data  = block + 4 * channels + 4 * c;
+			uint32 frame = 1;
+			for (; frame < BLOCK_FRAMES; data += 4 * channels) {
+				for (int i = 0; i < 4; i++) {
+					const int lo = Encode_nibble(
+							samples[frame++ * channels + c], pred, index[c]);
+					const int hi = Encode_nibble(
+							samples[frame++ * channels + c], pred, index[c]);
+					data[i] = static_cast<uint8>(lo | (hi << 4));
+				}
+			}
+		}
+	}
+
+	void AdpcmAudioSample::writeHeader(
+			ODataSource* out, uint32 rate, int channels, uint32 frames,
+			uint32 data_size) {
+		const uint32 align = BLOCK_BYTES * channels;
+		out->write("RIFF", 4);
+		out->write4(4 + 8 + 20 + 8 + 4 + 8 + data_size);
+		out->write("WAVE", 4);
+		out->write("fmt ", 4);
+		out->write4(20);
+		out->write2(WAVE_FORMAT_IMA_ADPCM);
+		out->write2(channels);
+		out->write4(rate);
+		out->write4(static_cast<uint32>(uint64(rate) * align / BLOCK_FRAMES));
+		out->write2(align);
+		out->write2(4);
+		out->write2(2);
+		out->write2(BLOCK_FRAMES);
+		out->write("fact", 4);
+		out->write4(4);
+		out->write4(frames);
+		out->write("data", 4);
+		out->write4(data_size);
+	}
+
+}    // namespace Pentagram
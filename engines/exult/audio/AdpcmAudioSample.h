@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+#ifndef ADPCMAUDIOSAMPLE_H_INCLUDED
+#define ADPCMAUDIOSAMPLE_H_INCLUDED
+
+#include "AudioSample.h"
+
+class ODataSource;
+
+namespace Pentagram {
+
+	// A WAV file of IMA ADPCM (format 0x11): 4 bits a sample, decoded a
+	// block at a time to 16 bit.
+	class AdpcmAudioSample : public AudioSample {
+	public:
+		AdpcmAudioSample(std::unique_ptr<uint8[]> buffer, uint32 size);
+
+		void   initDecompressor(void* DecompData) const override;
+		uint32 decompressFrame(void* DecompData, void* samples) const override;
+
+		static bool isThis(IDataSource* ds);
+
+		// Block size per channel of the files written here.
+		static constexpr const uint32 BLOCK_BYTES = 1024;
+		// Frames in each block of such a file.
+		static constexpr const uint32 BLOCK_FRAMES = (BLOCK_BYTES - 4) * 2 + 1;
+
+		// Encodes 16 bit samples, interleaved if stereo, into blocks of
+		// BLOCK_BYTES per channel.
+		class Encoder {
+		public:
+			explicit Encoder(int channels_) : channels(channels_) {}
+
+			// Encodes BLOCK_FRAMES frames into channels * BLOCK_BYTES.
+			void encodeBlock(const sint16* samples, uint8* block);
+
+		private:
+			int channels;
+			int index[2] = {0, 0};
+		};
+
+		// Writes the headers of a file of data_size bytes of blocks,
+		// which play frames frames. The blocks follow.
+		static void writeHeader(
+				ODataSource* out, uint32 rate, int channels, uint32 frames,
+				uint32 data_size);
+
+	protected:
+		struct AdpcmDecompData {
+			uint32 pos;       // Of the next block.
+			uint32 frames;    // Still to play.
+		};
+
+		uint32 start_pos;
+		uint32 block_align;
+		uint32 block_frames;
+	};
+
+}    // namespace Pentagram
+
+#endif    // ADPCMAUDIOSAMPLE_H_INCLUDED
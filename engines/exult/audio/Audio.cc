@@ -24,6 +24,7 @@
 #include "AudioSample.h"
 #include "Configuration.h"
 #include "Flex.h"
+#include "StreamingAudioSample.h"
 #include "actors.h"
 #include "conv.h"
 #include "databuf.h"
@@ -39,6 +40,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <climits>
 #include <cstdio>
 #include <cstdlib>
@@ -275,6 +277,23 @@ void Audio::Init(int _samplerate, int _channels) {
 	mixer = std::make_unique<AudioMixer>(
 			_samplerate, _channels == 2, MIXER_CHANNELS);
 
+	// "sinc" trades some CPU for cleaner resampling of the sounds.
+	std::string s;
+	config->value("config/audio/resampler", s, "cubic");
+	if (s == "sinc") {
+		mixer->setResampler(AudioResampler::Sinc);
+	} else if (s != "cubic") {
+		config->set("config/audio/resampler", "cubic", true);
+	}
+	// Decoded copies of the sounds played most, in KB.
+	int cache_kb;
+	config->value("config/audio/decoded_cache", cache_kb, 4096);
+	mixer->setDecodedCacheLimit(std::max(cache_kb, 0) * 1024);
+	// How much of the music and speech is decoded ahead, in ms.
+	int ahead_ms;
+	config->value("config/audio/stream_ahead", ahead_ms, 500);
+	mixer->setStreamAhead(std::clamp(ahead_ms, 0, 10000));
+
 	COUT("Audio initialisation OK");
 
 	mixer->openMidiOutput();
@@ -289,6 +308,19 @@ void Audio::Deinit() {
 	CERR("Audio::Deinit:  about to stop_music()");
 	stop_music();
 
+	uint32 cache_bytes;
+	int    cache_count;
+	uint32 cache_hits;
+	uint32 cache_misses;
+	mixer->getDecodedCacheStats(
+			cache_bytes, cache_count, cache_hits, cache_misses);
+	CERR("Audio::Deinit:  " << cache_count << " decoded sounds in "
+							<< cache_bytes / 1024 << " KB, used for "
+							<< cache_hits << " of "
+							<< cache_hits + cache_misses << " plays");
+	CERR("Audio::Deinit:  " << StreamingAudioSample::getUnderruns()
+							<< " streamed frames not decoded in time");
+
 	CERR("Audio::Deinit:  about to quit subsystem");
 	mixer.reset();
 
@@ -764,9 +796,8 @@ int Audio::play_wave_sfx(
 	volume                = (volume * sfx_volume) / 100;
 	const int instance_id = mixer->playSample(
 			wave, repeat, 0, true, AUDIO_DEF_PITCH, volume, volume);
-	// Either AudioMixer::playSample called IncRef through
-	// AudioChannel::playSample and the sample will be played, or the sample was
-	// not queued for playback. In either case we need to Release the sample to
+	// Either AudioMixer::playSample called IncRef and the sample will be
+	// played, or the sample was not queued for playback. In either case we need to Release the sample to
 	// avoid a memory leak.
 	wave->Release();
 	if (instance_id < 0) {
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "AudioMixer.h"
 #include "LowLevelMidiDriver.h"
 #include "MidiDriver.h"
+#include "MidiRenderCache.h"
 #include "OggAudioSample.h"
 #include "conv.h"
 #include "convmusic.h"
@@ -40,6 +41,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <unistd.h>
 #include <vorbis/codec.h>
 
+#include <algorithm>
 #include <climits>
 #include <iostream>
 
@@ -145,7 +147,8 @@ bool MyMidiPlayer::start_music(
 		}
 		// Midi driver is playing?
 		if (force != Force_Ogg && midi_driver
-			&& midi_driver->isSequencePlaying(SEQ_NUM_MUSIC)) {
+			&& (midi_driver->isSequencePlaying(SEQ_NUM_MUSIC)
+				|| rendered_is_playing())) {
 			return true;
 		}
 	}
@@ -212,14 +215,17 @@ bool MyMidiPlayer::start_music(
 		return false;
 	}
 
-	XMidiFile midfile(
-			mid_data.get(), setup_timbre_for_track(flex),
-			midi_driver->getName());
+	const int conversion = setup_timbre_for_track(flex);
+	XMidiFile midfile(mid_data.get(), conversion, midi_driver->getName());
 
 	// Now give the xmidi object to the midi device
 
 	XMidiEventList* eventlist = midfile.GetEventList(0);
 	if (eventlist) {
+		if (prerender
+			&& rendered_play_track(flex, num, conversion, eventlist, repeat)) {
+			return true;
+		}
 		midi_driver->startSequence(SEQ_NUM_MUSIC, eventlist, repeat, 255);
 		return true;
 	}
@@ -294,12 +300,16 @@ bool MyMidiPlayer::start_music(
 		return false;
 	}
 
-	XMidiFile midfile(
-			&mid_data, setup_timbre_for_track(fname), midi_driver->getName());
+	const int conversion = setup_timbre_for_track(fname);
+	XMidiFile midfile(&mid_data, conversion, midi_driver->getName());
 
 	// Now give the xmidi object to the midi device
 	XMidiEventList* eventlist = midfile.GetEventList(num);
 	if (eventlist) {
+		if (prerender
+			&& rendered_play_track(fname, num, conversion, eventlist, repeat)) {
+			return true;
+		}
 		midi_driver->startSequence(SEQ_NUM_MUSIC, eventlist, repeat, 255);
 		return true;
 	}
@@ -309,6 +319,9 @@ bool MyMidiPlayer::start_music(
 void MyMidiPlayer::set_repeat(bool newrepeat) {
 	if (ogg_enabled) {
 		ogg_set_repeat(newrepeat);
+	} else if (rendered_is_playing()) {
+		Pentagram::AudioMixer::get_instance()->setLoop(
+				rendered_instance_id, newrepeat ? -1 : 0);
 	} else if (midi_driver) {
 		midi_driver->setSequenceRepeat(SEQ_NUM_MUSIC, newrepeat);
 	}
@@ -388,65 +401,55 @@ int MyMidiPlayer::setup_timbre_for_track(std::string& str) {
 	return music_conversion;
 }
 
-void MyMidiPlayer::load_timbres() {
-	if (!midi_driver) {
-		return;
-	}
-
-	if (ogg_enabled) {
-		ogg_stop_track();
-	}
-
-	// Stop all playing sequences
-	for (int i = 0; i < midi_driver->maxSequences(); i++) {
-		midi_driver->finishSequence(i);
-	}
-
+// Does the driver need a timbre library loaded in this conversion mode?
+static bool Uses_timbres(MidiDriver* driver, int music_conversion) {
 	// No timbre Support!
-	if (midi_driver->noTimbreSupport()) {
-		return;
+	if (driver->noTimbreSupport()) {
+		return false;
 	}
 
 	// Not in a mode that uses Timbres
-	if (!midi_driver->isFMSynth() && !midi_driver->isMT32()
-		&& music_conversion != XMIDIFILE_CONVERT_NOCONVERSION) {
-		return;
-	}
+	return driver->isFMSynth() || driver->isMT32()
+		   || music_conversion == XMIDIFILE_CONVERT_NOCONVERSION;
+}
 
+// The timbre library to load into a driver that uses them, for timbre_lib.
+static void Find_timbre_library(
+		MidiDriver* driver, MyMidiPlayer::TimbreLibrary timbre_lib,
+		MidiDriver::TimbreLibraryType& type, const char*& filename,
+		int& index) {
 	const char* u7voice = nullptr;
 
 	// Black Gate Settings
-	if (GAME_BG && timbre_lib == TIMBRE_LIB_INTRO) {
+	if (GAME_BG && timbre_lib == MyMidiPlayer::TIMBRE_LIB_INTRO) {
 		u7voice = INTRO_TIM;
-	} else if (GAME_BG && timbre_lib != TIMBRE_LIB_ENDGAME) {
+	} else if (GAME_BG && timbre_lib != MyMidiPlayer::TIMBRE_LIB_ENDGAME) {
 		u7voice = U7VOICE_FLX;
 	}
 	// Serpent Isle
 	else if (
 			Game::get_game_type() == SERPENT_ISLE
-			&& timbre_lib == TIMBRE_LIB_MAINMENU) {
+			&& timbre_lib == MyMidiPlayer::TIMBRE_LIB_MAINMENU) {
 		u7voice = MAINMENU_TIM;
 	}
 
-	MidiDriver::TimbreLibraryType type;
-	const char*                   filename;
-	int                           index = -1;
+	index = -1;
 
 	// General Midi Mode - AdLib
-	if (timbre_lib == TIMBRE_LIB_GM && midi_driver->isFMSynth()) {
+	if (timbre_lib == MyMidiPlayer::TIMBRE_LIB_GM && driver->isFMSynth()) {
 		type     = MidiDriver::TIMBRE_LIBRARY_FMOPL_SETGM;
 		filename = "FMOPL_SETGM";
 		index    = -2;
 	}
 	// General Midi Mode - MT32
-	else if (timbre_lib == TIMBRE_LIB_GM) {
+	else if (timbre_lib == MyMidiPlayer::TIMBRE_LIB_GM) {
 		type     = MidiDriver::TIMBRE_LIBRARY_XMIDI_FILE;
 		filename = BUNDLE_CHECK(BUNDLE_EXULT_FLX, EXULT_FLX);
 		index    = EXULT_FLX_MTGM_MID;
 	}
 	// U7VOICE
 	else if (u7voice) {
-		if (midi_driver->isFMSynth()) {
+		if (driver->isFMSynth()) {
 			type  = MidiDriver::TIMBRE_LIBRARY_U7VOICE_AD;
 			index = 1;
 		} else {
@@ -457,7 +460,7 @@ void MyMidiPlayer::load_timbres() {
 	}
 	// XMIDI_MT and XMIDI_AD
 	else {
-		if (midi_driver->isFMSynth()) {
+		if (driver->isFMSynth()) {
 			type     = MidiDriver::TIMBRE_LIBRARY_XMIDI_AD;
 			filename = XMIDI_AD;
 		} else {
@@ -465,6 +468,46 @@ void MyMidiPlayer::load_timbres() {
 			filename = XMIDI_MT;
 		}
 	}
+}
+
+// Open a timbre library. Returns nullptr if it can't be found, or if there
+// is no file (index is -2).
+static std::unique_ptr<IDataSource> Open_timbre_library(
+		const char* filename, int index) {
+	if (index == -1) {
+		auto ds = std::make_unique<IFileDataSource>(filename);
+		if (!ds->good()) {
+			return nullptr;
+		}
+		return ds;
+	} else if (index >= 0) {
+		return std::make_unique<IExultDataSource>(filename, index);
+	}
+	return nullptr;
+}
+
+void MyMidiPlayer::load_timbres() {
+	if (!midi_driver) {
+		return;
+	}
+
+	if (ogg_enabled) {
+		ogg_stop_track();
+	}
+
+	// Stop all playing sequences
+	for (int i = 0; i < midi_driver->maxSequences(); i++) {
+		midi_driver->finishSequence(i);
+	}
+
+	if (!Uses_timbres(midi_driver.get(), music_conversion)) {
+		return;
+	}
+
+	MidiDriver::TimbreLibraryType type;
+	const char*                   filename;
+	int                           index;
+	Find_timbre_library(midi_driver.get(), timbre_lib, type, filename, index);
 
 	if (timbre_lib_filename == filename && timbre_lib_index == index
 		&& timbre_lib_game == Game::get_game_type()) {
@@ -475,15 +518,9 @@ void MyMidiPlayer::load_timbres() {
 	timbre_lib_index    = index;
 	timbre_lib_game     = Game::get_game_type();
 
-	std::unique_ptr<IDataSource> ds;
-
-	if (index == -1) {
-		ds = std::make_unique<IFileDataSource>(filename);
-		if (!ds->good()) {
-			return;
-		}
-	} else if (index >= 0) {
-		ds = std::make_unique<IExultDataSource>(filename, index);
+	std::unique_ptr<IDataSource> ds = Open_timbre_library(filename, index);
+	if (!ds && index != -2) {
+		return;
 	}
 
 	// Note: ds can be null here if inde == -2. In this case, the pointer
@@ -502,6 +539,7 @@ void MyMidiPlayer::stop_music(bool quitting) {
 	if (ogg_enabled) {
 		ogg_stop_track();
 	}
+	rendered_stop_track();
 	if (midi_driver) {
 		midi_driver->finishSequence(SEQ_NUM_MUSIC);
 	}
@@ -515,6 +553,9 @@ bool MyMidiPlayer::is_track_playing(int num) {
 	if (ogg_enabled && ogg_is_playing()) {
 		return true;
 	}
+	if (rendered_is_playing()) {
+		return true;
+	}
 	if (midi_driver && midi_driver->isSequencePlaying(0)) {
 		return true;
 	}
@@ -530,6 +571,9 @@ int MyMidiPlayer::get_current_track() const {
 	if (ogg_enabled && ogg_is_playing()) {
 		return current_track;
 	}
+	if (rendered_is_playing()) {
+		return current_track;
+	}
 	if (midi_driver && midi_driver->isSequencePlaying(0)) {
 		return current_track;
 	}
@@ -546,6 +590,9 @@ uint32 MyMidiPlayer::get_track_length() {
 	if (ogg_enabled && mixer->isPlaying(ogg_instance_id)) {
 		return mixer->GetPlaybackLength(ogg_instance_id);
 	}
+	if (rendered_is_playing()) {
+		return mixer->GetPlaybackLength(rendered_instance_id);
+	}
 	if (midi_driver && midi_driver->isSequencePlaying(0)) {
 		return midi_driver->getPlaybackLength(0);
 	}
@@ -561,6 +608,9 @@ uint32 MyMidiPlayer::get_track_position() {
 	if (ogg_enabled && mixer->isPlaying(ogg_instance_id)) {
 		return mixer->GetPlaybackPosition(ogg_instance_id);
 	}
+	if (rendered_is_playing()) {
+		return mixer->GetPlaybackPosition(rendered_instance_id);
+	}
 	if (midi_driver && midi_driver->isSequencePlaying(0)) {
 		return midi_driver->getPlaybackPosition(0);
 	}
@@ -643,6 +693,7 @@ void MyMidiPlayer::set_midi_driver(
 		}
 		midi_driver = nullptr;
 		initialized = false;
+		render_cache.reset();
 	}
 
 	ogg_enabled      = use_oggs;
@@ -700,6 +751,11 @@ bool MyMidiPlayer::init_device(bool timbre_load) {
 		std::cout << "Never" << std::endl;
 	}
 
+	// How far ahead of the mixer software synths run, in ms.
+	int latency;
+	config->value("config/audio/midi/synth_latency", latency, 60);
+	LowLevelMidiDriver::synthLatency = std::clamp(latency, 0, 500);
+
 #ifdef ENABLE_MIDISFX
 	const bool sfx = Audio::get_ptr()->are_effects_enabled();
 
@@ -751,6 +807,11 @@ bool MyMidiPlayer::init_device(bool timbre_load) {
 	std::cout << "OGG Vorbis Digital Music: "
 			  << (ogg_enabled ? "Enabled" : "Disabled") << std::endl;
 
+	// Render tracks ahead of time
+	config->value("config/audio/midi/prerender", s, "no");
+	prerender = (s == "yes");
+	config->set("config/audio/midi/prerender", prerender ? "yes" : "no", true);
+
 	Pentagram::AudioMixer* mixer = Pentagram::AudioMixer::get_instance();
 	midi_driver                  = MidiDriver::createInstance(
             s, mixer->getSampleRate(), mixer->getStereo());
@@ -850,6 +911,8 @@ MyMidiPlayer::MyMidiPlayer() {
 
 MyMidiPlayer::~MyMidiPlayer() {
 	ogg_stop_track();
+	rendered_stop_track();
+	render_cache.reset();
 	if (midi_driver) {
 		midi_driver->destroyMidiDriver();
 		midi_driver = nullptr;
@@ -857,6 +920,7 @@ MyMidiPlayer::~MyMidiPlayer() {
 }
 
 void MyMidiPlayer::destroyMidiDriver() {
+	render_cache.reset();
 	if (midi_driver) {
 		midi_driver->destroyMidiDriver();
 		midi_driver = nullptr;
@@ -1106,7 +1170,83 @@ void MyMidiPlayer::ogg_set_repeat(bool newrepeat) {
 	}
 }
 
+bool MyMidiPlayer::rendered_play_track(
+		const std::string& source, int num, int conversion,
+		XMidiEventList* eventlist, bool repeat) {
+	if (!midi_driver->canRenderOffline()) {
+		return false;
+	}
+
+	// The timbres are part of the sound, so they go in the name
+	const bool timbres = Uses_timbres(midi_driver.get(), music_conversion);
+	MidiDriver::TimbreLibraryType type{};
+	const char*                   filename = "";
+	int                           index    = -1;
+	std::string                   timbre_name;
+	if (timbres) {
+		Find_timbre_library(
+				midi_driver.get(), timbre_lib, type, filename, index);
+		timbre_name = filename + std::to_string(index);
+	}
+
+	Pentagram::AudioMixer* mixer = Pentagram::AudioMixer::get_instance();
+	const std::string      game
+			= Game::get_gametitle() + '_' + Game::get_modtitle();
+	const std::string name = MidiRenderCache::get_cache_name(
+			midi_driver->getName(), game, source, num, conversion,
+			timbre_name, mixer->getSampleRate(), mixer->getStereo());
+
+	if (Pentagram::AudioSample* sample = MidiRenderCache::find(name)) {
+		rendered_stop_track();
+		const int vol = (midi_driver->getGlobalVolume() * 255) / 100;
+		rendered_instance_id = mixer->playSample(
+				sample, repeat ? -1 : 0, INT_MAX, false, 65536, vol, vol);
+		sample->Release();
+		return rendered_instance_id != -1;
+	}
+
+	// Not rendered yet, so do it now for next time. If the renderer is busy
+	// with another track, this one waits till it's played again.
+	if (!render_cache) {
+		render_cache = std::make_unique<MidiRenderCache>();
+	}
+	if (!render_cache->get_driver(
+				midi_driver->getName(), mixer->getSampleRate(),
+				mixer->getStereo())) {
+		return false;
+	}
+	if (timbres && render_cache->get_timbres() != timbre_name) {
+		std::unique_ptr<IDataSource> ds = Open_timbre_library(filename, index);
+		if (!ds && index != -2) {
+			return false;
+		}
+		render_cache->load_timbres(timbre_name, ds.get(), type);
+	}
+	render_cache->start(eventlist, name);
+	return false;
+}
+
+void MyMidiPlayer::rendered_stop_track() {
+	if (rendered_instance_id != -1) {
+		Pentagram::AudioMixer* mixer = Pentagram::AudioMixer::get_instance();
+		mixer->stopSample(rendered_instance_id);
+		rendered_instance_id = -1;
+	}
+}
+
+bool MyMidiPlayer::rendered_is_playing() const {
+	if (rendered_instance_id != -1) {
+		Pentagram::AudioMixer* mixer = Pentagram::AudioMixer::get_instance();
+		return mixer->isPlaying(rendered_instance_id);
+	}
+	return false;
+}
+
 void MyMidiPlayer::setMidiPausedAll(bool state) {
+	if (rendered_is_playing()) {
+		Pentagram::AudioMixer::get_instance()->setPaused(
+				rendered_instance_id, state);
+	}
 	if (midi_driver) {
 		for (int seq = 0; seq < midi_driver->maxSequences(); seq++)
 		{
@@ -1159,6 +1299,11 @@ void MyMidiPlayer::SetMidiMusicVolume(int vol, bool savetoconfig) {
 	}
 
 	midi_driver->setGlobalVolume(vol);
+	if (rendered_is_playing()) {
+		const int mixvol = (vol * 255) / 100;
+		Pentagram::AudioMixer::get_instance()->setVolume(
+				rendered_instance_id, mixvol, mixvol);
+	}
 	if (savetoconfig) {
 		config->set(
 				"config/audio/midi/volume_" + midi_driver->getName(),
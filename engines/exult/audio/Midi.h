@@ -25,10 +25,12 @@
 #include "exult_constants.h"
 #include "fnames.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
 class MidiDriver;
+class MidiRenderCache;
 
 namespace Pentagram {
 	class AudioSample;
@@ -196,6 +198,20 @@ private:
 
 	void ogg_mix(sint16* stream, uint32 bytes);
 
+private:
+	// Tracks rendered ahead of time, for software synths that can.
+	bool                             prerender            = false;
+	sint32                           rendered_instance_id = -1;
+	std::unique_ptr<MidiRenderCache> render_cache;
+
+	// Play the rendering of a track if there is one, else start rendering
+	// it for next time. Returns false if it wasn't played.
+	bool rendered_play_track(
+			const std::string& source, int num, int conversion,
+			XMidiEventList* eventlist, bool repeat);
+	void rendered_stop_track();
+	bool rendered_is_playing() const;
+
 private:
 	uint16 looping_egg_count;
 
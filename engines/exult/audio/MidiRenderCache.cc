@@ -0,0 +1,294 @@
+/*
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// Includes Pentagram headers so we must include pent_include.h
+#include "pent_include.h"
+
+#include "MidiRenderCache.h"
+
+#include "AdpcmAudioSample.h"
+#include "LowLevelMidiDriver.h"
+#include "XMidiEventList.h"
+#include "databuf.h"
+#include "exceptions.h"
+#include "pathindex.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// Longest track rendered; longer ones are just played live.
+constexpr const uint32 MAX_RENDER_SECONDS = 10 * 60;
+
+/*
+ *  Start the thread, which waits for work.
+ */
+
+MidiRenderCache::MidiRenderCache() : thread(&MidiRenderCache::run, this) {}
+
+/*
+ *  Stop a render in progress, and the thread.
+ */
+
+MidiRenderCache::~MidiRenderCache() {
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		quit   = true;
+		cancel = true;
+	}
+	work_ready.notify_one();
+	thread.join();
+	if (job_list) {
+		job_list->decrementCounter();
+	}
+	if (driver) {
+		driver->destroyMidiDriver();
+	}
+}
+
+/*
+ *  Render each track given to start() until told to quit.
+ */
+
+void MidiRenderCache::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		work_ready.wait(lock, [this]() {
+			return quit || job_list;
+		});
+		if (quit) {
+			return;
+		}
+		XMidiEventList*   list = job_list;
+		const std::string path = job_path;
+		lock.unlock();
+		const bool done = render(list, path);
+		lock.lock();
+		if (!done) {
+			failed.insert(path);
+		}
+		job_list->decrementCounter();
+		job_list = nullptr;
+		busy     = false;
+	}
+}
+
+/*
+ *  Render a track to path, writing a temporary file first so that a
+ *  rendering is either all there or not at all.
+ */
+
+bool MidiRenderCache::render(XMidiEventList* list, const std::string& path) {
+	using Pentagram::AdpcmAudioSample;
+	const int         channels   = stereo ? 2 : 1;
+	const uint32      max_frames = rate * MAX_RENDER_SECONDS;
+	const std::string temp       = path + ".part";
+
+	std::vector<sint16> pending(AdpcmAudioSample::BLOCK_FRAMES * channels);
+	std::vector<uint8>  block(AdpcmAudioSample::BLOCK_BYTES * channels);
+	AdpcmAudioSample::Encoder encoder(channels);
+	uint32                    frames    = 0;    // Rendered.
+	uint32                    filled    = 0;    // Frames in pending.
+	uint32                    data_size = 0;
+	bool                      done      = false;
+	try {
+		OFileDataSource out(temp);
+		AdpcmAudioSample::writeHeader(&out, rate, channels, 0, 0);
+		const auto encode = [&]() {
+			encoder.encodeBlock(pending.data(), block.data());
+			out.write(block.data(), block.size());
+			data_size += block.size();
+			filled = 0;
+		};
+		done = driver->renderSequence(
+				list, [&](const sint16* samples, uint32 count) {
+					if (cancel || frames + count > max_frames) {
+						return false;
+					}
+					frames += count;
+					while (count) {
+						const uint32 take = std::min(
+								count,
+								AdpcmAudioSample::BLOCK_FRAMES - filled);
+						std::copy(
+								samples, samples + take * channels,
+								pending.begin() + filled * channels);
+						samples += take * channels;
+						filled += take;
+						count -= take;
+						if (filled == AdpcmAudioSample::BLOCK_FRAMES) {
+							encode();
+						}
+					}
+					return true;
+				});
+		if (done && filled) {
+			std::fill(pending.begin() + filled * channels, pending.end(), 0);
+			encode();
+		}
+		out.seek(0);
+		AdpcmAudioSample::writeHeader(&out, rate, channels, frames, data_size);
+		out.flush();
+		done = done && frames && out.good();
+	} catch (exult_exception&) {
+		done = false;
+	}
+	if (done) {
+		// Windows won't rename over a file.
+		std::remove(path.c_str());
+		done = std::rename(temp.c_str(), path.c_str()) == 0;
+	}
+	if (done) {
+		Path_index::get().add_file(path);
+	} else {
+		std::remove(temp.c_str());
+	}
+	return done;
+}
+
+/*
+ *  The file for a track. Everything that changes how it sounds is in the
+ *  name, so changing a setting just means other files get used.
+ */
+
+std::string MidiRenderCache::get_cache_name(
+		const std::string& driver_name, const std::string& game,
+		const std::string& source, int num, int conversion,
+		const std::string& timbre_lib, uint32 rate, bool stereo) {
+	// Leave out the <DATA>/ and such.
+	std::string file = source;
+	if (!file.empty() && file[0] == '<') {
+		const size_t end = file.find(">/");
+		if (end != std::string::npos) {
+			file.erase(0, end + 2);
+		}
+	}
+	std::string name = driver_name + '_' + game + '_' + file + '_'
+					   + std::to_string(num) + '_' + std::to_string(conversion)
+					   + '_' + timbre_lib + '_' + std::to_string(rate)
+					   + (stereo ? 's' : 'm');
+	for (char& c : name) {
+		if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-') {
+			c = '_';
+		}
+	}
+	return "<SAVEHOME>/cache/music/" + name + ".wav";
+}
+
+/*
+ *  Load a finished rendering.
+ */
+
+Pentagram::AudioSample* MidiRenderCache::find(const std::string& name) {
+	if (!U7exists(name)) {
+		return nullptr;
+	}
+	IFileDataSource ds(name);
+	if (!ds.good() || !Pentagram::AdpcmAudioSample::isThis(&ds)) {
+		return nullptr;
+	}
+	ds.seek(0);
+	const uint32 size = ds.getSize();
+	return new Pentagram::AdpcmAudioSample(ds.readN(size), size);
+}
+
+/*
+ *  Get the synth, made the first time and when the settings change.
+ */
+
+MidiDriver* MidiRenderCache::get_driver(
+		const std::string& driver_name, uint32 samp_rate, bool is_stereo) {
+	if (busy) {
+		return nullptr;
+	}
+	if (driver && driver->getName() == driver_name && rate == samp_rate
+		&& stereo == is_stereo) {
+		return driver.get();
+	}
+	if (driver) {
+		driver->destroyMidiDriver();
+		driver = nullptr;
+	}
+	timbres.clear();
+	rate   = samp_rate;
+	stereo = is_stereo;
+	if (driver_name == failed_driver) {
+		return nullptr;
+	}
+	driver = MidiDriver::createInstance(driver_name, rate, stereo);
+	// It falls back on other drivers, which we don't want.
+	if (!driver || driver->getName() != driver_name
+		|| !driver->canRenderOffline()) {
+		if (driver) {
+			driver->destroyMidiDriver();
+			driver = nullptr;
+		}
+		failed_driver = driver_name;
+		return nullptr;
+	}
+	return driver.get();
+}
+
+void MidiRenderCache::load_timbres(
+		const std::string& lib, IDataSource* ds,
+		MidiDriver::TimbreLibraryType type) {
+	if (busy || !driver) {
+		return;
+	}
+	// Nothing runs this synth until a render starts, so it must not wait
+	// for the timbres to be sent.
+	const bool precache = LowLevelMidiDriver::precacheTimbresOnStartup;
+	LowLevelMidiDriver::precacheTimbresOnStartup = false;
+	driver->loadTimbreLibrary(ds, type);
+	LowLevelMidiDriver::precacheTimbresOnStartup = precache;
+
+	timbres = lib;
+}
+
+/*
+ *  Hand a track to the thread.
+ */
+
+bool MidiRenderCache::start(XMidiEventList* list, const std::string& name) {
+	if (busy || !driver) {
+		return false;
+	}
+	const std::string path = get_system_path(name);
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		if (failed.count(path)) {
+			return false;
+		}
+	}
+	U7mkdir("<SAVEHOME>/cache", 0755);
+	U7mkdir("<SAVEHOME>/cache/music", 0755);
+
+	list->incrementCounter();
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		job_list = list;
+		job_path = path;
+		cancel   = false;
+		busy     = true;
+	}
+	work_ready.notify_one();
+	return true;
+}
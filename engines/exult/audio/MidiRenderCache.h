@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef MIDIRENDERCACHE_H
+#define MIDIRENDERCACHE_H
+
+#include "MidiDriver.h"
+#include "common_types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+class IDataSource;
+class XMidiEventList;
+
+namespace Pentagram {
+	class AudioSample;
+}
+
+/*
+ *  Music tracks rendered ahead of time by a second instance of a software
+ *  synth, kept as IMA ADPCM wave files in <SAVEHOME>/cache/music. One
+ *  track is rendered at a time, on a thread of its own, while the live
+ *  synth goes on playing it.
+ */
+class MidiRenderCache {
+	std::shared_ptr<MidiDriver> driver;
+	uint32                      rate   = 0;
+	bool                        stereo = false;
+	std::string                 timbres;    // Library loaded into driver.
+	std::string                 failed_driver;    // Couldn't be made.
+
+	std::mutex              mutex;
+	std::condition_variable work_ready;
+	bool                    quit = false;
+	std::atomic<bool>       busy{false};      // A render is queued or running.
+	std::atomic<bool>       cancel{false};    // Stop the current render.
+	std::string             job_path;         // File to write.
+	XMidiEventList*         job_list = nullptr;
+	std::set<std::string>   failed;    // Renders not to try again.
+	std::thread             thread;
+
+	void run();
+	bool render(XMidiEventList* list, const std::string& path);
+
+public:
+	MidiRenderCache();
+	~MidiRenderCache();
+	MidiRenderCache(const MidiRenderCache&)            = delete;
+	MidiRenderCache& operator=(const MidiRenderCache&) = delete;
+
+	// Name of the file for a track, from everything that changes its sound.
+	static std::string get_cache_name(
+			const std::string& driver_name, const std::string& game,
+			const std::string& source, int num, int conversion,
+			const std::string& timbre_lib, uint32 rate, bool stereo);
+	// The finished rendering, or nullptr. The caller gets a reference.
+	static Pentagram::AudioSample* find(const std::string& name);
+
+	// Is a render queued or running?
+	bool is_busy() const {
+		return busy;
+	}
+
+	// The synth to render with, created if needed. Only to be set up when
+	// not busy. Returns nullptr if the driver can't render ahead.
+	MidiDriver* get_driver(
+			const std::string& driver_name, uint32 samp_rate, bool is_stereo);
+
+	// Name of the timbre library loaded into the synth.
+	const std::string& get_timbres() const {
+		return timbres;
+	}
+
+	// Load a timbre library into the synth, when not busy.
+	void load_timbres(
+			const std::string& lib, IDataSource* ds,
+			MidiDriver::TimbreLibraryType type);
+
+	// Render a track into name. Takes a reference to list. Returns false
+	// if a render is already under way, or this one failed before.
+	bool start(XMidiEventList* list, const std::string& name);
+};
+
+#endif
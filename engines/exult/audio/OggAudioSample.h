@@ -54,6 +54,11 @@ namespace Pentagram {
 		uint32 decompressFrame(void* DecompData, void* samples) const override;
 		void   freeDecompressor(void* DecompData) const override;
 		void   rewind(void* DecompData) const override;
+
+		bool isStreamable() const override {
+			return true;
+		}
+
 		static ov_callbacks callbacks;
 
 		static size_t read_func(
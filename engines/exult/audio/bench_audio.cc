@@ -0,0 +1,566 @@
+/*
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// Headless benchmark of the audio engine. AudioMixer::MixAudio is called
+// directly, with the device paused, for channels of each kind of sample,
+// then a MIDI driver playing a fixed tune, then everything at once. For
+// each it prints the time per 1024 frame buffer, the longest buffer and
+// the allocations made while mixing.
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "pent_include.h"
+
+#include "AdpcmAudioSample.h"
+#include "AudioMixer.h"
+#include "Configuration.h"
+#include "LowLevelMidiDriver.h"
+#include "Midi.h"
+#include "MidiDriver.h"
+#include "MidiRenderCache.h"
+#include "OggAudioSample.h"
+#include "RawAudioSample.h"
+#include "VocAudioSample.h"
+#include "WavAudioSample.h"
+#include "XMidiEventList.h"
+#include "XMidiFile.h"
+#include "databuf.h"
+#include "game.h"
+#include "items.h"
+
+#ifdef __GNUC__
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wold-style-cast"
+#	pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#	if !defined(__llvm__) && !defined(__clang__)
+#		pragma GCC diagnostic ignored "-Wuseless-cast"
+#	endif
+#endif    // __GNUC__
+#include <SDL3/SDL.h>
+#ifdef __GNUC__
+#	pragma GCC diagnostic pop
+#endif    // __GNUC__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Pentagram::AudioMixer;
+using Pentagram::AudioSample;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+/*
+ *  Every allocation is counted, so that allocating in the audio callback
+ *  shows up.
+ */
+
+static std::atomic<uint64> allocations{0};
+
+void* operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = std::malloc(size ? size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t size) noexcept {
+	ignore_unused_variable_warning(size);
+	std::free(ptr);
+}
+
+/*
+ *  What the audio code needs from the rest of Exult.
+ */
+
+// The MIDI drivers read their settings from here.
+Configuration* config = new Configuration();
+
+// XMidiFile picks the MT-32 display messages by game.
+Exult_Game Game::game_type = BLACK_GATE;
+
+// Names of driver settings, shown in the game's menus.
+const char* get_text_msg(unsigned num) {
+	ignore_unused_variable_warning(num);
+	return "";
+}
+
+// AudioMixer plays music through MyMidiPlayer, which needs the whole game.
+// This one just plays the driver set up here.
+static std::shared_ptr<MidiDriver> bench_midi;
+
+MyMidiPlayer::MyMidiPlayer() {}
+
+MyMidiPlayer::~MyMidiPlayer() {}
+
+void MyMidiPlayer::load_timbres() {}
+
+void MyMidiPlayer::stop_music(bool quitting) {
+	ignore_unused_variable_warning(quitting);
+}
+
+void MyMidiPlayer::destroyMidiDriver() {}
+
+void MyMidiPlayer::setMidiPausedAll(bool state) {
+	ignore_unused_variable_warning(state);
+}
+
+void MyMidiPlayer::produceSamples(sint16* stream, uint32 bytes) {
+	if (bench_midi && bench_midi->isInitialized()
+		&& bench_midi->isSampleProducer()) {
+		bench_midi->produceSamples(stream, bytes);
+	}
+}
+
+/*
+ *  Test sounds, two seconds of each.
+ */
+
+static const uint32 SOUND_SECONDS = 2;
+
+static void Put2(std::vector<uint8>& out, uint32 val) {
+	out.push_back(val & 0xff);
+	out.push_back((val >> 8) & 0xff);
+}
+
+static void Put4(std::vector<uint8>& out, uint32 val) {
+	Put2(out, val & 0xffff);
+	Put2(out, val >> 16);
+}
+
+static std::unique_ptr<uint8[]> To_buffer(const std::vector<uint8>& data) {
+	auto buf = std::make_unique<uint8[]>(data.size());
+	std::copy(data.begin(), data.end(), buf.get());
+	return buf;
+}
+
+// A chord, so every sample changes.
+static std::vector<sint16> Make_tone(uint32 rate, int channels) {
+	std::vector<sint16> samples(rate * SOUND_SECONDS * channels);
+	for (size_t i = 0; i < samples.size(); i++) {
+		const double t = double(i / channels) / rate;
+		const double v = std::sin(2 * M_PI * 220 * t)
+						 + std::sin(2 * M_PI * 277 * t)
+						 + std::sin(2 * M_PI * 330 * t);
+		samples[i]     = static_cast<sint16>(v * 8000);
+	}
+	return samples;
+}
+
+// Sound effects: 8 bit unsigned mono.
+static AudioSample* Make_raw8() {
+	const uint32              rate = 11025;
+	const std::vector<sint16> tone = Make_tone(rate, 1);
+	std::vector<uint8>        data(tone.size());
+	for (size_t i = 0; i < tone.size(); i++) {
+		data[i] = static_cast<uint8>((tone[i] >> 8) + 128);
+	}
+	return new Pentagram::RawAudioSample(
+			To_buffer(data), data.size(), rate, false, false, 8);
+}
+
+// 16 bit signed stereo, as decoded copies are.
+static AudioSample* Make_raw16() {
+	const uint32              rate = 22050;
+	const std::vector<sint16> tone = Make_tone(rate, 2);
+	const uint32              size = tone.size() * 2;
+	auto                      buf  = std::make_unique<uint8[]>(size);
+	std::memcpy(buf.get(), tone.data(), size);
+	return new Pentagram::RawAudioSample(
+			std::move(buf), size, rate, true, true, 16);
+}
+
+// Speech: Creative ADPCM. Noise decodes just as slowly as speech.
+static AudioSample* Make_voc() {
+	std::vector<uint8> data;
+	const char         magic[] = "Creative Voice File\x1a";
+	data.insert(data.end(), magic, magic + 20);
+	Put2(data, 0x1a);      // Data offset
+	Put2(data, 0x010a);    // Version
+	Put2(data, 0x1129);    // Check
+	const uint32 bytes = 11111 * SOUND_SECONDS / 2;
+	data.push_back(1);    // Sound data
+	const uint32 len = bytes + 1 + 2;
+	data.push_back(len & 0xff);
+	data.push_back((len >> 8) & 0xff);
+	data.push_back((len >> 16) & 0xff);
+	data.push_back(256 - 1000000 / 11111);
+	data.push_back(1);      // 4 bit ADPCM
+	data.push_back(128);    // Reference sample
+	uint32 seed = 12345;
+	for (uint32 i = 0; i < bytes; i++) {
+		seed = seed * 1103515245 + 12345;
+		data.push_back((seed >> 16) & 0xff);
+	}
+	data.push_back(0);    // Terminator
+	return new Pentagram::VocAudioSample(To_buffer(data), data.size());
+}
+
+// 16 bit mono PCM wave.
+static AudioSample* Make_wav() {
+	const uint32              rate = 22050;
+	const std::vector<sint16> tone = Make_tone(rate, 1);
+	std::vector<uint8>        data;
+	const uint32              data_size = tone.size() * 2;
+	data.insert(data.end(), {'R', 'I', 'F', 'F'});
+	Put4(data, 4 + 8 + 16 + 8 + data_size);
+	data.insert(data.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+	Put4(data, 16);
+	Put2(data, 1);    // PCM
+	Put2(data, 1);
+	Put4(data, rate);
+	Put4(data, rate * 2);
+	Put2(data, 2);
+	Put2(data, 16);
+	data.insert(data.end(), {'d', 'a', 't', 'a'});
+	Put4(data, data_size);
+	for (const sint16 s : tone) {
+		Put2(data, static_cast<uint16>(s));
+	}
+	return new Pentagram::WavAudioSample(To_buffer(data), data.size());
+}
+
+// Prerendered music: IMA ADPCM wave.
+static AudioSample* Make_adpcm() {
+	using Pentagram::AdpcmAudioSample;
+	const uint32              rate   = 22050;
+	const std::vector<sint16> tone   = Make_tone(rate, 1);
+	const uint32              blocks = tone.size() / AdpcmAudioSample::BLOCK_FRAMES;
+	const uint32 data_size = blocks * AdpcmAudioSample::BLOCK_BYTES;
+
+	const uint32    size = 60 + data_size;
+	auto            buf  = std::make_unique<uint8[]>(size);
+	OBufferDataSpan out(buf.get(), size);
+	AdpcmAudioSample::writeHeader(
+			&out, rate, 1, blocks * AdpcmAudioSample::BLOCK_FRAMES, data_size);
+	AdpcmAudioSample::Encoder encoder(1);
+	std::vector<uint8>        block(AdpcmAudioSample::BLOCK_BYTES);
+	for (uint32 i = 0; i < blocks; i++) {
+		encoder.encodeBlock(
+				tone.data() + i * AdpcmAudioSample::BLOCK_FRAMES, block.data());
+		out.write(block.data(), block.size());
+	}
+	return new AdpcmAudioSample(std::move(buf), size);
+}
+
+/*
+ *  The MIDI tune: a standard MIDI file of chords on eight instruments,
+ *  with drums, so the synth always has some twenty notes going.
+ */
+
+static void Put_var(std::vector<uint8>& out, uint32 val) {
+	uint8 bytes[4];
+	int   count = 0;
+	do {
+		bytes[count++] = val & 0x7f;
+		val >>= 7;
+	} while (val);
+	while (count--) {
+		out.push_back(bytes[count] | (count ? 0x80 : 0));
+	}
+}
+
+static std::vector<uint8> Make_tune() {
+	static const uint8 programs[8] = {0, 24, 32, 40, 48, 56, 73, 88};
+	static const int   chords[4][3] = {
+            {60, 64, 67},
+            {57, 60, 64},
+            {53, 57, 60},
+            {55, 59, 62}
+    };
+	const uint32 quarter = 120;
+
+	std::vector<uint8> track;
+	for (uint8 chan = 0; chan < 8; chan++) {
+		Put_var(track, 0);
+		track.push_back(0xC0 | chan);
+		track.push_back(programs[chan]);
+	}
+	for (int bar = 0; bar < 16; bar++) {
+		for (int beat = 0; beat < 4; beat++) {
+			const int* chord = chords[bar % 4];
+			for (uint8 chan = 0; chan < 8; chan++) {
+				for (int n = 0; n < 3; n++) {
+					Put_var(track, 0);
+					track.push_back(0x90 | chan);
+					track.push_back(chord[n] + 12 * (chan % 3 - 1));
+					track.push_back(80);
+				}
+			}
+			Put_var(track, 0);
+			track.push_back(0x99);
+			track.push_back(beat % 2 ? 38 : 36);
+			track.push_back(100);
+			Put_var(track, quarter);
+			for (uint8 chan = 0; chan < 8; chan++) {
+				for (int n = 0; n < 3; n++) {
+					Put_var(track, 0);
+					track.push_back(0x80 | chan);
+					track.push_back(chord[n] + 12 * (chan % 3 - 1));
+					track.push_back(0);
+				}
+			}
+			Put_var(track, 0);
+			track.push_back(0x89);
+			track.push_back(beat % 2 ? 38 : 36);
+			track.push_back(0);
+		}
+	}
+	Put_var(track, 0);
+	track.insert(track.end(), {0xff, 0x2f, 0x00});
+
+	std::vector<uint8> file = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1};
+	file.push_back(quarter >> 8);
+	file.push_back(quarter & 0xff);
+	file.insert(file.end(), {'M', 'T', 'r', 'k'});
+	const uint32 len = track.size();
+	file.insert(
+			file.end(), {uint8(len >> 24), uint8(len >> 16), uint8(len >> 8),
+						 uint8(len)});
+	file.insert(file.end(), track.begin(), track.end());
+	return file;
+}
+
+/*
+ *  Running the mixer.
+ */
+
+struct Options {
+	int         channels = 8;    // Of each kind of sample.
+	int         buffers  = 2000;
+	int         rate     = 22050;
+	bool        sinc     = false;
+	bool        paced    = false;
+	uint32      latency  = 60;
+	uint32      ahead    = 500;
+	uint32      cache_kb = 4096;
+	std::string driver   = "FMOpl";
+	std::string ogg_file;
+};
+
+static const uint32 BUFFER_FRAMES = 1024;
+
+// Mix the buffers and print the times. Paced runs mix a buffer only when
+// a device would ask for one, as a synth thread needs.
+static void Run(
+		AudioMixer* mixer, const Options& opts, const std::string& name) {
+	const uint32        bytes = BUFFER_FRAMES * 2 * 2;
+	std::vector<sint16> buffer(BUFFER_FRAMES * 2);
+	// Get the commands applied and any decoding started.
+	for (int i = 0; i < 10; i++) {
+		mixer->MixAudio(buffer.data(), bytes);
+	}
+
+	using clock = std::chrono::steady_clock;
+	const auto period = std::chrono::duration_cast<clock::duration>(
+			std::chrono::duration<double>(double(BUFFER_FRAMES) / opts.rate));
+	auto            next         = clock::now();
+	clock::duration total        = {};
+	clock::duration worst        = {};
+	const uint64    start_allocs = allocations;
+	for (int i = 0; i < opts.buffers; i++) {
+		if (opts.paced) {
+			next += period;
+			std::this_thread::sleep_until(next);
+		}
+		const auto start = clock::now();
+		mixer->MixAudio(buffer.data(), bytes);
+		const auto took = clock::now() - start;
+		total += took;
+		worst = std::max(worst, took);
+	}
+	const uint64 allocs = allocations - start_allocs;
+
+	using std::chrono::duration_cast;
+	using std::chrono::nanoseconds;
+	const double per_buffer
+			= duration_cast<nanoseconds>(total).count() / 1000.0 / opts.buffers;
+	const double budget = 1e6 * BUFFER_FRAMES / opts.rate;
+	cout << std::left << std::setw(12) << name << std::right << std::fixed
+		 << std::setprecision(1) << std::setw(10) << per_buffer << " us"
+		 << std::setw(10)
+		 << duration_cast<nanoseconds>(worst).count() / 1000.0 << " us"
+		 << std::setw(8) << 100 * per_buffer / budget << " %" << std::setw(10)
+		 << allocs << endl;
+}
+
+static void Play(AudioMixer* mixer, AudioSample* sample, int count) {
+	for (int i = 0; i < count; i++) {
+		// Spread the pitches, so the channels don't all resample alike.
+		const uint32 pitch = AUDIO_DEF_PITCH + (i * AUDIO_DEF_PITCH) / 64;
+		mixer->playSample(sample, -1, 100, false, pitch, 128, 128);
+	}
+}
+
+static void Usage(const char* prog) {
+	cerr << "Usage: " << prog << " [options]\n"
+		 << "  -c N      channels of each kind of sample (8)\n"
+		 << "  -n N      buffers mixed in each run (2000)\n"
+		 << "  -r RATE   output rate (22050)\n"
+		 << "  -s        use the windowed sinc resampler\n"
+		 << "  -p        mix in real time, as a device would ask\n"
+		 << "  -m NAME   MIDI driver (FMOpl)\n"
+		 << "  -l MS     synth thread latency, 0 for none (60)\n"
+		 << "  -a MS     stream long sounds this far ahead, 0 for none "
+			"(500)\n"
+		 << "  -k KB     decoded sound cache (4096)\n"
+		 << "  -o FILE   also play an Ogg Vorbis file" << endl;
+}
+
+int main(int argc, char* argv[]) {
+	Options opts;
+	for (int i = 1; i < argc; i++) {
+		const std::string arg  = argv[i];
+		const char*       next = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (arg == "-s") {
+			opts.sinc = true;
+		} else if (arg == "-p") {
+			opts.paced = true;
+		} else if (next && arg == "-c") {
+			opts.channels = std::max(1, std::atoi(argv[++i]));
+		} else if (next && arg == "-n") {
+			opts.buffers = std::max(1, std::atoi(argv[++i]));
+		} else if (next && arg == "-r") {
+			opts.rate = std::max(8000, std::atoi(argv[++i]));
+		} else if (next && arg == "-m") {
+			opts.driver = argv[++i];
+		} else if (next && arg == "-l") {
+			opts.latency = std::max(0, std::atoi(argv[++i]));
+		} else if (next && arg == "-a") {
+			opts.ahead = std::max(0, std::atoi(argv[++i]));
+		} else if (next && arg == "-k") {
+			opts.cache_kb = std::max(0, std::atoi(argv[++i]));
+		} else if (next && arg == "-o") {
+			opts.ogg_file = argv[++i];
+		} else {
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+
+	// Nothing is played, so any machine will do.
+	SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+
+	struct Kind {
+		std::string  name;
+		AudioSample* sample;
+	};
+
+	std::vector<Kind> kinds = {
+			{  "raw8",   Make_raw8()},
+			{ "raw16",  Make_raw16()},
+			{   "voc",    Make_voc()},
+			{   "wav",    Make_wav()},
+			{ "adpcm",  Make_adpcm()},
+	};
+	if (!opts.ogg_file.empty()) {
+		try {
+			auto ds = std::make_unique<IFileDataSource>(opts.ogg_file);
+			kinds.push_back(
+					{"ogg", new Pentagram::OggAudioSample(std::move(ds))});
+		} catch (const std::exception& err) {
+			cerr << "Can't play " << opts.ogg_file << ": " << err.what()
+				 << endl;
+			return 1;
+		}
+	}
+
+	auto mixer = std::make_unique<AudioMixer>(
+			opts.rate, true, opts.channels * static_cast<int>(kinds.size()));
+	opts.rate = mixer->getSampleRate();
+	if (!mixer->getStereo()) {
+		cerr << "Couldn't open the audio in stereo" << endl;
+		return 1;
+	}
+	mixer->pauseDevice(true);
+	mixer->setResampler(
+			opts.sinc ? Pentagram::AudioResampler::Sinc
+					  : Pentagram::AudioResampler::Cubic);
+	mixer->setStreamAhead(opts.ahead);
+	mixer->setDecodedCacheLimit(opts.cache_kb * 1024);
+	mixer->openMidiOutput();
+
+	cout << opts.channels << " channels of each, " << opts.buffers
+		 << " buffers of " << BUFFER_FRAMES << " frames at " << opts.rate
+		 << " Hz" << (opts.sinc ? ", sinc" : ", cubic")
+		 << (opts.paced ? ", paced" : "") << endl
+		 << endl
+		 << std::left << std::setw(12) << "run" << std::right << std::setw(13)
+		 << "per buffer" << std::setw(13) << "worst" << std::setw(10)
+		 << "of time" << std::setw(10) << "allocs" << endl;
+
+	for (const Kind& kind : kinds) {
+		Play(mixer.get(), kind.sample, opts.channels);
+		Run(mixer.get(), opts, kind.name);
+		mixer->reset();
+	}
+
+	LowLevelMidiDriver::synthLatency = opts.latency;
+	bench_midi = MidiDriver::createInstance(opts.driver, opts.rate, true);
+	std::vector<uint8>         tune = Make_tune();
+	std::unique_ptr<XMidiFile> midfile;
+	if (bench_midi) {
+		IBufferDataView ds(tune.data(), tune.size());
+		midfile = std::make_unique<XMidiFile>(
+				&ds, XMIDIFILE_CONVERT_NOCONVERSION, bench_midi->getName());
+		XMidiEventList* eventlist = midfile->GetEventList(0);
+		if (eventlist) {
+			bench_midi->startSequence(0, eventlist, true, 255);
+		}
+		cout << "MIDI: " << bench_midi->getName() << endl;
+		Run(mixer.get(), opts, "midi");
+
+		for (const Kind& kind : kinds) {
+			Play(mixer.get(), kind.sample, opts.channels);
+		}
+		Run(mixer.get(), opts, "all");
+		mixer->reset();
+
+		bench_midi->finishSequence(0);
+		bench_midi->destroyMidiDriver();
+	} else {
+		cerr << "Couldn't open MIDI driver " << opts.driver << endl;
+	}
+
+	// The driver prints its synth thread timings as it goes.
+	mixer.reset();
+	bench_midi.reset();
+	for (const Kind& kind : kinds) {
+		kind.sample->Release();
+	}
+	return 0;
+}
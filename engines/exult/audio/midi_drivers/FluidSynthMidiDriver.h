@@ -87,6 +87,10 @@ protected:
 	bool noTimbreSupport() override {
 		return true;
 	}
+
+	bool canRenderOffline() override {
+		return true;
+	}
 };
 
 #endif
@@ -26,9 +26,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "XMidiFile.h"
 #include "XMidiSequence.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <mutex>
+#include <vector>
 // If the time to wait is less than this then we yield instead of waiting on the
 // condition variable This must be great than or equal to 2
 #define LLMD_MINIMUM_YIELD_THRESHOLD 6
@@ -117,6 +119,8 @@ bool LowLevelMidiDriver::precacheTimbresOnStartup = false;
 
 bool LowLevelMidiDriver::precacheTimbresOnPlay = false;
 
+uint32 LowLevelMidiDriver::synthLatency = 0;
+
 //
 // All Dev Reset
 //
@@ -145,6 +149,7 @@ LowLevelMidiDriver::~LowLevelMidiDriver() {
 				"destroyMidiDriver() wasn't called!"
 			 << std::endl;
 		// destroyMidiDriver();
+		stopSynthThread();
 		quit_thread = true;    // The thread should stop based upon this flag
 		if (thread) {
 			thread->detach();    // calling join might not be safe as the driver
@@ -226,6 +231,9 @@ int LowLevelMidiDriver::initMidiDriver(uint32 samp_rate, bool is_stereo) {
 		cond.reset();
 	} else {
 		initialized = true;
+		if (isSampleProducer() && synthLatency) {
+			startSynthThread();
+		}
 	}
 
 	return code;
@@ -703,6 +711,9 @@ int LowLevelMidiDriver::initSoftwareSynth() {
 }
 
 void LowLevelMidiDriver::destroySoftwareSynth() {
+	// From here on the mixer runs the synth, as without the thread
+	stopSynthThread();
+
 	// Will cause the synth to set it self uninitialized
 	ComMessage message(LLMD_MSG_THREAD_EXIT, -1);
 	sendComMessage(message);
@@ -724,6 +735,83 @@ void LowLevelMidiDriver::destroySoftwareSynth() {
 }
 
 void LowLevelMidiDriver::produceSamples(sint16* samples, uint32 bytes) {
+	if (!synth_threaded) {
+		synthesizeSamples(samples, bytes);
+		return;
+	}
+	// The mixer zeroed the buffer, so anything the thread hasn't got to
+	// yet is silence
+	const size_t wanted = bytes / 2;
+	if (synth_ring->pop(samples, wanted) < wanted) {
+		synth_underruns++;
+	}
+}
+
+void LowLevelMidiDriver::startSynthThread() {
+	// Room for the target and one chunk more
+	const int    stereo_mult = stereo ? 2 : 1;
+	const uint64 frames
+			= uint64(sample_rate) * synthLatency / 1000 + sample_rate / 200 + 1;
+	synth_ring = std::make_unique<Pentagram::SPSCQueue<sint16>>(
+			frames * stereo_mult);
+	synth_chunks    = 0;
+	synth_time      = {};
+	synth_max       = {};
+	synth_underruns = 0;
+	quit_synth      = false;
+	synth_threaded  = true;
+	synth_thread    = std::make_unique<std::thread>(
+			&LowLevelMidiDriver::synthThreadMain, this);
+}
+
+void LowLevelMidiDriver::stopSynthThread() {
+	if (!synth_thread) {
+		return;
+	}
+	quit_synth = true;
+	synth_thread->join();
+	synth_thread.reset();
+	synth_threaded = false;
+	synth_ring.reset();
+
+	if (synth_chunks) {
+		COUT(getName() << " synth thread: " << synth_chunks
+					   << " chunks, average "
+					   << synth_time.count() / synth_chunks / 1000
+					   << " us, longest " << synth_max.count() / 1000
+					   << " us, " << synth_underruns << " underruns");
+	}
+}
+
+void LowLevelMidiDriver::synthThreadMain() {
+	// Chunks of 5 ms, small enough to top the ring up often
+	const int    stereo_mult = stereo ? 2 : 1;
+	const uint32 frames      = std::max<uint32>(sample_rate / 200, 1);
+	const size_t chunk       = frames * stereo_mult;
+	const size_t ahead
+			= uint64(sample_rate) * synthLatency / 1000 * stereo_mult;
+	const size_t target = std::max(ahead, chunk);
+	std::vector<sint16> block(chunk);
+
+	while (!quit_synth && initialized) {
+		if (synth_ring->size() + chunk > target) {
+			// Far enough ahead. The mixer takes a buffer at a time, every
+			// 10 ms or more, so there's no hurry.
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			continue;
+		}
+		std::fill(block.begin(), block.end(), 0);
+		const auto start = std::chrono::steady_clock::now();
+		synthesizeSamples(block.data(), chunk * 2);
+		const auto took = std::chrono::steady_clock::now() - start;
+		synth_chunks++;
+		synth_time += took;
+		synth_max = std::max<std::chrono::nanoseconds>(synth_max, took);
+		synth_ring->push(block.data(), chunk);
+	}
+}
+
+void LowLevelMidiDriver::synthesizeSamples(sint16* samples, uint32 bytes) {
 	// Hey, we're not supposed to be here
 	if (!initialized) {
 		return;
@@ -828,6 +916,43 @@ void LowLevelMidiDriver::produceSamples(sint16* samples, uint32 bytes) {
 	}
 }
 
+bool LowLevelMidiDriver::renderSequence(
+		XMidiEventList* eventlist,
+		const std::function<bool(const sint16*, uint32)>& out) {
+	// Only software synths can be run faster than real time
+	if (!initialized || !isSampleProducer()) {
+		return false;
+	}
+	// Nothing takes from the ring here
+	stopSynthThread();
+
+	// Blocks of about a tenth of a second
+	const int           stereo_mult = stereo ? 2 : 1;
+	const uint32        frames      = sample_rate / 10;
+	const uint32        bytes       = frames * 2 * stereo_mult;
+	std::vector<sint16> block(frames * stereo_mult);
+
+	// Nothing else will run the timbre upload, so run it here. Its output
+	// is just the synth being set up.
+	while (uploading_timbres && initialized
+		   && (peekComMessageType() || playing[3])) {
+		std::fill(block.begin(), block.end(), 0);
+		synthesizeSamples(block.data(), bytes);
+	}
+	uploading_timbres = false;
+
+	startSequence(0, eventlist, false, 255);
+	while (initialized && (peekComMessageType() || playing[0])) {
+		std::fill(block.begin(), block.end(), 0);
+		synthesizeSamples(block.data(), bytes);
+		if (!out(block.data(), frames)) {
+			finishSequence(0);
+			return false;
+		}
+	}
+	return initialized;
+}
+
 //
 // Shared Stuff
 //
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define LOWLEVELMIDIDRIVER_H_INCLUDED
 
 #include "MidiDriver.h"
+#include "SPSCQueue.h"
 #include "XMidiSequenceHandler.h"
 #include "common_types.h"
 #include "ignore_unused_variable_warning.h"
@@ -90,10 +91,17 @@ public:
 
 	void produceSamples(sint16* samples, uint32 bytes) override;
 
+	bool renderSequence(
+			XMidiEventList* eventlist,
+			const std::function<bool(const sint16*, uint32)>& out) override;
+
 	void loadTimbreLibrary(IDataSource*, TimbreLibraryType type) override;
 
 	static bool precacheTimbresOnStartup;
 	static bool precacheTimbresOnPlay;
+	//! How far ahead, in ms, software synths run on a thread of their own.
+	//! 0 synthesizes in produceSamples instead.
+	static uint32 synthLatency;
 
 protected:
 	LowLevelMidiDriver(std::string&& name) : MidiDriver(std::move(name)) {}
@@ -382,6 +390,23 @@ private:
 	// Software methods
 	int  initSoftwareSynth();
 	void destroySoftwareSynth();
+	void synthesizeSamples(sint16* samples, uint32 bytes);
+
+	// Synth thread, keeping synth_ring filled synthLatency ms ahead of
+	// produceSamples, which then only copies out of it.
+	void startSynthThread();
+	void stopSynthThread();
+	void synthThreadMain();
+
+	std::unique_ptr<Pentagram::SPSCQueue<sint16>> synth_ring;
+	std::unique_ptr<std::thread>                  synth_thread;
+	std::atomic_bool                              quit_synth;
+	std::atomic_bool                              synth_threaded{false};
+	// Timing of the synth thread, for the log
+	uint32                   synth_chunks;
+	std::chrono::nanoseconds synth_time;
+	std::chrono::nanoseconds synth_max;
+	std::atomic_uint32_t     synth_underruns;
 
 	// XMidiSequenceHandler implementation
 	void sequenceSendEvent(uint16 sequence_id, uint32 message) override;
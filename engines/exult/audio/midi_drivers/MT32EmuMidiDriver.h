@@ -81,6 +81,10 @@ protected:
 	bool isMT32() override {
 		return true;
 	}
+
+	bool canRenderOffline() override {
+		return true;
+	}
 };
 
 #endif    // USE_MT32EMU_MIDI
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "items.h"
 
 #include <atomic>
+#include <functional>
 #include <string>
 class XMidiEventList;
 class IDataSource;
@@ -231,6 +232,25 @@ public:
 		ignore_unused_variable_warning(type);
 	}
 
+	//! Can an instance of its own render sequences ahead of time, while
+	//! another plays? Synths with global state can't.
+	virtual bool canRenderOffline() {
+		return false;
+	}
+
+	//! Render a whole sequence, without repeating, as fast as possible.
+	//! Only for an instance that isn't otherwise playing.
+	//! \param eventlist The sequence to render
+	//! \param out Called with each block of samples and its frame count.
+	//! Returning false stops the render.
+	//! \return true if the sequence was rendered to the end
+	virtual bool renderSequence(
+			XMidiEventList* eventlist,
+			const std::function<bool(const sint16*, uint32)>& out) {
+		ignore_unused_variable_warning(eventlist, out);
+		return false;
+	}
+
 	//! Destructor
 	virtual ~MidiDriver() = default;
 
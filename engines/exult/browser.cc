@@ -35,7 +35,7 @@
 
 #include "browser.h"
 #include "exult.h"
-#include "files/U7file.h"
+#include "U7file.h"
 #include "font.h"
 #include "game.h"
 #include "gamewin.h"
@@ -29,11 +29,12 @@
 
 #include "Configuration.h"
 #include "Gump_manager.h"
+#include "Hpastar.h"
 #include "actors.h"
 #include "cheat.h"
 #include "chunks.h"
 #include "exult.h"
-#include "files/U7file.h"    // IWYU pragma: keep
+#include "U7file.h"    // IWYU pragma: keep
 #include "font.h"
 #include "game.h"
 #include "gameclk.h"
@@ -1157,6 +1158,15 @@ void CheatScreen::NormalDisplay() {
 			t.tz);
 	font->paint_text_fixedwidth(
 			ibuf, buf, offsetx, 81 - offsety2, 8, fontcolor.colors);
+
+	unsigned hits;
+	unsigned misses;
+	Hpastar::get_kept_stats(hits, misses);
+	snprintf(
+			buf, sizeof(buf), "Kept paths used %u of %u times", hits,
+			hits + misses);
+	font->paint_text_fixedwidth(
+			ibuf, buf, offsetx, 90 - offsety2, 8, fontcolor.colors);
 }
 
 void CheatScreen::NormalMenu() {
@@ -401,6 +401,48 @@ bool Combat_schedule::is_enemy(int align, int other) {
 	return true;    // This should never happen.
 }
 
+/*
+ *  The nearby NPC's and the Avatar, sorted by alignment once a frame so
+ *  each fighter looking for opponents need only walk the hostile ones.
+ *  Alignments can change during the frame, so callers check them again.
+ */
+
+namespace {
+	class Combat_broadphase {
+		unsigned int                  stamp = 0;
+		bool                          valid = false;
+		std::vector<Game_object_weak> by_alignment[4];
+
+	public:
+		void update(Game_window* gwin);
+
+		const std::vector<Game_object_weak>& get(int align) const {
+			return by_alignment[align];
+		}
+	};
+
+	void Combat_broadphase::update(Game_window* gwin) {
+		const unsigned int now = Game::get_ticks();
+		if (valid && now == stamp) {
+			return;
+		}
+		stamp = now;
+		valid = true;
+		for (auto& bucket : by_alignment) {
+			bucket.clear();
+		}
+		Actor_vector nearby;
+		gwin->get_nearby_npcs(nearby);
+		nearby.push_back(gwin->get_main_actor());    // Incl. Avatar!
+		for (auto* actor : nearby) {
+			by_alignment[actor->get_effective_alignment() & 3].push_back(
+					actor->weak_from_this());
+		}
+	}
+
+	Combat_broadphase combatants;
+}    // namespace
+
 /*
  *  Find nearby opponents in the 9 surrounding chunks.
  */
@@ -408,11 +450,9 @@ bool Combat_schedule::is_enemy(int align, int other) {
 void Combat_schedule::find_opponents() {
 	opponents.clear();
 	Game_window* gwin = Game_window::get_instance();
-	Actor_vector nearby;
-	Actor_vector sleeping;    // Get all nearby NPC's.
-	gwin->get_nearby_npcs(nearby);
+	Actor_vector sleeping;
+	combatants.update(gwin);    // Get all nearby NPC's.
 	Actor* avatar = gwin->get_main_actor();
-	nearby.push_back(avatar);    // Incl. Avatar!
 	const bool charmed_avatar
 			= Combat::charmed_more_difficult
 			  && avatar->get_effective_alignment() != Actor::good;
@@ -420,6 +460,19 @@ void Combat_schedule::find_opponents() {
 	const bool in_party      = npc->is_in_party() || npc == avatar;
 	const int  npc_align     = npc->get_effective_alignment();
 	const bool see_invisible = npc->can_see_invisible();
+	Actor_vector nearby;
+	for (int align = Actor::neutral; align <= Actor::chaotic; align++) {
+		// Party members also look for whoever is fighting the party.
+		if (!in_party && !is_enemy(npc_align, align)) {
+			continue;
+		}
+		for (const auto& weak : combatants.get(align)) {
+			const Game_object_shared obj = weak.lock();
+			if (obj) {
+				nearby.push_back(obj->as_actor());
+			}
+		}
+	}
 	for (auto* actor : nearby) {
 		if (actor->is_dead()
 			|| (!see_invisible && actor->get_flag(Obj_flags::invisible))) {
@@ -22,6 +22,7 @@
 
 #include "Configuration.h"
 
+#include "databuf.h"
 #include "exceptions.h"
 #include "ignore_unused_variable_warning.h"
 #include "utils.h"
@@ -219,6 +220,24 @@ bool Configuration::read_config_file(
 	return read_abs_config_file(fname, root);
 }
 
+namespace {
+	constexpr const uint32 CACHE_MAGIC   = 0x43434558;    // "EXCC"
+	constexpr const uint32 CACHE_VERSION = 1;
+}    // namespace
+
+/*
+ *  64 bit FNV-1a hash of a file's contents.
+ */
+
+static uint64 hash_contents(const string& s) {
+	uint64 hash = 0xcbf29ce484222325ULL;
+	for (const char c : s) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
 // read config from file, without pre-processing the filename
 bool Configuration::read_abs_config_file(
 		const string& input_filename, const string& root) {
@@ -257,12 +276,82 @@ bool Configuration::read_abs_config_file(
 		return false;
 	}
 	CTRACE("Configuration::read_config_file - file read");
-	read_config_string(sbuf);
+	const uint64 hash = hash_contents(sbuf);
+	if (!read_cache(sbuf.size(), hash)) {
+		read_config_string(sbuf);
+		write_cache(sbuf.size(), hash);
+	}
 
 	is_file = true;
 	return true;
 }
 
+/*
+ *  Get the name of the cache for our file, or "" if there is nowhere to
+ *  put it.
+ */
+
+string Configuration::get_cache_name() const {
+	if (!is_system_path_defined("<SAVEHOME>")) {
+		return string();
+	}
+	// Files of the same name can be in several places.
+	string     name(get_filename_from_path(filename));
+	const auto path = get_system_path(filename);
+	name += '-' + std::to_string(hash_contents(path) & 0xffffffffU);
+	return "<SAVEHOME>/cache/" + name + ".bin";
+}
+
+/*
+ *  Read the tree from the cache, if it was made from the same contents.
+ *
+ *  Output: false if there was no usable cache.
+ */
+
+bool Configuration::read_cache(size_t size, uint64 hash) {
+	const string cachename = get_cache_name();
+	if (cachename.empty() || !U7exists(cachename)) {
+		return false;
+	}
+	IFileDataSource ds(cachename);
+	if (!ds.good() || ds.getSize() < 20 || ds.read4() != CACHE_MAGIC
+		|| ds.read4() != CACHE_VERSION || ds.read4() != size
+		|| ds.read4() != (hash & 0xffffffffU) || ds.read4() != (hash >> 32)) {
+		return false;
+	}
+	auto* tree = new XMLnode();
+	if (!tree->read_binary(ds)) {
+		delete tree;
+		return false;
+	}
+	delete xmltree;
+	xmltree = tree;
+	return true;
+}
+
+/*
+ *  Write the tree to the cache.
+ */
+
+void Configuration::write_cache(size_t size, uint64 hash) const {
+	const string cachename = get_cache_name();
+	if (cachename.empty()) {
+		return;
+	}
+	try {
+		U7mkdir("<SAVEHOME>/cache", 0755);
+		OBufferedFileDataSource ds(cachename);
+		ds.write4(CACHE_MAGIC);
+		ds.write4(CACHE_VERSION);
+		ds.write4(size);
+		ds.write4(hash & 0xffffffffU);
+		ds.write4(hash >> 32);
+		xmltree->write_binary(ds);
+	} catch (exult_exception&) {
+		// Just don't cache it.
+	}
+}
+
 string Configuration::dump() {
 	return xmltree->dump();
 }
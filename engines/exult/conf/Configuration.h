@@ -20,6 +20,7 @@
 #define _Configuration_h_
 
 #include "XMLEntity.h"
+#include "common_types.h"
 
 class Configuration {
 public:
@@ -99,6 +100,12 @@ public:
 	void getsubkeys(KeyTypeList& ktl, const std::string& basekey);
 
 private:
+	// The parsed tree of a file is cached in <SAVEHOME>/cache, keyed by
+	// the size and hash of the file's contents.
+	std::string get_cache_name() const;
+	bool        read_cache(size_t size, uint64 hash);
+	void        write_cache(size_t size, uint64 hash) const;
+
 	XMLnode*    xmltree;
 	std::string rootname;
 	std::string filename;
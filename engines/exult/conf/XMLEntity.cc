@@ -23,6 +23,7 @@
 #include "XMLEntity.h"
 
 #include "common_types.h"
+#include "databuf.h"
 
 #include <cassert>
 #include <iostream>
@@ -421,3 +422,53 @@ void XMLnode::selectpairs(KeyTypeList& ktl, const std::string& currkey) {
 		node->selectpairs(ktl, currkey + id + '/');
 	}
 }
+
+/*
+ *  Write out the tree in a form read_binary can read quickly.
+ */
+void XMLnode::write_binary(ODataSource& out) const {
+	out.write4(id.size());
+	out.write(id);
+	out.write4(content.size());
+	out.write(content);
+	out.write1(no_close ? 1 : 0);
+	out.write4(nodelist.size());
+	for (const auto* node : nodelist) {
+		node->write_binary(out);
+	}
+}
+
+/*
+ *  Read in a tree written by write_binary.
+ *
+ *  Output: false if the data is bad.
+ */
+bool XMLnode::read_binary(IDataSource& in, int depth) {
+	const auto read_string = [&](string& str) {
+		const size_t len = in.read4();
+		if (len > in.getAvail()) {
+			return false;
+		}
+		in.read(str, len);
+		return true;
+	};
+	if (depth > 64 || !read_string(id) || !read_string(content)
+		|| in.getAvail() < 5) {
+		return false;
+	}
+	no_close           = in.read1() != 0;
+	const size_t count = in.read4();
+	// Each node takes at least 13 bytes.
+	if (count > in.getAvail() / 13) {
+		return false;
+	}
+	nodelist.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		auto* node = new XMLnode();
+		nodelist.push_back(node);
+		if (!node->read_binary(in, depth + 1)) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -22,6 +22,9 @@
 #include <string>
 #include <vector>
 
+class IDataSource;
+class ODataSource;
+
 std::string encode_entity(const std::string& s);
 
 class XMLnode {
@@ -65,6 +68,10 @@ public:
 	void xmlassign(const std::string& key, const std::string& value);
 	void xmlparse(const std::string& s, std::size_t& pos);
 
+	// Binary copy of the tree, for caching a parsed file.
+	void write_binary(ODataSource& out) const;
+	bool read_binary(IDataSource& in, int depth = 0);
+
 	void listkeys(
 			const std::string&, std::vector<std::string>&,
 			bool longformat = true) const;
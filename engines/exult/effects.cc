@@ -296,6 +296,92 @@ void Effects_manager::update_dirty_text() {
 	}
 }
 
+/**
+ *  Done with the time queue.
+ */
+
+Sprites_ticker::~Sprites_ticker() {
+	if (in_queue() && gwin->get_tqueue()) {
+		gwin->get_tqueue()->remove(this);
+	}
+}
+
+/**
+ *  Put our entry in the queue for a given time.
+ */
+
+void Sprites_ticker::requeue(unsigned long time) {
+	if (in_queue()) {
+		gwin->get_tqueue()->remove(this);
+	}
+	gwin->get_tqueue()->add(time, this);
+	queued_for = time;
+}
+
+/**
+ *  Set when a sprite is next due, adding it if new.
+ */
+
+void Sprites_ticker::add(Sprites_effect* sprite, unsigned long due) {
+	if (sprite->tick_index >= 0) {
+		sprites[sprite->tick_index].due = due;
+	} else {
+		sprite->tick_index = sprites.size();
+		sprites.push_back({sprite, due});
+	}
+	if (!ticking && (!in_queue() || due < queued_for)) {
+		requeue(due);
+	}
+}
+
+/**
+ *  Remove a sprite, moving the last one to its place.
+ */
+
+void Sprites_ticker::remove(Sprites_effect* sprite) {
+	const int i = sprite->tick_index;
+	if (i < 0 || static_cast<size_t>(i) >= sprites.size()
+		|| sprites[i].sprite != sprite) {
+		return;
+	}
+	sprite->tick_index = -1;
+	if (static_cast<size_t>(i) + 1 < sprites.size()) {
+		sprites[i]                    = sprites.back();
+		sprites[i].sprite->tick_index = i;
+	}
+	sprites.pop_back();
+}
+
+/**
+ *  Step the sprites whose times have come, then wait for the soonest.
+ */
+
+void Sprites_ticker::handle_event(unsigned long curtime, uintptr udata) {
+	ignore_unused_variable_warning(udata);
+	ticking = true;
+	for (size_t i = 0; i < sprites.size();) {
+		Sprites_effect* sprite = sprites[i].sprite;
+		if (sprites[i].due > curtime) {
+			i++;
+			continue;
+		}
+		// This sets its next time, or removes it.
+		sprite->handle_event(curtime, 0);
+		if (i < sprites.size() && sprites[i].sprite == sprite) {
+			i++;    // (Else another has been moved here.)
+		}
+	}
+	ticking = false;
+	if (sprites.empty()) {
+		return;
+	}
+	unsigned long soonest = sprites[0].due;
+	for (const auto& each : sprites) {
+		soonest = std::min(soonest, each.due);
+	}
+	requeue(soonest);
+}
+
 /**
  *  Some special effects may not need painting.
  */
@@ -318,7 +404,7 @@ Sprites_effect::Sprites_effect(
 		  deltax(dx), deltay(dy), reps(rps) {
 	frames = sprite.get_num_frames();
 	// Start.
-	gwin->get_tqueue()->add(Game::get_ticks() + delay, this);
+	eman->get_sprites_ticker().add(this, Game::get_ticks() + delay);
 }
 
 /**
@@ -338,7 +424,11 @@ Sprites_effect::Sprites_effect(
 	pos    = it->get_tile();
 	frames = sprite.get_num_frames();
 	// Start immediately.
-	gwin->get_tqueue()->add(Game::get_ticks(), this);
+	eman->get_sprites_ticker().add(this, Game::get_ticks());
+}
+
+Sprites_effect::~Sprites_effect() {
+	eman->get_sprites_ticker().remove(this);
 }
 
 /**
@@ -371,13 +461,16 @@ inline void Sprites_effect::add_dirty(int frnum) {
 void Sprites_effect::handle_event(
 		unsigned long curtime,    // Current time of day.
 		uintptr       udata) {
+	ignore_unused_variable_warning(udata);
 	int       frame_num = sprite.get_framenum();
 	const int delay
 			= gwin->get_std_delay();    // Delay between frames.  Needs to
 	//   match usecode animations.
 	if (!reps || (reps < 0 && frame_num == frames)) {    // At end?
-		// Remove & delete this.
-		gwin->set_all_dirty();
+		// Clear out the last frame, if it's showing, and delete this.
+		if (frame_num < frames) {
+			add_dirty(frame_num);
+		}
 		auto ownHandle = eman->remove_effect(this);
 		return;
 	}
@@ -396,8 +489,8 @@ void Sprites_effect::handle_event(
 	}
 	add_dirty(frame_num);    // Want to paint new frame.
 	sprite.set_frame(frame_num);
-	// Add back to queue for next time.
-	gwin->get_tqueue()->add(curtime + delay, this, udata);
+	// Due again next time.
+	eman->get_sprites_ticker().add(this, curtime + delay);
 }
 
 /**
@@ -30,6 +30,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 class Xform_palette;
 class PathFinder;
@@ -39,10 +40,40 @@ class Image_window8;
 class Shape_frame;
 class Actor;
 class Special_effect;
+class Sprites_effect;
 class Text_effect;
 
 using Game_object_weak = std::weak_ptr<Game_object>;
 
+/*
+ *  Steps the sprite animations whose times have come.  It's in the time
+ *  queue once, for the soonest of them, rather than each sprite having
+ *  an entry of its own.
+ */
+class Sprites_ticker : public Time_sensitive {
+	struct Due_sprite {
+		Sprites_effect* sprite;
+		unsigned long   due;    // Time for its next frame.
+	};
+
+	Game_window*            gwin;
+	std::vector<Due_sprite> sprites;               // Each knows its index.
+	unsigned long           queued_for = 0;        // Time of our entry.
+	bool                    ticking    = false;    // In handle_event().
+
+	void requeue(unsigned long time);
+
+public:
+	Sprites_ticker(Game_window* g) : gwin(g) {}
+
+	~Sprites_ticker() override;
+	// Set when a sprite is next due, adding it if new.
+	void add(Sprites_effect* sprite, unsigned long due);
+	void remove(Sprites_effect* sprite);
+	// Step the sprites whose times have come.
+	void handle_event(unsigned long curtime, uintptr udata) override;
+};
+
 /*
  *  Manage special effects.
  */
@@ -51,8 +82,14 @@ class Effects_manager {
 	std::list<std::unique_ptr<Special_effect>>
 			effects;    // Sprite effects, projectiles, etc.
 	std::list<std::unique_ptr<Text_effect>> texts;    // Text snippets.
+	Sprites_ticker                          sprites_ticker;
+
 public:
-	Effects_manager(Game_window* g) : gwin(g) {}
+	Effects_manager(Game_window* g) : gwin(g), sprites_ticker(g) {}
+
+	Sprites_ticker& get_sprites_ticker() {
+		return sprites_ticker;
+	}
 
 	~Effects_manager();
 	// Add text item.
@@ -111,7 +148,9 @@ protected:
 	int              xoff, yoff;        // Offset from position in pixels.
 	int              deltax, deltay;    // Add to xoff, yoff on each frame.
 	int              reps;              // Repetitions, or -1.
+	int              tick_index = -1;   // In Sprites_ticker's list.
 	void             add_dirty(int frnum);
+	friend class Sprites_ticker;
 
 public:
 	Sprites_effect(
@@ -120,7 +159,8 @@ public:
 	Sprites_effect(
 			int num, Game_object* it, int xf, int yf, int dx, int dy,
 			int frm = 0, int rps = -1);
-	// For Time_sensitive:
+	~Sprites_effect() override;
+	// Step to the next frame (called by Sprites_ticker).
 	void handle_event(unsigned long time, uintptr udata) override;
 	// Render.
 	void paint() override;
@@ -28,10 +28,13 @@
 
 #include "exult.h"
 
+#include "Async_log.h"
 #include "Audio.h"
 #include "AudioMixer.h"
+#include "RawAudioSample.h"
 #include "Configuration.h"
 #include "Face_stats.h"
+#include "Frame_profiler.h"
 #include "Gump_button.h"
 #include "Gump_manager.h"
 #include "Scroll_gump.h"
@@ -46,6 +49,7 @@
 #include "crc.h"
 #include "drag.h"
 #include "effects.h"
+#include "exceptions.h"
 #include "exult_bg_flx.h"
 #include "exult_flx.h"
 #include "exult_si_flx.h"
@@ -64,10 +68,15 @@
 #include "mouse.h"
 #include "palette.h"
 #include "party.h"
+#include "path.h"
+#include "paths.h"
+#include "scale_bands.h"
 #include "sdlrwopsistream.h"
 #include "sdlrwopsostream.h"
+#include "startup_profile.h"
 #include "touchui.h"
 #include "u7drag.h"
+#include "ucdebugging.h"
 #include "ucmachine.h"
 #include "utils.h"
 #include "verify.h"
@@ -76,9 +85,13 @@
 #	include "files/zip/unzip.h"
 #endif
 
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
+#include <sstream>
+#include <vector>
 
 #ifdef __GNUC__
 #	pragma GCC diagnostic push
@@ -162,6 +175,8 @@ int current_scaleval = 1;
  */
 static int  exult_main(const char* runpath);
 static void Init();
+static void Report_startup_times();
+static void Start_frame_trace();
 static int  Play();
 static bool Get_click(
 		int& x, int& y, char* chr, bool drag_ok, bool rotate_colors = false);
@@ -189,6 +204,9 @@ static int drag_npcnum = -1;
 static int drag_cnknum = -1;
 #endif
 static void BuildGameMap(BaseGameInfo* game, int mapnum);
+static int  BenchRender(BaseGameInfo* game, int frames);
+static int  BenchPaths(BaseGameInfo* game);
+static int  BenchAudio(int seconds);
 static void Handle_events();
 static void Handle_event(SDL_Event& event);
 
@@ -205,6 +223,13 @@ static string arg_modname  = "default";    // cmdline arguments
 static string arg_configfile;
 static int    arg_buildmap     = -1;
 static int    arg_mapnum       = -1;
+static int    arg_bench_frames = -1;    // Frames per position to bench.
+static string arg_bench_positions;
+static string arg_bench_paths;     // Queries to replay.
+static int    arg_bench_audio = -1;    // Seconds of audio to mix per case.
+static string arg_record_paths;    // Where to record queries.
+static string arg_profile_usecode;    // Where to write usecode stacks.
+static string arg_usecode_module;     // Usecode compiled to native code.
 static bool   arg_nomenu       = false;
 static bool   arg_edit_mode    = false;    // Start up ExultStudio.
 static bool   arg_write_xml    = false;    // Write out game's config. as XML.
@@ -306,6 +331,13 @@ int main(int argc, char* argv[]) {
 	parameters.declare("--mod", &arg_modname, "default");
 	parameters.declare("--buildmap", &arg_buildmap, -1);
 	parameters.declare("--mapnum", &arg_mapnum, -1);
+	parameters.declare("--bench-render", &arg_bench_frames, -1);
+	parameters.declare("--bench-positions", &arg_bench_positions, "");
+	parameters.declare("--bench-paths", &arg_bench_paths, "");
+	parameters.declare("--bench-audio", &arg_bench_audio, -1);
+	parameters.declare("--record-paths", &arg_record_paths, "");
+	parameters.declare("--profile-usecode", &arg_profile_usecode, "");
+	parameters.declare("--usecode-module", &arg_usecode_module, "");
 	parameters.declare("--nocrc", &ignore_crc, true);
 	parameters.declare("-c", &arg_configfile, "");
 	parameters.declare("--edit", &arg_edit_mode, true);
@@ -381,6 +413,43 @@ int main(int argc, char* argv[]) {
 				"which map"
 			 << endl
 			 << "\t\t(for multimap games or mods) whose map is desired" << endl
+			 << "--bench-render <N>\tRender N frames per camera position "
+				"with every"
+			 << endl
+			 << "\t\tscaler and scale factor, and write the timings as JSON"
+			 << endl
+			 << "\t\tOnly valid if used together with '--bg', '--fov', '--si', "
+				"'--ss', '--sib'"
+			 << endl
+			 << "\t\tor '--game <game>'" << endl
+			 << "--bench-positions <file>\tCamera positions for "
+				"'--bench-render', one"
+			 << endl
+			 << "\t\t'tx ty [lift]' per line (default: spread over the map)"
+			 << endl
+			 << "--record-paths <file>\tWrite the NPCs' path searches to a "
+				"file"
+			 << endl
+			 << "--bench-paths <file>\tReplay the searches from "
+				"'--record-paths' and"
+			 << endl
+			 << "\t\twrite the nodes, times and path costs as JSON" << endl
+			 << "\t\tOnly valid if used together with '--bg', '--fov', '--si', "
+				"'--ss', '--sib'"
+			 << endl
+			 << "\t\tor '--game <game>'" << endl
+			 << "--bench-audio <N>\tMix N seconds of sound with each "
+				"resampler and"
+			 << endl
+			 << "\t\twrite the time per output sample as JSON" << endl
+			 << "--profile-usecode <file>\tCount the instructions and time of "
+				"usecode"
+			 << endl
+			 << "\t\tfunctions, and write their call stacks on exit" << endl
+			 << "--usecode-module <file>\tRun the usecode functions in this "
+				"module"
+			 << endl
+			 << "\t\tas native code instead of interpreting them" << endl
 			 << "--nocrc\t\tDon't check crc's of .flx files" << endl
 			 << "--verify-files\tVerifies that the files in static dir are not "
 				"corrupt"
@@ -422,6 +491,20 @@ int main(int argc, char* argv[]) {
 				"--ss, --sib or --game!"
 			 << endl;
 		exit(1);
+	} else if (arg_bench_frames >= 0 && gameparam == 0) {
+		cerr << "Error: --bench-render requires one of --bg, --fov, --si, "
+				"--ss, --sib or --game!"
+			 << endl;
+		exit(1);
+	} else if (!arg_bench_paths.empty() && gameparam == 0) {
+		cerr << "Error: --bench-paths requires one of --bg, --fov, --si, "
+				"--ss, --sib or --game!"
+			 << endl;
+		exit(1);
+	} else if (!arg_bench_positions.empty() && arg_bench_frames < 0) {
+		cerr << "Error: '--bench-positions' requires '--bench-render'!"
+			 << endl;
+		exit(1);
 	}
 #ifndef HAVE_ZIP_SUPPORT
 	else if (!arg_installmod.empty()) {
@@ -471,6 +554,10 @@ int main(int argc, char* argv[]) {
 		return 0;
 	}
 
+	if (arg_bench_audio >= 0) {
+		return BenchAudio(arg_bench_audio);
+	}
+
 	try {
 		result = exult_main(argv[0]);
 	} catch (const quit_exception& /*e*/) {
@@ -519,6 +606,10 @@ int main(int argc, char* argv[]) {
 
 int exult_main(const char* runpath) {
 	string music_path;
+	// Traces are written by a thread of their own, so that the game doesn't
+	// wait on the terminal or the log files.
+	Async_log::get().take_over(cout, Async_log::Out);
+	Async_log::get().take_over(cerr, Async_log::Err);
 	// output version info
 	getVersionInfo(cout);
 
@@ -528,10 +619,19 @@ int exult_main(const char* runpath) {
 	// Read in configuration file
 	config = new Configuration;
 
-	if (!arg_configfile.empty()) {
-		config->read_abs_config_file(arg_configfile);
-	} else {
-		config->read_config_file(USER_CONFIGURATION_FILE);
+	{
+		const Startup_phase phase("config");
+		if (!arg_configfile.empty()) {
+			config->read_abs_config_file(arg_configfile);
+		} else {
+			config->read_config_file(USER_CONFIGURATION_FILE);
+		}
+	}
+	string log_levels;
+	config->value("config/debug/log_levels", log_levels, "");
+	if (!Async_log::get().set_levels(log_levels)) {
+		cerr << "Couldn't understand config/debug/log_levels: " << log_levels
+			 << endl;
 	}
 
 #if defined _WIN32
@@ -819,6 +919,11 @@ static void Init() {
 	// Remove SDL_HINT_MOUSE_EMULATE_WARP_WITH_RELATIVE set as "0"
 	// Do not confuse that Hint with :
 	//        SDL_HINT_MOUSE_RELATIVE_MODE_WARP         set as "0"
+	// Benchmarks don't need to show anything.
+	if ((arg_bench_frames >= 0 || !arg_bench_paths.empty())
+		&& !SDL_GetHint(SDL_HINT_VIDEO_DRIVER)) {
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+	}
 	if (!SDL_Init(init_flags | joyinit)) {
 		cerr << "Unable to initialize SDL: " << SDL_GetError() << endl;
 		exit(-1);
@@ -858,6 +963,22 @@ static void Init() {
 		config->value("config/video/gamma/blue", gb, "1.0");
 		Image_window8::set_gamma(
 				atof(gr.c_str()), atof(gg.c_str()), atof(gb.c_str()));
+		// Threads for the hqNx and xBR scalers; 0 = one per core.
+		int scaler_threads;
+		config->value("config/video/scaler_threads", scaler_threads, 0);
+		if (scaler_threads < 0) {
+			scaler_threads = 0;
+		}
+		config->set("config/video/scaler_threads", scaler_threads, false);
+		Scaler_bands::set_threads(scaler_threads);
+		// Memory for decoded shape frames, in KB; 0 decodes on every paint.
+		int span_cache;
+		config->value("config/video/shape_span_cache", span_cache, 8192);
+		if (span_cache < 0) {
+			span_cache = 0;
+		}
+		config->set("config/video/shape_span_cache", span_cache, false);
+		Shape_frame::set_span_budget(size_t(span_cache) * 1024);
 		string fullscreenstr;    // Check config. for fullscreen mode.
 		config->value("config/video/fullscreen", fullscreenstr, "no");
 		const bool fullscreen = (fullscreenstr == "yes");
@@ -895,9 +1016,15 @@ static void Init() {
 		bool disable_fades;
 		config->value("config/video/disable_fades", disable_fades, false);
 
-		setup_video(fullscreen, VIDEO_INIT);
-		SetIcon();
-		Audio::Init();
+		{
+			const Startup_phase phase("video");
+			setup_video(fullscreen, VIDEO_INIT);
+			SetIcon();
+		}
+		{
+			const Startup_phase phase("audio");
+			Audio::Init();
+		}
 		gwin->get_pal()->set_fades_enabled(!disable_fades);
 		gwin->set_in_exult_menu(false);
 	}
@@ -1028,6 +1155,20 @@ static void Init() {
 			newgame->setup_game_paths();
 			exit(verify_files(newgame));
 		}
+		if (arg_bench_frames >= 0) {
+			exit(BenchRender(newgame, arg_bench_frames));
+		}
+		if (!arg_bench_paths.empty()) {
+			exit(BenchPaths(newgame));
+		}
+		if (!arg_record_paths.empty()
+			&& !Path_recorder::start(arg_record_paths)) {
+			exit(1);
+		}
+		if (!arg_profile_usecode.empty()) {
+			Usecode_profiler::start(arg_profile_usecode);
+		}
+		Usecode_machine::set_native_module(arg_usecode_module);
 
 #ifdef DEBUG
 		{
@@ -1144,7 +1285,10 @@ static void Init() {
 #endif
 		Game::create_game(newgame);
 		Audio* audio = Audio::get_ptr();
-		audio->Init_sfx();
+		{
+			const Startup_phase phase("audio/MIDI");
+			audio->Init_sfx();
+		}
 		MyMidiPlayer* midi = audio->get_midi();
 
 		Game::setup_text();
@@ -1218,6 +1362,8 @@ static void Init() {
 	gwin->read_gwin();
 	gwin->setup_game(arg_edit_mode);    // This will start the scene.
 										// Get scale factor for mouse.
+	Report_startup_times();
+	Start_frame_trace();
 #ifdef USE_EXULTSTUDIO
 	Server_init();    // Initialize server (for map-editor).
 	SDL_SetEventEnabled(SDL_EVENT_DROP_FILE, true);
@@ -1225,6 +1371,36 @@ static void Init() {
 #endif
 }
 
+/*
+ *  Print the times of the startup phases, and save them as a trace if
+ *  asked to.
+ */
+
+static void Report_startup_times() {
+	Startup_profile& profile = Startup_profile::get();
+	profile.report(cout);
+	string trace;
+	config->value("config/debug/startup_trace", trace, "");
+	if (!trace.empty() && !profile.write_trace(get_system_path(trace))) {
+		cerr << "Couldn't write startup trace '" << trace << "'" << endl;
+	}
+	profile.clear();
+}
+
+/*
+ *  Record the frames from here on, if asked to; Play() writes them out.
+ */
+
+static void Start_frame_trace() {
+	Frame_profiler& profiler = Frame_profiler::get();
+	string          trace;
+	config->value("config/debug/frame_trace", trace, "");
+	if (!trace.empty() && !profiler.start(get_system_path(trace))) {
+		cerr << "Frame traces need Exult configured with --enable-frame-trace"
+			 << endl;
+	}
+}
+
 /*
  *  Play game.
  */
@@ -1242,6 +1418,9 @@ static int Play() {
 		}
 	} while (quitting_time == QUIT_TIME_RESTART);
 
+	if (!Frame_profiler::get().finish()) {
+		cerr << "Couldn't write frame trace" << endl;
+	}
 	delete gwin;
 
 	Audio::Destroy();    // Deinit the sound system.
@@ -1420,13 +1599,22 @@ static void Handle_events() {
 	/*
 	 *  Main event loop.
 	 */
-	int last_x = -1;
-	int last_y = -1;
+	int    last_x     = -1;
+	int    last_y     = -1;
+	uint32 frame_ms   = 0;    // While scrolling smoothly, frame time.
+	uint32 last_frame = 0;    // When the last lerped frame started.
 	while (!quitting_time) {
+		// While lerping, wake up for every display refresh, counting
+		//   from the start of the last frame, instead of pausing.
+		uint32 wait_ms = DELAY_TOTAL_MS;
+		if (frame_ms) {
+			const uint32 spent = SDL_GetTicks() - last_frame;
+			wait_ms            = spent < frame_ms ? frame_ms - spent : 0;
+		}
 #ifdef USE_EXULTSTUDIO
-		Server_delay();    // Handle requests.
+		Server_delay(wait_ms);    // Handle requests.
 #else
-		Delay();    // Wait a fraction of a second.
+		Delay(wait_ms);    // Wait a fraction of a second.
 #endif
 		// Mouse scale factor
 		// int scale = gwin->get_fastmouse() ? 1 :
@@ -1438,9 +1626,9 @@ static void Handle_events() {
 		// Get current time.
 		const uint32 ticks = SDL_GetTicks();
 #if defined(_WIN32) && defined(USE_EXULTSTUDIO)
-		if (ticks - Game::get_ticks() < 10) {
+		if (ticks - Game::get_ticks() < wait_ms) {
 			// Reducing processor usage with a slight delay.
-			SDL_Delay(10 - (ticks - Game::get_ticks()));
+			SDL_Delay(wait_ms - (ticks - Game::get_ticks()));
 			continue;
 		}
 #endif
@@ -1534,9 +1722,13 @@ static void Handle_events() {
 			// Is lerping (smooth scrolling) enabled
 			if (mswait && ticks < (last_repaint + mswait * 2)) {
 				gwin->paint_lerped(((ticks - last_repaint) * 0x10000) / mswait);
-				didlerp = true;
+				didlerp    = true;
+				last_frame = ticks;
 			}
 		}
+		// Paint the next ones at the display's rate; the game itself
+		//   still only moves on its own ticks.
+		frame_ms = didlerp ? gwin->get_win()->get_refresh_ms() : 0;
 		if (!lerp || !didlerp) {       // No lerping
 			if (gwin->is_dirty()) {    // Note the ending else in the above #if!
 				gwin->paint_dirty();
@@ -1557,6 +1749,7 @@ static void Handle_events() {
 			Mouse::mouse_update) {    // If not, did mouse change?
 			Mouse::mouse()->blit_dirty();
 		}
+		PROFILE_FRAME();
 	}
 }
 
@@ -2516,7 +2709,7 @@ static bool Get_click(
 				}
 				// Non palettized needs explicit blit.
 				if (!gwin->get_win()->is_palettized()) {
-					gwin->set_painted();
+					gwin->set_colours_rotated();
 				}
 			}
 		}
@@ -3096,6 +3289,355 @@ void BuildGameMap(BaseGameInfo* game, int mapnum) {
 	}
 }
 
+/*
+ *  Render frames at a set of camera positions with every scaler and scale
+ *  factor, through Game_render::paint_map and Image_window::show, and write
+ *  the times to cout as JSON.  The video settings from the config (threads,
+ *  span cache) are kept; vsync is turned off so frames aren't throttled.
+ *  Output: exit code.
+ */
+
+int BenchRender(BaseGameInfo* game, int frames) {
+	constexpr const int game_w = 320;
+	constexpr const int game_h = 200;
+	frames                     = std::max(frames, 1);
+
+	struct Position {
+		int tx, ty, lift;
+	};
+
+	std::vector<Position> positions;
+	if (!arg_bench_positions.empty()) {
+		std::unique_ptr<std::istream> in;
+		try {
+			in = U7open_in(arg_bench_positions.c_str(), true);
+		} catch (const file_open_exception& err) {
+			cerr << err.what() << endl;
+			return 1;
+		}
+		Position pos;
+		std::string line;
+		while (std::getline(*in, line)) {
+			pos.lift = 16;
+			std::istringstream fields(line);
+			if (fields >> pos.tx >> pos.ty) {
+				fields >> pos.lift;
+				positions.push_back(pos);
+			}
+		}
+	} else {
+		// Centres of every third superchunk.
+		for (int sy = 1; sy < c_num_schunks; sy += 3) {
+			for (int sx = 1; sx < c_num_schunks; sx += 3) {
+				positions.push_back(
+						{sx * c_tiles_per_schunk + c_tiles_per_schunk / 2,
+						 sy * c_tiles_per_schunk + c_tiles_per_schunk / 2,
+						 16});
+			}
+		}
+	}
+	if (positions.empty()) {
+		cerr << "--bench-render: no camera positions" << endl;
+		return 1;
+	}
+
+	Game::create_game(game);
+	gwin->init_files(false);    // init, but don't show plasma
+	gwin->get_map()->init();
+	gwin->set_map(0);
+	gwin->get_pal()->set(0);
+	Image_window8* win = gwin->get_win();
+
+	using bench_clock = std::chrono::steady_clock;
+	auto ms_since     = [](bench_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(
+					   bench_clock::now() - start)
+				.count();
+	};
+
+	cout << "{\n  \"frames\": " << frames
+		 << ",\n  \"positions\": " << positions.size()
+		 << ",\n  \"game_width\": " << game_w
+		 << ",\n  \"game_height\": " << game_h << ",\n  \"results\": [";
+	const char* sep = "";
+	for (int sclr = 0; sclr < Image_window::NumScalers; sclr++) {
+		for (int scale = 1; scale <= 4; scale++) {
+			if (!(Image_window::Scalers[sclr].size_mask
+				  & (1u << (scale - 1)))) {
+				continue;
+			}
+			gwin->resized(
+					game_w * scale, game_h * scale, false, game_w, game_h,
+					scale, sclr, Image_window::Fit, Image_window::point);
+			if (win->get_scaler() != sclr) {
+				continue;    // Not supported here.
+			}
+			SDL_SetRenderVSync(SDL_GetRenderer(win->get_screen_window()), 0);
+
+			std::vector<double> times;
+			double              paint_ms = 0;
+			double              show_ms  = 0;
+			for (const Position& pos : positions) {
+				const int toptx = (pos.tx - game_w / c_tilesize / 2
+								   + c_num_tiles)
+								  % c_num_tiles;
+				const int topty = (pos.ty - game_h / c_tilesize / 2
+								   + c_num_tiles)
+								  % c_num_tiles;
+				for (int i = 0; i < frames; i++) {
+					const bench_clock::time_point start = bench_clock::now();
+					gwin->paint_map_at_tile(
+							0, 0, game_w, game_h, toptx, topty, pos.lift);
+					const double painted = ms_since(start);
+					win->show();
+					const double total = ms_since(start);
+					paint_ms += painted;
+					show_ms += total - painted;
+					times.push_back(total);
+				}
+			}
+			std::sort(times.begin(), times.end());
+			auto percentile = [&times](int pct) {
+				return times[(times.size() - 1) * pct / 100];
+			};
+			const double mean   = (paint_ms + show_ms) / times.size();
+			const double pixels = double(win->get_display_width())
+								  * win->get_display_height();
+			cout << sep << "\n    {\"scaler\": \""
+				 << Image_window::get_name_for_scaler(sclr)
+				 << "\", \"scale\": " << scale
+				 << ", \"ms_p50\": " << percentile(50)
+				 << ", \"ms_p90\": " << percentile(90)
+				 << ", \"ms_p99\": " << percentile(99)
+				 << ", \"ms_mean\": " << mean
+				 << ", \"paint_ms_mean\": " << paint_ms / times.size()
+				 << ", \"show_ms_mean\": " << show_ms / times.size()
+				 << ", \"pixels_per_s\": "
+				 << (mean > 0 ? pixels * 1000.0 / mean : 0) << "}";
+			sep = ",";
+		}
+	}
+	cout << "\n  ]\n}" << endl;
+	Audio::Destroy();
+	return 0;
+}
+
+/*
+ *  Replay the path searches written by '--record-paths' on the map as a new
+ *  game starts, with A* and with jump points, and write the nodes expanded,
+ *  times and path costs to cout as JSON.  Costs are only compared with the
+ *  recorded ones where what blocks around the path hashes the same.
+ *  Output: exit code.
+ */
+
+int BenchPaths(BaseGameInfo* game) {
+	struct Query {
+		int        map;
+		Tile_coord start, goal;
+		int        move_flags, dist, height;
+		bool       found;
+		int        cost;
+		uint32     hash;
+	};
+
+	std::vector<Query> queries;
+	{
+		std::unique_ptr<std::istream> in;
+		try {
+			in = U7open_in(arg_bench_paths.c_str(), true);
+		} catch (const file_open_exception& err) {
+			cerr << err.what() << endl;
+			return 1;
+		}
+		std::string line;
+		while (std::getline(*in, line)) {
+			std::istringstream fields(line);
+			Query              q;
+			int                found;
+			int                nodes;
+			long               usecs;
+			if (fields >> q.map >> q.start.tx >> q.start.ty >> q.start.tz
+				>> q.goal.tx >> q.goal.ty >> q.goal.tz >> q.move_flags >> q.dist
+				>> q.height >> found >> q.cost >> nodes >> usecs >> q.hash) {
+				q.found = found != 0;
+				queries.push_back(q);
+			}
+		}
+	}
+	if (queries.empty()) {
+		cerr << "--bench-paths: no queries" << endl;
+		return 1;
+	}
+
+	Game::create_game(game);
+	gwin->init_files(false);    // init, but don't show plasma
+	gwin->get_map()->init();
+	gwin->set_map(0);
+
+	using bench_clock = std::chrono::steady_clock;
+	constexpr const Path_search searches[] = {
+			Path_search::a_star, Path_search::jump_points};
+	constexpr const char* const names[] = {"a_star", "jump_points"};
+
+	struct Totals {
+		std::vector<double> usecs;
+		long                nodes = 0;
+		int                 found = 0;
+		// Where the map hashes the same and both found a path.
+		int    compared    = 0;
+		double cost_ratio  = 0;    // Sum of cost / recorded cost.
+		int    differently = 0;    // # that found or not unlike recorded.
+	};
+
+	Totals totals[2];
+	int    replayed = 0;
+	int    same_map = 0;
+	for (const Query& q : queries) {
+		if (q.map != gwin->get_map()->get_num()) {
+			gwin->set_map(q.map);
+		}
+		int cx0;
+		int cy0;
+		int cw;
+		int ch;
+		if (!Snapshot_pathfinder_client::get_area(
+					q.start, q.goal, cx0, cy0, cw, ch)) {
+			continue;
+		}
+		const Snapshot_pathfinder_client client(
+				q.move_flags, q.height, q.dist, cx0, cy0, cw, ch);
+		const bool same = client.get_hash() == q.hash;
+		replayed++;
+		if (same) {
+			same_map++;
+		}
+		for (int s = 0; s < 2; s++) {
+			Totals&                       t     = totals[s];
+			int                           cost  = -1;
+			const bench_clock::time_point start = bench_clock::now();
+			const bool                    found
+					= Find_path(q.start, q.goal, &client, &cost, searches[s])
+							  .second;
+			t.usecs.push_back(std::chrono::duration<double, std::micro>(
+									  bench_clock::now() - start)
+									  .count());
+			t.nodes += Get_path_nodes_expanded();
+			if (found) {
+				t.found++;
+			}
+			if (!same) {
+				continue;
+			}
+			if (found != q.found) {
+				t.differently++;
+			} else if (found && q.cost > 0) {
+				t.compared++;
+				t.cost_ratio += double(cost) / q.cost;
+			}
+		}
+	}
+
+	cout << "{\n  \"queries\": " << queries.size()
+		 << ",\n  \"replayed\": " << replayed
+		 << ",\n  \"same_map\": " << same_map << ",\n  \"results\": [";
+	const char* sep = "";
+	for (int s = 0; s < 2; s++) {
+		Totals& t = totals[s];
+		std::sort(t.usecs.begin(), t.usecs.end());
+		auto percentile = [&t](int pct) {
+			return t.usecs.empty() ? 0.0
+								   : t.usecs[(t.usecs.size() - 1) * pct / 100];
+		};
+		double total_us = 0;
+		for (const double us : t.usecs) {
+			total_us += us;
+		}
+		const double n = std::max<size_t>(t.usecs.size(), 1);
+		cout << sep << "\n    {\"search\": \"" << names[s]
+			 << "\", \"found\": " << t.found
+			 << ", \"nodes_mean\": " << t.nodes / n
+			 << ", \"us_mean\": " << total_us / n
+			 << ", \"us_p50\": " << percentile(50)
+			 << ", \"us_p99\": " << percentile(99)
+			 << ", \"found_unlike_recorded\": " << t.differently
+			 << ", \"cost_vs_recorded\": "
+			 << (t.compared ? t.cost_ratio / t.compared : 0) << "}";
+		sep = ",";
+	}
+	cout << "\n  ]\n}" << endl;
+	Audio::Destroy();
+	return 0;
+}
+
+/*
+ *  Mix seconds of looping noise through one channel per resampler, source
+ *  rate and format, at 48000 Hz stereo as the mixer does (without the
+ *  audio device), and write the time per output sample to cout as JSON.
+ *  Output: exit code.
+ */
+
+int BenchAudio(int seconds) {
+	constexpr const uint32 out_rate = 48000;
+	constexpr const uint32 block    = 1024;    // Frames per callback.
+	seconds                         = std::max(seconds, 1);
+
+	constexpr const AudioResampler resamplers[] = {
+			AudioResampler::Cubic, AudioResampler::Sinc};
+	constexpr const char* const names[] = {"cubic", "sinc"};
+	constexpr const uint32      rates[] = {11025, 22050, 44100};
+	AudioChannel::prepareSinc();
+
+	using bench_clock = std::chrono::steady_clock;
+	std::vector<sint32> bus(block * 2);
+	sint64              checksum = 0;    // So the mixing isn't optimized out.
+	const char*         sep      = "";
+	cout << "{\n  \"output_rate\": " << out_rate << ",\n  \"results\": [";
+	for (int r = 0; r < 2; r++) {
+		for (const uint32 rate : rates) {
+			for (int src_stereo = 0; src_stereo < 2; src_stereo++) {
+				// A second of noise.
+				const uint32 size = rate * (src_stereo ? 2 : 1);
+				auto         data = std::make_unique<uint8[]>(size);
+				uint32       seed = 1;
+				for (uint32 i = 0; i < size; i++) {
+					seed    = seed * 1103515245 + 12345;
+					data[i] = static_cast<uint8>(seed >> 16);
+				}
+				auto* sample = new RawAudioSample(
+						std::move(data), size, rate, false, src_stereo != 0);
+				AudioChannel channel(out_rate, true);
+				channel.setResampler(resamplers[r]);
+				channel.playSample(
+						sample, -1, 0, false, AUDIO_DEF_PITCH,
+						AUDIO_MAX_VOLUME, AUDIO_MAX_VOLUME, 1);
+
+				const uint32 blocks = seconds * out_rate / block;
+				const bench_clock::time_point start = bench_clock::now();
+				for (uint32 b = 0; b < blocks; b++) {
+					std::fill(bus.begin(), bus.end(), 0);
+					channel.resampleAndMix(bus.data(), block * 2);
+					checksum += bus[b % bus.size()];
+				}
+				const double ns = std::chrono::duration<double, std::nano>(
+										  bench_clock::now() - start)
+										  .count();
+				channel.stop();
+				sample->Release();
+
+				cout << sep << "\n    {\"resampler\": \"" << names[r]
+					 << "\", \"source_rate\": " << rate
+					 << ", \"source_stereo\": "
+					 << (src_stereo ? "true" : "false")
+					 << ", \"ns_per_sample\": "
+					 << ns / (double(blocks) * block * 2) << "}";
+				sep = ",";
+			}
+		}
+	}
+	cout << "\n  ],\n  \"checksum\": " << checksum << "\n}" << endl;
+	return 0;
+}
+
 /*
  *  Most of the game setable video configuration stuff is stored here so
  *  it isn't duplicated all over the place. fullscreen is determined
@@ -3189,6 +3731,7 @@ void setup_video(
 		} else if (
 				scaler != Image_window::point
 				&& scaler != Image_window::SDLScaler
+				&& scaler != Image_window::GPUScaler
 				&& scaler != Image_window::interlaced
 				&& scaler != Image_window::bilinear) {
 			scaleval = 2;
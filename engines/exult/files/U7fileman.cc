@@ -47,9 +47,14 @@ U7FileManager*       U7FileManager::self = &filemanager;
  *  @return Pointer to data reading class.
  */
 U7file* U7FileManager::get_file_object(const File_spec& s, bool allow_errors) {
-	if (file_list.count(s) != 0) {
-		return file_list[s].get();
+	{
+		const std::shared_lock<std::shared_mutex> lock(file_list_mutex);
+		auto it = file_list.find(s);
+		if (it != file_list.end()) {
+			return it->second.get();
+		}
 	}
+	// Opened without holding the lock, as it reads the file's index.
 	// Not in our cache. Attempt to figure it out.
 	std::unique_ptr<U7file> uf;
 	if (s.index >= 0) {
@@ -85,14 +90,16 @@ U7file* U7FileManager::get_file_object(const File_spec& s, bool allow_errors) {
 		return nullptr;
 	}
 
-	U7file* pt   = uf.get();
-	file_list[s] = std::move(uf);
-	return pt;
+	// Another thread may have opened it meanwhile; keep theirs.
+	const std::unique_lock<std::shared_mutex> lock(file_list_mutex);
+	auto it = file_list.emplace(s, std::move(uf)).first;
+	return it->second.get();
 }
 
 /**
  *  Cleans the whole file list.
  */
 void U7FileManager::reset() {
+	const std::unique_lock<std::shared_mutex> lock(file_list_mutex);
 	file_list.clear();
 }
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 
 /**
@@ -36,6 +37,8 @@ class U7FileManager {
 protected:
 	/// The actual "file" list.
 	std::map<File_spec, std::unique_ptr<U7file>> file_list;
+	/// Guards file_list; the files themselves lock their own reads.
+	std::shared_mutex file_list_mutex;
 	/// Static pointer to self.
 	static U7FileManager* self;
 
@@ -43,13 +46,14 @@ public:
 	U7FileManager()                                = default;
 	U7FileManager(const U7FileManager&)            = delete;
 	U7FileManager& operator=(const U7FileManager&) = delete;
-	U7FileManager(U7FileManager&&)                 = default;
-	U7FileManager& operator=(U7FileManager&&)      = default;
+	U7FileManager(U7FileManager&&)                 = delete;
+	U7FileManager& operator=(U7FileManager&&)      = delete;
 
 	~U7FileManager() {
 		reset();
 	}
 
+	/// Closes all files. Not safe while other threads use them.
 	void reset();
 
 	U7file* get_file_object(const File_spec& s, bool allow_errors = false);
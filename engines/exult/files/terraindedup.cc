@@ -0,0 +1,136 @@
+/*
+ *  terraindedup.cc - Find chunk terrains that are the same as others.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "terraindedup.h"
+
+#include <algorithm>
+#include <iostream>
+
+// Terrains compared with each one added, at most.
+constexpr const size_t c_max_compared = 64;
+
+Terrain_dedup::Terrain_dedup(int tol)
+		: tolerance(std::clamp(tol, 0, ntiles - 1)), nruns(tolerance + 1) {
+	if (tolerance > 0) {
+		by_run.resize(nruns);
+	}
+}
+
+/*
+ *  Hash some tiles (FNV-1a).
+ */
+
+uint64 Terrain_dedup::hash(const uint32* first, const uint32* last) {
+	uint64 h = 0xcbf29ce484222325ULL;
+	for (; first != last; ++first) {
+		h = (h ^ *first) * 0x100000001b3ULL;
+	}
+	return h;
+}
+
+/*
+ *  Find the numbered terrain differing least from one.
+ *
+ *  Output: Its number, or -1 if none is within the tolerance.
+ */
+
+int Terrain_dedup::find_near(
+		const Tiles& tiles, const uint64* run_hashes) const {
+	int              best      = -1;
+	int              best_diff = tolerance + 1;
+	std::vector<int> compared;
+	// Spread the comparisons over the runs.
+	const size_t per_run
+			= std::max<size_t>(1, c_max_compared / static_cast<size_t>(nruns));
+	for (int run = 0; run < nruns && best_diff > 1
+					  && compared.size() < c_max_compared;
+		 run++) {
+		auto found = by_run[run].find(run_hashes[run]);
+		if (found == by_run[run].end()) {
+			continue;
+		}
+		const std::vector<int>& ters = found->second;
+		// The newest are likeliest to be neighbors.
+		const size_t cnt = std::min(ters.size(), per_run);
+		for (size_t i = ters.size() - cnt; i < ters.size(); i++) {
+			const int tnum = ters[i];
+			if (std::find(compared.begin(), compared.end(), tnum)
+				!= compared.end()) {
+				continue;
+			}
+			compared.push_back(tnum);
+			const Tiles& other = terrains[tnum];
+			int          diff  = 0;
+			for (int t = 0; t < ntiles && diff < best_diff; t++) {
+				diff += tiles[t] != other[t];
+			}
+			if (diff < best_diff) {
+				best      = tnum;
+				best_diff = diff;
+			}
+		}
+	}
+	return best;
+}
+
+int Terrain_dedup::add(const Tiles& tiles) {
+	added++;
+	const uint64 h     = hash(tiles.data(), tiles.data() + ntiles);
+	auto         range = by_hash.equal_range(h);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (terrains[it->second] == tiles) {
+			exact++;
+			return it->second;
+		}
+	}
+	uint64 run_hashes[ntiles];
+	if (tolerance > 0) {
+		for (int run = 0; run < nruns; run++) {
+			run_hashes[run] = hash(
+					tiles.data() + run_start(run),
+					tiles.data() + run_start(run + 1));
+		}
+		const int tnum = find_near(tiles, run_hashes);
+		if (tnum >= 0) {
+			near++;
+			return tnum;
+		}
+	}
+	const int tnum = size();
+	terrains.push_back(tiles);
+	by_hash.emplace(h, tnum);
+	for (int run = 0; run < nruns && tolerance > 0; run++) {
+		by_run[run][run_hashes[run]].push_back(tnum);
+	}
+	return tnum;
+}
+
+void Terrain_dedup::report(std::ostream& out, size_t bytes_each) const {
+	out << "Chunk terrains: " << added << " in, " << size() << " kept ("
+		<< exact << " same as another";
+	if (tolerance > 0) {
+		out << ", " << near << " within " << tolerance << " tiles";
+	}
+	out << "), " << (size() * bytes_each + 1023) / 1024 << " KB" << std::endl;
+}
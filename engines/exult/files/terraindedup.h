@@ -0,0 +1,108 @@
+/*
+ *  terraindedup.h - Find chunk terrains that are the same as others.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef TERRAINDEDUP_H
+#define TERRAINDEDUP_H
+
+#include "common_types.h"
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+/**
+ *  Assigns terrain numbers to chunk terrains, giving a terrain that has
+ *  been seen before the number it got then.  Generated maps have many
+ *  chunks that are all the same, and every terrain takes room in
+ *  'u7chunks' and memory when in use.
+ *
+ *  With a tolerance, a terrain differing from one already numbered in
+ *  at most that many tiles gets its number too.  Those are found by
+ *  splitting the tiles into tolerance + 1 runs: a terrain within the
+ *  tolerance must match in at least one run, so only terrains sharing
+ *  a run are compared.
+ */
+class Terrain_dedup {
+public:
+	static constexpr int ntiles = 16 * 16;
+	/// A tile is (shape << 8) | frame.
+	using Tiles = std::array<uint32, ntiles>;
+
+	static uint32 tile(int shapenum, int framenum) {
+		return (static_cast<uint32>(shapenum) << 8) | (framenum & 0xff);
+	}
+
+	/// @param tolerance  Tiles that may differ, 0 for exact matches only.
+	explicit Terrain_dedup(int tolerance = 0);
+
+	/// Number a terrain.
+	/// @param tiles  Its tiles, row by row.
+	/// @return Its number: a new one (the count before) if not seen.
+	int add(const Tiles& tiles);
+
+	/// The terrain with a number.
+	const Tiles& get(int tnum) const {
+		return terrains[tnum];
+	}
+
+	/// How many different terrains.
+	int size() const {
+		return static_cast<int>(terrains.size());
+	}
+
+	size_t get_added() const {
+		return added;
+	}
+
+	size_t get_exact_matches() const {
+		return exact;
+	}
+
+	size_t get_near_matches() const {
+		return near;
+	}
+
+	/// Tell how many terrains there were and how much room they take.
+	/// @param bytes_each  Bytes per terrain (in a file or in memory).
+	void report(std::ostream& out, size_t bytes_each) const;
+
+private:
+	int                         tolerance;
+	int                         nruns;    // Runs of tiles, if tolerance.
+	std::vector<Tiles>          terrains;
+	std::unordered_multimap<uint64, int> by_hash;
+	/// Run # -> hash of a run -> terrains with that run.
+	std::vector<std::unordered_map<uint64, std::vector<int>>> by_run;
+	size_t                      added = 0;
+	size_t                      exact = 0;
+	size_t                      near  = 0;
+
+	int run_start(int run) const {
+		return run * ntiles / nruns;
+	}
+
+	static uint64 hash(const uint32* first, const uint32* last);
+	// The numbered terrain nearest to one, if within the tolerance.
+	int find_near(const Tiles& tiles, const uint64* run_hashes) const;
+};
+
+#endif
@@ -26,8 +26,8 @@ using namespace std;
 
 #	include "unzip.h"
 
-#	include "../databuf.h"
-#	include "../utils.h"
+#	include "databuf.h"
+#	include "utils.h"
 #	include "exceptions.h"
 
 #	if !defined(unix) && !defined(CASESENSITIVITYDEFAULT_YES) \
@@ -83,6 +83,7 @@ struct file_in_zip_read_info_s {
 	uLong rest_read_uncompressed; /*number of byte to be obtained after decomp*/
 	IDataSource* file;            /* io structore of the zipfile */
 	uLong        compression_method; /* compression method (0==store) */
+	int          raw; /* 1 if the data is read without inflating it */
 	uLong byte_before_the_zipfile;   /* byte before the zipfile, (>0 for sfx)*/
 };
 
@@ -882,6 +883,10 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(
   If there is no error and the file is opened, the return value is UNZ_OK.
 */
 extern int ZEXPORT unzOpenCurrentFile(unz_s* file) {
+	return unzOpenCurrentFile2(file, 0);
+}
+
+extern int ZEXPORT unzOpenCurrentFile2(unz_s* file, int raw) {
 	int                      err = UNZ_OK;
 	bool                     Store;
 	uInt                     iSizeVar;
@@ -933,12 +938,13 @@ extern int ZEXPORT unzOpenCurrentFile(unz_s* file) {
 		&& (file->cur_file_info.compression_method != Z_DEFLATED)) {
 		return UNZ_BADZIPFILE;
 	}
-	Store = file->cur_file_info.compression_method == 0;
+	Store = file->cur_file_info.compression_method == 0 || raw != 0;
 
 	pfile_in_zip_read_info->crc32_wait = file->cur_file_info.crc;
 	pfile_in_zip_read_info->crc32      = 0;
+	pfile_in_zip_read_info->raw        = raw;
 	pfile_in_zip_read_info->compression_method
-			= file->cur_file_info.compression_method;
+			= Store ? 0 : file->cur_file_info.compression_method;
 	pfile_in_zip_read_info->file = file->file;
 	pfile_in_zip_read_info->byte_before_the_zipfile
 			= file->byte_before_the_zipfile;
@@ -964,8 +970,10 @@ extern int ZEXPORT unzOpenCurrentFile(unz_s* file) {
 	}
 	pfile_in_zip_read_info->rest_read_compressed
 			= file->cur_file_info.compressed_size;
+	/* Raw data is read as if it was stored. */
 	pfile_in_zip_read_info->rest_read_uncompressed
-			= file->cur_file_info.uncompressed_size;
+			= raw != 0 ? file->cur_file_info.compressed_size
+					   : file->cur_file_info.uncompressed_size;
 
 	pfile_in_zip_read_info->pos_in_zipfile
 			= file->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER
@@ -1224,7 +1232,8 @@ extern int ZEXPORT unzCloseCurrentFile(unz_s* file) {
 		return UNZ_PARAMERROR;
 	}
 
-	if (pfile_in_zip_read_info->rest_read_uncompressed == 0) {
+	if (pfile_in_zip_read_info->rest_read_uncompressed == 0
+		&& pfile_in_zip_read_info->raw == 0) {
 		if (pfile_in_zip_read_info->crc32
 			!= pfile_in_zip_read_info->crc32_wait) {
 			err = UNZ_CRCERROR;
@@ -190,6 +190,14 @@ extern int ZEXPORT unzGetCurrentFileInfo(
 */
 extern int ZEXPORT unzOpenCurrentFile(unz_s* file);
 
+/*
+  Same as unzOpenCurrentFile, but if raw=1 the data is read as it is
+  stored in the zipfile, without inflating it or checking its CRC.
+  unz_file_info has the compression method, CRC and sizes needed to
+  copy it into another zipfile with zipOpenNewFileInZip2.
+*/
+extern int ZEXPORT unzOpenCurrentFile2(unz_s* file, int raw);
+
 /*
   Close the file in zip opened with unzOpenCurrentFile
   Return UNZ_CRCERROR if all the file was read but the CRC is not good
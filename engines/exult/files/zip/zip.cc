@@ -118,6 +118,7 @@ struct curfile_info {
 	uLong flag;               /* flag of the file currently writing */
 
 	int  method;                   /* compression method of file currenty wr.*/
+	int  raw;                      /* 1 if data is written already compressed */
 	Byte buffered_data[Z_BUFSIZE]; /* buffer contain compressed data to be
 									  writ*/
 	uLong dosDate;
@@ -309,6 +310,17 @@ extern int ZEXPORT zipOpenNewFileInZip(
 		const void* extrafield_local, uInt size_extrafield_local,
 		const void* extrafield_global, uInt size_extrafield_global,
 		const char* comment, int method, int level) {
+	return zipOpenNewFileInZip2(
+			file, filename, zipfi, extrafield_local, size_extrafield_local,
+			extrafield_global, size_extrafield_global, comment, method, level,
+			0);
+}
+
+extern int ZEXPORT zipOpenNewFileInZip2(
+		zipFile file, const char* filename, const zip_fileinfo* zipfi,
+		const void* extrafield_local, uInt size_extrafield_local,
+		const void* extrafield_global, uInt size_extrafield_global,
+		const char* comment, int method, int level, int raw) {
 	uInt size_filename;
 	uInt size_comment;
 	uInt i;
@@ -364,6 +376,7 @@ extern int ZEXPORT zipOpenNewFileInZip(
 
 	file->ci.crc32                = 0;
 	file->ci.method               = method;
+	file->ci.raw                  = raw;
 	file->ci.stream_initialised   = 0;
 	file->ci.pos_in_buffered_data = 0;
 	file->ci.pos_local_header     = ftell(file->filezip);
@@ -485,7 +498,8 @@ extern int ZEXPORT zipOpenNewFileInZip(
 	file->ci.stream.total_in  = 0;
 	file->ci.stream.total_out = 0;
 
-	if ((err == ZIP_OK) && (file->ci.method == Z_DEFLATED)) {
+	if ((err == ZIP_OK) && (file->ci.method == Z_DEFLATED)
+		&& (file->ci.raw == 0)) {
 		file->ci.stream.zalloc = nullptr;
 		file->ci.stream.zfree  = nullptr;
 		file->ci.stream.opaque = nullptr;
@@ -516,7 +530,10 @@ extern int ZEXPORT zipWriteInFileInZip(zipFile file, voidpc buf, unsigned len) {
 
 	file->ci.stream.next_in  = static_cast<const Bytef*>(buf);
 	file->ci.stream.avail_in = len;
-	file->ci.crc32 = crc32(file->ci.crc32, static_cast<const Bytef*>(buf), len);
+	if (file->ci.raw == 0) {
+		file->ci.crc32
+				= crc32(file->ci.crc32, static_cast<const Bytef*>(buf), len);
+	}
 
 	while ((err == ZIP_OK) && (file->ci.stream.avail_in > 0)) {
 		if (file->ci.stream.avail_out == 0) {
@@ -530,7 +547,7 @@ extern int ZEXPORT zipWriteInFileInZip(zipFile file, voidpc buf, unsigned len) {
 			file->ci.stream.next_out      = file->ci.buffered_data;
 		}
 
-		if (file->ci.method == Z_DEFLATED) {
+		if ((file->ci.method == Z_DEFLATED) && (file->ci.raw == 0)) {
 			const uLong uTotalOutBefore = file->ci.stream.total_out;
 			err                         = deflate(&file->ci.stream, Z_NO_FLUSH);
 			file->ci.pos_in_buffered_data
@@ -560,6 +577,11 @@ extern int ZEXPORT zipWriteInFileInZip(zipFile file, voidpc buf, unsigned len) {
 }
 
 extern int ZEXPORT zipCloseFileInZip(zipFile file) {
+	return zipCloseFileInZipRaw(file, 0, 0);
+}
+
+extern int ZEXPORT zipCloseFileInZipRaw(
+		zipFile file, uLong uncompressed_size, uLong crc) {
 	int err = ZIP_OK;
 
 	if (file == nullptr) {
@@ -571,7 +593,7 @@ extern int ZEXPORT zipCloseFileInZip(zipFile file) {
 	}
 	file->ci.stream.avail_in = 0;
 
-	if (file->ci.method == Z_DEFLATED) {
+	if ((file->ci.method == Z_DEFLATED) && (file->ci.raw == 0)) {
 		while (err == ZIP_OK) {
 			uLong uTotalOutBefore;
 			if (file->ci.stream.avail_out == 0) {
@@ -603,11 +625,16 @@ extern int ZEXPORT zipCloseFileInZip(zipFile file) {
 		}
 	}
 
-	if ((file->ci.method == Z_DEFLATED) && (err == ZIP_OK)) {
+	if ((file->ci.stream_initialised != 0) && (err == ZIP_OK)) {
 		err                         = deflateEnd(&file->ci.stream);
 		file->ci.stream_initialised = 0;
 	}
 
+	if (file->ci.raw != 0) {
+		file->ci.stream.total_in = uncompressed_size;
+		file->ci.crc32           = crc;
+	}
+
 	ziplocal_putValue_inmemory(
 			file->ci.central_header + 16, file->ci.crc32, 4); /*crc*/
 	ziplocal_putValue_inmemory(
@@ -115,6 +115,18 @@ extern int ZEXPORT zipOpenNewFileInZip(
   level contain the level of compression (can be Z_DEFAULT_COMPRESSION)
 */
 
+extern int ZEXPORT zipOpenNewFileInZip2(
+		zipFile file, const char* filename, const zip_fileinfo* zipfi,
+		const void* extrafield_local, uInt size_extrafield_local,
+		const void* extrafield_global, uInt size_extrafield_global,
+		const char* comment, int method, int level, int raw);
+/*
+  Same as zipOpenNewFileInZip, except if raw=1: then the data written with
+  zipWriteInFileInZip is stored as it is, and must already be compressed
+  with method (raw deflate, without a zlib header).  level is only used
+  for the flags in the header.  Close the file with zipCloseFileInZipRaw.
+*/
+
 extern int ZEXPORT zipWriteInFileInZip(zipFile file, voidpc buf, unsigned len);
 /*
   Write data in the zipfile
@@ -125,6 +137,14 @@ extern int ZEXPORT zipCloseFileInZip(zipFile file);
   Close the current file in the zipfile
 */
 
+extern int ZEXPORT zipCloseFileInZipRaw(
+		zipFile file, uLong uncompressed_size, uLong crc);
+/*
+  Close the current file in the zipfile, for a file opened with raw=1.
+  uncompressed_size and crc are those of the data before it was
+  compressed.
+*/
+
 extern int ZEXPORT zipClose(zipFile file, const char* global_comment);
 /*
   Close the zipfile
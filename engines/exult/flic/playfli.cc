@@ -29,15 +29,25 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "playfli.h"
 
+#include "Async_log.h"
 #include "databuf.h"
 #include "endianio.h"
 #include "exceptions.h"
 #include "gamewin.h"
+#include "ibuf8.h"
 #include "palette.h"
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #ifdef __GNUC__
 #	pragma GCC diagnostic push
@@ -57,32 +67,462 @@ using std::endl;
 using std::ifstream;
 using std::size_t;
 
-void playfli::initfli() {
-	size_t pos = fli_data.getPos();
-	fli_data.skip(4);
-	fli_magic = fli_data.read2();
-	fli_data.seek(pos);
+namespace {
+	Log_category flic_log("flic");
+}    // namespace
+
+/*
+ *  Decodes the frames of a flic on a thread of its own, a few ahead of
+ *  the one play() wants next, so that play() only has to show them on
+ *  time.  Each frame changes the one before, so they're decoded in
+ *  order, from the start again after restart().  The palette is left to
+ *  play(), which gets each frame's colors with it.
+ */
+
+class playfli::Decoder {
+public:
+	struct Frame {
+		std::vector<unsigned char>     pixels;    // Width * height.
+		std::array<unsigned char, 768> colors{};
+		bool has_palette = false;    // Colors were read.
+		bool changepal   = false;    // And should be applied.
+	};
+
+	Decoder(std::unique_ptr<IExultDataSource> data, size_t start, int w,
+			int h, int frames)
+			: fli_data(std::move(data)), streamstart(start), streampos(start),
+			  fli_width(w), fli_height(h), fli_frames(frames), canvas(w, h),
+			  pixbuf(w) {}
+
+	Decoder(const Decoder&)            = delete;
+	Decoder& operator=(const Decoder&) = delete;
+	~Decoder();
+
+	Frame next();
+	void  release(std::vector<unsigned char> pixels);
+	void  restart();
+
+private:
+	static constexpr size_t max_ready = 4;    // Frames decoded ahead.
+
+	// Only the thread uses these while it runs.
+	std::unique_ptr<IExultDataSource> fli_data;
+	size_t                            streamstart;
+	size_t                            streampos;
+	int                               fli_width;
+	int                               fli_height;
+	int                               fli_frames;
+	int                               next_frame = 0;
+	int                               thispal    = -1;
+	int                               nextpal    = 0;
+	Image_buffer8                     canvas;    // The frame decoded last.
+	std::vector<uint8>                pixbuf;
+
+	std::thread             worker;
+	bool                    started  = false;
+	bool                    threaded = false;
+	std::mutex              mutex;
+	std::condition_variable room;       // Space in ready, a restart or quit.
+	std::condition_variable decoded;    // A frame in ready, or an error.
+	std::deque<Frame>       ready;
+	std::vector<std::vector<unsigned char>> spare;
+	std::vector<unsigned char>              played;    // Frame played last.
+	unsigned           generation = 0;    // Counts restarts.
+	bool               rewind     = false;
+	bool               quit       = false;
+	std::exception_ptr error;
+
+	void                       run();
+	void                       rewind_stream();
+	std::vector<unsigned char> get_pixels();
+	void                       decode(Frame& out);
+};
+
+playfli::Decoder::~Decoder() {
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	room.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+/*
+ *  Get the next frame, waiting for it if need be.  The thread is started
+ *  the first time.
+ */
+
+playfli::Decoder::Frame playfli::Decoder::next() {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!started) {
+		started = true;
+		try {
+			worker   = std::thread(&Decoder::run, this);
+			threaded = true;
+		} catch (const std::system_error&) {
+			// No threads here: decode each frame when it's wanted.
+		}
+	}
+	if (!threaded) {
+		if (rewind) {
+			rewind_stream();
+			rewind = false;
+		}
+		Frame frame;
+		frame.pixels = get_pixels();
+		lock.unlock();
+		decode(frame);
+		return frame;
+	}
+	decoded.wait(lock, [this] {
+		return !ready.empty() || error;
+	});
+	if (ready.empty()) {
+		std::rethrow_exception(error);
+	}
+	Frame frame = std::move(ready.front());
+	ready.pop_front();
+	lock.unlock();
+	room.notify_one();
+	return frame;
+}
+
+/*
+ *  Give back the pixels of the frame just played, for a restart() and
+ *  then for the frames after.
+ */
+
+void playfli::Decoder::release(std::vector<unsigned char> pixels) {
+	const std::lock_guard<std::mutex> lock(mutex);
+	if (!played.empty()) {
+		spare.push_back(std::move(played));
+	}
+	played = std::move(pixels);
+}
+
+/*
+ *  Go back to the first frame, dropping those decoded ahead.
+ */
+
+void playfli::Decoder::restart() {
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		for (auto& frame : ready) {
+			spare.push_back(std::move(frame.pixels));
+		}
+		ready.clear();
+		generation++;
+		rewind = true;
+	}
+	room.notify_one();
+}
+
+/*
+ *  Decode frames until told to quit, keeping up to max_ready of them.
+ */
+
+void playfli::Decoder::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		room.wait(lock, [this] {
+			return quit || rewind
+				   || (ready.size() < max_ready && next_frame < fli_frames);
+		});
+		if (quit) {
+			return;
+		}
+		if (rewind) {
+			rewind_stream();
+			rewind = false;
+		}
+		if (ready.size() >= max_ready || next_frame >= fli_frames) {
+			continue;
+		}
+		const unsigned gen = generation;
+		Frame          frame;
+		frame.pixels = get_pixels();
+		lock.unlock();
+		try {
+			decode(frame);
+		} catch (...) {
+			// For play() to throw, after the frames before it.
+			lock.lock();
+			error = std::current_exception();
+			decoded.notify_all();
+			return;
+		}
+		lock.lock();
+		if (gen == generation) {
+			ready.push_back(std::move(frame));
+			decoded.notify_all();
+		} else {    // Restarted meanwhile.
+			spare.push_back(std::move(frame.pixels));
+		}
+	}
+}
+
+/*
+ *  Back to the start, with the mutex held.  The first frame may only
+ *  change part of the one played last, so decoding goes on from that.
+ */
+
+void playfli::Decoder::rewind_stream() {
+	streampos  = streamstart;
+	next_frame = 0;
+	nextpal    = 0;
+	if (!played.empty()) {
+		std::copy(played.begin(), played.end(), canvas.get_bits());
+	}
+}
+
+std::vector<unsigned char> playfli::Decoder::get_pixels() {
+	if (spare.empty()) {
+		return std::vector<unsigned char>(size_t(fli_width) * fli_height);
+	}
+	auto pixels = std::move(spare.back());
+	spare.pop_back();
+	return pixels;
+}
+
+/*
+ *  Decode the next frame onto the canvas, and copy it out.
+ */
+
+void playfli::Decoder::decode(Frame& out) {
+	auto read_palette = [this]() {
+		const size_t packets = fli_data->read2();
+
+		std::array<unsigned char, 768> colors{};
+
+		auto* current = colors.data();
+
+		for (size_t p_count = 0; p_count < packets; p_count++) {
+			const size_t skip = fli_data->read1();
+
+			current += skip;
+			size_t change = fli_data->read1();
+
+			if (change == 0) {
+				change = 256;
+			}
+			fli_data->read(current, change * 3);
+		}
+		return colors;
+	};
+
+	auto update_palette
+			= [this, &out](const std::array<unsigned char, 768>& colors) {
+				  out.colors      = colors;
+				  out.has_palette = true;
+				  if (thispal != nextpal) {
+					  thispal       = nextpal;
+					  out.changepal = true;
+				  }
+				  nextpal++;
+			  };
+
+	fli_data->seek(streampos);
+	const int frame_size = fli_data->read4();
+	// Skip frame_magic
+	fli_data->skip(2);
+	const int frame_chunks = fli_data->read2();
+	fli_data->skip(8);
+	for (int chunk = 0; chunk < frame_chunks; chunk++) {
+		// Skip chunk_size
+		fli_data->skip(4);
+		const auto chunk_type = static_cast<FlicChunks>(fli_data->read2());
+
+		switch (chunk_type) {
+		case FLI_COLOR256: {
+			auto colors = read_palette();
+			for (auto& color : colors) {
+				color /= 4;
+			}
+			update_palette(colors);
+			break;
+		}
+
+		case FLI_COLOR: {
+			auto colors = read_palette();
+			update_palette(colors);
+			break;
+		}
+
+		case FLI_LC: {
+			const int skip_lines   = fli_data->read2();
+			const int change_lines = fli_data->read2();
+			for (int line = 0; line < change_lines; line++) {
+				const int packets = fli_data->read1();
+				int       pix_pos = 0;
+				for (int p_count = 0; p_count < packets; p_count++) {
+					const int skip_count = fli_data->read1();
+					pix_pos += skip_count;
+					const int size_count
+							= static_cast<sint8>(fli_data->read1());
+					if (size_count < 0) {
+						const int  pix_count = std::abs(size_count);
+						const auto data
+								= static_cast<uint8>(fli_data->read1());
+						canvas.fill_hline8(
+								data, pix_count, pix_pos,
+								skip_lines + line);
+						pix_pos += pix_count;
+					} else {
+						fli_data->read(pixbuf.data(), size_count);
+						canvas.copy_hline8(
+								pixbuf.data(), size_count, pix_pos,
+								skip_lines + line);
+						pix_pos += size_count;
+					}
+				}
+			}
+			break;
+		}
+
+		case FLI_BLACK:
+			canvas.fill8(0);
+			break;
+
+		case FLI_BRUN: {
+			for (int line = 0; line < fli_height; line++) {
+				const int packets = fli_data->read1();
+				auto*     pix_pos = pixbuf.data();
+				for (int p_count = 0; p_count < packets; p_count++) {
+					const int size_count
+							= static_cast<sint8>(fli_data->read1());
+					if (size_count > 0) {
+						const auto data
+								= static_cast<uint8>(fli_data->read1());
+						pix_pos = std::fill_n(pix_pos, size_count, data);
+					} else {
+						const int pix_count = std::abs(size_count);
+						fli_data->read(pix_pos, pix_count);
+						pix_pos += pix_count;
+					}
+				}
+				canvas.copy_hline8(pixbuf.data(), fli_width, 0, line);
+			}
+			break;
+		}
+
+		case FLI_COPY: {
+			for (int line = 0; line < fli_height; line++) {
+				fli_data->read(pixbuf.data(), fli_width);
+				canvas.copy_hline8(pixbuf.data(), fli_width, 0, line);
+			}
+			break;
+		}
+
+		case FLI_SS2: {
+			const int change_lines = fli_data->read2();
+			for (int line = 0; line < change_lines; line++) {
+				int packets = fli_data->read2();
+				while ((packets & 0x8000U) != 0U) {
+					// flag word
+					if ((packets & 0x4000U) != 0U) {
+						// skip lines
+						line += std::abs(static_cast<sint16>(packets));
+					} else {
+						// Set last pixel of current line (used if line
+						// width is odd)
+						canvas.put_pixel8(
+								packets & 0xff, fli_width - 1, line);
+					}
+					packets = fli_data->read2();
+				}
+				int pix_pos = 0;
+				for (int p_count = 0; p_count < packets; p_count++) {
+					const int skip_count = fli_data->read1();
+					pix_pos += skip_count;
+					const int size_count
+							= static_cast<sint8>(fli_data->read1());
+					if (size_count < 0) {
+						const uint16 data       = fli_data->read2();
+						auto*        pixptr     = pixbuf.data();
+						const int    word_count = std::abs(size_count);
+						for (int i = 0; i < word_count; i++) {
+							little_endian::Write2(pixptr, data);
+						}
+						canvas.copy_hline8(
+								pixbuf.data(), 2 * word_count, pix_pos,
+								line);
+						pix_pos += 2 * word_count;
+					} else {
+						fli_data->read(pixbuf.data(), 2 * size_count);
+						canvas.copy_hline8(
+								pixbuf.data(), 2 * size_count, pix_pos,
+								line);
+						pix_pos += 2 * size_count;
+					}
+				}
+			}
+			break;
+		}
+
+		case FLI_PSTAMP: {
+			std::cerr << "FLIC ERROR: Postage Stamp Image not supported "
+						 "(chunk type FLI_PSTAMP == 18)"
+					  << endl;
+			size_t skip = fli_data->read4();
+			fli_data->skip(skip - 4);
+			break;
+		}
+
+		default:
+			std::cerr << "FLIC ERROR: Invalid chunk type: "
+					  << static_cast<int>(chunk_type) << endl;
+			break;
+		}
+	}
+
+	streampos += frame_size;
+	next_frame++;
+	std::copy_n(canvas.get_bits(), out.pixels.size(), out.pixels.begin());
+}
+
+playfli::playfli(playfli&&) noexcept            = default;
+playfli& playfli::operator=(playfli&&) noexcept = default;
+
+playfli::~playfli() noexcept {
+	if (decoder && shown_frames + dropped_frames > 0) {
+		ULTIMA_LOG(flic_log, Info)
+				<< (fli_name[0] ? fli_name : "flic") << ": " << shown_frames
+				<< " frames shown, " << dropped_frames << " dropped, "
+				<< late_frames << " late";
+	}
+}
+
+playfli::playfli(std::unique_ptr<IExultDataSource> fli_data)
+		: palette(std::make_unique<Palette>()) {
+	size_t pos = fli_data->getPos();
+	fli_data->skip(4);
+	fli_magic = fli_data->read2();
+	fli_data->seek(pos);
 	if (fli_magic != 0xaf11 && fli_magic != 0xaf12) {
 		// This is a U7-style flic with a 8-byte name prefixed.
-		fli_data.read(fli_name, 8);
+		fli_data->read(fli_name, 8);
 	}
-	fli_size  = fli_data.read4();
-	fli_magic = fli_data.read2();
+	fli_size  = fli_data->read4();
+	fli_magic = fli_data->read2();
 	if (fli_magic != 0xaf11 && fli_magic != 0xaf12) {
 		throw exult_exception("Not a valid FLI file");
 	}
-	fli_frames = fli_data.read2();
-	fli_width  = fli_data.read2();
-	fli_height = fli_data.read2();
-	fli_depth  = fli_data.read2();
-	fli_flags  = fli_data.read2();
-	fli_speed  = fli_data.read2();
-	fli_data.skip(110);
-	streampos = streamstart = fli_data.getPos();
-	frame                   = 0;
-	thispal                 = -1;
-	nextpal                 = 0;
-	changepal               = false;
+	fli_frames = fli_data->read2();
+	fli_width  = fli_data->read2();
+	fli_height = fli_data->read2();
+	fli_depth  = fli_data->read2();
+	fli_flags  = fli_data->read2();
+	fli_speed  = fli_data->read2();
+	fli_data->skip(110);
+	const size_t streamstart = fli_data->getPos();
+	frame                    = 0;
+	changepal                = false;
+
+	decoder = std::make_unique<Decoder>(
+			std::move(fli_data), streamstart, fli_width, fli_height,
+			fli_frames);
 }
 
 void playfli::info(fliinfo* fi) const {
@@ -140,205 +580,26 @@ int playfli::play(
 	}
 
 	if (first_frame < frame) {
-		nextpal   = 0;
-		frame     = 0;
-		streampos = streamstart;
+		frame = 0;
+		decoder->restart();
 	}
 
-	std::vector<uint8> pixbuf(fli_width);
-
 	if (brightness != palette->get_brightness()) {
 		palette->set_brightness(brightness);
 		changepal = true;
 	}
 
-	auto read_palette = [this]() {
-		const size_t packets = fli_data.read2();
-
-		std::array<unsigned char, 768> colors{};
-
-		auto* current = colors.data();
-
-		for (size_t p_count = 0; p_count < packets; p_count++) {
-			const size_t skip = fli_data.read1();
-
-			current += skip;
-			size_t change = fli_data.read1();
-
-			if (change == 0) {
-				change = 256;
-			}
-			fli_data.read(current, change * 3);
-		}
-		return colors;
-	};
-
-	auto update_palette = [this](const std::array<unsigned char, 768>& colors) {
-		palette->set_palette(colors.data());
-		if (thispal != nextpal) {
-			thispal   = nextpal;
-			changepal = true;
-		}
-		nextpal++;
-	};
-
 	// Play frames...
 	for (; frame < last_frame; frame++) {
-		fli_data.seek(streampos);
-		const int frame_size = fli_data.read4();
-		// Skip frame_magic
-		fli_data.skip(2);
-		const int frame_chunks = fli_data.read2();
-		fli_data.skip(8);
-		for (int chunk = 0; chunk < frame_chunks; chunk++) {
-			// Skip chunk_size
-			fli_data.skip(4);
-			const auto chunk_type = static_cast<FlicChunks>(fli_data.read2());
-
-			switch (chunk_type) {
-			case FLI_COLOR256: {
-				auto colors = read_palette();
-				for (auto& color : colors) {
-					color /= 4;
-				}
-				update_palette(colors);
-				break;
-			}
-
-			case FLI_COLOR: {
-				auto colors = read_palette();
-				update_palette(colors);
-				break;
-			}
-
-			case FLI_LC: {
-				const int skip_lines   = fli_data.read2();
-				const int change_lines = fli_data.read2();
-				for (int line = 0; line < change_lines; line++) {
-					const int packets = fli_data.read1();
-					int       pix_pos = 0;
-					for (int p_count = 0; p_count < packets; p_count++) {
-						const int skip_count = fli_data.read1();
-						pix_pos += skip_count;
-						const int size_count
-								= static_cast<sint8>(fli_data.read1());
-						if (size_count < 0) {
-							const int  pix_count = std::abs(size_count);
-							const auto data
-									= static_cast<uint8>(fli_data.read1());
-							fli_buf->fill_hline8(
-									data, pix_count, pix_pos,
-									skip_lines + line);
-							pix_pos += pix_count;
-						} else {
-							fli_data.read(pixbuf.data(), size_count);
-							fli_buf->copy_hline8(
-									pixbuf.data(), size_count, pix_pos,
-									skip_lines + line);
-							pix_pos += size_count;
-						}
-					}
-				}
-				break;
-			}
-
-			case FLI_BLACK:
-				fli_buf->fill8(0);
-				break;
-
-			case FLI_BRUN: {
-				for (int line = 0; line < fli_height; line++) {
-					const int packets = fli_data.read1();
-					auto*     pix_pos = pixbuf.data();
-					for (int p_count = 0; p_count < packets; p_count++) {
-						const int size_count
-								= static_cast<sint8>(fli_data.read1());
-						if (size_count > 0) {
-							const auto data
-									= static_cast<uint8>(fli_data.read1());
-							pix_pos = std::fill_n(pix_pos, size_count, data);
-						} else {
-							const int pix_count = std::abs(size_count);
-							fli_data.read(pix_pos, pix_count);
-							pix_pos += pix_count;
-						}
-					}
-					fli_buf->copy_hline8(pixbuf.data(), fli_width, 0, line);
-				}
-				break;
-			}
-
-			case FLI_COPY: {
-				for (int line = 0; line < fli_height; line++) {
-					fli_data.read(pixbuf.data(), fli_width);
-					fli_buf->copy_hline8(pixbuf.data(), fli_width, 0, line);
-				}
-				break;
-			}
-
-			case FLI_SS2: {
-				const int change_lines = fli_data.read2();
-				for (int line = 0; line < change_lines; line++) {
-					int packets = fli_data.read2();
-					while ((packets & 0x8000U) != 0U) {
-						// flag word
-						if ((packets & 0x4000U) != 0U) {
-							// skip lines
-							line += std::abs(static_cast<sint16>(packets));
-						} else {
-							// Set last pixel of current line (used if line
-							// width is odd)
-							fli_buf->put_pixel8(
-									packets & 0xff, fli_width - 1, line);
-						}
-						packets = fli_data.read2();
-					}
-					int pix_pos = 0;
-					for (int p_count = 0; p_count < packets; p_count++) {
-						const int skip_count = fli_data.read1();
-						pix_pos += skip_count;
-						const int size_count
-								= static_cast<sint8>(fli_data.read1());
-						if (size_count < 0) {
-							const uint16 data       = fli_data.read2();
-							auto*        pixptr     = pixbuf.data();
-							const int    word_count = std::abs(size_count);
-							for (int i = 0; i < word_count; i++) {
-								little_endian::Write2(pixptr, data);
-							}
-							fli_buf->copy_hline8(
-									pixbuf.data(), 2 * word_count, pix_pos,
-									line);
-							pix_pos += 2 * word_count;
-						} else {
-							fli_data.read(pixbuf.data(), 2 * size_count);
-							fli_buf->copy_hline8(
-									pixbuf.data(), 2 * size_count, pix_pos,
-									line);
-							pix_pos += 2 * size_count;
-						}
-					}
-				}
-				break;
-			}
-
-			case FLI_PSTAMP: {
-				std::cerr << "FLIC ERROR: Postage Stamp Image not supported "
-							 "(chunk type FLI_PSTAMP == 18)"
-						  << endl;
-				size_t skip = fli_data.read4();
-				fli_data.skip(skip - 4);
-				break;
-			}
-
-			default:
-				std::cerr << "FLIC ERROR: Invalid chunk type: "
-						  << static_cast<int>(chunk_type) << endl;
-				break;
-			}
+		auto decoded = decoder->next();
+		if (decoded.has_palette) {
+			palette->set_palette(decoded.colors.data());
 		}
-
-		streampos += frame_size;
+		if (decoded.changepal) {
+			changepal = true;
+		}
+		fli_buf->copy8(decoded.pixels.data(), fli_width, fli_height, 0, 0);
+		decoder->release(std::move(decoded.pixels));
 
 		if (changepal) {
 			palette->apply(false);
@@ -353,6 +614,16 @@ int playfli::play(
 		const bool skip_frame
 				= Game_window::get_instance()->get_frame_skipping()
 				  && SDL_GetTicks() >= ticks;
+		if (!dont_show) {
+			if (skip_frame) {
+				dropped_frames++;
+			} else {
+				shown_frames++;
+				if (SDL_GetTicks() > ticks) {
+					late_frames++;
+				}
+			}
+		}
 
 		win->put(fli_buf.get(), xoffset, yoffset);
 
@@ -24,6 +24,8 @@
 #include "databuf.h"
 #include "imagewin.h"
 
+#include <memory>
+
 class Palette;
 
 class playfli {
@@ -52,8 +54,10 @@ private:
 		FLI_PSTAMP   = 18,    // Unsupported
 	};
 
-	IExultDataSource              fli_data;
-	std::unique_ptr<Image_buffer> fli_buf;
+	class Decoder;    // Reads the frames ahead of play().
+
+	std::unique_ptr<Decoder>      decoder;
+	std::unique_ptr<Image_buffer> fli_buf;    // The frame played last.
 	std::unique_ptr<Palette>      palette;
 	int                           fli_size;
 	int                           fli_magic;
@@ -63,24 +67,24 @@ private:
 	int                           fli_depth;
 	int                           fli_flags;
 	int                           fli_speed;
-	size_t                        streamstart;
-	size_t                        streampos;
 	int                           frame;
 	char                          fli_name[9]{};
+	// Frames shown, skipped for being behind time, and shown behind time.
+	int shown_frames   = 0;
+	int dropped_frames = 0;
+	int late_frames    = 0;
 
 public:
 	template <typename... T>
 	explicit playfli(T&&... args)
-			: fli_data(std::forward<T>(args)...),
-			  palette(std::make_unique<Palette>()) {
-		initfli();
-	}
+			: playfli(std::make_unique<IExultDataSource>(
+					  std::forward<T>(args)...)) {}
 
-	playfli(const playfli&)                = delete;
-	playfli(playfli&&) noexcept            = default;
-	playfli& operator=(const playfli&)     = delete;
-	playfli& operator=(playfli&&) noexcept = default;
-	~playfli() noexcept                    = default;
+	playfli(const playfli&)            = delete;
+	playfli(playfli&&) noexcept;
+	playfli& operator=(const playfli&) = delete;
+	playfli& operator=(playfli&&) noexcept;
+	~playfli() noexcept;
 	void info(fliinfo* fi = nullptr) const;
 	int  play(
 			 Image_window* win, int first_frame = 0, int last_frame = -1,
@@ -92,9 +96,7 @@ public:
 	}
 
 private:
-	void initfli();
-	int  nextpal;
-	int  thispal;
+	explicit playfli(std::unique_ptr<IExultDataSource> fli_data);
 	bool changepal;
 };
 
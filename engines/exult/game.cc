@@ -29,9 +29,11 @@
 #include "exult.h"
 #include "exult_constants.h"
 #include "exult_flx.h"
-#include "files/U7file.h"
+#include "U7file.h"
 #include "files/U7fileman.h"
-#include "files/utils.h"
+#include "gamemanifest.h"
+#include "pathindex.h"
+#include "utils.h"
 #include "font.h"
 #include "gameclk.h"
 #include "gamemgr/bggame.h"
@@ -47,6 +49,7 @@
 #include "palette.h"
 #include "shapeid.h"
 #include "shapes/miscinf.h"
+#include "startup_profile.h"
 
 #include <unistd.h>
 
@@ -110,7 +113,18 @@ Game::~Game() {
 }
 
 Game* Game::create_game(BaseGameInfo* mygame) {
+	const Startup_phase phase("Game::create");
 	mygame->setup_game_paths();
+	// Index the static data, so its files are found without probing.
+	// The launcher's manifest of it saves walking the directory.
+	Path_index::get().clear();
+	const std::string        static_dir = get_system_path("<STATIC>");
+	const Game_manifest*     manifest   = Game_manifest::from_environment();
+	std::vector<std::string> listed;
+	if (manifest == nullptr || !manifest->list(static_dir, listed)
+		|| !Path_index::get().add_root(static_dir, std::move(listed))) {
+		Path_index::get().add_root(static_dir);
+	}
 	gametitle    = mygame->get_cfgname();
 	modtitle     = mygame->get_mod_title();
 	game_type    = mygame->get_game_type();
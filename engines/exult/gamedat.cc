@@ -40,7 +40,9 @@
 #include "utils.h"
 #include "version.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
@@ -48,7 +50,12 @@
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #	include <io.h>
@@ -188,6 +195,14 @@ void Game_window::restore_gamedat(const char* fname    // Name of savegame file.
 		}
 		user_ignored_identity_mismatch = true;
 	}
+	// Don't let the map read ahead from files we're replacing.
+	for (auto* map : maps) {
+		if (map) {
+			map->cancel_prefetch();
+		}
+	}
+	ireg_save.clear();
+	iregs_written.clear();
 	// Check for a ZIP file first
 #ifdef HAVE_ZIP_SUPPORT
 	if (restore_gamedat_zip(fname)) {
@@ -323,14 +338,17 @@ static inline void save_gamedat_chunks(Game_map* map, Flex_writer& flex) {
  */
 
 void Game_window::save_gamedat(
-		const char* fname,      // File to create.
-		const char* savename    // User's savegame name.
+		const char* fname,       // File to create.
+		const char* savename,    // User's savegame name.
+		bool        quick        // Compress faster, if compressing.
 ) {
 	// First check for compressed save game
 #ifdef HAVE_ZIP_SUPPORT
-	if (save_compression > 0 && save_gamedat_zip(fname, savename)) {
+	if (save_compression > 0 && save_gamedat_zip(fname, savename, quick)) {
 		return;
 	}
+#else
+	ignore_unused_variable_warning(quick);
 #endif
 
 	// setup correct file list
@@ -408,8 +426,9 @@ for (const auto* savefile : savefiles) {
  */
 
 void Game_window::save_gamedat(
-		int         num,        // 0-9, currently.
-		const char* savename    // User's savegame name.
+		int         num,         // 0-9, currently.
+		const char* savename,    // User's savegame name.
+		bool        quick        // Compress faster, if compressing.
 ) {
 	char fname[50];    // Set up name.
 	snprintf(
@@ -417,7 +436,7 @@ void Game_window::save_gamedat(
 			Game::get_game_type() == BLACK_GATE     ? "bg"
 			: Game::get_game_type() == SERPENT_ISLE ? "si"
 													: "dev");
-	save_gamedat(fname, savename);
+	save_gamedat(fname, savename, quick);
 	if (num >= 0 && num < 10) {
 		// Update name
 		save_names[num] = savename;
@@ -1034,11 +1053,205 @@ bool Game_window::restore_gamedat_zip(
 
 	load_palette_timer = 0;
 
+	// Unchanged IREG's can be copied from a level 1 save on the next save.
+	ireg_save = level2zip ? "" : fname;
+	iregs_written.clear();
 	return true;
 }
 
-// Level 1 Compression
-static bool Save_level1(zipFile zipfile, const char* fname) {
+namespace {
+	/*
+	 *  A member of a zipped savegame, before it is compressed.
+	 */
+	struct Zip_member {
+		std::string                name;
+		std::vector<unsigned char> data;
+		// Set if data was copied compressed from another zip.
+		bool  raw    = false;
+		int   method = Z_DEFLATED;
+		uLong size   = 0;    // Uncompressed.
+		uLong crc    = 0;
+	};
+
+	/*
+	 *  Deflates the members of a zip on worker threads.  Each member is
+	 *  cut into blocks that are compressed separately; every block after
+	 *  the first is primed with the 32K of data before it and ends on a
+	 *  sync flush, so the blocks of a member join into a single deflate
+	 *  stream that is about as small as one compressed serially.  The
+	 *  blocks are written out in order as they become ready, so the zip
+	 *  is the same whatever the number of threads.
+	 */
+	class Zip_deflater {
+		static constexpr size_t block_size  = 128 * 1024;
+		static constexpr size_t window_size = 32 * 1024;
+
+		struct Block {
+			const Zip_member*          member;
+			size_t                     offset;
+			size_t                     len;
+			std::vector<unsigned char> out;
+			uLong                      crc = 0;
+			bool                       ok  = false;
+			std::promise<void>         done;
+
+			Block(const Zip_member* m, size_t off, size_t n)
+					: member(m), offset(off), len(n) {}
+		};
+
+		const std::vector<Zip_member>& members;
+		const int                      level;
+		std::vector<Block>             blocks;
+		std::atomic<size_t>            next_block{0};
+		std::vector<std::thread>       workers;
+
+		void deflate_block(Block& block);
+
+		void worker() {
+			size_t i;
+			while ((i = next_block++) < blocks.size()) {
+				deflate_block(blocks[i]);
+				blocks[i].done.set_value();
+			}
+		}
+
+	public:
+		Zip_deflater(const std::vector<Zip_member>& mems, int lev)
+				: members(mems), level(lev) {
+			for (const auto& member : members) {
+				if (member.raw) {
+					continue;
+				}
+				size_t offset = 0;
+				do {
+					const size_t len
+							= std::min(block_size, member.data.size() - offset);
+					blocks.emplace_back(&member, offset, len);
+					offset += len;
+				} while (offset < member.data.size());
+			}
+			const unsigned cores = std::thread::hardware_concurrency();
+			const size_t   nthreads
+					= std::min<size_t>(std::clamp(cores, 1u, 8u), blocks.size());
+			for (size_t i = 0; i < nthreads; i++) {
+				workers.emplace_back(&Zip_deflater::worker, this);
+			}
+		}
+
+		~Zip_deflater() {
+			// Let the workers run out of blocks.
+			next_block = blocks.size();
+			for (auto& thread : workers) {
+				thread.join();
+			}
+		}
+
+		Zip_deflater(const Zip_deflater&)            = delete;
+		Zip_deflater& operator=(const Zip_deflater&) = delete;
+
+		bool write(zipFile zipfile);
+	};
+
+#	ifdef __GNUC__
+#		pragma GCC diagnostic push
+#		pragma GCC diagnostic ignored "-Wold-style-cast"
+#	endif    // __GNUC__
+	int Deflate_init(z_stream* stream, int level) {
+		return deflateInit2(
+				stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	}
+#	ifdef __GNUC__
+#		pragma GCC diagnostic pop
+#	endif    // __GNUC__
+
+	/*
+	 *  Compress one block, on a worker thread.
+	 */
+
+	void Zip_deflater::deflate_block(Block& block) {
+		const unsigned char* data = block.member->data.data();
+		const bool last = block.offset + block.len == block.member->data.size();
+		block.crc       = crc32(0L, data + block.offset, block.len);
+
+		z_stream stream{};
+		if (Deflate_init(&stream, level) != Z_OK) {
+			return;
+		}
+		if (block.offset > 0) {
+			const size_t dict = std::min(window_size, block.offset);
+			deflateSetDictionary(&stream, data + block.offset - dict, dict);
+		}
+		// A sync flush adds an empty stored block, 5 bytes at most.
+		block.out.resize(deflateBound(&stream, block.len) + 16);
+		stream.next_in   = const_cast<Bytef*>(data + block.offset);
+		stream.avail_in  = block.len;
+		stream.next_out  = block.out.data();
+		stream.avail_out = block.out.size();
+
+		const int ret = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+		block.ok      = last ? ret == Z_STREAM_END
+							 : ret == Z_OK && stream.avail_in == 0
+									&& stream.avail_out > 0;
+		block.out.resize(stream.total_out);
+		deflateEnd(&stream);
+	}
+
+	/*
+	 *  Write the members to the zip, waiting for each block to be done.
+	 *
+	 *  Output: false if error.
+	 */
+
+	bool Zip_deflater::write(zipFile zipfile) {
+		auto block = blocks.begin();
+		bool ok    = true;
+		for (const auto& member : members) {
+			if (member.raw) {
+				ok = ok
+					 && zipOpenNewFileInZip2(
+								zipfile, member.name.c_str(), nullptr, nullptr,
+								0, nullptr, 0, nullptr, member.method,
+								Z_BEST_COMPRESSION, 1)
+								== ZIP_OK
+					 && zipWriteInFileInZip(
+								zipfile, member.data.data(), member.data.size())
+								== ZIP_OK
+					 && zipCloseFileInZipRaw(zipfile, member.size, member.crc)
+								== ZIP_OK;
+				continue;
+			}
+			ok = ok
+				 && zipOpenNewFileInZip2(
+							zipfile, member.name.c_str(), nullptr, nullptr, 0,
+							nullptr, 0, nullptr, Z_DEFLATED, level, 1)
+							== ZIP_OK;
+			uLong crc = crc32(0L, nullptr, 0);
+			for (; block != blocks.end() && block->member == &member;
+				 ++block) {
+				block->done.get_future().wait();
+				crc = crc32_combine(crc, block->crc, block->len);
+				ok  = ok && block->ok
+					 && zipWriteInFileInZip(
+								zipfile, block->out.data(), block->out.size())
+								== ZIP_OK;
+				// Free it as soon as it is written.
+				std::vector<unsigned char>().swap(block->out);
+			}
+			ok = ok
+				 && zipCloseFileInZipRaw(zipfile, member.data.size(), crc)
+							== ZIP_OK;
+		}
+		return ok;
+	}
+}    // namespace
+
+/*
+ *  Read a gamedat file for a zip.
+ *
+ *  Output: false if it doesn't exist in a game being edited.
+ */
+
+static bool Read_savefile(const char* fname, std::vector<unsigned char>& buf) {
 	IFileDataSource ds(fname);
 	if (!ds.good()) {
 		if (Game::is_editing()) {
@@ -1048,19 +1261,80 @@ static bool Save_level1(zipFile zipfile, const char* fname) {
 	}
 
 	const size_t size = ds.getSize();
-	const auto   buf  = ds.readN(size);
+	const size_t pos  = buf.size();
+	buf.resize(pos + size);
+	ds.read(buf.data() + pos, size);
+	return true;
+}
 
-	zipOpenNewFileInZip(
-			zipfile, remove_dir(fname), nullptr, nullptr, 0, nullptr, 0,
-			nullptr, Z_DEFLATED, Z_BEST_COMPRESSION);
+// Level 1 Compression
+static void Save_level1(std::vector<Zip_member>& members, const char* fname) {
+	Zip_member member{remove_dir(fname), {}};
+	if (Read_savefile(fname, member.data)) {
+		members.push_back(std::move(member));
+	}
+}
 
-	zipWriteInFileInZip(zipfile, buf.get(), size);
+/*
+ *  Copy members from a previous level 1 savegame as they are, without
+ *  inflating them.  'wanted' maps member names to their index in members
+ *  and the gamedat file they are for; each member found is marked raw.
+ */
 
-	return zipCloseFileInZip(zipfile) == ZIP_OK;
+static void Carry_level1(
+		const std::string& prevname, std::vector<Zip_member>& members,
+		const std::unordered_map<std::string, std::pair<size_t, std::string>>&
+				wanted) {
+	IFileDataSource ds(prevname.c_str());
+	if (!ds.good()) {
+		return;
+	}
+	unzFile unzipfile = unzOpen(&ds);
+	if (!unzipfile) {
+		return;
+	}
+	std::string name;
+	int         err = unzGoToFirstFile(unzipfile);
+	for (; err == UNZ_OK; err = unzGoToNextFile(unzipfile)) {
+		unz_file_info info;
+		if (unzGetCurrentFileInfo(
+					unzipfile, &info, nullptr, 0, nullptr, 0, nullptr, 0)
+			!= UNZ_OK) {
+			break;
+		}
+		name.resize(info.size_filename);
+		unzGetCurrentFileInfo(
+				unzipfile, nullptr, name.data(), name.size(), nullptr, 0,
+				nullptr, 0);
+		auto found = wanted.find(name);
+		if (found == wanted.end()) {
+			continue;
+		}
+		// Check the file is still the one that was saved, just in case.
+		IFileDataSource file(found->second.second.c_str());
+		if (!file.good() || file.getSize() != info.uncompressed_size) {
+			continue;
+		}
+		Zip_member& member = members[found->second.first];
+		member.data.resize(info.compressed_size);
+		if (unzOpenCurrentFile2(unzipfile, 1) != UNZ_OK) {
+			continue;
+		}
+		const int len = unzReadCurrentFile(
+				unzipfile, member.data.data(), member.data.size());
+		unzCloseCurrentFile(unzipfile);
+		if (len < 0 || static_cast<uLong>(len) != info.compressed_size) {
+			continue;
+		}
+		member.raw    = true;
+		member.method = info.compression_method;
+		member.size   = info.uncompressed_size;
+		member.crc    = info.crc;
+	}
 }
 
 // Level 2 Compression
-static bool Begin_level2(zipFile zipfile, int mapnum) {
+static void Begin_level2(std::vector<Zip_member>& members, int mapnum) {
 	char oname[8];    // Set up name.
 	if (mapnum == 0) {
 		strcpy(oname, "GAMEDAT");
@@ -1072,25 +1346,20 @@ static bool Begin_level2(zipFile zipfile, int mapnum) {
 		oname[4]                             = hexLUT[mapnum % 16];
 		oname[5]                             = 0;
 	}
-	return zipOpenNewFileInZip(
-				   zipfile, oname, nullptr, nullptr, 0, nullptr, 0, nullptr,
-				   Z_DEFLATED, Z_BEST_COMPRESSION)
-		   == ZIP_OK;
+	members.push_back(Zip_member{oname, {}});
 }
 
-static bool Save_level2(zipFile zipfile, const char* fname) {
-	IFileDataSource ds(fname);
-	if (!ds.good()) {
-		if (Game::is_editing()) {
-			return false;    // Newly developed game.
-		}
-		throw file_read_exception(fname);
-	}
+static void Save_level2(std::vector<Zip_member>& members, const char* fname) {
+	auto&        buf = members.back().data;
+	const size_t pos = buf.size();
 
-	const size_t      size = ds.getSize();
-	std::vector<char> buf(std::max<size_t>(13, size), 0);
+	// Filename first, then the size of the file, then the file.
+	buf.resize(pos + 12 + 4, 0);
+	if (!Read_savefile(fname, buf)) {
+		buf.resize(pos);
+		return;
+	}
 
-	// Filename first
 	const char* fname2 = strrchr(fname, '/');
 	if (!fname2) {
 		fname2 = strchr(fname, '\\');
@@ -1100,44 +1369,23 @@ static bool Save_level2(zipFile zipfile, const char* fname) {
 	} else {
 		fname2 = fname;
 	}
-	strncpy(buf.data(), fname2, 13);
-	int err = zipWriteInFileInZip(zipfile, buf.data(), 12);
-
-	// Size of the file
-	if (err == ZIP_OK) {
-		// Must be platform independent
-		auto* ptr = buf.data();
-		little_endian::Write4(ptr, size);
-		err = zipWriteInFileInZip(zipfile, buf.data(), 4);
-	}
-
-	// Now the actual file
-	if (err == ZIP_OK) {
-		ds.read(buf.data(), size);
-		err = zipWriteInFileInZip(zipfile, buf.data(), size);
-	}
+	strncpy(reinterpret_cast<char*>(buf.data() + pos), fname2, 12);
 
-	return err == ZIP_OK;
+	// Must be platform independent
+	auto* ptr = buf.data() + pos + 12;
+	little_endian::Write4(ptr, buf.size() - pos - 16);
 }
 
-static bool End_level2(zipFile zipfile) {
-	uint32 zeros = 0;
-
+static void End_level2(std::vector<Zip_member>& members) {
 	// Write a terminator (12 zeros)
-	int err = zipWriteInFileInZip(zipfile, &zeros, 4);
-	if (err == ZIP_OK) {
-		err = zipWriteInFileInZip(zipfile, &zeros, 4);
-	}
-	if (err == ZIP_OK) {
-		err = zipWriteInFileInZip(zipfile, &zeros, 4);
-	}
-
-	return zipCloseFileInZip(zipfile) == ZIP_OK && err == ZIP_OK;
+	auto& buf = members.back().data;
+	buf.resize(buf.size() + 12, 0);
 }
 
 bool Game_window::save_gamedat_zip(
-		const char* fname,      // File to create.
-		const char* savename    // User's savegame name.
+		const char* fname,       // File to create.
+		const char* savename,    // User's savegame name.
+		bool        quick        // Favour speed over size.
 ) {
 	char iname[128];
 	// If no compression return
@@ -1153,35 +1401,29 @@ bool Game_window::save_gamedat_zip(
 		savefiles = sisavefiles;
 	}
 
-	// Name
-	{
-		auto out = U7open_out(fname);
-		if (out) {
-			std::string title(savename);
-			title.resize(0x50, '\0');
-			out->write(title.data(), title.size());
-		}
-	}
-
-	const std::string filestr = get_system_path(fname);
-	zipFile           zipfile = zipOpen(filestr.c_str(), 1);
+	// Read everything first, so it can all be compressed at once.
+	std::vector<Zip_member> members;
 
 	// We need to explicitly save these as they are no longer included in
 	// savefiles and they should always be stored first and as level 1
 	// Screenshot may not exist so only include it if it exists
 	if (U7exists(GSCRNSHOT)) {
-		Save_level1(zipfile, GSCRNSHOT);
+		Save_level1(members, GSCRNSHOT);
 	}
-	Save_level1(zipfile, GSAVEINFO);
-	Save_level1(zipfile, IDENTITY);
+	Save_level1(members, GSAVEINFO);
+	Save_level1(members, IDENTITY);
 
 	// Level 1 Compression
 	if (save_compression != 2) {
 		for (const auto* savefile : savefiles) {
-			Save_level1(zipfile, savefile);
+			Save_level1(members, savefile);
 		}
 
-		// Now the Ireg's.
+		// Now the Ireg's.  Those that haven't been written since the
+		// last save or restore are copied from it, if it is still there.
+		const bool carry = !ireg_save.empty() && !Game::is_editing();
+		std::unordered_map<std::string, std::pair<size_t, std::string>>
+				wanted;
 		for (auto* map : maps) {
 			if (!map) {
 				continue;
@@ -1190,9 +1432,27 @@ bool Game_window::save_gamedat_zip(
 				// Check to see if the ireg exists before trying to
 				// save it; prevents crash when creating new maps
 				// for existing games
-				if (U7exists(
+				if (!U7exists(
 							map->get_schunk_file_name(U7IREG, schunk, iname))) {
-					Save_level1(zipfile, iname);
+					continue;
+				}
+				if (carry && iregs_written.count(iname) == 0) {
+					wanted.emplace(
+							remove_dir(iname),
+							std::make_pair(members.size(), iname));
+					members.push_back(Zip_member{remove_dir(iname), {}});
+				} else {
+					Save_level1(members, iname);
+				}
+			}
+		}
+		if (!wanted.empty()) {
+			Carry_level1(ireg_save, members, wanted);
+			// Read the rest the usual way.
+			for (const auto& entry : wanted) {
+				Zip_member& member = members[entry.second.first];
+				if (!member.raw) {
+					Read_savefile(entry.second.second.c_str(), member.data);
 				}
 			}
 		}
@@ -1200,10 +1460,10 @@ bool Game_window::save_gamedat_zip(
 	// Level 2 Compression
 	else {
 		// Start the GAMEDAT file.
-		Begin_level2(zipfile, 0);
+		Begin_level2(members, 0);
 
-		for(const char *savefilename:savefiles) {
-			Save_level2(zipfile, savefilename);
+		for (const char* savefilename : savefiles) {
+			Save_level2(members, savefilename);
 		}
 
 		// Now the Ireg's.
@@ -1213,9 +1473,9 @@ bool Game_window::save_gamedat_zip(
 			}
 			if (map->get_num() != 0) {
 				// Finish the open file (GAMEDAT or mapXX).
-				End_level2(zipfile);
+				End_level2(members);
 				// Start the next file (mapXX).
-				Begin_level2(zipfile, map->get_num());
+				Begin_level2(members, map->get_num());
 			}
 			for (int schunk = 0; schunk < 12 * 12; schunk++) {
 				// Check to see if the ireg exists before trying to
@@ -1223,19 +1483,49 @@ bool Game_window::save_gamedat_zip(
 				// for existing games
 				if (U7exists(
 							map->get_schunk_file_name(U7IREG, schunk, iname))) {
-					Save_level2(zipfile, iname);
+					Save_level2(members, iname);
 				}
 			}
 		}
 
-		End_level2(zipfile);
+		End_level2(members);
+	}
+
+	// Name
+	{
+		auto out = U7open_out(fname);
+		if (out) {
+			std::string title(savename);
+			title.resize(0x50, '\0');
+			out->write(title.data(), title.size());
+		}
+	}
+
+	const std::string filestr = get_system_path(fname);
+	zipFile           zipfile = zipOpen(filestr.c_str(), 1);
+	if (!zipfile) {
+		throw file_write_exception(fname);
+	}
+
+	bool ok;
+	{
+		Zip_deflater deflater(
+				members, quick ? Z_BEST_SPEED : Z_BEST_COMPRESSION);
+		ok = deflater.write(zipfile);
 	}
 
 	// ++++Better error system needed??
-	if (zipClose(zipfile, savename) != ZIP_OK) {
+	if (zipClose(zipfile, savename) != ZIP_OK || !ok) {
 		throw file_write_exception(fname);
 	}
 
+	// Level 2 zips can't be copied from.
+	if (save_compression != 2) {
+		ireg_save = fname;
+		iregs_written.clear();
+	} else if (ireg_save == fname) {
+		ireg_save.clear();
+	}
 	return true;
 }
 
@@ -1303,6 +1593,11 @@ void Game_window::MakeEmergencySave(const char* savename) {
 			std::filesystem::copy_file(entry.path(), newpath, ec);
 		}
 
+		// The real gamedat doesn't get what is written here.
+		const std::string                     old_ireg_save = ireg_save;
+		const std::unordered_set<std::string> old_iregs_written
+				= iregs_written;
+
 		// Write out current gamestate to gamedat
 		std::cerr << " attempting to save current gamestate to gamedat"
 				  << std::endl;
@@ -1311,7 +1606,15 @@ void Game_window::MakeEmergencySave(const char* savename) {
 		// save it as the save
 		std::cerr << " attempting to save gamedat as \"" << savename << "\""
 				  << std::endl;
-		save_gamedat(freesaveindex, savename);
+		save_gamedat(freesaveindex, savename, true);
+
+		ireg_save     = old_ireg_save;
+		iregs_written = old_iregs_written;
+		for (auto* map : maps) {
+			if (map) {
+				map->set_ireg_dirty();
+			}
+		}
 
 		// Remove crashtemp
 		std::filesystem::remove_all(crashtemppath);
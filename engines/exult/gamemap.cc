@@ -29,6 +29,7 @@
 #include "gamemap.h"
 
 #include "Flex.h"
+#include "Job_system.h"
 #include "actors.h" /* For Dead_body, which should be moved. */
 #include "animate.h"
 #include "barge.h"
@@ -46,9 +47,12 @@
 #include "mappatch.h"
 #include "objiter.cc" /* Yes we #include the .cc here on purpose! Please don't "fix" this */
 #include "objiter.h"
+#include "objpool.h"
 #include "objs.h"
+#include "schunk_loader.h"
 #include "shapeinf.h"
 #include "spellbook.h"
+#include "terraindedup.h"
 #include "ucsched.h"
 #include "virstone.h"
 #include "weaponinf.h"
@@ -75,11 +79,16 @@ using std::pair;
 using std::string;
 using std::vector;
 
-vector<Chunk_terrain*>*       Game_map::chunk_terrains = nullptr;
-std::unique_ptr<std::istream> Game_map::chunks;
-bool                          Game_map::v2_chunks               = false;
-bool                          Game_map::read_all_terrain        = false;
-bool                          Game_map::chunk_terrains_modified = false;
+vector<Chunk_terrain*>*        Game_map::chunk_terrains = nullptr;
+std::unique_ptr<std::istream>  Game_map::chunks;
+std::unique_ptr<U7mapped_file> Game_map::chunks_map;
+bool                           Game_map::v2_chunks               = false;
+unsigned                       Game_map::evict_hand              = 0;
+bool                           Game_map::read_all_terrain        = false;
+bool                           Game_map::chunk_terrains_modified = false;
+
+// Unused terrains are deleted once there are more than this many.
+constexpr const int c_max_terrains = 2048;
 
 const int   V2_CHUNK_HDR_SIZE = 4 + 4 + 2;    // 0xffff, "exlt", vers.
 static char v2hdr[]
@@ -113,15 +122,20 @@ Chunk_terrain* Game_map::read_terrain(
 	const int ntiles = c_tiles_per_chunk * c_tiles_per_chunk;
 	assert(chunk_num >= 0
 		   && static_cast<unsigned>(chunk_num) < chunk_terrains->size());
-	unsigned char buf[ntiles * 3];
-	if (v2_chunks) {
-		chunks->seekg(V2_CHUNK_HDR_SIZE + chunk_num * ntiles * 3);
-		chunks->read(reinterpret_cast<char*>(buf), ntiles * 3);
+	evict_terrains();
+	// Terrains are all the same size, so find it by its number.
+	const size_t len    = v2_chunks ? ntiles * 3 : ntiles * 2;
+	const size_t offset = (v2_chunks ? V2_CHUNK_HDR_SIZE : 0)
+						  + static_cast<size_t>(chunk_num) * len;
+	unsigned char        buf[ntiles * 3];
+	const unsigned char* data = &buf[0];
+	if (chunks_map && offset + len <= chunks_map->get_size()) {
+		data = chunks_map->get_data() + offset;    // Read it in place.
 	} else {
-		chunks->seekg(chunk_num * ntiles * 2);
-		chunks->read(reinterpret_cast<char*>(buf), ntiles * 2);
+		chunks->seekg(offset);
+		chunks->read(reinterpret_cast<char*>(buf), len);
 	}
-	auto* ter = new Chunk_terrain(&buf[0], v2_chunks);
+	auto* ter = new Chunk_terrain(data, v2_chunks);
 	if (static_cast<unsigned>(chunk_num) >= chunk_terrains->size()) {
 		chunk_terrains->resize(chunk_num + 1);
 	}
@@ -129,13 +143,40 @@ Chunk_terrain* Game_map::read_terrain(
 	return ter;
 }
 
+/*
+ *  Delete terrains that no chunk uses once there are too many of them.
+ *  They're read in again when needed.  Not while map-editing, which
+ *  keeps pointers to terrains and expects them all to stay in memory.
+ */
+
+void Game_map::evict_terrains() {
+	if (Chunk_terrain::get_count() < c_max_terrains || read_all_terrain
+		|| chunk_terrains_modified || Game::is_editing()
+		|| cheat.in_map_editor()) {
+		return;
+	}
+	const unsigned cnt = chunk_terrains->size();
+	// Go around, stopping when under 3/4 of the limit.
+	for (unsigned n = 0;
+		 n < cnt && Chunk_terrain::get_count() > c_max_terrains * 3 / 4;
+		 n++) {
+		evict_hand          = (evict_hand + 1) % cnt;
+		Chunk_terrain*& ter = (*chunk_terrains)[evict_hand];
+		if (ter && ter->is_unused()) {
+			delete ter;
+			ter = nullptr;
+		}
+	}
+}
+
 /*
  *  Create game window.
  */
 
 Game_map::Game_map(int n)
 		: num(n), didinit(false), map_modified(false), caching_out(0),
-		  map_patches(std::make_unique<Map_patch_collection>()) {}
+		  map_patches(std::make_unique<Map_patch_collection>()),
+		  loader(std::make_unique<Schunk_loader>()) {}
 
 /*
  *  Deleting map.
@@ -150,9 +191,11 @@ Game_map::~Game_map() {
  */
 
 void Game_map::init_chunks() {
-	int        num_chunk_terrains;
-	const bool patch_exists = is_system_path_defined("<PATCH>");
+	int         num_chunk_terrains;
+	const bool  patch_exists = is_system_path_defined("<PATCH>");
+	const char* fname        = U7CHUNKS;
 	if (patch_exists && U7exists(PATCH_U7CHUNKS)) {
+		fname  = PATCH_U7CHUNKS;
 		chunks = U7open_in(PATCH_U7CHUNKS);
 	} else {
 		try {
@@ -172,9 +215,12 @@ void Game_map::init_chunks() {
 			unsigned char buf[16 * 16 * 3]{};
 			ochunks.write(reinterpret_cast<char*>(buf), sizeof(buf));
 			pOchunks.reset();
+			fname  = PATCH_U7CHUNKS;
 			chunks = U7open_in(PATCH_U7CHUNKS);
 		}
 	}
+	// Map it, if we can, so terrains can be read in place.
+	chunks_map = U7map_in(fname);
 	char v2buf[V2_CHUNK_HDR_SIZE];    // Check for V2.
 	chunks->read(v2buf, sizeof(v2buf));
 	int hdrsize = 0;
@@ -184,11 +230,17 @@ void Game_map::init_chunks() {
 		hdrsize   = V2_CHUNK_HDR_SIZE;
 		chunksz   = c_tiles_per_chunk * c_tiles_per_chunk * 3;
 	}
-	// Get to end so we can get length.
-	chunks->seekg(0, ios::end);
-	// 2 bytes/tile.
-	num_chunk_terrains
-			= (static_cast<int>(chunks->tellg()) - hdrsize) / chunksz;
+	if (chunks_map) {
+		num_chunk_terrains
+				= (static_cast<int>(chunks_map->get_size()) - hdrsize)
+				  / chunksz;
+	} else {
+		// Get to end so we can get length.
+		chunks->seekg(0, ios::end);
+		// 2 bytes/tile.
+		num_chunk_terrains
+				= (static_cast<int>(chunks->tellg()) - hdrsize) / chunksz;
+	}
 	if (!chunk_terrains) {
 		chunk_terrains = new vector<Chunk_terrain*>();
 	}
@@ -252,8 +304,14 @@ void Game_map::init() {
 	}
 	std::fill(std::begin(schunk_read), std::end(schunk_read), false);
 	std::fill(std::begin(schunk_modified), std::end(schunk_modified), false);
+	std::fill(
+			std::begin(schunk_ireg_dirty), std::end(schunk_ireg_dirty), false);
 	std::fill(std::begin(schunk_cache), std::end(schunk_cache), nullptr);
 	std::fill(std::begin(schunk_cache_sizes), std::end(schunk_cache_sizes), -1);
+	std::fill(
+			std::begin(schunk_shapes_known), std::end(schunk_shapes_known),
+			false);
+	loader->clear();
 
 	didinit = true;
 }
@@ -272,6 +330,8 @@ void Game_map::clear_chunks() {
 		chunk_terrains = nullptr;
 	}
 	chunks.reset();    // Close 'u7chunks'.
+	chunks_map.reset();
+	evict_hand       = 0;
 	read_all_terrain = false;
 }
 
@@ -300,23 +360,45 @@ void Game_map::clear() {
 	// Clear 'read' flags.
 	std::fill(std::begin(schunk_read), std::end(schunk_read), false);
 	std::fill(std::begin(schunk_modified), std::end(schunk_modified), false);
+	std::fill(
+			std::begin(schunk_ireg_dirty), std::end(schunk_ireg_dirty), false);
 	std::fill(std::begin(schunk_cache), std::end(schunk_cache), nullptr);
 	std::fill(std::begin(schunk_cache_sizes), std::end(schunk_cache_sizes), -1);
+	std::fill(
+			std::begin(schunk_shapes_known), std::end(schunk_shapes_known),
+			false);
+	loader->clear();
 }
 
 /*
- *  Read in superchunk data to cover the screen.
+ *  Stop reading superchunks ahead of time, and forget what was read
+ *  (and which shapes they have).  Call before the files in 'gamedat'
+ *  are replaced.
  */
 
-void Game_map::read_map_data() {
+void Game_map::cancel_prefetch() {
+	loader->clear();
+	std::fill(
+			std::begin(schunk_shapes_known), std::end(schunk_shapes_known),
+			false);
+}
+
+/*
+ *  Get the superchunks that cover the screen.
+ */
+
+void Game_map::get_visible_schunks(
+		int& firstsx, int& firstsy,    // First one returned.
+		int& stopsx, int& stopsy       // Past the last one returned.
+) {
 	Game_window* gwin     = Game_window::get_instance();
 	const int    scrolltx = gwin->get_scrolltx();
 	const int    scrollty = gwin->get_scrollty();
 	const int    w        = gwin->get_width();
 	const int    h        = gwin->get_height();
 	// Start one tile to left.
-	const int firstsx = (scrolltx - 1) / c_tiles_per_schunk;
-	const int firstsy = (scrollty - 1) / c_tiles_per_schunk;
+	firstsx = (scrolltx - 1) / c_tiles_per_schunk;
+	firstsy = (scrollty - 1) / c_tiles_per_schunk;
 	// End 8 tiles to right.
 	// These 1 added to the chunk limits reflect the Game_render::paint_map
 	//       1 added to the chunk limits for the Smooth Scrolling.
@@ -333,8 +415,20 @@ void Game_map::read_map_data() {
 								  / c_tiles_per_chunk)
 					   / c_chunks_per_schunk;
 	// Watch for wrapping.
-	const int stopsx = (lastsx + 1) % c_num_schunks;
-	const int stopsy = (lastsy + 1) % c_num_schunks;
+	stopsx = (lastsx + 1) % c_num_schunks;
+	stopsy = (lastsy + 1) % c_num_schunks;
+}
+
+/*
+ *  Read in superchunk data to cover the screen.
+ */
+
+void Game_map::read_map_data() {
+	int firstsx;
+	int firstsy;
+	int stopsx;
+	int stopsy;
+	get_visible_schunks(firstsx, firstsy, stopsx, stopsy);
 	// Read in "map", "ifix" objects for
 	//  all visible superchunks.
 	for (int sy = firstsy; sy != stopsy; sy = (sy + 1) % c_num_schunks) {
@@ -347,6 +441,168 @@ void Game_map::read_map_data() {
 			}
 		}
 	}
+	prefetch_schunks(firstsx, firstsy, stopsx, stopsy);
+}
+
+/*
+ *  Start reading the superchunks that cover the screen on the loader's
+ *  threads, so they're decoded at the same time while the game is set
+ *  up.  read_map_data() then adds them to the map in order.
+ */
+
+void Game_map::prefetch_map_data() {
+	// Map-editing changes the files under us.
+	if (Game::is_editing() || cheat.in_map_editor()) {
+		return;
+	}
+	int firstsx;
+	int firstsy;
+	int stopsx;
+	int stopsy;
+	get_visible_schunks(firstsx, firstsy, stopsx, stopsy);
+	for (int sy = firstsy; sy != stopsy; sy = (sy + 1) % c_num_schunks) {
+		for (int sx = firstsx; sx != stopsx; sx = (sx + 1) % c_num_schunks) {
+			const int schunk = 12 * sy + sx;
+			if (!schunk_read[schunk] && !loader->is_pending(schunk)) {
+				loader->prefetch(schunk, new_schunk_files(schunk));
+			}
+		}
+	}
+}
+
+/*
+ *  Set up the names of the files to read for a superchunk.
+ */
+
+std::unique_ptr<Schunk_files> Game_map::new_schunk_files(int schunk) {
+	auto files = std::make_unique<Schunk_files>();
+	char fname[128];    // Set up name.
+	if (is_system_path_defined("<PATCH>")) {
+		files->ifix_patch_name
+				= get_schunk_file_name(PATCH_U7IFIX, schunk, fname);
+	}
+	files->ifix_name = get_schunk_file_name(U7IFIX, schunk, fname);
+	// Moveable objects already in memory don't need reading.
+	if (!schunk_cache[schunk]) {
+		files->ireg_name = get_schunk_file_name(U7IREG, schunk, fname);
+	}
+	return files;
+}
+
+/*
+ *  Find the shapes in the files of superchunks that aren't read in and
+ *  whose shapes we don't know, reading them in parallel.  No objects
+ *  are created.
+ */
+
+void Game_map::index_schunk_shapes() {
+	std::vector<int>                           todo;
+	std::vector<std::unique_ptr<Schunk_files>> files;
+	for (int schunk = 0; schunk < c_num_schunks * c_num_schunks; schunk++) {
+		if (schunk_read[schunk] || schunk_shapes_known[schunk]) {
+			continue;
+		}
+		std::unique_ptr<Schunk_files> sfiles = new_schunk_files(schunk);
+		if (schunk_cache[schunk]) {    // Cached out, so it's in memory.
+			const int len      = std::max(schunk_cache_sizes[schunk], 0);
+			sfiles->ireg_read  = true;
+			sfiles->ireg_found = len > 0;
+			sfiles->ireg_len   = len;
+			sfiles->ireg       = std::make_unique<unsigned char[]>(len);
+			std::memcpy(sfiles->ireg.get(), schunk_cache[schunk], len);
+		}
+		todo.push_back(schunk);
+		files.push_back(std::move(sfiles));
+	}
+	Job_system::get().run("index shapes", todo.size(), [&](size_t i) {
+		Schunk_files& sfiles = *files[i];
+		try {
+			sfiles.read_ifix();
+			if (!sfiles.ireg_read && !sfiles.ireg_name.empty()) {
+				sfiles.read_ireg();
+			}
+		} catch (const std::exception& /*e*/) {
+			return;    // Searches will read it in.
+		}
+		sfiles.get_shapes(schunk_shapes[todo[i]]);
+		schunk_shapes_known[todo[i]] = true;
+	});
+}
+
+/*
+ *  Note the shapes of a superchunk's objects, which are what its files
+ *  (or cache) have once they're written.
+ */
+
+void Game_map::note_schunk_shapes(int schunk) {
+	const int            scy    = 16 * (schunk / 12);
+	const int            scx    = 16 * (schunk % 12);
+	std::vector<uint16>& shapes = schunk_shapes[schunk];
+	shapes.clear();
+	for (int cy = 0; cy < 16; cy++) {
+		for (int cx = 0; cx < 16; cx++) {
+			Map_chunk* chunk = get_chunk_unsafe(scx + cx, scy + cy);
+			if (!chunk) {
+				continue;
+			}
+			Recursive_object_iterator all(chunk->get_objects());
+			Game_object*              obj;
+			while ((obj = all.get_next()) != nullptr) {
+				shapes.push_back(obj->get_shapenum());
+			}
+		}
+	}
+	std::sort(shapes.begin(), shapes.end());
+	shapes.erase(std::unique(shapes.begin(), shapes.end()), shapes.end());
+	schunk_shapes_known[schunk] = true;
+}
+
+bool Game_map::schunk_may_have(int schunk, int shnum) const {
+	if (schunk_read[schunk] || !schunk_shapes_known[schunk]) {
+		return true;
+	}
+	const std::vector<uint16>& shapes = schunk_shapes[schunk];
+	return std::binary_search(shapes.begin(), shapes.end(), shnum);
+}
+
+/*
+ *  Queue the superchunks just past the visible ones, on the side the
+ *  avatar is facing, to be read on the loader's thread.
+ */
+
+void Game_map::prefetch_schunks(
+		int firstsx, int firstsy,    // First visible superchunk.
+		int stopsx, int stopsy       // Past last visible one.
+) {
+	Game_window* gwin = Game_window::get_instance();
+	Actor*       av   = gwin->get_main_actor();
+	// Map-editing changes the files under us.
+	if (!av || Game::is_editing() || cheat.in_map_editor()
+		|| gwin->get_map() != this) {
+		return;
+	}
+	const Tile_coord ahead = Tile_coord(0, 0, 0).get_neighbor(
+			av->get_dir_facing());
+	const int dx = ahead.tx > 0 ? 1 : (ahead.tx < 0 ? -1 : 0);
+	const int dy = ahead.ty > 0 ? 1 : (ahead.ty < 0 ? -1 : 0);
+	const int nx = (stopsx - firstsx + c_num_schunks) % c_num_schunks;
+	const int ny = (stopsy - firstsy + c_num_schunks) % c_num_schunks;
+	// Go around the visible ones.
+	for (int j = -1; j <= ny; j++) {
+		const int oy = j < 0 ? -1 : (j == ny ? 1 : 0);
+		for (int i = -1; i <= nx; i++) {
+			const int ox = i < 0 ? -1 : (i == nx ? 1 : 0);
+			if (!((ox && ox == dx) || (oy && oy == dy))) {
+				continue;    // Not ahead.
+			}
+			const int sx = (firstsx + i + c_num_schunks) % c_num_schunks;
+			const int sy = (firstsy + j + c_num_schunks) % c_num_schunks;
+			const int schunk = 12 * sy + sx;
+			if (!schunk_read[schunk] && !loader->is_pending(schunk)) {
+				loader->prefetch(schunk, new_schunk_files(schunk));
+			}
+		}
+	}
 }
 
 /*
@@ -459,6 +715,7 @@ void Game_map::write_chunk_terrains() {
 	// Got to update.
 	// IMPORTANT:  Get all in memory BEFORE truncating the file.
 	get_all_terrain();
+	chunks_map.reset();    // Can't truncate it while it's mapped.
 	// Open file for chunks data.
 	// This truncates the file.
 	auto pOchunks = U7open_out(PATCH_U7CHUNKS);
@@ -553,14 +810,15 @@ void Game_map::write_static() {
 
 void Game_map::write_ifix_objects(int schunk    // Superchunk # (0-143).
 ) {
-	char            fname[128];    // Set up name.
-	OFileDataSource ifix(get_schunk_file_name(PATCH_U7IFIX, schunk, fname));
-	// +++++Use game title.
+	char      fname[128];    // Set up name.
 	const int count = c_chunks_per_schunk * c_chunks_per_schunk;
 
 	// Always save as V2 to support 8 bit lift
-	bool        v2 = true;
-	Flex_writer writer(ifix, "Exult", count, Flex_header::exult_v2);
+	bool v2 = true;
+	// +++++Use game title.
+	Flex_writer writer(
+			get_schunk_file_name(PATCH_U7IFIX, schunk, fname), "Exult", count,
+			Flex_header::exult_v2);
 	const int   scy = 16 * (schunk / 12);    // Get abs. chunk coords.
 	const int   scx = 16 * (schunk % 12);
 	// Go through chunks.
@@ -576,99 +834,52 @@ void Game_map::write_ifix_objects(int schunk    // Superchunk # (0-143).
  *  Read in the objects for a superchunk from one of the "u7ifix" files.
  */
 
-void Game_map::get_ifix_objects(int schunk    // Superchunk # (0-143).
+void Game_map::get_ifix_objects(
+		int           schunk,    // Superchunk # (0-143).
+		Schunk_files* files      // Already read, or nullptr.
 ) {
-	char fname[128];    // Set up name.
-	if (!is_system_path_defined("<PATCH>") ||
-		// First check for patch.
-		!U7exists(get_schunk_file_name(PATCH_U7IFIX, schunk, fname))) {
-		get_schunk_file_name(U7IFIX, schunk, fname);
+	std::unique_ptr<Schunk_files> read_now;
+	if (!files || !files->ifix_read) {
+		read_now = new_schunk_files(schunk);
+		files    = read_now.get();
+		files->read_ifix();
 	}
-	IFileDataSource ifix(fname);
-	if (!ifix.good()) {
+	if (!files->ifix_found) {
 		if (!Game::is_editing()) {    // Ok if map-editing.
-			cerr << "Ifix file '" << fname << "' not found." << endl;
+			cerr << "Ifix file '" << files->ifix_file << "' not found."
+				 << endl;
 		}
 		return;
 	}
-	FlexFile  flex(fname);
-	const int vers = static_cast<int>(flex.get_vers());
-	const int scy  = 16 * (schunk / 12);    // Get abs. chunk coords.
-	const int scx  = 16 * (schunk % 12);
+	const int scy = 16 * (schunk / 12);    // Get abs. chunk coords.
+	const int scx = 16 * (schunk % 12);
 	// Go through chunks.
 	for (int cy = 0; cy < 16; cy++) {
 		for (int cx = 0; cx < 16; cx++) {
-			// Get to index entry for chunk.
-			const int    chunk_num = cy * 16 + cx;
-			size_t       len;
-			const uint32 offset = flex.get_entry_info(chunk_num, len);
-			if (len) {
-				get_ifix_chunk_objects(
-						&ifix, vers, offset, len, scx + cx, scy + cy);
+			const Schunk_files::Ifix_chunk& chunk = files->ifix[cy * 16 + cx];
+			if (!chunk.present) {
+				continue;
 			}
+			// Get object list for chunk.
+			Map_chunk* olist = get_chunk(scx + cx, scy + cy);
+			for (const auto& ent : chunk.objs) {
+				const Shape_info&  info = ShapeID::get_info(ent.shnum);
+				Game_object_shared obj
+						= (info.is_animated() || info.has_sfx())
+								  ? Make_pooled_object<Animated_ifix_object>(
+											ent.shnum, ent.frnum, ent.tx,
+											ent.ty, ent.tz)
+								  : Make_pooled_object<Ifix_game_object>(
+											ent.shnum, ent.frnum, ent.tx,
+											ent.ty, ent.tz);
+				olist->add(obj.get());
+			}
+			// Should have all dungeon pieces now.
+			olist->setup_dungeon_levels();
 		}
 	}
 }
 
-/*
- *  Get the objects from one ifix chunk entry onto the screen.
- */
-
-void Game_map::get_ifix_chunk_objects(
-		IDataSource* ifix,
-		int          vers,       // Flex file vers.
-		long         filepos,    // Offset in file.
-		int          len,        // Length of data.
-		int cx, int cy           // Absolute chunk #'s.
-) {
-	Game_object_shared obj;
-	ifix->seek(filepos);    // Get to actual shape.
-	// Get buffer to hold entries' indices.
-	auto           entries = ifix->readN(len);    // Read them in.
-	unsigned char* ent     = entries.get();
-	// Get object list for chunk.
-	Map_chunk* olist = get_chunk(cx, cy);
-	if (static_cast<Flex_header::Flex_vers>(vers) == Flex_header::orig) {
-		const int cnt = len / 4;
-		for (int i = 0; i < cnt; i++, ent += 4) {
-			int               tx    = (ent[0] >> 4) & 0xf;
-			int               ty    = ent[0] & 0xf;
-			int               tz    = ent[1] & 0xf;
-			int               shnum = ent[2] + 256 * (ent[3] & 3);
-			int               frnum = ent[3] >> 2;
-			const Shape_info& info  = ShapeID::get_info(shnum);
-			obj                     = (info.is_animated() || info.has_sfx())
-											  ? std::make_shared<Animated_ifix_object>(
-                                    shnum, frnum, tx, ty, tz)
-											  : std::make_shared<Ifix_game_object>(
-                                    shnum, frnum, tx, ty, tz);
-			olist->add(obj.get());
-		}
-	} else if (
-			static_cast<Flex_header::Flex_vers>(vers)
-			== Flex_header::exult_v2) {
-		// b0 = tx,ty, b1 = lift, b2-3 = shnum, b4=frnum
-		const int cnt = len / 5;
-		for (int i = 0; i < cnt; i++, ent += 5) {
-			int               tx    = (ent[0] >> 4) & 0xf;
-			int               ty    = ent[0] & 0xf;
-			int               tz    = ent[1];    // allow full 8 bit lift in v2
-			int               shnum = ent[2] + 256 * ent[3];
-			int               frnum = ent[4];
-			const Shape_info& info  = ShapeID::get_info(shnum);
-			obj                     = (info.is_animated() || info.has_sfx())
-											  ? std::make_shared<Animated_ifix_object>(
-                                    shnum, frnum, tx, ty, tz)
-											  : std::make_shared<Ifix_game_object>(
-                                    shnum, frnum, tx, ty, tz);
-			olist->add(obj.get());
-		}
-	} else {
-		assert(0);
-	}
-	olist->setup_dungeon_levels();    // Should have all dungeon pieces now.
-}
-
 /*
  *  Constants for IREG files:
  */
@@ -754,14 +965,21 @@ int Game_map::write_string(
  */
 
 void Game_map::write_ireg() {
+	Game_window* gwin = Game_window::get_instance();
+	// Map-editing may not go through the usual paths, so write it all.
+	const bool all = Game::is_editing();
 	// Write each superchunk to Iregxx.
 	for (int schunk = 0; schunk < c_num_schunks * c_num_schunks; schunk++) {
+		// Unchanged since it was read from its file?
+		if (!schunk_ireg_dirty[schunk] && !all) {
+			continue;
+		}
+		char fname[128];    // Set up name.
+		get_schunk_file_name(U7IREG, schunk, fname);
 		// Only write what we've read.
 		if (schunk_cache[schunk] && schunk_cache_sizes[schunk] >= 0) {
 			// It's loaded in a memory buffer
-			char fname[128];    // Set up name.
-			auto ireg_stream
-					= U7open_out(get_schunk_file_name(U7IREG, schunk, fname));
+			auto ireg_stream = U7open_out(fname);
 			if (ireg_stream) {
 				ireg_stream->write(
 						schunk_cache[schunk], schunk_cache_sizes[schunk]);
@@ -769,6 +987,16 @@ void Game_map::write_ireg() {
 		} else if (schunk_read[schunk]) {
 			// It's active
 			write_ireg_objects(schunk);
+		} else {
+			continue;
+		}
+		schunk_ireg_dirty[schunk] = false;
+		gwin->set_ireg_written(fname);
+	}
+	// What's read in now matches its files.
+	for (int schunk = 0; schunk < c_num_schunks * c_num_schunks; schunk++) {
+		if (schunk_read[schunk]) {
+			note_schunk_shapes(schunk);
 		}
 	}
 }
@@ -818,7 +1046,9 @@ void Game_map::write_ireg_objects(
  *  (These are the moveable objects.)
  */
 
-void Game_map::get_ireg_objects(int schunk    // Superchunk # (0-143).
+void Game_map::get_ireg_objects(
+		int           schunk,    // Superchunk # (0-143).
+		Schunk_files* files      // Already read, or nullptr.
 ) {
 	char                         fname[128];    // Set up name.
 	std::unique_ptr<IDataSource> ireg;
@@ -834,6 +1064,12 @@ void Game_map::get_ireg_objects(int schunk    // Superchunk # (0-143).
 		std::cout << "Reading " << get_schunk_file_name(U7IREG, schunk, fname)
 				  << " from memory" << std::endl;
 #endif
+	} else if (files && files->ireg_read) {
+		if (!files->ireg_found) {
+			return;    // Just don't show them.
+		}
+		ireg = std::make_unique<IBufferDataSource>(
+				std::move(files->ireg), files->ireg_len);
 	} else {
 		ireg = std::make_unique<IFileDataSource>(
 				get_schunk_file_name(U7IREG, schunk, fname));
@@ -1074,7 +1310,7 @@ void Game_map::read_ireg_objects(
 			if (!npc_num) {    // Avatar has no body.
 				npc_num = -1;
 			}
-			const Dead_body_shared b = std::make_shared<Dead_body>(
+			const Dead_body_shared b = Make_pooled_object<Dead_body>(
 					shnum, frnum, tilex, tiley, lift, npc_num);
 			obj = b;
 			if (npc_num > 0) {
@@ -1096,7 +1332,7 @@ void Game_map::read_ireg_objects(
 			if (info.get_shape_class() == Shape_info::virtue_stone) {
 				// Virtue stone?
 				const std::shared_ptr<Virtue_stone_object> v
-						= std::make_shared<Virtue_stone_object>(
+						= Make_pooled_object<Virtue_stone_object>(
 								shnum, frnum, tilex, tiley, lift);
 				v->set_target_pos(entry[4], entry[5], entry[6], entry[7]);
 				v->set_target_map(entry[10]);
@@ -1104,7 +1340,7 @@ void Game_map::read_ireg_objects(
 				type = 0;
 			} else if (info.get_shape_class() == Shape_info::barge) {
 				const std::shared_ptr<Barge_object> b
-						= std::make_shared<Barge_object>(
+						= Make_pooled_object<Barge_object>(
 								shnum, frnum, tilex, tiley, lift, entry[4],
 								entry[5], (quality >> 1) & 3);
 				obj = b;
@@ -1112,10 +1348,10 @@ void Game_map::read_ireg_objects(
 					gwin->set_moving_barge(b.get());
 				}
 			} else if (info.is_jawbone()) {    // serpent jawbone
-				obj = std::make_shared<Jawbone_object>(
+				obj = Make_pooled_object<Jawbone_object>(
 						shnum, frnum, tilex, tiley, lift, entry[10]);
 			} else {
-				obj = std::make_shared<Container_game_object>(
+				obj = Make_pooled_object<Container_game_object>(
 						shnum, frnum, tilex, tiley, lift, entry[10]);
 			}
 			// Read container's objects.
@@ -1137,7 +1373,7 @@ void Game_map::read_ireg_objects(
 			uint8* ptr = &entry[14];
 			// 3 unknowns, then bookmark.
 			unsigned char bmark = ptr[3];
-			obj                 = std::make_shared<Spellbook_object>(
+			obj                 = Make_pooled_object<Spellbook_object>(
                     shnum, frnum, tilex, tiley, lift, &circles[0], bmark);
 		} else {
 			// Just to shut up spurious warnings by compilers and static
@@ -1193,43 +1429,43 @@ Ireg_game_object_shared Game_map::create_ireg_object(
 	Ireg_game_object_shared newobj;
 	// (These are all animated.)
 	if (info.is_field() && info.get_field_type() >= 0) {
-		newobj = std::make_shared<Field_object>(
+		newobj = Make_pooled_object<Field_object>(
 				shnum, frnum, tilex, tiley, lift,
 				Egg_object::fire_field + info.get_field_type());
 	} else if (info.is_animated() || info.has_sfx()) {
-		newobj = std::make_shared<Animated_ireg_object>(
+		newobj = Make_pooled_object<Animated_ireg_object>(
 				shnum, frnum, tilex, tiley, lift);
 	} else if (shnum == 607) {    // Path.
-		newobj = std::make_shared<Egglike_game_object>(
+		newobj = Make_pooled_object<Egglike_game_object>(
 				shnum, frnum, tilex, tiley, lift);
 	} else if (info.is_mirror()) {    // Mirror
-		newobj = std::make_shared<Mirror_object>(
+		newobj = Make_pooled_object<Mirror_object>(
 				shnum, frnum, tilex, tiley, lift);
 	} else if (info.is_body_shape()) {
-		newobj = std::make_shared<Dead_body>(
+		newobj = Make_pooled_object<Dead_body>(
 				shnum, frnum, tilex, tiley, lift, -1);
 	} else if (info.get_shape_class() == Shape_info::virtue_stone) {
-		newobj = std::make_shared<Virtue_stone_object>(
+		newobj = Make_pooled_object<Virtue_stone_object>(
 				shnum, frnum, tilex, tiley, lift);
 	} else if (info.get_shape_class() == Shape_info::spellbook) {
 		static unsigned char circles[9] = {0};
-		newobj                          = std::make_shared<Spellbook_object>(
+		newobj                          = Make_pooled_object<Spellbook_object>(
                 shnum, frnum, tilex, tiley, lift, &circles[0], 0);
 	} else if (info.get_shape_class() == Shape_info::barge) {
-		newobj = std::make_shared<Barge_object>(
+		newobj = Make_pooled_object<Barge_object>(
 				shnum, frnum, tilex, tiley, lift,
 				// FOR NOW: 8x16 tiles, North.
 				8, 16, 0);
 	} else if (info.get_shape_class() == Shape_info::container) {
 		if (info.is_jawbone()) {
-			newobj = std::make_shared<Jawbone_object>(
+			newobj = Make_pooled_object<Jawbone_object>(
 					shnum, frnum, tilex, tiley, lift);
 		} else {
-			newobj = std::make_shared<Container_game_object>(
+			newobj = Make_pooled_object<Container_game_object>(
 					shnum, frnum, tilex, tiley, lift);
 		}
 	} else {
-		newobj = std::make_shared<Ireg_game_object>(
+		newobj = Make_pooled_object<Ireg_game_object>(
 				shnum, frnum, tilex, tiley, lift);
 	}
 	return newobj;
@@ -1254,9 +1490,10 @@ Ifix_game_object_shared Game_map::create_ifix_object(
 ) {
 	const Shape_info& info = ShapeID::get_info(shnum);
 	return (info.is_animated() || info.has_sfx())
-				   ? std::make_shared<Animated_ifix_object>(
+				   ? Make_pooled_object<Animated_ifix_object>(
 							 shnum, frnum, 0, 0, 0)
-				   : std::make_shared<Ifix_game_object>(shnum, frnum, 0, 0, 0);
+				   : Make_pooled_object<Ifix_game_object>(
+							 shnum, frnum, 0, 0, 0);
 }
 
 /*
@@ -1265,11 +1502,16 @@ Ifix_game_object_shared Game_map::create_ifix_object(
 
 void Game_map::get_superchunk_objects(int schunk    // Superchunk #.
 ) {
-	get_map_objects(schunk);       // Get map objects/scenery.
-	get_ifix_objects(schunk);      // Get objects from ifix.
-	get_ireg_objects(schunk);      // Get moveable objects.
-	schunk_read[schunk] = true;    // Done this one now.
-	map_patches->apply(schunk);    // Move/delete objects.
+	// Files read ahead of time, if any.
+	const std::unique_ptr<Schunk_files> files = loader->take(schunk);
+	// A superchunk cached out since it changed is still changed.
+	const bool dirty = schunk_cache[schunk] && schunk_ireg_dirty[schunk];
+	get_map_objects(schunk);                  // Get map objects/scenery.
+	get_ifix_objects(schunk, files.get());    // Get objects from ifix.
+	get_ireg_objects(schunk, files.get());    // Get moveable objects.
+	schunk_read[schunk]       = true;         // Done this one now.
+	schunk_ireg_dirty[schunk] = dirty;        // Adding them set it.
+	map_patches->apply(schunk);               // Move/delete objects.
 }
 
 /*
@@ -1540,6 +1782,82 @@ bool Game_map::delete_terrain(int tnum) {
 	return true;
 }
 
+/*
+ *  Have chunks with terrains that are the same (or differ in at most
+ *  'tolerance' tiles) share one, removing the others and updating the
+ *  maps.  Terrains are kept in order, and the first of each kind stays.
+ *
+ *  Output: # of terrains removed, or -1 if terrains are being edited.
+ */
+
+int Game_map::merge_terrains(int tolerance) {
+	get_all_terrain();    // Need all of 'u7chunks' read in.
+	for (Chunk_terrain* ter : *chunk_terrains) {
+		if (ter->has_edits()) {
+			return -1;
+		}
+	}
+	const int              cnt = chunk_terrains->size();
+	Terrain_dedup          dedup(tolerance);
+	vector<int>            renum(cnt);    // Old # -> new #.
+	vector<Chunk_terrain*> kept;
+	for (int i = 0; i < cnt; i++) {
+		Chunk_terrain*       ter = (*chunk_terrains)[i];
+		Terrain_dedup::Tiles tiles;
+		for (int ty = 0; ty < c_tiles_per_chunk; ty++) {
+			for (int tx = 0; tx < c_tiles_per_chunk; tx++) {
+				const ShapeID id = ter->get_flat(tx, ty);
+				tiles[ty * c_tiles_per_chunk + tx]
+						= Terrain_dedup::tile(id.get_shapenum(), id.get_framenum());
+			}
+		}
+		renum[i] = dedup.add(tiles);
+		if (renum[i] == static_cast<int>(kept.size())) {
+			kept.push_back(ter);
+			if (renum[i] != i) {
+				ter->set_modified();    // Moved down.
+			}
+		}
+	}
+	dedup.report(cout, sizeof(Chunk_terrain));
+	const int removed = cnt - static_cast<int>(kept.size());
+	if (removed == 0) {
+		return 0;
+	}
+	// Update terrain maps, moving chunks onto the terrains kept.
+	Game_window*             gwin = Game_window::get_instance();
+	const vector<Game_map*>& maps = gwin->get_maps();
+	for (auto* map : maps) {
+		if (!map) {
+			continue;
+		}
+		for (int cy = 0; cy < c_num_chunks; cy++) {
+			for (int cx = 0; cx < c_num_chunks; cx++) {
+				short&    terrain = map->terrain_map[cx][cy];
+				const int tnum    = renum[terrain];
+				if (tnum != terrain) {
+					terrain          = tnum;
+					Map_chunk* chunk = map->get_chunk_unsafe(cx, cy);
+					if (chunk && chunk->get_terrain()
+						&& chunk->get_terrain() != kept[tnum]) {
+						chunk->set_terrain(kept[tnum]);
+					}
+				}
+			}
+		}
+		map->map_modified = true;
+	}
+	for (int i = 0; i < cnt; i++) {
+		if (kept[renum[i]] != (*chunk_terrains)[i]) {
+			delete (*chunk_terrains)[i];
+		}
+	}
+	*chunk_terrains         = std::move(kept);
+	chunk_terrains_modified = true;
+	gwin->set_all_dirty();
+	return removed;
+}
+
 /*
  *  Commit edits made to terrain chunks.
  */
@@ -1589,7 +1907,26 @@ void Game_map::abort_terrain_edits() {
 }
 
 /*
- *  Find all unused shapes in game.  This can take a while!!
+ *  Call a function with the shape of each of a terrain's tiles that are
+ *  turned into objects, as Map_chunk::set_terrain() does.
+ */
+
+template <typename Func>
+static void For_terrain_objects(Chunk_terrain* ter, Func func) {
+	for (int ty = 0; ty < c_tiles_per_chunk; ty++) {
+		for (int tx = 0; tx < c_tiles_per_chunk; tx++) {
+			ShapeID      id    = ter->get_flat(tx, ty);
+			Shape_frame* shape = id.get_shape();
+			if (shape && shape->is_rle()) {
+				func(id.get_shapenum());
+			}
+		}
+	}
+}
+
+/*
+ *  Find all unused shapes in game.  The superchunks that aren't read
+ *  in are scanned in parallel, without creating their objects.
  */
 
 void Game_map::find_unused_shapes(
@@ -1599,37 +1936,56 @@ void Game_map::find_unused_shapes(
 	std::fill_n(found, foundlen, 0);
 	Game_window*   gwin = Game_window::get_instance();
 	Shape_manager* sman = Shape_manager::get_instance();
-	cout << "Reading all chunks";
-	// Read in EVERYTHING!
-	for (int sc = 0; sc < c_num_schunks * c_num_schunks; sc++) {
-		cout << '.';
-		cout.flush();
-		char msg[80];
-		snprintf(msg, sizeof(msg), "Scanning superchunk %d", sc);
-		gwin->get_effects()->center_text(msg);
-		gwin->paint();
-		gwin->show();
-		if (!schunk_read[sc]) {
-			get_superchunk_objects(sc);
-		}
-	}
-	cout << endl;
+	gwin->get_effects()->center_text("Scanning superchunks");
+	gwin->paint();
+	gwin->show();
+	// Get the shapes in the files of what isn't read in, in parallel.
+	index_schunk_shapes();
 	int       maxbits = foundlen * 8;    // Total #bits in 'found'.
 	const int nshapes = sman->get_shapes().get_num_shapes();
 	if (maxbits > nshapes) {
 		maxbits = nshapes;
 	}
-	// Go through chunks.
+	auto add_shape = [&](int shnum) {
+		if (shnum >= 0 && shnum < maxbits) {
+			found[shnum / 8] |= (1 << (shnum % 8));
+		}
+	};
+	for (int sc = 0; sc < c_num_schunks * c_num_schunks; sc++) {
+		if (schunk_read[sc]) {
+			continue;
+		}
+		if (!schunk_shapes_known[sc]) {
+			get_superchunk_objects(sc);    // Couldn't scan it.
+			continue;
+		}
+		for (const int shnum : schunk_shapes[sc]) {
+			add_shape(shnum);
+		}
+	}
+	// And the objects of their terrains.
+	std::vector<bool> terrain_done(get_num_chunk_terrains());
 	for (int cy = 0; cy < c_num_chunks; cy++) {
 		for (int cx = 0; cx < c_num_chunks; cx++) {
-			Map_chunk*                chunk = get_chunk_unchecked(cx, cy);
+			const int tnum = terrain_map[cx][cy];
+			if (is_chunk_read(cx, cy) || terrain_done[tnum]) {
+				continue;
+			}
+			terrain_done[tnum] = true;
+			For_terrain_objects(get_terrain(tnum), add_shape);
+		}
+	}
+	// Go through the objects in memory.
+	for (int cy = 0; cy < c_num_chunks; cy++) {
+		for (int cx = 0; cx < c_num_chunks; cx++) {
+			Map_chunk* chunk = get_chunk_unsafe(cx, cy);
+			if (!chunk) {
+				continue;
+			}
 			Recursive_object_iterator all(chunk->get_objects());
 			Game_object*              obj;
 			while ((obj = all.get_next()) != nullptr) {
-				const int shnum = obj->get_shapenum();
-				if (shnum >= 0 && shnum < maxbits) {
-					found[shnum / 8] |= (1 << (shnum % 8));
-				}
+				add_shape(obj->get_shapenum());
 			}
 		}
 	}
@@ -1679,6 +2035,7 @@ Game_object* Game_map::locate_shape(
 		cx   = c_num_chunks;    // Past last chunk.
 		cy   = c_num_chunks - 1;
 	}
+	index_schunk_shapes();    // So we can pass over what isn't read in.
 	Game_object* obj = nullptr;
 	if (start) {    // Start here.
 		Game_object* owner = start->get_outermost();
@@ -1714,8 +2071,17 @@ Game_object* Game_map::locate_shape(
 			cx -= dir * c_num_chunks;
 		}
 		Map_chunk* chunk = get_chunk(cx, cy);
-		// Make sure objs. are read.
-		ensure_chunk_read(cx, cy);
+		// Make sure objs. are read, unless nothing there has the shape.
+		bool terrain_has = false;
+		For_terrain_objects(
+				get_terrain(terrain_map[cx][cy]),
+				[&](int shnum) { terrain_has |= shnum == shapenum; });
+		if (terrain_has
+			|| schunk_may_have(
+					12 * (cy / c_chunks_per_schunk) + cx / c_chunks_per_schunk,
+					shapenum)) {
+			ensure_chunk_read(cx, cy);
+		}
 		if (upwards) {
 			Recursive_object_iterator_backwards next(chunk->get_objects());
 			while ((obj = next.get_next()) != nullptr) {
@@ -1881,6 +2247,7 @@ void Game_map::cache_out_schunk(int schunk) {
 	int        cx;
 	const bool save_map_modified     = map_modified;
 	const bool save_terrain_modified = chunk_terrains_modified;
+	const bool save_ireg_dirty       = schunk_ireg_dirty[schunk];
 
 	if (schunk_modified[schunk]) {
 		return;    // NEVER cache out modified chunks.
@@ -1933,6 +2300,7 @@ void Game_map::cache_out_schunk(int schunk) {
 	OBufferDataSpan ds(schunk_cache[schunk], schunk_cache_sizes[schunk]);
 
 	write_ireg_objects(schunk, &ds);
+	note_schunk_shapes(schunk);
 
 #ifdef DEBUG
 	std::cout << "Wrote " << ds.getPos() << " bytes" << std::endl;
@@ -1956,8 +2324,9 @@ void Game_map::cache_out_schunk(int schunk) {
 		}
 	}
 	// Removing objs. sets these flags.
-	schunk_modified[schunk] = false;
-	map_modified            = save_map_modified;
-	chunk_terrains_modified = save_terrain_modified;
+	schunk_modified[schunk]   = false;
+	schunk_ireg_dirty[schunk] = save_ireg_dirty;
+	map_modified              = save_map_modified;
+	chunk_terrains_modified   = save_terrain_modified;
 	--caching_out;
 }
@@ -27,9 +27,11 @@
 #include "flags.h"
 #include "tiles.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>    // STL string
 #include <vector>
@@ -45,6 +47,9 @@ class Shapes_vga_file;
 class IDataSource;
 class ODataSource;
 class Shape;
+class U7mapped_file;
+class Schunk_loader;
+struct Schunk_files;
 
 using Ireg_game_object_shared = std::shared_ptr<Ireg_game_object>;
 using Ifix_game_object_shared = std::shared_ptr<Ifix_game_object>;
@@ -58,9 +63,11 @@ using Ifix_game_object_shared = std::shared_ptr<Ifix_game_object>;
 class Game_map {
 	int num;    // Map #.  Index in gwin->maps.
 	// Flat chunk areas:
-	static std::vector<Chunk_terrain*>*  chunk_terrains;
-	static std::unique_ptr<std::istream> chunks;       // "u7chunks" file.
-	static bool                          v2_chunks;    // True if 3 bytes/entry.
+	static std::vector<Chunk_terrain*>*   chunk_terrains;
+	static std::unique_ptr<std::istream>  chunks;        // "u7chunks" file.
+	static std::unique_ptr<U7mapped_file> chunks_map;    // Or it, mapped.
+	static bool                           v2_chunks;     // 3 bytes/entry.
+	static unsigned                       evict_hand;    // For evicting.
 	static bool read_all_terrain;    // True if we've read them all.
 	static bool chunk_terrains_modified;
 	bool        didinit;
@@ -72,17 +79,36 @@ class Game_map {
 	std::unique_ptr<Map_chunk> objects[c_num_chunks][c_num_chunks];
 	bool  schunk_read[144];        // Flag for reading in each "ifix".
 	bool  schunk_modified[144];    // Flag for modified "ifix".
+	bool  schunk_ireg_dirty[144];  // Moveable objects changed since read.
 	char* schunk_cache[144];
 	int   schunk_cache_sizes[144];
+	// Shapes in each superchunk's files (or cache), sorted, so searches
+	//   can pass over superchunks that aren't read in.
+	std::vector<uint16> schunk_shapes[144];
+	bool                schunk_shapes_known[144];
 	int   caching_out;    // >0 in 'cache_out_schunk'.
 	std::unique_ptr<Map_patch_collection> map_patches;
+	std::unique_ptr<Schunk_loader>        loader;    // Reads ahead.
 
 	Map_chunk*            create_chunk(int cx, int cy);
 	static Chunk_terrain* read_terrain(int chunk_num);
+	static void           evict_terrains();
 
 	// Create a 192x192 viewable map.
 	void create_minimap(Shape* minimaps, const unsigned char* chunk_pixels);
 	void cache_out_schunk(int schunk);
+	// Set up names of a superchunk's files.
+	std::unique_ptr<Schunk_files> new_schunk_files(int schunk);
+	// Find the shapes of the superchunks that aren't read in.
+	void index_schunk_shapes();
+	// Note the shapes of a superchunk's objects in memory.
+	void note_schunk_shapes(int schunk);
+	// Might a superchunk have a shape?  (True if it's read in.)
+	bool schunk_may_have(int schunk, int shnum) const;
+	// Read ahead where the avatar is heading.
+	void prefetch_schunks(int firstsx, int firstsy, int stopsx, int stopsy);
+	void get_visible_schunks(
+			int& firstsx, int& firstsy, int& stopsx, int& stopsy);
 
 public:
 	Game_map(int n);
@@ -90,8 +116,10 @@ public:
 	static void init_chunks();
 	void        init();    // Set up map.
 	static void clear_chunks();
-	void        clear();            // Clear out old map.
-	void        read_map_data();    // Read in 'ifix', 'ireg', etc.
+	void        clear();              // Clear out old map.
+	void        read_map_data();      // Read in 'ifix', 'ireg', etc.
+	void        prefetch_map_data();    // Start reading them ahead.
+	void        cancel_prefetch();      // Stop reading ahead.
 
 	static bool is_v2_chunks() {
 		return v2_chunks;
@@ -153,6 +181,23 @@ public:
 				= true;
 	}
 
+	// Write all "ireg" files that have been read on the next save.
+	void set_ireg_dirty() {
+		std::fill(
+				std::begin(schunk_ireg_dirty), std::end(schunk_ireg_dirty),
+				true);
+	}
+
+	// The moveable objects in a chunk changed, so its "ireg" needs writing.
+	void set_ireg_dirty(int cx, int cy) {
+		if (cx < c_num_chunks && cy < c_num_chunks) {
+			schunk_ireg_dirty
+					[12 * (cy / c_chunks_per_schunk)
+					 + cx / c_chunks_per_schunk]
+					= true;
+		}
+	}
+
 	// Get objs. list for a chunk.
 	Map_chunk* get_chunk_unsafe(int cx, int cy) {
 		return objects[cx][cy].get();
@@ -204,10 +249,7 @@ public:
 	// Write (static) map objects.
 	void write_ifix_objects(int schunk);
 	// Get "ifix" objects for a superchunk.
-	void get_ifix_objects(int schunk);
-	// Get "ifix" objs. for given chunk.
-	void get_ifix_chunk_objects(
-			IDataSource* ifix, int vers, long filepos, int len, int cx, int cy);
+	void get_ifix_objects(int schunk, Schunk_files* files = nullptr);
 	static void write_attributes(
 			ODataSource*                              ireg,
 			std::vector<std::pair<const char*, int>>& attlist);
@@ -221,7 +263,7 @@ public:
 	// Write moveable objects to datasource.
 	void write_ireg_objects(int schunk, ODataSource* ireg);
 	// Get moveable objects.
-	void get_ireg_objects(int schunk);
+	void get_ireg_objects(int schunk, Schunk_files* files = nullptr);
 	// Read scheduled script(s) for obj.
 	void read_special_ireg(IDataSource* ireg, Game_object* obj);
 	void read_ireg_objects(
@@ -242,6 +284,8 @@ public:
 	// Insert new terrain after 'tnum'.
 	static bool insert_terrain(int tnum, bool dup = false);
 	static bool delete_terrain(int tnum);
+	// Share terrains that are the same, or nearly.
+	static int merge_terrains(int tolerance = 0);
 	static void commit_terrain_edits();    // End terrain-editing mode.
 	static void abort_terrain_edits();
 	// Search entire game for unused.
@@ -30,13 +30,13 @@
 #include "databuf.h"
 #include "exult.h"
 #include "exult_constants.h"
-#include "files/utils.h"
+#include "utils.h"
 #include "flic/playfli.h"
 #include "fnames.h"
 #include "font.h"
 #include "gamewin.h"
 #include "gump_utils.h"
-#include "imagewin/ArbScaler.h"
+#include "ArbScaler.h"
 #include "imagewin/imagewin.h"
 #include "items.h"
 #include "mappatch.h"
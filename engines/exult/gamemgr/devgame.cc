@@ -25,8 +25,8 @@
 #include "Audio.h"
 #include "common_types.h"
 #include "databuf.h"
-#include "files/U7file.h"
-#include "files/utils.h"
+#include "U7file.h"
+#include "utils.h"
 #include "flic/playfli.h"
 #include "font.h"
 #include "gamewin.h"
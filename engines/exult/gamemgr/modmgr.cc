@@ -30,6 +30,7 @@
 #include "databuf.h"
 #include "exult_constants.h"
 #include "fnames.h"
+#include "gamemanifest.h"
 #include "listfiles.h"
 #include "utils.h"
 
@@ -497,9 +498,14 @@ ModManager::ModManager(
 		return;
 	}
 
-	const string mainshp     = static_dir + "/mainshp.flx";
-	const uint32 crc         = crc32(mainshp.c_str(), true);
-	auto         unknown_crc = [crc](const char* game) {
+	const string mainshp = static_dir + "/mainshp.flx";
+	// The launcher's manifest saves reading it all again.
+	const Game_manifest*       manifest = Game_manifest::from_environment();
+	const Game_manifest::File* known
+			= manifest != nullptr ? manifest->find(mainshp) : nullptr;
+	const uint32 crc
+			= known != nullptr ? known->crc : crc32(mainshp.c_str(), true);
+	auto unknown_crc = [crc](const char* game) {
         cerr << "Warning: Unknown CRC for mainshp.flx: 0x" << std::hex << crc
              << std::dec << std::endl;
         cerr << "Note: Guessing hacked " << game << std::endl;
@@ -28,7 +28,7 @@
 #include "data/exult_si_flx.h"
 #include "databuf.h"
 #include "exult.h"
-#include "files/utils.h"
+#include "utils.h"
 #include "flic/playfli.h"
 #include "font.h"
 #include "gamewin.h"
@@ -25,6 +25,7 @@
 
 #include "gamerend.h"
 
+#include "Frame_profiler.h"
 #include "Gump.h"
 #include "Gump_manager.h"
 #include "actors.h"
@@ -196,11 +197,12 @@ void Game_render::paint_terrain_only(
  *  Paint just the map and its objects (no gumps, effects).
  *  (The caller should set/clear clip area.)
  *
- *  Output: # light-sources found.
+ *  Output: # light-sources found, if count_lights; else 0.
  */
 
 int Game_render::paint_map(
-		int x, int y, int w, int h    // Rectangle to cover.
+		int x, int y, int w, int h,    // Rectangle to cover.
+		bool count_lights              // Only needed for full repaints.
 ) {
 	Game_window*   gwin = Game_window::get_instance();
 	Game_map*      map  = gwin->map;
@@ -208,9 +210,8 @@ int Game_render::paint_map(
 	render_seq++;    // Increment sequence #.
 	gwin->painted = true;
 
-	const int scrolltx      = gwin->scrolltx;
-	const int scrollty      = gwin->scrollty;
-	int       light_sources = 0;    // Count light sources found.
+	const int scrolltx = gwin->scrolltx;
+	const int scrollty = gwin->scrollty;
 	// Get chunks to start with, starting
 	//   1 tile left/above.
 	int start_chunkx = (scrolltx + x / c_tilesize - 1) / c_tiles_per_chunk;
@@ -281,7 +282,7 @@ int Game_render::paint_map(
 		for (int dx = start_chunkx, dy = cy;
 			 dx != stop_chunkx && dy != tmp_stopy;
 			 dx = INCR_CHUNK(dx), dy = DECR_CHUNK(dy)) {
-			light_sources += paint_chunk_objects(dx, dy);
+			paint_chunk_objects(dx, dy);
 		}
 	}
 	for (cx = (start_chunkx + 1) % c_num_chunks; cx != stop_chunkx;
@@ -289,7 +290,7 @@ int Game_render::paint_map(
 		for (int dx = cx, dy = (stop_chunky - 1 + c_num_chunks) % c_num_chunks;
 			 dx != stop_chunkx && dy != tmp_stopy;
 			 dx = INCR_CHUNK(dx), dy = DECR_CHUNK(dy)) {
-			light_sources += paint_chunk_objects(dx, dy);
+			paint_chunk_objects(dx, dy);
 		}
 	}
 	/// Dungeon Blackness (but disable in map editor mode)
@@ -321,6 +322,58 @@ int Game_render::paint_map(
 					stop_chunkx, stop_chunky);
 		}
 	}
+	if (!count_lights) {
+		return 0;
+	}
+	return count_light_sources(
+			start_chunkx, start_chunky, stop_chunkx, stop_chunky);
+}
+
+/*
+ *  Add up the light sources on the ground in a range of chunks.  Chunks
+ *  too far from the avatar for any of their lights to reach it are skipped,
+ *  so this costs the same however large the view is.
+ *
+ *  Output: Total strength of the light sources.
+ */
+
+int Game_render::count_light_sources(
+		int start_chunkx, int start_chunky, int stop_chunkx,
+		int stop_chunky) const {
+	Game_window*      gwin       = Game_window::get_instance();
+	Main_actor* const main_actor = gwin->get_main_actor();
+	if (main_actor == nullptr) {
+		return 0;
+	}
+	// Lights fade out at 38 tiles across or 25 down (see
+	//   Get_light_strength); allow a chunk more for large objects,
+	//   whose center can be in the chunk before.
+	constexpr const int reachx  = 38 + 3 * c_tiles_per_chunk / 2;
+	constexpr const int reachy  = 25 + 3 * c_tiles_per_chunk / 2;
+	const Tile_coord    av      = main_actor->get_center_tile();
+	const bool          dungeon = gwin->is_in_dungeon() != 0;
+	int                 light_sources = 0;
+	for (int cy = start_chunky; cy != stop_chunky; cy = INCR_CHUNK(cy)) {
+		const int centery = cy * c_tiles_per_chunk + c_tiles_per_chunk / 2;
+		if (std::abs(Tile_coord::delta(centery, av.ty)) >= reachy) {
+			continue;
+		}
+		for (int cx = start_chunkx; cx != stop_chunkx; cx = INCR_CHUNK(cx)) {
+			const int centerx = cx * c_tiles_per_chunk + c_tiles_per_chunk / 2;
+			if (std::abs(Tile_coord::delta(centerx, av.tx)) >= reachx) {
+				continue;
+			}
+			Map_chunk*  olist  = gwin->map->get_chunk(cx, cy);
+			const auto& lights = dungeon ? olist->get_dungeon_lights()
+										 : olist->get_non_dungeon_lights();
+			for (const auto& light_obj : lights) {
+				const Shape_info& info = light_obj->get_info();
+				if (info.get_object_light(light_obj->get_framenum()) > 0) {
+					light_sources += get_light_strength(light_obj, main_actor);
+				}
+			}
+		}
+	}
 	return light_sources;
 }
 
@@ -368,6 +421,7 @@ void Game_window::paint(
 	if (!win->ready()) {
 		return;
 	}
+	PROFILE_ZONE("Game_window::paint");
 	// This will adjust and clip the rectangle as appropriate, it may end up
 	// bigger or smaller
 	win->BeginPaintIntoGuardBand(&x, &y, &w, &h);
@@ -392,9 +446,13 @@ void Game_window::paint(
 	win->set_clip(gx, gy, gw, gh);    // Clip to this area.
 
 	int light_sources = 0;
+	// Lights are only counted for a complete repaint.
+	const bool complete
+			= !gx && !gy && gw == get_width() && gh == get_height();
 
 	if (main_actor) {
-		light_sources = render->paint_map(gx, gy, gw, gh);
+		PROFILE_ZONE("Game_render::paint_map");
+		light_sources = render->paint_map(gx, gy, gw, gh, complete);
 	} else {
 		win->fill8(0);
 	}
@@ -431,7 +489,7 @@ void Game_window::paint(
 	gump_man->paint(true);
 
 	// Complete repaint?
-	if (!gx && !gy && gw == get_width() && gh == get_height() && main_actor) {
+	if (complete && main_actor) {
 		// Look for lights.
 		Actor*    party[9];    // Get party, including Avatar.
 		const int cnt           = get_party(party, 1);
@@ -592,41 +650,22 @@ void Game_render::paint_chunk_flat_rles(
 
 /*
  *  Paint a chunk's objects, left-to-right, top-to-bottom.
- *
- *  Output: # light sources found.
  */
 
-int Game_render::paint_chunk_objects(
+void Game_render::paint_chunk_objects(
 		int cx, int cy    // Chunk coords (0 - 12*16).
 ) {
-	Game_object*      obj;
-	Game_window*      gwin          = Game_window::get_instance();
-	Map_chunk*        olist         = gwin->map->get_chunk(cx, cy);
-	int               light_sources = 0;    // Also check for light sources.
-	Main_actor* const main_actor    = gwin->get_main_actor();
-	if (main_actor != nullptr) {
-		const auto& lights = gwin->is_in_dungeon()
-									 ? olist->get_dungeon_lights()
-									 : olist->get_non_dungeon_lights();
-		for (const auto& light_obj : lights) {
-			const Shape_info& info = light_obj->get_info();
-			if (info.get_object_light(light_obj->get_framenum()) > 0) {
-				// Count light sources.
-				light_sources += get_light_strength(light_obj, main_actor);
-			}
-		}
-	}
-	skip = gwin->get_render_skip_lift();
-	Nonflat_object_iterator next(olist);
-
-	while ((obj = next.get_next()) != nullptr) {
+	Game_window* gwin  = Game_window::get_instance();
+	Map_chunk*   olist = gwin->map->get_chunk(cx, cy);
+	skip               = gwin->get_render_skip_lift();
+	// Those at the skipped lift and above are left out already.
+	for (auto* obj : olist->get_paint_objects(skip)) {
 		if (obj->render_seq != render_seq) {
 			paint_object(obj);
 		}
 	}
 
 	skip = 255;    // Back to a safe #.
-	return light_sources;
 }
 
 /*
@@ -666,7 +705,7 @@ void Game_render::paint_object(Game_object* obj) {
 }
 
 /*
- *  Paint 'dirty' rectangle.
+ *  Paint 'dirty' regions.
  */
 
 void Game_window::paint_dirty() {
@@ -678,9 +717,14 @@ void Game_window::paint_dirty() {
 
 	effects->update_dirty_text();
 
-	TileRect box = clip_to_win(dirty);
-	if (box.w > 0 && box.h > 0) {
-		paint(box);    // (Could create new dirty rects.)
+	// Painting could create new dirty rects, which are dropped.
+	std::vector<TileRect> regions;
+	regions.swap(dirty);
+	for (const auto& region : regions) {
+		TileRect box = clip_to_win(region);
+		if (box.w > 0 && box.h > 0) {
+			paint(box);
+		}
 	}
 	clear_dirty();
 }
@@ -37,8 +37,8 @@ public:
 	void paint_terrain_only(
 			int start_chunkx, int start_chunky, int stop_chunkx,
 			int stop_chunky);
-	// Render the map & objects.
-	int paint_map(int x, int y, int w, int h);
+	// Render the map & objects, and count lights if asked to.
+	int paint_map(int x, int y, int w, int h, bool count_lights = false);
 	// Paint "flat" scenery in a chunk.
 	void paint_chunk_flats(int cx, int cy, int xoff, int yoff);
 	void paint_chunk_flat_rles(int cx, int cy, int xoff, int yoff);
@@ -47,7 +47,11 @@ public:
 	// index=0);
 	// Paint objects in given chunk at
 	//   given lift.
-	int paint_chunk_objects(int cx, int cy);
+	void paint_chunk_objects(int cx, int cy);
+	// Add up light sources in chunks that can light the avatar.
+	int count_light_sources(
+			int start_chunkx, int start_chunky, int stop_chunkx,
+			int stop_chunky) const;
 	// Paint an obj. after dependencies.
 	void paint_object(Game_object* obj);
 	// Render dungeon blackness
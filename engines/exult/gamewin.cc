@@ -55,7 +55,7 @@
 #include "effects.h"
 #include "egg.h"
 #include "exult.h"
-#include "files/U7file.h"
+#include "U7file.h"
 #include "flic/playfli.h"
 #include "fnames.h"
 #include "game.h"
@@ -75,6 +75,7 @@
 #include "paths.h"
 #include "schedule.h"
 #include "spellbook.h"
+#include "startup_profile.h"
 #include "touchui.h"
 #include "ucmachine.h"
 #include "ucsched.h" /* Only used to flush objects. */
@@ -291,13 +292,15 @@ Game_window::Game_window(
 		  tqueue(new Time_queue()),
 		  background_noise(new Background_noise(this)), usecode(nullptr),
 		  combat(false), focus(true), ice_dungeon(false), painted(false),
-		  ambient_light(false), infravision_active(false), skip_above_actor(31),
+		  colours_rotated(false), ambient_light(false),
+		  infravision_active(false), skip_above_actor(31),
 		  in_dungeon(0), num_npcs1(0), std_delay(c_std_delay), time_stopped(0),
 		  special_light(0), theft_warnings(0), theft_cx(255), theft_cy(255),
 		  moving_barge(nullptr), main_actor(nullptr), camera_actor(nullptr),
-		  npcs(0), bodies(0), scrolltx(0), scrollty(0), dirty(0, 0, 0, 0),
+		  npcs(0), bodies(0), scrolltx(0), scrollty(0),
 		  save_names{}, mouse3rd(false), fastmouse(false),
 		  double_click_closes_gumps(false), text_bg(false), step_tile_delta(8),
+		  npc_coarse_minutes(5),
 		  allow_right_pathfind(2), scroll_with_mouse(false),
 		  alternate_drop(false), allow_autonotes(false),
 		  allow_enhancements(false), in_exult_menu(false),
@@ -361,6 +364,12 @@ Game_window::Game_window(
 	}
 	config->set("config/gameplay/step_tile_delta", step_tile_delta, false);
 
+	config->value(
+			"config/gameplay/npc_coarse_minutes", npc_coarse_minutes, 5);
+	set_npc_coarse_minutes(npc_coarse_minutes);
+	config->set(
+			"config/gameplay/npc_coarse_minutes", npc_coarse_minutes, false);
+
 	config->value("config/gameplay/allow_right_pathfind", str, "double");
 	if (str == "no") {
 		allow_right_pathfind = 0;
@@ -560,12 +569,16 @@ bool Game_window::is_background_track(
 }
 
 void Game_window::init_files(bool cycle) {
+	const Startup_phase phase("init_files");
 	// Display red plasma during load...
 	if (cycle) {
 		setup_load_palette();
 	}
 
-	usecode = Usecode_machine::create();
+	{
+		const Startup_phase usecode_phase("usecode");
+		usecode = Usecode_machine::create();
+	}
 	Game_singletons::init(this);    // Everything should exist here.
 
 	cycle_load_palette();
@@ -939,6 +952,7 @@ void Game_window::clear_world(bool restoremapedit) {
 	cheat.set_map_editor(false);
 	Combat::resume();
 	tqueue->clear();    // Remove all entries.
+	npc_prox->clear();
 	clear_dirty();
 	Usecode_script::clear();    // Clear out all scheduled usecode.
 	// Most NPCs were deleted when the map is cleared; we have to deal with some
@@ -1065,7 +1079,7 @@ bool Game_window::rotatecolours() {
 		}
 		// Non palettized needs explicit blit.
 		if (!win->is_palettized()) {
-			set_painted();
+			set_colours_rotated();
 		}
 		return true;
 	}
@@ -1424,6 +1438,9 @@ void Game_window::write(bool nopaint) {
  */
 
 void Game_window::read() {
+#ifdef DEBUG
+	const uint32 start = SDL_GetTicks();
+#endif
 	Audio::get_ptr()->cancel_streams();
 	// Display red plasma during load...
 	setup_load_palette();
@@ -1440,6 +1457,10 @@ void Game_window::read() {
 	// before calling read_npcs!!
 	setup_game(cheat.in_map_editor());    // Read NPC's, usecode.
 	Mouse::mouse()->set_speed_cursor();
+#ifdef DEBUG
+	cout << "Restoring the game took " << SDL_GetTicks() - start << " ms"
+		 << endl;
+#endif
 }
 
 /*
@@ -1609,6 +1630,64 @@ void Game_window::reload_usecode() {
 	}
 }
 
+/*
+ *  Add a rectangle to the dirty regions. It is merged with a region when
+ *  painting their union costs less than painting both.
+ */
+
+void Game_window::add_dirty(const TileRect& r) {
+	if (r.w <= 0 || r.h <= 0) {
+		return;
+	}
+	auto area = [](const TileRect& rect) {
+		return static_cast<long>(rect.w) * rect.h;
+	};
+	TileRect rect = r;
+	// A union can make further merges worthwhile, so start over after one.
+	bool merged;
+	do {
+		merged = false;
+		for (auto it = dirty.begin(); it != dirty.end(); ++it) {
+			const TileRect both = it->add(rect);
+			if (area(both) <= area(*it) + area(rect) + dirty_rect_cost) {
+				rect = both;
+				dirty.erase(it);
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+	if (dirty.size() >= max_dirty_rects) {
+		// Too many; merge with the region that grows the least.
+		auto best      = dirty.begin();
+		long best_cost = 0;
+		for (auto it = dirty.begin(); it != dirty.end(); ++it) {
+			const long cost = area(it->add(rect)) - area(*it) - area(rect);
+			if (it == dirty.begin() || cost < best_cost) {
+				best      = it;
+				best_cost = cost;
+			}
+		}
+		rect = best->add(rect);
+		dirty.erase(best);
+		add_dirty(rect);
+		return;
+	}
+	dirty.push_back(rect);
+}
+
+void Game_window::shift_dirty(int dx, int dy) {
+	std::vector<TileRect> shifted;
+	shifted.swap(dirty);
+	for (auto& rect : shifted) {
+		rect.shift(dx, dy);
+		rect = clip_to_win(rect);
+		if (rect.w > 0 && rect.h > 0) {
+			dirty.push_back(rect);
+		}
+	}
+}
+
 /*
  *  Shift view by one tile.
  */
@@ -1630,8 +1709,7 @@ void Game_window::view_right() {
 	win->copy(c_tilesize, 0, w - c_tilesize, h, 0, 0);
 	// Paint 1 column to right.
 	paint(w - c_tilesize, 0, c_tilesize, h);
-	dirty.x -= c_tilesize;    // Shift dirty rect.
-	dirty = clip_to_win(dirty);
+	shift_dirty(-c_tilesize, 0);
 	// New chunk?
 	const int new_rcx = ((scrolltx + (w - 1) / c_tilesize) / c_tiles_per_chunk)
 						% c_num_chunks;
@@ -1653,8 +1731,7 @@ void Game_window::view_left() {
 	win->copy(0, 0, get_width() - c_tilesize, get_height(), c_tilesize, 0);
 	const int h = get_height();
 	paint(0, 0, c_tilesize, h);
-	dirty.x += c_tilesize;    // Shift dirty rect.
-	dirty = clip_to_win(dirty);
+	shift_dirty(c_tilesize, 0);
 	// New chunk?
 	const int new_lcx = (scrolltx / c_tiles_per_chunk) % c_num_chunks;
 	if (new_lcx != old_lcx) {
@@ -1677,8 +1754,7 @@ void Game_window::view_down() {
 	map->read_map_data();    // Be sure objects are present.
 	win->copy(0, c_tilesize, w, h - c_tilesize, 0, 0);
 	paint(0, h - c_tilesize, w, c_tilesize);
-	dirty.y -= c_tilesize;    // Shift dirty rect.
-	dirty = clip_to_win(dirty);
+	shift_dirty(0, -c_tilesize);
 	// New chunk?
 	const int new_bcy = ((scrollty + (h - 1) / c_tilesize) / c_tiles_per_chunk)
 						% c_num_chunks;
@@ -1700,8 +1776,7 @@ void Game_window::view_up() {
 	const int w = get_width();
 	win->copy(0, 0, w, get_height() - c_tilesize, 0, c_tilesize);
 	paint(0, 0, w, c_tilesize);
-	dirty.y += c_tilesize;    // Shift dirty rect.
-	dirty = clip_to_win(dirty);
+	shift_dirty(0, c_tilesize);
 	// New chunk?
 	const int new_tcy = (scrollty / c_tiles_per_chunk) % c_num_chunks;
 	if (new_tcy != old_tcy) {
@@ -2889,24 +2964,33 @@ void Game_window::lose_focus() {
  */
 
 void Game_window::setup_game(bool map_editing) {
-	// Map 0 always exists.
-	get_map(0)->init();
-	if (is_system_path_defined("<PATCH>")) {
-		// There is a patch dir; search for other maps.
-		for (int i = 1; i <= 0xFF; i++) {
-			char fname[128];
-			if (U7exists(Get_mapped_name(PATCH_U7MAP, i, fname))) {
-				get_map(i)->init();
+	const Startup_phase phase("setup_game");
+	{
+		const Startup_phase map_phase("map");
+		// Map 0 always exists.
+		get_map(0)->init();
+		if (is_system_path_defined("<PATCH>")) {
+			// There is a patch dir; search for other maps.
+			for (int i = 1; i <= 0xFF; i++) {
+				char fname[128];
+				if (U7exists(Get_mapped_name(PATCH_U7MAP, i, fname))) {
+					get_map(i)->init();
+				}
 			}
 		}
+		// Read the visible superchunks while the actors are set up.
+		map->prefetch_map_data();
 	}
 	// Init. current 'tick'.
 	Game::set_ticks(SDL_GetTicks());
 	Face_stats::RemoveGump();    // it tries to update when reading actors so
 								 // delete it until finished loading
-	init_actors();               // Set up actors if not already done.
-	// This also sets up initial
-	// schedules and positions.
+	{
+		const Startup_phase actors_phase("actors");
+		init_actors();    // Set up actors if not already done.
+		// This also sets up initial
+		// schedules and positions.
+	}
 
 	cycle_load_palette();
 
@@ -2930,7 +3014,10 @@ void Game_window::setup_game(bool map_editing) {
 		}
 	}
 
-	usecode->read();    // Read the usecode flags
+	{
+		const Startup_phase usecode_phase("usecode flags");
+		usecode->read();    // Read the usecode flags
+	}
 	cycle_load_palette();
 
 	if (GAME_BG && !map_editing) {
@@ -33,6 +33,7 @@
 #include <array>
 #include <memory>
 #include <string>    // STL string
+#include <unordered_set>
 #include <vector>
 
 #ifndef ATTR_PRINTF
@@ -112,6 +113,7 @@ class Game_window {
 	bool focus;                 // Do we have focus?
 	bool ice_dungeon;           // true if inside ice dungeon
 	bool painted;               // true if we updated image buffer.
+	bool colours_rotated;       // true if cycling colours need a blit.
 	bool ambient_light;         // Permanent version of special_light.
 	bool infravision_active;    // Infravision flag.
 	// Game state values:
@@ -132,15 +134,22 @@ class Game_window {
 	// Rendering info:
 	int      scrolltx, scrollty;    // Top-left tile of screen.
 	TileRect scroll_bounds;         // Walking outside this scrolls.
-	TileRect dirty;                 // Dirty rectangle.
+	// Dirty regions, at most max_dirty_rects of them.
+	std::vector<TileRect> dirty;
 	// Savegames:
 	std::array<std::string, 10> save_names;    // Names of saved games.
+	// Zipped savegame the "ireg" files in gamedat were last saved to or
+	// restored from.  Those not written since are copied from it as they
+	// are, without compressing them again.
+	std::string                     ireg_save;
+	std::unordered_set<std::string> iregs_written;
 	// Options:
 	bool mouse3rd;    // use third (middle) mouse button
 	bool fastmouse;
 	bool double_click_closes_gumps;
 	int  text_bg;                 // draw a dark background behind text
 	int  step_tile_delta;         // multiplier for the delta in start_actor_alt
+	int  npc_coarse_minutes;      // schedule tick for far-off NPCs (0 = off)
 	int  allow_right_pathfind;    // If moving with right click is allowed
 	bool scroll_with_mouse;       // scroll game view with mousewheel
 	bool alternate_drop;    // don't split stacks, can be inverted with a CTRL
@@ -615,22 +624,34 @@ public:
 		return painted;
 	}
 
+	// Only the palette cycling colours changed.
+	inline void set_colours_rotated() {
+		colours_rotated = true;
+	}
+
 	bool show(bool force = false) {    // Returns true if blit occurred.
 		if (painted || force) {
 			win->show();
 			++blits;
-			painted = false;
+			painted         = false;
+			colours_rotated = false;
 			return true;
 		}
+		if (colours_rotated) {
+			// Just the parts showing them.  Still false, so the
+			//   mouse gets blitted too.
+			win->show_colors(0xe0, 0xff);
+			colours_rotated = false;
+		}
 		return false;
 	}
 
-	void clear_dirty() {    // Clear dirty rectangle.
-		dirty.w = 0;
+	void clear_dirty() {    // Clear dirty regions.
+		dirty.clear();
 	}
 
 	bool is_dirty() const {
-		return dirty.w > 0;
+		return !dirty.empty();
 	}
 
 	// Paint scene at given tile.
@@ -645,18 +666,25 @@ public:
 	}
 
 	void paint();    // Paint whole image.
-	// Paint 'dirty' rectangle.
+	// Paint 'dirty' regions.
 	void paint_dirty();
 
 	void set_all_dirty() {    // Whole window.
-		dirty = TileRect(
-				win->get_start_x(), win->get_start_y(), win->get_full_width(),
-				win->get_full_height());
+		dirty.assign(
+				1, TileRect(
+						   win->get_start_x(), win->get_start_y(),
+						   win->get_full_width(), win->get_full_height()));
 	}
 
-	void add_dirty(const TileRect& r) {    // Add rectangle to dirty area.
-		dirty = dirty.w > 0 ? dirty.add(r) : r;
-	}
+	// Most dirty regions kept before they are merged regardless of cost.
+	static constexpr size_t max_dirty_rects = 8;
+	// Cost of painting one more region, in pixels.
+	static constexpr int dirty_rect_cost = 64 * 64;
+
+	// Add rectangle to dirty area.
+	void add_dirty(const TileRect& r);
+	// Move dirty regions along with a scrolled image.
+	void shift_dirty(int dx, int dy);
 
 	// Add dirty rect. for obj. Rets. false
 	//   if not on screen.
@@ -753,6 +781,11 @@ public:
 		return save_names[i];
 	}
 
+	// An "ireg" file in gamedat was rewritten.
+	void set_ireg_written(const char* fname) {
+		iregs_written.insert(fname);
+	}
+
 	void setup_game(bool map_editing);    // Prepare for game
 	void read_npcs();                     // Read in npc's.
 	void write_npcs();                    // Write them back.
@@ -763,8 +796,10 @@ public:
 	void restore_gamedat(const char* fname);
 	void restore_gamedat(int num);
 	// Save "gamedat".
-	void save_gamedat(const char* fname, const char* savename);
-	void save_gamedat(int num, const char* savename);
+	// quick trades compression for speed, for saves made on the fly.
+	void save_gamedat(
+			const char* fname, const char* savename, bool quick = false);
+	void save_gamedat(int num, const char* savename, bool quick = false);
 	bool init_gamedat(bool create);    // Initialize gamedat directory
 
 	// Emergency save Creates a new save in the next available index
@@ -775,7 +810,7 @@ public:
 
 #ifdef HAVE_ZIP_SUPPORT
 private:
-	bool save_gamedat_zip(const char* fname, const char* savename);
+	bool save_gamedat_zip(const char* fname, const char* savename, bool quick);
 	bool Restore_level2(unzFile& unzipfile, const char* dirname, int dirlen);
 	bool restore_gamedat_zip(const char* fname);
 
@@ -802,6 +837,15 @@ public:
 		return step_tile_delta;
 	}
 
+	// Game minutes between schedule ticks of NPCs far off the screen.
+	inline void set_npc_coarse_minutes(int m) {
+		npc_coarse_minutes = m > 0 ? m : 0;
+	}
+
+	inline int get_npc_coarse_minutes() const {
+		return npc_coarse_minutes;
+	}
+
 	inline void set_allow_right_pathfind(int a) {
 		allow_right_pathfind = a;
 	}
@@ -30,6 +30,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "game.h"
 #include "gamewin.h"
 #include "gumpinf.h"
+#include "iwin8.h"
 #include "misc_buttons.h"
 #include "objiter.h"
 #include "utils.h"
@@ -369,33 +370,16 @@ void check_elem_positions(Object_list& objects) {
 }
 
 /*
- *  Paint on screen.
+ *  Give a place in the object area to objects not already in it.
  */
 
-void Gump::paint() {
-	// Paint the gump itself.
-	if (get_shape()) {
-		paint_shape(x, y);
-	}
-	gwin->set_painted();
-
-	// Paint red "checkmark".
-	paint_elems();
-
-	if (!container) {
-		return;    // Empty.
-	}
+void Gump::place_objects() {
 	Object_list& objects = container->get_objects();
-	if (objects.is_empty()) {
-		return;    // Empty.
-	}
-	TileRect box = object_area;    // Paint objects inside.
-	box.shift(x, y);               // Set box to screen location.
-	int       cury = 0;
-	int       curx = 0;
-	const int endy = box.h;
-	const int endx = box.w;
-	int       loop = 0;               // # of times covering container.
+	int          cury    = 0;
+	int          curx    = 0;
+	const int    endy    = object_area.h;
+	const int    endx    = object_area.w;
+	int          loop    = 0;     // # of times covering container.
 	check_elem_positions(objects);    // Set to place if new game.
 	Game_object*    obj;
 	Object_iterator next(objects);
@@ -433,8 +417,98 @@ void Gump::paint() {
 				}
 			}
 		}
-		obj->paint_shape(box.x + obj->get_tx(), box.y + obj->get_ty());
 	}
+}
+
+/*
+ *  Paint the objects, from 'contents' if none have changed since they
+ *  were last painted there.
+ */
+
+void Gump::paint_objects() {
+	std::vector<Painted_object> now;
+	bool                        translucent = false;
+	Game_object*                obj;
+	Object_iterator             next(container->get_objects());
+	while ((obj = next.get_next()) != nullptr) {
+		Shape_frame* shape = obj->get_shape();
+		if (shape) {
+			now.push_back(
+					{obj, shape, obj->get_tx(), obj->get_ty(),
+					 obj->get_palette_transform()});
+			translucent = translucent || obj->is_translucent();
+		}
+	}
+	const int objx = x + object_area.x;
+	const int objy = y + object_area.y;
+	// Translucent shapes blend with what's under them, so can't be kept.
+	if (translucent) {
+		painted.clear();
+		contents.reset();
+		for (const auto& each : now) {
+			each.obj->paint_shape(objx + each.tx, objy + each.ty);
+		}
+		return;
+	}
+	if (!contents || now != painted) {
+		TileRect area(0, 0, 0, 0);
+		for (const auto& each : now) {
+			const TileRect rect(
+					object_area.x + each.tx - each.shape->get_xleft(),
+					object_area.y + each.ty - each.shape->get_yabove(),
+					each.shape->get_width(), each.shape->get_height());
+			area = area.w > 0 ? area.add(rect) : rect;
+		}
+		if (area.w <= 0 || area.h <= 0) {
+			painted.swap(now);
+			contents.reset();
+			return;
+		}
+		if (!contents || contents_area.w != area.w
+			|| contents_area.h != area.h) {
+			contents = std::make_unique<Image_buffer8>(area.w, area.h);
+		}
+		contents_area = area;
+		contents->fill8(255);    // Fill with 'transparent' pixel.
+		Shape_frame::set_to_render(contents.get());
+		for (const auto& each : now) {
+			each.obj->paint_shape(
+					object_area.x + each.tx - area.x,
+					object_area.y + each.ty - area.y);
+		}
+		Shape_frame::set_to_render(gwin->get_win()->get_ib8());
+		painted.swap(now);
+	}
+	gwin->get_win()->get_ib8()->copy_transparent8(
+			contents->get_bits(), contents_area.w, contents_area.h,
+			x + contents_area.x, y + contents_area.y, 255);
+}
+
+/*
+ *  Paint on screen.
+ */
+
+void Gump::paint() {
+	// Paint the gump itself.
+	if (get_shape()) {
+		paint_shape(x, y);
+	}
+	gwin->set_painted();
+
+	// Paint red "checkmark".
+	paint_elems();
+
+	if (!container) {
+		return;    // Empty.
+	}
+	Object_list& objects = container->get_objects();
+	if (objects.is_empty()) {
+		painted.clear();
+		contents.reset();
+		return;    // Empty.
+	}
+	place_objects();
+	paint_objects();
 	// Outline selections in this gump.
 	const Game_object_shared_vector& sel = cheat.get_selected();
 	for (const auto& it : sel) {
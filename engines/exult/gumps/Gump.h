@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #	pragma GCC diagnostic pop
 #endif    // __GNUC__
 
+#include <memory>
 #include <vector>
 
 class Checkmark_button;
@@ -46,6 +47,7 @@ class Game_window;
 class Gump_button;
 class Gump_manager;
 class Gump_widget;
+class Image_buffer8;
 
 // Base Class shared by Gumps and Widgetss
 class Gump_Base : public ShapeID, public Paintable {
@@ -148,6 +150,28 @@ protected:
 		elems.push_back(w);
 	}
 
+private:
+	// The objects as last painted into 'contents', which is pasted in
+	// their place until one of them changes.
+	struct Painted_object {
+		const Game_object* obj;
+		const Shape_frame* shape;
+		int                tx, ty;
+		int                palette_transform;
+
+		bool operator==(const Painted_object& other) const {
+			return obj == other.obj && shape == other.shape && tx == other.tx
+				   && ty == other.ty
+				   && palette_transform == other.palette_transform;
+		}
+	};
+
+	std::vector<Painted_object>    painted;
+	std::unique_ptr<Image_buffer8> contents;
+	TileRect                       contents_area{};    // Rel. to gump.
+	void                           place_objects();
+	void                           paint_objects();
+
 public:
 	friend class Gump_model;
 	Gump(Container_game_object* cont, int initx, int inity, int shnum,
@@ -329,6 +329,7 @@ void VideoOptions_gump::rebuild_dynamic_buttons() {
 	const int num_scales = (scaler == Image_window::point
 							|| scaler == Image_window::interlaced
 							|| scaler == Image_window::bilinear
+							|| scaler == Image_window::GPUScaler
 							|| scaler == Image_window::SDLScaler)
 								   ? max_scales
 								   : 1;
@@ -41,8 +41,8 @@
 #define DELAY_TOTAL_MS  10
 #define DELAY_SINGLE_MS 1
 
-inline void Delay() {
-	const Uint32 expiration = DELAY_TOTAL_MS + SDL_GetTicks();
+inline void Delay(Uint32 total_ms = DELAY_TOTAL_MS) {
+	const Uint32 expiration = total_ms + SDL_GetTicks();
 	for (;;) {
 		SDL_PumpEvents();
 		if ((SDL_PeepEvents(
@@ -29,6 +29,7 @@
 #include "endianio.h"
 #include "ignore_unused_variable_warning.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -527,6 +528,38 @@ void Image_buffer8::copy_transparent8(
 	}
 }
 
+/*
+ *  Copy another rectangle into this one, skipping pixels of the given
+ *  transparent color.
+ */
+
+void Image_buffer8::copy_transparent8(
+		const unsigned char* src_pixels,    // Source rectangle pixels.
+		int srcw, int srch,                 // Dimensions of source.
+		int destx, int desty, unsigned char transparent) {
+	int       srcx      = 0;
+	int       srcy      = 0;
+	const int src_width = srcw;    // Save full source width.
+	// Constrain to window's space.
+	if (!clip(srcx, srcy, srcw, srch, destx, desty)) {
+		return;
+	}
+	unsigned char*       to   = bits + desty * line_width + destx;
+	const unsigned char* from = src_pixels + srcy * src_width + srcx;
+	const int to_next         = line_width - srcw;    // # pixels to next line.
+	const int from_next       = src_width - srcw;
+	while (srch--) {    // Do each line.
+		for (int cnt = srcw; cnt; cnt--, to++) {
+			const unsigned char chr = Read1(from);
+			if (chr != transparent) {
+				*to = chr;
+			}
+		}
+		to += to_next;
+		from += from_next;
+	}
+}
+
 // Slightly Optimized RLE Painter
 void Image_buffer8::paint_rle(int xoff, int yoff, const unsigned char* inptr) {
 	const uint8* in = inptr;
@@ -684,6 +717,56 @@ void Image_buffer8::paint_rle(int xoff, int yoff, const unsigned char* inptr) {
 	}
 }
 
+/*
+ *  Paint the spans of a decoded RLE shape, remapping the colours if trans
+ *  is given.
+ */
+
+void Image_buffer8::paint_spans(
+		int xoff, int yoff, const Rle_span* spans, size_t count,
+		const unsigned char* pixels, const unsigned char* trans) {
+	const int right  = clipx + clipw;
+	const int bottom = clipy + cliph;
+
+	// Skip the lines above the clipping rectangle.
+	const Rle_span* const end  = spans + count;
+	const Rle_span*       span = std::lower_bound(
+			  spans, end, clipy - yoff, [](const Rle_span& s, int y) {
+				  return s.y < y;
+			  });
+	for (; span != end; ++span) {
+		const int scany = yoff + span->y;
+		if (scany >= bottom) {
+			break;
+		}
+		int scanx = xoff + span->x;
+		int len   = span->len;
+		int skip  = 0;
+		if (scanx < clipx) {
+			skip = clipx - scanx;
+			len -= skip;
+			scanx = clipx;
+		}
+		if (scanx + len > right) {
+			len = right - scanx;
+		}
+		if (len <= 0) {
+			continue;
+		}
+		unsigned char* dest = bits + scany * line_width + scanx;
+		if (span->fill) {
+			std::memset(dest, trans ? trans[span->first] : span->first, len);
+		} else if (trans) {
+			const unsigned char* src = pixels + span->first + skip;
+			for (int i = 0; i < len; i++) {
+				dest[i] = trans[src[i]];
+			}
+		} else {
+			std::memcpy(dest, pixels + span->first + skip, len);
+		}
+	}
+}
+
 // Slightly Optimized RLE Painter
 void Image_buffer8::paint_rle_remapped(
 		int xoff, int yoff, const unsigned char* inptr,
@@ -96,6 +96,10 @@ public:
 	void copy_transparent8(
 			const unsigned char* src_pixels, int srcw, int srch, int destx,
 			int desty) override;
+	// Copy rect. with a given transp. color.
+	void copy_transparent8(
+			const unsigned char* src_pixels, int srcw, int srch, int destx,
+			int desty, unsigned char transparent);
 
 	// Get/put a single pixel.
 	unsigned char get_pixel8(int x, int y) override {
@@ -114,6 +118,20 @@ public:
 			int xoff, int yoff, const unsigned char* inptr,
 			const unsigned char*& trans);
 
+	// A run of opaque pixels of a decoded RLE shape.
+	struct Rle_span {
+		short          x;        // Start, relative to the shape's origin.
+		short          y;
+		unsigned short len;      // # pixels.
+		bool           fill;     // All pixels are the colour 'first'.
+		unsigned int   first;    // Else index of the first pixel.
+	};
+
+	// Paint decoded RLE spans, which must be sorted by y.
+	void paint_spans(
+			int xoff, int yoff, const Rle_span* spans, size_t count,
+			const unsigned char* pixels, const unsigned char* trans = nullptr);
+
 	void draw_beveled_box(
 			int x, int y, int w, int h, int depth, uint8 colfill, uint8 coltop,
 			uint8 coltr, uint8 colbottom, uint8 colbl,
@@ -39,6 +39,7 @@ Boston, MA  02111-1307, USA.
 #include "manip.h"
 #include "mouse.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -87,6 +88,7 @@ const Image_window::ScalerConst Image_window::Hq4x("Hq4x");
 const Image_window::ScalerConst Image_window::_2xBR("2xBR");
 const Image_window::ScalerConst Image_window::_3xBR("3xBR");
 const Image_window::ScalerConst Image_window::_4xBR("4xBR");
+const Image_window::ScalerConst Image_window::GPUScaler("GPU");
 const Image_window::ScalerConst Image_window::SDLScaler("SDLScaler");
 const Image_window::ScalerConst Image_window::NumScalers(nullptr);
 
@@ -281,6 +283,12 @@ Image_window::ScalerVector::ScalerVector() {
 			   nullptr};
 	push_back(_4xbr);
 #endif
+	// Only converts the palette; the renderer does the scaling and filling.
+	const ScalerInfo GPU
+			= {"GPU",   0,       0xFFFFFFFF, nullptr, nullptr,
+			   nullptr, nullptr, nullptr,    nullptr};
+	push_back(GPU);
+
 	const ScalerInfo SDLScaler
 			= {"SDLScaler", 0,       0xFFFFFFFF, nullptr, nullptr,
 			   nullptr,     nullptr, nullptr,    nullptr};
@@ -803,13 +811,24 @@ bool Image_window::create_scale_surfaces(int w, int h, int bpp) {
 		screen_texture = SDL_CreateTexture(
 				screen_renderer, desktop_displaymode.format,
 				SDL_TEXTUREACCESS_STREAMING,
-				(fill_scaler == SDLScaler ? inter_width : w),
-				(fill_scaler == SDLScaler ? inter_height : h));
+				(scaler == GPUScaler       ? inter_width / scale
+				 : fill_scaler == SDLScaler ? inter_width
+											: w),
+				(scaler == GPUScaler       ? inter_height / scale
+				 : fill_scaler == SDLScaler ? inter_height
+											: h));
 	}
 	if (screen_texture == nullptr) {
 		cout << "Couldn't create texture: " << SDL_GetError() << std::endl;
 	}
 	SDL_SetTextureBlendMode(screen_texture, SDL_BLENDMODE_NONE);
+	if (scaler == GPUScaler) {
+		// The texture is stretched to the window in one step, so the fill
+		// scaler picks the filter
+		SDL_SetTextureScaleMode(
+				screen_texture, fill_scaler == point ? SDL_SCALEMODE_NEAREST
+													 : SDL_SCALEMODE_LINEAR);
+	}
 	if (!display_surface) {
 		cerr << "Unable to set video mode to" << w << "x" << h << " " << hwdepth
 			 << " bpp" << endl;
@@ -832,8 +851,25 @@ bool Image_window::create_scale_surfaces(int w, int h, int bpp) {
 		return false;
 	}
 
+	// Convert to the display format unscaled, for the GPU to scale
+	if (scaler == GPUScaler) {
+		const SDL_PixelFormatDetails* display_surface_format
+				= SDL_GetPixelFormatDetails(display_surface->format);
+		if (!(inter_surface = SDL_CreateSurface(
+					  draw_width, draw_height,
+					  SDL_GetPixelFormatForMasks(
+							  hwdepth, display_surface_format->Rmask,
+							  display_surface_format->Gmask,
+							  display_surface_format->Bmask,
+							  display_surface_format->Amask)))) {
+			cerr << "Couldn't create inter surface: " << SDL_GetError() << endl;
+			free_surface();
+			return false;
+		}
+	}
 	// Scale using 'fill_scaler' only
-	if (fill_scaler != SDLScaler && (scaler == fill_scaler || scale == 1)) {
+	else if (
+			fill_scaler != SDLScaler && (scaler == fill_scaler || scale == 1)) {
 		inter_surface = draw_surface;
 	} else if (inter_width != w || inter_height != h) {
 		const SDL_PixelFormatDetails* display_surface_format
@@ -873,7 +909,9 @@ bool Image_window::create_scale_surfaces(int w, int h, int bpp) {
 bool Image_window::try_scaler(int w, int h) {
 	const ScalerInfo* info;
 
-	if (scaler < 0 || scaler >= NumScalers || scale == 1) {
+	// The GPU scaler uses the point scaler to convert the palette
+	if (scaler < 0 || scaler >= NumScalers || scale == 1
+		|| scaler == GPUScaler) {
 		info = &Scalers[point];
 	} else {
 		info = &Scalers[scaler];
@@ -994,6 +1032,17 @@ void Image_window::show(int x, int y, int w, int h) {
 	if (!ready()) {
 		return;
 	}
+	if (scale_area(x, y, w, h)) {
+		present();
+	}
+}
+
+/*
+ *   Scale a portion of the draw surface, without showing it yet.
+ *   Output: False if it's not visible.
+ */
+
+bool Image_window::scale_area(int x, int y, int w, int h) {
 	// call EndPaintIntoGuardBand just in case. It is safe to call it when not
 	// needed
 	EndPaintIntoGuardBand();
@@ -1001,7 +1050,7 @@ void Image_window::show(int x, int y, int w, int h) {
 	int srcx = 0;
 	int srcy = 0;
 	if (!ibuf->clip(srcx, srcy, w, h, x, y)) {
-		return;
+		return false;
 	}
 	x -= get_start_x();
 	y -= get_start_y();
@@ -1045,7 +1094,12 @@ void Image_window::show(int x, int y, int w, int h) {
 	}
 
 	// Phase 1 blit from draw_surface to inter_surface
-	if (draw_surface != inter_surface) {
+	if (scaler == GPUScaler) {
+		// Palette conversion only
+		Scalers[point].arb->Scale(
+				draw_surface, x + guard_band, y + guard_band, w, h,
+				inter_surface, x + guard_band, y + guard_band, w, h, false);
+	} else if (draw_surface != inter_surface) {
 		const ScalerInfo& sel_scaler = Scalers[scaler];
 
 		const SDL_PixelFormatDetails* inter_surface_format
@@ -1106,16 +1160,23 @@ void Image_window::show(int x, int y, int w, int h) {
 									+ inter_surface_format->bytes_per_pixel
 											  * guard_band * scale;
 		}
-
-		x *= scale;
-		y *= scale;
-		w *= scale;
-		h *= scale;
 	}
+	return true;
+}
+
+/*
+ *   Finish the scaled frame and show it.
+ */
 
+void Image_window::present() {
 	// Phase 2 blit from inter_surface to display_surface
-	if (inter_surface != display_surface && fill_scaler != SDLScaler) {
+	if (inter_surface != display_surface && fill_scaler != SDLScaler
+		&& scaler != GPUScaler) {
 		const ScalerInfo& sel_scaler = Scalers[fill_scaler];
+		int               x;
+		int               y;
+		int               w;
+		int               h;
 
 		// Just scale entire surfaces
 		if (inter_surface == draw_surface) {
@@ -1138,15 +1199,29 @@ void Image_window::show(int x, int y, int w, int h) {
 					inter_surface, x, y, w, h, display_surface, 0, 0,
 					display_surface->w, display_surface->h, false);
 		}
-
-		x = 0;
-		y = 0;
-		w = display_surface->w;
-		h = display_surface->h;
 	}
 	// Phase 3 blit high res draw surface on top of display_surface
 	// Phase 4 notify SDL
-	UpdateRect(fill_scaler == SDLScaler ? inter_surface : display_surface);
+	UpdateRect(
+			fill_scaler == SDLScaler || scaler == GPUScaler ? inter_surface
+															: display_surface);
+}
+
+/*
+ *   Get the time between refreshes of the window's display, rounded down
+ *   so that no refresh is missed.  Assumes 60Hz if it's not known.
+ */
+
+int Image_window::get_refresh_ms() {
+	const SDL_DisplayMode* mode = nullptr;
+	if (screen_window) {
+		mode = SDL_GetCurrentDisplayMode(
+				SDL_GetDisplayForWindow(screen_window));
+	}
+	if (mode == nullptr || mode->refresh_rate <= 0) {
+		return 1000 / 60;
+	}
+	return std::max(1, static_cast<int>(1000 / mode->refresh_rate));
 }
 
 /*
@@ -1597,13 +1672,15 @@ void Image_window::UpdateRect(SDL_Surface* surf) {
 	// what I try. -Lanica 08/28/2013
 	const SDL_PixelFormatDetails* surf_format
 			= SDL_GetPixelFormatDetails(surf->format);
-	uint8* pixels
+	// The GPU scaler's surface is not scaled
+	const int surf_scale = scaler == GPUScaler ? 1 : scale;
+	uint8*    pixels
 			= (surf == display_surface
 					   ? static_cast<uint8*>(surf->pixels)
 					   : static_cast<uint8*>(surf->pixels)
-								 + guard_band * scale
+								 + guard_band * surf_scale
 										   * surf_format->bytes_per_pixel
-								 + guard_band * scale * surf->pitch);
+								 + guard_band * surf_scale * surf->pitch);
 	SDL_UpdateTexture(screen_texture, nullptr, pixels, surf->pitch);
 	SDL_RenderTexture(screen_renderer, screen_texture, nullptr, nullptr);
 	SDL_RenderPresent(screen_renderer);
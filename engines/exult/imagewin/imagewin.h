@@ -163,6 +163,7 @@ public:
 	static const ScalerConst _2xBR;
 	static const ScalerConst _3xBR;
 	static const ScalerConst _4xBR;
+	static const ScalerConst GPUScaler;
 	static const ScalerConst SDLScaler;
 	static const ScalerConst NumScalers;
 
@@ -210,6 +211,9 @@ protected:
 	struct SDL_Renderer*   screen_renderer;
 	struct SDL_Texture*    screen_texture;
 	void                   UpdateRect(SDL_Surface* surf);
+	// show() in two steps, so several areas can be shown at once.
+	bool scale_area(int x, int y, int w, int h);
+	void present();
 
 	SDL_Surface* paletted_surface;    // Surface that palette is set on (Example
 									  // res)
@@ -445,6 +449,9 @@ public:
 		return fullscreen;
 	}
 
+	// Milliseconds between refreshes of the display we're on.
+	int get_refresh_ms();
+
 	// Create a compatible image buffer.
 	std::unique_ptr<Image_buffer> create_buffer(int w, int h);
 	// Resize event occurred.
@@ -460,6 +467,11 @@ public:
 
 	// Repaint rectangle.
 	void show(int x, int y, int w, int h);
+	// Repaint the parts that use palette colours first to last.
+	virtual void show_colors(int first, int last) {
+		ignore_unused_variable_warning(first, last);
+		show();
+	}
 
 	void toggle_fullscreen();
 
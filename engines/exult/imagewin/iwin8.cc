@@ -169,6 +169,55 @@ void Image_window8::rotate_colors(
 	}
 }
 
+/*
+ *  Repaint only the parts of the window that use colors first to last,
+ *  scanning the buffer in bands of rows.  Nothing is shown if none of
+ *  those colors is on screen.
+ */
+
+void Image_window8::show_colors(int first, int last) {
+	if (!ready()) {
+		return;
+	}
+	constexpr const int band   = 16;
+	const unsigned      range  = last - first;
+	const int           w      = get_full_width();
+	const int           h      = get_full_height();
+	const int           startx = get_start_x();
+	const int           starty = get_start_y();
+	const int           pitch  = ib8->get_line_width();
+	bool                shown  = false;
+	for (int y = 0; y < h; y += band) {
+		const int      bh   = std::min(band, h - y);
+		int            minx = w;
+		int            maxx = -1;
+		unsigned char* line = ib8->get_bits() + y * pitch;
+		for (int row = 0; row < bh; row++, line += pitch) {
+			// Only look outside of what was already found.
+			int x = 0;
+			while (x < minx && static_cast<unsigned>(line[x] - first) > range) {
+				x++;
+			}
+			if (x == w) {
+				continue;    // None on this row.
+			}
+			minx = std::min(minx, x);
+			x    = w - 1;
+			while (x > maxx && static_cast<unsigned>(line[x] - first) > range) {
+				x--;
+			}
+			maxx = std::max(maxx, x);
+		}
+		if (maxx >= minx
+			&& scale_area(startx + minx, starty + y, maxx - minx + 1, bh)) {
+			shown = true;
+		}
+	}
+	if (shown) {
+		present();
+	}
+}
+
 static inline int pow2(int x) {
 	return x * x;
 }
@@ -70,6 +70,9 @@ public:
 	// Rotate palette colors.
 	void rotate_colors(int first, int num, int upd) override;
 
+	// Repaint the parts that use colors first to last.
+	void show_colors(int first, int last) override;
+
 	/*
 	 *  8-bit color methods:
 	 */
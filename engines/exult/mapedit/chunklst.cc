@@ -176,6 +176,9 @@ unsigned char* Chunk_chooser::get_chunk(int chunknum) {
 	if (data) {
 		return data;    // Already have it.
 	}
+	if (get_chunks(chunknum)) {
+		return chunklist[chunknum];
+	}
 	// Get from server.
 	unsigned char        buf[Exult_server::maxlength];
 	unsigned char*       ptr    = &buf[0];
@@ -207,6 +210,77 @@ unsigned char* Chunk_chooser::get_chunk(int chunknum) {
 	return chunklist[chunknum];
 }
 
+/*
+ *  Get a run of chunks we don't have yet from the server, starting
+ *  with one, in a single request.
+ *
+ *  Output: false if the server didn't send them.
+ */
+
+bool Chunk_chooser::get_chunks(int chunknum) {
+	// Stop at the first one we have.
+	int cnt = 1;
+	while (chunknum + cnt < num_chunks && !chunklist[chunknum + cnt]
+		   && (cnt + 1) * chunksz + 12 <= Exult_server::max_batch_length) {
+		cnt++;
+	}
+	unsigned char  buf[4];
+	unsigned char* ptr = &buf[0];
+	little_endian::Write2(ptr, chunknum);
+	little_endian::Write2(ptr, cnt);
+	ExultStudio*               studio        = ExultStudio::get_instance();
+	int                        server_socket = studio->get_server_socket();
+	std::vector<unsigned char> reply(Exult_server::max_batch_length);
+	Exult_server::Msg_type     id;    // Expect immediate answer.
+	int                        datalen;
+	if (!studio->send_to_server(Exult_server::send_terrains, buf, ptr - buf)
+		|| !Exult_server::wait_for_response(server_socket, 100)
+		|| (datalen = Exult_server::Receive_data(
+					server_socket, id, reply.data(),
+					static_cast<int>(reply.size())))
+				   == -1
+		|| id != Exult_server::send_terrains) {
+		return false;
+	}
+	return set_chunks(reply.data(), datalen) && chunklist[chunknum];
+}
+
+/*
+ *  Set a run of chunks with data from 'Exult'.
+ *
+ *  Output: false if the data was bad.
+ */
+
+bool Chunk_chooser::set_chunks(const unsigned char* data, int datalen) {
+	if (datalen < 6) {
+		return false;
+	}
+	const int first          = little_endian::Read2(data);
+	const int cnt            = little_endian::Read2(data);
+	const int new_num_chunks = little_endian::Read2(data);
+	datalen -= 6;
+	if (datalen != cnt * chunksz || first < 0
+		|| first + cnt > new_num_chunks) {
+		cout << "Set_chunks:  Bad data received" << endl;
+		return false;
+	}
+	if (new_num_chunks != num_chunks) {
+		// Update total #.
+		if (new_num_chunks > num_chunks) {
+			chunklist.resize(new_num_chunks);
+		}
+		update_num_chunks(new_num_chunks);
+	}
+	for (int tnum = first; tnum < first + cnt; tnum++, data += chunksz) {
+		unsigned char* chunk = chunklist[tnum];
+		if (!chunk) {    // Not read yet?
+			chunk = chunklist[tnum] = new unsigned char[chunksz];
+		}
+		memcpy(chunk, data, chunksz);
+	}
+	return true;
+}
+
 /*
  *  Update #chunks.
  */
@@ -703,6 +777,12 @@ static void on_delete(GtkMenuItem* item, gpointer udata) {
 	chooser->del();
 }
 
+static void on_merge(GtkMenuItem* item, gpointer udata) {
+	ignore_unused_variable_warning(item);
+	auto* chooser = static_cast<Chunk_chooser*>(udata);
+	chooser->merge();
+}
+
 /*
  *  Set up popup menu.
  */
@@ -720,6 +800,7 @@ GtkWidget* Chunk_chooser::create_popup() {
 		Add_menu_item(new_menu, "Duplicate", G_CALLBACK(on_insert_dup), this);
 		Add_menu_item(popup, "Delete", G_CALLBACK(on_delete), this);
 	}
+	Add_menu_item(popup, "Merge Duplicates", G_CALLBACK(on_merge), this);
 	return popup;
 }
 
@@ -871,10 +952,17 @@ bool Chunk_chooser::server_response(int id, unsigned char* data, int datalen) {
 	case Exult_server::swap_terrain:
 		swap_response(data, datalen);
 		return true;
+	case Exult_server::merge_terrains:
+		merge_response(data, datalen);
+		return true;
 	case Exult_server::send_terrain:
 		set_chunk(data, datalen);
 		render();
 		return true;
+	case Exult_server::send_terrains:
+		set_chunks(data, datalen);
+		render();
+		return true;
 	default:
 		return false;
 	}
@@ -1080,6 +1168,49 @@ void Chunk_chooser::delete_response(const unsigned char* data, int datalen) {
 	}
 }
 
+/*
+ *  Have chunks whose terrains are the same share one, deleting the rest.
+ */
+
+void Chunk_chooser::merge() {
+	unsigned char  data[Exult_server::maxlength];
+	unsigned char* ptr = &data[0];
+	little_endian::Write2(ptr, 0);    // Tolerance:  exact matches.
+	ExultStudio* studio = ExultStudio::get_instance();
+	studio->send_to_server(Exult_server::merge_terrains, data, ptr - data);
+}
+
+/*
+ *  Response from server to a 'merge'.
+ */
+
+void Chunk_chooser::merge_response(const unsigned char* data, int datalen) {
+	ignore_unused_variable_warning(datalen);
+	const unsigned char* ptr     = data;
+	const int            removed = little_endian::Read2s(ptr);
+	const int            total   = little_endian::Read2(ptr);
+	if (removed < 0) {
+		EStudio::Alert("Finish terrain-editing before merging.");
+		return;
+	}
+	if (removed == 0) {
+		EStudio::Alert("No terrains are the same.");
+		return;
+	}
+	// The numbers have changed, so get them all again.
+	unselect(false);
+	for (int i = 0; i < num_chunks; i++) {
+		delete chunklist[i];
+	}
+	chunklist.assign(total, nullptr);
+	update_num_chunks(total);
+	render();
+	EStudio::Alert(
+			"Merged %d terrains; %d are left.  Chunk groups may need "
+			"updating.",
+			removed, total);
+}
+
 /*
  *  Move currently-selected chunk up or down.
  */
@@ -88,6 +88,8 @@ class Chunk_chooser : public Object_browser, public Shape_draw {
 	unsigned char* get_chunk(int chunknum);
 	void           update_num_chunks(int new_num_chunks);
 	void           set_chunk(const unsigned char* data, int datalen);
+	bool           get_chunks(int chunknum);
+	bool           set_chunks(const unsigned char* data, int datalen);
 	void render_chunk(int chunknum, Image_buffer8* rwin, int xoff, int yoff);
 	void scroll(int newpixel);    // Scroll.
 	void scroll(bool upwards);
@@ -141,6 +143,8 @@ public:
 	void        del();               // Delete current chunk.
 	void        insert_response(const unsigned char* data, int datalen);
 	void        delete_response(const unsigned char* data, int datalen);
+	void        merge();    // Merge terrains that are the same.
+	void        merge_response(const unsigned char* data, int datalen);
 	void        move(bool upwards) override;    // Move current selected chunk.
 	void        swap_response(const unsigned char* data, int datalen);
 	static gint drag_motion(
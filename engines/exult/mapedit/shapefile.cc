@@ -164,15 +164,15 @@ void Image_file_info::write_file(
 		int         nshapes,     // # shapes.
 		bool        single       // Don't write a FLEX file.
 ) {
-	OFileDataSource out(pathname);    // May throw exception.
 	if (single) {
+		OFileDataSource out(pathname);    // May throw exception.
 		if (nshapes) {
 			shapes[0]->write(out);
 		}
 		out.flush();
 		return;
 	}
-	Flex_writer writer(out, "Written by ExultStudio", nshapes);
+	Flex_writer writer(pathname, "Written by ExultStudio", nshapes);
 	// Write all out.
 	for (int shnum = 0; shnum < nshapes; shnum++) {
 		if (shapes[shnum]->get_modified() || shapes[shnum]->get_from_patch()) {
@@ -291,29 +291,77 @@ void Npcs_file_info::setup() {
 		return;
 	}
 	npcs.resize(num_npcs);
+	// Ask for them all at once, rather than waiting for each.
+	Exult_server::Batch requests(server_socket);
 	for (int i = 0; i < num_npcs; ++i) {
-		newptr = ptr = &buf[0];
+		ptr = &buf[0];
 		little_endian::Write2(ptr, i);
-		if (!studio->send_to_server(Exult_server::npc_info, buf, ptr - buf)
-			|| !Exult_server::wait_for_response(server_socket, 100)
-			|| Exult_server::Receive_data(server_socket, id, buf, sizeof(buf))
-					   == -1
-			|| id != Exult_server::npc_info
-			|| little_endian::Read2(newptr) != i) {
+		if (!requests.add(Exult_server::npc_info, buf, ptr - buf)
+			&& (requests.send() == -1
+				|| !requests.add(Exult_server::npc_info, buf, ptr - buf))) {
 			npcs.resize(0);
-			cerr << "Error getting info for NPC #" << i << endl;
+			cerr << "Error sending data to server." << endl;
 			return;
 		}
-		npcs[i].shapenum = little_endian::Read2(newptr);    // -1 if unused.
+	}
+	if (requests.send() == -1) {
+		npcs.resize(0);
+		cerr << "Error sending data to server." << endl;
+		return;
+	}
+	// Replies may come singly or in batches.
+	std::vector<unsigned char> reply(Exult_server::max_batch_length);
+	int                        received = 0;
+	auto store = [&](Exult_server::Msg_type id, const unsigned char* data,
+					 int datalen) {
+		if (id != Exult_server::npc_info || datalen < 4) {
+			return false;
+		}
+		const unsigned i = little_endian::Read2(data);
+		if (i >= npcs.size()) {
+			return false;
+		}
+		npcs[i].shapenum = little_endian::Read2(data);    // -1 if unused.
 		if (npcs[i].shapenum >= 0) {
-			npcs[i].unused = Read1(newptr) != 0;
+			npcs[i].unused = Read1(data) != 0;
 			const string utf8name(
-					convertToUTF8(reinterpret_cast<const char*>(newptr)));
+					convertToUTF8(reinterpret_cast<const char*>(data)));
 			npcs[i].name = utf8name;
 		} else {
 			npcs[i].unused = true;
 			npcs[i].name   = "";
 		}
+		received++;
+		return true;
+	};
+	while (received < num_npcs) {
+		int datalen;
+		if (!Exult_server::wait_for_response(server_socket, 100)
+			|| (datalen = Exult_server::Receive_data(
+						server_socket, id, reply.data(),
+						static_cast<int>(reply.size())))
+					   == -1) {
+			npcs.resize(0);
+			cerr << "Error getting info for NPC #" << received << endl;
+			return;
+		}
+		bool ok = true;
+		if (id == Exult_server::batch) {
+			const unsigned char* next = reply.data();
+			const unsigned char* end  = next + datalen;
+			const unsigned char* data;
+			while (ok
+				   && Exult_server::Batch::next(next, end, id, data, datalen)) {
+				ok = store(id, data, datalen);
+			}
+		} else {
+			ok = store(id, reply.data(), datalen);
+		}
+		if (!ok) {
+			npcs.resize(0);
+			cerr << "Error getting info for NPC #" << received << endl;
+			return;
+		}
 	}
 }
 
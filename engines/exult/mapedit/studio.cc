@@ -55,8 +55,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <cstdarg>
 #include <cstdio> /* These are for sockets. */
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 #ifdef _WIN32
 #	include "servewin32.h"
@@ -3297,11 +3299,11 @@ void ExultStudio::read_from_server() {
 		return;
 	}
 #endif
-	unsigned char          data[Exult_server::maxlength];
-	Exult_server::Msg_type id;
-	const int              datalen
-			= Exult_server::Receive_data(server_socket, id, data, sizeof(data));
-	if (datalen < 0 || datalen > static_cast<int>(sizeof(data))) {
+	static std::vector<unsigned char> buf(Exult_server::max_batch_length);
+	Exult_server::Msg_type            id;
+	int                               datalen = Exult_server::Receive_data(
+            server_socket, id, buf.data(), static_cast<int>(buf.size()));
+	if (datalen < 0) {
 		cout << "Error reading from server" << endl;
 		if (server_socket == -1) {    // Socket closed?
 			g_source_remove(server_input_tag);
@@ -3317,6 +3319,31 @@ void ExultStudio::read_from_server() {
 		return;
 	}
 	cout << "Read " << datalen << " bytes from server" << endl;
+	if (id != Exult_server::batch) {
+		handle_server_message(id, buf.data(), datalen);
+		return;
+	}
+	// Several messages, one after another.
+	const unsigned char* ptr = buf.data();
+	const unsigned char* end = ptr + datalen;
+	const unsigned char* msgdata;
+	while (Exult_server::Batch::next(ptr, end, id, msgdata, datalen)) {
+		unsigned char data[Exult_server::maxlength];
+		if (datalen > static_cast<int>(sizeof(data))) {
+			cout << "Message in batch is too long" << endl;
+			continue;
+		}
+		std::memcpy(data, msgdata, datalen);
+		handle_server_message(id, data, datalen);
+	}
+}
+
+/*
+ *  Handle one message from the server.
+ */
+
+void ExultStudio::handle_server_message(
+		Exult_server::Msg_type id, unsigned char* data, int datalen) {
 	cout << "ID = " << static_cast<int>(id) << endl;
 	switch (id) {
 	case Exult_server::obj:
@@ -3340,6 +3367,7 @@ void ExultStudio::read_from_server() {
 	case Exult_server::swap_terrain:
 	case Exult_server::insert_terrain:
 	case Exult_server::delete_terrain:
+	case Exult_server::merge_terrains:
 	case Exult_server::locate_shape:
 	case Exult_server::game_pos:
 	case Exult_server::get_user_click:
@@ -3351,6 +3379,11 @@ void ExultStudio::read_from_server() {
 			browser->server_response(static_cast<int>(id), data, datalen);
 		}
 		break;
+	case Exult_server::send_terrains:    // Came too late.
+		if (browser) {
+			browser->server_response(static_cast<int>(id), data, datalen);
+		}
+		break;
 	case Exult_server::info:
 		info_received(data, datalen);
 		break;
@@ -533,6 +533,8 @@ public:
 			Exult_server::Msg_type id, unsigned char* data = nullptr,
 			int datalen = 0);
 	void read_from_server();
+	void handle_server_message(
+			Exult_server::Msg_type id, unsigned char* data, int datalen);
 	bool connect_to_server();
 	void disconnect_from_server();
 	// Message from Exult.
@@ -4,13 +4,20 @@
 
 #include "DialogueHooks.h"
 #include "ExultNPCBridge.h"
+#include "Async_log.h"
 
 #include <algorithm>
-#include <iostream>
 
 namespace Ultima {
 namespace Exult {
 
+namespace {
+
+Log_category hooksLog("DialogueHooks", Log_level::Info, 20);
+Log_category dialogueLog("AIDialogueIntegration");
+
+} // namespace
+
 // DialogueHooks implementation
 
 DialogueHooks& DialogueHooks::getInstance() {
@@ -69,7 +76,7 @@ DialogueHookResult DialogueHooks::invokeHooks(const DialogueEventData& data) {
                     }
                 }
             } catch (const std::exception& e) {
-                std::cerr << "[DialogueHooks] Hook error: " << e.what() << std::endl;
+                ULTIMA_LOG(hooksLog, Error) << "Hook error: " << e.what();
             }
         }
     }
@@ -215,7 +222,7 @@ bool AIDialogueIntegration::initialize() {
     auto& bridge = ExultNPCBridge::getInstance();
     if (!bridge.isInitialized()) {
         if (!bridge.initialize()) {
-            std::cerr << "[AIDialogueIntegration] Failed to initialize NPC bridge" << std::endl;
+            ULTIMA_LOG(dialogueLog, Error) << "Failed to initialize NPC bridge";
             return false;
         }
     }
@@ -289,7 +296,7 @@ bool AIDialogueIntegration::initialize() {
     );
     
     active_ = true;
-    std::cout << "[AIDialogueIntegration] Initialized successfully" << std::endl;
+    ULTIMA_LOG(dialogueLog, Info) << "Initialized successfully";
     return true;
 }
 
@@ -313,7 +320,7 @@ void AIDialogueIntegration::shutdown() {
     usecodeHooks.setEndConversationHook(nullptr);
     
     active_ = false;
-    std::cout << "[AIDialogueIntegration] Shutdown complete" << std::endl;
+    ULTIMA_LOG(dialogueLog, Info) << "Shutdown complete";
 }
 
 void AIDialogueIntegration::setEnabled(bool enabled) {
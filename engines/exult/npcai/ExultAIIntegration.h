@@ -58,6 +58,19 @@
         } \
     } while(0)
 
+/**
+ * Advance the cognitive NPCs with the game clock
+ * Call this once per game clock tick, not per frame
+ *
+ * @param game_time Game time in seconds
+ */
+#define NPCAI_TICK(game_time) \
+    do { \
+        if (Ultima::Exult::NPCAIInitializer::isInitialized()) { \
+            Ultima::Exult::NPCAIInitializer::tick(game_time); \
+        } \
+    } while(0)
+
 // =============================================================================
 // DIALOGUE INTEGRATION MACROS
 // =============================================================================
@@ -5,10 +5,13 @@
 #include "ExultNPCBridge.h"
 #include "../../npc/include/NPCSystem.h"
 #include "../../npc/include/aiml/HybridDialogue.h"
+#include "../../npc/include/llm/DialogueService.h"
 #include "../../npc/include/llm/TinyLLM.h"
 #include "../../npc/include/persona/Persona.h"
+#include "../../npc/include/persistence/Archive.h"
+#include "Job_system.h"
+#include "Async_log.h"
 
-#include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <ctime>
@@ -16,6 +19,104 @@
 namespace Ultima {
 namespace Exult {
 
+namespace {
+
+constexpr int TILES_PER_SUPERCHUNK = 256;
+
+// Rough size of an active NPC's subsystems, besides what its archive holds
+constexpr size_t ENTITY_BYTES = 32 * 1024;
+
+// Registrations come a superchunk at a time, so they are debug messages,
+// and no more than a screenful a second of anything
+Log_category bridgeLog("ExultNPCBridge", Log_level::Info, 20);
+
+void applyProfile(NPC::NPCEntity& entity, const NPCProfile& profile) {
+    auto& persona = entity.getPersona();
+    persona.name = profile.name;
+    persona.role.title = profile.profession;
+    // backstory stored in description
+    persona.description = profile.backstory;
+    persona.traits.openness = profile.openness;
+    persona.traits.conscientiousness = profile.conscientiousness;
+    persona.traits.extraversion = profile.extraversion;
+    persona.traits.agreeableness = profile.agreeableness;
+    persona.traits.neuroticism = profile.neuroticism;
+}
+
+// Choose between carrying on and the other options. Only reads the NPC,
+// so may run on any thread.
+BehaviorSuggestion decide(
+    NPC::NPCEntity& entity,
+    const std::vector<std::string>& options,
+    const std::vector<const void*>& targets = {}
+) {
+    BehaviorSuggestion suggestion;
+    suggestion.type = BehaviorSuggestion::Type::CONTINUE_CURRENT;
+    
+    auto decision = entity.makeDecision(options);
+    
+    if (decision.action.find("interact:") == 0) {
+        suggestion.type = BehaviorSuggestion::Type::INTERACT_WITH_OBJECT;
+        suggestion.targetId = decision.action.substr(9);
+    } else if (decision.action.find("approach:") == 0) {
+        suggestion.type = BehaviorSuggestion::Type::APPROACH_NPC;
+        suggestion.targetId = decision.action.substr(9);
+    }
+    if (!targets.empty()) {
+        const size_t chosen = std::find(options.begin(), options.end(), decision.action) - options.begin();
+        suggestion.target = chosen < targets.size() ? targets[chosen] : nullptr;
+    }
+    
+    suggestion.confidence = static_cast<float>(decision.confidence);
+    suggestion.reasoning = decision.reasoning;
+    return suggestion;
+}
+
+BehaviorSuggestion suggestFor(
+    NPC::NPCEntity& entity,
+    const std::vector<std::string>& nearbyObjects,
+    const std::vector<std::string>& nearbyNPCs
+) {
+    std::vector<std::string> options;
+    options.push_back("continue_current");
+    
+    for (const auto& obj : nearbyObjects) {
+        options.push_back("interact:" + obj);
+    }
+    
+    for (const auto& other : nearbyNPCs) {
+        options.push_back("approach:" + other);
+    }
+    
+    return decide(entity, options);
+}
+
+// From a snapshot whose names for the view have been looked up
+BehaviorSuggestion suggestFor(
+    NPC::NPCEntity& entity,
+    const void* self,
+    PerceptionView nearby,
+    PerceptionSnapshot& perception
+) {
+    std::vector<std::string> options;
+    std::vector<const void*> targets;
+    options.reserve(nearby.size() + 1);
+    targets.reserve(nearby.size() + 1);
+    options.push_back("continue_current");
+    targets.push_back(nullptr);
+    
+    for (const auto& object : nearby) {
+        if (object.object == self) continue;
+        const char* verb = (object.flags & PerceivedObject::IS_ACTOR) ? "approach:" : "interact:";
+        options.push_back(verb + perception.nameOf(object));
+        targets.push_back(object.object);
+    }
+    
+    return decide(entity, options, targets);
+}
+
+} // namespace
+
 // Singleton instance
 ExultNPCBridge& ExultNPCBridge::getInstance() {
     static ExultNPCBridge instance;
@@ -35,12 +136,16 @@ bool ExultNPCBridge::initialize(const std::string& configPath) {
     }
     
     try {
+        manager_ = std::make_unique<NPC::NPCManager>();
+        manager_->initialize("");
+        
         // Initialize the dialogue engine
         dialogueEngine_ = std::make_unique<NPC::Dialogue::HybridDialogueEngine>();
         
         // Initialize with default config
         NPC::Dialogue::HybridConfig config;
         dialogueEngine_->initialize(config, "");
+        aimlConfidenceThreshold_ = config.aimlConfidenceThreshold;
         
         // Set default paths
         if (aimlPatternsPath_.empty()) {
@@ -48,11 +153,11 @@ bool ExultNPCBridge::initialize(const std::string& configPath) {
         }
         
         initialized_ = true;
-        std::cout << "[ExultNPCBridge] Initialized successfully" << std::endl;
+        ULTIMA_LOG(bridgeLog, Info) << "Initialized successfully";
         return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "[ExultNPCBridge] Initialization failed: " << e.what() << std::endl;
+        ULTIMA_LOG(bridgeLog, Error) << "Initialization failed: " << e.what();
         return false;
     }
 }
@@ -62,13 +167,23 @@ void ExultNPCBridge::shutdown() {
         return;
     }
     
-    cognitiveNPCs_.clear();
+    dialogueService_.reset();
+    residents_.clear();
+    profileIds_.clear();
+    activeOrder_.clear();
+    residentBytes_ = 0;
+    nextActorId_ = 1;
+    manager_.reset();
+    gameTime_ = -1.0;
     actorToId_.clear();
     activeConversations_.clear();
+    avatarDistances_.clear();
+    behaviorRequests_.clear();
+    perception_.clear();
     dialogueEngine_.reset();
     
     initialized_ = false;
-    std::cout << "[ExultNPCBridge] Shutdown complete" << std::endl;
+    ULTIMA_LOG(bridgeLog, Info) << "Shutdown complete";
 }
 
 bool ExultNPCBridge::registerNPC(Actor* actor, const NPCProfile& profile) {
@@ -80,33 +195,23 @@ bool ExultNPCBridge::registerNPC(Actor* actor, const NPCProfile& profile) {
         return true;
     }
     
-    try {
-        auto entity = std::make_unique<NPC::NPCEntity>(profile.id);
-        
-        auto& persona = entity->getPersona();
-        persona.name = profile.name;
-        persona.role.title = profile.profession;
-        // backstory stored in description
-        persona.description = profile.backstory;
-        persona.traits.openness = profile.openness;
-        persona.traits.conscientiousness = profile.conscientiousness;
-        persona.traits.extraversion = profile.extraversion;
-        persona.traits.agreeableness = profile.agreeableness;
-        persona.traits.neuroticism = profile.neuroticism;
-        
-        int actorId = static_cast<int>(cognitiveNPCs_.size()) + 1;
-        actorToId_[actor] = actorId;
-        cognitiveNPCs_[actorId] = std::move(entity);
-        
-        std::cout << "[ExultNPCBridge] Registered NPC: " << profile.name 
-                  << " (ID: " << actorId << ")" << std::endl;
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "[ExultNPCBridge] Failed to register NPC: " << e.what() << std::endl;
+    if (profileIds_.count(profile.id) > 0) {
+        ULTIMA_LOG(bridgeLog, Warning) << "NPC ID already registered: " << profile.id;
         return false;
     }
+    
+    // Only built once activated
+    const int actorId = nextActorId_++;
+    actorToId_[actor] = actorId;
+    profileIds_[profile.id] = actorId;
+    Resident& resident = residents_[actorId];
+    resident.profile = profile;
+    resident.inactiveSince = std::max(gameTime_, 0.0);
+    
+    ULTIMA_LOG(bridgeLog, Debug) << "Registered NPC: " << profile.name
+                                 << " (ID: " << actorId << ")";
+    
+    return true;
 }
 
 bool ExultNPCBridge::unregisterNPC(Actor* actor) {
@@ -120,7 +225,18 @@ bool ExultNPCBridge::unregisterNPC(Actor* actor) {
     }
     
     int actorId = it->second;
-    cognitiveNPCs_.erase(actorId);
+    auto resident = residents_.find(actorId);
+    if (dialogueService_) {
+        dialogueService_->cancelNPC(resident->second.profile.name);
+    }
+    if (resident->second.entity) {
+        manager_->removeNPC(resident->second.entity->getId());
+        activeOrder_.erase(resident->second.used);
+        residentBytes_ -= resident->second.bytes;
+    }
+    profileIds_.erase(resident->second.profile.id);
+    residents_.erase(resident);
+    avatarDistances_.erase(actorId);
     actorToId_.erase(it);
     activeConversations_.erase(actorId);
     
@@ -137,14 +253,126 @@ NPC::NPCEntity* ExultNPCBridge::getCognitiveNPC(Actor* actor) {
     auto it = actorToId_.find(actor);
     if (it == actorToId_.end()) return nullptr;
     
-    auto npcIt = cognitiveNPCs_.find(it->second);
-    if (npcIt == cognitiveNPCs_.end()) return nullptr;
-    
-    return npcIt->second.get();
+    return activate(it->second);
 }
 
 const NPC::NPCEntity* ExultNPCBridge::getCognitiveNPC(Actor* actor) const {
-    return const_cast<ExultNPCBridge*>(this)->getCognitiveNPC(actor);
+    auto it = residents_.find(getActorId(actor));
+    if (it == residents_.end()) return nullptr;
+    
+    return it->second.entity;
+}
+
+bool ExultNPCBridge::isActive(Actor* actor) const {
+    return getCognitiveNPC(actor) != nullptr;
+}
+
+void ExultNPCBridge::setActivationDistance(int superchunks) {
+    activationTiles_ = std::max(0, superchunks) * TILES_PER_SUPERCHUNK;
+}
+
+void ExultNPCBridge::setResidentBudget(size_t kilobytes) {
+    residentBudget_ = kilobytes * 1024;
+    evictToBudget(-1);
+}
+
+NPC::NPCEntity* ExultNPCBridge::activate(int actorId) {
+    auto it = residents_.find(actorId);
+    if (it == residents_.end()) return nullptr;
+    
+    Resident& resident = it->second;
+    if (resident.entity) {
+        activeOrder_.splice(activeOrder_.begin(), activeOrder_, resident.used);
+        return resident.entity;
+    }
+    
+    try {
+        auto entity = std::make_unique<NPC::NPCEntity>(resident.profile.id);
+        if (resident.archive.empty() || !entity->deserialize(resident.archive)) {
+            if (!resident.archive.empty()) {
+                ULTIMA_LOG(bridgeLog, Warning)
+                        << "Cannot restore NPC: " << resident.profile.name
+                        << ", starting afresh";
+            }
+            applyProfile(*entity, resident.profile);
+        }
+        
+        // Catch up on the time spent inactive in one step
+        const double now = std::max(gameTime_, 0.0);
+        const double behind = now - resident.inactiveSince;
+        if (behind > 0.0) {
+            entity->update(behind);
+            entity->decay(behind, static_cast<uint32_t>(now));
+        }
+        
+        resident.bytes = ENTITY_BYTES +
+            NPC::Persistence::ArchiveReader::payloadSize(resident.archive);
+        std::string().swap(resident.archive);
+        resident.entity = manager_->addNPC(std::move(entity));
+        resident.importance = 1.0;
+        activeOrder_.push_front(actorId);
+        resident.used = activeOrder_.begin();
+        residentBytes_ += resident.bytes;
+        
+    } catch (const std::exception& e) {
+        ULTIMA_LOG(bridgeLog, Error) << "Failed to activate NPC: " << e.what();
+        return nullptr;
+    }
+    
+    updateImportance(actorId);
+    evictToBudget(actorId);
+    return resident.entity;
+}
+
+void ExultNPCBridge::evict(int actorId) {
+    auto it = residents_.find(actorId);
+    if (it == residents_.end() || !it->second.entity) return;
+    
+    Resident& resident = it->second;
+    resident.archive = resident.entity->serialize(true);
+    resident.inactiveSince = std::max(gameTime_, 0.0);
+    manager_->removeNPC(resident.entity->getId());
+    resident.entity = nullptr;
+    activeOrder_.erase(resident.used);
+    residentBytes_ -= resident.bytes;
+    resident.bytes = 0;
+}
+
+void ExultNPCBridge::evictToBudget(int keepId) {
+    // Least recently used first, keeping those near the avatar or talking
+    auto it = activeOrder_.end();
+    while (residentBytes_ > residentBudget_ && it != activeOrder_.begin()) {
+        --it;
+        const int actorId = *it;
+        if (actorId == keepId || isWanted(actorId)) continue;
+        ++it;
+        evict(actorId);
+    }
+}
+
+bool ExultNPCBridge::isWanted(int actorId) const {
+    if (activeConversations_.count(actorId) > 0) return true;
+    
+    auto distance = avatarDistances_.find(actorId);
+    return distance != avatarDistances_.end() && distance->second <= activationTiles_;
+}
+
+void ExultNPCBridge::updateImportance(int actorId) {
+    auto it = residents_.find(actorId);
+    if (it == residents_.end() || !it->second.entity) return;
+    
+    auto distance = avatarDistances_.find(actorId);
+    const double importance = NPC::NPCManager::importanceOf(
+        distance != avatarDistances_.end() ? distance->second : 0,
+        activeConversations_.count(actorId) > 0);
+    
+    // Only the update period matters, so spare the manager's lookup
+    Resident& resident = it->second;
+    if (NPC::NPCManager::updatePeriod(importance) !=
+        NPC::NPCManager::updatePeriod(resident.importance)) {
+        manager_->setImportance(resident.entity->getId(), importance);
+    }
+    resident.importance = importance;
 }
 
 int ExultNPCBridge::getActorId(Actor* actor) const {
@@ -152,6 +380,59 @@ int ExultNPCBridge::getActorId(Actor* actor) const {
     return (it != actorToId_.end()) ? it->second : -1;
 }
 
+NPC::LLM::NPCContext ExultNPCBridge::buildPromptContext(
+    Resident& resident,
+    const DialogueContext& context
+) {
+    if (!resident.prompt) {
+        const auto& persona = resident.entity->getPersona();
+        auto prompt = std::make_shared<NPC::LLM::NPCContext>();
+        prompt->name = persona.name;
+        prompt->occupation = persona.role.title;
+        
+        // Build personality string
+        std::stringstream ss;
+        const auto& p = persona.traits;
+        if (p.extraversion > 0.6f) ss << "outgoing, ";
+        if (p.agreeableness > 0.6f) ss << "friendly, ";
+        if (p.conscientiousness > 0.6f) ss << "diligent, ";
+        prompt->personality = ss.str();
+        
+        if (!persona.description.empty()) {
+            prompt->knownFacts.push_back(persona.description);
+        }
+        for (const auto& [id, level] : resident.profile.relationships) {
+            auto other = profileIds_.find(id);
+            const std::string& name = other != profileIds_.end() ?
+                residents_.at(other->second).profile.name : id;
+            if (level > 0.6f) {
+                prompt->knownFacts.push_back("You are fond of " + name + ".");
+            } else if (level < 0.4f) {
+                prompt->knownFacts.push_back("You distrust " + name + ".");
+            }
+        }
+        
+        prompt->prefix = NPC::LLM::PromptPrefix::make(prompt->personaPrompt());
+        resident.prompt = std::move(prompt);
+    }
+    
+    // Only the situation is built afresh each turn
+    NPC::LLM::NPCContext npcContext = *resident.prompt;
+    npcContext.location = context.location;
+    npcContext.currentMood = context.mood;
+    
+    std::string& events = npcContext.recentEvents;
+    for (const auto& topic : context.recentTopics) {
+        events += (events.empty() ? "talked about " : ", ") + topic;
+    }
+    if (!context.currentQuest.empty()) {
+        events += (events.empty() ? "" : "; ") + std::string("the Avatar is on the quest ") +
+                  context.currentQuest;
+    }
+    
+    return npcContext;
+}
+
 std::string ExultNPCBridge::processDialogue(
     Actor* npc,
     const std::string& playerInput,
@@ -167,20 +448,7 @@ std::string ExultNPCBridge::processDialogue(
     }
     
     try {
-        // Build NPC context for dialogue engine
-        NPC::LLM::NPCContext npcContext;
-        npcContext.name = entity->getPersona().name;
-        npcContext.occupation = entity->getPersona().role.title;
-        npcContext.location = context.location;
-        npcContext.currentMood = context.mood;
-        
-        // Build personality string
-        std::stringstream ss;
-        const auto& p = entity->getPersona().traits;
-        if (p.extraversion > 0.6f) ss << "outgoing, ";
-        if (p.agreeableness > 0.6f) ss << "friendly, ";
-        if (p.conscientiousness > 0.6f) ss << "diligent, ";
-        npcContext.personality = ss.str();
+        auto npcContext = buildPromptContext(residents_.at(getActorId(npc)), context);
         
         // Build dialogue context
         NPC::Dialogue::DialogueContext dialogueCtx;
@@ -188,12 +456,42 @@ std::string ExultNPCBridge::processDialogue(
         dialogueCtx.playerId = context.playerId;
         dialogueCtx.currentLocation = context.location;
         
-        // Generate response
-        auto result = dialogueEngine_->generateResponse(
-            playerInput,
-            npcContext,
-            dialogueCtx
-        );
+        if (!llmFallbackEnabled_ || !startDialogueService()) {
+            // Generate response
+            auto result = dialogueEngine_->generateResponse(
+                playerInput,
+                npcContext,
+                dialogueCtx
+            );
+            
+            if (dialogueCallback_) {
+                dialogueCallback_(result.response);
+            }
+            
+            return result.response;
+        }
+        
+        // Answer from the patterns now, and have the LLM try to do better
+        // without holding up the game
+        auto result = dialogueEngine_->generateFromAIML(playerInput, npcContext);
+        result.response = NPC::LLM::PersonalityModifier::addEmotion(
+            result.response, npcContext.currentMood, 0.5f);
+        if (result.confidence < aimlConfidenceThreshold_) {
+            NPC::LLM::DialogueRequest request;
+            request.playerInput = playerInput;
+            request.npcContext = npcContext;
+            request.stopSequences = {"\nPlayer:"};
+            
+            const std::string mood = npcContext.currentMood;
+            dialogueService_->submit(request,
+                [this, mood](const NPC::LLM::DialogueResult& reply) {
+                    if (reply.wasGenerated && dialogueCallback_) {
+                        dialogueCallback_(NPC::LLM::PersonalityModifier::addEmotion(
+                            reply.response, mood, 0.5f));
+                    }
+                },
+                nullptr, llmDeadlineMs_);
+        }
         
         if (dialogueCallback_) {
             dialogueCallback_(result.response);
@@ -202,7 +500,7 @@ std::string ExultNPCBridge::processDialogue(
         return result.response;
         
     } catch (const std::exception& e) {
-        std::cerr << "[ExultNPCBridge] Dialogue error: " << e.what() << std::endl;
+        ULTIMA_LOG(bridgeLog, Error) << "Dialogue error: " << e.what();
         return "";
     }
 }
@@ -250,6 +548,8 @@ void ExultNPCBridge::startConversation(Actor* npc, const DialogueContext& contex
     if (actorId < 0) return;
     
     activeConversations_[actorId] = context;
+    activate(actorId);
+    updateImportance(actorId);
 }
 
 void ExultNPCBridge::endConversation(Actor* npc) {
@@ -259,6 +559,36 @@ void ExultNPCBridge::endConversation(Actor* npc) {
     if (actorId < 0) return;
     
     activeConversations_.erase(actorId);
+    updateImportance(actorId);
+    
+    // Replies still being generated are no longer wanted
+    if (dialogueService_) {
+        dialogueService_->cancelNPC(residents_.at(actorId).profile.name);
+    }
+}
+
+bool ExultNPCBridge::startDialogueService() {
+    if (dialogueService_) {
+        return dialogueService_->isRunning();
+    }
+    
+    dialogueService_ = std::make_unique<NPC::LLM::DialogueService>();
+    NPC::LLM::LLMConfig config;
+    config.modelPath = llmModelPath_;
+    if (!dialogueService_->start(config)) {
+        // No usable model file, so use the built-in weights as the
+        // dialogue engine does
+        ULTIMA_LOG(bridgeLog, Warning) << "Cannot load LLM model: " << llmModelPath_;
+        config.modelPath.clear();
+        dialogueService_->start(config);
+    }
+    return dialogueService_->isRunning();
+}
+
+void ExultNPCBridge::updateDialogue(double budgetMs) {
+    if (dialogueService_) {
+        dialogueService_->deliver(budgetMs);
+    }
 }
 
 BehaviorSuggestion ExultNPCBridge::suggestBehavior(
@@ -281,36 +611,14 @@ BehaviorSuggestion ExultNPCBridge::suggestBehavior(
     }
     
     try {
-        std::vector<std::string> options;
-        options.push_back("continue_current");
-        
-        for (const auto& obj : nearbyObjects) {
-            options.push_back("interact:" + obj);
-        }
-        
-        for (const auto& other : nearbyNPCs) {
-            options.push_back("approach:" + other);
-        }
-        
-        auto decision = entity->makeDecision(options);
-        
-        if (decision.action.find("interact:") == 0) {
-            suggestion.type = BehaviorSuggestion::Type::INTERACT_WITH_OBJECT;
-            suggestion.targetId = decision.action.substr(9);
-        } else if (decision.action.find("approach:") == 0) {
-            suggestion.type = BehaviorSuggestion::Type::APPROACH_NPC;
-            suggestion.targetId = decision.action.substr(9);
-        }
-        
-        suggestion.confidence = static_cast<float>(decision.confidence);
-        suggestion.reasoning = decision.reasoning;
+        suggestion = suggestFor(*entity, nearbyObjects, nearbyNPCs);
         
         if (behaviorCallback_) {
             behaviorCallback_(suggestion);
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "[ExultNPCBridge] Behavior suggestion error: " << e.what() << std::endl;
+        ULTIMA_LOG(bridgeLog, Error) << "Behavior suggestion error: " << e.what();
     }
     
     return suggestion;
@@ -329,22 +637,151 @@ void ExultNPCBridge::notifyEvent(
     entity->notifyEvent(eventType, eventData);
 }
 
-void ExultNPCBridge::update(Actor* npc, double deltaTime) {
+void ExultNPCBridge::requestBehavior(
+    Actor* npc,
+    int currentSchedule,
+    const std::vector<std::string>& nearbyObjects,
+    const std::vector<std::string>& nearbyNPCs
+) {
     if (!initialized_ || !npc) return;
     
-    auto* entity = getCognitiveNPC(npc);
-    if (!entity) return;
+    const int actorId = getActorId(npc);
+    if (actorId < 0) return;
+    
+    behaviorRequests_.push_back({actorId, npc, currentSchedule, -1, nearbyObjects, nearbyNPCs});
+}
+
+void ExultNPCBridge::requestBehavior(Actor* npc, int currentSchedule, int region) {
+    if (!initialized_ || !npc) return;
+    
+    const int actorId = getActorId(npc);
+    if (actorId < 0) return;
+    
+    behaviorRequests_.push_back({actorId, npc, currentSchedule, region, {}, {}});
+}
+
+std::vector<ExultNPCBridge::QueuedBehavior> ExultNPCBridge::tick(double gameTime) {
+    std::vector<QueuedBehavior> suggestions;
+    if (!initialized_) return suggestions;
+    
+    // Nothing to catch up on the first tick, or after loading an earlier game
+    const double deltaTime = gameTime_ >= 0.0 ? std::max(0.0, gameTime - gameTime_) : 0.0;
+    gameTime_ = gameTime;
+    manager_->update(deltaTime);
+    
+    if (behaviorRequests_.empty()) return suggestions;
+    
+    // Activate them all first, as that may evict; any evicted again
+    // just carry on
+    std::vector<BehaviorRequest> requests;
+    requests.swap(behaviorRequests_);
+    for (const auto& request : requests) {
+        activate(request.actorId);
+    }
+    std::vector<NPC::NPCEntity*> entities;
+    std::vector<PerceptionView> views;
+    entities.reserve(requests.size());
+    views.reserve(requests.size());
+    int named = -1;                             // The last region named
+    for (const auto& request : requests) {
+        entities.push_back(residents_.count(request.actorId) > 0 ?
+                           residents_[request.actorId].entity : nullptr);
+        views.push_back(perception_.region(request.region));
+        // The workers only read names, so look them up here
+        if (request.region >= 0 && request.region != named) {
+            perception_.resolveNames(views.back());
+            named = request.region;
+        }
+    }
     
-    entity->update(deltaTime);
+    suggestions.resize(requests.size());
+    Job_system::get().run("npcai.behavior", requests.size(), [&](size_t i) {
+        BehaviorSuggestion& suggestion = suggestions[i].suggestion;
+        suggestions[i].npc = requests[i].npc;
+        if (!entities[i]) {
+            suggestion.type = BehaviorSuggestion::Type::CONTINUE_CURRENT;
+            suggestion.confidence = 0.5f;
+            return;
+        }
+        const BehaviorRequest& request = requests[i];
+        if (request.region >= 0) {
+            suggestion = suggestFor(*entities[i], request.npc, views[i], perception_);
+        } else {
+            suggestion = suggestFor(*entities[i], request.nearbyObjects, request.nearbyNPCs);
+        }
+    });
+    
+    if (behaviorCallback_) {
+        for (const auto& queued : suggestions) {
+            behaviorCallback_(queued.suggestion);
+        }
+    }
+    return suggestions;
+}
+
+void ExultNPCBridge::setAvatarDistance(Actor* npc, int tiles) {
+    const int actorId = getActorId(npc);
+    if (actorId < 0) return;
+    
+    avatarDistances_[actorId] = tiles;
+    if (tiles <= activationTiles_) {
+        activate(actorId);
+    }
+    updateImportance(actorId);
+}
+
+void ExultNPCBridge::setLLMModelPath(const std::string& path) {
+    llmModelPath_ = path;
+    // Restart with the new model when next needed
+    dialogueService_.reset();
+}
+
+void ExultNPCBridge::setLLMFallbackEnabled(bool enabled) {
+    llmFallbackEnabled_ = enabled;
+    if (!enabled) {
+        dialogueService_.reset();
+    }
+}
+
+void ExultNPCBridge::setLLMDeadline(int milliseconds) {
+    llmDeadlineMs_ = std::max(0, milliseconds);
+}
+
+void ExultNPCBridge::setDialogueCallback(DialogueCallback callback) {
+    dialogueCallback_ = std::move(callback);
 }
 
 float ExultNPCBridge::getRelationship(Actor* npc1, Actor* npc2) const {
     if (!initialized_ || !npc1 || !npc2) return 0.5f;
-    return 0.5f;  // Default neutral relationship
+    
+    auto first = residents_.find(getActorId(npc1));
+    auto second = residents_.find(getActorId(npc2));
+    if (first == residents_.end() || second == residents_.end()) {
+        return 0.5f;  // Default neutral relationship
+    }
+    const auto& relationships = first->second.profile.relationships;
+    auto it = relationships.find(second->second.profile.id);
+    return it != relationships.end() ? it->second : 0.5f;
 }
 
 void ExultNPCBridge::modifyRelationship(Actor* npc1, Actor* npc2, float delta) {
-    // TODO: Implement relationship modification
+    if (!initialized_ || !npc1 || !npc2) return;
+    
+    auto first = residents_.find(getActorId(npc1));
+    auto second = residents_.find(getActorId(npc2));
+    if (first == residents_.end() || second == residents_.end()) return;
+    
+    const float level = getRelationship(npc1, npc2);
+    first->second.profile.relationships[second->second.profile.id] =
+        std::clamp(level + delta, 0.0f, 1.0f);
+    first->second.prompt.reset();
+}
+
+void ExultNPCBridge::invalidatePrompt(Actor* npc) {
+    auto it = residents_.find(getActorId(npc));
+    if (it != residents_.end()) {
+        it->second.prompt.reset();
+    }
 }
 
 void ExultNPCBridge::recordMemory(
@@ -14,9 +14,12 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <list>
 #include <vector>
 #include <functional>
 
+#include "Perception.h"
+
 // Forward declarations for Exult types
 class Actor;
 class Schedule;
@@ -27,10 +30,15 @@ class Usecode_value;
 namespace Ultima {
 namespace NPC {
     class NPCEntity;
+    class NPCManager;
     namespace Dialogue {
         class HybridDialogueEngine;
         struct HybridDialogueResult;
     }
+    namespace LLM {
+        class DialogueService;
+        struct NPCContext;
+    }
     namespace Persona {
         class NPCPersona;
     }
@@ -99,6 +107,7 @@ struct BehaviorSuggestion {
     Type type;
     int scheduleType;              // For CHANGE_SCHEDULE
     std::string targetId;          // For INTERACT/APPROACH
+    const void* target = nullptr;  // The Exult object, if from a snapshot
     std::string message;           // For SPEAK_SPONTANEOUS
     std::string customAction;      // For CUSTOM_ACTION
     float confidence;
@@ -120,19 +129,53 @@ public:
     bool isInitialized() const { return initialized_; }
     
     // NPC Registration
+    // Profile IDs must be unique among registered NPCs
     bool registerNPC(Actor* actor, const NPCProfile& profile);
     bool unregisterNPC(Actor* actor);
     bool isRegistered(Actor* actor) const;
     
-    // Get the cognitive entity for an actor
+    /**
+     * Get the cognitive entity for an actor, activating it if need be.
+     * Activating one NPC may evict another, so don't keep the pointer.
+     * The const one only finds NPCs that are already active.
+     */
     NPC::NPCEntity* getCognitiveNPC(Actor* actor);
     const NPC::NPCEntity* getCognitiveNPC(Actor* actor) const;
     
+    // Activation
+    //
+    // Registered NPCs are kept as their profile, or as an archive once
+    // they have run, and only built into a full cognitive NPC when near
+    // the avatar, in conversation, or otherwise asked for. When the
+    // active ones take more than the resident budget, the least recently
+    // used of those no longer near or talking are archived again. Active
+    // NPCs are updated by tick(); inactive ones catch up when activated.
+    
+    /**
+     * Set how many superchunks from the avatar NPCs are activated
+     */
+    void setActivationDistance(int superchunks);
+    int getActivationDistance() const { return activationTiles_ / 256; }
+    
+    /**
+     * Set how much memory active NPCs may take, in kilobytes
+     */
+    void setResidentBudget(size_t kilobytes);
+    
+    bool isActive(Actor* actor) const;
+    size_t getActiveCount() const { return activeOrder_.size(); }
+    size_t getResidentBytes() const { return residentBytes_; }
+    
     // Dialogue Integration
     
     /**
      * Process player input and generate NPC response
      * Called when player speaks to an NPC
+     *
+     * With the LLM enabled, this answers at once from the AIML patterns.
+     * If they had no good answer, the LLM is asked in the background, and
+     * its reply goes to the dialogue callback from updateDialogue() if it
+     * is ready before the LLM deadline and the conversation is still on.
      */
     std::string processDialogue(
         Actor* npc,
@@ -172,6 +215,35 @@ public:
         const std::vector<std::string>& nearbyNPCs
     );
     
+    /**
+     * Ask for a behavior suggestion without waiting for it; it is worked
+     * out, with the others asked for, in the next tick()
+     */
+    void requestBehavior(
+        Actor* npc,
+        int currentSchedule,
+        const std::vector<std::string>& nearbyObjects,
+        const std::vector<std::string>& nearbyNPCs
+    );
+    
+    /**
+     * Likewise, choosing from what the NPC sees in a region of the
+     * perception snapshot as it is at the next tick. Only the names of
+     * objects in regions asked about are looked up.
+     */
+    void requestBehavior(Actor* npc, int currentSchedule, int region);
+    
+    /**
+     * What NPCs can see, by region: refilled by the game just before
+     * each tick()
+     */
+    PerceptionSnapshot& getPerception() { return perception_; }
+    
+    struct QueuedBehavior {
+        Actor* npc;
+        BehaviorSuggestion suggestion;
+    };
+    
     /**
      * Notify the AI of an event affecting an NPC
      */
@@ -182,9 +254,27 @@ public:
     );
     
     /**
-     * Update NPC state (called each game tick)
+     * Advance the active cognitive NPCs to this game time, in seconds
+     * (called once per game clock tick from the main loop)
+     *
+     * The NPCs are updated together on the job system's threads, those
+     * far from the avatar and not in conversation less often, as are the
+     * behavior requests since the last tick.
+     * @return The suggestions asked for, to apply on the main thread
+     */
+    std::vector<QueuedBehavior> tick(double gameTime);
+    
+    /**
+     * Tell the bridge how far an NPC is from the avatar, in tiles,
+     * activating it if that is within the activation distance
+     */
+    void setAvatarDistance(Actor* npc, int tiles);
+    
+    /**
+     * Pass on LLM replies that are ready (called each game tick)
+     * @param budgetMs Time to spend at most, leaving the rest for later
      */
-    void update(Actor* npc, double deltaTime);
+    void updateDialogue(double budgetMs = 1.0);
     
     // Relationship System
     
@@ -198,6 +288,11 @@ public:
      */
     void modifyRelationship(Actor* npc1, Actor* npc2, float delta);
     
+    /**
+     * Rebuild an NPC's dialogue prompt after changing its persona
+     */
+    void invalidatePrompt(Actor* npc);
+    
     // Memory System
     
     /**
@@ -254,6 +349,11 @@ public:
      */
     void setLLMFallbackEnabled(bool enabled);
     
+    /**
+     * Set how long an LLM reply may take to replace the AIML answer
+     */
+    void setLLMDeadline(int milliseconds);
+    
     // Callbacks for Exult integration
     using DialogueCallback = std::function<void(const std::string&)>;
     using BehaviorCallback = std::function<void(const BehaviorSuggestion&)>;
@@ -269,8 +369,35 @@ private:
     
     bool initialized_ = false;
     
-    // Actor ID to NPCEntity mapping
-    std::map<int, std::unique_ptr<NPC::NPCEntity>> cognitiveNPCs_;
+    // A registered NPC, in full while active
+    struct Resident {
+        NPCProfile profile;
+        std::string archive;                     // Saved state, once evicted
+        NPC::NPCEntity* entity = nullptr;        // In manager_, while active
+        double inactiveSince = 0.0;              // Game time
+        double importance = 1.0;
+        size_t bytes = 0;                        // Charged while active
+        std::list<int>::iterator used;           // Place in activeOrder_
+        
+        // Who the NPC is, for dialogue prompts; built when first needed
+        // and kept until its persona or relationships change
+        std::shared_ptr<const NPC::LLM::NPCContext> prompt;
+    };
+    
+    // Registered NPCs, by actor ID
+    std::map<int, Resident> residents_;
+    std::map<std::string, int> profileIds_;
+    int nextActorId_ = 1;
+    
+    // Updates the active NPCs, which it owns while they are active
+    std::unique_ptr<NPC::NPCManager> manager_;
+    double gameTime_ = -1.0;                     // At the last tick
+    
+    // Active actor IDs, most recently used first
+    std::list<int> activeOrder_;
+    size_t residentBytes_ = 0;
+    size_t residentBudget_ = 16 * 1024 * 1024;
+    int activationTiles_ = 2 * 256;              // 2 superchunks
     
     // Actor pointer to ID mapping
     std::map<Actor*, int> actorToId_;
@@ -278,13 +405,34 @@ private:
     // Dialogue engine
     std::unique_ptr<NPC::Dialogue::HybridDialogueEngine> dialogueEngine_;
     
+    // Generates LLM replies in the background, started when first needed
+    std::unique_ptr<NPC::LLM::DialogueService> dialogueService_;
+    
     // Active conversations
     std::map<int, DialogueContext> activeConversations_;
     
+    // Update level of detail, by actor ID
+    std::map<int, int> avatarDistances_;
+    
+    // Behavior asked for since the last tick
+    struct BehaviorRequest {
+        int actorId;
+        Actor* npc;
+        int currentSchedule;
+        int region;                             // Or -1 for the names below
+        std::vector<std::string> nearbyObjects;
+        std::vector<std::string> nearbyNPCs;
+    };
+    std::vector<BehaviorRequest> behaviorRequests_;
+    
+    PerceptionSnapshot perception_;
+    
     // Configuration
     std::string llmModelPath_;
     std::string aimlPatternsPath_;
     bool llmFallbackEnabled_ = true;
+    int llmDeadlineMs_ = 3000;
+    float aimlConfidenceThreshold_ = 0.6f;
     
     // Callbacks
     DialogueCallback dialogueCallback_;
@@ -295,7 +443,13 @@ public:
     int getActorId(Actor* actor) const;
     
 private:
-    std::string buildPromptContext(Actor* npc, const DialogueContext& context);
+    NPC::NPCEntity* activate(int actorId);
+    void evict(int actorId);
+    void evictToBudget(int keepId);
+    bool isWanted(int actorId) const;
+    void updateImportance(int actorId);
+    bool startDialogueService();
+    NPC::LLM::NPCContext buildPromptContext(Resident& resident, const DialogueContext& context);
     BehaviorSuggestion convertDecisionToBehavior(
         const NPC::NPCEntity* entity,
         int currentSchedule
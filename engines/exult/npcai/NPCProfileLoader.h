@@ -11,6 +11,9 @@
 #define NPC_PROFILE_LOADER_H
 
 #include "ExultNPCBridge.h"
+#include "ScheduleIntegration.h"
+#include "PerceptionBuilder.h"
+#include "Configuration.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -113,12 +116,18 @@ public:
     static bool isInitialized();
 
     /**
-     * Update all cognitive NPCs (call each game tick)
+     * Pass on dialogue that is ready (call each frame)
      *
      * @param deltaTime Time since last update in seconds
      */
     static void update(double deltaTime);
 
+    /**
+     * Advance the cognitive NPCs to this game time, in seconds, and apply
+     * the behavior suggestions they come up with (call each game clock tick)
+     */
+    static void tick(double gameTime);
+
     /**
      * Get statistics about the NPC AI system
      */
@@ -391,6 +400,25 @@ inline bool NPCAIInitializer::initialize(const std::string& dataDirectory, const
     bridge.setAIMLPatternsPath(dataDirectory + "/aiml");
     bridge.setLLMModelPath(dataDirectory + "/models/tiny_llm.bin");
 
+    // Cognitive NPCs are built within this many superchunks of the avatar
+    int activationDistance;
+    config->value("config/npcai/activation_distance", activationDistance, 2);
+    if (activationDistance < 0) {
+        activationDistance = 0;
+    }
+    config->set("config/npcai/activation_distance", activationDistance, false);
+    bridge.setActivationDistance(activationDistance);
+    // Memory for active cognitive NPCs, in KB
+    int residentMemory;
+    config->value("config/npcai/resident_memory", residentMemory, 16384);
+    if (residentMemory < 0) {
+        residentMemory = 0;
+    }
+    config->set("config/npcai/resident_memory", residentMemory, false);
+    bridge.setResidentBudget(static_cast<size_t>(residentMemory));
+
+    bridge.getPerception().setNameResolver(PerceptionBuilder::nameOf);
+
     // Load NPC profiles if provided
     if (!profilesPath.empty()) {
         auto profiles = NPCProfileLoader::loadFromFile(profilesPath);
@@ -415,8 +443,18 @@ inline bool NPCAIInitializer::isInitialized() {
 inline void NPCAIInitializer::update(double deltaTime) {
     if (!initialized_) return;
 
-    // The bridge handles individual NPC updates
+    // The NPCs themselves are updated by tick()
     // This is called from Exult's main game loop
+    ExultNPCBridge::getInstance().updateDialogue();
+}
+
+inline void NPCAIInitializer::tick(double gameTime) {
+    if (!initialized_) return;
+
+    // Looked at by the behavior requests since the last tick
+    ExultNPCBridge& bridge = ExultNPCBridge::getInstance();
+    PerceptionBuilder::build(bridge.getPerception(), bridge.getActivationDistance());
+    AIScheduleManager::getInstance().applySuggestions(bridge.tick(gameTime));
 }
 
 inline NPCAIInitializer::Stats NPCAIInitializer::getStats() {
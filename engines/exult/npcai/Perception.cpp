@@ -0,0 +1,61 @@
+/**
+ * Perception.cpp - Per-tick snapshots of what cognitive NPCs can see
+ */
+
+#include "Perception.h"
+
+namespace Ultima {
+namespace Exult {
+
+void PerceptionSnapshot::clear() {
+    objects_.clear();
+    regions_.clear();
+    currentRegion_ = -1;
+    actorNames_.clear();
+    itemNames_.clear();
+}
+
+void PerceptionSnapshot::beginRegion(int region) {
+    if (currentRegion_ >= 0) {
+        regions_[currentRegion_].count = objects_.size() - regions_[currentRegion_].first;
+    }
+    currentRegion_ = region;
+    regions_[region] = {objects_.size(), 0};
+}
+
+PerceptionView PerceptionSnapshot::region(int region) const {
+    auto it = regions_.find(region);
+    if (it == regions_.end()) {
+        return PerceptionView();
+    }
+    // The region being added runs to the end so far
+    const size_t count = region == currentRegion_ ?
+        objects_.size() - it->second.first : it->second.count;
+    return PerceptionView(objects_.data() + it->second.first, count);
+}
+
+const std::string& PerceptionSnapshot::nameOf(const PerceivedObject& object) {
+    if (object.flags & PerceivedObject::IS_ACTOR) {
+        auto it = actorNames_.find(object.object);
+        if (it != actorNames_.end()) {
+            return it->second;
+        }
+        return actorNames_[object.object] = resolver_ ? resolver_(object) : std::string();
+    }
+
+    const uint32_t key = (static_cast<uint32_t>(object.shape) << 8) | object.frame;
+    auto it = itemNames_.find(key);
+    if (it != itemNames_.end()) {
+        return it->second;
+    }
+    return itemNames_[key] = resolver_ ? resolver_(object) : std::string();
+}
+
+void PerceptionSnapshot::resolveNames(PerceptionView view) {
+    for (const auto& object : view) {
+        nameOf(object);
+    }
+}
+
+} // namespace Exult
+} // namespace Ultima
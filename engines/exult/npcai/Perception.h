@@ -0,0 +1,125 @@
+/**
+ * Perception.h - What cognitive NPCs can see, gathered once per tick
+ *
+ * Rather than each NPC asking for the names of the objects around it,
+ * the objects of each active region (a superchunk) are gathered once per
+ * tick into a compact array, and every NPC in the region is handed a
+ * view of it. Names are only looked up when something needs them, and
+ * then once per snapshot.
+ *
+ * Part of the Ultima Integration Project
+ */
+
+#ifndef EXULT_NPC_PERCEPTION_H
+#define EXULT_NPC_PERCEPTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Ultima {
+namespace Exult {
+
+/**
+ * PerceivedObject - One object in a snapshot
+ */
+struct PerceivedObject {
+    enum Flags : uint8_t {
+        IS_ACTOR = 1,
+        IS_MONSTER = 2,
+        IS_CONTAINER = 4
+    };
+
+    const void* object;     // The Exult object (the Actor for actors)
+    uint16_t shape;
+    uint8_t frame;
+    uint8_t flags;
+    uint16_t tx, ty;        // Absolute tile
+};
+
+/**
+ * PerceptionView - The objects of one region, borrowed from a snapshot
+ * and valid until it is next cleared
+ */
+class PerceptionView {
+public:
+    PerceptionView() = default;
+    PerceptionView(const PerceivedObject* first, size_t count)
+        : first_(first), count_(count) {}
+
+    const PerceivedObject* begin() const { return first_; }
+    const PerceivedObject* end() const { return first_ + count_; }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    const PerceivedObject& operator[](size_t i) const { return first_[i]; }
+
+private:
+    const PerceivedObject* first_ = nullptr;
+    size_t count_ = 0;
+};
+
+/**
+ * PerceptionSnapshot - The objects of the active regions this tick
+ */
+class PerceptionSnapshot {
+public:
+    using NameResolver = std::function<std::string(const PerceivedObject&)>;
+
+    /**
+     * Set how names are looked up; called on the main thread only
+     */
+    void setNameResolver(NameResolver resolver) { resolver_ = std::move(resolver); }
+
+    /**
+     * Start again for a new tick, invalidating all views
+     */
+    void clear();
+
+    /**
+     * Add a region's objects; each region is added in one go
+     */
+    void beginRegion(int region);
+    void add(const PerceivedObject& object) { objects_.push_back(object); }
+
+    /**
+     * The objects of a region, empty if it wasn't added
+     */
+    PerceptionView region(int region) const;
+
+    size_t size() const { return objects_.size(); }
+
+    /**
+     * An object's name, looked up the first time it is asked for. Items
+     * of one shape and frame share a name; actors each have their own.
+     * Main thread only, unless resolveNames() has covered the object.
+     */
+    const std::string& nameOf(const PerceivedObject& object);
+
+    /**
+     * Look up the names of a view's objects ahead of reading them from
+     * other threads
+     */
+    void resolveNames(PerceptionView view);
+
+private:
+    struct Range {
+        size_t first;
+        size_t count;
+    };
+
+    std::vector<PerceivedObject> objects_;
+    std::unordered_map<int, Range> regions_;
+    int currentRegion_ = -1;
+
+    NameResolver resolver_;
+    std::unordered_map<const void*, std::string> actorNames_;
+    std::unordered_map<uint32_t, std::string> itemNames_;   // By shape and frame
+};
+
+} // namespace Exult
+} // namespace Ultima
+
+#endif // EXULT_NPC_PERCEPTION_H
@@ -0,0 +1,117 @@
+/**
+ * PerceptionBuilder.h - Fill the bridge's perception snapshot from the map
+ *
+ * Reads Exult's chunk lists directly, so, like NPCProfileLoader.h, this
+ * is only compiled into Exult itself.
+ *
+ * Part of the Ultima Integration Project
+ */
+
+#ifndef EXULT_NPC_PERCEPTION_BUILDER_H
+#define EXULT_NPC_PERCEPTION_BUILDER_H
+
+#include "ExultNPCBridge.h"
+#include "Perception.h"
+#include "actors.h"
+#include "chunks.h"
+#include "gamemap.h"
+#include "gamewin.h"
+#include "objiter.h"
+
+#include <algorithm>
+
+namespace Ultima {
+namespace Exult {
+
+/**
+ * PerceptionBuilder - Gathers the objects around the avatar once per tick
+ */
+class PerceptionBuilder {
+public:
+    /**
+     * The region, a superchunk, a tile is in
+     */
+    static int regionAt(int tx, int ty) {
+        return (ty / c_tiles_per_schunk) * c_num_schunks + tx / c_tiles_per_schunk;
+    }
+
+    /**
+     * Refill the snapshot with the superchunks within this many of the
+     * avatar's. Only chunks already read in are looked at, and flat
+     * objects are left out.
+     */
+    static void build(PerceptionSnapshot& snapshot, int superchunks);
+
+    /**
+     * What an NPC sees: its region of the snapshot
+     */
+    static PerceptionView viewFor(const PerceptionSnapshot& snapshot, Actor* npc) {
+        const Tile_coord pos = npc->get_tile();
+        return snapshot.region(regionAt(pos.tx, pos.ty));
+    }
+
+    /**
+     * Name of a snapshot's object, for PerceptionSnapshot::setNameResolver()
+     */
+    static std::string nameOf(const PerceivedObject& object) {
+        if (object.flags & PerceivedObject::IS_ACTOR) {
+            return static_cast<const Actor*>(object.object)->get_name();
+        }
+        return static_cast<const Game_object*>(object.object)->get_name();
+    }
+};
+
+inline void PerceptionBuilder::build(PerceptionSnapshot& snapshot, int superchunks) {
+    snapshot.clear();
+
+    Game_window* gwin = Game_window::get_instance();
+    Main_actor* avatar = gwin->get_main_actor();
+    if (!avatar) return;
+
+    Game_map* gmap = gwin->get_map();
+    const Tile_coord pos = avatar->get_tile();
+    const int sx = pos.tx / c_tiles_per_schunk;
+    const int sy = pos.ty / c_tiles_per_schunk;
+    for (int y = std::max(0, sy - superchunks);
+         y <= std::min(c_num_schunks - 1, sy + superchunks); ++y) {
+        for (int x = std::max(0, sx - superchunks);
+             x <= std::min(c_num_schunks - 1, sx + superchunks); ++x) {
+            snapshot.beginRegion(y * c_num_schunks + x);
+            for (int cy = y * c_chunks_per_schunk; cy < (y + 1) * c_chunks_per_schunk; ++cy) {
+                for (int cx = x * c_chunks_per_schunk; cx < (x + 1) * c_chunks_per_schunk; ++cx) {
+                    Map_chunk* chunk = gmap->get_chunk_unsafe(cx, cy);
+                    if (!chunk || !chunk->get_first_nonflat()) continue;
+
+                    // Flat objects come first
+                    bool flat = true;
+                    Game_object* obj;
+                    Object_iterator next(chunk->get_objects());
+                    while ((obj = next.get_next()) != nullptr) {
+                        flat = flat && obj != chunk->get_first_nonflat();
+                        if (flat || obj->is_egg()) continue;
+
+                        const Actor* actor = obj->as_actor();
+                        const Tile_coord tile = obj->get_tile();
+                        PerceivedObject seen;
+                        seen.object = actor ? static_cast<const void*>(actor)
+                                            : static_cast<const void*>(obj);
+                        seen.shape = static_cast<uint16_t>(obj->get_shapenum());
+                        seen.frame = static_cast<uint8_t>(obj->get_framenum());
+                        seen.flags = 0;
+                        if (actor) seen.flags |= PerceivedObject::IS_ACTOR;
+                        if (obj->is_monster()) seen.flags |= PerceivedObject::IS_MONSTER;
+                        if (obj->as_container() && !actor) seen.flags |= PerceivedObject::IS_CONTAINER;
+                        seen.tx = static_cast<uint16_t>(tile.tx);
+                        seen.ty = static_cast<uint16_t>(tile.ty);
+                        snapshot.add(seen);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace Exult
+} // namespace Ultima
+
+#endif // EXULT_NPC_PERCEPTION_BUILDER_H
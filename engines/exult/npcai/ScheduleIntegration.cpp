@@ -5,14 +5,22 @@
 #include "ScheduleIntegration.h"
 #include "ExultNPCBridge.h"
 #include "../../npc/include/NPCSystem.h"
+#include "Async_log.h"
 
 #include <algorithm>
-#include <iostream>
 #include <cmath>
 
 namespace Ultima {
 namespace Exult {
 
+namespace {
+
+// Speech comes with every schedule decision, so it is a debug message
+Log_category scheduleLog("AIScheduleManager", Log_level::Info, 20);
+Log_category behaviorLog("BehaviorIntegration");
+
+} // namespace
+
 // ScheduleHooks implementation
 
 ScheduleHooks& ScheduleHooks::getInstance() {
@@ -116,7 +124,7 @@ bool AIScheduleManager::initialize() {
     });
     
     active_ = true;
-    std::cout << "[AIScheduleManager] Initialized successfully" << std::endl;
+    ULTIMA_LOG(scheduleLog, Info) << "Initialized successfully";
     return true;
 }
 
@@ -134,10 +142,11 @@ void AIScheduleManager::shutdown() {
     
     // Clear data
     customBehaviors_.clear();
+    suggestionHandler_ = nullptr;
     npcData_.clear();
     
     active_ = false;
-    std::cout << "[AIScheduleManager] Shutdown complete" << std::endl;
+    ULTIMA_LOG(scheduleLog, Info) << "Shutdown complete";
 }
 
 void AIScheduleManager::setEnabled(bool enabled) {
@@ -163,7 +172,7 @@ bool AIScheduleManager::processNowWhat(Actor* npc, const AIScheduleContext& cont
     // Handle spontaneous speech
     if (decision.shouldSpeak && !decision.speechText.empty()) {
         // Would call Exult's item_say here
-        std::cout << "[AIScheduleManager] NPC says: " << decision.speechText << std::endl;
+        ULTIMA_LOG(scheduleLog, Debug) << "NPC says: " << decision.speechText;
     }
     
     // Handle custom behavior
@@ -283,6 +292,24 @@ void AIScheduleManager::registerCustomBehavior(
     customBehaviors_[schedule] = std::move(behavior);
 }
 
+void AIScheduleManager::setSuggestionHandler(SuggestionHandler handler) {
+    suggestionHandler_ = std::move(handler);
+}
+
+void AIScheduleManager::applySuggestions(
+    const std::vector<ExultNPCBridge::QueuedBehavior>& suggestions
+) {
+    if (!active_ || !enabled_ || !suggestionHandler_) {
+        return;
+    }
+    
+    for (const auto& queued : suggestions) {
+        if (queued.suggestion.type != BehaviorSuggestion::Type::CONTINUE_CURRENT) {
+            suggestionHandler_(queued.npc, queued.suggestion);
+        }
+    }
+}
+
 void AIScheduleManager::setSchedulePriorities(
     Actor* npc,
     const std::map<ScheduleType, float>& priorities
@@ -444,7 +471,7 @@ bool BehaviorIntegration::initialize() {
     }
     
     active_ = true;
-    std::cout << "[BehaviorIntegration] Initialized successfully" << std::endl;
+    ULTIMA_LOG(behaviorLog, Info) << "Initialized successfully";
     return true;
 }
 
@@ -457,7 +484,7 @@ void BehaviorIntegration::shutdown() {
     interactionCooldowns_.clear();
     
     active_ = false;
-    std::cout << "[BehaviorIntegration] Shutdown complete" << std::endl;
+    ULTIMA_LOG(behaviorLog, Info) << "Shutdown complete";
 }
 
 void BehaviorIntegration::processBehavior(Actor* npc, double deltaTime) {
@@ -474,9 +501,7 @@ void BehaviorIntegration::processBehavior(Actor* npc, double deltaTime) {
         }
     }
     
-    // Update NPC through the bridge
-    auto& bridge = ExultNPCBridge::getInstance();
-    bridge.update(npc, deltaTime);
+    // The NPC's own update is in ExultNPCBridge::tick()
 }
 
 void BehaviorIntegration::handleEvent(
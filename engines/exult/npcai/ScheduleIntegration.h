@@ -14,6 +14,8 @@
 #include <memory>
 #include <functional>
 
+#include "ExultNPCBridge.h"
+
 // Forward declarations
 class Actor;
 class Schedule;
@@ -199,6 +201,18 @@ public:
     using CustomScheduleBehavior = std::function<void(Actor*, const AIScheduleContext&)>;
     void registerCustomBehavior(ScheduleType schedule, CustomScheduleBehavior behavior);
     
+    /**
+     * Set what carries out behavior suggestions for an NPC
+     */
+    using SuggestionHandler = std::function<void(Actor*, const BehaviorSuggestion&)>;
+    void setSuggestionHandler(SuggestionHandler handler);
+    
+    /**
+     * Carry out the suggestions from ExultNPCBridge::tick() on the main
+     * thread, skipping those to carry on as before
+     */
+    void applySuggestions(const std::vector<ExultNPCBridge::QueuedBehavior>& suggestions);
+    
     /**
      * Set schedule priorities for an NPC
      * Higher priority schedules are preferred when multiple are valid
@@ -236,6 +250,7 @@ private:
     
     // Custom behaviors per schedule type
     std::map<ScheduleType, CustomScheduleBehavior> customBehaviors_;
+    SuggestionHandler suggestionHandler_;
     
     // Per-NPC data
     struct NPCScheduleData {
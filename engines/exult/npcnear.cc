@@ -55,11 +55,14 @@ using std::rand;
 
 bool Bg_dont_wake(Game_window* gwin, Actor* npc);
 
+// Most time to spend checking NPCs each tick (msecs).  The rest wait.
+constexpr const int c_max_check_msecs = 2;
+
 /*
- *  Add an npc to the time queue.
+ *  Get a random time for an npc to be checked next.
  */
 
-void Npc_proximity_handler::add(
+unsigned long Npc_proximity_handler::get_due(
 		unsigned long curtime,    // Current time (msecs).
 		Npc_actor*    npc,
 		int           additional_ticks    // More secs. to wait.
@@ -70,9 +73,39 @@ void Npc_proximity_handler::add(
 	} else {    // Wait between 2 & 6 secs.
 		msecs = (rand() % 4000) + 2000;
 	}
-	unsigned long newtime = curtime + (msecs * gwin->get_std_delay() / 100);
-	newtime += additional_ticks * gwin->get_std_delay();
-	gwin->get_tqueue()->add(newtime, this, npc);
+	const unsigned long newtime
+			= curtime + (msecs * gwin->get_std_delay() / 100);
+	return newtime + additional_ticks * gwin->get_std_delay();
+}
+
+/*
+ *  Add an npc to the list.
+ */
+
+void Npc_proximity_handler::add(
+		unsigned long curtime,    // Current time (msecs).
+		Npc_actor*    npc,
+		int           additional_ticks    // More secs. to wait.
+) {
+	npc->set_nearby_index(npcs.size());
+	npcs.push_back({npc, get_due(curtime, npc, additional_ticks)});
+	if (!in_queue()) {
+		gwin->get_tqueue()->add(curtime + gwin->get_std_delay(), this);
+	}
+}
+
+/*
+ *  Remove the npc at a given index, moving the last one there.
+ */
+
+void Npc_proximity_handler::remove_at(size_t i) {
+	npcs[i].npc->clear_nearby();
+	npcs[i].npc->set_nearby_index(-1);
+	if (i + 1 < npcs.size()) {
+		npcs[i] = npcs.back();
+		npcs[i].npc->set_nearby_index(i);
+	}
+	npcs.pop_back();
 }
 
 /*
@@ -80,8 +113,27 @@ void Npc_proximity_handler::add(
  */
 
 void Npc_proximity_handler::remove(Npc_actor* npc) {
-	npc->clear_nearby();
-	gwin->get_tqueue()->remove(this, npc);
+	const int i = npc->get_nearby_index();
+	if (i >= 0 && static_cast<size_t>(i) < npcs.size()
+		&& npcs[i].npc == npc) {
+		remove_at(i);
+	} else {
+		npc->clear_nearby();
+	}
+}
+
+/*
+ *  Remove all npcs, as when the world is cleared.
+ */
+
+void Npc_proximity_handler::clear() {
+	for (auto& each : npcs) {
+		each.npc->clear_nearby();
+		each.npc->set_nearby_index(-1);
+	}
+	npcs.clear();
+	next = 0;
+	gwin->get_tqueue()->remove(this);
 }
 
 /*
@@ -98,21 +150,53 @@ bool Bg_dont_wake(Game_window* gwin, Actor* npc) {
 }
 
 /*
- *  Run proximity usecode function for the NPC now.
+ *  Check the NPCs whose times have come, starting where we left off, for
+ *  as long as we're allowed.
  */
 
 void Npc_proximity_handler::handle_event(unsigned long curtime, uintptr udata) {
-	auto* npc         = reinterpret_cast<Npc_actor*>(udata);
-	int   extra_delay = 5;    // For next time.
-							  // See if still on visible screen.
+	ignore_unused_variable_warning(udata);
+	const uint32 stop = SDL_GetTicks() + c_max_check_msecs;
+	size_t       cnt  = npcs.size();
+	while (cnt-- && !npcs.empty()) {
+		if (next >= npcs.size()) {
+			next = 0;
+		}
+		if (npcs[next].due > curtime) {
+			next++;
+		} else if (check(curtime, next)) {
+			next++;    // (Else it was removed, and another is there.)
+			if (SDL_GetTicks() >= stop) {
+				break;
+			}
+		}
+	}
+	if (!npcs.empty()) {
+		gwin->get_tqueue()->add(curtime + gwin->get_std_delay(), this);
+	}
+}
+
+/*
+ *  Run proximity usecode function for an NPC now.
+ *
+ *  Output: false if it was removed.
+ */
+
+bool Npc_proximity_handler::check(
+		unsigned long curtime,    // Current time (msecs).
+		size_t        i           // Index in npcs.
+) {
+	Npc_actor* npc         = npcs[i].npc;
+	int        extra_delay = 5;    // For next time.
+								   // See if still on visible screen.
 	const TileRect   tiles = gwin->get_win_tile_rect().enlarge(10);
 	const Tile_coord t     = npc->get_tile();
 	if (!tiles.has_world_point(t.tx, t.ty) ||    // No longer visible?
 												 // Not on current map?
 		npc->get_map() != gwin->get_map()
 		|| npc->is_dead()) {    // Or no longer living?
-		npc->clear_nearby();
-		return;
+		remove_at(i);
+		return false;
 	}
 	auto sched
 			= static_cast<Schedule::Schedule_types>(npc->get_schedule_type());
@@ -134,7 +218,12 @@ void Npc_proximity_handler::handle_event(unsigned long curtime, uintptr udata) {
 		npc->start(0, 10000);
 		extra_delay = 11;    // And don't run Usecode while up.
 	}
-	add(curtime, npc, extra_delay);    // Add back for next time.
+	// The list may have changed.
+	const int idx = npc->get_nearby_index();
+	if (idx >= 0) {
+		npcs[idx].due = get_due(curtime, npc, extra_delay);
+	}
+	return idx == static_cast<int>(i);
 }
 
 /*
@@ -155,10 +244,7 @@ void Npc_proximity_handler::wait(int secs    // # of seconds.
 void Npc_proximity_handler::get_all(
 		Actor_vector& alist    // They're appended to this.
 ) {
-	Time_queue_iterator next(gwin->get_tqueue(), this);
-	Time_sensitive*     obj;
-	uintptr             data;    // NPC is the data.
-	while (next(obj, data)) {
-		alist.push_back(reinterpret_cast<Npc_actor*>(data));
+	for (const auto& each : npcs) {
+		alist.push_back(each.npc);
 	}
 }
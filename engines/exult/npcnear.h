@@ -24,6 +24,7 @@
 
 #include "tqueue.h"
 
+#include <cstddef>
 #include <vector>
 
 class Game_window;
@@ -32,20 +33,35 @@ class Actor;
 
 /*
  *  This class keeps track of NPC's nearby, and randomly runs the Usecode
- *  proximity functions for them.
+ *  proximity functions for them.  It's in the time queue once, and each
+ *  time goes through the NPCs whose times have come.
  */
 class Npc_proximity_handler : public Time_sensitive {
-	Game_window*  gwin;
-	unsigned long wait_until;    // Skip running usecodes until past.
+	struct Nearby_npc {
+		Npc_actor*    npc;
+		unsigned long due;    // Time to check it again.
+	};
+
+	Game_window*            gwin;
+	unsigned long           wait_until;    // Skip running usecodes until past.
+	std::vector<Nearby_npc> npcs;          // Each NPC knows its index.
+	size_t                  next = 0;      // Where to start next time.
+
+	unsigned long get_due(
+			unsigned long curtime, Npc_actor* npc, int additional_ticks);
+	void remove_at(size_t i);
+	bool check(unsigned long curtime, size_t i);
+
 public:
 	Npc_proximity_handler(Game_window* gw) : gwin(gw) {
 		wait_until = 0;
 	}
 
-	// Add npc to queue.
+	// Add npc to list.
 	void add(unsigned long curtime, Npc_actor* npc, int additional_ticks = 0);
 	void remove(Npc_actor* npc);    // Remove.
-	// Run usecode function.
+	void clear();                   // Remove all.
+	// Check the NPCs whose times have come.
 	void handle_event(unsigned long curtime, uintptr udata) override;
 	// Wait before running more funs.
 	void wait(int secs);
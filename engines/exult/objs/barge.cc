@@ -377,12 +377,16 @@ void Barge_object::finish_move(
 ) {
 	set_center();                      // Update center.
 	const int cnt = objects.size();    // We'll move each object.
-	for (int i = 0; i < cnt; i++) {    // Now add them back in new location.
-		Game_object* obj = get_object(i);
-		if (i < perm_count) {    // Restore us as owner.
-			obj->set_owner(this);
+	{
+		// Order them against the chunks all at once.
+		const Map_chunk::Group_add group;
+		for (int i = 0; i < cnt; i++) {    // Now add them back.
+			Game_object* obj = get_object(i);
+			if (i < perm_count) {    // Restore us as owner.
+				obj->set_owner(this);
+			}
+			obj->move(positions[i], newmap);
 		}
-		obj->move(positions[i], newmap);
 	}
 	delete[] positions;
 	// Check for scrolling.
@@ -45,6 +45,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ordinfo.h"
 #include "shapeinf.h"
 
+#include <algorithm>
+
 using std::rand;
 using std::vector;
 
@@ -57,8 +59,8 @@ Chunk_cache::Chunk_cache() : obj_list(nullptr), egg_objects(4), eggs{} {}
 /*
  *  This mask gives the low bits (b0) for a given # of ztiles.
  */
-unsigned long tmasks[8]
-		= {0x0L, 0x1L, 0x5L, 0x15L, 0x55L, 0x155L, 0x555L, 0x1555L};
+unsigned long tmasks[9] = {0x0L,   0x1L,   0x5L,    0x15L,  0x55L,
+						   0x155L, 0x555L, 0x1555L, 0x5555L};
 
 /*
  *  Set (actually, increment count) for a given tile.
@@ -110,6 +112,59 @@ inline void Clear_blocked_tile(
 	blocked[ty * c_tiles_per_chunk + tx] = (val & ~(mask0 | mask1)) | newval;
 }
 
+/*
+ *  Get the lifts with a count of 1 or more from a tile's blocked flags,
+ *  as bits 0-7.
+ */
+
+inline uint64 Blocked_lifts(uint16 val) {
+	unsigned bits = (val | (val >> 1)) & 0x5555u;
+	bits          = (bits | (bits >> 1)) & 0x3333u;
+	bits          = (bits | (bits >> 2)) & 0x0f0fu;
+	bits          = (bits | (bits >> 4)) & 0x00ffu;
+	return bits;
+}
+
+/*
+ *  Get the lowest/highest set bit of a non-zero word.
+ */
+
+inline int Lowest_bit(uint64 bits) {
+#if defined(__cpp_lib_bitops) && __cpp_lib_bitops >= 201907L
+	return std::countr_zero(bits);
+#elif defined(__GNUG__)
+	return __builtin_ctzll(bits);
+#else
+	int i = 0;
+	for (; !(bits & 1); bits >>= 1) {
+		i++;
+	}
+	return i;
+#endif
+}
+
+inline int Highest_bit(uint64 bits) {
+#if defined(__cpp_lib_bitops) && __cpp_lib_bitops >= 201907L
+	return 63 - std::countl_zero(bits);
+#elif defined(__GNUG__)
+	return 63 - __builtin_clzll(bits);
+#else
+	int i = -1;
+	for (; bits; bits >>= 1) {
+		i++;
+	}
+	return i;
+#endif
+}
+
+/*
+ *  Get a mask of the low 'n' bits (0-64).
+ */
+
+inline uint64 Low_bits(int n) {
+	return n >= 64 ? ~uint64(0) : (uint64(1) << n) - 1;
+}
+
 /*
  *  Create new blocked flags for a given z-level, where each level
  *  covers 8 lifts.
@@ -123,6 +178,26 @@ Chunk_cache::blocked8z& Chunk_cache::new_blocked_level(int zlevel) {
 	return blocked[zlevel];
 }
 
+/*
+ *  Copy the blocked flags of a tile at a given z-level to the bits that
+ *  are used for searching.
+ */
+
+void Chunk_cache::update_blocked_bits(int zlevel, int tx, int ty) {
+	const unsigned int group = zlevel / 8;
+	if (group >= blocked_bits.size()) {
+		blocked_bits.resize(group + 1);
+	}
+	auto& bits = blocked_bits[group];
+	if (!bits) {
+		bits = std::make_unique<uint64[]>(256);
+	}
+	const int    tile  = ty * c_tiles_per_chunk + tx;
+	const int    shift = 8 * (zlevel % 8);
+	const uint64 lifts = Blocked_lifts(blocked[zlevel][tile]);
+	bits[tile] = (bits[tile] & ~(uint64(0xff) << shift)) | (lifts << shift);
+}
+
 /*
  *  Set/unset the blocked flags in a region.
  */
@@ -144,6 +219,7 @@ void Chunk_cache::set_blocked(
 		for (int y = starty; y <= endy; y++) {
 			for (int x = startx; x <= endx; x++) {
 				Set_blocked_tile(block, x, y, thisz, zcnt);
+				update_blocked_bits(zlevel, x, y);
 			}
 		}
 		z += zcnt;
@@ -172,6 +248,7 @@ void Chunk_cache::clear_blocked(
 			for (int y = starty; y <= endy; y++) {
 				for (int x = startx; x <= endx; x++) {
 					Clear_blocked_tile(block, x, y, thisz, zcnt);
+					update_blocked_bits(zlevel, x, y);
 				}
 			}
 		}
@@ -189,7 +266,7 @@ void Chunk_cache::update_object(
 		bool add    // 1 to add, 0 to remove.
 ) {
 	ignore_unused_variable_warning(chunk);
-	const Shape_info& info = obj->get_info();
+	const Shape_hot_info& info = obj->get_hot_info();
 	if (info.is_door()) {    // Special door list.
 		if (add) {
 			doors.insert(obj);
@@ -213,8 +290,10 @@ void Chunk_cache::update_object(
 		if (add) {
 			Set_blocked_tile(
 					need_blocked_level(lift / 8), endx, endy, lift % 8, ztiles);
+			update_blocked_bits(lift / 8, endx, endy);
 		} else if (blocked[lift / 8]) {
 			Clear_blocked_tile(blocked[lift / 8], endx, endy, lift % 8, ztiles);
+			update_blocked_bits(lift / 8, endx, endy);
 		}
 		return;
 	}
@@ -261,7 +340,8 @@ void Chunk_cache::set_egged(
 				egg_objects.push_back(egg);
 			}
 		}
-		if (eggnum > 15) {    // We only have 16 bits.
+		if (eggnum >= 15) {    // We only have 16 bits.
+			add_egg_spans(eggnum, tiles);
 			eggnum = 15;
 		}
 		const short mask  = (1 << eggnum);
@@ -278,15 +358,9 @@ void Chunk_cache::set_egged(
 		}
 		egg_objects[eggnum] = nullptr;
 		if (eggnum >= 15) {    // We only have 16 bits.
-			// Last one at 15 or above?
-			for (auto it = egg_objects.begin() + 15; it != egg_objects.end();
-				 ++it) {
-				if (*it != nullptr) {
-					// No, so leave bits alone.
-					return;
-				}
-			}
-			eggnum = 15;
+			// Bit 15 is redone from what's left.
+			remove_egg_spans(eggnum);
+			return;
 		}
 		const short mask  = ~(1 << eggnum);
 		const int   stopx = tiles.x + tiles.w;
@@ -299,6 +373,89 @@ void Chunk_cache::set_egged(
 	}
 }
 
+/*
+ *  Record the rows of a rectangle within the influence of an egg that
+ *  doesn't get its own bit.
+ */
+
+void Chunk_cache::add_egg_spans(
+		int             eggnum,    // Index in egg_objects, >= 15.
+		const TileRect& tiles      // Range of tiles within chunk.
+) {
+	const Egg_span span{
+			static_cast<unsigned char>(tiles.x),
+			static_cast<unsigned char>(tiles.x + tiles.w - 1),
+			static_cast<unsigned short>(eggnum)};
+	const int stopy = tiles.y + tiles.h;
+	for (int ty = tiles.y; ty < stopy; ty++) {
+		vector<Egg_span>& spans = egg_spans[ty];
+		auto              pos   = std::upper_bound(
+				   spans.begin(), spans.end(), span,
+				   [](const Egg_span& a, const Egg_span& b) {
+					   return a.startx < b.startx;
+				   });
+		spans.insert(pos, span);
+	}
+}
+
+/*
+ *  Forget all the spans of an egg that didn't get its own bit, and redo
+ *  bit 15 of the tiles it influenced from the eggs that are left.
+ */
+
+void Chunk_cache::remove_egg_spans(int eggnum) {
+	for (int ty = 0; ty < c_tiles_per_chunk; ty++) {
+		vector<Egg_span>& spans = egg_spans[ty];
+		unsigned          row   = 0;    // Tiles of this row to redo.
+		auto              it    = spans.begin();
+		while (it != spans.end()) {
+			if (it->eggnum == eggnum) {
+				row |= ((2u << it->endx) - 1) & ~((1u << it->startx) - 1);
+				it = spans.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if (!row) {
+			continue;
+		}
+		unsigned short* rowbits = &eggs[ty * c_tiles_per_chunk];
+		for (int tx = 0; tx < c_tiles_per_chunk; tx++) {
+			if (row & (1u << tx)) {
+				rowbits[tx] &= ~(1 << 15);
+			}
+		}
+		for (const auto& span : spans) {
+			for (int tx = span.startx; tx <= span.endx; tx++) {
+				rowbits[tx] |= 1 << 15;
+			}
+		}
+	}
+}
+
+/*
+ *  Find the eggs that didn't get their own bit whose influence includes
+ *  a tile.
+ */
+
+void Chunk_cache::find_egg_spans(
+		int tx, int ty,    // Tile within chunk.
+		vector<unsigned short>& found    // Eggnums returned, in order.
+) {
+	const vector<Egg_span>& spans = egg_spans[ty];
+	for (const auto& span : spans) {
+		if (span.startx > tx) {
+			break;    // Sorted, so none of the rest can have it.
+		}
+		if (span.endx >= tx) {
+			found.push_back(span.eggnum);
+		}
+	}
+	// An egg can have more than one span (its perimeter).
+	std::sort(found.begin(), found.end());
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+}
+
 /*
  *  Add/remove an egg to the cache.
  */
@@ -366,38 +523,47 @@ void Chunk_cache::setup(Map_chunk* chunk) {
 	obj_list = chunk;
 }
 
-//	Temp. storage for 'blocked' flags for a single tile.
-static uint16 tflags[256 / 8];
+//	Temp. storage for 'blocked' bits for a single tile.
+static uint64 tflags[256 / 64];
 static int    tflags_maxz;
-//	Test for given z-coord. (lift)
-#define TEST_TFLAGS(i) (tflags[(i) / 8] & (3 << (2 * ((i) % 8))))
 
 inline void Chunk_cache::set_tflags(int tx, int ty, int maxz) {
-	int       zlevel = maxz / 8;
-	const int bsize  = blocked.size();
-	if (zlevel >= bsize) {
-		memset(tflags + bsize, 0, (zlevel - bsize + 1) * sizeof(uint16));
-		zlevel = bsize - 1;
+	if (maxz > 255) {
+		maxz = 255;
 	}
-	while (zlevel >= 0) {
-		auto& block      = blocked[zlevel];
-		tflags[zlevel--] = block ? block[ty * c_tiles_per_chunk + tx] : 0;
+	const int      tile  = ty * c_tiles_per_chunk + tx;
+	const unsigned words = maxz / 64 + 1;
+	for (unsigned w = 0; w < words; w++) {
+		tflags[w] = w < blocked_bits.size() && blocked_bits[w]
+							? blocked_bits[w][tile]
+							: 0;
 	}
 	tflags_maxz = maxz;
 }
 
 /*
- *  Get highest blocked lift below a given level for a given tile.
+ *  Get highest blocked lift below a given level, given a tile's 'blocked'
+ *  bits up to maxz.
  *
  *  Output: Highest lift that's blocked by an object, or -1 if none.
  */
 
-inline int Chunk_cache::get_highest_blocked(int lift    // Look below this lift.
+static inline int Get_highest_blocked(
+		const uint64* bits, int maxz,
+		int lift    // Look below this lift.
 ) {
-	int i;    // Look downwards.
-	for (i = lift - 1; i >= 0 && !TEST_TFLAGS(i); i--)
-		;
-	return i;
+	// Look downwards.
+	const int top = std::min(lift - 1, maxz);
+	for (int w = top >= 0 ? top / 64 : -1; w >= 0; w--) {
+		uint64 b = bits[w];
+		if (w == top / 64) {
+			b &= Low_bits(top % 64 + 1);
+		}
+		if (b) {
+			return w * 64 + Highest_bit(b);
+		}
+	}
+	return -1;
 }
 
 /*
@@ -411,24 +577,29 @@ int Chunk_cache::get_highest_blocked(
 		int tx, int ty    // Square to test.
 ) {
 	set_tflags(tx, ty, lift);
-	return get_highest_blocked(lift);
+	return Get_highest_blocked(tflags, tflags_maxz, lift);
 }
 
 /*
- *  Get lowest blocked lift above a given level for a given tile.
+ *  Get lowest blocked lift above a given level, given a tile's 'blocked'
+ *  bits up to maxz.
  *
- *  Output: Highest lift that's blocked by an object, or -1 if none.
+ *  Output: Lowest lift that's blocked by an object, or -1 if none.
  */
 
-inline int Chunk_cache::get_lowest_blocked(int lift    // Look above this lift.
+static inline int Get_lowest_blocked(
+		const uint64* bits, int maxz,
+		int lift    // Look above this lift.
 ) {
-	int i;    // Look upward.
-	for (i = lift; i <= tflags_maxz && !TEST_TFLAGS(i); i++)
-		;
-	if (i > tflags_maxz) {
-		return -1;
+	// Look upward, a word at a time.
+	for (int i = std::max(lift, 0); i <= maxz; i = (i | 63) + 1) {
+		const int    last = std::min(i | 63, maxz);
+		const uint64 b    = (bits[i / 64] >> (i % 64)) & Low_bits(last - i + 1);
+		if (b) {
+			return i + Lowest_bit(b);
+		}
 	}
-	return i;
+	return -1;
 }
 
 /*
@@ -442,7 +613,7 @@ int Chunk_cache::get_lowest_blocked(
 		int tx, int ty    // Square to test.
 ) {
 	set_tflags(tx, ty, 255);    // FOR NOW, look up to max.
-	return get_lowest_blocked(lift);
+	return Get_lowest_blocked(tflags, tflags_maxz, lift);
 }
 
 /*
@@ -458,9 +629,10 @@ inline int Check_terrain(
 	// Sets: bit0 if land, bit1 if water,
 	int terrain = 0;
 	if (!flat.is_invalid()) {
-		if (flat.get_info().is_water()) {
+		const Shape_hot_info& info = flat.get_hot_info();
+		if (info.is_water()) {
 			terrain |= 2;
-		} else if (flat.get_info().is_solid()) {
+		} else if (info.is_solid()) {
 			terrain |= 4;
 		} else {
 			terrain |= 1;
@@ -487,11 +659,39 @@ bool Chunk_cache::is_blocked(
 		int       max_drop,    // Max. drop/rise allowed.
 		int       max_rise     // Max. rise, or -1 to use old beha-
 							   //   viour (max_drop if FLY, else 1).
+) {
+	set_tflags(tx, ty, 255);
+	return is_blocked(
+				   tflags, height, lift, new_lift, move_flags, max_drop,
+				   max_rise)
+		   || is_blocked_at(
+				   new_lift, new_lift == 0 ? Check_terrain(obj_list, tx, ty) : 0,
+				   move_flags);
+}
+
+/*
+ *  Find the lift an object would be at on a tile, given the tile's
+ *  'blocked' bits.  Doesn't use any game state, so it's safe to call
+ *  from another thread on a copy of the bits.
+ *
+ *  Output: true if blocked by objects, else false.
+ *      new_lift is always set, as in is_blocked() above.
+ */
+
+bool Chunk_cache::is_blocked(
+		const uint64* bits,      // 256 lifts' worth.
+		int           height,    // Height (in tiles) of obj. being
+		//   tested.
+		int       lift,        // Given lift.
+		int&      new_lift,    // New lift returned.
+		const int move_flags,
+		int       max_drop,    // Max. drop/rise allowed.
+		int       max_rise     // Max. rise, or -1 to use old beha-
+							   //   viour (max_drop if FLY, else 1).
 ) {
 	const bool is_ethereal   = (move_flags & MOVE_ETHEREAL) != 0;
 	const bool in_mapedit    = (move_flags & MOVE_MAPEDIT) != 0;
 	const bool can_walk      = (move_flags & MOVE_WALK) != 0;
-	const bool can_swim      = (move_flags & MOVE_SWIM) != 0;
 	const bool can_fly       = (move_flags & MOVE_FLY) != 0;
 	const bool is_levitating = (move_flags & MOVE_LEVITATE) != 0;
 	// Ethereal beings always return not blocked
@@ -515,11 +715,11 @@ bool Chunk_cache::is_blocked(
 	if (max_lift > 255) {
 		max_lift = 255;    // As high as we can go.
 	}
-	set_tflags(tx, ty, max_lift + height);
+	const int maxz = std::min(max_lift + height, 255);
 	for (new_lift = lift; new_lift <= max_lift; new_lift++) {
-		if (!TEST_TFLAGS(new_lift)) {
+		if (!((bits[new_lift / 64] >> (new_lift % 64)) & 1)) {
 			// Not blocked?
-			const int new_high = get_lowest_blocked(new_lift);
+			const int new_high = Get_lowest_blocked(bits, maxz, new_lift);
 			// Not blocked above?
 			if (new_high == -1 || new_high >= (new_lift + height)) {
 				break;    // Okay.
@@ -528,17 +728,18 @@ bool Chunk_cache::is_blocked(
 	}
 	if (new_lift > max_lift) {    // Spot not found at lift or higher?
 		// Look downwards.
-		new_lift = get_highest_blocked(lift) + 1;
+		new_lift = Get_highest_blocked(bits, maxz, lift) + 1;
 		if (new_lift >= lift) {    // Couldn't drop?
 			return true;
 		}
-		const int new_high = get_lowest_blocked(new_lift);
+		const int new_high = Get_lowest_blocked(bits, maxz, new_lift);
 		if (new_high != -1 && new_high < new_lift + height) {
 			return true;    // Still blocked above.
 		}
 	}
 	if (new_lift <= lift) {    // Not going up?  See if falling.
-		new_lift = is_levitating ? lift : get_highest_blocked(lift) + 1;
+		new_lift = is_levitating ? lift
+								 : Get_highest_blocked(bits, maxz, lift) + 1;
 		// Don't allow fall of > max_drop.
 		if (lift - new_lift > max_drop) {
 			// Map-editing?  Suspend in air there.
@@ -548,16 +749,34 @@ bool Chunk_cache::is_blocked(
 				return true;
 			}
 		}
-		const int new_high = get_lowest_blocked(new_lift);
+		const int new_high = Get_lowest_blocked(bits, maxz, new_lift);
 
 		// Make sure that where we want to go is tall enough for us
 		if (new_high != -1 && new_high < (new_lift + height)) {
 			return true;
 		}
 	}
+	return false;
+}
 
-	// Found a new place to go, lets test if we can actually move there
+/*
+ *  Found a new place to go, lets test if we can actually move there.
+ *
+ *  Output: true if the mover can't be there.
+ */
 
+bool Chunk_cache::is_blocked_at(
+		int       new_lift,    // From is_blocked() above.
+		int       terrain,     // Check_terrain() bits, for lift 0.
+		const int move_flags) {
+	const bool is_ethereal = (move_flags & MOVE_ETHEREAL) != 0;
+	const bool in_mapedit  = (move_flags & MOVE_MAPEDIT) != 0;
+	const bool can_walk    = (move_flags & MOVE_WALK) != 0;
+	const bool can_swim    = (move_flags & MOVE_SWIM) != 0;
+	const bool can_fly     = (move_flags & MOVE_FLY) != 0;
+	if (is_ethereal) {
+		return false;
+	}
 	// Lift 0 tests
 	if (new_lift == 0) {
 		if (in_mapedit) {
@@ -567,16 +786,15 @@ bool Chunk_cache::is_blocked(
 			// Cannot move at all, like Reapers in BG.
 			return true;
 		}
-		const int ter = Check_terrain(obj_list, tx, ty);
-		if (can_swim && !can_walk && !can_fly && (ter & 2) == 0) {
+		if (can_swim && !can_walk && !can_fly && (terrain & 2) == 0) {
 			// Can only swim; do not allow to move outside of water.
 			return true;
 		}
-		if (can_walk && !can_swim && !can_fly && (ter & 2) != 0) {
+		if (can_walk && !can_swim && !can_fly && (terrain & 2) != 0) {
 			// Can only walk; do not allow to move into water.
 			return true;
 		}
-		if (!can_swim && !can_fly && (ter & 4) != 0) {
+		if (!can_swim && !can_fly && (terrain & 4) != 0) {
 			// Can only walk and terrain is solid (and 0-height).
 			return true;
 		}
@@ -613,12 +831,14 @@ void Chunk_cache::activate_eggs(
 		}
 	}
 	if (eggbits) {    // Check 15th bit.
-					  // DON'T use an iterator here, since
-					  //   the list can change as eggs are
-					  //   activated, causing a CRASH!
-		const size_t sz = egg_objects.size();
-		for (; i < sz; i++) {
-			Egg_object* egg = egg_objects[i];
+		// The list can change as eggs are activated, so look each one up.
+		vector<unsigned short> found;
+		find_egg_spans(
+				tx % c_tiles_per_chunk, ty % c_tiles_per_chunk, found);
+		for (const unsigned short eggnum : found) {
+			Egg_object* egg
+					= eggnum < egg_objects.size() ? egg_objects[eggnum]
+												  : nullptr;
 			if (egg && egg->is_active(obj, tx, ty, tz, from_tx, from_ty)) {
 				egg->hatch(obj, now);
 				if (chunk->get_cache() != this) {
@@ -653,13 +873,15 @@ void Chunk_cache::unhatch_eggs(
 		}
 	}
 	if (eggbits) {    // Check 15th bit.
-					  // DON'T use an iterator here, since
-					  //   the list can change as eggs are
-					  //   activated, causing a CRASH!
-		const size_t sz = egg_objects.size();
-		i               = 0;    // Go through eggs.
-		for (; i < sz; i++) {
-			Egg_object* egg = egg_objects[i];
+		// The list can change as eggs are activated, so look each one up.
+		vector<unsigned short> found;
+		find_egg_spans(
+				from_tx % c_tiles_per_chunk, from_ty % c_tiles_per_chunk,
+				found);
+		for (const unsigned short eggnum : found) {
+			Egg_object* egg
+					= eggnum < egg_objects.size() ? egg_objects[eggnum]
+												  : nullptr;
 			if (egg && egg->test_unhatch(obj, tx, ty, tz, from_tx, from_ty)) {
 				egg->unhatch(obj, now);
 			}
@@ -694,7 +916,53 @@ Map_chunk::Map_chunk(
 		: map(m), terrain(nullptr), objects(nullptr), first_nonflat(nullptr),
 		  from_below(0), from_right(0), from_below_right(0), ice_dungeon(0x00),
 		  dungeon_levels(nullptr), cache(nullptr), roof(0), cx(chunkx),
-		  cy(chunky), selected(false) {}
+		  cy(chunky), selected(false),
+		  blocked_version(++last_blocked_version), paint_skip(-1) {}
+
+/*
+ *  Note that an object that might block was added or removed.  It may
+ *  extend into the chunks to the left and above.
+ */
+
+void Map_chunk::blocking_changed(const Game_object* obj) {
+	if (obj->as_actor()) {    // They're always moving.
+		return;
+	}
+	blocked_version = ++last_blocked_version;
+	map->get_chunk(DECR_CHUNK(cx), cy)->blocked_version
+			= ++last_blocked_version;
+	map->get_chunk(cx, DECR_CHUNK(cy))->blocked_version
+			= ++last_blocked_version;
+	map->get_chunk(DECR_CHUNK(cx), DECR_CHUNK(cy))->blocked_version
+			= ++last_blocked_version;
+}
+
+/*
+ *  Copy the 'blocked' bits of each tile.
+ *
+ *  Output: # of words per tile.  Word w of tile t is bits[w * 256 + t].
+ */
+
+int Map_chunk::copy_blocked_bits(std::vector<uint64>& bits) {
+	const Chunk_cache* c     = need_cache();
+	const int          words = c->blocked_bits.size();
+	const int          tiles = c_tiles_per_chunk * c_tiles_per_chunk;
+	bits.assign(words * tiles, 0);
+	for (int w = 0; w < words; w++) {
+		if (c->blocked_bits[w]) {
+			std::copy_n(c->blocked_bits[w].get(), tiles, &bits[w * tiles]);
+		}
+	}
+	return words;
+}
+
+/*
+ *  Get whether a tile is land, water or solid.
+ */
+
+int Map_chunk::get_terrain(int tx, int ty) {
+	return Check_terrain(this, tx, ty);
+}
 
 /*
  *  Set terrain.  Even if the terrain is the same, it still reloads the
@@ -724,6 +992,7 @@ void Map_chunk::set_terrain(Chunk_terrain* ter) {
 	}
 	terrain = ter;
 	terrain->add_client();
+	blocked_version = ++last_blocked_version;
 	// Get RLE objects in chunk.
 	for (int tiley = 0; tiley < c_tiles_per_chunk; tiley++) {
 		for (int tilex = 0; tilex < c_tiles_per_chunk; tilex++) {
@@ -745,6 +1014,78 @@ void Map_chunk::set_terrain(Chunk_terrain* ter) {
 	}
 }
 
+int Map_chunk::group_adds     = 0;
+int Map_chunk::group_scrolltx = 0;
+int Map_chunk::group_scrollty = 0;
+std::unordered_map<Map_chunk*, Map_chunk::Nonflat_areas>
+		Map_chunk::group_areas;
+uint32 Map_chunk::last_blocked_version = 0;
+
+/*
+ *  Get the sorted screen areas of our non-flat objects while adding a
+ *  group, making them if needed.
+ *
+ *  Output: ->areas, or nullptr if not adding a group.
+ */
+
+Map_chunk::Nonflat_areas* Map_chunk::get_group_areas() {
+	if (!group_adds) {
+		return nullptr;
+	}
+	if (group_scrolltx != gwin->get_scrolltx()
+		|| group_scrollty != gwin->get_scrollty()) {
+		group_areas.clear();    // Screen areas have all moved.
+		group_scrolltx = gwin->get_scrolltx();
+		group_scrollty = gwin->get_scrollty();
+	}
+	auto it = group_areas.find(this);
+	if (it != group_areas.end()) {
+		return &it->second;
+	}
+	Nonflat_areas&          areas = group_areas[this];
+	Game_object*            obj;
+	Nonflat_object_iterator next(this);
+	while ((obj = next.get_next()) != nullptr) {
+		const TileRect area = gwin->get_shape_rect(obj);
+		areas.areas.push_back({area, obj});
+		areas.maxw = std::max(areas.maxw, area.w);
+	}
+	std::sort(
+			areas.areas.begin(), areas.areas.end(),
+			[](const Nonflat_area& a, const Nonflat_area& b) {
+				return a.area.x < b.area.x;
+			});
+	return &areas;
+}
+
+/*
+ *  Add rendering dependencies between a new object and another.
+ */
+
+void Map_chunk::add_dependency(
+		Game_object*   newobj,     // Object to add.
+		Ordering_info& newinfo,    // Info. for new object's ordering.
+		Game_object*   obj         // Object to order it against.
+) {
+	// cout << "Here " << __LINE__ << " " << obj << endl;
+	/* Compare returns -1 if lt, 0 if dont_care, 1 if gt. */
+	int cmp = Game_object::compare(newinfo, obj);
+	// TODO: Fix this properly, instead of with an ugly hack.
+	// This fixes relative ordering between the Y depression and the Y
+	// shapes in SI. Done so in a way that the depression is not clickable.
+	if (!cmp && GAME_SI && newobj->get_shapenum() == 0xd1
+		&& obj->get_shapenum() == 0xd1 && obj->get_framenum() == 17) {
+		cmp = 1;
+	}
+	if (cmp == 1) {    // Bigger than this object?
+		newobj->dependencies.insert(obj);
+		obj->dependors.insert(newobj);
+	} else if (cmp == -1) {    // Smaller than?
+		obj->dependencies.insert(newobj);
+		newobj->dependors.insert(obj);
+	}
+}
+
 /*
  *  Add rendering dependencies for a new object.
  */
@@ -753,26 +1094,27 @@ void Map_chunk::add_dependencies(
 		Game_object*   newobj,    // Object to add.
 		Ordering_info& newinfo    // Info. for new object's ordering.
 ) {
+	Nonflat_areas* group = get_group_areas();
+	if (group) {
+		// Only those that overlap on screen can depend on it.
+		const TileRect& area = newinfo.area;
+		auto            it   = std::upper_bound(
+				   group->areas.begin(), group->areas.end(),
+				   area.x - group->maxw, [](int x, const Nonflat_area& each) {
+					   return x < each.area.x;
+				   });
+		for (; it != group->areas.end() && it->area.x < area.x + area.w;
+			 ++it) {
+			if (area.intersects(it->area)) {
+				add_dependency(newobj, newinfo, it->obj);
+			}
+		}
+		return;
+	}
 	Game_object*            obj;    // Figure dependencies.
 	Nonflat_object_iterator next(this);
 	while ((obj = next.get_next()) != nullptr) {
-		// cout << "Here " << __LINE__ << " " << obj << endl;
-		/* Compare returns -1 if lt, 0 if dont_care, 1 if gt. */
-		int cmp = Game_object::compare(newinfo, obj);
-		// TODO: Fix this properly, instead of with an ugly hack.
-		// This fixes relative ordering between the Y depression and the Y
-		// shapes in SI. Done so in a way that the depression is not clickable.
-		if (!cmp && GAME_SI && newobj->get_shapenum() == 0xd1
-			&& obj->get_shapenum() == 0xd1 && obj->get_framenum() == 17) {
-			cmp = 1;
-		}
-		if (cmp == 1) {    // Bigger than this object?
-			newobj->dependencies.insert(obj);
-			obj->dependors.insert(newobj);
-		} else if (cmp == -1) {    // Smaller than?
-			obj->dependencies.insert(newobj);
-			newobj->dependors.insert(obj);
-		}
+		add_dependency(newobj, newinfo, obj);
 	}
 }
 
@@ -802,6 +1144,12 @@ inline Map_chunk* Map_chunk::add_outside_dependencies(
 void Map_chunk::add(Game_object* newobj    // Object to add.
 ) {
 	newobj->chunk = this;    // Set object's chunk.
+	paint_skip    = -1;
+	if (!newobj->as_actor()) {
+		map->set_ireg_dirty(cx, cy);
+	}
+	index_object(newobj, newobj->get_shapenum(), true);
+	blocking_changed(newobj);
 	Ordering_info            ord(gwin, newobj);
 	const Game_object_shared newobj_shared = newobj->shared_from_this();
 	// Put past flats.
@@ -843,6 +1191,23 @@ void Map_chunk::add(Game_object* newobj    // Object to add.
 					->from_below++;
 		}
 		first_nonflat = newobj;    // Inserted before old first_nonflat.
+		if (group_adds) {
+			auto it = group_areas.find(this);
+			if (it != group_areas.end()) {
+				// Keep our areas up to date.
+				std::vector<Nonflat_area>& areas = it->second.areas;
+				const Nonflat_area         each{ord.area, newobj};
+				areas.insert(
+						std::upper_bound(
+								areas.begin(), areas.end(), each,
+								[](const Nonflat_area& a,
+								   const Nonflat_area& b) {
+									return a.area.x < b.area.x;
+								}),
+						each);
+				it->second.maxw = std::max(it->second.maxw, ord.area.w);
+			}
+		}
 	}
 	if (cache) {    // Add to cache.
 		cache->update_object(this, newobj, true);
@@ -884,6 +1249,37 @@ void Map_chunk::remove_egg(Egg_object* egg) {
 	remove(egg);    // Remove it normally.
 }
 
+/*
+ *  Add an object to, or remove it from, the lists searched by shape.
+ */
+
+void Map_chunk::index_object(Game_object* obj, int shapenum, bool add) {
+	std::vector<Game_object*>* list;
+	if (obj->as_actor()) {
+		list = &chunk_actors;
+	} else if (add) {
+		list = &shape_objects[shapenum];
+	} else {
+		auto it = shape_objects.find(shapenum);
+		if (it == shape_objects.end()) {
+			return;
+		}
+		list = &it->second;
+	}
+	if (add) {
+		list->push_back(obj);
+		return;
+	}
+	auto found = std::find(list->begin(), list->end(), obj);
+	if (found != list->end()) {
+		*found = list->back();
+		list->pop_back();
+	}
+	if (list->empty() && list != &chunk_actors) {
+		shape_objects.erase(shapenum);
+	}
+}
+
 /*
  *  Remove a game object from this list.  The object's 'chunk' field
  *  is set to nullptr.
@@ -891,10 +1287,19 @@ void Map_chunk::remove_egg(Egg_object* egg) {
 
 void Map_chunk::remove(Game_object* remove) {
 	assert(remove->get_chunk() == this);
+	if (group_adds) {    // Made again when needed.
+		group_areas.erase(this);
+	}
 	if (cache) {    // Remove from cache.
 		cache->update_object(this, remove, false);
 	}
+	paint_skip = -1;
 	remove->clear_dependencies();    // Remove all dependencies.
+	blocking_changed(remove);
+	if (!remove->as_actor()) {
+		map->set_ireg_dirty(cx, cy);
+	}
+	index_object(remove, remove->get_shapenum(), false);
 	Game_map*         gmap = gwin->get_map();
 	const Shape_info& info = remove->get_info();
 	// See if it extends outside.
@@ -1202,10 +1607,10 @@ Tile_coord Map_chunk::find_spot(
 		//   random.
 		Find_spot_where where    // Inside/outside.
 ) {
-	const Shape_info& info = ShapeID::get_info(shapenum);
-	const int         xs   = info.get_3d_xtiles(framenum);
-	const int         ys   = info.get_3d_ytiles(framenum);
-	const int         zs   = info.get_3d_height();
+	const Shape_hot_info& info = ShapeID::get_hot_info(shapenum);
+	const int             xs   = info.get_3d_xtiles(framenum);
+	const int             ys   = info.get_3d_ytiles(framenum);
+	const int             zs   = info.get_3d_height();
 	// The 'MOVE_FLY' flag really means
 	//   we can look upwards by max_drop.
 	const int mflags = MOVE_WALK | MOVE_FLY;
@@ -1523,6 +1928,28 @@ int Map_chunk::is_roof(int tx, int ty, int lift) {
 	return height;
 }
 
+/*
+ *  Get the non-flat objects below a lift, in the order they're painted.
+ *  The list is kept until objects are added or removed, or another lift
+ *  is asked for, so that under a roof the objects above aren't looked at
+ *  each frame.
+ */
+
+const std::vector<Game_object*>& Map_chunk::get_paint_objects(int skip) {
+	if (paint_skip != skip) {
+		paint_objects.clear();
+		Nonflat_object_iterator next(this);
+		Game_object*            obj;
+		while ((obj = next.get_next()) != nullptr) {
+			if (obj->get_lift() < skip) {
+				paint_objects.push_back(obj);
+			}
+		}
+		paint_skip = skip;
+	}
+	return paint_objects;
+}
+
 void Map_chunk::kill_cache() {
 	// Get rid of terrain
 	if (terrain) {
@@ -34,6 +34,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 class Map_chunk;
 class Egg_object;
@@ -57,11 +59,18 @@ public:
 	// level for #objs blocking there, so
 	// 8 lifts are represented.
 	using blocked8z = std::unique_ptr<uint16[]>;
+	// For each tile, 1 bit for each lift
+	// that's blocked at all, so 64 lifts
+	// are represented.
+	using blocked64z = std::unique_ptr<uint64[]>;
 
 private:
 	Map_chunk* obj_list;
 	// One for each 8 lifts.
 	std::vector<blocked8z> blocked;
+	// One for each 64 lifts.  Kept in step
+	// with 'blocked', for fast searches.
+	std::vector<blocked64z> blocked_bits;
 	// ->eggs which influence this chunk.
 	std::vector<Egg_object*> egg_objects;
 	// Bit #i (0-14) set means that the
@@ -69,6 +78,16 @@ private:
 	// influence.  Bit 15 means it's 1 or
 	// more of egg_objects[15-(num_eggs-1)].
 	unsigned short eggs[256];
+
+	// Part of a row of tiles within an egg's influence.
+	struct Egg_span {
+		unsigned char  startx, endx;    // Tiles, inclusive.
+		unsigned short eggnum;          // Index in egg_objects.
+	};
+
+	// For egg_objects[15] and up, the spans of each row of tiles they
+	// influence, sorted by startx, so bit 15 needn't mean trying them all.
+	std::vector<Egg_span> egg_spans[c_tiles_per_chunk];
 	// Keep special list of doors.
 	std::set<Game_object*> doors;
 
@@ -77,6 +96,8 @@ private:
 	}
 
 	blocked8z& new_blocked_level(int zlevel);
+	// Copy a tile's counts to blocked_bits.
+	void update_blocked_bits(int zlevel, int tx, int ty);
 
 	blocked8z& need_blocked_level(int zlevel) {
 		return (static_cast<unsigned>(zlevel) >= blocked.size()
@@ -96,6 +117,11 @@ private:
 	void set_egged(Egg_object* egg, TileRect& tiles, bool add);
 	// Add egg.
 	void update_egg(Map_chunk* chunk, Egg_object* egg, bool add);
+	// Add/remove egg_spans for an egg (15 and up).
+	void add_egg_spans(int eggnum, const TileRect& tiles);
+	void remove_egg_spans(int eggnum);
+	// Get eggs (15 and up) influencing a tile, in order.
+	void find_egg_spans(int tx, int ty, std::vector<unsigned short>& found);
 	// Set up with chunk's data.
 	void setup(Map_chunk* chunk);
 	void set_tflags(int tx, int ty, int maxz);    // Setup flags.
@@ -151,6 +177,14 @@ public:
 	friend class Map_chunk;
 	Chunk_cache();
 
+	// Where an object would be on a tile, given the tile's 'blocked' bits
+	//   for all 256 lifts.  Safe to use off the main thread.
+	static bool is_blocked(
+			const uint64* bits, int height, int lift, int& new_lift,
+			const int move_flags, int max_drop = 1, int max_rise = -1);
+	// Can a mover be at the lift found above, given the tile's terrain?
+	static bool is_blocked_at(int new_lift, int terrain, const int move_flags);
+
 	// Is there something on this tile?
 	inline bool is_tile_occupied(int tx, int ty, int tz) {
 		const auto* b8 = static_cast<unsigned>(tz / 8) < blocked.size()
@@ -183,16 +217,72 @@ class Map_chunk : public Game_singletons {
 	// # light sources in chunk.
 	std::set<Game_object*> dungeon_lights;
 	std::set<Game_object*> non_dungeon_lights;
+	// For searches by shape: objects other than actors by shape, and the
+	// actors, whose polymorphs are searched for as well.
+	std::unordered_map<int, std::vector<Game_object*>> shape_objects;
+	std::vector<Game_object*>                          chunk_actors;
 	unsigned char          cx, cy;      // Absolute chunk coords. of this.
 	bool                   selected;    // For 'select_chunks' mode.
-	void add_dungeon_levels(TileRect& tiles, unsigned int lift);
+	// Changed whenever something that might block is added or removed.
+	uint32        blocked_version;
+	static uint32 last_blocked_version;
+	// Non-flat objects below the lift last painted, in list order, and
+	// that lift, or -1 if objects were added or removed since.
+	std::vector<Game_object*> paint_objects;
+	int                       paint_skip;
+
+	// Screen areas of a chunk's non-flat objects, sorted by x.
+	struct Nonflat_area {
+		TileRect     area;
+		Game_object* obj;
+	};
+
+	struct Nonflat_areas {
+		std::vector<Nonflat_area> areas;
+		int                       maxw = 0;    // Widest area.
+	};
+
+	// While adding a group (see Group_add), the chunks' non-flat areas,
+	// made as needed, and the scroll position they're for.
+	static int                                          group_adds;
+	static int                                          group_scrolltx;
+	static int                                          group_scrollty;
+	static std::unordered_map<Map_chunk*, Nonflat_areas> group_areas;
+
+	Nonflat_areas* get_group_areas();
+	void           add_dungeon_levels(TileRect& tiles, unsigned int lift);
+	static void    add_dependency(
+			   Game_object* newobj, Ordering_info& newinfo, Game_object* obj);
 	void add_dependencies(Game_object* newobj, Ordering_info& newinfo);
+	void blocking_changed(const Game_object* obj);
+	void index_object(Game_object* obj, int shapenum, bool add);
 	static Map_chunk* add_outside_dependencies(
 			int cx, int cy, Game_object* newobj, Ordering_info& newinfo);
 
 public:
 	friend class Npc_actor;
 	friend class Game_object;
+
+	// While one exists, objects added to chunks are ordered against a
+	// sorted list of the screen areas of each chunk's objects, instead of
+	// all of them.  For adding many at once, as when a barge moves.
+	// Objects shouldn't change frames meanwhile, except by being re-added.
+	class Group_add {
+	public:
+		Group_add() {
+			++group_adds;
+		}
+
+		~Group_add() {
+			if (--group_adds == 0) {
+				group_areas.clear();
+			}
+		}
+
+		Group_add(const Group_add&)            = delete;
+		Group_add& operator=(const Group_add&) = delete;
+	};
+
 	Map_chunk(Game_map* m, int chunkx, int chunky);
 
 	Game_map* get_map() const {
@@ -203,6 +293,17 @@ public:
 		return terrain;
 	}
 
+	// For knowing when paths through the chunk were found.
+	uint32 get_blocked_version() const {
+		return blocked_version;
+	}
+
+	// Versions only increase, so chunks with a version up to this
+	// haven't changed since it was gotten.
+	static uint32 get_last_blocked_version() {
+		return last_blocked_version;
+	}
+
 	void set_terrain(Chunk_terrain* ter);
 	void add(Game_object* obj);       // Add an object.
 	void add_egg(Egg_object* egg);    // Add/remove an egg.
@@ -221,6 +322,19 @@ public:
 		return first_nonflat;
 	}
 
+	// Non-flat objects to paint when skipping those at 'skip' and above.
+	const std::vector<Game_object*>& get_paint_objects(int skip);
+
+	// Objects of a shape, except actors, or null if none.
+	const std::vector<Game_object*>* get_shape_objects(int shapenum) const {
+		auto it = shape_objects.find(shapenum);
+		return it != shape_objects.end() ? &it->second : nullptr;
+	}
+
+	const std::vector<Game_object*>& get_actors() const {
+		return chunk_actors;
+	}
+
 	int get_cx() const {
 		return cx;
 	}
@@ -360,6 +474,17 @@ public:
 		return need_cache()->find_door(t);
 	}
 
+	// For copying what blocks, to find paths off the main thread.
+	// Returns # of words (64 lifts each) per tile copied to bits.
+	int copy_blocked_bits(std::vector<uint64>& bits);
+
+	const std::set<Game_object*>& get_doors() {
+		return need_cache()->doors;
+	}
+
+	// Check_terrain() bits for a tile: 1 = land, 2 = water, 4 = solid.
+	int get_terrain(int tx, int ty);
+
 	static int find_in_area(
 			std::vector<Game_object*>& vec, const TileRect& area, int shapenum,
 			int framenum);
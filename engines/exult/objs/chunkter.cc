@@ -29,10 +29,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "gamewin.h"
 
+#include <algorithm>
 #include <cstring>
 
 Chunk_terrain* Chunk_terrain::render_queue = nullptr;
 int            Chunk_terrain::queue_size   = 0;
+int            Chunk_terrain::count        = 0;
 
 /*
  *  Insert at start of render queue.  It may already be there, but it's
@@ -148,6 +150,7 @@ Chunk_terrain::Chunk_terrain(
 		: undo_shapes(nullptr), num_clients(0), modified(false),
 		  rendered_flats(nullptr), render_queue_next(nullptr),
 		  render_queue_prev(nullptr) {
+	count++;
 	for (int tiley = 0; tiley < c_tiles_per_chunk; tiley++) {
 		for (int tilex = 0; tilex < c_tiles_per_chunk; tilex++) {
 			int shnum;
@@ -175,6 +178,7 @@ Chunk_terrain::Chunk_terrain(const Chunk_terrain& c2)
 		: undo_shapes(nullptr), num_clients(0), modified(true),
 		  rendered_flats(nullptr), render_queue_next(nullptr),
 		  render_queue_prev(nullptr) {
+	count++;
 	for (int tiley = 0; tiley < c_tiles_per_chunk; tiley++) {
 		for (int tilex = 0; tilex < c_tiles_per_chunk; tilex++) {
 			shapes[16 * tiley + tilex] = c2.shapes[16 * tiley + tilex];
@@ -187,6 +191,7 @@ Chunk_terrain::Chunk_terrain(const Chunk_terrain& c2)
  */
 
 Chunk_terrain::~Chunk_terrain() {
+	count--;
 	delete[] undo_shapes;
 	delete rendered_flats;
 	remove_from_queue();
@@ -243,13 +248,15 @@ void Chunk_terrain::abort_edits() {
  *  Figure max. queue size for given game window.
  */
 static int Figure_queue_size() {
-	// Game_window *gwin = Game_window::get_instance();
-	// int w = gwin->get_width(), h = gwin->get_height();
-	//  Figure # chunks, rounding up.
-	// int cw = (w + c_chunksize - 1)/c_chunksize,
-	//     ch = (h + c_chunksize - 1)/c_chunksize;
-	//  Add extra in each dir.
-	return 100;    //(cw + 3)*(ch + 3);
+	Game_window* gwin = Game_window::get_instance();
+	const int    w    = gwin->get_width();
+	const int    h    = gwin->get_height();
+	// Figure # chunks, rounding up.
+	const int cw = (w + c_chunksize - 1) / c_chunksize;
+	const int ch = (h + c_chunksize - 1) / c_chunksize;
+	// Add extra in each dir.  Anything less would render every visible
+	//   chunk again each frame on large screens.
+	return std::max(100, (cw + 3) * (ch + 3));
 }
 
 /*
@@ -258,14 +265,15 @@ static int Figure_queue_size() {
 
 Image_buffer8* Chunk_terrain::render_flats() {
 	if (!rendered_flats) {
-		if (queue_size > Figure_queue_size()) {
+		if (render_queue != this) {    // Keep track of every buffer.
+			insert_in_queue();
+		}
+		const int max_size = Figure_queue_size();
+		while (queue_size > max_size) {
 			// Grown too big.  Remove last.
 			Chunk_terrain* last = render_queue->render_queue_prev;
 			last->free_rendered_flats();
-			render_queue->render_queue_prev = last->render_queue_prev;
-			last->render_queue_prev->render_queue_next = render_queue;
-			last->render_queue_next = last->render_queue_prev = nullptr;
-			queue_size--;
+			last->remove_from_queue();
 		}
 		rendered_flats = new Image_buffer8(c_chunksize, c_chunksize);
 	}
@@ -287,6 +295,18 @@ void Chunk_terrain::free_rendered_flats() {
 	rendered_flats = nullptr;
 }
 
+/*
+ *  Free all pre-rendered landscape, as when the flat shapes have changed.
+ */
+
+void Chunk_terrain::clear_rendered_flats() {
+	while (render_queue) {
+		Chunk_terrain* ter = render_queue;
+		ter->free_rendered_flats();
+		ter->remove_from_queue();
+	}
+}
+
 /*
  *  This method is only used in 'terrain-editor' mode, NOT in normal
  *  gameplay.
@@ -45,6 +45,7 @@ class Chunk_terrain : public Game_singletons {
 	//   for rendered_flats:
 	static Chunk_terrain* render_queue;
 	static int            queue_size;
+	static int            count;    // # Chunk_terrain's in existence.
 	Chunk_terrain *       render_queue_next, *render_queue_prev;
 	//   Kept only for nearby chunks.
 	void insert_in_queue();    // Queue methods.
@@ -60,6 +61,17 @@ public:
 	// Copy-constructor:
 	Chunk_terrain(const Chunk_terrain& c2);
 	~Chunk_terrain();
+	// Free all rendered_flats.
+	static void clear_rendered_flats();
+
+	static int get_count() {
+		return count;
+	}
+
+	// Can be deleted and read in again later?
+	bool is_unused() const {
+		return num_clients <= 0 && !modified && !undo_shapes;
+	}
 
 	inline void add_client() {
 		num_clients++;
@@ -77,6 +89,11 @@ public:
 		modified = tf;
 	}
 
+	// Being edited (uncommitted)?
+	bool has_edits() const {
+		return undo_shapes != nullptr;
+	}
+
 	// Get tile's shape ID.
 	inline ShapeID get_flat(int tilex, int tiley) const {
 		return shapes[16 * tiley + tilex];
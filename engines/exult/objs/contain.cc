@@ -89,6 +89,8 @@ void Container_game_object::remove(Game_object* obj) {
 	obj->set_owner(nullptr);
 	obj->set_invalid();    // No longer part of world.
 	objects.remove(obj->shared_from_this());
+	count_member(obj, -1);
+	set_ireg_dirty();
 	if (g_shortcutBar) {
 		g_shortcutBar->check_for_updates(shapenum);
 	}
@@ -172,6 +174,8 @@ bool Container_game_object::add(
 	volume_used += objvol;
 	obj->set_owner(this);                       // Set us as the owner.
 	objects.append(obj->shared_from_this());    // Append to chain.
+	count_member(obj, 1);
+	set_ireg_dirty();
 	// Guessing:
 	if (get_flag(Obj_flags::okay_to_take)) {
 		obj->set_flag(Obj_flags::okay_to_take);
@@ -190,10 +194,51 @@ void Container_game_object::change_member_shape(
 		Game_object* obj, int newshape) {
 	const int oldvol = obj->get_volume();
 	obj->set_shape(newshape);
+	set_ireg_dirty();
 	// Update total volume.
 	volume_used += obj->get_volume() - oldvol;
 }
 
+/*
+ *  Count objects of a shape coming or going, here and in our owners.
+ */
+
+void Container_game_object::count_shape(int shapenum, int delta) {
+	for (Container_game_object* cont = this; cont; cont = cont->get_owner()) {
+		auto it = cont->shape_counts.find(shapenum);
+		if (it == cont->shape_counts.end()) {
+			if (delta > 0) {
+				cont->shape_counts.emplace(shapenum, delta);
+			}
+		} else if ((it->second += delta) <= 0) {
+			cont->shape_counts.erase(it);
+		}
+	}
+}
+
+/*
+ *  Count a member coming (sign = 1) or going (-1), with all it holds.
+ */
+
+void Container_game_object::count_member(Game_object* obj, int sign) {
+	count_shape(obj->get_shapenum(), sign);
+	const Container_game_object* cont = obj->as_container();
+	if (cont) {
+		for (const auto& [shapenum, count] : cont->shape_counts) {
+			count_shape(shapenum, sign * count);
+		}
+	}
+}
+
+/*
+ *  A member, or something inside one, is changing shape.
+ */
+
+void Container_game_object::recount_shape(int oldshape, int newshape) {
+	count_shape(oldshape, -1);
+	count_shape(newshape, 1);
+}
+
 /*
  *  Add a key (by quality) to the SI keyring.
  *
@@ -256,7 +301,10 @@ int Container_game_object::add_quantity(
 	// Note:  quantity is ignored for
 	//   figuring volume.
 	Game_object* obj;
-	if (!objects.is_empty()) {
+	// Only look through what might take some.
+	if (!objects.is_empty()
+		&& (holds_shape(shapenum)
+			|| (GAME_SI && shapenum == 641 && holds_shape(485)))) {
 		// First try existing items.
 		Object_iterator next(objects);
 		while (delta && (obj = next.get_next()) != nullptr) {
@@ -363,7 +411,8 @@ int Container_game_object::remove_quantity(
 		int qual,        // Quality, or c_any_qual for any.
 		int framenum     // Frame, or c_any_framenum for any.
 ) {
-	if (objects.is_empty() || !Can_be_added(this, shapenum)) {
+	if (objects.is_empty() || !holds_shape(shapenum)
+		|| !Can_be_added(this, shapenum)) {
 		return delta;    // Empty.
 	}
 	Game_object* obj  = objects.get_first();
@@ -400,7 +449,8 @@ Game_object* Container_game_object::find_item(
 		int qual,        // Quality, or c_any_qual for any.
 		int framenum     // Frame, or c_any_framenum for any.
 ) {
-	if (objects.is_empty() || !Can_be_added(this, shapenum, true)) {
+	if (objects.is_empty() || !holds_shape(shapenum)
+		|| !Can_be_added(this, shapenum, true)) {
 		return nullptr;    // Empty.
 	}
 	Game_object*    obj;
@@ -607,7 +657,8 @@ int Container_game_object::count_objects(
 		int qual,        // Quality, or c_any_qual for any.
 		int framenum     // Frame#, or c_any_framenum for any.
 ) {
-	if (!Can_be_added(this, shapenum, true)) {
+	if ((shapenum != c_any_shapenum && !holds_shape(shapenum))
+		|| !Can_be_added(this, shapenum, true)) {
 		return 0;
 	}
 	int             total = 0;
@@ -639,6 +690,9 @@ int Container_game_object::get_objects(
 		int                 qual,        // Quality, or c_any_qual for any.
 		int                 framenum     // Frame#, or c_any_framenum for any.
 ) {
+	if (shapenum != c_any_shapenum && !holds_shape(shapenum)) {
+		return 0;
+	}
 	const int       vecsize = vec.size();
 	Game_object*    obj;
 	Object_iterator next(objects);
@@ -25,12 +25,19 @@
 #include "ignore_unused_variable_warning.h"
 #include "iregobjs.h"
 
+#include <unordered_map>
+
 /*
  *  A container object:
  */
 class Container_game_object : public Ireg_game_object {
 	int  volume_used = 0;    // Amount of volume occupied.
 	char resistance  = 0;    // Resistance to attack.
+	// # of objects of each shape in here, at any depth, so searches for a
+	// shape can skip containers without any.
+	std::unordered_map<int, int> shape_counts;
+	void count_shape(int shapenum, int delta);    // Here and in owners.
+	void count_member(Game_object* obj, int sign);
 protected:
 	Object_list objects = nullptr;    // ->first object.
 	int         get_max_volume() const;
@@ -88,6 +95,13 @@ public:
 			bool noset = false) override;
 	// Change member shape.
 	virtual void change_member_shape(Game_object* obj, int newshape);
+	// A member (at any depth) is changing shape.
+	void recount_shape(int oldshape, int newshape);
+
+	// Is there an object of this shape in here, at any depth?
+	bool holds_shape(int shapenum) const {
+		return shape_counts.find(shapenum) != shape_counts.end();
+	}
 
 	// Find object's spot.
 	virtual int find_readied(Game_object* obj) {
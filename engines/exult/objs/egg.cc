@@ -982,6 +982,7 @@ bool Egg_object::is_active(
 			// Mark hatched if not auto-reset.
 			if (!(flags & (1 << static_cast<int>(auto_reset)))) {
 				flags |= (1 << static_cast<int>(hatched));
+				set_ireg_dirty();
 			}
 			return false;
 		}
@@ -1205,6 +1206,7 @@ void Egg_object::activate(int event) {
 	if (animator) {
 		flags &= ~(
 				1 << static_cast<int>(hatched));    // Moongate:  reset always.
+		set_ireg_dirty();
 	}
 }
 
@@ -1396,6 +1398,7 @@ void Egg_object::hatch(
 #ifdef DEBUG
 	print_debug();
 #endif
+	set_ireg_dirty();    // Its flags change below.
 	/*
 	  MAJOR HACK!
 	  This is an attempt at a work-around of a potential bug in the original
@@ -1452,6 +1455,7 @@ void Egg_object::unhatch(Game_object* obj, bool must) {
 	if (unhatch_now(obj, must)) {
 		if (is_auto_reset()) {
 			flags &= ~(1 << static_cast<int>(hatched));
+			set_ireg_dirty();
 		}
 	}
 	// once only eggs are safe to remove here
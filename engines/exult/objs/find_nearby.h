@@ -133,34 +133,19 @@ int Game_object::find_nearby(
 		Map_chunk* chunk = gmap->get_chunk(cx, cy);
 		tiles.x += cx * c_tiles_per_chunk;
 		tiles.y += cy * c_tiles_per_chunk;
-		Object_iterator next(chunk->get_objects());
-		Game_object*    obj;
-		while ((obj = next.get_next()) != nullptr) {
-			// Check shape.
-			if (shapenum >= 0) {
-				const bool shape_match = [&]() {
-					if (obj->get_shapenum() == shapenum) {
-						return true;
-					}
-					Actor* npc = obj->as_actor();
-					return npc != nullptr && npc->get_polymorph() == shapenum;
-				}();
-				if (!shape_match) {
-					continue;
-				}
-			}
+		auto consider = [&](Game_object* obj) {
 			if (qual != c_any_qual && obj->get_quality() != qual) {
-				continue;
+				return;
 			}
 			if (framenum != c_any_framenum && obj->get_framenum() != framenum) {
-				continue;
+				return;
 			}
 			if (!Check_mask(obj, mask_)) {
-				continue;
+				return;
 			}
 			if (exclude_okay_to_take
 				&& obj->get_flag(Obj_flags::okay_to_take)) {
-				continue;
+				return;
 			}
 			const Tile_coord t = obj->get_tile();
 			if (tiles.has_point(t.tx, t.ty)) {
@@ -169,6 +154,28 @@ int Game_object::find_nearby(
 					vec.push_back(castobj);
 				}
 			}
+		};
+		if (shapenum >= 0) {
+			// Only the objects of that shape, and actors that are it or
+			// are polymorphed from it.
+			if (const auto* objs = chunk->get_shape_objects(shapenum)) {
+				for (auto* obj : *objs) {
+					consider(obj);
+				}
+			}
+			for (auto* obj : chunk->get_actors()) {
+				Actor* npc = obj->as_actor();
+				if (obj->get_shapenum() == shapenum
+					|| npc->get_polymorph() == shapenum) {
+					consider(obj);
+				}
+			}
+			continue;
+		}
+		Object_iterator next(chunk->get_objects());
+		Game_object*    obj;
+		while ((obj = next.get_next()) != nullptr) {
+			consider(obj);
 		}
 	}
 	// Return # added.
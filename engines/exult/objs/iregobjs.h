@@ -101,6 +101,7 @@ public:
 		} else if (flag >= 32 && flag < 64) {
 			flags2 |= (static_cast<uint32>(1) << (flag - 32));
 		}
+		set_ireg_dirty();
 	}
 
 	void clear_flag(int flag) override {
@@ -109,6 +110,7 @@ public:
 		} else if (flag >= 32 && flag < 64) {
 			flags2 &= ~(static_cast<uint32>(1) << (flag - 32));
 		}
+		set_ireg_dirty();
 	}
 
 	bool get_flag(int flag) const override {
@@ -29,6 +29,9 @@
 #include "shapeinf.h"
 
 #include <cstdio>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifndef ATTR_PRINTF
 #	ifdef __GNUC__
@@ -40,6 +43,7 @@
 
 using std::strchr;
 using std::string;
+using std::string_view;
 
 /*
  *  For objects that can have a quantity, the name is in the format:
@@ -134,10 +138,53 @@ static void get_plural_name(
 	}
 }
 
+/*
+ *  Names made from the game's text, by the text and quantity, and names
+ *  made some other way.  Both are kept until the text changes, when the
+ *  text they came from may be gone.
+ */
+namespace {
+	struct Name_key {
+		const char* text;
+		int         quantity;
+
+		bool operator==(const Name_key& other) const {
+			return text == other.text && quantity == other.quantity;
+		}
+	};
+
+	struct Name_key_hash {
+		size_t operator()(const Name_key& key) const {
+			return std::hash<const char*>()(key.text) * 131 + key.quantity;
+		}
+	};
+
+	std::unordered_map<Name_key, string, Name_key_hash> composed_names;
+	std::unordered_set<string>                          interned_names;
+	unsigned                                            names_version = 0;
+
+	void Check_names_version() {
+		if (names_version != get_text_version()) {
+			composed_names.clear();
+			interned_names.clear();
+			names_version = get_text_version();
+		}
+	}
+}    // namespace
+
+string_view Game_object::intern_name(const string& name) {
+	Check_names_version();
+	auto it = interned_names.find(name);
+	if (it == interned_names.end()) {
+		it = interned_names.insert(name).first;
+	}
+	return *it;
+}
+
 /*
  *  Returns the string to be displayed when the item is clicked on
  */
-string Game_object::get_name() const {
+string_view Game_object::get_name_view() const {
 	const Shape_info& info = get_info();
 	const int qual = info.has_quality() && !info.is_npc() ? get_quality() : -1;
 	const Frame_name_info* nminf = info.get_frame_name(get_framenum(), qual);
@@ -149,7 +196,7 @@ string Game_object::get_name() const {
 	const int   type    = nminf ? nminf->get_type() : -255;
 	int         msgid;
 	if (type < 0 && type != -255) {    // This is a "catch all" default.
-		return "";                     // None.
+		return {};                     // None.
 	} else if (
 			type == -255
 			|| (msgid = nminf->get_msgid()) >= get_num_misc_names()) {
@@ -193,20 +240,19 @@ string Game_object::get_name() const {
 			if (othermsg >= 0 && othermsg < get_num_misc_names()) {
 				name = get_misc_name(othermsg);
 			} else if (othermsg < 0 && othermsg != -255) {    // None.
-				return "";
+				return {};
 			} else {    // Use shape's.
 				name = shpname;
 			}
 		} else if (type & 1) {
-			return other + msg;
+			return intern_name(other + msg);
 		} else {
-			return msg + other;
+			return intern_name(msg + other);
 		}
 	}
-	int    quantity;
-	string display_name;
+	int quantity;
 	if (name == nullptr) {
-		return "";
+		return {};
 	}
 
 	if (ShapeID::get_info(shnum).has_quantity()) {
@@ -214,6 +260,15 @@ string Game_object::get_name() const {
 	} else {
 		quantity = 1;
 	}
+	if (quantity < 1) {    // Named as for one.
+		quantity = 1;
+	}
+	Check_names_version();
+	auto found = composed_names.find(Name_key{name, quantity});
+	if (found != composed_names.end()) {
+		return found->second;
+	}
+	string& display_name = composed_names[Name_key{name, quantity}];
 
 	// If there are no slashes then it is simpler
 	if (strchr(name, '/') == nullptr) {
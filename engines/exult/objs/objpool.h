@@ -0,0 +1,134 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef OBJPOOL_H
+#define OBJPOOL_H 1
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*
+ *  Memory for one type, taken from the heap a slab at a time.  Freed
+ *  blocks go on a free list for the next ones, and slabs are kept until
+ *  exit: a superchunk that is dropped leaves its memory for the next one
+ *  loaded.  The last reference to an object may go on any thread, so the
+ *  pool is locked.
+ */
+template <class T>
+class Object_slab_pool {
+	static constexpr size_t slab_size = 64;    // Blocks per slab.
+
+	union Block {
+		Block* next;
+		alignas(T) unsigned char data[sizeof(T)];
+	};
+
+	std::mutex                            mutex;
+	Block*                                free_list = nullptr;
+	std::vector<std::unique_ptr<Block[]>> slabs;
+
+	Object_slab_pool() = default;
+
+public:
+	Object_slab_pool(const Object_slab_pool&)            = delete;
+	Object_slab_pool& operator=(const Object_slab_pool&) = delete;
+
+	static Object_slab_pool& get() {
+		// Never destroyed, as objects may be freed by other statics'
+		//   destructors.
+		static auto* pool = new Object_slab_pool;
+		return *pool;
+	}
+
+	void* allocate() {
+		const std::lock_guard<std::mutex> lock(mutex);
+		if (!free_list) {
+			slabs.push_back(std::make_unique<Block[]>(slab_size));
+			Block* slab = slabs.back().get();
+			for (size_t i = 0; i < slab_size; i++) {
+				slab[i].next = free_list;
+				free_list    = &slab[i];
+			}
+		}
+		Block* block = free_list;
+		free_list    = block->next;
+		return block->data;
+	}
+
+	void release(void* ptr) noexcept {
+		const std::lock_guard<std::mutex> lock(mutex);
+		auto* block = static_cast<Block*>(ptr);
+		block->next = free_list;
+		free_list   = block;
+	}
+};
+
+/*
+ *  For std::allocate_shared, which rebinds it to the type holding both
+ *  the object and its reference counts: each class of object gets a pool
+ *  of its own.
+ */
+template <class T>
+class Object_allocator {
+public:
+	using value_type = T;
+
+	Object_allocator() = default;
+
+	template <class U>
+	Object_allocator(const Object_allocator<U>&) noexcept {}
+
+	T* allocate(size_t n) {
+		if (n != 1) {
+			return std::allocator<T>().allocate(n);
+		}
+		return static_cast<T*>(Object_slab_pool<T>::get().allocate());
+	}
+
+	void deallocate(T* ptr, size_t n) noexcept {
+		if (n != 1) {
+			std::allocator<T>().deallocate(ptr, n);
+		} else {
+			Object_slab_pool<T>::get().release(ptr);
+		}
+	}
+
+	template <class U>
+	bool operator==(const Object_allocator<U>&) const noexcept {
+		return true;
+	}
+
+	template <class U>
+	bool operator!=(const Object_allocator<U>&) const noexcept {
+		return false;
+	}
+};
+
+/*
+ *  Like std::make_shared, for the objects read with the map.
+ */
+template <class T, class... Args>
+std::shared_ptr<T> Make_pooled_object(Args&&... args) {
+	return std::allocate_shared<T>(
+			Object_allocator<T>(), std::forward<Args>(args)...);
+}
+
+#endif
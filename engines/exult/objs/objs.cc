@@ -354,6 +354,25 @@ int Game_object::get_quantity() const {
 	}
 }
 
+/*
+ *  Set shape, telling the owner, which counts what it holds by shape.
+ */
+
+void Game_object::set_shape(int shnum, int frnum) {
+	Container_game_object* owner = get_owner();
+	if (owner && shnum != get_shapenum()) {
+		owner->recount_shape(get_shapenum(), shnum);
+	} else if (chunk && shnum != get_shapenum() && !as_actor()) {
+		chunk->index_object(this, get_shapenum(), false);
+		chunk->index_object(this, shnum, true);
+	}
+	ShapeID::set_shape(shnum, frnum);
+}
+
+void Game_object::set_shape(int shnum) {
+	set_shape(shnum, get_framenum());
+}
+
 /*
  *  Get effective maximum range for weapon.
  */
@@ -510,6 +529,7 @@ int Game_object::modify_quantity(
 	}
 	const int oldvol = get_volume();                   // Get old volume used.
 	quality          = static_cast<char>(newquant);    // Store new value.
+	set_ireg_dirty();
 	// Set appropriate frame.
 	if (get_info().has_weapon_info()) {    // Starbursts, serpent(ine) daggers,
 										   // knives.
@@ -590,6 +610,7 @@ void Game_object::move(int newtx, int newty, int newlift, int newmap) {
 
 void Game_object::change_frame(int frnum) {
 	gwin->add_dirty(this);    // Set to repaint old area.
+	set_ireg_dirty();
 							  // Track brightness change when changing frames
 	const int old_brightness = get_info().get_object_light(get_framenum());
 
@@ -966,6 +987,22 @@ Game_object* Game_object::get_outermost() {
 	return top;
 }
 
+/*
+ *  Flag the superchunk whose "ireg" this is saved in, if any, so the next
+ *  save writes it.  NPCs and what they carry are saved elsewhere.
+ */
+
+void Game_object::set_ireg_dirty() {
+	const Game_object* top = get_outermost();
+	if (top->as_actor()) {
+		return;
+	}
+	const Map_chunk* chk = top->get_chunk();
+	if (chk) {
+		chk->get_map()->set_ireg_dirty(chk->get_cx(), chk->get_cy());
+	}
+}
+
 /*
  *  Show text by the object on the screen.
  */
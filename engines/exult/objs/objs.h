@@ -36,6 +36,7 @@
 #include <memory>
 #include <set>
 #include <string>    // STL string
+#include <string_view>
 
 class Actor;
 class Map_chunk;
@@ -162,6 +163,7 @@ public:
 
 	virtual void set_quality(int q) {
 		quality = q;
+		set_ireg_dirty();
 	}
 
 	int get_quantity() const;    // Like # of coins.
@@ -173,6 +175,10 @@ public:
 	// Add/remove to/from quantity.
 	int modify_quantity(int delta, bool* del = nullptr);
 
+	// Set shape, keeping owners' counts of what they hold right.
+	void set_shape(int shnum, int frnum);
+	void set_shape(int shnum);    // Keep old frame #.
+
 	// Set shape coord. in chunk/gump.
 	void set_shape_pos(unsigned int shapex, unsigned int shapey) {
 		tx = shapex;
@@ -315,6 +321,8 @@ public:
 	const Game_object* get_outermost()
 			const;                         // Get top 'owner' of this object.
 	Game_object* get_outermost();          // Get top 'owner' of this object.
+	// Flag the "ireg" this is saved in as needing to be written.
+	void set_ireg_dirty();
 	void         say(const char* text);    // Put text up by item.
 	void         say(int msgnum);          // Show given text msg.
 	void         say(int from, int to);    // Show random msg. from 'text.flx'.
@@ -334,8 +342,16 @@ public:
 	virtual void activate(int event = 1);
 	virtual bool edit();    // Edit in ExultStudio.
 	// Saved from ExultStudio.
-	static void         update_from_studio(unsigned char* data, int datalen);
-	virtual std::string get_name() const;
+	static void update_from_studio(unsigned char* data, int datalen);
+
+	std::string get_name() const {
+		return std::string(get_name_view());
+	}
+
+	// The name, kept until the game's text changes.
+	virtual std::string_view get_name_view() const;
+	// Keep a name made some other way in the same store.
+	static std::string_view intern_name(const std::string& name);
 	// Remove/delete this object.
 	virtual void remove_this(Game_object_shared* keep = nullptr);
 
@@ -43,20 +43,21 @@ public:
 
 private:
 	void init(const Game_object* obj) {
-		const Tile_coord t = obj->get_tile();
-		tx                 = t.tx;
-		ty                 = t.ty;
-		tz                 = t.tz;
-		const int frnum    = obj->get_framenum();
-		xs                 = info.get_3d_xtiles(frnum);
-		ys                 = info.get_3d_ytiles(frnum);
-		zs                 = info.get_3d_height();
-		xleft              = tx - xs + 1;
-		xright             = tx;
-		yfar               = ty - ys + 1;
-		ynear              = ty;
-		ztop               = tz + zs - 1;
-		zbot               = tz;
+		const Tile_coord t        = obj->get_tile();
+		tx                        = t.tx;
+		ty                        = t.ty;
+		tz                        = t.tz;
+		const int frnum           = obj->get_framenum();
+		const Shape_hot_info& hot = obj->get_hot_info();
+		xs                        = hot.get_3d_xtiles(frnum);
+		ys                        = hot.get_3d_ytiles(frnum);
+		zs                        = hot.get_3d_height();
+		xleft                     = tx - xs + 1;
+		xright                    = tx;
+		yfar                      = ty - ys + 1;
+		ynear                     = ty;
+		ztop                      = tz + zs - 1;
+		zbot                      = tz;
 		if (!zs) {    // Flat?
 			zbot--;
 		}
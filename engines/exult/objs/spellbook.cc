@@ -167,6 +167,7 @@ int Spellbook_object::add_spell(int spell    // 0-71
 		return 0;    // Already have it.
 	}
 	circles[circle] |= (1 << num);
+	set_ireg_dirty();
 	return 1;
 }
 
@@ -176,6 +177,7 @@ int Spellbook_object::add_spell(int spell    // 0-71
 
 void Spellbook_object::clear_spells() {
 	memset(circles, 0, sizeof(circles));
+	set_ireg_dirty();
 }
 
 /*
@@ -192,6 +194,7 @@ int Spellbook_object::remove_spell(int spell    // 0-71
 		return 0;    // Already does not have it.
 	}
 	circles[circle] ^= (1 << num);
+	set_ireg_dirty();
 	return 1;
 }
 
@@ -51,6 +51,7 @@ public:
 
 	void set_target_pos(const Tile_coord& t) {    // Set/get position.
 		pos = t;
+		set_ireg_dirty();
 	}
 
 	void set_target_pos(
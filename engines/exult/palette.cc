@@ -23,7 +23,7 @@
 #include "palette.h"
 
 #include "exceptions.h"
-#include "files/U7file.h"
+#include "U7file.h"
 #include "fnames.h"
 #include "game.h"
 #include "gameclk.h"
@@ -24,10 +24,12 @@
 #include <vector>
 
 class Astar : public PathFinder {
+protected:
 	std::vector<Tile_coord> path;              // Coords. to goal.
 	int                     dir        = 0;    // 1 or -1.
 	int                     stop       = 0;    // Index to stop at.
 	int                     next_index = 0;    // Index of next tile to return.
+
 public:
 	// Find a path from sx,sy,sz to dx,dy,dz
 	// Return false if no path can be traced.
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (C) 2025  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "Async_astar.h"
+
+#include "chunks.h"
+#include "path.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ *  A path to be found on a worker thread.  Only 'client', 'src' and
+ *  'dest' are used there; the rest is guarded by the worker's mutex.
+ */
+struct Async_astar::Request {
+	std::unique_ptr<Pathfinder_client> client;    // A snapshot().
+	Tile_coord                         src, dest;
+	std::vector<Tile_coord>            path;
+	bool                               success   = false;
+	bool                               done      = false;
+	bool                               cancelled = false;
+};
+
+namespace {
+	/*
+	 *  Worker threads that find the paths.
+	 */
+	class Path_worker {
+		using Request = Async_astar::Request;
+		std::vector<std::thread> workers;    // Started as needed.
+		unsigned                 max_workers;
+		unsigned                 busy = 0;    // Workers finding paths.
+		std::mutex               mutex;
+		std::condition_variable  work_ready;
+		bool                     quit = false;
+		std::deque<std::shared_ptr<Request>> queue;
+
+		void run();
+
+	public:
+		Path_worker();
+		~Path_worker();
+		Path_worker(const Path_worker&)            = delete;
+		Path_worker& operator=(const Path_worker&) = delete;
+
+		static Path_worker& get_instance() {
+			static Path_worker instance;
+			return instance;
+		}
+
+		std::mutex& get_mutex() {
+			return mutex;
+		}
+
+		// Queue a path to be found.
+		void add(std::shared_ptr<Request> req);
+	};
+
+	/*
+	 *  Create, with up to one worker for each core (but no more than 2).
+	 */
+
+	Path_worker::Path_worker()
+			: max_workers(
+					  std::clamp(std::thread::hardware_concurrency(), 1u, 2u)) {
+	}
+
+	/*
+	 *  Stop the workers.
+	 */
+
+	Path_worker::~Path_worker() {
+		{
+			const std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+			queue.clear();
+		}
+		work_ready.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	/*
+	 *  Find queued paths until told to quit.
+	 */
+
+	void Path_worker::run() {
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			work_ready.wait(lock, [this] {
+				return quit || !queue.empty();
+			});
+			if (quit) {
+				return;
+			}
+			auto req = std::move(queue.front());
+			queue.pop_front();
+			if (req->cancelled) {
+				continue;
+			}
+			busy++;
+			lock.unlock();
+			auto [path, success]
+					= Find_path(req->src, req->dest, req->client.get());
+			lock.lock();
+			busy--;
+			req->path    = std::move(path);
+			req->success = success;
+			req->done    = true;
+			req->client.reset();
+		}
+	}
+
+	/*
+	 *  Queue a path to be found.
+	 */
+
+	void Path_worker::add(std::shared_ptr<Request> req) {
+		{
+			const std::lock_guard<std::mutex> lock(mutex);
+			queue.push_back(std::move(req));
+			// Another worker if all are busy.
+			if (workers.size() < max_workers
+				&& busy + queue.size() > workers.size()) {
+				workers.emplace_back(&Path_worker::run, this);
+			}
+		}
+		work_ready.notify_one();
+	}
+}    // namespace
+
+/*
+ *  Forget about the path being found.
+ */
+
+Async_astar::~Async_astar() {
+	cancel();
+}
+
+void Async_astar::cancel() {
+	if (request) {
+		const std::lock_guard<std::mutex> lock(
+				Path_worker::get_instance().get_mutex());
+		request->cancelled = true;
+	}
+	request = nullptr;
+}
+
+/*
+ *  Find path from source to destination, on a worker thread if the
+ *  client can make a snapshot.
+ *
+ *  Output: true if successful or being found, else false.
+ */
+bool Async_astar::NewPath(
+		const Tile_coord& s, const Tile_coord& d,
+		const Pathfinder_client* client) {
+	cancel();
+	backwards  = false;
+	path_found = true;
+	if (find_kept(s, d, client)) {
+		return true;
+	}
+	auto snap = client->snapshot(s, d);
+	if (!snap) {
+		return Hpastar::NewPath(s, d, client);
+	}
+	move_flags   = client->get_move_flags();
+	client_key   = client->get_path_key();
+	requested_at = Map_chunk::get_last_blocked_version();
+	src  = s;    // Store start, destination.
+	dest = d;
+	path.clear();
+	next_index      = 0;
+	dir             = 1;
+	stop            = 0;
+	request         = std::make_shared<Request>();
+	request->client = std::move(snap);
+	request->src    = s;
+	request->dest   = d;
+	Path_worker::get_instance().add(request);
+	return true;
+}
+
+/*
+ *  Is the path still being found?  If it's just arrived, it's set up
+ *  to be followed.
+ */
+bool Async_astar::is_pending() {
+	if (!request) {
+		return false;
+	}
+	{
+		const std::lock_guard<std::mutex> lock(
+				Path_worker::get_instance().get_mutex());
+		if (!request->done) {
+			return true;
+		}
+	}
+	path_found = request->success;
+	set_path(src, dest, std::move(request->path));
+	request = nullptr;
+	if (path_found) {
+		keep(move_flags, client_key, requested_at);
+	}
+	if (backwards) {
+		Astar::set_backwards();
+	}
+	return false;
+}
+
+/*
+ *  Get next point on path to go to (in tile coords).
+ *
+ *  Output: false if all done, or the path isn't there yet.
+ */
+bool Async_astar::GetNextStep(Tile_coord& n, bool& done) {
+	if (is_pending()) {
+		done = false;
+		return false;
+	}
+	return Astar::GetNextStep(n, done);
+}
+
+/*
+ *  Set to traverse backwards, now or when the path arrives.
+ *
+ *  Output: true always (we succeeded).
+ */
+bool Async_astar::set_backwards() {
+	if (is_pending()) {
+		backwards = true;
+		return true;
+	}
+	return Astar::set_backwards();
+}
+
+/*
+ *  Get # steps left, which is 0 until the path arrives.
+ */
+int Async_astar::get_num_steps() {
+	return is_pending() ? 0 : Astar::get_num_steps();
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2025  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef ASYNC_ASTAR_H
+#define ASYNC_ASTAR_H
+
+#include "Hpastar.h"
+
+#include <memory>
+
+/*
+ *  Hpastar that finds paths on a worker thread when the client can make
+ *  a snapshot() of what it needs and there's no kept path.  NewPath() then returns true right
+ *  away, and is_pending() says when the path is there; found() says if
+ *  one was.  Other clients get their paths right away, like Hpastar.
+ */
+class Async_astar : public Hpastar {
+public:
+	struct Request;
+
+private:
+	std::shared_ptr<Request> request;            // Being found.
+	bool                     path_found = true;
+	bool                     backwards  = false;    // set_backwards() called.
+	// For keeping the path when it's found.
+	int    move_flags   = 0;
+	int    client_key   = -1;
+	uint32 requested_at = 0;    // Map_chunk::get_last_blocked_version().
+	void   cancel();
+
+public:
+	Async_astar() = default;
+	~Async_astar() override;
+	Async_astar(const Async_astar&)            = delete;
+	Async_astar& operator=(const Async_astar&) = delete;
+
+	bool NewPath(
+			const Tile_coord& s, const Tile_coord& d,
+			const Pathfinder_client* client) override;
+
+	// Retrieve the coordinates of the next step on the path
+	bool GetNextStep(Tile_coord& n, bool& done) override;
+	// Set to retrieve in opposite order.
+	bool set_backwards() override;
+	int  get_num_steps() override;    // # of steps left to take.
+
+	bool is_pending() override;
+
+	bool found() override {
+		return !is_pending() && path_found;
+	}
+};
+
+#endif
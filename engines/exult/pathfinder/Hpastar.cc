@@ -0,0 +1,231 @@
+/*
+ *  Copyright (C) 2025  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "Hpastar.h"
+
+#include "chunks.h"
+#include "gamemap.h"
+#include "gamewin.h"
+#include "path.h"
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+	/*
+	 *  The chunks of the current map.
+	 */
+	class Map_versions : public Chunk_versions {
+		Game_map* map;
+
+	public:
+		explicit Map_versions(Game_map* m) : map(m) {}
+
+		uint32 get_version(int cx, int cy) const override {
+			return map->get_chunk(cx, cy)->get_blocked_version();
+		}
+
+		int get_map_num() const override {
+			return map->get_num();
+		}
+	};
+
+	/*
+	 *  What a kept path was found for.
+	 */
+	struct Path_key {
+		Tile_coord src, dest;
+		int        map_num;
+		int        move_flags;
+		int        client_key;    // Pathfinder_client::get_path_key().
+
+		bool operator==(const Path_key& k) const {
+			return src == k.src && dest == k.dest && map_num == k.map_num
+				   && move_flags == k.move_flags && client_key == k.client_key;
+		}
+	};
+
+	struct Path_key_hash {
+		size_t operator()(const Path_key& k) const {
+			const size_t src  = (k.src.tz * c_num_tiles + k.src.ty) * c_num_tiles
+								+ k.src.tx;
+			const size_t dest = (k.dest.tz * c_num_tiles + k.dest.ty)
+									* c_num_tiles
+								+ k.dest.tx;
+			return ((src * 31 + dest) * 31 + k.move_flags) * 31 + k.client_key;
+		}
+	};
+
+	struct Kept_path {
+		Path_key                key;
+		std::vector<Tile_coord> path;
+		// Chunks it goes through, and their versions then.
+		std::vector<std::pair<int, uint32>> chunks;    // (cy * 256 + cx).
+	};
+
+	// Keep this many paths, dropping the least recently used.
+	constexpr const size_t c_max_kept_paths = 256;
+
+	std::list<Kept_path> kept_paths;    // Most recently used first.
+	std::unordered_map<Path_key, std::list<Kept_path>::iterator, Path_key_hash>
+			 kept_lookup;
+	unsigned kept_hits   = 0;
+	unsigned kept_misses = 0;
+
+	/*
+	 *  Get the key for a path, if it can be kept.
+	 *
+	 *  Output: false if it can't.
+	 */
+
+	bool Get_path_key(
+			const Tile_coord& s, const Tile_coord& d, int move_flags,
+			int client_key, Path_key& key) {
+		// -1's mean a client that just cares about one coord.
+		if (client_key < 0 || s.tx < 0 || s.ty < 0 || d.tx < 0 || d.ty < 0) {
+			return false;
+		}
+		key = {s, d, Game_window::get_instance()->get_map()->get_num(),
+			   move_flags, client_key};
+		return true;
+	}
+}    // namespace
+
+/*
+ *  Follow a new path from the start.
+ */
+void Hpastar::set_path(
+		const Tile_coord& s, const Tile_coord& d,
+		std::vector<Tile_coord>&& p) {
+	src        = s;    // Store start, destination.
+	dest       = d;
+	path       = std::move(p);
+	next_index = 0;
+	dir        = 1;
+	stop       = path.size();
+}
+
+/*
+ *  Use a kept path, if there's one and nothing's changed in its chunks.
+ *
+ *  Output: true if there was.
+ */
+bool Hpastar::find_kept(
+		const Tile_coord& s, const Tile_coord& d,
+		const Pathfinder_client* client) {
+	Path_key key;
+	if (!Get_path_key(
+				s, d, client->get_move_flags(), client->get_path_key(), key)) {
+		return false;
+	}
+	auto it = kept_lookup.find(key);
+	if (it == kept_lookup.end()) {
+		kept_misses++;
+		return false;
+	}
+	Game_map* map = Game_window::get_instance()->get_map();
+	for (const auto& [chunk, version] : it->second->chunks) {
+		if (map->get_chunk(chunk % 256, chunk / 256)->get_blocked_version()
+			!= version) {
+			kept_paths.erase(it->second);    // Something moved.
+			kept_lookup.erase(it);
+			kept_misses++;
+			return false;
+		}
+	}
+	kept_paths.splice(kept_paths.begin(), kept_paths, it->second);
+	kept_hits++;
+	std::vector<Tile_coord> p = it->second->path;
+	set_path(s, d, std::move(p));
+	return true;
+}
+
+/*
+ *  Keep the path just found.
+ */
+void Hpastar::keep(
+		int move_flags, int client_key,
+		uint32 since    // Map_chunk::get_last_blocked_version() when the
+						//   search started.
+) {
+	Path_key key;
+	if (path.empty()
+		|| !Get_path_key(src, dest, move_flags, client_key, key)) {
+		return;
+	}
+	Kept_path kept{key, path, {}};
+	Game_map* map = Game_window::get_instance()->get_map();
+	for (const auto& t : path) {
+		const int chunk = (t.ty / c_tiles_per_chunk) * 256
+						  + t.tx / c_tiles_per_chunk;
+		if (!kept.chunks.empty() && kept.chunks.back().first == chunk) {
+			continue;
+		}
+		const uint32 version
+				= map->get_chunk(chunk % 256, chunk / 256)->get_blocked_version();
+		if (version > since) {
+			return;    // Changed while the path was being found.
+		}
+		kept.chunks.emplace_back(chunk, version);
+	}
+	auto it = kept_lookup.find(key);
+	if (it != kept_lookup.end()) {
+		kept_paths.erase(it->second);
+		kept_lookup.erase(it);
+	} else if (kept_paths.size() >= c_max_kept_paths) {
+		kept_lookup.erase(kept_paths.back().key);
+		kept_paths.pop_back();
+	}
+	kept_paths.push_front(std::move(kept));
+	kept_lookup[key] = kept_paths.begin();
+}
+
+/*
+ *  Find path from source to destination.
+ *
+ *  Output: true if successful, else false.
+ */
+bool Hpastar::NewPath(
+		const Tile_coord& s, const Tile_coord& d,
+		const Pathfinder_client* client) {
+	if (find_kept(s, d, client)) {
+		return true;
+	}
+	const uint32       since = Map_chunk::get_last_blocked_version();
+	const Map_versions versions(Game_window::get_instance()->get_map());
+	auto [new_path, success] = Find_path_by_chunks(s, d, client, versions);
+	set_path(s, d, std::move(new_path));
+	if (success) {
+		keep(client->get_move_flags(), client->get_path_key(), since);
+	}
+	return success;
+}
+
+/*
+ *  Get how often kept paths were used.
+ */
+void Hpastar::get_kept_stats(unsigned& hits, unsigned& misses) {
+	hits   = kept_hits;
+	misses = kept_misses;
+}
+
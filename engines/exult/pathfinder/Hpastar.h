@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2025  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef HPASTAR_H
+#define HPASTAR_H
+
+#include "Astar.h"
+
+#include "common_types.h"
+
+/*
+ *  Astar that finds long paths through a graph of the entrances of the
+ *  current map's chunks.  Short ones are found just like Astar.  Paths
+ *  found are kept for reuse while nothing changes in their chunks.
+ */
+class Hpastar : public Astar {
+protected:
+	// Use a kept path if there's one.
+	bool find_kept(
+			const Tile_coord& s, const Tile_coord& d,
+			const Pathfinder_client* client);
+	// Keep the path just found for a client with these move flags and
+	// path key, unless one of its chunks changed after the given
+	// Map_chunk::get_last_blocked_version().
+	void keep(int move_flags, int client_key, uint32 since);
+	// Follow a new path from the start.
+	void set_path(
+			const Tile_coord& s, const Tile_coord& d,
+			std::vector<Tile_coord>&& p);
+
+public:
+	bool NewPath(
+			const Tile_coord& s, const Tile_coord& d,
+			const Pathfinder_client* client) override;
+	// For the cheat screen.
+	static void get_kept_stats(unsigned& hits, unsigned& misses);
+};
+
+#endif
@@ -22,6 +22,8 @@
 
 #include "PathFinder.h"
 
+#include "ignore_unused_variable_warning.h"
+
 /*
  *  Given the estimated cost from start to goal, figure the max. cost
  *  before the pathfinder should quit.
@@ -44,3 +46,15 @@ bool Pathfinder_client::at_goal(
 	return tile.tx == goal.tx && tile.ty == goal.ty
 		   && (goal.tz == -1 || tile.tz == goal.tz);
 }
+
+/*
+ *  Get a copy for finding a path on another thread.
+ *
+ *  Output: nullptr, since clients look at the game's state by default.
+ */
+
+std::unique_ptr<Pathfinder_client> Pathfinder_client::snapshot(
+		const Tile_coord& from, const Tile_coord& to) const {
+	ignore_unused_variable_warning(from, to);
+	return nullptr;
+}
@@ -21,6 +21,8 @@
 
 #include "tiles.h"
 
+#include <memory>
+
 /*
  *  This class provides A* cost methods.
  */
@@ -46,6 +48,21 @@ public:
 			= 0;
 	// Is tile at the goal?
 	virtual bool at_goal(const Tile_coord& tile, const Tile_coord& goal) const;
+	// Do steps onto ordinary tiles all cost 2 straight and 3 diagonal,
+	// without changing lift?  Then open runs can be jumped over.
+	virtual bool has_uniform_cost() const {
+		return false;
+	}
+	// Clients with the same move flags and key find the same paths
+	// between the same tiles.  -1 if their paths shouldn't be reused.
+	virtual int get_path_key() const {
+		return -1;
+	}
+
+	// Get a copy of what's needed to go from 'from' to 'to' that can be
+	// used on another thread, or nullptr if there's none.
+	virtual std::unique_ptr<Pathfinder_client> snapshot(
+			const Tile_coord& from, const Tile_coord& to) const;
 
 	int get_move_flags() const {
 		return move_flags;
@@ -101,6 +118,17 @@ public:
 		return false;
 	}
 
+	// Is the path still being found in the background?
+	virtual bool is_pending() {
+		return false;
+	}
+
+	// Was a path found?  Only false for one found in the background
+	// that couldn't be.
+	virtual bool found() {
+		return true;
+	}
+
 	virtual int get_num_steps() = 0;    // # of steps left to take.
 	virtual ~PathFinder()       = default;
 };
@@ -25,10 +25,19 @@
 #include "path.h"
 
 #include "PathFinder.h"
+#include "common_types.h"
 #include "exult_constants.h"
-#include "hash_utils.h"
+#include "ignore_unused_variable_warning.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <queue>
+#include <unordered_map>
 #include <vector>
 
 using std::cout;
@@ -68,6 +77,19 @@ public:
 int Neighbor_iterator::coords[16]
 		= {-1, -1, 0, -1, 1, -1, -1, 0, 1, 0, -1, 1, 0, 1, 1, 1};
 
+// The same, for jumping.
+static const int all_dirs[16]
+		= {-1, -1, 0, -1, 1, -1, -1, 0, 1, 0, -1, 1, 0, 1, 1, 1};
+
+/*
+ *  Get the tile one step away in a direction, wrapping around the world.
+ */
+static inline Tile_coord Step_tile(const Tile_coord& t, int dx, int dy) {
+	return Tile_coord(
+			(t.tx + dx + c_num_tiles) % c_num_tiles,
+			(t.ty + dy + c_num_tiles) % c_num_tiles, t.tz);
+}
+
 /*
  *  A node for our search:
  */
@@ -86,13 +108,16 @@ public:
 		total_cost = gcost + scost;
 	}
 
-	// For creating a key to search for.
-	Search_node(const Tile_coord& t) : tile(t) {}
+	Search_node() = default;    // For the arena.
 
 	Tile_coord get_tile() const {
 		return tile;
 	}
 
+	Search_node* get_parent() const {
+		return parent;
+	}
+
 	int get_start_cost() {
 		return start_cost;
 	}
@@ -132,6 +157,30 @@ public:
 		}
 		return result;
 	}
+
+	// Create path back to start, filling in the tiles jumped over.  They
+	// are in a straight or diagonal line at the lift jumped from.
+	std::vector<Tile_coord> create_jump_path() {
+		std::vector<Tile_coord> result;
+		for (Search_node* each = this; each->parent != nullptr;
+			 each              = each->parent) {
+			const Tile_coord& from  = each->parent->tile;
+			const int         dx    = Tile_coord::delta(from.tx, each->tile.tx);
+			const int         dy    = Tile_coord::delta(from.ty, each->tile.ty);
+			const int         steps = std::max(std::abs(dx), std::abs(dy));
+			result.push_back(each->tile);
+			for (int i = steps - 1; i > 0; i--) {
+				result.push_back(Tile_coord(
+						(from.tx + i * (dx / steps) + c_num_tiles)
+								% c_num_tiles,
+						(from.ty + i * (dy / steps) + c_num_tiles)
+								% c_num_tiles,
+						from.tz));
+			}
+		}
+		std::reverse(result.begin(), result.end());
+		return result;
+	}
 #ifdef VERIFYCHAIN
 	// Returns false if bad chain.
 	bool verify_chain(Search_node* last, bool removed = false) {
@@ -225,59 +274,162 @@ public:
 };
 
 /*
- *  Hash function for nodes:
+ *  Nodes for a search, handed out in order from blocks that are kept
+ *  for the next search.
  */
-class Hash_node {
+class Node_arena {
+	static constexpr const size_t block_size = 1024;
+	vector<std::unique_ptr<Search_node[]>> blocks;
+	size_t                                 used = 0;    // # handed out.
+
 public:
-	size_t operator()(const Search_node* a) const noexcept {
-		const Tile_coord t = a->get_tile();
-		return (t.tz << 24) + (t.ty << 12) + t.tx;
+	Search_node* alloc(
+			const Tile_coord& t, short scost, short gcost, Search_node* p) {
+		if (used == blocks.size() * block_size) {
+			blocks.push_back(std::make_unique<Search_node[]>(block_size));
+		}
+		Search_node* node = &blocks[used / block_size][used % block_size];
+		used++;
+		*node = Search_node(t, scost, gcost, p);
+		return node;
+	}
+
+	void reset() {    // Free all nodes.
+		used = 0;
 	}
 };
 
 /*
- *  For testing if two nodes match.
+ *  Finds each tile's node.  This is an open-addressed hash table keyed by
+ *  the packed coords, so looking up doesn't touch the nodes.  Slots from
+ *  an older search (by 'search') count as empty, so it's cleared for
+ *  free.
  */
-class Equal_nodes {
+class Node_table {
+	struct Slot {
+		uint64       key;
+		Search_node* node;
+		uint32       search;    // Search it was stored in.
+	};
+
+	vector<Slot> slots;
+	size_t       count  = 0;
+	uint32       search = 1;
+
+	static uint64 get_key(const Tile_coord& t) {
+		return (static_cast<uint64>(static_cast<uint16>(t.tz)) << 32)
+			   | (static_cast<uint64>(static_cast<uint16>(t.ty)) << 16)
+			   | static_cast<uint16>(t.tx);
+	}
+
+	size_t get_slot(uint64 key) const {    // Where to start looking.
+		return (key * 0x9e3779b97f4a7c15ULL >> 32) & (slots.size() - 1);
+	}
+
+	void grow() {
+		vector<Slot> old(slots.size() * 2, Slot{0, nullptr, 0});
+		old.swap(slots);
+		for (const Slot& each : old) {
+			if (each.search == search) {
+				size_t i = get_slot(each.key);
+				while (slots[i].search == search) {
+					i = (i + 1) & (slots.size() - 1);
+				}
+				slots[i] = each;
+			}
+		}
+	}
+
 public:
-	bool operator()(const Search_node* a, const Search_node* b) const noexcept {
-		const Tile_coord ta = a->get_tile();
-		const Tile_coord tb = b->get_tile();
-		return ta == tb;
+	Node_table() : slots(1024, Slot{0, nullptr, 0}) {}
+
+	void reset() {    // Forget all nodes.
+		count = 0;
+		if (++search == 0) {    // Wrapped, so really clear.
+			std::fill(slots.begin(), slots.end(), Slot{0, nullptr, 0});
+			search = 1;
+		}
+	}
+
+	void insert(Search_node* nd) {
+		if (2 * (count + 1) > slots.size()) {
+			grow();
+		}
+		const uint64 key = get_key(nd->get_tile());
+		size_t       i   = get_slot(key);
+		while (slots[i].search == search) {
+			i = (i + 1) & (slots.size() - 1);
+		}
+		slots[i] = Slot{key, nd, search};
+		count++;
+	}
+
+	Search_node* find(const Tile_coord& tile) const {
+		const uint64 key = get_key(tile);
+		size_t       i   = get_slot(key);
+		while (slots[i].search == search) {
+			if (slots[i].key == key) {
+				return slots[i].node;
+			}
+			i = (i + 1) & (slots.size() - 1);
+		}
+		return nullptr;
 	}
 };
 
+/*
+ *  What a search uses.  Kept between searches so they don't allocate.
+ */
+struct Search_storage {
+	vector<Search_node*> open;
+	Node_arena           nodes;
+	Node_table           lookup;
+	bool                 in_use = false;
+};
+
 /*
  *  The priority queue for the A* algorithm:
  */
 class A_star_queue {
-	vector<Search_node*> open;    // Nodes to be done, by priority. Each
-	//   is a ->last node in chain.
+	// Storage for one search at a time on each thread, and ours if we're
+	// not that one (a search started by a client while another is going).
+	static thread_local Search_storage shared;
+	std::unique_ptr<Search_storage>    own;
+	Search_storage&                    store;
+	vector<Search_node*>&              open;    // Nodes to be done, by
+	//   priority.  Each is a ->last node in chain.
 	int best;    // Index of 1st non-null ent. in open.
-	// For finding each tile's node:
-	using Lookup_set = std::unordered_set<Search_node*, Hash_node, Equal_nodes>;
-	Lookup_set lookup;
+
+	Search_storage& get_storage() {
+		if (shared.in_use) {
+			own = std::make_unique<Search_storage>();
+			return *own;
+		}
+		shared.in_use = true;
+		return shared;
+	}
 
 public:
-	A_star_queue() : open(256), lookup(1000) {
-		open.insert(open.begin(), 256, nullptr);
+	A_star_queue() : store(get_storage()), open(store.open) {
+		open.assign(512, nullptr);
 		best = open.size();    // Best is past end.
+		store.nodes.reset();
+		store.lookup.reset();
 	}
 
 	~A_star_queue() {
-		/*
-		This _should_ work, but might hang some hash_set implementations.
-		The problem is that on deleting the Search_node, the hash_set can
-		no longer properly evaluate the hash value (since the hash function
-		dereferences the Search_node* stored). This might cause an endless
-		loop.
-		*/
-		for (auto X = lookup.begin(); X != lookup.end();) {
-			Search_node* sn = *X;
-			++X;
-			delete sn;    // only delete this _after_ iterating
+		if (&store == &shared) {
+			shared.in_use = false;
 		}
-		lookup.clear();    // Remove all nodes.
+	}
+
+	A_star_queue(const A_star_queue&)            = delete;
+	A_star_queue& operator=(const A_star_queue&) = delete;
+
+	// Create a node.
+	Search_node* new_node(
+			const Tile_coord& t, short scost, short gcost, Search_node* p) {
+		return store.nodes.alloc(t, scost, gcost, p);
 	}
 
 	void add_open(int pri, Search_node* nd) {
@@ -300,7 +452,7 @@ public:
 	}
 
 	void add(Search_node* nd) {    // Add new node to 'open' set.
-		lookup.insert(nd);
+		store.lookup.insert(nd);
 		add_back(nd);
 	}
 
@@ -353,34 +505,141 @@ public:
 
 	// Find node for given tile.
 	Search_node* find(const Tile_coord& tile) {
-		Search_node        key(tile);
-		Search_node* const pkey = &key;
-		auto               it   = lookup.find(pkey);
-		if (it != lookup.end()) {
-			return *it;
-		} else {
-			return nullptr;
-		}
+		return store.lookup.find(tile);
 	}
 };
 
+thread_local Search_storage A_star_queue::shared;
+
 static bool tracing = false;
 
+static thread_local int nodes_expanded = 0;
+
+static std::atomic<Path_query_hook> query_hook{nullptr};
+
+/*
+ *  Remembers which tiles are plain, for a jump point search:  a step onto
+ *  them costs 2 (straight) at the same lift, so nothing's in the way.
+ */
+class Plain_tiles {
+	const Pathfinder_client*         client;
+	std::unordered_map<uint64, bool> known;
+
+public:
+	explicit Plain_tiles(const Pathfinder_client* c) : client(c) {}
+
+	bool is_plain(const Tile_coord& t) {
+		const uint64 key
+				= (static_cast<uint64>(static_cast<uint16>(t.tz)) << 32)
+				  | (static_cast<uint64>(static_cast<uint16>(t.ty)) << 16)
+				  | static_cast<uint16>(t.tx);
+		auto it = known.find(key);
+		if (it != known.end()) {
+			return it->second;
+		}
+		const Tile_coord from = Step_tile(t, -1, 0);
+		Tile_coord       to   = t;
+		const bool       plain
+				= client->get_step_cost(from, to) == 2 && to.tz == t.tz;
+		known.emplace(key, plain);
+		return plain;
+	}
+
+	// Are all 8 neighbors plain?
+	bool is_open_around(const Tile_coord& t) {
+		Neighbor_iterator get_next(t);
+		Tile_coord        ntile(0, 0, 0);
+		while (get_next(ntile)) {
+			if (!is_plain(ntile)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+/*
+ *  Jump from a tile in a direction over plain tiles, as long as nothing
+ *  interesting is passed.  A diagonal jump also stops where a straight one
+ *  from it would.  We stop at every tile that isn't surrounded by plain
+ *  tiles, so what's beyond them is searched a tile at a time.
+ *
+ *  Output: true if a tile to go on from was found, with its cost from
+ *  the start.
+ */
+
+static bool Jump(
+		Plain_tiles& plain, const Pathfinder_client* client,
+		const Tile_coord& goal, const Tile_coord& from, int dx, int dy,
+		int cost,        // Cost from start to 'from'.
+		int max_cost,    // Give up when reaching this.
+		Tile_coord& found, int& found_cost) {
+	const int  step_cost = (dx && dy) ? 3 : 2;
+	Tile_coord tile      = from;
+	for (;;) {
+		tile = Step_tile(tile, dx, dy);
+		cost += step_cost;
+		if (!plain.is_plain(tile)
+			|| cost + client->estimate_cost(tile, goal) >= max_cost) {
+			return false;
+		}
+		bool stop = client->at_goal(tile, goal) || !plain.is_open_around(tile);
+		if (!stop && dx && dy) {
+			Tile_coord straight;
+			int        straight_cost;
+			stop = Jump(plain, client, goal, tile, dx, 0, cost, max_cost,
+						straight, straight_cost)
+				   || Jump(plain, client, goal, tile, 0, dy, cost, max_cost,
+						   straight, straight_cost);
+		}
+		if (stop) {
+			found      = tile;
+			found_cost = cost;
+			return true;
+		}
+	}
+}
+
+/*
+ *  Get the nodes expanded by the last search on this thread.
+ */
+
+int Get_path_nodes_expanded() {
+	return nodes_expanded;
+}
+
+/*
+ *  Set the function called after each search.
+ */
+
+void Set_path_query_hook(Path_query_hook hook) {
+	query_hook = hook;
+}
+
 /*
  *  First cut at using the A* pathfinding algorithm.
  *
  *  Output: pair<path vector, flag> where flag is true if path found.
  */
 
-std::pair<std::vector<Tile_coord>, bool> Find_path(
+static std::pair<std::vector<Tile_coord>, bool> Search_for_path(
 		const Tile_coord&        start,    // Where to start from.
 		const Tile_coord&        goal,     // Where to end up.
-		const Pathfinder_client* client    // Provides costs.
+		const Pathfinder_client* client,   // Provides costs.
+		int*                     cost,     // Cost of path returned here.
+		Path_search              search    // How to expand tiles.
 ) {
 	A_star_queue nodes;    // The priority queue & hash table.
-	int          max_cost = client->estimate_cost(start, goal);
+	const bool   jumping
+			= search == Path_search::jump_points && client->has_uniform_cost();
+	std::unique_ptr<Plain_tiles> plain;
+	if (jumping) {
+		plain = std::make_unique<Plain_tiles>(client);
+	}
+	nodes_expanded = 0;
+	int max_cost   = client->estimate_cost(start, goal);
 	// Create start node.
-	nodes.add(new Search_node(start, 0, max_cost, nullptr));
+	nodes.add(nodes.new_node(start, 0, max_cost, nullptr));
 	// Figure when to give up.
 	max_cost = client->get_max_cost(max_cost);
 	Search_node* node;    // Try 'best' node each iteration.
@@ -394,20 +653,76 @@ std::pair<std::vector<Tile_coord>, bool> Find_path(
 		const Tile_coord curtile = node->get_tile();
 		if (client->at_goal(curtile, goal)) {
 			// Success.
-			return {node->create_path(), true};
+			if (cost) {
+				*cost = node->get_start_cost();
+			}
+			return {jumping ? node->create_jump_path() : node->create_path(),
+					true};
+		}
+		nodes_expanded++;
+		// Directions to jump in, as (dx, dy) pairs.  All 8 for the start,
+		//   and next to anything that's not plain; otherwise only those
+		//   that can't be reached better without going through here.
+		int dirs[16];
+		int ndirs = 0;
+		if (jumping) {
+			Search_node* parent = node->get_parent();
+			if (parent && parent->get_tile().tz == curtile.tz
+				&& plain->is_open_around(curtile)) {
+				const Tile_coord ptile = parent->get_tile();
+				int dx = Tile_coord::delta(ptile.tx, curtile.tx);
+				int dy = Tile_coord::delta(ptile.ty, curtile.ty);
+				dx     = (dx > 0) - (dx < 0);
+				dy     = (dy > 0) - (dy < 0);
+				if (dx && dy) {
+					const int diag[6] = {dx, 0, 0, dy, dx, dy};
+					std::copy(diag, diag + 6, dirs);
+					ndirs = 3;
+				} else {
+					dirs[0] = dx;
+					dirs[1] = dy;
+					ndirs   = 1;
+				}
+			} else {
+				std::copy(all_dirs, all_dirs + 16, dirs);
+				ndirs = 8;
+			}
 		}
 		// Go through surrounding tiles.
 		Neighbor_iterator get_next(curtile);
 		Tile_coord        ntile(0, 0, 0);
-		while (get_next(ntile)) {
-			// Get cost to next tile.
-			const int step_cost = client->get_step_cost(curtile, ntile);
-			// Blocked?
-			if (step_cost == -1) {
-				continue;
+		int               next_dir = 0;
+		while (jumping ? next_dir < ndirs : get_next(ntile) != 0) {
+			int new_cost;
+			if (jumping) {
+				const int dx = dirs[2 * next_dir];
+				const int dy = dirs[2 * next_dir + 1];
+				next_dir++;
+				ntile = Step_tile(curtile, dx, dy);
+				if (plain->is_plain(ntile)) {
+					if (!Jump(*plain, client, goal, curtile, dx, dy,
+							  node->get_start_cost(), max_cost, ntile,
+							  new_cost)) {
+						continue;
+					}
+				} else {
+					// Not plain, so take a single step.
+					const int step_cost = client->get_step_cost(curtile, ntile);
+					if (step_cost == -1) {
+						continue;
+					}
+					new_cost = node->get_start_cost() + step_cost;
+				}
+			} else {
+				// Get cost to next tile.
+				const int step_cost = client->get_step_cost(curtile, ntile);
+				// Blocked?
+				if (step_cost == -1) {
+					continue;
+				}
+				// Get cost from start to ntile.
+				new_cost = node->get_start_cost() + step_cost;
 			}
-			// Get cost from start to ntile.
-			const int new_cost = node->get_start_cost() + step_cost;
 			// See if next tile already seen.
 			Search_node* next = nodes.find(ntile);
 			// Already there, and cheaper?
@@ -420,7 +735,7 @@ std::pair<std::vector<Tile_coord>, bool> Find_path(
 				continue;
 			}
 			if (!next) {    // Create if necessary.
-				next = new Search_node(ntile, new_cost, new_goal_cost, node);
+				next = nodes.new_node(ntile, new_cost, new_goal_cost, node);
 				nodes.add(next);
 			} else {
 				// It's going to move.
@@ -433,3 +748,377 @@ std::pair<std::vector<Tile_coord>, bool> Find_path(
 	// Failed if here.
 	return {{}, false};
 }
+
+/*
+ *  Find a path, telling the query hook about it if there is one.
+ *
+ *  Output: pair<path vector, flag> where flag is true if path found.
+ */
+
+std::pair<std::vector<Tile_coord>, bool> Find_path(
+		const Tile_coord&        start,    // Where to start from.
+		const Tile_coord&        goal,     // Where to end up.
+		const Pathfinder_client* client,   // Provides costs.
+		int*                     cost,     // Cost of path returned here.
+		Path_search              search    // How to expand tiles.
+) {
+	const Path_query_hook hook = query_hook;
+	if (!hook) {
+		return Search_for_path(start, goal, client, cost, search);
+	}
+	using query_clock = std::chrono::steady_clock;
+	const query_clock::time_point began = query_clock::now();
+	int  path_cost = -1;
+	auto result    = Search_for_path(start, goal, client, &path_cost, search);
+	const long usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+							   query_clock::now() - began)
+							   .count();
+	if (cost && result.second) {
+		*cost = path_cost;
+	}
+	hook(Path_query{
+			start, goal, client, result.second,
+			result.second ? path_cost : -1, nodes_expanded, usecs});
+	return result;
+}
+
+/*
+ *  Keeps a search within one chunk.
+ */
+class Chunk_client : public Pathfinder_client {
+	const Pathfinder_client* client;
+	int                      cx, cy;    // The chunk.
+	bool                     to_goal;    // Use client's at_goal().
+
+public:
+	Chunk_client(const Pathfinder_client* c, int chx, int chy, bool g)
+			: Pathfinder_client(c->get_move_flags()), client(c), cx(chx),
+			  cy(chy), to_goal(g) {}
+
+	int get_max_cost(int cost_to_goal) const override {
+		ignore_unused_variable_warning(cost_to_goal);
+		// Enough to go all over the chunk.
+		return 16 * c_tiles_per_chunk * c_tiles_per_chunk;
+	}
+
+	int get_step_cost(const Tile_coord& from, Tile_coord& to) const override {
+		if (to.tx / c_tiles_per_chunk != cx
+			|| to.ty / c_tiles_per_chunk != cy) {
+			return -1;
+		}
+		return client->get_step_cost(from, to);
+	}
+
+	int estimate_cost(
+			const Tile_coord& from, const Tile_coord& to) const override {
+		return client->estimate_cost(from, to);
+	}
+
+	bool at_goal(const Tile_coord& tile, const Tile_coord& goal)
+			const override {
+		return to_goal ? client->at_goal(tile, goal) : tile == goal;
+	}
+
+	bool has_uniform_cost() const override {
+		return client->has_uniform_cost();
+	}
+};
+
+/*
+ *  The ways in and out of a chunk at one lift, and the costs between
+ *  them, for a given set of move flags.
+ */
+struct Chunk_graph {
+	uint32             versions[5];    // Chunk's, then N, E, S, W.
+	vector<Tile_coord> entrances;      // Tiles on the chunk's edges.
+	vector<Tile_coord> exits;          // Tile across from each.
+	vector<int>        exit_costs;     // Cost of stepping there.
+	vector<int>        costs;          // Entrance to entrance, or -1.
+};
+
+// Chunk offsets for N, E, S, W.
+static const int chunk_dx[4] = {0, 1, 0, -1};
+static const int chunk_dy[4] = {-1, 0, 1, 0};
+
+// Don't keep more graphs than this.
+constexpr const size_t c_max_chunk_graphs = 4096;
+// Use the graphs for paths at least this many chunks long.
+constexpr const int c_min_chunks_for_graph = 3;
+// Give up on the graphs after trying this many entrances.
+constexpr const int c_max_graph_nodes = 8192;
+
+static std::unordered_map<uint64, Chunk_graph> chunk_graphs;
+
+/*
+ *  Can we step from one tile to another at the same lift?
+ */
+
+static int Get_flat_step_cost(
+		const Pathfinder_client* client, const Tile_coord& from,
+		const Tile_coord& to) {
+	Tile_coord dest = to;
+	const int  cost = client->get_step_cost(from, dest);
+	return dest.tz == to.tz ? cost : -1;
+}
+
+/*
+ *  Add the crossings on one side of a chunk to its graph.  Each run of
+ *  tiles that can be crossed both ways gets one, in its middle, so the
+ *  chunk on the other side finds the same ones.
+ */
+
+static void Add_crossings(
+		Chunk_graph& graph, int cx, int cy,
+		int                      dir,    // 0-3 = N, E, S, W.
+		int                      lift,
+		const Pathfinder_client* client) {
+	const int  ends[4][2] = {{0, 0}, {c_tiles_per_chunk - 1, 0},
+							 {0, c_tiles_per_chunk - 1}, {0, 0}};
+	const bool along_x    = chunk_dy[dir] != 0;
+	const int  x0         = cx * c_tiles_per_chunk + ends[dir][0];
+	const int  y0         = cy * c_tiles_per_chunk + ends[dir][1];
+	int        run        = 0;    // Length of current run.
+	for (int i = 0; i <= c_tiles_per_chunk; i++) {
+		bool passable = false;
+		if (i < c_tiles_per_chunk) {
+			const Tile_coord in(
+					along_x ? x0 + i : x0, along_x ? y0 : y0 + i, lift);
+			const Tile_coord out(
+					(in.tx + chunk_dx[dir] + c_num_tiles) % c_num_tiles,
+					(in.ty + chunk_dy[dir] + c_num_tiles) % c_num_tiles,
+					lift);
+			passable = Get_flat_step_cost(client, in, out) >= 0
+					   && Get_flat_step_cost(client, out, in) >= 0;
+		}
+		if (passable) {
+			run++;
+			continue;
+		}
+		if (run) {    // Use the middle of the run.
+			const int        mid = i - run + (run - 1) / 2;
+			const Tile_coord in(
+					along_x ? x0 + mid : x0, along_x ? y0 : y0 + mid, lift);
+			const Tile_coord out(
+					(in.tx + chunk_dx[dir] + c_num_tiles) % c_num_tiles,
+					(in.ty + chunk_dy[dir] + c_num_tiles) % c_num_tiles,
+					lift);
+			graph.entrances.push_back(in);
+			graph.exits.push_back(out);
+			graph.exit_costs.push_back(Get_flat_step_cost(client, in, out));
+			run = 0;
+		}
+	}
+}
+
+/*
+ *  Get the graph for a chunk, making it if it's not there or what blocks
+ *  the chunk or its neighbors has changed.
+ */
+
+static Chunk_graph& Get_chunk_graph(
+		int cx, int cy, int lift, const Pathfinder_client* client,
+		const Chunk_versions& versions) {
+	const uint64 key
+			= (static_cast<uint64>(versions.get_map_num() & 0xffff) << 48)
+			  | (static_cast<uint64>(client->get_move_flags() & 0xffff) << 32)
+			  | (static_cast<uint64>(lift & 0xffff) << 16) | (cx << 8) | cy;
+	uint32 vers[5];
+	vers[0] = versions.get_version(cx, cy);
+	for (int dir = 0; dir < 4; dir++) {
+		vers[dir + 1] = versions.get_version(
+				(cx + chunk_dx[dir] + c_num_chunks) % c_num_chunks,
+				(cy + chunk_dy[dir] + c_num_chunks) % c_num_chunks);
+	}
+	auto it = chunk_graphs.find(key);
+	if (it != chunk_graphs.end()
+		&& std::equal(vers, vers + 5, it->second.versions)) {
+		return it->second;
+	}
+	if (it == chunk_graphs.end() && chunk_graphs.size() >= c_max_chunk_graphs) {
+		chunk_graphs.clear();
+	}
+	Chunk_graph& graph = chunk_graphs[key];
+	graph              = Chunk_graph();
+	for (int dir = 0; dir < 4; dir++) {
+		Add_crossings(graph, cx, cy, dir, lift, client);
+	}
+	const size_t       cnt = graph.entrances.size();
+	const Chunk_client inside(client, cx, cy, false);
+	graph.costs.assign(cnt * cnt, -1);
+	for (size_t i = 0; i < cnt; i++) {
+		graph.costs[i * cnt + i] = 0;
+		for (size_t j = i + 1; j < cnt; j++) {
+			int cost;
+			if (Find_path(graph.entrances[i], graph.entrances[j], &inside,
+						  &cost)
+						.second) {
+				graph.costs[i * cnt + j] = graph.costs[j * cnt + i] = cost;
+			}
+		}
+	}
+	// Making it may have read in objects.
+	graph.versions[0] = versions.get_version(cx, cy);
+	for (int dir = 0; dir < 4; dir++) {
+		graph.versions[dir + 1] = versions.get_version(
+				(cx + chunk_dx[dir] + c_num_chunks) % c_num_chunks,
+				(cy + chunk_dy[dir] + c_num_chunks) % c_num_chunks);
+	}
+	return graph;
+}
+
+/*
+ *  Find a long path by first finding the chunk entrances to pass through,
+ *  then the tiles within each chunk.  Falls back to Find_path() when the
+ *  ends are close together, on different lifts, or the chunks' graph
+ *  doesn't find a way.
+ *
+ *  Output: pair<path vector, flag> where flag is true if path found.
+ */
+
+std::pair<std::vector<Tile_coord>, bool> Find_path_by_chunks(
+		const Tile_coord&        start,     // Where to start from.
+		const Tile_coord&        goal,      // Where to end up.
+		const Pathfinder_client* client,    // Provides costs.
+		const Chunk_versions&    versions) {
+	const int scx = start.tx / c_tiles_per_chunk;
+	const int scy = start.ty / c_tiles_per_chunk;
+	const int gcx = goal.tx / c_tiles_per_chunk;
+	const int gcy = goal.ty / c_tiles_per_chunk;
+	const int dcx = Tile_coord::delta(scx, gcx);
+	const int dcy = Tile_coord::delta(scy, gcy);
+	if (start.tx < 0 || start.ty < 0 || goal.tx < 0 || goal.ty < 0
+		|| (goal.tz != start.tz && goal.tz != -1)
+		|| std::max(std::abs(dcx), std::abs(dcy)) < c_min_chunks_for_graph) {
+		return Find_path(start, goal, client);
+	}
+	const int lift = start.tz;
+	// A node is the start (0), the goal (1), or an entrance.
+	struct Node {
+		Tile_coord tile;
+		int        cost;      // From start.
+		int        parent;    // Node before, or -1.
+	};
+
+	vector<Node>                    nodes{{start, 0, -1}, {goal, -1, -1}};
+	std::unordered_map<uint64, int> lookup;    // Entrance tile -> node.
+	using Entry = std::pair<int, int>;         // (Total cost, node).
+	std::priority_queue<Entry, vector<Entry>, std::greater<>> open;
+	const int                                                 max_cost
+			= client->get_max_cost(client->estimate_cost(start, goal));
+	auto      get_key  = [](const Tile_coord& t) {
+		 return (static_cast<uint64>(static_cast<uint16>(t.tz)) << 32)
+				| (static_cast<uint64>(static_cast<uint16>(t.ty)) << 16)
+				| static_cast<uint16>(t.tx);
+	};
+	// Add a way to get to a tile.
+	auto reach = [&](const Tile_coord& t, int cost, int from, bool is_goal) {
+		int n = 1;
+		if (!is_goal) {
+			auto it = lookup.find(get_key(t));
+			if (it == lookup.end()) {
+				n = nodes.size();
+				lookup[get_key(t)] = n;
+				nodes.push_back({t, -1, -1});
+			} else {
+				n = it->second;
+			}
+		}
+		Node& node = nodes[n];
+		if (node.cost >= 0 && node.cost <= cost) {
+			return;
+		}
+		const int total = cost + client->estimate_cost(t, goal);
+		if (total >= max_cost) {
+			return;
+		}
+		node.cost   = cost;
+		node.parent = from;
+		open.emplace(total, n);
+	};
+	// Start to the entrances of its chunk.
+	{
+		const Chunk_graph& graph
+				= Get_chunk_graph(scx, scy, lift, client, versions);
+		const Chunk_client inside(client, scx, scy, false);
+		for (const auto& entrance : graph.entrances) {
+			int cost;
+			if (Find_path(start, entrance, &inside, &cost).second) {
+				reach(entrance, cost, 0, false);
+			}
+		}
+	}
+	const Chunk_client to_goal(client, gcx, gcy, true);
+	int                expanded = 0;
+	while (!open.empty()) {
+		const auto [total, n] = open.top();
+		open.pop();
+		if (n == 1) {
+			break;    // The goal.
+		}
+		const Node node = nodes[n];
+		if (total != node.cost + client->estimate_cost(node.tile, goal)) {
+			continue;    // We found a cheaper way since.
+		}
+		if (++expanded > c_max_graph_nodes) {
+			return Find_path(start, goal, client);
+		}
+		const int          cx    = node.tile.tx / c_tiles_per_chunk;
+		const int          cy    = node.tile.ty / c_tiles_per_chunk;
+		const Chunk_graph& graph
+				= Get_chunk_graph(cx, cy, lift, client, versions);
+		const size_t       cnt   = graph.entrances.size();
+		size_t             i     = 0;
+		while (i < cnt && graph.entrances[i] != node.tile) {
+			i++;
+		}
+		if (i == cnt) {
+			continue;    // Chunk changed, so it's gone.
+		}
+		// Other entrances, and across to the next chunk.
+		for (size_t j = 0; j < cnt; j++) {
+			const int cost = graph.costs[i * cnt + j];
+			if (j != i && cost >= 0) {
+				reach(graph.entrances[j], node.cost + cost, n, false);
+			}
+		}
+		reach(graph.exits[i], node.cost + graph.exit_costs[i], n, false);
+		if (cx == gcx && cy == gcy) {
+			int cost;
+			if (Find_path(node.tile, goal, &to_goal, &cost).second) {
+				reach(goal, node.cost + cost, n, true);
+			}
+		}
+	}
+	if (nodes[1].parent < 0) {
+		return Find_path(start, goal, client);
+	}
+	// Now get the tiles, chunk by chunk.
+	vector<int> ways;
+	for (int n = 1; n >= 0; n = nodes[n].parent) {
+		ways.push_back(n);
+	}
+	std::vector<Tile_coord> path;
+	for (size_t w = ways.size() - 1; w > 0; w--) {
+		const Tile_coord& from = nodes[ways[w]].tile;
+		const Tile_coord& to   = nodes[ways[w - 1]].tile;
+		const int         cx   = from.tx / c_tiles_per_chunk;
+		const int         cy   = from.ty / c_tiles_per_chunk;
+		if (ways[w - 1] != 1
+			&& (to.tx / c_tiles_per_chunk != cx
+				|| to.ty / c_tiles_per_chunk != cy)) {
+			// Across to the next one.
+			if (Get_flat_step_cost(client, from, to) < 0) {
+				return Find_path(start, goal, client);
+			}
+			path.push_back(to);
+			continue;
+		}
+		const Chunk_client inside(client, cx, cy, ways[w - 1] == 1);
+		auto [steps, ok] = Find_path(from, to, &inside);
+		if (!ok) {
+			return Find_path(start, goal, client);
+		}
+		path.insert(path.end(), steps.begin(), steps.end());
+	}
+	return {std::move(path), true};
+}
@@ -19,6 +19,7 @@
 #ifndef PATH_H
 #define PATH_H
 
+#include "common_types.h"
 #include "tiles.h"
 
 #include <utility>
@@ -26,7 +27,50 @@
 
 class Pathfinder_client;
 
+/*
+ *  Tells Find_path_by_chunks() about the chunks of the map searched.
+ */
+class Chunk_versions {
+public:
+	virtual ~Chunk_versions() = default;
+	// Changes whenever what blocks in the chunk might have.
+	virtual uint32 get_version(int cx, int cy) const = 0;
+	virtual int    get_map_num() const = 0;
+};
+
+/*
+ *  How Find_path() expands a tile.
+ */
+enum class Path_search {
+	a_star,         // Try each of the 8 neighbors.
+	jump_points     // Jump over open runs if the client's costs are
+					//   uniform (see Pathfinder_client::has_uniform_cost).
+};
+
 std::pair<std::vector<Tile_coord>, bool> Find_path(
-		const Tile_coord&, const Tile_coord&, const Pathfinder_client* client);
+		const Tile_coord&, const Tile_coord&, const Pathfinder_client* client,
+		int* cost = nullptr, Path_search search = Path_search::jump_points);
+// Nodes expanded by the last Find_path() on this thread.
+int Get_path_nodes_expanded();
+
+/*
+ *  A search done by Find_path(), for recording them.
+ */
+struct Path_query {
+	Tile_coord               start, goal;
+	const Pathfinder_client* client;
+	bool                     found;
+	int                      cost;     // -1 if not found.
+	int                      nodes;    // # expanded.
+	long                     usecs;    // Time taken.
+};
+
+using Path_query_hook = void (*)(const Path_query& query);
+// Call a function after each Find_path(), on the thread doing it.
+void Set_path_query_hook(Path_query_hook hook);
+// Find a long path through a graph of the chunks' entrances.
+std::pair<std::vector<Tile_coord>, bool> Find_path_by_chunks(
+		const Tile_coord&, const Tile_coord&, const Pathfinder_client* client,
+		const Chunk_versions& versions);
 
 #endif
@@ -27,12 +27,20 @@
 #include "Astar.h"
 #include "Zombie.h"
 #include "actors.h"
+#include "exceptions.h"
 #include "gamemap.h"
 #include "gamewin.h"
 #include "ignore_unused_variable_warning.h"
+#include "path.h"
 #include "schedule.h"
+#include "shapeinf.h"
+#include "utils.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <typeinfo>
 
 /*
  *  Create for given NPC.
@@ -200,6 +208,291 @@ bool Actor_pathfinder_client::at_goal(
 		   <= dist;
 }
 
+/*
+ *  Get a key for reusing paths.  They depend on the NPC's size, how close
+ *  to get, and whether NPCs are ignored.
+ */
+
+int Actor_pathfinder_client::get_path_key() const {
+	if (!npc) {
+		return -1;    // A copy.
+	}
+	const Shape_info& info  = npc->get_info();
+	const int         frame = npc->get_framenum();
+	return (std::min(dist, 255) << 16) | (info.get_3d_xtiles(frame) << 12)
+		   | (info.get_3d_ytiles(frame) << 8) | (info.get_3d_height() << 1)
+		   | (ignore_npcs ? 1 : 0);
+}
+
+/*
+ *  Copy what blocks the chunks around a path, if the NPC is 1x1, the
+ *  path's ends are known, and they aren't too far apart.
+ *
+ *  Output: The copy, or nullptr.
+ */
+
+std::unique_ptr<Pathfinder_client> Actor_pathfinder_client::snapshot(
+		const Tile_coord& from, const Tile_coord& to) const {
+	if (ignore_npcs || from.tx < 0 || from.ty < 0 || to.tx < 0 || to.ty < 0) {
+		return nullptr;    // Needs to look at NPCs, or a -1 coord.
+	}
+	const Shape_info& info  = npc->get_info();
+	const int         frame = npc->get_framenum();
+	if (info.get_3d_xtiles(frame) != 1 || info.get_3d_ytiles(frame) != 1) {
+		return nullptr;
+	}
+	int cx0;
+	int cy0;
+	int cw;
+	int ch;
+	if (!Snapshot_pathfinder_client::get_area(from, to, cx0, cy0, cw, ch)) {
+		return nullptr;
+	}
+	return std::make_unique<Snapshot_pathfinder_client>(
+			npc, dist, cx0, cy0, cw, ch);
+}
+
+/*
+ *  Get the chunks around a path to copy.
+ *
+ *  Output: false if there are too many.
+ */
+
+bool Snapshot_pathfinder_client::get_area(
+		const Tile_coord& from, const Tile_coord& to,
+		int& chx, int& chy,    // Upper-left chunk returned.
+		int& chw, int& chh     // Size in chunks returned.
+) {
+	// Chunks to copy around the ends, and the most to copy each way.
+	constexpr const int margin     = 2;
+	constexpr const int max_chunks = 16;
+	const int           fcx        = from.tx / c_tiles_per_chunk;
+	const int           fcy        = from.ty / c_tiles_per_chunk;
+	const int dcx = Tile_coord::delta(fcx, to.tx / c_tiles_per_chunk);
+	const int dcy = Tile_coord::delta(fcy, to.ty / c_tiles_per_chunk);
+	chw           = std::abs(dcx) + 1 + 2 * margin;
+	chh           = std::abs(dcy) + 1 + 2 * margin;
+	if (chw > max_chunks || chh > max_chunks) {
+		return false;
+	}
+	chx = (std::min(fcx, fcx + dcx) - margin + c_num_chunks) % c_num_chunks;
+	chy = (std::min(fcy, fcy + dcy) - margin + c_num_chunks) % c_num_chunks;
+	return true;
+}
+
+/*
+ *  Copy a rectangle of chunks.  Must be done on the main thread.
+ */
+
+Snapshot_pathfinder_client::Snapshot_pathfinder_client(
+		Actor* npc,
+		int    d,           // Distance for success.
+		int chx, int chy,    // Upper-left chunk.
+		int chw, int chh     // Size in chunks.
+		)
+		: Snapshot_pathfinder_client(
+				  npc->get_type_flags(), npc->get_info().get_3d_height(), d,
+				  chx, chy, chw, chh) {}
+
+/*
+ *  Copy a rectangle of chunks for an NPC that's only known by its move
+ *  flags and height.  Must be done on the main thread.
+ */
+
+Snapshot_pathfinder_client::Snapshot_pathfinder_client(
+		int mf,             // Move flags.
+		int hgt,            // NPC's height in tiles.
+		int d,              // Distance for success.
+		int chx, int chy,    // Upper-left chunk.
+		int chw, int chh     // Size in chunks.
+		)
+		: Actor_pathfinder_client(mf, d), cx0(chx), cy0(chy), cw(chw),
+		  ch(chh), chunks(chw * chh), height(hgt),
+		  min_max_cost(Actor_pathfinder_client::get_max_cost(0)) {
+	Game_window* gwin = Game_window::get_instance();
+	Game_map*    gmap = gwin->get_map();
+	for (int y = 0; y < ch; y++) {
+		for (int x = 0; x < cw; x++) {
+			Map_chunk* olist = gmap->get_chunk(
+					(cx0 + x) % c_num_chunks, (cy0 + y) % c_num_chunks);
+			Chunk& chunk = chunks[y * cw + x];
+			chunk.words  = olist->copy_blocked_bits(chunk.bits);
+			for (int ty = 0; ty < c_tiles_per_chunk; ty++) {
+				for (int tx = 0; tx < c_tiles_per_chunk; tx++) {
+					bool water;
+					bool poison;
+					Actor::get_tile_info(
+							nullptr, gwin, olist, tx, ty, water, poison);
+					const ShapeID flat = olist->get_flat(tx, ty);
+					int           bits = olist->get_terrain(tx, ty);
+					if (poison) {
+						bits |= 8;
+					}
+					// Cobblestone path in BlackGate?
+					if (flat.get_shapenum() == 24 && flat.get_framenum() <= 1) {
+						bits |= 16;
+					}
+					chunk.tiles[ty * c_tiles_per_chunk + tx] = bits;
+				}
+			}
+			// Only doors that can block matter.
+			for (auto* door : olist->get_doors()) {
+				const Shape_info& info   = door->get_info();
+				const int         frnum  = door->get_framenum();
+				const int         ztiles = info.get_3d_height();
+				if (!ztiles || !info.is_solid()) {
+					continue;
+				}
+				chunk.doors.push_back(
+						{door->get_tile(), info.get_3d_xtiles(frnum),
+						 info.get_3d_ytiles(frnum), ztiles,
+						 door->get_footprint(), door->is_closed_door(),
+						 frnum % 4 >= 2});
+			}
+		}
+	}
+}
+
+/*
+ *  Hash what was copied (FNV-1a), so a replayed path can tell if it sees
+ *  the same map as when it was recorded.
+ */
+
+static inline void Hash_add(uint32& hash, uint64 value) {
+	for (int i = 0; i < 8; i++) {
+		hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 16777619u;
+	}
+}
+
+uint32 Snapshot_pathfinder_client::get_hash() const {
+	uint32 hash = 2166136261u;
+	Hash_add(
+			hash, (static_cast<uint64>(cx0) << 48)
+						  | (static_cast<uint64>(cy0) << 32) | (cw << 16) | ch);
+	for (const Chunk& chunk : chunks) {
+		for (const uint64 bits : chunk.bits) {
+			Hash_add(hash, bits);
+		}
+		for (const unsigned char tile : chunk.tiles) {
+			Hash_add(hash, tile);
+		}
+		for (const Door& door : chunk.doors) {
+			Hash_add(
+					hash, (static_cast<uint64>(door.tile.tx) << 32)
+								  | (door.tile.ty << 16) | (door.closed ? 2 : 0)
+								  | (door.locked ? 1 : 0));
+		}
+	}
+	return hash;
+}
+
+/*
+ *  Get a copied chunk.
+ *
+ *  Output: ->chunk, or nullptr if it wasn't copied.
+ */
+
+const Snapshot_pathfinder_client::Chunk* Snapshot_pathfinder_client::get_chunk(
+		int cx, int cy) const {
+	const int x = (cx - cx0 + c_num_chunks) % c_num_chunks;
+	const int y = (cy - cy0 + c_num_chunks) % c_num_chunks;
+	return x < cw && y < ch ? &chunks[y * cw + x] : nullptr;
+}
+
+/*
+ *  Figure when to give up.
+ */
+
+int Snapshot_pathfinder_client::get_max_cost(
+		int cost_to_goal    // From estimate_cost().
+) const {
+	return std::max(3 * cost_to_goal, min_max_cost);
+}
+
+/*
+ *  Figure cost going from one tile to an adjacent tile, the way
+ *  Actor_pathfinder_client does for a 1x1 NPC that doesn't ignore NPCs.
+ *
+ *  Output: Cost, or -1 if blocked.
+ *      The 'tz' field in tile may be modified.
+ */
+
+int Snapshot_pathfinder_client::get_step_cost(
+		const Tile_coord& from,
+		Tile_coord&       to    // The tile we're going to.  The 'tz'
+								//   field may be modified.
+) const {
+	to.fixme();
+	const Chunk* chunk
+			= get_chunk(to.tx / c_tiles_per_chunk, to.ty / c_tiles_per_chunk);
+	if (!chunk) {
+		return -1;    // Outside the copy.
+	}
+	const int tile = (to.ty % c_tiles_per_chunk) * c_tiles_per_chunk
+					 + to.tx % c_tiles_per_chunk;
+	uint64 bits[256 / 64] = {};
+	for (int w = 0; w < chunk->words; w++) {
+		bits[w] = chunk->bits[w * c_tiles_per_chunk * c_tiles_per_chunk + tile];
+	}
+	const int tbits    = chunk->tiles[tile];
+	int       cost     = 1;
+	const int old_lift = to.tz;    // Might climb/descend.
+	int       new_lift;
+	const bool blocked
+			= Chunk_cache::is_blocked(
+					  bits, height, to.tz, new_lift, get_move_flags())
+			  || Chunk_cache::is_blocked_at(
+					  new_lift, tbits & 7, get_move_flags());
+	to.tz = new_lift;
+	if (blocked) {
+		// Blocked, but check for a door.
+		const Door* door = nullptr;
+		for (const auto& each : chunk->doors) {
+			const Tile_coord& t = each.tile;
+			if (t.tx >= to.tx && t.ty >= to.ty && t.tz <= to.tz
+				&& to.tx > t.tx - each.xtiles && to.ty > t.ty - each.ytiles
+				&& to.tz < t.tz + each.ztiles) {
+				door = &each;
+				break;
+			}
+		}
+		if (!door || !door->closed || door->locked) {
+			return -1;
+		}
+		// Can't be either end of door.
+		const TileRect& foot = door->foot;
+		if (foot.h == 1
+			&& (to.tx == foot.x || to.tx == FIX_COORD(foot.x + foot.w - 1))) {
+			return -1;
+		} else if (
+				foot.w == 1
+				&& (to.ty == foot.y
+					|| to.ty == FIX_COORD(foot.y + foot.h - 1))) {
+			return -1;
+		}
+		if (foot.has_world_point(from.tx, from.ty)) {
+			return -1;    // Don't walk within doorway.
+		}
+		cost++;    // But try to avoid them.
+	}
+	if (old_lift != to.tz) {
+		cost++;
+	}
+	// On the diagonal?
+	if (from.tx != to.tx || from.ty != to.ty) {
+		cost *= 3;    // Make it 50% more expensive.
+	} else {
+		cost *= 2;
+	}
+	if ((tbits & 8) && to.tz == 0) {
+		cost *= 2;    // And avoid poison if possible.
+	}
+	if (tbits & 16) {    // Cobblestone path in BlackGate?
+		cost--;
+	}
+	return cost;
+}
+
 /*
  *  Estimate cost from one point to another.
  */
@@ -808,3 +1101,77 @@ int Monster_pathfinder_client::get_step_cost(
 		return 1;
 	}
 }
+
+/*
+ *  Where Path_recorder writes, and the thread it records.
+ */
+static std::unique_ptr<std::ostream> path_record;
+static std::thread::id               path_record_thread;
+
+/*
+ *  Write a query to the record, if it can be replayed.  Each line has
+ *  "map sx sy sz gx gy gz move_flags dist height found cost nodes usecs
+ *  hash", where the hash is of what blocks the chunks around the path.
+ */
+
+static void Record_path_query(const Path_query& query) {
+	if (!path_record || std::this_thread::get_id() != path_record_thread
+		|| typeid(*query.client) != typeid(Actor_pathfinder_client)) {
+		return;
+	}
+	// The key has what's needed to copy the client.
+	const int key = query.client->get_path_key();
+	if (key < 0 || ((key >> 8) & 0xff) != 0x11 || (key & 1) != 0) {
+		return;    // Not a 1x1 NPC, or it ignores NPCs.
+	}
+	const Tile_coord& start = query.start;
+	const Tile_coord& goal  = query.goal;
+	if (start.tx < 0 || start.ty < 0 || goal.tx < 0 || goal.ty < 0) {
+		return;
+	}
+	int cx0;
+	int cy0;
+	int cw;
+	int ch;
+	if (!Snapshot_pathfinder_client::get_area(start, goal, cx0, cy0, cw, ch)) {
+		return;
+	}
+	const int                        dist   = key >> 16;
+	const int                        height = (key >> 1) & 0x7f;
+	const Snapshot_pathfinder_client copy(
+			query.client->get_move_flags(), height, dist, cx0, cy0, cw, ch);
+	*path_record << Game_window::get_instance()->get_map()->get_num() << ' '
+				 << start.tx << ' ' << start.ty << ' ' << start.tz << ' '
+				 << goal.tx << ' ' << goal.ty << ' ' << goal.tz << ' '
+				 << query.client->get_move_flags() << ' ' << dist << ' '
+				 << height << ' ' << (query.found ? 1 : 0) << ' ' << query.cost
+				 << ' ' << query.nodes << ' ' << query.usecs << ' '
+				 << copy.get_hash() << '\n';
+}
+
+/*
+ *  Start recording the main thread's queries.
+ *
+ *  Output: false if the file can't be written.
+ */
+
+bool Path_recorder::start(const std::string& fname) {
+	try {
+		path_record = U7open_out(fname.c_str(), true);
+	} catch (const file_open_exception& err) {
+		std::cerr << err.what() << std::endl;
+		return false;
+	}
+	path_record_thread = std::this_thread::get_id();
+	Set_path_query_hook(Record_path_query);
+	return true;
+}
+
+/*
+ *  Stop recording.
+ */
+
+void Path_recorder::stop() {
+	Set_path_query_hook(nullptr);
+	path_record.reset();
+}
@@ -23,9 +23,15 @@
 
 #include "PathFinder.h"
 #include "chunks.h"
+#include "common_types.h"
+#include "ignore_unused_variable_warning.h"
 #include "rect.h"
 #include "tiles.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 class Actor;
 class Game_object;
 class Game_window;
@@ -39,6 +45,11 @@ class Actor_pathfinder_client : public Pathfinder_client {
 	bool   ignore_npcs;    // If NPCs are nonblocking.
 	int    check_blocking(const Tile_coord& from, const Tile_coord& to) const;
 
+protected:
+	// For a copy that doesn't need the NPC.
+	Actor_pathfinder_client(int mf, int d)
+			: Pathfinder_client(mf), dist(d), npc(nullptr), ignore_npcs(false) {}
+
 public:
 	//	Actor_pathfinder_client(Actor *npc, int d = 0) : dist(d)
 	//		{ set_move_flags(mf); }
@@ -53,11 +64,74 @@ public:
 	// Is tile at the goal?
 	bool at_goal(const Tile_coord& tile, const Tile_coord& goal) const override;
 
+	// Straight = 2, diag = 3, unless something's in the way.
+	bool has_uniform_cost() const override {
+		return true;
+	}
+
+	// Depends on the NPC's size, for reusing paths.
+	int get_path_key() const override;
+	// Copy what blocks around the path, for another thread.
+	std::unique_ptr<Pathfinder_client> snapshot(
+			const Tile_coord& from, const Tile_coord& to) const override;
+
 	bool ignores_npcs() const {
 		return ignore_npcs;
 	}
 };
 
+/*
+ *  An Actor_pathfinder_client for a 1x1 NPC that uses a copy of what
+ *  blocks the chunks around its path, so it can be used on another
+ *  thread.  Tiles outside the copied chunks are blocked.
+ */
+class Snapshot_pathfinder_client : public Actor_pathfinder_client {
+	struct Door {
+		Tile_coord tile;    // Lower-right corner, like get_tile().
+		int        xtiles, ytiles, ztiles;
+		TileRect   foot;
+		bool       closed, locked;
+	};
+
+	struct Chunk {
+		int                 words;    // Per tile, from copy_blocked_bits().
+		std::vector<uint64> bits;
+		// Terrain bits (1, 2, 4), then 8 if poison, 16 if cobblestone.
+		unsigned char     tiles[c_tiles_per_chunk * c_tiles_per_chunk];
+		std::vector<Door> doors;
+	};
+
+	int                cx0, cy0;    // Upper-left chunk.
+	int                cw, ch;      // Size in chunks.
+	std::vector<Chunk> chunks;
+	int                height;          // NPC's height in tiles.
+	int                min_max_cost;    // From Actor_pathfinder_client.
+
+	const Chunk* get_chunk(int cx, int cy) const;
+
+public:
+	Snapshot_pathfinder_client(
+			Actor* npc, int d, int chx, int chy, int chw, int chh);
+	Snapshot_pathfinder_client(
+			int mf, int hgt, int d, int chx, int chy, int chw, int chh);
+	// Get the chunks to copy for a path.  False if there are too many.
+	static bool get_area(
+			const Tile_coord& from, const Tile_coord& to, int& chx, int& chy,
+			int& chw, int& chh);
+	// Hash of what was copied, to tell if a map has changed.
+	uint32 get_hash() const;
+	// Figure when to give up.
+	int get_max_cost(int cost_to_goal) const override;
+	// Figure cost for a single step.
+	int get_step_cost(const Tile_coord& frm, Tile_coord& to) const override;
+
+	std::unique_ptr<Pathfinder_client> snapshot(
+			const Tile_coord& from, const Tile_coord& to) const override {
+		ignore_unused_variable_warning(from, to);
+		return nullptr;
+	}
+};
+
 /*
  *  This client succeeds when the path makes it to just one X/Y coord.
  *  It assumes that a -1 was placed in the coord. that we should ignore.
@@ -87,6 +161,11 @@ public:
 			Actor* n, const Tile_coord& b, bool ign = false);
 	// Figure cost for a single step.
 	int get_step_cost(const Tile_coord& from, Tile_coord& to) const override;
+
+	bool has_uniform_cost() const override {
+		return false;
+	}
+
 	// Estimate cost between two points.
 	int estimate_cost(
 			const Tile_coord& from, const Tile_coord& to) const override;
@@ -105,6 +184,16 @@ public:
 	Approach_object_pathfinder_client(Actor* from, Game_object* to, int dist);
 	// Is tile at the goal?
 	bool at_goal(const Tile_coord& tile, const Tile_coord& goal) const override;
+
+	int get_path_key() const override {
+		return -1;    // Goal depends on the box.
+	}
+
+	std::unique_ptr<Pathfinder_client> snapshot(
+			const Tile_coord& from, const Tile_coord& to) const override {
+		ignore_unused_variable_warning(from, to);
+		return nullptr;    // Its goal box isn't copied.
+	}
 };
 
 /*
@@ -176,4 +265,15 @@ public:
 	int get_step_cost(const Tile_coord& from, Tile_coord& to) const override;
 };
 
+/*
+ *  Writes the queries Actor_pathfinder_clients for 1x1 NPCs make on the
+ *  main thread to a file, one per line, for replaying with '--bench-paths'.
+ */
+class Path_recorder {
+public:
+	// Output: false if the file can't be written.
+	static bool start(const std::string& fname);
+	static void stop();
+};
+
 #endif /* INCL_PATHS */
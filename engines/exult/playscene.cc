@@ -21,7 +21,7 @@
 #include "Audio.h"
 #include "data/exult_flx.h"
 #include "exceptions.h"
-#include "files/utils.h"
+#include "utils.h"
 #include "flic/playfli.h"
 #include "font.h"
 #include "game.h"
@@ -6293,9 +6293,11 @@ void Walk_to_schedule::now_what() {
 	blocked = Tile_coord(-1, -1, -1);
 	cout << "Finding path to schedule for " << npc->get_name() << endl;
 	// Create path to dest., delaying
-	//   0 to 1 seconds.
+	//   0 to 1 seconds.  Many NPCs do this at once when the hour changes,
+	//   so find it in the background.
 	if (!npc->walk_path_to_tile(
-				from, to, gwin->get_std_delay(), first_delay + rand() % 1000)) {
+				from, to, gwin->get_std_delay(), first_delay + rand() % 1000,
+				0, 3, true)) {
 		// Wait 1 sec., then try again.
 #ifdef DEBUG
 		cout << "Failed to find path for " << npc->get_name() << endl;
@@ -0,0 +1,300 @@
+/*
+ *  schunk_loader.cc - Read superchunk files ahead of time.
+ *
+ *  Copyright (C) 2025  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "schunk_loader.h"
+
+#include "Flex.h"
+#include "databuf.h"
+#include "exceptions.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cassert>
+
+/*
+ *  Read and decode the 'ifix' file.  Doesn't use any game state, so it
+ *  can be called from the worker thread.
+ */
+
+void Schunk_files::read_ifix() {
+	ifix_read = true;
+	ifix_file = !ifix_patch_name.empty() && U7exists(ifix_patch_name)
+						? ifix_patch_name
+						: ifix_name;
+	IFileDataSource in(ifix_file.c_str());
+	if (!in.good()) {
+		return;
+	}
+	ifix_found = true;
+	FlexFile  flex(ifix_file.c_str());
+	const int vers = static_cast<int>(flex.get_vers());
+	// Go through chunks.
+	const int num_chunks = c_chunks_per_schunk * c_chunks_per_schunk;
+	for (int chunk_num = 0; chunk_num < num_chunks; chunk_num++) {
+		size_t       len;
+		const uint32 offset = flex.get_entry_info(chunk_num, len);
+		if (!len) {
+			continue;
+		}
+		Ifix_chunk& chunk = ifix[chunk_num];
+		chunk.present     = true;
+		// Static ifix files are mapped, so read them in place.
+		const auto                       view = flex.get_object_view(chunk_num);
+		const unsigned char*             ent  = view.data();
+		std::unique_ptr<unsigned char[]> entries;
+		if (view.empty()) {
+			in.seek(offset);    // Get to actual shape.
+			entries = in.readN(len);    // Read them in.
+			ent     = entries.get();
+		}
+		if (static_cast<Flex_header::Flex_vers>(vers) == Flex_header::orig) {
+			const int cnt = len / 4;
+			chunk.objs.reserve(cnt);
+			for (int i = 0; i < cnt; i++, ent += 4) {
+				chunk.objs.push_back(
+						{static_cast<unsigned char>((ent[0] >> 4) & 0xf),
+						 static_cast<unsigned char>(ent[0] & 0xf), ent[1] & 0xf,
+						 ent[2] + 256 * (ent[3] & 3), ent[3] >> 2});
+			}
+		} else if (
+				static_cast<Flex_header::Flex_vers>(vers)
+				== Flex_header::exult_v2) {
+			// b0 = tx,ty, b1 = lift, b2-3 = shnum, b4=frnum
+			const int cnt = len / 5;
+			chunk.objs.reserve(cnt);
+			for (int i = 0; i < cnt; i++, ent += 5) {
+				// Allow full 8 bit lift in v2.
+				chunk.objs.push_back(
+						{static_cast<unsigned char>((ent[0] >> 4) & 0xf),
+						 static_cast<unsigned char>(ent[0] & 0xf), ent[1],
+						 ent[2] + 256 * ent[3], ent[4]});
+			}
+		} else {
+			assert(0);
+		}
+	}
+}
+
+/*
+ *  Read the whole 'ireg' file into memory.
+ */
+
+void Schunk_files::read_ireg() {
+	ireg_read = true;
+	IFileDataSource in(ireg_name.c_str());
+	if (!in.good()) {
+		return;
+	}
+	ireg_found = true;
+	ireg_len   = in.getSize();
+	ireg       = in.readN(ireg_len);
+}
+
+/*
+ *  Get the shapes of the objects read, including those in containers.
+ *  The 'ireg' entries are only walked, as in Game_map::read_ireg_objects().
+ */
+
+void Schunk_files::get_shapes(std::vector<uint16>& shapes) const {
+	shapes.clear();
+	for (const auto& chunk : ifix) {
+		for (const auto& ent : chunk.objs) {
+			shapes.push_back(ent.shnum);
+		}
+	}
+	const unsigned char* ptr = ireg.get();
+	const unsigned char* end = ptr + (ireg_found ? ireg_len : 0);
+	while (ptr < end) {
+		int entlen = *ptr++;
+		if (entlen == 0 || entlen == 1) {    // End of a container.
+			continue;
+		}
+		if (entlen == 2) {    // Index id.
+			ptr += 2;
+			continue;
+		}
+		if (entlen == 255) {    // Special entry:  type, length, data.
+			if (end - ptr < 3) {
+				break;
+			}
+			ptr += 3 + (ptr[1] | (ptr[2] << 8));
+			continue;
+		}
+		int extended = 0;    // 1 for 2-byte shape #'s.
+		if (entlen == 254 || entlen == 253) {
+			extended = entlen == 254 ? 1 : 0;
+			if (ptr == end) {
+				break;
+			}
+			entlen = *ptr++;
+		}
+		if (end - ptr < entlen) {
+			break;
+		}
+		const int testlen = entlen - extended;
+		if (testlen == 6 || testlen == 10 || testlen == 12 || testlen == 13
+			|| testlen == 14 || testlen == 18) {
+			shapes.push_back(
+					extended ? ptr[2] + 256 * ptr[3]
+							 : ptr[2] + 256 * (ptr[3] & 3));
+		}
+		ptr += entlen;
+	}
+	std::sort(shapes.begin(), shapes.end());
+	shapes.erase(std::unique(shapes.begin(), shapes.end()), shapes.end());
+}
+
+/*
+ *  Create, with up to one worker for each core (but no more than 4).
+ */
+
+Schunk_loader::Schunk_loader()
+		: max_workers(std::clamp(std::thread::hardware_concurrency(), 1u, 4u)) {
+}
+
+/*
+ *  Stop the workers.
+ */
+
+Schunk_loader::~Schunk_loader() {
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+		queue.clear();
+	}
+	work_ready.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+/*
+ *  Read queued superchunks until told to quit.
+ */
+
+void Schunk_loader::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		work_ready.wait(lock, [this] {
+			return quit || !queue.empty();
+		});
+		if (quit) {
+			return;
+		}
+		auto      files  = std::move(queue.front().second);
+		const int schunk = queue.front().first;
+		busy.insert(schunk);
+		queue.pop_front();
+		lock.unlock();
+		try {
+			files->read_ifix();
+			if (!files->ireg_name.empty()) {
+				files->read_ireg();
+			}
+		} catch (const std::exception& /*e*/) {
+			// Leave it to the main thread, which will report it.
+			files = nullptr;
+		}
+		lock.lock();
+		if (files) {
+			done[schunk] = std::move(files);
+		}
+		busy.erase(schunk);
+		work_done.notify_all();
+	}
+}
+
+/*
+ *  Is a superchunk queued, being read, or read?
+ */
+
+bool Schunk_loader::is_pending(int schunk) {
+	const std::lock_guard<std::mutex> lock(mutex);
+	if (busy.count(schunk) || done.find(schunk) != done.end()) {
+		return true;
+	}
+	for (const auto& job : queue) {
+		if (job.first == schunk) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ *  Queue the files of a superchunk to be read.
+ */
+
+void Schunk_loader::prefetch(int schunk, std::unique_ptr<Schunk_files> files) {
+	{
+		const std::lock_guard<std::mutex> lock(mutex);
+		queue.emplace_back(schunk, std::move(files));
+		// Another worker if all are busy.
+		if (workers.size() < max_workers
+			&& busy.size() + queue.size() > workers.size()) {
+			workers.emplace_back(&Schunk_loader::run, this);
+		}
+	}
+	work_ready.notify_one();
+}
+
+/*
+ *  Get what was read for a superchunk.
+ *
+ *  Output: The files, or nullptr if they weren't prefetched (or reading
+ *      them failed).
+ */
+
+std::unique_ptr<Schunk_files> Schunk_loader::take(int schunk) {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto it = queue.begin(); it != queue.end(); ++it) {
+		if (it->first == schunk) {    // Not started, so do it now.
+			queue.erase(it);
+			return nullptr;
+		}
+	}
+	work_done.wait(lock, [this, schunk] {
+		return !busy.count(schunk);
+	});
+	auto it = done.find(schunk);
+	if (it == done.end()) {
+		return nullptr;
+	}
+	auto files = std::move(it->second);
+	done.erase(it);
+	return files;
+}
+
+/*
+ *  Forget everything, after waiting for the current reads.
+ */
+
+void Schunk_loader::clear() {
+	std::unique_lock<std::mutex> lock(mutex);
+	queue.clear();
+	work_done.wait(lock, [this] {
+		return busy.empty();
+	});
+	done.clear();
+}
@@ -0,0 +1,111 @@
+/*
+ *  schunk_loader.h - Read superchunk files ahead of time.
+ *
+ *  Copyright (C) 2025  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SCHUNK_LOADER_H
+#define SCHUNK_LOADER_H
+
+#include "common_types.h"
+#include "exult_constants.h"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ *  The files of a superchunk, as read from disk.  The 'ifix' entries are
+ *  decoded, but no objects are created; that's left to the main thread.
+ */
+struct Schunk_files {
+	// Names to read from.  The patch 'ifix' is used if it exists.
+	std::string ifix_patch_name;
+	std::string ifix_name;
+	std::string ireg_name;    // Empty to not read 'ireg'.
+
+	struct Ifix_entry {
+		unsigned char tx, ty;    // Tile within chunk.
+		int           tz;
+		int           shnum, frnum;
+	};
+
+	struct Ifix_chunk {
+		bool                    present = false;    // Had an entry.
+		std::vector<Ifix_entry> objs;
+	};
+
+	bool                                     ifix_read = false;
+	bool                                     ifix_found = false;
+	std::string                              ifix_file;    // Name used.
+	std::array<Ifix_chunk, c_chunks_per_schunk * c_chunks_per_schunk>
+			ifix;
+	bool                             ireg_read  = false;
+	bool                             ireg_found = false;
+	std::unique_ptr<unsigned char[]> ireg;    // Whole 'ireg' file.
+	size_t                           ireg_len = 0;
+
+	// Read and decode 'ifix'.  May throw, like the file classes.
+	void read_ifix();
+	// Read the 'ireg' file into memory.
+	void read_ireg();
+	// Get the shapes of what was read (sorted, no repeats), without
+	//   creating any objects.
+	void get_shapes(std::vector<uint16>& shapes) const;
+};
+
+/*
+ *  Worker threads that read superchunk files before they're needed.
+ */
+class Schunk_loader {
+	std::vector<std::thread>    workers;    // Started as needed.
+	unsigned                    max_workers;
+	std::mutex                  mutex;
+	std::condition_variable     work_ready;
+	std::condition_variable     work_done;
+	bool                        quit = false;
+	std::deque<std::pair<int, std::unique_ptr<Schunk_files>>> queue;
+	std::set<int>               busy;    // Superchunks being read.
+	std::map<int, std::unique_ptr<Schunk_files>> done;
+
+	void run();
+
+public:
+	Schunk_loader();
+	~Schunk_loader();
+	Schunk_loader(const Schunk_loader&)            = delete;
+	Schunk_loader& operator=(const Schunk_loader&) = delete;
+
+	// Is a superchunk queued, being read, or read?
+	bool is_pending(int schunk);
+	// Queue the files of a superchunk to be read.
+	void prefetch(int schunk, std::unique_ptr<Schunk_files> files);
+	// Get what was read for a superchunk, waiting for it if it's being
+	// read now.  Returns nullptr if it wasn't prefetched.
+	std::unique_ptr<Schunk_files> take(int schunk);
+	// Forget everything, after waiting for the current reads.
+	void clear();
+};
+
+#endif
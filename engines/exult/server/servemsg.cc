@@ -33,12 +33,19 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <unistd.h>
 
+#include <cerrno>
 #include <climits>
 #include <cstring>
 #include <iostream> /* For debugging msgs. */
 
 #ifdef _WIN32
 #	include "servewin32.h"
+#else
+#	include <sys/select.h>
+#endif
+
+#ifdef HAVE_ZIP_SUPPORT
+#	include <zlib.h>
 #endif
 
 using std::cout;
@@ -46,6 +53,154 @@ using std::endl;
 
 namespace Exult_server {
 
+	namespace {
+		// The batch Send_data() is adding to, if any.
+		Batch* collecting = nullptr;
+
+#ifdef USE_EXULTSTUDIO
+		/*
+		 *  Wait a little for a socket to be ready, after it said it would
+		 *  block partway through a long message.
+		 *
+		 *  Output: false if it isn't.
+		 */
+
+		bool Wait_ready(int socket, bool for_write) {
+#	ifndef _WIN32
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				return false;
+			}
+			fd_set fds;
+			FD_ZERO(&fds);
+			FD_SET(socket, &fds);
+			timeval timer;
+			timer.tv_sec  = 1;
+			timer.tv_usec = 0;
+			return select(socket + 1, for_write ? nullptr : &fds,
+						  for_write ? &fds : nullptr, nullptr, &timer)
+				   > 0;
+#	else
+			ignore_unused_variable_warning(socket, for_write);
+			return false;
+#	endif
+		}
+
+		/*
+		 *  Read or write all of a buffer.
+		 *
+		 *  Output: false if error.
+		 */
+
+		bool Write_all(int socket, const unsigned char* buf, int len) {
+			while (len > 0) {
+				const auto n = write(socket, buf, len);
+				if (n > 0) {
+					buf += n;
+					len -= static_cast<int>(n);
+				} else if (!Wait_ready(socket, true)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool Read_all(int socket, unsigned char* buf, int len) {
+			while (len > 0) {
+				const auto n = read(socket, buf, len);
+				if (n > 0) {
+					buf += n;
+					len -= static_cast<int>(n);
+				} else if (n == 0 || !Wait_ready(socket, false)) {
+					return false;
+				}
+			}
+			return true;
+		}
+#endif
+
+		/*
+		 *  Write a message.
+		 *
+		 *  Output: -1 if error.
+		 */
+
+		int Write_message(
+				int socket, Msg_type id, const unsigned char* data,
+				int datalen) {
+#ifdef USE_EXULTSTUDIO
+			if (datalen < 0 || datalen > max_batch_length) {
+				return -1;
+			}
+			unsigned char  small[maxlength + hdrlength];
+			std::vector<unsigned char> large;
+			unsigned char* buf = small;
+			if (datalen > maxlength) {
+				large.resize(datalen + hdrlength);
+				buf = large.data();
+			}
+			buf[0] = magic & 0xff;    // Store magic (low-byte first).
+			buf[1] = (magic >> 8) & 0xff;
+			buf[2] = datalen & 0xff;    // Data length.
+			buf[3] = (datalen >> 8) & 0xff;
+			buf[4] = id;
+			if (datalen > 0) {
+				std::memcpy(&buf[5], data, datalen);    // The data itself.
+			}
+			return Write_all(socket, buf, datalen + hdrlength) ? 0 : -1;
+#else  /* USE_EXULTSTUDIO */
+			ignore_unused_variable_warning(socket, id, data, datalen);
+			return -1;
+#endif /* USE_EXULTSTUDIO */
+		}
+
+		/*
+		 *  Undo Send_packed().
+		 *
+		 *  Output: Length of data, else -1.
+		 */
+
+		int Unpack(
+				const unsigned char* packed, int packedlen, Msg_type& id,
+				unsigned char* data, int datalen) {
+			// Type, flags, stride, length.
+			constexpr int hdr = 1 + 1 + 2 + 2;
+			if (packedlen < hdr) {
+				return -1;
+			}
+			id               = static_cast<Msg_type>(packed[0]);
+			const int flags  = packed[1];
+			const int stride = packed[2] | (packed[3] << 8);
+			const int len    = packed[4] | (packed[5] << 8);
+			if (len > datalen) {
+				cout << "Unpacked length " << len << " exceeds max" << endl;
+				return -1;
+			}
+			if (flags & 1) {
+#ifdef HAVE_ZIP_SUPPORT
+				uLongf destlen = len;
+				if (uncompress(data, &destlen, packed + hdr, packedlen - hdr)
+							!= Z_OK
+					|| destlen != static_cast<uLongf>(len)) {
+					cout << "Bad packed data" << endl;
+					return -1;
+				}
+#else
+				cout << "Can't unpack compressed data" << endl;
+				return -1;
+#endif
+			} else if (packedlen - hdr == len) {
+				std::memcpy(data, packed + hdr, len);
+			} else {
+				return -1;
+			}
+			// Undo the differences.
+			for (int i = stride; stride > 0 && i < len; i++) {
+				data[i] ^= data[i - stride];
+			}
+			return len;
+		}
+	}    // namespace
+
 	/*
 	 *  Send data.
 	 *
@@ -54,23 +209,19 @@ namespace Exult_server {
 
 	int Send_data(
 			int socket, Msg_type id, const unsigned char* data, int datalen) {
-#ifdef USE_EXULTSTUDIO
-		unsigned char buf[maxlength + hdrlength];
-		buf[0] = magic & 0xff;    // Store magic (low-byte first).
-		buf[1] = (magic >> 8) & 0xff;
-		buf[2] = datalen & 0xff;    // Data length.
-		buf[3] = (datalen >> 8) & 0xff;
-		buf[4] = id;
-		if (datalen > 0) {
-			std::memcpy(&buf[5], data, datalen);    // The data itself.
+		if (collecting && collecting->get_socket() == socket) {
+			if (collecting->add(id, data, datalen)) {
+				return 0;
+			}
+			// Full, so send what we have.
+			if (collecting->send() == -1) {
+				return -1;
+			}
+			if (collecting->add(id, data, datalen)) {
+				return 0;
+			}
 		}
-		const int len = datalen + hdrlength;
-
-		return write(socket, buf, len) == len ? 0 : -1;
-#else  /* USE_EXULTSTUDIO */
-		ignore_unused_variable_warning(socket, id, data, datalen);
-		return -1;
-#endif /* USE_EXULTSTUDIO */
+		return Write_message(socket, id, data, datalen);
 	}
 
 	/*
@@ -99,40 +250,141 @@ namespace Exult_server {
 			cout << "Bad magic read" << endl;
 			return -1;
 		}
-		if (read(socket, buf, 3) != 3) {
+		if (!Read_all(socket, buf, 3)) {
 			cout << "Couldn't read length+type" << endl;
 			return -1;
 		}
 		const int dlen = buf[0] | (buf[1] << 8);
 		// Message type.
 		id = static_cast<Exult_server::Msg_type>(buf[2]);
-		if (dlen > Exult_server::maxlength || dlen > datalen) {
-			cout << "Length " << datalen << " exceeds max" << endl;
-			//+++++++++Eat the chars.
-			return -1;
+		if (id == packed) {
+			std::vector<unsigned char> packed_data(dlen);
+			if (!Read_all(socket, packed_data.data(), dlen)) {
+				cout << "Failed to read all " << dlen << " bytes" << endl;
+				return -1;
+			}
+			return Unpack(packed_data.data(), dlen, id, data, datalen);
 		}
-#	ifdef _WIN32
-		const int bytes_read = read(socket, data, dlen);    // Read data.
-#	else
-		const ssize_t bytes_read = read(socket, data, dlen);    // Read data.
-#	endif
-		if (bytes_read < 0 || bytes_read > INT_MAX) {
-			cout << "Read error or overflow" << endl;
+		if (dlen > datalen) {
+			cout << "Length " << dlen << " exceeds max" << endl;
+			// Eat the chars, to stay in step.
+			std::vector<unsigned char> skip(dlen);
+			Read_all(socket, skip.data(), dlen);
 			return -1;
 		}
-		datalen = static_cast<int>(bytes_read);
-
-		if (datalen < dlen) {
+		if (!Read_all(socket, data, dlen)) {
 			cout << "Failed to read all " << dlen << " bytes" << endl;
 			return -1;
 		}
-		return datalen;
+		return dlen;
 #else  /* USE_EXULTSTUDIO */
 		ignore_unused_variable_warning(socket, id, data, datalen);
 		return -1;
 #endif /* USE_EXULTSTUDIO */
 	}
 
+	int Send_packed(
+			int socket, Msg_type id, const unsigned char* data, int datalen,
+			int stride) {
+		constexpr int hdr = 1 + 1 + 2 + 2;
+		if (datalen < 0 || datalen > max_batch_length || stride < 0
+			|| stride > 0xffff) {
+			return -1;
+		}
+		std::vector<unsigned char> diffs(data, data + datalen);
+		for (int i = datalen - 1; stride > 0 && i >= stride; i--) {
+			diffs[i] ^= diffs[i - stride];
+		}
+		std::vector<unsigned char> out(hdr);
+		out[0]    = id;
+		out[1]    = 0;
+		out[2]    = stride & 0xff;
+		out[3]    = (stride >> 8) & 0xff;
+		out[4]    = datalen & 0xff;
+		out[5]    = (datalen >> 8) & 0xff;
+#ifdef HAVE_ZIP_SUPPORT
+		uLongf zlen = compressBound(datalen);
+		out.resize(hdr + zlen);
+		if (compress(out.data() + hdr, &zlen, diffs.data(), datalen) == Z_OK
+			&& zlen < static_cast<uLongf>(datalen)) {
+			out[1] = 1;
+			out.resize(hdr + zlen);
+		} else {
+			out.resize(hdr);
+		}
+#endif
+		if (out[1] == 0) {
+			out.insert(out.end(), diffs.begin(), diffs.end());
+		}
+		if (static_cast<int>(out.size()) > max_batch_length) {
+			return -1;
+		}
+		return Send_data(
+				socket, packed, out.data(), static_cast<int>(out.size()));
+	}
+
+	bool Batch::add(Msg_type id, const unsigned char* data, int datalen) {
+		if (datalen < 0 || datalen > 0xffff
+			|| buf.size() + 3 + datalen > static_cast<size_t>(max_batch_length)) {
+			return false;
+		}
+		buf.push_back(id);
+		buf.push_back(datalen & 0xff);
+		buf.push_back((datalen >> 8) & 0xff);
+		if (datalen > 0) {
+			buf.insert(buf.end(), data, data + datalen);
+		}
+		return true;
+	}
+
+	int Batch::send() {
+		if (buf.empty()) {
+			return 0;
+		}
+		const unsigned char* ptr = buf.data();
+		Msg_type             id;
+		const unsigned char* data;
+		int                  datalen;
+		next(ptr, buf.data() + buf.size(), id, data, datalen);
+		int result;
+		if (ptr == buf.data() + buf.size()) {
+			// Just one, so send it by itself.
+			result = Write_message(socket, id, data, datalen);
+		} else {
+			result = Write_message(
+					socket, batch, buf.data(), static_cast<int>(buf.size()));
+		}
+		buf.clear();
+		return result;
+	}
+
+	void Batch::start_collecting() {
+		collecting = this;
+	}
+
+	void Batch::end_collecting() {
+		if (collecting == this) {
+			collecting = nullptr;
+		}
+	}
+
+	bool Batch::next(
+			const unsigned char*& ptr, const unsigned char* end, Msg_type& id,
+			const unsigned char*& data, int& datalen) {
+		if (end - ptr < 3) {
+			return false;
+		}
+		const int len = ptr[1] | (ptr[2] << 8);
+		if (end - ptr - 3 < len) {
+			return false;    // Bad.
+		}
+		id      = static_cast<Msg_type>(ptr[0]);
+		datalen = len;
+		data    = ptr + 3;
+		ptr += 3 + len;
+		return true;
+	}
+
 	bool wait_for_response(int socket, int ms) {
 		ignore_unused_variable_warning(socket, ms);
 #if defined(_WIN32) && defined(USE_EXULTSTUDIO)
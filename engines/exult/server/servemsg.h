@@ -26,6 +26,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef INCL_SERVEMSG
 #define INCL_SERVEMSG 1
 
+#include <vector>
+
 /*
  *  An entry sent between client and server will have the following format:
  *
@@ -41,6 +43,8 @@ namespace Exult_server {
 	const int            maxlength
 			= 16 * 16 * 3 + 50;    // Big enough to hold a 'terrain'.
 	const int hdrlength = 5;
+	// Longest data of any message (a batch, or packed data).
+	const int max_batch_length = 0xffff;
 	const int version   = 0;    // Sent with 'info' message.
 
 	enum Msg_type {
@@ -102,6 +106,10 @@ namespace Exult_server {
 		get_user_click     = 53,    // Request map click, returns tile coords.
 		locate_egg         = 54,    // Locate egg by quality/path number.
 		locate_intermap    = 55,    // Locate intermap destination (x,y,z,map).
+		merge_terrains     = 56,    // Share same/similar terrains.
+		batch              = 57,    // Several messages.  See Batch.
+		packed             = 58,    // A packed message.  See Send_packed.
+		send_terrains      = 59,    // Send a run of terrains (packed).
 		usecode_debugging  = 128
 	};
 
@@ -118,6 +126,54 @@ namespace Exult_server {
 	// Wait for given ms for a response. return false if no response
 	bool wait_for_response(int socket, int ms);
 
+	/*
+	 *  Pack data and send it as a 'packed' message, which Receive_data()
+	 *  unpacks.  Records 'stride' bytes long are first stored as how
+	 *  they differ from the one before, so runs of similar ones (like
+	 *  terrains) compress well.  Compressed with zlib if we have it.
+	 *
+	 *  Output: -1 if error.
+	 */
+	int Send_packed(
+			int socket, Msg_type id, const unsigned char* data, int datalen,
+			int stride = 0);
+
+	/*
+	 *  Messages gathered to go as one 'batch' message.  Each is stored
+	 *  as its type (1 byte), length (2 bytes) and data.  While a batch
+	 *  is collecting for a socket, Send_data() to it adds to the batch.
+	 */
+	class Batch {
+		std::vector<unsigned char> buf;
+		int                        socket;
+
+	public:
+		explicit Batch(int s = -1) : socket(s) {}
+
+		// Add a message.  Output: false if it won't fit.
+		bool add(Msg_type id, const unsigned char* data, int datalen);
+
+		bool empty() const {
+			return buf.empty();
+		}
+
+		int get_socket() const {
+			return socket;
+		}
+
+		// Send it, and start again.  Output: -1 if error.
+		int send();
+		// Have Send_data() to our socket add to us until end_collecting().
+		void start_collecting();
+		void end_collecting();
+
+		// Go through a received batch's messages.
+		// Output: false when there are no more.
+		static bool next(
+				const unsigned char*& ptr, const unsigned char* end,
+				Msg_type& id, const unsigned char*& data, int& datalen);
+	};
+
 }    // namespace Exult_server
 
 #endif /* INCL_SERVEMSG */
@@ -43,6 +43,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #	include "exult.h"
 #	include "gamemap.h"
 #	include "gamewin.h"
+#	include "ignore_unused_variable_warning.h"
 #	include "objiter.h"
 #	include "objserial.h"
 #	include "servemsg.h"
@@ -53,8 +54,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #	include <fcntl.h>
 #	include <unistd.h>
 
+#	include <algorithm>
 #	include <cstdio>
 #	include <cstdlib>
+#	include <cstring>
+#	include <deque>
+#	include <vector>
 
 #	if HAVE_SYS_TYPES_H
 #		include <sys/types.h>
@@ -221,15 +226,14 @@ extern void Set_dragged_combo(int cnt, int xtl, int ytl, int rtl, int btl);
 extern void Set_dragged_npc(int npcnum);
 extern void Set_dragged_chunk(int chunknum);
 
-static void Handle_client_message(
-		int& fd    // Socket to client.  May be closed.
-) {
-	unsigned char          data[Exult_server::maxlength];
-	Exult_server::Msg_type id;
-	const int datalen = Exult_server::Receive_data(fd, id, data, sizeof(data));
-	if (datalen < 0) {
-		return;
-	}
+/*
+ *  Handle one message from the client.
+ */
+
+static void Handle_message(
+		Exult_server::Msg_type id,
+		unsigned char*         data,    // Room for maxlength bytes.
+		int                    datalen) {
 	const unsigned char* ptr               = &data[0];
 	Game_window*         gwin              = Game_window::get_instance();
 	auto                 unhandled_message = [](Exult_server::Msg_type id) {
@@ -331,6 +335,17 @@ static void Handle_client_message(
 				client_socket, Exult_server::delete_terrain, data, wptr - data);
 		break;
 	}
+	case Exult_server::merge_terrains: {
+		// Send back # removed (-1 if editing), new total.
+		const int      tolerance = little_endian::Read2s(ptr);
+		const int      removed   = Game_map::merge_terrains(tolerance);
+		unsigned char* wptr      = &data[2];
+		little_endian::Write2(wptr, removed);
+		little_endian::Write2(wptr, gwin->get_map()->get_num_chunk_terrains());
+		Exult_server::Send_data(
+				client_socket, Exult_server::merge_terrains, data, wptr - data);
+		break;
+	}
 	case Exult_server::send_terrain: {
 		// Send back #, total, 512-bytes data.
 		const int      tnum = little_endian::Read2s(ptr);
@@ -343,6 +358,34 @@ static void Handle_client_message(
 				client_socket, Exult_server::send_terrain, data, wptr - data);
 		break;
 	}
+	case Exult_server::send_terrains: {
+		// Send back first, count, total, then the data, packed.
+		const int      first = little_endian::Read2s(ptr);
+		int            cnt   = little_endian::Read2s(ptr);
+		const int      total = gwin->get_map()->get_num_chunk_terrains();
+		const int      tsize = c_tiles_per_chunk * c_tiles_per_chunk
+							* (Game_map::is_v2_chunks() ? 3 : 2);
+		if (first < 0 || first >= total || cnt <= 0) {
+			break;
+		}
+		cnt = std::min(
+				{cnt, total - first,
+				 (Exult_server::max_batch_length - 12) / tsize});
+		std::vector<unsigned char> buf(6 + cnt * tsize);
+		unsigned char*             wptr = buf.data();
+		little_endian::Write2(wptr, first);
+		little_endian::Write2(wptr, cnt);
+		little_endian::Write2(wptr, total);
+		for (int tnum = first; tnum < first + cnt; tnum++) {
+			Chunk_terrain* ter = Game_map::get_terrain(tnum);
+			wptr += ter->write_flats(wptr, Game_map::is_v2_chunks());
+		}
+		// Neighboring tiles are often alike.
+		Exult_server::Send_packed(
+				client_socket, Exult_server::send_terrains, buf.data(),
+				wptr - buf.data(), tsize);
+		break;
+	}
 	case Exult_server::terrain_editing_mode: {
 		// 1=on, 0=off, -1=undo.
 		const int onoff = little_endian::Read2s(ptr);
@@ -840,18 +883,95 @@ static void Handle_client_message(
 }
 
 /*
- *  Delay for a fraction of a second, or until there's data available.
+ *  Messages that came in a batch, waiting their turn.
+ */
+struct Pending_message {
+	Exult_server::Msg_type     id;
+	std::vector<unsigned char> data;
+};
+
+static std::deque<Pending_message> pending;
+
+// Time to spend on waiting messages each frame.
+constexpr const Uint64 pending_budget_ms = 5;
+
+/*
+ *  Handle messages waiting in the queue, until they're done or the time
+ *  for this frame is up.  Replies go back together as one batch.
+ */
+
+static void Handle_pending() {
+	if (pending.empty()) {
+		return;
+	}
+	const Uint64        stop = SDL_GetTicks() + pending_budget_ms;
+	Exult_server::Batch replies(client_socket);
+	replies.start_collecting();
+	do {
+		const Pending_message msg = std::move(pending.front());
+		pending.pop_front();
+		unsigned char data[Exult_server::maxlength];
+		if (!msg.data.empty()) {
+			std::memcpy(data, msg.data.data(), msg.data.size());
+		}
+		Handle_message(msg.id, data, static_cast<int>(msg.data.size()));
+	} while (!pending.empty() && client_socket >= 0 && SDL_GetTicks() < stop);
+	replies.end_collecting();
+	if (client_socket >= 0) {
+		replies.send();
+	}
+}
+
+/*
+ *  Read a message (or batch of them) from the client and handle it.
+ */
+
+static void Handle_client_message(
+		int& fd    // Socket to client.  May be closed.
+) {
+	static std::vector<unsigned char> data(Exult_server::max_batch_length);
+	Exult_server::Msg_type            id;
+	const int                         datalen = Exult_server::Receive_data(
+            fd, id, data.data(), static_cast<int>(data.size()));
+	if (datalen < 0) {
+		return;
+	}
+	auto queue = [](Exult_server::Msg_type id, const unsigned char* msgdata,
+					int msglen) {
+		if (msglen > Exult_server::maxlength) {
+			cout << "Message from Exult Studio is too long (id = " << id
+				 << ")" << endl;
+			return;
+		}
+		pending.push_back(
+				{id, std::vector<unsigned char>(msgdata, msgdata + msglen)});
+	};
+	if (id != Exult_server::batch) {
+		queue(id, data.data(), datalen);
+	} else {
+		const unsigned char* ptr = data.data();
+		const unsigned char* end = ptr + datalen;
+		const unsigned char* msgdata;
+		int                  msglen;
+		while (Exult_server::Batch::next(ptr, end, id, msgdata, msglen)) {
+			queue(id, msgdata, msglen);
+		}
+	}
+	Handle_pending();
+}
+
+/*
+ *  Delay for up to total_ms, or until there's data available.
  *  If a server request comes, it's handled here.
  */
 
 #	ifndef _WIN32
-#		define DELAY_TOTAL_MS  10
 #		define DELAY_SINGLE_MS 1
 #	endif
 
-void Server_delay(Message_handler handle_message) {
+void Server_delay(Message_handler handle_message, unsigned int total_ms) {
 #	ifndef _WIN32
-	Uint32 expiration = DELAY_TOTAL_MS + SDL_GetTicks();
+	Uint32 expiration = total_ms + SDL_GetTicks();
 	for (;;) {
 		SDL_PumpEvents();
 		if ((SDL_PeepEvents(
@@ -900,6 +1020,7 @@ void Server_delay(Message_handler handle_message) {
 		}
 	}
 #	else
+	ignore_unused_variable_warning(total_ms);
 	if (listen_socket == -1) {
 		return;
 	}
@@ -930,8 +1051,9 @@ void Server_delay(Message_handler handle_message) {
 #	endif
 }
 
-void Server_delay() {
-	Server_delay(Handle_client_message);
+void Server_delay(unsigned int total_ms) {
+	Handle_pending();    // Left over from the last batch?
+	Server_delay(Handle_client_message, total_ms);
 }
 
 #endif
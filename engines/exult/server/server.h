@@ -33,8 +33,9 @@ using Message_handler = void (*)(int&);
 
 extern int  client_socket;
 extern void Server_init();
-extern void Server_delay(Message_handler handle_message);
-extern void Server_delay();
+extern void Server_delay(
+		Message_handler handle_message, unsigned int total_ms = 10);
+extern void Server_delay(unsigned int total_ms = 10);
 extern void Server_close();
 
 #endif /* USE_EXULTSTUDIO */
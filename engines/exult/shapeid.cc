@@ -26,6 +26,7 @@
 #include "Flex.h"
 #include "U7file.h"
 #include "U7fileman.h"
+#include "chunkter.h"
 #include "data/exult_bg_flx.h"
 #include "data/exult_si_flx.h"
 #include "exceptions.h"
@@ -34,12 +35,14 @@
 #include "game.h"
 #include "gamewin.h"
 #include "miscinf.h"
+#include "startup_profile.h"
 #include "u7drag.h"
 #include "utils.h"
 #include "vgafile.h"
 
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -124,8 +127,11 @@ void Shape_manager::load() {
 
 	// Determine some colors based on the default palette
 	Palette pal;
-	// could throw!
-	pal.load(PALETTES_FLX, PATCH_PALETTES, 0);
+	{
+		const Startup_phase phase("palette");
+		// could throw!
+		pal.load(PALETTES_FLX, PATCH_PALETTES, 0);
+	}
 	// Get a bright green.
 	special_pixels[POISON_PIXEL] = pal.find_color(4, 63, 4);
 	// Get a light gray.
@@ -141,6 +147,7 @@ void Shape_manager::load() {
 	// Black for ShortcutBar_gump
 	special_pixels[BLACK_PIXEL] = pal.find_color(0, 0, 0);
 
+	auto vga_phase = std::make_optional<Startup_phase>("VGA files");
 	files[SF_GUMPS_VGA].load(GUMPS_VGA, PATCH_GUMPS, true);
 
 	if (!files[SF_PAPERDOL_VGA].load(
@@ -249,11 +256,18 @@ void Shape_manager::load() {
 	const char* gamedata = game->get_resource("files/gameflx").str;
 	std::cout << "Loading " << gamedata << "..." << std::endl;
 	files[SF_GAME_FLX].load(gamedata);
+	vga_phase.reset();
 
-	read_shape_info();
+	{
+		const Startup_phase phase("shapeinf");
+		read_shape_info();
+	}
 
-	fonts = make_unique<Fonts_vga_file>();
-	fonts->init();
+	{
+		const Startup_phase phase("fonts");
+		fonts = make_unique<Fonts_vga_file>();
+		fonts->init();
+	}
 
 	// Get translucency tables.
 	unique_ptr<unsigned char[]>
@@ -370,6 +384,8 @@ void Shape_manager::reload_shapes(int shape_kind    // Type from u7drag.h.
 	switch (shape_kind) {
 	case U7_SHAPE_SHAPES:
 		read_shape_info();
+		// The terrain may have been painted with the old flats.
+		Chunk_terrain::clear_rendered_flats();
 		// ++++Reread text?
 		break;
 	case U7_SHAPE_GUMPS:
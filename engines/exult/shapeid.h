@@ -379,6 +379,15 @@ public:
 		return Shape_manager::instance->shapes.get_info(shnum);
 	}
 
+	// What the chunk caches and painting use, packed with other shapes'.
+	const Shape_hot_info& get_hot_info() const {
+		return Shape_manager::instance->shapes.get_hot_info(shapenum);
+	}
+
+	static const Shape_hot_info& get_hot_info(int shnum) {
+		return Shape_manager::instance->shapes.get_hot_info(shnum);
+	}
+
 	uint8* Get_palette_transform_table(uint8 table[256]) const;
 };
 
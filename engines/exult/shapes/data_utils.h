@@ -360,6 +360,18 @@ public:
 	}
 };
 
+class Shape_info;
+class Shape_info_table;
+
+/*
+ *  What the multidata readers and writers work on: shapes keep theirs in
+ *  a table by shape number, the rest in maps.
+ */
+template <class Info>
+using Info_table = std::conditional_t<
+		std::is_same_v<Info, Shape_info>, Shape_info_table,
+		std::map<int, Info>>;
+
 /*
  *  Generic functor-based reader class for maps.
  */
@@ -368,10 +380,10 @@ template <
 		class ReadID = ID_reader_functor>
 class Functor_multidata_reader : public Base_reader {
 protected:
-	std::map<int, Info>& info;
-	Functor              reader;
-	Transform            postread;
-	ReadID               idread;
+	Info_table<Info>& info;
+	Functor           reader;
+	Transform         postread;
+	ReadID            idread;
 
 	void read_data(
 			std::istream& in, size_t index, int version, bool patch,
@@ -385,7 +397,7 @@ protected:
 	}
 
 public:
-	Functor_multidata_reader(std::map<int, Info>& nfo, bool h = false)
+	Functor_multidata_reader(Info_table<Info>& nfo, bool h = false)
 			: Base_reader(h), info(nfo) {}
 };
 
@@ -639,13 +651,13 @@ public:
 template <class Info, class Functor>
 class Functor_multidata_writer : public Base_writer {
 protected:
-	std::map<int, Info>& info;
-	const int            numshapes;
-	Functor              writer;
+	Info_table<Info>& info;
+	const int         numshapes;
+	Functor           writer;
 
 	int check_write() override {
 		int num = 0;
-		for (auto& kvpair : info) {
+		for (auto&& kvpair : info) {
 			if (writer(kvpair.second)) {
 				num++;
 			}
@@ -654,7 +666,7 @@ protected:
 	}
 
 	void write_data(std::ostream& out, Exult_Game game) override {
-		for (auto& kvpair : info) {
+		for (auto&& kvpair : info) {
 			if (writer(kvpair.second)) {
 				writer(out, kvpair.first, game, kvpair.second);
 			}
@@ -663,7 +675,7 @@ protected:
 
 public:
 	Functor_multidata_writer(
-			const char* s, std::map<int, Info>& nfo, int n, int v = -1)
+			const char* s, Info_table<Info>& nfo, int n, int v = -1)
 			: Base_writer(s, v), info(nfo), numshapes(n) {
 		check();
 	}
@@ -58,6 +58,8 @@ vector<string> item_names;
 vector<string> text_msgs;
 // Frames, etc (0x500 - 0x5ff/0x685 (BG/SI) in text.flx).
 vector<string> misc_names;
+// Bumped when any of them change.
+static unsigned text_version = 0;
 
 static inline int remap_index(bool remap, int index, bool sibeta) {
 	if (!remap) {
@@ -120,6 +122,7 @@ static inline const char* get_text_internal(
 
 static inline void add_text_internal(
 		vector<string>& src, unsigned num, const char* name) {
+	++text_version;
 	if (num >= src.size()) {
 		src.resize(num + 1);
 	}
@@ -433,6 +436,11 @@ void Free_text() {
 	Free_text_list(item_names);
 	Free_text_list(text_msgs);
 	Free_text_list(misc_names);
+	++text_version;
+}
+
+unsigned get_text_version() {
+	return text_version;
 }
 
 /*
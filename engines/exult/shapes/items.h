@@ -47,6 +47,8 @@ void        Set_misc_name(unsigned num, const char* name);
 
 void Setup_text(bool si, bool expansion, bool sibeta, Game_Language language);
 void Free_text();
+// Changes whenever any of the above text does.
+unsigned get_text_version();
 void Write_text_file();
 
 // This is the offset messages start at in txt.flx and exultmsg.txt
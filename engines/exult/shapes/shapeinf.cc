@@ -624,3 +624,29 @@ void Shape_info::paint_bbox(
 				stroke, x + vx[0], y + vy[0], x + vx[1], y + vy[1], nullptr);
 	}
 }
+
+const Shape_hot_info Shape_info_table::zhot;
+
+Shape_info& Shape_info_table::operator[](int shapenum) {
+	const auto index = static_cast<size_t>(shapenum);
+	if (index >= infos.size()) {
+		infos.resize(index + 1);
+		hot.resize(index + 1);
+	}
+	if (!infos[index]) {
+		infos[index] = std::make_unique<Shape_info>();
+	}
+	return *infos[index];
+}
+
+void Shape_info_table::update_hot(int shapenum) {
+	if (Shape_info* inf = find(shapenum)) {
+		hot[shapenum] = Shape_hot_info(*inf);
+	}
+}
+
+void Shape_info_table::update_hot() {
+	for (size_t i = 0; i < infos.size(); i++) {
+		hot[i] = infos[i] ? Shape_hot_info(*infos[i]) : Shape_hot_info();
+	}
+}
@@ -28,6 +28,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "baseinf.h"
 
+#include <iterator>
+#include <memory>
 #include <vector>
 
 class Armor_info;
@@ -1008,4 +1010,161 @@ public:
 	}
 };
 
+/*
+ *  What the chunk caches and the painting look at for every object, copied
+ *  out of its shape's Shape_info so that the shapes of a whole map fit in
+ *  a few cache lines.
+ */
+class Shape_hot_info {
+	enum Hot_flags : unsigned char {
+		solid_bit    = 1 << 0,
+		water_bit    = 1 << 1,
+		door_bit     = 1 << 2,
+		occludes_bit = 1 << 3
+	};
+
+	unsigned char dims[3] = {0};    // As in Shape_info.
+	unsigned char flags   = 0;
+	unsigned char weight = 0, volume = 0;
+
+public:
+	Shape_hot_info() = default;
+
+	explicit Shape_hot_info(const Shape_info& inf)
+			: dims{static_cast<unsigned char>(inf.get_3d_xtiles(0)),
+				   static_cast<unsigned char>(inf.get_3d_ytiles(0)),
+				   static_cast<unsigned char>(inf.get_3d_height())},
+			  flags(static_cast<unsigned char>(
+					  (inf.is_solid() ? solid_bit : 0)
+					  | (inf.is_water() ? water_bit : 0)
+					  | (inf.is_door() ? door_bit : 0)
+					  | (inf.occludes() ? occludes_bit : 0))),
+			  weight(static_cast<unsigned char>(inf.get_weight())),
+			  volume(static_cast<unsigned char>(inf.get_volume())) {}
+
+	int get_3d_xtiles(unsigned int framenum) const {
+		return dims[(framenum >> 5) & 1];
+	}
+
+	int get_3d_ytiles(unsigned int framenum) const {
+		return dims[1 ^ ((framenum >> 5) & 1)];
+	}
+
+	int get_3d_height() const {
+		return dims[2];
+	}
+
+	bool is_solid() const {
+		return (flags & solid_bit) != 0;
+	}
+
+	bool is_water() const {
+		return (flags & water_bit) != 0;
+	}
+
+	bool is_door() const {
+		return (flags & door_bit) != 0;
+	}
+
+	bool occludes() const {
+		return (flags & occludes_bit) != 0;
+	}
+
+	int get_weight() const {
+		return weight;
+	}
+
+	int get_volume() const {
+		return volume;
+	}
+};
+
+/*
+ *  The Shape_info of each shape, by shape number, along with its
+ *  Shape_hot_info.  Each Shape_info is allocated by itself, so that
+ *  references to it stay good until clear().
+ */
+class Shape_info_table {
+	std::vector<std::unique_ptr<Shape_info>> infos;
+	std::vector<Shape_hot_info>              hot;
+	static const Shape_hot_info              zhot;    // All 0's.
+
+public:
+	// What iterating gives, as a std::map would.
+	struct Entry {
+		int         first;
+		Shape_info& second;
+	};
+
+	class iterator {
+		Shape_info_table* table;
+		size_t            index;
+
+		void skip_empty() {
+			while (index < table->infos.size() && !table->infos[index]) {
+				index++;
+			}
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = Entry;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = void;
+		using reference         = Entry;
+
+		iterator(Shape_info_table* t, size_t i) : table(t), index(i) {
+			skip_empty();
+		}
+
+		Entry operator*() const {
+			return Entry{static_cast<int>(index), *table->infos[index]};
+		}
+
+		iterator& operator++() {
+			index++;
+			skip_empty();
+			return *this;
+		}
+
+		bool operator==(const iterator& other) const {
+			return index == other.index;
+		}
+
+		bool operator!=(const iterator& other) const {
+			return index != other.index;
+		}
+	};
+
+	iterator begin() {
+		return iterator(this, 0);
+	}
+
+	iterator end() {
+		return iterator(this, infos.size());
+	}
+
+	// Get a shape's info, adding it if it has none.
+	Shape_info& operator[](int shapenum);
+
+	Shape_info* find(int shapenum) {
+		const auto index = static_cast<size_t>(shapenum);
+		return index < infos.size() ? infos[index].get() : nullptr;
+	}
+
+	const Shape_hot_info& get_hot(int shapenum) const {
+		const auto index = static_cast<size_t>(shapenum);
+		return index < hot.size() ? hot[index] : zhot;
+	}
+
+	// The hot info is only copied when these are called.
+	void update_hot(int shapenum);
+	void update_hot();
+
+	void clear() {
+		infos.clear();
+		hot.clear();
+	}
+};
+
 #endif
@@ -546,7 +546,7 @@ void Shapes_vga_file::Read_Gumpinf_text_data_file(
 	};
 
 	// The template parameters are: <Info, Functor>  (Info comes FIRST!)
-	// The constructor takes: std::map<int, Info>&
+	// The constructor takes: Info_table<Info>&
 	using Container_area_reader
 			= Functor_multidata_reader<Gump_info, Container_area_functor>;
 	using Checkmark_pos_reader
@@ -811,14 +811,14 @@ bool Shapes_vga_file::read_info(
 	// Ensure valid ready spots for all shapes.
 	const unsigned char defready = game == BLACK_GATE ? backpack : rhand;
 	zinfo.ready_type             = defready;
-	for (auto& it : info) {
+	for (auto&& it : info) {
 		Shape_info& inf = it.second;
 		if (inf.ready_type == invalid_spot) {
 			inf.ready_type = defready;
 		}
 	}
 	bool auto_modified = false;
-	for (auto& it : info) {
+	for (auto&& it : info) {
 		const int   shnum = it.first;
 		Shape_info& inf   = it.second;
 		if (inf.has_monster_info()) {
@@ -855,6 +855,7 @@ bool Shapes_vga_file::read_info(
 			}
 		}
 	}
+	info.update_hot();
 	return auto_modified;
 }
 
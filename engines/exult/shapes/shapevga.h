@@ -39,9 +39,9 @@
  *  The "shapes.vga" file:
  */
 class Shapes_vga_file : public Vga_file {
-	std::map<int, Shape_info> info;     // Extra info. about each shape.
-	Shape_info                zinfo;    // A fake one (all 0's).
-	bool                      info_read = false;    // True when info is set.
+	Shape_info_table info;     // Extra info. about each shape.
+	Shape_info       zinfo;    // A fake one (all 0's).
+	bool             info_read = false;    // True when info is set.
 	void Read_Shapeinf_text_data_file(bool editing, Exult_Game game_type);
 	void Read_Bodies_text_data_file(bool editing, Exult_Game game_type);
 	void Read_Paperdoll_text_data_file(bool editing, Exult_Game game_type);
@@ -66,24 +66,28 @@ public:
 	Shape* new_shape(int shapenum) override;
 
 	Shape_info& get_info(int shapenum) {
-		auto it = info.find(shapenum);
-		if (it != info.end()) {
-			return it->second;
-		}
-		return zinfo;
+		Shape_info* inf = info.find(shapenum);
+		return inf ? *inf : zinfo;
+	}
+
+	// Only updated when the info is read or set; changes made through
+	//   get_info() show here after reload_info().
+	const Shape_hot_info& get_hot_info(int shapenum) const {
+		return info.get_hot(shapenum);
 	}
 
 	bool has_info(int shapenum) {
-		auto it = info.find(shapenum);
-		return it != info.end();
+		return info.find(shapenum) != nullptr;
 	}
 
 	void set_info(int shapenum, const Shape_info& inf) {
 		info[shapenum] = inf;
+		info.update_hot(shapenum);
 	}
 
 	void copy_info(int shapenum, const Shape_info& inf) {
 		info[shapenum].copy(inf, true);
+		info.update_hot(shapenum);
 	}
 };
 
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <list>
 #include <map>
 #include <string>
 #include <utility>
@@ -54,6 +55,188 @@ using std::vector;
 
 Image_buffer8* Shape_frame::scrwin = nullptr;
 
+/*
+ *  The RLE data of a frame decoded into spans of opaque pixels, so painting
+ *  doesn't have to decode the runs each time.
+ */
+struct Shape_spans {
+	// Runs of one colour this long are filled rather than copied.
+	static constexpr int min_fill = 8;
+
+	std::vector<Image_buffer8::Rle_span> spans;    // Sorted by y.
+	std::vector<unsigned char>           pixels;
+	size_t                               memory = 0;
+	// Position in the LRU list, most recently painted first.
+	std::list<Shape_frame*>::iterator lru;
+
+	explicit Shape_spans(const unsigned char* data);
+
+	void add_pixels(int x, int y, const unsigned char* in, int cnt);
+	void add_fill(int x, int y, unsigned char col, int cnt);
+};
+
+static std::list<Shape_frame*> span_lru;
+
+size_t Shape_frame::span_budget = 0;
+size_t Shape_frame::span_memory = 0;
+
+/*
+ *  Add a run of pixels, joining it to the last span if it follows on.
+ */
+
+void Shape_spans::add_pixels(
+		int x, int y, const unsigned char* in, int cnt) {
+	if (!spans.empty()) {
+		Image_buffer8::Rle_span& last = spans.back();
+		if (!last.fill && last.y == y && last.x + last.len == x
+			&& last.len + cnt <= 0xffff) {
+			last.len += cnt;
+			pixels.insert(pixels.end(), in, in + cnt);
+			return;
+		}
+	}
+	spans.push_back(
+			{static_cast<short>(x), static_cast<short>(y),
+			 static_cast<unsigned short>(cnt), false,
+			 static_cast<unsigned int>(pixels.size())});
+	pixels.insert(pixels.end(), in, in + cnt);
+}
+
+/*
+ *  Add a run of one colour.
+ */
+
+void Shape_spans::add_fill(int x, int y, unsigned char col, int cnt) {
+	if (cnt < min_fill) {
+		const unsigned char run[min_fill] = {col, col, col, col,
+											 col, col, col, col};
+		add_pixels(x, y, run, cnt);
+		return;
+	}
+	spans.push_back(
+			{static_cast<short>(x), static_cast<short>(y),
+			 static_cast<unsigned short>(cnt), true, col});
+}
+
+/*
+ *  Decode RLE data.
+ */
+
+Shape_spans::Shape_spans(const unsigned char* data) {
+	const uint8* in = data;
+	int          scanlen;
+	while ((scanlen = little_endian::Read2(in)) != 0) {
+		// Get length of scan line.
+		const int encoded = scanlen & 1;    // Is it encoded?
+		scanlen           = scanlen >> 1;
+		int       scanx   = static_cast<sint16>(little_endian::Read2(in));
+		const int scany   = static_cast<sint16>(little_endian::Read2(in));
+		if (!encoded) {    // Raw data?
+			add_pixels(scanx, scany, in, scanlen);
+			in += scanlen;
+			continue;
+		}
+		while (scanlen > 0) {
+			int       bcnt   = Read1(in);
+			const int repeat = bcnt & 1;    // Repeat next char. if odd.
+			bcnt             = bcnt >> 1;
+			if (bcnt == 0) {
+				break;
+			}
+			if (repeat) {
+				add_fill(scanx, scany, Read1(in), bcnt);
+			} else {
+				add_pixels(scanx, scany, in, bcnt);
+				in += bcnt;
+			}
+			scanx += bcnt;
+			scanlen -= bcnt;
+		}
+	}
+	// Scan lines are normally stored top to bottom, but make sure.
+	std::stable_sort(
+			spans.begin(), spans.end(),
+			[](const Image_buffer8::Rle_span& a,
+			   const Image_buffer8::Rle_span& b) {
+				return a.y < b.y;
+			});
+	spans.shrink_to_fit();
+	pixels.shrink_to_fit();
+	memory = sizeof(*this) + spans.size() * sizeof(spans[0]) + pixels.size();
+}
+
+/*
+ *  Get the decoded spans of an RLE frame, decoding them if needed.
+ *
+ *  Output: nullptr if spans are disabled.
+ */
+
+const Shape_spans* Shape_frame::get_spans() {
+	if (!span_budget) {
+		return nullptr;
+	}
+	if (spans) {
+		// Most recently used.
+		span_lru.splice(span_lru.begin(), span_lru, spans->lru);
+		return spans.get();
+	}
+	spans = make_unique<Shape_spans>(data.get());
+	span_lru.push_front(this);
+	spans->lru = span_lru.begin();
+	span_memory += spans->memory;
+	// Drop the least recently painted frames, but never this one.
+	while (span_memory > span_budget && span_lru.back() != this) {
+		span_lru.back()->release_spans();
+	}
+	return spans.get();
+}
+
+/*
+ *  Forget the decoded spans.
+ */
+
+void Shape_frame::release_spans() {
+	if (spans) {
+		span_memory -= spans->memory;
+		span_lru.erase(spans->lru);
+		spans.reset();
+	}
+}
+
+void Shape_frame::set_span_budget(size_t bytes) {
+	span_budget = bytes;
+	while (span_memory > span_budget) {
+		span_lru.back()->release_spans();
+	}
+}
+
+Shape_frame::~Shape_frame() noexcept {
+	release_spans();
+}
+
+Shape_frame::Shape_frame(Shape_frame&& other) noexcept
+		: data(std::move(other.data)), datalen(other.datalen),
+		  xleft(other.xleft), xright(other.xright), yabove(other.yabove),
+		  ybelow(other.ybelow), rle(other.rle) {
+	// The spans know which frame they belong to; just decode them again.
+	other.release_spans();
+}
+
+Shape_frame& Shape_frame::operator=(Shape_frame&& other) noexcept {
+	if (this != &other) {
+		release_spans();
+		other.release_spans();
+		data    = std::move(other.data);
+		datalen = other.datalen;
+		xleft   = other.xleft;
+		xright  = other.xright;
+		yabove  = other.yabove;
+		ybelow  = other.ybelow;
+		rle     = other.rle;
+	}
+	return *this;
+}
+
 /*
  *  +++++Debugging
  */
@@ -241,6 +424,7 @@ void Shape_frame::create_rle(
 		unsigned char* pixels,    // 8-bit uncompressed data.
 		int w, int h              // Width, height.
 ) {
+	release_spans();
 	data = encode_rle(pixels, w, h, xleft, yabove, datalen);
 }
 
@@ -405,15 +589,33 @@ unsigned int Shape_frame::read(
 		uint32       shapelen,    // Length expected for detecting RLE.
 		int          frnum        // Frame #.
 ) {
-	int framenum = frnum;
-	rle          = false;
 	if (!shapelen && !shapeoff) {
+		rle = false;
+		release_spans();
 		return 0;
 	}
-	// Get to actual shape.
-	shapes->seek(shapeoff);
-	const uint32 dlen   = shapes->read4();
-	const uint32 hdrlen = shapes->read4();
+	shapes->seek(shapeoff);    // Get to actual shape.
+	IDataWindow shape = shapes->lockWindow(shapelen);
+	return read(shape, shapelen, frnum);
+}
+
+/*
+ *  Read in a desired shape from a window on the whole shape.
+ *
+ *  Output: # of frames.
+ */
+
+unsigned int Shape_frame::read(
+		IDataWindow& shape,       // The shape's data.
+		uint32       shapelen,    // Length expected for detecting RLE.
+		int          frnum        // Frame #.
+) {
+	int framenum = frnum;
+	rle          = false;
+	release_spans();
+	shape.seek(0);
+	const uint32 dlen   = shape.read4();
+	const uint32 hdrlen = shape.read4();
 	// it's a rle shape if dlen equals the filesize, or if the filesize is 16bit
 	// aligned and dlen equals filesize-1
 	if (dlen == shapelen
@@ -429,29 +631,30 @@ unsigned int Shape_frame::read(
 		uint32 framelen;
 		if (framenum == 0) {
 			frameoff = hdrlen;
-			framelen = nframes > 1 ? shapes->read4() - frameoff
+			framelen = nframes > 1 ? shape.read4() - frameoff
 								   : dlen - frameoff;
 		} else {
-			shapes->skip((framenum - 1) * 4);
-			frameoff = shapes->read4();
+			shape.skip((framenum - 1) * 4);
+			frameoff = shape.read4();
 			// Last frame?
 			if (framenum == nframes - 1) {
 				framelen = dlen - frameoff;
 			} else {
-				framelen = shapes->read4() - frameoff;
+				framelen = shape.read4() - frameoff;
 			}
 		}
 		// Get compressed data.
-		get_rle_shape(shapes, shapeoff + frameoff, framelen);
+		get_rle_shape(shape, frameoff, framelen);
 		// Return # frames.
 		return nframes;
 	}
 	framenum &= 31;                 // !!!Guessing here.
 	xleft = yabove = c_tilesize;    // Just an 8x8 bitmap.
 	xright = ybelow = -1;
-	shapes->seek(shapeoff + framenum * c_num_tile_bytes);
+	shape.seek(framenum * c_num_tile_bytes);
 	datalen = c_num_tile_bytes;
-	data    = shapes->readN(c_num_tile_bytes);
+	data    = make_unique<unsigned char[]>(c_num_tile_bytes);
+	shape.read(data.get(), c_num_tile_bytes);
 	return shapelen / c_num_tile_bytes;    // That's how many frames.
 }
 
@@ -460,24 +663,24 @@ unsigned int Shape_frame::read(
  */
 
 void Shape_frame::get_rle_shape(
-		IDataSource* shapes,     // Shapes data source to read.
-		long         filepos,    // Position in file.
-		long         len         // Length of entire frame data.
+		IDataWindow& shape,       // The shape's data.
+		long         framepos,    // Position in shape.
+		long         len          // Length of entire frame data.
 ) {
-	shapes->seek(filepos);    // Get to extents.
-	xright = shapes->read2();
-	xleft  = shapes->read2();
-	yabove = shapes->read2();
-	ybelow = shapes->read2();
+	release_spans();
+	shape.seek(framepos);    // Get to extents.
+	xright = shape.read2();
+	xleft  = shape.read2();
+	yabove = shape.read2();
+	ybelow = shape.read2();
 	len -= 8;    // Subtract what we just read.
-	if (len == 0) {
-		datalen       = 2;
-		data[len]     = 0;    // 0-delimit.
-		data[len + 1] = 0;
+	if (len <= 0) {
+		datalen = 2;
+		data    = make_unique<unsigned char[]>(datalen);    // 0-delimit.
 	} else {
 		datalen = len;
 		data    = make_unique<unsigned char[]>(datalen);
-		shapes->read(data.get(), len);
+		shape.read(data.get(), len);
 	}
 	rle = true;
 }
@@ -501,6 +704,12 @@ void Shape_frame::paint_rle(
 		}
 	}
 
+	if (const Shape_spans* sp = get_spans()) {
+		win->paint_spans(
+				xoff, yoff, sp->spans.data(), sp->spans.size(),
+				sp->pixels.data());
+		return;
+	}
 	win->paint_rle(xoff, yoff, data.get());
 }
 
@@ -523,6 +732,12 @@ void Shape_frame::paint_rle_remapped(
 		}
 	}
 
+	if (const Shape_spans* sp = get_spans()) {
+		win->paint_spans(
+				xoff, yoff, sp->spans.data(), sp->spans.size(),
+				sp->pixels.data(), trans);
+		return;
+	}
 	win->paint_rle_remapped(xoff, yoff, data.get(), trans);
 }
 
@@ -780,6 +995,7 @@ void Shape_frame::set_offset(int new_xright, int new_ybelow) {
 	}
 	const int deltax = new_xright - xright;    // Get changes.
 	const int deltay = new_ybelow - ybelow;
+	release_spans();
 	xright           = new_xright;
 	ybelow           = new_ybelow;
 	xleft            = w - xright - 1;    // Update other dims.
@@ -1041,15 +1257,16 @@ void Shape::load(IDataSource* shape_source    // datasource.
 ) {
 	reset();
 	auto         frame    = make_unique<Shape_frame>();
-	const size_t location = shape_source->getPos();
 	const size_t shapelen = shape_source->getAvail();
+	// All frames are read from one window on the shape.
+	IDataWindow shape = shape_source->lockWindow(shapelen);
 	// Read frame 0 & get frame count.
-	create_frames_list(frame->read(shape_source, location, shapelen, 0));
+	create_frames_list(frame->read(shape, shapelen, 0));
 	store_frame(std::move(frame), 0);
 	// Get the rest.
 	for (size_t i = 1; i < num_frames; i++) {
 		auto frame = make_unique<Shape_frame>();
-		frame->read(shape_source, location, shapelen, i);
+		frame->read(shape, shapelen, i);
 		store_frame(std::move(frame), i);
 	}
 }
@@ -1190,8 +1407,16 @@ IDataSource* Vga_file::U7load(
 	unique_ptr<IDataSource> source;
 	bool                    is_patch = false;
 	if (resource.second < 0) {
-		// It is a file.
-		source   = make_unique<IFileDataSource>(resource.first);
+		// It is a file. Static ones are mapped, if possible.
+		if (!resource.first.compare(0, 9, "<STATIC>/")) {
+			auto mapped = make_unique<IMappedDataSource>(resource.first);
+			if (mapped->good()) {
+				source = std::move(mapped);
+			}
+		}
+		if (!source) {
+			source = make_unique<IFileDataSource>(resource.first);
+		}
 		is_patch = !resource.first.compare(0, 7, "<PATCH>");
 	} else {
 		// It is a resource.
@@ -36,10 +36,12 @@
 #include <vector>
 
 class IDataSource;
+class IDataWindow;
 class ODataSource;
 class Shape;
 class Image_buffer8;
 class Palette;
+struct Shape_spans;
 
 /*
  *  A shape from "shapes.vga":
@@ -53,11 +55,18 @@ class Shape_frame {
 	short                            ybelow;    // Extent below origin.
 	bool                             rle;       // Run-length encoded.
 	static Image_buffer8*            scrwin;    // Screen window to render to.
-
+	// RLE data decoded for painting, for the most recently painted frames.
+	std::unique_ptr<Shape_spans> spans;
+	static size_t                span_budget;    // Bytes; 0 = no spans.
+	static size_t                span_memory;
+
+	// Get the decoded spans, or nullptr if they are disabled.
+	const Shape_spans* get_spans();
+	void               release_spans();
 	// Create RLE data & store in frame.
 	void create_rle(unsigned char* pixels, int w, int h);
 	// Create from RLE entry.
-	void get_rle_shape(IDataSource* shapes, long filepos, long len);
+	void get_rle_shape(IDataWindow& shape, long framepos, long len);
 
 public:
 	Shape_frame() = default;
@@ -74,6 +83,13 @@ public:
 		scrwin = w;
 	}
 
+	// Set the memory used for decoded RLE spans.  0 turns them off.
+	static void set_span_budget(size_t bytes);
+
+	static size_t get_span_memory() {
+		return span_memory;
+	}
+
 	unsigned char* get_data() {
 		return data.get();
 	}
@@ -93,6 +109,7 @@ public:
 	// Read in shape/frame.
 	unsigned int read(
 			IDataSource* shapes, uint32 shapeoff, uint32 shapelen, int frnum);
+	unsigned int read(IDataWindow& shape, uint32 shapelen, int frnum);
 	// Paint into given buffer.
 	void paint_rle(Image_buffer8* win, int xoff, int yoff);
 	void paint_rle_remapped(
@@ -168,11 +185,11 @@ public:
 		return !data || (data[0] == 0 && data[1] == 0);
 	}
 
-	virtual ~Shape_frame() noexcept                = default;
-	Shape_frame(const Shape_frame&)                = delete;
-	Shape_frame& operator=(const Shape_frame&)     = delete;
-	Shape_frame(Shape_frame&&) noexcept            = default;
-	Shape_frame& operator=(Shape_frame&&) noexcept = default;
+	virtual ~Shape_frame() noexcept;
+	Shape_frame(const Shape_frame&)            = delete;
+	Shape_frame& operator=(const Shape_frame&) = delete;
+	Shape_frame(Shape_frame&& other) noexcept;
+	Shape_frame& operator=(Shape_frame&& other) noexcept;
 };
 
 /*
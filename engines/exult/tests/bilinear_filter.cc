@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "pent_include.h"
+
+#include "BilinearScalerInternal.h"
+#include "bilinear_filter.h"
+
+#ifdef BSI_NO_SIMD
+#	define FilterImage FilterImage_Scalar
+#else
+#	define FilterImage FilterImage_SIMD
+#endif
+
+using namespace Pentagram::BilinearScaler;
+
+namespace {
+	// Packs the channels as they come out of the filter, so the test sees
+	// exactly what a Manip would get
+	struct PackRGB {
+		static uint32 rgb(uint32 r, uint32 g, uint32 b) {
+			return r | (g << 8) | (b << 16);
+		}
+	};
+
+	// The coefficents the 2x, X2Y24 and X1Y12 scalers use, and the ends
+	// of the range
+	const uint_fast32_t coefficents[]
+			= {0, 1, 2, 51, 64, 102, 127, 128, 129, 153, 204, 255, 256};
+
+	// Fills pixels the filters must not write to
+	const uint32 untouched = 0xDEADBEEF;
+}    // namespace
+
+void BilinearTest::FilterImage(const Image& img, std::vector<uint32>& out) {
+	for (int y = 0; y + 1 < img.h; y++) {
+		for (int x = 0; x + 1 < img.w; x++) {
+			const uint8* tl = img.texel(x, y);
+			const uint8* tr = img.texel(x + 1, y);
+			const uint8* bl = img.texel(x, y + 1);
+			const uint8* br = img.texel(x + 1, y + 1);
+
+			for (const uint_fast32_t fy : coefficents) {
+				for (const uint_fast32_t fx : coefficents) {
+					uint32 pixel = untouched;
+					Interpolate2x2BlockTo1<uint32, PackRGB, uint32>(
+							tl, bl, tr, br, fx, fy,
+							reinterpret_cast<uint8*>(&pixel));
+					out.push_back(pixel);
+
+					uint32 pixels[2] = {untouched, untouched};
+					Interpolate2x2BlockTo2x1<uint32, PackRGB, uint32>(
+							tl, bl, tr, br, fx, 256 - fx, fy,
+							reinterpret_cast<uint8*>(pixels));
+					out.push_back(pixels[0]);
+					out.push_back(pixels[1]);
+
+					// With the second pixel past the limit of the surface
+					pixels[0] = pixels[1] = untouched;
+					uint8* limit = reinterpret_cast<uint8*>(&pixels[1]);
+					Interpolate2x2BlockTo2x1<uint32, PackRGB, uint32>(
+							tl, bl, tr, br, fx, 256 - fx, fy,
+							reinterpret_cast<uint8*>(pixels), limit);
+					out.push_back(pixels[0]);
+					out.push_back(pixels[1]);
+				}
+			}
+		}
+	}
+
+	// Every coefficent pair on the first block
+	if (img.w < 2 || img.h < 2) {
+		return;
+	}
+	const uint8* tl = img.texel(0, 0);
+	const uint8* tr = img.texel(1, 0);
+	const uint8* bl = img.texel(0, 1);
+	const uint8* br = img.texel(1, 1);
+	for (uint_fast32_t fy = 0; fy <= 256; fy++) {
+		for (uint_fast32_t fx = 0; fx <= 256; fx++) {
+			uint32 pixel = untouched;
+			Interpolate2x2BlockTo1<uint32, PackRGB, uint32>(
+					tl, bl, tr, br, fx, fy, reinterpret_cast<uint8*>(&pixel));
+			out.push_back(pixel);
+		}
+	}
+}
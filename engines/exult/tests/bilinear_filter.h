@@ -0,0 +1,47 @@
+/*
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef BILINEAR_FILTER_H
+#define BILINEAR_FILTER_H
+
+#include "common_types.h"
+
+#include <vector>
+
+// bilinear_filter.cc is built twice, once with the SSE2 or NEON texel block
+// filters of BilinearScalerInternal.h (if the target has them) and once with
+// BSI_NO_SIMD.
+namespace BilinearTest {
+	// A source image of w x h RGBA texels
+	struct Image {
+		int                w, h;
+		std::vector<uint8> texels;
+
+		const uint8* texel(int x, int y) const {
+			return &texels[(y * w + x) * 4];
+		}
+	};
+
+	// Filter every 2x2 texel block of img with Interpolate2x2BlockTo1 and
+	// Interpolate2x2BlockTo2x1 for a set of filtering coefficents, and
+	// append the resulting pixels to out.
+	void FilterImage_SIMD(const Image& img, std::vector<uint32>& out);
+	void FilterImage_Scalar(const Image& img, std::vector<uint32>& out);
+}    // namespace BilinearTest
+
+#endif
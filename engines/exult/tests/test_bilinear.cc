@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+// Checks that the SSE2 and NEON texel block filters of the bilinear scalers
+// give exactly the same pixels as the plain C++ ones, on a few fixed images.
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "bilinear_filter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using BilinearTest::Image;
+
+namespace {
+	Image MakeImage(int w, int h) {
+		Image img;
+		img.w = w;
+		img.h = h;
+		img.texels.resize(w * h * 4);
+		return img;
+	}
+
+	void SetTexel(Image& img, int x, int y, int r, int g, int b, int a) {
+		uint8* t = &img.texels[(y * img.w + x) * 4];
+		t[0]     = static_cast<uint8>(r);
+		t[1]     = static_cast<uint8>(g);
+		t[2]     = static_cast<uint8>(b);
+		t[3]     = static_cast<uint8>(a);
+	}
+
+	// Smooth ramps in every channel
+	Image Gradient() {
+		Image img = MakeImage(17, 13);
+		for (int y = 0; y < img.h; y++) {
+			for (int x = 0; x < img.w; x++) {
+				SetTexel(img, x, y, x * 15, y * 21, (x + y) * 9, 255);
+			}
+		}
+		return img;
+	}
+
+	// Black and white texels next to each other, the largest steps
+	Image Checker() {
+		Image img = MakeImage(9, 9);
+		for (int y = 0; y < img.h; y++) {
+			for (int x = 0; x < img.w; x++) {
+				const int v = ((x + y) & 1) ? 255 : 0;
+				SetTexel(img, x, y, v, 255 - v, (x & 2) ? v : 255, v);
+			}
+		}
+		return img;
+	}
+
+	// Noise from a fixed seed
+	Image Noise() {
+		Image  img   = MakeImage(16, 16);
+		uint32 state = 0x1234567;
+		for (uint8& t : img.texels) {
+			state = state * 1664525u + 1013904223u;
+			t     = static_cast<uint8>(state >> 24);
+		}
+		return img;
+	}
+
+	bool Compare(const char* name, const Image& img) {
+		std::vector<uint32> expected;
+		std::vector<uint32> actual;
+		BilinearTest::FilterImage_Scalar(img, expected);
+		BilinearTest::FilterImage_SIMD(img, actual);
+
+		if (expected.size() != actual.size()) {
+			std::printf(
+					"%s: FAIL, %zu pixels instead of %zu\n", name,
+					actual.size(), expected.size());
+			return false;
+		}
+		for (size_t i = 0; i < expected.size(); i++) {
+			if (expected[i] != actual[i]) {
+				std::printf(
+						"%s: FAIL, pixel %zu is %08x instead of %08x\n", name,
+						i, actual[i], expected[i]);
+				return false;
+			}
+		}
+		std::printf("%s: %zu pixels match\n", name, expected.size());
+		return true;
+	}
+}    // namespace
+
+int main() {
+	bool ok = true;
+	ok      = Compare("gradient", Gradient()) && ok;
+	ok      = Compare("checker", Checker()) && ok;
+	ok      = Compare("noise", Noise()) && ok;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -690,8 +690,7 @@ static void Create(
 			 << "' exists, so we won't overwrite it" << endl;
 		palname = nullptr;
 	}
-	OFileDataSource out(imagename);    // May throw exception.
-	Flex_writer     writer(out, title, specs.size());
+	Flex_writer writer(imagename, title, specs.size());    // May throw.
 	for (auto& spec : specs) {
 		char* basename = spec.filename;
 		if (basename) {    // Not empty?
@@ -741,9 +740,8 @@ static void Update(
 			data[i].reset();
 		}
 	}
-	OFileDataSource out(imagename);    // May throw exception.
-	const size_t    newcnt = oldcnt > specs.size() ? oldcnt : specs.size();
-	Flex_writer     writer(out, title, newcnt);
+	const size_t newcnt = oldcnt > specs.size() ? oldcnt : specs.size();
+	Flex_writer  writer(imagename, title, newcnt);    // May throw.
 	for (i = 0; i < newcnt; i++) {    // Write out new entries.
 		// New entry for this shape?
 		if (i < specs.size() && specs[i].filename != nullptr) {
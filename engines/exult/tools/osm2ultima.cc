@@ -0,0 +1,1774 @@
+/*
+ *  osm2ultima.cc - Make a U7 map from OpenStreetMap data.
+ *
+ *  Copyright (C) 2026  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  This is the native counterpart of tools/osm2ultima/osm2ultima.py, for
+ *  extracts too big for it.  The input is read once, a block at a time;
+ *  each way is kept only as the tiles of its nodes, and each tagged node
+ *  only as the object it becomes.  The map is then painted by several
+ *  threads, each owning a band of chunk rows and going through all of
+ *  the ways in order, so the result is the same for any number of them.
+ *
+ *  The shapes come from osm_shape_mapping.txt, which is written by
+ *  'osm_shape_mapping.py --export'.  Building interiors and NPC's are
+ *  left to the Python tool.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "Flex.h"
+#include "U7obj.h"
+#include "databuf.h"
+#include "exceptions.h"
+#include "exult_constants.h"
+#include "terraindedup.h"
+#include "utils.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::string_view;
+using std::vector;
+
+// Exult keeps terrain numbers in shorts.
+constexpr const int c_max_terrains = 0x8000;
+
+using Tags = vector<std::pair<string_view, string_view>>;
+
+static string_view Get_tag(const Tags& tags, string_view key) {
+	for (const auto& tag : tags) {
+		if (tag.first == key) {
+			return tag.second;
+		}
+	}
+	return {};
+}
+
+static bool Has_tag(const Tags& tags, string_view key) {
+	for (const auto& tag : tags) {
+		if (tag.first == key) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ *  The shape tables exported from osm_shape_mapping.py.  Lookups follow
+ *  get_terrain_shape() and get_object_shapes() there.
+ */
+
+class Shape_mapping {
+	vector<vector<int>>             lists;       // Shape lists.
+	std::unordered_map<string, int> terrains;    // Terrain name -> list.
+	std::unordered_map<string, int> objects;     // Object name -> list.
+	// "<table> <key>" -> name of a terrain or object.
+	std::unordered_map<string, string> entries;
+	// "<building type> <component>" -> object name.
+	std::unordered_map<string, string> buildings;
+
+	const string* find_entry(const char* table, string_view key) const {
+		string name(table);
+		name += ' ';
+		name += key;
+		auto it = entries.find(name);
+		return it != entries.end() ? &it->second : nullptr;
+	}
+
+	int find_list(
+			const std::unordered_map<string, int>& names,
+			const string&                          name) const {
+		auto it = names.find(name);
+		return it != names.end() ? it->second : -1;
+	}
+
+public:
+	// What a feature is made of, as shape lists, or -1.
+	struct Object_shapes {
+		int main  = -1;
+		int walls = -1;
+		int roof  = -1;
+		int door  = -1;
+	};
+
+	bool read(const char* fname);
+
+	const vector<int>& get_list(int index) const {
+		return lists[index];
+	}
+
+	int terrain(const string& name) const {
+		return find_list(terrains, name);
+	}
+
+	int object(const string& name) const {
+		return find_list(objects, name);
+	}
+
+	// A terrain by name, or a fallback if there's no such terrain.
+	int terrain_or(const string& name, const char* fallback) const {
+		const int list = terrain(name);
+		return list >= 0 ? list : terrain(fallback);
+	}
+
+	int terrain_for(const Tags& tags) const;
+	int highway_terrain(string_view highway) const;
+	Object_shapes objects_for(const Tags& tags) const;
+};
+
+/*
+ *  Read the tables.
+ *
+ *  Output: false if the file couldn't be read.
+ */
+
+bool Shape_mapping::read(const char* fname) {
+	std::ifstream in(fname);
+	if (!in.good()) {
+		return false;
+	}
+	string line;
+	while (std::getline(in, line)) {
+		std::istringstream words(line);
+		string             table;
+		string             key;
+		if (!(words >> table >> key) || table[0] == '#') {
+			continue;
+		}
+		if (table == "terrain" || table == "object") {
+			vector<int> shapes;
+			int         shape;
+			while (words >> shape) {
+				shapes.push_back(shape);
+			}
+			auto& names = table == "terrain" ? terrains : objects;
+			names[key]  = static_cast<int>(lists.size());
+			lists.push_back(std::move(shapes));
+		} else if (table == "building") {
+			string component;
+			string name;
+			if (words >> component >> name) {
+				buildings[key + ' ' + component] = name;
+			}
+		} else {
+			string name;
+			if (words >> name) {
+				entries[table + ' ' + key] = name;
+			}
+		}
+	}
+	return terrain("grass") >= 0;
+}
+
+/*
+ *  Get the terrain shapes for an area.
+ */
+
+int Shape_mapping::terrain_for(const Tags& tags) const {
+	static const struct {
+		const char* tag;
+		const char* table;
+		const char* fallback;
+	} checks[] = {
+			{    "landuse",  "landuse_terrain",       "grass"},
+			{    "natural",  "natural_terrain",       "grass"},
+			{    "surface",  "surface_terrain",       "grass"},
+			{    "highway",  "highway_terrain", "cobblestone"},
+			{   "waterway", "waterway_terrain",       "water"}
+    };
+	for (const auto& check : checks) {
+		const string_view value = Get_tag(tags, check.tag);
+		if (value.empty()) {
+			continue;
+		}
+		if (const string* name = find_entry(check.table, value)) {
+			return terrain_or(*name, check.fallback);
+		}
+	}
+	return terrain("grass");
+}
+
+/*
+ *  Get the terrain shapes for a road.
+ */
+
+int Shape_mapping::highway_terrain(string_view highway) const {
+	const string* name = find_entry("highway_terrain", highway);
+	return terrain_or(name ? *name : string("cobblestone"), "cobblestone");
+}
+
+/*
+ *  Get the object shapes for a feature.
+ */
+
+Shape_mapping::Object_shapes Shape_mapping::objects_for(
+		const Tags& tags) const {
+	Object_shapes     result;
+	const string_view building = Get_tag(tags, "building");
+	if (!building.empty()) {
+		string type(building);
+		if (buildings.find(type + " walls") == buildings.end()
+			&& buildings.find(type + " roof") == buildings.end()) {
+			type = "house";
+		}
+		auto component = [&](const char* name) {
+			auto it = buildings.find(type + ' ' + name);
+			return it != buildings.end() ? object(it->second) : -1;
+		};
+		result.walls = component("walls");
+		result.roof  = component("roof");
+		result.door  = component("door");
+		return result;
+	}
+	static const struct {
+		const char* tag;
+		const char* table;
+	} checks[] = {
+			{ "amenity",  "amenity_object"},
+			{ "natural",  "natural_object"},
+			{ "barrier",  "barrier_object"},
+			{"man_made", "man_made_object"}
+    };
+	for (const auto& check : checks) {
+		const string_view value = Get_tag(tags, check.tag);
+		if (value.empty()) {
+			continue;
+		}
+		if (const string* name = find_entry(check.table, value)) {
+			result.main = object(*name);
+			return result;
+		}
+	}
+	return result;
+}
+
+/*
+ *  A point in tiles.  Points off the map are kept, so features crossing
+ *  its edge are clipped rather than squashed onto it.
+ */
+
+struct Tile_point {
+	int x;
+	int y;
+};
+
+/*
+ *  An object to be written out.
+ */
+
+struct Map_object {
+	int           tx;
+	int           ty;
+	uint16        shapenum;
+	unsigned char lift;
+	bool          ireg;    // Goes in 'u7ireg', else 'u7ifix'.
+};
+
+/*
+ *  Something painted onto the map, in the order read.
+ */
+
+struct Map_feature {
+	enum Kind : unsigned char {
+		line,        // Terrain along the ways.
+		area,        // Terrain filling a closed way.
+		bridge,      // Planking, with bridge pieces at the ends.
+		barrier,     // Objects along the ways.
+		building,    // Floor, walls, door and roof.
+	};
+
+	Kind     kind;
+	int      width;       // For lines and bridges.
+	int      shapes;      // Shape list (walls for buildings).
+	int      roof;        // Buildings only.
+	int      door;
+	uint32_t first;       // Into vertices.
+	uint32_t count;
+	int      minx, miny, maxx, maxy;    // Tiles it can touch.
+};
+
+/*
+ *  Gathers the features as they're read, then paints the map.
+ */
+
+class Map_generator {
+	const Shape_mapping& mapping;
+	double               min_lon, min_lat, lon_range, lat_range;
+	int                  tiles_x, tiles_y;    // Map size in tiles.
+	uint64_t             seed;
+
+	struct Node_tile {
+		int64_t id;
+		int     x;
+		int     y;
+
+		bool operator<(const Node_tile& other) const {
+			return id < other.id;
+		}
+	};
+
+	vector<Node_tile>   nodes;
+	bool                nodes_sorted = true;
+	vector<Tile_point>  vertices;
+	vector<Map_feature> features;
+	vector<Map_object>  points;    // Objects placed as read.
+
+	// Roads, as MapGenerator.HIGHWAY_WIDTHS.
+	static int highway_width(string_view highway);
+
+	Tile_point to_tile(double lon, double lat) const;
+
+	const Node_tile* find_node(int64_t id) {
+		if (!nodes_sorted) {
+			std::stable_sort(nodes.begin(), nodes.end());
+			nodes_sorted = true;
+		}
+		auto it = std::lower_bound(
+				nodes.begin(), nodes.end(), Node_tile{id, 0, 0});
+		return it != nodes.end() && it->id == id ? &*it : nullptr;
+	}
+
+	bool on_map(int x, int y) const {
+		return x >= 0 && y >= 0 && x < tiles_x && y < tiles_y;
+	}
+
+	// Pick one of a list, the same way for the same place and salt.
+	int choose(int list, uint64_t salt, int x, int y) const;
+	void add_feature(
+			Map_feature::Kind kind, int shapes, int width, uint32_t first);
+	void add_point(int list, Tile_point pt, bool ireg);
+
+	// Painting one band of rows.
+	struct Band {
+		int                 y0, y1;    // Rows [y0, y1).
+		uint16*             terrain;
+		vector<Map_object>* objects;
+	};
+
+	void paint(const Band& band) const;
+	void paint_line(const Band& band, const Map_feature& f, size_t n) const;
+	void paint_area(const Band& band, const Map_feature& f, size_t n) const;
+	void paint_building(
+			const Band& band, const Map_feature& f, size_t n) const;
+
+public:
+	// Tiles painted by nothing.
+	static constexpr uint16 no_terrain = 0xffff;
+
+	struct Stats {
+		size_t nodes     = 0;
+		size_t ways      = 0;
+		size_t roads     = 0;
+		size_t buildings = 0;
+	} stats;
+
+	Map_generator(
+			const Shape_mapping& m, const double bbox[4], int chunks_x,
+			int chunks_y, uint64_t s)
+			: mapping(m), min_lon(bbox[0]), min_lat(bbox[1]),
+			  lon_range(bbox[2] - bbox[0]), lat_range(bbox[3] - bbox[1]),
+			  tiles_x(chunks_x * c_tiles_per_chunk),
+			  tiles_y(chunks_y * c_tiles_per_chunk), seed(s) {}
+
+	int get_tiles_x() const {
+		return tiles_x;
+	}
+
+	int get_tiles_y() const {
+		return tiles_y;
+	}
+
+	void add_node(int64_t id, double lon, double lat, const Tags& tags);
+	void add_way(const vector<int64_t>& refs, const Tags& tags);
+	// Paint everything with this many threads.
+	void generate(
+			int nthreads, vector<uint16>& terrain,
+			vector<Map_object>& objects) const;
+};
+
+int Map_generator::highway_width(string_view highway) {
+	static const std::pair<const char*, int> widths[] = {
+			{  "motorway", 4},
+            {     "trunk", 4},
+            {   "primary", 3},
+			{ "secondary", 3},
+            {  "tertiary", 2},
+            {"residential", 2},
+			{   "service", 1},
+            {     "track", 1},
+            {      "path", 1},
+			{  "footway", 1},
+            {"pedestrian", 2},
+            {  "cycleway", 1},
+			{"bridleway", 1},
+            {     "steps", 1}
+    };
+	for (const auto& entry : widths) {
+		if (highway == entry.first) {
+			return entry.second;
+		}
+	}
+	return 2;
+}
+
+/*
+ *  Convert a position to tiles, with north at the top.
+ */
+
+Tile_point Map_generator::to_tile(double lon, double lat) const {
+	const double nx = lon_range > 0 ? (lon - min_lon) / lon_range : 0.5;
+	const double ny = 1.0 - (lat_range > 0 ? (lat - min_lat) / lat_range : 0.5);
+	// Far-off points only need to stay far off.
+	constexpr double limit = 1 << 24;
+	return Tile_point{
+			static_cast<int>(std::floor(std::clamp(nx * tiles_x, -limit, limit))),
+			static_cast<int>(
+					std::floor(std::clamp(ny * tiles_y, -limit, limit)))};
+}
+
+int Map_generator::choose(int list, uint64_t salt, int x, int y) const {
+	const vector<int>& shapes = mapping.get_list(list);
+	if (shapes.empty()) {
+		return -1;
+	}
+	// SplitMix64 over the seed, salt and place.
+	auto mix = [](uint64_t z) {
+		z += 0x9e3779b97f4a7c15ULL;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	};
+	uint64_t h = mix(seed ^ salt);
+	h          = mix(h ^ static_cast<uint32_t>(x));
+	h          = mix(h ^ static_cast<uint32_t>(y));
+	return shapes[h % shapes.size()];
+}
+
+void Map_generator::add_feature(
+		Map_feature::Kind kind, int shapes, int width, uint32_t first) {
+	if (shapes < 0) {
+		vertices.resize(first);
+		return;
+	}
+	Map_feature f{};
+	f.kind   = kind;
+	f.width  = width;
+	f.shapes = shapes;
+	f.roof   = -1;
+	f.door   = -1;
+	f.first  = first;
+	f.count  = static_cast<uint32_t>(vertices.size() - first);
+	f.minx = f.miny = std::numeric_limits<int>::max();
+	f.maxx = f.maxy = std::numeric_limits<int>::min();
+	for (uint32_t i = first; i < vertices.size(); i++) {
+		f.minx = std::min(f.minx, vertices[i].x);
+		f.miny = std::min(f.miny, vertices[i].y);
+		f.maxx = std::max(f.maxx, vertices[i].x);
+		f.maxy = std::max(f.maxy, vertices[i].y);
+	}
+	f.minx -= width;    // Room for the width of a line.
+	f.miny -= width;
+	f.maxx += width;
+	f.maxy += width;
+	if (f.maxx < 0 || f.maxy < 0 || f.minx >= tiles_x || f.miny >= tiles_y) {
+		vertices.resize(first);    // Off the map.
+		return;
+	}
+	features.push_back(f);
+}
+
+void Map_generator::add_point(int list, Tile_point pt, bool ireg) {
+	if (list < 0 || !on_map(pt.x, pt.y)) {
+		return;
+	}
+	const int shapenum = choose(list, points.size(), pt.x, pt.y);
+	if (shapenum >= 0) {
+		points.push_back(Map_object{
+				pt.x, pt.y, static_cast<uint16>(shapenum), 0, ireg});
+	}
+}
+
+/*
+ *  Add a node, keeping where it is for the ways, and placing an object
+ *  if it's tagged as one.
+ */
+
+void Map_generator::add_node(
+		int64_t id, double lon, double lat, const Tags& tags) {
+	const Tile_point pt = to_tile(lon, lat);
+	if (!nodes.empty() && id < nodes.back().id) {
+		nodes_sorted = false;
+	}
+	nodes.push_back(Node_tile{id, pt.x, pt.y});
+	stats.nodes++;
+	if (!tags.empty()) {
+		add_point(mapping.objects_for(tags).main, pt, true);
+	}
+}
+
+/*
+ *  Add a way, as MapGenerator._process_way() does.
+ */
+
+void Map_generator::add_way(const vector<int64_t>& refs, const Tags& tags) {
+	if (refs.empty()) {
+		return;
+	}
+	const auto first = static_cast<uint32_t>(vertices.size());
+	for (const int64_t ref : refs) {
+		if (const Node_tile* node = find_node(ref)) {
+			vertices.push_back(Tile_point{node->x, node->y});
+		}
+	}
+	const auto count = vertices.size() - first;
+	if (count == 0) {
+		return;
+	}
+	stats.ways++;
+	const bool closed = refs.size() > 2 && refs.front() == refs.back();
+	if (Has_tag(tags, "highway")) {
+		const string_view highway = Get_tag(tags, "highway");
+		const bool        is_bridge
+				= Get_tag(tags, "bridge") == "yes"
+				  || Get_tag(tags, "man_made") == "bridge";
+		stats.roads++;
+		if (is_bridge) {
+			add_feature(
+					Map_feature::bridge, mapping.terrain_or("planking", "grass"),
+					highway_width(highway), first);
+		} else {
+			add_feature(
+					Map_feature::line, mapping.highway_terrain(highway),
+					highway_width(highway), first);
+		}
+	} else if (Has_tag(tags, "building")) {
+		if (count < 3) {
+			vertices.resize(first);
+			return;
+		}
+		const Shape_mapping::Object_shapes shapes = mapping.objects_for(tags);
+		const int                          floor = mapping.terrain("floor");
+		if (floor < 0) {
+			vertices.resize(first);
+			return;
+		}
+		const size_t index = features.size();
+		add_feature(Map_feature::building, floor, 0, first);
+		if (features.size() > index) {
+			Map_feature& f = features.back();
+			f.shapes = floor;
+			f.roof = shapes.roof >= 0 ? shapes.roof : mapping.object("roof_slate");
+			f.door = shapes.door >= 0 ? shapes.door : mapping.object("door");
+			// Walls go in 'width', which buildings don't use.
+			f.width = shapes.walls >= 0 ? shapes.walls : mapping.object("wall");
+			stats.buildings++;
+		}
+	} else if (Has_tag(tags, "landuse") || Has_tag(tags, "natural")) {
+		const Shape_mapping::Object_shapes shapes = mapping.objects_for(tags);
+		// Scatter its objects along the edge.
+		for (size_t i = first; i < vertices.size(); i += 3) {
+			add_point(shapes.main, vertices[i], false);
+		}
+		if (closed && count >= 3) {
+			add_feature(Map_feature::area, mapping.terrain_for(tags), 0, first);
+		} else {
+			add_feature(Map_feature::line, mapping.terrain_for(tags), 1, first);
+		}
+	} else if (Has_tag(tags, "waterway")) {
+		add_feature(Map_feature::line, mapping.terrain("water"), 3, first);
+	} else if (Has_tag(tags, "barrier")) {
+		add_feature(
+				Map_feature::barrier, mapping.objects_for(tags).main, 0, first);
+	} else {
+		vertices.resize(first);
+	}
+}
+
+/*
+ *  Paint the segments of a line, or a bridge, or put a barrier along it.
+ */
+
+void Map_generator::paint_line(
+		const Band& band, const Map_feature& f, size_t n) const {
+	// The span -width//2 .. width//2, as in the Python tool.
+	const int lo = -((f.width + 1) / 2);
+	const int hi = f.width / 2;
+	auto      set_tile = [&](int x, int y, uint64_t salt) {
+        if (x >= 0 && x < tiles_x && y >= band.y0 && y < band.y1) {
+            const int shapenum = choose(f.shapes, salt, x, y);
+            if (shapenum >= 0) {
+                band.terrain[static_cast<size_t>(y) * tiles_x + x]
+                        = static_cast<uint16>(shapenum);
+            }
+        }
+	};
+	auto add_object = [&](int list, int x, int y, uint64_t salt) {
+		if (x >= 0 && x < tiles_x && y >= band.y0 && y < band.y1) {
+			const int shapenum = choose(list, salt, x, y);
+			if (shapenum >= 0) {
+				band.objects->push_back(Map_object{
+						x, y, static_cast<uint16>(shapenum), 0, false});
+			}
+		}
+	};
+	const uint64_t salt = n << 8;
+	for (uint32_t v = f.first; v + 1 < f.first + f.count; v++) {
+		const Tile_point a    = vertices[v];
+		const Tile_point b    = vertices[v + 1];
+		const int        dx   = b.x - a.x;
+		const int        dy   = b.y - a.y;
+		const int        dist = std::max(std::abs(dx), std::abs(dy));
+		if (dist == 0) {
+			if (f.kind == Map_feature::line) {
+				set_tile(a.x, a.y, salt);
+			}
+			continue;
+		}
+		// Only step through the part of the segment near this band.
+		double i0 = 0;
+		double i1 = dist;
+		auto   clip = [&](int start, int delta, int vmin, int vmax) {
+            if (delta == 0) {
+                if (start < vmin || start > vmax) {
+                    i1 = -1;
+                }
+                return;
+            }
+            double t0 = static_cast<double>(vmin - start) * dist / delta;
+            double t1 = static_cast<double>(vmax - start) * dist / delta;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            // Each row or column lasts up to dist/|delta| steps.
+            const double slack = static_cast<double>(dist) / std::abs(delta) + 1;
+            i0 = std::max(i0, t0 - slack);
+            i1 = std::min(i1, t1 + slack);
+		};
+		clip(a.x, dx, -hi, tiles_x - 1 - lo);
+		clip(a.y, dy, band.y0 - hi, band.y1 - 1 - lo);
+		if (i0 > i1) {
+			continue;
+		}
+		const int first = static_cast<int>(std::ceil(i0));
+		const int last  = static_cast<int>(std::floor(i1));
+		for (int i = first; i <= last; i++) {
+			const double t = static_cast<double>(i) / dist;
+			const int    x = static_cast<int>(std::floor(a.x + t * dx));
+			const int    y = static_cast<int>(std::floor(a.y + t * dy));
+			if (f.kind == Map_feature::barrier) {
+				add_object(f.shapes, x, y, salt | 1);
+				continue;
+			}
+			for (int wx = lo; wx <= hi; wx++) {
+				for (int wy = lo; wy <= hi; wy++) {
+					set_tile(x + wx, y + wy, salt);
+				}
+			}
+			if (f.kind == Map_feature::bridge && (i == 0 || i == dist)) {
+				add_object(mapping.object("bridge"), x, y, salt | 2);
+			}
+		}
+	}
+}
+
+/*
+ *  Fill a closed way, row by row.  A tile is inside if the ray from it
+ *  to the right crosses the outline an odd number of times.
+ */
+
+void Map_generator::paint_area(
+		const Band& band, const Map_feature& f, size_t n) const {
+	const uint64_t salt = n << 8;
+	const int      y0   = std::max(band.y0, f.miny);
+	const int      y1   = std::min(band.y1 - 1, f.maxy);
+	const int      x0   = std::max(0, f.minx);
+	const int      x1   = std::min(tiles_x - 1, f.maxx);
+	vector<double> crossings;
+	for (int y = y0; y <= y1; y++) {
+		crossings.clear();
+		uint32_t j = f.first + f.count - 1;
+		for (uint32_t i = f.first; i < f.first + f.count; j = i++) {
+			const Tile_point& pi = vertices[i];
+			const Tile_point& pj = vertices[j];
+			if ((pi.y > y) != (pj.y > y)) {
+				crossings.push_back(
+						static_cast<double>(pj.x - pi.x) * (y - pi.y)
+								/ (pj.y - pi.y)
+						+ pi.x);
+			}
+		}
+		if (crossings.empty()) {
+			continue;
+		}
+		std::sort(crossings.begin(), crossings.end());
+		size_t passed = 0;    // Crossings at or left of x.
+		for (int x = x0; x <= x1; x++) {
+			while (passed < crossings.size() && crossings[passed] <= x) {
+				passed++;
+			}
+			if ((crossings.size() - passed) % 2 == 1) {
+				const int shapenum = choose(f.shapes, salt, x, y);
+				if (shapenum >= 0) {
+					band.terrain[static_cast<size_t>(y) * tiles_x + x]
+							= static_cast<uint16>(shapenum);
+				}
+			}
+		}
+	}
+}
+
+/*
+ *  A building fills the box around its outline: floor, walls around it
+ *  with a door in the middle of the bottom, and a roof on top.
+ */
+
+void Map_generator::paint_building(
+		const Band& band, const Map_feature& f, size_t n) const {
+	const uint64_t salt  = n << 8;
+	const int      minx  = f.minx;    // Buildings have no width.
+	const int      maxx  = f.maxx;
+	const int      miny  = f.miny;
+	const int      maxy  = f.maxy;
+	const int      walls = f.width;
+	auto           add_object
+			= [&](int list, int x, int y, int lift, bool ireg, uint64_t s) {
+				  if (list < 0 || !on_map(x, y) || y < band.y0
+					  || y >= band.y1) {
+					  return;
+				  }
+				  const int shapenum = choose(list, s, x, y);
+				  if (shapenum >= 0) {
+					  band.objects->push_back(Map_object{
+							  x, y, static_cast<uint16>(shapenum),
+							  static_cast<unsigned char>(lift), ireg});
+				  }
+			  };
+	for (int y = std::max(miny, band.y0); y <= std::min(maxy, band.y1 - 1);
+		 y++) {
+		for (int x = std::max(minx, 0); x <= std::min(maxx, tiles_x - 1);
+			 x++) {
+			const int shapenum = choose(f.shapes, salt, x, y);
+			if (shapenum >= 0) {
+				band.terrain[static_cast<size_t>(y) * tiles_x + x]
+						= static_cast<uint16>(shapenum);
+			}
+		}
+	}
+	for (int x = minx; x <= maxx; x++) {
+		add_object(walls, x, miny, 0, false, salt | 1);
+		add_object(walls, x, maxy, 0, false, salt | 1);
+	}
+	for (int y = miny + 1; y < maxy; y++) {
+		add_object(walls, minx, y, 0, false, salt | 1);
+		add_object(walls, maxx, y, 0, false, salt | 1);
+	}
+	// Doors open and shut, so they go with the movable objects.
+	const int sum = minx + maxx;
+	add_object(f.door, sum >= 0 ? sum / 2 : (sum - 1) / 2, maxy, 0, true,
+			   salt | 2);
+	for (int y = miny; y <= maxy; y++) {
+		for (int x = minx; x <= maxx; x++) {
+			add_object(f.roof, x, y, 4, false, salt | 3);
+		}
+	}
+}
+
+/*
+ *  Paint a band, going through all the features in order.
+ */
+
+void Map_generator::paint(const Band& band) const {
+	for (size_t n = 0; n < features.size(); n++) {
+		const Map_feature& f = features[n];
+		if (f.maxy < band.y0 || f.miny >= band.y1) {
+			continue;
+		}
+		switch (f.kind) {
+		case Map_feature::line:
+		case Map_feature::bridge:
+		case Map_feature::barrier:
+			paint_line(band, f, n);
+			break;
+		case Map_feature::area:
+			paint_area(band, f, n);
+			break;
+		case Map_feature::building:
+			paint_building(band, f, n);
+			break;
+		}
+	}
+}
+
+/*
+ *  Paint the whole map, splitting it into bands of chunk rows.
+ *
+ *  Output: terrain shapes for each tile (rows of tiles_x) and the objects.
+ */
+
+void Map_generator::generate(
+		int nthreads, vector<uint16>& terrain,
+		vector<Map_object>& objects) const {
+	terrain.assign(static_cast<size_t>(tiles_x) * tiles_y, no_terrain);
+	const int chunk_rows = tiles_y / c_tiles_per_chunk;
+	nthreads             = std::max(1, std::min(nthreads, chunk_rows));
+	vector<vector<Map_object>> band_objects(nthreads);
+	vector<std::thread>        threads;
+	for (int i = 0; i < nthreads; i++) {
+		Band band;
+		band.y0      = chunk_rows * i / nthreads * c_tiles_per_chunk;
+		band.y1      = chunk_rows * (i + 1) / nthreads * c_tiles_per_chunk;
+		band.terrain = terrain.data();
+		band.objects = &band_objects[i];
+		threads.emplace_back([this, band]() {
+			paint(band);
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	// Anything left is grass.
+	const int grass = mapping.terrain("grass");
+	for (int y = 0; y < tiles_y; y++) {
+		for (int x = 0; x < tiles_x; x++) {
+			uint16& tile = terrain[static_cast<size_t>(y) * tiles_x + x];
+			if (tile == no_terrain) {
+				tile = static_cast<uint16>(choose(grass, 0, x, y));
+			}
+		}
+	}
+	objects = points;
+	for (auto& band : band_objects) {
+		objects.insert(objects.end(), band.begin(), band.end());
+	}
+}
+
+/*
+ *  Read OSM XML a block at a time.
+ */
+
+class Osm_xml_reader {
+	std::istream& in;
+	string        buf;
+	size_t        pos = 0;
+
+	// Get the next markup, without its '<' and '>'.
+	bool next_markup(string& markup);
+
+	static string decode(string_view text);
+
+public:
+	explicit Osm_xml_reader(std::istream& i) : in(i) {}
+
+	// Read it all, getting the bounds if there are any.
+	bool read(Map_generator*& gen, double bbox[4], bool have_bbox,
+			  const std::function<Map_generator*(const double*)>& make);
+};
+
+bool Osm_xml_reader::next_markup(string& markup) {
+	for (;;) {
+		const size_t start = buf.find('<', pos);
+		if (start != string::npos) {
+			// Find the end, skipping quoted '>'s.
+			char   quote = 0;
+			size_t end   = start + 1;
+			bool   comment = buf.compare(start, 4, "<!--") == 0;
+			for (; end < buf.size(); end++) {
+				const char c = buf[end];
+				if (comment) {
+					if (c == '>' && end >= start + 6 && buf[end - 1] == '-'
+						&& buf[end - 2] == '-') {
+						break;
+					}
+				} else if (quote) {
+					if (c == quote) {
+						quote = 0;
+					}
+				} else if (c == '"' || c == '\'') {
+					quote = c;
+				} else if (c == '>') {
+					break;
+				}
+			}
+			if (end < buf.size()) {
+				markup.assign(buf, start + 1, end - start - 1);
+				pos = end + 1;
+				return true;
+			}
+			buf.erase(0, start);
+		} else {
+			buf.clear();
+		}
+		pos = 0;
+		// Get more.
+		char block[1 << 16];
+		in.read(block, sizeof(block));
+		if (in.gcount() <= 0) {
+			return false;
+		}
+		buf.append(block, in.gcount());
+	}
+}
+
+string Osm_xml_reader::decode(string_view text) {
+	string out;
+	out.reserve(text.size());
+	for (size_t i = 0; i < text.size(); i++) {
+		if (text[i] != '&') {
+			out += text[i];
+			continue;
+		}
+		const size_t semi = text.find(';', i);
+		if (semi == string_view::npos) {
+			out += text[i];
+			continue;
+		}
+		const string_view entity = text.substr(i + 1, semi - i - 1);
+		if (entity == "amp") {
+			out += '&';
+		} else if (entity == "lt") {
+			out += '<';
+		} else if (entity == "gt") {
+			out += '>';
+		} else if (entity == "quot") {
+			out += '"';
+		} else if (entity == "apos") {
+			out += '\'';
+		} else if (!entity.empty() && entity[0] == '#') {
+			const bool hex  = entity.size() > 1 && entity[1] == 'x';
+			const long code = std::strtol(
+					string(entity.substr(hex ? 2 : 1)).c_str(), nullptr,
+					hex ? 16 : 10);
+			// Tag values we look at are plain ASCII.
+			out += code > 0 && code < 128 ? static_cast<char>(code) : '?';
+		} else {
+			out += text.substr(i, semi - i + 1);
+		}
+		i = semi;
+	}
+	return out;
+}
+
+bool Osm_xml_reader::read(
+		Map_generator*& gen, double bbox[4], bool have_bbox,
+		const std::function<Map_generator*(const double*)>& make) {
+	enum {
+		none,
+		in_node,
+		in_way,
+		in_other
+	} state = none;
+
+	string             markup;
+	vector<std::pair<string_view, string_view>> attrs;
+	std::deque<string> tag_text;    // Holds decoded tags.
+	Tags               tags;
+	vector<int64_t>    refs;
+	int64_t            node_id  = 0;
+	double             node_lon = 0;
+	double             node_lat = 0;
+
+	// Split "name a='b' c='d'/" into its attributes.
+	auto parse = [&](string_view text, string_view& name, bool& closed) {
+		attrs.clear();
+		closed = !text.empty() && text.back() == '/';
+		if (closed) {
+			text.remove_suffix(1);
+		}
+		size_t i = 0;
+		while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) {
+			i++;
+		}
+		name = text.substr(0, i);
+		for (;;) {
+			while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) {
+				i++;
+			}
+			const size_t eq = text.find('=', i);
+			if (eq == string_view::npos || eq + 1 >= text.size()) {
+				return;
+			}
+			const char   quote = text[eq + 1];
+			const size_t end   = text.find(quote, eq + 2);
+			if (end == string_view::npos) {
+				return;
+			}
+			attrs.emplace_back(
+					text.substr(i, eq - i), text.substr(eq + 2, end - eq - 2));
+			i = end + 1;
+		}
+	};
+	auto attr = [&](string_view name) {
+		for (const auto& a : attrs) {
+			if (a.first == name) {
+				return a.second;
+			}
+		}
+		return string_view();
+	};
+	auto number = [](string_view text) {
+		return std::strtod(string(text).c_str(), nullptr);
+	};
+	auto id_of = [](string_view text) {
+		return std::strtoll(string(text).c_str(), nullptr, 10);
+	};
+	auto start_map = [&]() {
+		if (!gen) {
+			if (!have_bbox) {
+				cerr << "No bounds in the input; use -b." << endl;
+				return false;
+			}
+			gen = make(bbox);
+		}
+		return true;
+	};
+
+	while (next_markup(markup)) {
+		if (markup.empty() || markup[0] == '?' || markup[0] == '!') {
+			continue;
+		}
+		string_view name;
+		bool        closed;
+		if (markup[0] == '/') {
+			const string_view end_name = string_view(markup).substr(1);
+			if (state == in_node && end_name == "node") {
+				gen->add_node(node_id, node_lon, node_lat, tags);
+				state = none;
+			} else if (state == in_way && end_name == "way") {
+				gen->add_way(refs, tags);
+				state = none;
+			} else if (
+					state == in_other
+					&& (end_name == "relation" || end_name == "changeset")) {
+				state = none;
+			}
+			continue;
+		}
+		parse(markup, name, closed);
+		if (name == "bounds" && !have_bbox && !gen) {
+			bbox[0]   = number(attr("minlon"));
+			bbox[1]   = number(attr("minlat"));
+			bbox[2]   = number(attr("maxlon"));
+			bbox[3]   = number(attr("maxlat"));
+			have_bbox = true;
+		} else if (name == "node" && state == none) {
+			if (!start_map()) {
+				return false;
+			}
+			node_id  = id_of(attr("id"));
+			node_lon = number(attr("lon"));
+			node_lat = number(attr("lat"));
+			tags.clear();
+			tag_text.clear();
+			if (closed) {
+				gen->add_node(node_id, node_lon, node_lat, tags);
+			} else {
+				state = in_node;
+			}
+		} else if (name == "way" && state == none) {
+			if (!start_map()) {
+				return false;
+			}
+			tags.clear();
+			tag_text.clear();
+			refs.clear();
+			state = closed ? none : in_way;
+		} else if (name == "nd" && state == in_way) {
+			refs.push_back(id_of(attr("ref")));
+		} else if (name == "tag" && (state == in_node || state == in_way)) {
+			tag_text.push_back(decode(attr("k")));
+			const string_view key = tag_text.back();
+			tag_text.push_back(decode(attr("v")));
+			tags.emplace_back(key, tag_text.back());
+		} else if (
+				(name == "relation" || name == "changeset") && state == none
+				&& !closed) {
+			state = in_other;
+		}
+	}
+	return start_map();
+}
+
+/*
+ *  Read the protocol buffer messages of OSM PBF.
+ */
+
+class Pbf_message {
+	const unsigned char* ptr;
+	const unsigned char* end;
+
+public:
+	Pbf_message(const unsigned char* p, size_t len) : ptr(p), end(p + len) {}
+
+	explicit Pbf_message(string_view data)
+			: Pbf_message(
+					  reinterpret_cast<const unsigned char*>(data.data()),
+					  data.size()) {}
+
+	bool at_end() const {
+		return ptr >= end;
+	}
+
+	uint64_t varint() {
+		uint64_t val   = 0;
+		int      shift = 0;
+		while (ptr < end && shift < 64) {
+			const unsigned char b = *ptr++;
+			val |= static_cast<uint64_t>(b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				break;
+			}
+			shift += 7;
+		}
+		return val;
+	}
+
+	int64_t svarint() {
+		const uint64_t val = varint();
+		return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+	}
+
+	// Next field, or false at the end.
+	bool next(int& field, int& wire) {
+		if (at_end()) {
+			return false;
+		}
+		const uint64_t key = varint();
+		field              = static_cast<int>(key >> 3);
+		wire               = static_cast<int>(key & 7);
+		return true;
+	}
+
+	string_view bytes() {
+		const auto len = static_cast<size_t>(varint());
+		const auto avail = static_cast<size_t>(end - ptr);
+		const string_view data(
+				reinterpret_cast<const char*>(ptr), std::min(len, avail));
+		ptr += data.size();
+		return data;
+	}
+
+	void skip(int wire) {
+		switch (wire) {
+		case 0:
+			varint();
+			break;
+		case 1:
+			ptr += 8;
+			break;
+		case 2:
+			bytes();
+			break;
+		case 5:
+			ptr += 4;
+			break;
+		default:
+			ptr = end;    // Can't go on.
+			break;
+		}
+	}
+
+	// Packed repeated integers.
+	template <typename Fn>
+	static void packed(string_view data, Fn&& each) {
+		Pbf_message list(data);
+		while (!list.at_end()) {
+			each(list);
+		}
+	}
+};
+
+/*
+ *  Read OSM PBF a blob at a time.
+ */
+
+class Osm_pbf_reader {
+	std::istream& in;
+	string        blob;
+	string        data;    // Uncompressed blob.
+
+	bool read_blob(string& type);
+	void read_header(double bbox[4], bool& have_bbox);
+	void read_block(Map_generator& gen);
+
+public:
+	explicit Osm_pbf_reader(std::istream& i) : in(i) {}
+
+	bool read(Map_generator*& gen, double bbox[4], bool have_bbox,
+			  const std::function<Map_generator*(const double*)>& make);
+};
+
+bool Osm_pbf_reader::read_blob(string& type) {
+	unsigned char lenbuf[4];
+	if (!in.read(reinterpret_cast<char*>(lenbuf), 4)) {
+		return false;
+	}
+	const uint32_t hdrlen = (uint32_t(lenbuf[0]) << 24)
+							| (uint32_t(lenbuf[1]) << 16)
+							| (uint32_t(lenbuf[2]) << 8) | lenbuf[3];
+	string header(hdrlen, '\0');
+	if (!in.read(&header[0], hdrlen)) {
+		return false;
+	}
+	Pbf_message hdr(header);
+	size_t      datasize = 0;
+	int         field;
+	int         wire;
+	type.clear();
+	while (hdr.next(field, wire)) {
+		if (field == 1 && wire == 2) {
+			type = string(hdr.bytes());
+		} else if (field == 3 && wire == 0) {
+			datasize = static_cast<size_t>(hdr.varint());
+		} else {
+			hdr.skip(wire);
+		}
+	}
+	blob.resize(datasize);
+	if (datasize && !in.read(&blob[0], datasize)) {
+		return false;
+	}
+	Pbf_message msg(blob);
+	string_view zdata;
+	size_t      raw_size = 0;
+	data.clear();
+	while (msg.next(field, wire)) {
+		if (field == 1 && wire == 2) {
+			data = string(msg.bytes());
+		} else if (field == 2 && wire == 0) {
+			raw_size = static_cast<size_t>(msg.varint());
+		} else if (field == 3 && wire == 2) {
+			zdata = msg.bytes();
+		} else {
+			if (field >= 4 && field <= 7) {
+				cerr << "Unsupported compression in " << type << " blob."
+					 << endl;
+				return false;
+			}
+			msg.skip(wire);
+		}
+	}
+	if (!zdata.empty()) {
+		data.resize(raw_size);
+		uLongf len = raw_size;
+		if (uncompress(
+					reinterpret_cast<Bytef*>(&data[0]), &len,
+					reinterpret_cast<const Bytef*>(zdata.data()),
+					zdata.size())
+					!= Z_OK
+			|| len != raw_size) {
+			cerr << "Bad compressed data in " << type << " blob." << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+void Osm_pbf_reader::read_header(double bbox[4], bool& have_bbox) {
+	Pbf_message msg(data);
+	int         field;
+	int         wire;
+	while (msg.next(field, wire)) {
+		if (field == 1 && wire == 2) {    // HeaderBBox, in nanodegrees.
+			Pbf_message box(msg.bytes());
+			double      sides[4] = {};    // Left, right, top, bottom.
+			while (box.next(field, wire)) {
+				if (field >= 1 && field <= 4 && wire == 0) {
+					sides[field - 1] = box.svarint() * 1e-9;
+				} else {
+					box.skip(wire);
+				}
+			}
+			if (!have_bbox) {
+				bbox[0]   = sides[0];
+				bbox[1]   = sides[3];
+				bbox[2]   = sides[1];
+				bbox[3]   = sides[2];
+				have_bbox = true;
+			}
+		} else {
+			msg.skip(wire);
+		}
+	}
+}
+
+void Osm_pbf_reader::read_block(Map_generator& gen) {
+	vector<string_view> strings;
+	vector<string_view> groups;
+	int64_t             granularity = 100;
+	int64_t             lat_offset  = 0;
+	int64_t             lon_offset  = 0;
+	Pbf_message         block(data);
+	int                 field;
+	int                 wire;
+	// The scales come after the groups, so find them all first.
+	while (block.next(field, wire)) {
+		if (field == 1 && wire == 2) {
+			Pbf_message table(block.bytes());
+			while (table.next(field, wire)) {
+				if (field == 1 && wire == 2) {
+					strings.push_back(table.bytes());
+				} else {
+					table.skip(wire);
+				}
+			}
+		} else if (field == 2 && wire == 2) {
+			groups.push_back(block.bytes());
+		} else if (field == 17 && wire == 0) {
+			granularity = static_cast<int64_t>(block.varint());
+		} else if (field == 19 && wire == 0) {
+			lat_offset = static_cast<int64_t>(block.varint());
+		} else if (field == 20 && wire == 0) {
+			lon_offset = static_cast<int64_t>(block.varint());
+		} else {
+			block.skip(wire);
+		}
+	}
+	auto str = [&](uint64_t index) {
+		return index < strings.size() ? strings[index] : string_view();
+	};
+	auto lon = [&](int64_t val) {
+		return 1e-9 * static_cast<double>(lon_offset + granularity * val);
+	};
+	auto lat = [&](int64_t val) {
+		return 1e-9 * static_cast<double>(lat_offset + granularity * val);
+	};
+	Tags             tags;
+	vector<int64_t>  refs;
+	vector<uint64_t> keys;
+	vector<uint64_t> vals;
+	for (const string_view group_data : groups) {
+		Pbf_message group(group_data);
+		while (group.next(field, wire)) {
+			if (wire != 2) {
+				group.skip(wire);
+				continue;
+			}
+			const string_view item = group.bytes();
+			Pbf_message       msg(item);
+			if (field == 1) {    // Node.
+				int64_t id      = 0;
+				int64_t node_la = 0;
+				int64_t node_lo = 0;
+				keys.clear();
+				vals.clear();
+				while (msg.next(field, wire)) {
+					if (field == 1 && wire == 0) {
+						id = msg.svarint();
+					} else if ((field == 2 || field == 3) && wire == 2) {
+						auto& list = field == 2 ? keys : vals;
+						Pbf_message::packed(msg.bytes(), [&](Pbf_message& m) {
+							list.push_back(m.varint());
+						});
+					} else if (field == 8 && wire == 0) {
+						node_la = msg.svarint();
+					} else if (field == 9 && wire == 0) {
+						node_lo = msg.svarint();
+					} else {
+						msg.skip(wire);
+					}
+				}
+				tags.clear();
+				for (size_t i = 0; i < keys.size() && i < vals.size(); i++) {
+					tags.emplace_back(str(keys[i]), str(vals[i]));
+				}
+				gen.add_node(id, lon(node_lo), lat(node_la), tags);
+			} else if (field == 2) {    // DenseNodes.
+				vector<int64_t> ids;
+				vector<int64_t> lats;
+				vector<int64_t> lons;
+				vector<uint64_t> keys_vals;
+				while (msg.next(field, wire)) {
+					if (wire != 2) {
+						msg.skip(wire);
+						continue;
+					}
+					const string_view list = msg.bytes();
+					if (field == 1 || field == 8 || field == 9) {
+						auto& out = field == 1 ? ids : field == 8 ? lats : lons;
+						int64_t last = 0;    // Delta coded.
+						Pbf_message::packed(list, [&](Pbf_message& m) {
+							last += m.svarint();
+							out.push_back(last);
+						});
+					} else if (field == 10) {
+						Pbf_message::packed(list, [&](Pbf_message& m) {
+							keys_vals.push_back(m.varint());
+						});
+					}
+				}
+				size_t kv = 0;
+				for (size_t i = 0; i < ids.size() && i < lats.size()
+								   && i < lons.size();
+					 i++) {
+					tags.clear();
+					// Each node's tags end with a 0.
+					while (kv < keys_vals.size() && keys_vals[kv] != 0) {
+						if (kv + 1 < keys_vals.size()) {
+							tags.emplace_back(
+									str(keys_vals[kv]), str(keys_vals[kv + 1]));
+						}
+						kv += 2;
+					}
+					kv++;
+					gen.add_node(ids[i], lon(lons[i]), lat(lats[i]), tags);
+				}
+			} else if (field == 3) {    // Way.
+				keys.clear();
+				vals.clear();
+				refs.clear();
+				while (msg.next(field, wire)) {
+					if ((field == 2 || field == 3) && wire == 2) {
+						auto& list = field == 2 ? keys : vals;
+						Pbf_message::packed(msg.bytes(), [&](Pbf_message& m) {
+							list.push_back(m.varint());
+						});
+					} else if (field == 8 && wire == 2) {
+						int64_t last = 0;    // Delta coded.
+						Pbf_message::packed(msg.bytes(), [&](Pbf_message& m) {
+							last += m.svarint();
+							refs.push_back(last);
+						});
+					} else {
+						msg.skip(wire);
+					}
+				}
+				tags.clear();
+				for (size_t i = 0; i < keys.size() && i < vals.size(); i++) {
+					tags.emplace_back(str(keys[i]), str(vals[i]));
+				}
+				gen.add_way(refs, tags);
+			}
+			// Relations and changesets aren't used.
+		}
+	}
+}
+
+bool Osm_pbf_reader::read(
+		Map_generator*& gen, double bbox[4], bool have_bbox,
+		const std::function<Map_generator*(const double*)>& make) {
+	string type;
+	while (read_blob(type)) {
+		if (type == "OSMHeader") {
+			read_header(bbox, have_bbox);
+		} else if (type == "OSMData") {
+			if (!gen) {
+				if (!have_bbox) {
+					cerr << "No bounds in the input; use -b." << endl;
+					return false;
+				}
+				gen = make(bbox);
+			}
+			read_block(*gen);
+		}
+	}
+	if (!in.eof()) {
+		cerr << "Error reading the input." << endl;
+		return false;
+	}
+	if (!gen && have_bbox) {
+		gen = make(bbox);
+	}
+	return gen != nullptr;
+}
+
+/*
+ *  Write the map: the terrain of each chunk, with identical ones shared,
+ *  the map of which chunk has which, and the objects of each superchunk.
+ */
+
+static void Write_map(
+		const string& outdir, int tiles_x, int tiles_y,
+		const vector<uint16>& terrain, const vector<Map_object>& objects,
+		int outside, int tolerance) {
+	const string patch   = outdir + "/patch";
+	const string gamedat = outdir + "/gamedat";
+	U7mkdir(outdir.c_str(), 0755);
+	U7mkdir(patch.c_str(), 0755);
+	U7mkdir(gamedat.c_str(), 0755);
+
+	constexpr int chunk_bytes = c_tiles_per_chunk * c_tiles_per_chunk * 2;
+	// Chunks of the same terrain share it.
+	Terrain_dedup  dedup(tolerance);
+	vector<uint16> terrain_map(c_num_chunks * c_num_chunks);
+	{
+		OBufferedFileDataSource chunks(File_spec(patch + "/u7chunks"));
+		Terrain_dedup::Tiles    tiles;
+		int                     written = 0;
+		for (int cy = 0; cy < c_num_chunks; cy++) {
+			for (int cx = 0; cx < c_num_chunks; cx++) {
+				const bool inside = (cx + 1) * c_tiles_per_chunk <= tiles_x
+									&& (cy + 1) * c_tiles_per_chunk <= tiles_y;
+				for (int ty = 0; ty < c_tiles_per_chunk; ty++) {
+					for (int tx = 0; tx < c_tiles_per_chunk; tx++) {
+						const int shapenum
+								= inside ? terrain[static_cast<size_t>(
+														   cy * c_tiles_per_chunk
+														   + ty)
+														   * tiles_x
+												   + cx * c_tiles_per_chunk + tx]
+										 : outside;
+						tiles[ty * c_tiles_per_chunk + tx]
+								= Terrain_dedup::tile(shapenum, 0);
+					}
+				}
+				const int tnum = dedup.add(tiles);
+				if (tnum >= c_max_terrains) {
+					throw exult_exception(
+							"Too many different chunk terrains; try a "
+							"tolerance (-t)");
+				}
+				if (tnum == written) {    // New, so write it.
+					written++;
+					for (const uint32 tile : tiles) {
+						const int shapenum = tile >> 8;
+						chunks.write1(shapenum & 0xff);
+						chunks.write1((shapenum >> 8) & 3);    // Frame 0.
+					}
+				}
+				terrain_map[cy * c_num_chunks + cx] = static_cast<uint16>(tnum);
+			}
+		}
+	}
+	dedup.report(cout, chunk_bytes);
+	{
+		// As Game_map::write_static().
+		OFileDataSource u7map(File_spec(patch + "/u7map"));
+		for (int schunk = 0; schunk < c_num_schunks * c_num_schunks;
+			 schunk++) {
+			const int scy = 16 * (schunk / 12);
+			const int scx = 16 * (schunk % 12);
+			for (int cy = 0; cy < 16; cy++) {
+				for (int cx = 0; cx < 16; cx++) {
+					u7map.write2(terrain_map[(scy + cy) * c_num_chunks + scx + cx]);
+				}
+			}
+		}
+	}
+	// Objects by chunk.
+	vector<vector<const Map_object*>> by_chunk(c_num_chunks * c_num_chunks);
+	for (const auto& obj : objects) {
+		by_chunk[(obj.ty / c_tiles_per_chunk) * c_num_chunks
+				 + obj.tx / c_tiles_per_chunk]
+				.push_back(&obj);
+	}
+	constexpr static const char hexLUT[] = "0123456789abcdef";
+	for (int schunk = 0; schunk < c_num_schunks * c_num_schunks; schunk++) {
+		const int scy    = 16 * (schunk / 12);
+		const int scx    = 16 * (schunk % 12);
+		string    suffix = {hexLUT[schunk / 16], hexLUT[schunk % 16]};
+		// As Game_map::write_ifix_objects(), always V2.
+		Flex_writer   ifix(
+                File_spec(patch + "/u7ifix" + suffix), "Exult",
+                c_chunks_per_schunk * c_chunks_per_schunk,
+                Flex_header::exult_v2);
+		vector<unsigned char> ireg;
+		vector<unsigned char> entries;
+		for (int cy = 0; cy < 16; cy++) {
+			for (int cx = 0; cx < 16; cx++) {
+				entries.clear();
+				for (const Map_object* obj :
+					 by_chunk[(scy + cy) * c_num_chunks + scx + cx]) {
+					const int tx = obj->tx % c_tiles_per_chunk;
+					const int ty = obj->ty % c_tiles_per_chunk;
+					if (obj->ireg) {
+						// As Ireg_game_object::write_ireg().
+						const unsigned char entry[10]
+								= {10,
+								   static_cast<unsigned char>((cx << 4) | tx),
+								   static_cast<unsigned char>((cy << 4) | ty),
+								   static_cast<unsigned char>(obj->shapenum & 0xff),
+								   static_cast<unsigned char>((obj->shapenum >> 8) & 3),
+								   static_cast<unsigned char>(
+										   ((obj->lift & 15) << 4)
+										   | (obj->lift >> 4)),
+								   0,
+								   0,
+								   0,
+								   0};
+						ireg.insert(ireg.end(), entry, entry + 10);
+					} else {
+						// As Ifix_game_object::write_ifix().
+						const unsigned char entry[5]
+								= {static_cast<unsigned char>((tx << 4) | ty),
+								   obj->lift,
+								   static_cast<unsigned char>(obj->shapenum & 0xff),
+								   static_cast<unsigned char>(obj->shapenum >> 8),
+								   0};
+						entries.insert(entries.end(), entry, entry + 5);
+					}
+				}
+				ifix.write_object(entries.data(), entries.size());
+			}
+		}
+		if (!ireg.empty()) {
+			OFileDataSource out(File_spec(gamedat + "/u7ireg" + suffix));
+			out.write(ireg.data(), ireg.size());
+		}
+	}
+}
+
+static void Usage() {
+	cerr << "Usage: osm2ultima [-b min_lon,min_lat,max_lon,max_lat] "
+			"[-s width,height]\n"
+			"                  [-m mapping] [-j threads] [-r seed] "
+			"[-t tiles]\n"
+			"                  -o outdir input\n"
+			"Converts OpenStreetMap XML (.osm) or PBF (.pbf) to U7 map "
+			"files:\n"
+			"    outdir/patch:   u7map, u7chunks and u7ifixNN\n"
+			"    outdir/gamedat: u7iregNN\n"
+			"-b  Area to convert, if not the input's bounds\n"
+			"-s  Map size in chunks, up to 192,192 (default 16,16)\n"
+			"-m  Shape mapping from 'osm_shape_mapping.py --export'\n"
+			"    (default osm_shape_mapping.txt)\n"
+			"-j  Threads for painting (default: all cores)\n"
+			"-r  Random seed (default 0)\n"
+			"-t  Chunk terrains differing in up to this many tiles are\n"
+			"    shared (default 0: only identical ones)"
+		 << endl;
+	exit(1);
+}
+
+int main(int argc, char** argv) {
+	double      bbox[4]   = {};
+	bool        have_bbox = false;
+	int         chunks_x  = 16;
+	int         chunks_y  = 16;
+	const char* mapfile   = "osm_shape_mapping.txt";
+	const char* outdir    = nullptr;
+	const char* infile    = nullptr;
+	int         nthreads  = static_cast<int>(std::thread::hardware_concurrency());
+	uint64_t    seed      = 0;
+	int         tolerance = 0;
+	for (int i = 1; i < argc; i++) {
+		const string arg = argv[i];
+		if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc) {
+			const char* val = argv[++i];
+			switch (arg[1]) {
+			case 'b':
+				have_bbox = std::sscanf(
+									val, "%lf,%lf,%lf,%lf", &bbox[0], &bbox[1],
+									&bbox[2], &bbox[3])
+							== 4;
+				if (!have_bbox) {
+					Usage();
+				}
+				break;
+			case 's':
+				if (std::sscanf(val, "%d,%d", &chunks_x, &chunks_y) != 2) {
+					Usage();
+				}
+				break;
+			case 'm':
+				mapfile = val;
+				break;
+			case 'o':
+				outdir = val;
+				break;
+			case 'j':
+				nthreads = std::atoi(val);
+				break;
+			case 'r':
+				seed = std::strtoull(val, nullptr, 10);
+				break;
+			case 't':
+				tolerance = std::atoi(val);
+				break;
+			default:
+				Usage();
+			}
+		} else if (!infile && arg[0] != '-') {
+			infile = argv[i];
+		} else {
+			Usage();
+		}
+	}
+	if (!infile || !outdir || chunks_x < 1 || chunks_y < 1
+		|| chunks_x > c_num_chunks || chunks_y > c_num_chunks) {
+		Usage();
+	}
+	Shape_mapping mapping;
+	if (!mapping.read(mapfile)) {
+		cerr << "Couldn't read the shape mapping '" << mapfile << "'." << endl;
+		return 1;
+	}
+	std::ifstream in(infile, std::ios::binary);
+	if (!in.good()) {
+		cerr << "Couldn't open '" << infile << "'." << endl;
+		return 1;
+	}
+	std::unique_ptr<Map_generator> owner;
+	Map_generator*                 gen  = nullptr;
+	auto                           make = [&](const double* box) {
+        owner = std::make_unique<Map_generator>(
+                mapping, box, chunks_x, chunks_y, seed);
+        return owner.get();
+	};
+	// PBF starts with the length of its first header.
+	const bool pbf = in.peek() == 0;
+	const bool ok  = pbf ? Osm_pbf_reader(in).read(gen, bbox, have_bbox, make)
+						 : Osm_xml_reader(in).read(gen, bbox, have_bbox, make);
+	if (!ok) {
+		return 1;
+	}
+	vector<uint16>     terrain;
+	vector<Map_object> objects;
+	gen->generate(nthreads, terrain, objects);
+	try {
+		const int water = mapping.terrain("water");
+		Write_map(
+				outdir, gen->get_tiles_x(), gen->get_tiles_y(), terrain, objects,
+				water >= 0 ? mapping.get_list(water)[0] : 0, tolerance);
+	} catch (const exult_exception& e) {
+		cerr << e.what() << endl;
+		return 1;
+	}
+	cout << "Read " << gen->stats.nodes << " nodes and " << gen->stats.ways
+		 << " ways: " << gen->stats.roads << " roads, "
+		 << gen->stats.buildings << " buildings." << endl;
+	cout << "Wrote " << objects.size() << " objects to " << outdir << endl;
+	return 0;
+}
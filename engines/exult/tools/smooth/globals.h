@@ -62,6 +62,7 @@ typedef struct g_stat_struct {
 	const char*                   filein;              // stat
 	const char*                   fileout;             // stat
 	const char*                   config_file;         // stat
+	int                           threads;             // stat
 } glob_statics;
 
 EXTERN glob_statics g_statics;
@@ -75,6 +76,7 @@ typedef struct pacman {
 	struct pacman* next;
 	pfnPluginApply plugin_apply;    // for storing plugins' apply
 	libhandle_t    handle;          // for storing dlopens' handle
+	int            threadsafe;      // plugin_apply may run on many threads
 } node;
 
 // this is what holds the address of the plugin_apply functions to apply to
@@ -198,8 +198,8 @@ void putpixel(SDL_Surface* surface, int x, int y, Uint8 pixel) {
 	*p       = pixel;
 }
 
-colour_hex transform(int index) {
-	SDL_Color* colors = g_variables.image_out_palette->colors;
+colour_hex transform(int index, glob_variables* vars) {
+	SDL_Color* colors = vars->image_out_palette->colors;
 	colour_hex ret
 			= ((((colour_hex)(colors[index].r)) << 16)
 			   | (((colour_hex)(colors[index].g)) << 8)
@@ -211,7 +211,7 @@ colour_hex transform(int index) {
 		colour_hex tmp;
 		do {
 			pfnPluginApply tmp_func = cursor->plugin_apply;
-			tmp                     = (*tmp_func)(ret, &g_variables);
+			tmp                     = (*tmp_func)(ret, vars);
 			cursor                  = cursor->next;
 		} while (cursor != NULL);
 		return tmp;
@@ -249,26 +249,123 @@ Uint8 palette_rw(colour_hex col) {
 	}
 }
 
+// rows of the map a thread takes at a time
+#define BAND_ROWS 8
+
+typedef struct process_struct {
+	colour_hex*   result;      // the transformed colour of each pixel
+	Uint8*        pending;     // pixels left for the serial pass
+	int           parallel[MAX_COLOURS];    // index can be done on any thread
+	SDL_AtomicInt next_band;
+} process_job;
+
+int SDLCALL process_bands(void* data) {
+	// transforms the pixels that can be, a band of rows at a time. plugins
+	// only read image_in, which doesn't change, so a band needs no more than
+	// itself
+	process_job*   job  = (process_job*)data;
+	glob_variables vars = g_variables;
+	int            band;
+
+	while ((band = SDL_AddAtomicInt(&job->next_band, 1)) * BAND_ROWS < 192) {
+		int y;
+		for (y = band * BAND_ROWS; y < (band + 1) * BAND_ROWS && y < 192;
+			 y++) {
+			int x;
+			for (x = 0; x < 192; x++) {
+				Uint8 idx = getpixel(
+						g_statics.image_in, g_statics.image_in_format, x, y);
+				if (!job->parallel[idx]) {
+					job->pending[y * 192 + x] = 1;
+					continue;
+				}
+				vars.global_x             = x;
+				vars.global_y             = y;
+				job->result[y * 192 + x]  = transform(idx, &vars);
+				job->pending[y * 192 + x] = 0;
+			}
+		}
+	}
+	return 0;
+}
+
 int process_image(void) {
 	// returns < 0 if pb
 	// that's where the meat of the program is
 	// algo:
 	// for each pixel of image_in at coord (x,y):
 	//    write the converted pixel at coord (x,y) in image_out
+	// the plugins are applied on several threads first, where they can be.
+	// Then, in the same order as if on one thread, the rest are applied and
+	// the colours put into image_out, whose palette grows as we go
+
+	process_job job;
+	int         nthreads = g_statics.threads;
+	int         i;
 
+	job.result  = (colour_hex*)malloc(192 * 192 * sizeof(colour_hex));
+	job.pending = (Uint8*)malloc(192 * 192);
+	if (job.result == NULL || job.pending == NULL) {
+		fprintf(stderr, "ERROR: Couldn't allocate memory");
+		free(job.result);
+		free(job.pending);
+		return -1;
+	}
+	for (i = 0; i < MAX_COLOURS; i++) {
+		// colours past the input's may be added before we get to them
+		node* cursor    = action_table[i];
+		job.parallel[i] = i < g_statics.image_in_ncolors;
+		for (; cursor != NULL && job.parallel[i]; cursor = cursor->next) {
+			job.parallel[i] = cursor->threadsafe;
+		}
+	}
+	SDL_SetAtomicInt(&job.next_band, 0);
+
+	if (nthreads <= 0) {
+		nthreads = SDL_GetNumLogicalCPUCores();
+	}
+	if (g_statics.debug) {
+		printf("Smoothing with %d threads\n", nthreads);
+		fflush(stdout);
+	}
+	// this thread is one of them
+	SDL_Thread** threads = NULL;
+	if (nthreads > 1) {
+		threads = (SDL_Thread**)calloc(nthreads - 1, sizeof(SDL_Thread*));
+	}
+	for (i = 0; threads != NULL && i < nthreads - 1; i++) {
+		// any not started leave more work for the others
+		threads[i] = SDL_CreateThread(process_bands, "smooth", &job);
+	}
+	process_bands(&job);
+	for (i = 0; threads != NULL && i < nthreads - 1; i++) {
+		if (threads[i] != NULL) {
+			SDL_WaitThread(threads[i], NULL);
+		}
+	}
+	free(threads);
+
+	SDL_LockSurface(g_variables.image_out);
 	for (g_variables.global_y = 0; g_variables.global_y < 192;
 		 g_variables.global_y++) {
 		for (g_variables.global_x = 0; g_variables.global_x < 192;
 			 g_variables.global_x++) {
-			Uint8 idx = getpixel(
-					g_statics.image_in, g_statics.image_in_format,
-					g_variables.global_x, g_variables.global_y);
-			SDL_LockSurface(g_variables.image_out);
+			int        pos = g_variables.global_y * 192 + g_variables.global_x;
+			colour_hex col = job.result[pos];
+			if (job.pending[pos]) {
+				Uint8 idx = getpixel(
+						g_statics.image_in, g_statics.image_in_format,
+						g_variables.global_x, g_variables.global_y);
+				col = transform(idx, &g_variables);
+			}
 			putpixel(
 					g_variables.image_out, g_variables.global_x,
-					g_variables.global_y, palette_rw(transform(idx)));
-			SDL_UnlockSurface(g_variables.image_out);
+					g_variables.global_y, palette_rw(col));
 		}
 	}
+	SDL_UnlockSurface(g_variables.image_out);
+
+	free(job.result);
+	free(job.pending);
 	return 1;
 }
@@ -1,7 +1,9 @@
 int   img_read(const char* filein);
 int   img_write(const char* img_out);
-Uint8 getpixel(SDL_Surface* surface, int x, int y);
-void  putpixel(SDL_Surface* surface, int x, int y, Uint8 pixel);
-char* transform(int index);
-Uint8 palette_rw(char* col);
-int   process_image(void);
+Uint8 getpixel(
+		SDL_Surface* surface, const SDL_PixelFormatDetails* surface_format,
+		int x, int y);
+void       putpixel(SDL_Surface* surface, int x, int y, Uint8 pixel);
+colour_hex transform(int index, glob_variables* vars);
+Uint8      palette_rw(colour_hex col);
+int        process_image(void);
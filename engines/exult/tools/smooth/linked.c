@@ -28,6 +28,7 @@ node* create_node(void) {
 	new_node->plugin_apply = NULL;
 	new_node->next         = NULL;
 	new_node->handle       = NULL;
+	new_node->threadsafe   = 0;
 
 	if (g_statics.debug > 2) {
 		printf("node created\n");
@@ -17,7 +17,7 @@
 
 void show_help(char* prog_name) {
 	printf("Usage: %s [-h] [-c configfile] [-i inputimage] [-o "
-		   "outputimage.bmp] [-d debuglevel]\n\n",
+		   "outputimage.bmp] [-d debuglevel] [-t threads]\n\n",
 		   prog_name);
 	printf("-h\t\t\tShows this help\n");
 	printf("-c configfile\t\tSpecify config file for conversion\n");
@@ -31,6 +31,8 @@ void show_help(char* prog_name) {
 	printf("-d debuglevel\t\tInteger value for debug level; the higher, the "
 		   "more debug information\n");
 	printf("\t\t\t\t(default: 0, max effect: 4)\n");
+	printf("-t threads\t\tNumber of threads to smooth with\n");
+	printf("\t\t\t\t(default: 0, one per CPU core)\n");
 	fflush(stdout);
 }
 
@@ -65,6 +67,15 @@ int read_param(int argc, char** argv) {
 				}
 				break;
 			}
+			case 't': {
+				if (i + 1 < argc && !is_switch(argv[i + 1])) {
+					g_statics.threads = atoi(argv[i + 1]);
+				} else {
+					printf("missing value for switch 't'\n");
+					return -1;
+				}
+				break;
+			}
 			case 'c': {
 				if (i + 1 < argc && !is_switch(argv[i + 1])) {
 					// printf("config file: %s\n",argv[i+1]);
@@ -114,6 +114,14 @@ int add_plugin_apply(int col_index, libhandle_t a_hdl) {
 	}
 	new_node->plugin_apply = apply;
 
+	// plugins that can be applied from several threads say so
+	int (*threadsafe)(void);
+	*(void**)&threadsafe = plug_load_func(a_hdl, "plugin_threadsafe");
+	if (threadsafe != NULL) {
+		new_node->threadsafe = (*threadsafe)();
+	}
+	(void)plug_error();    // not having it is no error
+
 	// add new_node at end of list found on action_table[idx]
 	// dealing with the special case
 	if (action_table[col_index] == NULL) {
@@ -12,6 +12,41 @@
 colour_hex col[256]
 			  [MAX_RANDOM + 2];    // # randoms, source color, random colors
 int          glob_idx = 0;
+
+// the rule for each source colour, found by hashing the colour. Holds
+// rule index + 1, 0 for an empty slot
+#define RULE_SLOTS 512
+int rule_slots[RULE_SLOTS];
+
+unsigned int rule_slot(colour_hex colour) {
+	return ((Uint32)(colour * 2654435761u)) >> 23;
+}
+
+int find_rule(colour_hex colour) {
+	// returns -1 if there is no rule for colour
+	unsigned int slot = rule_slot(colour);
+	while (rule_slots[slot] != 0) {
+		int rule = rule_slots[slot] - 1;
+		if (col[rule][1] == colour) {
+			return rule;
+		}
+		slot = (slot + 1) % RULE_SLOTS;
+	}
+	return -1;
+}
+
+void add_rule(int rule) {
+	// the first rule for a colour is the one used
+	if (find_rule(col[rule][1]) >= 0) {
+		return;
+	}
+	unsigned int slot = rule_slot(col[rule][1]);
+	while (rule_slots[slot] != 0) {
+		slot = (slot + 1) % RULE_SLOTS;
+	}
+	rule_slots[slot] = rule + 1;
+}
+
 glob_statics my_g_stat;
 
 void init_plugin(glob_statics* g_stat) {
@@ -88,6 +123,7 @@ int plugin_parse(char* line) {
 		}
 	}
 
+	add_rule(glob_idx);
 	glob_idx++;
 
 	return 0;
@@ -112,16 +148,9 @@ colour_hex plugin_apply(colour_hex colour) {
 	// plugin_apply are obviously plugin-specific colour is the colour at point
 	// (i,j) -- (i,j) are external variables from smooth
 
-	int loc_idx = 0;
-
 	// find the colour in big table
-	while (loc_idx < glob_idx && col[loc_idx][1] != colour) {
-		// printf("I look for %06x and I got %06x at %d instead!\n",
-		//        colour, col[loc_idx][1], loc_idx+1);
-		loc_idx++;
-	}
-
-	if (loc_idx >= glob_idx) {
+	int loc_idx = find_rule(colour);
+	if (loc_idx < 0) {
 		printf("I look for %06x, not found\n", colour);
 		return colour;
 	}
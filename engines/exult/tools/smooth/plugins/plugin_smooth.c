@@ -9,12 +9,47 @@
 #define PLUGIN_NAME "Smooth"
 
 glob_statics   my_g_stat;
-glob_variables my_g_var;
 
 // global variables
 colour_hex col[256][16];    // Star, Source, Trigger, 13 targets
 int        glob_idx = 0;
 
+/*****************************************************************************/
+
+// the rule for each source colour, found by hashing the colour. Holds
+// rule index + 1, 0 for an empty slot
+#define RULE_SLOTS 512
+int rule_slots[RULE_SLOTS];
+
+unsigned int rule_slot(colour_hex colour) {
+	return ((Uint32)(colour * 2654435761u)) >> 23;
+}
+
+int find_rule(colour_hex colour) {
+	// returns -1 if there is no rule for colour
+	unsigned int slot = rule_slot(colour);
+	while (rule_slots[slot] != 0) {
+		int rule = rule_slots[slot] - 1;
+		if (col[rule][1] == colour) {
+			return rule;
+		}
+		slot = (slot + 1) % RULE_SLOTS;
+	}
+	return -1;
+}
+
+void add_rule(int rule) {
+	// the first rule for a colour is the one used
+	if (find_rule(col[rule][1]) >= 0) {
+		return;
+	}
+	unsigned int slot = rule_slot(col[rule][1]);
+	while (rule_slots[slot] != 0) {
+		slot = (slot + 1) % RULE_SLOTS;
+	}
+	rule_slots[slot] = rule + 1;
+}
+
 /*****************************************************************************/
 // NO CHANGES TO MAKE HERE
 
@@ -62,6 +97,12 @@ void deinit_plugin(void) {
 	}
 }
 
+int plugin_threadsafe(void) {
+	// optional
+	// tells smooth that plugin_apply may be called for several pixels at once
+	return 1;
+}
+
 int plugin_parse(char* line) {
 	// required
 	// will prepare the plugin to know what to send back when receiving a
@@ -111,6 +152,7 @@ int plugin_parse(char* line) {
 		}
 	}
 
+	add_rule(glob_idx);
 	glob_idx++;
 
 	return 0;
@@ -129,64 +171,56 @@ int calculate(Uint8 col_num, int bpp, unsigned int my_x, unsigned int my_y) {
 	}
 }
 
-int has_around(colour_hex col_name) {
+int has_around(colour_hex col_name, int x, int y) {
 	// this checks if there is a chunk around (i,j) of colour col_name
 	// we check the 8 directions
 	// used to find a trigger colour around the chunk we are transforming
 
 	long int a0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x - 1) % 192,
-			(192 + my_g_var.global_y - 1) % 192);
+			(192 + x - 1) % 192, (192 + y - 1) % 192);
 	long int a = my_g_stat.image_in_palette->colors[a0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[a0].g * 256
 				 + my_g_stat.image_in_palette->colors[a0].b;
 	long int b0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x) % 192,
-			(192 + my_g_var.global_y - 1) % 192);
+			(192 + x) % 192, (192 + y - 1) % 192);
 	long int b = my_g_stat.image_in_palette->colors[b0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[b0].g * 256
 				 + my_g_stat.image_in_palette->colors[b0].b;
 	long int c0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x + 1) % 192,
-			(192 + my_g_var.global_y - 1) % 192);
+			(192 + x + 1) % 192, (192 + y - 1) % 192);
 	long int c = my_g_stat.image_in_palette->colors[c0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[c0].g * 256
 				 + my_g_stat.image_in_palette->colors[c0].b;
 	long int d0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x - 1) % 192,
-			(192 + my_g_var.global_y) % 192);
+			(192 + x - 1) % 192, (192 + y) % 192);
 	long int d = my_g_stat.image_in_palette->colors[d0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[d0].g * 256
 				 + my_g_stat.image_in_palette->colors[d0].b;
 	long int e0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x + 1) % 192,
-			(192 + my_g_var.global_y) % 192);
+			(192 + x + 1) % 192, (192 + y) % 192);
 	long int e = my_g_stat.image_in_palette->colors[e0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[e0].g * 256
 				 + my_g_stat.image_in_palette->colors[e0].b;
 	long int f0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x - 1) % 192,
-			(192 + my_g_var.global_y + 1) % 192);
+			(192 + x - 1) % 192, (192 + y + 1) % 192);
 	long int f = my_g_stat.image_in_palette->colors[f0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[f0].g * 256
 				 + my_g_stat.image_in_palette->colors[f0].b;
 	long int g0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x) % 192,
-			(192 + my_g_var.global_y + 1) % 192);
+			(192 + x) % 192, (192 + y + 1) % 192);
 	long int g = my_g_stat.image_in_palette->colors[g0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[g0].g * 256
 				 + my_g_stat.image_in_palette->colors[g0].b;
 	long int h0 = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			(192 + my_g_var.global_x + 1) % 192,
-			(192 + my_g_var.global_y + 1) % 192);
+			(192 + x + 1) % 192, (192 + y + 1) % 192);
 	long int h = my_g_stat.image_in_palette->colors[h0].r * 256 * 256
 				 + my_g_stat.image_in_palette->colors[h0].g * 256
 				 + my_g_stat.image_in_palette->colors[h0].b;
@@ -208,43 +242,41 @@ colour_hex plugin_apply(colour_hex colour, glob_variables* g_var) {
 	// plugin_apply are obviously plugin-specific colour is the colour at point
 	// (i,j) -- (i,j) are external variables from smooth
 
-	my_g_var.global_x  = g_var->global_x;
-	my_g_var.global_y  = g_var->global_y;
-	my_g_var.image_out = g_var->image_out;
+	// only locals and what was set up by plugin_parse, so that this can be
+	// called from several threads at once
+	const int x = g_var->global_x;
+	const int y = g_var->global_y;
 
 	Uint8 col_num = my_getpixel(
 			my_g_stat.image_in, my_g_stat.image_in_format->bytes_per_pixel,
-			my_g_var.global_x, my_g_var.global_y);
+			x, y);
 
 	// find the colour in big table
-	int loc_idx = 0;
-	while (loc_idx < glob_idx && col[loc_idx][1] != colour) {
-		loc_idx++;
-	}
-
-	if (loc_idx >= glob_idx) {
+	int loc_idx = find_rule(colour);
+	if (loc_idx < 0) {
 		fprintf(stderr,
-				"WARNING: loc_idx >= glob_idx. This should never happen\n");
+				"WARNING: no rule for %06x. This should never happen\n",
+				colour);
 		return colour;    // colour is not in table, so we don't treat it. This
 						  // should never happen.
 	}
 
-	if (col[loc_idx][0] == 1 || has_around(col[loc_idx][2])) {
+	if (col[loc_idx][0] == 1 || has_around(col[loc_idx][2], x, y)) {
 		//    printf("trig is around!\n");
 		// this is the main part. Trigger is * or trigger is around the chunk to
 		// change.
 		unsigned short int a = calculate(
 				col_num, my_g_stat.image_in_format->bytes_per_pixel,
-				my_g_var.global_x - 1, my_g_var.global_y);
+				x - 1, y);
 		unsigned short int b = calculate(
 				col_num, my_g_stat.image_in_format->bytes_per_pixel,
-				my_g_var.global_x, my_g_var.global_y + 1);
+				x, y + 1);
 		unsigned short int c = calculate(
 				col_num, my_g_stat.image_in_format->bytes_per_pixel,
-				my_g_var.global_x + 1, my_g_var.global_y);
+				x + 1, y);
 		unsigned short int d = calculate(
 				col_num, my_g_stat.image_in_format->bytes_per_pixel,
-				my_g_var.global_x, my_g_var.global_y - 1);
+				x, y - 1);
 
 		if (!((a || c) && (b || d))) {
 			// this combinaison is not authorised for modifying.
@@ -263,7 +295,7 @@ colour_hex plugin_apply(colour_hex colour, glob_variables* g_var) {
 
 		if (my_g_stat.debug > 3) {
 			printf("calc_value is %u at (%d,%d) -- a=%d b=%d c=%d d=%d\n",
-				   calc_value, my_g_var.global_x, my_g_var.global_y, a, b, c,
+				   calc_value, x, y, a, b, c,
 				   d);
 		}
 
@@ -283,20 +315,20 @@ colour_hex plugin_apply(colour_hex colour, glob_variables* g_var) {
 			Uint8              idx_trigger = 0;
 			unsigned short int i           = calculate(
                     idx_trigger, my_g_stat.image_in_format->bytes_per_pixel,
-                    my_g_var.global_x - 1,
-                    my_g_var.global_y - 1);    // NW corner
+                    x - 1,
+                    y - 1);    // NW corner
 			unsigned short int j = calculate(
 					idx_trigger, my_g_stat.image_in_format->bytes_per_pixel,
-					my_g_var.global_x + 1,
-					my_g_var.global_y - 1);    // NE corner
+					x + 1,
+					y - 1);    // NE corner
 			unsigned short int k = calculate(
 					idx_trigger, my_g_stat.image_in_format->bytes_per_pixel,
-					my_g_var.global_x + 1,
-					my_g_var.global_y + 1);    // SE corner
+					x + 1,
+					y + 1);    // SE corner
 			unsigned short int l = calculate(
 					idx_trigger, my_g_stat.image_in_format->bytes_per_pixel,
-					my_g_var.global_x - 1,
-					my_g_var.global_y + 1);    // SW corner
+					x - 1,
+					y + 1);    // SW corner
 
 			if (i + j + k + l != 1) {
 				// Not exactly one trigger at the corners. This is not allowed
@@ -82,8 +82,7 @@ static void Write_flex(
 		const char*     title,       // For the header.
 		vector<string>& strings      // Okay if some are null.
 ) {
-	OFileDataSource out(filename);    // May throw exception.
-	Flex_writer     writer(out, title, strings.size());
+	Flex_writer writer(filename, title, strings.size());    // May throw.
 	for (auto& str : strings) {
 		if (!str.empty()) {
 			writer.write_object(str.c_str(), str.size() + 1);
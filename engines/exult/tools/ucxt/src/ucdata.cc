@@ -22,7 +22,7 @@
 
 #include "ucdata.h"
 
-#include "files/utils.h"
+#include "utils.h"
 #include "headers/ios_state.hpp"
 #include "ops.h"
 #include "usecode/ucsymtbl.h"
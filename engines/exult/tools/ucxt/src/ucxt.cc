@@ -38,7 +38,7 @@
 
 #include "Configuration.h"
 #include "exult_constants.h"
-#include "files/utils.h"
+#include "utils.h"
 #include "gamemgr/modmgr.h"
 #include "ops.h"
 #include "ucc.h"
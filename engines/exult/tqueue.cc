@@ -24,6 +24,7 @@
 
 #include "tqueue.h"
 
+#include "Frame_profiler.h"
 #include "actors.h"
 #include "cheat.h"
 #include "gamewin.h"
@@ -44,51 +45,186 @@
 #endif    // __GNUC__
 
 /*
- *  Remove all entries.
+ *  Restore the heap from a given position toward the top.
  */
 
-void Time_queue::clear() {
-	for (auto& ent : data) {
-		ent.handler->dequeue();
+void Time_queue::heap_up(int pos) {
+	const int slot = heap[pos];
+	while (pos > 0) {
+		const int parent = (pos - 1) / 2;
+		if (!earlier(slot, heap[parent])) {
+			break;
+		}
+		heap[pos]                   = heap[parent];
+		entries[heap[pos]].heap_pos = pos;
+		pos                         = parent;
 	}
-	data.clear();
+	heap[pos]              = slot;
+	entries[slot].heap_pos = pos;
 }
 
 /*
- *  Add an entry to the queue.
+ *  Restore the heap from a given position toward the bottom.
  */
 
-void Time_queue::add(
-		uint32 t, std::shared_ptr<Time_sensitive> obj, uintptr ud) {
+void Time_queue::heap_down(int pos) {
+	const int slot = heap[pos];
+	const int cnt  = static_cast<int>(heap.size());
+	for (;;) {
+		int child = 2 * pos + 1;
+		if (child >= cnt) {
+			break;
+		}
+		if (child + 1 < cnt && earlier(heap[child + 1], heap[child])) {
+			child++;
+		}
+		if (!earlier(heap[child], slot)) {
+			break;
+		}
+		heap[pos]                   = heap[child];
+		entries[heap[pos]].heap_pos = pos;
+		pos                         = child;
+	}
+	heap[pos]              = slot;
+	entries[slot].heap_pos = pos;
+}
+
+/*
+ *  Put a new entry into a free slot, the heap, and obj's chain.
+ */
+
+Queue_handle Time_queue::insert(
+		uint32 t, Time_sensitive* obj, Queue_entry& ent) {
 	obj->queue_cnt++;    // It's going in, no matter what.
-	Queue_entry newent;
 	if (paused && !obj->always) {    // Paused?
 		// Messy, but we need to fix time.
 		t -= SDL_GetTicks() - pause_time;
 	}
-	newent.set(t, nullptr, ud, obj);
-	auto insertionPoint = std::upper_bound(data.begin(), data.end(), newent);
-	data.insert(insertionPoint, newent);
+	ent.time = t;
+	ent.seq  = next_seq++;
+	int slot;
+	if (free_slot >= 0) {
+		slot          = free_slot;
+		free_slot     = entries[slot].next_same;
+		entries[slot] = std::move(ent);
+	} else {
+		slot = static_cast<int>(entries.size());
+		entries.push_back(std::move(ent));
+	}
+	Queue_entry& newent = entries[slot];
+	newent.prev_same    = -1;
+	newent.next_same    = obj->queue_first;
+	if (obj->queue_first >= 0) {
+		entries[obj->queue_first].prev_same = slot;
+	}
+	obj->queue_first = slot;
+	heap.push_back(slot);
+	heap_up(static_cast<int>(heap.size()) - 1);
+	return {slot, newent.seq};
+}
+
+/*
+ *  Take an entry out of the heap and its object's chain, and free its
+ *  slot.  The object's count isn't changed.
+ */
+
+void Time_queue::erase(int slot) {
+	Queue_entry&    ent = entries[slot];
+	Time_sensitive* obj = ent.get_handler();
+	if (ent.prev_same >= 0) {
+		entries[ent.prev_same].next_same = ent.next_same;
+	} else {
+		obj->queue_first = ent.next_same;
+	}
+	if (ent.next_same >= 0) {
+		entries[ent.next_same].prev_same = ent.prev_same;
+	}
+	const int pos  = ent.heap_pos;
+	const int last = heap.back();
+	heap.pop_back();
+	if (last != slot) {
+		heap[pos] = last;
+		heap_up(pos);
+		heap_down(entries[last].heap_pos);
+	}
+	ent.heap_pos = -1;
+	ent.handler  = nullptr;
+	ent.sp_handler.reset();    // Might delete the object.
+	ent.next_same = free_slot;
+	free_slot     = slot;
+}
+
+/*
+ *  Find the soonest due entry for an object (and data, if match_udata).
+ *
+ *  Output: Its slot, or -1.
+ */
+
+int Time_queue::first_for(
+		const Time_sensitive* obj, bool match_udata, uintptr udata) const {
+	const int first = obj->queue_first;
+	if (first < 0 || first >= static_cast<int>(entries.size())
+		|| entries[first].get_handler() != obj) {
+		return -1;    // Not in this queue.
+	}
+	int found = -1;
+	for (int slot = first; slot >= 0; slot = entries[slot].next_same) {
+		if ((!match_udata || entries[slot].udata == udata)
+			&& (found < 0 || earlier(slot, found))) {
+			found = slot;
+		}
+	}
+	return found;
+}
+
+/*
+ *  Remove all entries.
+ */
+
+void Time_queue::clear() {
+	// Handlers may delete themselves in dequeue(), so empty the queue
+	//   before calling them.
+	std::vector<Queue_entry> old_entries;
+	old_entries.reserve(heap.size());
+	for (const int slot : heap) {
+		entries[slot].get_handler()->queue_first = -1;
+		old_entries.push_back(std::move(entries[slot]));
+	}
+	std::sort(old_entries.begin(), old_entries.end());
+	entries.clear();
+	heap.clear();
+	free_slot = -1;
+	for (auto& ent : old_entries) {
+		ent.get_handler()->dequeue();
+	}
+}
+
+/*
+ *  Add an entry to the queue.
+ *
+ *  Output: Handle for removing it.
+ */
+
+Queue_handle Time_queue::add(
+		uint32 t, std::shared_ptr<Time_sensitive> obj, uintptr ud) {
+	Time_sensitive* handler = obj.get();
+	Queue_entry     newent;
+	newent.set(t, nullptr, ud, std::move(obj));
+	return insert(t, handler, newent);
 }
 
-void Time_queue::add(
+Queue_handle Time_queue::add(
 		uint32          t,      // When entry is to be activated.
 		Time_sensitive* obj,    // Object to be added.
 		uintptr         ud      // User data.
 ) {
-	obj->queue_cnt++;    // It's going in, no matter what.
 	Queue_entry newent;
-	if (paused && !obj->always) {    // Paused?
-		// Messy, but we need to fix time.
-		t -= SDL_GetTicks() - pause_time;
-	}
 	newent.set(t, obj, ud, nullptr);
-	auto insertionPoint = std::upper_bound(data.begin(), data.end(), newent);
-	data.insert(insertionPoint, newent);
+	return insert(t, obj, newent);
 }
 
 bool operator<(const Queue_entry& q1, const Queue_entry& q2) {
-	return q1.time < q2.time;
+	return q1.time < q2.time || (q1.time == q2.time && q1.seq < q2.seq);
 }
 
 /*
@@ -98,29 +234,17 @@ bool operator<(const Queue_entry& q1, const Queue_entry& q2) {
  */
 
 bool Time_queue::remove(Time_sensitive* obj) {
-	auto toRemove
-			= std::find_if(data.begin(), data.end(), [obj](const auto& el) {
-				  return el.handler == obj || el.sp_handler.get() == obj;
-			  });
-	auto found = toRemove != data.end();
-	if (found) {
-		toRemove->handler->queue_cnt--;
-		data.erase(toRemove);
+	const int slot = first_for(obj);
+	if (slot < 0) {
+		return false;
 	}
-	return found;
+	obj->queue_cnt--;
+	erase(slot);
+	return true;
 }
 
 bool Time_queue::remove(std::shared_ptr<Time_sensitive> obj) {
-	auto toRemove
-			= std::find_if(data.begin(), data.end(), [obj](const auto& el) {
-				  return el.handler == obj.get() || el.sp_handler == obj;
-			  });
-	auto found = toRemove != data.end();
-	if (found) {
-		toRemove->handler->queue_cnt--;
-		data.erase(toRemove);
-	}
-	return found;
+	return remove(obj.get());
 }
 
 /*
@@ -130,28 +254,34 @@ bool Time_queue::remove(std::shared_ptr<Time_sensitive> obj) {
  */
 
 bool Time_queue::remove(Time_sensitive* obj, uintptr udata) {
-	auto       it = std::find_if(data.begin(), data.end(), [&](const auto& el) {
-        return el.handler == obj && el.udata == udata;
-    });
-	const bool found = it != data.end();
-	if (found) {
-		obj->queue_cnt--;
-		data.erase(it);
+	const int slot = first_for(obj, true, udata);
+	if (slot < 0) {
+		return false;
 	}
-	return found;
+	obj->queue_cnt--;
+	erase(slot);
+	return true;
 }
 
 bool Time_queue::remove(std::shared_ptr<Time_sensitive> obj, uintptr udata) {
-	auto       it = std::find_if(data.begin(), data.end(), [&](const auto& el) {
-        return (el.handler == obj.get() || el.sp_handler == obj)
-               && el.udata == udata;
-    });
-	const bool found = it != data.end();
-	if (found) {
-		obj->queue_cnt--;
-		data.erase(it);
+	return remove(obj.get(), udata);
+}
+
+/*
+ *  Remove an entry by its handle.
+ *
+ *  Output: false if it was already gone.
+ */
+
+bool Time_queue::remove(const Queue_handle& handle) {
+	if (handle.slot < 0 || handle.slot >= static_cast<int>(entries.size())
+		|| entries[handle.slot].heap_pos < 0
+		|| entries[handle.slot].seq != handle.seq) {
+		return false;
 	}
-	return found;
+	entries[handle.slot].get_handler()->queue_cnt--;
+	erase(handle.slot);
+	return true;
 }
 
 /*
@@ -161,12 +291,9 @@ bool Time_queue::remove(std::shared_ptr<Time_sensitive> obj, uintptr udata) {
  */
 
 bool Time_queue::find(const Time_sensitive* obj) const {
-	return std::find_if(
-				   data.begin(), data.end(),
-				   [&](const auto& el) {
-					   return el.handler == obj || el.sp_handler.get() == obj;
-				   })
-		   != data.end();
+	const int first = obj->queue_first;
+	return first >= 0 && first < static_cast<int>(entries.size())
+		   && entries[first].get_handler() == obj;
 }
 
 /*
@@ -176,25 +303,24 @@ bool Time_queue::find(const Time_sensitive* obj) const {
  */
 
 long Time_queue::find_delay(const Time_sensitive* obj, uint32 curtime) const {
-	auto found = std::find_if(data.begin(), data.end(), [&](const auto& el) {
-		return obj == el.handler || obj == el.sp_handler.get();
-	});
-	if (found == data.end()) {
+	const int slot = first_for(obj);
+	if (slot < 0) {
 		return -1;
 	}
 	if (pause_time) {    // Watch for case when paused.
 		curtime = pause_time;
 	}
-	const long delay = found->time - curtime;
+	const long delay = entries[slot].time - curtime;
 	return delay >= 0 ? delay : 0;
 }
 
 void Time_queue::activate(uint32 curtime) {
+	PROFILE_ZONE("Time_queue::activate");
 	if (cheat.in_map_editor()) {
 		activate_mapedit(curtime);
 	} else if (paused > 0) {
 		activate_always(curtime);
-	} else if (!data.empty() && !(curtime < data.front().time)) {
+	} else if (!heap.empty() && !(curtime < entries[heap.front()].time)) {
 		activate0(curtime);
 	}
 }
@@ -207,21 +333,43 @@ void Time_queue::activate(uint32 curtime) {
 void Time_queue::activate0(uint32 curtime    // Current time.
 ) {
 	do {
-		Queue_entry                     ent    = data.front();
-		Time_sensitive*                 obj    = ent.handler;
-		std::shared_ptr<Time_sensitive> sp_obj = ent.sp_handler;
-		const uintptr                   udata  = ent.udata;
-		data.pop_front();    // Remove from chain.
-
-		if (!obj && sp_obj) {
-			obj = sp_obj.get();
-		}
+		const int slot = heap.front();
+		// Copy what we need, as handle_event can add entries.
+		Time_sensitive*                 obj    = entries[slot].get_handler();
+		std::shared_ptr<Time_sensitive> sp_obj = entries[slot].sp_handler;
+		const uintptr                   udata  = entries[slot].udata;
+		erase(slot);    // Remove from chain.
+
 		if (obj) {
 			obj->queue_cnt--;
 			obj->handle_event(curtime, udata);
 		}
 
-	} while (!data.empty() && !(curtime < data.front().time));
+	} while (!heap.empty() && !(curtime < entries[heap.front()].time));
+}
+
+/*
+ *  Get the entries that are due, in the order they're due.
+ *
+ *  Output: Slots and sequence #'s, to spot slots that get reused.
+ */
+
+std::vector<std::pair<int, uint64>> Time_queue::get_due(uint32 curtime) const {
+	std::vector<int> due;
+	for (const int slot : heap) {
+		if (!(curtime < entries[slot].time)) {
+			due.push_back(slot);
+		}
+	}
+	std::sort(due.begin(), due.end(), [this](int slot1, int slot2) {
+		return earlier(slot1, slot2);
+	});
+	std::vector<std::pair<int, uint64>> order;
+	order.reserve(due.size());
+	for (const int slot : due) {
+		order.emplace_back(slot, entries[slot].seq);
+	}
+	return order;
 }
 
 /*
@@ -231,25 +379,22 @@ void Time_queue::activate0(uint32 curtime    // Current time.
 
 void Time_queue::activate_always(uint32 curtime    // Current time.
 ) {
-	if (data.empty()) {
+	if (heap.empty()) {
 		return;
 	}
-	for (auto it = data.begin(); it != data.end() && !(curtime < it->time);) {
-		auto next = it;
-		++next;    // Get ->next in case we erase.
-		Queue_entry                     ent    = *it;
-		std::shared_ptr<Time_sensitive> sp_obj = ent.sp_handler;
-		Time_sensitive*                 obj    = ent.handler;
-		if (obj == nullptr && sp_obj) {
-			obj = sp_obj.get();
+	// Entries that handlers add are left for the next time.
+	for (const auto& [slot, seq] : get_due(curtime)) {
+		if (entries[slot].heap_pos < 0 || entries[slot].seq != seq) {
+			continue;    // Removed by an earlier handler.
 		}
+		Time_sensitive* obj = entries[slot].get_handler();
 		if (obj != nullptr && obj->always) {
+			std::shared_ptr<Time_sensitive> sp_obj = entries[slot].sp_handler;
 			obj->queue_cnt--;
-			const uintptr udata = ent.udata;
-			data.erase(it);
+			const uintptr udata = entries[slot].udata;
+			erase(slot);
 			obj->handle_event(curtime, udata);
 		}
-		it = next;
 	}
 }
 
@@ -260,28 +405,25 @@ void Time_queue::activate_always(uint32 curtime    // Current time.
 
 void Time_queue::activate_mapedit(uint32 curtime    // Current time.
 ) {
-	if (data.empty()) {
+	if (heap.empty()) {
 		return;
 	}
 
 	const Main_actor* const avatar
 			= Game_window::get_instance()->get_main_actor();
-	for (auto it = data.begin(); it != data.end() && !(curtime < it->time);) {
-		auto next = it;
-		++next;    // Get ->next in case we erase.
-		Queue_entry                     ent    = *it;
-		std::shared_ptr<Time_sensitive> sp_obj = ent.sp_handler;
-		Time_sensitive*                 obj    = ent.handler;
-		if (obj == nullptr && sp_obj) {
-			obj = sp_obj.get();
+	// Entries that handlers add are left for the next time.
+	for (const auto& [slot, seq] : get_due(curtime)) {
+		if (entries[slot].heap_pos < 0 || entries[slot].seq != seq) {
+			continue;    // Removed by an earlier handler.
 		}
+		Time_sensitive* obj = entries[slot].get_handler();
 		if (obj != nullptr && (obj == avatar || obj->always)) {
+			std::shared_ptr<Time_sensitive> sp_obj = entries[slot].sp_handler;
 			obj->queue_cnt--;
-			const uintptr udata = ent.udata;
-			data.erase(it);
+			const uintptr udata = entries[slot].udata;
+			erase(slot);
 			obj->handle_event(curtime, udata);
 		}
-		it = next;
 	}
 }
 
@@ -298,11 +440,41 @@ void Time_queue::resume(uint32 curtime) {
 	if (diff < 0) {    // Should not happen.
 		return;
 	}
-	for (auto& it : data) {
-		if (!it.handler->always) {
-			it.time += diff;    // Push entries ahead.
+	paused_total += diff;
+	for (const int slot : heap) {
+		if (!entries[slot].get_handler()->always) {
+			entries[slot].time += diff;    // Push entries ahead.
 		}
 	}
+	// Only some moved, so rebuild the heap.
+	for (int pos = static_cast<int>(heap.size()) / 2 - 1; pos >= 0; pos--) {
+		heap_down(pos);
+	}
+}
+
+/*
+ *  Start with the entries (for obj, if not null) in the order they're due.
+ */
+
+Time_queue_iterator::Time_queue_iterator(Time_queue* tq, Time_sensitive* obj)
+		: tqueue(tq) {
+	const std::vector<Queue_entry>& entries = tq->entries;
+	std::vector<int>                slots;
+	if (obj == nullptr) {
+		slots = tq->heap;
+	} else if (tq->find(obj)) {
+		for (int slot = obj->queue_first; slot >= 0;
+			 slot     = entries[slot].next_same) {
+			slots.push_back(slot);
+		}
+	}
+	std::sort(slots.begin(), slots.end(), [tq](int slot1, int slot2) {
+		return tq->earlier(slot1, slot2);
+	});
+	order.reserve(slots.size());
+	for (const int slot : slots) {
+		order.emplace_back(slot, entries[slot].seq);
+	}
 }
 
 /*
@@ -313,19 +485,15 @@ bool Time_queue_iterator::operator()(
 		Time_sensitive*& obj,    // Main object.
 		uintptr&         data    // Data that was added with it.
 ) {
-	auto remain = iter;
-	iter        = this_obj == nullptr
-						  ? remain
-						  : std::find_if(
-                             iter, tqueue->data.end(), [&](const auto& el) {
-                                 return el.handler == this_obj
-                                        || el.sp_handler.get() == this_obj;
-                             });
-	if (iter == tqueue->data.end()) {
-		return false;
+	while (next < order.size()) {
+		const auto [slot, seq] = order[next++];
+		const Queue_entry& ent = tqueue->entries[slot];
+		if (ent.heap_pos < 0 || ent.seq != seq) {
+			continue;    // It's been removed.
+		}
+		obj  = ent.get_handler();    // Return fields.
+		data = ent.udata;
+		return true;
 	}
-	obj  = iter->handler;    // Return fields.
-	data = iter->udata;
-	++iter;    // On to the next.
-	return true;
+	return false;
 }
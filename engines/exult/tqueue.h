@@ -23,15 +23,17 @@
 
 #include "common_types.h"
 
-#include <list>
 #include <memory>
+#include <utility>
+#include <vector>
 
 /*
  *  An interface for entries in the queue:
  */
 class Time_sensitive {
-	int  queue_cnt = 0;        // # of entries for this in queue.
-	bool always    = false;    // Always do this, even if paused.
+	int  queue_cnt   = 0;        // # of entries for this in queue.
+	int  queue_first = -1;       // Slot of one of them, chained to others.
+	bool always      = false;    // Always do this, even if paused.
 protected:
 	virtual void dequeue() {
 		queue_cnt--;
@@ -39,6 +41,7 @@ protected:
 
 public:
 	friend class Time_queue;
+	friend class Time_queue_iterator;
 	virtual ~Time_sensitive() = default;
 
 	bool in_queue() const {
@@ -60,12 +63,15 @@ class Time_queue;
  *  A queue entry:
  */
 struct Queue_entry {
-	// Queue_entry *next, *prev;    // Next, prev. in queue.
 	Time_sensitive* handler;    // Object to activate.
 	std::shared_ptr<Time_sensitive>
 			sp_handler;    // Shared pointer to object to activate
 	uintptr udata;         // Data to pass to handler.
 	uint32  time;          // Time when this is due.
+	uint64  seq;           // Order added, so equal times stay FIFO.
+	int     heap_pos;      // Index in the heap, or -1 if slot is free.
+	int     next_same;     // Next entry for the same object (or free).
+	int     prev_same;     // Previous entry for the same object.
 
 	inline void set(
 			uint32 t, Time_sensitive* h, uintptr ud,
@@ -73,22 +79,53 @@ struct Queue_entry {
 		time       = t;
 		handler    = h;
 		udata      = ud;
-		sp_handler = sp;
+		sp_handler = std::move(sp);
+	}
+
+	Time_sensitive* get_handler() const {
+		return handler ? handler : sp_handler.get();
 	}
 };
 
 bool operator<(const Queue_entry& q1, const Queue_entry& q2);
 
 /*
- *  Time-based queue.  The entries are kept sorted in increasing order
- *  by time.
+ *  Refers to one entry, to remove it without looking for it.  It's no
+ *  longer valid once the entry has been activated or removed.
+ */
+struct Queue_handle {
+	int    slot = -1;
+	uint64 seq  = 0;
+};
+
+/*
+ *  Time-based queue.  The entries are kept in a binary heap ordered by
+ *  time, and then by the order they were added.  Each object chains its
+ *  own entries, so finding or removing them doesn't search the queue.
  */
 class Time_queue {
-	using Temporal_sequence = std::list<Queue_entry>;
-	Temporal_sequence data;
-	uint32            pause_time = 0;    // Time when paused.
-	int               paused     = 0;    // Count of calls to 'pause()'.
+	std::vector<Queue_entry> entries;      // Slots for the entries.
+	std::vector<int>         heap;         // Slots, soonest due first.
+	int                      free_slot  = -1;    // Chain of unused slots.
+	uint64                   next_seq   = 0;
+	uint32                   pause_time = 0;    // Time when paused.
+	int                      paused = 0;    // Count of calls to 'pause()'.
+	uint32                   paused_total = 0;    // Time spent paused.
+
+	bool earlier(int slot1, int slot2) const {
+		return entries[slot1] < entries[slot2];
+	}
 
+	void heap_up(int pos);
+	void heap_down(int pos);
+	Queue_handle insert(uint32 t, Time_sensitive* obj, Queue_entry& ent);
+	void erase(int slot);    // Take slot out of the queue.
+	// Soonest due entry for obj, and then with that udata if asked.
+	int first_for(
+			const Time_sensitive* obj, bool match_udata = false,
+			uintptr udata = 0) const;
+	// Entries that are due, in order, to activate while paused.
+	std::vector<std::pair<int, uint64>> get_due(uint32 curtime) const;
 	// Activate head + any others due.
 	void activate0(uint32 curtime);
 	void activate_always(uint32 curtime);
@@ -99,24 +136,25 @@ public:
 	void clear();    // Remove all entries.
 
 	// Add an entry.
-	void add(uint32 t, Time_sensitive* obj) {
-		add(t, obj, static_cast<uintptr>(0));
+	Queue_handle add(uint32 t, Time_sensitive* obj) {
+		return add(t, obj, static_cast<uintptr>(0));
 	}
 
-	void add(uint32 t, std::shared_ptr<Time_sensitive> obj) {
-		add(t, obj, static_cast<uintptr>(0));
+	Queue_handle add(uint32 t, std::shared_ptr<Time_sensitive> obj) {
+		return add(t, obj, static_cast<uintptr>(0));
 	}
 
-	void add(uint32 t, Time_sensitive* obj, void* ud) {
-		add(t, obj, reinterpret_cast<uintptr>(ud));
+	Queue_handle add(uint32 t, Time_sensitive* obj, void* ud) {
+		return add(t, obj, reinterpret_cast<uintptr>(ud));
 	}
 
-	void add(uint32 t, std::shared_ptr<Time_sensitive> obj, void* ud) {
-		add(t, obj, reinterpret_cast<uintptr>(ud));
+	Queue_handle add(uint32 t, std::shared_ptr<Time_sensitive> obj, void* ud) {
+		return add(t, obj, reinterpret_cast<uintptr>(ud));
 	}
 
-	void add(uint32 t, std::shared_ptr<Time_sensitive> obj, uintptr ud);
-	void add(uint32 t, Time_sensitive* obj, uintptr ud);
+	Queue_handle add(
+			uint32 t, std::shared_ptr<Time_sensitive> obj, uintptr ud);
+	Queue_handle add(uint32 t, Time_sensitive* obj, uintptr ud);
 	// Remove object's entry.
 	bool remove(Time_sensitive* obj);
 	bool remove(std::shared_ptr<Time_sensitive> obj);
@@ -131,6 +169,8 @@ public:
 
 	bool remove(Time_sensitive* obj, uintptr udata);
 	bool remove(std::shared_ptr<Time_sensitive> obj, uintptr udata);
+	// Remove the entry that add() returned, if it's still there.
+	bool remove(const Queue_handle& handle);
 	bool find(const Time_sensitive* obj) const;    // Find an entry.
 	// Find delay when obj. is due.
 	long find_delay(const Time_sensitive* obj, uint32 curtime) const;
@@ -145,15 +185,31 @@ public:
 	}
 
 	void resume(uint32 curtime);
+
+	// Time with the pauses taken out.  It stands still while paused, so
+	//   delays measured in it don't need fixing when the game resumes.
+	uint32 get_game_time(uint32 curtime) const {
+		return (paused ? pause_time : curtime) - paused_total;
+	}
+
+	// The time to add() something due at game time 't'.
+	uint32 from_game_time(uint32 t, uint32 curtime) const {
+		return t + paused_total + (paused ? curtime - pause_time : 0);
+	}
 };
 
+/*
+ *  Go through the entries (or only those for one object) in the order
+ *  they're due.  Entries removed meanwhile are skipped; ones added after
+ *  the iterator was made aren't seen.
+ */
 class Time_queue_iterator {
-	Time_queue::Temporal_sequence::iterator iter;
-	Time_queue*                             tqueue;
-	Time_sensitive* this_obj;    // Only return entries for this obj.
+	std::vector<std::pair<int, uint64>> order;    // Slot and seq. #.
+	size_t                              next = 0;
+	Time_queue*                         tqueue;
+
 public:
-	Time_queue_iterator(Time_queue* tq, Time_sensitive* obj)
-			: iter(tq->data.begin()), tqueue(tq), this_obj(obj) {}
+	Time_queue_iterator(Time_queue* tq, Time_sensitive* obj);
 
 	bool operator()(Time_sensitive*& obj, uintptr& data);
 };
@@ -23,7 +23,7 @@
 #include "txtscroll.h"
 
 #include "common_types.h"
-#include "files/U7file.h"
+#include "U7file.h"
 #include "font.h"
 #include "game.h"
 #include "gamewin.h"
@@ -43,7 +43,11 @@ namespace Exult_server {
 				= 13,    // ( *  ) set a breakpoint at a specific location
 		dbg_clear_breakpoint = 14,    // ( *  ) clear a breakpoint
 		dbg_get_breakpoints
-				= 15    // (c->s) request all (permanent) breakpoints
+				= 15,    // (c->s) request all (permanent) breakpoints
+		dbg_start_profile = 16,    // (c->s) start the usecode profiler
+		dbg_stop_profile  = 17,    // (c->s) stop it
+		dbg_get_profile   = 18,    // (c->s) request the profile so far
+		dbg_profile       = 19     // (s->c) sending profile (text)
 	};
 
 }    // namespace Exult_server
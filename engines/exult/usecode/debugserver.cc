@@ -204,6 +204,27 @@ void Handle_debug_message(unsigned char* data, int datalen) {
 		uci->transmit_breakpoints(client_socket);
 		break;
 	}
+	case Exult_server::dbg_start_profile:
+		Usecode_profiler::start();
+		break;
+	case Exult_server::dbg_stop_profile:
+		Usecode_profiler::stop();
+		break;
+	case Exult_server::dbg_get_profile: {
+		stringstream report;
+		report << static_cast<char>(Exult_server::dbg_profile);
+		if (Usecode_profiler* prof = Usecode_profiler::get()) {
+			prof->write_report(report, 20);
+		}
+		// Cut what doesn't fit in a message.
+		const std::string msg = report.str().substr(
+				0, Exult_server::maxlength - 1);
+		Exult_server::Send_data(
+				client_socket, Exult_server::usecode_debugging,
+				reinterpret_cast<const unsigned char*>(msg.c_str()),
+				msg.size() + 1);
+		break;
+	}
 	default:
 		break;
 	}
@@ -24,7 +24,6 @@
 
 #include "stackframe.h"
 
-#include "endianio.h"
 #include "ucfunction.h"
 #include "ucinternal.h"
 #include "useval.h"
@@ -42,34 +41,18 @@ Stack_frame::Stack_frame(
 		  call_chain(chain), call_depth(depth), num_externs(0), num_args(0),
 		  num_vars(0), locals(nullptr), eventid(event),
 		  caller_item(shared_from_obj(caller)), save_sp(nullptr) {
-	ip   = function->code;
-	endp = ip + function->len;
-
-	int data_len;
-	if (!fun->extended) {
-		data_len = little_endian::Read2(ip);    // Get length of (text) data.
-	} else {
-		data_len = little_endian::Read4s(ip);    // 32 bit lengths
-	}
-
-	data = ip;
-
-	ip += data_len;                         // Point past text.
-	num_args = little_endian::Read2(ip);    // # of args. this function takes.
-
-	// Local variables follow args.
-	num_vars = little_endian::Read2(ip);
+	// The header was decoded when the function was read.
+	endp        = function->code + function->len;
+	data        = function->data;
+	num_args    = function->num_args;
+	num_vars    = function->num_vars;
+	num_externs = function->num_externs;
+	externs     = function->externs;
+	code = ins_ip = ip = function->instructions;
 
 	// Allocate locals.
 	const int num_locals = num_vars + num_args;
 	locals               = new Usecode_value[num_locals];
-
-	num_externs = little_endian::Read2(ip);    // external function references
-	externs     = ip;
-
-	ip += 2 * num_externs;    // now points to actual code
-
-	code = ins_ip = ip;
 }
 
 Stack_frame::~Stack_frame() {
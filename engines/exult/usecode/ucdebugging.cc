@@ -29,6 +29,12 @@
 #include "stackframe.h"
 #include "ucfunction.h"
 #include "ucinternal.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 
 Breakpoint::Breakpoint(bool once) {
 	this->once = once;
@@ -148,3 +154,243 @@ void Breakpoints::transmit(int fd) {
 		brk->serialize(fd);
 	}
 }
+
+Usecode_profiler* Usecode_profiler::active = nullptr;
+
+Usecode_profiler::Usecode_profiler() : last_time(Clock::now()) {
+	nodes.push_back(Stack_node{0, 0});
+}
+
+/*
+ *  Start profiling, if it isn't already.
+ */
+
+void Usecode_profiler::start(const std::string& fname) {
+	if (!active) {
+		active        = new Usecode_profiler();
+		active->fname = fname;
+	}
+}
+
+/*
+ *  Stop profiling, and write the call stacks if a file was given.
+ */
+
+void Usecode_profiler::stop() {
+	if (!active) {
+		return;
+	}
+	Usecode_profiler* prof = active;
+	active                 = nullptr;
+	if (!prof->fname.empty()) {
+		try {
+			auto out = U7open_out(prof->fname.c_str(), true);
+			if (out) {
+				prof->write_folded(*out, false);
+			}
+		} catch (const file_open_exception& err) {
+			std::cerr << err.what() << std::endl;
+		}
+		prof->write_report(std::cout, 20);
+	}
+	delete prof;
+}
+
+/*
+ *  Add what ran since the last call or return to the current function.
+ */
+
+void Usecode_profiler::flush() {
+	const Clock::time_point now = Clock::now();
+	if (!frames.empty()) {
+		const Clock::duration time = now - last_time;
+		Frame&                top  = frames.back();
+		top.insns += pending_insns;
+		top.time += time;
+		nodes[top.node].insns += pending_insns;
+		nodes[top.node].time += time;
+		Function_stats& stats = functions[top.key];
+		stats.insns += pending_insns;
+		stats.time += time;
+	}
+	pending_insns = 0;
+	last_time     = now;
+}
+
+void Usecode_profiler::push(int key, const char* name, int callip) {
+	flush();
+
+	size_t parent = 0;
+	if (!frames.empty()) {
+		parent = frames.back().node;
+		if (callip >= 0) {
+			call_sites[Call_site{frames.back().key, callip, key}]++;
+		}
+	}
+
+	const auto child = std::make_pair(parent, key);
+	auto       it    = children.find(child);
+	size_t     node;
+	if (it != children.end()) {
+		node = it->second;
+	} else {
+		node = nodes.size();
+		nodes.push_back(Stack_node{key, parent});
+		children[child] = node;
+	}
+	frames.push_back(Frame{key, node});
+
+	Function_stats& stats = functions[key];
+	if (stats.calls == 0 && name) {
+		stats.name = name;
+	}
+	stats.calls++;
+	stats.active++;
+}
+
+void Usecode_profiler::pop() {
+	flush();
+	if (frames.empty()) {
+		return;    // Called before profiling started.
+	}
+
+	const Frame frame = frames.back();
+	frames.pop_back();
+
+	const unsigned long long incl_insns = frame.insns + frame.child_insns;
+	const Clock::duration    incl_time  = frame.time + frame.child_time;
+
+	// Count recursive calls only once, in the outermost one.
+	Function_stats& stats = functions[frame.key];
+	if (--stats.active == 0) {
+		stats.incl_insns += incl_insns;
+		stats.incl_time += incl_time;
+	}
+	if (!frames.empty()) {
+		frames.back().child_insns += incl_insns;
+		frames.back().child_time += incl_time;
+	}
+}
+
+void Usecode_profiler::call(int funcid, const char* name, int callip) {
+	push(funcid, name, callip);
+}
+
+void Usecode_profiler::ret() {
+	pop();
+}
+
+void Usecode_profiler::begin_intrinsic(int num, const char* name, int callip) {
+	push(-1 - num, name, callip);
+}
+
+void Usecode_profiler::end_intrinsic() {
+	pop();
+}
+
+std::string Usecode_profiler::get_name(int key) const {
+	auto it = functions.find(key);
+	if (it != functions.end() && !it->second.name.empty()) {
+		return it->second.name;
+	}
+	std::ostringstream name;
+	name << (key < 0 ? "intrinsic_" : "func_") << std::hex << std::setw(4)
+		 << std::setfill('0') << (key < 0 ? -1 - key : key);
+	return name.str();
+}
+
+std::string Usecode_profiler::get_stack(size_t node) const {
+	std::string stack = get_name(nodes[node].key);
+	for (node = nodes[node].parent; node != 0; node = nodes[node].parent) {
+		stack = get_name(nodes[node].key) + ';' + stack;
+	}
+	return stack;
+}
+
+static double To_millis(std::chrono::steady_clock::duration time) {
+	return std::chrono::duration<double, std::milli>(time).count();
+}
+
+/*
+ *  Write the busiest functions, intrinsics and call sites.
+ */
+
+void Usecode_profiler::write_report(std::ostream& out, size_t topn) {
+	flush();
+
+	std::vector<std::pair<int, const Function_stats*>> funcs;
+	std::vector<std::pair<int, const Function_stats*>> intrinsics;
+	for (const auto& entry : functions) {
+		(entry.first < 0 ? intrinsics : funcs)
+				.emplace_back(entry.first, &entry.second);
+	}
+	std::sort(funcs.begin(), funcs.end(), [](const auto& a, const auto& b) {
+		return a.second->insns > b.second->insns;
+	});
+	std::sort(
+			intrinsics.begin(), intrinsics.end(),
+			[](const auto& a, const auto& b) {
+				return a.second->calls > b.second->calls;
+			});
+
+	const auto flags = out.flags();
+	out << std::fixed << std::setprecision(3);
+	out << "Usecode profile" << std::endl
+		<< std::left << std::setw(32) << "function" << std::right
+		<< std::setw(9) << "calls" << std::setw(12) << "insns"
+		<< std::setw(12) << "incl" << std::setw(10) << "ms" << std::setw(10)
+		<< "incl ms" << std::endl;
+	for (size_t i = 0; i < funcs.size() && i < topn; i++) {
+		const Function_stats& stats = *funcs[i].second;
+		out << std::left << std::setw(32) << get_name(funcs[i].first)
+			<< std::right << std::setw(9) << stats.calls << std::setw(12)
+			<< stats.insns << std::setw(12) << stats.incl_insns
+			<< std::setw(10) << To_millis(stats.time) << std::setw(10)
+			<< To_millis(stats.incl_time) << std::endl;
+	}
+
+	out << std::left << std::setw(32) << "intrinsic" << std::right
+		<< std::setw(9) << "calls" << std::setw(10) << "ms" << std::endl;
+	for (size_t i = 0; i < intrinsics.size() && i < topn; i++) {
+		const Function_stats& stats = *intrinsics[i].second;
+		out << std::left << std::setw(32) << get_name(intrinsics[i].first)
+			<< std::right << std::setw(9) << stats.calls << std::setw(10)
+			<< To_millis(stats.incl_time) << std::endl;
+	}
+
+	std::vector<std::pair<Call_site, unsigned>> sites(
+			call_sites.begin(), call_sites.end());
+	std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) {
+		return a.second > b.second;
+	});
+	out << "Busiest call sites:" << std::endl;
+	for (size_t i = 0; i < sites.size() && i < topn; i++) {
+		const Call_site& site = sites[i].first;
+		out << std::setw(9) << sites[i].second << "  "
+			<< get_name(site.caller) << " @" << std::hex << std::setw(4)
+			<< std::setfill('0') << site.ip << std::dec << std::setfill(' ')
+			<< " -> " << get_name(site.callee) << std::endl;
+	}
+	out.flags(flags);
+}
+
+/*
+ *  Write the call stacks as 'folded' lines for flame graph tools.
+ */
+
+void Usecode_profiler::write_folded(std::ostream& out, bool bytime) {
+	flush();
+
+	for (size_t i = 1; i < nodes.size(); i++) {
+		unsigned long long count = nodes[i].insns;
+		if (bytime) {
+			count = std::chrono::duration_cast<std::chrono::microseconds>(
+							nodes[i].time)
+							.count();
+		}
+		if (count != 0) {
+			out << get_stack(i) << ' ' << count << '\n';
+		}
+	}
+	out.flush();
+}
@@ -23,7 +23,12 @@
 
 #include "ignore_unused_variable_warning.h"
 
+#include <chrono>
+#include <iosfwd>
 #include <list>
+#include <map>
+#include <string>
+#include <vector>
 
 class Stack_frame;
 
@@ -156,4 +161,102 @@ private:
 	std::list<Breakpoint*> breaks;
 };
 
+// Counts the instructions run and the time spent in each usecode function
+// and intrinsic, following the interpreter's call stack. Intrinsics are
+// pseudo-functions, so usecode run from within one shows up under it.
+class Usecode_profiler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Start profiling. If fname isn't empty, the call stacks are written
+	// there when it stops.
+	static void start(const std::string& fname = std::string());
+	static void stop();
+
+	// The running profiler, or nullptr.
+	static Usecode_profiler* get() {
+		return active;
+	}
+
+	void instruction() {
+		pending_insns++;
+	}
+
+	// The instruction at callip (-1 if called from outside) calls funcid.
+	void call(int funcid, const char* name, int callip);
+	void ret();
+	void begin_intrinsic(int num, const char* name, int callip);
+	void end_intrinsic();
+
+	// The 'topn' functions, intrinsics and call sites that ran the most
+	// instructions or were called most.
+	void write_report(std::ostream& out, size_t topn);
+	// One line per call stack in the format flame graph tools read, with
+	// the instructions run in it, or the microseconds spent if bytime.
+	void write_folded(std::ostream& out, bool bytime);
+
+private:
+	// Intrinsic n is -1 - n, functions are their id.
+	struct Function_stats {
+		std::string        name;
+		unsigned           calls  = 0;
+		unsigned           active = 0;    // Calls that haven't returned.
+		unsigned long long insns  = 0;    // Run in the function itself.
+		unsigned long long incl_insns = 0;    // Including its callees.
+		Clock::duration    time{};
+		Clock::duration    incl_time{};
+	};
+
+	struct Stack_node {
+		int             key;
+		size_t          parent;    // The root is its own parent.
+		unsigned long long insns = 0;
+		Clock::duration time{};
+	};
+
+	struct Frame {
+		int                key;
+		size_t             node;
+		unsigned long long insns       = 0;
+		unsigned long long child_insns = 0;
+		Clock::duration    time{};
+		Clock::duration    child_time{};
+	};
+
+	struct Call_site {
+		int caller;
+		int ip;
+		int callee;
+
+		bool operator<(const Call_site& o) const {
+			if (caller != o.caller) {
+				return caller < o.caller;
+			}
+			if (ip != o.ip) {
+				return ip < o.ip;
+			}
+			return callee < o.callee;
+		}
+	};
+
+	static Usecode_profiler* active;
+
+	std::string        fname;
+	Clock::time_point  last_time;
+	unsigned long long pending_insns = 0;
+
+	std::vector<Frame>                      frames;
+	std::map<int, Function_stats>           functions;
+	std::map<Call_site, unsigned>           call_sites;
+	std::vector<Stack_node>                 nodes;
+	std::map<std::pair<size_t, int>, size_t> children;
+
+	Usecode_profiler();
+	void        flush();
+	void        push(int key, const char* name, int callip);
+	void        pop();
+	std::string get_name(int key) const;
+	std::string get_stack(size_t node) const;
+};
+
 #endif
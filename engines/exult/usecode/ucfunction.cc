@@ -54,4 +54,20 @@ Usecode_function::Usecode_function(istream& file) : orig(nullptr) {
 
 	code = new unsigned char[len];    // Allocate buffer & read it in.
 	file.read(reinterpret_cast<char*>(code), len);
+
+	const unsigned char* ip = code;
+	int                  data_len;
+	if (!extended) {
+		data_len = little_endian::Read2(ip);    // Get length of (text) data.
+	} else {
+		data_len = little_endian::Read4s(ip);    // 32 bit lengths
+	}
+	data = ip;
+	ip += data_len;                            // Point past text.
+	num_args    = little_endian::Read2(ip);    // # of args.
+	num_vars    = little_endian::Read2(ip);    // Local variables follow args.
+	num_externs = little_endian::Read2(ip);    // external function references
+	externs     = ip;
+	ip += 2 * num_externs;
+	instructions = ip;
 }
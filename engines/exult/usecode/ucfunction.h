@@ -26,6 +26,9 @@
 #include <iosfwd>
 #include <vector>
 
+class Stack_frame;
+class Usecode_internal;
+
 class Usecode_function {
 public:
 	int id;    // The function #.  (Appears to be the
@@ -39,6 +42,21 @@ public:
 	bool extended;    // is this an 'extented' function? (aka 32 bit function)
 	unsigned char*             code;       // The code.
 	std::vector<Usecode_value> statics;    // Local statics.
+
+	// The header of the code, decoded once when read.
+	const unsigned char* data;            // Start of (text) data.
+	const unsigned char* externs;         // External function references.
+	const unsigned char* instructions;    // First instruction.
+	int                  num_args;
+	int                  num_vars;
+	int                  num_externs;
+	// Whether it takes the 'itemref' phantom arg; -1 until looked up in
+	// the symbol table.
+	int object_fun = -1;
+	// Run instead of the code, if a native module has this function.
+	bool (*native)(Usecode_internal* uc, Stack_frame* frame, Usecode_value& ret)
+			= nullptr;
+
 	// Create from file.
 	Usecode_function(std::istream& file);
 
@@ -26,6 +26,7 @@
 
 #include "Audio.h"
 #include "Face_stats.h"
+#include "Frame_profiler.h"
 #include "Gump.h"
 #include "Gump_manager.h"
 #include "Notebook_gump.h"
@@ -77,6 +78,8 @@
 #include <iomanip>
 #include <map>
 
+#include <SDL3/SDL.h>
+
 #ifdef XWIN
 #	include <csignal>
 #endif
@@ -235,7 +238,10 @@ bool Usecode_internal::call_function(
 	// In the originals, this was probably so that the games
 	// could know how much memory the function would need.
 	// In any case, do this only if this was not an indirect call.
-	if (givenargs == 0 && is_object_fun(funcid)) {
+	if (fun->object_fun < 0) {
+		fun->object_fun = is_object_fun(funcid);
+	}
+	if (givenargs == 0 && fun->object_fun) {
 		if (--num_args < 0) {
 			// Backwards compatibility with older mods.
 			cerr << "Called usecode function " << hex << setfill('0') << funcid
@@ -258,8 +264,7 @@ bool Usecode_internal::call_function(
 	// Store args in first num_args locals
 	int i;
 	for (i = 0; i < num_args; i++) {
-		const Usecode_value val         = pop();
-		frame->locals[num_args - i - 1] = val;
+		frame->locals[num_args - i - 1] = pop();
 	}
 
 	// save stack pointer
@@ -268,6 +273,26 @@ bool Usecode_internal::call_function(
 	// add new stack frame to top of stack
 	call_stack.push_front(frame);
 
+	if (Usecode_profiler* prof = Usecode_profiler::get()) {
+		Usecode_symbol* fsym   = symtbl ? (*symtbl)[funcid] : nullptr;
+		int             callip = -1;
+		if (!entrypoint) {
+			const Stack_frame* parent = call_stack[1];
+			callip = static_cast<int>(parent->ins_ip - parent->code);
+		}
+		prof->call(funcid, fsym ? fsym->get_name() : nullptr, callip);
+	}
+
+	if (fun->native) {    // Compiled; run it through now.
+		Usecode_value ret;
+		if (fun->native(this, frame, ret)) {
+			return_from_function(ret);
+		} else {
+			return_from_procedure();
+		}
+		return true;
+	}
+
 #ifdef DEBUG
 	Usecode_symbol* fsym = symtbl ? (*symtbl)[funcid] : nullptr;
 	cout << "Running usecode ";
@@ -301,6 +326,10 @@ void Usecode_internal::previous_stack_frame() {
 	Stack_frame* frame = call_stack.front();
 	call_stack.pop_front();
 
+	if (Usecode_profiler* prof = Usecode_profiler::get()) {
+		prof->ret();
+	}
+
 	// restore stack pointer
 	sp = frame->save_sp;
 
@@ -443,6 +472,10 @@ inline void Usecode_internal::push(const Usecode_value& val) {
 	*sp++ = val;
 }
 
+inline void Usecode_internal::push(Usecode_value&& val) {
+	*sp++ = std::move(val);
+}
+
 inline Usecode_value Usecode_internal::pop() {
 	if (sp <= stack) {
 		// Happens in SI #0x939
@@ -454,8 +487,8 @@ inline Usecode_value Usecode_internal::pop() {
 		return Usecode_value(0);
 	}
 
-	// +++++SHARED:  Shouldn't we reset *sp.
-	return *--sp;
+	// Moving out leaves nothing shared behind in the slot.
+	return std::move(*--sp);
 }
 
 inline Usecode_value Usecode_internal::peek() {
@@ -463,18 +496,15 @@ inline Usecode_value Usecode_internal::peek() {
 }
 
 inline void Usecode_internal::pushref(Game_object* obj) {
-	const Usecode_value v(obj);
-	push(v);
+	push(Usecode_value(obj));
 }
 
 inline void Usecode_internal::pushref(Game_object_shared obj) {
-	const Usecode_value v(std::move(obj));
-	push(v);
+	push(Usecode_value(std::move(obj)));
 }
 
 inline void Usecode_internal::pushi(long val) {    // Push/pop integers.
-	const Usecode_value v(val);
-	push(v);
+	push(Usecode_value(val));
 }
 
 inline int Usecode_internal::popi() {
@@ -484,8 +514,7 @@ inline int Usecode_internal::popi() {
 
 // Push/pop strings.
 inline void Usecode_internal::pushs(const char* s) {
-	const Usecode_value val(s);
-	push(val);
+	push(Usecode_value(s));
 }
 
 /*
@@ -1669,7 +1698,16 @@ Usecode_value Usecode_internal::call_intrinsic(
 		auto&                    table_entry = table[intrinsic];
 		const UsecodeIntrinsicFn func        = table_entry.func;
 		const char*              name        = table_entry.name;
-		return Execute_Intrinsic(func, name, intrinsic, num_parms, parms);
+		Usecode_profiler*        prof        = Usecode_profiler::get();
+		if (prof == nullptr) {
+			return Execute_Intrinsic(func, name, intrinsic, num_parms, parms);
+		}
+		prof->begin_intrinsic(
+				intrinsic, name, static_cast<int>(frame->ins_ip - frame->code));
+		Usecode_value ret
+				= Execute_Intrinsic(func, name, intrinsic, num_parms, parms);
+		prof->end_intrinsic();
+		return ret;
 	}
 	return no_ret;
 }
@@ -1782,6 +1820,82 @@ Usecode_machine* Usecode_machine::create() {
 	return new Usecode_internal();
 }
 
+static std::string native_module_name;    // Set from the command line.
+
+void Usecode_machine::set_native_module(const std::string& fname) {
+	native_module_name = fname;
+}
+
+/*
+ *  Load a module of usecode functions compiled to native code.
+ *
+ *  Output: false if it couldn't be loaded.
+ */
+
+bool Usecode_internal::load_native_module(const std::string& fname) {
+	SDL_SharedObject* lib = SDL_LoadObject(fname.c_str());
+	if (lib == nullptr) {
+		cerr << "Couldn't load usecode module '" << fname
+			 << "': " << SDL_GetError() << endl;
+		return false;
+	}
+	auto* reg = reinterpret_cast<void (*)(Usecode_internal*)>(
+			SDL_LoadFunction(lib, "Exult_register_usecode"));
+	if (reg == nullptr) {
+		cerr << "'" << fname << "' isn't a usecode module" << endl;
+		SDL_UnloadObject(lib);
+		return false;
+	}
+	native_module = lib;
+	reg(this);
+	return true;
+}
+
+void Usecode_internal::set_native_function(int funcid, Native_function fun) {
+	Usecode_function* ucfun = find_function(funcid);
+	if (ucfun && ucfun->orig) {
+		ucfun = ucfun->orig;    // Patched; the module has the original.
+	}
+	if (ucfun) {
+		ucfun->native = fun;
+	}
+}
+
+/*
+ *  Run a usecode function to its end, for a native function calling it.
+ *
+ *  Output: What it returned, or 0.
+ */
+
+Usecode_value Usecode_internal::call_from_native(
+		int funcid, Stack_frame* frame, const Usecode_value* args,
+		int num_args) {
+	Usecode_value* const old_sp = sp;
+	if (!call_function(
+				funcid, frame->eventid, frame->caller_item.get(), true)) {
+		return Usecode_value(0);
+	}
+	Stack_frame* called = call_stack.front();
+	if (called != nullptr) {    // Not native itself?
+		const int cnt = std::min(num_args, called->num_args);
+		for (int i = 0; i < cnt; i++) {
+			called->locals[i] = args[i];
+		}
+		run();
+	} else {
+		call_stack.pop_front();
+	}
+	return sp > old_sp ? pop() : Usecode_value(0);
+}
+
+Usecode_value Usecode_internal::call_intrinsic_from_native(
+		int intrinsic, const Usecode_value* args, int num_args) {
+	for (int i = num_args - 1; i >= 0; i--) {    // 1st arg. on top.
+		push(args[i]);
+	}
+	return call_intrinsic(intrinsic, num_args);
+}
+
 /*
  *  Create machine from a 'usecode' file.
  */
@@ -1815,6 +1929,10 @@ Usecode_internal::Usecode_internal() : stack(new Usecode_value[1024]) {
 		read_usecode(file, true);
 	}
 
+	if (!native_module_name.empty()) {
+		load_native_module(native_module_name);
+	}
+
 	//  set_breakpoint();
 }
 
@@ -1834,6 +1952,14 @@ void Usecode_internal::read_usecode(
 		delete symtbl;
 		symtbl = new Usecode_symbol_table();
 		symtbl->read(file);
+		// What was looked up in the old table has to be again.
+		for (auto& slot : funs) {
+			for (auto* fun : slot) {
+				if (fun) {
+					fun->object_fun = -1;
+				}
+			}
+		}
 	}
 	// Read in all the functions.
 	while (file.tellg() < size) {
@@ -1870,6 +1996,7 @@ void Usecode_internal::read_usecode(
  */
 
 Usecode_internal::~Usecode_internal() {
+	Usecode_profiler::stop();
 	delete[] stack;
 	delete[] String;
 	delete symtbl;
@@ -1882,6 +2009,9 @@ Usecode_internal::~Usecode_internal() {
 		}
 	}
 	delete book;
+	if (native_module) {
+		SDL_UnloadObject(static_cast<SDL_SharedObject*>(native_module));
+	}
 }
 
 #ifdef DEBUG
@@ -1930,6 +2060,7 @@ void Clearbreak() {
  */
 
 int Usecode_internal::run() {
+	PROFILE_ZONE("Usecode_internal::run");
 	bool aborted           = false;
 	bool initializing_loop = false;
 
@@ -1964,6 +2095,10 @@ int Usecode_internal::run() {
 
 			auto opcode = static_cast<UsecodeOps>(*(frame->ip));
 
+			if (Usecode_profiler* prof = Usecode_profiler::get()) {
+				prof->instruction();
+			}
+
 			if (frame->ip + get_opcode_length(static_cast<int>(opcode))
 				> frame->endp) {
 				cerr << "Operands lie outside of code segment. ";
@@ -2115,38 +2250,28 @@ int Usecode_internal::run() {
 				}
 			} break;
 			case UC_ADD: {    // ADD.
-				const Usecode_value v2     = pop();
-				const Usecode_value v1     = pop();
-				const Usecode_value retval = v1 + v2;
-				push(retval);
+				const Usecode_value v2 = pop();
+				push(pop() + v2);
 				break;
 			}
 			case UC_SUB: {    // SUB.
-				const Usecode_value v2     = pop();
-				const Usecode_value v1     = pop();
-				const Usecode_value retval = v1 - v2;
-				push(retval);
+				const Usecode_value v2 = pop();
+				push(pop() - v2);
 				break;
 			}
 			case UC_DIV: {    // DIV.
-				const Usecode_value v2     = pop();
-				const Usecode_value v1     = pop();
-				const Usecode_value retval = v1 / v2;
-				push(retval);
+				const Usecode_value v2 = pop();
+				push(pop() / v2);
 				break;
 			}
 			case UC_MUL: {    // MUL.
-				const Usecode_value v2     = pop();
-				const Usecode_value v1     = pop();
-				const Usecode_value retval = v1 * v2;
-				push(retval);
+				const Usecode_value v2 = pop();
+				push(pop() * v2);
 				break;
 			}
 			case UC_MOD: {    // MOD.
-				const Usecode_value v2     = pop();
-				const Usecode_value v1     = pop();
-				const Usecode_value retval = v1 % v2;
-				push(retval);
+				const Usecode_value v2 = pop();
+				push(pop() % v2);
 				break;
 			}
 			case UC_AND: {    // AND.
@@ -2169,11 +2294,11 @@ int Usecode_internal::run() {
 			case UC_POP: {    // POP into a variable.
 				offset = little_endian::Read2(frame->ip);
 				// Get value.
-				const Usecode_value val = pop();
+				Usecode_value val = pop();
 				if (offset < 0 || offset >= num_locals) {
 					LOCAL_VAR_ERROR(offset);
 				} else {
-					frame->locals[offset] = val;
+					frame->locals[offset] = std::move(val);
 				}
 				break;
 			}
@@ -2244,7 +2369,7 @@ int Usecode_internal::run() {
 				if (to < num) {    // 1 or more vals empty arrays?
 					arr.resize(to);
 				}
-				push(arr);
+				push(std::move(arr));
 				break;
 			}
 			case UC_PUSHI:        // PUSHI.
@@ -2306,8 +2431,9 @@ int Usecode_internal::run() {
 			case UC_AIDXTHV: {    // AIDXTHV.
 				sval = popi();    // Get index into array.
 				sval--;           // It's 1 based.
-				// Get # of local to index.
-				Usecode_value* val;
+				// Get # of local to index. Only read, so a shared array
+				// isn't copied.
+				const Usecode_value* val;
 				if (opcode == UC_AIDX) {
 					offset = little_endian::Read2(frame->ip);
 					if (offset < 0 || offset >= num_locals) {
@@ -2814,7 +2940,8 @@ int Usecode_internal::run() {
 			case UC_ARRA: {    // ARRA.
 				Usecode_value val = pop();
 				Usecode_value arr = pop();
-				push(arr.concat(val));
+				arr.concat(val);
+				push(std::move(arr));
 				break;
 			}
 			case UC_POPEVENTID:    // POP EVENTID.
@@ -2935,18 +3062,18 @@ int Usecode_internal::run() {
 			case UC_POPSTATIC: {    // POP static.
 				offset = little_endian::Read2s(frame->ip);
 				// Get value.
-				const Usecode_value val = pop();
+				Usecode_value val = pop();
 				if (offset < 0) {
 					if (static_cast<unsigned>(-offset) >= statics.size()) {
 						statics.resize(-offset + 1);
 					}
-					statics[-offset] = val;
+					statics[-offset] = std::move(val);
 				} else {
 					if (static_cast<unsigned>(offset)
 						>= frame->function->statics.size()) {
 						frame->function->statics.resize(offset + 1);
 					}
-					frame->function->statics[offset] = val;
+					frame->function->statics[offset] = std::move(val);
 				}
 				break;
 			}
@@ -2989,10 +3116,10 @@ int Usecode_internal::run() {
 			}
 			case UC_POPTHV: {    // POP class this->var.
 				// Get value.
-				const Usecode_value val   = pop();
+				Usecode_value val         = pop();
 				offset                    = little_endian::Read2(frame->ip);
 				Usecode_value& ths        = frame->get_this();
-				ths.nth_class_var(offset) = val;
+				ths.nth_class_var(offset) = std::move(val);
 				break;
 			}
 			case UC_CALLM:       // CALLM - call method, use pushed var vtable.
@@ -3135,8 +3262,7 @@ bool Usecode_internal::call_method(
 	// Store args in first num_args locals
 	int i;
 	for (i = 0; i < frame->num_args; i++) {
-		const Usecode_value val                = pop();
-		frame->locals[frame->num_args - i - 1] = val;
+		frame->locals[frame->num_args - i - 1] = pop();
 	}
 
 	// save stack pointer
@@ -3145,6 +3271,11 @@ bool Usecode_internal::call_method(
 	// add new stack frame to top of stack
 	call_stack.push_front(frame);
 
+	if (Usecode_profiler* prof = Usecode_profiler::get()) {
+		Usecode_symbol* fsym = symtbl ? (*symtbl)[id] : nullptr;
+		prof->call(id, fsym ? fsym->get_name() : nullptr, -1);
+	}
+
 #ifdef DEBUG
 	Usecode_class_symbol* cls  = inst->get_class_ptr();
 	Usecode_symbol*       fsym = cls ? (*cls)[id] : nullptr;
@@ -98,9 +98,11 @@ class Usecode_internal : public Usecode_machine {
 	void           show_pending_text();    // Make sure user's seen all text.
 	void           show_book();            // "Say" book/scroll text.
 	void           say_string();           // "Say" the string.
+	void*          native_module = nullptr;    // SDL shared object.
 	Usecode_value* stack;                  // Stack.
 	Usecode_value* sp;                     // Stack ptr.  Grows upwards.
 	void           push(const Usecode_value& val);    // Push/pop stack.
+	void           push(Usecode_value&& val);
 	Usecode_value  pop();
 	Usecode_value  peek();
 	void           pushref(Game_object* obj);    // Push itemref
@@ -508,6 +510,26 @@ public:
 	// Call desired function.
 	int  call_usecode(int id, Game_object* item, Usecode_events event) override;
 	bool call_method(Usecode_value* inst, int id, Game_object* item) override;
+
+	/*
+	 *  Usecode functions compiled to native code.  A module exports
+	 *  'extern "C" void Exult_register_usecode(Usecode_internal*)', which
+	 *  calls set_native_function() for each function it has.  A native
+	 *  function gets the frame with its arguments in the locals, and
+	 *  returns true if it returns a value (in 'ret').
+	 */
+	using Native_function
+			= bool (*)(Usecode_internal* uc, Stack_frame* frame,
+					   Usecode_value& ret);
+	bool load_native_module(const std::string& fname);
+	// Only the function read from the game's usecode gets it, not a patch.
+	void set_native_function(int funcid, Native_function fun);
+	// Run a usecode function to its end, for a native one calling it.
+	Usecode_value call_from_native(
+			int funcid, Stack_frame* frame, const Usecode_value* args,
+			int num_args);
+	Usecode_value call_intrinsic_from_native(
+			int intrinsic, const Usecode_value* args, int num_args);
 	int  find_function(const char* nm, bool noerr = false) override;
 	const char* find_function_name(int funcid) override;
 	void        do_speech(int num) override;    // Start speech, or show text.
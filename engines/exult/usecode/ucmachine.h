@@ -63,6 +63,9 @@ public:
 	friend class Usecode_script;
 	// Create Usecode_internal.
 	static Usecode_machine* create();
+	// Module with usecode functions compiled to native code, to load when
+	//   the machine is created.
+	static void set_native_module(const std::string& fname);
 	Usecode_machine();
 	virtual ~Usecode_machine();
 	// Read in usecode functions.
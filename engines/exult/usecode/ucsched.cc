@@ -37,8 +37,10 @@
 #include "ucscriptop.h"
 #include "useval.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 
 using std::cout;
 using std::endl;
@@ -53,6 +55,168 @@ extern bool intrinsic_trace;
 int             Usecode_script::count = 0;
 Usecode_script* Usecode_script::first = nullptr;
 
+/*
+ *  Runs the started scripts from one time queue entry.  A tick runs all
+ *  the scripts that are due together, so scenes with dozens of scripted
+ *  objects don't fill the time queue.  Due times are kept in the queue's
+ *  game time, so pausing doesn't need to move them.
+ */
+
+class Script_scheduler : public Time_sensitive {
+	struct Entry {
+		uint32          due;    // Game time.
+		uint64          seq;    // Order started, for equal times.
+		Usecode_script* script;
+
+		bool operator<(const Entry& e2) const {
+			if (due != e2.due) {
+				return static_cast<sint32>(due - e2.due) < 0;
+			}
+			return seq < e2.seq;
+		}
+	};
+
+	std::vector<Entry> entries;    // Waiting; sched_slot is the index.
+	std::vector<Entry> ready;      // Being run; sched_slot is -2.
+	uint64             next_seq = 0;
+	uint32             now      = 0;        // Game time of the tick.
+	bool               running  = false;    // In handle_event().
+	uint32             queued_for = 0;      // Game time of our entry.
+	Queue_handle       handle;
+
+	void add(Usecode_script* script, uint32 due);
+	void requeue(uint32 due);
+
+public:
+	void start(Usecode_script* script, long delay);
+
+	// Run it again after 'delay', from handle_event().
+	void again(Usecode_script* script, long delay) {
+		add(script, now + delay);
+	}
+
+	void remove(Usecode_script* script);
+	long find_delay(const Usecode_script* script) const;
+	void handle_event(unsigned long curtime, uintptr udata) override;
+};
+
+static Script_scheduler scheduler;
+
+/*
+ *  Put our entry in the time queue, for game time 'due'.
+ */
+
+void Script_scheduler::requeue(uint32 due) {
+	Game_window* gwin   = Game_window::get_instance();
+	Time_queue*  tqueue = gwin->get_tqueue();
+	if (in_queue()) {
+		tqueue->remove(handle);
+	}
+	queued_for         = due;
+	const uint32 start = tqueue->from_game_time(due, SDL_GetTicks());
+	handle             = tqueue->add(start, this, gwin->get_usecode());
+}
+
+void Script_scheduler::add(Usecode_script* script, uint32 due) {
+	script->sched_slot = static_cast<int>(entries.size());
+	entries.push_back(Entry{due, next_seq++, script});
+	// handle_event() requeues when it's done.
+	if (!running
+		&& (!in_queue() || static_cast<sint32>(due - queued_for) < 0)) {
+		requeue(due);
+	}
+}
+
+/*
+ *  Start running a script after 'delay' msecs.
+ */
+
+void Script_scheduler::start(Usecode_script* script, long delay) {
+	const Time_queue* tqueue = Game_window::get_instance()->get_tqueue();
+	add(script, tqueue->get_game_time(SDL_GetTicks()) + delay);
+}
+
+/*
+ *  Forget a script that's being deleted.
+ */
+
+void Script_scheduler::remove(Usecode_script* script) {
+	const int slot = script->sched_slot;
+	if (slot >= 0) {
+		entries[slot] = entries.back();
+		entries[slot].script->sched_slot = slot;
+		entries.pop_back();
+	} else if (slot == -2) {
+		for (auto& ent : ready) {
+			if (ent.script == script) {
+				ent.script = nullptr;
+			}
+		}
+	}
+	script->sched_slot = -1;
+}
+
+/*
+ *  Output: Msecs. until the script is due, or -1 if it isn't waiting.
+ */
+
+long Script_scheduler::find_delay(const Usecode_script* script) const {
+	if (script->sched_slot == -2) {
+		return 0;
+	}
+	if (script->sched_slot < 0) {
+		return -1;
+	}
+	const Time_queue* tqueue = Game_window::get_instance()->get_tqueue();
+	const sint32      delay  = entries[script->sched_slot].due
+						 - tqueue->get_game_time(SDL_GetTicks());
+	return delay >= 0 ? delay : 0;
+}
+
+/*
+ *  Run the scripts that are due, in the order they are due.
+ */
+
+void Script_scheduler::handle_event(unsigned long curtime, uintptr udata) {
+	const Time_queue* tqueue = Game_window::get_instance()->get_tqueue();
+	const uint32      tick   = tqueue->get_game_time(curtime);
+	if (running) {    // From a script, via the time queue?  Next time.
+		requeue(tick + 1);
+		return;
+	}
+	now = tick;
+	// Take the due ones out first, as running them adds and deletes
+	//   scripts.
+	for (size_t i = 0; i < entries.size();) {
+		if (static_cast<sint32>(entries[i].due - now) > 0) {
+			i++;
+			continue;
+		}
+		ready.push_back(entries[i]);
+		entries[i].script->sched_slot = -2;
+		entries[i]                    = entries.back();
+		entries.pop_back();
+		if (i < entries.size()) {
+			entries[i].script->sched_slot = static_cast<int>(i);
+		}
+	}
+	std::sort(ready.begin(), ready.end());
+	running = true;
+	for (auto& ent : ready) {
+		Usecode_script* script = ent.script;
+		if (script) {    // Not deleted by one run before it?
+			ent.script         = nullptr;
+			script->sched_slot = -1;
+			script->handle_event(curtime, udata);
+		}
+	}
+	ready.clear();
+	running = false;
+	if (!entries.empty()) {
+		requeue(std::min_element(entries.begin(), entries.end())->due);
+	}
+}
+
 /*
  *  Create for a 'restore'.
  */
@@ -97,6 +261,12 @@ Usecode_script::~Usecode_script() {
 	if (!started) {
 		return;
 	}
+	// Scripts are saved with their objects.
+	const Game_object_shared o = obj.lock();
+	if (o) {
+		o->set_ireg_dirty();
+	}
+	scheduler.remove(this);
 	count--;
 	if (next) {
 		next->prev = prev;
@@ -115,8 +285,7 @@ Usecode_script::~Usecode_script() {
 
 void Usecode_script::start(long d    // Start after this many msecs.
 ) {
-	Game_window* gwin = Game_window::get_instance();
-	const int    cnt  = code->get_array_size();    // Check initial elems.
+	const int cnt = code->get_array_size();    // Check initial elems.
 	for (int i = 0; i < cnt; i++) {
 		const int opval0 = code->get_elem(i).get_int_value();
 		if (opval0 == Ucscript::dont_halt) {
@@ -143,10 +312,14 @@ void Usecode_script::start(long d    // Start after this many msecs.
 	}
 	first   = this;
 	started = true;
+	const Game_object_shared o = obj.lock();
+	if (o) {
+		o->set_ireg_dirty();
+	}
 	//++++ Messes up Moonshade Trial.
 	//	gwin->get_tqueue()->add(d + Game::get_ticks(), this,
 	// gwin->get_usecode());
-	gwin->get_tqueue()->add(d + SDL_GetTicks(), this, gwin->get_usecode());
+	scheduler.start(this, d);
 }
 
 /*
@@ -305,6 +478,7 @@ void Usecode_script::handle_event(
 		unsigned long curtime,    // Current time of day.
 		uintptr       udata       // ->usecode machine.
 ) {
+	ignore_unused_variable_warning(curtime);
 	const Game_object_shared o   = obj.lock();
 	Actor*                   act = o ? o->as_actor() : nullptr;
 	if (act && act->get_casting_mode() == Actor::init_casting) {
@@ -319,7 +493,7 @@ void Usecode_script::handle_event(
 #endif
 	const int delay = exec(usecode, false);
 	if (i < cnt) {    // More to do?
-		Usecode_internal::gwin->get_tqueue()->add(curtime + delay, this, udata);
+		scheduler.again(this, delay);
 		return;
 	}
 	if (act && act->get_casting_mode() == Actor::show_casting_frames) {
@@ -768,8 +942,7 @@ void Usecode_script::step(
 
 int Usecode_script::save(ODataSource* out) const {
 	// Get delay to when due.
-	const long when = Game_window::get_instance()->get_tqueue()->find_delay(
-			this, SDL_GetTicks());
+	const long when = scheduler.find_delay(this);
 	if (when < 0) {
 		return -1;
 	}
@@ -28,12 +28,16 @@
 class Game_object;
 class Usecode_value;
 class Usecode_internal;
+class Script_scheduler;
 using Game_object_weak = std::weak_ptr<Game_object>;
 
 /*
- *  A class for executing usecode at a scheduled time:
+ *  A class for executing usecode at a scheduled time.  The started ones
+ *  are run by a single Script_scheduler rather than each being in the
+ *  time queue.
  */
-class Usecode_script : public Time_sensitive {
+class Usecode_script {
+	friend class Script_scheduler;
 	static int             count;          // Total # of these around.
 	static Usecode_script* first;          // ->chain of all of them.
 	Usecode_script *       next, *prev;    // Next/prev. in global chain.
@@ -47,6 +51,7 @@ class Usecode_script : public Time_sensitive {
 	bool must_finish;     // 1 to finish before deleting.
 	bool killed_barks;    // 1 to prevent barks from showing.
 	int  delay;           // Used for restoring.
+	int  sched_slot = -1;    // Where the scheduler has it.
 	// For restore:
 	Usecode_script(
 			Game_object* item, Usecode_value* cd, int findex, int nhalt,
@@ -54,7 +59,7 @@ class Usecode_script : public Time_sensitive {
 
 public:
 	Usecode_script(Game_object* o, Usecode_value* cd = nullptr);
-	~Usecode_script() override;
+	~Usecode_script();
 	void start(long delay = 1);    // Start after 'delay' msecs.
 
 	long get_delay() const {
@@ -100,7 +105,7 @@ public:
 	static void clear();    // Delete all.
 	// Remove all whose objs. are too far.
 	static void purge(const Tile_coord& spot, int dist);
-	void        handle_event(unsigned long curtime, uintptr udata) override;
+	void        handle_event(unsigned long curtime, uintptr udata);
 	int         exec(Usecode_internal* usecode, bool finish);
 	// Move object in given direction.
 	void step(Usecode_internal* usecode, int dir, int dz);
@@ -71,7 +71,8 @@ void Usecode_value::steal_array(Usecode_value& v2) {
 		// Swipe array.
 		construct(arrayval, std::move(v2.arrayval));
 	} else {
-		construct(arrayval, 1, std::move(v2));
+		construct(
+				arrayval, std::make_shared<Usecode_vector>(1, std::move(v2)));
 	}
 }
 
@@ -88,7 +89,7 @@ int Usecode_value::resize(int new_size) {
 		*this = Usecode_value(new_size, &elem);
 		return 1;
 	}
-	arrayval.resize(new_size);
+	writable_array().resize(new_size);
 	return 1;
 }
 
@@ -143,7 +144,7 @@ bool Usecode_value::operator==(const Usecode_value& v2) const {
 			return get_array_size() && get_elem(0) == v2;
 		case array_type: {
 			// On array == array, arrays must be equal.
-			return arrayval == v2.arrayval;
+			return arrayval == v2.arrayval || array() == v2.array();
 		}
 		default:
 			return false;
@@ -169,8 +170,9 @@ int Usecode_value::find_elem(const Usecode_value& val) {
 	if (type != array_type) {
 		return -1;    // Not an array.
 	}
-	for (size_t i = 0; i < arrayval.size(); i++) {
-		if (arrayval[i] == val) {
+	const Usecode_vector& elems = array();
+	for (size_t i = 0; i < elems.size(); i++) {
+		if (elems[i] == val) {
 			return i;
 		}
 	}
@@ -191,11 +193,11 @@ Usecode_value& Usecode_value::concat(
 		Usecode_value tmp(1, this);
 		*this = std::move(tmp);
 	}
+	Usecode_vector& elems = writable_array();
 	if (val2.type != array_type) {    // Appending a single value?
-		arrayval.push_back(val2);
+		elems.push_back(val2);
 	} else {    // Appending an array.
-		arrayval.insert(
-				arrayval.end(), val2.arrayval.cbegin(), val2.arrayval.cend());
+		elems.insert(elems.end(), val2.array().cbegin(), val2.array().cend());
 	}
 	return *this;
 }
@@ -206,7 +208,8 @@ Usecode_value& Usecode_value::concat(
 
 void Usecode_value::append(int* vals, int cnt) {
 	assert(type == array_type);
-	arrayval.insert(arrayval.end(), vals, vals + cnt);
+	Usecode_vector& elems = writable_array();
+	elems.insert(elems.end(), vals, vals + cnt);
 }
 
 /*
@@ -220,20 +223,19 @@ int Usecode_value::add_values(int index, Usecode_value& val2) {
 	const int size = get_array_size();
 	if (!val2.is_array()) {    // Simple case?
 		if (index >= size) {
-			arrayval.push_back(val2);
+			writable_array().push_back(val2);
 		} else {
-			arrayval[index] = val2;
+			writable_array()[index] = val2;
 		}
 		return 1;
 	}
 	// Add each element.
-	const int size2 = val2.get_array_size();
+	const int       size2 = val2.get_array_size();
+	Usecode_vector& elems = writable_array();
 	if (index + size2 > size) {
-		arrayval.resize(index + size2);
+		elems.resize(index + size2);
 	}
-	std::copy(
-			val2.arrayval.cbegin(), val2.arrayval.cend(),
-			arrayval.begin() + index);
+	std::copy(val2.array().cbegin(), val2.array().cend(), elems.begin() + index);
 	return size2;    // Return # added.
 }
 
@@ -276,7 +278,7 @@ void Usecode_value::print(ostream& out, bool shortformat) const {
 		out << '"' << strval << '"';
 		break;
 	case array_type:
-		print_array(arrayval.cbegin(), arrayval.size());
+		print_array(array().cbegin(), array().size());
 		break;
 	case class_sym_type:
 		// TODO: Implement this.
@@ -398,7 +400,7 @@ Usecode_value& Usecode_value::operator%=(const Usecode_value& v2) {
  *  Output: # bytes stored, or -1 if error.
  */
 
-bool Usecode_value::save(ODataSource* out) {
+bool Usecode_value::save(ODataSource* out) const {
 	out->write1(static_cast<int>(type));
 	switch (type) {
 	case int_type:
@@ -422,8 +424,8 @@ bool Usecode_value::save(ODataSource* out) {
 	}
 	case array_type:
 		out->write2(
-				arrayval.size());    // first length, then length Usecode_values
-		for (auto& elem : arrayval) {
+				array().size());    // first length, then length Usecode_values
+		for (const auto& elem : array()) {
 			if (!elem.save(out)) {
 				return false;
 			}
@@ -483,8 +485,8 @@ bool Usecode_value::restore(IDataSource* in) {
 		return true;
 	}
 	case array_type:
-		construct(arrayval, Usecode_vector(in->read2()));
-		for (auto& elem : arrayval) {
+		construct(arrayval, std::make_shared<Usecode_vector>(in->read2()));
+		for (auto& elem : *arrayval) {
 			if (!elem.restore(in)) {
 				return false;
 			}
@@ -29,6 +29,7 @@
 #	include <cstdlib>
 #	include <cstring>
 #	include <iostream>
+#	include <memory>
 #	include <new>
 #	include <string>    // STL string
 #	include <vector>    // STL container
@@ -52,6 +53,10 @@ public:
 	using Usecode_vector = std::vector<Usecode_value>;
 
 private:
+	// Arrays are shared by the values they are copied to, until one of
+	// them changes its array. Short strings are kept inline by std::string.
+	using Array_ptr = std::shared_ptr<Usecode_vector>;
+
 	struct ClassRef {
 		Usecode_value* elems;
 		short          cnt;
@@ -62,7 +67,7 @@ private:
 	union {
 		long                  intval;
 		std::string           strval;
-		Usecode_vector        arrayval;
+		Array_ptr             arrayval;
 		Game_object_shared    ptrval;
 		Usecode_class_symbol* clssym;
 		ClassRef              clsrefval;
@@ -76,7 +81,7 @@ private:
 	void destroy() noexcept {
 		switch (type) {
 		case array_type:
-			arrayval.~Usecode_vector();
+			arrayval.~Array_ptr();
 			break;
 		case string_type:
 			using std::string;
@@ -90,6 +95,19 @@ private:
 		}
 	}
 
+	// The array, for reading.
+	const Usecode_vector& array() const {
+		return *arrayval;
+	}
+
+	// The array, for writing. It is copied first if it is shared.
+	Usecode_vector& writable_array() {
+		if (arrayval.use_count() > 1) {
+			arrayval = std::make_shared<Usecode_vector>(*arrayval);
+		}
+		return *arrayval;
+	}
+
 	template <typename T, typename... U>
 	void construct(T& var, U&&... newval) {
 		new (&var) T(std::forward<U>(newval)...);
@@ -157,9 +175,11 @@ public:
 
 	// Create array with 1st element.
 	Usecode_value(int size, Usecode_value* elem0)
-			: type(array_type), arrayval(size), undefined(false) {
+			: type(array_type),
+			  arrayval(std::make_shared<Usecode_vector>(size)),
+			  undefined(false) {
 		if (elem0) {
-			arrayval[0] = *elem0;
+			(*arrayval)[0] = *elem0;
 		}
 	}
 
@@ -238,7 +258,7 @@ public:
 	Usecode_value& operator%=(const Usecode_value& v2);
 
 	void push_back(int i) {
-		arrayval.emplace_back(i);
+		writable_array().emplace_back(i);
 	}
 
 	// Comparator.
@@ -253,7 +273,7 @@ public:
 	}
 
 	size_t get_array_size() const {    // Get size of array.
-		return (type == array_type) ? arrayval.size() : 0;
+		return (type == array_type) ? array().size() : 0;
 	}
 
 	bool is_array() const {
@@ -289,7 +309,7 @@ public:
 		return (type == string_type)
 					   ? strval.c_str()
 					   : ((undefined
-						   || (type == array_type && arrayval.empty()))
+						   || (type == array_type && array().empty()))
 								  ? emptystr
 								  : nullptr);
 	}
@@ -299,7 +319,7 @@ public:
 		const char* str = get_str_value();
 		return str ? std::atoi(str)
 				   : ((type == array_type && get_array_size())
-							  ? arrayval[0].need_int_value()
+							  ? array()[0].need_int_value()
 							  // Pointer = ref.
 							  : (type == pointer_type
 										 ? (reinterpret_cast<uintptr>(
@@ -310,42 +330,43 @@ public:
 
 	// Add array element. (No checking!)
 	void put_elem(int i, Usecode_value& val) {
-		arrayval[i] = val;
+		writable_array()[i] = val;
 	}
 
 	// Get an array element.
 	Usecode_value& get_elem(int i) {
 		static Usecode_value zval(0);
-		return (type == array_type) ? arrayval[i] : zval;
+		return (type == array_type) ? writable_array()[i] : zval;
 	}
 
 	// Get an array element.
 	const Usecode_value& get_elem(int i) const {
 		static const Usecode_value zval(0);
-		return (type == array_type) ? arrayval[i] : zval;
+		return (type == array_type) ? array()[i] : zval;
 	}
 
 	Usecode_value& operator[](int i) {
 		assert(type == array_type);
-		return arrayval[i];
+		return writable_array()[i];
 	}
 
 	const Usecode_value& operator[](int i) const {
 		assert(type == array_type);
-		return arrayval[i];
+		return array()[i];
 	}
 
 	// Get array elem. 0, or this.
 	Usecode_value& get_elem0() {
 		static Usecode_value zval(0);
-		return (type == array_type) ? (get_array_size() ? arrayval[0] : zval)
+		return (type == array_type)
+					   ? (get_array_size() ? writable_array()[0] : zval)
 									: *this;
 	}
 
 	// Get array elem. 0, or this.
 	const Usecode_value& get_elem0() const {
 		static const Usecode_value zval(0);
-		return (type == array_type) ? (get_array_size() ? arrayval[0] : zval)
+		return (type == array_type) ? (get_array_size() ? array()[0] : zval)
 									: *this;
 	}
 
@@ -354,7 +375,7 @@ public:
 			// Maybe make this an error?
 			return {};
 		}
-		return arrayval.begin();
+		return writable_array().begin();
 	}
 
 	const_iterator begin() const {
@@ -362,7 +383,7 @@ public:
 			// Maybe make this an error?
 			return {};
 		}
-		return arrayval.cbegin();
+		return array().cbegin();
 	}
 
 	const_iterator cbegin() const {
@@ -370,7 +391,7 @@ public:
 			// Maybe make this an error?
 			return {};
 		}
-		return arrayval.cbegin();
+		return array().cbegin();
 	}
 
 	iterator end() {
@@ -378,7 +399,7 @@ public:
 			// Maybe make this an error?
 			return {};
 		}
-		return arrayval.end();
+		return writable_array().end();
 	}
 
 	const_iterator end() const {
@@ -386,7 +407,7 @@ public:
 			// Maybe make this an error?
 			return {};
 		}
-		return arrayval.cend();
+		return array().cend();
 	}
 
 	const_iterator cend() const {
@@ -394,7 +415,7 @@ public:
 			// Maybe make this an error?
 			return {};
 		}
-		return arrayval.cend();
+		return array().cend();
 	}
 
 	void steal_array(Usecode_value& v2);
@@ -406,7 +427,7 @@ public:
 		case pointer_type:
 			return ptrval == nullptr;
 		case array_type:
-			return arrayval.empty();
+			return array().empty();
 		default:
 			return false;
 		}
@@ -431,7 +452,7 @@ public:
 	void print(std::ostream& out, bool shortformat = false)
 			const;    // Print in ASCII.
 	// Save/restore.
-	bool save(ODataSource* out);
+	bool save(ODataSource* out) const;
 	bool restore(IDataSource* in);
 	// Class objects.
 	void class_new(Usecode_class_symbol* cls, int nvars);
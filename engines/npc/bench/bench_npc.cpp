@@ -0,0 +1,464 @@
+/**
+ * bench_npc.cpp - NPC AI Benchmarks
+ *
+ * Builds worlds of synthetic NPCs, with personas, memories, relationships
+ * and AIML categories, at several scales, and times the library's main
+ * paths in each. Results are printed and written as JSON so runs can be
+ * compared as the library changes.
+ *
+ * Usage: bench_npc [--scales 10,100,1000,10000] [--budget seconds]
+ *                  [--out file] [--no-llm]
+ *
+ * A benchmark is skipped at a scale where its time, extrapolated from the
+ * scale before, would exceed the budget.
+ */
+
+#include "NPCSystem.h"
+#include "aiml/HybridDialogue.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Ultima::NPC;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const TOPICS[] = {
+    "sword", "shield", "bread", "ale", "gold", "moongate", "dragon", "ship",
+    "castle", "temple", "virtue", "reagent", "spell", "horse", "map", "storm"
+};
+const size_t TOPIC_COUNT = sizeof(TOPICS) / sizeof(TOPICS[0]);
+
+const Social::InteractionType INTERACTIONS[] = {
+    Social::InteractionType::Greeting, Social::InteractionType::Conversation,
+    Social::InteractionType::Trade, Social::InteractionType::Help,
+    Social::InteractionType::Gift, Social::InteractionType::Insult
+};
+
+struct Options {
+    std::vector<size_t> scales = {10, 100, 1000, 10000};
+    double budget = 30.0;           // Seconds one benchmark may take at one scale
+    double target = 0.5;            // Seconds to spend repeating a fast one
+    std::string out = "bench_npc.json";
+    bool llm = true;
+};
+
+struct Result {
+    std::string name;
+    size_t npcs = 0;
+    size_t iterations = 0;
+    double meanUs = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    bool skipped = false;
+};
+
+/**
+ * Times benchmarks and keeps their results
+ */
+class Bench {
+public:
+    explicit Bench(const Options& options) : options_(options) {}
+
+    /**
+     * Run op until it has run minRuns times and for the target time, or
+     * for the budget
+     * @param growth How its time grows with the NPC count, for skipping
+     */
+    void run(const std::string& name, size_t npcs, double growth,
+             const std::function<void(size_t)>& op, size_t minRuns = 5) {
+        Result result;
+        result.name = name;
+        result.npcs = npcs;
+
+        auto last = last_.find(name);
+        if (last != last_.end()) {
+            const double scale = static_cast<double>(npcs) / last->second.first;
+            const double estimate = last->second.second * std::pow(scale, growth);
+            if (estimate > options_.budget * 1e6) {
+                result.skipped = true;
+                report(result);
+                return;
+            }
+        }
+
+        std::vector<double> times;
+        const auto start = Clock::now();
+        double elapsed = 0.0;
+        while (times.size() < minRuns || elapsed < options_.target) {
+            const auto before = Clock::now();
+            op(times.size());
+            const auto after = Clock::now();
+            times.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+            elapsed = std::chrono::duration<double>(after - start).count();
+            if (elapsed > options_.budget || times.size() >= 100000) {
+                break;
+            }
+        }
+
+        double total = 0.0;
+        for (double t : times) {
+            total += t;
+        }
+        std::sort(times.begin(), times.end());
+        result.iterations = times.size();
+        result.meanUs = total / times.size();
+        result.p50Us = times[times.size() / 2];
+        result.p99Us = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+        last_[name] = {static_cast<double>(npcs), result.meanUs};
+        report(result);
+    }
+
+    void note(const std::string& name, size_t npcs, double ms) {
+        setup_.push_back({name, npcs, ms});
+        std::printf("  %-28s %8zu  %12.1f ms\n", name.c_str(), npcs, ms);
+    }
+
+    bool write(const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out) {
+            return false;
+        }
+        out << "{\n  \"benchmark\": \"bench_npc\",\n  \"version\": 1,\n"
+            << "  \"budget_s\": " << options_.budget << ",\n  \"setup\": [";
+        for (size_t i = 0; i < setup_.size(); ++i) {
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << setup_[i].name
+                << "\", \"npcs\": " << setup_[i].npcs << ", \"ms\": " << setup_[i].ms << "}";
+        }
+        out << "\n  ],\n  \"results\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+                << "\", \"npcs\": " << r.npcs;
+            if (r.skipped) {
+                out << ", \"skipped\": true}";
+                continue;
+            }
+            out << ", \"iterations\": " << r.iterations << ", \"mean_us\": " << r.meanUs
+                << ", \"p50_us\": " << r.p50Us << ", \"p99_us\": " << r.p99Us << "}";
+        }
+        out << "\n  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+private:
+    struct Setup {
+        std::string name;
+        size_t npcs;
+        double ms;
+    };
+
+    const Options& options_;
+    std::vector<Result> results_;
+    std::vector<Setup> setup_;
+    std::map<std::string, std::pair<double, double>> last_;    // npcs, mean us
+
+    void report(const Result& r) {
+        if (r.skipped) {
+            std::printf("  %-28s %8zu  %12s\n", r.name.c_str(), r.npcs, "skipped");
+        } else {
+            std::printf("  %-28s %8zu  %12.2f us  p50 %10.2f  p99 %10.2f  (%zu runs)\n",
+                        r.name.c_str(), r.npcs, r.meanUs, r.p50Us, r.p99Us, r.iterations);
+        }
+        results_.push_back(r);
+    }
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string npcName(size_t i) {
+    return "npc" + std::to_string(i);
+}
+
+// A few categories per NPC, plus some shared by all
+std::string makeAIML(size_t npcs) {
+    std::ostringstream aiml;
+    aiml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aiml version=\"2.0\">\n";
+    auto category = [&](const std::string& pattern, const std::string& reply) {
+        aiml << "<category><pattern>" << pattern << "</pattern><template>" << reply
+             << "</template></category>\n";
+    };
+    category("HELLO", "Greetings, traveller.");
+    category("HELLO *", "Well met.");
+    category("WHAT IS YOUR NAME", "I am <bot name=\"name\"/>.");
+    category("* WEATHER *", "The skies look grey.");
+    category("*", "I know naught of that.");
+    for (size_t t = 0; t < TOPIC_COUNT; ++t) {
+        std::string topic = TOPICS[t];
+        std::transform(topic.begin(), topic.end(), topic.begin(), ::toupper);
+        category("TELL ME ABOUT " + topic, "The " + std::string(TOPICS[t]) + "? A fine thing.");
+        category("WHERE CAN I FIND A " + topic, "Try the market.");
+    }
+    for (size_t i = 0; i < npcs; ++i) {
+        const std::string name = "NPC" + std::to_string(i);
+        category("WHO IS " + name, name + " lives nearby.");
+        category("WHERE IS " + name, "Last I saw, near the docks.");
+        category("TELL ME ABOUT " + name + " *", "Ask " + name + " yourself.");
+        category("_ " + name, "What of " + name + "?");
+    }
+    aiml << "</aiml>\n";
+    return aiml.str();
+}
+
+/**
+ * Every benchmark at one scale
+ */
+void runScale(Bench& bench, const Options& options, size_t npcs) {
+    std::printf("\n%zu NPCs\n", npcs);
+    std::mt19937 rng(static_cast<uint32_t>(npcs));
+    const size_t locationCount = std::max<size_t>(4, npcs / 20);
+
+    // World: personas, memories and relationships
+    auto start = Clock::now();
+    NPCManager manager;
+    manager.initialize("");
+    for (size_t i = 0; i < npcs; ++i) {
+        NPCEntity* npc = manager.createNPC(npcName(i));
+        const std::string location = "loc" + std::to_string(rng() % locationCount);
+        npc->setLocation(location);
+        npc->setActivity("work");
+        Persona::NPCPersona& persona = npc->getPersona();
+        persona.randomize();
+        persona.name = "Name" + std::to_string(i);
+        persona.currentLocation = location;
+
+        Memory::MemorySystem& memory = npc->getMemory();
+        for (uint32_t t = 0; t < 16; ++t) {
+            memory.update(t * 60, 1.0);
+            memory.experienceEvent(TOPICS[rng() % TOPIC_COUNT],
+                                   {npcName(rng() % npcs), "avatar"}, "done",
+                                   (rng() % 200) / 100.0 - 1.0,
+                                   "loc" + std::to_string(rng() % locationCount));
+            if (t % 2 == 0) {
+                memory.learnFact(npcName(rng() % npcs), "lives_in",
+                                 "loc" + std::to_string(rng() % locationCount));
+            }
+        }
+    }
+    for (size_t i = 0; i < npcs && npcs > 1; ++i) {
+        for (int r = 0; r < 4; ++r) {
+            size_t other = rng() % npcs;
+            if (other == i) other = (other + 1) % npcs;
+            manager.processInteraction(npcName(i), npcName(other),
+                                       INTERACTIONS[rng() % 6], 0.5 + (rng() % 50) / 100.0);
+        }
+    }
+    bench.note("setup.world", npcs, msSince(start));
+
+    // AIML
+    start = Clock::now();
+    AIML::AIMLEngine aiml;
+    AIML::AIMLParser parser;
+    for (auto& category : parser.parseString(makeAIML(npcs))) {
+        aiml.getPatternMatcher().addCategory(std::move(category));
+    }
+    bench.note("setup.aiml", npcs, msSince(start));
+
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < 64; ++q) {
+        const std::string name = "npc" + std::to_string(rng() % npcs);
+        const std::string topic = TOPICS[rng() % TOPIC_COUNT];
+        switch (q % 4) {
+            case 0: queries.push_back("Who is " + name); break;
+            case 1: queries.push_back("Tell me about " + topic); break;
+            case 2: queries.push_back("Tell me about " + name + " and the " + topic); break;
+            default: queries.push_back("What do you think of the weather today"); break;
+        }
+    }
+    AIML::SessionContext session;
+    bench.run("aiml.respond", npcs, 0.0, [&](size_t i) {
+        aiml.respond(queries[i % queries.size()], session);
+    });
+
+    // Hybrid dialogue, answered from patterns and by the LLM
+    LLM::NPCContext speaker;
+    speaker.name = "Name0";
+    speaker.occupation = "smith";
+    speaker.personality = "gruff but fair";
+    speaker.currentMood = "calm";
+    speaker.location = "loc0";
+
+    Dialogue::HybridConfig patternsOnly;
+    patternsOnly.aimlConfidenceThreshold = 0.0f;
+    patternsOnly.enableCaching = false;
+    patternsOnly.llmConfig.maxTokens = 16;
+    patternsOnly.llmConfig.threads = 1;
+    Dialogue::HybridDialogueEngine patternEngine;
+    patternEngine.initialize(patternsOnly);
+    for (size_t i = 0; i < npcs; ++i) {
+        patternEngine.addPattern("who is " + npcName(i), npcName(i) + " lives nearby.");
+        patternEngine.addPattern("where is " + npcName(i), "Near the docks, {name} thinks.");
+    }
+    for (size_t t = 0; t < TOPIC_COUNT; ++t) {
+        patternEngine.addPattern(std::string("about ") + TOPICS[t], "A fine thing, says {name}.");
+    }
+    Dialogue::DialogueContext conversation;
+    conversation.npcId = npcName(0);
+    conversation.playerId = "avatar";
+    bench.run("dialogue.hybrid.aiml", npcs, 1.0, [&](size_t i) {
+        patternEngine.generateResponse(queries[i % queries.size()], speaker, conversation);
+    });
+
+    if (options.llm) {
+        Dialogue::HybridConfig withLLM = patternsOnly;
+        withLLM.aimlConfidenceThreshold = 2.0f;     // Never confident enough
+        Dialogue::HybridDialogueEngine llmEngine;
+        if (llmEngine.initialize(withLLM)) {
+            Dialogue::DialogueContext chat;
+            chat.npcId = npcName(0);
+            chat.playerId = "avatar";
+            bench.run("dialogue.hybrid.llm", npcs, 0.0, [&](size_t i) {
+                llmEngine.generateResponse(queries[i % queries.size()], speaker, chat);
+            }, 3);
+        }
+    }
+
+    // Memory search, by entity and by tag
+    bench.run("memory.remember_about", npcs, 0.0, [&](size_t i) {
+        manager.getNPC(npcName(i % npcs))->getMemory().rememberAbout(npcName((i * 7) % npcs));
+    });
+    bench.run("memory.search_tags", npcs, 0.0, [&](size_t i) {
+        Memory::RetrievalCue cue;
+        cue.tags = {TOPICS[i % TOPIC_COUNT], TOPICS[(i + 5) % TOPIC_COUNT]};
+        cue.maxResults = 5;
+        manager.getNPC(npcName(i % npcs))->getMemory().remember(cue);
+    });
+
+    // Rules, matched in full and incrementally
+    std::vector<std::map<std::string, double>> state(npcs);
+    auto ruleSet = std::make_shared<Reasoning::RuleSet>();
+    for (const auto& rule : Reasoning::DefaultRules::getAllDefaultRules()) {
+        ruleSet->addRule(rule);
+    }
+    auto context = std::make_shared<Reasoning::RuleContext>();
+    context->registerStateGetter("", [&](const std::string& npcId, const std::string& key) {
+        const size_t i = std::strtoul(npcId.c_str() + 3, nullptr, 10);
+        auto it = state[i % npcs].find(key);
+        return it == state[i % npcs].end() ? 0.5 : it->second;
+    });
+    context->registerStateSetter("", [&](const std::string& npcId, const std::string& key,
+                                         double value) {
+        state[std::strtoul(npcId.c_str() + 3, nullptr, 10) % npcs][key] = value;
+    });
+    const char* const keys[] = {"health", "hunger", "fatigue", "fear", "anger", "gold"};
+    for (bool incremental : {false, true}) {
+        Reasoning::RuleEngine engine;
+        engine.initialize(ruleSet);
+        engine.setContext(context);
+        engine.setIncrementalMatching(incremental);
+        bench.run(incremental ? "rules.process_incremental" : "rules.process", npcs, 0.0,
+                  [&](size_t i) {
+            const std::string id = npcName(i % npcs);
+            context->setState(id, keys[i % 6], (i * 37 % 100) / 100.0);
+            engine.process(id);
+            engine.update(1);
+        });
+    }
+
+    // World update, a tenth of a second a tick
+    bench.run("manager.update", npcs, 1.0, [&](size_t) {
+        manager.update(0.1);
+    });
+
+    // Social network analysis
+    Social::SocialNetwork& network = manager.getRelationshipSystem().getNetwork();
+    bench.run("social.compute_centrality", npcs, 1.0, [&](size_t) {
+        network.computeCentrality();
+    }, 1);
+    bench.run("social.detect_communities", npcs, 1.0, [&](size_t) {
+        network.detectCommunities();
+    }, 1);
+    bench.run("social.most_influential", npcs, 1.0, [&](size_t) {
+        network.getMostInfluential(10);
+    });
+
+    // City, sized for the population
+    start = Clock::now();
+    Urban::UrbanSimulation urban;
+    urban.initialize();
+    Urban::CityGenerator::Parameters params;
+    params.width = params.height = std::max(32, static_cast<int>(std::sqrt(npcs) * 8));
+    params.initialPopulation = static_cast<int>(npcs);
+    params.seed = 1;
+    auto city = urban.generateCity("bench", params);
+    bench.note("setup.city", npcs, msSince(start));
+    bench.run("city.simulate", npcs, 1.0, [&](size_t) {
+        urban.simulate(1.0);
+    });
+    bench.run("city.find_path", npcs, 1.0, [&](size_t i) {
+        const int w = city->width, h = city->height;
+        city->findPath(static_cast<int>(i * 7) % w, static_cast<int>(i * 13) % h,
+                       static_cast<int>(i * 29) % w, static_cast<int>(i * 31) % h);
+    });
+    bench.run("city.nearest_building", npcs, 1.0, [&](size_t i) {
+        const int x = static_cast<int>(i * 7) % city->width;
+        const int y = static_cast<int>(i * 13) % city->height;
+        city->findNearestBuilding(Urban::BuildingType::Well, x, y);
+        city->findNearestBuilding(Urban::BuildingType::House, x, y);
+    });
+}
+
+std::vector<size_t> parseScales(const std::string& list) {
+    std::vector<size_t> scales;
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const size_t scale = std::strtoul(item.c_str(), nullptr, 10);
+        if (scale > 0) {
+            scales.push_back(scale);
+        }
+    }
+    return scales;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--scales" && hasValue) {
+            options.scales = parseScales(argv[++i]);
+        } else if (arg == "--budget" && hasValue) {
+            options.budget = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (arg == "--no-llm") {
+            options.llm = false;
+        } else {
+            std::cerr << "Usage: bench_npc [--scales 10,100,1000,10000] [--budget seconds]\n"
+                      << "                 [--out file] [--no-llm]\n";
+            return 1;
+        }
+    }
+    if (options.scales.empty()) {
+        std::cerr << "bench_npc: no scales to run\n";
+        return 1;
+    }
+
+    Bench bench(options);
+    for (size_t npcs : options.scales) {
+        runScale(bench, options, npcs);
+    }
+    if (!bench.write(options.out)) {
+        std::cerr << "bench_npc: cannot write " << options.out << "\n";
+        return 1;
+    }
+    std::cout << "\nResults written to " << options.out << "\n";
+    return 0;
+}
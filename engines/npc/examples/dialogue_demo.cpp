@@ -154,7 +154,8 @@ int main() {
         std::cout << "LLM responses: " << stats.llmResponses << "\n";
         std::cout << "Hybrid responses: " << stats.hybridResponses << "\n";
         std::cout << "Fallback responses: " << stats.fallbackResponses << "\n";
-        std::cout << "Cache hits: " << stats.cacheHits << "\n";
+        std::cout << "Cache hits: " << stats.cacheHits << " ("
+                  << engine.getCacheStats().total.hitRatio() * 100.0 << "%)\n";
         std::cout << "Avg processing time: " << stats.avgProcessingTimeMs << "ms\n";
     }
 
@@ -28,6 +28,7 @@
 
 // Phase 5: Urban Dynamics
 #include "urban/UrbanDynamics.h"
+#include "simulation/Scheduler.h"
 
 #include <memory>
 #include <string>
@@ -49,7 +50,7 @@ public:
 
     // Subsystem access
     Persona::NPCPersona& getPersona() { return *persona_; }
-    Memory::MemorySystem& getMemory() { return *memory_; }
+    Memory::MemorySystem& getMemory();     // Reads deserialized memories
     Neural::NPCLearningNetwork& getLearning() { return *learning_; }
     Economy::EconomicAgent& getEconomicAgent() { return *economicAgent_; }
 
@@ -62,9 +63,23 @@ public:
     void setLocation(const std::string& location) { currentLocation_ = location; }
     void setActivity(const std::string& activity) { currentActivity_ = activity; }
 
-    // Update
+    // Update. NPCManager runs update(), decay() and consolidate() for
+    // different NPCs on different threads, so they may only touch the
+    // NPC's own state.
     void update(double deltaTime);
 
+    /**
+     * Slow decay of emotions, mood, memories and goals. Decay compounds,
+     * so it can be applied to the time since the last call rather than
+     * every tick.
+     */
+    void decay(double deltaTime, uint32_t currentTime);
+
+    /**
+     * Consolidate long-term memories
+     */
+    void consolidate(uint32_t currentTime);
+
     // Dialogue
     std::string respondToDialogue(const std::string& input);
 
@@ -84,8 +99,18 @@ public:
     Persona::EmotionalState& getEmotionalState();
     const Persona::EmotionalState& getEmotionalState() const;
     
-    // Serialization
-    std::string serialize() const;
+    /**
+     * Serialize as a binary archive (see persistence/Archive.h), with the
+     * state, persona, memories and learned weights each in a section
+     * @param compress Deflate it, if compression is available
+     */
+    std::string serialize(bool compress = true) const;
+
+    /**
+     * Restore from serialize(). Memories are only read when getMemory()
+     * is first called; until then they neither decay nor consolidate.
+     * @return false, leaving the NPC as it was, if the data is damaged
+     */
     bool deserialize(const std::string& data);
 
 private:
@@ -100,6 +125,8 @@ private:
     std::unique_ptr<Neural::NPCLearningNetwork> learning_;
     std::unique_ptr<Economy::EconomicAgent> economicAgent_;
     std::unique_ptr<AIML::SessionContext> dialogueContext_;
+
+    std::string pendingMemories_;   // Memory section not yet read, if any
 };
 
 /**
@@ -130,6 +157,17 @@ public:
      */
     void removeNPC(const std::string& id);
 
+    /**
+     * Take over an NPC built elsewhere, replacing any with its ID
+     */
+    NPCEntity* addNPC(std::unique_ptr<NPCEntity> npc);
+
+    /**
+     * Remove an NPC without destroying it, e.g. to archive it
+     * @return nullptr if there is none with that ID
+     */
+    std::unique_ptr<NPCEntity> releaseNPC(const std::string& id);
+
     /**
      * Get all NPC IDs
      */
@@ -142,9 +180,42 @@ public:
 
     /**
      * Update all NPCs
+     * Each NPC is updated as often as its importance asks, catching up on
+     * the time since its last update. Slow decay runs on a rotating slice
+     * of the population, DECAY_SLICES ticks apart for each NPC, and
+     * consolidation every CONSOLIDATION_INTERVAL seconds as part of it.
+     * The NPCs are shared out between the job system's threads. Systems shared
+     * between NPCs are run afterwards by the scheduler, each at its own
+     * rate: relationships every tick, the economy hourly and towns daily.
      */
     void update(double deltaTime);
 
+    /**
+     * Set how much an NPC matters to the player, from 0 to 1 (the
+     * default). See importanceOf().
+     */
+    void setImportance(const std::string& id, double importance);
+    double getImportance(const std::string& id) const;
+
+    /**
+     * Importance of an NPC this far from the avatar, in tiles: 1 in
+     * conversation or close by, halving every NEAR_DISTANCE tiles further
+     */
+    static double importanceOf(double distance, bool inConversation);
+
+    /**
+     * Seconds between updates of an NPC of this importance, 0 for every tick
+     */
+    static double updatePeriod(double importance);
+
+    /**
+     * Run the job system, which everything else shares too, on this many
+     * threads, the calling one included
+     * @param threads 0 for one per core
+     */
+    void setWorkerThreads(int threads);
+    int getWorkerThreads() const;
+
     /**
      * Process NPC interaction
      */
@@ -159,9 +230,11 @@ public:
     Economy::EconomicSystem& getEconomicSystem() { return *economicSystem_; }
     Reasoning::RuleEngine& getRuleEngine() { return *ruleEngine_; }
     Urban::UrbanSimulation& getUrbanSimulation() { return *urbanSimulation_; }
+    Simulation::Scheduler& getScheduler() { return scheduler_; }
 
     /**
-     * Save/load world state
+     * Save/load world state: the world clock and every NPC. Loading
+     * replaces all NPCs, unless the file can't be read.
      */
     bool saveWorld(const std::string& filename) const;
     bool loadWorld(const std::string& filename);
@@ -174,8 +247,36 @@ public:
     double getAverageWealth() const;
 
 private:
+    static constexpr size_t DECAY_SLICES = 8;
+    static constexpr double CONSOLIDATION_INTERVAL = 60.0;
+    static constexpr double NEAR_DISTANCE = 16.0;
+    static constexpr double ECONOMY_PERIOD = 3600.0;        // A market tick an hour
+    static constexpr double URBAN_PERIOD = 86400.0;         // Towns grow by the day
+
+    // What one NPC does this tick
+    struct UpdateJob {
+        NPCEntity* npc;
+        double updateTime;          // 0 to skip
+        double decayTime;           // Likewise
+        bool consolidate;
+    };
+
     std::map<std::string, std::unique_ptr<NPCEntity>> npcs_;
 
+    // Update schedule, by slot
+    std::vector<NPCEntity*> slots_;
+    std::vector<double> importance_;
+    std::vector<double> pendingUpdate_;         // Time not yet updated
+    std::vector<double> pendingDecay_;          // Time not yet decayed
+    std::vector<double> sinceConsolidation_;
+    size_t decayCursor_ = 0;
+    double worldTime_ = 0.0;
+
+    std::vector<UpdateJob> jobs_;
+
+    size_t slotOf(const std::string& id) const;
+    static void runJob(const UpdateJob& job, uint32_t currentTime);
+
     // Shared systems
     std::unique_ptr<AIML::AIMLEngine> aimlEngine_;
     std::unique_ptr<AIML::NPCDialogueManager> dialogueManager_;
@@ -187,6 +288,7 @@ private:
     std::unique_ptr<Reasoning::ReasoningSystem> reasoningSystem_;
     std::unique_ptr<Urban::UrbanSimulation> urbanSimulation_;
     std::unique_ptr<Persona::PersonaFactory> personaFactory_;
+    Simulation::Scheduler scheduler_;
 
     void initializeSubsystems(const std::string& dataDirectory);
     void setupRuleContext();
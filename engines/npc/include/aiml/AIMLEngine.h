@@ -11,7 +11,11 @@
 #ifndef ULTIMA_NPC_AIML_ENGINE_H
 #define ULTIMA_NPC_AIML_ENGINE_H
 
+#include "aiml/BrainFile.h"
+#include <cstdint>
+#include <deque>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include <memory>
@@ -99,6 +103,18 @@ struct MatchResult {
     double confidence = 0.0;            // Match confidence score
 };
 
+/**
+ * Text made ready for matching by PatternMatcher::tokenize(): substituted,
+ * stripped of punctuation, and each word looked up in the matcher's
+ * vocabulary
+ */
+struct TokenizedInput {
+    std::vector<uint32_t> ids;      // Of each word, in the matcher's vocabulary
+    std::string text;               // The words, one space apart, for stars
+    std::vector<uint32_t> starts;   // Of each word in text
+    std::string word;               // Scratch
+};
+
 /**
  * Session context for conversation
  */
@@ -118,6 +134,12 @@ struct SessionContext {
     int metacogLevel = 0;
     double cognitiveLoad = 0.0;
     std::string currentReasoning;
+
+    // Input, <that> and topic of the last match, kept so that matching
+    // reuses their buffers
+    TokenizedInput inputTokens;
+    TokenizedInput thatTokens;
+    TokenizedInput topicTokens;
 };
 
 /**
@@ -166,6 +188,13 @@ private:
 
 /**
  * Pattern Matcher - Graphmaster-style pattern matching
+ *
+ * Categories are stored in a trie keyed by the words of the pattern, then
+ * the <that> pattern, then the topic, so a match only visits the branches
+ * the input can follow. At each word the branches are tried in AIML order
+ * of priority: _, the word itself, ^, then *. The first category reached
+ * wins, and of categories with the same path, the one of highest priority.
+ * A <that> or topic pattern left out matches anything.
  */
 class PatternMatcher {
 public:
@@ -175,7 +204,7 @@ public:
     /**
      * Add category to pattern graph
      */
-    void addCategory(const Category& category);
+    void addCategory(Category category);
 
     /**
      * Find best matching category
@@ -184,6 +213,25 @@ public:
                      const std::string& that = "",
                      const std::string& topic = "") const;
 
+    /**
+     * Find best matching category for text already tokenized. Tokens
+     * must be remade once categories have been added.
+     */
+    MatchResult match(const TokenizedInput& input,
+                      const TokenizedInput& that,
+                      const TokenizedInput& topic) const;
+
+    /**
+     * Make text ready for matching, reusing the buffers in tokens
+     */
+    void tokenize(const std::string& text, TokenizedInput& tokens) const;
+
+    /**
+     * Replace a word of the input, whatever its case or punctuation, with
+     * others before matching, such as "DON'T" with "do not"
+     */
+    void addSubstitution(const std::string& word, const std::string& replacement);
+
     /**
      * Get all matches above threshold
      */
@@ -200,19 +248,33 @@ public:
      */
     size_t getPatternCount() const { return categories_.size(); }
 
+    /**
+     * Every category, in the order added
+     */
+    const std::deque<Category>& getCategories() const { return categories_; }
+
 private:
-    std::vector<Category> categories_;
+    std::deque<Category> categories_;  // Stays put for the graph's pointers
+
+    // Every word in a pattern, numbered
+    std::unordered_map<std::string, uint32_t> vocabulary_;
+    static constexpr uint32_t UNKNOWN_WORD = 0xFFFFFFFF;
+    std::unordered_map<std::string, std::string> substitutions_;  // Upper-case words
+
+    uint32_t intern(const std::string& word);
 
     // Graphmaster node structure
     struct GraphNode {
-        std::map<std::string, std::unique_ptr<GraphNode>> children;
-        std::vector<const Category*> categories;
+        std::unordered_map<uint32_t, std::unique_ptr<GraphNode>> children;  // Words
+        std::unique_ptr<GraphNode> one;         // _
+        std::unique_ptr<GraphNode> zeroOrMore;  // ^
+        std::unique_ptr<GraphNode> oneOrMore;   // *
+        std::unique_ptr<GraphNode> next;        // Start of the <that>, then topic
+        std::vector<const Category*> categories;    // Whose path ends here
     };
     std::unique_ptr<GraphNode> root_;
 
-    double calculateMatchScore(const std::vector<PatternElement>& pattern,
-                              const std::vector<std::string>& words,
-                              std::vector<std::string>& captures) const;
+    struct Search;
 };
 
 /**
@@ -340,10 +402,27 @@ public:
 
     /**
      * Load AIML file(s)
+     *
+     * loadDirectory() loads the directory's brain (BrainFile::DEFAULT_NAME)
+     * instead when it was compiled from exactly the files there as they
+     * are now.
      */
     bool loadFile(const std::string& filename);
     bool loadDirectory(const std::string& directory, const std::string& pattern = "*.aiml");
 
+    /**
+     * Save every category, with the AIML files they were loaded from, as a
+     * compiled brain
+     */
+    bool saveBrain(const std::string& filename) const;
+
+    /**
+     * Load a compiled brain
+     * @return false, loading nothing, if the brain is missing, broken or
+     *         stale
+     */
+    bool loadBrain(const std::string& filename);
+
     /**
      * Process input and generate response
      */
@@ -393,6 +472,7 @@ public:
 private:
     AIMLParser parser_;
     PatternMatcher matcher_;
+    std::vector<BrainFile::Source> sources_;    // AIML files loaded
     TemplateProcessor processor_;
     KnowledgeBase knowledgeBase_;
     BotProperties botProps_;
@@ -0,0 +1,80 @@
+/**
+ * BrainFile.h - Compiled AIML Brains
+ *
+ * A brain holds every category of a set of AIML files, already parsed, so
+ * an engine starts with one read of one file instead of parsing XML. It
+ * records the size and modification time of each file it was compiled
+ * from, and is refused once any of them changes.
+ *
+ * Layout, little-endian:
+ *   Header      "AIMB", version, string, source and category counts
+ *   Strings     Every distinct word, value, attribute and path, once,
+ *               each as a length then the bytes
+ *   Sources     Path, size and modification time of each AIML file
+ *   Categories  Pattern, <that>, topic, priority, source file and line,
+ *               then the template tree. Strings are given by number.
+ */
+
+#ifndef ULTIMA_NPC_AIML_BRAIN_FILE_H
+#define ULTIMA_NPC_AIML_BRAIN_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Ultima {
+namespace NPC {
+namespace AIML {
+
+struct Category;
+class PatternMatcher;
+
+class BrainFile {
+public:
+    /**
+     * Name of the brain loadDirectory() looks for in an AIML directory
+     */
+    static constexpr const char* DEFAULT_NAME = "brain.aimlb";
+
+    /**
+     * An AIML file a brain was compiled from
+     */
+    struct Source {
+        std::string path;
+        uint64_t size = 0;
+        int64_t modified = 0;   // Filesystem clock ticks
+
+        /**
+         * The file as it is now, or an empty path if it can't be found
+         */
+        static Source of(const std::string& path);
+
+        /**
+         * Whether the file is still the one compiled
+         */
+        bool isCurrent() const;
+    };
+
+    /**
+     * Write the categories of a matcher as a brain
+     * @param sources The AIML files they came from
+     */
+    static bool write(const std::string& filename,
+                      const std::vector<Source>& sources,
+                      const PatternMatcher& matcher);
+
+    /**
+     * Read a brain
+     * @return false if it can't be read, isn't a brain of this version, or
+     *         is stale
+     */
+    static bool read(const std::string& filename,
+                     std::vector<Source>& sources,
+                     std::vector<Category>& categories);
+};
+
+} // namespace AIML
+} // namespace NPC
+} // namespace Ultima
+
+#endif // ULTIMA_NPC_AIML_BRAIN_FILE_H
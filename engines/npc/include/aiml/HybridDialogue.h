@@ -17,6 +17,7 @@
 #include "llm/TinyLLM.h"
 #include "reasoning/TensorLogic.h"
 #include "persona/Persona.h"
+#include <cstdint>
 #include <memory>
 #include <functional>
 
@@ -115,6 +116,86 @@ struct HybridConfig {
     };
 };
 
+/**
+ * ResponseCache - Least recently used cache of NPC responses
+ *
+ * Entries are keyed by a 64-bit hash of the NPC, the normalized input and
+ * whatever context shapes the answer. The cache is split into shards,
+ * each with its own lock and recency list, so dialogue workers on several
+ * threads can share one cache. A full shard drops its least recently used
+ * entry.
+ */
+class ResponseCache {
+public:
+    /**
+     * Lookups and evictions, for one NPC or for the whole cache
+     */
+    struct Counters {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;     // Of entries for the NPC
+        
+        double hitRatio() const {
+            return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+        }
+    };
+    
+    struct Stats {
+        Counters total;
+        size_t size = 0;
+        size_t capacity = 0;
+        std::unordered_map<std::string, Counters> byNPC;
+    };
+    
+    /**
+     * @param capacity Most entries held
+     * @param shards Number of independently locked parts
+     */
+    explicit ResponseCache(size_t capacity = 1000, size_t shards = 16);
+    ~ResponseCache();
+    
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+    
+    /**
+     * Key for an NPC's answer to an input. The input is compared ignoring
+     * case, punctuation and spacing.
+     * @param context Anything else the answer depends on, such as mood
+     */
+    static uint64_t makeKey(const std::string& npcId, const std::string& input,
+                            const std::string& context = "");
+    
+    /**
+     * Look up an answer, making it the most recently used
+     * @return false if it isn't cached
+     */
+    bool get(const std::string& npcId, uint64_t key, std::string& response);
+    
+    /**
+     * Cache an answer, replacing any with the same key
+     */
+    void put(const std::string& npcId, uint64_t key, const std::string& response);
+    
+    /**
+     * Change the capacity, dropping the least recently used entries that
+     * no longer fit
+     */
+    void setCapacity(size_t capacity);
+    
+    /**
+     * Drop every entry, keeping the statistics
+     */
+    void clear();
+    
+    Stats getStats() const;
+
+private:
+    struct Shard;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    
+    Shard& shardFor(uint64_t key) const;
+};
+
 /**
  * HybridDialogueEngine - Main dialogue generation system
  * 
@@ -182,6 +263,8 @@ public:
         int hybridResponses = 0;
         int fallbackResponses = 0;
         int cacheHits = 0;
+        int cacheMisses = 0;
+        int cacheEvictions = 0;
         int consistencyFailures = 0;
         double avgProcessingTimeMs = 0.0;
     };
@@ -192,6 +275,17 @@ public:
      */
     void clearCache();
     
+    /**
+     * Cache statistics, including each NPC's
+     */
+    ResponseCache::Stats getCacheStats() const;
+    
+    /**
+     * The response cache, which other engines can be given to share
+     */
+    std::shared_ptr<ResponseCache> getCache() const;
+    void setCache(std::shared_ptr<ResponseCache> cache);
+    
     /**
      * Update configuration
      */
@@ -215,8 +309,8 @@ private:
     float scoreAIMLResponse(const std::string& response, const std::string& input);
     std::string combineResponses(const std::string& aiml, const std::string& llm, float aimlScore);
     std::string applyPersonality(const std::string& response, const LLM::NPCContext& ctx);
-    std::string getCachedResponse(const std::string& key);
-    void cacheResponse(const std::string& key, const std::string& response);
+    bool getCachedResponse(const std::string& npcId, uint64_t key, std::string& response);
+    void cacheResponse(const std::string& npcId, uint64_t key, const std::string& response);
 };
 
 /**
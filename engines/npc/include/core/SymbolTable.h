@@ -0,0 +1,109 @@
+/**
+ * SymbolTable.h - Interned Strings
+ *
+ * Ids, tags and names are strings at the API, but every system keying a
+ * map by them would hash, compare and copy the same few strings over and
+ * over. Interned once in the shared table, each string becomes a 32-bit
+ * Symbol: cheap to hash, compare and store, and the same in every system.
+ * Symbols last as long as the program.
+ */
+
+#ifndef ULTIMA_NPC_CORE_SYMBOL_TABLE_H
+#define ULTIMA_NPC_CORE_SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Ultima {
+namespace NPC {
+
+/**
+ * Handle to an interned string; the default one stands for no string
+ */
+class Symbol {
+public:
+    constexpr Symbol() = default;
+    constexpr explicit Symbol(uint32_t value) : value_(value) {}
+
+    constexpr uint32_t value() const { return value_; }
+    constexpr bool valid() const { return value_ != 0; }
+
+    constexpr bool operator==(Symbol other) const { return value_ == other.value_; }
+    constexpr bool operator!=(Symbol other) const { return value_ != other.value_; }
+    constexpr bool operator<(Symbol other) const { return value_ < other.value_; }
+
+private:
+    uint32_t value_ = 0;
+};
+
+/**
+ * Key for a pair of symbols, in order or either way round
+ */
+constexpr uint64_t pairKey(Symbol first, Symbol second) {
+    return (static_cast<uint64_t>(first.value()) << 32) | second.value();
+}
+
+constexpr uint64_t unorderedPairKey(Symbol a, Symbol b) {
+    return a < b ? pairKey(a, b) : pairKey(b, a);
+}
+
+/**
+ * Strings by symbol and back. Safe to use from several threads at once.
+ */
+class SymbolTable {
+public:
+    /**
+     * The table shared by the whole library
+     */
+    static SymbolTable& global();
+
+    /**
+     * Symbol for a string, interning it if it's new
+     */
+    Symbol intern(std::string_view name);
+
+    /**
+     * Symbol for a string if it's been interned, otherwise no symbol, so a
+     * lookup can't grow the table
+     */
+    Symbol find(std::string_view name) const;
+
+    /**
+     * String of a symbol; empty for no symbol
+     */
+    const std::string& name(Symbol symbol) const;
+
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> names_;                         // By value - 1
+    std::unordered_map<std::string_view, uint32_t> values_; // Views into names_
+};
+
+/**
+ * Shorthands for the shared table
+ */
+inline Symbol intern(std::string_view name) { return SymbolTable::global().intern(name); }
+inline Symbol findSymbol(std::string_view name) { return SymbolTable::global().find(name); }
+
+} // namespace NPC
+} // namespace Ultima
+
+namespace std {
+
+template <>
+struct hash<Ultima::NPC::Symbol> {
+    size_t operator()(Ultima::NPC::Symbol symbol) const noexcept {
+        return hash<uint32_t>()(symbol.value());
+    }
+};
+
+} // namespace std
+
+#endif // ULTIMA_NPC_CORE_SYMBOL_TABLE_H
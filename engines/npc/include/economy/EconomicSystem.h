@@ -15,11 +15,17 @@
 
 #include <string>
 #include <vector>
+#include <array>
+#include <deque>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <memory>
 #include <optional>
 #include <functional>
+#include <iterator>
 #include <cfloat>
+#include <cstdint>
 
 namespace Ultima {
 namespace NPC {
@@ -64,6 +70,8 @@ enum class ResourceType {
     Custom
 };
 
+constexpr size_t RESOURCE_TYPE_COUNT = static_cast<size_t>(ResourceType::Custom) + 1;
+
 /**
  * Resource/Item
  */
@@ -112,6 +120,13 @@ public:
     bool has(const std::string& resourceId, double minQuantity = 1.0) const;
     bool hasType(ResourceType type, double minQuantity = 1.0) const;
 
+    /**
+     * Total quantity held of a type
+     */
+    double getQuantity(ResourceType type) const {
+        return typeQuantities_[static_cast<size_t>(type)];
+    }
+
     /**
      * Get resource
      */
@@ -141,10 +156,11 @@ public:
 private:
     double maxCapacity_;
     std::map<std::string, Resource> resources_;
+    std::array<double, RESOURCE_TYPE_COUNT> typeQuantities_{};
 };
 
 /**
- * Market listing
+ * Market listing, an offer to sell; prices are per unit
  */
 struct MarketListing {
     std::string id;
@@ -152,11 +168,51 @@ struct MarketListing {
     Resource resource;
     double askingPrice;
     double minPrice;                // Won't sell below this
-    uint32_t listedTime;
-    uint32_t expirationTime;
+    uint32_t listedTime = 0;
+    uint32_t expirationTime = 0;    // 0 for never
     bool isActive = true;
 };
 
+/**
+ * Market bid, an offer to buy up to a quantity of a type at no more than
+ * maxPrice a unit
+ */
+struct MarketBid {
+    std::string id;
+    std::string buyerId;
+    ResourceType type;
+    double quantity;
+    double maxPrice;
+    uint32_t placedTime = 0;
+    uint32_t expirationTime = 0;    // 0 for never
+};
+
+/**
+ * Open orders for one resource type in price order, orders at the same
+ * price in the order they arrived
+ */
+struct OrderBook {
+    struct Key {
+        double price;
+        uint64_t sequence;
+    };
+    struct Cheapest {
+        bool operator()(const Key& a, const Key& b) const {
+            return a.price != b.price ? a.price < b.price : a.sequence < b.sequence;
+        }
+    };
+    struct Dearest {
+        bool operator()(const Key& a, const Key& b) const {
+            return a.price != b.price ? a.price > b.price : a.sequence < b.sequence;
+        }
+    };
+
+    std::map<Key, MarketListing, Cheapest> asks;
+    std::map<Key, MarketBid, Dearest> bids;
+    double askQuantity = 0.0;
+    double bidQuantity = 0.0;
+};
+
 /**
  * Trade offer
  */
@@ -184,12 +240,100 @@ struct Transaction {
     std::string buyerId;
     std::string sellerId;
     std::string resourceId;
+    ResourceType type = ResourceType::Custom;
     double quantity;
-    double price;
+    double price;                   // Per unit
     uint32_t timestamp;
     std::string location;
 };
 
+/**
+ * A day's trading in one resource type
+ */
+struct PriceDay {
+    uint32_t day;                   // Timestamp / PriceHistory::DAY_LENGTH
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume = 0.0;            // Quantity traded
+    double value = 0.0;             // Gold traded
+    uint32_t trades = 0;
+};
+
+/**
+ * Price statistics for one resource type in constant memory. The latest
+ * transactions are kept in a ring alongside running totals, so windowed
+ * means, VWAP and volatility cost the same however long the market has
+ * run; earlier trading survives only as daily open/high/low/close.
+ */
+class PriceHistory {
+public:
+    static constexpr size_t WINDOW = 64;            // Transactions kept
+    static constexpr size_t DAYS = 30;              // Days kept
+    static constexpr uint32_t DAY_LENGTH = 86400;   // Timestamp units a day
+    static constexpr double EMA_WEIGHT = 0.1;       // Of each new price
+
+    void add(const Transaction& transaction);
+
+    /**
+     * Transactions kept, and one by age, 0 the latest
+     */
+    size_t size() const { return count_; }
+    const Transaction& recent(size_t age) const;
+
+    /**
+     * Mean price of the latest count transactions
+     */
+    double mean(size_t count = WINDOW) const;
+
+    /**
+     * Volume-weighted average price over the transactions kept
+     */
+    double vwap() const;
+
+    /**
+     * Standard deviation of price over the transactions kept, relative to
+     * their mean
+     */
+    double volatility() const;
+
+    /**
+     * Exponential moving average of price over every transaction
+     */
+    double ema() const { return ema_; }
+
+    const std::deque<PriceDay>& days() const { return days_; }
+
+private:
+    struct Totals {
+        double price = 0.0;
+        double squares = 0.0;
+        double value = 0.0;
+        double quantity = 0.0;
+    };
+
+    // Ring of transactions, each with the running totals from before it
+    std::vector<Transaction> transactions_;
+    std::vector<Totals> before_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+    Totals totals_;
+    double ema_ = 0.0;
+    std::deque<PriceDay> days_;
+
+    size_t slot(size_t age) const { return (next_ + WINDOW - 1 - age) % WINDOW; }
+    Totals latest(size_t count) const;
+};
+
+/**
+ * A matched bid and listing, for the buyer and seller to settle
+ */
+struct Trade {
+    Transaction transaction;
+    Resource resource;              // What changes hands, as much as traded
+};
+
 /**
  * Market
  */
@@ -202,13 +346,68 @@ public:
     std::string location;
     std::string name;
 
+    /**
+     * Listings viewed in place, by type, cheapest first within a type.
+     * Valid until the market next changes.
+     */
+    class ListingRange {
+    public:
+        using Books = std::map<ResourceType, OrderBook>;
+        using Asks = std::map<OrderBook::Key, MarketListing, OrderBook::Cheapest>;
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = MarketListing;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const MarketListing*;
+            using reference = const MarketListing&;
+
+            const_iterator() = default;
+            const_iterator(Books::const_iterator book, Books::const_iterator bookEnd);
+
+            reference operator*() const { return listing_->second; }
+            pointer operator->() const { return &listing_->second; }
+            const_iterator& operator++();
+            const_iterator operator++(int) {
+                const_iterator old = *this;
+                ++*this;
+                return old;
+            }
+            bool operator==(const const_iterator& other) const {
+                return book_ == other.book_ && (book_ == bookEnd_ || listing_ == other.listing_);
+            }
+            bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+        private:
+            Books::const_iterator book_;
+            Books::const_iterator bookEnd_;
+            Asks::const_iterator listing_;
+
+            void skipEmptyBooks();
+        };
+
+        ListingRange(Books::const_iterator first, Books::const_iterator last)
+            : first_(first), last_(last) {}
+
+        const_iterator begin() const { return const_iterator(first_, last_); }
+        const_iterator end() const { return const_iterator(last_, last_); }
+        bool empty() const { return begin() == end(); }
+
+    private:
+        Books::const_iterator first_;
+        Books::const_iterator last_;
+    };
+
     /**
      * List item for sale
+     * @param expirationTime When it's withdrawn if unsold, 0 for never
      */
     std::string listItem(const std::string& sellerId,
                         const Resource& resource,
                         double askingPrice,
-                        double minPrice = 0.0);
+                        double minPrice = 0.0,
+                        uint32_t expirationTime = 0);
 
     /**
      * Remove listing
@@ -216,9 +415,21 @@ public:
     void removeListing(const std::string& listingId);
 
     /**
-     * Get listings
+     * Place a bid, matched against listings at the next update
+     */
+    std::string placeBid(const std::string& buyerId, ResourceType type,
+                         double quantity, double maxPrice,
+                         uint32_t expirationTime = 0);
+
+    /**
+     * Cancel bid
      */
-    std::vector<MarketListing> getListings(ResourceType type = ResourceType::Custom) const;
+    void cancelBid(const std::string& bidId);
+
+    /**
+     * Get listings, of every type for Custom
+     */
+    ListingRange getListings(ResourceType type = ResourceType::Custom) const;
     std::vector<MarketListing> getListingsBySeller(const std::string& sellerId) const;
 
     /**
@@ -227,6 +438,11 @@ public:
     std::optional<MarketListing> findBestPrice(ResourceType type,
                                                double maxPrice = DBL_MAX) const;
 
+    /**
+     * Highest bid for a type, if any
+     */
+    const MarketBid* getBestBid(ResourceType type) const;
+
     /**
      * Execute purchase
      */
@@ -235,20 +451,28 @@ public:
                         double offeredPrice);
 
     /**
-     * Get price history
+     * Get price history, latest first, from the transactions kept
      */
     std::vector<Transaction> getPriceHistory(const std::string& resourceId,
                                              int maxRecords = 100) const;
 
     /**
-     * Get average price
+     * Get average price of a type's latest transactions
      */
     double getAveragePrice(ResourceType type, int recentCount = 10) const;
 
     /**
-     * Update market (decay old listings)
+     * Price statistics for a type, or nullptr if it has never traded
      */
-    void update(uint32_t currentTime);
+    const PriceHistory* getPriceStatistics(ResourceType type) const;
+
+    /**
+     * Update market: withdraw expired orders, then match each type's bids
+     * against its listings, best prices first, until they no longer
+     * cross. A match trades at the price of whichever order came first.
+     * @return The trades made, to be settled
+     */
+    std::vector<Trade> update(uint32_t currentTime);
 
     /**
      * Market statistics
@@ -258,13 +482,28 @@ public:
     double getPriceVolatility(ResourceType type) const;
 
 private:
-    std::map<std::string, MarketListing> listings_;
-    std::vector<Transaction> transactions_;
+    // Where an order is in the books
+    struct OrderRef {
+        ResourceType type;
+        OrderBook::Key key;
+        bool isBid;
+        uint32_t expirationTime;
+    };
+
+    std::map<ResourceType, OrderBook> books_;
+    std::unordered_map<std::string, OrderRef> orders_;
+    std::set<std::pair<uint32_t, std::string>> expirations_;
+    std::map<ResourceType, PriceHistory> history_;
+    uint64_t transactionCount_ = 0;
+    uint64_t nextOrder_ = 0;
+    uint32_t currentTime_ = 0;
 
     // Demand tracking
     std::map<ResourceType, double> demandTracker_;
 
     std::string generateId();
+    void removeOrder(const std::string& orderId, bool isBid);
+    const Transaction& recordTransaction(Transaction transaction);
 };
 
 /**
@@ -293,6 +532,33 @@ public:
     double dailyIncome = 0.0;
     double dailyExpenses = 0.0;
 
+    // Location of the market it trades at; empty for the simulation's first
+    std::string market;
+
+    /**
+     * How much it wants a type, 0-1, 0.5 unless set
+     */
+    double getNeed(ResourceType type) const { return resourceNeeds_[static_cast<size_t>(type)]; }
+    void setNeed(ResourceType type, double need) { resourceNeeds_[static_cast<size_t>(type)] = need; }
+
+    /**
+     * Price it expects for a type, 0 if it has no idea
+     */
+    double getPriceExpectation(ResourceType type) const {
+        return priceExpectations_[static_cast<size_t>(type)];
+    }
+
+    /**
+     * Take an observed price into its expectation, as far as it remembers
+     * prices
+     */
+    void updatePriceExpectation(ResourceType type, double observedPrice);
+
+    const std::array<double, RESOURCE_TYPE_COUNT>& getNeeds() const { return resourceNeeds_; }
+    const std::array<double, RESOURCE_TYPE_COUNT>& getPriceExpectations() const {
+        return priceExpectations_;
+    }
+
     /**
      * Evaluate resource utility
      */
@@ -342,12 +608,10 @@ public:
 
 private:
     // Price expectations
-    std::map<ResourceType, double> priceExpectations_;
+    std::array<double, RESOURCE_TYPE_COUNT> priceExpectations_{};
 
     // Needs
-    std::map<ResourceType, double> resourceNeeds_;
-
-    void updatePriceExpectation(ResourceType type, double observedPrice);
+    std::array<double, RESOURCE_TYPE_COUNT> resourceNeeds_;
 };
 
 /**
@@ -501,7 +765,8 @@ public:
     void setBasePrice(ResourceType type, double price);
 
     /**
-     * Simulate market tick
+     * Simulate market tick: agents decide what to buy and sell in one
+     * batched pass, then the markets match and settle the orders
      */
     void simulate(double deltaTime);
 
@@ -549,11 +814,24 @@ private:
     std::map<ResourceType, double> basePrices_;
 
     // Economic state
+    double time_ = 0.0;
     double moneySupply_ = 10000.0;
     double previousPriceIndex_ = 1.0;
     double inflationRate_ = 0.0;
 
+    // Agent x resource type tables for the decision pass, a row an agent
+    std::vector<EconomicAgent*> rows_;
+    std::vector<double> needs_;
+    std::vector<double> expectations_;
+    std::vector<double> holdings_;
+
+    // Bids from the last pass, replaced by the next one's
+    std::vector<std::pair<Market*, std::string>> bids_;
+
+    void decideOrders();
+    Market* marketFor(const EconomicAgent& agent);
     void matchOrders();
+    void settle(const Trade& trade);
     void updatePrices();
     void calculateEconomicIndicators();
 };
@@ -567,14 +845,16 @@ public:
     ~NPCEconomicDecision();
 
     /**
-     * Decide what to buy
+     * Decide what to buy, by the rule of MarketSimulation's decision pass
+     * @return Types with quantities wanted
      */
     std::vector<std::pair<ResourceType, double>> decidePurchases(
         const EconomicAgent& agent,
         const Market& market);
 
     /**
-     * Decide what to sell
+     * Decide what to sell, by the rule of MarketSimulation's decision pass
+     * @return Resource ids with asking prices
      */
     std::vector<std::pair<std::string, double>> decideSales(
         const EconomicAgent& agent,
@@ -0,0 +1,108 @@
+/**
+ * DialogueService.h - Background Dialogue Generation
+ *
+ * Runs TinyLLM on worker threads so the game never waits for it. The game
+ * submits a request, shows whatever it has meanwhile (such as an AIML
+ * answer), and calls deliver() once a frame to receive the text generated
+ * so far and the finished result, on its own thread.
+ *
+ * A request can be given a deadline, after which its answer is no longer
+ * wanted: it is dropped, running or not, and its result callback is never
+ * called. Requests can also be cancelled one at a time or for an NPC, such
+ * as when a conversation ends.
+ */
+
+#pragma once
+
+#include "llm/TinyLLM.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Ultima {
+namespace NPC {
+namespace LLM {
+
+class DialogueService {
+public:
+    using JobId = uint64_t;
+
+    /**
+     * Called from deliver() with the response generated so far
+     */
+    using PartialCallback = std::function<void(const std::string& text)>;
+
+    /**
+     * Called from deliver() with the finished result
+     */
+    using ResultCallback = std::function<void(const DialogueResult& result)>;
+
+    DialogueService();
+    ~DialogueService();
+
+    DialogueService(const DialogueService&) = delete;
+    DialogueService& operator=(const DialogueService&) = delete;
+
+    /**
+     * Start the workers, each with its own TinyLLM
+     * @param config LLM configuration. The workers share the model's
+     *               weights.
+     * @param workers Number of worker threads
+     * @return false if a TinyLLM fails to initialize
+     */
+    bool start(const LLMConfig& config, int workers = 1);
+
+    /**
+     * Stop the workers, dropping every request not yet delivered
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * Queue a request, answered in the order submitted
+     * @param request The dialogue request
+     * @param onResult Called with the result
+     * @param onPartial Called with the response so far as it grows
+     * @param deadlineMs Drop the request if it isn't finished this many
+     *                   milliseconds from now. 0 for no deadline.
+     * @return Id of the request, or 0 if the service isn't running
+     */
+    JobId submit(const DialogueRequest& request,
+                 ResultCallback onResult,
+                 PartialCallback onPartial = nullptr,
+                 int deadlineMs = 0);
+
+    /**
+     * Drop a request. If it is being generated, that stops.
+     */
+    void cancel(JobId id);
+
+    /**
+     * Drop every request to an NPC
+     */
+    void cancelNPC(const std::string& npcName);
+
+    /**
+     * Call the callbacks of requests that have progressed, from the
+     * calling thread, and drop those past their deadline
+     * @param budgetMs Stop once this much time has passed, leaving the rest
+     *                 for the next call. 0 for no limit.
+     * @return Number of callbacks called
+     */
+    int deliver(double budgetMs = 0.0);
+
+    /**
+     * Requests submitted but not yet delivered or dropped
+     */
+    size_t pending() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace LLM
+} // namespace NPC
+} // namespace Ultima
@@ -0,0 +1,94 @@
+/**
+ * ModelFile.h - Memory-Mapped TinyLLM Weight Files
+ *
+ * Weights are stored ready to use, float or quantized to 8 or 4 bits
+ * with a scale per row, so a model is mapped into memory rather than
+ * read. Loading is instant and the pages are shared between every
+ * TinyLLM using the same file.
+ *
+ * Layout, little-endian, with each part starting on a 64 byte boundary:
+ *   Header   "TLLQ", version, vocab size, dim, feed-forward dim, layers,
+ *            weight type, tensor count
+ *   Tensors  Embeddings and output projection, then for each layer the
+ *            attention wq, wk, wv, wo and feed-forward w1, w2. Each is
+ *            rows, cols and weight type, then the row scales if it is
+ *            quantized, then the rows.
+ */
+
+#pragma once
+
+#include "llm/TensorKernels.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Ultima {
+namespace NPC {
+namespace LLM {
+
+class ModelFile {
+public:
+    /**
+     * Sizes of the model a file holds
+     */
+    struct Shape {
+        uint32_t vocabSize = 0;
+        uint32_t dim = 0;
+        uint32_t hiddenDim = 0;
+        uint32_t layers = 0;
+    };
+
+    ModelFile() = default;
+    ~ModelFile();
+
+    ModelFile(const ModelFile&) = delete;
+    ModelFile& operator=(const ModelFile&) = delete;
+
+    /**
+     * Map a model file, checking it is whole and consistent
+     * @return false if it can't be mapped or isn't a model file
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Unmap the file. Weights from tensors() are no longer valid.
+     */
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const Shape& shape() const { return shape_; }
+    Kernels::WeightType weightType() const { return type_; }
+    size_t size() const { return size_; }
+
+    /**
+     * The weights, in file order, pointing into the mapping
+     */
+    const std::vector<Kernels::Weights>& tensors() const { return tensors_; }
+
+    /**
+     * Write a model file
+     * @param tensors Float weights in file order
+     * @param type How to store them
+     */
+    static bool write(const std::string& filename, const Shape& shape,
+                      Kernels::WeightType type,
+                      const std::vector<Kernels::Weights>& tensors);
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    Shape shape_;
+    Kernels::WeightType type_ = Kernels::WeightType::F32;
+    std::vector<Kernels::Weights> tensors_;
+    std::vector<uint8_t> copy_;     // The file, where it couldn't be mapped
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+
+    bool map(const std::string& filename);
+    bool parse();
+};
+
+} // namespace LLM
+} // namespace NPC
+} // namespace Ultima
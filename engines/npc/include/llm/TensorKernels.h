@@ -0,0 +1,110 @@
+/**
+ * TensorKernels.h - Dense Matrix Kernels
+ *
+ * Matrix-vector and matrix-matrix products over row-major matrices,
+ * writing into float buffers owned by the caller. Rows are taken four
+ * at a time so each load of the input is shared between four dot
+ * products, and batched products walk the matrix in blocks that stay in
+ * cache while every input vector passes over them.
+ *
+ * Matrices may be float, or quantized to 8 or 4 bit integers with one
+ * scale per row. Quantized rows are widened to float inside the dot
+ * product, so they are never unpacked in memory.
+ *
+ * Activation functions run over whole buffers in place, using a rational
+ * approximation of tanh that vectorizes.
+ *
+ * AVX2 is used when the CPU has it (checked at run time), otherwise SSE2
+ * on x86 or NEON on ARM. Define NO_SIMD to use plain C++ only.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Ultima {
+namespace NPC {
+namespace LLM {
+namespace Kernels {
+
+/**
+ * How a matrix's weights are stored
+ */
+enum class WeightType : uint32_t {
+    F32 = 0,    // float
+    Q8 = 1,     // int8_t, times the row's scale
+    Q4 = 2      // Two 4 bit values a byte, low nibble first, stored
+                // plus 8 and times the row's scale
+};
+
+/**
+ * A matrix held somewhere else, such as in a mapped model file
+ */
+struct Weights {
+    WeightType type = WeightType::F32;
+    const void* data = nullptr;     // rows of rowBytes(type, cols) each
+    const float* scales = nullptr;  // One a row, for Q8 and Q4
+    int rows = 0;
+    int cols = 0;
+};
+
+/**
+ * Bytes in a row of cols weights stored as type
+ */
+size_t rowBytes(WeightType type, int cols);
+
+/**
+ * Stores a row of cols floats as type in out
+ * @return The row's scale (1 for F32)
+ */
+float quantizeRow(WeightType type, const float* row, int cols, void* out);
+
+/**
+ * Widens row r of a back to cols floats
+ */
+void dequantizeRow(const Weights& a, int r, float* out);
+
+/**
+ * y = A x
+ * @param x Vector of a.cols floats
+ * @param y Vector of a.rows floats, not overlapping x
+ */
+void gemv(const Weights& a, const float* x, float* y);
+
+/**
+ * C = X A^T, the product of A with each of n vectors at once
+ * @param x Row-major n x a.cols matrix, one input vector per row
+ * @param c Row-major n x a.rows result, not overlapping x
+ */
+void gemm(const float* x, int n, const Weights& a, float* c);
+
+/**
+ * y = A x for a row-major rows x cols float matrix A
+ */
+void gemv(const float* a, int rows, int cols, const float* x, float* y);
+
+/**
+ * C = X A^T for a row-major rows x cols float matrix A
+ */
+void gemm(const float* x, int n, const float* a, int rows, int cols, float* c);
+
+/**
+ * x = tanh(x) for each of n floats, to within 1e-6
+ */
+void tanhInPlace(float* x, size_t n);
+
+/**
+ * x = 1 / (1 + e^-x) for each of n floats, to within 1e-6
+ */
+void sigmoidInPlace(float* x, size_t n);
+
+/**
+ * Name of the instruction set the kernels are using
+ */
+const char* backendName();
+
+} // namespace Kernels
+} // namespace LLM
+} // namespace NPC
+} // namespace Ultima
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <memory>
@@ -26,7 +27,8 @@ namespace LLM {
  * Configuration for the TinyLLM engine
  */
 struct LLMConfig {
-    std::string modelPath;          // Path to GGUF model file
+    std::string modelPath;          // Model file to map (see ModelFile.h);
+                                    // random weights if empty
     int contextSize = 2048;         // Context window size
     int maxTokens = 256;            // Max tokens to generate
     float temperature = 0.7f;       // Sampling temperature (0.0-2.0)
@@ -56,6 +58,17 @@ struct ChatMessage {
     }
 };
 
+/**
+ * The part of an NPC's system prompt that only changes with who the NPC
+ * is, built and tokenized once and shared by all of its requests
+ */
+struct PromptPrefix {
+    std::string text;
+    std::vector<int> tokens;
+    
+    static std::shared_ptr<const PromptPrefix> make(std::string text);
+};
+
 /**
  * NPC personality context for dialogue generation
  */
@@ -68,9 +81,15 @@ struct NPCContext {
     std::string recentEvents;       // Recent happenings
     std::vector<std::string> knownFacts;  // Facts the NPC knows
     std::vector<std::string> secrets;     // Things NPC won't reveal easily
+    std::shared_ptr<const PromptPrefix> prefix; // Stands in for personaPrompt() if set
     
     // Generate a system prompt from this context
     std::string toSystemPrompt() const;
+    
+    // The two halves of the system prompt. Who the NPC is comes first, so
+    // a conversation's cache outlives changes of mood or place.
+    std::string personaPrompt() const;
+    std::string situationPrompt() const;
 };
 
 /**
@@ -82,6 +101,10 @@ struct DialogueRequest {
     std::vector<ChatMessage> history; // Recent conversation history
     std::string situationalContext; // Current game situation
     bool requiresCreativity = true; // Whether to use LLM or fallback
+    float temperature = -1.0f;      // Sampling temperature, or the config's if < 0
+    int maxTokens = 0;              // Most tokens to generate, or the config's if 0
+    std::vector<std::string> stopSequences; // Stop once the response ends with one
+    const std::atomic<bool>* cancelled = nullptr; // Stop once set, from any thread
 };
 
 /**
@@ -101,12 +124,22 @@ struct DialogueResult {
  */
 using StreamCallback = std::function<void(const std::string& token)>;
 
+/**
+ * Callback for batched responses, with the index of the request answered
+ */
+using BatchCallback = std::function<void(size_t index, const DialogueResult& result)>;
+
 /**
  * TinyLLM - Lightweight Language Model for NPC Dialogue
  * 
  * This class provides a simple interface for generating creative
  * NPC dialogue using small language models. It's designed to work
  * alongside the AIML engine for hybrid dialogue generation.
+ *
+ * Instances using the same model file, or the same built-in model size,
+ * share one read-only copy of its weights. Each keeps only its own working
+ * buffers and conversation caches, so an instance per thread or per NPC
+ * costs little beyond the conversations it holds.
  */
 class TinyLLM {
 public:
@@ -124,6 +157,14 @@ public:
      */
     bool initialize(const LLMConfig& config);
     
+    /**
+     * Save the weights as a model file, for LLMConfig::modelPath
+     * @param filename File to write
+     * @param bits 8 or 4 to quantize the weights, 32 for floats
+     * @return true if saved
+     */
+    bool save(const std::string& filename, int bits = 8) const;
+    
     /**
      * Check if the LLM is ready
      */
@@ -136,8 +177,27 @@ public:
      */
     DialogueResult generateDialogue(const DialogueRequest& request);
     
+    /**
+     * Generate dialogue for several NPCs at once
+     *
+     * Requests to different NPCs are run through the model together, so
+     * each weight matrix is read once per token for all of them. Requests
+     * to the same NPC take turns, in order.
+     *
+     * @param requests The dialogue requests
+     * @param callback Called with each result as it finishes. It must not
+     *                 use this TinyLLM.
+     */
+    void generateBatch(const std::vector<DialogueRequest>& requests,
+                       BatchCallback callback);
+    
     /**
      * Generate dialogue with streaming output
+     *
+     * Tokens are passed on as they are generated. The final response may
+     * still differ from them: a stop sequence is trimmed, and a response
+     * too short to use is replaced with a fallback.
+     *
      * @param request The dialogue request
      * @param callback Called for each generated token
      * @return Final dialogue result
@@ -184,6 +244,10 @@ public:
     
     /**
      * Clear the conversation context
+     *
+     * Each NPC's conversation keeps the attention keys and values of its
+     * tokens, so the next prompt only runs what is new since the shared
+     * start (system prompt and history). This drops them all.
      */
     void clearContext();
     
@@ -206,7 +270,10 @@ private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
     
-    std::string buildPrompt(const DialogueRequest& request) const;
+    void runBatch(const std::vector<const DialogueRequest*>& requests,
+                  const BatchCallback& callback,
+                  const StreamCallback* stream = nullptr);
+    std::string buildPrompt(const DialogueRequest& request, bool withPrefix = true) const;
     std::string formatChatHistory(const std::vector<ChatMessage>& history) const;
     DialogueResult parseResponse(const std::string& raw, const DialogueRequest& request) const;
 };
@@ -242,6 +309,17 @@ public:
      */
     DialogueResult generate(const DialogueRequest& request);
     
+    /**
+     * Generate dialogue for several NPCs at once, such as the barks of
+     * everyone in a room. Pattern matches are answered first, and the
+     * rest are generated together by the LLM.
+     *
+     * @param requests Dialogue requests
+     * @param callback Called with each result as it is ready
+     */
+    void generateBatch(const std::vector<DialogueRequest>& requests,
+                       BatchCallback callback);
+    
     /**
      * Force LLM generation (bypass AIML)
      */
@@ -13,9 +13,11 @@
 #ifndef ULTIMA_NPC_MEMORY_SYSTEM_H
 #define ULTIMA_NPC_MEMORY_SYSTEM_H
 
+#include "core/SymbolTable.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <queue>
 #include <chrono>
@@ -24,6 +26,12 @@
 
 namespace Ultima {
 namespace NPC {
+
+namespace Persistence {
+class ArchiveWriter;
+class ArchiveReader;
+}
+
 namespace Memory {
 
 /**
@@ -199,6 +207,12 @@ public:
      */
     double getCognitiveLoad() const;
 
+    /**
+     * Write/read within an archive
+     */
+    void write(Persistence::ArchiveWriter& out) const;
+    bool read(Persistence::ArchiveReader& in);
+
 private:
     struct WorkingMemoryItem {
         std::string content;
@@ -213,13 +227,17 @@ private:
 
 /**
  * Memory Retrieval Cue
+ *
+ * Memories are scored by their relevance to the tags, entity and location
+ * times their retrieval probability. A cue with none of these ranks
+ * memories by retrieval probability alone.
  */
 struct RetrievalCue {
     std::vector<std::string> tags;
     std::string entityContext;
     std::string locationContext;
     std::string emotionalContext;
-    uint32_t timeContext = 0;
+    uint32_t timeContext = 0;       // Time to recall at, 0 for the latest seen
     MemoryType typeFilter = MemoryType::Episodic;
     bool filterByType = false;
 
@@ -260,6 +278,9 @@ public:
 
     /**
      * Search memories with cue
+     * Only memories sharing a tag, entity or location with the cue are
+     * scored; a cue without any walks the most recently accessed first.
+     * @return At most cue.maxResults memories, best first
      */
     std::vector<MemoryItem> search(const RetrievalCue& cue);
 
@@ -300,6 +321,13 @@ public:
      */
     MemoryItem reconstruct(const std::string& memoryId);
 
+    /**
+     * Write/read every memory within an archive. Reading replaces the
+     * memories held.
+     */
+    void write(Persistence::ArchiveWriter& out) const;
+    bool read(Persistence::ArchiveReader& in);
+
     /**
      * Save/load memory store
      */
@@ -315,17 +343,28 @@ public:
     size_t getProceduralCount() const;
 
 private:
+    // Width of the last-access buckets, in time units
+    static constexpr uint32_t TIME_BUCKET_SIZE = 256;
+
     std::map<std::string, std::unique_ptr<MemoryItem>> memories_;
 
-    // Indexes for efficient retrieval
-    std::multimap<std::string, std::string> tagIndex_;
-    std::multimap<std::string, std::string> entityIndex_;
-    std::multimap<std::string, std::string> locationIndex_;
+    // Indexes for efficient retrieval, pointing into memories_, keyed by
+    // interned tag, entity and location
+    using MemoryList = std::vector<MemoryItem*>;
+    std::unordered_map<Symbol, MemoryList> tagIndex_;
+    std::unordered_map<Symbol, MemoryList> entityIndex_;        // By association
+    std::unordered_map<Symbol, MemoryList> locationIndex_;
+    std::map<uint32_t, MemoryList> timeIndex_;  // Last access / TIME_BUCKET_SIZE
     std::map<std::string, std::string> skillIndex_;  // skill name -> memory id
 
+    uint32_t latestTime_ = 0;       // Latest access seen
+    double maxWeight_ = 0.0;        // Highest strength x clarity stored
+
     std::string generateId();
     void indexMemory(const std::string& id, const MemoryItem& memory);
     void removeFromIndex(const std::string& id, const MemoryItem& memory);
+    void indexTime(MemoryItem* memory);
+    void removeFromTimeIndex(MemoryItem* memory);
 };
 
 /**
@@ -443,11 +482,24 @@ public:
      */
     void update(uint32_t currentTime, double deltaTime);
 
+    /**
+     * Strengthen important long-term memories. Much slower than decay, so
+     * it can run far less often than update().
+     */
+    void consolidate(uint32_t currentTime);
+
     /**
      * Get emotional memory of entity
      */
     double getEmotionalMemory(const std::string& entity) const;
 
+    /**
+     * Write/read working and long-term memory within an archive.
+     * Autobiographical memory isn't kept.
+     */
+    void write(Persistence::ArchiveWriter& out) const;
+    bool read(Persistence::ArchiveReader& in);
+
     /**
      * Save/load
      */
@@ -12,12 +12,19 @@
 
 #include <vector>
 #include <memory>
+#include <cstddef>
 #include <string>
 #include <functional>
 #include <cstdint>
 
 namespace Ultima {
 namespace NPC {
+
+namespace Persistence {
+class ArchiveWriter;
+class ArchiveReader;
+}
+
 namespace Neural {
 
 /**
@@ -105,6 +112,21 @@ struct TrainingConfig {
 
     bool randomizeInitialWeights = true;
     bool verbose = false;
+
+    // The genetic, annealing and random-search trainers score their
+    // candidates on this many copies of the network, run on the job
+    // system's threads (0 for one per thread it has). The result doesn't
+    // depend on it.
+    int threads = 1;
+
+    // Seeds the random streams, one per candidate, so training the same
+    // network with the same seed and data gives the same result. 0 for a
+    // random seed.
+    uint32_t seed = 0;
+
+    // Moves proposed at each annealing step, of which the best is tried
+    // (0 for one per thread)
+    int annealingProposals = 0;
 };
 
 /**
@@ -117,26 +139,56 @@ struct TrainingPoint {
 
 /**
  * Neural network layer
+ *
+ * Weights are held as one row-major block of floats, a row per neuron,
+ * and inputs go through in batches: one matrix product, then the
+ * activation over the whole batch.
  */
 class Layer {
 public:
     Layer(const LayerConfig& config);
     ~Layer();
 
-    std::vector<double> forward(const std::vector<double>& inputs);
+    /**
+     * Run count input vectors through the layer
+     * @param inputs count vectors of getNumInputs() floats, one after another
+     * @param outputs count vectors of getNumNeurons() floats
+     */
+    void forward(const float* inputs, size_t count, float* outputs) const;
+
+    /**
+     * Give the layer numInputs inputs, with random weights, unless it
+     * already has its inputs
+     */
+    void connect(uint32_t numInputs);
+
     void setWeights(const std::vector<std::vector<double>>& weights);
     std::vector<std::vector<double>> getWeights() const;
 
+    /**
+     * The weights, getNumNeurons() rows of getNumInputs()
+     */
+    float* getWeightData() { return weights_.data(); }
+    const float* getWeightData() const { return weights_.data(); }
+    size_t getNumWeights() const { return weights_.size(); }
+
+    /**
+     * The biases, one per neuron
+     */
+    float* getBiasData() { return biases_.data(); }
+    const float* getBiasData() const { return biases_.data(); }
+
     uint32_t getNumNeurons() const { return numNeurons_; }
+    uint32_t getNumInputs() const { return numInputs_; }
 
 private:
     uint32_t numNeurons_;
     uint32_t numInputs_;
     ActivationFunction activation_;
-    std::vector<std::vector<double>> weights_;
-    std::vector<double> biases_;
+    std::vector<float> weights_;
+    std::vector<float> biases_;
 
-    double activate(double x) const;
+    void activate(float* x, size_t n) const;
 };
 
 /**
@@ -151,9 +203,34 @@ public:
     void addLayer(const LayerConfig& config);
     void build();
 
-    // Forward pass
+    /**
+     * Set the size of the input, which is otherwise taken from the
+     * first prediction or training data
+     */
+    void setInputSize(uint32_t inputSize);
+    uint32_t getInputSize() const;
+    uint32_t getOutputSize() const;
+
+    // Forward pass. Inputs shorter than the input size are padded with
+    // zeros.
     std::vector<double> predict(const std::vector<double>& inputs);
 
+    /**
+     * Forward pass for many inputs at once, such as one for every NPC
+     * sharing the network
+     * @param inputs count vectors of getInputSize() floats, one after another
+     * @param outputs count vectors of getOutputSize() floats
+     */
+    void predictBatch(const float* inputs, size_t count, float* outputs);
+
+    /**
+     * As above, but leaves the network untouched, so that several threads
+     * or NPCs can run one network at once. The input size must be set.
+     * @param workspace Scratch, grown as needed, for the caller to keep
+     */
+    void predictBatch(const float* inputs, size_t count, float* outputs,
+                      std::vector<float>& workspace) const;
+
     // Training
     void train(const std::vector<TrainingPoint>& data, const TrainingConfig& config);
     double getTrainingError() const { return lastError_; }
@@ -162,6 +239,13 @@ public:
     bool save(const std::string& filename) const;
     bool load(const std::string& filename);
 
+    /**
+     * Write/read every layer's weights and biases within an archive.
+     * Reading needs a built network of the same shape.
+     */
+    void write(Persistence::ArchiveWriter& out) const;
+    bool read(Persistence::ArchiveReader& in);
+
     // Network info
     uint32_t getNumLayers() const { return static_cast<uint32_t>(layers_.size()); }
     uint32_t getNumNeurons() const;
@@ -170,12 +254,35 @@ public:
     void clear();
 
 private:
+    // Inputs run through the layers this many at a time
+    static constexpr size_t BATCH = 64;
+
     std::vector<std::unique_ptr<Layer>> layers_;
     std::vector<LayerConfig> layerConfigs_;
     bool isBuilt_ = false;
     double lastError_ = 0.0;
 
-    void randomizeWeights(double min, double max);
+    // Inputs packed for run(), and two buffers the layers write to in
+    // turn, each holding a batch of vectors of the widest layer. Both grow
+    // to the largest batch run, at most BATCH.
+    std::vector<float> packed_;
+    std::vector<float> workspace_;
+    uint32_t width_ = 0;    // Of the widest layer
+
+    class FitnessEvaluator;
+
+    void connect(uint32_t inputSize);
+    float* packedInputs(size_t count);
+    const float* run(const float* inputs, size_t count);
+    // Using the given layer buffers rather than the network's own
+    const float* run(const float* inputs, size_t count, float* workspace) const;
+
+    // Every layer's weights, one after another
+    std::vector<float> getAllWeights() const;
+    void setAllWeights(const std::vector<float>& weights);
+    std::unique_ptr<NeuralNetwork> clone() const;
+
+    void randomizeWeights(double min, double max, uint32_t seed);
     double computeError(const std::vector<TrainingPoint>& data, ErrorFunction errorFunc);
 
     // Training algorithms
@@ -192,6 +299,11 @@ private:
  * - Decision making
  * - Preference learning
  * - Behavior adaptation
+ *
+ * The hidden layers form a base network shared, read-only, by every NPC
+ * learning in the same context. Each NPC trains only its own output
+ * layer on the base's features, so an NPC costs a few hundred weights
+ * plus its experiences.
  */
 class NPCLearningNetwork {
 public:
@@ -235,6 +347,14 @@ public:
      */
     std::vector<double> getActionProbabilities(const std::vector<double>& situation);
 
+    /**
+     * Predict the best action for many situations in one pass
+     * @param situations Input features, one entry per situation
+     * @return Action index for each situation
+     */
+    std::vector<uint32_t> predictBestActions(
+        const std::vector<std::vector<double>>& situations);
+
     /**
      * Set number of possible actions
      */
@@ -246,11 +366,28 @@ public:
     void batchTrain();
 
     /**
-     * Save/load learned weights
+     * Save/load learned weights. These are the NPC's own output layer, so
+     * a file only suits NPCs using the same base network.
      */
     bool save(const std::string& filename) const;
     bool load(const std::string& filename);
 
+    /**
+     * Write/read learned weights and statistics within an archive. As
+     * with load(), these only suit NPCs using the same base network.
+     */
+    void write(Persistence::ArchiveWriter& out) const;
+    bool read(Persistence::ArchiveReader& in);
+
+    /**
+     * Replace the base network of a context with one saved by
+     * NeuralNetwork::save(). NPCs made afterwards use it; those already
+     * made keep the one they learned with.
+     * @return false if the file can't be read or doesn't take the
+     *         context's inputs
+     */
+    static bool loadBaseNetwork(LearningContext context, const std::string& filename);
+
     /**
      * Get learning statistics
      */
@@ -258,7 +395,8 @@ public:
     double getAverageReward() const { return totalReward_ / std::max(1u, experienceCount_); }
 
 private:
-    std::unique_ptr<NeuralNetwork> network_;
+    std::shared_ptr<const NeuralNetwork> base_;    // Shared with the context's NPCs
+    std::unique_ptr<NeuralNetwork> head_;           // This NPC's output layer
     LearningContext context_;
     uint32_t numActions_ = 4;
     uint32_t inputSize_ = 0;
@@ -267,11 +405,22 @@ private:
     std::vector<TrainingPoint> experienceBuffer_;
     static constexpr size_t MAX_BUFFER_SIZE = 1000;
 
+    // Reused when predicting and training
+    std::vector<float> batchInputs_;
+    std::vector<float> batchFeatures_;
+    std::vector<float> batchOutputs_;
+    std::vector<float> workspace_;      // For running base_
+
     // Statistics
     uint32_t experienceCount_ = 0;
     double totalReward_ = 0.0;
 
+    static uint32_t contextInputSize(LearningContext context);
+    static std::shared_ptr<const NeuralNetwork> sharedBase(LearningContext context);
+
     void initializeNetwork();
+    // Run base_ over the packed batchInputs_ into batchFeatures_
+    void computeFeatures(size_t count);
     std::vector<double> encodeAction(uint32_t action) const;
     uint32_t decodeAction(const std::vector<double>& output) const;
 };
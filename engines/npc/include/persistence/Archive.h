@@ -0,0 +1,130 @@
+/**
+ * Archive.h - Compact Binary Archives
+ *
+ * Save data is written as varints, raw little-endian doubles and floats,
+ * and strings interned as they go: the first use of a string writes it,
+ * later ones its number. Related data is grouped into tagged,
+ * length-prefixed sections, each with its own strings, so a reader can
+ * skip a section it doesn't know or keep its bytes to read later.
+ *
+ * Layout of a finished archive:
+ *   Header   "NPCA", format version, flags (bit 0: deflated), payload size
+ *   Payload  The sections, deflated if the flag is set
+ */
+
+#ifndef ULTIMA_NPC_PERSISTENCE_ARCHIVE_H
+#define ULTIMA_NPC_PERSISTENCE_ARCHIVE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Ultima {
+namespace NPC {
+namespace Persistence {
+
+/**
+ * Version of the archive format; readers refuse other versions
+ */
+constexpr uint32_t ARCHIVE_VERSION = 1;
+
+/**
+ * Whether deflate compression was built in
+ */
+bool compressionAvailable();
+
+/**
+ * Write a finished archive to a file, or read one back
+ */
+bool saveArchive(const std::string& filename, const std::string& archive);
+bool loadArchive(const std::string& filename, std::string& archive);
+
+class ArchiveWriter {
+public:
+    void putVarint(uint64_t value);
+    void putSigned(int64_t value);      // Zigzag, so small negatives stay small
+    void putBool(bool value) { putVarint(value ? 1 : 0); }
+    void putDouble(double value);
+    void putFloat(float value);
+    void putString(const std::string& value);
+    void putStrings(const std::vector<std::string>& values);
+
+    /**
+     * Append a section: its tag, its size, then its bytes
+     */
+    void putSection(uint32_t tag, const ArchiveWriter& section);
+    void putSection(uint32_t tag, const std::string& bytes);
+
+    const std::string& bytes() const { return bytes_; }
+
+    /**
+     * The whole archive, with header
+     * @param compress Deflate the payload, if compression is available
+     */
+    std::string finish(bool compress = true) const;
+
+private:
+    std::string bytes_;
+    std::unordered_map<std::string, uint64_t> strings_;
+};
+
+class ArchiveReader {
+public:
+    ArchiveReader(const char* data, size_t size);
+    explicit ArchiveReader(const std::string& bytes)
+        : ArchiveReader(bytes.data(), bytes.size()) {}
+
+    /**
+     * Check an archive's header and get its payload, inflated
+     * @return false if it isn't an archive of this version, is damaged,
+     *         or is deflated and compression isn't available
+     */
+    static bool open(const std::string& archive, std::string& payload);
+
+    /**
+     * An archive's payload size once inflated, from its header
+     * @return 0 if it isn't an archive of this version
+     */
+    static size_t payloadSize(const std::string& archive);
+
+    /**
+     * Whether everything read so far was there; once false, reads return
+     * zeros and empty strings
+     */
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == end_; }
+
+    uint64_t getVarint();
+    int64_t getSigned();
+    bool getBool() { return getVarint() != 0; }
+    double getDouble();
+    float getFloat();
+    std::string getString();
+    std::vector<std::string> getStrings();
+
+    /**
+     * A count of things at least minBytes long each, no more than are left
+     */
+    size_t getCount(size_t minBytes = 1);
+
+    /**
+     * Read the next section
+     * @return false at the end, or if it is cut short
+     */
+    bool nextSection(uint32_t& tag, std::string& bytes);
+
+private:
+    const char* pos_;
+    const char* end_;
+    bool ok_ = true;
+    std::vector<std::string> strings_;
+
+    bool take(void* out, size_t size);
+};
+
+} // namespace Persistence
+} // namespace NPC
+} // namespace Ultima
+
+#endif // ULTIMA_NPC_PERSISTENCE_ARCHIVE_H
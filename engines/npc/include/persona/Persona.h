@@ -23,6 +23,12 @@
 
 namespace Ultima {
 namespace NPC {
+
+namespace Persistence {
+class ArchiveWriter;
+class ArchiveReader;
+}
+
 namespace Persona {
 
 /**
@@ -439,7 +445,13 @@ public:
     std::map<std::string, double> getDialogueModifiers() const;
 
     /**
-     * Serialize/deserialize
+     * Write/read the whole persona within an archive
+     */
+    void write(Persistence::ArchiveWriter& out) const;
+    bool read(Persistence::ArchiveReader& in);
+
+    /**
+     * Serialize/deserialize, as a binary archive (see persistence/Archive.h)
      */
     std::string serialize() const;
     bool deserialize(const std::string& data);
@@ -10,9 +10,11 @@
 #ifndef ULTIMA_NPC_RULE_SET_H
 #define ULTIMA_NPC_RULE_SET_H
 
+#include "core/SymbolTable.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <functional>
 
@@ -216,6 +218,8 @@ public:
     using FactChecker = std::function<bool(const std::string& subject,
                                            const std::string& predicate,
                                            const std::string& object)>;
+    using ChangeListener = std::function<void(const std::string& npcId,
+                                              const std::string& key)>;
 
     RuleContext();
     ~RuleContext();
@@ -233,6 +237,19 @@ public:
     double getState(const std::string& npcId, const std::string& key) const;
     void setState(const std::string& npcId, const std::string& key, double value);
 
+    /**
+     * Report a change to state read through a getter. setState() reports
+     * its own changes.
+     * @param npcId Empty for every NPC
+     * @param key Empty for every key
+     */
+    void notifyStateChanged(const std::string& npcId, const std::string& key = "");
+
+    /**
+     * Set the one listener told of state changes, or none
+     */
+    void setChangeListener(ChangeListener listener);
+
     /**
      * Fact checking
      */
@@ -254,13 +271,20 @@ public:
     void updateCooldowns(int deltaTicks);
 
 private:
+    // Slots in the cooldown timer wheel, each holding the cooldowns that
+    // end on ticks congruent to it
+    static constexpr size_t COOLDOWN_WHEEL_SIZE = 256;
+
     std::map<std::string, StateGetter> stateGetters_;
     std::map<std::string, StateSetter> stateSetters_;
     FactChecker factChecker_;
+    ChangeListener changeListener_;
     uint32_t currentTime_ = 0;
 
-    // Cooldown tracking: npcId -> ruleId -> remaining ticks
-    std::map<std::string, std::map<std::string, int>> cooldowns_;
+    // Cooldown tracking: pairKey(npcId, ruleId) -> tick it ends
+    uint64_t cooldownTick_ = 0;
+    std::unordered_map<uint64_t, uint64_t> cooldowns_;
+    std::vector<std::vector<uint64_t>> cooldownWheel_;
 };
 
 /**
@@ -305,6 +329,12 @@ public:
         const std::string& npcId,
         RuleContext& context) const;
 
+    /**
+     * Select best of rules found applicable, sorted by priority
+     */
+    static const BehaviorRule* selectAmong(
+        const std::vector<const BehaviorRule*>& applicable);
+
     /**
      * Execute rule actions
      */
@@ -332,9 +362,65 @@ public:
      */
     void clear();
 
+    /**
+     * Changes whenever rules are added or removed
+     */
+    uint64_t getVersion() const { return version_; }
+
 private:
     std::map<std::string, BehaviorRule> rules_;
     std::multimap<std::string, std::string> categoryIndex_;  // category -> rule IDs
+    uint64_t version_ = 0;
+};
+
+/**
+ * Rule Network - Compiled rule set that remembers match results
+ *
+ * Conditions shared by several rules, and personality bounds, are compiled
+ * once into a node reading one interned state key. Each NPC keeps the last
+ * result of every node and the number of failing nodes of every rule, so
+ * a search re-evaluates only the nodes whose state was reported changed
+ * since, and adjusts only the rules they feed. Custom, fact and time of
+ * day conditions can't be watched and are evaluated on every search.
+ *
+ * Every condition concerns the one NPC, so there are no joins between
+ * facts; a rule's beta memory reduces to its count of failing nodes.
+ */
+class RuleNetwork {
+public:
+    RuleNetwork();
+    ~RuleNetwork();
+
+    /**
+     * Compile a rule set, forgetting every NPC's match results
+     */
+    void compile(const RuleSet& ruleSet);
+
+    /**
+     * Whether this is the current version of the rule set compiled
+     */
+    bool isCompiled(const RuleSet& ruleSet) const;
+
+    /**
+     * Mark state changed; see RuleContext::notifyStateChanged()
+     */
+    void stateChanged(const std::string& npcId, const std::string& key);
+
+    /**
+     * Same results as RuleSet::findApplicableRules()
+     */
+    std::vector<const BehaviorRule*> findApplicableRules(
+        const std::string& npcId,
+        RuleContext& context);
+
+    /**
+     * Number of distinct nodes the rules compiled into
+     */
+    size_t getNodeCount() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
 };
 
 /**
@@ -445,6 +531,12 @@ public:
      */
     void setContext(std::shared_ptr<RuleContext> context);
 
+    /**
+     * Match rules through a RuleNetwork. State read through getters must
+     * then be reported with RuleContext::notifyStateChanged().
+     */
+    void setIncrementalMatching(bool enabled);
+
     /**
      * Process NPC - find and execute applicable rules
      */
@@ -475,6 +567,9 @@ public:
 private:
     std::shared_ptr<RuleSet> ruleSet_;
     std::shared_ptr<RuleContext> context_;
+    std::unique_ptr<RuleNetwork> network_;      // When matching incrementally
+
+    void listenForChanges();
 
     std::map<std::string, const BehaviorRule*> lastRules_;
     std::map<std::string, uint32_t> executionCounts_;
@@ -13,7 +13,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
+#include <cstdint>
 #include <functional>
 #include <variant>
 #include <optional>
@@ -166,6 +168,11 @@ private:
 
 /**
  * Entity embedding - maps entities to tensor space
+ *
+ * Entity embeddings are unit rows of one float matrix, so similarity is a
+ * dot product and a search is one matrix-vector product over the rows.
+ * For worlds with many thousands of entities, buildIndex() clusters the
+ * rows so a search only scans the clusters nearest the query.
  */
 class EntityEmbedding {
 public:
@@ -197,6 +204,25 @@ public:
      */
     std::string predictObject(const std::string& subject, const std::string& relation);
 
+    /**
+     * Index the embeddings for approximate search. They are clustered
+     * into lists, and a search then scans only the lists whose centres
+     * are nearest the query. Entities added or updated later are filed
+     * as they change; call again to recluster.
+     * @param lists Number of lists, 0 for about the square root of the
+     *              number of entities
+     * @param probes Lists scanned by each search
+     */
+    void buildIndex(size_t lists = 0, size_t probes = 8);
+
+    /**
+     * Go back to scanning every entity
+     */
+    void dropIndex();
+
+    bool hasIndex() const { return !lists_.empty(); }
+    size_t getEntityCount() const { return names_.size(); }
+
     /**
      * Save/load embeddings
      */
@@ -205,14 +231,73 @@ public:
 
 private:
     size_t dimension_;
-    std::map<std::string, Tensor> entityEmbeddings_;
+
+    // One unit row of dimension_ floats per entity, by id
+    std::vector<float> matrix_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
     std::map<std::string, Tensor> relationEmbeddings_;
+    std::vector<float> scores_;
+
+    // A list of the approximate index, with copies of its entities' rows
+    struct IndexList {
+        std::vector<uint32_t> ids;
+        std::vector<float> rows;
+    };
+
+    std::vector<float> centroids_;      // One unit row per list
+    std::vector<IndexList> lists_;
+    std::vector<uint32_t> listOf_;      // By entity id
+    std::vector<uint32_t> slotOf_;      // Position in its list
+    size_t probes_ = 0;
 
     Tensor randomEmbedding();
+    uint32_t idOf(const std::string& entity);
+    float* row(uint32_t id) { return &matrix_[static_cast<size_t>(id) * dimension_]; }
+    void fileInIndex(uint32_t id);
+
+    /**
+     * The topK entities most similar to a unit query, most similar first
+     */
+    std::vector<std::pair<uint32_t, float>> search(const float* query, size_t topK,
+                                                   uint32_t exclude);
+};
+
+/**
+ * Symbol table - gives each distinct string a small integer id, so facts
+ * and rules compare and hash integers instead of strings
+ */
+class SymbolTable {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /**
+     * Id of name, adding it if it is new
+     */
+    uint32_t intern(const std::string& name);
+
+    /**
+     * Id of name, or NONE if it was never interned
+     */
+    uint32_t find(const std::string& name) const;
+
+    const std::string& name(uint32_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+    void clear();
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
 };
 
 /**
  * Reasoner - Main inference engine
+ *
+ * Facts are held as tuples of symbols, indexed by predicate, by each
+ * (predicate, argument position, symbol) and by entity. Rules are
+ * compiled when added, with their variables numbered, and forward
+ * chaining is semi-naive: each round only joins rules against the facts
+ * that became true in the round before.
  */
 class TensorLogicReasoner {
 public:
@@ -239,6 +324,13 @@ public:
 
     /**
      * Forward chaining - derive new facts from existing
+     *
+     * Premises are atomic formulas, whose variables are bound by joining
+     * them against true facts, negated atomic formulas, which must not be
+     * true once those are bound, and any other formula, checked with
+     * matchFormula() last. Each derived fact has the rule's confidence as
+     * its truth. Facts added between calls are picked up by the next one.
+     * @return The facts derived
      */
     std::vector<Fact> forwardChain(int maxIterations = 10);
 
@@ -283,14 +375,114 @@ public:
     bool matchFormula(const Formula& formula, const Binding& binding,
                      LogicalValue& result) const;
 
+    const SymbolTable& getSymbols() const { return symbols_; }
+    size_t getFactCount() const { return facts_.size(); }
+
 private:
-    std::vector<Fact> facts_;
+    static constexpr uint32_t NEVER = UINT32_MAX;
+
+    // Set on an atom argument that is a variable slot, not a symbol
+    static constexpr uint32_t VARIABLE = 0x80000000u;
+
+    /**
+     * A fact as symbols. Its arguments are arity entries of factArgs_,
+     * starting at firstArg.
+     */
+    struct StoredFact {
+        uint32_t predicate;
+        uint32_t firstArg;
+        uint32_t arity;
+        uint32_t trueSince;     // Round it last became true, or NEVER
+        LogicalValue value;
+        uint32_t timestamp = 0;
+        uint32_t source = SymbolTable::NONE;
+        bool isDerived = false;
+    };
+
+    /**
+     * Premise or conclusion of a compiled rule. Each argument is a symbol,
+     * or VARIABLE | slot.
+     */
+    struct Atom {
+        uint32_t predicate = SymbolTable::NONE;
+        std::vector<uint32_t> args;
+    };
+
+    struct CompiledRule {
+        std::vector<Atom> positive;
+        std::vector<Atom> negative;
+        std::vector<size_t> filters;            // Other premises, by index
+        Atom conclusion;
+        std::vector<std::string> variables;     // Name of each slot
+        bool usable = false;
+    };
+
+    struct ArgKey {
+        uint32_t predicate;
+        uint32_t position;
+        uint32_t symbol;
+        bool operator==(const ArgKey& other) const {
+            return predicate == other.predicate && position == other.position &&
+                   symbol == other.symbol;
+        }
+    };
+
+    struct ArgKeyHash {
+        size_t operator()(const ArgKey& key) const;
+    };
+
+    SymbolTable symbols_;
+    std::vector<StoredFact> facts_;
+    std::vector<uint32_t> factArgs_;
     std::vector<InferenceRule> rules_;
+    std::vector<CompiledRule> compiled_;
     EntityEmbedding embeddings_;
 
-    // Indexes for fast lookup
-    std::multimap<std::string, size_t> predicateIndex_;
-    std::multimap<std::string, size_t> entityIndex_;
+    // Indexes for fast lookup, each a list of fact indexes
+    std::unordered_map<uint32_t, std::vector<uint32_t>> predicateIndex_;
+    std::unordered_map<ArgKey, std::vector<uint32_t>, ArgKeyHash> argIndex_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> entityIndex_;
+    std::unordered_multimap<size_t, uint32_t> factLookup_;  // By tuple hash
+
+    // Facts that become true are tagged with this round, and the next
+    // forwardChain() starts by joining them. Rules from rulesChained_ on
+    // haven't been joined against anything yet.
+    uint32_t round_ = 0;
+    size_t rulesChained_ = 0;
+
+    uint32_t findFact(uint32_t predicate, const uint32_t* args, uint32_t arity) const;
+    uint32_t storeFact(uint32_t predicate, const uint32_t* args, uint32_t arity,
+                       const LogicalValue& value);
+    void setValue(StoredFact& fact, const LogicalValue& value);
+    Fact toFact(uint32_t index) const;
+    uint32_t symbolOf(const Term& term, const Binding& binding) const;
+
+    Atom compileAtom(const Term& predicate, CompiledRule& rule);
+    void compileRule(const InferenceRule& rule);
+
+    // Which facts an atom of a join may match, by the round they became
+    // true in compared with the round being joined
+    enum class Rounds { Before, At, UpTo };
+
+    struct Derivation {
+        const InferenceRule* rule;
+        uint32_t predicate;
+        std::vector<uint32_t> args;
+    };
+
+    struct Join {
+        const CompiledRule* rule;
+        const InferenceRule* source;
+        std::vector<size_t> order;      // Positive atoms, in join order
+        std::vector<Rounds> rounds;     // For each of order
+        uint32_t round;
+        std::vector<uint32_t> slots;
+        std::vector<Derivation>* derived;
+    };
+
+    void join(Join& state, size_t step) const;
+    bool holds(const Join& state) const;
+
     std::vector<Binding> findBindings(const Term& pattern) const;
     LogicalValue evaluateFormula(const Formula& f, const Binding& binding) const;
 };
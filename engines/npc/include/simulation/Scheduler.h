@@ -0,0 +1,94 @@
+/**
+ * Scheduler.h - Multi-Rate Simulation Scheduler
+ *
+ * World systems don't all need the frame rate: markets move by the hour,
+ * towns by the day. Each system is registered with a period of game time
+ * and the scheduler runs it only when that much time has passed, handing
+ * it all the time since its last run. After a fast-forward or a sleep a
+ * system catches up in as few steps as its longest step allows, within
+ * a budget of steps per advance, rather than replaying every frame.
+ *
+ * Systems due on the same advance run side by side as tasks on the job
+ * system, so systems sharing state must be registered as one.
+ */
+
+#ifndef ULTIMA_NPC_SIMULATION_SCHEDULER_H
+#define ULTIMA_NPC_SIMULATION_SCHEDULER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Ultima {
+namespace NPC {
+namespace Simulation {
+
+class Scheduler {
+public:
+    using Update = std::function<void(double deltaTime)>;
+
+    struct System {
+        std::string name;
+        double period = 0.0;        // Game seconds between runs, 0 for every advance
+        double maxStep = 0.0;       // Most time in one run, 0 for no limit
+        int stepBudget = 1;         // Most runs per advance; time past them waits
+        Update update;
+    };
+
+    Scheduler();
+    ~Scheduler();
+
+    /**
+     * Register a system, first due a period from now
+     * @return false if the name is taken or there's nothing to run
+     */
+    bool add(const System& system);
+
+    /**
+     * Unregister a system
+     */
+    bool remove(const std::string& name);
+
+    /**
+     * Move game time on, running the systems that are due
+     */
+    void advance(double deltaTime);
+
+    /**
+     * Game time advanced so far
+     */
+    double getTime() const { return time_; }
+
+    /**
+     * Time a system has yet to be run for, 0 if there's no such system
+     */
+    double getPending(const std::string& name) const;
+
+    size_t getSystemCount() const { return systems_.size(); }
+
+private:
+    struct Entry {
+        System system;
+        double pending = 0.0;       // Time not yet run
+    };
+
+    // One system's share of an advance
+    struct Run {
+        Entry* entry;
+        double step;
+        int steps;
+    };
+
+    std::vector<Entry> systems_;
+    std::vector<Run> runs_;
+    double time_ = 0.0;
+
+    Entry* find(const std::string& name);
+    const Entry* find(const std::string& name) const;
+};
+
+} // namespace Simulation
+} // namespace NPC
+} // namespace Ultima
+
+#endif // ULTIMA_NPC_SIMULATION_SCHEDULER_H
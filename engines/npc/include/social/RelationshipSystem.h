@@ -13,12 +13,17 @@
 #ifndef ULTIMA_NPC_RELATIONSHIP_SYSTEM_H
 #define ULTIMA_NPC_RELATIONSHIP_SYSTEM_H
 
+#include "core/SymbolTable.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <queue>
+#include <random>
 
 namespace Ultima {
 namespace NPC {
@@ -148,6 +153,9 @@ public:
     uint32_t lastInteraction = 0;
     uint32_t interactionCount = 0;
 
+    // Time decay has been applied up to, on the owning system's clock
+    double decayedUntil = 0.0;
+
     /**
      * Process an interaction
      */
@@ -161,7 +169,8 @@ public:
     void updateType();
 
     /**
-     * Decay relationship over time
+     * Decay relationship over time, in closed form so a long stretch
+     * decays the same as many short ones
      */
     void decay(double deltaTime);
 
@@ -270,17 +279,29 @@ public:
                                                    const std::string& entityB) const;
 
     /**
-     * Compute centrality metrics
+     * Compute centrality metrics: degree, betweenness and closeness, and
+     * influence as PageRank over relationship strengths, relative to the
+     * highest. Betweenness and closeness are estimated from a sample of
+     * source entities once the network outgrows it.
      */
     void computeCentrality();
 
     /**
-     * Get most influential entities
+     * Number of source entities sampled for betweenness and closeness;
+     * 0 to always use every entity
+     */
+    void setCentralitySamples(size_t samples) { centralitySamples_ = samples; }
+
+    static constexpr size_t DEFAULT_CENTRALITY_SAMPLES = 256;
+
+    /**
+     * Get most influential entities, by influence
      */
     std::vector<std::string> getMostInfluential(int count = 10) const;
 
     /**
-     * Detect communities/cliques
+     * Detect communities/cliques by Louvain modularity optimization,
+     * largest first
      */
     std::vector<std::set<std::string>> detectCommunities() const;
 
@@ -302,13 +323,21 @@ public:
     double getAverageConnections() const;
 
 private:
+    struct Graph;
+
     std::map<std::string, SocialNode> nodes_;
     std::vector<SocialEdge> edges_;
 
-    // Adjacency list for fast lookup
-    std::map<std::string, std::vector<std::pair<std::string, double>>> adjacency_;
+    // unorderedPairKey of the ends -> position in edges_
+    std::unordered_map<uint64_t, size_t> edgeIndex_;
+
+    // Compressed sparse row adjacency over entity numbers, both ways along
+    // every edge. Strength changes are patched in; new entities and edges
+    // have it rebuilt when next needed.
+    std::unique_ptr<Graph> graph_;
+    size_t centralitySamples_ = DEFAULT_CENTRALITY_SAMPLES;
 
-    void updateAdjacency();
+    const Graph& updateAdjacency() const;
 };
 
 /**
@@ -480,10 +509,22 @@ public:
                      const std::string& to);
 
     /**
-     * Simulate gossip spread in network
+     * Simulate gossip spread in network: deliver the hops due by now
      */
     void simulateSpread(SocialNetwork& network, double spreadProbability = 0.3);
 
+    /**
+     * Advance the clock and deliver the hops that come due. Each entity
+     * hearing gossip schedules a hop, with the given chance, to each of
+     * its connections, arriving after a random delay averaging HOP_DELAY,
+     * so an update costs the hops it delivers rather than a pass over all
+     * gossip.
+     */
+    void update(double deltaTime, const SocialNetwork& network,
+                double spreadProbability = 0.3);
+
+    static constexpr double HOP_DELAY = 60.0;
+
     /**
      * Get gossip known by entity
      */
@@ -500,7 +541,25 @@ public:
     void decay(uint32_t currentTime, uint32_t maxAge);
 
 private:
+    struct Hop {
+        double time;
+        uint64_t order;             // Breaks ties in scheduling order
+        std::string gossipId;
+        std::string from;
+        std::string to;
+
+        bool operator>(const Hop& other) const {
+            return time != other.time ? time > other.time : order > other.order;
+        }
+    };
+
     std::map<std::string, Gossip> gossips_;
+    std::priority_queue<Hop, std::vector<Hop>, std::greater<Hop>> hops_;
+    std::vector<std::pair<std::string, std::string>> tellers_;  // Gossip, entity
+    double time_ = 0.0;
+    uint64_t hopCount_ = 0;
+    uint64_t nextGossip_ = 0;
+    std::mt19937 rng_{0x6055};
 };
 
 /**
@@ -613,7 +672,8 @@ public:
     void createFaction(const Faction& faction);
 
     /**
-     * Update system
+     * Update system: advance the clock relationships decay by, and spread
+     * gossip that comes due
      */
     void update(double deltaTime);
 
@@ -629,7 +689,8 @@ private:
     GossipSystem gossip_;
 
     std::map<std::string, Faction> factions_;
-    std::map<std::pair<std::string, std::string>, Relationship> relationships_;
+    std::unordered_map<uint64_t, Relationship> relationships_;     // By unorderedPairKey
+    double time_ = 0.0;
 
     std::string makeRelationshipKey(const std::string& a, const std::string& b) const;
 };
@@ -14,6 +14,7 @@
 #ifndef ULTIMA_NPC_URBAN_DYNAMICS_H
 #define ULTIMA_NPC_URBAN_DYNAMICS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -109,8 +110,8 @@ struct Parcel {
     // Properties
     double elevation = 0.0;
     double fertility = 0.5;         // For agriculture
-    double accessibility = 0.5;     // Distance to roads
-    double desirability = 0.5;
+    double accessibility = 0.5;     // Distance to roads, 1 on one
+    double desirability = 0.5;      // Access plus nearby amenities
 
     // Infrastructure
     bool hasRoad = false;
@@ -207,13 +208,17 @@ public:
     City(const std::string& id, int width, int height);
     ~City();
 
+    // The spatial index points into buildings
+    City(const City&) = delete;
+    City& operator=(const City&) = delete;
+
     std::string id;
     std::string name;
     int width;
     int height;
 
-    // Grid
-    std::vector<std::vector<Parcel>> grid;
+    // Grid, row by row: the parcel at (x, y) is parcels[y * width + x]
+    std::vector<Parcel> parcels;
 
     // Structures
     std::map<std::string, Building> buildings;
@@ -275,19 +280,124 @@ public:
      */
     std::vector<std::pair<int, int>> findPath(int x1, int y1, int x2, int y2) const;
 
+    /**
+     * Find paths from many points to one, sharing a single search from the
+     * goal.  The paths are in the order of starts, empty where unreachable.
+     */
+    std::vector<std::vector<std::pair<int, int>>> findPaths(
+        const std::vector<std::pair<int, int>>& starts, int x2, int y2) const;
+
     /**
      * Get buildings of type
      */
     std::vector<Building*> getBuildingsByType(BuildingType type);
 
+    /**
+     * Get the building of a type nearest (x, y), searching outward ring by
+     * ring of the index and no further than maxDistance cells when that's
+     * given.  Ties go to the lower id; nullptr if there's none in reach.
+     */
+    Building* findNearestBuilding(BuildingType type, int x, int y, int maxDistance = -1);
+
+    /**
+     * Get roads with a cell within radius cells of (x, y) either way.  The
+     * pointers hold until the next road is added.
+     */
+    std::vector<Road*> getRoadsNear(int x, int y, int radius);
+
     /**
      * Calculate statistics
      */
     void calculateStatistics();
 
+    /**
+     * Bring parcels' accessibility and desirability up to date with the
+     * roads and buildings added or removed since, recomputing only the
+     * parcels near the changes
+     */
+    void updateFields();
+
+    static constexpr int ROAD_REACH = 10;           // Cells a road gives access over
+    static constexpr int AMENITY_RADIUS = 4;        // Cells a building is felt over
+
 private:
-    void updateAccessibility();
-    void updateDesirability();
+    // Cells x0..x1 by y0..y1; empty when x0 > x1
+    struct Region {
+        int x0 = 0;
+        int y0 = 0;
+        int x1 = -1;
+        int y1 = -1;
+
+        bool empty() const { return x0 > x1 || y0 > y1; }
+        long area() const { return empty() ? 0 : long(x1 - x0 + 1) * (y1 - y0 + 1); }
+        void include(const Region& other);
+        Region grown(int by, int width, int height) const;
+    };
+
+    // Fields, as grids row by row like parcels: each cell's distance to
+    // the nearest road, to ROAD_REACH + 1; the amenity its buildings lend
+    // their surroundings; and that amenity summed along the row within
+    // AMENITY_RADIUS
+    std::vector<uint8_t> roadDistance_;
+    std::vector<float> amenity_;
+    std::vector<float> rowAmenity_;
+
+    // Changes the fields haven't caught up with
+    std::vector<int> newRoads_;
+    Region amenityChanged_;
+    bool fieldsStale_ = true;
+    int roadCells_ = 0;
+
+    void updateAccessibility(Region& changed);
+    void updateDesirability(const Region& region);
+    void sumRowAmenity(int y, int x0, int x1);
+    void markAmenity(const Building& building, float sign);
+
+    static constexpr int INDEX_CELL = 8;            // Cells a side per index bucket
+
+    // Buildings of one type, by id and by the buckets they cover
+    struct TypeIndex {
+        std::map<std::string, Building*> byId;
+        std::vector<std::vector<Building*>> buckets;
+    };
+
+    // Spatial index over INDEX_CELL square buckets, row by row: the
+    // buildings covering each bucket, and each road cell in it with its
+    // road.  Kept by addBuilding, removeBuilding and addRoad.
+    int bucketsWide_ = 0;
+    int bucketsHigh_ = 0;
+    std::vector<std::vector<Building*>> buildingBuckets_;
+    std::vector<std::vector<std::pair<int, int>>> roadBuckets_;
+    std::map<BuildingType, TypeIndex> types_;
+
+    Region footprint(const Building& building) const;
+    void indexBuilding(Building& building, bool add);
+
+    /**
+     * Search state kept between path searches, one entry per cell.  An
+     * entry only holds for the current search if its stamp is the current
+     * generation, so nothing needs clearing between searches.  Not safe to
+     * share between threads searching the same city.
+     */
+    struct PathContext {
+        std::vector<uint32_t> stamp;
+        std::vector<int> cost;
+        std::vector<int> parent;
+        std::vector<std::vector<int>> buckets;  // Open cells by cost estimate
+        size_t lowest = 0;                      // No open cell below this
+        uint32_t generation = 0;
+
+        bool seen(int cell) const { return stamp[cell] == generation; }
+        void visit(int cell, int g, int from);
+        void push(int f, int cell);
+        bool pop(int& cell, int& f);
+    };
+
+    mutable PathContext pathContext_;
+
+    PathContext& beginPathSearch() const;
+    bool isBlocked(int cell) const;
+    std::vector<std::pair<int, int>> tracePath(int from) const;
 };
 
 /**
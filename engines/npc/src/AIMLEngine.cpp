@@ -12,6 +12,7 @@
 #include <regex>
 #include <cctype>
 #include <filesystem>
+#include <set>
 
 namespace Ultima {
 namespace NPC {
@@ -282,112 +283,43 @@ PatternMatcher::PatternMatcher()
 
 PatternMatcher::~PatternMatcher() = default;
 
-void PatternMatcher::addCategory(const Category& category) {
-    categories_.push_back(category);
-}
-
-double PatternMatcher::calculateMatchScore(
-    const std::vector<PatternElement>& pattern,
-    const std::vector<std::string>& words,
-    std::vector<std::string>& captures) const
-{
-    captures.clear();
-    size_t pIdx = 0;
-    size_t wIdx = 0;
-
-    while (pIdx < pattern.size() && wIdx <= words.size()) {
-        const auto& elem = pattern[pIdx];
-
-        switch (elem.type) {
-            case PatternElementType::Word: {
-                if (wIdx >= words.size()) return 0.0;
-                std::string word = words[wIdx];
-                std::transform(word.begin(), word.end(), word.begin(), ::toupper);
-                if (word != elem.value) return 0.0;
-                wIdx++;
-                pIdx++;
-                break;
-            }
-
-            case PatternElementType::Wildcard: {
-                // * matches one or more words
-                if (wIdx >= words.size()) return 0.0;
-
-                // Find where this wildcard ends
-                if (pIdx + 1 >= pattern.size()) {
-                    // Consume rest
-                    std::string captured;
-                    for (size_t i = wIdx; i < words.size(); ++i) {
-                        if (!captured.empty()) captured += " ";
-                        captured += words[i];
-                    }
-                    captures.push_back(captured);
-                    wIdx = words.size();
-                    pIdx++;
-                } else {
-                    // Find next word match
-                    const auto& nextElem = pattern[pIdx + 1];
-                    if (nextElem.type == PatternElementType::Word) {
-                        std::string captured;
-                        while (wIdx < words.size()) {
-                            std::string word = words[wIdx];
-                            std::transform(word.begin(), word.end(), word.begin(), ::toupper);
-                            if (word == nextElem.value) break;
-                            if (!captured.empty()) captured += " ";
-                            captured += words[wIdx];
-                            wIdx++;
-                        }
-                        if (captured.empty()) return 0.0;
-                        captures.push_back(captured);
-                        pIdx++;
-                    } else {
-                        // Greedy match one word
-                        captures.push_back(words[wIdx]);
-                        wIdx++;
-                        pIdx++;
-                    }
-                }
-                break;
-            }
+namespace {
 
-            case PatternElementType::WildcardZero: {
-                // ^ matches zero or more
-                if (pIdx + 1 >= pattern.size()) {
-                    std::string captured;
-                    for (size_t i = wIdx; i < words.size(); ++i) {
-                        if (!captured.empty()) captured += " ";
-                        captured += words[i];
-                    }
-                    captures.push_back(captured);
-                    wIdx = words.size();
-                    pIdx++;
-                } else {
-                    captures.push_back("");
-                    pIdx++;
-                }
-                break;
-            }
-
-            case PatternElementType::WildcardOne: {
-                // _ matches exactly one
-                if (wIdx >= words.size()) return 0.0;
-                captures.push_back(words[wIdx]);
-                wIdx++;
-                pIdx++;
-                break;
-            }
+bool isWordPunctuation(char c) {
+    return std::ispunct(static_cast<unsigned char>(c)) && c != '\'';
+}
 
-            default:
-                pIdx++;
-                break;
+// A <that> or topic pattern, which matches anything if left out
+std::vector<PatternElement> contextPattern(const std::string& text) {
+    std::vector<PatternElement> elements;
+    std::istringstream iss(text);
+    std::string word;
+    while (iss >> word) {
+        PatternElement elem;
+        if (word == "*") {
+            elem.type = PatternElementType::Wildcard;
+        } else if (word == "^") {
+            elem.type = PatternElementType::WildcardZero;
+        } else if (word == "_") {
+            elem.type = PatternElementType::WildcardOne;
+        } else {
+            word.erase(std::remove_if(word.begin(), word.end(), isWordPunctuation),
+                       word.end());
+            if (word.empty()) continue;
+            std::transform(word.begin(), word.end(), word.begin(), ::toupper);
+            elem.type = PatternElementType::Word;
+            elem.value = word;
         }
+        elements.push_back(elem);
     }
-
-    if (pIdx < pattern.size() || wIdx < words.size()) {
-        return 0.0;
+    if (elements.empty()) {
+        elements.push_back({PatternElementType::Wildcard, ""});
     }
+    return elements;
+}
 
-    // Calculate confidence based on specificity
+// Confidence in a match, from how specific its pattern is
+double patternScore(const std::vector<PatternElement>& pattern) {
     double score = 1.0;
     int wildcardCount = 0;
     for (const auto& elem : pattern) {
@@ -404,37 +336,267 @@ double PatternMatcher::calculateMatchScore(
     return std::max(0.0, std::min(1.0, score));
 }
 
-MatchResult PatternMatcher::match(const std::string& input,
-                                  const std::string& that,
-                                  const std::string& topic) const
-{
-    MatchResult best;
+} // namespace
 
-    // Tokenize input
-    std::vector<std::string> words;
-    std::istringstream iss(input);
-    std::string word;
-    while (iss >> word) {
-        words.push_back(word);
+void PatternMatcher::addSubstitution(const std::string& word, const std::string& replacement) {
+    std::string key = word;
+    std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+    substitutions_[key] = replacement;
+}
+
+void PatternMatcher::tokenize(const std::string& text, TokenizedInput& tokens) const {
+    tokens.ids.clear();
+    tokens.text.clear();
+    tokens.starts.clear();
+
+    auto append = [this, &tokens](const char* begin, const char* end) {
+        std::string& word = tokens.word;
+        word.clear();
+        for (const char* c = begin; c != end; ++c) {
+            if (!isWordPunctuation(*c)) {
+                word += static_cast<char>(std::toupper(static_cast<unsigned char>(*c)));
+            }
+        }
+        if (word.empty()) {
+            return;
+        }
+        if (!tokens.text.empty()) {
+            tokens.text += ' ';
+        }
+        tokens.starts.push_back(static_cast<uint32_t>(tokens.text.size()));
+        for (const char* c = begin; c != end; ++c) {
+            if (!isWordPunctuation(*c)) {
+                tokens.text += *c;
+            }
+        }
+        auto it = vocabulary_.find(word);
+        tokens.ids.push_back(it != vocabulary_.end() ? it->second : UNKNOWN_WORD);
+    };
+
+    const char* const end = text.data() + text.size();
+    const char* pos = text.data();
+    for (;;) {
+        while (pos != end && std::isspace(static_cast<unsigned char>(*pos))) ++pos;
+        if (pos == end) break;
+        const char* wordEnd = pos;
+        while (wordEnd != end && !std::isspace(static_cast<unsigned char>(*wordEnd))) ++wordEnd;
+
+        auto sub = substitutions_.end();
+        if (!substitutions_.empty()) {
+            std::string& word = tokens.word;
+            word.clear();
+            for (const char* c = pos; c != wordEnd; ++c) {
+                if (!isWordPunctuation(*c)) {
+                    word += static_cast<char>(std::toupper(static_cast<unsigned char>(*c)));
+                }
+            }
+            sub = substitutions_.find(word);
+        }
+        if (sub != substitutions_.end()) {
+            // Replacements are split into words, but not substituted again
+            const std::string& replacement = sub->second;
+            const char* r = replacement.data();
+            const char* const rEnd = r + replacement.size();
+            for (;;) {
+                while (r != rEnd && std::isspace(static_cast<unsigned char>(*r))) ++r;
+                if (r == rEnd) break;
+                const char* rWordEnd = r;
+                while (rWordEnd != rEnd && !std::isspace(static_cast<unsigned char>(*rWordEnd))) ++rWordEnd;
+                append(r, rWordEnd);
+                r = rWordEnd;
+            }
+        } else {
+            append(pos, wordEnd);
+        }
+        pos = wordEnd;
     }
+}
+
+uint32_t PatternMatcher::intern(const std::string& word) {
+    auto it = vocabulary_.emplace(word, static_cast<uint32_t>(vocabulary_.size())).first;
+    return it->second;
+}
+
+void PatternMatcher::addCategory(Category category) {
+    categories_.push_back(std::move(category));
+    const Category& added = categories_.back();
+
+    auto descend = [](std::unique_ptr<GraphNode>& node) {
+        if (!node) {
+            node = std::make_unique<GraphNode>();
+        }
+        return node.get();
+    };
+    auto insert = [this, &descend](GraphNode* node, const std::vector<PatternElement>& pattern) {
+        for (const auto& elem : pattern) {
+            switch (elem.type) {
+                case PatternElementType::Word:
+                    node = descend(node->children[intern(elem.value)]);
+                    break;
+                case PatternElementType::WildcardOne:
+                    node = descend(node->one);
+                    break;
+                case PatternElementType::WildcardZero:
+                    node = descend(node->zeroOrMore);
+                    break;
+                case PatternElementType::Wildcard:
+                    node = descend(node->oneOrMore);
+                    break;
+                default:
+                    // Sets and bot properties aren't known here, so match
+                    // no words
+                    break;
+            }
+        }
+        return node;
+    };
+
+    GraphNode* node = insert(root_.get(), added.pattern);
+    node = insert(descend(node->next), contextPattern(added.that));
+    node = insert(descend(node->next), contextPattern(added.topic));
+    node->categories.push_back(&added);
+}
 
-    for (const auto& cat : categories_) {
-        // Check topic filter
-        if (!cat.topic.empty() && cat.topic != topic) continue;
+/**
+ * One walk through the graph for the input, <that> and topic, trying the
+ * branches in order of priority until found() is satisfied
+ */
+struct PatternMatcher::Search {
+    enum { INPUT, THAT, TOPIC, SEGMENTS };
+
+    const TokenizedInput* segments[SEGMENTS] = {};
+    // Words each wildcard took, as [first, last)
+    std::vector<std::pair<uint32_t, uint32_t>> stars[SEGMENTS];
+    // Reached the end of every segment with these categories. Return true
+    // to stop.
+    std::function<bool(const std::vector<const Category*>&)> found;
+    bool anyContext = false;    // Ignore the <that> and topic
+
+    bool from(const GraphNode* node, int segment, uint32_t pos) {
+        const TokenizedInput& words = *segments[segment];
+        const uint32_t size = static_cast<uint32_t>(words.ids.size());
+        if (pos == size) {
+            if (segment == TOPIC) {
+                if (!node->categories.empty() && found(node->categories)) {
+                    return true;
+                }
+            } else if (node->next) {
+                if (segment == INPUT && anyContext) {
+                    return all(node->next.get());
+                }
+                if (from(node->next.get(), segment + 1, 0)) {
+                    return true;
+                }
+            }
+        }
 
-        // Check that filter
-        if (!cat.that.empty() && cat.that != that) continue;
+        if (node->one && pos < size && wildcard(node->one.get(), segment, pos, 1, 1)) {
+            return true;
+        }
+        if (pos < size && words.ids[pos] != UNKNOWN_WORD) {
+            auto it = node->children.find(words.ids[pos]);
+            if (it != node->children.end() && from(it->second.get(), segment, pos + 1)) {
+                return true;
+            }
+        }
+        if (node->zeroOrMore && wildcard(node->zeroOrMore.get(), segment, pos, 0, size - pos)) {
+            return true;
+        }
+        // Past the input, * stands for a <that> or topic left out, which
+        // is there to match even when the conversation has none
+        const uint32_t least = segment == INPUT ? 1 : 0;
+        if (node->oneOrMore && pos + least <= size &&
+            wildcard(node->oneOrMore.get(), segment, pos, least, size - pos)) {
+            return true;
+        }
+        return false;
+    }
 
-        std::vector<std::string> captures;
-        double score = calculateMatchScore(cat.pattern, words, captures);
+    // Take from least to most words, then carry on from node
+    bool wildcard(const GraphNode* node, int segment, uint32_t pos,
+                  uint32_t least, uint32_t most) {
+        for (uint32_t n = least; n <= most; ++n) {
+            stars[segment].emplace_back(pos, pos + n);
+            if (from(node, segment, pos + n)) {
+                return true;
+            }
+            stars[segment].pop_back();
+        }
+        return false;
+    }
+
+    // Every category below node, whatever its path
+    bool all(const GraphNode* node) {
+        if (!node->categories.empty() && found(node->categories)) {
+            return true;
+        }
+        for (const auto& child : node->children) {
+            if (all(child.second.get())) return true;
+        }
+        for (const GraphNode* child : {node->one.get(), node->zeroOrMore.get(),
+                                       node->oneOrMore.get(), node->next.get()}) {
+            if (child && all(child)) return true;
+        }
+        return false;
+    }
 
-        if (score > best.confidence) {
-            best.matched = true;
-            best.category = &cat;
-            best.stars = captures;
-            best.confidence = score;
+    // The text each wildcard of a segment took
+    std::vector<std::string> captured(int segment) const {
+        const TokenizedInput& words = *segments[segment];
+        std::vector<std::string> texts;
+        texts.reserve(stars[segment].size());
+        for (const auto& star : stars[segment]) {
+            if (star.first == star.second) {
+                texts.emplace_back();
+                continue;
+            }
+            const size_t begin = words.starts[star.first];
+            const size_t end = star.second < words.starts.size()
+                ? words.starts[star.second] - 1 : words.text.size();
+            texts.emplace_back(words.text, begin, end - begin);
         }
+        return texts;
     }
+};
+
+MatchResult PatternMatcher::match(const std::string& input,
+                                  const std::string& that,
+                                  const std::string& topic) const
+{
+    TokenizedInput tokens[3];
+    tokenize(input, tokens[0]);
+    tokenize(that, tokens[1]);
+    tokenize(topic, tokens[2]);
+    return match(tokens[0], tokens[1], tokens[2]);
+}
+
+MatchResult PatternMatcher::match(const TokenizedInput& input,
+                                  const TokenizedInput& that,
+                                  const TokenizedInput& topic) const
+{
+    MatchResult best;
+
+    Search search;
+    search.segments[Search::INPUT] = &input;
+    search.segments[Search::THAT] = &that;
+    search.segments[Search::TOPIC] = &topic;
+    search.found = [&](const std::vector<const Category*>& categories) {
+        // Of categories sharing a path, the first of highest priority
+        const Category* chosen = categories.front();
+        for (const Category* cat : categories) {
+            if (cat->priority > chosen->priority) {
+                chosen = cat;
+            }
+        }
+        best.matched = true;
+        best.category = chosen;
+        best.stars = search.captured(Search::INPUT);
+        best.thatStars = search.captured(Search::THAT);
+        best.topicStars = search.captured(Search::TOPIC);
+        best.confidence = patternScore(chosen->pattern);
+        return true;
+    };
+    search.from(root_.get(), Search::INPUT, 0);
 
     return best;
 }
@@ -443,38 +605,42 @@ std::vector<MatchResult> PatternMatcher::findAllMatches(const std::string& input
                                                         double minConfidence) const
 {
     std::vector<MatchResult> results;
+    std::set<const Category*> seen;
+
+    TokenizedInput tokens;
+    tokenize(input, tokens);
+    Search search;
+    search.segments[Search::INPUT] = &tokens;
+    search.anyContext = true;
+    search.found = [&](const std::vector<const Category*>& categories) {
+        for (const Category* cat : categories) {
+            const double score = patternScore(cat->pattern);
+            if (score < minConfidence || !seen.insert(cat).second) {
+                continue;
+            }
 
-    std::vector<std::string> words;
-    std::istringstream iss(input);
-    std::string word;
-    while (iss >> word) {
-        words.push_back(word);
-    }
-
-    for (const auto& cat : categories_) {
-        std::vector<std::string> captures;
-        double score = calculateMatchScore(cat.pattern, words, captures);
-
-        if (score >= minConfidence) {
             MatchResult result;
             result.matched = true;
-            result.category = &cat;
-            result.stars = captures;
+            result.category = cat;
+            result.stars = search.captured(Search::INPUT);
             result.confidence = score;
             results.push_back(result);
         }
-    }
+        return false;
+    };
+    search.from(root_.get(), Search::INPUT, 0);
 
-    std::sort(results.begin(), results.end(),
-              [](const MatchResult& a, const MatchResult& b) {
-                  return a.confidence > b.confidence;
-              });
+    std::stable_sort(results.begin(), results.end(),
+                     [](const MatchResult& a, const MatchResult& b) {
+                         return a.confidence > b.confidence;
+                     });
 
     return results;
 }
 
 void PatternMatcher::clear() {
     categories_.clear();
+    vocabulary_.clear();
     root_ = std::make_unique<GraphNode>();
 }
 
@@ -796,16 +962,21 @@ AIMLEngine::AIMLEngine() {
 AIMLEngine::~AIMLEngine() = default;
 
 bool AIMLEngine::loadFile(const std::string& filename) {
+    const BrainFile::Source source = BrainFile::Source::of(filename);
     auto categories = parser_.parseFile(filename);
     for (const auto& cat : categories) {
         matcher_.addCategory(cat);
     }
+    if (!source.path.empty()) {
+        sources_.push_back(source);
+    }
     return !parser_.getErrors().empty();
 }
 
 bool AIMLEngine::loadDirectory(const std::string& directory, const std::string& pattern) {
     namespace fs = std::filesystem;
 
+    std::vector<fs::path> files;
     try {
         for (const auto& entry : fs::directory_iterator(directory)) {
             if (entry.is_regular_file()) {
@@ -813,14 +984,53 @@ bool AIMLEngine::loadDirectory(const std::string& directory, const std::string&
                 // Simple pattern matching
                 if (pattern == "*.aiml" && filename.size() > 5 &&
                     filename.substr(filename.size() - 5) == ".aiml") {
-                    loadFile(entry.path().string());
+                    files.push_back(entry.path().lexically_normal());
                 }
             }
         }
-        return true;
     } catch (...) {
         return false;
     }
+    std::sort(files.begin(), files.end());
+
+    // A brain compiled from just these files saves parsing them
+    std::vector<BrainFile::Source> sources;
+    std::vector<Category> categories;
+    if (BrainFile::read((fs::path(directory) / BrainFile::DEFAULT_NAME).string(),
+                        sources, categories) &&
+        sources.size() == files.size() &&
+        std::equal(files.begin(), files.end(), sources.begin(),
+                   [](const fs::path& file, const BrainFile::Source& source) {
+                       return file == fs::path(source.path);
+                   })) {
+        for (auto& cat : categories) {
+            matcher_.addCategory(std::move(cat));
+        }
+        sources_.insert(sources_.end(), sources.begin(), sources.end());
+        return true;
+    }
+
+    for (const auto& file : files) {
+        loadFile(file.string());
+    }
+    return true;
+}
+
+bool AIMLEngine::saveBrain(const std::string& filename) const {
+    return BrainFile::write(filename, sources_, matcher_);
+}
+
+bool AIMLEngine::loadBrain(const std::string& filename) {
+    std::vector<BrainFile::Source> sources;
+    std::vector<Category> categories;
+    if (!BrainFile::read(filename, sources, categories)) {
+        return false;
+    }
+    for (auto& cat : categories) {
+        matcher_.addCategory(std::move(cat));
+    }
+    sources_.insert(sources_.end(), sources.begin(), sources.end());
+    return true;
 }
 
 std::string AIMLEngine::normalizeInput(const std::string& input) const {
@@ -852,10 +1062,15 @@ std::string AIMLEngine::respond(const std::string& input, SessionContext& contex
     std::string normalized = normalizeInput(input);
     context.inputHistory.push_back(normalized);
 
-    std::string that = context.responseHistory.empty() ? "" :
+    static const std::string none;
+    const std::string& that = context.responseHistory.empty() ? none :
         context.responseHistory.back();
 
-    auto match = matcher_.match(normalized, that, context.topic);
+    matcher_.tokenize(normalized, context.inputTokens);
+    matcher_.tokenize(that, context.thatTokens);
+    matcher_.tokenize(context.topic, context.topicTokens);
+    auto match = matcher_.match(context.inputTokens, context.thatTokens,
+                                context.topicTokens);
 
     std::string response;
     if (match.matched && match.category) {
@@ -0,0 +1,320 @@
+/**
+ * Archive.cpp - Compact Binary Archives
+ */
+
+#include "persistence/Archive.h"
+#include <cstring>
+#include <fstream>
+
+#ifdef NPC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace Ultima {
+namespace NPC {
+namespace Persistence {
+
+namespace {
+
+const char MAGIC[4] = {'N', 'P', 'C', 'A'};
+const uint64_t FLAG_DEFLATED = 1;
+const uint64_t MAX_PAYLOAD = 1ull << 32;    // Refuse to inflate more
+
+} // namespace
+
+bool compressionAvailable() {
+#ifdef NPC_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool saveArchive(const std::string& filename, const std::string& archive) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(archive.data(), static_cast<std::streamsize>(archive.size()));
+    return static_cast<bool>(out.flush());
+}
+
+bool loadArchive(const std::string& filename, std::string& archive) {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    const std::streamoff size = in.tellg();
+    if (size < 0) {
+        return false;
+    }
+    std::string data(static_cast<size_t>(size), '\0');
+    in.seekg(0);
+    if (!in.read(&data[0], size)) {
+        return false;
+    }
+    archive = std::move(data);
+    return true;
+}
+
+//=============================================================================
+// ArchiveWriter Implementation
+//=============================================================================
+
+void ArchiveWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        bytes_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    bytes_.push_back(static_cast<char>(value));
+}
+
+void ArchiveWriter::putSigned(int64_t value) {
+    putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void ArchiveWriter::putDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        bytes_.push_back(static_cast<char>(bits >> (8 * i)));
+    }
+}
+
+void ArchiveWriter::putFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        bytes_.push_back(static_cast<char>(bits >> (8 * i)));
+    }
+}
+
+void ArchiveWriter::putString(const std::string& value) {
+    // 0 and the string the first time, its number + 1 after that
+    auto it = strings_.find(value);
+    if (it != strings_.end()) {
+        putVarint(it->second + 1);
+        return;
+    }
+    strings_.emplace(value, strings_.size());
+    putVarint(0);
+    putVarint(value.size());
+    bytes_.append(value);
+}
+
+void ArchiveWriter::putStrings(const std::vector<std::string>& values) {
+    putVarint(values.size());
+    for (const auto& value : values) {
+        putString(value);
+    }
+}
+
+void ArchiveWriter::putSection(uint32_t tag, const ArchiveWriter& section) {
+    putSection(tag, section.bytes_);
+}
+
+void ArchiveWriter::putSection(uint32_t tag, const std::string& bytes) {
+    putVarint(tag);
+    putVarint(bytes.size());
+    bytes_.append(bytes);
+}
+
+std::string ArchiveWriter::finish(bool compress) const {
+    std::string payload = bytes_;
+    uint64_t flags = 0;
+#ifdef NPC_HAVE_ZLIB
+    if (compress && !bytes_.empty()) {
+        uLongf size = compressBound(static_cast<uLong>(bytes_.size()));
+        std::string deflated(size, '\0');
+        if (compress2(reinterpret_cast<Bytef*>(&deflated[0]), &size,
+                      reinterpret_cast<const Bytef*>(bytes_.data()),
+                      static_cast<uLong>(bytes_.size()), Z_DEFAULT_COMPRESSION) == Z_OK &&
+            size < bytes_.size()) {
+            deflated.resize(size);
+            payload = std::move(deflated);
+            flags |= FLAG_DEFLATED;
+        }
+    }
+#else
+    (void)compress;
+#endif
+
+    ArchiveWriter header;
+    header.bytes_.append(MAGIC, sizeof(MAGIC));
+    header.putVarint(ARCHIVE_VERSION);
+    header.putVarint(flags);
+    header.putVarint(bytes_.size());
+    return header.bytes_ + payload;
+}
+
+//=============================================================================
+// ArchiveReader Implementation
+//=============================================================================
+
+ArchiveReader::ArchiveReader(const char* data, size_t size)
+    : pos_(data), end_(data + size) {}
+
+bool ArchiveReader::open(const std::string& archive, std::string& payload) {
+    if (archive.size() < sizeof(MAGIC) ||
+        std::memcmp(archive.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    ArchiveReader reader(archive.data() + sizeof(MAGIC), archive.size() - sizeof(MAGIC));
+    const uint64_t version = reader.getVarint();
+    const uint64_t flags = reader.getVarint();
+    const uint64_t size = reader.getVarint();
+    if (!reader.ok() || version != ARCHIVE_VERSION || (flags & ~FLAG_DEFLATED) != 0) {
+        return false;
+    }
+    const size_t offset = archive.size() - static_cast<size_t>(reader.end_ - reader.pos_);
+
+    if (!(flags & FLAG_DEFLATED)) {
+        if (archive.size() - offset != size) {
+            return false;
+        }
+        payload = archive.substr(offset);
+        return true;
+    }
+#ifdef NPC_HAVE_ZLIB
+    if (size > MAX_PAYLOAD) {
+        return false;
+    }
+    std::string inflated(static_cast<size_t>(size), '\0');
+    uLongf inflatedSize = static_cast<uLongf>(size);
+    if (uncompress(reinterpret_cast<Bytef*>(&inflated[0]), &inflatedSize,
+                   reinterpret_cast<const Bytef*>(archive.data() + offset),
+                   static_cast<uLong>(archive.size() - offset)) != Z_OK ||
+        inflatedSize != size) {
+        return false;
+    }
+    payload = std::move(inflated);
+    return true;
+#else
+    (void)MAX_PAYLOAD;
+    return false;
+#endif
+}
+
+size_t ArchiveReader::payloadSize(const std::string& archive) {
+    if (archive.size() < sizeof(MAGIC) ||
+        std::memcmp(archive.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return 0;
+    }
+    ArchiveReader reader(archive.data() + sizeof(MAGIC), archive.size() - sizeof(MAGIC));
+    const uint64_t version = reader.getVarint();
+    reader.getVarint();
+    const uint64_t size = reader.getVarint();
+    if (!reader.ok() || version != ARCHIVE_VERSION) {
+        return 0;
+    }
+    return static_cast<size_t>(size);
+}
+
+bool ArchiveReader::take(void* out, size_t size) {
+    if (!ok_ || static_cast<size_t>(end_ - pos_) < size) {
+        ok_ = false;
+        std::memset(out, 0, size);
+        return false;
+    }
+    std::memcpy(out, pos_, size);
+    pos_ += size;
+    return true;
+}
+
+uint64_t ArchiveReader::getVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && ok_; shift += 7) {
+        if (pos_ == end_) {
+            break;
+        }
+        const uint8_t byte = static_cast<uint8_t>(*pos_++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    ok_ = false;
+    return 0;
+}
+
+int64_t ArchiveReader::getSigned() {
+    const uint64_t value = getVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+double ArchiveReader::getDouble() {
+    uint8_t bytes[8];
+    take(bytes, sizeof(bytes));
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+float ArchiveReader::getFloat() {
+    uint8_t bytes[4];
+    take(bytes, sizeof(bytes));
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string ArchiveReader::getString() {
+    const uint64_t index = getVarint();
+    if (index > 0) {
+        if (index > strings_.size()) {
+            ok_ = false;
+            return std::string();
+        }
+        return strings_[index - 1];
+    }
+    const size_t length = getCount();
+    if (!ok_) {
+        return std::string();
+    }
+    strings_.emplace_back(pos_, length);
+    pos_ += length;
+    return strings_.back();
+}
+
+std::vector<std::string> ArchiveReader::getStrings() {
+    std::vector<std::string> values(getCount());
+    for (auto& value : values) {
+        value = getString();
+    }
+    return values;
+}
+
+size_t ArchiveReader::getCount(size_t minBytes) {
+    const uint64_t count = getVarint();
+    if (count > static_cast<uint64_t>(end_ - pos_) / minBytes) {
+        ok_ = false;
+        return 0;
+    }
+    return static_cast<size_t>(count);
+}
+
+bool ArchiveReader::nextSection(uint32_t& tag, std::string& bytes) {
+    if (!ok_ || atEnd()) {
+        return false;
+    }
+    tag = static_cast<uint32_t>(getVarint());
+    const size_t size = getCount();
+    if (!ok_) {
+        return false;
+    }
+    bytes.assign(pos_, size);
+    pos_ += size;
+    return true;
+}
+
+} // namespace Persistence
+} // namespace NPC
+} // namespace Ultima
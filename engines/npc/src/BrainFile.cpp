@@ -0,0 +1,301 @@
+/**
+ * BrainFile.cpp - Compiled AIML Brains
+ */
+
+#include "aiml/BrainFile.h"
+#include "aiml/AIMLEngine.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace Ultima {
+namespace NPC {
+namespace AIML {
+
+namespace {
+
+const char MAGIC[4] = {'A', 'I', 'M', 'B'};
+const uint32_t VERSION = 1;
+const int MAX_DEPTH = 64;       // Of template elements
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t stringCount;
+    uint32_t sourceCount;
+    uint32_t categoryCount;
+};
+
+// Builds the sources and categories, numbering strings as it goes
+class Writer {
+public:
+    std::vector<const std::string*> strings;
+    std::string body;
+
+    template <typename T>
+    void put(T value) {
+        body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void putString(const std::string& s) {
+        auto it = ids_.find(s);
+        if (it == ids_.end()) {
+            it = ids_.emplace(s, static_cast<uint32_t>(strings.size())).first;
+            strings.push_back(&it->first);
+        }
+        put(it->second);
+    }
+
+    void putTemplate(const std::vector<TemplateElement>& elements) {
+        put(static_cast<uint32_t>(elements.size()));
+        for (const auto& elem : elements) {
+            put(static_cast<uint8_t>(elem.type));
+            putString(elem.value);
+            put(static_cast<uint32_t>(elem.attributes.size()));
+            for (const auto& attr : elem.attributes) {
+                putString(attr.first);
+                putString(attr.second);
+            }
+            putTemplate(elem.children);
+        }
+    }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_;
+};
+
+// Reads the file back, failing on anything out of bounds
+class Reader {
+public:
+    Reader(const std::string& data) : pos_(data.data()), end_(data.data() + data.size()) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == end_; }
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (static_cast<size_t>(end_ - pos_) < sizeof(value)) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, pos_, sizeof(value));
+        pos_ += sizeof(value);
+        return value;
+    }
+
+    // A count of things at least minBytes long each, no more than are left
+    uint32_t getCount(size_t minBytes) {
+        const uint32_t count = get<uint32_t>();
+        if (count > static_cast<size_t>(end_ - pos_) / minBytes) {
+            ok_ = false;
+            return 0;
+        }
+        return count;
+    }
+
+    void readStrings(uint32_t count) {
+        if (count > static_cast<size_t>(end_ - pos_) / sizeof(uint32_t)) {
+            ok_ = false;
+            return;
+        }
+        strings_.reserve(count);
+        for (uint32_t i = 0; i < count && ok_; ++i) {
+            const uint32_t length = get<uint32_t>();
+            if (length > static_cast<size_t>(end_ - pos_)) {
+                ok_ = false;
+                break;
+            }
+            strings_.emplace_back(pos_, length);
+            pos_ += length;
+        }
+    }
+
+    const std::string& getString() {
+        static const std::string empty;
+        const uint32_t id = get<uint32_t>();
+        if (id >= strings_.size()) {
+            ok_ = false;
+            return empty;
+        }
+        return strings_[id];
+    }
+
+    bool getTemplate(std::vector<TemplateElement>& elements, int depth) {
+        if (depth > MAX_DEPTH) {
+            ok_ = false;
+            return false;
+        }
+        elements.resize(getCount(13));
+        const size_t count = elements.size();
+        for (size_t i = 0; i < count && ok_; ++i) {
+            TemplateElement& elem = elements[i];
+            const uint8_t type = get<uint8_t>();
+            if (type > static_cast<uint8_t>(TemplateElementType::System)) {
+                ok_ = false;
+                break;
+            }
+            elem.type = static_cast<TemplateElementType>(type);
+            elem.value = getString();
+            const uint32_t attributes = getCount(8);
+            for (uint32_t a = 0; a < attributes && ok_; ++a) {
+                const std::string& name = getString();
+                elem.attributes[name] = getString();
+            }
+            getTemplate(elem.children, depth + 1);
+        }
+        return ok_;
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+    bool ok_ = true;
+    std::vector<std::string> strings_;
+};
+
+} // namespace
+
+BrainFile::Source BrainFile::Source::of(const std::string& path) {
+    namespace fs = std::filesystem;
+    Source source;
+    std::error_code error;
+    const uint64_t size = fs::file_size(path, error);
+    if (error) {
+        return source;
+    }
+    const auto modified = fs::last_write_time(path, error);
+    if (error) {
+        return source;
+    }
+    source.path = path;
+    source.size = size;
+    source.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    return source;
+}
+
+bool BrainFile::Source::isCurrent() const {
+    const Source now = of(path);
+    return !now.path.empty() && now.size == size && now.modified == modified;
+}
+
+bool BrainFile::write(const std::string& filename,
+                      const std::vector<Source>& sources,
+                      const PatternMatcher& matcher) {
+    namespace fs = std::filesystem;
+    const std::deque<Category>& categories = matcher.getCategories();
+    // Sources are kept relative to the brain, so the two can move together
+    const fs::path base = fs::path(filename).parent_path();
+    Writer writer;
+    for (const auto& source : sources) {
+        writer.putString(fs::path(source.path).lexically_proximate(base).generic_string());
+        writer.put(source.size);
+        writer.put(source.modified);
+    }
+    for (const auto& cat : categories) {
+        writer.put(static_cast<uint32_t>(cat.pattern.size()));
+        for (const auto& elem : cat.pattern) {
+            writer.put(static_cast<uint8_t>(elem.type));
+            writer.putString(elem.value);
+        }
+        writer.putString(cat.that);
+        writer.putString(cat.topic);
+        writer.put(static_cast<int32_t>(cat.priority));
+        writer.putString(cat.sourceFile);
+        writer.put(static_cast<int32_t>(cat.sourceLine));
+        writer.putTemplate(cat.templateElements);
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.stringCount = static_cast<uint32_t>(writer.strings.size());
+    header.sourceCount = static_cast<uint32_t>(sources.size());
+    header.categoryCount = static_cast<uint32_t>(categories.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const std::string* s : writer.strings) {
+        const uint32_t length = static_cast<uint32_t>(s->size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(s->data(), static_cast<std::streamsize>(length));
+    }
+    out.write(writer.body.data(), static_cast<std::streamsize>(writer.body.size()));
+    return static_cast<bool>(out.flush());
+}
+
+bool BrainFile::read(const std::string& filename,
+                     std::vector<Source>& sources,
+                     std::vector<Category>& categories) {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    const std::streamoff fileSize = in.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(FileHeader))) {
+        return false;
+    }
+    std::string data(static_cast<size_t>(fileSize), '\0');
+    in.seekg(0);
+    if (!in.read(&data[0], fileSize)) {
+        return false;
+    }
+
+    Reader reader(data);
+    const FileHeader header = reader.get<FileHeader>();
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION) {
+        return false;
+    }
+    reader.readStrings(header.stringCount);
+
+    if (header.sourceCount > data.size() / 20) {
+        return false;
+    }
+    const std::filesystem::path base = std::filesystem::path(filename).parent_path();
+    std::vector<Source> readSources(header.sourceCount);
+    for (auto& source : readSources) {
+        source.path = (base / reader.getString()).lexically_normal().string();
+        source.size = reader.get<uint64_t>();
+        source.modified = reader.get<int64_t>();
+        if (!reader.ok() || !source.isCurrent()) {
+            return false;
+        }
+    }
+
+    std::vector<Category> readCategories;
+    readCategories.reserve(std::min<size_t>(header.categoryCount, data.size() / 24));
+    for (uint32_t c = 0; c < header.categoryCount && reader.ok(); ++c) {
+        Category cat;
+        cat.pattern.resize(reader.getCount(5));
+        for (auto& elem : cat.pattern) {
+            const uint8_t type = reader.get<uint8_t>();
+            if (type > static_cast<uint8_t>(PatternElementType::Bot)) {
+                return false;
+            }
+            elem.type = static_cast<PatternElementType>(type);
+            elem.value = reader.getString();
+        }
+        cat.that = reader.getString();
+        cat.topic = reader.getString();
+        cat.priority = reader.get<int32_t>();
+        cat.sourceFile = reader.getString();
+        cat.sourceLine = reader.get<int32_t>();
+        reader.getTemplate(cat.templateElements, 0);
+        readCategories.push_back(std::move(cat));
+    }
+    if (!reader.ok() || !reader.atEnd()) {
+        return false;
+    }
+
+    sources = std::move(readSources);
+    categories = std::move(readCategories);
+    return true;
+}
+
+} // namespace AIML
+} // namespace NPC
+} // namespace Ultima
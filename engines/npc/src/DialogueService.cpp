@@ -0,0 +1,282 @@
+/**
+ * DialogueService.cpp - Background Dialogue Generation
+ */
+
+#include "llm/DialogueService.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Ultima {
+namespace NPC {
+namespace LLM {
+
+using Clock = std::chrono::steady_clock;
+
+struct DialogueService::Impl {
+    struct Job {
+        DialogueRequest request;
+        ResultCallback onResult;
+        PartialCallback onPartial;
+        bool hasDeadline = false;
+        Clock::time_point deadline;
+
+        int worker = -1;            // Generating it, or -1
+        bool cancelled = false;     // Dropped while generating
+        std::atomic<bool> stop{false};  // Tells the worker's TinyLLM
+        bool finished = false;
+        std::string partial;
+        bool partialChanged = false;
+        DialogueResult result;
+    };
+
+    struct Worker {
+        TinyLLM llm;
+        std::thread thread;
+    };
+
+    // Everything below is shared with the workers, under mutex
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::map<JobId, Job> jobs;      // Oldest first
+    std::deque<JobId> queue;        // Waiting for a worker
+    std::vector<std::unique_ptr<Worker>> workers;
+    JobId nextId = 1;
+    bool running = false;
+    bool stopping = false;
+
+    // Forget a job. One being generated is stopped, and is forgotten by
+    // its worker when it is.
+    std::map<JobId, Job>::iterator drop(std::map<JobId, Job>::iterator it) {
+        Job& job = it->second;
+        if (job.worker < 0) {
+            return jobs.erase(it);
+        }
+        job.cancelled = true;
+        job.stop = true;
+        return ++it;
+    }
+
+    void run(int index) {
+        Worker& worker = *workers[index];
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            const JobId id = queue.front();
+            queue.pop_front();
+            auto it = jobs.find(id);
+            if (it == jobs.end()) {
+                continue;
+            }
+            Job& job = it->second;
+            if (job.hasDeadline && Clock::now() >= job.deadline) {
+                jobs.erase(it);
+                continue;
+            }
+            job.worker = index;
+            lock.unlock();
+
+            // The request isn't changed once queued, and the job stays
+            // until this worker lets it go
+            DialogueResult result = worker.llm.generateDialogueStreaming(
+                job.request,
+                [this, &job](const std::string& token) {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    job.partial += token;
+                    job.partialChanged = true;
+                });
+
+            lock.lock();
+            job.worker = -1;
+            if (job.cancelled) {
+                jobs.erase(it);
+            } else {
+                job.result = std::move(result);
+                job.finished = true;
+            }
+        }
+    }
+};
+
+DialogueService::DialogueService() : impl_(std::make_unique<Impl>()) {}
+
+DialogueService::~DialogueService() {
+    stop();
+}
+
+bool DialogueService::start(const LLMConfig& config, int workers) {
+    stop();
+
+    std::vector<std::unique_ptr<Impl::Worker>> created;
+    for (int i = 0; i < std::max(workers, 1); ++i) {
+        created.push_back(std::make_unique<Impl::Worker>());
+        if (!created.back()->llm.initialize(config)) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->workers = std::move(created);
+    impl_->running = true;
+    for (size_t i = 0; i < impl_->workers.size(); ++i) {
+        impl_->workers[i]->thread = std::thread(&Impl::run, impl_.get(),
+                                                static_cast<int>(i));
+    }
+    return true;
+}
+
+void DialogueService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->running) {
+            return;
+        }
+        impl_->running = false;
+        impl_->stopping = true;
+        for (auto it = impl_->jobs.begin(); it != impl_->jobs.end();) {
+            it = impl_->drop(it);
+        }
+    }
+    impl_->wake.notify_all();
+    for (auto& worker : impl_->workers) {
+        worker->thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->workers.clear();
+    impl_->jobs.clear();
+    impl_->queue.clear();
+    impl_->stopping = false;
+}
+
+bool DialogueService::isRunning() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->running;
+}
+
+DialogueService::JobId DialogueService::submit(const DialogueRequest& request,
+                                               ResultCallback onResult,
+                                               PartialCallback onPartial,
+                                               int deadlineMs) {
+    JobId id;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->running) {
+            return 0;
+        }
+        id = impl_->nextId++;
+        Impl::Job& job = impl_->jobs[id];
+        job.request = request;
+        job.request.cancelled = &job.stop;
+        job.onResult = std::move(onResult);
+        job.onPartial = std::move(onPartial);
+        if (deadlineMs > 0) {
+            job.hasDeadline = true;
+            job.deadline = Clock::now() + std::chrono::milliseconds(deadlineMs);
+        }
+        impl_->queue.push_back(id);
+    }
+    impl_->wake.notify_one();
+    return id;
+}
+
+void DialogueService::cancel(JobId id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->jobs.find(id);
+    if (it != impl_->jobs.end() && !it->second.cancelled) {
+        impl_->drop(it);
+    }
+}
+
+void DialogueService::cancelNPC(const std::string& npcName) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (auto it = impl_->jobs.begin(); it != impl_->jobs.end();) {
+        if (!it->second.cancelled && it->second.request.npcContext.name == npcName) {
+            it = impl_->drop(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int DialogueService::deliver(double budgetMs) {
+    const auto start = Clock::now();
+    int delivered = 0;
+
+    // Each job is visited once, in order, so a fast worker can't keep
+    // this going
+    JobId after = 0;
+    for (;;) {
+        if (budgetMs > 0.0 && delivered > 0 &&
+            std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= budgetMs) {
+            break;
+        }
+
+        PartialCallback onPartial;
+        std::string partial;
+        ResultCallback onResult;
+        DialogueResult result;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(impl_->mutex);
+            const auto now = Clock::now();
+            auto it = impl_->jobs.upper_bound(after);
+            while (it != impl_->jobs.end() && !found) {
+                Impl::Job& job = it->second;
+                after = it->first;
+                if (job.cancelled) {
+                    ++it;
+                } else if (job.finished) {
+                    onResult = std::move(job.onResult);
+                    result = std::move(job.result);
+                    impl_->jobs.erase(it);
+                    found = true;
+                } else if (job.hasDeadline && now >= job.deadline) {
+                    it = impl_->drop(it);
+                } else if (job.partialChanged && job.onPartial) {
+                    onPartial = job.onPartial;
+                    partial = job.partial;
+                    job.partialChanged = false;
+                    found = true;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        if (!found) {
+            break;
+        }
+
+        if (onResult) {
+            onResult(result);
+        } else if (onPartial) {
+            onPartial(partial);
+        }
+        ++delivered;
+    }
+    return delivered;
+}
+
+size_t DialogueService::pending() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    size_t count = 0;
+    for (const auto& entry : impl_->jobs) {
+        if (!entry.second.cancelled) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace LLM
+} // namespace NPC
+} // namespace Ultima
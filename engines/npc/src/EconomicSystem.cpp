@@ -4,9 +4,11 @@
  */
 
 #include "economy/EconomicSystem.h"
+#include "Job_system.h"
 #include <algorithm>
 #include <random>
 #include <cmath>
+#include <numeric>
 
 namespace Ultima {
 namespace NPC {
@@ -14,6 +16,56 @@ namespace Economy {
 
 static std::mt19937 rng(std::random_device{}());
 
+namespace {
+
+const double BUY_NEED = 0.6;            // Buys what it wants at least this much
+const double SELL_NEED = 0.4;           // Sells what it wants no more than this
+const double STOCK_PER_NEED = 5.0;      // Quantity it keeps for a need of 1
+const size_t AGENTS_PER_WORKER = 512;   // Fewer aren't worth a thread
+
+// An order an agent has decided on
+struct OrderDecision {
+    size_t row;
+    ResourceType type;
+    double quantity;
+    double price;                       // Most it pays, or what it asks
+    double minPrice;                    // For listings
+    bool isBid;
+};
+
+// One agent's orders, from its rows of the need, expectation and holding
+// tables: it bids for what it wants and is short of, within its gold and
+// space, and sells surplus of what it doesn't
+void decideRow(size_t row, const double* needs, const double* expectations,
+               const double* holdings, const double* reference, double gold,
+               double space, double materialism, std::vector<OrderDecision>& orders) {
+    for (size_t t = 0; t < RESOURCE_TYPE_COUNT; ++t) {
+        const double need = needs[t];
+        const double price = expectations[t] > 0.0 ? expectations[t] : reference[t];
+        const double stock = need * STOCK_PER_NEED;
+        if (price <= 0.0) continue;
+
+        if (need >= BUY_NEED && holdings[t] < stock) {
+            // As getWillingnessToPay
+            const double most = price * (0.8 + 0.4 * need) * (1.0 + (materialism - 0.5) * 0.2);
+            const double quantity = std::min({std::ceil(stock - holdings[t]),
+                                              std::floor(gold / most), std::floor(space)});
+            if (quantity >= 1.0) {
+                gold -= quantity * most;
+                space -= quantity;
+                orders.push_back({row, static_cast<ResourceType>(t), quantity, most, 0.0, true});
+            }
+        } else if (need <= SELL_NEED && holdings[t] >= stock + 1.0) {
+            // As getMinSalePrice, asking a quarter over it
+            const double least = price * (0.6 + 0.4 * (1.0 - need));
+            orders.push_back({row, static_cast<ResourceType>(t),
+                              std::floor(holdings[t] - stock), least * 1.25, least, false});
+        }
+    }
+}
+
+} // namespace
+
 // Resource Implementation
 double Resource::getMarketValue(double marketMultiplier) const {
     return baseValue * quality * quantity * marketMultiplier;
@@ -28,11 +80,16 @@ bool Inventory::add(const Resource& resource) {
         return false;
     }
 
-    if (resources_.count(resource.id) && resource.isStackable) {
-        resources_[resource.id].quantity += resource.quantity;
+    auto it = resources_.find(resource.id);
+    if (it != resources_.end() && resource.isStackable) {
+        it->second.quantity += resource.quantity;
     } else {
+        if (it != resources_.end()) {
+            typeQuantities_[static_cast<size_t>(it->second.type)] -= it->second.quantity;
+        }
         resources_[resource.id] = resource;
     }
+    typeQuantities_[static_cast<size_t>(resource.type)] += resource.quantity;
     return true;
 }
 
@@ -43,6 +100,7 @@ bool Inventory::remove(const std::string& resourceId, double quantity) {
     if (it->second.quantity < quantity) return false;
 
     it->second.quantity -= quantity;
+    typeQuantities_[static_cast<size_t>(it->second.type)] -= quantity;
     if (it->second.quantity <= 0) {
         resources_.erase(it);
     }
@@ -63,11 +121,17 @@ double Inventory::getTotalValue() const {
 }
 
 double Inventory::getUsedCapacity() const {
-    double used = 0.0;
+    return std::accumulate(typeQuantities_.begin(), typeQuantities_.end(), 0.0);
+}
+
+std::vector<Resource> Inventory::getByType(ResourceType type) const {
+    std::vector<Resource> result;
     for (const auto& [id, res] : resources_) {
-        used += res.quantity;
+        if (res.type == type) {
+            result.push_back(res);
+        }
     }
-    return used;
+    return result;
 }
 
 // Market Implementation
@@ -75,84 +139,365 @@ Market::Market(const std::string& i, const std::string& loc)
     : id(i), location(loc), name(loc + " Market") {}
 Market::~Market() = default;
 
+Market::ListingRange::const_iterator::const_iterator(Books::const_iterator book,
+                                                     Books::const_iterator bookEnd)
+    : book_(book), bookEnd_(bookEnd) {
+    if (book_ != bookEnd_) {
+        listing_ = book_->second.asks.begin();
+        skipEmptyBooks();
+    }
+}
+
+Market::ListingRange::const_iterator& Market::ListingRange::const_iterator::operator++() {
+    ++listing_;
+    skipEmptyBooks();
+    return *this;
+}
+
+void Market::ListingRange::const_iterator::skipEmptyBooks() {
+    while (listing_ == book_->second.asks.end()) {
+        if (++book_ == bookEnd_) {
+            return;
+        }
+        listing_ = book_->second.asks.begin();
+    }
+}
+
 std::string Market::generateId() {
-    static int counter = 0;
-    return "listing_" + std::to_string(++counter);
+    return std::to_string(++nextOrder_);
 }
 
 std::string Market::listItem(const std::string& sellerId,
                             const Resource& resource,
                             double askingPrice,
-                            double minPrice) {
+                            double minPrice,
+                            uint32_t expirationTime) {
     MarketListing listing;
-    listing.id = generateId();
+    listing.id = "listing_" + generateId();
     listing.sellerId = sellerId;
     listing.resource = resource;
     listing.askingPrice = askingPrice;
     listing.minPrice = minPrice > 0 ? minPrice : askingPrice * 0.7;
+    listing.listedTime = currentTime_;
+    listing.expirationTime = expirationTime;
     listing.isActive = true;
 
-    listings_[listing.id] = listing;
-    return listing.id;
+    const OrderBook::Key key{askingPrice, nextOrder_};
+    OrderBook& book = books_[resource.type];
+    book.askQuantity += resource.quantity;
+    orders_[listing.id] = {resource.type, key, false, expirationTime};
+    if (expirationTime > 0) {
+        expirations_.insert({expirationTime, listing.id});
+    }
+    const std::string listingId = listing.id;
+    book.asks.emplace(key, std::move(listing));
+    return listingId;
+}
+
+std::string Market::placeBid(const std::string& buyerId, ResourceType type,
+                             double quantity, double maxPrice,
+                             uint32_t expirationTime) {
+    MarketBid bid;
+    bid.id = "bid_" + generateId();
+    bid.buyerId = buyerId;
+    bid.type = type;
+    bid.quantity = quantity;
+    bid.maxPrice = maxPrice;
+    bid.placedTime = currentTime_;
+    bid.expirationTime = expirationTime;
+
+    const OrderBook::Key key{maxPrice, nextOrder_};
+    OrderBook& book = books_[type];
+    book.bidQuantity += quantity;
+    orders_[bid.id] = {type, key, true, expirationTime};
+    if (expirationTime > 0) {
+        expirations_.insert({expirationTime, bid.id});
+    }
+    const std::string bidId = bid.id;
+    book.bids.emplace(key, std::move(bid));
+    return bidId;
+}
+
+void Market::removeOrder(const std::string& orderId, bool isBid) {
+    auto it = orders_.find(orderId);
+    if (it == orders_.end() || it->second.isBid != isBid) return;
+    const OrderRef& ref = it->second;
+    OrderBook& book = books_[ref.type];
+    if (isBid) {
+        auto bid = book.bids.find(ref.key);
+        book.bidQuantity -= bid->second.quantity;
+        book.bids.erase(bid);
+    } else {
+        auto ask = book.asks.find(ref.key);
+        book.askQuantity -= ask->second.resource.quantity;
+        book.asks.erase(ask);
+    }
+    if (ref.expirationTime > 0) {
+        expirations_.erase({ref.expirationTime, orderId});
+    }
+    orders_.erase(it);
 }
 
 void Market::removeListing(const std::string& listingId) {
-    listings_.erase(listingId);
+    removeOrder(listingId, false);
+}
+
+void Market::cancelBid(const std::string& bidId) {
+    removeOrder(bidId, true);
 }
 
-std::vector<MarketListing> Market::getListings(ResourceType type) const {
-    std::vector<MarketListing> results;
-    for (const auto& [id, listing] : listings_) {
-        if (!listing.isActive) continue;
-        if (type == ResourceType::Custom || listing.resource.type == type) {
-            results.push_back(listing);
+Market::ListingRange Market::getListings(ResourceType type) const {
+    if (type == ResourceType::Custom) {
+        return ListingRange(books_.begin(), books_.end());
+    }
+    auto book = books_.find(type);
+    return ListingRange(book, book == books_.end() ? book : std::next(book));
+}
+
+std::optional<MarketListing> Market::findBestPrice(ResourceType type,
+                                                   double maxPrice) const {
+    const MarketListing* best = nullptr;
+    for (const auto& [bookType, book] : books_) {
+        if (type != ResourceType::Custom && bookType != type) continue;
+        if (book.asks.empty()) continue;
+        const MarketListing& cheapest = book.asks.begin()->second;
+        if (cheapest.askingPrice <= maxPrice &&
+            (!best || cheapest.askingPrice < best->askingPrice)) {
+            best = &cheapest;
         }
     }
-    return results;
+    if (!best) return std::nullopt;
+    return *best;
+}
+
+const MarketBid* Market::getBestBid(ResourceType type) const {
+    auto book = books_.find(type);
+    if (book == books_.end() || book->second.bids.empty()) return nullptr;
+    return &book->second.bids.begin()->second;
+}
+
+double Market::getSupply(ResourceType type) const {
+    auto book = books_.find(type);
+    return book != books_.end() ? std::max(0.0, book->second.askQuantity) : 0.0;
+}
+
+double Market::getDemand(ResourceType type) const {
+    auto book = books_.find(type);
+    return book != books_.end() ? std::max(0.0, book->second.bidQuantity) : 0.0;
+}
+
+const Transaction& Market::recordTransaction(Transaction transaction) {
+    transaction.id = "tx_" + std::to_string(transactionCount_++);
+    transaction.timestamp = currentTime_;
+    transaction.location = location;
+    PriceHistory& history = history_[transaction.type];
+    history.add(transaction);
+    return history.recent(0);
 }
 
 bool Market::executePurchase(const std::string& listingId,
                             const std::string& buyerId,
                             double offeredPrice) {
-    auto it = listings_.find(listingId);
-    if (it == listings_.end() || !it->second.isActive) return false;
+    auto it = orders_.find(listingId);
+    if (it == orders_.end() || it->second.isBid) return false;
+    const MarketListing& listing = books_[it->second.type].asks.at(it->second.key);
 
-    if (offeredPrice < it->second.minPrice) return false;
+    if (offeredPrice < listing.minPrice) return false;
 
     Transaction tx;
-    tx.id = "tx_" + std::to_string(transactions_.size());
     tx.buyerId = buyerId;
-    tx.sellerId = it->second.sellerId;
-    tx.resourceId = it->second.resource.id;
-    tx.quantity = it->second.resource.quantity;
+    tx.sellerId = listing.sellerId;
+    tx.resourceId = listing.resource.id;
+    tx.type = listing.resource.type;
+    tx.quantity = listing.resource.quantity;
     tx.price = offeredPrice;
 
-    transactions_.push_back(tx);
-    listings_.erase(it);
+    recordTransaction(std::move(tx));
+    removeOrder(listingId, false);
 
     return true;
 }
 
+std::vector<Trade> Market::update(uint32_t currentTime) {
+    currentTime_ = currentTime;
+    while (!expirations_.empty() && expirations_.begin()->first < currentTime) {
+        const std::string orderId = expirations_.begin()->second;
+        removeOrder(orderId, orders_.at(orderId).isBid);
+    }
+
+    std::vector<Trade> trades;
+    for (auto& [type, book] : books_) {
+        while (!book.bids.empty() && !book.asks.empty()) {
+            auto bidIt = book.bids.begin();
+            auto askIt = book.asks.begin();
+            MarketBid& bid = bidIt->second;
+            MarketListing& ask = askIt->second;
+            if (bid.maxPrice < ask.askingPrice) break;
+
+            const double quantity = std::min(bid.quantity, ask.resource.quantity);
+            Trade trade;
+            trade.resource = ask.resource;
+            trade.resource.quantity = quantity;
+            trade.resource.owner = bid.buyerId;
+            Transaction& tx = trade.transaction;
+            tx.buyerId = bid.buyerId;
+            tx.sellerId = ask.sellerId;
+            tx.resourceId = ask.resource.id;
+            tx.type = type;
+            tx.quantity = quantity;
+            tx.price = bidIt->first.sequence < askIt->first.sequence ? bid.maxPrice
+                                                                      : ask.askingPrice;
+            trade.transaction = recordTransaction(tx);
+            trades.push_back(std::move(trade));
+
+            bid.quantity -= quantity;
+            ask.resource.quantity -= quantity;
+            book.bidQuantity -= quantity;
+            book.askQuantity -= quantity;
+            if (bid.quantity <= 0.0) {
+                removeOrder(std::string(bid.id), true);
+            }
+            if (ask.resource.quantity <= 0.0) {
+                removeOrder(std::string(ask.id), false);
+            }
+        }
+    }
+    return trades;
+}
+
 double Market::getAveragePrice(ResourceType type, int recentCount) const {
-    double sum = 0.0;
-    int count = 0;
+    const PriceHistory* history = getPriceStatistics(type);
+    return history ? history->mean(static_cast<size_t>(std::max(recentCount, 0))) : 0.0;
+}
+
+double Market::getPriceVolatility(ResourceType type) const {
+    const PriceHistory* history = getPriceStatistics(type);
+    return history ? history->volatility() : 0.0;
+}
+
+const PriceHistory* Market::getPriceStatistics(ResourceType type) const {
+    auto it = history_.find(type);
+    return it != history_.end() ? &it->second : nullptr;
+}
+
+std::vector<Transaction> Market::getPriceHistory(const std::string& resourceId,
+                                                 int maxRecords) const {
+    std::vector<Transaction> result;
+    for (const auto& [type, history] : history_) {
+        for (size_t age = 0; age < history.size(); ++age) {
+            if (history.recent(age).resourceId == resourceId) {
+                result.push_back(history.recent(age));
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Transaction& a, const Transaction& b) {
+        return a.timestamp > b.timestamp;
+    });
+    if (result.size() > static_cast<size_t>(std::max(maxRecords, 0))) {
+        result.resize(static_cast<size_t>(std::max(maxRecords, 0)));
+    }
+    return result;
+}
 
-    for (auto it = transactions_.rbegin(); it != transactions_.rend() && count < recentCount; ++it) {
-        sum += it->price;
-        count++;
+// PriceHistory Implementation
+void PriceHistory::add(const Transaction& transaction) {
+    if (transactions_.empty()) {
+        transactions_.resize(WINDOW);
+        before_.resize(WINDOW);
+        ema_ = transaction.price;
     }
+    const double price = transaction.price;
+    transactions_[next_] = transaction;
+    before_[next_] = totals_;
+    totals_.price += price;
+    totals_.squares += price * price;
+    totals_.value += price * transaction.quantity;
+    totals_.quantity += transaction.quantity;
+    next_ = (next_ + 1) % WINDOW;
+    count_ = std::min(count_ + 1, WINDOW);
+
+    // Once around the ring, take out what the oldest kept didn't see, so
+    // the totals stay the size of a window's worth
+    if (next_ == 0) {
+        const Totals base = before_[0];
+        for (Totals* totals = before_.data(); totals != before_.data() + WINDOW; ++totals) {
+            totals->price -= base.price;
+            totals->squares -= base.squares;
+            totals->value -= base.value;
+            totals->quantity -= base.quantity;
+        }
+        totals_.price -= base.price;
+        totals_.squares -= base.squares;
+        totals_.value -= base.value;
+        totals_.quantity -= base.quantity;
+    }
+
+    ema_ += EMA_WEIGHT * (price - ema_);
+
+    const uint32_t day = transaction.timestamp / DAY_LENGTH;
+    if (days_.empty() || day > days_.back().day) {
+        days_.push_back({day, price, price, price, price});
+        if (days_.size() > DAYS) {
+            days_.pop_front();
+        }
+    }
+    PriceDay& today = days_.back();
+    today.high = std::max(today.high, price);
+    today.low = std::min(today.low, price);
+    today.close = price;
+    today.volume += transaction.quantity;
+    today.value += price * transaction.quantity;
+    ++today.trades;
+}
+
+const Transaction& PriceHistory::recent(size_t age) const {
+    return transactions_[slot(age)];
+}
+
+PriceHistory::Totals PriceHistory::latest(size_t count) const {
+    Totals result = totals_;
+    const Totals& before = before_[slot(count - 1)];
+    result.price -= before.price;
+    result.squares -= before.squares;
+    result.value -= before.value;
+    result.quantity -= before.quantity;
+    return result;
+}
+
+double PriceHistory::mean(size_t count) const {
+    count = std::min(count, count_);
+    return count > 0 ? latest(count).price / count : 0.0;
+}
 
-    return count > 0 ? sum / count : 0.0;
+double PriceHistory::vwap() const {
+    if (count_ == 0) return 0.0;
+    const Totals totals = latest(count_);
+    return totals.quantity > 0.0 ? totals.value / totals.quantity : mean();
+}
+
+double PriceHistory::volatility() const {
+    if (count_ < 2) return 0.0;
+    const Totals totals = latest(count_);
+    const double average = totals.price / count_;
+    const double variance = std::max(0.0, totals.squares / count_ - average * average);
+    return average > 0.0 ? std::sqrt(variance) / average : 0.0;
 }
 
 // EconomicAgent Implementation
 EconomicAgent::EconomicAgent(const std::string& entityId)
-    : entityId(entityId), inventory(100.0) {}
+    : entityId(entityId), inventory(100.0) {
+    resourceNeeds_.fill(0.5);
+}
 EconomicAgent::~EconomicAgent() = default;
 
 double EconomicAgent::evaluateUtility(const Resource& resource) const {
-    double need = resourceNeeds_.count(resource.type) ? resourceNeeds_.at(resource.type) : 0.5;
-    return resource.quality * need;
+    return resource.quality * getNeed(resource.type);
+}
+
+void EconomicAgent::updatePriceExpectation(ResourceType type, double observedPrice) {
+    double& expected = priceExpectations_[static_cast<size_t>(type)];
+    expected = expected > 0.0 ? priceMemory * expected + (1.0 - priceMemory) * observedPrice
+                              : observedPrice;
 }
 
 double EconomicAgent::getWillingnessToPay(const Resource& resource,
@@ -204,11 +549,16 @@ void MarketSimulation::setBasePrice(ResourceType type, double price) {
 }
 
 void MarketSimulation::simulate(double deltaTime) {
+    time_ += deltaTime;
+
     // Update agents
     for (auto& [id, agent] : agents_) {
         agent->dailyUpdate();
     }
 
+    // Decide and place orders
+    decideOrders();
+
     // Match orders
     matchOrders();
 
@@ -237,8 +587,105 @@ double MarketSimulation::getTotalWealth() const {
     return total;
 }
 
+Market* MarketSimulation::marketFor(const EconomicAgent& agent) {
+    if (agent.market.empty()) {
+        return markets_.empty() ? nullptr : markets_.begin()->second.get();
+    }
+    return getMarket(agent.market);
+}
+
+void MarketSimulation::decideOrders() {
+    const size_t count = agents_.size();
+    const size_t width = RESOURCE_TYPE_COUNT;
+    rows_.clear();
+    rows_.reserve(count);
+    for (auto& [id, agent] : agents_) {
+        rows_.push_back(agent.get());
+    }
+    needs_.resize(count * width);
+    expectations_.resize(count * width);
+    holdings_.resize(count * width);
+
+    // Types nobody has a price for yet go by their base prices
+    std::array<double, RESOURCE_TYPE_COUNT> reference{};
+    for (const auto& [type, price] : basePrices_) {
+        reference[static_cast<size_t>(type)] = price;
+    }
+
+    // Each worker fills in and decides on a run of rows; nothing is shared
+    // but reading the agents
+    Job_system& jobs = Job_system::get();
+    const size_t workers = jobs.threads_for(count, AGENTS_PER_WORKER);
+    std::vector<std::vector<OrderDecision>> decided(workers);
+    jobs.run("economy.decide", workers, [&](size_t worker) {
+        const size_t end = count * (worker + 1) / workers;
+        for (size_t row = count * worker / workers; row < end; ++row) {
+            const EconomicAgent& agent = *rows_[row];
+            double* needs = &needs_[row * width];
+            double* expectations = &expectations_[row * width];
+            double* holdings = &holdings_[row * width];
+            std::copy(agent.getNeeds().begin(), agent.getNeeds().end(), needs);
+            std::copy(agent.getPriceExpectations().begin(), agent.getPriceExpectations().end(),
+                      expectations);
+            for (size_t t = 0; t < width; ++t) {
+                holdings[t] = agent.inventory.getQuantity(static_cast<ResourceType>(t));
+            }
+            decideRow(row, needs, expectations, holdings, reference.data(), agent.gold,
+                      agent.inventory.getMaxCapacity() - agent.inventory.getUsedCapacity(),
+                      agent.materialism, decided[worker]);
+        }
+    });
+
+    // Orders go in afterwards, in row order, so the books come out the
+    // same however the rows were split. Last pass's bids make way.
+    for (const auto& [market, bidId] : bids_) {
+        market->cancelBid(bidId);
+    }
+    bids_.clear();
+    for (const auto& orders : decided) {
+        for (const OrderDecision& order : orders) {
+            EconomicAgent& agent = *rows_[order.row];
+            Market* market = marketFor(agent);
+            if (!market) continue;
+            if (order.isBid) {
+                bids_.push_back({market, market->placeBid(agent.entityId, order.type,
+                                                          order.quantity, order.price)});
+                continue;
+            }
+
+            // Listed goods leave the inventory, to be delivered when sold
+            double left = order.quantity;
+            for (Resource resource : agent.inventory.getByType(order.type)) {
+                resource.quantity = std::min(resource.quantity, left);
+                if (resource.quantity <= 0.0 ||
+                    !agent.inventory.remove(resource.id, resource.quantity)) continue;
+                market->listItem(agent.entityId, resource, order.price, order.minPrice);
+                left -= resource.quantity;
+            }
+        }
+    }
+}
+
 void MarketSimulation::matchOrders() {
-    // Simple order matching
+    for (auto& [location, market] : markets_) {
+        for (const Trade& trade : market->update(static_cast<uint32_t>(time_))) {
+            settle(trade);
+        }
+    }
+}
+
+void MarketSimulation::settle(const Trade& trade) {
+    // Either side may be someone outside the simulation, like the player
+    const double cost = trade.transaction.price * trade.transaction.quantity;
+    if (EconomicAgent* buyer = getAgent(trade.transaction.buyerId)) {
+        buyer->gold -= cost;
+        buyer->inventory.add(trade.resource);
+        buyer->updatePriceExpectation(trade.transaction.type, trade.transaction.price);
+    }
+    if (EconomicAgent* seller = getAgent(trade.transaction.sellerId)) {
+        seller->gold += cost;
+        seller->updatePriceExpectation(trade.transaction.type, trade.transaction.price);
+    }
 }
 
 void MarketSimulation::updatePrices() {
@@ -295,6 +742,52 @@ EconomicSystem::EconomicStats EconomicSystem::getStatistics() const {
 NPCEconomicDecision::NPCEconomicDecision() = default;
 NPCEconomicDecision::~NPCEconomicDecision() = default;
 
+namespace {
+
+// One agent's orders, by the rule the batched pass uses, with the
+// market's recent prices standing in for those it has no idea of
+std::vector<OrderDecision> decideAlone(const EconomicAgent& agent, const Market& market) {
+    std::array<double, RESOURCE_TYPE_COUNT> holdings{};
+    std::array<double, RESOURCE_TYPE_COUNT> reference{};
+    for (size_t t = 0; t < RESOURCE_TYPE_COUNT; ++t) {
+        holdings[t] = agent.inventory.getQuantity(static_cast<ResourceType>(t));
+        reference[t] = market.getAveragePrice(static_cast<ResourceType>(t));
+    }
+    std::vector<OrderDecision> orders;
+    decideRow(0, agent.getNeeds().data(), agent.getPriceExpectations().data(),
+              holdings.data(), reference.data(), agent.gold,
+              agent.inventory.getMaxCapacity() - agent.inventory.getUsedCapacity(),
+              agent.materialism, orders);
+    return orders;
+}
+
+} // namespace
+
+std::vector<std::pair<ResourceType, double>> NPCEconomicDecision::decidePurchases(
+    const EconomicAgent& agent,
+    const Market& market) {
+    std::vector<std::pair<ResourceType, double>> purchases;
+    for (const OrderDecision& order : decideAlone(agent, market)) {
+        if (order.isBid) {
+            purchases.push_back({order.type, order.quantity});
+        }
+    }
+    return purchases;
+}
+
+std::vector<std::pair<std::string, double>> NPCEconomicDecision::decideSales(
+    const EconomicAgent& agent,
+    const Market& market) {
+    std::vector<std::pair<std::string, double>> sales;
+    for (const OrderDecision& order : decideAlone(agent, market)) {
+        if (order.isBid) continue;
+        for (const Resource& resource : agent.inventory.getByType(order.type)) {
+            sales.push_back({resource.id, order.price});
+        }
+    }
+    return sales;
+}
+
 ProductionFacility::ProductionFacility(const std::string& id) : id(id) {}
 ProductionFacility::~ProductionFacility() = default;
 
@@ -4,7 +4,10 @@
 
 #include "aiml/HybridDialogue.h"
 #include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <list>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <unordered_set>
@@ -14,6 +17,151 @@ namespace Ultima {
 namespace NPC {
 namespace Dialogue {
 
+//=============================================================================
+// ResponseCache Implementation
+//=============================================================================
+
+struct ResponseCache::Shard {
+    struct Entry {
+        uint64_t key;
+        std::string response;
+        Counters* npc;          // In npcs
+    };
+    
+    mutable std::mutex mutex;
+    std::list<Entry> entries;   // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    std::unordered_map<std::string, Counters> npcs;
+    Counters total;
+    size_t capacity = 1;
+    
+    void evictTo(size_t size) {
+        while (entries.size() > size) {
+            Entry& last = entries.back();
+            last.npc->evictions++;
+            total.evictions++;
+            index.erase(last.key);
+            entries.pop_back();
+        }
+    }
+};
+
+ResponseCache::ResponseCache(size_t capacity, size_t shards) {
+    for (size_t i = 0; i < std::max<size_t>(shards, 1); ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    setCapacity(capacity);
+}
+
+ResponseCache::~ResponseCache() = default;
+
+uint64_t ResponseCache::makeKey(const std::string& npcId, const std::string& input,
+                                const std::string& context) {
+    // FNV-1a over each part, then mixed so every bit picks a shard as well
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](unsigned char c) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    };
+    for (char c : npcId) add(static_cast<unsigned char>(c));
+    add(0);
+    
+    bool space = false;
+    bool any = false;
+    for (char c : input) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '\'') {
+            if (space && any) add(' ');
+            add(static_cast<unsigned char>(std::tolower(u)));
+            space = false;
+            any = true;
+        } else if (std::isspace(u)) {
+            space = true;
+        }
+    }
+    add(0);
+    for (char c : context) add(static_cast<unsigned char>(c));
+    
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+ResponseCache::Shard& ResponseCache::shardFor(uint64_t key) const {
+    return *shards_[key % shards_.size()];
+}
+
+bool ResponseCache::get(const std::string& npcId, uint64_t key, std::string& response) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Counters& npc = shard.npcs[npcId];
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        npc.misses++;
+        shard.total.misses++;
+        return false;
+    }
+    npc.hits++;
+    shard.total.hits++;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    response = it->second->response;
+    return true;
+}
+
+void ResponseCache::put(const std::string& npcId, uint64_t key, const std::string& response) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Counters* npc = &shard.npcs[npcId];
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->second->response = response;
+        it->second->npc = npc;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+    shard.evictTo(shard.capacity - 1);
+    shard.entries.push_front({key, response, npc});
+    shard.index[key] = shard.entries.begin();
+}
+
+void ResponseCache::setCapacity(size_t capacity) {
+    // Spread over the shards, at least one entry each
+    const size_t perShard = std::max<size_t>((capacity + shards_.size() - 1) / shards_.size(), 1);
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->capacity = perShard;
+        shard->evictTo(perShard);
+    }
+}
+
+void ResponseCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->entries.clear();
+        shard->index.clear();
+    }
+}
+
+ResponseCache::Stats ResponseCache::getStats() const {
+    Stats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.total.hits += shard->total.hits;
+        stats.total.misses += shard->total.misses;
+        stats.total.evictions += shard->total.evictions;
+        stats.size += shard->entries.size();
+        stats.capacity += shard->capacity;
+        for (const auto& [npcId, counters] : shard->npcs) {
+            Counters& npc = stats.byNPC[npcId];
+            npc.hits += counters.hits;
+            npc.misses += counters.misses;
+            npc.evictions += counters.evictions;
+        }
+    }
+    return stats;
+}
+
 //=============================================================================
 // HybridDialogueEngine Implementation
 //=============================================================================
@@ -24,8 +172,8 @@ struct HybridDialogueEngine::Impl {
     Stats stats;
     LLMCallback llmCallback;
     
-    // Simple response cache
-    std::unordered_map<std::string, std::string> cache;
+    // Response cache, which may be shared with other engines
+    std::shared_ptr<ResponseCache> cache = std::make_shared<ResponseCache>();
     
     // AIML-like patterns
     std::unordered_map<std::string, std::vector<std::string>> patterns;
@@ -153,8 +301,12 @@ struct HybridDialogueEngine::Impl {
         return {bestResponse, bestScore};
     }
     
-    std::string generateCacheKey(const std::string& input, const std::string& npcId) {
-        return npcId + ":" + input;
+    // The answer also depends on the NPC's mood and where the talk is
+    uint64_t generateCacheKey(const std::string& input, const LLM::NPCContext& npcContext,
+                              const DialogueContext& dialogueContext) {
+        return ResponseCache::makeKey(dialogueContext.npcId, input,
+                                      npcContext.currentMood + '\n' +
+                                      dialogueContext.currentLocation);
     }
 };
 
@@ -166,6 +318,7 @@ HybridDialogueEngine::~HybridDialogueEngine() = default;
 
 bool HybridDialogueEngine::initialize(const HybridConfig& config, const std::string& aimlPath) {
     impl_->config = config;
+    impl_->cache->setCapacity(static_cast<size_t>(std::max(config.cacheMaxSize, 1)));
     
     // Initialize the dialogue generator
     impl_->dialogueGen = std::make_unique<LLM::DialogueGenerator>();
@@ -184,10 +337,11 @@ HybridDialogueResult HybridDialogueEngine::generateResponse(
     result.isConsistent = true;
     
     // Check cache first
+    uint64_t cacheKey = 0;
     if (impl_->config.enableCaching) {
-        std::string cacheKey = impl_->generateCacheKey(input, dialogueContext.npcId);
-        std::string cached = getCachedResponse(cacheKey);
-        if (!cached.empty()) {
+        cacheKey = impl_->generateCacheKey(input, npcContext, dialogueContext);
+        std::string cached;
+        if (getCachedResponse(dialogueContext.npcId, cacheKey, cached)) {
             result.response = cached;
             result.source = ResponseSource::Cached;
             result.confidence = 0.8f;
@@ -199,6 +353,7 @@ HybridDialogueResult HybridDialogueEngine::generateResponse(
             );
             return result;
         }
+        impl_->stats.cacheMisses++;
     }
     
     // Try AIML pattern matching
@@ -291,8 +446,7 @@ HybridDialogueResult HybridDialogueEngine::generateResponse(
     
     // Cache the response
     if (impl_->config.enableCaching && result.confidence > 0.5f) {
-        std::string cacheKey = impl_->generateCacheKey(input, dialogueContext.npcId);
-        cacheResponse(cacheKey, result.response);
+        cacheResponse(dialogueContext.npcId, cacheKey, result.response);
     }
     
     // Update dialogue context
@@ -390,15 +544,32 @@ bool HybridDialogueEngine::validateResponse(
 }
 
 HybridDialogueEngine::Stats HybridDialogueEngine::getStats() const {
-    return impl_->stats;
+    Stats stats = impl_->stats;
+    stats.cacheEvictions = static_cast<int>(impl_->cache->getStats().total.evictions);
+    return stats;
 }
 
 void HybridDialogueEngine::clearCache() {
-    impl_->cache.clear();
+    impl_->cache->clear();
+}
+
+ResponseCache::Stats HybridDialogueEngine::getCacheStats() const {
+    return impl_->cache->getStats();
+}
+
+std::shared_ptr<ResponseCache> HybridDialogueEngine::getCache() const {
+    return impl_->cache;
+}
+
+void HybridDialogueEngine::setCache(std::shared_ptr<ResponseCache> cache) {
+    if (cache) {
+        impl_->cache = std::move(cache);
+    }
 }
 
 void HybridDialogueEngine::setConfig(const HybridConfig& config) {
     impl_->config = config;
+    impl_->cache->setCapacity(static_cast<size_t>(std::max(config.cacheMaxSize, 1)));
 }
 
 void HybridDialogueEngine::addPattern(const std::string& pattern, const std::string& response) {
@@ -444,20 +615,14 @@ std::string HybridDialogueEngine::applyPersonality(
     return LLM::PersonalityModifier::addEmotion(response, ctx.currentMood, 0.5f);
 }
 
-std::string HybridDialogueEngine::getCachedResponse(const std::string& key) {
-    auto it = impl_->cache.find(key);
-    return it != impl_->cache.end() ? it->second : "";
+bool HybridDialogueEngine::getCachedResponse(const std::string& npcId, uint64_t key,
+                                             std::string& response) {
+    return impl_->cache->get(npcId, key, response);
 }
 
-void HybridDialogueEngine::cacheResponse(const std::string& key, const std::string& response) {
-    if (impl_->cache.size() >= static_cast<size_t>(impl_->config.cacheMaxSize)) {
-        // Simple eviction: clear half the cache
-        auto it = impl_->cache.begin();
-        for (size_t i = 0; i < impl_->cache.size() / 2 && it != impl_->cache.end(); ++i) {
-            it = impl_->cache.erase(it);
-        }
-    }
-    impl_->cache[key] = response;
+void HybridDialogueEngine::cacheResponse(const std::string& npcId, uint64_t key,
+                                         const std::string& response) {
+    impl_->cache->put(npcId, key, response);
 }
 
 //=============================================================================
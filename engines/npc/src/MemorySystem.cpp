@@ -4,9 +4,11 @@
  */
 
 #include "memory/MemorySystem.h"
+#include "persistence/Archive.h"
 #include <algorithm>
 #include <random>
 #include <cmath>
+#include <queue>
 
 namespace Ultima {
 namespace NPC {
@@ -105,25 +107,205 @@ LongTermMemory::~LongTermMemory() = default;
 
 std::string LongTermMemory::generateId() {
     static int counter = 0;
-    return "mem_" + std::to_string(++counter);
+    // Loaded memories may already have taken the next number
+    std::string id;
+    do {
+        id = "mem_" + std::to_string(++counter);
+    } while (memories_.count(id));
+    return id;
 }
 
 std::string LongTermMemory::store(const MemoryItem& memory) {
     std::string id = memory.id.empty() ? generateId() : memory.id;
-    memories_[id] = std::make_unique<MemoryItem>(memory);
-    indexMemory(id, memory);
+    auto& slot = memories_[id];
+    if (slot) {
+        removeFromIndex(id, *slot);
+    }
+    slot = std::make_unique<MemoryItem>(memory);
+    slot->id = id;
+    indexMemory(id, *slot);
     return id;
 }
 
+namespace {
+
+void addTo(std::vector<MemoryItem*>& list, MemoryItem* memory) {
+    if (std::find(list.begin(), list.end(), memory) == list.end()) {
+        list.push_back(memory);
+    }
+}
+
+template <typename Index, typename Key>
+void removeFrom(Index& index, const Key& key, MemoryItem* memory) {
+    auto it = index.find(key);
+    if (it == index.end()) return;
+    auto& list = it->second;
+    list.erase(std::remove(list.begin(), list.end(), memory), list.end());
+    if (list.empty()) {
+        index.erase(it);
+    }
+}
+
+} // namespace
+
 void LongTermMemory::indexMemory(const std::string& id, const MemoryItem& memory) {
+    MemoryItem* item = memories_.at(id).get();
     for (const auto& tag : memory.tags) {
-        tagIndex_.insert({tag, id});
+        addTo(tagIndex_[intern(tag)], item);
+    }
+    for (const auto& [entity, strength] : memory.associations) {
+        entityIndex_[intern(entity)].push_back(item);
     }
     if (!memory.location.empty()) {
-        locationIndex_.insert({memory.location, id});
+        locationIndex_[intern(memory.location)].push_back(item);
+    }
+    indexTime(item);
+    maxWeight_ = std::max(maxWeight_, memory.strength * memory.clarity);
+}
+
+void LongTermMemory::removeFromIndex(const std::string& id, const MemoryItem& memory) {
+    MemoryItem* item = memories_.at(id).get();
+    for (const auto& tag : memory.tags) {
+        removeFrom(tagIndex_, findSymbol(tag), item);
+    }
+    for (const auto& [entity, strength] : memory.associations) {
+        removeFrom(entityIndex_, findSymbol(entity), item);
+    }
+    if (!memory.location.empty()) {
+        removeFrom(locationIndex_, findSymbol(memory.location), item);
+    }
+    removeFromTimeIndex(item);
+}
+
+void LongTermMemory::indexTime(MemoryItem* memory) {
+    timeIndex_[memory->lastAccess / TIME_BUCKET_SIZE].push_back(memory);
+    latestTime_ = std::max(latestTime_, memory->lastAccess);
+}
+
+void LongTermMemory::removeFromTimeIndex(MemoryItem* memory) {
+    removeFrom(timeIndex_, memory->lastAccess / TIME_BUCKET_SIZE, memory);
+}
+
+std::optional<MemoryItem> LongTermMemory::retrieve(const std::string& id) {
+    auto it = memories_.find(id);
+    if (it == memories_.end()) {
+        return std::nullopt;
+    }
+    return *it->second;
+}
+
+std::vector<MemoryItem> LongTermMemory::search(const RetrievalCue& cue) {
+    std::vector<MemoryItem> results;
+    if (cue.maxResults <= 0) {
+        return results;
+    }
+    const uint32_t now = cue.timeContext ? cue.timeContext : latestTime_;
+    const bool anyContext = !cue.tags.empty() || !cue.entityContext.empty() ||
+                            !cue.locationContext.empty();
+
+    // Keep the best maxResults, the worst on top
+    struct Scored {
+        double score;
+        const MemoryItem* memory;
+        bool operator>(const Scored& other) const {
+            return score != other.score ? score > other.score
+                                        : memory->id < other.memory->id;
+        }
+    };
+    std::priority_queue<Scored, std::vector<Scored>, std::greater<Scored>> best;
+    auto consider = [&](const MemoryItem* memory) {
+        if ((cue.filterByType && memory->type != cue.typeFilter) ||
+            memory->strength < cue.minStrength) {
+            return;
+        }
+        double relevance = 1.0;
+        if (anyContext) {
+            relevance = memory->getRelevance(cue.tags, cue.entityContext);
+            if (!cue.locationContext.empty() && memory->location == cue.locationContext) {
+                relevance = std::min(1.0, relevance + 0.2);
+            }
+        }
+        if (relevance < cue.minRelevance) {
+            return;
+        }
+        Scored scored{relevance * memory->getRetrievalProbability(now), memory};
+        if (best.size() < static_cast<size_t>(cue.maxResults)) {
+            best.push(scored);
+        } else if (scored > best.top()) {
+            best.pop();
+            best.push(scored);
+        }
+    };
+
+    if (anyContext) {
+        // Score each memory sharing something with the cue, once
+        std::vector<const MemoryItem*> candidates;
+        auto gather = [&candidates](const auto& index, const std::string& key) {
+            auto it = index.find(findSymbol(key));
+            if (it != index.end()) {
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        };
+        for (const auto& tag : cue.tags) {
+            gather(tagIndex_, tag);
+        }
+        if (!cue.entityContext.empty()) {
+            gather(entityIndex_, cue.entityContext);
+        }
+        if (!cue.locationContext.empty()) {
+            gather(locationIndex_, cue.locationContext);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (const MemoryItem* memory : candidates) {
+            consider(memory);
+        }
+    } else {
+        // Most recently accessed first, until no older bucket can do better
+        for (auto bucket = timeIndex_.rbegin(); bucket != timeIndex_.rend(); ++bucket) {
+            if (best.size() == static_cast<size_t>(cue.maxResults)) {
+                const uint32_t newest = bucket->first * TIME_BUCKET_SIZE + (TIME_BUCKET_SIZE - 1);
+                const double bound = newest < now
+                    ? maxWeight_ / (1.0 + 0.001 * (now - newest)) : maxWeight_;
+                if (best.top().score >= bound) {
+                    break;
+                }
+            }
+            for (const MemoryItem* memory : bucket->second) {
+                consider(memory);
+            }
+        }
+    }
+
+    results.resize(best.size());
+    for (size_t i = results.size(); i-- > 0; best.pop()) {
+        results[i] = *best.top().memory;
+    }
+    return results;
+}
+
+void LongTermMemory::consolidate(uint32_t currentTime) {
+    (void)currentTime;
+    for (auto& [id, memory] : memories_) {
+        // Emotional and often recalled memories set hardest
+        const double gain = 0.01 * (memory->encoding.emotionalArousal +
+                                    memory->emotionalIntensity +
+                                    std::min(memory->encoding.rehearsals, 5.0) * 0.1);
+        memory->strength = std::min(1.0, memory->strength + gain);
+        maxWeight_ = std::max(maxWeight_, memory->strength * memory->clarity);
     }
 }
 
+void LongTermMemory::recordAccess(const std::string& memoryId, uint32_t currentTime) {
+    auto it = memories_.find(memoryId);
+    if (it == memories_.end()) return;
+    MemoryItem* memory = it->second.get();
+    removeFromTimeIndex(memory);
+    memory->lastAccess = currentTime;
+    memory->encoding.rehearsals += 1;
+    indexTime(memory);
+}
+
 MemorySystem::MemorySystem() = default;
 MemorySystem::~MemorySystem() = default;
 
@@ -144,6 +326,12 @@ void MemorySystem::experienceEvent(const std::string& eventType,
     mem.emotionalValence = emotionalImpact;
     mem.emotionalIntensity = std::abs(emotionalImpact);
     mem.strength = 0.5 + std::abs(emotionalImpact) * 0.5;
+    mem.encodingTime = currentTime_;
+    mem.lastAccess = currentTime_;
+    mem.tags.push_back(eventType);
+    for (const auto& participant : participants) {
+        mem.associations[participant] = 0.5;
+    }
 
     longTermMemory_.store(mem);
 }
@@ -157,15 +345,217 @@ void MemorySystem::learnFact(const std::string& subject,
     mem.predicate = predicate;
     mem.object = object;
     mem.source = source;
+    mem.encodingTime = currentTime_;
+    mem.lastAccess = currentTime_;
+    mem.tags.push_back(predicate);
+    mem.associations[subject] = 0.5;
+    mem.associations[object] = 0.5;
 
     longTermMemory_.store(mem);
 }
 
+std::vector<MemoryItem> MemorySystem::remember(const RetrievalCue& cue) {
+    RetrievalCue current = cue;
+    if (current.timeContext == 0) {
+        current.timeContext = currentTime_;
+    }
+    std::vector<MemoryItem> memories = longTermMemory_.search(current);
+    // Recalling a memory keeps it fresh
+    for (const auto& memory : memories) {
+        longTermMemory_.recordAccess(memory.id, current.timeContext);
+    }
+    return memories;
+}
+
+std::vector<MemoryItem> MemorySystem::rememberAbout(const std::string& entity,
+                                                    int maxResults) {
+    RetrievalCue cue;
+    cue.entityContext = entity;
+    cue.maxResults = maxResults;
+    return remember(cue);
+}
+
 void MemorySystem::update(uint32_t currentTime, double deltaTime) {
     currentTime_ = currentTime;
     workingMemory_.decay(deltaTime);
 }
 
+void MemorySystem::consolidate(uint32_t currentTime) {
+    longTermMemory_.consolidate(currentTime);
+}
+
+//=============================================================================
+// Persistence
+//=============================================================================
+
+using Persistence::ArchiveReader;
+using Persistence::ArchiveWriter;
+
+void WorkingMemory::write(ArchiveWriter& out) const {
+    out.putVarint(capacity_);
+    out.putVarint(items_.size());
+    for (const auto& item : items_) {
+        out.putString(item.content);
+        out.putDouble(item.activation);
+        out.putVarint(item.addTime);
+    }
+    out.putString(currentFocus_);
+}
+
+bool WorkingMemory::read(ArchiveReader& in) {
+    capacity_ = std::max<size_t>(1, in.getVarint());
+    items_.resize(in.getCount(10));
+    for (auto& item : items_) {
+        item.content = in.getString();
+        item.activation = in.getDouble();
+        item.addTime = static_cast<uint32_t>(in.getVarint());
+    }
+    currentFocus_ = in.getString();
+    return in.ok();
+}
+
+void LongTermMemory::write(ArchiveWriter& out) const {
+    out.putVarint(memories_.size());
+    for (const auto& [id, memory] : memories_) {
+        out.putString(id);
+        out.putVarint(static_cast<uint64_t>(memory->type));
+        out.putString(memory->content);
+        out.putVarint(memory->encodingTime);
+        out.putVarint(memory->lastAccess);
+        out.putDouble(memory->strength);
+        out.putDouble(memory->clarity);
+        out.putDouble(memory->confidence);
+        out.putStrings(memory->tags);
+        out.putVarint(memory->associations.size());
+        for (const auto& [entity, strength] : memory->associations) {
+            out.putString(entity);
+            out.putDouble(strength);
+        }
+        out.putString(memory->location);
+        out.putStrings(memory->relatedMemories);
+        out.putDouble(memory->emotionalValence);
+        out.putDouble(memory->emotionalIntensity);
+        out.putDouble(memory->encoding.attention);
+        out.putDouble(memory->encoding.emotionalArousal);
+        out.putDouble(memory->encoding.novelty);
+        out.putDouble(memory->encoding.selfRelevance);
+        out.putDouble(memory->encoding.rehearsals);
+    }
+    out.putVarint(skillIndex_.size());
+    for (const auto& [skill, id] : skillIndex_) {
+        out.putString(skill);
+        out.putString(id);
+    }
+}
+
+bool LongTermMemory::read(ArchiveReader& in) {
+    memories_.clear();
+    tagIndex_.clear();
+    entityIndex_.clear();
+    locationIndex_.clear();
+    timeIndex_.clear();
+    skillIndex_.clear();
+    latestTime_ = 0;
+    maxWeight_ = 0.0;
+
+    for (size_t i = in.getCount(80); i > 0 && in.ok(); --i) {
+        MemoryItem memory;
+        memory.id = in.getString();
+        memory.type = static_cast<MemoryType>(in.getVarint());
+        memory.content = in.getString();
+        memory.encodingTime = static_cast<uint32_t>(in.getVarint());
+        memory.lastAccess = static_cast<uint32_t>(in.getVarint());
+        memory.strength = in.getDouble();
+        memory.clarity = in.getDouble();
+        memory.confidence = in.getDouble();
+        memory.tags = in.getStrings();
+        for (size_t a = in.getCount(9); a > 0 && in.ok(); --a) {
+            const std::string entity = in.getString();
+            memory.associations[entity] = in.getDouble();
+        }
+        memory.location = in.getString();
+        memory.relatedMemories = in.getStrings();
+        memory.emotionalValence = in.getDouble();
+        memory.emotionalIntensity = in.getDouble();
+        memory.encoding.attention = in.getDouble();
+        memory.encoding.emotionalArousal = in.getDouble();
+        memory.encoding.novelty = in.getDouble();
+        memory.encoding.selfRelevance = in.getDouble();
+        memory.encoding.rehearsals = in.getDouble();
+        if (in.ok() && !memory.id.empty()) {
+            store(memory);
+        }
+    }
+    for (size_t i = in.getCount(2); i > 0 && in.ok(); --i) {
+        const std::string skill = in.getString();
+        skillIndex_[skill] = in.getString();
+    }
+    return in.ok();
+}
+
+bool LongTermMemory::save(const std::string& filename) const {
+    ArchiveWriter out;
+    write(out);
+    return Persistence::saveArchive(filename, out.finish());
+}
+
+bool LongTermMemory::load(const std::string& filename) {
+    std::string archive, payload;
+    if (!Persistence::loadArchive(filename, archive) ||
+        !ArchiveReader::open(archive, payload)) {
+        return false;
+    }
+    ArchiveReader in(payload);
+    return read(in) && in.atEnd();
+}
+
+void MemorySystem::write(ArchiveWriter& out) const {
+    out.putString(npcId_);
+    out.putVarint(currentTime_);
+    workingMemory_.write(out);
+    longTermMemory_.write(out);
+    out.putVarint(entityEmotions_.size());
+    for (const auto& [entity, emotion] : entityEmotions_) {
+        out.putString(entity);
+        out.putDouble(emotion);
+    }
+    out.putDouble(encodingThreshold_);
+    out.putDouble(consolidationRate_);
+    out.putDouble(forgettingRate_);
+}
+
+bool MemorySystem::read(ArchiveReader& in) {
+    npcId_ = in.getString();
+    currentTime_ = static_cast<uint32_t>(in.getVarint());
+    workingMemory_.read(in);
+    longTermMemory_.read(in);
+    entityEmotions_.clear();
+    for (size_t i = in.getCount(9); i > 0 && in.ok(); --i) {
+        const std::string entity = in.getString();
+        entityEmotions_[entity] = in.getDouble();
+    }
+    encodingThreshold_ = in.getDouble();
+    consolidationRate_ = in.getDouble();
+    forgettingRate_ = in.getDouble();
+    return in.ok();
+}
+
+bool MemorySystem::save(const std::string& filename) const {
+    ArchiveWriter out;
+    write(out);
+    return Persistence::saveArchive(filename, out.finish());
+}
+
+bool MemorySystem::load(const std::string& filename) {
+    std::string archive, payload;
+    if (!Persistence::loadArchive(filename, archive) ||
+        !ArchiveReader::open(archive, payload)) {
+        return false;
+    }
+    ArchiveReader in(payload);
+    return read(in) && in.atEnd();
+}
+
 MemoryNetwork::MemoryNetwork() = default;
 MemoryNetwork::~MemoryNetwork() = default;
 
@@ -0,0 +1,302 @@
+/**
+ * ModelFile.cpp - Memory-Mapped TinyLLM Weight Files
+ */
+
+#include "llm/ModelFile.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define MODELFILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Ultima {
+namespace NPC {
+namespace LLM {
+
+using Kernels::WeightType;
+using Kernels::Weights;
+
+namespace {
+
+const char MAGIC[4] = {'T', 'L', 'L', 'Q'};
+const uint32_t VERSION = 1;
+const size_t ALIGN = 64;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t vocabSize;
+    uint32_t dim;
+    uint32_t hiddenDim;
+    uint32_t layers;
+    uint32_t weightType;
+    uint32_t tensorCount;
+};
+
+struct TensorHeader {
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t weightType;
+    uint32_t reserved;
+};
+
+size_t alignUp(size_t n) {
+    return (n + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+// Rows and columns of each tensor, in file order
+std::vector<std::pair<uint32_t, uint32_t>> tensorShapes(
+    const ModelFile::Shape& shape) {
+    std::vector<std::pair<uint32_t, uint32_t>> shapes = {
+        {shape.vocabSize, shape.dim},
+        {shape.vocabSize, shape.dim}
+    };
+    for (uint32_t i = 0; i < shape.layers; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            shapes.emplace_back(shape.dim, shape.dim);
+        }
+        shapes.emplace_back(shape.hiddenDim, shape.dim);
+        shapes.emplace_back(shape.dim, shape.hiddenDim);
+    }
+    return shapes;
+}
+
+void pad(std::ofstream& out) {
+    static const char zeros[ALIGN] = {};
+    const size_t pos = static_cast<size_t>(out.tellp());
+    out.write(zeros, static_cast<std::streamsize>(alignUp(pos) - pos));
+}
+
+} // namespace
+
+ModelFile::~ModelFile() {
+    close();
+}
+
+bool ModelFile::open(const std::string& filename) {
+    close();
+    if (!map(filename) || !parse()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ModelFile::close() {
+    if (data_ && copy_.empty()) {
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+#elif defined(MODELFILE_MMAP)
+        munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    }
+    copy_.clear();
+    copy_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    shape_ = Shape();
+    tensors_.clear();
+}
+
+bool ModelFile::map(const std::string& filename) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                          nullptr);
+            void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)
+                                  : nullptr;
+            if (view) {
+                data_ = static_cast<const uint8_t*>(view);
+                size_ = static_cast<size_t>(fileSize.QuadPart);
+            } else if (mapping_) {
+                CloseHandle(mapping_);
+                mapping_ = nullptr;
+            }
+        }
+        CloseHandle(file);
+    }
+#elif defined(MODELFILE_MMAP)
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<size_t>(st.st_size),
+                              PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                data_ = static_cast<const uint8_t*>(view);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if (data_) {
+        return true;
+    }
+
+    // No mapping here, so read it in
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    const std::streamoff fileSize = in.tellg();
+    if (fileSize <= 0) {
+        return false;
+    }
+    copy_.resize(static_cast<size_t>(fileSize));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(copy_.data()), fileSize)) {
+        copy_.clear();
+        return false;
+    }
+    data_ = copy_.data();
+    size_ = copy_.size();
+    return true;
+}
+
+bool ModelFile::parse() {
+    FileHeader header;
+    if (size_ < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION ||
+        header.weightType > static_cast<uint32_t>(WeightType::Q4)) {
+        return false;
+    }
+    // Anything bigger is a broken file rather than a model
+    const uint32_t limit = 1u << 20;
+    if (header.vocabSize == 0 || header.vocabSize > limit ||
+        header.dim == 0 || header.dim > limit ||
+        header.hiddenDim == 0 || header.hiddenDim > limit ||
+        header.layers == 0 || header.layers > 1024) {
+        return false;
+    }
+    shape_.vocabSize = header.vocabSize;
+    shape_.dim = header.dim;
+    shape_.hiddenDim = header.hiddenDim;
+    shape_.layers = header.layers;
+    type_ = static_cast<WeightType>(header.weightType);
+
+    const auto shapes = tensorShapes(shape_);
+    if (header.tensorCount != shapes.size()) {
+        return false;
+    }
+    size_t pos = alignUp(sizeof(header));
+    for (const auto& expected : shapes) {
+        TensorHeader th;
+        if (pos + sizeof(th) > size_) {
+            return false;
+        }
+        std::memcpy(&th, data_ + pos, sizeof(th));
+        if (th.rows != expected.first || th.cols != expected.second ||
+            th.weightType > static_cast<uint32_t>(WeightType::Q4)) {
+            return false;
+        }
+        Weights w;
+        w.type = static_cast<WeightType>(th.weightType);
+        w.rows = static_cast<int>(th.rows);
+        w.cols = static_cast<int>(th.cols);
+        pos = alignUp(pos + sizeof(th));
+        if (w.type != WeightType::F32) {
+            const uint64_t scaleBytes = uint64_t(th.rows) * sizeof(float);
+            if (pos + scaleBytes > size_) {
+                return false;
+            }
+            w.scales = reinterpret_cast<const float*>(data_ + pos);
+            pos = alignUp(pos + static_cast<size_t>(scaleBytes));
+        }
+        const uint64_t dataBytes =
+            uint64_t(th.rows) * Kernels::rowBytes(w.type, w.cols);
+        if (pos + dataBytes > size_) {
+            return false;
+        }
+        w.data = data_ + pos;
+        pos = alignUp(pos + static_cast<size_t>(dataBytes));
+        tensors_.push_back(w);
+    }
+    return true;
+}
+
+bool ModelFile::write(const std::string& filename, const Shape& shape,
+                      WeightType type, const std::vector<Weights>& tensors) {
+    const auto shapes = tensorShapes(shape);
+    if (tensors.size() != shapes.size()) {
+        return false;
+    }
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.vocabSize = shape.vocabSize;
+    header.dim = shape.dim;
+    header.hiddenDim = shape.hiddenDim;
+    header.layers = shape.layers;
+    header.weightType = static_cast<uint32_t>(type);
+    header.tensorCount = static_cast<uint32_t>(tensors.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad(out);
+
+    std::vector<float> row;
+    std::vector<float> scales;
+    std::vector<uint8_t> rows;
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const Weights& w = tensors[i];
+        if (static_cast<uint32_t>(w.rows) != shapes[i].first ||
+            static_cast<uint32_t>(w.cols) != shapes[i].second) {
+            return false;
+        }
+        TensorHeader th = {shapes[i].first, shapes[i].second,
+                           static_cast<uint32_t>(type), 0};
+        out.write(reinterpret_cast<const char*>(&th), sizeof(th));
+        pad(out);
+
+        const size_t stride = Kernels::rowBytes(type, w.cols);
+        row.resize(w.cols);
+        scales.resize(w.rows);
+        rows.resize(static_cast<size_t>(w.rows) * stride);
+        for (int r = 0; r < w.rows; ++r) {
+            Kernels::dequantizeRow(w, r, row.data());
+            scales[r] = Kernels::quantizeRow(type, row.data(), w.cols,
+                                             &rows[r * stride]);
+        }
+        if (type != WeightType::F32) {
+            out.write(reinterpret_cast<const char*>(scales.data()),
+                      static_cast<std::streamsize>(scales.size() * sizeof(float)));
+            pad(out);
+        }
+        out.write(reinterpret_cast<const char*>(rows.data()),
+                  static_cast<std::streamsize>(rows.size()));
+        pad(out);
+    }
+    return static_cast<bool>(out.flush());
+}
+
+} // namespace LLM
+} // namespace NPC
+} // namespace Ultima
@@ -3,12 +3,29 @@
  */
 
 #include "NPCSystem.h"
+#include "persistence/Archive.h"
+#include "Job_system.h"
+#include "Frame_profiler.h"
 #include <algorithm>
+#include <cmath>
 #include <random>
 
 namespace Ultima {
 namespace NPC {
 
+namespace {
+
+// Sections of a serialized NPC
+const uint32_t STATE_SECTION = 1;
+const uint32_t PERSONA_SECTION = 2;
+const uint32_t MEMORY_SECTION = 3;
+const uint32_t LEARNING_SECTION = 4;
+
+// And of a saved world
+const uint32_t NPC_SECTION = 1;
+
+} // namespace
+
 //=============================================================================
 // NPCEntity Implementation
 //=============================================================================
@@ -35,6 +52,33 @@ void NPCEntity::update(double deltaTime) {
     emotions.overallValence *= (1.0 - 0.05 * deltaTime);
 }
 
+void NPCEntity::decay(double deltaTime, uint32_t currentTime) {
+    persona_->update(deltaTime);
+    // Memories not yet read stay as they were saved
+    if (pendingMemories_.empty()) {
+        memory_->update(currentTime, deltaTime);
+    }
+}
+
+void NPCEntity::consolidate(uint32_t currentTime) {
+    if (pendingMemories_.empty()) {
+        memory_->consolidate(currentTime);
+    }
+}
+
+Memory::MemorySystem& NPCEntity::getMemory() {
+    if (!pendingMemories_.empty()) {
+        // A damaged section leaves the NPC with no memories
+        auto memory = std::make_unique<Memory::MemorySystem>();
+        Persistence::ArchiveReader in(pendingMemories_);
+        if (memory->read(in) && in.atEnd()) {
+            memory_ = std::move(memory);
+        }
+        std::string().swap(pendingMemories_);
+    }
+    return *memory_;
+}
+
 std::string NPCEntity::respondToDialogue(const std::string& input) {
     // Simple response based on personality
     static std::mt19937 rng(std::random_device{}());
@@ -178,13 +222,105 @@ const Persona::EmotionalState& NPCEntity::getEmotionalState() const {
     return persona_->emotionalState;
 }
 
-std::string NPCEntity::serialize() const {
-    return "{}";  // Placeholder
+std::string NPCEntity::serialize(bool compress) const {
+    using Persistence::ArchiveWriter;
+    ArchiveWriter out;
+
+    ArchiveWriter state;
+    state.putBool(isAlive_);
+    state.putBool(isConscious_);
+    state.putString(currentLocation_);
+    state.putString(currentActivity_);
+    out.putSection(STATE_SECTION, state);
+
+    ArchiveWriter persona;
+    persona_->write(persona);
+    out.putSection(PERSONA_SECTION, persona);
+
+    // Memories never read go back out as they came in
+    if (!pendingMemories_.empty()) {
+        out.putSection(MEMORY_SECTION, pendingMemories_);
+    } else {
+        ArchiveWriter memory;
+        memory_->write(memory);
+        out.putSection(MEMORY_SECTION, memory);
+    }
+
+    ArchiveWriter learning;
+    learning_->write(learning);
+    out.putSection(LEARNING_SECTION, learning);
+
+    return out.finish(compress);
 }
 
 bool NPCEntity::deserialize(const std::string& data) {
-    (void)data;
-    return true;  // Placeholder
+    using Persistence::ArchiveReader;
+    std::string payload;
+    if (!ArchiveReader::open(data, payload)) {
+        return false;
+    }
+
+    // Read into new parts, kept only if everything reads
+    bool isAlive = isAlive_;
+    bool isConscious = isConscious_;
+    std::string location = currentLocation_;
+    std::string activity = currentActivity_;
+    std::unique_ptr<Persona::NPCPersona> persona;
+    std::unique_ptr<Neural::NPCLearningNetwork> learning;
+    std::string memories;
+    bool hasMemories = false;
+
+    ArchiveReader in(payload);
+    uint32_t tag;
+    std::string bytes;
+    while (in.nextSection(tag, bytes)) {
+        ArchiveReader section(bytes);
+        switch (tag) {
+            case STATE_SECTION:
+                isAlive = section.getBool();
+                isConscious = section.getBool();
+                location = section.getString();
+                activity = section.getString();
+                if (!section.ok()) return false;
+                break;
+            case PERSONA_SECTION:
+                persona = std::make_unique<Persona::NPCPersona>(id_);
+                if (!persona->read(section)) return false;
+                persona->id = id_;
+                break;
+            case MEMORY_SECTION:
+                // Read by getMemory(), if the NPC ever needs them
+                memories = std::move(bytes);
+                hasMemories = true;
+                break;
+            case LEARNING_SECTION:
+                learning = std::make_unique<Neural::NPCLearningNetwork>(
+                    Neural::NPCLearningNetwork::LearningContext{});
+                if (!learning->read(section)) return false;
+                break;
+            default:
+                break;  // Added by a later version
+        }
+    }
+    if (!in.ok()) {
+        return false;
+    }
+
+    isAlive_ = isAlive;
+    isConscious_ = isConscious;
+    currentLocation_ = std::move(location);
+    currentActivity_ = std::move(activity);
+    if (persona) {
+        persona_ = std::move(persona);
+    }
+    if (hasMemories) {
+        memory_ = std::make_unique<Memory::MemorySystem>();
+        pendingMemories_ = std::move(memories);
+    }
+    if (learning) {
+        learning_ = std::move(learning);
+    }
+    return true;
 }
 
 //=============================================================================
@@ -195,7 +331,16 @@ NPCManager::NPCManager()
     : dialogueManager_(std::make_unique<AIML::NPCDialogueManager>())
     , relationshipSystem_(std::make_unique<Social::RelationshipSystem>())
     , economicSystem_(std::make_unique<Economy::EconomicSystem>())
+    , urbanSimulation_(std::make_unique<Urban::UrbanSimulation>())
 {
+    // A market tick or a day of growth is one step however long it's
+    // been, so a fast-forward costs one step rather than one per period
+    scheduler_.add({"relationships", 0.0, 0.0, 1,
+                    [this](double deltaTime) { relationshipSystem_->update(deltaTime); }});
+    scheduler_.add({"economy", ECONOMY_PERIOD, 0.0, 1,
+                    [this](double deltaTime) { economicSystem_->update(deltaTime); }});
+    scheduler_.add({"urban", URBAN_PERIOD, 0.0, 1,
+                    [this](double deltaTime) { urbanSimulation_->simulate(deltaTime / URBAN_PERIOD); }});
 }
 
 NPCManager::~NPCManager() = default;
@@ -208,10 +353,19 @@ bool NPCManager::initialize(const std::string& dataDirectory) {
 
 NPCEntity* NPCManager::createNPC(const std::string& id, const std::string& templateId) {
     (void)templateId;
-    
-    auto npc = std::make_unique<NPCEntity>(id);
+    return addNPC(std::make_unique<NPCEntity>(id));
+}
+
+NPCEntity* NPCManager::addNPC(std::unique_ptr<NPCEntity> npc) {
+    const std::string id = npc->getId();
     NPCEntity* ptr = npc.get();
+    removeNPC(id);
     npcs_[id] = std::move(npc);
+    slots_.push_back(ptr);
+    importance_.push_back(1.0);
+    pendingUpdate_.push_back(0.0);
+    pendingDecay_.push_back(0.0);
+    sinceConsolidation_.push_back(0.0);
     
     // Register with relationship system
     relationshipSystem_->registerEntity(id);
@@ -228,7 +382,32 @@ NPCEntity* NPCManager::getNPC(const std::string& id) {
 }
 
 void NPCManager::removeNPC(const std::string& id) {
-    npcs_.erase(id);
+    releaseNPC(id);
+}
+
+std::unique_ptr<NPCEntity> NPCManager::releaseNPC(const std::string& id) {
+    auto it = npcs_.find(id);
+    if (it == npcs_.end()) return nullptr;
+
+    // Swap the last slot into its place
+    const size_t slot = slotOf(id);
+    const size_t last = slots_.size() - 1;
+    slots_[slot] = slots_[last];
+    importance_[slot] = importance_[last];
+    pendingUpdate_[slot] = pendingUpdate_[last];
+    pendingDecay_[slot] = pendingDecay_[last];
+    sinceConsolidation_[slot] = sinceConsolidation_[last];
+    slots_.pop_back();
+    importance_.pop_back();
+    pendingUpdate_.pop_back();
+    pendingDecay_.pop_back();
+    sinceConsolidation_.pop_back();
+    if (decayCursor_ >= slots_.size()) {
+        decayCursor_ = 0;
+    }
+    std::unique_ptr<NPCEntity> npc = std::move(it->second);
+    npcs_.erase(it);
+    return npc;
 }
 
 std::vector<std::string> NPCManager::getAllNPCIds() const {
@@ -251,9 +430,107 @@ std::vector<NPCEntity*> NPCManager::getNPCsAtLocation(const std::string& locatio
 }
 
 void NPCManager::update(double deltaTime) {
-    for (auto& pair : npcs_) {
-        pair.second->update(deltaTime);
+    PROFILE_ZONE("NPCManager::update");
+    worldTime_ += deltaTime;
+    const uint32_t now = static_cast<uint32_t>(worldTime_);
+    const size_t count = slots_.size();
+    for (size_t i = 0; i < count; ++i) {
+        pendingUpdate_[i] += deltaTime;
+        pendingDecay_[i] += deltaTime;
+        sinceConsolidation_[i] += deltaTime;
+    }
+
+    // Plan the tick: NPCs due an update, and this tick's share of the slow
+    // decay, each NPC catching up in one step
+    jobs_.clear();
+    const size_t slice = (count + DECAY_SLICES - 1) / DECAY_SLICES;
+    for (size_t i = 0; i < count; ++i) {
+        UpdateJob job{slots_[i], 0.0, 0.0, false};
+        if (pendingUpdate_[i] >= updatePeriod(importance_[i])) {
+            job.updateTime = pendingUpdate_[i];
+            pendingUpdate_[i] = 0.0;
+        }
+        if ((i + count - decayCursor_) % count < slice) {
+            job.decayTime = pendingDecay_[i];
+            pendingDecay_[i] = 0.0;
+            if (sinceConsolidation_[i] >= CONSOLIDATION_INTERVAL) {
+                job.consolidate = true;
+                sinceConsolidation_[i] = 0.0;
+            }
+        }
+        if (job.updateTime > 0.0 || job.decayTime > 0.0) {
+            jobs_.push_back(job);
+        }
+    }
+    if (count > 0) {
+        decayCursor_ = (decayCursor_ + slice) % count;
+    }
+    PROFILE_COUNTER("npc updates", jobs_.size());
+
+    Job_system::get().run("npc.update", jobs_.size(), [this, now](size_t i) {
+        runJob(jobs_[i], now);
+    });
+
+    // Shared between NPCs, so after the jobs
+    scheduler_.advance(deltaTime);
+}
+
+void NPCManager::runJob(const UpdateJob& job, uint32_t currentTime) {
+    if (job.updateTime > 0.0) {
+        job.npc->update(job.updateTime);
+    }
+    if (job.decayTime > 0.0) {
+        job.npc->decay(job.decayTime, currentTime);
+    }
+    if (job.consolidate) {
+        job.npc->consolidate(currentTime);
+    }
+}
+
+size_t NPCManager::slotOf(const std::string& id) const {
+    auto it = npcs_.find(id);
+    if (it == npcs_.end()) {
+        return slots_.size();
+    }
+    return std::find(slots_.begin(), slots_.end(), it->second.get()) - slots_.begin();
+}
+
+void NPCManager::setImportance(const std::string& id, double importance) {
+    const size_t slot = slotOf(id);
+    if (slot == slots_.size()) return;
+    importance = std::max(0.0, std::min(1.0, importance));
+    const double period = updatePeriod(importance);
+    if (period != updatePeriod(importance_[slot])) {
+        // Spread NPCs with the same period over it
+        pendingUpdate_[slot] = period * static_cast<double>(slot % DECAY_SLICES) / DECAY_SLICES;
+    }
+    importance_[slot] = importance;
+}
+
+double NPCManager::getImportance(const std::string& id) const {
+    const size_t slot = slotOf(id);
+    return slot < slots_.size() ? importance_[slot] : 0.0;
+}
+
+double NPCManager::importanceOf(double distance, bool inConversation) {
+    if (inConversation) {
+        return 1.0;
     }
+    return std::min(1.0, std::pow(0.5, (distance - NEAR_DISTANCE) / NEAR_DISTANCE));
+}
+
+double NPCManager::updatePeriod(double importance) {
+    if (importance >= 0.5) return 0.0;      // Within two NEAR_DISTANCEs
+    if (importance >= 0.125) return 0.25;
+    return 1.0;
+}
+
+void NPCManager::setWorkerThreads(int threads) {
+    Job_system::get().set_threads(threads);
+}
+
+int NPCManager::getWorkerThreads() const {
+    return Job_system::get().get_threads();
 }
 
 void NPCManager::processInteraction(const std::string& npcA, const std::string& npcB,
@@ -261,5 +538,54 @@ void NPCManager::processInteraction(const std::string& npcA, const std::string&
     relationshipSystem_->processInteraction(npcA, npcB, type, intensity);
 }
 
+bool NPCManager::saveWorld(const std::string& filename) const {
+    // NPCs go in as they are, and the world is deflated as a whole
+    Persistence::ArchiveWriter out;
+    out.putDouble(worldTime_);
+    for (const auto& [id, npc] : npcs_) {
+        out.putString(id);
+        out.putSection(NPC_SECTION, npc->serialize(false));
+    }
+    return Persistence::saveArchive(filename, out.finish());
+}
+
+bool NPCManager::loadWorld(const std::string& filename) {
+    using Persistence::ArchiveReader;
+    std::string archive, payload;
+    if (!Persistence::loadArchive(filename, archive) ||
+        !ArchiveReader::open(archive, payload)) {
+        return false;
+    }
+
+    ArchiveReader in(payload);
+    const double worldTime = in.getDouble();
+    std::vector<std::unique_ptr<NPCEntity>> loaded;
+    while (in.ok() && !in.atEnd()) {
+        const std::string id = in.getString();
+        uint32_t tag;
+        std::string data;
+        if (!in.nextSection(tag, data) || tag != NPC_SECTION) {
+            return false;
+        }
+        auto npc = std::make_unique<NPCEntity>(id);
+        if (!npc->deserialize(data)) {
+            return false;
+        }
+        loaded.push_back(std::move(npc));
+    }
+    if (!in.ok()) {
+        return false;
+    }
+
+    for (const auto& id : getAllNPCIds()) {
+        removeNPC(id);
+    }
+    for (auto& npc : loaded) {
+        addNPC(std::move(npc));
+    }
+    worldTime_ = worldTime;
+    return true;
+}
+
 } // namespace NPC
 } // namespace Ultima
@@ -5,10 +5,17 @@
  */
 
 #include "neural/NeuralNetwork.h"
+#include "llm/TensorKernels.h"
+#include "persistence/Archive.h"
+#include "Job_system.h"
 #include <cmath>
 #include <random>
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
 
@@ -16,9 +23,32 @@ namespace Ultima {
 namespace NPC {
 namespace Neural {
 
+namespace Kernels = LLM::Kernels;
+
 // Random number generator
 static std::mt19937 rng(std::random_device{}());
 
+// What a candidate's random stream is for
+enum class Stream : uint32_t {
+    InitialWeights,
+    Genetic,
+    Annealing,
+    RandomSearch
+};
+
+// The random stream of one candidate at one step of training, which is
+// the same whichever thread uses it
+static std::mt19937 candidateRng(uint32_t seed, Stream stream,
+                                 uint64_t step, uint64_t index) {
+    std::seed_seq seq{seed, static_cast<uint32_t>(stream),
+                      static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32),
+                      static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32)};
+    return std::mt19937(seq);
+}
+
+// Random search scores its candidates this many at a time
+static const size_t SEARCH_ROUND = 32;
+
 //=============================================================================
 // Layer Implementation
 //=============================================================================
@@ -32,62 +62,84 @@ Layer::Layer(const LayerConfig& config)
 
 Layer::~Layer() = default;
 
-double Layer::activate(double x) const {
+void Layer::activate(float* x, size_t n) const {
     switch (activation_) {
         case ActivationFunction::Tanh:
-            return std::tanh(x);
+            Kernels::tanhInPlace(x, n);
+            break;
         case ActivationFunction::Exp:
-            return 1.0 / (1.0 + std::exp(-x)); // Sigmoid
+            Kernels::sigmoidInPlace(x, n);
+            break;
         case ActivationFunction::Identity:
-            return x;
         case ActivationFunction::Polynomial1:
-            return x;
+            break;
         case ActivationFunction::Polynomial2:
-            return x * x;
+            for (size_t i = 0; i < n; ++i) {
+                x[i] *= x[i];
+            }
+            break;
         default:
-            return std::tanh(x);
+            Kernels::tanhInPlace(x, n);
+            break;
     }
 }
 
-std::vector<double> Layer::forward(const std::vector<double>& inputs) {
-    if (numInputs_ == 0) {
-        numInputs_ = static_cast<uint32_t>(inputs.size());
-        // Initialize weights if not set
-        if (weights_.empty()) {
-            std::uniform_real_distribution<double> dist(-1.0, 1.0);
-            weights_.resize(numNeurons_);
-            biases_.resize(numNeurons_);
-            for (uint32_t i = 0; i < numNeurons_; ++i) {
-                weights_[i].resize(numInputs_);
-                for (uint32_t j = 0; j < numInputs_; ++j) {
-                    weights_[i][j] = dist(rng);
-                }
-                biases_[i] = dist(rng) * 0.1;
-            }
+void Layer::connect(uint32_t numInputs) {
+    if (numInputs_ != 0) {
+        return;
+    }
+    numInputs_ = numInputs;
+    // Initialize weights if not set
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    weights_.resize(static_cast<size_t>(numNeurons_) * numInputs_);
+    biases_.resize(numNeurons_);
+    for (uint32_t i = 0; i < numNeurons_; ++i) {
+        for (uint32_t j = 0; j < numInputs_; ++j) {
+            weights_[i * numInputs_ + j] = static_cast<float>(dist(rng));
         }
+        biases_[i] = static_cast<float>(dist(rng) * 0.1);
     }
+}
 
-    std::vector<double> outputs(numNeurons_);
-    for (uint32_t i = 0; i < numNeurons_; ++i) {
-        double sum = biases_[i];
-        for (uint32_t j = 0; j < numInputs_ && j < inputs.size(); ++j) {
-            sum += inputs[j] * weights_[i][j];
+void Layer::forward(const float* inputs, size_t count, float* outputs) const {
+    Kernels::gemm(inputs, static_cast<int>(count), weights_.data(),
+                  static_cast<int>(numNeurons_), static_cast<int>(numInputs_),
+                  outputs);
+    for (size_t t = 0; t < count; ++t) {
+        float* row = outputs + t * numNeurons_;
+        for (uint32_t i = 0; i < numNeurons_; ++i) {
+            row[i] += biases_[i];
         }
-        outputs[i] = activate(sum);
     }
-    return outputs;
+    activate(outputs, count * numNeurons_);
 }
 
 void Layer::setWeights(const std::vector<std::vector<double>>& weights) {
-    weights_ = weights;
-    if (!weights_.empty()) {
-        numNeurons_ = static_cast<uint32_t>(weights_.size());
-        numInputs_ = static_cast<uint32_t>(weights_[0].size());
+    if (weights.empty()) {
+        return;
     }
+    numNeurons_ = static_cast<uint32_t>(weights.size());
+    numInputs_ = static_cast<uint32_t>(weights[0].size());
+    weights_.assign(static_cast<size_t>(numNeurons_) * numInputs_, 0.0f);
+    for (uint32_t i = 0; i < numNeurons_; ++i) {
+        for (uint32_t j = 0; j < numInputs_ && j < weights[i].size(); ++j) {
+            weights_[i * numInputs_ + j] = static_cast<float>(weights[i][j]);
+        }
+    }
+    biases_.resize(numNeurons_, 0.0f);
 }
 
 std::vector<std::vector<double>> Layer::getWeights() const {
-    return weights_;
+    std::vector<std::vector<double>> weights;
+    if (numInputs_ == 0) {
+        return weights;
+    }
+    weights.resize(numNeurons_);
+    for (uint32_t i = 0; i < numNeurons_; ++i) {
+        const float* row = weights_.data() + static_cast<size_t>(i) * numInputs_;
+        weights[i].assign(row, row + numInputs_);
+    }
+    return weights;
 }
 
 //=============================================================================
@@ -113,45 +165,275 @@ void NeuralNetwork::build() {
     for (const auto& config : layerConfigs_) {
         layers_.push_back(std::make_unique<Layer>(config));
     }
+    packed_.clear();
+    workspace_.clear();
+    width_ = 0;
     isBuilt_ = true;
 }
 
-std::vector<double> NeuralNetwork::predict(const std::vector<double>& inputs) {
+void NeuralNetwork::setInputSize(uint32_t inputSize) {
     if (!isBuilt_) {
         throw std::runtime_error("Network not built");
     }
+    connect(inputSize);
+}
+
+uint32_t NeuralNetwork::getInputSize() const {
+    return layers_.empty() ? 0 : layers_.front()->getNumInputs();
+}
 
-    std::vector<double> current = inputs;
+uint32_t NeuralNetwork::getOutputSize() const {
+    return layers_.empty() ? 0 : layers_.back()->getNumNeurons();
+}
+
+void NeuralNetwork::connect(uint32_t inputSize) {
+    uint32_t inputs = inputSize;
+    uint32_t width = 0;
     for (auto& layer : layers_) {
-        current = layer->forward(current);
+        layer->connect(inputs);
+        inputs = layer->getNumNeurons();
+        width = std::max(width, inputs);
+    }
+    width_ = width;
+}
+
+float* NeuralNetwork::packedInputs(size_t count) {
+    const size_t size = count * getInputSize();
+    if (packed_.size() < size) {
+        packed_.resize(size);
+    }
+    return packed_.data();
+}
+
+const float* NeuralNetwork::run(const float* inputs, size_t count) {
+    const size_t size = 2 * count * width_;
+    if (workspace_.size() < size) {
+        workspace_.resize(size);
+    }
+    return run(inputs, count, workspace_.data());
+}
+
+const float* NeuralNetwork::run(const float* inputs, size_t count, float* workspace) const {
+    float* buffers[2] = {workspace, workspace + count * width_};
+    const float* current = inputs;
+    for (size_t l = 0; l < layers_.size(); ++l) {
+        float* next = buffers[l % 2];
+        layers_[l]->forward(current, count, next);
+        current = next;
     }
     return current;
 }
 
-void NeuralNetwork::randomizeWeights(double min, double max) {
-    std::uniform_real_distribution<double> dist(min, max);
-    for (auto& layer : layers_) {
-        auto weights = layer->getWeights();
-        for (auto& neuronWeights : weights) {
-            for (auto& w : neuronWeights) {
-                w = dist(rng);
+std::vector<double> NeuralNetwork::predict(const std::vector<double>& inputs) {
+    if (!isBuilt_) {
+        throw std::runtime_error("Network not built");
+    }
+    connect(static_cast<uint32_t>(inputs.size()));
+
+    const uint32_t inputSize = getInputSize();
+    float* packed = packedInputs(1);
+    for (uint32_t j = 0; j < inputSize; ++j) {
+        packed[j] = j < inputs.size() ? static_cast<float>(inputs[j]) : 0.0f;
+    }
+    const float* output = run(packed, 1);
+    return std::vector<double>(output, output + getOutputSize());
+}
+
+void NeuralNetwork::predictBatch(const float* inputs, size_t count, float* outputs) {
+    if (!isBuilt_) {
+        throw std::runtime_error("Network not built");
+    }
+    if (getInputSize() == 0) {
+        throw std::runtime_error("Network input size not set");
+    }
+    connect(getInputSize());
+
+    const size_t inputSize = getInputSize();
+    const size_t outputSize = getOutputSize();
+    for (size_t start = 0; start < count; start += BATCH) {
+        const size_t n = std::min(BATCH, count - start);
+        const float* output = run(inputs + start * inputSize, n);
+        std::copy(output, output + n * outputSize, outputs + start * outputSize);
+    }
+}
+
+void NeuralNetwork::predictBatch(const float* inputs, size_t count, float* outputs,
+                                 std::vector<float>& workspace) const {
+    if (!isBuilt_) {
+        throw std::runtime_error("Network not built");
+    }
+    if (getInputSize() == 0) {
+        throw std::runtime_error("Network input size not set");
+    }
+    const size_t size = 2 * std::min(BATCH, count) * width_;
+    if (workspace.size() < size) {
+        workspace.resize(size);
+    }
+
+    const size_t inputSize = getInputSize();
+    const size_t outputSize = getOutputSize();
+    for (size_t start = 0; start < count; start += BATCH) {
+        const size_t n = std::min(BATCH, count - start);
+        const float* output = run(inputs + start * inputSize, n, workspace.data());
+        std::copy(output, output + n * outputSize, outputs + start * outputSize);
+    }
+}
+
+//=============================================================================
+// FitnessEvaluator Implementation
+//=============================================================================
+
+/**
+ * Scores sets of weights against training data on the job system's
+ * threads, each copy of the network in use by one of them at a time. The
+ * network itself is the first copy.
+ */
+class NeuralNetwork::FitnessEvaluator {
+public:
+    FitnessEvaluator(NeuralNetwork& network, const std::vector<TrainingPoint>& data,
+                     ErrorFunction errorFunc, int threads)
+        : network_(network)
+        , data_(data)
+        , errorFunc_(errorFunc)
+    {
+        if (threads <= 0) {
+            threads = Job_system::get().get_threads();
+        }
+        for (int i = 1; i < threads; ++i) {
+            clones_.push_back(network.clone());
+        }
+    }
+
+    int getNumThreads() const { return static_cast<int>(clones_.size()) + 1; }
+
+    /**
+     * errors[i] = error of the network with weights candidates[i]. The
+     * network is left with one of the candidates.
+     */
+    void evaluate(const std::vector<std::vector<float>>& candidates,
+                  std::vector<double>& errors) {
+        errors.assign(candidates.size(), 0.0);
+        std::atomic<size_t> next{0};
+        Job_system::get().run("neural.fitness", clones_.size() + 1, [&](size_t copy) {
+            NeuralNetwork& network = copy == 0 ? network_ : *clones_[copy - 1];
+            for (size_t i = next++; i < candidates.size(); i = next++) {
+                network.setAllWeights(candidates[i]);
+                errors[i] = network.computeError(data_, errorFunc_);
             }
+        });
+    }
+
+private:
+    NeuralNetwork& network_;
+    const std::vector<TrainingPoint>& data_;
+    ErrorFunction errorFunc_;
+    std::vector<std::unique_ptr<NeuralNetwork>> clones_;
+};
+
+void NeuralNetwork::write(Persistence::ArchiveWriter& out) const {
+    out.putVarint(layers_.size());
+    for (const auto& layer : layers_) {
+        out.putVarint(layer->getNumNeurons());
+        out.putVarint(layer->getNumInputs());
+        for (size_t i = 0; i < layer->getNumWeights(); ++i) {
+            out.putFloat(layer->getWeightData()[i]);
+        }
+        for (uint32_t i = 0; i < layer->getNumNeurons(); ++i) {
+            out.putFloat(layer->getBiasData()[i]);
         }
-        layer->setWeights(weights);
     }
 }
 
+bool NeuralNetwork::read(Persistence::ArchiveReader& in) {
+    if (in.getVarint() != layers_.size()) {
+        return false;
+    }
+    for (auto& layer : layers_) {
+        if (in.getVarint() != layer->getNumNeurons() ||
+            in.getVarint() != layer->getNumInputs() ||
+            layer->getNumWeights() != static_cast<size_t>(layer->getNumNeurons()) *
+                                      layer->getNumInputs()) {
+            return false;
+        }
+        for (size_t i = 0; i < layer->getNumWeights(); ++i) {
+            layer->getWeightData()[i] = in.getFloat();
+        }
+        for (uint32_t i = 0; i < layer->getNumNeurons(); ++i) {
+            layer->getBiasData()[i] = in.getFloat();
+        }
+    }
+    return in.ok();
+}
+
+std::vector<float> NeuralNetwork::getAllWeights() const {
+    std::vector<float> weights;
+    for (const auto& layer : layers_) {
+        weights.insert(weights.end(), layer->getWeightData(),
+                       layer->getWeightData() + layer->getNumWeights());
+    }
+    return weights;
+}
+
+void NeuralNetwork::setAllWeights(const std::vector<float>& weights) {
+    size_t offset = 0;
+    for (auto& layer : layers_) {
+        const size_t n = std::min(layer->getNumWeights(), weights.size() - offset);
+        std::copy(weights.begin() + offset, weights.begin() + offset + n,
+                  layer->getWeightData());
+        offset += n;
+    }
+}
+
+std::unique_ptr<NeuralNetwork> NeuralNetwork::clone() const {
+    auto copy = std::make_unique<NeuralNetwork>();
+    copy->layerConfigs_ = layerConfigs_;
+    for (const auto& layer : layers_) {
+        copy->layers_.push_back(std::make_unique<Layer>(*layer));
+    }
+    copy->isBuilt_ = isBuilt_;
+    copy->connect(getInputSize());
+    return copy;
+}
+
+void NeuralNetwork::randomizeWeights(double min, double max, uint32_t seed) {
+    std::mt19937 gen = candidateRng(seed, Stream::InitialWeights, 0, 0);
+    std::uniform_real_distribution<double> dist(min, max);
+    std::vector<float> weights = getAllWeights();
+    for (auto& w : weights) {
+        w = static_cast<float>(dist(gen));
+    }
+    setAllWeights(weights);
+}
+
 double NeuralNetwork::computeError(const std::vector<TrainingPoint>& data,
                                    ErrorFunction errorFunc) {
+    if (!data.empty()) {
+        connect(static_cast<uint32_t>(data.front().inputs.size()));
+    }
+    const uint32_t inputSize = getInputSize();
+    const uint32_t outputSize = getOutputSize();
+
     double totalError = 0.0;
-    for (const auto& point : data) {
-        auto output = predict(point.inputs);
-        for (size_t i = 0; i < output.size() && i < point.expectedOutputs.size(); ++i) {
-            double diff = output[i] - point.expectedOutputs[i];
-            if (errorFunc == ErrorFunction::L2) {
-                totalError += diff * diff;
-            } else {
-                totalError += std::abs(diff);
+    for (size_t start = 0; start < data.size(); start += BATCH) {
+        const size_t n = std::min(BATCH, data.size() - start);
+        float* packed = packedInputs(n);
+        for (size_t t = 0; t < n; ++t) {
+            const auto& inputs = data[start + t].inputs;
+            for (uint32_t j = 0; j < inputSize; ++j) {
+                *packed++ = j < inputs.size() ? static_cast<float>(inputs[j]) : 0.0f;
+            }
+        }
+
+        const float* output = run(packed_.data(), n);
+        for (size_t t = 0; t < n; ++t, output += outputSize) {
+            const auto& expected = data[start + t].expectedOutputs;
+            for (size_t i = 0; i < outputSize && i < expected.size(); ++i) {
+                double diff = output[i] - expected[i];
+                if (errorFunc == ErrorFunction::L2) {
+                    totalError += diff * diff;
+                } else {
+                    totalError += std::abs(diff);
+                }
             }
         }
     }
@@ -163,31 +445,43 @@ void NeuralNetwork::train(const std::vector<TrainingPoint>& data,
     if (!isBuilt_) {
         build();
     }
+    if (!data.empty()) {
+        connect(static_cast<uint32_t>(data.front().inputs.size()));
+    }
 
-    if (config.randomizeInitialWeights) {
-        randomizeWeights(config.weightMin, config.weightMax);
+    TrainingConfig seeded = config;
+    if (seeded.seed == 0) {
+        seeded.seed = static_cast<uint32_t>(rng()) | 1u;
     }
 
-    switch (config.method) {
+    if (seeded.randomizeInitialWeights) {
+        randomizeWeights(seeded.weightMin, seeded.weightMax, seeded.seed);
+    }
+
+    switch (seeded.method) {
         case OptimizationMethod::GradientDescent:
-            trainGradientDescent(data, config);
+            trainGradientDescent(data, seeded);
             break;
         case OptimizationMethod::SimulatedAnnealing:
-            trainSimulatedAnnealing(data, config);
+            trainSimulatedAnnealing(data, seeded);
             break;
         case OptimizationMethod::GeneticAlgorithm:
-            trainGeneticAlgorithm(data, config);
+            trainGeneticAlgorithm(data, seeded);
             break;
         case OptimizationMethod::RandomSearch:
-            trainRandomSearch(data, config);
+            trainRandomSearch(data, seeded);
             break;
         case OptimizationMethod::MSMCO:
             // Fall back to simulated annealing for now
-            trainSimulatedAnnealing(data, config);
+            trainSimulatedAnnealing(data, seeded);
             break;
     }
 
     lastError_ = computeError(data, config.errorFunction);
+
+    // Sized for whole batches of training data, which predicting rarely needs
+    packed_ = std::vector<float>();
+    workspace_ = std::vector<float>();
 }
 
 void NeuralNetwork::trainGradientDescent(const std::vector<TrainingPoint>& data,
@@ -200,189 +494,183 @@ void NeuralNetwork::trainGradientDescent(const std::vector<TrainingPoint>& data,
 
         // Numerical gradient descent
         for (auto& layer : layers_) {
-            auto weights = layer->getWeights();
-            for (size_t i = 0; i < weights.size(); ++i) {
-                for (size_t j = 0; j < weights[i].size(); ++j) {
-                    double original = weights[i][j];
+            float* weights = layer->getWeightData();
+            for (size_t i = 0; i < layer->getNumWeights(); ++i) {
+                const float original = weights[i];
 
-                    // Compute gradient numerically
-                    weights[i][j] = original + epsilon;
-                    layer->setWeights(weights);
-                    double errorPlus = computeError(data, config.errorFunction);
+                // Compute gradient numerically
+                weights[i] = static_cast<float>(original + epsilon);
+                double errorPlus = computeError(data, config.errorFunction);
 
-                    weights[i][j] = original - epsilon;
-                    layer->setWeights(weights);
-                    double errorMinus = computeError(data, config.errorFunction);
+                weights[i] = static_cast<float>(original - epsilon);
+                double errorMinus = computeError(data, config.errorFunction);
 
-                    double gradient = (errorPlus - errorMinus) / (2.0 * epsilon);
+                double gradient = (errorPlus - errorMinus) / (2.0 * epsilon);
 
-                    // Update weight
-                    weights[i][j] = original - config.learningRate * gradient;
-                }
+                // Update weight
+                weights[i] = static_cast<float>(original - config.learningRate * gradient);
             }
-            layer->setWeights(weights);
         }
     }
 }
 
 void NeuralNetwork::trainSimulatedAnnealing(const std::vector<TrainingPoint>& data,
                                             const TrainingConfig& config) {
+    FitnessEvaluator evaluator(*this, data, config.errorFunction, config.threads);
+    const size_t numProposals = static_cast<size_t>(config.annealingProposals > 0 ?
+        config.annealingProposals : evaluator.getNumThreads());
+
+    std::vector<float> current = getAllWeights();
+    double currentError = computeError(data, config.errorFunction);
     double temperature = config.initialTemperature;
-    double bestError = computeError(data, config.errorFunction);
 
     std::uniform_real_distribution<double> probDist(0.0, 1.0);
     std::uniform_real_distribution<double> perturbDist(-0.5, 0.5);
+    std::vector<std::vector<float>> proposals(numProposals);
+    std::vector<double> errors;
 
     for (int iter = 0; iter < config.maxIterations && temperature > config.minTemperature; ++iter) {
         // Perturb weights
-        for (auto& layer : layers_) {
-            auto weights = layer->getWeights();
-            for (auto& neuronWeights : weights) {
-                for (auto& w : neuronWeights) {
-                    w += perturbDist(rng) * temperature;
-                    w = std::clamp(w, config.weightMin, config.weightMax);
-                }
+        for (size_t p = 0; p < numProposals; ++p) {
+            std::mt19937 gen = candidateRng(config.seed, Stream::Annealing, iter, p);
+            proposals[p] = current;
+            for (auto& w : proposals[p]) {
+                w = static_cast<float>(std::clamp(w + perturbDist(gen) * temperature,
+                                                  config.weightMin, config.weightMax));
             }
-            layer->setWeights(weights);
         }
-
-        double newError = computeError(data, config.errorFunction);
-        double delta = newError - bestError;
+        evaluator.evaluate(proposals, errors);
+        const size_t best = static_cast<size_t>(
+            std::min_element(errors.begin(), errors.end()) - errors.begin());
+        double delta = errors[best] - currentError;
 
         // Accept or reject
-        if (delta < 0 || probDist(rng) < std::exp(-delta / temperature)) {
-            bestError = newError;
+        std::mt19937 gen = candidateRng(config.seed, Stream::Annealing, iter, numProposals);
+        if (delta < 0 || probDist(gen) < std::exp(-delta / temperature)) {
+            current.swap(proposals[best]);
+            currentError = errors[best];
         }
 
         // Cool down
         temperature *= config.coolingRate;
 
-        if (bestError < config.accuracy) break;
+        if (currentError < config.accuracy) break;
     }
+    setAllWeights(current);
 }
 
 void NeuralNetwork::trainGeneticAlgorithm(const std::vector<TrainingPoint>& data,
                                           const TrainingConfig& config) {
     // Simplified genetic algorithm
-    struct Individual {
-        std::vector<std::vector<std::vector<double>>> weights;
-        double fitness = 0.0;
-    };
+    FitnessEvaluator evaluator(*this, data, config.errorFunction, config.threads);
+    const size_t size = static_cast<size_t>(std::max(config.populationSize, 1));
+    const size_t numWeights = getAllWeights().size();
 
-    std::vector<Individual> population(config.populationSize);
+    std::vector<std::vector<float>> population(size);
+    std::vector<std::vector<float>> newPop(size);
 
     // Initialize population
     std::uniform_real_distribution<double> weightDist(config.weightMin, config.weightMax);
-    for (auto& ind : population) {
-        ind.weights.resize(layers_.size());
-        for (size_t l = 0; l < layers_.size(); ++l) {
-            auto layerWeights = layers_[l]->getWeights();
-            ind.weights[l] = layerWeights;
-            for (auto& neuronWeights : ind.weights[l]) {
-                for (auto& w : neuronWeights) {
-                    w = weightDist(rng);
-                }
-            }
+    for (size_t i = 0; i < size; ++i) {
+        std::mt19937 gen = candidateRng(config.seed, Stream::Genetic, 0, i);
+        population[i].resize(numWeights);
+        for (auto& w : population[i]) {
+            w = static_cast<float>(weightDist(gen));
         }
     }
 
     std::uniform_real_distribution<double> probDist(0.0, 1.0);
+    std::vector<double> errors;
+    std::vector<size_t> order(size);
+    std::vector<float> best;
 
     for (int gen = 0; gen < config.maxIterations; ++gen) {
         // Evaluate fitness
-        for (auto& ind : population) {
-            for (size_t l = 0; l < layers_.size(); ++l) {
-                layers_[l]->setWeights(ind.weights[l]);
-            }
-            double error = computeError(data, config.errorFunction);
-            ind.fitness = 1.0 / (1.0 + error);
-        }
+        evaluator.evaluate(population, errors);
 
         // Sort by fitness
-        std::sort(population.begin(), population.end(),
-                  [](const Individual& a, const Individual& b) {
-                      return a.fitness > b.fitness;
-                  });
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(),
+                         [&errors](size_t a, size_t b) {
+                             return errors[a] < errors[b];
+                         });
+        best = population[order[0]];
 
-        if (1.0 / population[0].fitness - 1.0 < config.accuracy) break;
+        if (errors[order[0]] < config.accuracy) break;
 
         // Selection and reproduction
-        std::vector<Individual> newPop;
-        newPop.push_back(population[0]); // Elitism
+        newPop[0] = best; // Elitism
+
+        for (size_t i = 1; i < size; ++i) {
+            std::mt19937 childRng = candidateRng(config.seed, Stream::Genetic, gen + 1, i);
 
-        while (newPop.size() < population.size()) {
             // Tournament selection
-            size_t p1 = std::min(rng() % 5, population.size() - 1);
-            size_t p2 = std::min(rng() % 5, population.size() - 1);
-
-            Individual child;
-            child.weights.resize(layers_.size());
-
-            // Crossover
-            for (size_t l = 0; l < layers_.size(); ++l) {
-                child.weights[l] = (probDist(rng) < 0.5) ?
-                    population[p1].weights[l] : population[p2].weights[l];
-
-                // Mutation
-                for (auto& neuronWeights : child.weights[l]) {
-                    for (auto& w : neuronWeights) {
-                        if (probDist(rng) < config.mutationRate) {
-                            w += (probDist(rng) - 0.5) * 0.2;
-                            w = std::clamp(w, config.weightMin, config.weightMax);
-                        }
-                    }
+            const auto& parent1 = population[order[std::min<size_t>(childRng() % 5, size - 1)]];
+            const auto& parent2 = population[order[std::min<size_t>(childRng() % 5, size - 1)]];
+
+            // Crossover, a layer at a time
+            auto& child = newPop[i];
+            child.resize(numWeights);
+            size_t offset = 0;
+            for (const auto& layer : layers_) {
+                const auto& parent = (probDist(childRng) < 0.5) ? parent1 : parent2;
+                std::copy(parent.begin() + offset,
+                          parent.begin() + offset + layer->getNumWeights(),
+                          child.begin() + offset);
+                offset += layer->getNumWeights();
+            }
+
+            // Mutation
+            for (auto& w : child) {
+                if (probDist(childRng) < config.mutationRate) {
+                    w = static_cast<float>(std::clamp(w + (probDist(childRng) - 0.5) * 0.2,
+                                                      config.weightMin, config.weightMax));
                 }
             }
-            newPop.push_back(child);
         }
-        population = std::move(newPop);
+        population.swap(newPop);
     }
 
     // Apply best weights
-    for (size_t l = 0; l < layers_.size(); ++l) {
-        layers_[l]->setWeights(population[0].weights[l]);
+    if (!best.empty()) {
+        setAllWeights(best);
     }
 }
 
 void NeuralNetwork::trainRandomSearch(const std::vector<TrainingPoint>& data,
                                       const TrainingConfig& config) {
+    FitnessEvaluator evaluator(*this, data, config.errorFunction, config.threads);
+    std::vector<float> bestWeights = getAllWeights();
     double bestError = computeError(data, config.errorFunction);
-    std::vector<std::vector<std::vector<double>>> bestWeights;
-
-    for (auto& layer : layers_) {
-        bestWeights.push_back(layer->getWeights());
-    }
 
     std::uniform_real_distribution<double> dist(config.weightMin, config.weightMax);
+    std::vector<std::vector<float>> candidates;
+    std::vector<double> errors;
 
-    for (int iter = 0; iter < config.maxIterations; ++iter) {
+    const size_t maxIterations = static_cast<size_t>(std::max(config.maxIterations, 0));
+    for (size_t start = 0; start < maxIterations && bestError >= config.accuracy;
+         start += SEARCH_ROUND) {
         // Random weights
-        for (auto& layer : layers_) {
-            auto weights = layer->getWeights();
-            for (auto& neuronWeights : weights) {
-                for (auto& w : neuronWeights) {
-                    w = dist(rng);
-                }
+        candidates.resize(std::min(SEARCH_ROUND, maxIterations - start));
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            std::mt19937 gen = candidateRng(config.seed, Stream::RandomSearch, 0, start + i);
+            candidates[i].resize(bestWeights.size());
+            for (auto& w : candidates[i]) {
+                w = static_cast<float>(dist(gen));
             }
-            layer->setWeights(weights);
         }
 
-        double error = computeError(data, config.errorFunction);
-        if (error < bestError) {
-            bestError = error;
-            bestWeights.clear();
-            for (auto& layer : layers_) {
-                bestWeights.push_back(layer->getWeights());
+        evaluator.evaluate(candidates, errors);
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (errors[i] < bestError) {
+                bestError = errors[i];
+                bestWeights.swap(candidates[i]);
             }
         }
-
-        if (bestError < config.accuracy) break;
     }
 
     // Restore best weights
-    for (size_t l = 0; l < layers_.size(); ++l) {
-        layers_[l]->setWeights(bestWeights[l]);
-    }
+    setAllWeights(bestWeights);
 }
 
 bool NeuralNetwork::save(const std::string& filename) const {
@@ -417,6 +705,9 @@ bool NeuralNetwork::load(const std::string& filename) {
 
     layers_.clear();
     layerConfigs_.clear();
+    packed_.clear();
+    workspace_.clear();
+    width_ = 0;
 
     for (size_t l = 0; l < numLayers; ++l) {
         size_t numNeurons, numInputs;
@@ -437,6 +728,12 @@ bool NeuralNetwork::load(const std::string& filename) {
         }
         layer->setWeights(weights);
         layers_.push_back(std::move(layer));
+
+        // Each layer's inputs are the outputs of the one before
+        if (l > 0 && numInputs != layers_[l - 1]->getNumNeurons()) {
+            clear();
+            return false;
+        }
     }
 
     isBuilt_ = true;
@@ -454,6 +751,9 @@ uint32_t NeuralNetwork::getNumNeurons() const {
 void NeuralNetwork::clear() {
     layers_.clear();
     layerConfigs_.clear();
+    packed_.clear();
+    workspace_.clear();
+    width_ = 0;
     isBuilt_ = false;
     lastError_ = 0.0;
 }
@@ -465,55 +765,86 @@ void NeuralNetwork::clear() {
 NPCLearningNetwork::NPCLearningNetwork(LearningContext context)
     : context_(context)
 {
+    switch (context_) {
+        case LearningContext::DecisionMaking:    numActions_ = 8; break;
+        case LearningContext::SocialBehavior:    numActions_ = 6; break;
+        case LearningContext::CombatTactics:     numActions_ = 10; break;
+        case LearningContext::EconomicDecisions: numActions_ = 5; break;
+        case LearningContext::EmotionalResponse: numActions_ = 8; break;
+    }
     initializeNetwork();
 }
 
 NPCLearningNetwork::~NPCLearningNetwork() = default;
 
-void NPCLearningNetwork::initializeNetwork() {
-    network_ = std::make_unique<NeuralNetwork>();
+uint32_t NPCLearningNetwork::contextInputSize(LearningContext context) {
+    switch (context) {
+        case LearningContext::DecisionMaking:    return 16;
+        case LearningContext::SocialBehavior:    return 12;
+        case LearningContext::CombatTactics:     return 20;
+        case LearningContext::EconomicDecisions: return 14;
+        case LearningContext::EmotionalResponse: return 10;
+    }
+    return 16;
+}
 
-    // Configure based on context
-    switch (context_) {
-        case LearningContext::DecisionMaking:
-            inputSize_ = 16;
-            numActions_ = 8;
-            break;
-        case LearningContext::SocialBehavior:
-            inputSize_ = 12;
-            numActions_ = 6;
-            break;
-        case LearningContext::CombatTactics:
-            inputSize_ = 20;
-            numActions_ = 10;
-            break;
-        case LearningContext::EconomicDecisions:
-            inputSize_ = 14;
-            numActions_ = 5;
-            break;
-        case LearningContext::EmotionalResponse:
-            inputSize_ = 10;
-            numActions_ = 8;
-            break;
+// Base networks by context, made on first use
+static std::mutex baseMutex;
+static std::map<int, std::shared_ptr<const NeuralNetwork>> baseNetworks;
+
+std::shared_ptr<const NeuralNetwork> NPCLearningNetwork::sharedBase(LearningContext context) {
+    std::lock_guard<std::mutex> lock(baseMutex);
+    std::shared_ptr<const NeuralNetwork>& base = baseNetworks[static_cast<int>(context)];
+    if (!base) {
+        // input -> hidden -> hidden
+        auto network = std::make_shared<NeuralNetwork>();
+
+        LayerConfig hidden1;
+        hidden1.numNeurons = 32;
+        hidden1.activation = ActivationFunction::Tanh;
+        network->addLayer(hidden1);
+
+        LayerConfig hidden2;
+        hidden2.numNeurons = 16;
+        hidden2.activation = ActivationFunction::Tanh;
+        network->addLayer(hidden2);
+
+        network->build();
+        network->setInputSize(contextInputSize(context));
+        base = std::move(network);
     }
+    return base;
+}
 
-    // Build network: input -> hidden -> hidden -> output
-    LayerConfig hidden1;
-    hidden1.numNeurons = 32;
-    hidden1.activation = ActivationFunction::Tanh;
-    network_->addLayer(hidden1);
+bool NPCLearningNetwork::loadBaseNetwork(LearningContext context, const std::string& filename) {
+    auto network = std::make_shared<NeuralNetwork>();
+    if (!network->load(filename) ||
+        network->getInputSize() != contextInputSize(context) ||
+        network->getOutputSize() == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(baseMutex);
+    baseNetworks[static_cast<int>(context)] = std::move(network);
+    return true;
+}
 
-    LayerConfig hidden2;
-    hidden2.numNeurons = 16;
-    hidden2.activation = ActivationFunction::Tanh;
-    network_->addLayer(hidden2);
+void NPCLearningNetwork::initializeNetwork() {
+    base_ = sharedBase(context_);
+    inputSize_ = base_->getInputSize();
 
+    // features -> output
+    head_ = std::make_unique<NeuralNetwork>();
     LayerConfig output;
     output.numNeurons = numActions_;
     output.activation = ActivationFunction::Tanh;
-    network_->addLayer(output);
+    head_->addLayer(output);
+    head_->build();
+    head_->setInputSize(base_->getOutputSize());
+}
 
-    network_->build();
+void NPCLearningNetwork::computeFeatures(size_t count) {
+    batchFeatures_.resize(count * base_->getOutputSize());
+    base_->predictBatch(batchInputs_.data(), count, batchFeatures_.data(), workspace_);
 }
 
 void NPCLearningNetwork::learnFromExperience(
@@ -557,9 +888,40 @@ uint32_t NPCLearningNetwork::predictBestAction(const std::vector<double>& situat
 std::vector<double> NPCLearningNetwork::getActionProbabilities(
     const std::vector<double>& situation)
 {
-    std::vector<double> input = situation;
-    input.resize(inputSize_, 0.0);
-    return network_->predict(input);
+    batchInputs_.assign(inputSize_, 0.0f);
+    std::copy(situation.begin(),
+              situation.begin() + std::min<size_t>(situation.size(), inputSize_),
+              batchInputs_.begin());
+    computeFeatures(1);
+
+    batchOutputs_.resize(numActions_);
+    head_->predictBatch(batchFeatures_.data(), 1, batchOutputs_.data());
+    return std::vector<double>(batchOutputs_.begin(), batchOutputs_.end());
+}
+
+std::vector<uint32_t> NPCLearningNetwork::predictBestActions(
+    const std::vector<std::vector<double>>& situations)
+{
+    const size_t inputSize = inputSize_;
+    const size_t outputSize = numActions_;
+    batchInputs_.assign(situations.size() * inputSize, 0.0f);
+    batchOutputs_.resize(situations.size() * outputSize);
+    for (size_t s = 0; s < situations.size(); ++s) {
+        const size_t n = std::min(situations[s].size(), inputSize);
+        std::copy(situations[s].begin(), situations[s].begin() + n,
+                  batchInputs_.begin() + s * inputSize);
+    }
+    computeFeatures(situations.size());
+    head_->predictBatch(batchFeatures_.data(), situations.size(),
+                        batchOutputs_.data());
+
+    std::vector<uint32_t> actions(situations.size(), 0);
+    for (size_t s = 0; s < situations.size() && outputSize > 0; ++s) {
+        const float* output = batchOutputs_.data() + s * outputSize;
+        actions[s] = static_cast<uint32_t>(
+            std::max_element(output, output + outputSize) - output);
+    }
+    return actions;
 }
 
 void NPCLearningNetwork::setNumActions(uint32_t numActions) {
@@ -570,21 +932,69 @@ void NPCLearningNetwork::setNumActions(uint32_t numActions) {
 void NPCLearningNetwork::batchTrain() {
     if (experienceBuffer_.empty()) return;
 
+    // The base doesn't learn, so the head trains on its features
+    const size_t count = experienceBuffer_.size();
+    batchInputs_.assign(count * inputSize_, 0.0f);
+    for (size_t e = 0; e < count; ++e) {
+        const std::vector<double>& inputs = experienceBuffer_[e].inputs;
+        std::copy(inputs.begin(),
+                  inputs.begin() + std::min<size_t>(inputs.size(), inputSize_),
+                  batchInputs_.begin() + e * inputSize_);
+    }
+    computeFeatures(count);
+
+    const size_t featureSize = base_->getOutputSize();
+    std::vector<TrainingPoint> features(count);
+    for (size_t e = 0; e < count; ++e) {
+        const float* f = batchFeatures_.data() + e * featureSize;
+        features[e].inputs.assign(f, f + featureSize);
+        features[e].expectedOutputs = experienceBuffer_[e].expectedOutputs;
+    }
+
     TrainingConfig config;
     config.method = OptimizationMethod::GradientDescent;
     config.learningRate = 0.01;
     config.maxIterations = 100;
     config.randomizeInitialWeights = false;
 
-    network_->train(experienceBuffer_, config);
+    head_->train(features, config);
 }
 
 bool NPCLearningNetwork::save(const std::string& filename) const {
-    return network_->save(filename);
+    return head_->save(filename);
 }
 
 bool NPCLearningNetwork::load(const std::string& filename) {
-    return network_->load(filename);
+    auto head = std::make_unique<NeuralNetwork>();
+    if (!head->load(filename) ||
+        head->getNumLayers() != 1 ||
+        head->getInputSize() != base_->getOutputSize()) {
+        return false;
+    }
+    head_ = std::move(head);
+    numActions_ = head_->getOutputSize();
+    return true;
+}
+
+void NPCLearningNetwork::write(Persistence::ArchiveWriter& out) const {
+    out.putVarint(numActions_);
+    out.putVarint(experienceCount_);
+    out.putDouble(totalReward_);
+    head_->write(out);
+}
+
+bool NPCLearningNetwork::read(Persistence::ArchiveReader& in) {
+    // Each action is an output neuron, with a weight per feature
+    const size_t numActions = in.getCount(4 * base_->getOutputSize());
+    if (numActions == 0) {
+        return false;
+    }
+    if (numActions != numActions_) {
+        setNumActions(static_cast<uint32_t>(numActions));
+    }
+    experienceCount_ = static_cast<uint32_t>(in.getVarint());
+    totalReward_ = in.getDouble();
+    return head_->read(in);
 }
 
 std::vector<double> NPCLearningNetwork::encodeAction(uint32_t action) const {
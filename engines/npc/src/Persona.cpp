@@ -5,6 +5,7 @@
  */
 
 #include "persona/Persona.h"
+#include "persistence/Archive.h"
 #include <cmath>
 #include <random>
 #include <algorithm>
@@ -473,47 +474,306 @@ std::map<std::string, double> NPCPersona::getDialogueModifiers() const {
     return modifiers;
 }
 
-std::string NPCPersona::serialize() const {
-    std::stringstream ss;
+namespace {
+
+using Persistence::ArchiveReader;
+using Persistence::ArchiveWriter;
+
+// Every field of the structs that are all doubles, in archive order
+const std::vector<double BigFiveTraits::*> TRAIT_FIELDS = {
+    &BigFiveTraits::openness, &BigFiveTraits::intellectualCuriosity,
+    &BigFiveTraits::artisticInterest, &BigFiveTraits::conscientiousness,
+    &BigFiveTraits::orderliness, &BigFiveTraits::dutifulness,
+    &BigFiveTraits::achievementStriving, &BigFiveTraits::selfDiscipline,
+    &BigFiveTraits::extraversion, &BigFiveTraits::warmth,
+    &BigFiveTraits::gregariousness, &BigFiveTraits::assertiveness,
+    &BigFiveTraits::activityLevel, &BigFiveTraits::agreeableness,
+    &BigFiveTraits::trust, &BigFiveTraits::altruism, &BigFiveTraits::compliance,
+    &BigFiveTraits::modesty, &BigFiveTraits::neuroticism, &BigFiveTraits::anxiety,
+    &BigFiveTraits::hostility, &BigFiveTraits::depression,
+    &BigFiveTraits::selfConsciousness, &BigFiveTraits::impulsiveness,
+    &BigFiveTraits::vulnerability
+};
+
+const std::vector<double BehavioralTendencies::*> BEHAVIOR_FIELDS = {
+    &BehavioralTendencies::riskTolerance, &BehavioralTendencies::impulsiveness,
+    &BehavioralTendencies::stubbornness, &BehavioralTendencies::cooperativeness,
+    &BehavioralTendencies::competitiveness, &BehavioralTendencies::generosity,
+    &BehavioralTendencies::forgiveness, &BehavioralTendencies::loyalty,
+    &BehavioralTendencies::aggression, &BehavioralTendencies::cowardice,
+    &BehavioralTendencies::mercy, &BehavioralTendencies::materialism,
+    &BehavioralTendencies::frugality, &BehavioralTendencies::honesty,
+    &BehavioralTendencies::suspicion, &BehavioralTendencies::curiosity,
+    &BehavioralTendencies::helpfulness
+};
+
+template <typename T>
+void putFields(ArchiveWriter& out, const T& value, const std::vector<double T::*>& fields) {
+    for (double T::* field : fields) {
+        out.putDouble(value.*field);
+    }
+}
+
+template <typename T>
+void getFields(ArchiveReader& in, T& value, const std::vector<double T::*>& fields) {
+    for (double T::* field : fields) {
+        value.*field = in.getDouble();
+    }
+}
+
+template <typename Enum>
+Enum getEnum(ArchiveReader& in) {
+    return static_cast<Enum>(in.getVarint());
+}
+
+} // namespace
+
+void NPCPersona::write(ArchiveWriter& out) const {
+    out.putString(id);
+    out.putString(name);
+    out.putString(title);
+    out.putString(description);
+    out.putVarint(age);
+    out.putString(gender);
+    out.putString(race);
 
-    ss << "id:" << id << "\n";
-    ss << "name:" << name << "\n";
-    ss << "age:" << age << "\n";
-    ss << "gender:" << gender << "\n";
+    putFields(out, traits, TRAIT_FIELDS);
 
-    // Traits
-    ss << "openness:" << traits.openness << "\n";
-    ss << "conscientiousness:" << traits.conscientiousness << "\n";
-    ss << "extraversion:" << traits.extraversion << "\n";
-    ss << "agreeableness:" << traits.agreeableness << "\n";
-    ss << "neuroticism:" << traits.neuroticism << "\n";
+    out.putVarint(emotionalState.emotions.size());
+    for (const auto& [emotion, intensity] : emotionalState.emotions) {
+        out.putVarint(static_cast<uint64_t>(emotion));
+        out.putDouble(intensity);
+    }
+    out.putDouble(emotionalState.overallValence);
+    out.putDouble(emotionalState.arousal);
+    out.putDouble(emotionalState.dominance);
+    out.putDouble(emotionalState.moodValence);
+    out.putDouble(emotionalState.moodStability);
+    out.putDouble(emotionalState.stressLevel);
+    out.putDouble(emotionalState.satisfaction);
+
+    out.putVarint(static_cast<uint64_t>(communication.primaryStyle));
+    out.putDouble(communication.formality);
+    out.putDouble(communication.verbosity);
+    out.putDouble(communication.emotionalExpression);
+    out.putDouble(communication.directness);
+    out.putDouble(communication.politeness);
+    out.putDouble(communication.humor);
+    out.putStrings(communication.favoredExpressions);
+    out.putStrings(communication.greetings);
+    out.putStrings(communication.farewells);
+    out.putStrings(communication.exclamations);
+    out.putString(communication.speechQuirk);
+
+    putFields(out, behavior, BEHAVIOR_FIELDS);
+
+    out.putString(role.title);
+    out.putString(role.faction);
+    out.putSigned(role.socialRank);
+    out.putStrings(role.duties);
+    out.putStrings(role.skills);
+    out.putStrings(role.knownLocations);
+    out.putVarint(role.dailySchedule.size());
+    for (const auto& entry : role.dailySchedule) {
+        out.putVarint(entry.startTime);
+        out.putVarint(entry.endTime);
+        out.putString(entry.activity);
+        out.putString(entry.location);
+    }
+
+    out.putVarint(relationships.size());
+    for (const auto& [targetId, rel] : relationships) {
+        out.putString(targetId);
+        out.putVarint(static_cast<uint64_t>(rel.type));
+        out.putDouble(rel.familiarity);
+        out.putDouble(rel.trust);
+        out.putDouble(rel.affection);
+        out.putDouble(rel.respect);
+        out.putDouble(rel.fear);
+        out.putVarint(rel.interactionCount);
+        out.putVarint(rel.lastInteraction);
+        out.putStrings(rel.significantEventIds);
+        out.putDouble(rel.owesThem);
+        out.putDouble(rel.theyOwe);
+    }
+
+    out.putVarint(goals.size());
+    for (const auto& goal : goals) {
+        out.putString(goal.id);
+        out.putString(goal.description);
+        out.putVarint(static_cast<uint64_t>(goal.motivation));
+        out.putDouble(goal.priority);
+        out.putDouble(goal.progress);
+        out.putBool(goal.isActive);
+        out.putBool(goal.isSecret);
+        out.putStrings(goal.prerequisites);
+        out.putStrings(goal.blockers);
+        out.putBool(goal.hasDeadline);
+        out.putVarint(goal.deadlineGameTime);
+    }
+    out.putVarint(motivationStrengths.size());
+    for (const auto& [motivation, strength] : motivationStrengths) {
+        out.putVarint(static_cast<uint64_t>(motivation));
+        out.putDouble(strength);
+    }
+
+    out.putVarint(memories.size());
+    for (const auto& memory : memories) {
+        out.putString(memory.id);
+        out.putVarint(static_cast<uint64_t>(memory.type));
+        out.putString(memory.description);
+        out.putString(memory.relatedEntityId);
+        out.putDouble(memory.emotionalImpact);
+        out.putDouble(memory.importance);
+        out.putVarint(memory.gameTime);
+        out.putVarint(memory.lastRecalled);
+        out.putBool(memory.isRepressed);
+        out.putDouble(memory.clarity);
+        out.putDouble(memory.accuracy);
+    }
+    out.putVarint(knownFacts.size());
+    for (const auto& [key, value] : knownFacts) {
+        out.putString(key);
+        out.putString(value);
+    }
 
-    return ss.str();
+    out.putBool(isAlive);
+    out.putBool(isConscious);
+    out.putString(currentActivity);
+    out.putString(currentLocation);
 }
 
-bool NPCPersona::deserialize(const std::string& data) {
-    std::istringstream ss(data);
-    std::string line;
+bool NPCPersona::read(ArchiveReader& in) {
+    id = in.getString();
+    name = in.getString();
+    title = in.getString();
+    description = in.getString();
+    age = static_cast<uint32_t>(in.getVarint());
+    gender = in.getString();
+    race = in.getString();
 
-    while (std::getline(ss, line)) {
-        size_t colonPos = line.find(':');
-        if (colonPos == std::string::npos) continue;
+    getFields(in, traits, TRAIT_FIELDS);
 
-        std::string key = line.substr(0, colonPos);
-        std::string value = line.substr(colonPos + 1);
+    emotionalState.emotions.clear();
+    for (size_t i = in.getCount(9); i > 0; --i) {
+        const EmotionType emotion = getEnum<EmotionType>(in);
+        emotionalState.emotions[emotion] = in.getDouble();
+    }
+    emotionalState.overallValence = in.getDouble();
+    emotionalState.arousal = in.getDouble();
+    emotionalState.dominance = in.getDouble();
+    emotionalState.moodValence = in.getDouble();
+    emotionalState.moodStability = in.getDouble();
+    emotionalState.stressLevel = in.getDouble();
+    emotionalState.satisfaction = in.getDouble();
+
+    communication.primaryStyle = getEnum<CommunicationStyle>(in);
+    communication.formality = in.getDouble();
+    communication.verbosity = in.getDouble();
+    communication.emotionalExpression = in.getDouble();
+    communication.directness = in.getDouble();
+    communication.politeness = in.getDouble();
+    communication.humor = in.getDouble();
+    communication.favoredExpressions = in.getStrings();
+    communication.greetings = in.getStrings();
+    communication.farewells = in.getStrings();
+    communication.exclamations = in.getStrings();
+    communication.speechQuirk = in.getString();
+
+    getFields(in, behavior, BEHAVIOR_FIELDS);
+
+    role.title = in.getString();
+    role.faction = in.getString();
+    role.socialRank = static_cast<int>(in.getSigned());
+    role.duties = in.getStrings();
+    role.skills = in.getStrings();
+    role.knownLocations = in.getStrings();
+    role.dailySchedule.resize(in.getCount(4));
+    for (auto& entry : role.dailySchedule) {
+        entry.startTime = static_cast<uint32_t>(in.getVarint());
+        entry.endTime = static_cast<uint32_t>(in.getVarint());
+        entry.activity = in.getString();
+        entry.location = in.getString();
+    }
 
-        if (key == "id") id = value;
-        else if (key == "name") name = value;
-        else if (key == "age") age = std::stoul(value);
-        else if (key == "gender") gender = value;
-        else if (key == "openness") traits.openness = std::stod(value);
-        else if (key == "conscientiousness") traits.conscientiousness = std::stod(value);
-        else if (key == "extraversion") traits.extraversion = std::stod(value);
-        else if (key == "agreeableness") traits.agreeableness = std::stod(value);
-        else if (key == "neuroticism") traits.neuroticism = std::stod(value);
+    relationships.clear();
+    for (size_t i = in.getCount(60); i > 0 && in.ok(); --i) {
+        const std::string targetId = in.getString();
+        Relationship& rel = relationships[targetId];
+        rel.targetId = targetId;
+        rel.type = getEnum<Relationship::Type>(in);
+        rel.familiarity = in.getDouble();
+        rel.trust = in.getDouble();
+        rel.affection = in.getDouble();
+        rel.respect = in.getDouble();
+        rel.fear = in.getDouble();
+        rel.interactionCount = static_cast<uint32_t>(in.getVarint());
+        rel.lastInteraction = static_cast<uint32_t>(in.getVarint());
+        rel.significantEventIds = in.getStrings();
+        rel.owesThem = in.getDouble();
+        rel.theyOwe = in.getDouble();
     }
 
-    return true;
+    goals.resize(in.getCount(24));
+    for (auto& goal : goals) {
+        goal.id = in.getString();
+        goal.description = in.getString();
+        goal.motivation = getEnum<MotivationType>(in);
+        goal.priority = in.getDouble();
+        goal.progress = in.getDouble();
+        goal.isActive = in.getBool();
+        goal.isSecret = in.getBool();
+        goal.prerequisites = in.getStrings();
+        goal.blockers = in.getStrings();
+        goal.hasDeadline = in.getBool();
+        goal.deadlineGameTime = static_cast<uint32_t>(in.getVarint());
+    }
+    motivationStrengths.clear();
+    for (size_t i = in.getCount(9); i > 0; --i) {
+        const MotivationType motivation = getEnum<MotivationType>(in);
+        motivationStrengths[motivation] = in.getDouble();
+    }
+
+    memories.resize(in.getCount(40));
+    for (auto& memory : memories) {
+        memory.id = in.getString();
+        memory.type = getEnum<Memory::Type>(in);
+        memory.description = in.getString();
+        memory.relatedEntityId = in.getString();
+        memory.emotionalImpact = in.getDouble();
+        memory.importance = in.getDouble();
+        memory.gameTime = static_cast<uint32_t>(in.getVarint());
+        memory.lastRecalled = static_cast<uint32_t>(in.getVarint());
+        memory.isRepressed = in.getBool();
+        memory.clarity = in.getDouble();
+        memory.accuracy = in.getDouble();
+    }
+    knownFacts.clear();
+    for (size_t i = in.getCount(2); i > 0 && in.ok(); --i) {
+        const std::string key = in.getString();
+        knownFacts[key] = in.getString();
+    }
+
+    isAlive = in.getBool();
+    isConscious = in.getBool();
+    currentActivity = in.getString();
+    currentLocation = in.getString();
+    return in.ok();
+}
+
+std::string NPCPersona::serialize() const {
+    ArchiveWriter out;
+    write(out);
+    return out.finish();
+}
+
+bool NPCPersona::deserialize(const std::string& data) {
+    std::string payload;
+    if (!ArchiveReader::open(data, payload)) {
+        return false;
+    }
+    ArchiveReader in(payload);
+    return read(in) && in.atEnd();
 }
 
 std::unique_ptr<NPCPersona> NPCPersona::clone() const {
@@ -4,9 +4,14 @@
  */
 
 #include "social/RelationshipSystem.h"
+#include "Job_system.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <random>
 #include <cmath>
+#include <numeric>
+#include <unordered_map>
 
 namespace Ultima {
 namespace NPC {
@@ -98,9 +103,9 @@ void Relationship::updateType() {
 }
 
 void Relationship::decay(double deltaTime) {
-    double rate = 0.001 * deltaTime;
-    metricsAtoB.familiarity *= (1.0 - rate * 0.5);
-    metricsBtoA.familiarity *= (1.0 - rate * 0.5);
+    const double remaining = std::exp(-0.0005 * deltaTime);
+    metricsAtoB.familiarity *= remaining;
+    metricsBtoA.familiarity *= remaining;
 }
 
 double Relationship::getStrength() const {
@@ -117,7 +122,33 @@ bool Relationship::isHostile() const {
 }
 
 // SocialNetwork Implementation
-SocialNetwork::SocialNetwork() = default;
+
+namespace {
+
+const double PAGERANK_DAMPING = 0.85;
+const int PAGERANK_MAX_ITERATIONS = 100;
+const double PAGERANK_TOLERANCE = 1e-9;     // Total change in rank to stop at
+const size_t NODES_PER_WORKER = 4096;       // Fewer aren't worth a thread
+const size_t SOURCES_PER_WORKER = 8;
+const int LOUVAIN_MAX_PASSES = 32;
+const uint32_t NO_NUMBER = UINT32_MAX;
+
+} // namespace
+
+struct SocialNetwork::Graph {
+    std::vector<std::string> ids;                       // By entity number
+    std::unordered_map<std::string, uint32_t> numbers;  // In nodes_ order
+    std::vector<uint32_t> offsets;      // Where each entity's neighbors start
+    std::vector<uint32_t> neighbors;
+    std::vector<double> strengths;
+    std::vector<uint32_t> edges;                 // Edge behind each neighbor
+    std::vector<std::array<uint32_t, 2>> slots;  // Each edge's places in neighbors
+    bool stale = true;
+
+    size_t size() const { return ids.size(); }
+};
+
+SocialNetwork::SocialNetwork() : graph_(std::make_unique<Graph>()) {}
 SocialNetwork::~SocialNetwork() = default;
 
 void SocialNetwork::addEntity(const std::string& entityId, const std::string& name,
@@ -126,7 +157,9 @@ void SocialNetwork::addEntity(const std::string& entityId, const std::string& na
     node.entityId = entityId;
     node.name = name;
     node.faction = faction;
-    nodes_[entityId] = node;
+    if (nodes_.insert_or_assign(entityId, node).second) {
+        graph_->stale = true;
+    }
 }
 
 void SocialNetwork::removeEntity(const std::string& entityId) {
@@ -138,21 +171,439 @@ void SocialNetwork::removeEntity(const std::string& entityId) {
                       }),
         edges_.end()
     );
+    edgeIndex_.clear();
+    for (size_t i = 0; i < edges_.size(); ++i) {
+        edgeIndex_[unorderedPairKey(intern(edges_[i].from), intern(edges_[i].to))] = i;
+    }
+    graph_->stale = true;
+}
+
+const SocialNode* SocialNetwork::getNode(const std::string& entityId) const {
+    auto it = nodes_.find(entityId);
+    return it != nodes_.end() ? &it->second : nullptr;
+}
+
+void SocialNetwork::updateRelationship(const Relationship& rel) {
+    const uint64_t key = unorderedPairKey(intern(rel.entityA), intern(rel.entityB));
+    const double strength = rel.getStrength();
+    auto it = edgeIndex_.find(key);
+    if (it == edgeIndex_.end()) {
+        edgeIndex_[key] = edges_.size();
+        edges_.push_back({rel.entityA, rel.entityB, strength, rel.type, rel.isMutual});
+        graph_->stale = true;
+        return;
+    }
+
+    SocialEdge& edge = edges_[it->second];
+    edge.strength = strength;
+    edge.type = rel.type;
+    edge.isBidirectional = rel.isMutual;
+    if (!graph_->stale) {
+        for (uint32_t slot : graph_->slots[it->second]) {
+            if (slot != NO_NUMBER) {
+                graph_->strengths[slot] = strength;
+            }
+        }
+    }
+}
+
+const SocialNetwork::Graph& SocialNetwork::updateAdjacency() const {
+    Graph& graph = *graph_;
+    if (!graph.stale) {
+        return graph;
+    }
+    const size_t count = nodes_.size();
+    graph.ids.clear();
+    graph.ids.reserve(count);
+    graph.numbers.clear();
+    graph.numbers.reserve(count);
+    for (const auto& entry : nodes_) {
+        graph.numbers.emplace(entry.first, static_cast<uint32_t>(graph.ids.size()));
+        graph.ids.push_back(entry.first);
+    }
+
+    // Number each edge's ends, leaving out those to unknown entities, count
+    // every entity's neighbors, then place them
+    auto number = [&](const std::string& id) {
+        auto it = graph.numbers.find(id);
+        return it != graph.numbers.end() ? it->second : NO_NUMBER;
+    };
+    std::vector<std::array<uint32_t, 2>> ends(edges_.size());
+    graph.offsets.assign(count + 1, 0);
+    for (size_t i = 0; i < edges_.size(); ++i) {
+        ends[i] = {number(edges_[i].from), number(edges_[i].to)};
+        if (ends[i][0] == NO_NUMBER || ends[i][1] == NO_NUMBER || ends[i][0] == ends[i][1]) {
+            ends[i] = {NO_NUMBER, NO_NUMBER};
+            continue;
+        }
+        ++graph.offsets[ends[i][0] + 1];
+        ++graph.offsets[ends[i][1] + 1];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        graph.offsets[i + 1] += graph.offsets[i];
+    }
+
+    std::vector<uint32_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+    graph.neighbors.resize(graph.offsets[count]);
+    graph.strengths.resize(graph.offsets[count]);
+    graph.edges.resize(graph.offsets[count]);
+    graph.slots.assign(edges_.size(), {NO_NUMBER, NO_NUMBER});
+    for (size_t i = 0; i < edges_.size(); ++i) {
+        if (ends[i][0] == NO_NUMBER) continue;
+        for (int end = 0; end < 2; ++end) {
+            const uint32_t slot = next[ends[i][end]]++;
+            graph.neighbors[slot] = ends[i][1 - end];
+            graph.strengths[slot] = edges_[i].strength;
+            graph.edges[slot] = static_cast<uint32_t>(i);
+            graph.slots[i][end] = slot;
+        }
+    }
+    graph.stale = false;
+    return graph;
+}
+
+void SocialNetwork::computeCentrality() {
+    const Graph& graph = updateAdjacency();
+    const size_t count = graph.size();
+    for (auto& [id, node] : nodes_) {
+        node.degreeCentrality = 0.0;
+        node.closenessCentrality = 0.0;
+        node.betweennessCentrality = 0.0;
+    }
+    if (count < 2) return;
+    const double n = static_cast<double>(count);
+    Job_system& jobs = Job_system::get();
+
+    // Influence: PageRank, each entity passing its rank on in proportion to
+    // the strength of its relationships, those with none to everyone
+    std::vector<double> totalStrength(count, 0.0);
+    for (size_t v = 0; v < count; ++v) {
+        for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            totalStrength[v] += graph.strengths[e];
+        }
+    }
+    std::vector<double> rank(count, 1.0 / n);
+    std::vector<double> nextRank(count);
+    std::vector<double> share(count);
+    const size_t rankWorkers = jobs.threads_for(count, NODES_PER_WORKER);
+    std::vector<double> change(rankWorkers);
+    for (int iteration = 0; iteration < PAGERANK_MAX_ITERATIONS; ++iteration) {
+        double unshared = 0.0;
+        for (size_t v = 0; v < count; ++v) {
+            share[v] = totalStrength[v] > 0.0 ? rank[v] / totalStrength[v] : 0.0;
+            if (totalStrength[v] <= 0.0) {
+                unshared += rank[v];
+            }
+        }
+        const double base = (1.0 - PAGERANK_DAMPING + PAGERANK_DAMPING * unshared) / n;
+        jobs.run("social.pagerank", rankWorkers, [&](size_t worker) {
+            double moved = 0.0;
+            const size_t end = count * (worker + 1) / rankWorkers;
+            for (size_t v = count * worker / rankWorkers; v < end; ++v) {
+                double received = 0.0;
+                for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                    received += share[graph.neighbors[e]] * graph.strengths[e];
+                }
+                nextRank[v] = base + PAGERANK_DAMPING * received;
+                moved += std::abs(nextRank[v] - rank[v]);
+            }
+            change[worker] = moved;
+        });
+        rank.swap(nextRank);
+        if (std::accumulate(change.begin(), change.end(), 0.0) < PAGERANK_TOLERANCE) {
+            break;
+        }
+    }
+    const double highestRank = *std::max_element(rank.begin(), rank.end());
+
+    // Brandes: a breadth-first search from each source gives everyone's
+    // distance from it, and the shortest paths found, walked back, their
+    // betweenness. Past the sample size, sources are a fixed random sample
+    // and the totals are scaled up to match.
+    std::vector<uint32_t> sources(count);
+    std::iota(sources.begin(), sources.end(), 0);
+    if (centralitySamples_ > 0 && centralitySamples_ < count) {
+        std::mt19937 rng(static_cast<uint32_t>(count));
+        for (size_t i = 0; i < centralitySamples_; ++i) {
+            std::uniform_int_distribution<size_t> pick(i, count - 1);
+            std::swap(sources[i], sources[pick(rng)]);
+        }
+        sources.resize(centralitySamples_);
+    }
+
+    struct Tally {
+        std::vector<double> betweenness;
+        std::vector<double> distance;       // Summed over the sources reaching
+        std::vector<uint32_t> reachedBy;
+    };
+    const size_t pathWorkers = jobs.threads_for(sources.size(), SOURCES_PER_WORKER);
+    std::vector<Tally> tallies(pathWorkers);
+    std::atomic<size_t> nextSource{0};
+    jobs.run("social.centrality", pathWorkers, [&](size_t worker) {
+        Tally& tally = tallies[worker];
+        tally.betweenness.assign(count, 0.0);
+        tally.distance.assign(count, 0.0);
+        tally.reachedBy.assign(count, 0);
+        std::vector<int> distance(count, -1);
+        std::vector<double> paths(count, 0.0);
+        std::vector<double> dependency(count, 0.0);
+        std::vector<uint32_t> order;        // Also the search's queue
+        order.reserve(count);
+
+        for (size_t i; (i = nextSource++) < sources.size();) {
+            const uint32_t source = sources[i];
+            order.assign(1, source);
+            distance[source] = 0;
+            paths[source] = 1.0;
+            for (size_t head = 0; head < order.size(); ++head) {
+                const uint32_t current = order[head];
+                const int next = distance[current] + 1;
+                for (uint32_t e = graph.offsets[current]; e < graph.offsets[current + 1]; ++e) {
+                    const uint32_t neighbor = graph.neighbors[e];
+                    if (distance[neighbor] < 0) {
+                        distance[neighbor] = next;
+                        order.push_back(neighbor);
+                    }
+                    if (distance[neighbor] == next) {
+                        paths[neighbor] += paths[current];
+                    }
+                }
+            }
+
+            // A node's predecessors are its neighbors one step nearer
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                const uint32_t current = *it;
+                const double part = (1.0 + dependency[current]) / paths[current];
+                const int previous = distance[current] - 1;
+                for (uint32_t e = graph.offsets[current]; e < graph.offsets[current + 1]; ++e) {
+                    const uint32_t neighbor = graph.neighbors[e];
+                    if (distance[neighbor] == previous) {
+                        dependency[neighbor] += paths[neighbor] * part;
+                    }
+                }
+                if (current != source) {
+                    tally.betweenness[current] += dependency[current];
+                    tally.distance[current] += distance[current];
+                    ++tally.reachedBy[current];
+                }
+            }
+            for (uint32_t v : order) {
+                distance[v] = -1;
+                paths[v] = 0.0;
+                dependency[v] = 0.0;
+            }
+        }
+    });
+
+    std::vector<bool> isSource(count, false);
+    for (uint32_t source : sources) {
+        isSource[source] = true;
+    }
+    // Each path was found from both ends
+    const double pairs = (n - 1.0) * (n - 2.0);
+    const double scale = n / static_cast<double>(sources.size());
+    size_t v = 0;
+    for (auto& [id, node] : nodes_) {
+        double betweenness = 0.0;
+        double distance = 0.0;
+        double reachedBy = 0.0;
+        for (const Tally& tally : tallies) {
+            betweenness += tally.betweenness[v];
+            distance += tally.distance[v];
+            reachedBy += tally.reachedBy[v];
+        }
+        // Distances are the same both ways, so those from the sources stand
+        // in for those to everyone; scaled by the share reached, for
+        // networks in pieces
+        const double others = static_cast<double>(sources.size() - (isSource[v] ? 1 : 0));
+        if (distance > 0.0) {
+            node.closenessCentrality = (reachedBy / others) * (reachedBy / distance);
+        }
+        node.degreeCentrality = (graph.offsets[v + 1] - graph.offsets[v]) / (n - 1.0);
+        if (pairs > 0.0) {
+            node.betweennessCentrality = betweenness * scale / pairs;
+        }
+        node.influence = highestRank > 0.0 ? rank[v] / highestRank : 0.0;
+        ++v;
+    }
 }
 
 std::vector<std::string> SocialNetwork::getConnections(const std::string& entityId,
                                                        double minStrength) const {
     std::vector<std::string> result;
-    for (const auto& edge : edges_) {
+    auto connects = [&](const SocialEdge& edge) {
         if (edge.from == entityId && edge.strength >= minStrength) {
             result.push_back(edge.to);
         } else if (edge.to == entityId && edge.isBidirectional && edge.strength >= minStrength) {
             result.push_back(edge.from);
         }
+    };
+
+    // Registered entities have their edges at hand; others need a search
+    const Graph& graph = updateAdjacency();
+    auto it = graph.numbers.find(entityId);
+    if (it == graph.numbers.end()) {
+        std::for_each(edges_.begin(), edges_.end(), connects);
+        return result;
+    }
+    for (uint32_t e = graph.offsets[it->second]; e < graph.offsets[it->second + 1]; ++e) {
+        connects(edges_[graph.edges[e]]);
+    }
+    return result;
+}
+
+std::vector<std::string> SocialNetwork::getMostInfluential(int count) const {
+    std::vector<const SocialNode*> ranked;
+    ranked.reserve(nodes_.size());
+    for (const auto& entry : nodes_) {
+        ranked.push_back(&entry.second);
+    }
+    const size_t top = std::min(ranked.size(), static_cast<size_t>(std::max(count, 0)));
+    std::partial_sort(ranked.begin(), ranked.begin() + top, ranked.end(),
+                      [](const SocialNode* a, const SocialNode* b) {
+                          if (a->influence != b->influence) {
+                              return a->influence > b->influence;
+                          }
+                          return a->entityId < b->entityId;
+                      });
+
+    std::vector<std::string> result;
+    result.reserve(top);
+    for (size_t i = 0; i < top; ++i) {
+        result.push_back(ranked[i]->entityId);
     }
     return result;
 }
 
+std::vector<std::set<std::string>> SocialNetwork::detectCommunities() const {
+    const Graph& graph = updateAdjacency();
+    const size_t count = graph.size();
+
+    // Louvain: move nodes one at a time into the neighboring community that
+    // most raises modularity until none moves, then merge each community
+    // into one node and go again on that smaller network. The network
+    // starts as the entities, with relationship strengths as weights.
+    std::vector<std::vector<std::pair<uint32_t, double>>> links(count);
+    std::vector<double> inside(count, 0.0);         // Weight within a node
+    for (size_t v = 0; v < count; ++v) {
+        for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            links[v].push_back({graph.neighbors[e], graph.strengths[e]});
+        }
+    }
+    std::vector<uint32_t> membership(count);        // Entity -> node
+    std::iota(membership.begin(), membership.end(), 0);
+
+    while (true) {
+        const size_t size = links.size();
+        std::vector<double> degree(size);
+        double total = 0.0;
+        for (size_t i = 0; i < size; ++i) {
+            degree[i] = 2.0 * inside[i];
+            for (const auto& link : links[i]) {
+                degree[i] += link.second;
+            }
+            total += degree[i];
+        }
+        if (total <= 0.0) break;
+
+        std::vector<uint32_t> community(size);
+        std::iota(community.begin(), community.end(), 0);
+        std::vector<double> communityDegree = degree;
+        std::vector<double> toCommunity(size, -1.0);    // -1: not a neighbor
+        std::vector<uint32_t> neighboring;
+        bool moved = false;
+        for (int pass = 0; pass < LOUVAIN_MAX_PASSES; ++pass) {
+            bool changed = false;
+            for (uint32_t i = 0; i < size; ++i) {
+                const uint32_t current = community[i];
+                neighboring.assign(1, current);
+                toCommunity[current] = 0.0;
+                for (const auto& [j, weight] : links[i]) {
+                    const uint32_t c = community[j];
+                    if (toCommunity[c] < 0.0) {
+                        toCommunity[c] = 0.0;
+                        neighboring.push_back(c);
+                    }
+                    toCommunity[c] += weight;
+                }
+
+                communityDegree[current] -= degree[i];
+                uint32_t best = current;
+                double bestGain = toCommunity[current] -
+                                  communityDegree[current] * degree[i] / total;
+                for (uint32_t c : neighboring) {
+                    const double gain = toCommunity[c] - communityDegree[c] * degree[i] / total;
+                    if (gain > bestGain + 1e-12) {
+                        best = c;
+                        bestGain = gain;
+                    }
+                }
+                communityDegree[best] += degree[i];
+                community[i] = best;
+                changed = changed || best != current;
+                for (uint32_t c : neighboring) {
+                    toCommunity[c] = -1.0;
+                }
+            }
+            if (!changed) break;
+            moved = true;
+        }
+        if (!moved) break;
+
+        // Merge: number the communities, then sum the weights between them
+        std::vector<uint32_t> renumber(size, NO_NUMBER);
+        std::vector<std::vector<uint32_t>> members;
+        for (uint32_t i = 0; i < size; ++i) {
+            if (renumber[community[i]] == NO_NUMBER) {
+                renumber[community[i]] = static_cast<uint32_t>(members.size());
+                members.emplace_back();
+            }
+            members[renumber[community[i]]].push_back(i);
+        }
+        const size_t merged = members.size();
+        std::vector<std::vector<std::pair<uint32_t, double>>> mergedLinks(merged);
+        std::vector<double> mergedInside(merged, 0.0);
+        std::vector<double> weightTo(merged, -1.0);
+        for (uint32_t c = 0; c < merged; ++c) {
+            neighboring.clear();
+            for (uint32_t i : members[c]) {
+                mergedInside[c] += inside[i];
+                for (const auto& [j, weight] : links[i]) {
+                    const uint32_t d = renumber[community[j]];
+                    if (d == c) {
+                        mergedInside[c] += weight / 2.0;    // Seen from both ends
+                        continue;
+                    }
+                    if (weightTo[d] < 0.0) {
+                        weightTo[d] = 0.0;
+                        neighboring.push_back(d);
+                    }
+                    weightTo[d] += weight;
+                }
+            }
+            for (uint32_t d : neighboring) {
+                mergedLinks[c].push_back({d, weightTo[d]});
+                weightTo[d] = -1.0;
+            }
+        }
+        for (auto& node : membership) {
+            node = renumber[community[node]];
+        }
+        links.swap(mergedLinks);
+        inside.swap(mergedInside);
+    }
+
+    std::vector<std::set<std::string>> communities(links.size());
+    for (size_t v = 0; v < count; ++v) {
+        communities[membership[v]].insert(graph.ids[v]);
+    }
+    std::stable_sort(communities.begin(), communities.end(),
+                     [](const std::set<std::string>& a, const std::set<std::string>& b) {
+                         return a.size() > b.size();
+                     });
+    return communities;
+}
+
 // Faction Implementation
 Faction::Faction() = default;
 Faction::Faction(const std::string& i, const std::string& n) : id(i), name(n) {}
@@ -244,11 +695,20 @@ void RelationshipSystem::registerEntity(const std::string& entityId,
 
 Relationship& RelationshipSystem::getRelationship(const std::string& entityA,
                                                   const std::string& entityB) {
-    auto key = std::make_pair(std::min(entityA, entityB), std::max(entityA, entityB));
-    if (!relationships_.count(key)) {
-        relationships_[key] = Relationship(entityA, entityB);
+    const uint64_t key = unorderedPairKey(intern(entityA), intern(entityB));
+    auto it = relationships_.find(key);
+    if (it == relationships_.end()) {
+        it = relationships_.emplace(key, Relationship(entityA, entityB)).first;
+        it->second.decayedUntil = time_;
+    }
+
+    // Decay catches up when a relationship is used, rather than every update
+    Relationship& rel = it->second;
+    if (rel.decayedUntil < time_) {
+        rel.decay(time_ - rel.decayedUntil);
+        rel.decayedUntil = time_;
     }
-    return relationships_[key];
+    return rel;
 }
 
 void RelationshipSystem::processInteraction(const std::string& entityA,
@@ -258,12 +718,12 @@ void RelationshipSystem::processInteraction(const std::string& entityA,
     auto& rel = getRelationship(entityA, entityB);
     rel.processInteraction(type, entityA, intensity);
     rel.updateType();
+    network_.updateRelationship(rel);
 }
 
 void RelationshipSystem::update(double deltaTime) {
-    for (auto& [key, rel] : relationships_) {
-        rel.decay(deltaTime);
-    }
+    time_ += deltaTime;
+    gossip_.update(deltaTime, network_);
 }
 
 Faction* RelationshipSystem::getFaction(const std::string& factionId) {
@@ -287,29 +747,69 @@ std::string GossipSystem::createGossip(const std::string& subject,
                                        const std::string& originator,
                                        double truthfulness) {
     Gossip g;
-    g.id = "gossip_" + std::to_string(gossips_.size());
+    g.id = "gossip_" + std::to_string(nextGossip_++);
     g.subject = subject;
     g.content = content;
     g.originEntity = originator;
     g.truthfulness = truthfulness;
+    g.originTime = static_cast<uint32_t>(time_);
     g.knownBy.insert(originator);
     gossips_[g.id] = g;
+    tellers_.push_back({g.id, originator});
     return g.id;
 }
 
 void GossipSystem::spreadGossip(const std::string& gossipId,
                                 const std::string& from,
                                 const std::string& to) {
+    (void)from;
     auto it = gossips_.find(gossipId);
-    if (it != gossips_.end()) {
-        it->second.knownBy.insert(to);
+    if (it != gossips_.end() && it->second.knownBy.insert(to).second) {
+        tellers_.push_back({gossipId, to});
     }
 }
 
 void GossipSystem::simulateSpread(SocialNetwork& network, double spreadProbability) {
-    (void)network;
-    (void)spreadProbability;
-    // Placeholder for gossip spread simulation
+    update(0.0, network, spreadProbability);
+}
+
+void GossipSystem::update(double deltaTime, const SocialNetwork& network,
+                          double spreadProbability) {
+    time_ += deltaTime;
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::exponential_distribution<double> delay(1.0 / HOP_DELAY);
+
+    // Whoever has just heard something picks who to pass it on to and
+    // when; hops that come due are heard in turn, until none are left
+    while (true) {
+        for (const auto& [gossipId, teller] : tellers_) {
+            for (const auto& listener : network.getConnections(teller)) {
+                if (chance(rng_) < spreadProbability) {
+                    hops_.push({time_ + delay(rng_), hopCount_++, gossipId, teller, listener});
+                }
+            }
+        }
+        tellers_.clear();
+        if (hops_.empty() || hops_.top().time > time_) break;
+
+        while (!hops_.empty() && hops_.top().time <= time_) {
+            const Hop hop = hops_.top();
+            hops_.pop();
+            spreadGossip(hop.gossipId, hop.from, hop.to);
+        }
+    }
+}
+
+void GossipSystem::decay(uint32_t currentTime, uint32_t maxAge) {
+    // Hops still queued for forgotten gossip find nothing to spread
+    for (auto it = gossips_.begin(); it != gossips_.end();) {
+        if (currentTime > it->second.originTime &&
+            currentTime - it->second.originTime > maxAge) {
+            it = gossips_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 std::vector<GossipSystem::Gossip> GossipSystem::getKnownGossip(const std::string& entityId) const {
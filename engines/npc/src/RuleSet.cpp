@@ -5,6 +5,7 @@
 #include "reasoning/RuleSet.h"
 #include <random>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 
 namespace Ultima {
@@ -95,6 +96,43 @@ bool Condition::evaluate(const std::string& npcId, RuleContext& context) const {
     return negated ? !result : result;
 }
 
+namespace {
+
+enum class NodeKind {
+    Watched,        // Reads one state key
+    Volatile,       // Reads something no one reports changes to
+    Constant
+};
+
+// What a condition reads, as Condition::evaluate() does
+NodeKind nodeKindOf(const Condition& condition, std::string& key) {
+    switch (condition.type) {
+        case ConditionType::HasItem:           key = "has_" + condition.target; break;
+        case ConditionType::HasGold:           key = "gold"; break;
+        case ConditionType::HealthBelow:
+        case ConditionType::HealthAbove:       key = "health"; break;
+        case ConditionType::StaminaBelow:      key = "stamina"; break;
+        case ConditionType::AtLocation:        key = "location_" + condition.target; break;
+        case ConditionType::RelationshipAbove:
+        case ConditionType::RelationshipBelow: key = "rel_" + condition.target; break;
+        case ConditionType::EmotionAbove:      key = "emotion_" + condition.target; break;
+        case ConditionType::TraitAbove:
+        case ConditionType::TraitBelow:        key = "trait_" + condition.target; break;
+        case ConditionType::InCombat:          key = "in_combat"; break;
+        case ConditionType::KnowsFact:
+        case ConditionType::TimeOfDay:
+        case ConditionType::CustomCondition:   return NodeKind::Volatile;
+        default:                               return NodeKind::Constant;
+    }
+    return NodeKind::Watched;
+}
+
+bool higherPriority(const BehaviorRule* a, const BehaviorRule* b) {
+    return a->priority > b->priority;
+}
+
+} // namespace
+
 //=============================================================================
 // Action Implementation
 //=============================================================================
@@ -210,11 +248,22 @@ void RuleContext::setState(const std::string& npcId, const std::string& key, dou
     for (const auto& [prefix, setter] : stateSetters_) {
         if (key.find(prefix) == 0) {
             setter(npcId, key, value);
+            notifyStateChanged(npcId, key);
             return;
         }
     }
 }
 
+void RuleContext::notifyStateChanged(const std::string& npcId, const std::string& key) {
+    if (changeListener_) {
+        changeListener_(npcId, key);
+    }
+}
+
+void RuleContext::setChangeListener(ChangeListener listener) {
+    changeListener_ = std::move(listener);
+}
+
 bool RuleContext::checkFact(const std::string& subject,
                            const std::string& predicate,
                            const std::string& object) const {
@@ -225,26 +274,54 @@ bool RuleContext::checkFact(const std::string& subject,
 }
 
 bool RuleContext::isOnCooldown(const std::string& npcId, const std::string& ruleId) const {
-    auto npcIt = cooldowns_.find(npcId);
-    if (npcIt == cooldowns_.end()) return false;
-
-    auto ruleIt = npcIt->second.find(ruleId);
-    if (ruleIt == npcIt->second.end()) return false;
+    if (cooldowns_.empty()) return false;
 
-    return ruleIt->second > 0;
+    // Only ids a cooldown was ever set for have symbols
+    const Symbol npc = findSymbol(npcId);
+    const Symbol rule = findSymbol(ruleId);
+    if (!npc.valid() || !rule.valid()) return false;
+    auto it = cooldowns_.find(pairKey(npc, rule));
+    return it != cooldowns_.end() && it->second > cooldownTick_;
 }
 
 void RuleContext::setCooldown(const std::string& npcId,
                              const std::string& ruleId,
                              int duration) {
-    cooldowns_[npcId][ruleId] = duration;
+    const uint64_t key = pairKey(intern(npcId), intern(ruleId));
+    if (duration <= 0) {
+        cooldowns_.erase(key);
+        return;
+    }
+    if (cooldownWheel_.empty()) {
+        cooldownWheel_.resize(COOLDOWN_WHEEL_SIZE);
+    }
+    const uint64_t end = cooldownTick_ + static_cast<uint64_t>(duration);
+    cooldowns_[key] = end;
+    cooldownWheel_[end % COOLDOWN_WHEEL_SIZE].push_back(key);
 }
 
 void RuleContext::updateCooldowns(int deltaTicks) {
-    for (auto& [npcId, ruleCooldowns] : cooldowns_) {
-        for (auto& [ruleId, remaining] : ruleCooldowns) {
-            remaining = std::max(0, remaining - deltaTicks);
-        }
+    if (deltaTicks <= 0) return;
+    const uint64_t start = cooldownTick_ + 1;
+    cooldownTick_ += static_cast<uint64_t>(deltaTicks);
+    if (cooldowns_.empty()) return;
+
+    // Only the slots of the ticks passed, each at most once
+    const uint64_t first = std::max(start, cooldownTick_ + 1 - std::min<uint64_t>(
+        cooldownTick_ + 1, COOLDOWN_WHEEL_SIZE));
+    for (uint64_t tick = first; tick <= cooldownTick_; ++tick) {
+        auto& slot = cooldownWheel_[tick % COOLDOWN_WHEEL_SIZE];
+        slot.erase(std::remove_if(slot.begin(), slot.end(), [&](uint64_t key) {
+            auto it = cooldowns_.find(key);
+            if (it == cooldowns_.end() || it->second % COOLDOWN_WHEEL_SIZE != tick % COOLDOWN_WHEEL_SIZE) {
+                return true;    // Ended, or set again for another slot
+            }
+            if (it->second <= cooldownTick_) {
+                cooldowns_.erase(it);
+                return true;
+            }
+            return false;       // Ends on a later turn of the wheel
+        }), slot.end());
     }
 }
 
@@ -256,8 +333,10 @@ RuleSet::RuleSet() = default;
 RuleSet::~RuleSet() = default;
 
 void RuleSet::addRule(const BehaviorRule& rule) {
+    removeRule(rule.id);
     rules_[rule.id] = rule;
     categoryIndex_.insert({rule.category, rule.id});
+    ++version_;
 }
 
 void RuleSet::removeRule(const std::string& ruleId) {
@@ -273,6 +352,7 @@ void RuleSet::removeRule(const std::string& ruleId) {
             }
         }
         rules_.erase(it);
+        ++version_;
     }
 }
 
@@ -303,17 +383,17 @@ std::vector<const BehaviorRule*> RuleSet::findApplicableRules(
     }
 
     // Sort by priority
-    std::sort(applicable.begin(), applicable.end(),
-              [](const BehaviorRule* a, const BehaviorRule* b) {
-                  return a->priority > b->priority;
-              });
+    std::sort(applicable.begin(), applicable.end(), higherPriority);
 
     return applicable;
 }
 
 const BehaviorRule* RuleSet::selectBestRule(const std::string& npcId,
                                             RuleContext& context) const {
-    auto applicable = findApplicableRules(npcId, context);
+    return selectAmong(findApplicableRules(npcId, context));
+}
+
+const BehaviorRule* RuleSet::selectAmong(const std::vector<const BehaviorRule*>& applicable) {
     if (applicable.empty()) return nullptr;
 
     // Find highest priority
@@ -383,6 +463,214 @@ std::vector<std::string> RuleSet::getRuleIds() const {
 void RuleSet::clear() {
     rules_.clear();
     categoryIndex_.clear();
+    ++version_;
+}
+
+//=============================================================================
+// RuleNetwork Implementation
+//=============================================================================
+
+struct RuleNetwork::Impl {
+    struct Node {
+        NodeKind kind;
+        Condition condition;
+        bool isBounds = false;          // A personality bound, not a condition
+        double min = 0.0;
+        double max = 0.0;
+        std::string key;                // Watched state
+        std::vector<uint32_t> rules;    // Fed, once per use
+    };
+
+    struct NPCMemory {
+        bool fresh = true;              // Nothing evaluated yet
+        std::vector<int8_t> results;    // By node
+        std::vector<uint32_t> failing;  // Failing nodes, by rule
+        std::vector<uint32_t> dirty;
+        std::vector<bool> isDirty;
+    };
+
+    const RuleSet* ruleSet = nullptr;
+    uint64_t version = 0;
+    std::vector<Node> nodes;
+    std::vector<const BehaviorRule*> rules;
+    std::unordered_map<std::string, uint32_t> keyIds;
+    std::vector<std::vector<uint32_t>> nodesByKey;
+    std::vector<uint32_t> volatileNodes;
+    std::unordered_map<std::string, NPCMemory> npcs;
+
+    uint32_t addNode(const std::string& signature, Node node,
+                     std::unordered_map<std::string, uint32_t>& bySignature) {
+        auto it = bySignature.find(signature);
+        if (it != bySignature.end()) {
+            return it->second;
+        }
+        const uint32_t id = static_cast<uint32_t>(nodes.size());
+        if (node.kind == NodeKind::Watched) {
+            auto key = keyIds.emplace(node.key, static_cast<uint32_t>(nodesByKey.size()));
+            if (key.second) {
+                nodesByKey.emplace_back();
+            }
+            nodesByKey[key.first->second].push_back(id);
+        } else if (node.kind == NodeKind::Volatile) {
+            volatileNodes.push_back(id);
+        }
+        nodes.push_back(std::move(node));
+        bySignature.emplace(signature, id);
+        return id;
+    }
+
+    bool evaluate(const Node& node, const std::string& npcId, RuleContext& context) const {
+        if (node.isBounds) {
+            const double value = context.getState(npcId, node.key);
+            return value >= node.min && value <= node.max;
+        }
+        return node.condition.evaluate(npcId, context);
+    }
+
+    void update(NPCMemory& memory, uint32_t n, bool value) {
+        int8_t& result = memory.results[n];
+        if (result == static_cast<int8_t>(value)) return;
+        result = static_cast<int8_t>(value);
+        for (uint32_t rule : nodes[n].rules) {
+            value ? --memory.failing[rule] : ++memory.failing[rule];
+        }
+    }
+
+    void markDirty(NPCMemory& memory, uint32_t keyId) {
+        if (memory.fresh) return;
+        for (uint32_t n : nodesByKey[keyId]) {
+            if (!memory.isDirty[n]) {
+                memory.isDirty[n] = true;
+                memory.dirty.push_back(n);
+            }
+        }
+    }
+
+    void markFresh(NPCMemory& memory) {
+        memory.fresh = true;
+        memory.dirty.clear();
+    }
+};
+
+RuleNetwork::RuleNetwork() : impl_(std::make_unique<Impl>()) {}
+RuleNetwork::~RuleNetwork() = default;
+
+void RuleNetwork::compile(const RuleSet& ruleSet) {
+    Impl& impl = *impl_;
+    impl = Impl();
+    impl.ruleSet = &ruleSet;
+    impl.version = ruleSet.getVersion();
+
+    std::unordered_map<std::string, uint32_t> bySignature;
+    for (const auto& ruleId : ruleSet.getRuleIds()) {
+        const BehaviorRule* rule = ruleSet.getRule(ruleId);
+        const uint32_t index = static_cast<uint32_t>(impl.rules.size());
+        impl.rules.push_back(rule);
+
+        for (size_t c = 0; c < rule->conditions.size(); ++c) {
+            const Condition& condition = rule->conditions[c];
+            Impl::Node node{};
+            node.condition = condition;
+            node.kind = nodeKindOf(condition, node.key);
+            // Custom evaluators can't be compared, so aren't shared
+            std::string signature;
+            if (condition.type == ConditionType::CustomCondition) {
+                signature = "custom\n" + ruleId + "\n" + std::to_string(c);
+            } else {
+                char threshold[sizeof(double)];
+                std::memcpy(threshold, &condition.threshold, sizeof(threshold));
+                signature = std::to_string(static_cast<int>(condition.type)) +
+                            (condition.negated ? "!" : "=") + condition.target + '\n' +
+                            std::string(threshold, sizeof(threshold));
+            }
+            const uint32_t n = impl.addNode(signature, std::move(node), bySignature);
+            impl.nodes[n].rules.push_back(index);
+        }
+        for (const auto& [trait, bounds] : rule->personalityBounds) {
+            Impl::Node node{};
+            node.kind = NodeKind::Watched;
+            node.isBounds = true;
+            node.key = "trait_" + trait;
+            node.min = bounds.first;
+            node.max = bounds.second;
+            const std::string signature = "bounds\n" + trait + '\n' +
+                std::to_string(bounds.first) + '\n' + std::to_string(bounds.second);
+            const uint32_t n = impl.addNode(signature, std::move(node), bySignature);
+            impl.nodes[n].rules.push_back(index);
+        }
+    }
+}
+
+bool RuleNetwork::isCompiled(const RuleSet& ruleSet) const {
+    return impl_->ruleSet == &ruleSet && impl_->version == ruleSet.getVersion();
+}
+
+void RuleNetwork::stateChanged(const std::string& npcId, const std::string& key) {
+    Impl& impl = *impl_;
+    uint32_t keyId = 0;
+    if (!key.empty()) {
+        auto it = impl.keyIds.find(key);
+        if (it == impl.keyIds.end()) return;     // No rule reads it
+        keyId = it->second;
+    }
+    auto mark = [&](Impl::NPCMemory& memory) {
+        key.empty() ? impl.markFresh(memory) : impl.markDirty(memory, keyId);
+    };
+    if (npcId.empty()) {
+        for (auto& [id, memory] : impl.npcs) {
+            mark(memory);
+        }
+    } else {
+        auto it = impl.npcs.find(npcId);
+        if (it != impl.npcs.end()) {
+            mark(it->second);
+        }
+    }
+}
+
+std::vector<const BehaviorRule*> RuleNetwork::findApplicableRules(
+    const std::string& npcId,
+    RuleContext& context)
+{
+    Impl& impl = *impl_;
+    Impl::NPCMemory& memory = impl.npcs[npcId];
+    if (memory.fresh) {
+        memory.results.assign(impl.nodes.size(), 0);
+        memory.failing.assign(impl.rules.size(), 0);
+        memory.isDirty.assign(impl.nodes.size(), false);
+        for (uint32_t n = 0; n < impl.nodes.size(); ++n) {
+            if (impl.evaluate(impl.nodes[n], npcId, context)) {
+                memory.results[n] = 1;
+            } else {
+                for (uint32_t rule : impl.nodes[n].rules) {
+                    ++memory.failing[rule];
+                }
+            }
+        }
+        memory.fresh = false;
+    } else {
+        for (uint32_t n : memory.dirty) {
+            memory.isDirty[n] = false;
+            impl.update(memory, n, impl.evaluate(impl.nodes[n], npcId, context));
+        }
+        memory.dirty.clear();
+        for (uint32_t n : impl.volatileNodes) {
+            impl.update(memory, n, impl.evaluate(impl.nodes[n], npcId, context));
+        }
+    }
+
+    std::vector<const BehaviorRule*> applicable;
+    for (size_t r = 0; r < impl.rules.size(); ++r) {
+        if (memory.failing[r] == 0 && !context.isOnCooldown(npcId, impl.rules[r]->id)) {
+            applicable.push_back(impl.rules[r]);
+        }
+    }
+    std::sort(applicable.begin(), applicable.end(), higherPriority);
+    return applicable;
+}
+
+size_t RuleNetwork::getNodeCount() const {
+    return impl_->nodes.size();
 }
 
 //=============================================================================
@@ -718,14 +1006,42 @@ BehaviorRule RuleBuilder::build() {
 //=============================================================================
 
 RuleEngine::RuleEngine() = default;
-RuleEngine::~RuleEngine() = default;
+
+RuleEngine::~RuleEngine() {
+    if (context_ && network_) {
+        context_->setChangeListener(nullptr);
+    }
+}
 
 void RuleEngine::initialize(std::shared_ptr<RuleSet> ruleSet) {
     ruleSet_ = ruleSet;
 }
 
 void RuleEngine::setContext(std::shared_ptr<RuleContext> context) {
+    if (context_ && network_) {
+        context_->setChangeListener(nullptr);
+    }
     context_ = context;
+    listenForChanges();
+}
+
+void RuleEngine::setIncrementalMatching(bool enabled) {
+    if (enabled == static_cast<bool>(network_)) return;
+    if (context_ && network_) {
+        context_->setChangeListener(nullptr);
+    }
+    network_ = enabled ? std::make_unique<RuleNetwork>() : nullptr;
+    listenForChanges();
+}
+
+void RuleEngine::listenForChanges() {
+    if (!context_ || !network_) return;
+    RuleNetwork* network = network_.get();
+    context_->setChangeListener([network](const std::string& npcId, const std::string& key) {
+        network->stateChanged(npcId, key);
+    });
+    // Nothing seen so far can be trusted
+    network->stateChanged("", "");
 }
 
 std::vector<Action> RuleEngine::process(const std::string& npcId) {
@@ -733,7 +1049,15 @@ std::vector<Action> RuleEngine::process(const std::string& npcId) {
 
     if (!ruleSet_ || !context_) return actions;
 
-    const BehaviorRule* rule = ruleSet_->selectBestRule(npcId, *context_);
+    const BehaviorRule* rule = nullptr;
+    if (network_) {
+        if (!network_->isCompiled(*ruleSet_)) {
+            network_->compile(*ruleSet_);
+        }
+        rule = RuleSet::selectAmong(network_->findApplicableRules(npcId, *context_));
+    } else {
+        rule = ruleSet_->selectBestRule(npcId, *context_);
+    }
     if (rule) {
         actions = rule->actions;
         ruleSet_->executeRule(*rule, npcId, *context_);
@@ -0,0 +1,105 @@
+/**
+ * Scheduler.cpp - Multi-Rate Simulation Scheduler
+ */
+
+#include "simulation/Scheduler.h"
+#include "Job_system.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Ultima {
+namespace NPC {
+namespace Simulation {
+
+Scheduler::Scheduler() = default;
+Scheduler::~Scheduler() = default;
+
+bool Scheduler::add(const System& system) {
+    if (!system.update || find(system.name)) {
+        return false;
+    }
+    Entry entry;
+    entry.system = system;
+    entry.system.period = std::max(0.0, system.period);
+    entry.system.maxStep = std::max(0.0, system.maxStep);
+    entry.system.stepBudget = std::max(1, system.stepBudget);
+    systems_.push_back(std::move(entry));
+    return true;
+}
+
+bool Scheduler::remove(const std::string& name) {
+    auto it = std::find_if(systems_.begin(), systems_.end(),
+                           [&name](const Entry& entry) { return entry.system.name == name; });
+    if (it == systems_.end()) {
+        return false;
+    }
+    systems_.erase(it);
+    return true;
+}
+
+void Scheduler::advance(double deltaTime) {
+    if (deltaTime <= 0.0) {
+        return;
+    }
+    time_ += deltaTime;
+
+    // Plan: each due system catches up in as few steps as it can take,
+    // leaving what its budget can't cover for later advances
+    runs_.clear();
+    for (auto& entry : systems_) {
+        const System& system = entry.system;
+        entry.pending += deltaTime;
+        if (entry.pending < system.period) {
+            continue;
+        }
+        Run run{&entry, entry.pending, 1};
+        if (system.maxStep > 0.0) {
+            if (entry.pending > system.maxStep * system.stepBudget) {
+                run.step = system.maxStep;
+                run.steps = system.stepBudget;
+            } else {
+                run.steps = static_cast<int>(std::ceil(entry.pending / system.maxStep));
+                run.step = entry.pending / run.steps;
+            }
+        }
+        entry.pending = std::max(0.0, entry.pending - run.step * run.steps);
+        runs_.push_back(run);
+    }
+
+    // Each system's steps stay in one task, in order, timed under its name
+    Job_system& jobs = Job_system::get();
+    std::vector<Job_system::Task_ptr> tasks;
+    tasks.reserve(runs_.size());
+    for (const Run& run : runs_) {
+        tasks.push_back(jobs.submit(run.entry->system.name.c_str(), [&run] {
+            for (int step = 0; step < run.steps; ++step) {
+                run.entry->system.update(run.step);
+            }
+        }));
+    }
+    for (const auto& task : tasks) {
+        jobs.wait(task);
+    }
+}
+
+double Scheduler::getPending(const std::string& name) const {
+    const Entry* entry = find(name);
+    return entry ? entry->pending : 0.0;
+}
+
+Scheduler::Entry* Scheduler::find(const std::string& name) {
+    for (auto& entry : systems_) {
+        if (entry.system.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const Scheduler::Entry* Scheduler::find(const std::string& name) const {
+    return const_cast<Scheduler*>(this)->find(name);
+}
+
+} // namespace Simulation
+} // namespace NPC
+} // namespace Ultima
@@ -0,0 +1,58 @@
+/**
+ * SymbolTable.cpp - Interned Strings
+ */
+
+#include "core/SymbolTable.h"
+#include <mutex>
+
+namespace Ultima {
+namespace NPC {
+
+SymbolTable& SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol SymbolTable::intern(std::string_view name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = values_.find(name);
+        if (it != values_.end()) {
+            return Symbol(it->second);
+        }
+    }
+
+    // Another thread may have got there between the locks
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = values_.find(name);
+    if (it != values_.end()) {
+        return Symbol(it->second);
+    }
+    names_.emplace_back(name);
+    const uint32_t value = static_cast<uint32_t>(names_.size());
+    values_.emplace(names_.back(), value);
+    return Symbol(value);
+}
+
+Symbol SymbolTable::find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = values_.find(name);
+    return it != values_.end() ? Symbol(it->second) : Symbol();
+}
+
+const std::string& SymbolTable::name(Symbol symbol) const {
+    static const std::string none;
+    if (!symbol.valid()) {
+        return none;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return symbol.value() <= names_.size() ? names_[symbol.value() - 1] : none;
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
+
+} // namespace NPC
+} // namespace Ultima
@@ -0,0 +1,673 @@
+/**
+ * TensorKernels.cpp - Dense Matrix Kernels
+ *
+ * Every product comes down to dot products of four matrix rows with one
+ * input vector, done by the widest kernel the CPU supports for the way
+ * the rows are stored.
+ */
+
+#include "llm/TensorKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KERNELS_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define KERNELS_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Ultima {
+namespace NPC {
+namespace LLM {
+namespace Kernels {
+
+// Matrix bytes in each block of a batched product: 64 KB, which stays
+// in L2 while the whole batch goes through it.
+static const size_t BLOCK_BYTES = 64 * 1024;
+
+// Writes the dot products of x with the four rows, stride bytes apart,
+// starting at a to y.
+using Dot4Fn = void (*)(const uint8_t* a, size_t stride, int cols,
+                        const float* x, float* y);
+// Returns the dot product of x with the row at a.
+using Dot1Fn = float (*)(const uint8_t* a, int cols, const float* x);
+
+// Weight j of a row, before scaling, for each way of storing them
+struct RowF32 {
+    static float at(const uint8_t* row, int j) {
+        return reinterpret_cast<const float*>(row)[j];
+    }
+};
+
+struct RowQ8 {
+    static float at(const uint8_t* row, int j) {
+        return static_cast<float>(static_cast<int8_t>(row[j]));
+    }
+};
+
+struct RowQ4 {
+    static float at(const uint8_t* row, int j) {
+        return static_cast<float>(((row[j >> 1] >> ((j & 1) * 4)) & 0xF) - 8);
+    }
+};
+
+template<class Row>
+static float dot1(const uint8_t* a, int cols, const float* x) {
+    float sum = 0.0f;
+    for (int j = 0; j < cols; ++j) {
+        sum += Row::at(a, j) * x[j];
+    }
+    return sum;
+}
+
+// Adds the products of the columns from j on, which the vector loops
+// leave over.
+template<class Row>
+static inline void dot4Tail(const uint8_t* a, size_t stride, int cols,
+                            const float* x, float* y, int j) {
+    for (; j < cols; ++j) {
+        y[0] += Row::at(a, j) * x[j];
+        y[1] += Row::at(a + stride, j) * x[j];
+        y[2] += Row::at(a + 2 * stride, j) * x[j];
+        y[3] += Row::at(a + 3 * stride, j) * x[j];
+    }
+}
+
+template<class Row>
+static void dot4Scalar(const uint8_t* a, size_t stride, int cols,
+                       const float* x, float* y) {
+    y[0] = y[1] = y[2] = y[3] = 0.0f;
+    dot4Tail<Row>(a, stride, cols, x, y, 0);
+}
+
+#if defined(KERNELS_SSE2)
+// The sum across each of four vectors, as one vector.
+static inline __m128 sumAcross4(__m128 s0, __m128 s1, __m128 s2, __m128 s3) {
+    _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+    return _mm_add_ps(_mm_add_ps(s0, s1), _mm_add_ps(s2, s3));
+}
+
+static void dot4SSE2(const uint8_t* a, size_t stride, int cols,
+                     const float* x, float* y) {
+    const float* a0 = reinterpret_cast<const float*>(a);
+    const float* a1 = reinterpret_cast<const float*>(a + stride);
+    const float* a2 = reinterpret_cast<const float*>(a + 2 * stride);
+    const float* a3 = reinterpret_cast<const float*>(a + 3 * stride);
+    __m128 s0 = _mm_setzero_ps();
+    __m128 s1 = _mm_setzero_ps();
+    __m128 s2 = _mm_setzero_ps();
+    __m128 s3 = _mm_setzero_ps();
+    int j = 0;
+    for (; j + 4 <= cols; j += 4) {
+        const __m128 xv = _mm_loadu_ps(x + j);
+        s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a0 + j), xv));
+        s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a1 + j), xv));
+        s2 = _mm_add_ps(s2, _mm_mul_ps(_mm_loadu_ps(a2 + j), xv));
+        s3 = _mm_add_ps(s3, _mm_mul_ps(_mm_loadu_ps(a3 + j), xv));
+    }
+    _mm_storeu_ps(y, sumAcross4(s0, s1, s2, s3));
+    dot4Tail<RowF32>(a, stride, cols, x, y, j);
+}
+
+// Sixteen columns of a quantized row, as signed bytes
+static inline __m128i loadQ8SSE2(const uint8_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+static inline __m128i loadQ4SSE2(const uint8_t* p) {
+    const __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i lo = _mm_and_si128(b, mask);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), mask);
+    return _mm_sub_epi8(_mm_unpacklo_epi8(lo, hi), _mm_set1_epi8(8));
+}
+
+// The dot product of sixteen signed bytes with x0..x3, as four partial
+// sums. SSE2 has no sign extension, so it is done by unpacking with the
+// sign bits.
+static inline __m128 dot16(__m128i b, __m128 x0, __m128 x1, __m128 x2,
+                           __m128 x3) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(b, _mm_cmpgt_epi8(zero, b));
+    const __m128i hi = _mm_unpackhi_epi8(b, _mm_cmpgt_epi8(zero, b));
+    const __m128i slo = _mm_cmpgt_epi16(zero, lo);
+    const __m128i shi = _mm_cmpgt_epi16(zero, hi);
+    const __m128 w0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, slo));
+    const __m128 w1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, slo));
+    const __m128 w2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, shi));
+    const __m128 w3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, shi));
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, x0), _mm_mul_ps(w1, x1)),
+                      _mm_add_ps(_mm_mul_ps(w2, x2), _mm_mul_ps(w3, x3)));
+}
+
+// Bytes16 is the bytes holding sixteen columns.
+template<__m128i (*Load)(const uint8_t*), int Bytes16, class Row>
+static void dot4QuantSSE2(const uint8_t* a, size_t stride, int cols,
+                          const float* x, float* y) {
+    __m128 s0 = _mm_setzero_ps();
+    __m128 s1 = _mm_setzero_ps();
+    __m128 s2 = _mm_setzero_ps();
+    __m128 s3 = _mm_setzero_ps();
+    int j = 0;
+    for (; j + 16 <= cols; j += 16) {
+        const __m128 x0 = _mm_loadu_ps(x + j);
+        const __m128 x1 = _mm_loadu_ps(x + j + 4);
+        const __m128 x2 = _mm_loadu_ps(x + j + 8);
+        const __m128 x3 = _mm_loadu_ps(x + j + 12);
+        const uint8_t* p = a + j / 16 * Bytes16;
+        s0 = _mm_add_ps(s0, dot16(Load(p), x0, x1, x2, x3));
+        s1 = _mm_add_ps(s1, dot16(Load(p + stride), x0, x1, x2, x3));
+        s2 = _mm_add_ps(s2, dot16(Load(p + 2 * stride), x0, x1, x2, x3));
+        s3 = _mm_add_ps(s3, dot16(Load(p + 3 * stride), x0, x1, x2, x3));
+    }
+    _mm_storeu_ps(y, sumAcross4(s0, s1, s2, s3));
+    dot4Tail<Row>(a, stride, cols, x, y, j);
+}
+#endif
+
+#if defined(KERNELS_AVX2)
+#define KERNELS_AVX2_FUNC __attribute__((target("avx2,fma")))
+
+static inline KERNELS_AVX2_FUNC __m128 fold(__m256 v) {
+    return _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+// Eight columns of a row, as floats
+static inline KERNELS_AVX2_FUNC __m256 loadF32AVX2(const uint8_t* p) {
+    return _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+}
+
+static inline KERNELS_AVX2_FUNC __m256 loadQ8AVX2(const uint8_t* p) {
+    const __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(b));
+}
+
+static inline KERNELS_AVX2_FUNC __m256 loadQ4AVX2(const uint8_t* p) {
+    uint32_t bits;
+    std::memcpy(&bits, p, sizeof(bits));
+    const __m256i v = _mm256_srlv_epi32(
+        _mm256_set1_epi32(static_cast<int>(bits)),
+        _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28));
+    return _mm256_cvtepi32_ps(_mm256_sub_epi32(
+        _mm256_and_si256(v, _mm256_set1_epi32(0xF)), _mm256_set1_epi32(8)));
+}
+
+// Bytes8 is the bytes holding eight columns.
+template<__m256 (*Load)(const uint8_t*), int Bytes8, class Row>
+static KERNELS_AVX2_FUNC void dot4AVX2(const uint8_t* a, size_t stride,
+                                       int cols, const float* x, float* y) {
+    __m256 s0 = _mm256_setzero_ps();
+    __m256 s1 = _mm256_setzero_ps();
+    __m256 s2 = _mm256_setzero_ps();
+    __m256 s3 = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 8 <= cols; j += 8) {
+        const __m256 xv = _mm256_loadu_ps(x + j);
+        const uint8_t* p = a + j / 8 * Bytes8;
+        s0 = _mm256_fmadd_ps(Load(p), xv, s0);
+        s1 = _mm256_fmadd_ps(Load(p + stride), xv, s1);
+        s2 = _mm256_fmadd_ps(Load(p + 2 * stride), xv, s2);
+        s3 = _mm256_fmadd_ps(Load(p + 3 * stride), xv, s3);
+    }
+    _mm_storeu_ps(y, sumAcross4(fold(s0), fold(s1), fold(s2), fold(s3)));
+    dot4Tail<Row>(a, stride, cols, x, y, j);
+}
+
+static bool hasAVX2() {
+    static int avx2 = -1;
+    if (avx2 < 0) {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+                   ? 1 : 0;
+    }
+    return avx2 != 0;
+}
+#endif
+
+#if defined(KERNELS_NEON)
+static inline float32x2_t sumAcross2(float32x4_t s0, float32x4_t s1) {
+    return vpadd_f32(vadd_f32(vget_low_f32(s0), vget_high_f32(s0)),
+                     vadd_f32(vget_low_f32(s1), vget_high_f32(s1)));
+}
+
+static void dot4NEON(const uint8_t* a, size_t stride, int cols,
+                     const float* x, float* y) {
+    const float* a0 = reinterpret_cast<const float*>(a);
+    const float* a1 = reinterpret_cast<const float*>(a + stride);
+    const float* a2 = reinterpret_cast<const float*>(a + 2 * stride);
+    const float* a3 = reinterpret_cast<const float*>(a + 3 * stride);
+    float32x4_t s0 = vdupq_n_f32(0.0f);
+    float32x4_t s1 = vdupq_n_f32(0.0f);
+    float32x4_t s2 = vdupq_n_f32(0.0f);
+    float32x4_t s3 = vdupq_n_f32(0.0f);
+    int j = 0;
+    for (; j + 4 <= cols; j += 4) {
+        const float32x4_t xv = vld1q_f32(x + j);
+        s0 = vmlaq_f32(s0, vld1q_f32(a0 + j), xv);
+        s1 = vmlaq_f32(s1, vld1q_f32(a1 + j), xv);
+        s2 = vmlaq_f32(s2, vld1q_f32(a2 + j), xv);
+        s3 = vmlaq_f32(s3, vld1q_f32(a3 + j), xv);
+    }
+    vst1q_f32(y, vcombine_f32(sumAcross2(s0, s1), sumAcross2(s2, s3)));
+    dot4Tail<RowF32>(a, stride, cols, x, y, j);
+}
+
+// Sixteen columns of a quantized row, as signed bytes
+static inline int8x16_t loadQ8NEON(const uint8_t* p) {
+    return vld1q_s8(reinterpret_cast<const int8_t*>(p));
+}
+
+static inline int8x16_t loadQ4NEON(const uint8_t* p) {
+    const uint8x8_t b = vld1_u8(p);
+    const uint8x8x2_t z = vzip_u8(vand_u8(b, vdup_n_u8(0x0F)), vshr_n_u8(b, 4));
+    return vsubq_s8(vreinterpretq_s8_u8(vcombine_u8(z.val[0], z.val[1])),
+                    vdupq_n_s8(8));
+}
+
+// Adds the products of sixteen signed bytes with x0..x3 to s.
+static inline float32x4_t dot16(float32x4_t s, int8x16_t b, float32x4_t x0,
+                                float32x4_t x1, float32x4_t x2,
+                                float32x4_t x3) {
+    const int16x8_t lo = vmovl_s8(vget_low_s8(b));
+    const int16x8_t hi = vmovl_s8(vget_high_s8(b));
+    s = vmlaq_f32(s, vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), x0);
+    s = vmlaq_f32(s, vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), x1);
+    s = vmlaq_f32(s, vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), x2);
+    return vmlaq_f32(s, vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), x3);
+}
+
+// Bytes16 is the bytes holding sixteen columns.
+template<int8x16_t (*Load)(const uint8_t*), int Bytes16, class Row>
+static void dot4QuantNEON(const uint8_t* a, size_t stride, int cols,
+                          const float* x, float* y) {
+    float32x4_t s0 = vdupq_n_f32(0.0f);
+    float32x4_t s1 = vdupq_n_f32(0.0f);
+    float32x4_t s2 = vdupq_n_f32(0.0f);
+    float32x4_t s3 = vdupq_n_f32(0.0f);
+    int j = 0;
+    for (; j + 16 <= cols; j += 16) {
+        const float32x4_t x0 = vld1q_f32(x + j);
+        const float32x4_t x1 = vld1q_f32(x + j + 4);
+        const float32x4_t x2 = vld1q_f32(x + j + 8);
+        const float32x4_t x3 = vld1q_f32(x + j + 12);
+        const uint8_t* p = a + j / 16 * Bytes16;
+        s0 = dot16(s0, Load(p), x0, x1, x2, x3);
+        s1 = dot16(s1, Load(p + stride), x0, x1, x2, x3);
+        s2 = dot16(s2, Load(p + 2 * stride), x0, x1, x2, x3);
+        s3 = dot16(s3, Load(p + 3 * stride), x0, x1, x2, x3);
+    }
+    vst1q_f32(y, vcombine_f32(sumAcross2(s0, s1), sumAcross2(s2, s3)));
+    dot4Tail<Row>(a, stride, cols, x, y, j);
+}
+#endif
+
+struct Kernel {
+    Dot4Fn dot4;
+    Dot1Fn dot1;
+};
+
+template<class Row>
+static Kernel scalarKernel() {
+    return {dot4Scalar<Row>, dot1<Row>};
+}
+
+static Kernel selectKernel(WeightType type) {
+#if defined(KERNELS_AVX2)
+    if (hasAVX2()) {
+        switch (type) {
+            case WeightType::F32:
+                return {dot4AVX2<loadF32AVX2, 32, RowF32>, dot1<RowF32>};
+            case WeightType::Q8:
+                return {dot4AVX2<loadQ8AVX2, 8, RowQ8>, dot1<RowQ8>};
+            case WeightType::Q4:
+                return {dot4AVX2<loadQ4AVX2, 4, RowQ4>, dot1<RowQ4>};
+        }
+    }
+#endif
+#if defined(KERNELS_SSE2)
+    switch (type) {
+        case WeightType::F32:
+            return {dot4SSE2, dot1<RowF32>};
+        case WeightType::Q8:
+            return {dot4QuantSSE2<loadQ8SSE2, 16, RowQ8>, dot1<RowQ8>};
+        case WeightType::Q4:
+            return {dot4QuantSSE2<loadQ4SSE2, 8, RowQ4>, dot1<RowQ4>};
+    }
+#elif defined(KERNELS_NEON)
+    switch (type) {
+        case WeightType::F32:
+            return {dot4NEON, dot1<RowF32>};
+        case WeightType::Q8:
+            return {dot4QuantNEON<loadQ8NEON, 16, RowQ8>, dot1<RowQ8>};
+        case WeightType::Q4:
+            return {dot4QuantNEON<loadQ4NEON, 8, RowQ4>, dot1<RowQ4>};
+    }
+#endif
+    switch (type) {
+        case WeightType::Q8:
+            return scalarKernel<RowQ8>();
+        case WeightType::Q4:
+            return scalarKernel<RowQ4>();
+        default:
+            return scalarKernel<RowF32>();
+    }
+}
+
+static const Kernel& kernelFor(WeightType type) {
+    static const Kernel kernels[] = {
+        selectKernel(WeightType::F32),
+        selectKernel(WeightType::Q8),
+        selectKernel(WeightType::Q4)
+    };
+    return kernels[static_cast<size_t>(type)];
+}
+
+size_t rowBytes(WeightType type, int cols) {
+    switch (type) {
+        case WeightType::Q8:
+            return static_cast<size_t>(cols);
+        case WeightType::Q4:
+            return static_cast<size_t>(cols + 1) / 2;
+        default:
+            return static_cast<size_t>(cols) * sizeof(float);
+    }
+}
+
+static inline int quantize(float v, float scale, int limit) {
+    return std::min(std::max(static_cast<int>(std::lround(v / scale)), -limit),
+                     limit);
+}
+
+float quantizeRow(WeightType type, const float* row, int cols, void* out) {
+    if (type == WeightType::F32) {
+        std::memcpy(out, row, static_cast<size_t>(cols) * sizeof(float));
+        return 1.0f;
+    }
+    float maxAbs = 0.0f;
+    for (int j = 0; j < cols; ++j) {
+        maxAbs = std::max(maxAbs, std::fabs(row[j]));
+    }
+    const int limit = type == WeightType::Q8 ? 127 : 7;
+    float scale = maxAbs > 0.0f ? maxAbs / limit : 1.0f;
+
+    // With few levels, clipping the largest weights leaves finer steps
+    // for the rest, so take the clip giving the least squared error.
+    if (type == WeightType::Q4 && maxAbs > 0.0f) {
+        double bestError = -1.0;
+        for (int i = 0; i <= 10; ++i) {
+            const float trial = maxAbs * (1.0f - 0.05f * i) / limit;
+            double error = 0.0;
+            for (int j = 0; j < cols; ++j) {
+                const float d = row[j] - quantize(row[j], trial, limit) * trial;
+                error += d * d;
+            }
+            if (bestError < 0.0 || error < bestError) {
+                bestError = error;
+                scale = trial;
+            }
+        }
+    }
+    auto* bytes = static_cast<uint8_t*>(out);
+    if (type == WeightType::Q4) {
+        std::memset(bytes, 0, rowBytes(type, cols));
+    }
+    for (int j = 0; j < cols; ++j) {
+        const int q = quantize(row[j], scale, limit);
+        if (type == WeightType::Q8) {
+            bytes[j] = static_cast<uint8_t>(static_cast<int8_t>(q));
+        } else {
+            bytes[j >> 1] |= static_cast<uint8_t>((q + 8) << ((j & 1) * 4));
+        }
+    }
+    return scale;
+}
+
+void dequantizeRow(const Weights& a, int r, float* out) {
+    const uint8_t* row = static_cast<const uint8_t*>(a.data)
+                         + static_cast<size_t>(r) * rowBytes(a.type, a.cols);
+    switch (a.type) {
+        case WeightType::Q8:
+            for (int j = 0; j < a.cols; ++j) {
+                out[j] = RowQ8::at(row, j) * a.scales[r];
+            }
+            break;
+        case WeightType::Q4:
+            for (int j = 0; j < a.cols; ++j) {
+                out[j] = RowQ4::at(row, j) * a.scales[r];
+            }
+            break;
+        default:
+            std::memcpy(out, row, static_cast<size_t>(a.cols) * sizeof(float));
+            break;
+    }
+}
+
+void gemv(const Weights& a, const float* x, float* y) {
+    gemm(x, 1, a, y);
+}
+
+void gemm(const float* x, int n, const Weights& a, float* c) {
+    const Kernel& kernel = kernelFor(a.type);
+    const size_t stride = rowBytes(a.type, a.cols);
+    const int block = static_cast<int>(std::max<size_t>(
+        4, BLOCK_BYTES / std::max<size_t>(stride, 1) / 4 * 4));
+    const auto* data = static_cast<const uint8_t*>(a.data);
+    const bool scaled = a.type != WeightType::F32;
+
+    for (int r0 = 0; r0 < a.rows; r0 += block) {
+        const int rEnd = std::min(a.rows, r0 + block);
+        for (int t = 0; t < n; ++t) {
+            const float* xt = x + static_cast<size_t>(t) * a.cols;
+            float* ct = c + static_cast<size_t>(t) * a.rows;
+            int i = r0;
+            for (; i + 4 <= rEnd; i += 4) {
+                kernel.dot4(data + i * stride, stride, a.cols, xt, ct + i);
+            }
+            for (; i < rEnd; ++i) {
+                ct[i] = kernel.dot1(data + i * stride, a.cols, xt);
+            }
+            if (scaled) {
+                for (i = r0; i < rEnd; ++i) {
+                    ct[i] *= a.scales[i];
+                }
+            }
+        }
+    }
+}
+
+void gemv(const float* a, int rows, int cols, const float* x, float* y) {
+    gemm(x, 1, a, rows, cols, y);
+}
+
+void gemm(const float* x, int n, const float* a, int rows, int cols, float* c) {
+    Weights w;
+    w.data = a;
+    w.rows = rows;
+    w.cols = cols;
+    gemm(x, n, w, c);
+}
+
+// tanh as a rational function of degree 13 over 6, clamped where it
+// reaches +-1 in float and x itself near 0. Within 1e-6 of std::tanh.
+static const float TANH_CLAMP = 7.90531110763549805f;
+static const float TANH_TINY = 0.0004f;
+static const float TANH_P[7] = {
+    -2.76076847742355e-16f, 2.00018790482477e-13f, -8.60467152213735e-11f,
+    5.12229709037114e-08f, 1.48572235717979e-05f, 6.37261928875436e-04f,
+    4.89352455891786e-03f
+};
+static const float TANH_Q[4] = {
+    1.19825839466702e-06f, 1.18534705686654e-04f, 2.26843463243900e-03f,
+    4.89352518554385e-03f
+};
+
+// Each activation is y = outScale * tanh(inScale * x) + outBias
+struct Squash {
+    float inScale;
+    float outScale;
+    float outBias;
+};
+
+static inline float tanhScalar(float x) {
+    if (std::fabs(x) < TANH_TINY) {
+        return x;
+    }
+    x = std::min(std::max(x, -TANH_CLAMP), TANH_CLAMP);
+    const float x2 = x * x;
+    float p = TANH_P[0];
+    for (int i = 1; i < 7; ++i) {
+        p = p * x2 + TANH_P[i];
+    }
+    float q = TANH_Q[0];
+    for (int i = 1; i < 4; ++i) {
+        q = q * x2 + TANH_Q[i];
+    }
+    return x * p / q;
+}
+
+static void squashScalar(float* x, size_t n, Squash s) {
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = s.outScale * tanhScalar(s.inScale * x[i]) + s.outBias;
+    }
+}
+
+#if defined(KERNELS_SSE2)
+static void squashSSE2(float* x, size_t n, Squash s) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 inScale = _mm_set1_ps(s.inScale);
+    const __m128 outScale = _mm_set1_ps(s.outScale);
+    const __m128 outBias = _mm_set1_ps(s.outBias);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v = _mm_mul_ps(_mm_loadu_ps(x + i), inScale);
+        const __m128 tiny = _mm_cmplt_ps(_mm_andnot_ps(sign, v),
+                                         _mm_set1_ps(TANH_TINY));
+        const __m128 c = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-TANH_CLAMP)),
+                                    _mm_set1_ps(TANH_CLAMP));
+        const __m128 x2 = _mm_mul_ps(c, c);
+        __m128 p = _mm_set1_ps(TANH_P[0]);
+        for (int k = 1; k < 7; ++k) {
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(TANH_P[k]));
+        }
+        __m128 q = _mm_set1_ps(TANH_Q[0]);
+        for (int k = 1; k < 4; ++k) {
+            q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(TANH_Q[k]));
+        }
+        __m128 t = _mm_div_ps(_mm_mul_ps(c, p), q);
+        t = _mm_or_ps(_mm_and_ps(tiny, v), _mm_andnot_ps(tiny, t));
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_mul_ps(t, outScale), outBias));
+    }
+    squashScalar(x + i, n - i, s);
+}
+#endif
+
+#if defined(KERNELS_AVX2)
+static KERNELS_AVX2_FUNC void squashAVX2(float* x, size_t n, Squash s) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 inScale = _mm256_set1_ps(s.inScale);
+    const __m256 outScale = _mm256_set1_ps(s.outScale);
+    const __m256 outBias = _mm256_set1_ps(s.outBias);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(x + i), inScale);
+        const __m256 tiny = _mm256_cmp_ps(_mm256_andnot_ps(sign, v),
+                                          _mm256_set1_ps(TANH_TINY), _CMP_LT_OQ);
+        const __m256 c = _mm256_min_ps(
+            _mm256_max_ps(v, _mm256_set1_ps(-TANH_CLAMP)),
+            _mm256_set1_ps(TANH_CLAMP));
+        const __m256 x2 = _mm256_mul_ps(c, c);
+        __m256 p = _mm256_set1_ps(TANH_P[0]);
+        for (int k = 1; k < 7; ++k) {
+            p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(TANH_P[k]));
+        }
+        __m256 q = _mm256_set1_ps(TANH_Q[0]);
+        for (int k = 1; k < 4; ++k) {
+            q = _mm256_fmadd_ps(q, x2, _mm256_set1_ps(TANH_Q[k]));
+        }
+        const __m256 t = _mm256_blendv_ps(
+            _mm256_div_ps(_mm256_mul_ps(c, p), q), v, tiny);
+        _mm256_storeu_ps(x + i, _mm256_fmadd_ps(t, outScale, outBias));
+    }
+    squashScalar(x + i, n - i, s);
+}
+#endif
+
+#if defined(KERNELS_NEON) && defined(__aarch64__)
+static void squashNEON(float* x, size_t n, Squash s) {
+    const float32x4_t inScale = vdupq_n_f32(s.inScale);
+    const float32x4_t outScale = vdupq_n_f32(s.outScale);
+    const float32x4_t outBias = vdupq_n_f32(s.outBias);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vmulq_f32(vld1q_f32(x + i), inScale);
+        const uint32x4_t tiny = vcltq_f32(vabsq_f32(v), vdupq_n_f32(TANH_TINY));
+        const float32x4_t c = vminq_f32(vmaxq_f32(v, vdupq_n_f32(-TANH_CLAMP)),
+                                        vdupq_n_f32(TANH_CLAMP));
+        const float32x4_t x2 = vmulq_f32(c, c);
+        float32x4_t p = vdupq_n_f32(TANH_P[0]);
+        for (int k = 1; k < 7; ++k) {
+            p = vfmaq_f32(vdupq_n_f32(TANH_P[k]), p, x2);
+        }
+        float32x4_t q = vdupq_n_f32(TANH_Q[0]);
+        for (int k = 1; k < 4; ++k) {
+            q = vfmaq_f32(vdupq_n_f32(TANH_Q[k]), q, x2);
+        }
+        const float32x4_t t = vbslq_f32(tiny, v, vdivq_f32(vmulq_f32(c, p), q));
+        vst1q_f32(x + i, vfmaq_f32(outBias, t, outScale));
+    }
+    squashScalar(x + i, n - i, s);
+}
+#endif
+
+static void squash(float* x, size_t n, Squash s) {
+#if defined(KERNELS_AVX2)
+    if (hasAVX2()) {
+        squashAVX2(x, n, s);
+        return;
+    }
+#endif
+#if defined(KERNELS_SSE2)
+    squashSSE2(x, n, s);
+#elif defined(KERNELS_NEON) && defined(__aarch64__)
+    squashNEON(x, n, s);
+#else
+    squashScalar(x, n, s);
+#endif
+}
+
+void tanhInPlace(float* x, size_t n) {
+    squash(x, n, {1.0f, 1.0f, 0.0f});
+}
+
+// The logistic function is 1/2 + tanh(x/2)/2
+void sigmoidInPlace(float* x, size_t n) {
+    squash(x, n, {0.5f, 0.5f, 0.5f});
+}
+
+const char* backendName() {
+#if defined(KERNELS_AVX2)
+    if (hasAVX2()) return "AVX2";
+#endif
+#if defined(KERNELS_SSE2)
+    return "SSE2";
+#elif defined(KERNELS_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Kernels
+} // namespace LLM
+} // namespace NPC
+} // namespace Ultima
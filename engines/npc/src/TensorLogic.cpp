@@ -3,17 +3,21 @@
  */
 
 #include "reasoning/TensorLogic.h"
+#include "llm/TensorKernels.h"
 #include <cmath>
 #include <random>
 #include <algorithm>
 #include <fstream>
 #include <sstream>
+#include <numeric>
 #include <queue>
 
 namespace Ultima {
 namespace NPC {
 namespace Reasoning {
 
+namespace Kernels = LLM::Kernels;
+
 static std::mt19937 rng(std::random_device{}());
 
 //=============================================================================
@@ -226,6 +230,24 @@ double Tensor::cosineSimilarity(const Tensor& other) const {
 // EntityEmbedding Implementation
 //=============================================================================
 
+// Rows assigned to clusters at a time while building the index
+static const size_t CLUSTER_CHUNK = 256;
+static const int CLUSTER_ITERATIONS = 10;
+
+// Scales a row to unit length, unless it is all but zero
+static void normalizeRow(float* row, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += static_cast<double>(row[i]) * row[i];
+    }
+    const double norm = std::sqrt(sum);
+    if (norm < 1e-10) return;
+    const float scale = static_cast<float>(1.0 / norm);
+    for (size_t i = 0; i < n; ++i) {
+        row[i] *= scale;
+    }
+}
+
 EntityEmbedding::EntityEmbedding(size_t dimension)
     : dimension_(dimension)
 {
@@ -242,45 +264,107 @@ Tensor EntityEmbedding::randomEmbedding() {
     return t.normalized();
 }
 
-Tensor EntityEmbedding::getEmbedding(const std::string& entity) {
-    if (!entityEmbeddings_.count(entity)) {
-        entityEmbeddings_[entity] = randomEmbedding();
+uint32_t EntityEmbedding::idOf(const std::string& entity) {
+    auto it = ids_.find(entity);
+    if (it != ids_.end()) {
+        return it->second;
     }
-    return entityEmbeddings_[entity];
+    const uint32_t id = static_cast<uint32_t>(names_.size());
+    ids_.emplace(entity, id);
+    names_.push_back(entity);
+    const Tensor random = randomEmbedding();
+    matrix_.insert(matrix_.end(), random.data().begin(), random.data().end());
+    normalizeRow(row(id), dimension_);
+    fileInIndex(id);
+    return id;
+}
+
+Tensor EntityEmbedding::getEmbedding(const std::string& entity) {
+    const float* r = row(idOf(entity));
+    return Tensor(std::vector<double>(r, r + dimension_));
 }
 
 void EntityEmbedding::updateEmbedding(const std::string& entity,
                                       const Tensor& context,
                                       double learningRate) {
-    auto& emb = entityEmbeddings_[entity];
-    if (emb.size() == 0) {
-        emb = randomEmbedding();
-    }
+    const uint32_t id = idOf(entity);
+    float* emb = row(id);
     for (size_t i = 0; i < dimension_ && i < context.size(); ++i) {
-        emb[i] += learningRate * (context[i] - emb[i]);
+        emb[i] += static_cast<float>(learningRate * (context[i] - emb[i]));
     }
-    emb = emb.normalized();
+    normalizeRow(emb, dimension_);
+    fileInIndex(id);
+}
+
+std::vector<std::pair<uint32_t, float>> EntityEmbedding::search(const float* query,
+                                                                size_t topK,
+                                                                uint32_t exclude) {
+    // The best so far, as a heap with the worst on top
+    std::vector<std::pair<uint32_t, float>> best;
+    auto worse = [](const std::pair<uint32_t, float>& a,
+                    const std::pair<uint32_t, float>& b) {
+        return a.second > b.second;
+    };
+    auto offer = [&](uint32_t id, float score) {
+        if (id == exclude) return;
+        if (best.size() < topK) {
+            best.emplace_back(id, score);
+            std::push_heap(best.begin(), best.end(), worse);
+        } else if (score > best.front().second) {
+            std::pop_heap(best.begin(), best.end(), worse);
+            best.back() = {id, score};
+            std::push_heap(best.begin(), best.end(), worse);
+        }
+    };
+    if (topK == 0) {
+        return best;
+    }
+
+    const int dim = static_cast<int>(dimension_);
+    if (lists_.empty()) {
+        scores_.resize(names_.size());
+        Kernels::gemv(matrix_.data(), static_cast<int>(names_.size()), dim,
+                      query, scores_.data());
+        for (size_t i = 0; i < names_.size(); ++i) {
+            offer(static_cast<uint32_t>(i), scores_[i]);
+        }
+    } else {
+        // Scan the lists whose centres are nearest
+        const size_t numLists = lists_.size();
+        scores_.resize(numLists);
+        Kernels::gemv(centroids_.data(), static_cast<int>(numLists), dim,
+                      query, scores_.data());
+        std::vector<uint32_t> order(numLists);
+        std::iota(order.begin(), order.end(), 0u);
+        std::partial_sort(order.begin(), order.begin() + probes_, order.end(),
+                          [this](uint32_t a, uint32_t b) {
+                              return scores_[a] > scores_[b];
+                          });
+        for (size_t p = 0; p < probes_; ++p) {
+            const IndexList& list = lists_[order[p]];
+            scores_.resize(list.ids.size());
+            Kernels::gemv(list.rows.data(), static_cast<int>(list.ids.size()), dim,
+                          query, scores_.data());
+            for (size_t i = 0; i < list.ids.size(); ++i) {
+                offer(list.ids[i], scores_[i]);
+            }
+        }
+    }
+
+    std::sort(best.begin(), best.end(), worse);
+    return best;
 }
 
 std::vector<std::pair<std::string, double>> EntityEmbedding::findSimilar(
     const std::string& entity, int topK)
 {
     std::vector<std::pair<std::string, double>> results;
-    Tensor target = getEmbedding(entity);
-
-    for (const auto& [name, emb] : entityEmbeddings_) {
-        if (name == entity) continue;
-        double sim = target.cosineSimilarity(emb);
-        results.push_back({name, sim});
-    }
-
-    std::sort(results.begin(), results.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    const uint32_t id = idOf(entity);
+    const std::vector<float> target(row(id), row(id) + dimension_);
 
-    if (results.size() > static_cast<size_t>(topK)) {
-        results.resize(topK);
+    for (const auto& [other, sim] : search(target.data(), std::max(topK, 0), id)) {
+        results.push_back({names_[other], sim});
     }
-
     return results;
 }
 
@@ -309,23 +393,122 @@ std::string EntityEmbedding::predictObject(const std::string& subject,
         return "";
     }
 
-    Tensor subj = getEmbedding(subject);
-    Tensor rel = relationEmbeddings_[relation];
-    Tensor predicted = subj + rel;
+    const uint32_t id = idOf(subject);
+    const Tensor& rel = relationEmbeddings_[relation];
+    std::vector<float> predicted(row(id), row(id) + dimension_);
+    for (size_t i = 0; i < dimension_ && i < rel.size(); ++i) {
+        predicted[i] += static_cast<float>(rel[i]);
+    }
+    normalizeRow(predicted.data(), dimension_);
 
-    double bestSim = -1.0;
-    std::string bestEntity;
+    auto best = search(predicted.data(), 1, id);
+    return best.empty() ? "" : names_[best[0].first];
+}
+
+void EntityEmbedding::buildIndex(size_t lists, size_t probes) {
+    dropIndex();
+    const size_t n = names_.size();
+    if (n == 0) {
+        return;
+    }
+    const size_t numLists = lists > 0 ? std::min(lists, n)
+        : std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+    const int dim = static_cast<int>(dimension_);
+
+    // Spherical k-means, starting from entities spread through the table
+    centroids_.resize(numLists * dimension_);
+    for (size_t c = 0; c < numLists; ++c) {
+        const float* start = row(static_cast<uint32_t>(c * n / numLists));
+        std::copy(start, start + dimension_, &centroids_[c * dimension_]);
+    }
+    std::vector<uint32_t> assignment(n, 0);
+    std::vector<float> scores(CLUSTER_CHUNK * numLists);
+    std::vector<float> sums(numLists * dimension_);
+    for (int iter = 0; iter < CLUSTER_ITERATIONS; ++iter) {
+        for (size_t start = 0; start < n; start += CLUSTER_CHUNK) {
+            const size_t count = std::min(CLUSTER_CHUNK, n - start);
+            Kernels::gemm(row(static_cast<uint32_t>(start)), static_cast<int>(count),
+                          centroids_.data(), static_cast<int>(numLists), dim,
+                          scores.data());
+            for (size_t i = 0; i < count; ++i) {
+                const float* s = &scores[i * numLists];
+                assignment[start + i] =
+                    static_cast<uint32_t>(std::max_element(s, s + numLists) - s);
+            }
+        }
 
-    for (const auto& [name, emb] : entityEmbeddings_) {
-        if (name == subject) continue;
-        double sim = predicted.cosineSimilarity(emb);
-        if (sim > bestSim) {
-            bestSim = sim;
-            bestEntity = name;
+        // An empty list keeps its old centre
+        std::fill(sums.begin(), sums.end(), 0.0f);
+        std::vector<size_t> sizes(numLists, 0);
+        for (size_t i = 0; i < n; ++i) {
+            float* sum = &sums[assignment[i] * dimension_];
+            const float* r = row(static_cast<uint32_t>(i));
+            for (size_t d = 0; d < dimension_; ++d) {
+                sum[d] += r[d];
+            }
+            ++sizes[assignment[i]];
+        }
+        for (size_t c = 0; c < numLists; ++c) {
+            if (sizes[c] > 0) {
+                normalizeRow(&sums[c * dimension_], dimension_);
+                std::copy(&sums[c * dimension_], &sums[c * dimension_] + dimension_,
+                          &centroids_[c * dimension_]);
+            }
         }
     }
 
-    return bestEntity;
+    lists_.resize(numLists);
+    probes_ = std::max<size_t>(1, std::min(probes, numLists));
+    for (uint32_t id = 0; id < n; ++id) {
+        fileInIndex(id);
+    }
+}
+
+void EntityEmbedding::dropIndex() {
+    centroids_.clear();
+    lists_.clear();
+    listOf_.clear();
+    slotOf_.clear();
+    probes_ = 0;
+}
+
+void EntityEmbedding::fileInIndex(uint32_t id) {
+    if (lists_.empty()) {
+        return;
+    }
+    const float* r = row(id);
+    scores_.resize(lists_.size());
+    Kernels::gemv(centroids_.data(), static_cast<int>(lists_.size()),
+                  static_cast<int>(dimension_), r, scores_.data());
+    const uint32_t target = static_cast<uint32_t>(
+        std::max_element(scores_.begin(), scores_.end()) - scores_.begin());
+
+    if (listOf_.size() <= id) {
+        listOf_.resize(id + 1, UINT32_MAX);
+        slotOf_.resize(id + 1, 0);
+    }
+    if (listOf_[id] != target && listOf_[id] != UINT32_MAX) {
+        // Move the list's last entity into this one's place
+        IndexList& old = lists_[listOf_[id]];
+        const uint32_t slot = slotOf_[id];
+        const uint32_t last = old.ids.back();
+        old.ids[slot] = last;
+        std::copy(old.rows.end() - dimension_, old.rows.end(),
+                  old.rows.begin() + slot * dimension_);
+        slotOf_[last] = slot;
+        old.ids.pop_back();
+        old.rows.resize(old.rows.size() - dimension_);
+        listOf_[id] = UINT32_MAX;
+    }
+
+    IndexList& list = lists_[target];
+    if (listOf_[id] == UINT32_MAX) {
+        listOf_[id] = target;
+        slotOf_[id] = static_cast<uint32_t>(list.ids.size());
+        list.ids.push_back(id);
+        list.rows.resize(list.rows.size() + dimension_);
+    }
+    std::copy(r, r + dimension_, list.rows.begin() + slotOf_[id] * dimension_);
 }
 
 bool EntityEmbedding::save(const std::string& filename) const {
@@ -333,10 +516,11 @@ bool EntityEmbedding::save(const std::string& filename) const {
     if (!file) return false;
 
     file << dimension_ << "\n";
-    file << entityEmbeddings_.size() << "\n";
+    file << names_.size() << "\n";
 
-    for (const auto& [name, emb] : entityEmbeddings_) {
-        file << name << "\n";
+    for (size_t id = 0; id < names_.size(); ++id) {
+        file << names_[id] << "\n";
+        const float* emb = &matrix_[id * dimension_];
         for (size_t i = 0; i < dimension_; ++i) {
             file << emb[i] << " ";
         }
@@ -354,124 +538,330 @@ bool EntityEmbedding::load(const std::string& filename) {
     file >> dim >> count;
     dimension_ = dim;
 
-    entityEmbeddings_.clear();
+    dropIndex();
+    matrix_.clear();
+    ids_.clear();
+    names_.clear();
 
+    std::vector<float> emb(dim);
     for (size_t c = 0; c < count; ++c) {
         std::string name;
         file >> name;
-
-        Tensor emb(dim);
         for (size_t i = 0; i < dim; ++i) {
             file >> emb[i];
         }
-        entityEmbeddings_[name] = emb;
+        normalizeRow(emb.data(), dim);
+
+        auto it = ids_.find(name);
+        if (it == ids_.end()) {
+            it = ids_.emplace(name, static_cast<uint32_t>(names_.size())).first;
+            names_.push_back(name);
+            matrix_.resize(matrix_.size() + dim);
+        }
+        std::copy(emb.begin(), emb.end(), row(it->second));
     }
 
     return true;
 }
 
+//=============================================================================
+// SymbolTable Implementation
+//=============================================================================
+
+uint32_t SymbolTable::intern(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const uint32_t id = static_cast<uint32_t>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
+
+uint32_t SymbolTable::find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : NONE;
+}
+
+void SymbolTable::clear() {
+    ids_.clear();
+    names_.clear();
+}
+
 //=============================================================================
 // TensorLogicReasoner Implementation
 //=============================================================================
 
+static size_t hashCombine(size_t seed, uint32_t value) {
+    return seed ^ (value + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+static size_t hashTuple(uint32_t predicate, const uint32_t* args, uint32_t arity) {
+    size_t h = hashCombine(arity, predicate);
+    for (uint32_t i = 0; i < arity; ++i) {
+        h = hashCombine(h, args[i]);
+    }
+    return h;
+}
+
+size_t TensorLogicReasoner::ArgKeyHash::operator()(const ArgKey& key) const {
+    return hashCombine(hashCombine(key.predicate, key.position), key.symbol);
+}
+
 TensorLogicReasoner::TensorLogicReasoner() = default;
 TensorLogicReasoner::~TensorLogicReasoner() = default;
 
-void TensorLogicReasoner::addFact(const std::string& predicate,
-                                  const std::vector<std::string>& args,
-                                  double truthValue) {
+uint32_t TensorLogicReasoner::findFact(uint32_t predicate, const uint32_t* args,
+                                       uint32_t arity) const {
+    auto range = factLookup_.equal_range(hashTuple(predicate, args, arity));
+    for (auto it = range.first; it != range.second; ++it) {
+        const StoredFact& fact = facts_[it->second];
+        if (fact.predicate == predicate && fact.arity == arity &&
+            std::equal(args, args + arity, factArgs_.begin() + fact.firstArg)) {
+            return it->second;
+        }
+    }
+    return NEVER;
+}
+
+uint32_t TensorLogicReasoner::storeFact(uint32_t predicate, const uint32_t* args,
+                                        uint32_t arity, const LogicalValue& value) {
+    const uint32_t index = static_cast<uint32_t>(facts_.size());
+    StoredFact fact;
+    fact.predicate = predicate;
+    fact.firstArg = static_cast<uint32_t>(factArgs_.size());
+    fact.arity = arity;
+    fact.trueSince = NEVER;
+    factArgs_.insert(factArgs_.end(), args, args + arity);
+    setValue(fact, value);
+    facts_.push_back(fact);
+
+    factLookup_.emplace(hashTuple(predicate, args, arity), index);
+    predicateIndex_[predicate].push_back(index);
+    for (uint32_t i = 0; i < arity; ++i) {
+        argIndex_[ArgKey{predicate, i, args[i]}].push_back(index);
+        // Once per entity, however often it appears
+        if (std::find(args, args + i, args[i]) == args + i) {
+            entityIndex_[args[i]].push_back(index);
+        }
+    }
+    return index;
+}
+
+void TensorLogicReasoner::setValue(StoredFact& fact, const LogicalValue& value) {
+    const bool wasTrue = fact.trueSince != NEVER && fact.value.isTrue(0.5);
+    fact.value = value;
+    if (!wasTrue && value.isTrue(0.5)) {
+        fact.trueSince = round_;
+    }
+}
+
+Fact TensorLogicReasoner::toFact(uint32_t index) const {
+    const StoredFact& stored = facts_[index];
     Fact fact;
-    fact.predicate = Term::predicate(predicate, {});
-    for (const auto& arg : args) {
-        fact.predicate.arguments.push_back(Term::constant(arg));
+    fact.predicate = Term::predicate(symbols_.name(stored.predicate), {});
+    for (uint32_t i = 0; i < stored.arity; ++i) {
+        fact.predicate.arguments.push_back(
+            Term::constant(symbols_.name(factArgs_[stored.firstArg + i])));
+    }
+    fact.value = stored.value;
+    fact.timestamp = stored.timestamp;
+    if (stored.source != SymbolTable::NONE) {
+        fact.source = symbols_.name(stored.source);
     }
-    fact.value = LogicalValue(truthValue);
+    fact.isDerived = stored.isDerived;
+    return fact;
+}
 
-    size_t idx = facts_.size();
-    facts_.push_back(fact);
+uint32_t TensorLogicReasoner::symbolOf(const Term& term, const Binding& binding) const {
+    const Term* value = &term;
+    if (term.type == Term::Type::Variable) {
+        auto it = binding.find(term.name);
+        if (it == binding.end()) {
+            return SymbolTable::NONE;  // Unbound variable
+        }
+        value = &it->second;
+    }
+    if (!std::holds_alternative<std::string>(value->value)) {
+        return SymbolTable::NONE;
+    }
+    return symbols_.find(std::get<std::string>(value->value));
+}
 
-    predicateIndex_.insert({predicate, idx});
+void TensorLogicReasoner::addFact(const std::string& predicate,
+                                  const std::vector<std::string>& args,
+                                  double truthValue) {
+    std::vector<uint32_t> symbols;
+    symbols.reserve(args.size());
     for (const auto& arg : args) {
-        entityIndex_.insert({arg, idx});
+        symbols.push_back(symbols_.intern(arg));
     }
+    const uint32_t pred = symbols_.intern(predicate);
+    const uint32_t arity = static_cast<uint32_t>(symbols.size());
+
+    const uint32_t existing = findFact(pred, symbols.data(), arity);
+    if (existing != NEVER) {
+        setValue(facts_[existing], LogicalValue(truthValue));
+        facts_[existing].isDerived = false;
+        return;
+    }
+    storeFact(pred, symbols.data(), arity, LogicalValue(truthValue));
 }
 
 LogicalValue TensorLogicReasoner::queryFact(const std::string& predicate,
                                             const std::vector<std::string>& args) const {
-    auto range = predicateIndex_.equal_range(predicate);
-    for (auto it = range.first; it != range.second; ++it) {
-        const auto& fact = facts_[it->second];
-
-        bool match = true;
-        if (fact.predicate.arguments.size() != args.size()) {
-            continue;
+    const uint32_t pred = symbols_.find(predicate);
+    std::vector<uint32_t> symbols;
+    symbols.reserve(args.size());
+    for (const auto& arg : args) {
+        symbols.push_back(symbols_.find(arg));
+    }
+    if (pred != SymbolTable::NONE &&
+        std::find(symbols.begin(), symbols.end(), SymbolTable::NONE) == symbols.end()) {
+        const uint32_t index = findFact(pred, symbols.data(),
+                                        static_cast<uint32_t>(symbols.size()));
+        if (index != NEVER) {
+            return facts_[index].value;
         }
+    }
+    return LogicalValue(0.0, 0.0);  // Unknown
+}
 
-        for (size_t i = 0; i < args.size(); ++i) {
-            const auto& term = fact.predicate.arguments[i];
-            if (term.type == Term::Type::Constant) {
-                if (std::holds_alternative<std::string>(term.value)) {
-                    if (std::get<std::string>(term.value) != args[i]) {
-                        match = false;
-                        break;
-                    }
-                }
+TensorLogicReasoner::Atom TensorLogicReasoner::compileAtom(const Term& predicate,
+                                                            CompiledRule& rule) {
+    Atom atom;
+    atom.predicate = symbols_.intern(predicate.name);
+    for (const auto& arg : predicate.arguments) {
+        if (arg.type == Term::Type::Variable) {
+            auto it = std::find(rule.variables.begin(), rule.variables.end(), arg.name);
+            const size_t slot = static_cast<size_t>(it - rule.variables.begin());
+            if (it == rule.variables.end()) {
+                rule.variables.push_back(arg.name);
             }
+            atom.args.push_back(VARIABLE | static_cast<uint32_t>(slot));
+        } else if (std::holds_alternative<std::string>(arg.value)) {
+            atom.args.push_back(symbols_.intern(std::get<std::string>(arg.value)));
+        } else {
+            // Facts only hold names, so this can't match
+            atom.args.push_back(SymbolTable::NONE);
         }
-
-        if (match) {
-            return fact.value;
+    }
+    return atom;
+}
+
+void TensorLogicReasoner::compileRule(const InferenceRule& rule) {
+    CompiledRule compiled;
+    for (size_t i = 0; i < rule.premises.size(); ++i) {
+        const Formula& premise = rule.premises[i];
+        if (premise.type == Formula::Type::Atomic) {
+            compiled.positive.push_back(compileAtom(premise.predicate, compiled));
+        } else if (premise.type == Formula::Type::Negation &&
+                   premise.subformulas[0].type == Formula::Type::Atomic) {
+            compiled.negative.push_back(
+                compileAtom(premise.subformulas[0].predicate, compiled));
+        } else {
+            compiled.filters.push_back(i);
         }
     }
 
-    return LogicalValue(0.0, 0.0);  // Unknown
+    // Every variable of the conclusion and negated premises must be bound
+    // by a positive premise
+    compiled.usable = rule.conclusion.type == Formula::Type::Atomic;
+    if (compiled.usable) {
+        compiled.conclusion = compileAtom(rule.conclusion.predicate, compiled);
+        std::vector<bool> bound(compiled.variables.size(), false);
+        for (const auto& atom : compiled.positive) {
+            for (uint32_t arg : atom.args) {
+                if (arg & VARIABLE) {
+                    bound[arg & ~VARIABLE] = true;
+                }
+            }
+        }
+        auto isBound = [&bound](const Atom& atom) {
+            return std::all_of(atom.args.begin(), atom.args.end(), [&bound](uint32_t arg) {
+                return !(arg & VARIABLE) || bound[arg & ~VARIABLE];
+            });
+        };
+        compiled.usable = isBound(compiled.conclusion) &&
+            std::all_of(compiled.negative.begin(), compiled.negative.end(), isBound);
+    }
+    compiled_.push_back(std::move(compiled));
 }
 
 void TensorLogicReasoner::addRule(const InferenceRule& rule) {
     rules_.push_back(rule);
+    compileRule(rules_.back());
 }
 
 std::vector<Fact> TensorLogicReasoner::forwardChain(int maxIterations) {
     std::vector<Fact> newFacts;
+    std::vector<Derivation> derived;
 
     for (int iter = 0; iter < maxIterations; ++iter) {
-        bool changed = false;
-
-        for (const auto& rule : rules_) {
-            // Try to match premises
-            bool allPremisesMatch = true;
-            Binding binding;
-
-            for (const auto& premise : rule.premises) {
-                LogicalValue result;
-                if (!matchFormula(premise, binding, result)) {
-                    allPremisesMatch = false;
-                    break;
-                }
-                if (!result.isTrue(0.5)) {
-                    allPremisesMatch = false;
-                    break;
+        // Facts that become true from here on are for the next round
+        const uint32_t round = round_++;
+        derived.clear();
+
+        for (size_t r = 0; r < compiled_.size(); ++r) {
+            const CompiledRule& rule = compiled_[r];
+            if (!rule.usable || rule.positive.empty()) {
+                continue;
+            }
+            Join state;
+            state.rule = &rule;
+            state.source = &rules_[r];
+            state.round = round;
+            state.derived = &derived;
+            const size_t atoms = rule.positive.size();
+
+            if (r >= rulesChained_) {
+                // A new rule, joined against every fact
+                for (size_t i = 0; i < atoms; ++i) {
+                    state.order.push_back(i);
                 }
+                state.rounds.assign(atoms, Rounds::UpTo);
+                state.slots.assign(rule.variables.size(), SymbolTable::NONE);
+                join(state, 0);
+                continue;
             }
 
-            if (allPremisesMatch) {
-                // Derive conclusion
-                Fact newFact;
-                newFact.predicate = rule.conclusion.predicate;
-                newFact.value = LogicalValue(rule.confidence);
-                newFact.isDerived = true;
-
-                // Check if already known
-                bool alreadyKnown = false;
-                // ... (check logic)
-
-                if (!alreadyKnown) {
-                    facts_.push_back(newFact);
-                    newFacts.push_back(newFact);
-                    changed = true;
+            // Every match using at least one fact from this round: atom d
+            // takes this round's facts, those before it older facts and
+            // those after it any
+            for (size_t d = 0; d < atoms; ++d) {
+                state.order.assign(1, d);
+                state.rounds.assign(1, Rounds::At);
+                for (size_t i = 0; i < atoms; ++i) {
+                    if (i != d) {
+                        state.order.push_back(i);
+                        state.rounds.push_back(i < d ? Rounds::Before : Rounds::UpTo);
+                    }
                 }
+                state.slots.assign(rule.variables.size(), SymbolTable::NONE);
+                join(state, 0);
             }
         }
+        if (iter == 0) {
+            rulesChained_ = compiled_.size();
+        }
+
+        bool changed = false;
+        for (const auto& d : derived) {
+            const uint32_t arity = static_cast<uint32_t>(d.args.size());
+            // Check if already known
+            if (findFact(d.predicate, d.args.data(), arity) != NEVER) {
+                continue;
+            }
+            const uint32_t index = storeFact(d.predicate, d.args.data(), arity,
+                                             LogicalValue(d.rule->confidence));
+            facts_[index].isDerived = true;
+            if (!d.rule->name.empty()) {
+                facts_[index].source = symbols_.intern(d.rule->name);
+            }
+            newFacts.push_back(toFact(index));
+            changed = changed || facts_[index].trueSince == round_;
+        }
 
         if (!changed) break;
     }
@@ -479,6 +869,117 @@ std::vector<Fact> TensorLogicReasoner::forwardChain(int maxIterations) {
     return newFacts;
 }
 
+void TensorLogicReasoner::join(Join& state, size_t step) const {
+    const CompiledRule& rule = *state.rule;
+    if (step == state.order.size()) {
+        if (holds(state)) {
+            Derivation d;
+            d.rule = state.source;
+            d.predicate = rule.conclusion.predicate;
+            for (uint32_t arg : rule.conclusion.args) {
+                d.args.push_back((arg & VARIABLE) ? state.slots[arg & ~VARIABLE] : arg);
+            }
+            state.derived->push_back(std::move(d));
+        }
+        return;
+    }
+
+    // Scan the shortest index list among the atom's bound arguments
+    const Atom& atom = rule.positive[state.order[step]];
+    const uint32_t arity = static_cast<uint32_t>(atom.args.size());
+    auto predIt = predicateIndex_.find(atom.predicate);
+    if (predIt == predicateIndex_.end()) {
+        return;
+    }
+    const std::vector<uint32_t>* candidates = &predIt->second;
+    for (uint32_t i = 0; i < arity; ++i) {
+        const uint32_t arg = atom.args[i];
+        const uint32_t symbol = (arg & VARIABLE) ? state.slots[arg & ~VARIABLE] : arg;
+        if (symbol == SymbolTable::NONE) {
+            continue;
+        }
+        auto it = argIndex_.find(ArgKey{atom.predicate, i, symbol});
+        if (it == argIndex_.end()) {
+            return;
+        }
+        if (it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+
+    // Slots this atom binds, unbound again after each fact
+    std::vector<uint32_t> fresh;
+    for (uint32_t arg : atom.args) {
+        if ((arg & VARIABLE) && state.slots[arg & ~VARIABLE] == SymbolTable::NONE) {
+            fresh.push_back(arg & ~VARIABLE);
+        }
+    }
+
+    const Rounds rounds = state.rounds[step];
+    for (uint32_t index : *candidates) {
+        const StoredFact& fact = facts_[index];
+        if (fact.arity != arity || !fact.value.isTrue(0.5) ||
+            (rounds == Rounds::Before && fact.trueSince >= state.round) ||
+            (rounds == Rounds::At && fact.trueSince != state.round) ||
+            (rounds == Rounds::UpTo && fact.trueSince > state.round)) {
+            continue;
+        }
+
+        const uint32_t* args = &factArgs_[fact.firstArg];
+        bool match = true;
+        for (uint32_t i = 0; i < arity && match; ++i) {
+            const uint32_t arg = atom.args[i];
+            if (!(arg & VARIABLE)) {
+                match = arg == args[i];
+            } else if (state.slots[arg & ~VARIABLE] == SymbolTable::NONE) {
+                state.slots[arg & ~VARIABLE] = args[i];
+            } else {
+                match = state.slots[arg & ~VARIABLE] == args[i];
+            }
+        }
+        if (match) {
+            join(state, step + 1);
+        }
+        for (uint32_t slot : fresh) {
+            state.slots[slot] = SymbolTable::NONE;
+        }
+    }
+}
+
+bool TensorLogicReasoner::holds(const Join& state) const {
+    const CompiledRule& rule = *state.rule;
+    std::vector<uint32_t> args;
+    for (const Atom& atom : rule.negative) {
+        args.clear();
+        for (uint32_t arg : atom.args) {
+            args.push_back((arg & VARIABLE) ? state.slots[arg & ~VARIABLE] : arg);
+        }
+        const uint32_t index = findFact(atom.predicate, args.data(),
+                                        static_cast<uint32_t>(args.size()));
+        if (index != NEVER && facts_[index].value.isTrue(0.5)) {
+            return false;
+        }
+    }
+    if (rule.filters.empty()) {
+        return true;
+    }
+
+    Binding binding;
+    for (size_t slot = 0; slot < rule.variables.size(); ++slot) {
+        if (state.slots[slot] != SymbolTable::NONE) {
+            binding[rule.variables[slot]] = Term::constant(symbols_.name(state.slots[slot]));
+        }
+    }
+    for (size_t i : rule.filters) {
+        LogicalValue result;
+        if (!matchFormula(state.source->premises[i], binding, result) ||
+            !result.isTrue(0.5)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::optional<LogicalValue> TensorLogicReasoner::backwardChain(const Formula& goal,
                                                                int maxDepth) {
     if (maxDepth <= 0) return std::nullopt;
@@ -542,9 +1043,12 @@ LogicalValue TensorLogicReasoner::neuralInfer(const std::string& query) {
     double weightSum = 0.0;
 
     for (const auto& [entity, similarity] : similar) {
-        auto range = entityIndex_.equal_range(entity);
-        for (auto it = range.first; it != range.second; ++it) {
-            const auto& fact = facts_[it->second];
+        auto it = entityIndex_.find(symbols_.find(entity));
+        if (it == entityIndex_.end()) {
+            continue;
+        }
+        for (uint32_t index : it->second) {
+            const auto& fact = facts_[index];
             totalEvidence += fact.value.truth * similarity;
             weightSum += similarity;
         }
@@ -559,18 +1063,27 @@ LogicalValue TensorLogicReasoner::neuralInfer(const std::string& query) {
 
 std::vector<Fact> TensorLogicReasoner::getFactsAbout(const std::string& entity) const {
     std::vector<Fact> results;
-    auto range = entityIndex_.equal_range(entity);
-    for (auto it = range.first; it != range.second; ++it) {
-        results.push_back(facts_[it->second]);
+    auto it = entityIndex_.find(symbols_.find(entity));
+    if (it != entityIndex_.end()) {
+        for (uint32_t index : it->second) {
+            results.push_back(toFact(index));
+        }
     }
     return results;
 }
 
 void TensorLogicReasoner::clear() {
+    symbols_.clear();
     facts_.clear();
+    factArgs_.clear();
     rules_.clear();
+    compiled_.clear();
     predicateIndex_.clear();
+    argIndex_.clear();
     entityIndex_.clear();
+    factLookup_.clear();
+    round_ = 0;
+    rulesChained_ = 0;
 }
 
 bool TensorLogicReasoner::matchFormula(const Formula& formula,
@@ -579,19 +1092,18 @@ bool TensorLogicReasoner::matchFormula(const Formula& formula,
     switch (formula.type) {
         case Formula::Type::Atomic: {
             // Match predicate against facts
-            std::vector<std::string> args;
+            const uint32_t pred = symbols_.find(formula.predicate.name);
+            std::vector<uint32_t> args;
             for (const auto& arg : formula.predicate.arguments) {
-                if (arg.type == Term::Type::Variable) {
-                    if (binding.count(arg.name)) {
-                        args.push_back(std::get<std::string>(binding.at(arg.name).value));
-                    } else {
-                        return false;  // Unbound variable
-                    }
-                } else if (arg.type == Term::Type::Constant) {
-                    args.push_back(std::get<std::string>(arg.value));
+                const uint32_t symbol = symbolOf(arg, binding);
+                if (symbol == SymbolTable::NONE) {
+                    return false;  // Unbound variable or unknown name
                 }
+                args.push_back(symbol);
             }
-            result = queryFact(formula.predicate.name, args);
+            const uint32_t index = pred == SymbolTable::NONE ? NEVER :
+                findFact(pred, args.data(), static_cast<uint32_t>(args.size()));
+            result = index != NEVER ? facts_[index].value : LogicalValue(0.0, 0.0);
             return result.confidence > 0;
         }
 
@@ -630,8 +1142,40 @@ bool TensorLogicReasoner::matchFormula(const Formula& formula,
 
 std::vector<Binding> TensorLogicReasoner::findBindings(const Term& pattern) const {
     std::vector<Binding> bindings;
+    const uint32_t pred = symbols_.find(pattern.name);
+    auto it = predicateIndex_.find(pred);
+    if (it == predicateIndex_.end()) {
+        return bindings;
+    }
+
     // Find all possible variable bindings for pattern
-    // ... (implementation)
+    const uint32_t arity = static_cast<uint32_t>(pattern.arguments.size());
+    for (uint32_t index : it->second) {
+        const StoredFact& fact = facts_[index];
+        if (fact.arity != arity || !fact.value.isTrue(0.5)) {
+            continue;
+        }
+        Binding binding;
+        bool match = true;
+        for (uint32_t i = 0; i < arity && match; ++i) {
+            const Term& arg = pattern.arguments[i];
+            const std::string& value = symbols_.name(factArgs_[fact.firstArg + i]);
+            if (arg.type == Term::Type::Variable) {
+                auto bound = binding.find(arg.name);
+                if (bound == binding.end()) {
+                    binding[arg.name] = Term::constant(value);
+                } else {
+                    match = std::get<std::string>(bound->second.value) == value;
+                }
+            } else {
+                match = std::holds_alternative<std::string>(arg.value) &&
+                        std::get<std::string>(arg.value) == value;
+            }
+        }
+        if (match) {
+            bindings.push_back(std::move(binding));
+        }
+    }
     return bindings;
 }
 
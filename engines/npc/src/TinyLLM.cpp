@@ -7,11 +7,17 @@
  */
 
 #include "llm/TinyLLM.h"
+#include "llm/ModelFile.h"
+#include "llm/TensorKernels.h"
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cmath>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <regex>
@@ -25,15 +31,13 @@ namespace LLM {
 //=============================================================================
 
 std::string NPCContext::toSystemPrompt() const {
+    return (prefix ? prefix->text : personaPrompt()) + situationPrompt();
+}
+
+std::string NPCContext::personaPrompt() const {
     std::ostringstream ss;
     ss << "You are " << name << ", a " << occupation << " in a medieval fantasy world.\n";
     ss << "Personality: " << personality << "\n";
-    ss << "Current mood: " << currentMood << "\n";
-    ss << "Location: " << location << "\n";
-    
-    if (!recentEvents.empty()) {
-        ss << "Recent events: " << recentEvents << "\n";
-    }
     
     if (!knownFacts.empty()) {
         ss << "You know these facts:\n";
@@ -42,9 +46,21 @@ std::string NPCContext::toSystemPrompt() const {
         }
     }
     
-    ss << "\nRespond in character as " << name << ". ";
+    ss << "Respond in character as " << name << ". ";
     ss << "Keep responses concise (1-3 sentences). ";
-    ss << "Match your personality and current mood in your tone.";
+    ss << "Match your personality and current mood in your tone.\n";
+    
+    return ss.str();
+}
+
+std::string NPCContext::situationPrompt() const {
+    std::ostringstream ss;
+    ss << "Current mood: " << currentMood << "\n";
+    ss << "Location: " << location;
+    
+    if (!recentEvents.empty()) {
+        ss << "\nRecent events: " << recentEvents;
+    }
     
     return ss.str();
 }
@@ -155,6 +171,15 @@ private:
     }
 };
 
+std::shared_ptr<const PromptPrefix> PromptPrefix::make(std::string text) {
+    // The vocabulary is fixed, so every TinyLLM tokenizes alike
+    static const SimpleTokenizer tokenizer;
+    auto prefix = std::make_shared<PromptPrefix>();
+    prefix->tokens = tokenizer.encode(text);
+    prefix->text = std::move(text);
+    return prefix;
+}
+
 //=============================================================================
 // Simple Neural Network Components
 //=============================================================================
@@ -163,8 +188,9 @@ class SimpleMatrix {
 public:
     SimpleMatrix(int rows, int cols) : rows_(rows), cols_(cols), data_(rows * cols, 0.0f) {}
     
-    float& at(int r, int c) { return data_[r * cols_ + c]; }
-    float at(int r, int c) const { return data_[r * cols_ + c]; }
+    // Weights held elsewhere, such as in a mapped model file
+    explicit SimpleMatrix(const Kernels::Weights& weights)
+        : rows_(weights.rows), cols_(weights.cols), external_(weights) {}
     
     int rows() const { return rows_; }
     int cols() const { return cols_; }
@@ -177,19 +203,61 @@ public:
         }
     }
     
-    std::vector<float> multiply(const std::vector<float>& vec) const {
-        std::vector<float> result(rows_, 0.0f);
-        for (int i = 0; i < rows_; ++i) {
-            for (int j = 0; j < cols_; ++j) {
-                result[i] += at(i, j) * vec[j];
-            }
+    Kernels::Weights weights() const {
+        if (external_.data) {
+            return external_;
         }
-        return result;
+        Kernels::Weights w;
+        w.data = data_.data();
+        w.rows = rows_;
+        w.cols = cols_;
+        return w;
+    }
+    
+    // Row r as floats, in out
+    void getRow(int r, float* out) const {
+        Kernels::dequantizeRow(weights(), r, out);
+    }
+    
+    // out = M vec, with out holding rows() floats
+    void multiply(const float* vec, float* out) const {
+        Kernels::gemv(weights(), vec, out);
+    }
+    
+    // The same for n vectors packed one after another in vecs
+    void multiplyBatch(const float* vecs, int n, float* out) const {
+        Kernels::gemm(vecs, n, weights(), out);
     }
 
 private:
     int rows_, cols_;
     std::vector<float> data_;
+    Kernels::Weights external_;
+};
+
+// Keys and values of the tokens seen so far in one conversation, for
+// each layer, so that each new token only computes its own
+struct KVCache {
+    std::vector<int> tokens;
+    std::vector<std::vector<float>> keys, values;
+    
+    int length() const { return static_cast<int>(tokens.size()); }
+    
+    // Forget everything after the first length tokens
+    void truncate(int length, int dim) {
+        tokens.resize(length);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys[i].resize(static_cast<size_t>(length) * dim);
+            values[i].resize(static_cast<size_t>(length) * dim);
+        }
+    }
+};
+
+// Working buffers for running the layers, grown to the largest batch and
+// context. They are kept apart from the layers, so that every TinyLLM
+// sharing a model has its own.
+struct LayerScratch {
+    std::vector<float> q, k, v, out, scores, h;
 };
 
 // Simple attention mechanism
@@ -204,31 +272,114 @@ public:
         wo_.randomize();
     }
     
-    std::vector<float> forward(const std::vector<float>& x) {
+    SimpleAttention(const SimpleMatrix& wq, const SimpleMatrix& wk,
+                    const SimpleMatrix& wv, const SimpleMatrix& wo, int heads = 4)
+        : dim_(wq.rows()), heads_(heads), headDim_(wq.rows() / heads),
+          wq_(wq), wk_(wk), wv_(wv), wo_(wo) {}
+    
+    std::vector<const SimpleMatrix*> matrices() const {
+        return {&wq_, &wk_, &wv_, &wo_};
+    }
+    
+    // Runs n vectors of dim floats, the tokens at pos onwards, through the
+    // layer in place. keys and values hold those of the tokens before pos,
+    // and have the new tokens' added.
+    void forward(float* x, int n, int pos,
+                 std::vector<float>& keys, std::vector<float>& values,
+                 LayerScratch& s) const {
+        const size_t size = static_cast<size_t>(n) * dim_;
+        const size_t start = static_cast<size_t>(pos) * dim_;
+        reserve(n, pos + n, s);
+        keys.resize(start + size);
+        values.resize(start + size);
+        
         // Simplified single-head attention for demo
-        auto q = wq_.multiply(x);
-        auto k = wk_.multiply(x);
-        auto v = wv_.multiply(x);
+        wq_.multiplyBatch(x, n, s.q.data());
+        wk_.multiplyBatch(x, n, &keys[start]);
+        wv_.multiplyBatch(x, n, &values[start]);
         
-        // Self-attention (simplified)
-        float score = 0.0f;
-        for (int i = 0; i < dim_; ++i) {
-            score += q[i] * k[i];
+        // Causal self-attention: each token looks at itself and those
+        // before it, whose keys and values are already cached
+        for (int t = 0; t < n; ++t) {
+            const size_t at = static_cast<size_t>(t) * dim_;
+            attend(&s.q[at], pos + t + 1, keys.data(), values.data(), &s.out[at], s);
         }
-        score /= std::sqrt(static_cast<float>(dim_));
-        float attn = 1.0f / (1.0f + std::exp(-score)); // Sigmoid approximation
         
-        std::vector<float> out(dim_);
-        for (int i = 0; i < dim_; ++i) {
-            out[i] = attn * v[i];
+        wo_.multiplyBatch(s.out.data(), n, x);
+    }
+    
+    // Runs n vectors of dim floats through the layer in place, each the
+    // next token of a different conversation. Their keys and values are
+    // added to this layer's in caches[t].
+    void forwardSteps(float* x, int n, KVCache* const* caches, int layer,
+                      LayerScratch& s) const {
+        int longest = 0;
+        for (int t = 0; t < n; ++t) {
+            longest = std::max(longest, caches[t]->length() + 1);
         }
+        reserve(n, longest, s);
+        
+        wq_.multiplyBatch(x, n, s.q.data());
+        wk_.multiplyBatch(x, n, s.k.data());
+        wv_.multiplyBatch(x, n, s.v.data());
         
-        return wo_.multiply(out);
+        for (int t = 0; t < n; ++t) {
+            const size_t at = static_cast<size_t>(t) * dim_;
+            std::vector<float>& keys = caches[t]->keys[layer];
+            std::vector<float>& values = caches[t]->values[layer];
+            keys.insert(keys.end(), &s.k[at], &s.k[at] + dim_);
+            values.insert(values.end(), &s.v[at], &s.v[at] + dim_);
+            attend(&s.q[at], static_cast<int>(keys.size() / dim_),
+                   keys.data(), values.data(), &s.out[at], s);
+        }
+        
+        wo_.multiplyBatch(s.out.data(), n, x);
     }
 
 private:
     int dim_, heads_, headDim_;
     SimpleMatrix wq_, wk_, wv_, wo_;
+    
+    void reserve(int n, int length, LayerScratch& s) const {
+        const size_t size = static_cast<size_t>(n) * dim_;
+        if (s.q.size() < size) {
+            s.q.resize(size);
+            s.k.resize(size);
+            s.v.resize(size);
+            s.out.resize(size);
+        }
+        if (s.scores.size() < static_cast<size_t>(length)) {
+            s.scores.resize(length);
+        }
+    }
+    
+    // out = the values of the first len tokens, weighted by how well their
+    // keys match q
+    void attend(const float* q, int len, const float* keys, const float* values,
+                float* out, LayerScratch& s) const {
+        std::vector<float>& scores = s.scores;
+        Kernels::gemv(keys, len, dim_, q, scores.data());
+        
+        const float scale = 1.0f / std::sqrt(static_cast<float>(dim_));
+        float maxScore = scores[0];
+        for (int j = 1; j < len; ++j) {
+            maxScore = std::max(maxScore, scores[j]);
+        }
+        float sum = 0.0f;
+        for (int j = 0; j < len; ++j) {
+            scores[j] = std::exp((scores[j] - maxScore) * scale);
+            sum += scores[j];
+        }
+        
+        std::fill(out, out + dim_, 0.0f);
+        for (int j = 0; j < len; ++j) {
+            const float p = scores[j] / sum;
+            const float* v = &values[static_cast<size_t>(j) * dim_];
+            for (int i = 0; i < dim_; ++i) {
+                out[i] += p * v[i];
+            }
+        }
+    }
 };
 
 // Simple feed-forward network
@@ -241,15 +392,28 @@ public:
         w2_.randomize();
     }
     
-    std::vector<float> forward(const std::vector<float>& x) {
-        auto h = w1_.multiply(x);
+    SimpleFeedForward(const SimpleMatrix& w1, const SimpleMatrix& w2)
+        : dim_(w1.cols()), hiddenDim_(w1.rows()), w1_(w1), w2_(w2) {}
+    
+    std::vector<const SimpleMatrix*> matrices() const {
+        return {&w1_, &w2_};
+    }
+    
+    // Runs n vectors of dim floats through the layer in place
+    void forward(float* x, int n, LayerScratch& s) const {
+        const size_t size = static_cast<size_t>(n) * hiddenDim_;
+        if (s.h.size() < size) {
+            s.h.resize(size);
+        }
+        w1_.multiplyBatch(x, n, s.h.data());
         
         // GELU activation
-        for (auto& v : h) {
+        for (size_t i = 0; i < size; ++i) {
+            float& v = s.h[i];
             v = 0.5f * v * (1.0f + std::tanh(std::sqrt(2.0f / 3.14159f) * (v + 0.044715f * v * v * v)));
         }
         
-        return w2_.multiply(h);
+        w2_.multiplyBatch(s.h.data(), n, x);
     }
 
 private:
@@ -257,6 +421,95 @@ private:
     SimpleMatrix w1_, w2_;
 };
 
+// The weights of a model. Never changed once made, so any number of
+// TinyLLM instances, on any threads, can share one.
+struct Model {
+    SimpleMatrix embeddings{0, 0};
+    SimpleMatrix outputProj{0, 0};
+    std::vector<std::unique_ptr<SimpleAttention>> attentionLayers;
+    std::vector<std::unique_ptr<SimpleFeedForward>> ffnLayers;
+    int dim = 0;
+    int hiddenDim = 0;
+    ModelFile file;     // Holds the weights, if they were loaded
+    
+    // Random weights of the given sizes, for demo use
+    static std::unique_ptr<Model> random(int vocabSize, int dim, int numLayers) {
+        auto model = std::make_unique<Model>();
+        model->dim = dim;
+        model->hiddenDim = dim * 4;
+        model->embeddings = SimpleMatrix(vocabSize, dim);
+        model->embeddings.randomize();
+        model->outputProj = SimpleMatrix(vocabSize, dim);
+        model->outputProj.randomize();
+        for (int i = 0; i < numLayers; ++i) {
+            model->attentionLayers.push_back(std::make_unique<SimpleAttention>(dim));
+            model->ffnLayers.push_back(std::make_unique<SimpleFeedForward>(dim));
+        }
+        return model;
+    }
+    
+    // The weights in a model file, which stays mapped
+    static std::unique_ptr<Model> load(const std::string& path, int vocabSize) {
+        auto model = std::make_unique<Model>();
+        ModelFile& file = model->file;
+        if (!file.open(path) ||
+            file.shape().vocabSize != static_cast<uint32_t>(vocabSize)) {
+            return nullptr;
+        }
+        model->dim = static_cast<int>(file.shape().dim);
+        model->hiddenDim = static_cast<int>(file.shape().hiddenDim);
+        
+        const auto& tensors = file.tensors();
+        model->embeddings = SimpleMatrix(tensors[0]);
+        model->outputProj = SimpleMatrix(tensors[1]);
+        for (size_t i = 2; i + 6 <= tensors.size(); i += 6) {
+            model->attentionLayers.push_back(std::make_unique<SimpleAttention>(
+                SimpleMatrix(tensors[i]), SimpleMatrix(tensors[i + 1]),
+                SimpleMatrix(tensors[i + 2]), SimpleMatrix(tensors[i + 3])));
+            model->ffnLayers.push_back(std::make_unique<SimpleFeedForward>(
+                SimpleMatrix(tensors[i + 4]), SimpleMatrix(tensors[i + 5])));
+        }
+        return model;
+    }
+    
+    // Every weight matrix, in model file order
+    std::vector<Kernels::Weights> weights() const {
+        std::vector<Kernels::Weights> all = {embeddings.weights(), outputProj.weights()};
+        for (size_t i = 0; i < attentionLayers.size(); ++i) {
+            for (const SimpleMatrix* m : attentionLayers[i]->matrices()) {
+                all.push_back(m->weights());
+            }
+            for (const SimpleMatrix* m : ffnLayers[i]->matrices()) {
+                all.push_back(m->weights());
+            }
+        }
+        return all;
+    }
+};
+
+// The model for key, made by create unless a TinyLLM is already using it.
+// Each model is freed with its last user.
+static std::shared_ptr<const Model> sharedModel(
+    const std::string& key, const std::function<std::unique_ptr<Model>()>& create) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const Model>> models;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = models.begin(); it != models.end();) {
+        it = it->second.expired() ? models.erase(it) : std::next(it);
+    }
+    
+    std::shared_ptr<const Model> model = models[key].lock();
+    if (!model) {
+        model = create();
+        if (!model) {
+            models.erase(key);
+            return nullptr;
+        }
+        models[key] = model;
+    }
+    return model;
+}
+
 //=============================================================================
 // TinyLLM Implementation
 //=============================================================================
@@ -266,11 +519,49 @@ struct TinyLLM::Impl {
     bool ready = false;
     SimpleTokenizer tokenizer;
     
-    // Simple transformer layers
-    std::vector<std::unique_ptr<SimpleAttention>> attentionLayers;
-    std::vector<std::unique_ptr<SimpleFeedForward>> ffnLayers;
-    SimpleMatrix embeddings{0, 0};
-    SimpleMatrix outputProj{0, 0};
+    // Shared with every other TinyLLM using the same model
+    std::shared_ptr<const Model> model;
+    int dim = 0;
+    LayerScratch scratch;
+    
+    // Prompt tokens go through the layers this many at a time
+    static const int PROMPT_BATCH = 32;
+    
+    // A conversation with one NPC. Its prompts all start with the same
+    // system prompt and history, so only what follows them is run.
+    struct Session {
+        std::string npcName;
+        KVCache cache;
+        uint64_t lastUsed = 0;
+    };
+    static const size_t MAX_SESSIONS = 4;
+    std::vector<Session> sessions;
+    uint64_t useCounter = 0;
+    
+    // A response being generated, one of up to MAX_SESSIONS at a time
+    struct Generation {
+        size_t index = 0;
+        const DialogueRequest* request = nullptr;
+        KVCache* cache = nullptr;
+        int promptTokens = 0;
+        int maxTokens = 0;
+        float temperature = 0.0f;
+        std::vector<int> tokens;
+        std::string text;
+        const StreamCallback* stream = nullptr;    // Given each token, if set
+        
+        bool cancelled() const {
+            return request->cancelled && *request->cancelled;
+        }
+    };
+    
+    // Working buffers, sized once so generating allocates nothing. The
+    // hidden states and logits hold a row for each generation.
+    std::vector<float> batch;
+    std::vector<float> hidden;
+    std::vector<float> logits;
+    std::vector<float> probs;
+    std::vector<KVCache*> stepCaches;
     
     std::mt19937 rng{std::random_device{}()};
     
@@ -296,33 +587,193 @@ struct TinyLLM::Impl {
         "Perhaps you should ask someone else about that."
     };
     
-    void initialize(int vocabSize, int dim, int numLayers) {
-        embeddings = SimpleMatrix(vocabSize, dim);
-        embeddings.randomize();
+    // Use a model, or none, with buffers to suit it
+    void use(std::shared_ptr<const Model> newModel, int vocabSize) {
+        sessions.clear();
+        model = std::move(newModel);
+        dim = model ? model->dim : 0;
+        scratch = LayerScratch();
+        batch.assign(static_cast<size_t>(PROMPT_BATCH) * dim, 0.0f);
+        hidden.assign(MAX_SESSIONS * dim, 0.0f);
+        logits.assign(MAX_SESSIONS * vocabSize, 0.0f);
+        probs.assign(vocabSize, 0.0f);
+        // Generations hold pointers to their sessions' caches
+        sessions.reserve(MAX_SESSIONS);
+        stepCaches.reserve(MAX_SESSIONS);
+    }
+    
+    void initialize(int vocabSize, int embedDim, int numLayers) {
+        const std::string key = "random:" + std::to_string(vocabSize) + "x" +
+            std::to_string(embedDim) + "x" + std::to_string(numLayers);
+        use(sharedModel(key, [&] {
+            return Model::random(vocabSize, embedDim, numLayers);
+        }), vocabSize);
+    }
+    
+    // Use the weights in a model file
+    bool load(const std::string& path, int vocabSize) {
+        const std::string key = "file:" + std::to_string(vocabSize) + ":" + path;
+        use(sharedModel(key, [&] {
+            return Model::load(path, vocabSize);
+        }), vocabSize);
+        return model != nullptr;
+    }
+    
+    void embed(int token, float* out) const {
+        model->embeddings.getRow(token % model->embeddings.rows(), out);
+    }
+    
+    // Runs n tokens, already embedded in x, through every layer in place
+    // and adds them to cache
+    void runLayers(const int* tokens, float* x, int n, KVCache& cache) {
+        const int pos = cache.length();
+        for (size_t i = 0; i < model->attentionLayers.size(); ++i) {
+            model->attentionLayers[i]->forward(x, n, pos, cache.keys[i],
+                                               cache.values[i], scratch);
+            model->ffnLayers[i]->forward(x, n, scratch);
+        }
+        cache.tokens.insert(cache.tokens.end(), tokens, tokens + n);
+    }
+    
+    // Runs the tokens, the next of a different conversation in each row of
+    // x, through every layer in place and adds them to caches
+    void runSteps(const int* tokens, float* x, int n, KVCache* const* caches) {
+        for (size_t i = 0; i < model->attentionLayers.size(); ++i) {
+            model->attentionLayers[i]->forwardSteps(x, n, caches, static_cast<int>(i),
+                                                    scratch);
+            model->ffnLayers[i]->forward(x, n, scratch);
+        }
+        for (int t = 0; t < n; ++t) {
+            caches[t]->tokens.push_back(tokens[t]);
+        }
+    }
+    
+    // Runs a prompt through the layers, leaving the output for its last
+    // token in out. Only the tokens after what cache already holds need
+    // running, but at least the last one is, to get its output.
+    // @return false if g was cancelled first
+    bool prefill(const std::vector<int>& tokens, KVCache& cache, float* out,
+                 const Generation& g) {
+        const size_t shared = std::mismatch(
+            cache.tokens.begin(),
+            cache.tokens.begin() + std::min(cache.tokens.size(), tokens.size()),
+            tokens.begin()).first - cache.tokens.begin();
+        const size_t reuse = tokens.empty() ? 0 : std::min(shared, tokens.size() - 1);
+        cache.truncate(static_cast<int>(reuse), dim);
         
-        outputProj = SimpleMatrix(vocabSize, dim);
-        outputProj.randomize();
+        std::fill(out, out + dim, 0.0f);
+        for (size_t start = reuse; start < tokens.size(); start += PROMPT_BATCH) {
+            if (g.cancelled()) {
+                return false;
+            }
+            const int n = static_cast<int>(
+                std::min(tokens.size() - start, static_cast<size_t>(PROMPT_BATCH)));
+            for (int t = 0; t < n; ++t) {
+                embed(tokens[start + t], &batch[static_cast<size_t>(t) * dim]);
+            }
+            runLayers(&tokens[start], batch.data(), n, cache);
+            std::copy_n(&batch[static_cast<size_t>(n - 1) * dim], dim, out);
+        }
+        return true;
+    }
+    
+    // Adds a sampled token to g
+    // @return false once g is finished, without adding it
+    bool accept(Generation& g, int token) {
+        if (token == 3) {   // </s>
+            return false;
+        }
+        g.tokens.push_back(token);
+        const size_t length = g.text.size();
+        g.text += tokenizer.decode({token});
+        if (g.stream) {
+            (*g.stream)(g.text.substr(length));
+        }
+        for (const auto& stop : g.request->stopSequences) {
+            if (!stop.empty() && g.text.size() >= stop.size() &&
+                g.text.compare(g.text.size() - stop.size(), stop.size(), stop) == 0) {
+                g.text.erase(g.text.size() - stop.size());
+                return false;
+            }
+        }
+        return static_cast<int>(g.tokens.size()) < g.maxTokens;
+    }
+    
+    DialogueResult finish(const Generation& g) {
+        DialogueResult result;
+        result.wasGenerated = true;
+        result.confidence = 0.7f;
+        result.tokensUsed = g.promptTokens + static_cast<int>(g.tokens.size());
         
-        for (int i = 0; i < numLayers; ++i) {
-            attentionLayers.push_back(std::make_unique<SimpleAttention>(dim));
-            ffnLayers.push_back(std::make_unique<SimpleFeedForward>(dim));
+        // If generated response is too short or gibberish, use fallback
+        if (g.text.length() < 10 || g.text.find_first_not_of(" \n\t") == std::string::npos) {
+            result.response = generateFallback(*g.request);
+            result.wasGenerated = false;
+            result.confidence = 0.5f;
+        } else {
+            result.response = g.text;
         }
+        
+        // Detect emotion from response
+        result.emotion = "neutral";
+        std::string lower = result.response;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        
+        if (lower.find("happy") != std::string::npos || 
+            lower.find("wonderful") != std::string::npos ||
+            lower.find("great") != std::string::npos) {
+            result.emotion = "joy";
+        } else if (lower.find("sorry") != std::string::npos ||
+                   lower.find("sad") != std::string::npos) {
+            result.emotion = "sadness";
+        } else if (lower.find("angry") != std::string::npos ||
+                   lower.find("furious") != std::string::npos) {
+            result.emotion = "anger";
+        } else if (lower.find("afraid") != std::string::npos ||
+                   lower.find("scared") != std::string::npos ||
+                   lower.find("danger") != std::string::npos) {
+            result.emotion = "fear";
+        }
+        
+        return result;
     }
     
-    std::vector<float> embed(int token) {
-        std::vector<float> emb(embeddings.cols());
-        for (int i = 0; i < embeddings.cols(); ++i) {
-            emb[i] = embeddings.at(token % embeddings.rows(), i);
+    // The session for an NPC, taking the place of the least recently used
+    // one if it has none
+    Session& session(const std::string& npcName) {
+        Session* found = nullptr;
+        for (auto& s : sessions) {
+            if (s.npcName == npcName) {
+                found = &s;
+                break;
+            }
         }
-        return emb;
+        if (!found) {
+            if (sessions.size() < MAX_SESSIONS) {
+                sessions.emplace_back();
+                found = &sessions.back();
+            } else {
+                found = &*std::min_element(sessions.begin(), sessions.end(),
+                    [](const Session& a, const Session& b) {
+                        return a.lastUsed < b.lastUsed;
+                    });
+            }
+            found->npcName = npcName;
+            found->cache.tokens.clear();
+            found->cache.keys.resize(model->attentionLayers.size());
+            found->cache.values.resize(model->attentionLayers.size());
+            found->cache.truncate(0, dim);
+        }
+        found->lastUsed = ++useCounter;
+        return *found;
     }
     
-    int sampleToken(const std::vector<float>& logits, float temperature) {
-        std::vector<float> probs(logits.size());
-        float maxLogit = *std::max_element(logits.begin(), logits.end());
+    // Samples from a row of logits, one for each token in the vocabulary
+    int sampleToken(const float* logits, float temperature) {
+        float maxLogit = *std::max_element(logits, logits + probs.size());
         
         float sum = 0.0f;
-        for (size_t i = 0; i < logits.size(); ++i) {
+        for (size_t i = 0; i < probs.size(); ++i) {
             probs[i] = std::exp((logits[i] - maxLogit) / std::max(temperature, 0.1f));
             sum += probs[i];
         }
@@ -391,9 +842,13 @@ TinyLLM::~TinyLLM() = default;
 bool TinyLLM::initialize(const LLMConfig& config) {
     impl_->config = config;
     
-    // Initialize with small dimensions for demo
-    // In production, this would load weights from the GGUF model
     int vocabSize = impl_->tokenizer.vocabSize();
+    if (!config.modelPath.empty()) {
+        impl_->ready = impl_->load(config.modelPath, vocabSize);
+        return impl_->ready;
+    }
+    
+    // Without a model, use random weights of small dimensions for demo
     int dim = 256;  // Small embedding dimension
     int numLayers = 4;
     
@@ -403,121 +858,174 @@ bool TinyLLM::initialize(const LLMConfig& config) {
     return true;
 }
 
+bool TinyLLM::save(const std::string& filename, int bits) const {
+    if (!impl_->ready || (bits != 4 && bits != 8 && bits != 32)) {
+        return false;
+    }
+    ModelFile::Shape shape;
+    const Model& model = *impl_->model;
+    shape.vocabSize = static_cast<uint32_t>(model.embeddings.rows());
+    shape.dim = static_cast<uint32_t>(model.dim);
+    shape.hiddenDim = static_cast<uint32_t>(model.hiddenDim);
+    shape.layers = static_cast<uint32_t>(model.attentionLayers.size());
+    const Kernels::WeightType type = bits == 4 ? Kernels::WeightType::Q4
+                                   : bits == 8 ? Kernels::WeightType::Q8
+                                               : Kernels::WeightType::F32;
+    return ModelFile::write(filename, shape, type, model.weights());
+}
+
 bool TinyLLM::isReady() const {
     return impl_->ready;
 }
 
 DialogueResult TinyLLM::generateDialogue(const DialogueRequest& request) {
     DialogueResult result;
-    result.wasGenerated = true;
-    result.confidence = 0.7f;
-    result.tokensUsed = 0;
-    
+    runBatch({&request}, [&result](size_t, const DialogueResult& r) {
+        result = r;
+    });
+    return result;
+}
+
+void TinyLLM::generateBatch(const std::vector<DialogueRequest>& requests,
+                            BatchCallback callback) {
+    std::vector<const DialogueRequest*> pointers;
+    pointers.reserve(requests.size());
+    for (const auto& request : requests) {
+        pointers.push_back(&request);
+    }
+    runBatch(pointers, callback);
+}
+
+void TinyLLM::runBatch(const std::vector<const DialogueRequest*>& requests,
+                       const BatchCallback& callback,
+                       const StreamCallback* stream) {
     if (!impl_->ready) {
-        result.response = impl_->generateFallback(request);
-        result.wasGenerated = false;
-        result.confidence = 0.5f;
-        return result;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            DialogueResult result;
+            result.response = impl_->generateFallback(*requests[i]);
+            result.wasGenerated = false;
+            result.confidence = 0.5f;
+            result.tokensUsed = 0;
+            callback(i, result);
+        }
+        return;
     }
     
-    // Build the prompt
-    std::string prompt = buildPrompt(request);
-    
-    // Tokenize
-    auto tokens = impl_->tokenizer.encode(prompt);
-    result.tokensUsed = static_cast<int>(tokens.size());
-    
-    // Generate response
-    std::vector<int> generatedTokens;
-    std::vector<float> hidden(256, 0.0f);
-    
-    // Process input tokens
-    for (int token : tokens) {
-        auto emb = impl_->embed(token);
-        for (size_t i = 0; i < impl_->attentionLayers.size(); ++i) {
-            emb = impl_->attentionLayers[i]->forward(emb);
-            emb = impl_->ffnLayers[i]->forward(emb);
-        }
-        hidden = emb;
+    const int dim = impl_->dim;
+    const size_t vocab = impl_->probs.size();
+    std::vector<size_t> pending(requests.size());
+    for (size_t i = 0; i < pending.size(); ++i) {
+        pending[i] = i;
     }
     
-    // Generate new tokens
-    int maxNewTokens = std::min(impl_->config.maxTokens, 64);
-    for (int i = 0; i < maxNewTokens; ++i) {
-        // Compute logits
-        std::vector<float> logits(impl_->tokenizer.vocabSize());
-        for (int j = 0; j < impl_->tokenizer.vocabSize(); ++j) {
-            for (int k = 0; k < static_cast<int>(hidden.size()); ++k) {
-                logits[j] += impl_->outputProj.at(j, k) * hidden[k];
+    // Each round takes up to MAX_SESSIONS requests to different NPCs, as
+    // each NPC's conversation has its own session. The rest wait.
+    while (!pending.empty()) {
+        std::vector<Impl::Generation> round;
+        std::vector<size_t> waiting;
+        for (size_t i : pending) {
+            const std::string& name = requests[i]->npcContext.name;
+            const bool busy = std::any_of(round.begin(), round.end(),
+                [&name](const Impl::Generation& g) {
+                    return g.request->npcContext.name == name;
+                });
+            if (busy || round.size() == Impl::MAX_SESSIONS) {
+                waiting.push_back(i);
+                continue;
             }
+            round.emplace_back();
+            round.back().index = i;
+            round.back().request = requests[i];
+            round.back().stream = stream;
         }
+        pending.swap(waiting);
         
-        // Sample next token
-        int nextToken = impl_->sampleToken(logits, impl_->config.temperature);
-        
-        // Check for end token
-        if (nextToken == 3) break; // </s>
-        
-        generatedTokens.push_back(nextToken);
-        result.tokensUsed++;
+        // Run each prompt, leaving its output in its row of hidden
+        for (size_t k = 0; k < round.size(); ++k) {
+            Impl::Generation& g = round[k];
+            const DialogueRequest& request = *g.request;
+            g.maxTokens = std::min(request.maxTokens > 0 ? request.maxTokens
+                                                         : impl_->config.maxTokens, 64);
+            g.temperature = request.temperature >= 0.0f ? request.temperature
+                                                        : impl_->config.temperature;
+            
+            // A prefix ends in whitespace, so the rest tokenizes the same
+            // on its own
+            std::vector<int> tokens;
+            const auto& prefix = request.npcContext.prefix;
+            if (prefix) {
+                tokens = prefix->tokens;
+                const auto rest = impl_->tokenizer.encode(buildPrompt(request, false));
+                tokens.insert(tokens.end(), rest.begin(), rest.end());
+            } else {
+                tokens = impl_->tokenizer.encode(buildPrompt(request));
+            }
+            g.promptTokens = static_cast<int>(tokens.size());
+            
+            // Keep the end of a prompt too long for the context, leaving
+            // room to answer
+            const size_t maxPrompt = static_cast<size_t>(
+                std::max(impl_->config.contextSize - g.maxTokens, 1));
+            if (tokens.size() > maxPrompt) {
+                tokens.erase(tokens.begin(), tokens.end() - maxPrompt);
+            }
+            
+            g.cache = &impl_->session(request.npcContext.name).cache;
+            if (!impl_->prefill(tokens, *g.cache, &impl_->hidden[k * dim], g)) {
+                g.maxTokens = 0;
+            }
+        }
         
-        // Update hidden state
-        auto emb = impl_->embed(nextToken);
-        for (size_t j = 0; j < impl_->attentionLayers.size(); ++j) {
-            emb = impl_->attentionLayers[j]->forward(emb);
-            emb = impl_->ffnLayers[j]->forward(emb);
+        // Generate a token for every unfinished response at once, keeping
+        // their rows packed at the front of hidden
+        std::vector<Impl::Generation*> active;
+        for (auto& g : round) {
+            if (g.maxTokens > 0) {
+                active.push_back(&g);
+            } else {
+                callback(g.index, impl_->finish(g));
+            }
+        }
+        std::vector<int> next;
+        next.reserve(round.size());
+        while (!active.empty()) {
+            const int n = static_cast<int>(active.size());
+            impl_->model->outputProj.multiplyBatch(impl_->hidden.data(), n, impl_->logits.data());
+            
+            next.clear();
+            impl_->stepCaches.clear();
+            for (int k = 0; k < n; ++k) {
+                Impl::Generation& g = *active[k];
+                if (g.cancelled()) {
+                    callback(g.index, impl_->finish(g));
+                    continue;
+                }
+                const int token = impl_->sampleToken(&impl_->logits[k * vocab], g.temperature);
+                if (!impl_->accept(g, token)) {
+                    callback(g.index, impl_->finish(g));
+                    continue;
+                }
+                impl_->embed(token, &impl_->hidden[next.size() * dim]);
+                active[next.size()] = &g;
+                next.push_back(token);
+                impl_->stepCaches.push_back(g.cache);
+            }
+            active.resize(next.size());
+            if (!next.empty()) {
+                impl_->runSteps(next.data(), impl_->hidden.data(),
+                                static_cast<int>(next.size()), impl_->stepCaches.data());
+            }
         }
-        hidden = emb;
-    }
-    
-    // Decode response
-    std::string rawResponse = impl_->tokenizer.decode(generatedTokens);
-    
-    // If generated response is too short or gibberish, use fallback
-    if (rawResponse.length() < 10 || rawResponse.find_first_not_of(" \n\t") == std::string::npos) {
-        result.response = impl_->generateFallback(request);
-        result.wasGenerated = false;
-        result.confidence = 0.5f;
-    } else {
-        result.response = rawResponse;
-    }
-    
-    // Detect emotion from response
-    result.emotion = "neutral";
-    std::string lower = result.response;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    
-    if (lower.find("happy") != std::string::npos || 
-        lower.find("wonderful") != std::string::npos ||
-        lower.find("great") != std::string::npos) {
-        result.emotion = "joy";
-    } else if (lower.find("sorry") != std::string::npos ||
-               lower.find("sad") != std::string::npos) {
-        result.emotion = "sadness";
-    } else if (lower.find("angry") != std::string::npos ||
-               lower.find("furious") != std::string::npos) {
-        result.emotion = "anger";
-    } else if (lower.find("afraid") != std::string::npos ||
-               lower.find("scared") != std::string::npos ||
-               lower.find("danger") != std::string::npos) {
-        result.emotion = "fear";
     }
-    
-    return result;
 }
 
 DialogueResult TinyLLM::generateDialogueStreaming(
     const DialogueRequest& request,
     StreamCallback callback) {
-    
-    // For simplicity, generate full response then stream it
-    auto result = generateDialogue(request);
-    
-    // Stream tokens
-    for (char c : result.response) {
-        callback(std::string(1, c));
-    }
-    
+    DialogueResult result;
+    runBatch({&request}, [&result](size_t, const DialogueResult& r) {
+        result = r;
+    }, &callback);
     return result;
 }
 
@@ -623,15 +1131,25 @@ int TinyLLM::getTokenCount(const std::string& text) const {
 }
 
 void TinyLLM::clearContext() {
-    // Reset hidden state would go here
+    impl_->sessions.clear();
 }
 
 std::string TinyLLM::getModelInfo() const {
     std::ostringstream ss;
     ss << "TinyLLM v1.0\n";
     ss << "Vocab size: " << impl_->tokenizer.vocabSize() << "\n";
-    ss << "Embedding dim: 256\n";
-    ss << "Layers: 4\n";
+    ss << "Embedding dim: " << impl_->dim << "\n";
+    ss << "Layers: " << (impl_->model ? impl_->model->attentionLayers.size() : 0) << "\n";
+    if (impl_->model && impl_->model->file.isOpen()) {
+        const ModelFile& file = impl_->model->file;
+        static const char* const typeNames[] = {"float", "int8", "int4"};
+        ss << "Weights: " << typeNames[static_cast<int>(file.weightType())]
+           << ", " << file.size() / 1024 << " KB mapped\n";
+    }
+    if (impl_->model) {
+        ss << "Sharing weights with: " << impl_->model.use_count() - 1 << " others\n";
+    }
+    ss << "Kernels: " << Kernels::backendName() << "\n";
     ss << "Ready: " << (impl_->ready ? "yes" : "no");
     return ss.str();
 }
@@ -642,15 +1160,18 @@ void TinyLLM::setTemperature(float temp) {
 
 void TinyLLM::shutdown() {
     impl_->ready = false;
-    impl_->attentionLayers.clear();
-    impl_->ffnLayers.clear();
+    impl_->use(nullptr, 0);
 }
 
-std::string TinyLLM::buildPrompt(const DialogueRequest& request) const {
+std::string TinyLLM::buildPrompt(const DialogueRequest& request, bool withPrefix) const {
     std::ostringstream ss;
     
-    // System prompt
-    ss << request.npcContext.toSystemPrompt() << "\n\n";
+    // System prompt, leaving out the prefix if the caller has its tokens
+    if (withPrefix) {
+        ss << request.npcContext.toSystemPrompt() << "\n\n";
+    } else {
+        ss << request.npcContext.situationPrompt() << "\n\n";
+    }
     
     // Conversation history
     if (!request.history.empty()) {
@@ -699,6 +1220,7 @@ struct DialogueGenerator::Impl {
     float creativityThreshold = 0.6f;
     bool personalityProcessing = true;
     Stats stats;
+    int timedResponses = 0;     // Batches count requests before answering
     
     // Simple AIML-like patterns
     std::unordered_map<std::string, std::string> patterns;
@@ -717,6 +1239,38 @@ struct DialogueGenerator::Impl {
         patterns["time"] = "The hour grows late. Best be careful after dark.";
     }
     
+    // Fills in result if a pattern matches the request
+    bool answerPattern(const DialogueRequest& request, DialogueResult& result) {
+        std::string response = matchPattern(request.playerInput, request.npcContext);
+        if (response.empty()) {
+            return false;
+        }
+        result.response = response;
+        result.wasGenerated = false;
+        result.confidence = 0.9f;
+        stats.aimlResponses++;
+        return true;
+    }
+    
+    // Applies personality processing and counts the time taken since start
+    void finish(const DialogueRequest& request, DialogueResult& result,
+                std::chrono::high_resolution_clock::time_point start) {
+        if (personalityProcessing) {
+            result.response = PersonalityModifier::addEmotion(
+                result.response,
+                request.npcContext.currentMood,
+                0.5f
+            );
+        }
+        
+        auto endTime = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double>(endTime - start).count();
+        ++timedResponses;
+        stats.avgResponseTime = 
+            (stats.avgResponseTime * (timedResponses - 1) + elapsed) 
+            / timedResponses;
+    }
+    
     std::string matchPattern(const std::string& input, const NPCContext& ctx) {
         std::string lower = input;
         std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
@@ -763,42 +1317,60 @@ DialogueResult DialogueGenerator::generate(const DialogueRequest& request) {
     DialogueResult result;
     
     // Try pattern matching first
-    std::string patternResponse = impl_->matchPattern(
-        request.playerInput, request.npcContext);
-    
-    if (!patternResponse.empty()) {
-        result.response = patternResponse;
-        result.wasGenerated = false;
-        result.confidence = 0.9f;
-        impl_->stats.aimlResponses++;
-    } else if (impl_->llm && impl_->llm->isReady()) {
-        // Use LLM for creative response
-        result = impl_->llm->generateDialogue(request);
-        impl_->stats.llmResponses++;
-    } else {
-        // Fallback
-        result.response = "I'm not sure what to say about that.";
-        result.wasGenerated = false;
-        result.confidence = 0.3f;
-        impl_->stats.fallbackResponses++;
+    if (!impl_->answerPattern(request, result)) {
+        if (impl_->llm && impl_->llm->isReady()) {
+            // Use LLM for creative response
+            result = impl_->llm->generateDialogue(request);
+            impl_->stats.llmResponses++;
+        } else {
+            // Fallback
+            result.response = "I'm not sure what to say about that.";
+            result.wasGenerated = false;
+            result.confidence = 0.3f;
+            impl_->stats.fallbackResponses++;
+        }
     }
     
-    // Apply personality processing
-    if (impl_->personalityProcessing) {
-        result.response = PersonalityModifier::addEmotion(
-            result.response,
-            request.npcContext.currentMood,
-            0.5f
-        );
+    impl_->finish(request, result, startTime);
+    return result;
+}
+
+void DialogueGenerator::generateBatch(const std::vector<DialogueRequest>& requests,
+                                      BatchCallback callback) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const bool useLLM = impl_->llm && impl_->llm->isReady();
+    
+    // Answer what the patterns can straight away, and gather the rest
+    // for the LLM
+    std::vector<DialogueRequest> creative;
+    std::vector<size_t> creativeIndex;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        impl_->stats.totalRequests++;
+        DialogueResult result;
+        if (!impl_->answerPattern(requests[i], result)) {
+            if (useLLM) {
+                creative.push_back(requests[i]);
+                creativeIndex.push_back(i);
+                continue;
+            }
+            result.response = "I'm not sure what to say about that.";
+            result.wasGenerated = false;
+            result.confidence = 0.3f;
+            impl_->stats.fallbackResponses++;
+        }
+        impl_->finish(requests[i], result, startTime);
+        callback(i, result);
     }
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double elapsed = std::chrono::duration<double>(endTime - startTime).count();
-    impl_->stats.avgResponseTime = 
-        (impl_->stats.avgResponseTime * (impl_->stats.totalRequests - 1) + elapsed) 
-        / impl_->stats.totalRequests;
-    
-    return result;
+    if (!creative.empty()) {
+        impl_->llm->generateBatch(creative,
+            [&](size_t index, const DialogueResult& generated) {
+                DialogueResult result = generated;
+                impl_->stats.llmResponses++;
+                impl_->finish(creative[index], result, startTime);
+                callback(creativeIndex[index], result);
+            });
+    }
 }
 
 DialogueResult DialogueGenerator::generateCreative(const DialogueRequest& request) {
@@ -4,6 +4,7 @@
  */
 
 #include "urban/UrbanDynamics.h"
+#include "Job_system.h"
 #include <algorithm>
 #include <random>
 #include <cmath>
@@ -15,29 +16,101 @@ namespace Urban {
 
 static std::mt19937 rng(std::random_device{}());
 
+namespace {
+
+const uint8_t NO_ROAD = City::ROAD_REACH + 1;   // Distance past reach
+const float BASE_DESIRABILITY = 0.3f;
+const float ACCESS_WEIGHT = 0.4f;
+const float AMENITY_WEIGHT = 1.5f;              // Of the mean amenity around
+const int ROWS_PER_WORKER = 64;                 // Fewer aren't worth a thread
+
+// What a building lends each cell around it, good or bad
+float amenityOf(BuildingType type) {
+    switch (type) {
+        case BuildingType::Market:
+        case BuildingType::Fountain:
+        case BuildingType::Monument:
+            return 1.0f;
+        case BuildingType::Temple:
+        case BuildingType::Shrine:
+        case BuildingType::Library:
+        case BuildingType::School:
+        case BuildingType::Hospital:
+        case BuildingType::Well:
+            return 0.8f;
+        case BuildingType::Shop:
+        case BuildingType::Inn:
+        case BuildingType::Tavern:
+        case BuildingType::Bank:
+        case BuildingType::TownHall:
+        case BuildingType::Courthouse:
+            return 0.5f;
+        case BuildingType::Manor:
+        case BuildingType::Castle:
+            return 0.3f;
+        case BuildingType::Hovel:
+        case BuildingType::House:
+            return 0.1f;
+        case BuildingType::Barracks:
+            return -0.2f;
+        case BuildingType::Workshop:
+        case BuildingType::Smithy:
+        case BuildingType::Mill:
+        case BuildingType::Mine:
+        case BuildingType::Warehouse:
+        case BuildingType::Dock:
+            return -0.5f;
+        case BuildingType::Ruin:
+            return -0.6f;
+        default:
+            return 0.0f;
+    }
+}
+
+// Run work(begin, end) over [first, last) in runs of ROWS_PER_WORKER, shared
+// out between the job system's threads
+template <typename Work>
+void forRuns(const char* name, int first, int last, const Work& work) {
+    if (last <= first) return;
+    Job_system::get().parallel_for(name, first, last, ROWS_PER_WORKER,
+                                   [&work](size_t begin, size_t end) {
+                                       work(static_cast<int>(begin), static_cast<int>(end));
+                                   });
+}
+
+} // namespace
+
 // City Implementation
 City::City(const std::string& i, int w, int h)
     : id(i), width(w), height(h) {
-    grid.resize(height);
+    const size_t cells = static_cast<size_t>(width) * height;
+    parcels.resize(cells);
     for (int y = 0; y < height; ++y) {
-        grid[y].resize(width);
         for (int x = 0; x < width; ++x) {
-            grid[y][x].x = x;
-            grid[y][x].y = y;
+            parcels[y * width + x].x = x;
+            parcels[y * width + x].y = y;
         }
     }
+    roadDistance_.assign(cells, NO_ROAD);
+    amenity_.assign(cells, 0.0f);
+    rowAmenity_.assign(cells, 0.0f);
+
+    bucketsWide_ = (width + INDEX_CELL - 1) / INDEX_CELL;
+    bucketsHigh_ = (height + INDEX_CELL - 1) / INDEX_CELL;
+    buildingBuckets_.resize(static_cast<size_t>(bucketsWide_) * bucketsHigh_);
+    roadBuckets_.resize(buildingBuckets_.size());
 }
 
 City::~City() = default;
 
 Parcel* City::getParcel(int x, int y) {
     if (!isValid(x, y)) return nullptr;
-    return &grid[y][x];
+    return &parcels[y * width + x];
 }
 
 const Parcel* City::getParcel(int x, int y) const {
     if (!isValid(x, y)) return nullptr;
-    return &grid[y][x];
+    return &parcels[y * width + x];
 }
 
 void City::setLandUse(int x, int y, LandUse use) {
@@ -52,7 +125,14 @@ std::string City::addBuilding(const Building& building) {
 
     Building b = building;
     b.id = id;
-    buildings[id] = b;
+    auto existing = buildings.find(id);
+    if (existing != buildings.end()) {
+        markAmenity(existing->second, -1.0f);
+        indexBuilding(existing->second, false);
+    }
+    Building& added = buildings[id] = b;
+    markAmenity(added, 1.0f);
+    indexBuilding(added, true);
 
     // Mark parcels
     for (int dy = 0; dy < b.height; ++dy) {
@@ -71,6 +151,8 @@ void City::removeBuilding(const std::string& buildingId) {
     if (it != buildings.end()) {
         // Clear parcels
         const Building& b = it->second;
+        markAmenity(b, -1.0f);
+        indexBuilding(it->second, false);
         for (int dy = 0; dy < b.height; ++dy) {
             for (int dx = 0; dx < b.width; ++dx) {
                 if (auto* p = getParcel(b.x + dx, b.y + dy)) {
@@ -83,13 +165,18 @@ void City::removeBuilding(const std::string& buildingId) {
 }
 
 Building* City::getBuildingAt(int x, int y) {
-    for (auto& [id, b] : buildings) {
-        if (x >= b.x && x < b.x + b.width &&
-            y >= b.y && y < b.y + b.height) {
-            return &b;
+    if (!isValid(x, y)) return nullptr;
+
+    // Where buildings overlap, the lowest id, as in id order
+    Building* found = nullptr;
+    for (Building* b : buildingBuckets_[(y / INDEX_CELL) * bucketsWide_ + x / INDEX_CELL]) {
+        if (x >= b->x && x < b->x + b->width &&
+            y >= b->y && y < b->y + b->height &&
+            (!found || b->id < found->id)) {
+            found = b;
         }
     }
-    return nullptr;
+    return found;
 }
 
 void City::addRoad(int x1, int y1, int x2, int y2, Road::Type type) {
@@ -105,9 +192,15 @@ void City::addRoad(int x1, int y1, int x2, int y2, Road::Type type) {
     // Mark parcels
     int dx = (x2 > x1) ? 1 : (x2 < x1) ? -1 : 0;
     int dy = (y2 > y1) ? 1 : (y2 < y1) ? -1 : 0;
+    const int road = static_cast<int>(roads.size()) - 1;
     int x = x1, y = y1;
     while (x != x2 || y != y2) {
         if (auto* p = getParcel(x, y)) {
+            roadBuckets_[(y / INDEX_CELL) * bucketsWide_ + x / INDEX_CELL].emplace_back(y * width + x, road);
+            if (!p->hasRoad) {
+                newRoads_.push_back(y * width + x);
+                ++roadCells_;
+            }
             p->hasRoad = true;
             p->landUse = LandUse::Road;
         }
@@ -120,89 +213,462 @@ bool City::isValid(int x, int y) const {
     return x >= 0 && x < width && y >= 0 && y < height;
 }
 
-std::vector<std::pair<int, int>> City::findPath(int x1, int y1, int x2, int y2) const {
-    // Simple A* pathfinding
-    std::vector<std::pair<int, int>> path;
+void City::Region::include(const Region& other) {
+    if (other.empty()) return;
+    if (empty()) {
+        *this = other;
+        return;
+    }
+    x0 = std::min(x0, other.x0);
+    y0 = std::min(y0, other.y0);
+    x1 = std::max(x1, other.x1);
+    y1 = std::max(y1, other.y1);
+}
 
-    struct Node {
-        int x, y;
-        double g, h;
-        int parentX, parentY;
-        bool operator>(const Node& other) const { return g + h > other.g + other.h; }
-    };
+City::Region City::Region::grown(int by, int width, int height) const {
+    if (empty()) return *this;
+    return {std::max(0, x0 - by), std::max(0, y0 - by),
+            std::min(width - 1, x1 + by), std::min(height - 1, y1 + by)};
+}
+
+City::Region City::footprint(const Building& building) const {
+    return {std::max(0, building.x), std::max(0, building.y),
+            std::min(width - 1, building.x + building.width - 1),
+            std::min(height - 1, building.y + building.height - 1)};
+}
+
+void City::markAmenity(const Building& building, float sign) {
+    const float value = sign * amenityOf(building.type);
+    const Region cells = footprint(building);
+    if (cells.empty() || value == 0.0f) return;
+    for (int y = cells.y0; y <= cells.y1; ++y) {
+        for (int x = cells.x0; x <= cells.x1; ++x) {
+            amenity_[y * width + x] += value;
+        }
+    }
+    amenityChanged_.include(cells);
+}
+
+void City::indexBuilding(Building& building, bool add) {
+    TypeIndex& type = types_[building.type];
+    if (add) {
+        type.byId[building.id] = &building;
+    } else {
+        type.byId.erase(building.id);
+    }
+    if (type.buckets.empty()) {
+        type.buckets.resize(buildingBuckets_.size());
+    }
+
+    const Region cells = footprint(building);
+    if (cells.empty()) return;
+    for (int by = cells.y0 / INDEX_CELL; by <= cells.y1 / INDEX_CELL; ++by) {
+        for (int bx = cells.x0 / INDEX_CELL; bx <= cells.x1 / INDEX_CELL; ++bx) {
+            const int bucket = by * bucketsWide_ + bx;
+            for (auto* list : {&buildingBuckets_[bucket], &type.buckets[bucket]}) {
+                if (add) {
+                    list->push_back(&building);
+                } else {
+                    list->erase(std::remove(list->begin(), list->end(), &building), list->end());
+                }
+            }
+        }
+    }
+}
 
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open;
-    std::map<std::pair<int, int>, bool> closed;
-    std::map<std::pair<int, int>, std::pair<int, int>> parent;
+void City::sumRowAmenity(int y, int x0, int x1) {
+    // A sliding window along the row
+    const float* amenity = &amenity_[y * width];
+    float* sums = &rowAmenity_[y * width];
+    float sum = 0.0f;
+    for (int x = std::max(0, x0 - AMENITY_RADIUS); x <= std::min(width - 1, x0 + AMENITY_RADIUS); ++x) {
+        sum += amenity[x];
+    }
+    for (int x = x0; x <= x1; ++x) {
+        sums[x] = sum;
+        if (x - AMENITY_RADIUS >= 0) sum -= amenity[x - AMENITY_RADIUS];
+        if (x + AMENITY_RADIUS + 1 < width) sum += amenity[x + AMENITY_RADIUS + 1];
+    }
+}
+
+void City::updateAccessibility(Region& changed) {
+    if (fieldsStale_) {
+        // Manhattan distance splits into a pass along each row, then one
+        // down each column
+        forRuns("urban.roads", 0, height, [&](int first, int last) {
+            for (int y = first; y < last; ++y) {
+                uint8_t* distance = &roadDistance_[y * width];
+                const Parcel* row = &parcels[y * width];
+                uint8_t d = NO_ROAD;
+                for (int x = 0; x < width; ++x) {
+                    d = row[x].hasRoad ? 0 : std::min<uint8_t>(NO_ROAD, d + 1);
+                    distance[x] = d;
+                }
+                d = NO_ROAD;
+                for (int x = width - 1; x >= 0; --x) {
+                    d = row[x].hasRoad ? 0 : std::min<uint8_t>(NO_ROAD, d + 1);
+                    distance[x] = std::min(distance[x], d);
+                }
+            }
+        });
+        forRuns("urban.roads", 0, width, [&](int first, int last) {
+            for (int y = 1; y < height; ++y) {
+                for (int x = first; x < last; ++x) {
+                    uint8_t& d = roadDistance_[y * width + x];
+                    d = std::min<uint8_t>(d, roadDistance_[(y - 1) * width + x] + 1);
+                }
+            }
+            for (int y = height - 2; y >= 0; --y) {
+                for (int x = first; x < last; ++x) {
+                    uint8_t& d = roadDistance_[y * width + x];
+                    d = std::min<uint8_t>(d, roadDistance_[(y + 1) * width + x] + 1);
+                }
+            }
+        });
+        newRoads_.clear();
+        changed = {0, 0, width - 1, height - 1};
+        return;
+    }
 
-    open.push({x1, y1, 0, 0, -1, -1});
+    // A breadth-first search out from the new roads, as far as it brings
+    // anywhere nearer a road than it was
+    std::vector<int> open;
+    for (int cell : newRoads_) {
+        if (roadDistance_[cell] != 0) {
+            roadDistance_[cell] = 0;
+            open.push_back(cell);
+        }
+    }
+    newRoads_.clear();
+    for (size_t head = 0; head < open.size(); ++head) {
+        const int cell = open[head];
+        const int x = cell % width;
+        const int y = cell / width;
+        changed.include({x, y, x, y});
+        const uint8_t next = roadDistance_[cell] + 1;
+        if (next >= NO_ROAD) continue;
+        const int neighbors[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+        for (const auto& [nx, ny] : neighbors) {
+            if (!isValid(nx, ny)) continue;
+            const int neighbor = ny * width + nx;
+            if (next < roadDistance_[neighbor]) {
+                roadDistance_[neighbor] = next;
+                open.push_back(neighbor);
+            }
+        }
+    }
+}
 
-    int dx[] = {0, 1, 0, -1};
-    int dy[] = {-1, 0, 1, 0};
+void City::updateDesirability(const Region& region) {
+    const float window = static_cast<float>((2 * AMENITY_RADIUS + 1) * (2 * AMENITY_RADIUS + 1));
+    forRuns("urban.desirability", region.y0, region.y1 + 1, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            const int top = std::max(0, y - AMENITY_RADIUS);
+            const int bottom = std::min(height - 1, y + AMENITY_RADIUS);
+            for (int x = region.x0; x <= region.x1; ++x) {
+                float around = 0.0f;
+                for (int row = top; row <= bottom; ++row) {
+                    around += rowAmenity_[row * width + x];
+                }
+                Parcel& parcel = parcels[y * width + x];
+                const float access = 1.0f - static_cast<float>(roadDistance_[y * width + x]) / NO_ROAD;
+                parcel.accessibility = access;
+                parcel.desirability = std::clamp(BASE_DESIRABILITY + ACCESS_WEIGHT * access +
+                                                 AMENITY_WEIGHT * around / window, 0.0f, 1.0f);
+            }
+        }
+    });
+}
 
-    while (!open.empty()) {
-        Node current = open.top();
-        open.pop();
+void City::updateFields() {
+    // Past a point, starting over is cheaper than catching up
+    const long cells = static_cast<long>(width) * height;
+    if (amenityChanged_.grown(AMENITY_RADIUS, width, height).area() > cells / 2 ||
+        static_cast<long>(newRoads_.size()) * ROAD_REACH * ROAD_REACH > cells) {
+        fieldsStale_ = true;
+    }
 
-        if (current.x == x2 && current.y == y2) {
-            // Reconstruct path
-            int px = x2, py = y2;
-            while (px != -1) {
-                path.push_back({px, py});
-                auto p = parent[{px, py}];
-                px = p.first;
-                py = p.second;
+    Region changed;
+    updateAccessibility(changed);
+    if (fieldsStale_) {
+        forRuns("urban.amenity", 0, height, [&](int first, int last) {
+            for (int y = first; y < last; ++y) {
+                sumRowAmenity(y, 0, width - 1);
             }
+        });
+        fieldsStale_ = false;
+    } else if (!amenityChanged_.empty()) {
+        // Row sums that reach into the change, then everything whose
+        // window does
+        const Region rows = {std::max(0, amenityChanged_.x0 - AMENITY_RADIUS), amenityChanged_.y0,
+                             std::min(width - 1, amenityChanged_.x1 + AMENITY_RADIUS),
+                             amenityChanged_.y1};
+        for (int y = rows.y0; y <= rows.y1; ++y) {
+            sumRowAmenity(y, rows.x0, rows.x1);
+        }
+        changed.include(amenityChanged_.grown(AMENITY_RADIUS, width, height));
+    }
+    amenityChanged_ = Region();
+    if (!changed.empty()) {
+        updateDesirability(changed);
+    }
+}
+
+void City::PathContext::visit(int cell, int g, int from) {
+    stamp[cell] = generation;
+    cost[cell] = g;
+    parent[cell] = from;
+}
+
+void City::PathContext::push(int f, int cell) {
+    if (static_cast<size_t>(f) >= buckets.size()) {
+        buckets.resize(f + 1);
+    }
+    buckets[f].push_back(cell);
+    lowest = std::min(lowest, static_cast<size_t>(f));
+}
+
+bool City::PathContext::pop(int& cell, int& f) {
+    while (lowest < buckets.size() && buckets[lowest].empty()) {
+        ++lowest;
+    }
+    if (lowest == buckets.size()) return false;
+
+    // Newest first, so ties go to the cell nearest the goal
+    cell = buckets[lowest].back();
+    buckets[lowest].pop_back();
+    f = static_cast<int>(lowest);
+    return true;
+}
+
+City::PathContext& City::beginPathSearch() const {
+    PathContext& ctx = pathContext_;
+    const size_t cells = static_cast<size_t>(width) * height;
+    if (ctx.stamp.size() != cells) {
+        ctx.stamp.assign(cells, 0);
+        ctx.cost.resize(cells);
+        ctx.parent.resize(cells);
+        ctx.generation = 0;
+    }
+    if (++ctx.generation == 0) {
+        // Wrapped around, so old stamps could look current
+        std::fill(ctx.stamp.begin(), ctx.stamp.end(), 0);
+        ctx.generation = 1;
+    }
+    for (auto& bucket : ctx.buckets) {
+        bucket.clear();
+    }
+    ctx.lowest = 0;
+    return ctx;
+}
+
+bool City::isBlocked(int cell) const {
+    return parcels[cell].hasBuilding;
+}
+
+std::vector<std::pair<int, int>> City::tracePath(int from) const {
+    std::vector<std::pair<int, int>> path;
+    for (int cell = from; cell != -1; cell = pathContext_.parent[cell]) {
+        path.push_back({cell % width, cell / width});
+    }
+    return path;
+}
+
+static const int pathDx[] = {0, 1, 0, -1};
+static const int pathDy[] = {-1, 0, 1, 0};
+
+std::vector<std::pair<int, int>> City::findPath(int x1, int y1, int x2, int y2) const {
+    // A* over the grid with unit steps, so cost estimates are small integers
+    // and the open list can be one bucket per estimate
+    if (!isValid(x1, y1) || !isValid(x2, y2)) return {};
+
+    PathContext& ctx = beginPathSearch();
+    const int start = y1 * width + x1;
+    const int goal = y2 * width + x2;
+    auto estimate = [&](int x, int y) {
+        return std::abs(x - x2) + std::abs(y - y2);
+    };
+
+    ctx.visit(start, 0, -1);
+    ctx.push(estimate(x1, y1), start);
+
+    int cell, f;
+    while (ctx.pop(cell, f)) {
+        const int x = cell % width;
+        const int y = cell / width;
+        if (f != ctx.cost[cell] + estimate(x, y)) continue;  // Since improved
+
+        if (cell == goal) {
+            auto path = tracePath(goal);
             std::reverse(path.begin(), path.end());
             return path;
         }
 
-        if (closed[{current.x, current.y}]) continue;
-        closed[{current.x, current.y}] = true;
-
         for (int i = 0; i < 4; ++i) {
-            int nx = current.x + dx[i];
-            int ny = current.y + dy[i];
-
+            int nx = x + pathDx[i];
+            int ny = y + pathDy[i];
             if (!isValid(nx, ny)) continue;
-            if (closed[{nx, ny}]) continue;
 
-            const Parcel* p = getParcel(nx, ny);
-            if (p->hasBuilding && !(nx == x2 && ny == y2)) continue;
+            int next = ny * width + nx;
+            if (next != goal && isBlocked(next)) continue;
 
-            double g = current.g + 1;
-            double h = std::abs(nx - x2) + std::abs(ny - y2);
+            int g = ctx.cost[cell] + 1;
+            if (ctx.seen(next) && ctx.cost[next] <= g) continue;
 
-            parent[{nx, ny}] = {current.x, current.y};
-            open.push({nx, ny, g, h, current.x, current.y});
+            ctx.visit(next, g, cell);
+            ctx.push(g + estimate(nx, ny), next);
         }
     }
 
-    return path;
+    return {};
+}
+
+std::vector<std::vector<std::pair<int, int>>> City::findPaths(
+    const std::vector<std::pair<int, int>>& starts, int x2, int y2) const {
+    std::vector<std::vector<std::pair<int, int>>> paths(starts.size());
+    if (!isValid(x2, y2)) return paths;
+
+    // Breadth first from the goal until every start is reached.  As in
+    // findPath a start may be inside a building, so blocked cells are
+    // reached but not searched on from.
+    PathContext& ctx = beginPathSearch();
+    std::vector<int> startCells;
+    for (const auto& [x, y] : starts) {
+        if (isValid(x, y)) startCells.push_back(y * width + x);
+    }
+    std::sort(startCells.begin(), startCells.end());
+    startCells.erase(std::unique(startCells.begin(), startCells.end()),
+                     startCells.end());
+    size_t waiting = startCells.size();
+    auto reached = [&](int cell) {
+        if (std::binary_search(startCells.begin(), startCells.end(), cell)) {
+            --waiting;
+        }
+    };
+
+    const int goal = y2 * width + x2;
+    std::vector<int>& queue = ctx.buckets.empty() ?
+        ctx.buckets.emplace_back() : ctx.buckets.front();
+    ctx.visit(goal, 0, -1);
+    queue.push_back(goal);
+    reached(goal);
+
+    for (size_t head = 0; head < queue.size() && waiting > 0; ++head) {
+        const int cell = queue[head];
+        const int x = cell % width;
+        const int y = cell / width;
+        for (int i = 0; i < 4; ++i) {
+            int nx = x + pathDx[i];
+            int ny = y + pathDy[i];
+            if (!isValid(nx, ny)) continue;
+
+            int next = ny * width + nx;
+            if (ctx.seen(next)) continue;
+
+            ctx.visit(next, ctx.cost[cell] + 1, cell);
+            reached(next);
+            if (!isBlocked(next)) {
+                queue.push_back(next);
+            }
+        }
+    }
+
+    // Parents lead towards the goal, so the traces are already in order
+    for (size_t i = 0; i < starts.size(); ++i) {
+        const auto& [x, y] = starts[i];
+        if (isValid(x, y) && ctx.seen(y * width + x)) {
+            paths[i] = tracePath(y * width + x);
+        }
+    }
+    return paths;
 }
 
 std::vector<Building*> City::getBuildingsByType(BuildingType type) {
     std::vector<Building*> result;
-    for (auto& [id, b] : buildings) {
-        if (b.type == type) {
-            result.push_back(&b);
+    auto it = types_.find(type);
+    if (it != types_.end()) {
+        result.reserve(it->second.byId.size());
+        for (const auto& [id, b] : it->second.byId) {
+            result.push_back(b);
         }
     }
     return result;
 }
 
-void City::calculateStatistics() {
-    population = 0;
-    wealth = 0;
-    roadCoverage = 0;
+Building* City::findNearestBuilding(BuildingType type, int x, int y, int maxDistance) {
+    auto it = types_.find(type);
+    if (it == types_.end() || it->second.byId.empty() || !isValid(x, y)) return nullptr;
+    const TypeIndex& index = it->second;
+
+    Building* best = nullptr;
+    long bestDistance = 0;
+    const long reach = maxDistance < 0 ? -1 : long(maxDistance) * maxDistance;
+    auto consider = [&](Building* b) {
+        // Squared distance to the nearest cell of the building
+        const long dx = std::max({0, b->x - x, x - (b->x + b->width - 1)});
+        const long dy = std::max({0, b->y - y, y - (b->y + b->height - 1)});
+        const long distance = dx * dx + dy * dy;
+        if (reach >= 0 && distance > reach) return;
+        if (!best || distance < bestDistance || (distance == bestDistance && b->id < best->id)) {
+            best = b;
+            bestDistance = distance;
+        }
+    };
 
-    int roadCount = 0;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (grid[y][x].hasRoad) roadCount++;
+    // Every cell in ring r + 1 or beyond is at least r * INDEX_CELL + 1
+    // away, so once something's nearer than that the search is done
+    const int bx = x / INDEX_CELL;
+    const int by = y / INDEX_CELL;
+    const int rings = std::max({bx, by, bucketsWide_ - 1 - bx, bucketsHigh_ - 1 - by});
+    for (int r = 0; r <= rings; ++r) {
+        for (int ry = std::max(0, by - r); ry <= std::min(bucketsHigh_ - 1, by + r); ++ry) {
+            const bool edge = ry == by - r || ry == by + r;
+            for (int rx = bx - r; rx <= bx + r; rx += edge ? 1 : 2 * std::max(r, 1)) {
+                if (rx < 0 || rx >= bucketsWide_) continue;
+                for (Building* b : index.buckets[ry * bucketsWide_ + rx]) {
+                    consider(b);
+                }
+            }
+        }
+        const long beyond = long(r) * INDEX_CELL + 1;
+        if ((best && bestDistance < beyond * beyond) || (reach >= 0 && beyond * beyond > reach)) {
+            break;
+        }
+    }
+    return best;
+}
+
+std::vector<Road*> City::getRoadsNear(int x, int y, int radius) {
+    const Region box = Region{x - radius, y - radius, x + radius, y + radius}.grown(0, width, height);
+    if (box.empty()) return {};
+    std::vector<int> found;
+    for (int by = box.y0 / INDEX_CELL; by <= box.y1 / INDEX_CELL; ++by) {
+        for (int bx = box.x0 / INDEX_CELL; bx <= box.x1 / INDEX_CELL; ++bx) {
+            for (const auto& [cell, road] : roadBuckets_[by * bucketsWide_ + bx]) {
+                const int cx = cell % width;
+                const int cy = cell / width;
+                if (cx >= box.x0 && cx <= box.x1 && cy >= box.y0 && cy <= box.y1) {
+                    found.push_back(road);
+                }
+            }
         }
     }
-    roadCoverage = static_cast<double>(roadCount) / (width * height);
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    std::vector<Road*> result;
+    result.reserve(found.size());
+    for (int road : found) {
+        result.push_back(&roads[road]);
+    }
+    return result;
+}
+
+void City::calculateStatistics() {
+    population = 0;
+    wealth = 0;
+    roadCoverage = static_cast<double>(roadCells_) / (width * height);
+    updateFields();
 }
 
 // CityGenerator Implementation
@@ -375,6 +841,7 @@ City* UrbanSimulation::getCity(const std::string& cityId) {
 
 void UrbanSimulation::simulate(double deltaTime) {
     for (auto& [id, city] : cities_) {
+        city->updateFields();
         populationModel_.simulate(deltaTime, *city);
         landValueModel_.calculate(*city);
         growthModel_.simulate(*city, deltaTime);
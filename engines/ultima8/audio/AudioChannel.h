@@ -59,6 +59,7 @@ public:
 	void resampleAndMix(sint16 *stream, uint32 bytes);
 
 	bool isPlaying() { return sample != 0; }
+	AudioSample* getSample() const { return sample; }
 
 	void setPitchShift(int pitch_shift_) { pitch_shift = pitch_shift_; }
 	uint32 getPitchShift() const { return pitch_shift; }
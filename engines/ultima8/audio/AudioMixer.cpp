@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "AudioProcess.h"
 #include "MusicProcess.h"
 #include "AudioChannel.h"
+#include "AudioSample.h"
 
 #include "MidiDriver.h"
 
@@ -57,7 +58,8 @@ AudioMixer::AudioMixer(int sample_rate_, bool stereo_, int num_channels_) :
 		sample_rate(sample_rate_), stereo(stereo_),
 		midi_driver(0), midi_volume(255),
 		num_channels(num_channels_), channels(0),
-		audio_device(0), audio_stream(nullptr)
+		audio_device(0), audio_stream(nullptr),
+		decoded_limit(0), decoded_bytes(0), decoded_hits(0), decoded_misses(0)
 {
 	the_audio_mixer = this;
 
@@ -146,6 +148,8 @@ AudioMixer::~AudioMixer(void)
 		channels = 0;
 	}
 
+	trimDecoded(0, 0);
+
 	the_audio_mixer = 0;
 }
 
@@ -190,6 +194,9 @@ int AudioMixer::playSample(AudioSample *sample, int loop, int priority, bool pau
 {
 	if (!audio_ok) return -1;
 
+	AudioSample *decoded = sample ? getDecoded(sample) : 0;
+	if (decoded) sample = decoded;
+
 	int lowest = -1;
 	int lowprior = 65536;
 
@@ -270,6 +277,26 @@ void AudioMixer::setVolume(int chan, int lvol, int rvol)
 	Unlock();
 }
 
+void AudioMixer::setVolumes(const ChannelVolume *vols, int count)
+{
+	Lock();
+	for (int i = 0; i < count; i++) {
+		if (vols[i].chan >= 0 && vols[i].chan < num_channels)
+			channels[vols[i].chan]->setVolume(vols[i].lvol, vols[i].rvol);
+	}
+	Unlock();
+}
+
+void AudioMixer::getPlaying(std::vector<bool> &playing)
+{
+	playing.assign(channels ? num_channels : 0, false);
+
+	Lock();
+	for (unsigned int i = 0; i < playing.size(); i++)
+		playing[i] = channels[i]->isPlaying();
+	Unlock();
+}
+
 void AudioMixer::getVolume(int chan, int &lvol, int &rvol)
 {
 	if (chan < 0 || chan >= num_channels) return;
@@ -279,6 +306,106 @@ void AudioMixer::getVolume(int chan, int &lvol, int &rvol)
 	Unlock();
 }
 
+AudioSample* AudioMixer::getDecoded(AudioSample *sample)
+{
+	if (!decoded_limit || sample->isPCM()) return 0;
+
+	// keep track of the last few hundred sounds, decoded or not
+	const unsigned int max_tracked = 256;
+	std::map<uint32, std::list<DecodedSample>::iterator>::iterator found =
+		decoded_index.find(sample->getSerial());
+	if (found == decoded_index.end()) {
+		trimDecoded(decoded_limit, max_tracked - 1);
+		DecodedSample entry = { sample->getSerial(), 0, 0, false };
+		decoded_lru.push_front(entry);
+		decoded_index[sample->getSerial()] = decoded_lru.begin();
+	} else {
+		decoded_lru.splice(decoded_lru.begin(), decoded_lru, found->second);
+	}
+
+	DecodedSample &entry = decoded_lru.front();
+	entry.plays++;
+	if (entry.decoded) {
+		decoded_hits++;
+		return entry.decoded;
+	}
+	decoded_misses++;
+
+	// Only sounds played more than once are worth the memory, and only
+	// short ones: no single copy may take more than an eighth.
+	if (entry.plays < 2 || entry.too_long) return 0;
+
+	entry.decoded = sample->decodeAll(decoded_limit / 8);
+	if (!entry.decoded) {
+		entry.too_long = true;
+		return 0;
+	}
+	decoded_bytes += entry.decoded->getBufferSize();
+	trimDecoded(decoded_limit, max_tracked);
+	return entry.decoded;
+}
+
+void AudioMixer::trimDecoded(uint32 bytes, unsigned int count)
+{
+	if (decoded_lru.empty()) return;
+
+	// the callback mustn't be playing a copy while it's deleted
+	Lock();
+	std::list<DecodedSample>::iterator it = decoded_lru.end();
+	while (it != decoded_lru.begin() &&
+		   (decoded_lru.size() > count || decoded_bytes > bytes))
+	{
+		--it;
+		if (it == decoded_lru.begin() && count > 0) break;
+
+		bool playing = false;
+		for (int i = 0; it->decoded && channels && i < num_channels; i++) {
+			if (channels[i]->getSample() == it->decoded)
+				playing = true;
+		}
+		if (playing) continue;
+
+		if (it->decoded) {
+			decoded_bytes -= it->decoded->getBufferSize();
+			delete it->decoded;
+		}
+		decoded_index.erase(it->serial);
+		it = decoded_lru.erase(it);
+	}
+	Unlock();
+}
+
+void AudioMixer::setDecodedCacheLimit(uint32 bytes)
+{
+	decoded_limit = bytes;
+	trimDecoded(bytes, bytes ? decoded_lru.size() : 0);
+}
+
+void AudioMixer::getDecodedCacheStats(uint32 &bytes, int &count,
+									  uint32 &hits, uint32 &misses) const
+{
+	bytes = decoded_bytes;
+	count = 0;
+	std::list<DecodedSample>::const_iterator it;
+	for (it = decoded_lru.begin(); it != decoded_lru.end(); ++it)
+		if (it->decoded) count++;
+	hits = decoded_hits;
+	misses = decoded_misses;
+}
+
+void AudioMixer::audioStats() const
+{
+	uint32 bytes, hits, misses;
+	int count;
+	getDecodedCacheStats(bytes, count, hits, misses);
+
+	pout << "Audio memory stats:" << std::endl;
+	pout << "Decoded    : " << count << " sounds, " << bytes << "/"
+		 << decoded_limit << " bytes" << std::endl;
+	pout << "Plays      : " << hits << " of " << hits + misses
+		 << " from a decoded copy" << std::endl;
+}
+
 void AudioMixer::openMidiOutput()
 {
 	SettingManager *settingman = SettingManager::get_instance();
@@ -21,6 +21,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <SDL3/SDL.h>
 
+#include <list>
+#include <map>
+#include <vector>
+
 class MidiDriver;
 
 namespace Pentagram {
@@ -50,10 +54,33 @@ public:
 	void			setVolume(int chan, int lvol, int rvol);
 	void			getVolume(int chan, int &lvol, int &rvol);
 
+	//! the volume of one channel, for setVolumes
+	struct ChannelVolume {
+		int			chan;
+		int			lvol, rvol;
+	};
+
+	//! set the volumes of several channels, locking the audio only once.
+	//! Later entries for a channel win over earlier ones.
+	void			setVolumes(const ChannelVolume *vols, int count);
+	//! get which channels are playing, all in one go
+	void			getPlaying(std::vector<bool> &playing);
+
 	void			openMidiOutput();
 	void			closeMidiOutput();
 	void			setMidiVolume(int vol);
 
+	//! set the bytes kept for decoded copies of sounds (0 to keep none)
+	void			setDecodedCacheLimit(uint32 bytes);
+
+	//! get how much the decoded copies take, how many there are, and how
+	//! often a played sound found or missed one
+	void			getDecodedCacheStats(uint32 &bytes, int &count,
+										 uint32 &hits, uint32 &misses) const;
+
+	//! Print memory used by the decoded copies
+	void			audioStats() const;
+
 	// Called by SDL3 audio callback
 	void			MixAudio(sint16 *stream, uint32 bytes);
 
@@ -75,6 +102,30 @@ private:
 
 	void			Lock();
 	void			Unlock();
+
+	//! A sound played before, and its decoded copy if it has one. Sounds
+	//! played again and again (footsteps, hits) are decoded once and
+	//! played from the copy, which the channels only have to copy from.
+	struct DecodedSample {
+		uint32		serial;
+		uint32		plays;
+		AudioSample	*decoded;
+		bool		too_long;
+	};
+
+	std::list<DecodedSample> decoded_lru;	//!< most recently played first
+	std::map<uint32, std::list<DecodedSample>::iterator> decoded_index;
+	uint32			decoded_limit;
+	uint32			decoded_bytes;
+	uint32			decoded_hits, decoded_misses;
+
+	//! get the decoded copy to play instead of sample, or 0 to play sample
+	AudioSample*	getDecoded(AudioSample *sample);
+
+	//! drop the least recently played sounds until the copies take at
+	//! most bytes and at most count sounds are tracked, sparing the most
+	//! recent one and those a channel is playing
+	void			trimDecoded(uint32 bytes, unsigned int count);
 };
 
 };
@@ -54,14 +54,21 @@ AudioProcess::~AudioProcess(void)
 }
 
 bool AudioProcess::calculateSoundVolume(ObjId objid, sint16 &lvol, sint16 &rvol) const
+{
+	sint32 ax, ay, az;
+	CameraProcess::GetCameraLocation(ax,ay,az);
+	return calculateSoundVolume(objid, ax, ay, az, lvol, rvol);
+}
+
+bool AudioProcess::calculateSoundVolume(ObjId objid, sint32 ax, sint32 ay, sint32 az,
+										sint16 &lvol, sint16 &rvol) const
 {
 	Item *item = getItem(objid);
 	if (!item) return false;
 
 	// Need to get items relative coords from avatar
 
-	sint32 ax, ay, az, ix, iy, iz;
-	CameraProcess::GetCameraLocation(ax,ay,az);
+	sint32 ix, iy, iz;
 	item->getLocationAbsolute(ix, iy, iz);
 	ix -= ax; iy -= ay; iz -= az; 
 
@@ -102,11 +109,37 @@ void AudioProcess::run()
 {
 	AudioMixer *mixer = AudioMixer::get_instance();
 
+	// Work everything out against one camera position and one look at
+	// the channels, then hand the mixer all the volumes at once, rather
+	// than locking the audio twice for every sample.
+	sint32 ax, ay, az;
+	CameraProcess::GetCameraLocation(ax,ay,az);
+	mixer->getPlaying(playing);
+	volumes.clear();
+
 	// Update the channels
 	std::list<SampleInfo>::iterator it;
 	for (it = sample_info.begin(); it != sample_info.end(); ) {
+		if (it->virtualised) {
+			// Nothing to hear until it comes back in range
+			if (!paused) {
+				it->lvol = 256;
+				it->rvol = 256;
+				calculateSoundVolume(it->objid, ax, ay, az, it->lvol, it->rvol);
+				if ((it->lvol || it->rvol) && resumeSample(*it)) {
+					AudioMixer::ChannelVolume v = { it->channel,
+						(it->lvol*it->volume)/256, (it->rvol*it->volume)/256 };
+					volumes.push_back(v);
+				}
+			}
+			++it;
+			continue;
+		}
+
 		bool finished = false;
-		if (!mixer->isPlaying(it->channel)) {
+		if (it->channel < 0 || it->channel >= static_cast<sint32>(playing.size()) ||
+			!playing[it->channel])
+		{
 			if (it->sfxnum == -1)
 				finished = !continueSpeech(*it);
 			else
@@ -121,13 +154,46 @@ void AudioProcess::run()
 			{
 				it->lvol = 256;
 				it->rvol = 256;
-				calculateSoundVolume(it->objid, it->lvol,it->rvol);
+				calculateSoundVolume(it->objid, ax, ay, az, it->lvol, it->rvol);
+
+				// A loop out of hearing gives up its channel, and is
+				// started again when it can be heard
+				if (!it->lvol && !it->rvol && it->loops == -1 && !paused) {
+					mixer->stopSample(it->channel);
+					it->channel = -1;
+					it->virtualised = true;
+					++it;
+					continue;
+				}
 			}
-			mixer->setVolume(it->channel, (it->lvol*it->volume)/256,(it->rvol*it->volume)/256);
+			AudioMixer::ChannelVolume v = { it->channel,
+				(it->lvol*it->volume)/256, (it->rvol*it->volume)/256 };
+			volumes.push_back(v);
 
 			++it;
 		}
 	}
+
+	if (!volumes.empty())
+		mixer->setVolumes(&volumes[0], static_cast<int>(volumes.size()));
+}
+
+bool AudioProcess::resumeSample(SampleInfo& si)
+{
+	assert(si.virtualised);
+
+	SoundFlex *soundflx = GameData::get_instance()->getSoundFlex();
+	AudioSample *sample = soundflx->getSample(si.sfxnum);
+	if (!sample) return false;
+
+	// Loops sound the same from any point, so start from the beginning
+	int channel = playSample(sample,si.priority,si.loops,si.pitch_shift,
+							 (si.lvol*si.volume)/256,(si.rvol*si.volume)/256);
+	if (channel == -1) return false;
+
+	si.channel = channel;
+	si.virtualised = false;
+	return true;
 }
 
 bool AudioProcess::continueSpeech(SampleInfo& si)
@@ -262,7 +328,7 @@ void AudioProcess::playSFX(int sfxnum, int priority, ObjId objid, int loops,
 
 				// Exactly the same (and playing) so just return
 				//if (it->priority == priority) 
-				if (mixer->isPlaying(it->channel))
+				if (it->virtualised || mixer->isPlaying(it->channel))
 				{
 					pout << "Sound already playing" << std::endl;
 					return;
@@ -442,7 +508,10 @@ void AudioProcess::pauseAllSamples()
 
 	std::list<SampleInfo>::iterator it;
 	for (it = sample_info.begin(); it != sample_info.end(); ) {
-		if (mixer->isPlaying(it->channel)) {
+		if (it->virtualised) {
+			++it;
+		}
+		else if (mixer->isPlaying(it->channel)) {
 			mixer->setPaused(it->channel,true);
 			++it;
 		}
@@ -463,7 +532,10 @@ void AudioProcess::unpauseAllSamples()
 
 	std::list<SampleInfo>::iterator it;
 	for (it = sample_info.begin(); it != sample_info.end(); ) {
-		if (mixer->isPlaying(it->channel)) {
+		if (it->virtualised) {
+			++it;
+		}
+		else if (mixer->isPlaying(it->channel)) {
 			mixer->setPaused(it->channel,false);
 			++it;
 		}
@@ -594,6 +666,9 @@ void AudioProcess::ConCmd_listSFX(const Console::ArgvType &argv)
 	for (it = ap->sample_info.begin(); it != ap->sample_info.end(); ++it) {
 		pout.printf("Sample: num %d, obj %d, loop %d, prio %d",
 					it->sfxnum, it->objid, it->loops, it->priority);
+		if (it->virtualised) {
+			pout << ", out of range";
+		}
 		if (!it->barked.empty()) {
 			pout << ", speech: \"" << it->barked.substr(it->curspeech_start, it->curspeech_end - it->curspeech_start) << "\"";
 		}
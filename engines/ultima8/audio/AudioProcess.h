@@ -21,8 +21,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "Process.h"
 #include "intrinsics.h"
+#include "AudioMixer.h"
 #include <list>
 #include <string>
+#include <vector>
 
 namespace Pentagram {
 	class AudioSample;
@@ -43,20 +45,27 @@ class AudioProcess :
 		uint16		volume;			// 0-256
 		sint16		lvol;
 		sint16		rvol;
+		bool		virtualised;	// out of hearing, so not on a channel
 		
-		SampleInfo() : sfxnum(-1) { }
+		SampleInfo() : sfxnum(-1), virtualised(false) { }
 		SampleInfo(sint32 s,sint32 p,ObjId o,sint32 l,sint32 c,uint32 ps,uint16 v, sint16 lv, sint16 rv) : 
 			sfxnum(s),priority(p),objid(o),loops(l),channel(c),
-			pitch_shift(ps), volume(v), lvol(lv), rvol(rv) { }
+			pitch_shift(ps), volume(v), lvol(lv), rvol(rv),
+			virtualised(false) { }
 		SampleInfo(std::string &b,sint32 shpnum,ObjId o,sint32 c,
 				   uint32 s,uint32 e,uint32 ps,uint16 v, sint16 lv, sint16 rv) : 
 			sfxnum(-1),priority(shpnum),objid(o),loops(0),channel(c),barked(b),
 			curspeech_start(s), curspeech_end(e), pitch_shift(ps), volume(v), 
-			lvol(lv), rvol(rv) { }
+			lvol(lv), rvol(rv), virtualised(false) { }
 	};
 
 	std::list<SampleInfo>	sample_info;
 
+	//! channel volumes worked out by run(), sent to the mixer in one go
+	std::vector<Pentagram::AudioMixer::ChannelVolume> volumes;
+	//! which channels were playing at the start of run()
+	std::vector<bool>		playing;
+
 public:
 	// p_dynamic_class stuff
 	ENABLE_RUNTIME_CLASSTYPE();
@@ -130,6 +139,12 @@ private:
 	bool continueSpeech(SampleInfo& si);
 
 	bool calculateSoundVolume(ObjId objid, sint16 &lvol, sint16 &rvol) const;
+	//! as above, for a camera at ax,ay,az
+	bool calculateSoundVolume(ObjId objid, sint32 ax, sint32 ay, sint32 az,
+							  sint16 &lvol, sint16 &rvol) const;
+
+	//! try to put a virtualised looping sample back on a channel
+	bool resumeSample(SampleInfo& si);
 
 	static AudioProcess	*	the_audio_process;
 };
@@ -18,14 +18,39 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "pent_include.h"
 #include "AudioSample.h"
+#include "RawAudioSample.h"
+
+#include <vector>
 
 namespace Pentagram {
 
+static uint32 next_serial = 0;
+
 AudioSample::AudioSample(uint8 *buffer_, uint32 size_) : 
 		sample_rate(0), bits(0), stereo(false), 
 		frame_size(0), decompressor_size(0), length(0), 
-		buffer_size(size_), buffer(buffer_)
+		buffer_size(size_), buffer(buffer_), serial(next_serial++)
+{
+}
+
+AudioSample* AudioSample::decodeAll(uint32 max_bytes) const
 {
+	std::vector<uint8> decomp(decompressor_size + 1);
+	std::vector<uint8> frame(frame_size + 1);
+	std::vector<uint8> pcm;
+
+	initDecompressor(&decomp[0]);
+	uint32 count;
+	while ((count = decompressFrame(&decomp[0], &frame[0])) != 0) {
+		if (pcm.size() + count > max_bytes) return 0;
+		pcm.insert(pcm.end(), frame.begin(), frame.begin() + count);
+	}
+	if (pcm.empty()) return 0;
+
+	// frames always come out as unsigned 8 bit
+	uint8 *data = new uint8[pcm.size()];
+	std::memcpy(data, &pcm[0], pcm.size());
+	return new RawAudioSample(data, pcm.size(), sample_rate, false, stereo);
 }
 
 AudioSample::~AudioSample(void)
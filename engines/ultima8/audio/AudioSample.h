@@ -35,6 +35,8 @@ protected:
 	uint32	buffer_size;
 	uint8	*buffer;
 
+	uint32	serial;
+
 public:
 	AudioSample(uint8 *buffer, uint32 size);
 	virtual ~AudioSample(void);
@@ -48,6 +50,20 @@ public:
 	//! get AudioSample length (in samples)
 	inline uint32 getLength() const { return length; }
 
+	inline uint32 getBufferSize() const { return buffer_size; }
+
+	//! get a number no other sample made before or after has, unlike the
+	//! address
+	inline uint32 getSerial() const { return serial; }
+
+	//! true if the frames are stored as they are played, so decoding the
+	//! whole sample ahead saves nothing
+	virtual bool isPCM() const { return false; }
+
+	//! decode the whole sample into a new sample that plays the same
+	//! \return the new sample, or 0 if it decodes to more than max_bytes
+	virtual AudioSample* decodeAll(uint32 max_bytes) const;
+
 	virtual void initDecompressor(void *DecompData) const = 0;
 	virtual uint32 decompressFrame(void *DecompData, void *samples) const = 0;
 	virtual void rewind(void *DecompData) const = 0;
@@ -33,6 +33,8 @@ public:
 	virtual uint32 decompressFrame(void *DecompData, void *samples) const;
 	virtual void rewind(void *DecompData) const;
 
+	virtual bool isPCM() const { return true; }
+
 protected:
 
 	struct RawDecompData {
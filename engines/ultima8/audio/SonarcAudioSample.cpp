@@ -17,6 +17,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 #include "pent_include.h"
 #include "SonarcAudioSample.h"
+#include "RawAudioSample.h"
 #include "IDataSource.h"
 
 namespace Pentagram {
@@ -151,29 +152,85 @@ void SonarcAudioSample::decode_EC(int mode, int samplecount,
 	}
 }
 
+// The LPC filter for the samples first to nsamples-1, with tap[j] applied
+// to the sample j+1 back. Samples before the start of the frame are 0
+// (-128 signed).
+static void decode_LPC_generic(int order, int first, int nsamples,
+							   uint8* dest, const int* tap)
+{
+	for (int i = first; i < nsamples; ++i) {
+		int accum = 0x800;
+		for (int j = 0; j < order; ++j) {
+			int val = (i-1-j < 0) ? 0 : dest[i-1-j];
+			accum += (val - 0x80) * tap[j];
+		}
+		dest[i] = (uint8)(dest[i] - (accum >> 12));
+	}
+}
+
+// The same with the order known at compile time, so the taps are unrolled
+// and kept in registers. The samples must all have order samples before
+// them.
+template<int order>
+static void decode_LPC_unrolled(int first, int nsamples,
+								uint8* dest, const int* tap_)
+{
+	int tap[order];
+	int bias = 0x800;
+	for (int j = 0; j < order; ++j) {
+		tap[j] = tap_[j];
+		bias -= 0x80 * tap[j];
+	}
+
+	for (int i = first; i < nsamples; ++i) {
+		const uint8* past = dest + i - 1;
+		int accum = bias;
+		for (int j = 0; j < order; ++j)
+			accum += past[-j] * tap[j];
+		dest[i] = (uint8)(dest[i] - (accum >> 12));
+	}
+}
+
+typedef void (*LPCFilter)(int first, int nsamples,
+						  uint8* dest, const int* tap);
+
+static const LPCFilter unrolled_LPC[] = {
+	0,
+	&decode_LPC_unrolled<1>,  &decode_LPC_unrolled<2>,
+	&decode_LPC_unrolled<3>,  &decode_LPC_unrolled<4>,
+	&decode_LPC_unrolled<5>,  &decode_LPC_unrolled<6>,
+	&decode_LPC_unrolled<7>,  &decode_LPC_unrolled<8>,
+	&decode_LPC_unrolled<9>,  &decode_LPC_unrolled<10>,
+	&decode_LPC_unrolled<11>, &decode_LPC_unrolled<12>,
+	&decode_LPC_unrolled<13>, &decode_LPC_unrolled<14>,
+	&decode_LPC_unrolled<15>, &decode_LPC_unrolled<16>
+};
+
+static const int MAX_UNROLLED_ORDER =
+	sizeof(unrolled_LPC) / sizeof(unrolled_LPC[0]) - 1;
+
 void SonarcAudioSample::decode_LPC(int order, int nsamples,
 						uint8* dest, const uint8* factors)
 {
-	uint8 *startdest = dest;
-	dest -= order;
-
 	// basic linear predictive (de)coding
 	// the errors this produces are fixed by decode_EC
 
-	for (int i = 0; i < nsamples; ++i) {
-		uint8* loopdest = dest++;
-		int accum = 0;
-		for (int j = order-1; j >= 0; --j) {
-			sint8 val1 = (loopdest<startdest)? 0: (*loopdest);
-			loopdest++;
-			val1 ^= 0x80;
-			sint16 val2 = factors[j*2] + (factors[j*2+1]<<8);
-			accum += (int)val1 * val2;
-		}
+	// Each sample depends on the ones just decoded, so this can't be done
+	// on several samples at once. Instead the taps are unrolled for each
+	// order.
+	int tap[256];
+	for (int j = 0; j < order; ++j)
+		tap[j] = (sint16)(factors[j*2] + (factors[j*2+1]<<8));
 
-		accum += 0x00000800;
-		*loopdest -= (sint8)((accum >> 12) & 0xFF);
+	if (order == 0 || order > MAX_UNROLLED_ORDER) {
+		decode_LPC_generic(order, 0, nsamples, dest, tap);
+		return;
 	}
+
+	// the first few reach back past the start of the frame
+	int head = (order < nsamples) ? order : nsamples;
+	decode_LPC_generic(order, 0, head, dest, tap);
+	unrolled_LPC[order](head, nsamples, dest, tap);
 }
 
 int SonarcAudioSample::audio_decode(const uint8* source, uint8* dest)
@@ -238,6 +295,40 @@ uint32 SonarcAudioSample::decompressFrame(void *DecompData, void *samples) const
 	return frame_samples;
 }
 
+AudioSample* SonarcAudioSample::decodeAll(uint32 max_bytes) const
+{
+	if (length > max_bytes) return 0;
+
+	// Decode each frame straight to its place, as decompressFrame would
+	// have it.
+	uint8 *data = new uint8[length];
+	uint32 pos = src_offset;
+	uint32 sample_pos = 0;
+	while (pos + 4 <= buffer_size && sample_pos < length) {
+		uint32 frame_bytes = buffer[pos] | (buffer[pos+1] << 8);
+		uint32 frame_samples = buffer[pos+2] | (buffer[pos+3] << 8);
+		if (frame_bytes == 0 || pos + frame_bytes > buffer_size ||
+			sample_pos + frame_samples > length)
+		{
+			// not the usual layout, so leave it to the frame by frame path
+			delete [] data;
+			return AudioSample::decodeAll(max_bytes);
+		}
+
+		if (audio_decode(buffer+pos, data+sample_pos) != 0)
+			std::memset(data+sample_pos, 0x80, frame_samples);
+
+		pos += frame_bytes;
+		sample_pos += frame_samples;
+	}
+
+	if (sample_pos == 0) {
+		delete [] data;
+		return 0;
+	}
+	return new RawAudioSample(data, sample_pos, sample_rate, false, stereo);
+}
+
 void SonarcAudioSample::rewind(void *DecompData) const
 {
 	SonarcDecompData *decomp = reinterpret_cast<SonarcDecompData *>(DecompData);
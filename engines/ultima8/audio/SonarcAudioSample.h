@@ -50,6 +50,8 @@ public:
 	virtual void initDecompressor(void *DecompData) const;
 	virtual uint32 decompressFrame(void *DecompData, void *samples) const;
 	virtual void rewind(void *DecompData) const;
+
+	virtual AudioSample* decodeAll(uint32 max_bytes) const;
 };
 
 };
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "FileSystem.h"
 #include "IDataSource.h"
+#include "ODataSource.h"
 
 using Pentagram::istring;
 using std::string;
@@ -114,14 +115,140 @@ bool INIFile::readConfigFile(string fname)
 
 	delete f;
 
-	if (!readConfigString(sbuf))
-		return false;
+	// A cached copy of the parsed sections saves parsing the file again,
+	// as long as the contents are still the same.
+	uint32 hash = hashContents(sbuf);
+	if (!readCache(fname, sbuf.size(), hash)) {
+		std::list<Section>::size_type oldcount = sections.size();
+		if (!readConfigString(sbuf))
+			return false;
+		writeCache(fname, sbuf.size(), hash, oldcount);
+	}
 
 	is_file = true; // readConfigString sets is_file = false
 	filename = fname;
 	return true;	
 }
 
+static const uint32 CACHE_MAGIC = 0x494E4943; // "CINI"
+static const uint32 CACHE_VERSION = 1;
+
+uint32 INIFile::hashContents(const string& s)
+{
+	// 32 bit FNV-1a
+	uint32 hash = 2166136261U;
+	for (string::size_type i = 0; i < s.size(); ++i) {
+		hash ^= static_cast<uint8>(s[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+string INIFile::getCacheName(const string& fname)
+{
+	string name = "@home/cache/";
+	for (string::size_type i = 0; i < fname.size(); ++i) {
+		char c = fname[i];
+		if (c == '@') continue;
+		if (c == '/' || c == '\\' || c == ':') c = '_';
+		name += c;
+	}
+	return name + ".bin";
+}
+
+static bool readCacheString(IDataSource* ds, string& s)
+{
+	uint32 len = ds->read4();
+	if (len > ds->getSize() - ds->getPos()) return false;
+	s.resize(len);
+	if (len > 0) ds->read(&s[0], len);
+	return true;
+}
+
+static bool readCacheString(IDataSource* ds, istring& s)
+{
+	string t;
+	if (!readCacheString(ds, t)) return false;
+	s = istring(t.data(), t.size());
+	return true;
+}
+
+static void writeCacheString(ODataSource* ds, const string& s)
+{
+	ds->write4(s.size());
+	ds->write(s.data(), s.size());
+}
+
+static void writeCacheString(ODataSource* ds, const istring& s)
+{
+	ds->write4(s.size());
+	ds->write(s.data(), s.size());
+}
+
+bool INIFile::readCache(const string& fname, uint32 size, uint32 hash)
+{
+	IDataSource* ds = FileSystem::get_instance()->ReadFile(
+		getCacheName(fname));
+	if (!ds) return false;
+
+	std::list<Section> cached;
+	bool ok = ds->getSize() >= 20 && ds->read4() == CACHE_MAGIC &&
+		ds->read4() == CACHE_VERSION && ds->read4() == size &&
+		ds->read4() == hash;
+	uint32 count = ok ? ds->read4() : 0;
+	for (uint32 i = 0; ok && i < count; ++i) {
+		cached.push_back(Section());
+		Section& section = cached.back();
+		ok = readCacheString(ds, section.name) &&
+			readCacheString(ds, section.comment);
+		uint32 keycount = ok ? ds->read4() : 0;
+		for (uint32 j = 0; ok && j < keycount; ++j) {
+			KeyValue v;
+			ok = readCacheString(ds, v.key) &&
+				readCacheString(ds, v.value) &&
+				readCacheString(ds, v.comment);
+			section.keys.push_back(v);
+		}
+	}
+
+	delete ds;
+
+	if (!ok) return false;
+	sections.splice(sections.end(), cached);
+	return true;
+}
+
+void INIFile::writeCache(const string& fname, uint32 size, uint32 hash,
+						 std::list<Section>::size_type first)
+{
+	FileSystem* filesys = FileSystem::get_instance();
+	filesys->MkDir("@home/cache");
+	ODataSource* ds = filesys->WriteFile(getCacheName(fname));
+	if (!ds) return;
+
+	std::list<Section>::const_iterator iter = sections.begin();
+	std::advance(iter, first);
+
+	ds->write4(CACHE_MAGIC);
+	ds->write4(CACHE_VERSION);
+	ds->write4(size);
+	ds->write4(hash);
+	ds->write4(sections.size() - first);
+	for (; iter != sections.end(); ++iter) {
+		writeCacheString(ds, iter->name);
+		writeCacheString(ds, iter->comment);
+		ds->write4(iter->keys.size());
+		std::list<KeyValue>::const_iterator k;
+		for (k = iter->keys.begin(); k != iter->keys.end(); ++k) {
+			writeCacheString(ds, k->key);
+			writeCacheString(ds, k->value);
+			writeCacheString(ds, k->comment);
+		}
+	}
+
+	delete ds;
+}
+
 
 static void rtrim(string& s)
 {
@@ -104,6 +104,19 @@ private:
 	bool splitKey(Pentagram::istring key, Pentagram::istring& section,
 				  Pentagram::istring& sectionkey);
 
+	//! A binary copy of the sections parsed from a file is kept in
+	//! @home/cache, keyed by the size and hash of the file's contents.
+	static uint32 hashContents(const std::string& s);
+	static std::string getCacheName(const std::string& fname);
+
+	//! append the sections of fname from its cache
+	//! \return false if there is no cache for these contents
+	bool readCache(const std::string& fname, uint32 size, uint32 hash);
+
+	//! write the sections from index first on to the cache of fname
+	void writeCache(const std::string& fname, uint32 size, uint32 hash,
+					std::list<Section>::size_type first);
+
 };
 
 #endif
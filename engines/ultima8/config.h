@@ -15,6 +15,7 @@
 #define HAVE_SYS_STAT_H 1
 #define HAVE_SYS_TYPES_H 1
 #define HAVE_UNISTD_H 1
+#define HAVE_SYS_MMAN_H 1
 #define HAVE_DIRENT_H 1
 #define HAVE_STDINT_H 1
 #define HAVE_INTTYPES_H 1
@@ -210,7 +210,8 @@ void ConvertShapeFrame::Read(IDataSource *source, const ConvertShapeFormat *csf,
 
 void ConvertShapeFrame::ReadCmpFrame(IDataSource *source, const ConvertShapeFormat *csf, const uint8 special[256], ConvertShapeFrame *prev)
 {
-	static OAutoBufferDataSource *rlebuf = 0;
+	// One per thread, as flexes are converted in parallel
+	static thread_local OAutoBufferDataSource *rlebuf = 0;
 	uint8 outbuf[512];
 
 	// Read unknown
@@ -98,7 +98,8 @@ class ConvertShape
 	ConvertShapeFrame	*frames;
 
 public:
-	ConvertShape() : num_frames(0), frames(0)
+	// header_unknown is zeroed, as it's written even if never read
+	ConvertShape() : header_unknown(), num_frames(0), frames(0)
 	{
 	}
 
@@ -84,6 +84,8 @@ protected:
 	uint32 count;
 
 	uint8* getRawObject(uint32 index, uint32* sizep=0);
+	//! Get an object without copying it (see ArchiveFile::getMappedObject)
+	const uint8* getMappedObject(uint32 index, uint32* sizep=0);
 	uint32 getRawSize(uint32 index);
 
 private:
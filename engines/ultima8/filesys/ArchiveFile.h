@@ -60,6 +60,15 @@ public:
 	virtual uint8* getObject(const std::string& name, uint32* size=0)=0;
 
 
+	//! Get object without copying it, if the file is mapped into memory.
+	//! Do not delete the returned buffer. It stays valid as long as the
+	//! ArchiveFile does.
+	//! \param index index of object to fetch
+	//! \param size if non-NULL, size of object is stored in *size
+	//! \return 0 if index is invalid, or the file is not mapped
+	virtual const uint8* getMappedObject(uint32 index, uint32* size=0)
+		{ return 0; }
+
 	//! Get size of object; returns zero if index is invalid.
 	//! See also exists(uint32 index)
 	//! \param index index of object to get size of
@@ -0,0 +1,109 @@
+/*
+Copyright (C) 2003-2005 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "filesys/BackgroundSavegameWriter.h"
+#include "filesys/ODataSource.h"
+
+BackgroundSavegameWriter::BackgroundSavegameWriter(ODataSource* ds_)
+	: SavegameWriter(ds_), thread(0), done(false), ok(false)
+{
+	mutex = SDL_CreateMutex();
+}
+
+BackgroundSavegameWriter::~BackgroundSavegameWriter()
+{
+	wait();
+	SDL_DestroyMutex(mutex);
+}
+
+bool BackgroundSavegameWriter::writeFile(const char* name,
+										 const uint8* data, uint32 size)
+{
+	if (thread || done) return false;
+
+	perr << name << ": " << size << std::endl;
+
+	entries.push_back(Entry());
+	Entry& entry = entries.back();
+	entry.name = name;
+	entry.data.assign(data, data + size);
+
+	return true;
+}
+
+bool BackgroundSavegameWriter::start()
+{
+	if (thread || done) return false;
+
+	thread = SDL_CreateThread(threadMain_Static, "SavegameWriter",
+							  static_cast<void*>(this));
+	if (!thread) {
+		// write it right now instead
+		threadMain();
+	}
+	return true;
+}
+
+bool BackgroundSavegameWriter::isDone()
+{
+	SDL_LockMutex(mutex);
+	bool d = done;
+	SDL_UnlockMutex(mutex);
+	return d;
+}
+
+bool BackgroundSavegameWriter::wait()
+{
+	if (thread) {
+		SDL_WaitThread(thread, 0);
+		thread = 0;
+	}
+	return ok;
+}
+
+int SDLCALL BackgroundSavegameWriter::threadMain_Static(void* data)
+{
+	static_cast<BackgroundSavegameWriter*>(data)->threadMain();
+	return 0;
+}
+
+void BackgroundSavegameWriter::threadMain()
+{
+	bool success = true;
+
+	std::vector<Entry>::iterator it;
+	for (it = entries.begin(); it != entries.end() && success; ++it) {
+		const uint8* data = it->data.empty() ? 0 : &it->data[0];
+		success = writeZipEntry(it->name.c_str(), data,
+								static_cast<uint32>(it->data.size()));
+	}
+
+	if (!finish()) success = false;
+
+	// close the file before anyone can read it
+	delete ds;
+	ds = 0;
+	entries.clear();
+
+	SDL_LockMutex(mutex);
+	ok = success;
+	done = true;
+	SDL_UnlockMutex(mutex);
+}
@@ -0,0 +1,68 @@
+/*
+Copyright (C) 2003-2005 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef BACKGROUNDSAVEGAMEWRITER_H
+#define BACKGROUNDSAVEGAMEWRITER_H
+
+#include "filesys/SavegameWriter.h"
+
+#include <vector>
+#include <SDL3/SDL.h>
+#include "misc/sdl2_compat.h"
+
+//! SavegameWriter that collects copies of the files first, and compresses
+//! and writes them on a background thread once start() is called.
+class BackgroundSavegameWriter : public SavegameWriter
+{
+public:
+	explicit BackgroundSavegameWriter(ODataSource* ds);
+	//! waits for the background thread to finish
+	virtual ~BackgroundSavegameWriter();
+
+	//! queue a file for the savegame. The data is copied.
+	virtual bool writeFile(const char* name, const uint8* data, uint32 size);
+	using SavegameWriter::writeFile;
+
+	//! start writing the queued files. No files can be added after this.
+	bool start();
+
+	//! has the background thread finished?
+	bool isDone();
+
+	//! wait for the background thread to finish
+	//! \return true if the savegame was written successfully
+	bool wait();
+
+private:
+	struct Entry {
+		std::string name;
+		std::vector<uint8> data;
+	};
+
+	static int SDLCALL threadMain_Static(void* data);
+	void threadMain();
+
+	std::vector<Entry> entries;
+
+	SDL_Thread* thread;
+	SDL_Mutex* mutex;
+	bool done;
+	bool ok;
+};
+
+#endif
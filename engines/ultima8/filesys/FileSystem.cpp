@@ -36,6 +36,7 @@
 using	std::string;
 
 #include "filesys/ListFiles.h"
+#include "filesys/MappedDataSource.h"
 
 #if defined(WIN32)
 #define WIN32_LEAN_AND_MEAN
@@ -114,6 +115,32 @@ IDataSource* FileSystem::ReadFile(const string &vfn, bool is_text)
 	return new IFileDataSource(f);
 }
 
+// Map a file into memory, or open it as readable (0 on failure)
+IDataSource* FileSystem::MapFile(const string &vfn)
+{
+	IDataSource* data = checkBuiltinData(vfn);
+
+	// allow data-override?
+	if (!allowdataoverride && data) return data;
+
+	string name = vfn;
+	if (!rewrite_virtual_path(name)) return data;
+	switch_slashes(name);
+
+	int uppercasecount = 0;
+	do {
+		IDataSource* mapped = IMappedDataSource::map(name);
+		if (mapped) {
+			delete data;
+			return mapped;
+		}
+	} while (base_to_uppercase(name, ++uppercasecount));
+
+	// can't be mapped, so stream it instead
+	delete data;
+	return ReadFile(vfn);
+}
+
 // Open a streaming file as readable. Streamed (0 on failure)
 ODataSource* FileSystem::WriteFile(const string &vfn, bool is_text)
 {
@@ -51,6 +51,12 @@ class FileSystem
 	//! \return 0 on failure
 	IDataSource *ReadFile(const std::string &vfn, bool is_text=false);
 
+	//! Open a file as readable, mapping all of it into memory if possible.
+	//! If it can't be mapped it is opened as by ReadFile.
+	//! \param vfn the (virtual) filename
+	//! \return 0 on failure
+	IDataSource *MapFile(const std::string &vfn);
+
 	//! Open a file as writable. Streamed.
 	//! \param vfn the (virtual) filename
 	//! \param is_text open in text mode?
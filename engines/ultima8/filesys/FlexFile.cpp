@@ -90,6 +90,22 @@ uint8* FlexFile::getObject(uint32 index, uint32* sizep)
 	return object;
 }
 
+const uint8* FlexFile::getMappedObject(uint32 index, uint32* sizep)
+{
+	const uint8* data = ds->getMappedData();
+	if (!data || index >= count) return 0;
+
+	uint32 size = getSize(index);
+	if (size == 0) return 0;
+
+	uint32 offset = getOffset(index);
+	if (offset > ds->getSize() || size > ds->getSize() - offset) return 0;
+
+	if (sizep) *sizep = size;
+
+	return data + offset;
+}
+
 uint32 FlexFile::getSize(uint32 index)
 {
 	if (index >= count) return 0;
@@ -51,6 +51,8 @@ public:
 	}
 	
 
+	virtual const uint8* getMappedObject(uint32 index, uint32* size=0);
+
 	virtual uint32 getSize(uint32 index);
 	virtual uint32 getSize(const std::string& name) {
 		uint32 index;
@@ -114,6 +114,13 @@ class IDataSource
 			return 0; 
 		}
 
+		//! Get all the data, if it is mapped into memory (see
+		//! IMappedDataSource). It stays valid until the source is deleted.
+		//! \return 0 if it isn't mapped
+		virtual const uint8* getMappedData() {
+			return 0;
+		}
+
 		/* SDL_RWops functionality removed for SDL3 compatibility */
 		/* Use IDataSource methods directly instead */
 };
@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "filesys/MappedDataSource.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+IMappedDataSource* IMappedDataSource::map(const std::string& filename)
+{
+#ifdef HAVE_SYS_MMAN_H
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) return 0;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+		close(fd);
+		return 0;
+	}
+
+	void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping stays valid
+	if (data == MAP_FAILED) return 0;
+
+	return new IMappedDataSource(data, static_cast<unsigned int>(st.st_size));
+#else
+	return 0;
+#endif
+}
+
+IMappedDataSource::~IMappedDataSource()
+{
+#ifdef HAVE_SYS_MMAN_H
+	munmap(const_cast<void*>(mapping), mapping_size);
+#endif
+}
@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef MAPPEDDATASOURCE_H
+#define MAPPEDDATASOURCE_H
+
+#include "filesys/IDataSource.h"
+
+//
+// IMappedDataSource. A file mapped read-only into memory. The OS pages it
+// in when it is read, and can drop the pages again under memory pressure.
+//
+
+class IMappedDataSource : public IBufferDataSource
+{
+public:
+	//! Map a file.
+	//! \param filename the real (not virtual) filename
+	//! \return 0 if the file can't be mapped
+	static IMappedDataSource* map(const std::string& filename);
+
+	virtual ~IMappedDataSource();
+
+	virtual const uint8* getMappedData() { return buf; }
+
+private:
+	IMappedDataSource(const void* data, unsigned int len)
+		: IBufferDataSource(data, len), mapping(data), mapping_size(len) { }
+
+	const void* mapping;
+	unsigned int mapping_size;
+};
+
+#endif
@@ -19,6 +19,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "pent_include.h"
 #include "OutputLogger.h"
+#include "profiler/Async_log.h"
 
 #include <cstdio>
 #include <unistd.h>
@@ -100,6 +101,9 @@ OutputLogger::OutputLogger(FILE *file, const std::string &filename) :
 
 OutputLogger::~OutputLogger(void)
 {
+	// Write out what the console has queued, while it still goes to the log
+	Async_log::get().flush();
+
 	// Replace fd with it's original details
 	if (fileOld && fd >= 0) {
 		_dup2(_fileno(fileOld),fd);
@@ -158,7 +162,7 @@ int OutputLogger::ThreadMain()
 	int numread;
 
 	// Read from the pipe (till its broken)
-	while ((numread = _read( fdPipeRead, buffer, 256)) > 0) { 
+	while ((numread = _read( fdPipeRead, buffer, sizeof(buffer))) > 0) { 
 		// Write to the duplicated original file stream
 		if (fileOld) {
 			fwrite(buffer, 1, numread, fileOld);
@@ -72,8 +72,14 @@ bool SavegameWriter::finish()
 bool SavegameWriter::writeFile(const char* name,
 							   const uint8* data, uint32 size)
 {
-	PentZip::zipFile zfile = static_cast<PentZip::zipFile>(zipfile);
 	perr << name << ": " << size << std::endl;
+	return writeZipEntry(name, data, size);
+}
+
+bool SavegameWriter::writeZipEntry(const char* name,
+								   const uint8* data, uint32 size)
+{
+	PentZip::zipFile zfile = static_cast<PentZip::zipFile>(zipfile);
 
 	// Because zlib's deflate causes false positives in valgrind,
 	// check the data to be saved manually, so deflate can be
@@ -51,6 +51,9 @@ public:
 	bool finish();
 
 protected:
+	//! compress and add a file to the zip, without logging
+	bool writeZipEntry(const char* name, const uint8* data, uint32 size);
+
 	ODataSource* ds;
 	std::string comment;
 	void* zipfile;
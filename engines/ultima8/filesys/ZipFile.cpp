@@ -15,229 +15,255 @@ You should have received a copy of the GNU General Public License
 along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
-
 #include "pent_include.h"
 
 #include "filesys/ZipFile.h"
 #include "filesys/IDataSource.h"
 #include "filesys/FileSystem.h"
 
-// unzip API
-#include "filesys/zip/unzip.h"
+#include <cstring>
+#include <vector>
+#include <zlib.h>
 
 DEFINE_RUNTIME_CLASSTYPE_CODE(NamedArchiveFile,ArchiveFile)
 
 DEFINE_RUNTIME_CLASSTYPE_CODE(ZipFile,NamedArchiveFile);
 
+static const uint32 ZIP_DIRECTORY_END = 0x06054b50;
+static const uint32 ZIP_DIRECTORY_ENTRY = 0x02014b50;
+static const uint32 ZIP_LOCAL_HEADER = 0x04034b50;
 
+static const uint32 DIRECTORY_END_SIZE = 22;
+static const uint32 DIRECTORY_ENTRY_SIZE = 46;
+static const uint32 LOCAL_HEADER_SIZE = 30;
 
-// ioapi IDataSource wrapper functions
-
-static voidpf ids_open(voidpf opaque, const char* filename, int mode);
-static uLong ids_read(voidpf opaque, voidpf stream, void* buf, uLong size);
-static uLong ids_write(voidpf opaque, voidpf stream,
-					   const void* buf, uLong size);
-static long ids_tell(voidpf opaque, voidpf stream);
-static long ids_seek(voidpf opaque, voidpf stream, uLong offset, int origin);
-static int ids_close(voidpf opaque, voidpf stream);
-static int ids_error(voidpf opaque, voidpf stream);
-
-PentZip::zlib_filefunc_def IDS_filefunc_templ = {
-	ids_open, ids_read, ids_write, ids_tell, ids_seek, ids_close, ids_error, 0
-};
+static const uint16 METHOD_STORED = 0;
+static const uint16 METHOD_DEFLATED = 8;
 
 
 ZipFile::ZipFile(IDataSource* ds_)
 {
 	ds = ds_;
-	PentZip::zlib_filefunc_def filefuncs = IDS_filefunc_templ;
-	filefuncs.opaque = static_cast<void*>(ds);
-
-	// filefuncs contains the datasource, so no need to actually use a path
-	PentZip::unzFile unzfile = PentZip::unzOpen2("", &filefuncs);
-
-	valid = (unzfile != 0);
-
-	unzipfile = static_cast<void*>(unzfile);
-
-	if (valid) {
-		valid = readMetadata();
-		if (!valid) PentZip::unzClose(unzfile);
-	}
+	count = 0;
+	valid = readMetadata();
 }
 
 
 ZipFile::~ZipFile()
 {
-	if (valid) {
-		PentZip::unzFile unzfile = static_cast<PentZip::unzFile>(unzipfile);
-		PentZip::unzClose(unzfile);		
-	}
 	delete ds;
 }
 
 //static
-bool ZipFile::isZipFile(IDataSource* ids)
+sint32 ZipFile::findDirectoryEnd(IDataSource* ids)
 {
-	PentZip::zlib_filefunc_def filefuncs = IDS_filefunc_templ;
-	filefuncs.opaque = static_cast<void*>(ids);
-
-	// filefuncs contains the datasource, so no need to actually use a path
-	PentZip::unzFile unzfile = PentZip::unzOpen2("", &filefuncs);
+	uint32 size = ids->getSize();
+	if (size < DIRECTORY_END_SIZE) return -1;
+
+	// The record is at the very end, unless the archive has a comment.
+	// Comments are at most 0xFFFF bytes long.
+	uint32 searchlen = size;
+	if (searchlen > DIRECTORY_END_SIZE + 0xFFFF)
+		searchlen = DIRECTORY_END_SIZE + 0xFFFF;
+
+	std::vector<uint8> buf(searchlen);
+	ids->seek(size - searchlen);
+	if (ids->read(&buf[0], searchlen) != static_cast<sint32>(searchlen))
+		return -1;
 
-	if (unzfile != 0) {
-		PentZip::unzClose(unzfile);
-		return true;
+	for (sint32 i = searchlen - DIRECTORY_END_SIZE; i >= 0; --i) {
+		const uint8* p = &buf[i];
+		if (p[0] == 0x50 && p[1] == 0x4b && p[2] == 0x05 && p[3] == 0x06)
+			return size - searchlen + i;
 	}
 
-	return false;
+	return -1;
+}
+
+//static
+bool ZipFile::isZipFile(IDataSource* ids)
+{
+	return findDirectoryEnd(ids) >= 0;
 }
 
 bool ZipFile::readMetadata()
 {
-	PentZip::unzFile unzfile = static_cast<PentZip::unzFile>(unzipfile);
+	sint32 endpos = findDirectoryEnd(ds);
+	if (endpos < 0) return false;
+
+	ds->seek(endpos);
+	if (ds->read4() != ZIP_DIRECTORY_END) return false;
+	uint16 disk = ds->read2();
+	uint16 dirdisk = ds->read2();
+	ds->read2();							// entries on this disk
+	uint16 entries = ds->read2();
+	uint32 dirsize = ds->read4();
+	uint32 diroffset = ds->read4();
+	uint16 commentlen = ds->read2();
+
+	// multi volume archives are not supported
+	if (disk != 0 || dirdisk != 0) return false;
+	if (diroffset + dirsize > static_cast<uint32>(endpos)) return false;
 
-	PentZip::unz_global_info ginfo;
-	if (PentZip::unzGetGlobalInfo(unzfile, &ginfo) != UNZ_OK) return false;
+	globalComment = "";
+	if (commentlen > 0) {
+		std::vector<char> comment(commentlen);
+		commentlen = ds->read(&comment[0], commentlen);
+		globalComment.assign(&comment[0], commentlen);
+		// the old reader stopped at a terminating zero
+		std::string::size_type nul = globalComment.find('\0');
+		if (nul != std::string::npos) globalComment.resize(nul);
+	}
 
-	count = ginfo.number_entry;
+	// read the whole directory at once and parse it from memory
+	std::vector<uint8> dir(dirsize);
+	ds->seek(diroffset);
+	if (dirsize > 0 &&
+		ds->read(&dir[0], dirsize) != static_cast<sint32>(dirsize))
+		return false;
+	IBufferDataSource dirds(dirsize ? &dir[0] : 0, dirsize);
+
+	for (uint16 i = 0; i < entries; ++i) {
+		if (dirds.getSize() - dirds.getPos() < DIRECTORY_ENTRY_SIZE)
+			return false;
+		if (dirds.read4() != ZIP_DIRECTORY_ENTRY) return false;
+
+		dirds.skip(4);							// versions
+		uint16 flags = dirds.read2();
+		Member member;
+		member.method = dirds.read2();
+		dirds.skip(8);							// time, date, crc
+		member.compressed = dirds.read4();
+		member.size = dirds.read4();
+		uint16 namelen = dirds.read2();
+		uint16 extralen = dirds.read2();
+		uint16 membercommentlen = dirds.read2();
+		dirds.skip(8);							// disk, attributes
+		member.headeroffset = dirds.read4();
+		member.dataoffset = 0;
+
+		if (dirds.getSize() - dirds.getPos() < namelen) return false;
+		std::string filename(reinterpret_cast<const char*>(
+								 &dir[dirds.getPos()]), namelen);
+		dirds.skip(namelen + extralen + membercommentlen);
+
+		// encrypted members can't be read
+		if (flags & 1) continue;
 
-	globalComment = "";
-	if (ginfo.size_comment > 0) {
-		char* commentbuf = new char[ginfo.size_comment+1];
-		int c = PentZip::unzGetGlobalComment(unzfile,
-											 commentbuf, ginfo.size_comment+1);
-		if (c > 0) globalComment = commentbuf;
-		delete[] commentbuf;
+		storeIndexedName(filename);
+		members[filename] = member;
 	}
 
-	PentZip::unz_file_info info;
-	char name[256];
+	count = entries;
 
-	bool done = (PentZip::unzGoToFirstFile(unzfile) != UNZ_OK);
+	return true;
+}
 
-	while (!done) {
-		int ret = PentZip::unzGetCurrentFileInfo(unzfile, &info, name, 256,
-												 0, 0, 0, 0);
-		if (ret != UNZ_OK) continue;
+bool ZipFile::locateData(Member& member)
+{
+	if (member.dataoffset != 0) return true;
 
-		std::string filename = name;
-		storeIndexedName(filename);
-		sizes[filename] = info.uncompressed_size;
+	// The local header repeats the name, but its extra field may differ
+	// from the one in the central directory.
+	ds->seek(member.headeroffset);
+	if (ds->read4() != ZIP_LOCAL_HEADER) return false;
+	ds->skip(22);
+	uint16 namelen = ds->read2();
+	uint16 extralen = ds->read2();
 
-		done = (PentZip::unzGoToNextFile(unzfile) != UNZ_OK);
-	}
+	uint32 offset = member.headeroffset + LOCAL_HEADER_SIZE +
+		namelen + extralen;
+	if (offset + member.compressed > ds->getSize()) return false;
 
+	member.dataoffset = offset;
 	return true;
 }
 
 bool ZipFile::exists(const std::string& name)
 {
-	std::map<std::string, uint32>::iterator iter;
-	iter = sizes.find(name);
-	return (iter != sizes.end());
+	std::map<std::string, Member>::iterator iter;
+	iter = members.find(name);
+	return (iter != members.end());
 }
 
 uint32 ZipFile::getSize(const std::string& name)
 {
-	std::map<std::string, uint32>::iterator iter;
-	iter = sizes.find(name);
-	if (iter == sizes.end()) return 0;
-	return (iter->second);
+	std::map<std::string, Member>::iterator iter;
+	iter = members.find(name);
+	if (iter == members.end()) return 0;
+	return (iter->second.size);
 }
 
-uint8* ZipFile::getObject(const std::string& name, uint32* sizep)
+bool ZipFile::readObject(const std::string& name, uint8* buf, uint32 size)
 {
-	PentZip::unzFile unzfile = static_cast<PentZip::unzFile>(unzipfile);
-	if (sizep) *sizep = 0;
-
-	if (PentZip::unzLocateFile(unzfile, name.c_str(), 1) != UNZ_OK) return 0;
-
-	PentZip::unz_file_info info;
-	uint8* buf = 0;
-
-	if (PentZip::unzGetCurrentFileInfo(unzfile, &info, 0, 0, 0, 0, 0, 0)
-		!= UNZ_OK)
-		return 0;
-
-	if (PentZip::unzOpenCurrentFile(unzfile) != UNZ_OK) return 0;
-	uint32 size = info.uncompressed_size;
-
-	buf = new uint8[size];
-
-	if (PentZip::unzReadCurrentFile(unzfile, buf, size) < static_cast<int>(size)) {
-		delete[] buf;
-		return 0;
+	std::map<std::string, Member>::iterator iter;
+	iter = members.find(name);
+	if (iter == members.end()) return false;
+
+	Member& member = iter->second;
+	if (size != member.size) return false;
+	if (!locateData(member)) return false;
+	if (size == 0) return true;
+
+	const uint8* mapped = ds->getMappedData();
+
+	if (member.method == METHOD_STORED) {
+		if (member.compressed != member.size) return false;
+		if (mapped) {
+			std::memcpy(buf, mapped + member.dataoffset, size);
+			return true;
+		}
+		ds->seek(member.dataoffset);
+		return ds->read(buf, size) == static_cast<sint32>(size);
 	}
 
-	if (PentZip::unzCloseCurrentFile(unzfile) != UNZ_OK) {
-		delete[] buf;
-		return 0;
+	if (member.method != METHOD_DEFLATED) return false;
+
+	// A mapped archive is inflated in place, otherwise the compressed
+	// data is read in one go first.
+	std::vector<uint8> input;
+	const uint8* in = mapped ? mapped + member.dataoffset : 0;
+	if (!in) {
+		input.resize(member.compressed + 1);
+		ds->seek(member.dataoffset);
+		if (ds->read(&input[0], member.compressed) !=
+			static_cast<sint32>(member.compressed))
+			return false;
+		in = &input[0];
 	}
 
-	if (sizep) *sizep = size;
+	z_stream stream;
+	std::memset(&stream, 0, sizeof(stream));
+	stream.next_in = const_cast<Bytef*>(in);
+	stream.avail_in = member.compressed;
+	stream.next_out = buf;
+	stream.avail_out = size;
 
-	return buf;
-}
+	// negative window bits: raw deflate data without a zlib header
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+	int ret = inflate(&stream, Z_FINISH);
+	inflateEnd(&stream);
 
-
-
-// ------------
-
-static voidpf ids_open(voidpf opaque, const char* filename, int mode)
-{
-	// read-only, for now
-	if (mode != (ZLIB_FILEFUNC_MODE_READ | ZLIB_FILEFUNC_MODE_EXISTING))
-		return 0;
-
-	// opaque is actually the IDataSource*
-	return opaque;
+	return (ret == Z_STREAM_END && stream.total_out == size);
 }
 
-static uLong ids_read(voidpf opaque, voidpf stream, void* buf, uLong size)
+uint8* ZipFile::getObject(const std::string& name, uint32* sizep)
 {
-	IDataSource* ids = static_cast<IDataSource*>(stream);
-	return ids->read(buf, size);
-}
+	if (sizep) *sizep = 0;
 
-static uLong ids_write(voidpf opaque, voidpf stream,
-					   const void* buf, uLong size)
-{
-	return 0;
-}
+	std::map<std::string, Member>::iterator iter;
+	iter = members.find(name);
+	if (iter == members.end()) return 0;
 
-static long ids_tell(voidpf opaque, voidpf stream)
-{
-	IDataSource* ids = static_cast<IDataSource*>(stream);
-	return ids->getPos();
-}
+	uint32 size = iter->second.size;
+	uint8* buf = new uint8[size];
 
-static long ids_seek(voidpf opaque, voidpf stream, uLong offset, int origin)
-{
-	IDataSource* ids = static_cast<IDataSource*>(stream);
-	switch (origin) {
-	case ZLIB_FILEFUNC_SEEK_CUR:
-		ids->skip(offset);
-		break;
-	case ZLIB_FILEFUNC_SEEK_END:
-		ids->seek(ids->getSize()+offset);
-		break;
-	case ZLIB_FILEFUNC_SEEK_SET:
-		ids->seek(offset);
-		break;
-	default:
-		return -1;
+	if (!readObject(name, buf, size)) {
+		delete[] buf;
+		return 0;
 	}
-	return 0;
-}
 
-static int ids_close(voidpf opaque, voidpf stream)
-{
-	return 0;
-}
+	if (sizep) *sizep = size;
 
-static int ids_error(voidpf opaque, voidpf stream)
-{
-	return 0;
+	return buf;
 }
-
@@ -25,6 +25,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 class IDataSource;
 
+//! A zip archive read through its central directory. The directory is
+//! parsed once when the archive is opened, and each member is then read
+//! with a seek to its data; stored members are copied as they are and
+//! deflated ones are inflated straight into the output buffer.
 class ZipFile : public NamedArchiveFile {
 public:
 	ENABLE_RUNTIME_CLASSTYPE();
@@ -40,6 +44,10 @@ public:
 
 	virtual uint32 getSize(const std::string& name);
 
+	//! Read a member into buf, which must hold getSize(name) bytes
+	//! \return true if the member exists and was read completely
+	bool readObject(const std::string& name, uint8* buf, uint32 size);
+
 	virtual uint32 getCount() { return count; }
 
 	static bool isZipFile(IDataSource* ds);
@@ -47,17 +55,30 @@ public:
 	std::string getComment() { return globalComment; }
 
 protected:
+	//! A member as listed in the central directory
+	struct Member {
+		uint32 headeroffset;	//!< offset of the local file header
+		uint32 dataoffset;		//!< offset of the data, 0 until known
+		uint32 compressed;
+		uint32 size;
+		uint16 method;			//!< 0 stored, 8 deflated
+	};
+
+	//! find the end of central directory record
+	//! \return its offset, or -1 if there is none
+	static sint32 findDirectoryEnd(IDataSource* ds);
+
 	bool readMetadata();
 
+	//! get the offset of a member's data, reading its local header
+	//! the first time
+	bool locateData(Member& member);
 
 	IDataSource* ds;
 	uint32 count;
-	std::map<std::string, uint32> sizes;
+	std::map<std::string, Member> members;
 
 	std::string globalComment;
-
-	// unzip internals
-	void* unzipfile;
 };
 
 
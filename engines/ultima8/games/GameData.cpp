@@ -107,6 +107,22 @@ MapGlob* GameData::getGlob(uint32 glob) const
 		return 0;
 }
 
+IDataSource* GameData::openMainShapes(const std::string& filename)
+{
+	FileSystem* filesystem = FileSystem::get_instance();
+	SettingManager* settingman = SettingManager::get_instance();
+
+	// keep the shapes mapped into memory, instead of reading each one
+	bool mapshapes;
+	settingman->setDefault("mapshapes", true);
+	settingman->get("mapshapes", mapshapes);
+
+	if (mapshapes)
+		return filesystem->MapFile(filename);
+	else
+		return filesystem->ReadFile(filename);
+}
+
 ShapeArchive* GameData::getShapeFlex(uint16 flexId) const
 {
 	switch (flexId) {
@@ -254,7 +270,7 @@ void GameData::loadU8Data()
 
 	// Load main shapes
 	pout << "Load Shapes" << std::endl;
-	IDataSource *sf = filesystem->ReadFile("@game/static/u8shapes.flx");
+	IDataSource *sf = openMainShapes("@game/static/u8shapes.flx");
 	if (!sf) sf = filesystem->ReadFile("@game/static/u8shapes.cmp");
 
 	if (!sf) {
@@ -316,6 +332,7 @@ void GameData::loadU8Data()
 		if (globds && globds->getSize()) {
 			glob = new MapGlob();
 			glob->read(globds);
+			glob->buildTemplate(mainshapes);
 		}
 		delete globds;
 
@@ -524,7 +541,7 @@ void GameData::loadRemorseData()
 
 	// Load main shapes
 	pout << "Load Shapes" << std::endl;
-	IDataSource *sf = filesystem->ReadFile("@game/static/shapes.flx");
+	IDataSource *sf = openMainShapes("@game/static/shapes.flx");
 
 	if (!sf) {
 		perr << "Unable to load static/shapes.flx. Exiting" << std::endl;
@@ -588,6 +605,7 @@ void GameData::loadRemorseData()
 		if (globds && globds->getSize()) {
 			glob = new MapGlob();
 			glob->read(globds);
+			glob->buildTemplate(mainshapes);
 		}
 		delete globds;
 
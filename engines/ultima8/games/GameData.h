@@ -36,6 +36,7 @@ class ShapeFrame;
 class SoundFlex;
 class SpeechFlex;
 struct GameInfo;
+class IDataSource;
 
 class GameData
 {
@@ -74,6 +75,7 @@ public:
 		GUMPS		= 2
 	};
 private:
+	IDataSource* openMainShapes(const std::string& filename);
 	void loadTranslation();
 	void setupTTFOverrides(const char* configkey, bool SJIS);
 	void setupJPOverrides();
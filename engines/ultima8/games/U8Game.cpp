@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "MusicProcess.h"
 #include "StartU8Process.h"
 #include "getObject.h"
+#include "startup_profile.h"
 
 U8Game::U8Game() : Game()
 {
@@ -70,18 +71,22 @@ U8Game::~U8Game()
 bool U8Game::loadFiles()
 {
 	// Load palette
-	pout << "Load Palette" << std::endl;
-	IDataSource *pf = FileSystem::get_instance()->ReadFile("@game/static/u8pal.pal");
-	if (!pf) {
-		perr << "Unable to load static/u8pal.pal." << std::endl;
-		return false;
-	}
-	pf->seek(4); // seek past header
+	{
+		Startup_phase phase("palette");
+		pout << "Load Palette" << std::endl;
+		IDataSource *pf = FileSystem::get_instance()->ReadFile("@game/static/u8pal.pal");
+		if (!pf) {
+			perr << "Unable to load static/u8pal.pal." << std::endl;
+			return false;
+		}
+		pf->seek(4); // seek past header
 
-	IBufferDataSource xfds(U8XFormPal,1024);
-	PaletteManager::get_instance()->load(PaletteManager::Pal_Game, *pf, xfds);
-	delete pf;
+		IBufferDataSource xfds(U8XFormPal,1024);
+		PaletteManager::get_instance()->load(PaletteManager::Pal_Game, *pf, xfds);
+		delete pf;
+	}
 
+	Startup_phase phase("GameData");
 	pout << "Load GameData" << std::endl;
 	GameData::get_instance()->loadU8Data();
 
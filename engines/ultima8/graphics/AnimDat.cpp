@@ -147,6 +147,8 @@ void AnimDat::load(IDataSource *ds)
 					a->actions[action]->frames[dir].push_back(f);
 				}
 			}
+
+			a->actions[action]->buildTravelTables();
 		}
 
 		anims[shape] = a;
@@ -233,6 +233,23 @@ BaseSoftRenderSurface::BaseSoftRenderSurface(int w, int h) :
 }
 
 
+//
+// BaseSoftRenderSurface::BaseSoftRenderSurface(const BaseSoftRenderSurface *)
+//
+// Desc: Constructor for a view of another surface. It shares the pixels,
+//       but owns nothing.
+//
+BaseSoftRenderSurface::BaseSoftRenderSurface(const BaseSoftRenderSurface *o) :
+	pixels(o->pixels), pixels00(o->pixels00),
+	zbuffer(o->zbuffer), zbuffer00(o->zbuffer00),
+	bytes_per_pixel(o->bytes_per_pixel), bits_per_pixel(o->bits_per_pixel),
+	format_type(o->format_type), ox(o->ox), oy(o->oy),
+	width(o->width), height(o->height), pitch(o->pitch), zpitch(o->zpitch),
+	flipped(o->flipped), clip_window(o->clip_window), lock_count(0),
+	sdl_surf(0), rtt_tex(0)
+{
+}
+
 //
 // BaseSoftRenderSurface::~BaseSoftRenderSurface()
 //
@@ -368,6 +385,9 @@ Texture *BaseSoftRenderSurface::GetSurfaceAsTexture()
 //
 void BaseSoftRenderSurface::CreateNativePalette(Pentagram::Palette* palette)
 {
+	// Lets cached frames know their colours are out of date
+	palette->revision = Pentagram::Palette::nextRevision();
+
 	for (int i = 0; i < 256; i++)
 	{
 		sint32 r,g,b;
@@ -75,6 +75,10 @@ protected:
 	// Create Generic
 	BaseSoftRenderSurface(int w, int h, int bpp, int rsft, int gsft, int bsft, int asft);
 	BaseSoftRenderSurface(int w, int h, uint8 *buf);
+
+	// Create a view of another surface (see CreateView)
+	explicit BaseSoftRenderSurface(const BaseSoftRenderSurface *);
+
 	virtual ECode GenericLock()  { return P_NO_ERROR; }
 	virtual ECode GenericUnlock()  { return P_NO_ERROR; }
 
@@ -22,10 +22,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "IDataSource.h"
 #include "Texture.h"
 #include <cstring>
+#include <atomic>
 
 namespace Pentagram
 {
 
+uint32 Palette::nextRevision()
+{
+	// movie palettes are converted on the SKFPlayer's decoding thread
+	static std::atomic<uint32> last_revision(0);
+	uint32 revision = ++last_revision;
+	if (revision == 0) revision = ++last_revision;
+	return revision;
+}
+
 void Palette::load(IDataSource& ds, IDataSource& xformds)
 {
 	load(ds);
@@ -55,6 +65,7 @@ void Palette::load(IDataSource& ds)
 	matrix[8] = 0;		matrix[9] = 0;		matrix[10] = 0x800;	matrix[11] = 0;
 
 	transform=Transform_None;
+	revision=0;
 }
 
 }
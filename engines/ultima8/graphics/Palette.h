@@ -57,6 +57,9 @@ struct Palette
 	void load(IDataSource& ds, IDataSource& xformds);
 	void load(IDataSource& ds);
 
+	//! Get a new value for revision
+	static uint32 nextRevision();
+
 	// 256 rgb entries
 	uint8 palette[768];
 
@@ -82,6 +85,10 @@ struct Palette
 
 	// The current palette transform
 	PalTransforms transform;
+
+	// Changes every time native and xform are recreated, and is never
+	// the same for two palettes. 0 until the RenderSurface set it up.
+	uint32 revision;
 };
 
 }
@@ -89,18 +89,9 @@ PaletteFaderProcess::~PaletteFaderProcess(void)
 
 void PaletteFaderProcess::run()
 {
-	sint16	matrix[12];
-
-	for (int i = 0; i < 12; i++)
-	{
-		sint32 o = old_matrix[i] * counter;
-		sint32 n = new_matrix[i] * (max_counter-counter);
-		matrix[i] = static_cast<sint16>((o + n)/max_counter);
-	}
-
-	PaletteManager::get_instance()->transformPalette(
-			PaletteManager::Pal_Game, 
-			matrix);
+	PaletteManager::get_instance()->fadePalette(
+			PaletteManager::Pal_Game,
+			old_matrix, new_matrix, counter, max_counter);
 	
 	if (!counter--) terminate();
 }
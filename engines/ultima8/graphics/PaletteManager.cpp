@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "RenderSurface.h"
 #include "Texture.h"
 
+#include <cstring>
+
 PaletteManager* PaletteManager::palettemanager = 0;
 
 PaletteManager::PaletteManager(RenderSurface *rs)
@@ -38,6 +40,7 @@ PaletteManager::~PaletteManager()
 {
 	reset();
 	con.Print(MM_INFO, "Destroying PaletteManager...\n");
+	clearFades();
 	palettemanager = 0;
 }
 
@@ -49,6 +52,7 @@ void PaletteManager::reset()
 	for (unsigned int i = 0; i < palettes.size(); ++i)
 		delete palettes[i];
 	palettes.clear();
+	clearFades();
 }
 
 void PaletteManager::updatedFont(PalIndex index)
@@ -56,6 +60,7 @@ void PaletteManager::updatedFont(PalIndex index)
 	Pentagram::Palette* pal = getPalette(index);
 	if (pal)
 		rendersurface->CreateNativePalette(pal); // convert to native format
+	clearFades();
 }
 
 // Reset all the transforms back to default
@@ -80,6 +85,7 @@ void PaletteManager::resetTransforms()
 void PaletteManager::RenderSurfaceChanged(RenderSurface* rs)
 {
 	rendersurface = rs;
+	clearFades();
 
 	// Create native palettes for all currently loaded palettes
 	for (unsigned int i = 0; i < palettes.size(); ++i)
@@ -100,6 +106,7 @@ void PaletteManager::load(PalIndex index, IDataSource& ds,IDataSource &xformds)
 	rendersurface->CreateNativePalette(pal); // convert to native format
 
 	palettes[index] = pal;
+	clearFades();
 }
 
 void PaletteManager::load(PalIndex index, IDataSource& ds)
@@ -115,6 +122,7 @@ void PaletteManager::load(PalIndex index, IDataSource& ds)
 	rendersurface->CreateNativePalette(pal); // convert to native format
 
 	palettes[index] = pal;
+	clearFades();
 }
 
 void PaletteManager::duplicate(PalIndex src, PalIndex dest)
@@ -130,6 +138,7 @@ void PaletteManager::duplicate(PalIndex src, PalIndex dest)
 	if (palettes.size() <= static_cast<unsigned int>(dest))
 		palettes.resize(dest+1);
 	palettes[dest] = newpal;
+	clearFades();
 }
 
 Pentagram::Palette* PaletteManager::getPalette(PalIndex index)
@@ -150,6 +159,101 @@ void PaletteManager::transformPalette(PalIndex index, sint16 matrix[12])
 	rendersurface->CreateNativePalette(pal); // convert to native format
 }
 
+void PaletteManager::fadePalette(PalIndex index, const sint16 from[12],
+								 const sint16 to[12], sint32 step,
+								 sint32 steps)
+{
+	Pentagram::Palette *pal = getPalette(index);
+
+	if (!pal || steps <= 0) return;
+	if (step < 0) step = 0;
+	if (step > steps) step = steps;
+
+	FadeTable* fade = getFadeTable(index, from, to, steps);
+
+	std::memcpy(pal->matrix, &fade->matrices[12*step], 12*sizeof(sint16));
+	std::memcpy(pal->native, &fade->native[256*step], 256*sizeof(uint32));
+	std::memcpy(pal->xform, &fade->xform[256*step], 256*sizeof(uint32));
+	pal->revision = Pentagram::Palette::nextRevision();
+}
+
+PaletteManager::FadeTable* PaletteManager::getFadeTable(PalIndex index,
+														const sint16 from[12],
+														const sint16 to[12],
+														sint32 steps)
+{
+	std::vector<FadeTable*>::iterator iter;
+	for (iter = fades.begin(); iter != fades.end(); ++iter) {
+		FadeTable* fade = *iter;
+		if (fade->index == index && fade->steps == steps &&
+			std::memcmp(fade->from, from, sizeof(fade->from)) == 0 &&
+			std::memcmp(fade->to, to, sizeof(fade->to)) == 0)
+		{
+			// move it to the front
+			fades.erase(iter);
+			fades.insert(fades.begin(), fade);
+			return fade;
+		}
+	}
+
+	if (fades.size() >= PALETTEMANAGER_MAX_FADES) {
+		delete fades.back();
+		fades.pop_back();
+	}
+
+	FadeTable* fade = new FadeTable;
+	fade->index = index;
+	std::memcpy(fade->from, from, sizeof(fade->from));
+	std::memcpy(fade->to, to, sizeof(fade->to));
+	fade->steps = steps;
+	fade->matrices.resize(12*(steps+1));
+	fade->native.resize(256*(steps+1));
+	fade->xform.resize(256*(steps+1));
+
+	// let the RenderSurface convert a copy of the palette for every step
+	Pentagram::Palette* tmp = new Pentagram::Palette(*getPalette(index));
+	for (sint32 s = 0; s <= steps; ++s) {
+		for (int i = 0; i < 12; i++) {
+			sint32 o = from[i] * s;
+			sint32 n = to[i] * (steps-s);
+			tmp->matrix[i] = static_cast<sint16>((o + n)/steps);
+		}
+		rendersurface->CreateNativePalette(tmp);
+
+		std::memcpy(&fade->matrices[12*s], tmp->matrix, 12*sizeof(sint16));
+		std::memcpy(&fade->native[256*s], tmp->native, 256*sizeof(uint32));
+		std::memcpy(&fade->xform[256*s], tmp->xform, 256*sizeof(uint32));
+	}
+	delete tmp;
+
+	fades.insert(fades.begin(), fade);
+	return fade;
+}
+
+void PaletteManager::clearFades()
+{
+	for (unsigned int i = 0; i < fades.size(); ++i)
+		delete fades[i];
+	fades.clear();
+}
+
+void PaletteManager::paletteStats()
+{
+	uint32 memory = 0;
+	for (unsigned int i = 0; i < fades.size(); ++i) {
+		memory += sizeof(FadeTable);
+		memory += fades[i]->matrices.size() * sizeof(sint16);
+		memory += fades[i]->native.size() * sizeof(uint32);
+		memory += fades[i]->xform.size() * sizeof(uint32);
+	}
+
+	pout << "Palette memory stats:" << std::endl;
+	pout << "Palettes   : " << palettes.size() << std::endl;
+	pout << "Fades      : " << fades.size() << "/"
+		 << PALETTEMANAGER_MAX_FADES << ", " << memory << " bytes"
+		 << std::endl;
+}
+
 void PaletteManager::untransformPalette(PalIndex index)
 {
 	Pentagram::Palette *pal = getPalette(index);
@@ -25,6 +25,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 class IDataSource;
 class RenderSurface;
 
+//! number of fades whose native palettes are kept
+#define PALETTEMANAGER_MAX_FADES	4
+
 class PaletteManager
 {
 public:
@@ -54,6 +57,19 @@ public:
 	//! reset the transformation matrix of a palette
 	void untransformPalette(PalIndex index);
 
+	//! Apply a step of a fade between two transform matrices to a palette.
+	//! The matrix is (from*step + to*(steps-step))/steps.
+	//! The native palettes of all steps are computed on the first call, and
+	//! kept for later fades between the same matrices.
+	void fadePalette(PalIndex index, const sint16 from[12],
+					 const sint16 to[12], sint32 step, sint32 steps);
+
+	//! Drop the precomputed fades
+	void clearFades();
+
+	//! Print memory used by the precomputed fades
+	void paletteStats();
+
 	// Get a TransformMatrix from a PalTransforms value (-4.11 fixed)
 	static void getTransformMatrix(sint16 matrix[12],
 								   Pentagram::PalTransforms trans);
@@ -72,9 +88,25 @@ public:
 	void resetTransforms();
 
 private:
+	//! The native palettes of every step of a fade
+	struct FadeTable {
+		PalIndex index;
+		sint16 from[12];
+		sint16 to[12];
+		sint32 steps;
+		std::vector<sint16> matrices;	//!< 12 per step
+		std::vector<uint32> native;		//!< 256 per step
+		std::vector<uint32> xform;		//!< 256 per step
+	};
+
+	FadeTable* getFadeTable(PalIndex index, const sint16 from[12],
+							const sint16 to[12], sint32 steps);
+
 	std::vector<Pentagram::Palette*> palettes;
 	RenderSurface *rendersurface;
 
+	std::vector<FadeTable*> fades;	//!< most recently used first
+
 	static PaletteManager* palettemanager;
 };
 
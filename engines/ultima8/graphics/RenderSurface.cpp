@@ -45,6 +45,57 @@ uint8 RenderSurface::Gamma22toGamma10[256];
 static SDL_Window *g_window = nullptr;
 static SDL_Surface *g_window_surface = nullptr;
 
+// Accelerated presenting: the frame is painted to g_frame, then uploaded to
+// g_texture and drawn by g_renderer
+static bool g_accelerated = false;
+static uint32 g_window_scale = 1;
+static bool g_smooth = false;
+static SDL_Renderer *g_renderer = nullptr;
+static SDL_Texture *g_texture = nullptr;
+static SDL_Surface *g_frame = nullptr;
+
+static void DestroyVideo()
+{
+	if (g_texture) SDL_DestroyTexture(g_texture);
+	if (g_renderer) SDL_DestroyRenderer(g_renderer);
+	if (g_frame) SDL_DestroySurface(g_frame);
+	if (g_window) SDL_DestroyWindow(g_window);
+	g_texture = nullptr;
+	g_renderer = nullptr;
+	g_frame = nullptr;
+	g_window = nullptr;
+	g_window_surface = nullptr;
+}
+
+// Create the renderer, and the surface and texture for the frame
+static bool CreateAccelerated(uint32 width, uint32 height, uint32 bpp)
+{
+	SDL_PixelFormat pixfmt = bpp == 32 ? SDL_PIXELFORMAT_XRGB8888
+									   : SDL_PIXELFORMAT_RGB565;
+
+	g_renderer = SDL_CreateRenderer(g_window, nullptr);
+	if (!g_renderer)
+	{
+		pout << "SDL_CreateRenderer() failed: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	g_texture = SDL_CreateTexture(g_renderer, pixfmt,
+								  SDL_TEXTUREACCESS_STREAMING, width, height);
+	g_frame = SDL_CreateSurface(width, height, pixfmt);
+	if (!g_texture || !g_frame)
+	{
+		pout << "Creating the frame texture failed: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	SDL_SetTextureScaleMode(g_texture, g_smooth ? SDL_SCALEMODE_LINEAR
+												: SDL_SCALEMODE_NEAREST);
+	SDL_SetRenderLogicalPresentation(g_renderer, width, height,
+									 SDL_LOGICAL_PRESENTATION_LETTERBOX);
+	return true;
+}
+
 //
 // RenderSurface::SetVideoMode()
 //
@@ -74,6 +125,9 @@ RenderSurface *RenderSurface::SetVideoMode(uint32 width,		// Width of desired mo
 		return 0;
 	}
 
+	// The RenderSurface of the old mode has been deleted by now
+	DestroyVideo();
+
 	// SDL3: Create window with appropriate flags
 	Uint32 window_flags = 0;
 	
@@ -82,7 +136,9 @@ RenderSurface *RenderSurface::SetVideoMode(uint32 width,		// Width of desired mo
 	}
 
 	// Create the window
-	g_window = SDL_CreateWindow("Pentagram", width, height, window_flags);
+	uint32 scale = g_accelerated ? g_window_scale : 1;
+	g_window = SDL_CreateWindow("Pentagram", width*scale, height*scale,
+								window_flags);
 	
 	if (!g_window)
 	{
@@ -90,17 +146,32 @@ RenderSurface *RenderSurface::SetVideoMode(uint32 width,		// Width of desired mo
 		return 0;
 	}
 
+	if (g_accelerated && !CreateAccelerated(width, height, bpp))
+	{
+		pout << "Falling back to the window surface" << std::endl;
+		DestroyVideo();
+		g_window = SDL_CreateWindow("Pentagram", width, height, window_flags);
+		if (!g_window)
+		{
+			pout << "SDL_CreateWindow() failed: " << SDL_GetError() << std::endl;
+			return 0;
+		}
+	}
+
 	// Get the window surface
-	g_window_surface = SDL_GetWindowSurface(g_window);
+	if (!g_renderer)
+		g_window_surface = SDL_GetWindowSurface(g_window);
 	
-	if (!g_window_surface)
+	if (!g_renderer && !g_window_surface)
 	{
 		pout << "SDL_GetWindowSurface() failed: " << SDL_GetError() << std::endl;
-		SDL_DestroyWindow(g_window);
-		g_window = nullptr;
+		DestroyVideo();
 		return 0;
 	}
 
+	// What we paint to
+	SDL_Surface *target = g_renderer ? g_frame : g_window_surface;
+
 	// Now create the SoftRenderSurface
 	RenderSurface *surf;
 
@@ -109,8 +180,8 @@ RenderSurface *RenderSurface::SetVideoMode(uint32 width,		// Width of desired mo
 	if (bpp == 32) surf = new D3D9SoftRenderSurface<uint32>(width,height,fullscreen);
 	else surf = new D3D9SoftRenderSurface<uint16>(width,height,fullscreen);
 #else
-	if (bpp == 32) surf = new SoftRenderSurface<uint32>(g_window_surface);
-	else surf = new SoftRenderSurface<uint16>(g_window_surface);
+	if (bpp == 32) surf = new SoftRenderSurface<uint32>(target);
+	else surf = new SoftRenderSurface<uint16>(target);
 #endif
 
 	// Initialize gamma correction tables
@@ -145,10 +216,29 @@ SDL_Window* RenderSurface::GetSDLWindow()
 	return g_window;
 }
 
+void RenderSurface::SetAcceleration(bool accelerated, uint32 window_scale,
+									bool smooth)
+{
+	g_accelerated = accelerated;
+	g_window_scale = window_scale ? window_scale : 1;
+	g_smooth = smooth;
+}
+
 // SDL3: Update the window surface
 void RenderSurface::UpdateWindowSurface()
 {
-	if (g_window) {
+	if (g_renderer) {
+		SDL_UpdateTexture(g_texture, nullptr, g_frame->pixels, g_frame->pitch);
+		SDL_RenderClear(g_renderer);
+		SDL_RenderTexture(g_renderer, g_texture, nullptr, nullptr);
+		SDL_RenderPresent(g_renderer);
+	}
+	else if (g_window) {
 		SDL_UpdateWindowSurface(g_window);
 	}
 }
+
+void RenderSurface::ConvertEventCoords(SDL_Event &event)
+{
+	if (g_renderer) SDL_ConvertEventToRenderCoordinates(g_renderer, &event);
+}
@@ -77,12 +77,24 @@ public:
 	//! Create a SecondaryRenderSurface with an associated Texture object
 	static RenderSurface *CreateSecondaryRenderSurface(uint32 width, uint32 height);
 
+	//! Present frames through an SDL_Renderer instead of the window surface.
+	//! The frame is uploaded to a texture that the GPU scales to the window,
+	//! which is window_scale times the size of the video mode.
+	//! \param smooth Scale bilinearly instead of to the nearest pixel
+	//! \note Takes effect at the next SetVideoMode
+	static void SetAcceleration(bool accelerated, uint32 window_scale,
+								bool smooth);
+
 	//! SDL3: Get the global SDL window
 	static struct SDL_Window* GetSDLWindow();
 
 	//! SDL3: Update the window surface
 	static void UpdateWindowSurface();
 
+	//! Convert the window coordinates of a mouse event to surface
+	//! coordinates (only needed when the GPU scales the frame)
+	static void ConvertEventCoords(union SDL_Event &event);
+
 	// Virtual Destructor
 	virtual ~RenderSurface();
 
@@ -107,6 +119,13 @@ public:
 	// \note It should only be used with Painting and Blitting methods.
 	virtual Texture *GetSurfaceAsTexture() = 0;
 
+	//! Create a surface that paints to the pixels of this one, with its own
+	//! origin and clipping rect. Threads can paint to different parts of
+	//! this surface through views at the same time.
+	// \note The surface must be painting (see BeginPainting) while the view
+	//        is being used. The view doesn't need BeginPainting.
+	virtual RenderSurface *CreateView() = 0;
+
 	//
 	// Surface Properties
 	//
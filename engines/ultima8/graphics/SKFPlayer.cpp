@@ -37,6 +37,8 @@
 #include "GameData.h"
 #include "SoundFlex.h"
 #include "AudioSample.h"
+#include "Palette.h"
+#include "profiler/Frame_profiler.h"
 
 #include <SDL3/SDL.h>
 #include "misc/sdl2_compat.h"
@@ -93,8 +95,15 @@ SKFPlayer::SKFPlayer(RawArchive* movie, int width_, int height_, bool introMusic
 	: width(width_), height(height_), skf(movie),
 	  curframe(0), curobject(0), curaction(0), curevent(0), playing(false),
 	  timer(0), framerate(15), fadecolour(0), fadelevel(0), buffer(0), subs(0),
-	  introMusicHack(introMusicHack_), pngFrameCounter(0), audioCounter(0), lastFrameTime(0), currentFrameStartTime(0), skfStartTime(0)
+	  introMusicHack(introMusicHack_), pngFrameCounter(0), audioCounter(0), lastFrameTime(0), currentFrameStartTime(0), skfStartTime(0),
+	  canvas(0), decodepal(0), decoder(0), quitDecoding(false),
+	  framesShown(0), framesDropped(0), framesLate(0), painted(true)
 {
+	mutex = SDL_CreateMutex();
+	skfmutex = SDL_CreateMutex();
+	decoded = SDL_CreateCondition();
+	released = SDL_CreateCondition();
+
 	// Get command line options from CoreApp
 	CoreApp* app = CoreApp::get_instance();
 	if (app) {
@@ -132,16 +141,34 @@ SKFPlayer::SKFPlayer(RawArchive* movie, int width_, int height_, bool introMusic
 	delete eventlist;
 
 	buffer = RenderSurface::CreateSecondaryRenderSurface(width, height);
+	canvas = RenderSurface::CreateSecondaryRenderSurface(width, height);
+	for (int i = 0; i < DECODE_AHEAD; ++i)
+		freesurfaces.push_back(
+			RenderSurface::CreateSecondaryRenderSurface(width, height));
 }
 
 SKFPlayer::~SKFPlayer()
 {
+	stopDecoding();
+
 	for (unsigned int i = 0; i < events.size(); ++i)
 		delete events[i];
 
+	for (unsigned int i = 0; i < ready.size(); ++i)
+		delete ready[i].surface;
+	for (unsigned int i = 0; i < freesurfaces.size(); ++i)
+		delete freesurfaces[i];
+
 	delete skf;
 	delete buffer;
+	delete canvas;
+	delete decodepal;
 	delete subs;
+
+	SDL_DestroyCondition(released);
+	SDL_DestroyCondition(decoded);
+	SDL_DestroyMutex(skfmutex);
+	SDL_DestroyMutex(mutex);
 }
 
 void SKFPlayer::parseEventList(IDataSource* eventlist)
@@ -163,9 +190,30 @@ void SKFPlayer::start()
 	buffer->BeginPainting();
 	buffer->Fill32(0, 0, 0, width, height);
 	buffer->EndPainting();
+	canvas->BeginPainting();
+	canvas->Fill32(0, 0, 0, width, height);
+	canvas->EndPainting();
 	MusicProcess* musicproc = MusicProcess::get_instance();
 	if (musicproc) musicproc->playMusic(0);
 	playing = true;
+
+	// Frames are painted with the movie palette until the movie sets one
+	Pentagram::Palette* pal = PaletteManager::get_instance()->
+		getPalette(PaletteManager::Pal_Movie);
+	if (pal) {
+		if (!decodepal) decodepal = new Pentagram::Palette;
+		*decodepal = *pal;
+	}
+
+	framesShown = framesDropped = framesLate = 0;
+	painted = true;
+
+	// Decode ahead. Without a thread, frames are decoded when they're due.
+	if (!decoder) {
+		quitDecoding = false;
+		decoder = SDL_CreateThread(decodeThreadMain, "SKFDecoder",
+								   static_cast<void*>(this));
+	}
 	lastupdate = SDL_GetTicks();
 	skfStartTime = lastupdate;  // Record when SKF playback started
 	
@@ -200,15 +248,160 @@ void SKFPlayer::start()
 
 void SKFPlayer::stop()
 {
+	stopDecoding();
+
+	if (playing) {
+		pout << "SKFPlayer: " << framesShown << " frames shown, "
+			 << framesDropped << " dropped, " << framesLate << " late"
+			 << std::endl;
+	}
+
 	MusicProcess* musicproc = MusicProcess::get_instance();
 	if (musicproc && !introMusicHack) musicproc->playMusic(0);
 	playing = false;
 }
 
+void SKFPlayer::stopDecoding()
+{
+	if (!decoder) return;
+
+	SDL_LockMutex(mutex);
+	quitDecoding = true;
+	SDL_BroadcastCondition(released);
+	SDL_UnlockMutex(mutex);
+
+	SDL_WaitThread(decoder, 0);
+	decoder = 0;
+}
+
+int SDLCALL SKFPlayer::decodeThreadMain(void* data)
+{
+	static_cast<SKFPlayer*>(data)->decodeThread();
+	return 0;
+}
+
+void SKFPlayer::decodeThread()
+{
+	for (;;) {
+		DecodedFrame frame;
+
+		SDL_LockMutex(mutex);
+		while (freesurfaces.empty() && !quitDecoding)
+			SDL_WaitCondition(released, mutex);
+		if (quitDecoding) {
+			SDL_UnlockMutex(mutex);
+			return;
+		}
+		frame.surface = freesurfaces.back();
+		freesurfaces.pop_back();
+		SDL_UnlockMutex(mutex);
+
+		bool more = decodeFrame(frame.surface, frame.palette);
+
+		SDL_LockMutex(mutex);
+		if (!more) {
+			// tell run() the movie is over
+			freesurfaces.push_back(frame.surface);
+			frame.surface = 0;
+		}
+		ready.push_back(frame);
+		SDL_SignalCondition(decoded);
+		SDL_UnlockMutex(mutex);
+
+		if (!more) return;
+	}
+}
+
+bool SKFPlayer::decodeFrame(RenderSurface* surface,
+							std::vector<uint8>& palette)
+{
+	PROFILE_ZONE("SKFPlayer::decodeFrame");
+
+	IDataSource* object;
+	uint16 objecttype = 0;
+	palette.clear();
+
+	do {
+		curobject++;
+		if (curobject >= skf->getCount())
+			return false; // done
+
+		// read object
+		SDL_LockMutex(skfmutex);
+		object = skf->get_datasource(curobject);
+		SDL_UnlockMutex(skfmutex);
+		if (!object || object->getSize() < 2) {
+			delete object;
+			continue;
+		}
+
+		objecttype = object->read2();
+
+//		pout << "Object " << curobject << "/" << skf->getCount()
+//			 << ", type = " << objecttype << std::endl;
+
+
+		if (objecttype == 1 && object->getSize() > 2) {
+			// kept for the PaletteManager, which gets it when the frame
+			// is shown
+			palette.resize(object->getSize() - 2);
+			object->read(&palette[0], static_cast<uint32>(palette.size()));
+			object->seek(2);
+
+			if (!decodepal) decodepal = new Pentagram::Palette;
+			decodepal->load(*object);
+			canvas->CreateNativePalette(decodepal);
+		}
+
+		if (objecttype != 2)
+			delete object;
+
+	} while (objecttype != 2);
+
+	// Frames only paint what changed, so they go on the canvas first
+	object->seek(0);
+	Shape* shape = new Shape(object, &U8SKFShapeFormat);
+	shape->setUncached();
+	shape->setPalette(decodepal);
+	canvas->BeginPainting();
+	canvas->Paint(shape, 0, 0, 0);
+	canvas->EndPainting();
+	delete shape;
+	delete object;
+
+	surface->BeginPainting();
+	surface->Blit(canvas->GetSurfaceAsTexture(), 0, 0, width, height, 0, 0);
+	surface->EndPainting();
+
+	return true;
+}
+
+void SKFPlayer::nextFrame(DecodedFrame& frame)
+{
+	if (!decoder) {
+		frame.surface = freesurfaces.back();
+		freesurfaces.pop_back();
+		if (!decodeFrame(frame.surface, frame.palette)) {
+			freesurfaces.push_back(frame.surface);
+			frame.surface = 0;
+		}
+		return;
+	}
+
+	SDL_LockMutex(mutex);
+	while (ready.empty())
+		SDL_WaitCondition(decoded, mutex);
+	frame = ready.front();
+	ready.pop_front();
+	SDL_UnlockMutex(mutex);
+}
+
 void SKFPlayer::paint(RenderSurface* surf, int /*lerp*/)
 {
 	if (!buffer) return;
 
+	painted = true;
+
 	Texture* tex = buffer->GetSurfaceAsTexture();
 
 	if (!fadelevel) {
@@ -328,8 +521,10 @@ void SKFPlayer::run()
 			}
 
 			if (audioproc) {
+				SDL_LockMutex(skfmutex);
 				uint8* buffer = skf->get_object(events[curevent]->data);
 				uint32 bufsize = skf->get_size(events[curevent]->data);
+				SDL_UnlockMutex(skfmutex);
 				Pentagram::AudioSample* s;
 				uint32 rate = buffer[6] + (buffer[7]<<8);
 				bool stereo = (buffer[8] == 2);
@@ -350,9 +545,11 @@ void SKFPlayer::run()
 			}
 
 			// subtitles
+			SDL_LockMutex(skfmutex);
 			char* textbuf = reinterpret_cast<char*>(
 				skf->get_object(events[curevent]->data-1));
 			uint32 textsize = skf->get_size(events[curevent]->data-1);
+			SDL_UnlockMutex(skfmutex);
 			if (textsize > 7) {
 				std::string subtitle = (textbuf+6);
 				delete subs;
@@ -398,70 +595,53 @@ void SKFPlayer::run()
 
 	curframe++;
 
-	PaletteManager* palman = PaletteManager::get_instance();
-	IDataSource* object;
-
-	uint16 objecttype = 0;
-	do {
-		curobject++;
-		if (curobject >= skf->getCount()) {
-			stop(); // done
-			return;
-		}
+	DecodedFrame frame;
+	nextFrame(frame);
+	if (!frame.surface) {
+		stop(); // done
+		return;
+	}
 
-		// read object
-		object = skf->get_datasource(curobject);
-		if (!object || object->getSize() < 2)
-			continue;
+	if (!frame.palette.empty()) {
+		IBufferDataSource palds(&frame.palette[0],
+								static_cast<unsigned int>(frame.palette.size()));
+		PaletteManager::get_instance()->load(PaletteManager::Pal_Movie, palds);
+	}
 
-		objecttype = object->read2();
+	now = SDL_GetTicks();
 
-//		pout << "Object " << curobject << "/" << skf->getCount()
-//			 << ", type = " << objecttype << std::endl;
+	// Log previous frame duration only if frame logging is enabled
+	if (logFrames && currentFrameStartTime > 0) {
+		uint32 frameDuration = now - currentFrameStartTime;
+		pout << "Frame " << (curframe - 1) << " total display time: " << frameDuration << "ms" << std::endl;
+	}
 
+	// Update frame timing for the new frame
+	currentFrameStartTime = now;
 
-		if (objecttype == 1) {
-			palman->load(PaletteManager::Pal_Movie, *object);
-		}
+	if (now >= lastupdate + (1000/framerate))
+		framesLate++;
+	if (!painted)
+		framesDropped++;
+	framesShown++;
+	painted = false;
 
-		if (objecttype != 2)
-			delete object;
+	// show it, and give the decoder the one shown until now
+	SDL_LockMutex(mutex);
+	freesurfaces.push_back(buffer);
+	SDL_SignalCondition(released);
+	SDL_UnlockMutex(mutex);
+	buffer = frame.surface;
 
-	} while (objecttype != 2);
+	//pout << "Rendering new frame " << curframe << " at time " << now << "ms" << std::endl;
 
-	if (objecttype == 2) {
-		uint32 now = SDL_GetTicks();
-		
-		// Log previous frame duration only if frame logging is enabled
-		if (logFrames && currentFrameStartTime > 0) {
-			uint32 frameDuration = now - currentFrameStartTime;
-			pout << "Frame " << (curframe - 1) << " total display time: " << frameDuration << "ms" << std::endl;
-		}
-		
-		// Update frame timing for the new frame
-		currentFrameStartTime = now;
-		
-		object->seek(0);
-		Shape* shape = new Shape(object, &U8SKFShapeFormat);
-		Pentagram::Palette* pal= palman->getPalette(PaletteManager::Pal_Movie);
-		shape->setPalette(pal);
-		buffer->BeginPainting();
-		buffer->Paint(shape, 0, 0, 0);
-		buffer->EndPainting();
-		delete shape;
-		
-		//pout << "Rendering new frame " << curframe << " at time " << now << "ms" << std::endl;
-		
-		// Save frame as PNG only if frame extraction is enabled
-		if (extractFrames) {
-			try {
-				savePNGFrame();
-			} catch (...) {
-				perr << "Exception occurred while saving PNG frame " << pngFrameCounter << std::endl;
-			}
+	// Save frame as PNG only if frame extraction is enabled
+	if (extractFrames) {
+		try {
+			savePNGFrame();
+		} catch (...) {
+			perr << "Exception occurred while saving PNG frame " << pngFrameCounter << std::endl;
 		}
-	
-		delete object;
 	}
 
 	timer = 1; // HACK! timing is rather broken currently...
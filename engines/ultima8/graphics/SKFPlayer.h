@@ -21,6 +21,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <vector>
 #include <map>
+#include <deque>
+#include <SDL3/SDL.h>
+#include "misc/sdl2_compat.h"
 
 struct SKFEvent;
 class RawArchive;
@@ -44,6 +47,28 @@ public:
 	// PNG Export: Automatically saves each frame as a PNG file during playback
 
 private:
+	//! A frame decoded ahead of time
+	struct DecodedFrame {
+		RenderSurface* surface;		//!< 0 at the end of the movie
+		std::vector<uint8> palette;	//!< palette read before it, if any
+	};
+
+	//! number of frames decoded ahead
+	enum { DECODE_AHEAD = 4 };
+
+	static int SDLCALL decodeThreadMain(void* data);
+	void decodeThread();
+
+	//! Decode the next frame onto 'surface'. Only the decoding thread
+	//! calls this while it runs.
+	//! \return false at the end of the movie
+	bool decodeFrame(RenderSurface* surface, std::vector<uint8>& palette);
+
+	//! Get the next decoded frame, waiting for it if necessary
+	void nextFrame(DecodedFrame& frame);
+
+	//! Stop the decoding thread
+	void stopDecoding();
 
 	void parseEventList(IDataSource* eventlist);
 	void savePNGFrame();  // Saves current frame buffer as PNG file to disk
@@ -65,7 +90,7 @@ private:
 	unsigned int timer;
 	unsigned int framerate;
 	uint8 fadecolour, fadelevel;
-	RenderSurface* buffer;
+	RenderSurface* buffer;		//!< the frame shown
 	RenderedText* subs;
 	int subtitley;
 	bool introMusicHack;
@@ -86,6 +111,24 @@ private:
 	
 	// Audio frame timing tracking for --log_skf_audio
 	std::map<unsigned int, unsigned int> audioFrameTimes;  // Maps frame number to timestamp
+
+	// Decoding ahead
+	RenderSurface* canvas;			//!< decoded frames are painted over it
+	Pentagram::Palette* decodepal;	//!< the palette of the decoded frames
+	std::deque<DecodedFrame> ready;
+	std::vector<RenderSurface*> freesurfaces;
+	SDL_Thread* decoder;			//!< 0 if decoding as frames are due
+	SDL_Mutex* mutex;				//!< guards ready, freesurfaces, quit
+	SDL_Mutex* skfmutex;			//!< guards reading the skf
+	SDL_Condition* decoded;			//!< signalled when a frame is ready
+	SDL_Condition* released;		//!< signalled when a surface is free
+	bool quitDecoding;
+
+	// Playback statistics, shown when stopped
+	unsigned int framesShown;
+	unsigned int framesDropped;		//!< replaced before they were painted
+	unsigned int framesLate;		//!< shown when the next one was due
+	bool painted;					//!< the shown frame has been painted
 };
 
 #endif
@@ -29,8 +29,12 @@ DEFINE_RUNTIME_CLASSTYPE_CODE_BASE_CLASS(Shape);
 
 DEFINE_CUSTOM_MEMORY_ALLOCATION(Shape);
 
+uint32 Shape::use_clock = 0;
+
 Shape::Shape(const uint8* data, uint32 size, const ConvertShapeFormat *format,
-			 const uint16 id, const uint32 shape) : flexId(id), shapenum(shape)
+			 const uint16 id, const uint32 shape, bool mapped_)
+	: lazy_format(0), frame_memory(0), last_use(0), mapped(mapped_),
+	  uncached(false), flexId(id), shapenum(shape)
 {
 	// NB: U8 style!
 
@@ -57,7 +61,8 @@ Shape::Shape(const uint8* data, uint32 size, const ConvertShapeFormat *format,
 }
 
 Shape::Shape(IDataSource *src, const ConvertShapeFormat *format)
-	: flexId(0), shapenum(0)
+	: lazy_format(0), frame_memory(0), last_use(0), mapped(false),
+	  uncached(false), flexId(0), shapenum(0)
 {
 	// NB: U8 style!
 
@@ -90,7 +95,29 @@ Shape::~Shape()
 	for (unsigned int i = 0; i < frames.size(); ++i)
 		delete frames[i];
 
-	delete[] const_cast<uint8*>(data);
+	if (!mapped)
+		delete[] const_cast<uint8*>(data);
+}
+
+ShapeFrame* Shape::getFrame(unsigned int frame)
+{
+	if (frame >= frames.size()) return 0;
+
+	// (only write when it changes, so threads painting can share shapes)
+	if (last_use != use_clock) last_use = use_clock;
+	if (!frames[frame]) frames[frame] = LoadFrame(frame);
+	return frames[frame];
+}
+
+void Shape::releaseFrames()
+{
+	if (!lazy_format) return;
+
+	for (unsigned int i = 0; i < frames.size(); ++i) {
+		delete frames[i];
+		frames[i] = 0;
+	}
+	frame_memory = 0;
 }
 
 void Shape::getShapeId(uint16 & id, uint32 & shape)
@@ -115,14 +142,9 @@ void Shape::LoadU8Format(const uint8* data, uint32 size, const ConvertShapeForma
 		return;
 	}
 
-	frames.reserve(framecount);
-
-	for (unsigned int i = 0; i < framecount; ++i) {
-		uint32 frameoffset = READ3(data,6+6*i);
-		uint32 framesize = READ2(data,10+6*i);
-		
-		frames.push_back(new ShapeFrame(data + frameoffset, framesize, format));
-	}
+	// frames are parsed when they are first used
+	frames.resize(framecount, 0);
+	lazy_format = format;
 }
 
 // This will load a pentagram style shape 'optimzed'.
@@ -135,14 +157,29 @@ void Shape::LoadPentagramFormat(const uint8* data, uint32 size, const ConvertSha
 		return;
 	}
 
-	frames.reserve(framecount);
+	// frames are parsed when they are first used
+	frames.resize(framecount, 0);
+	lazy_format = format;
+}
 
-	for (unsigned int i = 0; i < framecount; ++i) {
-		uint32 frameoffset = READ4(data,8+8*i);
-		uint32 framesize = READ4(data,12+8*i);
-		
-		frames.push_back(new ShapeFrame(data + frameoffset, framesize, format));
+ShapeFrame* Shape::LoadFrame(unsigned int frame) const
+{
+	uint32 frameoffset, framesize;
+
+	if (lazy_format == &PentagramShapeFormat) {
+		frameoffset = READ4(data,8+8*frame);
+		framesize = READ4(data,12+8*frame);
+	} else {
+		frameoffset = READ3(data,6+6*frame);
+		framesize = READ2(data,10+6*frame);
 	}
+
+	ShapeFrame* sf = new ShapeFrame(data + frameoffset, framesize,
+									lazy_format);
+	frame_memory += sizeof(ShapeFrame);
+	if (sf->height > 0) frame_memory += sf->height * sizeof(uint32);
+
+	return sf;
 }
 
 // This will load any sort of shape via a ConvertShapeFormat struct
@@ -250,6 +287,7 @@ void Shape::getTotalDimensions(sint32& w,sint32& h,sint32& x,sint32& y) const
 	sint32 miny = 1000000, maxy = -1000000;
 
 	for (unsigned int i = 0; i < frames.size(); ++i) {
+		if (!frames[i]) frames[i] = LoadFrame(i);
 		ShapeFrame* frame = frames[i];
 		if (-frame->xoff < minx)
 			minx = -frame->xoff;
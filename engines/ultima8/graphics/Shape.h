@@ -30,10 +30,12 @@ class Shape
 {
 public:
 	// Parse data, create frames.
-	// NB: Shape uses data without copying it. It is deleted on destruction
+	// NB: Shape uses data without copying it. It is deleted on destruction,
+	// unless it is mapped from a file (see IMappedDataSource)
 	// If format is not specified it will be autodetected
+	// U8 and Pentagram style frames are only parsed when they are first used
 	Shape(const uint8* data, uint32 size, const ConvertShapeFormat *format,
-		const uint16 flexId, const uint32 shapenum);
+		const uint16 flexId, const uint32 shapenum, bool mapped=false);
 	Shape(IDataSource *src, const ConvertShapeFormat *format);
 	virtual ~Shape();
 	void setPalette(const Pentagram::Palette* pal) { palette = pal; }
@@ -46,8 +48,27 @@ public:
 	//! (x,y) = coordinates of origin relative to top-left point of rectangle
 	void getTotalDimensions(sint32& w, sint32& h, sint32& x, sint32& y) const;
 
-	ShapeFrame* getFrame(unsigned int frame)
-		{ if (frame < frames.size()) return frames[frame]; else return 0; }
+	ShapeFrame* getFrame(unsigned int frame);
+
+	//! Delete the frames parsed so far. They are parsed again when used.
+	//! Does nothing if the frames were all parsed up front.
+	//! Potentially dangerous: make sure no one still uses the frames.
+	void releaseFrames();
+
+	//! Memory used by the parsed frames, in bytes
+	uint32 getFrameMemory() const { return frame_memory; }
+
+	//! Keep the frames out of the ShapeFrameCache. For shapes painted
+	//! once, or painted off the main thread (see SKFPlayer).
+	void setUncached() { uncached = true; }
+	bool isUncached() const { return uncached; }
+
+	//! Value of the use clock when a frame was last fetched
+	uint32 getLastUse() const { return last_use; }
+
+	//! Advance the use clock. Called once per painted frame.
+	static void advanceUseClock() { ++use_clock; }
+	static uint32 getUseClock() { return use_clock; }
 		
 	void getShapeId(uint16 & flexId, uint32 & shapenum);
 
@@ -71,7 +92,19 @@ protected:
 	// Crusader shapes must be loaded this way
 	void LoadGenericFormat(const uint8* data, uint32 size, const ConvertShapeFormat* format);
 
-	std::vector<ShapeFrame*> frames;
+	// Parse a single frame of a u8 or pentagram style shape
+	ShapeFrame* LoadFrame(unsigned int frame) const;
+
+	mutable std::vector<ShapeFrame*> frames;
+
+	//! format of the frames parsed on demand. 0 if all are parsed up front
+	const ConvertShapeFormat* lazy_format;
+	mutable uint32 frame_memory;
+	uint32 last_use;
+	bool mapped;
+	bool uncached;
+
+	static uint32 use_clock;
 
 	const Pentagram::Palette* palette;
 
@@ -23,6 +23,8 @@
 #include "Palette.h"
 #include "ConvertShape.h"
 
+#include <algorithm>
+
 DEFINE_RUNTIME_CLASSTYPE_CODE(ShapeArchive,Pentagram::Archive);
 
 ShapeArchive::~ShapeArchive()
@@ -45,8 +47,11 @@ void ShapeArchive::cache(uint32 shapenum)
 
 	if (shapes[shapenum]) return;
 
-	uint32 shpsize;
-	uint8 *data = getRawObject(shapenum, &shpsize);
+	// use the shape in place if the archive is mapped into memory
+	uint32 shpsize = 0;
+	const uint8 *data = getMappedObject(shapenum, &shpsize);
+	bool mapped = (data != 0);
+	if (!mapped) data = getRawObject(shapenum, &shpsize);
 
 	if (!data || shpsize == 0) return;
 
@@ -58,12 +63,12 @@ void ShapeArchive::cache(uint32 shapenum)
 	
 	if (!format)
 	{
-		delete [] data;
+		if (!mapped) delete [] const_cast<uint8*>(data);
 		perr << "Error: Unable to detect shape format for flex." << std::endl;
 		return;
 	}
 
-	Shape* shape = new Shape(data, shpsize, format, id, shapenum);
+	Shape* shape = new Shape(data, shpsize, format, id, shapenum, mapped);
 	if (palette) shape->setPalette(palette);
 
 	shapes[shapenum] = shape;
@@ -78,6 +83,42 @@ void ShapeArchive::uncache(uint32 shapenum)
 	shapes[shapenum] = 0;
 }
 
+static bool OlderUse(const Shape* a, const Shape* b)
+{
+	return a->getLastUse() < b->getLastUse();
+}
+
+void ShapeArchive::trimFrames()
+{
+	if (frame_budget == 0) return;
+
+	uint32 used = 0;
+	std::vector<Shape*>::iterator iter;
+	for (iter = shapes.begin(); iter != shapes.end(); ++iter) {
+		if (*iter) used += (*iter)->getFrameMemory();
+	}
+	if (used <= frame_budget) return;
+
+	std::vector<Shape*> loaded;
+	for (iter = shapes.begin(); iter != shapes.end(); ++iter) {
+		if (*iter && (*iter)->getFrameMemory())
+			loaded.push_back(*iter);
+	}
+	std::sort(loaded.begin(), loaded.end(), OlderUse);
+
+	// free a quarter of the budget, so this doesn't happen every frame
+	uint32 target = frame_budget - frame_budget / 4;
+	uint32 now = Shape::getUseClock();
+	for (iter = loaded.begin(); iter != loaded.end() && used > target; ++iter) {
+		// don't release what was just painted
+		if ((*iter)->getLastUse() == now) break;
+
+		uint32 memory = (*iter)->getFrameMemory();
+		(*iter)->releaseFrames();
+		used -= memory - (*iter)->getFrameMemory();
+	}
+}
+
 bool ShapeArchive::isCached(uint32 shapenum)
 {
 	if (shapenum >= count) return false;
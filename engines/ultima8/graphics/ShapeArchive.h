@@ -32,17 +32,21 @@ public:
 
 	ShapeArchive(uint16 id_, Pentagram::Palette* pal_ = 0,
 			  const ConvertShapeFormat *format_ = 0)
-		: Archive(), id(id_), format(format_), palette(pal_) { }
+		: Archive(), id(id_), format(format_), palette(pal_),
+		  frame_budget(0) { }
 	ShapeArchive(ArchiveFile* af, uint16 id_, Pentagram::Palette* pal_ = 0,
 			  const ConvertShapeFormat *format_ = 0)
-		: Archive(af), id(id_), format(format_), palette(pal_) { }
+		: Archive(af), id(id_), format(format_), palette(pal_),
+		  frame_budget(0) { }
 	ShapeArchive(IDataSource* ds, uint16 id_, Pentagram::Palette* pal_ = 0,
 			  const ConvertShapeFormat *format_ = 0)
-		: Archive(ds), id(id_), format(format_), palette(pal_) { }
+		: Archive(ds), id(id_), format(format_), palette(pal_),
+		  frame_budget(0) { }
 	ShapeArchive(const std::string& path, uint16 id_,
 				 Pentagram::Palette* pal_ = 0,
 				 const ConvertShapeFormat *format_ = 0)
-		: Archive(path), id(id_), format(format_), palette(pal_) { }
+		: Archive(path), id(id_), format(format_), palette(pal_),
+		  frame_budget(0) { }
 
 	virtual ~ShapeArchive();
 
@@ -52,11 +56,20 @@ public:
 	virtual void uncache(uint32 shapenum);
 	virtual bool isCached(uint32 shapenum);
 
+	//! Set the memory budget for parsed frames in bytes. 0 is unlimited.
+	void setFrameBudget(uint32 bytes) { frame_budget = bytes; }
+
+	//! Release the frames of the least recently used shapes when the parsed
+	//! frames use more than the budget. Only call this when no frames are
+	//! in use, e.g. between painted frames.
+	void trimFrames();
+
 protected:
 	uint16 id;
 	const ConvertShapeFormat *format;
 	Pentagram::Palette* palette;
 	std::vector<Shape*> shapes;
+	uint32 frame_budget;
 };
 
 
@@ -19,6 +19,7 @@
 #include "pent_include.h"
 
 #include "ShapeFrame.h"
+#include "ShapeFrameCache.h"
 #include "ConvertShape.h"
 #include "u8/ConvertShapeU8.h"
 #include "IDataSource.h"
@@ -27,7 +28,7 @@
   parse data and fill class
  */
 ShapeFrame::ShapeFrame(const uint8* data, uint32 size, const ConvertShapeFormat* format,
-					   const uint8 special[256], ConvertShapeFrame *prev) : line_offsets(0)
+					   const uint8 special[256], ConvertShapeFrame *prev) : line_offsets(0), cached(0)
 {
 	// Load it as u8
 	if (!format || format == &U8ShapeFormat || format == &U82DShapeFormat)
@@ -42,6 +43,7 @@ ShapeFrame::ShapeFrame(const uint8* data, uint32 size, const ConvertShapeFormat*
 
 ShapeFrame::~ShapeFrame()
 {
+	if (cached) ShapeFrameCache::release(this);
 	delete [] line_offsets;
 }
 
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 struct ConvertShapeFormat;
 struct ConvertShapeFrame;
+class CachedFrame;
 
 class ShapeFrame 
 {
@@ -43,6 +44,8 @@ public:
 	uint32				*line_offsets;		// Note these are offsets into rle_data
 	const uint8			*rle_data;
 
+	CachedFrame			*cached;			// Decoded frame (see ShapeFrameCache)
+
 	bool hasPoint(sint32 x, sint32 y) const;	// Check to see if a point is in the frame
 
 	uint8 getPixelAtPoint(sint32 x, sint32 y) const;	// Get the pixel at the point 
@@ -0,0 +1,209 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "ShapeFrameCache.h"
+#include "ShapeFrame.h"
+#include "Palette.h"
+
+uint32 ShapeFrameCache::budget = 16*1024*1024;
+uint32 ShapeFrameCache::used = 0;
+bool ShapeFrameCache::frozen = false;
+CachedFrame* ShapeFrameCache::lru_head = 0;
+CachedFrame* ShapeFrameCache::lru_tail = 0;
+
+const CachedFrame* ShapeFrameCache::get(ShapeFrame* frame,
+										const Pentagram::Palette* pal,
+										bool untformed_pal)
+{
+	if (!budget) return 0;
+
+	CachedFrame* cf = frame->cached;
+	if (frozen)
+		return (cf && isCurrent(cf, pal, untformed_pal)) ? cf : 0;
+
+	if (!cf) {
+		cf = decode(frame);
+		frame->cached = cf;
+		cf->frame = frame;
+		used += cf->memory;
+	} else {
+		unlink(cf);
+	}
+
+	// most recently used goes to the front
+	cf->lru_prev = 0;
+	cf->lru_next = lru_head;
+	if (lru_head) lru_head->lru_prev = cf;
+	lru_head = cf;
+	if (!lru_tail) lru_tail = cf;
+
+	if (!isCurrent(cf, pal, untformed_pal))
+	{
+		used -= cf->memory;
+		remap(cf, pal, untformed_pal);
+		used += cf->memory;
+	}
+
+	if (used > budget) evict(cf);
+
+	return cf;
+}
+
+bool ShapeFrameCache::isCurrent(const CachedFrame* cf,
+								const Pentagram::Palette* pal,
+								bool untformed_pal)
+{
+	return cf->revision == pal->revision && cf->untformed == untformed_pal &&
+		cf->colours.size() == cf->indices.size();
+}
+
+CachedFrame* ShapeFrameCache::decode(ShapeFrame* frame)
+{
+	// This walks the RLE data the same way SoftRenderSurface.inl does
+	CachedFrame* cf = new CachedFrame;
+	sint32 width = frame->width;
+	sint32 height = frame->height;
+
+	cf->line_spans.resize(height + 1);
+
+	for (sint32 i = 0; i < height; i++)
+	{
+		const uint8* linedata = frame->rle_data + frame->line_offsets[i];
+		sint32 xpos = 0;
+
+		cf->line_spans[i] = static_cast<uint32>(cf->span_list.size());
+
+		do
+		{
+			xpos += *linedata++;
+
+			if (xpos == width) break;
+
+			sint32 dlen = *linedata++;
+			int type = 0;
+			if (frame->compressed) {
+				type = dlen & 1;
+				dlen >>= 1;
+			}
+
+			CachedFrame::Span span;
+			span.x = xpos;
+			span.len = dlen;
+			span.first = static_cast<uint32>(cf->indices.size());
+			cf->span_list.push_back(span);
+
+			if (!type) {
+				cf->indices.insert(cf->indices.end(), linedata, linedata + dlen);
+				linedata += dlen;
+			} else {
+				cf->indices.insert(cf->indices.end(), dlen, *linedata);
+				linedata++;
+			}
+
+			xpos += dlen;
+
+		} while (xpos < width);
+	}
+
+	cf->line_spans[height] = static_cast<uint32>(cf->span_list.size());
+	cf->spans = cf->span_list.empty() ? 0 : &cf->span_list[0];
+
+	// leave colours empty, so get() remaps
+	cf->memory = static_cast<uint32>(sizeof(CachedFrame) +
+		cf->line_spans.size() * sizeof(uint32) +
+		cf->span_list.size() * sizeof(CachedFrame::Span) +
+		cf->indices.size());
+
+	return cf;
+}
+
+void ShapeFrameCache::remap(CachedFrame* cf, const Pentagram::Palette* pal,
+							bool untformed_pal)
+{
+	const uint32* native = untformed_pal ? pal->native_untransformed
+										 : pal->native;
+	const uint32* xform = untformed_pal ? pal->xform_untransformed
+										: pal->xform;
+
+	size_t count = cf->indices.size();
+	cf->colours.resize(count);
+
+	bool has_xform = false;
+	size_t i;
+	for (i = 0; i < count; i++) {
+		cf->colours[i] = native[cf->indices[i]];
+		if (xform[cf->indices[i]]) has_xform = true;
+	}
+
+	if (has_xform) {
+		cf->xforms.resize(count);
+		for (i = 0; i < count; i++)
+			cf->xforms[i] = xform[cf->indices[i]];
+	} else {
+		std::vector<uint32>().swap(cf->xforms);
+	}
+
+	cf->revision = pal->revision;
+	cf->untformed = untformed_pal;
+
+	cf->memory = static_cast<uint32>(sizeof(CachedFrame) +
+		cf->line_spans.size() * sizeof(uint32) +
+		cf->span_list.size() * sizeof(CachedFrame::Span) +
+		count * (1 + sizeof(uint32)) +
+		cf->xforms.size() * sizeof(uint32));
+}
+
+void ShapeFrameCache::unlink(CachedFrame* cf)
+{
+	if (cf->lru_prev) cf->lru_prev->lru_next = cf->lru_next;
+	else if (lru_head == cf) lru_head = cf->lru_next;
+	if (cf->lru_next) cf->lru_next->lru_prev = cf->lru_prev;
+	else if (lru_tail == cf) lru_tail = cf->lru_prev;
+	cf->lru_prev = cf->lru_next = 0;
+}
+
+void ShapeFrameCache::evict(CachedFrame* keep)
+{
+	while (used > budget && lru_tail && lru_tail != keep)
+		release(lru_tail->frame);
+}
+
+void ShapeFrameCache::release(ShapeFrame* frame)
+{
+	CachedFrame* cf = frame->cached;
+	if (!cf) return;
+
+	unlink(cf);
+	used -= cf->memory;
+	frame->cached = 0;
+	delete cf;
+}
+
+void ShapeFrameCache::clear()
+{
+	while (lru_head) release(lru_head->frame);
+}
+
+void ShapeFrameCache::setBudget(uint32 bytes)
+{
+	budget = bytes;
+	if (!budget) clear();
+	else if (lru_head) evict(lru_head);
+}
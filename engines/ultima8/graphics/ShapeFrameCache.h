@@ -0,0 +1,120 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef SHAPEFRAMECACHE_H
+#define SHAPEFRAMECACHE_H
+
+#include <vector>
+
+class ShapeFrame;
+namespace Pentagram { struct Palette; }
+
+//
+// CachedFrame. A ShapeFrame decoded into runs of opaque pixels (spans),
+// with every pixel already looked up in the native and xform palettes.
+//
+
+class CachedFrame
+{
+public:
+	struct Span {
+		sint32	x;		//!< start of the run, relative to the frame's left
+		sint32	len;	//!< number of pixels
+		uint32	first;	//!< index of the first pixel in the pixel arrays
+	};
+
+	//! spans of line i are getSpans(i) up to getSpans(i+1)
+	const Span* getSpans(int i) const { return spans + line_spans[i]; }
+
+	//! native colour of every pixel
+	const uint32* getColours() const
+		{ return colours.empty() ? 0 : &colours[0]; }
+
+	//! xform colour of every pixel, or 0 if there are none in the frame
+	const uint32* getXForms() const
+		{ return xforms.empty() ? 0 : &xforms[0]; }
+
+private:
+	friend class ShapeFrameCache;
+
+	CachedFrame() : spans(0), frame(0), revision(0), untformed(false),
+		memory(0), lru_prev(0), lru_next(0) { }
+
+	std::vector<uint32> line_spans;	//!< first span of each line, and the end
+	std::vector<Span> span_list;
+	const Span *spans;
+
+	std::vector<uint8> indices;		//!< palette index of every pixel
+	std::vector<uint32> colours;
+	std::vector<uint32> xforms;
+
+	ShapeFrame *frame;
+	uint32 revision;				//!< Palette::revision colours are for
+	bool untformed;					//!< colours are untransformed
+	uint32 memory;
+
+	CachedFrame *lru_prev, *lru_next;
+};
+
+//
+// ShapeFrameCache. Decodes frames for the SoftRenderSurface on first use,
+// and keeps the most recently used ones within a memory budget.
+//
+
+class ShapeFrameCache
+{
+public:
+	//! Get the decoded frame with the colours of palette pal.
+	//! \return 0 if the cache is disabled
+	static const CachedFrame* get(ShapeFrame* frame,
+								  const Pentagram::Palette* pal,
+								  bool untformed_pal);
+
+	//! Forget a frame. Called when a ShapeFrame is deleted.
+	static void release(ShapeFrame* frame);
+
+	//! Drop all cached frames
+	static void clear();
+
+	//! Set the memory budget in bytes. 0 disables the cache.
+	static void setBudget(uint32 bytes);
+	static uint32 getBudget() { return budget; }
+	static uint32 getMemoryUsed() { return used; }
+
+	//! While frozen, get() only returns frames that are already cached with
+	//! the right colours, and changes nothing. It can then be called from
+	//! several threads at once.
+	static void setFrozen(bool f) { frozen = f; }
+
+private:
+	static bool isCurrent(const CachedFrame* cf,
+						  const Pentagram::Palette* pal, bool untformed_pal);
+
+	static CachedFrame* decode(ShapeFrame* frame);
+	static void remap(CachedFrame* cf, const Pentagram::Palette* pal,
+					  bool untformed_pal);
+	static void unlink(CachedFrame* cf);
+	static void evict(CachedFrame* keep);
+
+	static uint32 budget;
+	static uint32 used;
+	static bool frozen;
+	static CachedFrame *lru_head, *lru_tail;	//!< most recently used first
+};
+
+#endif
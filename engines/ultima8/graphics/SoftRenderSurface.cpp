@@ -26,6 +26,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Texture.h"
 #include "Shape.h"
 #include "ShapeFrame.h"
+#include "ShapeFrameCache.h"
+#include "SpanBlit.h"
 #include "Palette.h"
 #include "FixedWidthFont.h"
 #include "memset_n.h"
@@ -85,6 +87,28 @@ template<class uintX> SoftRenderSurface<uintX>::SoftRenderSurface(int w, int h)
 }
 
 
+//
+// SoftRenderSurface::SoftRenderSurface(const SoftRenderSurface *)
+//
+// Desc: Create a view of another surface
+//
+template<class uintX> SoftRenderSurface<uintX>::SoftRenderSurface(const SoftRenderSurface<uintX> *o)
+	: BaseSoftRenderSurface(o)
+{
+}
+
+
+//
+// SoftRenderSurface::CreateView()
+//
+// Desc: Create a surface painting to the same pixels
+//
+template<class uintX> RenderSurface *SoftRenderSurface<uintX>::CreateView()
+{
+	return new SoftRenderSurface<uintX>(this);
+}
+
+
 //
 // SoftRenderSurface::Fill8(uint8 index, sint32 sx, sint32 sy, sint32 w, sint32 h)
 //
@@ -34,6 +34,9 @@ protected:
 	// Create Generic surface
 	SoftRenderSurface(int w, int h, int bpp, int rsft, int gsft, int bsft, int asft);
 
+	// Create a view (see CreateView)
+	explicit SoftRenderSurface(const SoftRenderSurface<uintX> *);
+
 public:
 
 	// Create from a SDL_Surface
@@ -45,6 +48,9 @@ public:
 	// Create a Render to texture surface
 	SoftRenderSurface(int w, int h);
 
+	// Create a view of this surface
+	virtual RenderSurface *CreateView();
+
 	//
 	// Surface Filling
 	//
@@ -40,6 +40,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // #define BLEND_CONDITIONAL to an argument of the function so BLEND
 // painting can be enabled/disabled with a bool
 //
+// #define NO_SPAN_BLIT to paint all runs of cached frames pixel by pixel
+// instead of using the SpanBlit functions
+//
 
 //
 // Macros defined by this file:
@@ -53,6 +56,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // XNEG - Negates X values if doing shape flipping
 // 
 // USE_XFORM_FUNC - Checks to see if we want to use XForm Blending for this pixel
+//
+// USE_XFORM_CACHED - The same for a pixel of a CachedFrame
+//
+// CLIP_SPAN - Clips a run of pixels of a CachedFrame
 // 
 // CUSTOM_BLEND - Final Blend for invisiblity
 //
@@ -64,8 +71,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #ifdef XFORM_CONDITIONAL
 #define USE_XFORM_FUNC ((XFORM_CONDITIONAL) && xform_pal[*linedata])
+#define USE_XFORM_CACHED(xf) ((XFORM_CONDITIONAL) && (xf))
 #else
 #define USE_XFORM_FUNC (xform_pal[*linedata])
+#define USE_XFORM_CACHED(xf) (xf)
 #endif
 
 //
@@ -73,6 +82,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //
 #else
 #define USE_XFORM_FUNC 0
+#define USE_XFORM_CACHED(xf) 0
 #endif
 
 
@@ -103,6 +113,7 @@ const sint32 neg = (FLIP_CONDITIONAL)?-1:0;
 #define NOT_CLIPPED_X (1)
 #define NOT_CLIPPED_Y (1)
 #define OFFSET_PIXELS (pixels)
+#define CLIP_SPAN()
 
 //
 // No Clipping = FALSE
@@ -113,6 +124,18 @@ const sint32 neg = (FLIP_CONDITIONAL)?-1:0;
 #define NOT_CLIPPED_Y (line >= 0 && line < scrn_height)
 #define NOT_CLIPPED_X (pixptr >= line_start && pixptr < line_end)
 
+// Find the pixels k0 <= k < k1 of the span that are on the line
+#define CLIP_SPAN() do { \
+		sint32 col = x + XNEG(span->x); \
+		if (XNEG(1) > 0) { \
+			if (col < 0) k0 = -col; \
+			if (col + k1 > scrn_width) k1 = scrn_width - col; \
+		} else { \
+			if (col >= scrn_width) k0 = col - scrn_width + 1; \
+			if (col - k1 < -1) k1 = col + 1; \
+		} \
+	} while (0)
+
 	int					scrn_width = clip_window.w;
 	int					scrn_height = clip_window.h;
 	uintX				*line_end;
@@ -198,8 +221,75 @@ const sint32 neg = (FLIP_CONDITIONAL)?-1:0;
 	x -= XNEG(frame->xoff);
 	y -= frame->yoff;
 
+	const CachedFrame *cached = s->isUncached() ? 0 :
+		ShapeFrameCache::get(frame, s->getPalette(), untformed_pal);
+
+	// Use the decoded frame if it is cached
+	if (cached) for (int i=0; i<height; i++)
+	{
+		line = y+i;
+
+		if (NOT_CLIPPED_Y)
+		{
+			line_start = reinterpret_cast<uintX *>(static_cast<uint8*>(OFFSET_PIXELS) + pitch*line);
+
+			const uint32 *colours = cached->getColours();
+#ifdef XFORM_SHAPES
+			const uint32 *xforms = cached->getXForms();
+#endif
+			const CachedFrame::Span *span = cached->getSpans(i);
+			const CachedFrame::Span *span_end = cached->getSpans(i+1);
+
+			for (; span != span_end; ++span)
+			{
+				sint32 k0 = 0;
+				sint32 k1 = span->len;
+
+				CLIP_SPAN();
+				if (k0 >= k1) continue;
+
+				pixptr = line_start+x+XNEG(span->x+k0);
+				const uint32 *colour = colours + span->first;
+#ifdef XFORM_SHAPES
+				const uint32 *xform = xforms ? xforms + span->first : 0;
+#endif
+
+#if !defined(BLEND_SHAPES) && !defined(DESTALPHA_MASK) && !defined(NO_SPAN_BLIT)
+				// Long runs that aren't flipped go to the span blitters
+				if (k1 - k0 >= SPANBLIT_MIN_LENGTH && XNEG(1) > 0)
+				{
+#ifdef XFORM_SHAPES
+					if (xform && USE_XFORM_CACHED(1))
+						Pentagram::blitSpanXForm(pixptr, colour+k0, xform+k0, k1-k0);
+					else
+#endif
+						Pentagram::blitSpan(pixptr, colour+k0, k1-k0);
+					continue;
+				}
+#endif
+
+				for (sint32 k = k0; k < k1; k++)
+				{
+					if (NOT_DESTINATION_MASKED)
+					{
+						#ifdef XFORM_SHAPES
+						if (xform && USE_XFORM_CACHED(xform[k]))
+						{
+							*pixptr = CUSTOM_BLEND(BlendPreModulated(xform[k],*pixptr));
+						}
+						else
+						#endif
+						{
+							*pixptr = CUSTOM_BLEND(colour[k]);
+						}
+					}
+					pixptr += XNEG(1);
+				}
+			}
+		}
+	}
 	// Do it this way if compressed
-	if (frame->compressed) for (int i=0; i<height; i++) 
+	else if (frame->compressed) for (int i=0; i<height; i++) 
 	{
 		xpos = 0;
 		line = y+i;
@@ -335,3 +425,5 @@ const sint32 neg = (FLIP_CONDITIONAL)?-1:0;
 #undef NOT_CLIPPED_Y
 #undef XNEG
 #undef USE_XFORM_FUNC
+#undef USE_XFORM_CACHED
+#undef CLIP_SPAN
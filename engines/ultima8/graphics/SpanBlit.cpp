@@ -0,0 +1,507 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "SpanBlit.h"
+#include "XFormBlend.h"
+
+#include <cstring>
+
+#ifndef NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPANBLIT_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPANBLIT_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SPANBLIT_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Pentagram {
+
+template<class uintX>
+static inline void xformTail(uintX* dst, const uint32* src,
+							 const uint32* xform, unsigned int i,
+							 unsigned int n)
+{
+	for (; i < n; ++i) {
+		if (xform[i])
+			dst[i] = static_cast<uintX>(BlendPreModulated(xform[i], dst[i]));
+		else
+			dst[i] = static_cast<uintX>(src[i]);
+	}
+}
+
+static inline void copyTail(uint16* dst, const uint32* src,
+							unsigned int i, unsigned int n)
+{
+	for (; i < n; ++i)
+		dst[i] = static_cast<uint16>(src[i]);
+}
+
+void blitSpan_scalar(uint16* dst, const uint32* src, unsigned int n)
+{
+	copyTail(dst, src, 0, n);
+}
+
+void blitSpanXForm_scalar(uint16* dst, const uint32* src,
+						  const uint32* xform, unsigned int n)
+{
+	xformTail(dst, src, xform, 0, n);
+}
+
+void blitSpanXForm_scalar(uint32* dst, const uint32* src,
+						  const uint32* xform, unsigned int n)
+{
+	xformTail(dst, src, xform, 0, n);
+}
+
+void blitSpan(uint32* dst, const uint32* src, unsigned int n)
+{
+	std::memcpy(dst, src, n * sizeof(uint32));
+}
+
+#if defined(SPANBLIT_SSE2)
+
+//
+// BlendPreModulated for four pixels. All the values stay below 2^17, and
+// the products below 2^16, so 16 bit multiplies will do.
+//
+
+struct BlendShifts
+{
+	__m128i	r_shift, g_shift, b_shift;
+	__m128i	r_loss, g_loss, b_loss;
+	__m128i	r_loss16, g_loss16, b_loss16;
+
+	BlendShifts() {
+		const RenderSurface::Format& f = RenderSurface::format;
+		r_shift = _mm_cvtsi32_si128(f.r_shift);
+		g_shift = _mm_cvtsi32_si128(f.g_shift);
+		b_shift = _mm_cvtsi32_si128(f.b_shift);
+		r_loss = _mm_cvtsi32_si128(f.r_loss);
+		g_loss = _mm_cvtsi32_si128(f.g_loss);
+		b_loss = _mm_cvtsi32_si128(f.b_loss);
+		r_loss16 = _mm_cvtsi32_si128(f.r_loss16);
+		g_loss16 = _mm_cvtsi32_si128(f.g_loss16);
+		b_loss16 = _mm_cvtsi32_si128(f.b_loss16);
+	}
+};
+
+struct BlendFormat128 : public BlendShifts
+{
+	__m128i	r_mask, g_mask, b_mask;
+
+	BlendFormat128() {
+		const RenderSurface::Format& f = RenderSurface::format;
+		r_mask = _mm_set1_epi32(f.r_mask);
+		g_mask = _mm_set1_epi32(f.g_mask);
+		b_mask = _mm_set1_epi32(f.b_mask);
+	}
+};
+
+static inline __m128i min65535(__m128i v)
+{
+	const __m128i max = _mm_set1_epi32(65535);
+	__m128i over = _mm_cmpgt_epi32(v, max);
+	return _mm_or_si128(_mm_andnot_si128(over, v), _mm_and_si128(over, max));
+}
+
+static inline __m128i blend4(__m128i src, __m128i xform, __m128i dst,
+							 const BlendFormat128& f)
+{
+	const __m128i ff00 = _mm_set1_epi32(0xFF00);
+
+	// UNPACK_RGB8(dst)
+	__m128i r = _mm_sll_epi32(_mm_srl_epi32(_mm_and_si128(dst, f.r_mask), f.r_shift), f.r_loss);
+	__m128i g = _mm_sll_epi32(_mm_srl_epi32(_mm_and_si128(dst, f.g_mask), f.g_shift), f.g_loss);
+	__m128i b = _mm_sll_epi32(_mm_srl_epi32(_mm_and_si128(dst, f.b_mask), f.b_shift), f.b_loss);
+
+	__m128i ia = _mm_sub_epi32(_mm_set1_epi32(256), _mm_srli_epi32(xform, 24));
+
+	r = _mm_add_epi32(_mm_mullo_epi16(r, ia), _mm_and_si128(_mm_slli_epi32(xform, 8), ff00));
+	g = _mm_add_epi32(_mm_mullo_epi16(g, ia), _mm_and_si128(xform, ff00));
+	b = _mm_add_epi32(_mm_mullo_epi16(b, ia), _mm_and_si128(_mm_srli_epi32(xform, 8), ff00));
+
+	// PACK_RGB16
+	r = _mm_sll_epi32(_mm_srl_epi32(min65535(r), f.r_loss16), f.r_shift);
+	g = _mm_sll_epi32(_mm_srl_epi32(min65535(g), f.g_loss16), f.g_shift);
+	b = _mm_sll_epi32(_mm_srl_epi32(min65535(b), f.b_loss16), f.b_shift);
+	__m128i blended = _mm_or_si128(_mm_or_si128(r, g), b);
+
+	// pixels without an xform colour are just copied
+	__m128i plain = _mm_cmpeq_epi32(xform, _mm_setzero_si128());
+	return _mm_or_si128(_mm_and_si128(plain, src),
+						_mm_andnot_si128(plain, blended));
+}
+
+// narrow eight values below 2^16 to 16 bits
+static inline __m128i narrow8(__m128i lo, __m128i hi)
+{
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+static void blitSpan_sse2(uint16* dst, const uint32* src, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i+4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), narrow8(lo, hi));
+	}
+	copyTail(dst, src, i, n);
+}
+
+static void blitSpanXForm_sse2(uint16* dst, const uint32* src,
+							   const uint32* xform, unsigned int n)
+{
+	BlendFormat128 f;
+	const __m128i zero = _mm_setzero_si128();
+
+	unsigned int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst+i));
+		__m128i lo = blend4(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(xform+i)),
+			_mm_unpacklo_epi16(d, zero), f);
+		__m128i hi = blend4(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i+4)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(xform+i+4)),
+			_mm_unpackhi_epi16(d, zero), f);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), narrow8(lo, hi));
+	}
+	xformTail(dst, src, xform, i, n);
+}
+
+static void blitSpanXForm_sse2(uint32* dst, const uint32* src,
+							   const uint32* xform, unsigned int n)
+{
+	BlendFormat128 f;
+
+	unsigned int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i d = blend4(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(xform+i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst+i)), f);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), d);
+	}
+	xformTail(dst, src, xform, i, n);
+}
+
+#if defined(SPANBLIT_AVX2)
+
+//
+// The same eight pixels at a time
+//
+
+#define SPANBLIT_AVX2_FUNC __attribute__((target("avx2")))
+
+struct BlendFormat256 : public BlendShifts
+{
+	__m256i	r_mask, g_mask, b_mask;
+
+	SPANBLIT_AVX2_FUNC BlendFormat256() {
+		const RenderSurface::Format& f = RenderSurface::format;
+		r_mask = _mm256_set1_epi32(f.r_mask);
+		g_mask = _mm256_set1_epi32(f.g_mask);
+		b_mask = _mm256_set1_epi32(f.b_mask);
+	}
+};
+
+static inline SPANBLIT_AVX2_FUNC __m256i blend8(__m256i src, __m256i xform,
+												__m256i dst,
+												const BlendFormat256& f)
+{
+	const __m256i ff00 = _mm256_set1_epi32(0xFF00);
+	const __m256i max = _mm256_set1_epi32(65535);
+
+	__m256i r = _mm256_sll_epi32(_mm256_srl_epi32(_mm256_and_si256(dst, f.r_mask), f.r_shift), f.r_loss);
+	__m256i g = _mm256_sll_epi32(_mm256_srl_epi32(_mm256_and_si256(dst, f.g_mask), f.g_shift), f.g_loss);
+	__m256i b = _mm256_sll_epi32(_mm256_srl_epi32(_mm256_and_si256(dst, f.b_mask), f.b_shift), f.b_loss);
+
+	__m256i ia = _mm256_sub_epi32(_mm256_set1_epi32(256), _mm256_srli_epi32(xform, 24));
+
+	r = _mm256_add_epi32(_mm256_mullo_epi16(r, ia), _mm256_and_si256(_mm256_slli_epi32(xform, 8), ff00));
+	g = _mm256_add_epi32(_mm256_mullo_epi16(g, ia), _mm256_and_si256(xform, ff00));
+	b = _mm256_add_epi32(_mm256_mullo_epi16(b, ia), _mm256_and_si256(_mm256_srli_epi32(xform, 8), ff00));
+
+	r = _mm256_sll_epi32(_mm256_srl_epi32(_mm256_min_epi32(r, max), f.r_loss16), f.r_shift);
+	g = _mm256_sll_epi32(_mm256_srl_epi32(_mm256_min_epi32(g, max), f.g_loss16), f.g_shift);
+	b = _mm256_sll_epi32(_mm256_srl_epi32(_mm256_min_epi32(b, max), f.b_loss16), f.b_shift);
+	__m256i blended = _mm256_or_si256(_mm256_or_si256(r, g), b);
+
+	__m256i plain = _mm256_cmpeq_epi32(xform, _mm256_setzero_si256());
+	return _mm256_blendv_epi8(blended, src, plain);
+}
+
+static SPANBLIT_AVX2_FUNC void blitSpan_avx2(uint16* dst, const uint32* src,
+											 unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i));
+		__m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i+8));
+		// packus works per 128 bit lane, so put the quarters back in order
+		__m256i d = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), d);
+	}
+	copyTail(dst, src, i, n);
+}
+
+static SPANBLIT_AVX2_FUNC void blitSpanXForm_avx2(uint16* dst,
+												  const uint32* src,
+												  const uint32* xform,
+												  unsigned int n)
+{
+	BlendFormat256 f;
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst+i));
+		__m256i lo = blend8(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xform+i)),
+			_mm256_cvtepu16_epi32(_mm256_castsi256_si128(d)), f);
+		__m256i hi = blend8(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i+8)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xform+i+8)),
+			_mm256_cvtepu16_epi32(_mm256_extracti128_si256(d, 1)), f);
+		d = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), d);
+	}
+	xformTail(dst, src, xform, i, n);
+}
+
+static SPANBLIT_AVX2_FUNC void blitSpanXForm_avx2(uint32* dst,
+												  const uint32* src,
+												  const uint32* xform,
+												  unsigned int n)
+{
+	BlendFormat256 f;
+
+	unsigned int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i d = blend8(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xform+i)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst+i)), f);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), d);
+	}
+	xformTail(dst, src, xform, i, n);
+}
+
+static bool hasAVX2()
+{
+	static int avx2 = -1;
+	if (avx2 < 0) {
+		__builtin_cpu_init();
+		avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+	}
+	return avx2 != 0;
+}
+
+void blitSpan(uint16* dst, const uint32* src, unsigned int n)
+{
+	if (hasAVX2()) blitSpan_avx2(dst, src, n);
+	else blitSpan_sse2(dst, src, n);
+}
+
+void blitSpanXForm(uint16* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	if (hasAVX2()) blitSpanXForm_avx2(dst, src, xform, n);
+	else blitSpanXForm_sse2(dst, src, xform, n);
+}
+
+void blitSpanXForm(uint32* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	if (hasAVX2()) blitSpanXForm_avx2(dst, src, xform, n);
+	else blitSpanXForm_sse2(dst, src, xform, n);
+}
+
+const char* getSpanBlitter()
+{
+	return hasAVX2() ? "AVX2" : "SSE2";
+}
+
+#else
+
+void blitSpan(uint16* dst, const uint32* src, unsigned int n)
+{
+	blitSpan_sse2(dst, src, n);
+}
+
+void blitSpanXForm(uint16* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	blitSpanXForm_sse2(dst, src, xform, n);
+}
+
+void blitSpanXForm(uint32* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	blitSpanXForm_sse2(dst, src, xform, n);
+}
+
+const char* getSpanBlitter()
+{
+	return "SSE2";
+}
+
+#endif
+
+#elif defined(SPANBLIT_NEON)
+
+struct BlendFormatNEON
+{
+	uint32x4_t	r_mask, g_mask, b_mask;
+	int32x4_t	r_shift, g_shift, b_shift;		// negative: right shifts
+	int32x4_t	r_loss, g_loss, b_loss;
+	int32x4_t	r_loss16, g_loss16, b_loss16;	// negative: right shifts
+	int32x4_t	r_pack, g_pack, b_pack;
+
+	BlendFormatNEON() {
+		const RenderSurface::Format& f = RenderSurface::format;
+		r_mask = vdupq_n_u32(f.r_mask);
+		g_mask = vdupq_n_u32(f.g_mask);
+		b_mask = vdupq_n_u32(f.b_mask);
+		r_shift = vdupq_n_s32(-static_cast<sint32>(f.r_shift));
+		g_shift = vdupq_n_s32(-static_cast<sint32>(f.g_shift));
+		b_shift = vdupq_n_s32(-static_cast<sint32>(f.b_shift));
+		r_loss = vdupq_n_s32(f.r_loss);
+		g_loss = vdupq_n_s32(f.g_loss);
+		b_loss = vdupq_n_s32(f.b_loss);
+		r_loss16 = vdupq_n_s32(-static_cast<sint32>(f.r_loss16));
+		g_loss16 = vdupq_n_s32(-static_cast<sint32>(f.g_loss16));
+		b_loss16 = vdupq_n_s32(-static_cast<sint32>(f.b_loss16));
+		r_pack = vdupq_n_s32(f.r_shift);
+		g_pack = vdupq_n_s32(f.g_shift);
+		b_pack = vdupq_n_s32(f.b_shift);
+	}
+};
+
+static inline uint32x4_t blend4(uint32x4_t src, uint32x4_t xform,
+								uint32x4_t dst, const BlendFormatNEON& f)
+{
+	const uint32x4_t ff00 = vdupq_n_u32(0xFF00);
+	const uint32x4_t max = vdupq_n_u32(65535);
+
+	uint32x4_t r = vshlq_u32(vshlq_u32(vandq_u32(dst, f.r_mask), f.r_shift), f.r_loss);
+	uint32x4_t g = vshlq_u32(vshlq_u32(vandq_u32(dst, f.g_mask), f.g_shift), f.g_loss);
+	uint32x4_t b = vshlq_u32(vshlq_u32(vandq_u32(dst, f.b_mask), f.b_shift), f.b_loss);
+
+	uint32x4_t ia = vsubq_u32(vdupq_n_u32(256), vshrq_n_u32(xform, 24));
+
+	r = vmlaq_u32(vandq_u32(vshlq_n_u32(xform, 8), ff00), r, ia);
+	g = vmlaq_u32(vandq_u32(xform, ff00), g, ia);
+	b = vmlaq_u32(vandq_u32(vshrq_n_u32(xform, 8), ff00), b, ia);
+
+	r = vshlq_u32(vshlq_u32(vminq_u32(r, max), f.r_loss16), f.r_pack);
+	g = vshlq_u32(vshlq_u32(vminq_u32(g, max), f.g_loss16), f.g_pack);
+	b = vshlq_u32(vshlq_u32(vminq_u32(b, max), f.b_loss16), f.b_pack);
+	uint32x4_t blended = vorrq_u32(vorrq_u32(r, g), b);
+
+	uint32x4_t plain = vceqq_u32(xform, vdupq_n_u32(0));
+	return vbslq_u32(plain, src, blended);
+}
+
+void blitSpan(uint16* dst, const uint32* src, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		uint16x4_t lo = vmovn_u32(vld1q_u32(src+i));
+		uint16x4_t hi = vmovn_u32(vld1q_u32(src+i+4));
+		vst1q_u16(dst+i, vcombine_u16(lo, hi));
+	}
+	copyTail(dst, src, i, n);
+}
+
+void blitSpanXForm(uint16* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	BlendFormatNEON f;
+
+	unsigned int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		uint16x8_t d = vld1q_u16(dst+i);
+		uint32x4_t lo = blend4(vld1q_u32(src+i), vld1q_u32(xform+i),
+							   vmovl_u16(vget_low_u16(d)), f);
+		uint32x4_t hi = blend4(vld1q_u32(src+i+4), vld1q_u32(xform+i+4),
+							   vmovl_u16(vget_high_u16(d)), f);
+		vst1q_u16(dst+i, vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+	}
+	xformTail(dst, src, xform, i, n);
+}
+
+void blitSpanXForm(uint32* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	BlendFormatNEON f;
+
+	unsigned int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t d = blend4(vld1q_u32(src+i), vld1q_u32(xform+i),
+							  vld1q_u32(dst+i), f);
+		vst1q_u32(dst+i, d);
+	}
+	xformTail(dst, src, xform, i, n);
+}
+
+const char* getSpanBlitter()
+{
+	return "NEON";
+}
+
+#else
+
+void blitSpan(uint16* dst, const uint32* src, unsigned int n)
+{
+	copyTail(dst, src, 0, n);
+}
+
+void blitSpanXForm(uint16* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	xformTail(dst, src, xform, 0, n);
+}
+
+void blitSpanXForm(uint32* dst, const uint32* src, const uint32* xform,
+				   unsigned int n)
+{
+	xformTail(dst, src, xform, 0, n);
+}
+
+const char* getSpanBlitter()
+{
+	return "scalar";
+}
+
+#endif
+
+}
@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// Span blitters for the runs of pixels of a CachedFrame.
+//
+// There are SSE2 and NEON versions, and an AVX2 version that is picked at
+// runtime on x86 CPUs that support it (GCC and clang only). The scalar
+// version is used when none of them is available (or when NO_SIMD is
+// defined).
+//
+
+#ifndef SPANBLIT_H
+#define SPANBLIT_H
+
+//! spans shorter than this are painted pixel by pixel
+#define SPANBLIT_MIN_LENGTH		8
+
+namespace Pentagram {
+
+//! dst[i] = src[i]
+void blitSpan(uint16* dst, const uint32* src, unsigned int n);
+void blitSpan(uint32* dst, const uint32* src, unsigned int n);
+
+//! dst[i] = xform[i] ? BlendPreModulated(xform[i],dst[i]) : src[i]
+void blitSpanXForm(uint16* dst, const uint32* src, const uint32* xform,
+				   unsigned int n);
+void blitSpanXForm(uint32* dst, const uint32* src, const uint32* xform,
+				   unsigned int n);
+
+//! Scalar versions of the above
+void blitSpan_scalar(uint16* dst, const uint32* src, unsigned int n);
+void blitSpanXForm_scalar(uint16* dst, const uint32* src,
+						  const uint32* xform, unsigned int n);
+void blitSpanXForm_scalar(uint32* dst, const uint32* src,
+						  const uint32* xform, unsigned int n);
+
+//! name of the instruction set the blitters use
+const char* getSpanBlitter();
+
+}
+
+#endif
@@ -52,6 +52,7 @@ FontManager::~FontManager()
 	con.Print(MM_INFO, "Destroying Font Manager...\n");
 
 	resetGameFonts();
+	clearGlyphs();
 
 	for (unsigned int i = 0; i < ttfonts.size(); ++i)
 		delete ttfonts[i];
@@ -85,6 +86,47 @@ Pentagram::Font* FontManager::getGameFont(unsigned int fontnum,
 	return sf;  // implicit upcast to Pentagram::Font*
 }
 
+const FontManager::Glyph* FontManager::getGlyph(TTF_Font* font, uint16 ch,
+												uint32 rgb,
+												bool antialiased) const
+{
+	GlyphId id;
+	id.font = font;
+	id.rgb = rgb;
+	id.ch = ch;
+	id.antialiased = antialiased;
+
+	std::map<GlyphId, Glyph*>::const_iterator iter = glyphs.find(id);
+	if (iter == glyphs.end()) return 0;
+	return iter->second;
+}
+
+void FontManager::addGlyph(TTF_Font* font, uint16 ch, uint32 rgb,
+						   bool antialiased, Glyph* glyph)
+{
+	// Text uses few glyphs, so simply start over when there are too many
+	if (glyphs.size() >= FONTMANAGER_MAX_GLYPHS)
+		clearGlyphs();
+
+	GlyphId id;
+	id.font = font;
+	id.rgb = rgb;
+	id.ch = ch;
+	id.antialiased = antialiased;
+
+	Glyph*& entry = glyphs[id];
+	delete entry;
+	entry = glyph;
+}
+
+void FontManager::clearGlyphs()
+{
+	std::map<GlyphId, Glyph*>::iterator iter;
+	for (iter = glyphs.begin(); iter != glyphs.end(); ++iter)
+		delete iter->second;
+	glyphs.clear();
+}
+
 Pentagram::Font* FontManager::getTTFont(unsigned int fontnum)
 {
 	if (fontnum >= ttfonts.size())
@@ -31,6 +31,9 @@ class IDataSource;
 
 class TTFont;
 
+//! number of glyphs kept before the glyph cache is emptied
+#define FONTMANAGER_MAX_GLYPHS	4096
+
 
 class FontManager
 {
@@ -72,6 +75,27 @@ public:
 
 	// Reset the game fonts
 	void resetGameFonts();
+
+	//! A glyph rendered by SDL_ttf. Every pixel holds the glyph's colour,
+	//! with the coverage in the alpha channel.
+	struct Glyph {
+		int width, height;
+		int advance;
+		std::vector<uint32> pixels;
+	};
+
+	//! Get a glyph from the glyph cache, shared by all TTFonts.
+	//! \param rgb the colour it was rendered in (0 if not antialiased)
+	//! \return 0 if it isn't cached
+	const Glyph* getGlyph(TTF_Font* font, uint16 ch, uint32 rgb,
+						  bool antialiased) const;
+
+	//! Add a glyph to the glyph cache. The cache takes ownership.
+	void addGlyph(TTF_Font* font, uint16 ch, uint32 rgb, bool antialiased,
+				  Glyph* glyph);
+
+	//! Empty the glyph cache
+	void clearGlyphs();
 private:
 
 	struct TTFId {
@@ -86,6 +110,20 @@ private:
 	std::map<TTFId, TTF_Font*> ttf_fonts;
 	bool ttf_antialiasing;
 
+	struct GlyphId {
+		TTF_Font* font;
+		uint32 rgb;
+		uint16 ch;
+		bool antialiased;
+		bool operator<(const GlyphId& other) const {
+			if (font != other.font) return font < other.font;
+			if (ch != other.ch) return ch < other.ch;
+			if (rgb != other.rgb) return rgb < other.rgb;
+			return antialiased < other.antialiased;
+		}
+	};
+	std::map<GlyphId, Glyph*> glyphs;
+
 	//! Get a (possibly cached) TTF_Font structure for filename/pointsize,
 	//! loading it if necessary.
 	TTF_Font* getTTF_Font(std::string filename, int pointsize);
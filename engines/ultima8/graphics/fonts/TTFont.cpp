@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "RenderSurface.h"
 #include "TTFont.h"
 #include "TTFRenderedText.h"
+#include "FontManager.h"
 #include "Texture.h"
 #include "IDataSource.h"
 #include "encoding.h"
@@ -108,6 +109,103 @@ static uint16* toUnicode(const std::string& text, uint16 bullet)
 }
 
 
+const FontManager::Glyph* TTFont::getGlyph(uint16 ch)
+{
+	FontManager* fontman = FontManager::get_instance();
+	uint32 glyph_rgb = antiAliased ? rgb : 0;
+
+	const FontManager::Glyph* glyph = fontman->getGlyph(ttf_font, ch,
+														glyph_rgb, antiAliased);
+	if (glyph) return glyph;
+
+	int minx, maxx, miny, maxy, advance;
+	if (TTF_GlyphMetrics(ttf_font, ch, &minx, &maxx,
+						 &miny, &maxy, &advance) != 0)
+		return 0;
+
+	// let SDL_ttf render the glyph
+	SDL_Surface* glyphsurf;
+
+	if (!antiAliased)
+	{
+		SDL_Color white = { 0xFF , 0xFF , 0xFF, 0 };
+		glyphsurf = TTF_RenderGlyph_Solid(ttf_font, ch, white);
+	}
+	else
+	{
+		SDL_Color colour = { static_cast<Uint8>(TEX32_R(rgb)), static_cast<Uint8>(TEX32_G(rgb)), static_cast<Uint8>(TEX32_B(rgb)), 0 };
+		SDL_Color black = { 0x00 , 0x00 , 0x00, 0 };
+		glyphsurf = TTF_RenderGlyph_Shaded(ttf_font, ch, colour, black);
+	}
+
+	FontManager::Glyph* newglyph = new FontManager::Glyph;
+	newglyph->advance = advance;
+	newglyph->width = 0;
+	newglyph->height = 0;
+
+	if (glyphsurf) {
+		SDL_LockSurface(glyphsurf);
+
+		SDL_Palette *pal = glyphsurf->format->palette;
+		newglyph->width = glyphsurf->w;
+		newglyph->height = glyphsurf->h;
+		newglyph->pixels.resize(glyphsurf->w * glyphsurf->h, 0);
+
+		for (int y = 0; y < glyphsurf->h; y++) {
+			uint8* surfrow = static_cast<uint8*>(glyphsurf->pixels) + y * glyphsurf->pitch;
+			uint32* glyphrow = &newglyph->pixels[y * glyphsurf->w];
+			for (int x = 0; x < glyphsurf->w; x++) {
+				uint32 idx = surfrow[x];
+				if (!antiAliased) {
+					if (idx == 1) glyphrow[x] = 0xFF000000;
+				} else if (idx != 0) {
+					SDL_Color pe = pal->colors[idx];
+					glyphrow[x] = TEX32_PACK_RGBA(pe.r, pe.g, pe.b, idx);
+				}
+			}
+		}
+
+		SDL_UnlockSurface(glyphsurf);
+		SDL_FreeSurface(glyphsurf);
+	}
+
+	fontman->addGlyph(ttf_font, ch, glyph_rgb, antiAliased, newglyph);
+	return newglyph;
+}
+
+void TTFont::renderGlyphs(const uint16* unicodetext,
+						  std::vector<uint32>& line, int& w, int& h)
+{
+	TTF_SizeUNICODE(ttf_font, unicodetext, &w, &h);
+	line.assign(w * h, 0);
+
+	int penx = 0;
+	uint16 prev = 0;
+	for (const uint16* c = unicodetext; *c; ++c) {
+		if (prev)
+			penx += TTF_GetFontKerningSizeGlyphs(ttf_font, prev, *c);
+		prev = *c;
+
+		const FontManager::Glyph* glyph = getGlyph(*c);
+		if (!glyph) continue;
+
+		int gh = glyph->height < h ? glyph->height : h;
+		for (int y = 0; y < gh; y++) {
+			const uint32* glyphrow = &glyph->pixels[y * glyph->width];
+			uint32* linerow = &line[y * w];
+			for (int x = 0; x < glyph->width; x++) {
+				int lx = penx + x;
+				if (lx < 0 || lx >= w) continue;
+				// glyphs can overlap a little, so keep the most opaque pixel
+				if (TEX32_A(glyphrow[x]) > TEX32_A(linerow[lx]))
+					linerow[lx] = glyphrow[x];
+			}
+		}
+
+		penx += glyph->advance;
+	}
+}
+
 void TTFont::getStringSize(const std::string& text, int& width, int& height)
 {
 	// convert to unicode
@@ -189,39 +287,26 @@ RenderedText* TTFont::renderText(const std::string& text,
 		else
 			unicodetext = toUnicode<SJISTraits>(iter->text, bullet);
 
-		// let SDL_ttf render the text
-		SDL_Surface* textsurf;
-
-		if (!antiAliased)
-		{
-			SDL_Color white = { 0xFF , 0xFF , 0xFF, 0 };
-			textsurf = TTF_RenderUNICODE_Solid(ttf_font, unicodetext, white);
-		}
-		else 
-		{
-			SDL_Color colour = { static_cast<Uint8>(TEX32_R(rgb)), static_cast<Uint8>(TEX32_G(rgb)), static_cast<Uint8>(TEX32_B(rgb)), 0 };
-			SDL_Color black = { 0x00 , 0x00 , 0x00, 0 };
-			textsurf = TTF_RenderUNICODE_Shaded(ttf_font, unicodetext, colour, black);
-		}
-
-		if (textsurf) { 
-			SDL_LockSurface(textsurf);
+		// put the line together from the cached glyphs
+		std::vector<uint32> line;
+		int linew, lineh;
+		renderGlyphs(unicodetext, line, linew, lineh);
 
+		if (!line.empty()) {
 #if 0
 			pout << iter->dims.w << "," << iter->dims.h << " vs. "
-				 << textsurf->w << "," << textsurf->h << ": " << iter->text
+				 << linew << "," << lineh << ": " << iter->text
 				 << std::endl;
 #endif
-			SDL_Palette *pal = textsurf->format->palette;
 
-			// render the text surface into our texture buffer
-			for (int y = 0; y < textsurf->h; y++) {
-				uint8* surfrow = static_cast<uint8*>(textsurf->pixels) + y * textsurf->pitch;
+			// render the line into our texture buffer
+			for (int y = 0; y < lineh; y++) {
+				const uint32* linerow = &line[y * linew];
 				// CHECKME: bordersize!
 				uint32* bufrow = buf + (iter->dims.y+y+bordersize)*resultwidth;
-				for (int x = 0; x < textsurf->w; x++) {
+				for (int x = 0; x < linew; x++) {
 
-					if (!antiAliased && surfrow[x] == 1) {
+					if (!antiAliased && TEX32_A(linerow[x]) != 0) {
 
 						bufrow[iter->dims.x+x+bordersize] = rgb | 0xFF000000;
 						if (bordersize <= 0) continue;
@@ -256,16 +341,15 @@ RenderedText* TTFont::renderText(const std::string& text,
 					}
 					else if (antiAliased)
 					{
-						uint32 idx = surfrow[x];
+						uint32 idx = TEX32_A(linerow[x]);
 
 						if (idx == 0) continue;
-						SDL_Color pe = pal->colors[idx];
 
 						if (bordersize <= 0) {
-							bufrow[iter->dims.x+x+bordersize] = TEX32_PACK_RGBA(pe.r, pe.g, pe.b, idx);
+							bufrow[iter->dims.x+x+bordersize] = linerow[x];
 						}
 						else {
-							bufrow[iter->dims.x+x+bordersize] = TEX32_PACK_RGBA(pe.r, pe.g, pe.b, 0xFF);
+							bufrow[iter->dims.x+x+bordersize] = linerow[x] | (0xFF << TEX32_A_SHIFT);
 							
 							// optimize common case
 							if (bordersize == 1) for (int dx = -1; dx <= 1; dx++) {
@@ -300,9 +384,6 @@ RenderedText* TTFont::renderText(const std::string& text,
 					}
 				}
 			}
-
-			SDL_UnlockSurface(textsurf);
-			SDL_FreeSurface(textsurf);
 		}
 
 		if (iter->cursor != std::string::npos) {
@@ -20,6 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define TTFONT_H
 
 #include "Font.h"
+#include "FontManager.h"
 
 // This is TTF_Font struct from SDL_ttf
 typedef struct _TTF_Font TTF_Font;
@@ -56,6 +57,14 @@ public:
 
 	ENABLE_RUNTIME_CLASSTYPE();
 protected:
+	//! Get a glyph from the FontManager's glyph cache, rendering it first
+	//! if it isn't there yet
+	const FontManager::Glyph* getGlyph(uint16 ch);
+
+	//! Put a line of text together from cached glyphs
+	void renderGlyphs(const uint16* unicodetext, std::vector<uint32>& line,
+					  int& w, int& h);
+
 	TTF_Font* ttf_font;
 	uint32 rgb;
 	int bordersize;
@@ -42,9 +42,12 @@ void FastAreaVisGump::PaintThis(RenderSurface* surf, sint32 lerp_factor, bool sc
 	surf->Fill32(0,1,1,MAP_NUM_CHUNKS,MAP_NUM_CHUNKS);
 
 
-	for (int y = 0; y < MAP_NUM_CHUNKS; y++)
-		for (int x = 0; x < MAP_NUM_CHUNKS; x++)
-			if (currentmap->isChunkFast(x,y)) surf->Fill32(0xFFFFFFFF,x+1,y+1,1,1);
+	const CurrentMap::FastChunks& fast = currentmap->getFastChunks();
+	for (unsigned int i = 0; fast.findNext(i); ++i) {
+		int x = CurrentMap::FastChunks::getX(i);
+		int y = CurrentMap::FastChunks::getY(i);
+		surf->Fill32(0xFFFFFFFF,x+1,y+1,1,1);
+	}
 }
 
 void FastAreaVisGump::ConCmd_toggle(const Console::ArgvType &argv)
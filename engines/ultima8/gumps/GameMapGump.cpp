@@ -47,6 +47,8 @@
 #include "PathfinderProcess.h"
 #include "UCList.h"
 #include "LoopScript.h"
+#include "PaletteManager.h"
+#include "Palette.h"
 
 // map dumping
 #include "Texture.h"
@@ -57,16 +59,19 @@
 DEFINE_RUNTIME_CLASSTYPE_CODE(GameMapGump,Gump);
 
 bool GameMapGump::highlightItems = false;
+bool GameMapGump::dirtyRects = false;
 
 GameMapGump::GameMapGump() :
-	Gump(), display_dragging(false)
+	Gump(), display_dragging(false), backbuffer(0), backbuffer_valid(false),
+	backbuffer_palette(0)
 {
 	display_list = new ItemSorter();
 }
 
 GameMapGump::GameMapGump(int X, int Y, int Width, int Height) :
 	Gump(X,Y,Width,Height, 0, FLAG_DONT_SAVE | FLAG_CORE_GUMP, LAYER_GAMEMAP),
-	display_list(0), display_dragging(false)
+	display_list(0), display_dragging(false), backbuffer(0),
+	backbuffer_valid(false), backbuffer_palette(0)
 {
 	// Offset the gump. We want 0,0 to be the centre
 	dims.x -= dims.w/2;
@@ -79,6 +84,7 @@ GameMapGump::GameMapGump(int X, int Y, int Width, int Height) :
 GameMapGump::~GameMapGump()
 {
 	delete display_list;
+	delete backbuffer;
 }
 
 void GameMapGump::GetCameraLocation(sint32& lx, sint32& ly, sint32& lz,
@@ -131,56 +137,71 @@ void GameMapGump::PaintThis(RenderSurface *surf, sint32 lerp_factor, bool scaled
 		zlimit = roof->getZ();
 	}
 
-	display_list->BeginDisplayList(surf, lx, ly, lz);
+	// Paint into the backbuffer, so only what changed has to be repainted
+	RenderSurface *target = surf;
+	if (dirtyRects && ItemSorter::IsIncremental())
+	{
+		if (!backbuffer) {
+			backbuffer = RenderSurface::CreateSecondaryRenderSurface(dims.w,
+																	 dims.h);
+			backbuffer_valid = false;
+		}
+		backbuffer->SetOrigin(-dims.x, -dims.y);
+		backbuffer->SetClippingRect(dims);
+		target = backbuffer;
+	}
+	else if (backbuffer)
+	{
+		FORGET_OBJECT(backbuffer);
+	}
+
+	display_list->BeginDisplayList(target, lx, ly, lz);
 
 	uint32 gametick = Kernel::get_instance()->getFrameNum();
 
 	bool paintEditorItems = GUIApp::get_instance()->isPaintEditorItems();
 
-	// Get all the required items
-	for (int cy = 0; cy < MAP_NUM_CHUNKS; cy++)
+	// Get all the required items (only the fast chunks)
+	const CurrentMap::FastChunks& fastchunks = map->getFastChunks();
+	for (unsigned int index = 0; fastchunks.findNext(index); ++index)
 	{
-		for (int cx = 0; cx < MAP_NUM_CHUNKS; cx++)
-		{
-			// Not fast, ignore
-			if (!map->isChunkFast(cx,cy)) continue;
-
-			const std::list<Item*>* items = map->getItemList(cx,cy);
+		int cx = CurrentMap::FastChunks::getX(index);
+		int cy = CurrentMap::FastChunks::getY(index);
+		const std::list<Item*>* items = map->getItemList(cx,cy);
 
-			if (!items) continue;
+		if (!items) continue;
 
-			std::list<Item*>::const_iterator it = items->begin();
-			std::list<Item*>::const_iterator end = items->end();
-			for (; it != end; ++it)
-			{
-				Item *item = *it;
-				if (!item) continue;
-
-				item->setupLerp(gametick);
-				item->doLerp(lerp_factor);
-
-				if (item->getZ() >= zlimit && !item->getShapeInfo()->is_draw())
-					continue;
-				if (!paintEditorItems && item->getShapeInfo()->is_editor())
-					continue;
-				if (item->getFlags() & Item::FLG_INVISIBLE) {
-					// special case: invisible avatar _is_ drawn
-					// HACK: unless EXT_TRANSPARENT is also set.
-					// (Used for hiding the avatar when drawing a full area map)
-
-					if (item->getObjId() == 1) {
-						if (item->getExtFlags() & Item::EXT_TRANSPARENT)
-							continue;
-
-						sint32 x, y, z;
-						item->getLerped(x, y, z);
-						display_list->AddItem(x,y,z,item->getShape(),item->getFrame(), item->getFlags() & ~Item::FLG_INVISIBLE, item->getExtFlags() | Item::EXT_TRANSPARENT, 1);
-					}
-
-					continue;
+		std::list<Item*>::const_iterator it = items->begin();
+		std::list<Item*>::const_iterator end = items->end();
+		for (; it != end; ++it)
+		{
+			Item *item = *it;
+			if (!item) continue;
+
+			item->setupLerp(gametick);
+			item->doLerp(lerp_factor);
+
+			if (item->getZ() >= zlimit && !item->getShapeInfo()->is_draw())
+				continue;
+			if (!paintEditorItems && item->getShapeInfo()->is_editor())
+				continue;
+			if (item->getFlags() & Item::FLG_INVISIBLE) {
+				// special case: invisible avatar _is_ drawn
+				// HACK: unless EXT_TRANSPARENT is also set.
+				// (Used for hiding the avatar when drawing a full area map)
+
+				if (item->getObjId() == 1) {
+					if (item->getExtFlags() & Item::EXT_TRANSPARENT)
+						continue;
+
+					sint32 x, y, z;
+					item->getLerped(x, y, z);
+					display_list->AddItem(x,y,z,item->getShape(),item->getFrame(), item->getFlags() & ~Item::FLG_INVISIBLE, item->getExtFlags() | Item::EXT_TRANSPARENT, 1);
 				}
-				display_list->AddItem(item);
+
+				continue;
 			}
+			display_list->AddItem(item);
 		}
 	}
 
@@ -192,8 +213,39 @@ void GameMapGump::PaintThis(RenderSurface *surf, sint32 lerp_factor, bool scaled
 							  dragging_flags, Item::EXT_TRANSPARENT);
 	}
 
+	if (!backbuffer) {
+		display_list->PaintDisplayList(highlightItems);
+		return;
+	}
+
+	// A new palette changes every pixel. Highlighted items are repainted
+	// every frame, and have to be painted over in the next.
+	Pentagram::Palette *pal = PaletteManager::get_instance()->
+		getPalette(PaletteManager::Pal_Game);
+	uint32 palrev = pal ? pal->revision : 0;
 
-	display_list->PaintDisplayList(highlightItems);
+	if (!backbuffer_valid || highlightItems || palrev != backbuffer_palette ||
+		!display_list->GetDirtyRects(dirty_rects))
+	{
+		backbuffer->Fill32(0x000000, dims.x, dims.y, dims.w, dims.h);
+		display_list->PaintDisplayList(highlightItems);
+	}
+	else
+	{
+		std::vector<Pentagram::Rect>::iterator it;
+		for (it = dirty_rects.begin(); it != dirty_rects.end(); ++it)
+		{
+			backbuffer->SetClippingRect(*it);
+			backbuffer->Fill32(0x000000, it->x, it->y, it->w, it->h);
+			display_list->PaintDisplayList(false, true);
+		}
+		backbuffer->SetClippingRect(dims);
+	}
+	backbuffer_valid = !highlightItems;
+	backbuffer_palette = palrev;
+
+	Texture *tex = backbuffer->GetSurfaceAsTexture();
+	surf->Blit(tex, 0, 0, dims.w, dims.h, dims.x, dims.y);
 }
 
 // Trace a click, and return ObjId
@@ -782,6 +834,8 @@ void GameMapGump::RenderSurfaceChanged()
 	dims.x -= dims.w/2;
 	dims.y -= dims.h/2;
 
+	FORGET_OBJECT(backbuffer);
+
 	Gump::RenderSurfaceChanged();
 }
 
@@ -24,6 +24,7 @@
 
 class ItemSorter;
 class CameraProcess;
+class RenderSurface;
 
 class GameMapGump : public Gump
 {
@@ -73,6 +74,11 @@ public:
 	static void			SetHighlightItems(bool highlight) { highlightItems = highlight; }
 	static bool			isHighlightItems() { return highlightItems; }
 
+	//! Keep the painted map in a backbuffer and only repaint the areas
+	//! where items changed. Needs ItemSorter::SetIncremental.
+	static void			SetDirtyRects(bool dirty) { dirtyRects = dirty; }
+	static bool			isDirtyRects() { return dirtyRects; }
+
 	static void ConCmd_toggleHighlightItems(const Console::ArgvType &argv);
 	static void ConCmd_dumpMap(const Console::ArgvType &argv);
 
@@ -90,7 +96,13 @@ protected:
 	uint32 dragging_flags;
 	sint32 dragging_pos[3];
 
+	RenderSurface *backbuffer;
+	bool backbuffer_valid;		//!< holds the map as painted last frame
+	uint32 backbuffer_palette;	//!< Palette::revision it was painted with
+	std::vector<Pentagram::Rect> dirty_rects;
+
 	static bool highlightItems;
+	static bool dirtyRects;
 
 };
 
@@ -69,18 +69,18 @@ void MiniMapGump::PaintThis(RenderSurface* surf, sint32 lerp_factor, bool scaled
 	surf->Fill32(0xFFFFAF00,1,MAP_NUM_CHUNKS*2+1,MAP_NUM_CHUNKS*2+1,1);
 	surf->Fill32(0xFFFFAF00,MAP_NUM_CHUNKS*2+1,1,1,MAP_NUM_CHUNKS*2+1);
 
-	for (int y = 0; y < MAP_NUM_CHUNKS; y++) for (int x = 0; x < MAP_NUM_CHUNKS; x++)
+	const CurrentMap::FastChunks& fast = currentmap->getFastChunks();
+	for (unsigned int index = 0; fast.findNext(index); ++index)
 	{
-		if (currentmap->isChunkFast(x,y)) {
-
-			for (int j = 0; j < MINMAPGUMP_SCALE; j++) for (int i = 0; i < MINMAPGUMP_SCALE; i++)
-			{
-				if (texbuffer[y*MINMAPGUMP_SCALE+j][x*MINMAPGUMP_SCALE+i] == 0)
-					texbuffer[y*MINMAPGUMP_SCALE+j][x*MINMAPGUMP_SCALE+i] = sampleAtPoint(
-						x*mapChunkSize + mapChunkSize/(MINMAPGUMP_SCALE*2) + (mapChunkSize*i)/MINMAPGUMP_SCALE, 
-						y*mapChunkSize + mapChunkSize/(MINMAPGUMP_SCALE*2) + (mapChunkSize*j)/MINMAPGUMP_SCALE,
-						currentmap);
-			}
+		int x = CurrentMap::FastChunks::getX(index);
+		int y = CurrentMap::FastChunks::getY(index);
+		for (int j = 0; j < MINMAPGUMP_SCALE; j++) for (int i = 0; i < MINMAPGUMP_SCALE; i++)
+		{
+			if (texbuffer[y*MINMAPGUMP_SCALE+j][x*MINMAPGUMP_SCALE+i] == 0)
+				texbuffer[y*MINMAPGUMP_SCALE+j][x*MINMAPGUMP_SCALE+i] = sampleAtPoint(
+					x*mapChunkSize + mapChunkSize/(MINMAPGUMP_SCALE*2) + (mapChunkSize*i)/MINMAPGUMP_SCALE, 
+					y*mapChunkSize + mapChunkSize/(MINMAPGUMP_SCALE*2) + (mapChunkSize*j)/MINMAPGUMP_SCALE,
+					currentmap);
 		}
 	}
 
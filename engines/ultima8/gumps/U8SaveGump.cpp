@@ -314,6 +314,9 @@ void U8SaveGump::loadDescriptions()
 {
 	descriptions.resize(6);
 
+	// don't read a savegame that is still being written
+	GUIApp::get_instance()->waitForBackgroundSave();
+
 	for (int i = 0; i < 6; ++i) {
 		int index = 6*page + i + 1;
 
@@ -38,6 +38,9 @@ public:
 
 	virtual size_t getCapacity() = 0;
 
+	//! get the memory taken by allocated blocks (in whole blocks)
+	virtual size_t getUsedMemory() = 0;
+
 	virtual void printInfo() = 0;
 };
 
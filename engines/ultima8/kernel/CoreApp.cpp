@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Args.h"
 #include "GameInfo.h"
 #include "GameDetector.h"
+#include "startup_profile.h"
 
 #include <sstream>
 
@@ -193,6 +194,8 @@ void CoreApp::setupVirtualPaths()
 // load configuration files
 void CoreApp::loadConfig()
 {
+	Startup_phase phase("config");
+
 	pout << "Loading configuration files:" << std::endl;
 
 	bool dataconf, homeconf;
@@ -18,6 +18,7 @@
 
 #include "pent_include.h"
 #include "DelayProcess.h"
+#include "Kernel.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
@@ -39,14 +40,32 @@ DelayProcess::~DelayProcess()
 
 void DelayProcess::run()
 {
-	if (--count == 0)
+	if (--count == 0) {
 		terminate();
+		return;
+	}
+
+	// Nothing happens until the last frame, so sleep until then.
+	// (Paused frames aren't counted by the kernel, so don't do this when
+	// we run while paused.)
+	if (count > 1 && !(flags & PROC_RUNPAUSED)) {
+		Kernel::get_instance()->sleepProcess(this, count);
+		count = 1;
+	}
+}
+
+int DelayProcess::getFramesLeft() const
+{
+	uint32 sleeping = Kernel::get_instance()->getSleepFrames(this);
+	if (sleeping > 0)
+		return count - 1 + static_cast<int>(sleeping);
+	return count;
 }
 
 void DelayProcess::dumpInfo()
 {
 	Process::dumpInfo();
-	pout << "Frames left: " << count << std::endl;
+	pout << "Frames left: " << getFramesLeft() << std::endl;
 }
 
 
@@ -62,5 +81,5 @@ bool DelayProcess::loadData(IDataSource* ids, uint32 version)
 void DelayProcess::saveData(ODataSource* ods)
 {
 	Process::saveData(ods);
-	ods->write4(static_cast<uint32>(count));
+	ods->write4(static_cast<uint32>(getFramesLeft()));
 }
@@ -40,6 +40,9 @@ public:
 protected:
 	virtual void saveData(ODataSource* ods);
 
+	//! number of frames until we terminate, including those slept through
+	int getFramesLeft() const;
+
 	int count;
 };
 
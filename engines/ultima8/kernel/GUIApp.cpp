@@ -48,8 +48,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "getObject.h"
 
 #include "SavegameWriter.h"
+#include "BackgroundSavegameWriter.h"
 #include "Savegame.h"
 #include <ctime>
+#include <cstdio>
 
 #include "Gump.h"
 #include "DesktopGump.h"
@@ -78,6 +80,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "remorseintrinsics.h"
 #include "Egg.h"
 #include "CurrentMap.h"
+#include "GlobEgg.h"
+#include "ItemSorter.h"
+#include "ShapeFrameCache.h"
+#include "MainShapeArchive.h"
+#include "Shape.h"
 #include "InverterProcess.h"
 #include "HealProcess.h"
 #include "SchedulerProcess.h"
@@ -109,6 +116,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ShapeViewerGump.h"
 
 #include "AudioMixer.h"
+#include "startup_profile.h"
+#include "profiler/Frame_profiler.h"
 
 #ifdef WIN32
 #include <windows.h>
@@ -139,7 +148,9 @@ using std::string;
 DEFINE_RUNTIME_CLASSTYPE_CODE(GUIApp,CoreApp);
 
 GUIApp::GUIApp(int argc, const char* const* argv)
-	: CoreApp(argc, argv), save_count(0), game(0), kernel(0), objectmanager(0),
+	: CoreApp(argc, argv), save_count(0), pendingSave(0),
+	  backgroundSave(false), headless(false), headlessFrames(0),
+	  headlessSeed(1), headlessStatsInterval(30), game(0), kernel(0), objectmanager(0),
 	  hidmanager(0), ucmachine(0), screen(0), fullscreen(false), palettemanager(0), 
 	  gamedata(0), world(0), desktopGump(0), consoleGump(0), gameMapGump(0),
 	  avatarMoverProcess(0), runSDLInit(false),
@@ -199,6 +210,11 @@ GUIApp::GUIApp(int argc, const char* const* argv)
 	con.AddConsoleCommand("Kernel::toggleFrameByFrame",
 						  Kernel::ConCmd_toggleFrameByFrame);
 	con.AddConsoleCommand("Kernel::advanceFrame", Kernel::ConCmd_advanceFrame);
+	con.AddConsoleCommand("Kernel::parallelThreads",
+						  Kernel::ConCmd_parallelThreads);
+	con.AddConsoleCommand("Kernel::profile", Kernel::ConCmd_profile);
+	con.AddConsoleCommand("Kernel::pathfindBudget",
+						  Kernel::ConCmd_pathfindBudget);
 	con.AddConsoleCommand("ObjectManager::objectTypes",
 						  ObjectManager::ConCmd_objectTypes);
 	con.AddConsoleCommand("ObjectManager::objectInfo",
@@ -237,6 +253,12 @@ GUIApp::GUIApp(int argc, const char* const* argv)
 	con.AddConsoleCommand("QuickAvatarMoverProcess::toggleClipping",
 						  QuickAvatarMoverProcess::ConCmd_toggleClipping);
 
+	con.AddConsoleCommand("CurrentMap::collisionCache",
+						  CurrentMap::ConCmd_collisionCache);
+	con.AddConsoleCommand("CurrentMap::loadStats",
+						  CurrentMap::ConCmd_loadStats);
+	con.AddConsoleCommand("GlobEgg::expandStats",
+						  GlobEgg::ConCmd_expandStats);
 	con.AddConsoleCommand("GameMapGump::toggleHighlightItems",
 						  GameMapGump::ConCmd_toggleHighlightItems);
 	con.AddConsoleCommand("GameMapGump::dumpMap",
@@ -286,6 +308,9 @@ GUIApp::~GUIApp()
 	con.RemoveConsoleCommand(Kernel::ConCmd_listProcesses);
 	con.RemoveConsoleCommand(Kernel::ConCmd_toggleFrameByFrame);
 	con.RemoveConsoleCommand(Kernel::ConCmd_advanceFrame);
+	con.RemoveConsoleCommand(Kernel::ConCmd_parallelThreads);
+	con.RemoveConsoleCommand(Kernel::ConCmd_profile);
+	con.RemoveConsoleCommand(Kernel::ConCmd_pathfindBudget);
 	con.RemoveConsoleCommand(ObjectManager::ConCmd_objectTypes);
 	con.RemoveConsoleCommand(ObjectManager::ConCmd_objectInfo);
 	con.RemoveConsoleCommand(MemoryManager::ConCmd_MemInfo);
@@ -306,6 +331,9 @@ GUIApp::~GUIApp()
 	con.RemoveConsoleCommand(QuickAvatarMoverProcess::ConCmd_toggleQuarterSpeed);
 	con.RemoveConsoleCommand(QuickAvatarMoverProcess::ConCmd_toggleClipping);
 
+	con.RemoveConsoleCommand(CurrentMap::ConCmd_collisionCache);
+	con.RemoveConsoleCommand(CurrentMap::ConCmd_loadStats);
+	con.RemoveConsoleCommand(GlobEgg::ConCmd_expandStats);
 	con.RemoveConsoleCommand(GameMapGump::ConCmd_toggleHighlightItems);
 	con.RemoveConsoleCommand(GameMapGump::ConCmd_dumpMap);
 	con.RemoveConsoleCommand(GameMapGump::ConCmd_incrementSortOrder);
@@ -341,15 +369,27 @@ void GUIApp::SDLInit()
 
 void GUIApp::startup()
 {
-	SDLInit();
-
 	// Set the console to auto paint, till we have finished initing
 	con.SetAutoPaint(conAutoPaint);
 
 	pout << "-- Initializing Pentagram -- " << std::endl;
 
 	// parent's startup first
-	CoreApp::startup();
+	{
+		Startup_phase phase("CoreApp::startup");
+		CoreApp::startup();
+	}
+
+	// the arguments are known now, so SDL can be set up for headless mode
+	if (headless) {
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+		SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+		frameLimit = false;
+	}
+	{
+		Startup_phase phase("SDL");
+		SDLInit();
+	}
 
 	bool dataoverride;
 	if (!settingman->get("dataoverride", dataoverride,
@@ -431,7 +471,10 @@ void GUIApp::startup()
 
 	objectmanager = new ObjectManager();
 
-	GraphicSysInit();
+	{
+		Startup_phase phase("graphics");
+		GraphicSysInit();
+	}
 
 	SDL_HideCursor();
 	SDL2_GetMouseState(&mouseX, &mouseY);
@@ -439,7 +482,17 @@ void GUIApp::startup()
 	hidmanager = new HIDManager();
 
 	// Audio Mixer
-	audiomixer = new Pentagram::AudioMixer(22050,true,8);
+	{
+		Startup_phase phase("audio");
+		audiomixer = new Pentagram::AudioMixer(22050,true,8);
+
+		// decoded copies of the sounds played most, in KB
+		int cachekb;
+		settingman->setDefault("decodedcache", 4096);
+		settingman->get("decodedcache", cachekb);
+		if (cachekb < 0) cachekb = 0;
+		audiomixer->setDecodedCacheLimit(cachekb * 1024);
+	}
 
 	pout << "-- Pentagram Initialized -- " << std::endl << std::endl;
 
@@ -454,12 +507,17 @@ void GUIApp::startup()
 	// Unset the console auto paint, since we have finished initing
 	con.SetAutoPaint(0);
 
+	reportStartupTimes();
+	startFrameTrace();
+
 //	pout << "Paint Initial display" << std::endl;
 	paint();
 }
 
 void GUIApp::startupGame()
 {
+	Startup_phase phase("game");
+
 	con.SetAutoPaint(conAutoPaint);
 
 	pout  << std::endl << "-- Initializing Game: " << gameinfo->name << " --" << std::endl;
@@ -530,20 +588,26 @@ void GUIApp::startupGame()
 
 	hidmanager->loadBindings();
 	
-	if (GAME_IS_U8) {
-		ucmachine = new UCMachine(U8Intrinsics, 256);
-	} else if (GAME_IS_REMORSE) {
-		ucmachine = new UCMachine(RemorseIntrinsics, 308);
-	} else {
-		CANT_HAPPEN_MSG("Invalid game type.");
+	{
+		Startup_phase ucphase("usecode");
+		if (GAME_IS_U8) {
+			ucmachine = new UCMachine(U8Intrinsics, 256);
+		} else if (GAME_IS_REMORSE) {
+			ucmachine = new UCMachine(RemorseIntrinsics, 308);
+		} else {
+			CANT_HAPPEN_MSG("Invalid game type.");
+		}
 	}
 
 	inBetweenFrame = 0;
 	lerpFactor = 256;
 
 	// Initialize world
-	world = new World();
-	world->initMaps();
+	{
+		Startup_phase worldphase("world");
+		world = new World();
+		world->initMaps();
+	}
 
 	game = Game::createGame(getGameInfo());
 
@@ -562,27 +626,109 @@ void GUIApp::startupGame()
 	settingman->setDefault("cheat", false);
 	settingman->get("cheat", cheats_enabled);
 
-	game->loadFiles();
-	gamedata->setupFontOverrides();
+	int parallelthreads;
+	settingman->setDefault("parallelthreads", 0);
+	settingman->get("parallelthreads", parallelthreads);
+	if (parallelthreads > 0)
+		kernel->setParallelThreads(parallelthreads);
+
+	settingman->setDefault("backgroundsave", false);
+	settingman->get("backgroundsave", backgroundSave);
+
+	// headless runs have to be reproducible, so no time budget there
+	int fastareabudget;
+	settingman->setDefault("fastareabudget", 2000);
+	settingman->get("fastareabudget", fastareabudget);
+	if (headless || fastareabudget < 0) fastareabudget = 0;
+	CurrentMap::setFastAreaBudget(static_cast<uint32>(fastareabudget));
+
+	bool incrementalsort;
+	settingman->setDefault("incrementalsort", false);
+	settingman->get("incrementalsort", incrementalsort);
+	ItemSorter::SetIncremental(incrementalsort);
+
+	// repaint only the changed parts of the map (needs incrementalsort)
+	bool dirtyrects;
+	settingman->setDefault("dirtyrects", false);
+	settingman->get("dirtyrects", dirtyrects);
+	GameMapGump::SetDirtyRects(dirtyrects);
+
+	// threads painting the map, each a band of the screen
+	int paintthreads;
+	settingman->setDefault("paintthreads", 0);
+	settingman->get("paintthreads", paintthreads);
+	if (headless || paintthreads < 0) paintthreads = 0;
+	ItemSorter::SetPaintThreads(static_cast<unsigned int>(paintthreads));
+
+	// memory for decoded shape frames, in kilobytes. 0 disables the cache
+	int shapecache;
+	settingman->setDefault("shapecache", 16384);
+	settingman->get("shapecache", shapecache);
+	if (shapecache < 0) shapecache = 0;
+	ShapeFrameCache::setBudget(static_cast<uint32>(shapecache) * 1024);
+
+	{
+		Startup_phase filesphase("game files");
+		game->loadFiles();
+		gamedata->setupFontOverrides();
+	}
+
+	// memory for parsed frames of the main shapes, in kilobytes.
+	// 0 is unlimited
+	int shapememory;
+	settingman->setDefault("shapememory", 0);
+	settingman->get("shapememory", shapememory);
+	if (shapememory < 0) shapememory = 0;
+	gamedata->getMainShapes()->setFrameBudget(
+		static_cast<uint32>(shapememory) * 1024);
 
 	// Unset the console auto paint (can't have it from here on)
 	con.SetAutoPaint(0);
 
 	// Create Midi Driver for Ultima 8
-	if (getGameInfo()->type == GameInfo::GAME_U8) 
+	if (getGameInfo()->type == GameInfo::GAME_U8) {
+		Startup_phase midiphase("MIDI");
 		audiomixer->openMidiOutput();
+	}
 
 	std::string savegame;
 	settingman->setDefault("lastSave", "");
 	settingman->get("lastSave", savegame);
 
-	newGame(savegame);
+	if (headless) {
+		if (!headlessLoad.empty()) savegame = headlessLoad;
+		std::srand(headlessSeed);
+		pout << "Headless: seed " << headlessSeed << ", savegame \""
+			 << savegame << "\"" << std::endl;
+	}
+
+	{
+		Startup_phase mapphase("map");
+		newGame(savegame);
+	}
 
 	consoleGump->HideConsole();
 
 	pout << "-- Game Initialized --" << std::endl << std::endl;
 }
 
+void GUIApp::reportStartupTimes()
+{
+	Startup_profile& profile = Startup_profile::get();
+	if (profile.empty()) return;
+	profile.report(pout);
+
+	// a Chrome trace of the same, if one was asked for
+	std::string trace;
+	settingman->setDefault("startuptrace", "");
+	settingman->get("startuptrace", trace);
+	if (!trace.empty() && !profile.write_trace(trace))
+		perr << "Couldn't write startup trace \"" << trace << "\""
+			 << std::endl;
+
+	profile.clear();
+}
+
 void GUIApp::startupPentagramMenu()
 {
 	con.SetAutoPaint(conAutoPaint);
@@ -605,8 +751,22 @@ void GUIApp::startupPentagramMenu()
 	menugump->InitGump(0, true);
 }
 
+void GUIApp::startFrameTrace()
+{
+	Frame_profiler& profiler = Frame_profiler::get();
+
+	std::string trace;
+	settingman->setDefault("frametrace", "");
+	settingman->get("frametrace", trace);
+	if (!trace.empty() && !profiler.start(trace))
+		perr << "Frame traces need Pentagram configured with "
+			 << "--enable-frame-trace" << std::endl;
+}
+
 void GUIApp::shutdown()
 {
+	if (!Frame_profiler::get().finish())
+		perr << "Couldn't write frame trace" << std::endl;
 	shutdownGame(false);
 }
 
@@ -614,6 +774,8 @@ void GUIApp::shutdownGame(bool reloading)
 {
 	pout << "-- Shutting down Game -- " << std::endl;
 
+	waitForBackgroundSave();
+
 	// Save config here....
 
 	SDL_WM_SetCaption("Pentagram", "");
@@ -635,6 +797,7 @@ void GUIApp::shutdownGame(bool reloading)
 	kernel->reset();
 	palettemanager->reset();
 	fontmanager->resetGameFonts();
+	ItemSorter::SetPaintThreads(0);
 
 	FORGET_OBJECT(game);
 	FORGET_OBJECT(gamedata);
@@ -751,11 +914,95 @@ void GUIApp::DeclareArgs()
 	// parent's arguments first
 	CoreApp::DeclareArgs();
 
-	// anything else?
+	parameters.declare("--headless", &headless, true);
+	parameters.declare("--frames", &headlessFrames, 0);
+	parameters.declare("--seed", &headlessSeed, 1);
+	parameters.declare("--load", &headlessLoad, "");
+	parameters.declare("--stats", &headlessStats, "");
+	parameters.declare("--statsinterval", &headlessStatsInterval, 30);
+}
+
+void GUIApp::helpMe()
+{
+	CoreApp::helpMe();
+
+	con.Print("\t--headless\t- simulate as fast as possible without painting\n");
+	con.Print("\t--frames {n}\t- stop the headless simulation after n frames\n");
+	con.Print("\t--seed {n}\t- seed the random number generator (headless)\n");
+	con.Print("\t--load {file}\t- start from a savegame (headless)\n");
+	con.Print("\t--stats {file}\t- write process/memory stats as CSV (headless)\n");
+	con.Print("\t--statsinterval {n}\t- frames between stats lines (default 30)\n");
+}
+
+void GUIApp::runHeadless()
+{
+	isRunning = true;
+
+	ODataSource* stats = 0;
+	if (!headlessStats.empty()) {
+		stats = filesystem->WriteFile(headlessStats, true);
+		if (stats) {
+			const char* header = "frame,elapsed_ms,processes,objects,"
+				"pooled_memory\n";
+			stats->write(header, static_cast<uint32>(std::strlen(header)));
+		} else {
+			perr << "Headless: unable to open " << headlessStats << std::endl;
+		}
+	}
+	if (headlessStatsInterval == 0) headlessStatsInterval = 1;
+
+	uint32 frames = 0;
+	uint32 starttime = SDL_GetTicks();
+
+	SDL_Event event;
+	while (isRunning && (headlessFrames == 0 || frames < headlessFrames)) {
+		kernel->runProcesses();
+		desktopGump->run();
+		frames++;
+
+		// only watch for quit requests, there is no input to handle
+		while (SDL_PollEvent(&event)) {
+			if (event.type == SDL_QUIT) isRunning = false;
+		}
+
+		if (stats && frames % headlessStatsInterval == 0)
+			writeHeadlessStats(stats, frames, SDL_GetTicks() - starttime);
+		PROFILE_FRAME();
+	}
+
+	uint32 elapsed = SDL_GetTicks() - starttime;
+	pout << "Headless: " << frames << " frames in " << elapsed << " ms";
+	if (elapsed > 0)
+		pout << " (" << (frames * 1000.0) / elapsed << " frames/s)";
+	pout << std::endl;
+
+	delete stats;
+	isRunning = false;
+}
+
+void GUIApp::writeHeadlessStats(ODataSource* ods, uint32 frames,
+								uint32 elapsed)
+{
+	MemoryManager* mm = MemoryManager::get_instance();
+
+	char buf[128];
+	int len = std::snprintf(buf, sizeof(buf), "%u,%u,%u,%u,%lu\n",
+							frames, elapsed,
+							kernel->getNumProcesses(0, 6),
+							objectmanager->getObjectCount(),
+							static_cast<unsigned long>(
+								mm ? mm->getUsedMemory() : 0));
+	if (len > 0)
+		ods->write(buf, static_cast<uint32>(len));
 }
 
 void GUIApp::run()
 {
+	if (headless) {
+		runHeadless();
+		return;
+	}
+
 	isRunning = true;
 
 	sint32 next_ticks = SDL_GetTicks()*3;	// Next time is right now!
@@ -806,12 +1053,21 @@ void GUIApp::run()
 
 		// get & handle all events in queue
 		while (isRunning && SDL_PollEvent(&event)) {
+			RenderSurface::ConvertEventCoords(event);
 			handleEvent(event);
 		}
 		handleDelayedEvents();
 
+		checkBackgroundSave(false);
+
 		// Paint Screen
 		paint();
+		PROFILE_FRAME();
+
+		// Drop the frames of shapes that haven't been painted in a while
+		if (gamedata && gamedata->getMainShapes())
+			gamedata->getMainShapes()->trimFrames();
+		Shape::advanceUseClock();
 
 		if (!change_gamename.empty()) {
 			pout << "Changing Game to: " << change_gamename << std::endl;
@@ -1021,6 +1277,9 @@ void GUIApp::paint()
 	if(!screen) // need to worry if the graphics system has been started. Need nicer way.
 		return;
 
+	if (headless)
+		return;
+
     if (prev != 0)
         tdiff += now - prev;
     prev = now;
@@ -1095,6 +1354,7 @@ void GUIApp::paint()
 
 	// End painting
 	screen->EndPainting();
+	RenderSurface::UpdateWindowSurface();
 
 	painting = false;
 }
@@ -1316,6 +1576,20 @@ void GUIApp::GraphicSysInit()
 	settingman->get("height", height);
 	settingman->get("bpp", bpp);
 
+	// present through the GPU, which scales the screen to the window
+	bool accelerated, smoothscale;
+	int windowscale;
+	settingman->setDefault("accelerated", false);
+	settingman->setDefault("windowscale", 1);
+	settingman->setDefault("smoothscale", false);
+	settingman->get("accelerated", accelerated);
+	settingman->get("windowscale", windowscale);
+	settingman->get("smoothscale", smoothscale);
+	if (windowscale < 1) windowscale = 1;
+	RenderSurface::SetAcceleration(accelerated,
+								   static_cast<uint32>(windowscale),
+								   smoothscale);
+
 #ifdef UNDER_CE
 	width = 240;
 	height = 320;
@@ -2033,12 +2307,23 @@ bool GUIApp::saveGame(std::string filename, std::string desc,
 	Gump * gump = getGump(mouseOverGump);
 	if (gump) gump->OnMouseLeft();
 
+	// Only one savegame can be written at a time
+	waitForBackgroundSave();
+
 	ODataSource* ods = filesystem->WriteFile(filename);
 	if (!ods) return false;
 
 	save_count++;
 
-	SavegameWriter* sgw = new SavegameWriter(ods);
+	// In the background mode every section is serialized to memory right
+	// here, between two frames, and only the compression and the disk I/O
+	// are moved to a separate thread.
+	BackgroundSavegameWriter* bsgw = 0;
+	SavegameWriter* sgw;
+	if (backgroundSave)
+		sgw = bsgw = new BackgroundSavegameWriter(ods);
+	else
+		sgw = new SavegameWriter(ods);
 	sgw->writeVersion(Pentagram::savegame_version);
 	sgw->writeDescription(desc);
 
@@ -2089,9 +2374,13 @@ bool GUIApp::saveGame(std::string filename, std::string desc,
 	sgw->writeFile("APP", &buf);
 	buf.clear();
 
-	sgw->finish();
-
-	delete sgw;
+	if (bsgw) {
+		bsgw->start();
+		pendingSave = bsgw;
+	} else {
+		sgw->finish();
+		delete sgw;
+	}
 
 	// Restore mouse over
 	if (gump) gump->OnMouseOver();
@@ -2228,10 +2517,31 @@ bool GUIApp::newGame(const std::string &savegame)
 	return true;
 }
 
+void GUIApp::checkBackgroundSave(bool wait)
+{
+	if (!pendingSave) return;
+	if (!wait && !pendingSave->isDone()) return;
+
+	if (!pendingSave->wait())
+		perr << "Error writing savegame in the background" << std::endl;
+	else
+		pout << "Savegame written" << std::endl;
+
+	delete pendingSave;
+	pendingSave = 0;
+}
+
+void GUIApp::waitForBackgroundSave()
+{
+	checkBackgroundSave(true);
+}
+
 bool GUIApp::loadGame(std::string filename)
 {
 	con.Print(MM_INFO, "Loading...\n");
 
+	waitForBackgroundSave();
+
 	IDataSource* ids = filesystem->ReadFile(filename);
 	if (!ids) {
 		Error("Can't load file", "Error Loading savegame " + filename);
@@ -2558,6 +2868,10 @@ void GUIApp::ConCmd_engineStats(const Console::ArgvType &argv)
 	ObjectManager::get_instance()->objectStats();
 	UCMachine::get_instance()->usecodeStats();
 	World::get_instance()->worldStats();
+	if (PaletteManager::get_instance())
+		PaletteManager::get_instance()->paletteStats();
+	if (Pentagram::AudioMixer::get_instance())
+		Pentagram::AudioMixer::get_instance()->audioStats();
 }
 
 void GUIApp::ConCmd_changeGame(const Console::ArgvType &argv)
@@ -50,6 +50,7 @@ class HIDManager;
 class AvatarMoverProcess;
 class IDataSource;
 class ODataSource;
+class BackgroundSavegameWriter;
 struct Texture;
 
 namespace Pentagram {
@@ -80,6 +81,13 @@ public:
 
 	void startupGame();
 	void startupPentagramMenu();
+
+	//! log the times of the startup phases, and write them as a trace
+	//! if the startuptrace setting names a file
+	void reportStartupTimes();
+	//! record the frames from here on if the frametrace setting names
+	//! a file; shutdown() writes them out
+	void startFrameTrace();
 	void shutdownGame(bool reloading=true);
 	void changeGame(Pentagram::istring newgame);
 	
@@ -95,6 +103,11 @@ public:
 	
 	virtual void paint();
 	virtual bool isPainting() { return painting; }
+
+	//! Are we simulating without painting or frame limiting (--headless)?
+	//! Everything that would depend on wall clock time should be
+	//! deterministic in headless mode.
+	bool isHeadless() const { return headless; }
 	
 	
 	INTRINSIC(I_getCurrentTimerTick);
@@ -193,12 +206,37 @@ public:
 	//! \param exit_to_menu If true, then exit to the Pentagram menu then display the message
 	void Error(std::string message, std::string title=std::string(), bool exit_to_menu=false);
 
+	virtual void helpMe();
+
+	//! wait until a savegame being written in the background is finished
+	void waitForBackgroundSave();
+
 protected:
 	virtual void DeclareArgs();
 
 private:
 	uint32 save_count;
 
+	//! savegame still being written in the background, or 0
+	BackgroundSavegameWriter* pendingSave;
+	bool backgroundSave;
+
+	//! clean up pendingSave once it's finished
+	void checkBackgroundSave(bool wait);
+
+	//! run the headless simulation (--headless)
+	void runHeadless();
+	//! append a line of process and memory stats to the headless stats file
+	void writeHeadlessStats(ODataSource* ods, uint32 frames, uint32 elapsed);
+
+	// headless mode (see DeclareArgs)
+	bool headless;
+	uint32 headlessFrames;		//!< frames to run, 0 = until quit
+	uint32 headlessSeed;		//!< RNG seed
+	std::string headlessLoad;	//!< savegame to start from
+	std::string headlessStats;	//!< CSV file for the stats
+	uint32 headlessStatsInterval; //!< frames between two lines of stats
+
 	//! write savegame info (time, ..., game-specifics)
 	void writeSaveInfo(ODataSource* ods);
 
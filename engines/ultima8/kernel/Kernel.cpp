@@ -20,29 +20,40 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "Kernel.h"
 #include "Process.h"
+#include "WorkerPool.h"
+#include "jobs/Job_system.h"
+#include "profiler/Frame_profiler.h"
 #include "idMan.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
 
+#include <algorithm>
 #include <map>
 
-typedef std::list<Process *>::iterator ProcessIterator;
+//! maximum number of processes in one batched job of the parallel phase
+static const unsigned int PARALLEL_BATCH_SIZE = 16;
+
+//! default number of pathfinder nodes expanded per frame
+static const unsigned int PATHFIND_BUDGET = 240;
+
+typedef std::vector<Process *>::iterator ProcessIterator;
 
 Kernel* Kernel::kernel = 0;
 
-Kernel::Kernel() : loading(false)
+Kernel::Kernel() : parkedcount(0), workers(0), loading(false)
 {
 	con.Print(MM_INFO, "Creating Kernel...\n");
 
 	assert(kernel == 0);
 	kernel = this;
 	pIDs = new idMan(1,32766,128);
-	current_process = processes.end();
 	framenum = 0;
 	paused = 0;
 	runningprocess = 0;
 	framebyframe = false;
+	pathfindbudget = PATHFIND_BUDGET;
+	pathfindnodesleft = pathfindbudget;
 }
 
 Kernel::~Kernel()
@@ -52,6 +63,7 @@ Kernel::~Kernel()
 
 	kernel = 0;
 
+	delete workers;
 	delete pIDs;
 }
 
@@ -59,11 +71,17 @@ void Kernel::reset()
 {
 	con.Print(MM_INFO, "Resetting Kernel...\n");
 
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it) {
+	std::vector<Process*> procs;
+	getAllProcesses(procs);
+	for (ProcessIterator it = procs.begin(); it != procs.end(); ++it) {
 		delete (*it);
 	}
 	processes.clear();
-	current_process = processes.begin();
+	for (unsigned int i = 0; i < PARK_BUCKETS; ++i)
+		parked[i].clear();
+	parkedcount = 0;
+	pidtable.clear();
+	objprocesses.clear();
 
 	pIDs->clearAll();
 
@@ -123,13 +141,22 @@ ProcId Kernel::addProcessExec(Process* proc)
 		 << ", pid = " << proc->pid << std::endl;
 #endif
 
-	processes.push_back(proc);
+	processes.pushBack(proc);
 	proc->flags |= Process::PROC_ACTIVE;
+	indexProcess(proc);
+
+	// nested runs are already counted in the time of the running process
+	Uint64 starttime = runningprocess ? 0 : profiler.beginRun();
 
 	Process* oldrunning = runningprocess; runningprocess = proc;
 	proc->run( );
 	runningprocess = oldrunning;
 
+	if (starttime) profiler.endRun(proc, starttime);
+
+	if (proc->indexeditem != proc->item_num)
+		reindexProcess(proc);
+
 	return proc->pid;
 }
 
@@ -139,30 +166,38 @@ void Kernel::removeProcess(Process* proc)
 	//! we probably want to flag them as terminated before actually
 	//! removing/deleting it or something
 	//! also have to look out for deleting processes while iterating
-	//! over the list. (Hence the special 'erase' in runProcs below, which
-	//! is very std::list-specific, incidentally)
+	//! over the list. (Hence the eraseCurrent in runProcs below)
 
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it) {
-		if (*it == proc) {
-			proc->flags &= ~Process::PROC_ACTIVE;
-			
-			perr << "[Kernel] Removing process " << proc << std::endl;
+	if (proc->flags & Process::PROC_ACTIVE) {
+		proc->flags &= ~Process::PROC_ACTIVE;
 
-			processes.erase(it);
+		perr << "[Kernel] Removing process " << proc << std::endl;
 
-			// Clear pid
-			pIDs->clearID(proc->pid);
+		if (proc->parkbucket >= 0)
+			unparkProcess(proc);
+		else
+			processes.remove(proc);
+		unindexProcess(proc);
 
-			return;
-		}
+		// Clear pid
+		pIDs->clearID(proc->pid);
 	}
 }
 
 
 void Kernel::runProcesses()
 {
-	if (!paused)
+	PROFILE_ZONE("Kernel::runProcesses");
+	PROFILE_COUNTER("processes", processes.size());
+
+	if (!paused) {
 		framenum++;
+		pathfindnodesleft = pathfindbudget;
+		wakeSleepers();
+
+		if (workers && !runParallelPhase())
+			return; // the list was reset, so leave now
+	}
 
 	if (processes.size() == 0) {
 		return;
@@ -171,9 +206,8 @@ void Kernel::runProcesses()
 		//! do this in a cleaner way
 		exit(0);
 	}
-	current_process = processes.begin();
-	while (current_process != processes.end()) {
-		Process* p = *current_process;
+	Process* p = processes.beginFrame();
+	while (p) {
 
 		if (!paused && ((p->flags & (Process::PROC_TERMINATED |
 									 Process::PROC_TERM_DEFERRED))
@@ -182,80 +216,337 @@ void Kernel::runProcesses()
 			p->terminate();
 		}
 		if (!(p->is_terminated() || p->is_suspended()) &&
+			p->wakeframe <= framenum && p->committedframe != framenum &&
 			(!paused || (p->flags & Process::PROC_RUNPAUSED)))
 		{
+			p->wakeframe = 0;
 			runningprocess = p;
+			Uint64 starttime = profiler.beginRun();
 			p->run();
 
 			if (!runningprocess)
 				return; // If this happens then the list was reset so leave NOW!
 
 			runningprocess = 0;
+			if (starttime) profiler.endRun(p, starttime);
+
+			// processes may change their own item while running
+			if (p->indexeditem != p->item_num)
+				reindexProcess(p);
 		}
 		if (!paused && (p->flags & Process::PROC_TERMINATED)) {
 			// process is killed, so remove it from the list
-			current_process = processes.erase(current_process);
+			Process* next = processes.eraseCurrent();
+			unindexProcess(p);
 				
 			// Clear pid
 			pIDs->clearID(p->pid);
 				
 			//! is this the right place to delete processes?
 			delete p;
+
+			p = next;
+		}
+		else if (!p->is_terminated() &&
+				 (p->is_suspended() || p->wakeframe > framenum))
+		{
+			// nothing to do until woken up, so take it off the run-list
+			Process* next = processes.eraseCurrent();
+			parkProcess(p);
+
+			p = next;
 		}
 		else
-			++current_process;
+			p = processes.advance();
 	}
 
+	if (!paused) profiler.endFrame(framenum);
+
 	if (!paused && framebyframe) pause();
 }
 
+static bool ProcessPidLess(const Process* a, const Process* b)
+{
+	return a->getPid() < b->getPid();
+}
+
+void Kernel::parallelJob(void* data, unsigned int index)
+{
+	Kernel* kernel = static_cast<Kernel*>(data);
+	const ParallelJob& job = kernel->paralleljobs[index];
+	if (job.func)
+		job.func(&kernel->parallelbatched[job.first], job.count);
+	else
+		kernel->parallelprocs[job.first]->runParallel();
+}
+
+bool Kernel::runParallelPhase()
+{
+	parallelprocs.clear();
+	processes.getProcesses(parallelprocs);
+
+	ProcessIterator it;
+	ProcessIterator end = parallelprocs.begin();
+	for (it = parallelprocs.begin(); it != parallelprocs.end(); ++it) {
+		Process* p = *it;
+		if (!(p->is_terminated() || p->is_suspended()) &&
+			p->wakeframe <= framenum && p->hasParallelPhase())
+			*end++ = p;
+	}
+	parallelprocs.erase(end, parallelprocs.end());
+	if (parallelprocs.empty()) return true;
+
+	// Commit in pid order, so the result doesn't depend on the run-list
+	// order or on the way the jobs were spread over the threads.
+	std::sort(parallelprocs.begin(), parallelprocs.end(), ProcessPidLess);
+
+	// Processes with a batch function are grouped (in pid order) into
+	// jobs of up to PARALLEL_BATCH_SIZE processes. The rest get a job each.
+	paralleljobs.clear();
+	parallelbatched.clear();
+	std::vector<Process::ParallelBatchFunc> batchfuncs;
+	unsigned int i;
+	for (i = 0; i < parallelprocs.size(); ++i) {
+		Process::ParallelBatchFunc func = parallelprocs[i]->getParallelBatch();
+		if (!func) {
+			ParallelJob job = { 0, i, 1 };
+			paralleljobs.push_back(job);
+		} else if (std::find(batchfuncs.begin(), batchfuncs.end(), func)
+				   == batchfuncs.end()) {
+			batchfuncs.push_back(func);
+		}
+	}
+	std::vector<Process::ParallelBatchFunc>::iterator fit;
+	for (fit = batchfuncs.begin(); fit != batchfuncs.end(); ++fit) {
+		unsigned int first = static_cast<unsigned int>(parallelbatched.size());
+		for (it = parallelprocs.begin(); it != parallelprocs.end(); ++it)
+			if ((*it)->getParallelBatch() == *fit)
+				parallelbatched.push_back(*it);
+
+		unsigned int last = static_cast<unsigned int>(parallelbatched.size());
+		for (i = first; i < last; i += PARALLEL_BATCH_SIZE) {
+			unsigned int n = last - i;
+			if (n > PARALLEL_BATCH_SIZE) n = PARALLEL_BATCH_SIZE;
+			ParallelJob job = { *fit, i, n };
+			paralleljobs.push_back(job);
+		}
+	}
+
+	workers->run(parallelJob, this,
+				 static_cast<unsigned int>(paralleljobs.size()));
+
+	for (it = parallelprocs.begin(); it != parallelprocs.end(); ++it) {
+		Process* p = *it;
+
+		// an earlier process may have killed or suspended this one
+		if (p->is_terminated() || p->is_suspended() ||
+			!(p->flags & Process::PROC_ACTIVE))
+			continue;
+
+		p->wakeframe = 0;
+		p->committedframe = framenum;
+		runningprocess = p;
+		Uint64 starttime = profiler.beginRun();
+		p->run();
+
+		if (!runningprocess) {
+			// the list was reset
+			parallelprocs.clear();
+			parallelbatched.clear();
+			return false;
+		}
+
+		runningprocess = 0;
+		if (starttime) profiler.endRun(p, starttime);
+
+		if (p->indexeditem != p->item_num)
+			reindexProcess(p);
+	}
+
+	// the regular walk takes care of terminated and sleeping processes
+	parallelprocs.clear();
+	parallelbatched.clear();
+	return true;
+}
+
+void Kernel::setParallelThreads(unsigned int threads)
+{
+	if (threads == getParallelThreads()) return;
+
+	delete workers;
+	workers = 0;
+
+	// the main thread takes part in every batch as well
+	if (threads > 0)
+		workers = new WorkerPool(threads - 1);
+}
+
+unsigned int Kernel::getParallelThreads() const
+{
+	return workers ? workers->getThreadCount() + 1 : 0;
+}
+
 void Kernel::setNextProcess(Process* proc)
 {
-	if (current_process != processes.end() && *current_process == proc) return;
+	if (processes.isCurrent(proc)) return;
 
 	if (proc->flags & Process::PROC_ACTIVE) {
-		for (ProcessIterator it = processes.begin();
-			 it != processes.end(); ++it) {
-			if (*it == proc) {
-				processes.erase(it);
-				break;
-			}
-		}
+		if (proc->parkbucket >= 0)
+			unparkProcess(proc);
+		else
+			processes.remove(proc);
 	} else {
 		proc->flags |= Process::PROC_ACTIVE;
+		indexProcess(proc);
 	}
 
-	if (current_process == processes.end()) {
-		processes.push_front(proc);
-	} else {
-		ProcessIterator t = current_process;
-		++t;
+	processes.insertNext(proc);
+}
+
+Process* Kernel::getProcess(ProcId pid)
+{
+	if (pid < pidtable.size())
+		return pidtable[pid];
+	return 0;
+}
+
+void Kernel::indexProcess(Process* proc)
+{
+	if (proc->pid >= pidtable.size())
+		pidtable.resize(proc->pid + 1, 0);
+	pidtable[proc->pid] = proc;
+
+	ObjId objid = proc->item_num;
+	if (objid >= objprocesses.size())
+		objprocesses.resize(objid + 1, 0);
+
+	proc->indexeditem = objid;
+	proc->prevobjproc = 0;
+	proc->nextobjproc = objprocesses[objid];
+	if (proc->nextobjproc)
+		proc->nextobjproc->prevobjproc = proc;
+	objprocesses[objid] = proc;
+}
 
-		processes.insert(t, proc);
+void Kernel::unindexProcess(Process* proc)
+{
+	if (proc->pid < pidtable.size() && pidtable[proc->pid] == proc)
+		pidtable[proc->pid] = 0;
+
+	if (proc->prevobjproc)
+		proc->prevobjproc->nextobjproc = proc->nextobjproc;
+	else if (proc->indexeditem < objprocesses.size() &&
+			 objprocesses[proc->indexeditem] == proc)
+		objprocesses[proc->indexeditem] = proc->nextobjproc;
+	if (proc->nextobjproc)
+		proc->nextobjproc->prevobjproc = proc->prevobjproc;
+
+	proc->nextobjproc = proc->prevobjproc = 0;
+}
+
+void Kernel::reindexProcess(Process* proc)
+{
+	if (!(proc->flags & Process::PROC_ACTIVE)) return;
+
+	unindexProcess(proc);
+	indexProcess(proc);
+}
+
+void Kernel::sleepProcess(Process* proc, uint32 frames)
+{
+	assert(proc == runningprocess);
+
+	// the process is parked once it returns from run()
+	if (frames > 0)
+		proc->wakeframe = framenum + frames;
+}
+
+uint32 Kernel::getSleepFrames(const Process* proc) const
+{
+	if (proc->wakeframe > framenum)
+		return proc->wakeframe - framenum;
+	return 0;
+}
+
+void Kernel::parkProcess(Process* proc)
+{
+	sint32 bucket = PARK_WAITING;
+	if (!proc->is_suspended()) {
+		uint32 delta = proc->wakeframe - framenum;
+		if (delta < 256)
+			bucket = PARK_WHEEL0 + (proc->wakeframe & 0xFF);
+		else
+			bucket = PARK_WHEEL1 + ((proc->wakeframe >> 8) & 0xFF);
 	}
+
+	proc->parkbucket = bucket;
+	proc->parkslot = static_cast<uint32>(parked[bucket].size());
+	parked[bucket].push_back(proc);
+	parkedcount++;
 }
 
-Process* Kernel::getProcess(ProcId pid)
+void Kernel::unparkProcess(Process* proc)
 {
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it) {
+	std::vector<Process*>& bucket = parked[proc->parkbucket];
+
+	// move the last process of the bucket into the hole
+	Process* last = bucket.back();
+	bucket[proc->parkslot] = last;
+	last->parkslot = proc->parkslot;
+	bucket.pop_back();
+
+	proc->parkbucket = -1;
+	parkedcount--;
+}
+
+void Kernel::wakeSleepers()
+{
+	std::vector<Process*> procs;
+
+	if ((framenum & 0xFF) == 0) {
+		// a new block of 256 frames: spread its bucket over the first level
+		procs.swap(parked[PARK_WHEEL1 + ((framenum >> 8) & 0xFF)]);
+		parkedcount -= static_cast<unsigned int>(procs.size());
+		for (ProcessIterator it = procs.begin(); it != procs.end(); ++it)
+			parkProcess(*it);
+		procs.clear();
+	}
+
+	procs.swap(parked[PARK_WHEEL0 + (framenum & 0xFF)]);
+	parkedcount -= static_cast<unsigned int>(procs.size());
+
+	// insertNext pushes to the front, so go backwards to keep their order
+	std::vector<Process*>::reverse_iterator it;
+	for (it = procs.rbegin(); it != procs.rend(); ++it) {
 		Process* p = *it;
-		if (p->pid == pid)
-			return p;
+		p->parkbucket = -1;
+		p->wakeframe = 0;
+		processes.insertNext(p);
 	}
-	return 0;
+}
+
+void Kernel::getAllProcesses(std::vector<Process*>& procs) const
+{
+	processes.getProcesses(procs);
+	for (unsigned int i = 0; i < PARK_BUCKETS; ++i)
+		procs.insert(procs.end(), parked[i].begin(), parked[i].end());
 }
 
 void Kernel::kernelStats()
 {
 	pout << "Kernel memory stats:" << std::endl;
-	pout << "Processes  : " << processes.size() << "/32765" << std::endl;
+	pout << "Processes  : " << processes.size() + parkedcount
+		 << "/32765" << std::endl;
+	pout << "Parked     : " << parkedcount << std::endl;
 }
 
 void Kernel::processTypes()
 {
 	pout << "Current process types:" << std::endl;
 	std::map<std::string, unsigned int> processtypes;
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it) {
+	std::vector<Process*> procs;
+	getAllProcesses(procs);
+	for (ProcessIterator it = procs.begin(); it != procs.end(); ++it) {
 		Process* p = *it;
 		processtypes[p->GetClassType().class_name]++;
 	}
@@ -285,8 +576,9 @@ void Kernel::ConCmd_listProcesses(const Console::ArgvType &argv)
 	} else {
 		pout << "Processes:" << std::endl;
 	}
-	for (ProcessIterator it = kernel->processes.begin();
-		 it != kernel->processes.end(); ++it)
+	std::vector<Process*> procs;
+	kernel->getAllProcesses(procs);
+	for (ProcessIterator it = procs.begin(); it != procs.end(); ++it)
 	{
 		Process* p = *it;
 		if (argv.size() == 1 || p->item_num == item)
@@ -335,19 +627,115 @@ void Kernel::ConCmd_advanceFrame(const Console::ArgvType& argv)
 	}
 }
 
+void Kernel::ConCmd_profile(const Console::ArgvType& argv)
+{
+	ProcessProfiler& profiler = Kernel::get_instance()->getProfiler();
+
+	if (argv.size() == 1) {
+		profiler.print(10);
+		return;
+	}
+
+	const std::string& cmd = argv[1];
+	if (cmd == "start") {
+		profiler.start();
+		Job_system::get().set_profiling(true);
+		pout << "Process profiler started" << std::endl;
+	} else if (cmd == "stop") {
+		profiler.stop();
+		Job_system::get().set_profiling(false);
+		pout << "Process profiler stopped" << std::endl;
+	} else if (cmd == "reset") {
+		profiler.reset();
+		Job_system::get().reset_stats();
+	} else if (cmd == "csv" && argv.size() >= 3) {
+		uint32 frames = static_cast<uint32>(strtol(argv[2].c_str(), 0, 0));
+		std::string filename = "@home/profile.csv";
+		if (argv.size() >= 4) filename = argv[3];
+
+		if (!profiler.setCSVDump(frames, filename))
+			pout << "Unable to open " << filename << std::endl;
+		else if (frames)
+			pout << "Dumping profile every " << frames << " frames to "
+				 << filename << " (overwritten)" << std::endl;
+	} else if (cmd == "top" && argv.size() >= 3) {
+		profiler.print(static_cast<unsigned int>(strtol(argv[2].c_str(),
+														0, 0)));
+	} else if (cmd == "jobs") {
+		Job_system::get().report(pout);
+	} else {
+		pout << "usage: profile [start|stop|reset|top <n>|jobs|"
+			 << "csv <frames> [<file to overwrite>]]" << std::endl;
+	}
+}
+
+void Kernel::ConCmd_parallelThreads(const Console::ArgvType& argv)
+{
+	Kernel* kernel = Kernel::get_instance();
+	if (argv.size() > 1) {
+		long threads = strtol(argv[1].c_str(), 0, 0);
+		kernel->setParallelThreads(threads > 0 ?
+								   static_cast<unsigned int>(threads) : 0);
+	}
+
+	pout << "Kernel: parallel threads: " << kernel->getParallelThreads()
+		 << std::endl;
+}
+
+unsigned int Kernel::takePathfindNodes(unsigned int wanted)
+{
+	if (pathfindbudget == 0)
+		return wanted;
+
+	if (wanted > pathfindnodesleft)
+		wanted = pathfindnodesleft;
+	pathfindnodesleft -= wanted;
+	return wanted;
+}
+
+void Kernel::ConCmd_pathfindBudget(const Console::ArgvType& argv)
+{
+	Kernel* kernel = Kernel::get_instance();
+	if (argv.size() > 1) {
+		long nodes = strtol(argv[1].c_str(), 0, 0);
+		kernel->setPathfindBudget(nodes > 0 ?
+								  static_cast<unsigned int>(nodes) : 0);
+	}
+
+	pout << "Kernel: pathfinding budget: " << kernel->getPathfindBudget()
+		 << " nodes per frame" << std::endl;
+}
+
 uint32 Kernel::getNumProcesses(ObjId objid, uint16 processtype)
 {
 	uint32 count = 0;
 
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it)
+	if (objid != 0) {
+		if (objid >= objprocesses.size()) return 0;
+
+		for (Process* p = objprocesses[objid]; p; p = p->nextobjproc)
+		{
+			// Don't count us, we are not really here
+			if (p->is_terminated()) continue;
+
+			if (objid == p->item_num &&
+				(processtype == 6 || processtype == p->type))
+				count++;
+		}
+
+		return count;
+	}
+
+	std::vector<Process*> procs;
+	getAllProcesses(procs);
+	for (ProcessIterator it = procs.begin(); it != procs.end(); ++it)
 	{
 		Process* p = *it;
 
 		// Don't count us, we are not really here
 		if (p->is_terminated()) continue;
 
-		if ((objid == 0 || objid == p->item_num) &&
-			(processtype == 6 || processtype == p->type))
+		if (processtype == 6 || processtype == p->type)
 			count++;
 	}
 
@@ -356,15 +744,32 @@ uint32 Kernel::getNumProcesses(ObjId objid, uint16 processtype)
 
 Process* Kernel::findProcess(ObjId objid, uint16 processtype)
 {
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it)
+	if (objid != 0) {
+		if (objid >= objprocesses.size()) return 0;
+
+		for (Process* p = objprocesses[objid]; p; p = p->nextobjproc)
+		{
+			// Don't count us, we are not really here
+			if (p->is_terminated()) continue;
+
+			if (objid == p->item_num &&
+				(processtype == 6 || processtype == p->type))
+				return p;
+		}
+
+		return 0;
+	}
+
+	std::vector<Process*> procs;
+	getAllProcesses(procs);
+	for (ProcessIterator it = procs.begin(); it != procs.end(); ++it)
 	{
 		Process* p = *it;
 
 		// Don't count us, we are not really here
 		if (p->is_terminated()) continue;
 
-		if ((objid == 0 || objid == p->item_num) &&
-			(processtype == 6 || processtype == p->type))
+		if (processtype == 6 || processtype == p->type)
 		{
 			return p;
 		}
@@ -373,42 +778,80 @@ Process* Kernel::findProcess(ObjId objid, uint16 processtype)
 	return 0;
 }
 
+void Kernel::collectObjectProcesses(ObjId objid, uint16 processtype,
+									bool nottype, std::vector<Process*>& procs)
+{
+	// Collect first and kill afterwards: failing a process wakes up the
+	// processes waiting for it, which may add them to the object lists
+	if (objid != 0) {
+		if (objid >= objprocesses.size()) return;
+
+		for (Process* p = objprocesses[objid]; p; p = p->nextobjproc)
+		{
+			if (p->item_num != objid) continue;
+			if (p->flags & (Process::PROC_TERMINATED |
+							Process::PROC_TERM_DEFERRED)) continue;
+
+			if (nottype ? (p->type != processtype)
+						: (processtype == 6 || processtype == p->type))
+				procs.push_back(p);
+		}
+		return;
+	}
+
+	std::vector<Process*> all;
+	getAllProcesses(all);
+	for (ProcessIterator it = all.begin(); it != all.end(); ++it)
+	{
+		Process* p = *it;
+
+		if (p->item_num == 0) continue;
+		if (p->flags & (Process::PROC_TERMINATED |
+						Process::PROC_TERM_DEFERRED)) continue;
+
+		if (nottype ? (p->type != processtype)
+					: (processtype == 6 || processtype == p->type))
+			procs.push_back(p);
+	}
+}
 
 void Kernel::killProcesses(ObjId objid, uint16 processtype, bool fail)
 {
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it)
+	std::vector<Process*> procs;
+	collectObjectProcesses(objid, processtype, false, procs);
+
+	for (std::vector<Process*>::iterator it = procs.begin();
+		 it != procs.end(); ++it)
 	{
 		Process* p = *it;
 
-		if (p->item_num != 0 && (objid == 0 || objid == p->item_num) &&
-			(processtype == 6 || processtype == p->type) && 
-			!(p->flags & Process::PROC_TERMINATED) &&
-			!(p->flags & Process::PROC_TERM_DEFERRED))
-		{
-			if (fail)
-				p->fail();
-			else
-				p->terminate();
-		}
+		// an earlier kill may have failed this one already
+		if (p->flags & Process::PROC_TERMINATED) continue;
+
+		if (fail)
+			p->fail();
+		else
+			p->terminate();
 	}
 }
 
 void Kernel::killProcessesNotOfType(ObjId objid, uint16 processtype, bool fail)
 {
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it)
+	std::vector<Process*> procs;
+	collectObjectProcesses(objid, processtype, true, procs);
+
+	for (std::vector<Process*>::iterator it = procs.begin();
+		 it != procs.end(); ++it)
 	{
 		Process* p = *it;
 
-		if (p->item_num != 0 && (objid == 0 || objid == p->item_num) &&
-			(p->type != processtype) &&
-			!(p->flags & Process::PROC_TERMINATED) &&
-			!(p->flags & Process::PROC_TERM_DEFERRED))
-		{
-			if (fail)
-				p->fail();
-			else
-				p->terminate();
-		}
+		// an earlier kill may have failed this one already
+		if (p->flags & Process::PROC_TERMINATED) continue;
+
+		if (fail)
+			p->fail();
+		else
+			p->terminate();
 	}
 }
 
@@ -416,8 +859,10 @@ void Kernel::save(ODataSource* ods)
 {
 	ods->write4(framenum);
 	pIDs->save(ods);
-	ods->write4(processes.size());
-	for (ProcessIterator it = processes.begin(); it != processes.end(); ++it)
+	std::vector<Process*> procs;
+	getAllProcesses(procs);
+	ods->write4(static_cast<uint32>(procs.size()));
+	for (ProcessIterator it = procs.begin(); it != procs.end(); ++it)
 	{
 		(*it)->save(ods);
 	}
@@ -434,7 +879,8 @@ bool Kernel::load(IDataSource* ids, uint32 version)
 	for (unsigned int i = 0; i < pcount; ++i) {
 		Process* p = loadProcess(ids, version);
 		if (!p) return false;
-		processes.push_back(p);
+		processes.pushBack(p);
+		indexProcess(p);
 	}
 
 	return true;
@@ -21,16 +21,19 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "intrinsics.h"
+#include "ProcessQueue.h"
+#include "ProcessProfiler.h"
 
 class Process;
+class WorkerPool;
 class idMan;
 class IDataSource;
 class ODataSource;
 
 typedef Process* (*ProcessLoadFunc)(IDataSource*, uint32 version);
-typedef std::list<Process*>::const_iterator ProcessIter;
 
 class Kernel {
 public:
@@ -56,6 +59,16 @@ public:
 	void setNextProcess(Process *proc);
 	Process* getRunningProcess() const { return runningprocess; }
 
+	//! re-file a process under its current item number
+	void reindexProcess(Process *proc);
+
+	//! Let the running process sleep for a number of frames.
+	//! It is taken off the run-list until frame getFrameNum()+frames.
+	void sleepProcess(Process *proc, uint32 frames);
+
+	//! get the number of frames a sleeping process has left
+	uint32 getSleepFrames(const Process *proc) const;
+
 	// objid = 0 means any object, type = 6 means any type
 	uint32 getNumProcesses(ObjId objid, uint16 processtype);
 
@@ -74,9 +87,10 @@ public:
 	//! \param fail if true, fail the processes instead of terminating them
 	void killProcessesNotOfType(ObjId objid, uint16 processtype, bool fail);
 
-	//! get an iterator of the process list.
-	ProcessIter getProcessBeginIterator() { return processes.begin(); }
-	ProcessIter getProcessEndIterator() { return processes.end(); }
+	//! get the (not terminated) processes of a certain object
+	//! \param objid the object, or 0 for any object (except objid 0)
+	void getObjectProcesses(ObjId objid, std::vector<Process*>& procs)
+		{ collectObjectProcesses(objid, 6, false, procs); }
 
 	void kernelStats();
 	void processTypes();
@@ -96,6 +110,24 @@ public:
 
 	uint32 getFrameNum() const { return framenum; };
 
+	//! Set the number of worker threads for the parallel phase, in which
+	//! processes that have one (see Process::hasParallelPhase) prepare
+	//! their frame before being run in pid order. 0 disables it.
+	void setParallelThreads(unsigned int threads);
+	unsigned int getParallelThreads() const;
+
+	//! Set the number of nodes pathfinding processes may expand in one
+	//! frame, shared by all of them. 0 means no limit.
+	void setPathfindBudget(unsigned int nodes) { pathfindbudget = nodes; }
+	unsigned int getPathfindBudget() const { return pathfindbudget; }
+
+	//! Take up to wanted nodes from what is left of this frame's
+	//! pathfinding budget.
+	//! \return the number of nodes the caller may expand, possibly 0
+	unsigned int takePathfindNodes(unsigned int wanted);
+
+	ProcessProfiler& getProfiler() { return profiler; }
+
 	//! "Kernel::processTypes" console command
 	static void ConCmd_processTypes(const Console::ArgvType &argv);
 	//! "Kernel::listProcesses" console command
@@ -107,16 +139,79 @@ public:
 	static void ConCmd_toggleFrameByFrame(const Console::ArgvType &argv);
 	//! "Kernel::advanceFrame" console command
 	static void ConCmd_advanceFrame(const Console::ArgvType &argv);
+	//! "Kernel::parallelThreads" console command
+	static void ConCmd_parallelThreads(const Console::ArgvType &argv);
+	//! "Kernel::profile" console command
+	static void ConCmd_profile(const Console::ArgvType &argv);
+	//! "Kernel::pathfindBudget" console command
+	static void ConCmd_pathfindBudget(const Console::ArgvType &argv);
 
 	INTRINSIC(I_getNumProcesses);
 	INTRINSIC(I_resetRef);
 private:
 	Process* loadProcess(IDataSource* ids, uint32 version);
 
-	std::list<Process*> processes;
+	//! add a process that just entered the run-list to the lookup indices
+	void indexProcess(Process *proc);
+	//! remove a process that is leaving the run-list from the lookup indices
+	void unindexProcess(Process *proc);
+
+	ProcessQueue processes;
 	idMan	*pIDs;
 
-	std::list<Process*>::iterator current_process;
+	//! processes in the run-list, indexed by pid
+	std::vector<Process*> pidtable;
+
+	//! heads of the per-object lists of processes (see Process::nextobjproc)
+	std::vector<Process*> objprocesses;
+
+	//! collect the processes of the given object matching the kill criteria
+	void collectObjectProcesses(ObjId objid, uint16 processtype, bool nottype,
+								std::vector<Process*>& procs);
+
+	//! get all processes, those in the run-list and those parked
+	void getAllProcesses(std::vector<Process*>& procs) const;
+
+	//! move a suspended or sleeping process from the run-list to a bucket
+	void parkProcess(Process *proc);
+	//! take a process out of its bucket
+	void unparkProcess(Process *proc);
+	//! return the processes whose sleep ends this frame to the run-list
+	void wakeSleepers();
+
+	//! prepare the runnable processes that have a parallel phase on the
+	//! worker threads, then run them in pid order
+	//! \return false if the kernel was reset by one of the processes
+	bool runParallelPhase();
+	static void parallelJob(void* data, unsigned int index);
+
+	//! Parked processes. Suspended processes wait in PARK_WAITING until
+	//! they are woken up. Sleeping processes are kept in a two-level
+	//! timer wheel: PARK_WHEEL0 has a bucket for each of the next 256
+	//! frames, PARK_WHEEL1 a bucket for each block of 256 frames after
+	//! that. A PARK_WHEEL1 bucket is spread over PARK_WHEEL0 when its
+	//! block begins.
+	enum {
+		PARK_WAITING = 0,
+		PARK_WHEEL0  = 1,
+		PARK_WHEEL1  = PARK_WHEEL0 + 256,
+		PARK_BUCKETS = PARK_WHEEL1 + 256
+	};
+	std::vector<Process*> parked[PARK_BUCKETS];
+	unsigned int parkedcount;
+
+	WorkerPool* workers;		//!< 0 if the parallel phase is disabled
+	std::vector<Process*> parallelprocs;
+
+	//! a job of the parallel phase: runParallel() of parallelprocs[first]
+	//! or func called on count processes starting at parallelbatched[first]
+	struct ParallelJob {
+		void (*func)(Process** procs, unsigned int count);
+		unsigned int first;
+		unsigned int count;
+	};
+	std::vector<ParallelJob> paralleljobs;
+	std::vector<Process*> parallelbatched;
 
 	std::map<std::string, ProcessLoadFunc> processloaders;
 
@@ -126,8 +221,13 @@ private:
 	unsigned int paused;
 	bool framebyframe;
 
+	unsigned int pathfindbudget;
+	unsigned int pathfindnodesleft;	//!< of pathfindbudget, this frame
+
 	Process* runningprocess;
 
+	ProcessProfiler profiler;
+
 	static Kernel* kernel;
 };
 
@@ -21,6 +21,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "MemoryManager.h"
 
 #include "SegmentedAllocator.h"
+#include "SlabAllocator.h"
+#include "profiler/Frame_profiler.h"
 
 MemoryManager* MemoryManager::memorymanager = 0;
 
@@ -32,7 +34,9 @@ MemoryManager::MemoryManager()
 	//!!! CONSTANT !!!!
 	allocatorCount = 2;
 	// Tune these with averages from MemoryManager::MemInfo when needed
-	allocators[0] = new SegmentedAllocator(192, 8500);
+	// Small objects (all Process and Object subclasses) go to the slabs,
+	// which are safe to use from every thread. The larger pool is not.
+	allocators[0] = new SlabAllocator(256);
 	allocators[1] = new SegmentedAllocator(4224, 25);
 
 	Pentagram::setAllocationFunctions(MemoryManager::allocate,
@@ -56,7 +60,9 @@ void * MemoryManager::_allocate(size_t size)
 	{
 		if (allocators[i]->getCapacity() >= size)
 		{
-			return allocators[i]->allocate(size);
+			void * ptr = allocators[i]->allocate(size);
+			PROFILE_ALLOC(ptr, size, "MemoryManager");
+			return ptr;
 		}
 	}
 
@@ -65,12 +71,14 @@ void * MemoryManager::_allocate(size_t size)
 #ifdef DEBUG
 	con.Printf("MemoryManager::allocate - Allocated %d bytes to 0x%X\n", size, ptr);
 #endif
+	PROFILE_ALLOC(ptr, size, "MemoryManager");
 
 	return ptr;
 }
 
 void MemoryManager::_deallocate(void * ptr)
 {
+	PROFILE_FREE(ptr, "MemoryManager");
 	Pool * p;
 	int i;
 	for (i = 0; i < allocatorCount; ++i)
@@ -99,6 +107,17 @@ void MemoryManager::freeResources()
 	}
 }
 
+size_t MemoryManager::getUsedMemory()
+{
+	size_t used = 0;
+	int i;
+	for (i = 0; i < allocatorCount; ++i)
+	{
+		used += allocators[i]->getUsedMemory();
+	}
+	return used;
+}
+
 void MemoryManager::ConCmd_MemInfo(const Console::ArgvType &argv)
 {
 	MemoryManager * mm = MemoryManager::get_instance();
@@ -45,6 +45,9 @@ public:
 
 	void freeResources();
 
+	//! get the memory taken by blocks from all Allocators
+	size_t getUsedMemory();
+
 	//! "MemoryManager::MemInfo" console command
 	static void ConCmd_MemInfo(const Console::ArgvType &argv);
 
@@ -101,40 +101,49 @@ void ObjectManager::reset()
 	unsigned int i;
 
 	for (i = 0; i < objects.size(); ++i) {
-		if (objects[i] == 0) continue;
+		if (objects[i].object == 0) continue;
 #if 0
-		Item* item = p_dynamic_cast<Item*>(objects[i]);
+		Item* item = p_dynamic_cast<Item*>(objects[i].object);
 		if (item && item->getParent()) continue; // will be deleted by parent
 #endif
-		Gump* gump = p_dynamic_cast<Gump*>(objects[i]);
+		Gump* gump = p_dynamic_cast<Gump*>(objects[i].object);
 		if (gump && gump->GetParent()) continue; // will be deleted by parent
-		delete objects[i];
+		delete objects[i].object;
 	}
 
 	for (i = 0; i < objects.size(); ++i) {
-		assert(objects[i] == 0);
+		assert(objects[i].object == 0);
 	}
 
-
+	// the generations are kept, so old handles stay invalid
 	//!CONSTANTS
-	objects.clear();
 	objects.resize(65536);
 	objIDs->clearAll(32766);
 	objIDs->reserveID(666);		// 666 is reserved for the Guardian Bark hack
 	actorIDs->clearAll();
 }
 
+unsigned int ObjectManager::getObjectCount() const
+{
+	unsigned int count = 0;
+	for (unsigned int i = 1; i < objects.size(); ++i) {
+		if (objects[i].object != 0)
+			count++;
+	}
+	return count;
+}
+
 void ObjectManager::objectStats()
 {
 	unsigned int i, npccount = 0, objcount = 0;
 
 	//!constants
 	for (i = 1; i < 256; i++) {
-		if (objects[i] != 0)
+		if (objects[i].object != 0)
 			npccount++;
 	}
 	for (i = 256; i < objects.size(); i++) {
-		if (objects[i] != 0)
+		if (objects[i].object != 0)
 			objcount++;
 	}
 
@@ -148,7 +157,7 @@ void ObjectManager::objectTypes()
 	pout << "Current object types:" << std::endl;
 	std::map<std::string, unsigned int> objecttypes;
 	for (unsigned int i = 1; i < objects.size(); ++i) {
-		Object* o = objects[i];
+		Object* o = objects[i].object;
 		if (!o) continue;
 		objecttypes[o->GetClassType().class_name]++;
 	}
@@ -201,8 +210,8 @@ uint16 ObjectManager::assignObjId(Object* obj, ObjId new_objid)
 
 	// failure???
 	if (new_objid != 0) {
-		assert(objects[new_objid] == 0);
-		objects[new_objid] = obj;
+		assert(objects[new_objid].object == 0);
+		objects[new_objid].object = obj;
 	}
 	return new_objid;
 }
@@ -216,8 +225,8 @@ uint16 ObjectManager::assignActorObjId(Actor* actor, ObjId new_objid)
 
 	// failure???
 	if (new_objid != 0) {
-		assert(objects[new_objid] == 0);
-		objects[new_objid] = actor;
+		assert(objects[new_objid].object == 0);
+		objects[new_objid].object = actor;
 	}
 	return new_objid;
 }
@@ -239,12 +248,10 @@ void ObjectManager::clearObjId(ObjId objid)
 	else
 		actorIDs->clearID(objid);
 
-	objects[objid] = 0;
-}
-
-Object* ObjectManager::getObject(ObjId objid) const
-{
-	return objects[objid];
+	if (objects[objid].object) {
+		objects[objid].object = 0;
+		objects[objid].generation++;
+	}
 }
 
 void ObjectManager::allow64kObjects()
@@ -259,7 +266,7 @@ void ObjectManager::save(ODataSource* ods)
 	actorIDs->save(ods);
 
 	for (unsigned int i = 0; i < objects.size(); ++i) {
-		Object* object = objects[i];
+		Object* object = objects[i].object;
 		if (!object) continue;
 
 		// child items/gumps are saved by their parent.
@@ -324,7 +331,7 @@ bool ObjectManager::load(IDataSource* ids, uint32 version)
 	}
 	unsigned int count = 0;
 	for (unsigned int i = 1024; i < objects.size(); i++) {
-		if (objects[i] == 0 && objIDs->isIDUsed(i)) {
+		if (objects[i].object == 0 && objIDs->isIDUsed(i)) {
 			objIDs->clearID(i);
 			count++;
 		}
@@ -367,7 +374,7 @@ Object* ObjectManager::loadObject(IDataSource* ids, std::string classname,
 	uint16 objid = obj->getObjId();
 
 	if (objid != 0xFFFF) {
-		objects[objid] = obj;
+		objects[objid].object = obj;
 		bool used;
 		if (objid >= 256)
 			used = objIDs->isIDUsed(objid);
@@ -45,7 +45,28 @@ public:
 	uint16 assignActorObjId(Actor* obj, ObjId id=0xFFFF);
 	bool reserveObjId(ObjId objid);
 	void clearObjId(ObjId objid);
-	Object* getObject(ObjId objid) const;
+	Object* getObject(ObjId objid) const { return objects[objid].object; }
+
+	//! get a handle to the object with the given objid, or 0 if there is none
+	ObjHandle getHandle(ObjId objid) const {
+		const ObjectSlot& slot = objects[objid];
+		return slot.object ? (static_cast<uint32>(slot.generation) << 16) |
+			objid : 0;
+	}
+	//! get the object a handle refers to, or 0 if it has been destroyed
+	Object* getObjectByHandle(ObjHandle handle) const {
+		const ObjectSlot& slot = objects[handle & 0xFFFF];
+		return (slot.generation == (handle >> 16)) ? slot.object : 0;
+	}
+	//! get the handle a reference to objid loaded from a savegame should
+	//! have. Slots keep their generation until their object is removed, so
+	//! this is right even when the object itself hasn't been loaded yet.
+	ObjHandle getLoadHandle(ObjId objid) const {
+		return objid ? (static_cast<uint32>(objects[objid].generation) << 16) |
+			objid : 0;
+	}
+	static ObjId getHandleObjId(ObjHandle handle)
+		{ return static_cast<ObjId>(handle & 0xFFFF); }
 
 	//! increase the maximum allowed object ID
 	//! Note: this shouldn't be used in normal circumstances.
@@ -55,6 +76,9 @@ public:
 	void allow64kObjects();
 
 
+	//! get the number of objects in the table
+	unsigned int getObjectCount() const;
+
 	void objectStats();
 	void objectTypes();
 
@@ -69,7 +93,14 @@ public:
 	//! "ObjectManager::objectInfo" console command
 	static void ConCmd_objectInfo(const Console::ArgvType &argv);
 
-	std::vector<Object*> objects;
+	//! Object table, indexed by objid. The generation of a slot changes
+	//! every time its object is removed.
+	struct ObjectSlot {
+		ObjectSlot() : object(0), generation(0) { }
+		Object* object;
+		uint16 generation;
+	};
+	std::vector<ObjectSlot> objects;
 	idMan* objIDs;
 	idMan* actorIDs;
 
@@ -29,7 +29,10 @@ DEFINE_RUNTIME_CLASSTYPE_CODE_BASE_CLASS(Process);
 DEFINE_CUSTOM_MEMORY_ALLOCATION(Process);
 
 Process::Process(ObjId it, uint16 ty)
-	: pid(0xFFFF), flags(0), item_num(it), type(ty), result(0)
+	: pid(0xFFFF), flags(0), item_num(it), type(ty), result(0),
+	  indexeditem(0), nextobjproc(0), prevobjproc(0),
+	  wakeframe(0), parkbucket(-1), parkslot(0),
+	  committedframe(0)
 {
 	Kernel::get_instance()->assignPID(this);
 }
@@ -59,6 +62,18 @@ void Process::terminate()
 	waiting.clear();
 
 	flags |= PROC_TERMINATED;
+
+	// a parked process has to go back to the run-list to be cleaned up
+	if (parkbucket >= 0)
+		kernel->setNextProcess(this);
+}
+
+void Process::terminateDeferred()
+{
+	flags |= PROC_TERM_DEFERRED;
+
+	if (parkbucket >= 0)
+		Kernel::get_instance()->setNextProcess(this);
 }
 
 void Process::wakeUp(uint32 result_)
@@ -97,6 +112,13 @@ void Process::suspend()
 	flags |= PROC_SUSPENDED;
 }
 
+void Process::setItemNum(ObjId it)
+{
+	item_num = it;
+	if (flags & PROC_ACTIVE)
+		Kernel::get_instance()->reindexProcess(this);
+}
+
 void Process::dumpInfo()
 {
 	pout << "Process " << getPid() << " class "
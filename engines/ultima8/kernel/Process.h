@@ -30,6 +30,24 @@ public:
 
 	virtual void run() = 0;
 
+	//! Can this process do part of its work in the Kernel's parallel phase?
+	//! A process that returns true only reads world state in runParallel()
+	//! and makes all its changes in the run() call that follows it.
+	virtual bool hasParallelPhase() const { return false; }
+
+	//! Prepare this frame's work. Called on a worker thread right before
+	//! run() when parallel processing is enabled. It may not change anything
+	//! but the process itself.
+	virtual void runParallel() { }
+
+	//! Prepares the parallel phase of a group of processes at once
+	typedef void (*ParallelBatchFunc)(Process** procs, unsigned int count);
+
+	//! If this returns a function, the Kernel collects the processes
+	//! returning the same function and calls it for groups of them on the
+	//! worker threads, instead of calling runParallel() for each of them.
+	virtual ParallelBatchFunc getParallelBatch() const { return 0; }
+
 	Process(ObjId item_num=0, uint16 type=0);
 	virtual ~Process() { }
 
@@ -52,7 +70,7 @@ public:
 	virtual void terminate();
 
 	//! terminate next frame
-	void terminateDeferred() { flags |= PROC_TERM_DEFERRED; }
+	void terminateDeferred();
 
 	//! suspend until process 'pid' returns. If pid is 0, suspend indefinitely
 	void waitFor(ProcId pid);
@@ -65,7 +83,7 @@ public:
 
 	void wakeUp(uint32 result);
 
-	void setItemNum(ObjId it) { item_num = it; }
+	void setItemNum(ObjId it);
 	void setType(uint16 ty) { type = ty; }
 
 	ProcId getPid() const { return pid; }
@@ -103,6 +121,21 @@ protected:
 	//! When this process terminates, awaken them and pass them the result val.
 	std::vector<ProcId> waiting;
 
+private:
+	//! item this process is filed under in the Kernel's per-object list
+	ObjId indexeditem;
+	Process* nextobjproc;
+	Process* prevobjproc;
+
+	//! frame in which a sleeping process wants to run again (0 = awake)
+	uint32 wakeframe;
+	//! Kernel sleep bucket this process is parked in (-1 = in the run-list)
+	sint32 parkbucket;
+	uint32 parkslot;
+
+	//! frame in which run() was already called by the parallel phase
+	uint32 committedframe;
+
 public:
 
 	enum processflags {
@@ -0,0 +1,185 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "ProcessProfiler.h"
+#include "Process.h"
+#include "FileSystem.h"
+#include "ODataSource.h"
+
+#include <cstdio>
+#include <cstring>
+
+ProcessProfiler::ProcessProfiler()
+	: running(false), frequency(1), frames(0), curframe(0), csv(0),
+	  csvframes(0), csvcountdown(0)
+{
+
+}
+
+ProcessProfiler::~ProcessProfiler()
+{
+	closeCSV();
+}
+
+void ProcessProfiler::start()
+{
+	frequency = SDL_GetPerformanceFrequency();
+	if (frequency == 0) frequency = 1;
+	running = true;
+}
+
+void ProcessProfiler::stop()
+{
+	running = false;
+}
+
+void ProcessProfiler::reset()
+{
+	types.clear();
+	slowest.clear();
+	frames = 0;
+	csvcountdown = csvframes;
+}
+
+bool ProcessProfiler::setCSVDump(uint32 frames_, const std::string& filename)
+{
+	closeCSV();
+	csvframes = frames_;
+	csvcountdown = frames_;
+	if (frames_ == 0) return true;
+
+	csv = FileSystem::get_instance()->WriteFile(filename, true);
+	if (!csv) {
+		csvframes = 0;
+		return false;
+	}
+
+	const char* header = "frame,class,calls,time_ms\n";
+	csv->write(header, static_cast<uint32>(std::strlen(header)));
+
+	for (TypeStatsMap::iterator it = types.begin(); it != types.end(); ++it) {
+		it->second.interval = 0;
+		it->second.intervalcalls = 0;
+	}
+	return true;
+}
+
+void ProcessProfiler::closeCSV()
+{
+	delete csv;
+	csv = 0;
+}
+
+void ProcessProfiler::endRun(Process* proc, Uint64 starttime)
+{
+	if (!running || starttime == 0) return;
+
+	Uint64 time = SDL_GetPerformanceCounter() - starttime;
+	const char* classname = proc->GetClassType().class_name;
+
+	TypeStats& stats = types[classname];
+	stats.total += time;
+	stats.calls++;
+	stats.frametime += time;
+	stats.framecalls++;
+	stats.interval += time;
+	stats.intervalcalls++;
+
+	if (slowest.size() == MAX_SLOWEST && slowest.back().time >= time)
+		return;
+
+	RunStats run;
+	run.time = time;
+	run.pid = proc->getPid();
+	run.classname = classname;
+	run.frame = curframe;
+
+	std::vector<RunStats>::iterator it = slowest.begin();
+	while (it != slowest.end() && it->time >= time) ++it;
+	slowest.insert(it, run);
+	if (slowest.size() > MAX_SLOWEST) slowest.pop_back();
+}
+
+void ProcessProfiler::endFrame(uint32 framenum)
+{
+	if (!running) return;
+
+	for (TypeStatsMap::iterator it = types.begin(); it != types.end(); ++it) {
+		TypeStats& stats = it->second;
+		stats.lastframe = stats.frametime;
+		if (stats.frametime > stats.worstframe)
+			stats.worstframe = stats.frametime;
+		stats.frametime = 0;
+		stats.framecalls = 0;
+	}
+	frames++;
+	curframe = framenum + 1;
+
+	if (csv && --csvcountdown == 0) {
+		writeCSV(framenum);
+		csvcountdown = csvframes;
+	}
+}
+
+void ProcessProfiler::writeCSV(uint32 framenum)
+{
+	char buf[256];
+	for (TypeStatsMap::iterator it = types.begin(); it != types.end(); ++it) {
+		TypeStats& stats = it->second;
+		if (stats.intervalcalls == 0) continue;
+
+		int len = std::snprintf(buf, sizeof(buf), "%u,%s,%u,%.3f\n",
+								framenum, it->first, stats.intervalcalls,
+								toMillis(stats.interval));
+		if (len > 0)
+			csv->write(buf, static_cast<uint32>(len));
+
+		stats.interval = 0;
+		stats.intervalcalls = 0;
+	}
+}
+
+void ProcessProfiler::print(unsigned int topn)
+{
+	pout << "Process profile: " << frames << " frames"
+		 << (running ? "" : " (stopped)") << std::endl;
+	if (frames == 0) return;
+
+	pout.printf("%-28s %8s %10s %9s %9s %9s\n", "class", "calls",
+				"total ms", "ms/frame", "last ms", "worst ms");
+	for (TypeStatsMap::iterator it = types.begin(); it != types.end(); ++it) {
+		TypeStats& stats = it->second;
+		pout.printf("%-28s %8u %10.2f %9.3f %9.3f %9.3f\n", it->first,
+					stats.calls, toMillis(stats.total),
+					toMillis(stats.total) / frames, toMillis(stats.lastframe),
+					toMillis(stats.worstframe));
+	}
+
+	if (topn > slowest.size())
+		topn = static_cast<unsigned int>(slowest.size());
+	if (topn == 0) return;
+
+	pout << "Slowest runs:" << std::endl;
+	for (unsigned int i = 0; i < topn; ++i) {
+		pout.printf("%9.3f ms  pid %5u  %-28s frame %u\n",
+					toMillis(slowest[i].time), slowest[i].pid,
+					slowest[i].classname, slowest[i].frame);
+	}
+}
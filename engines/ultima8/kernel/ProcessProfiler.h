@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef PROCESSPROFILER_H
+#define PROCESSPROFILER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "misc/sdl2_compat.h"
+
+class Process;
+class ODataSource;
+
+//
+// ProcessProfiler. Measures the time the Kernel spends in Process::run(),
+// per process class (by RunTimeClassType name), and keeps track of the
+// slowest individual runs.
+//
+
+class ProcessProfiler
+{
+public:
+	ProcessProfiler();
+	~ProcessProfiler();
+
+	void start();
+	void stop();
+	bool isRunning() const { return running; }
+
+	//! forget everything measured so far
+	void reset();
+
+	//! Start a new CSV file, replacing any file of that name, and every
+	//! 'frames' frames add the stats of those frames to it.
+	//! 0 frames stops dumping.
+	//! \return false if the file couldn't be opened
+	bool setCSVDump(uint32 frames, const std::string& filename);
+
+	//! call right before Process::run()
+	//! \return a timestamp to pass to endRun(), or 0 if not profiling
+	Uint64 beginRun() const
+		{ return running ? SDL_GetPerformanceCounter() : 0; }
+	//! call right after Process::run() returned
+	void endRun(Process* proc, Uint64 starttime);
+
+	//! call once all processes have run in a frame
+	void endFrame(uint32 framenum);
+
+	//! print the stats per class and the 'topn' slowest runs to pout
+	void print(unsigned int topn);
+
+	enum { MAX_SLOWEST = 32 };
+
+private:
+	struct TypeStats {
+		TypeStats() : total(0), calls(0), frametime(0), framecalls(0),
+					  lastframe(0), worstframe(0), interval(0),
+					  intervalcalls(0) { }
+
+		Uint64 total;			//!< time spent since the profile started
+		uint32 calls;
+		Uint64 frametime;		//!< time spent in the current frame
+		uint32 framecalls;
+		Uint64 lastframe;		//!< time spent in the last finished frame
+		Uint64 worstframe;		//!< most time spent in a single frame
+		Uint64 interval;		//!< time spent since the last CSV dump
+		uint32 intervalcalls;
+	};
+
+	struct RunStats {
+		Uint64 time;
+		uint16 pid;
+		const char* classname;
+		uint32 frame;
+	};
+
+	double toMillis(Uint64 ticks) const
+		{ return (ticks * 1000.0) / static_cast<double>(frequency); }
+
+	void writeCSV(uint32 framenum);
+	void closeCSV();
+
+	bool running;
+	Uint64 frequency;
+	uint32 frames;				//!< frames profiled
+	uint32 curframe;
+
+	//! keyed by RunTimeClassType::class_name, which is unique per class
+	typedef std::map<const char*, TypeStats> TypeStatsMap;
+	TypeStatsMap types;
+
+	//! slowest runs, slowest first
+	std::vector<RunStats> slowest;
+
+	ODataSource* csv;
+	uint32 csvframes;			//!< dump every csvframes frames
+	uint32 csvcountdown;
+};
+
+#endif
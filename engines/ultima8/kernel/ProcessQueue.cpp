@@ -0,0 +1,244 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "ProcessQueue.h"
+#include "Process.h"
+
+#ifndef USE_SLOT_SCHEDULER
+
+ProcessQueue::ProcessQueue()
+{
+	current = procs.end();
+}
+
+ProcessQueue::~ProcessQueue()
+{
+
+}
+
+void ProcessQueue::clear()
+{
+	procs.clear();
+	current = procs.end();
+}
+
+void ProcessQueue::insertNext(Process* proc)
+{
+	if (current == procs.end()) {
+		procs.push_front(proc);
+	} else {
+		std::list<Process*>::iterator t = current;
+		++t;
+
+		procs.insert(t, proc);
+	}
+}
+
+void ProcessQueue::pushBack(Process* proc)
+{
+	procs.push_back(proc);
+}
+
+void ProcessQueue::remove(Process* proc)
+{
+	assert(!isCurrent(proc));
+
+	std::list<Process*>::iterator it;
+	for (it = procs.begin(); it != procs.end(); ++it) {
+		if (*it == proc) {
+			procs.erase(it);
+			return;
+		}
+	}
+}
+
+Process* ProcessQueue::beginFrame()
+{
+	current = procs.begin();
+	return (current != procs.end()) ? *current : 0;
+}
+
+Process* ProcessQueue::advance()
+{
+	++current;
+	return (current != procs.end()) ? *current : 0;
+}
+
+Process* ProcessQueue::eraseCurrent()
+{
+	current = procs.erase(current);
+	return (current != procs.end()) ? *current : 0;
+}
+
+void ProcessQueue::getProcesses(std::vector<Process*>& out) const
+{
+	out.insert(out.end(), procs.begin(), procs.end());
+}
+
+#else
+
+ProcessQueue::ProcessQueue()
+	: active(0), cursor(0), current(0), count(0)
+{
+
+}
+
+ProcessQueue::~ProcessQueue()
+{
+
+}
+
+void ProcessQueue::clear()
+{
+	buffers[0].clear();
+	buffers[1].clear();
+	active = 0;
+	pending.clear();
+	location.clear();
+	cursor = 0;
+	current = 0;
+	count = 0;
+}
+
+void ProcessQueue::setLocation(Process* proc, QueuePart part, uint32 index)
+{
+	ProcId pid = proc->getPid();
+	if (pid >= location.size())
+		location.resize(pid + 1, 0);
+	location[pid] = (static_cast<uint32>(part) << 30) | index;
+}
+
+void ProcessQueue::clearLocation(Process* proc)
+{
+	ProcId pid = proc->getPid();
+	if (pid < location.size())
+		location[pid] = 0;
+}
+
+void ProcessQueue::insertNext(Process* proc)
+{
+	// Processes on the pending stack run right after the current process,
+	// top of the stack first. Between frames the stack is the run-list front.
+	setLocation(proc, PART_PENDING, static_cast<uint32>(pending.size()));
+	pending.push_back(proc);
+	count++;
+}
+
+void ProcessQueue::pushBack(Process* proc)
+{
+	setLocation(proc, slotsPart(), static_cast<uint32>(slots().size()));
+	slots().push_back(proc);
+	count++;
+}
+
+void ProcessQueue::remove(Process* proc)
+{
+	assert(!isCurrent(proc));
+
+	ProcId pid = proc->getPid();
+	if (pid >= location.size()) return;
+
+	uint32 loc = location[pid];
+	uint32 index = loc & 0x3FFFFFFF;
+
+	std::vector<Process*>* part = 0;
+	switch (loc >> 30) {
+	case PART_BUFFER0: part = &buffers[0]; break;
+	case PART_BUFFER1: part = &buffers[1]; break;
+	case PART_PENDING: part = &pending; break;
+	default: return;
+	}
+
+	if (index < part->size() && (*part)[index] == proc) {
+		(*part)[index] = 0;
+		location[pid] = 0;
+		count--;
+	}
+}
+
+Process* ProcessQueue::next()
+{
+	while (!pending.empty()) {
+		Process* p = pending.back();
+		pending.pop_back();
+		if (p) return p;
+	}
+
+	std::vector<Process*>& s = slots();
+	while (cursor < s.size()) {
+		Process* p = s[cursor++];
+		if (p) return p;
+	}
+
+	// end of the frame: the visited processes make up the new run order
+	s.clear();
+	active ^= 1;
+	cursor = 0;
+
+	return 0;
+}
+
+Process* ProcessQueue::beginFrame()
+{
+	// if a previous walk was cut short, finish it without running anything
+	while (current) advance();
+
+	current = next();
+	return current;
+}
+
+Process* ProcessQueue::advance()
+{
+	setLocation(current, visitedPart(), static_cast<uint32>(visited().size()));
+	visited().push_back(current);
+
+	current = next();
+	return current;
+}
+
+Process* ProcessQueue::eraseCurrent()
+{
+	clearLocation(current);
+	count--;
+
+	current = next();
+	return current;
+}
+
+void ProcessQueue::getProcesses(std::vector<Process*>& out) const
+{
+	const std::vector<Process*>& s = buffers[active];
+	const std::vector<Process*>& v = buffers[active ^ 1];
+
+	std::vector<Process*>::const_iterator it;
+	for (it = v.begin(); it != v.end(); ++it)
+		if (*it) out.push_back(*it);
+
+	if (current) out.push_back(current);
+
+	std::vector<Process*>::const_reverse_iterator rit;
+	for (rit = pending.rbegin(); rit != pending.rend(); ++rit)
+		if (*rit) out.push_back(*rit);
+
+	for (it = s.begin() + cursor; it != s.end(); ++it)
+		if (*it) out.push_back(*it);
+}
+
+#endif
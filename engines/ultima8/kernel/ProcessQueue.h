@@ -0,0 +1,152 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef PROCESSQUEUE_H
+#define PROCESSQUEUE_H
+
+#include <list>
+#include <vector>
+
+class Process;
+
+//
+// ProcessQueue. The Kernel's run-list.
+//
+// The run-list is walked once per frame from beginFrame() to the end.
+// A process passed to insertNext() is placed right after the process that
+// is currently being visited (or at the front of the list if no walk is in
+// progress), so it runs before anything else in the same frame.
+//
+// Two implementations with identical behaviour are available:
+// the default one wraps a std::list, the slot scheduler (enabled with
+// USE_SLOT_SCHEDULER) keeps the processes in contiguous arrays.
+//
+
+#ifndef USE_SLOT_SCHEDULER
+
+class ProcessQueue
+{
+public:
+	ProcessQueue();
+	~ProcessQueue();
+
+	void clear();
+	unsigned int size() const { return static_cast<unsigned int>(procs.size()); }
+
+	//! insert after the current process, or at the front between frames
+	void insertNext(Process* proc);
+	//! append to the end of the run-list
+	void pushBack(Process* proc);
+	//! remove a process. It must not be the current process.
+	void remove(Process* proc);
+
+	bool isCurrent(Process* proc) const
+		{ return current != procs.end() && *current == proc; }
+
+	//! start walking the run-list
+	//! \return the first process, or 0 if the list is empty
+	Process* beginFrame();
+	//! keep the current process and move to the next one
+	//! \return the next process, or 0 at the end of the list
+	Process* advance();
+	//! drop the current process from the run-list and move to the next one
+	//! \return the next process, or 0 at the end of the list
+	Process* eraseCurrent();
+
+	//! get all processes in run order
+	void getProcesses(std::vector<Process*>& out) const;
+
+private:
+	std::list<Process*> procs;
+	std::list<Process*>::iterator current;
+};
+
+#else
+
+class ProcessQueue
+{
+public:
+	ProcessQueue();
+	~ProcessQueue();
+
+	void clear();
+	unsigned int size() const { return count; }
+
+	//! insert after the current process, or at the front between frames
+	void insertNext(Process* proc);
+	//! append to the end of the run-list
+	void pushBack(Process* proc);
+	//! remove a process. It must not be the current process.
+	void remove(Process* proc);
+
+	bool isCurrent(Process* proc) const
+		{ return current != 0 && current == proc; }
+
+	//! start walking the run-list
+	//! \return the first process, or 0 if the list is empty
+	Process* beginFrame();
+	//! keep the current process and move to the next one
+	//! \return the next process, or 0 at the end of the list
+	Process* advance();
+	//! drop the current process from the run-list and move to the next one
+	//! \return the next process, or 0 at the end of the list
+	Process* eraseCurrent();
+
+	//! get all processes in run order
+	void getProcesses(std::vector<Process*>& out) const;
+
+private:
+	// The run order is: visited + current + pending (top first) + the
+	// not yet visited part of slots. Removed processes leave a 0 tombstone
+	// behind, which is dropped when visited slots are copied to 'visited'.
+	// At the end of a frame 'visited' becomes the new 'slots'.
+
+	enum QueuePart {
+		PART_NONE    = 0,
+		PART_BUFFER0 = 1,
+		PART_BUFFER1 = 2,
+		PART_PENDING = 3
+	};
+
+	std::vector<Process*>& slots() { return buffers[active]; }
+	std::vector<Process*>& visited() { return buffers[active ^ 1]; }
+	QueuePart slotsPart() const { return QueuePart(PART_BUFFER0 + active); }
+	QueuePart visitedPart() const
+		{ return QueuePart(PART_BUFFER0 + (active ^ 1)); }
+
+	void setLocation(Process* proc, QueuePart part, uint32 index);
+	void clearLocation(Process* proc);
+	Process* next();
+
+	//! this frame's run order and the processes already run this frame.
+	//! They swap roles at the end of every frame.
+	std::vector<Process*> buffers[2];
+	unsigned int active;
+	std::vector<Process*> pending;	//!< stack of processes to run next
+
+	//! (part << 30 | index) for every pid in the queue
+	std::vector<uint32> location;
+
+	uint32 cursor;			//!< first slot that hasn't been visited yet
+	Process* current;		//!< process being visited, or 0 between frames
+	unsigned int count;
+};
+
+#endif
+
+#endif
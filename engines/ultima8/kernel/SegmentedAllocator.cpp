@@ -96,6 +96,18 @@ void SegmentedAllocator::freeResources()
 	}
 }
 
+size_t SegmentedAllocator::getUsedMemory()
+{
+	std::vector<SegmentedPool *>::iterator i;
+	size_t used = 0;
+
+	for (i = pools.begin(); i != pools.end(); ++i)
+	{
+		used += (*i)->getUsedMemory();
+	}
+	return used;
+}
+
 void SegmentedAllocator::printInfo()
 {
 	std::vector<SegmentedPool *>::iterator it;
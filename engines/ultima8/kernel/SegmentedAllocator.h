@@ -39,6 +39,8 @@ public:
 
 	virtual size_t getCapacity() {return nodeCapacity;}
 
+	virtual size_t getUsedMemory();
+
 	void printInfo();
 
 private:
@@ -52,6 +52,7 @@ public:
 	void printInfo();
 
 	size_t getNodeCapacity() {return nodeCapacity;}
+	size_t getUsedMemory() {return (nodes - freeNodeCount) * nodeCapacity;}
 
 	SegmentedPoolNode* getPoolNode(void * ptr);
 private:
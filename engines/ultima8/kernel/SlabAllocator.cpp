@@ -0,0 +1,203 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "SlabAllocator.h"
+
+DEFINE_RUNTIME_CLASSTYPE_CODE(SlabAllocator,Allocator);
+
+SlabAllocator * SlabAllocator::instance = 0;
+uint32 SlabAllocator::lastGeneration = 0;
+
+static thread_local SlabAllocator::ThreadCache threadCache;
+
+SlabAllocator::ThreadCache::~ThreadCache()
+{
+	// give the blocks of an exiting thread back
+	if (instance && instance->generation == generation)
+		instance->flushThreadCache(*this);
+}
+
+SlabAllocator::SlabAllocator(uint32 slabsPerPool_)
+	: Allocator(), poolCount(0), slabsPerPool(slabsPerPool_)
+{
+	assert(instance == 0);
+
+	mutex = SDL_CreateMutex();
+
+	pools[0] = new SlabPool(this, slabsPerPool);
+	poolCount = 1;
+
+	// magazines left over from a previous allocator are ignored
+	generation = ++lastGeneration;
+	instance = this;
+}
+
+SlabAllocator::~SlabAllocator()
+{
+	instance = 0;
+
+	uint32 i, count = poolCount;
+	for (i = 0; i < count; ++i)
+	{
+		delete pools[i];
+	}
+	poolCount = 0;
+
+	SDL_DestroyMutex(mutex);
+}
+
+SlabAllocator::ThreadCache & SlabAllocator::getThreadCache()
+{
+	ThreadCache & cache = threadCache;
+	if (cache.generation != generation)
+	{
+		for (int i = 0; i < SlabPool::NUM_CLASSES; ++i)
+			cache.magazines[i].count = 0;
+		cache.generation = generation;
+	}
+	return cache;
+}
+
+void * SlabAllocator::allocate(size_t size)
+{
+	int sizeclass = SlabPool::getSizeClass(size);
+	if (sizeclass < 0)
+		return 0;
+
+	Magazine & mag = getThreadCache().magazines[sizeclass];
+	if (mag.count == 0)
+	{
+		refill(sizeclass, mag);
+		if (mag.count == 0)
+			return 0;
+	}
+
+	return mag.blocks[--mag.count];
+}
+
+void SlabAllocator::release(SlabPool * pool, void * ptr)
+{
+	Magazine & mag = getThreadCache().magazines[pool->getBlockClass(ptr)];
+	if (mag.count == MAGAZINE_SIZE)
+		drain(mag, MAGAZINE_SIZE / 2);
+
+	mag.blocks[mag.count++] = ptr;
+}
+
+void SlabAllocator::refill(int sizeclass, Magazine & mag)
+{
+	uint32 want = MAGAZINE_SIZE / 2;
+	uint32 i;
+
+	SDL_LockMutex(mutex);
+
+	uint32 count = poolCount;
+	for (i = 0; i < count && mag.count < want; ++i)
+	{
+		mag.count += pools[i]->takeBlocks(sizeclass, mag.blocks + mag.count,
+										  want - mag.count);
+	}
+
+	// all pools are exhausted, so add one
+	if (mag.count < want && count < MAX_POOLS)
+	{
+		pools[count] = new SlabPool(this, slabsPerPool);
+		poolCount = count + 1;
+		mag.count += pools[count]->takeBlocks(sizeclass,
+											  mag.blocks + mag.count,
+											  want - mag.count);
+	}
+
+	SDL_UnlockMutex(mutex);
+}
+
+void SlabAllocator::drain(Magazine & mag, uint32 count)
+{
+	uint32 i;
+
+	if (count > mag.count)
+		count = mag.count;
+
+	SDL_LockMutex(mutex);
+	for (i = 0; i < count; ++i)
+	{
+		void * ptr = mag.blocks[i];
+		static_cast<SlabPool *>(findPool(ptr))->returnBlock(ptr);
+	}
+	SDL_UnlockMutex(mutex);
+
+	// keep the most recently freed blocks, they are likely still cached
+	for (i = count; i < mag.count; ++i)
+		mag.blocks[i - count] = mag.blocks[i];
+	mag.count -= count;
+}
+
+void SlabAllocator::flushThreadCache(ThreadCache & cache)
+{
+	for (int i = 0; i < SlabPool::NUM_CLASSES; ++i)
+		drain(cache.magazines[i], cache.magazines[i].count);
+}
+
+Pool * SlabAllocator::findPool(void * ptr)
+{
+	uint32 i, count = poolCount;
+	for (i = 0; i < count; ++i)
+	{
+		if (pools[i]->inPool(ptr))
+			return pools[i];
+	}
+	return 0;
+}
+
+void SlabAllocator::freeResources()
+{
+	flushThreadCache(getThreadCache());
+}
+
+size_t SlabAllocator::getUsedMemory()
+{
+	uint32 i, count = poolCount;
+	size_t used = 0;
+
+	SDL_LockMutex(mutex);
+	for (i = 0; i < count; ++i)
+	{
+		used += pools[i]->getUsedMemory();
+	}
+	SDL_UnlockMutex(mutex);
+
+	return used;
+}
+
+void SlabAllocator::printInfo()
+{
+	uint32 i, count = poolCount;
+
+	SDL_LockMutex(mutex);
+
+	pout << "Slab pools: " << count << std::endl;
+	for (i = 0; i < count; ++i)
+	{
+		pout << "  Pool " << i << ":" << std::endl;
+		pools[i]->printInfo();
+	}
+
+	SDL_UnlockMutex(mutex);
+}
@@ -0,0 +1,97 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include "Allocator.h"
+#include "SlabPool.h"
+#include <SDL3/SDL.h>
+#include "misc/sdl2_compat.h"
+
+#include <atomic>
+
+/**
+ * Size class allocator for small objects. Every thread allocates from and
+ * frees to its own magazine of blocks per size class; only refilling or
+ * draining a magazine takes the lock on the shared SlabPools.
+ * Only one SlabAllocator can exist at a time.
+ */
+class SlabAllocator: public Allocator
+{
+public:
+	SlabAllocator(uint32 slabsPerPool);
+	virtual ~SlabAllocator();
+
+	ENABLE_RUNTIME_CLASSTYPE();
+
+	virtual void * allocate(size_t size);
+
+	virtual Pool * findPool(void * ptr);
+
+	//! Returns the blocks in the calling thread's magazines to the pools
+	virtual void freeResources();
+
+	virtual size_t getCapacity() { return SlabPool::MAX_BLOCK_SIZE; }
+
+	//! \note blocks in thread magazines count as used
+	virtual size_t getUsedMemory();
+
+	void printInfo();
+
+	//! free a block of one of our pools (see SlabPool::deallocate)
+	void release(SlabPool * pool, void * ptr);
+
+	enum {
+		MAGAZINE_SIZE = 32,
+		MAX_POOLS = 16
+	};
+
+	struct Magazine {
+		uint32 count;
+		void * blocks[MAGAZINE_SIZE];
+	};
+
+	struct ThreadCache {
+		ThreadCache() : generation(0) { }
+		~ThreadCache();
+
+		uint32 generation;		//!< allocator the magazines belong to
+		Magazine magazines[SlabPool::NUM_CLASSES];
+	};
+
+private:
+	ThreadCache & getThreadCache();
+	void refill(int sizeclass, Magazine & mag);
+	//! return the oldest 'count' blocks of a magazine to the pools
+	void drain(Magazine & mag, uint32 count);
+	void flushThreadCache(ThreadCache & cache);
+
+	SDL_Mutex * mutex;
+
+	SlabPool * pools[MAX_POOLS];
+	std::atomic<uint32> poolCount;
+	uint32 slabsPerPool;
+
+	uint32 generation;
+
+	static SlabAllocator * instance;
+	static uint32 lastGeneration;
+};
+
+#endif
@@ -0,0 +1,290 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "SlabPool.h"
+#include "SlabAllocator.h"
+
+DEFINE_RUNTIME_CLASSTYPE_CODE(SlabPool,Pool);
+
+struct SlabFreeBlock
+{
+	SlabFreeBlock * next;
+};
+
+int SlabPool::getSizeClass(size_t size)
+{
+	if (size <= 256)
+		return size == 0 ? 0 : static_cast<int>((size - 1) >> 4);
+	if (size <= MAX_BLOCK_SIZE)
+		return 16 + static_cast<int>((size - 257) >> 7);
+	return -1;
+}
+
+size_t SlabPool::getClassSize(int sizeclass)
+{
+	if (sizeclass < 16)
+		return (sizeclass + 1) << 4;
+	return 256 + ((sizeclass - 15) << 7);
+}
+
+SlabPool::SlabPool(SlabAllocator * owner_, uint32 slabs_)
+	: Pool(), owner(owner_), slabcount(slabs_), bumped(0), emptyhead(-1)
+{
+	int i;
+
+	// one extra slab to be able to align the pool to SLAB_SIZE
+	memory = new uint8[(slabcount + 1) * SLAB_SIZE];
+	startOfPool = reinterpret_cast<uint8 *>(
+		(reinterpret_cast<uintptr>(memory) + SLAB_SIZE - 1) &
+		~static_cast<uintptr>(SLAB_SIZE - 1));
+	endOfPool = startOfPool + slabcount * SLAB_SIZE;
+
+	slabs = new SlabInfo[slabcount];
+
+	for (i = 0; i < NUM_CLASSES; ++i)
+	{
+		classes[i].partialhead = -1;
+		classes[i].slabs = 0;
+		classes[i].used = 0;
+		classes[i].highwater = 0;
+		classes[i].slabhighwater = 0;
+	}
+}
+
+SlabPool::~SlabPool()
+{
+	delete [] slabs;
+	delete [] memory;
+}
+
+bool SlabPool::isEmpty()
+{
+	for (int i = 0; i < NUM_CLASSES; ++i)
+	{
+		if (classes[i].used > 0)
+			return false;
+	}
+	return true;
+}
+
+sint32 SlabPool::getEmptySlab()
+{
+	sint32 index;
+
+	if (emptyhead >= 0)
+	{
+		index = emptyhead;
+		emptyhead = slabs[index].next;
+		return index;
+	}
+
+	if (bumped < slabcount)
+		return static_cast<sint32>(bumped++);
+
+	return -1;
+}
+
+void SlabPool::initSlab(sint32 index, int sizeclass)
+{
+	SlabInfo & slab = slabs[index];
+	size_t blocksize = getClassSize(sizeclass);
+	uint8 * p = startOfPool + (static_cast<size_t>(index) << SLAB_SHIFT);
+	uint32 i;
+
+	slab.sizeclass = static_cast<sint16>(sizeclass);
+	slab.used = 0;
+	slab.capacity = static_cast<uint16>(SLAB_SIZE / blocksize);
+	slab.partial = false;
+
+	// thread the free list through the blocks, in address order
+	SlabFreeBlock * block = 0;
+	for (i = slab.capacity; i > 0; --i)
+	{
+		SlabFreeBlock * b = reinterpret_cast<SlabFreeBlock *>(
+			p + (i - 1) * blocksize);
+		b->next = block;
+		block = b;
+	}
+	slab.freelist = block;
+
+	ClassInfo & ci = classes[sizeclass];
+	ci.slabs++;
+	if (ci.slabs > ci.slabhighwater)
+		ci.slabhighwater = ci.slabs;
+
+	linkPartial(index);
+}
+
+void SlabPool::linkPartial(sint32 index)
+{
+	SlabInfo & slab = slabs[index];
+	ClassInfo & ci = classes[slab.sizeclass];
+
+	slab.prev = -1;
+	slab.next = ci.partialhead;
+	if (ci.partialhead >= 0)
+		slabs[ci.partialhead].prev = index;
+	ci.partialhead = index;
+	slab.partial = true;
+}
+
+void SlabPool::unlinkPartial(sint32 index)
+{
+	SlabInfo & slab = slabs[index];
+	ClassInfo & ci = classes[slab.sizeclass];
+
+	if (slab.prev >= 0)
+		slabs[slab.prev].next = slab.next;
+	else
+		ci.partialhead = slab.next;
+	if (slab.next >= 0)
+		slabs[slab.next].prev = slab.prev;
+
+	slab.next = slab.prev = -1;
+	slab.partial = false;
+}
+
+uint32 SlabPool::takeBlocks(int sizeclass, void ** blocks, uint32 count)
+{
+	ClassInfo & ci = classes[sizeclass];
+	uint32 taken = 0;
+
+	while (taken < count)
+	{
+		sint32 index = ci.partialhead;
+		if (index < 0)
+		{
+			index = getEmptySlab();
+			if (index < 0) break;
+			initSlab(index, sizeclass);
+		}
+
+		SlabInfo & slab = slabs[index];
+		while (taken < count && slab.freelist)
+		{
+			SlabFreeBlock * b = static_cast<SlabFreeBlock *>(slab.freelist);
+			slab.freelist = b->next;
+			slab.used++;
+			blocks[taken++] = b;
+		}
+
+		if (!slab.freelist)
+			unlinkPartial(index);
+	}
+
+	ci.used += taken;
+	if (ci.used > ci.highwater)
+		ci.highwater = ci.used;
+
+	return taken;
+}
+
+void SlabPool::returnBlock(void * ptr)
+{
+	sint32 index = static_cast<sint32>(getSlabIndex(ptr));
+	SlabInfo & slab = slabs[index];
+	ClassInfo & ci = classes[slab.sizeclass];
+
+	SlabFreeBlock * b = static_cast<SlabFreeBlock *>(ptr);
+	b->next = static_cast<SlabFreeBlock *>(slab.freelist);
+	slab.freelist = b;
+	slab.used--;
+	ci.used--;
+
+	if (slab.used == 0)
+	{
+		// hand the slab back for use by any size class
+		if (slab.partial)
+			unlinkPartial(index);
+		ci.slabs--;
+		slab.sizeclass = -1;
+		slab.next = emptyhead;
+		emptyhead = index;
+	}
+	else if (!slab.partial)
+	{
+		linkPartial(index);
+	}
+}
+
+void * SlabPool::allocate(size_t size)
+{
+	int sizeclass = getSizeClass(size);
+	void * block;
+
+	if (sizeclass < 0 || takeBlocks(sizeclass, &block, 1) == 0)
+		return 0;
+
+	return block;
+}
+
+void SlabPool::deallocate(void * ptr)
+{
+	if (inPool(ptr))
+		owner->release(this, ptr);
+}
+
+size_t SlabPool::getUsedMemory() const
+{
+	size_t used = 0;
+	for (int i = 0; i < NUM_CLASSES; ++i)
+		used += classes[i].used * getClassSize(i);
+	return used;
+}
+
+void SlabPool::printInfo()
+{
+	int i;
+	uint32 usedslabs = 0;
+	size_t usedmem = 0, slabmem = 0;
+
+	con.Printf("   start address 0x%X\tend address 0x%X\n",
+			startOfPool, endOfPool);
+	con.Printf("   slabs %d\tslab size %d b\tever used %d\n",
+			slabcount, SLAB_SIZE, bumped);
+	con.Printf("   class    size   slabs  (max)    blocks used  (max)   free%%\n");
+
+	for (i = 0; i < NUM_CLASSES; ++i)
+	{
+		ClassInfo & ci = classes[i];
+		if (ci.slabhighwater == 0) continue;
+
+		size_t blocksize = getClassSize(i);
+		uint32 capacity = ci.slabs * static_cast<uint32>(SLAB_SIZE / blocksize);
+		uint32 freepct = capacity ? (100 * (capacity - ci.used)) / capacity : 0;
+
+		con.Printf("   %5d  %6d  %6d %6d  %8d %6d %6d   %3d\n",
+				i, blocksize, ci.slabs, ci.slabhighwater, capacity, ci.used,
+				ci.highwater, freepct);
+
+		usedslabs += ci.slabs;
+		usedmem += ci.used * blocksize;
+		slabmem += ci.slabs * static_cast<size_t>(SLAB_SIZE);
+	}
+
+	// blocks held in thread magazines count as used here
+	con.Printf("   slabs in use %d\tmemory in slabs %d b\tused %d b\n",
+			usedslabs, slabmem, usedmem);
+	if (slabmem > 0)
+	{
+		con.Printf("   fragmentation %d%%\n",
+				static_cast<int>(100 - (100 * usedmem) / slabmem));
+	}
+}
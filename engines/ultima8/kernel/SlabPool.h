@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include "Pool.h"
+
+class SlabAllocator;
+
+/**
+ * A pool made of fixed size slabs. Every slab holds blocks of one size
+ * class; a slab that becomes empty can be reused for any size class.
+ * Blocks are handed out in batches to the per-thread magazines of the
+ * owning SlabAllocator. Except for deallocate(), the methods must be
+ * called with the allocator's lock held.
+ */
+class SlabPool: public Pool
+{
+public:
+	SlabPool(SlabAllocator * owner, uint32 slabs);
+	virtual ~SlabPool();
+
+	ENABLE_RUNTIME_CLASSTYPE();
+
+	enum {
+		SLAB_SHIFT = 16,
+		SLAB_SIZE = 1 << SLAB_SHIFT,
+
+		//! size classes: 16 byte steps up to 256, 128 byte steps to 1024
+		NUM_CLASSES = 16 + 6,
+		MAX_BLOCK_SIZE = 1024
+	};
+
+	//! get the size class for an allocation, or -1 if it is too large
+	static int getSizeClass(size_t size);
+	static size_t getClassSize(int sizeclass);
+
+	//! allocate one block of the right size class
+	virtual void * allocate(size_t size);
+	//! return a block to the owning allocator's magazine
+	virtual void deallocate(void * ptr);
+
+	//! take up to count blocks of a size class
+	//! \return the number of blocks taken
+	uint32 takeBlocks(int sizeclass, void ** blocks, uint32 count);
+	//! put a block that was taken back into its slab
+	void returnBlock(void * ptr);
+
+	//! get the size class of a block in this pool
+	int getBlockClass(void * ptr) const
+		{ return slabs[getSlabIndex(ptr)].sizeclass; }
+
+	virtual bool isFull() { return emptyhead < 0 && bumped == slabcount; }
+	virtual bool isEmpty();
+
+	virtual bool inPool(void * ptr)
+		{ return (ptr >= startOfPool && ptr < endOfPool); }
+
+	//! get the memory taken by blocks given out
+	size_t getUsedMemory() const;
+
+	void printInfo();
+
+private:
+	struct SlabInfo {
+		sint16 sizeclass;		// -1 if the slab is unused
+		uint16 used;			// blocks taken from this slab
+		uint16 capacity;
+		void * freelist;
+		sint32 next, prev;		// partial or empty slab list links
+		bool partial;
+	};
+
+	struct ClassInfo {
+		sint32 partialhead;		// slabs with free blocks
+		uint32 slabs;
+		uint32 used;
+		uint32 highwater;		// most blocks used at once
+		uint32 slabhighwater;
+	};
+
+	uint32 getSlabIndex(void * ptr) const {
+		return static_cast<uint32>((reinterpret_cast<uint8 *>(ptr) -
+									startOfPool) >> SLAB_SHIFT);
+	}
+
+	sint32 getEmptySlab();
+	void initSlab(sint32 index, int sizeclass);
+	void linkPartial(sint32 index);
+	void unlinkPartial(sint32 index);
+
+	SlabAllocator * owner;
+
+	uint8 * memory;
+	uint8 * startOfPool;		// memory, aligned to SLAB_SIZE
+	uint8 * endOfPool;
+
+	SlabInfo * slabs;
+	uint32 slabcount;
+	uint32 bumped;				// slabs that have been used at least once
+	sint32 emptyhead;			// slabs that became empty again
+
+	ClassInfo classes[NUM_CLASSES];
+};
+
+#endif
@@ -0,0 +1,55 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "WorkerPool.h"
+#include "jobs/Job_system.h"
+
+#include <atomic>
+
+WorkerPool::WorkerPool(unsigned int nthreads)
+	: threads(nthreads)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+}
+
+void WorkerPool::run(JobFunc func, void* data, unsigned int count)
+{
+	if (count == 0) return;
+
+	if (threads == 0) {
+		for (unsigned int i = 0; i < count; ++i)
+			func(data, i);
+		return;
+	}
+
+	// The job system gives each job index a thread of its own, up to all
+	// of its threads. So run one job per thread we may use, each of them
+	// taking the next index until there are none left.
+	unsigned int lanes = count < threads + 1 ? count : threads + 1;
+	std::atomic<unsigned int> next(0);
+	Job_system::get().run("WorkerPool", lanes, [func, data, count,
+												&next](size_t) {
+		for (unsigned int i = next++; i < count; i = next++)
+			func(data, i);
+	});
+}
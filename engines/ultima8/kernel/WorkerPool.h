@@ -0,0 +1,51 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+//
+// WorkerPool. Runs batches of jobs on the job system shared with Exult and
+// the NPC library, on at most the given number of threads besides the
+// calling one (fewer if the job system has fewer).
+//
+// run() hands out the job indices 0..count-1 to that many of the job
+// system's threads, the calling one included, and returns once all of
+// them have finished. The pool never changes the job system's thread
+// count: that is shared with everything else running tasks.
+//
+
+class WorkerPool
+{
+public:
+	typedef void (*JobFunc)(void* data, unsigned int index);
+
+	//! use up to this many threads besides the calling one
+	explicit WorkerPool(unsigned int threads);
+	~WorkerPool();
+
+	unsigned int getThreadCount() const { return threads; }
+
+	//! call func(data, i) for every i in [0,count) and wait for all of them
+	void run(JobFunc func, void* data, unsigned int count);
+
+private:
+	unsigned int threads;
+};
+
+#endif
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "RenderSurface.h"
 #include "util.h"
 #include "FixedWidthFont.h"
+#include "profiler/Async_log.h"
 
 #include <cstdio>
 #include <cstring>
@@ -37,6 +38,14 @@ using namespace std;
 // The console
 Console		con;
 
+// stdout and stderr are written by the log's thread, so printing doesn't
+// wait on the terminal or the log files
+static inline std::streambuf *StdStream(uint32 mask)
+{
+	return Async_log::get().get_streambuf(
+		mask == CON_STDERR ? Async_log::Err : Async_log::Out);
+}
+
 
 
 // Standard Output Stream Object
@@ -400,7 +409,8 @@ void Console::PrintPutchar()
 // Print a text string to the console, and output to stdout
 void Console::Print(const char *txt)
 {
-	if (std_output_enabled & CON_STDOUT) fputs(txt, stdout);
+	if (std_output_enabled & CON_STDOUT)
+		StdStream(CON_STDOUT)->sputn(txt, std::strlen(txt));
 	if (stdout_redir) stdout_redir->write(txt, std::strlen(txt));
 	PrintInternal(txt);
 }
@@ -442,13 +452,9 @@ sint32 Console::vPrintf (const char *fmt, va_list argptr)
 {
 	char msg[MAXPRINTMSG];
 
-	if (std_output_enabled & CON_STDOUT) {
-		va_list argptr2;
-		va_copy(argptr2, argptr);
-		vfprintf (stdout, fmt, argptr2);
-		va_end(argptr2);
-	}
 	sint32 count = vsnprintf (msg, MAXPRINTMSG, fmt, argptr);
+	if ((std_output_enabled & CON_STDOUT) && count > 0)
+		StdStream(CON_STDOUT)->sputn(msg, std::strlen(msg));
 	if (stdout_redir) stdout_redir->write(msg, count);
 	PrintInternal(msg);
 
@@ -458,7 +464,7 @@ sint32 Console::vPrintf (const char *fmt, va_list argptr)
 // Print a text string to the console, and output to stdout
 void Console::PrintRaw (const char *txt, int n)
 {
-	if (std_output_enabled & CON_STDOUT) std::fwrite(txt, n, 1, stdout);
+	if (std_output_enabled & CON_STDOUT) StdStream(CON_STDOUT)->sputn(txt, n);
 	if (stdout_redir) stdout_redir->write(txt, n);
 	PrintRawInternal (txt, n);
 }
@@ -466,7 +472,7 @@ void Console::PrintRaw (const char *txt, int n)
 // putchar, and output to stdout
 void Console::Putchar (int c)
 {
-	if (std_output_enabled & CON_STDOUT) fputc(c, stdout);
+	if (std_output_enabled & CON_STDOUT) StdStream(CON_STDOUT)->sputc(c);
 	if (stdout_redir) stdout_redir->write1(c);
 	PutcharInternal(c);
 }
@@ -479,7 +485,8 @@ void Console::Putchar (int c)
 // Print a text string to the console, and output to stderr
 void Console::Print_err (const char *txt)
 {
-	if (std_output_enabled & CON_STDERR) fputs(txt, stderr);
+	if (std_output_enabled & CON_STDERR)
+		StdStream(CON_STDERR)->sputn(txt, std::strlen(txt));
 	if (stderr_redir) stderr_redir->write(txt, std::strlen(txt));
 	PrintInternal (txt);
 }
@@ -521,13 +528,9 @@ sint32 Console::vPrintf_err (const char *fmt, va_list argptr)
 {
 	char msg[MAXPRINTMSG];
 
-	if (std_output_enabled & CON_STDERR) {
-		va_list argptr2;
-		va_copy(argptr2, argptr);
-		vfprintf (stderr, fmt, argptr2);
-		va_end(argptr2);
-	}
 	sint32 count = vsnprintf (msg, MAXPRINTMSG, fmt, argptr);
+	if ((std_output_enabled & CON_STDERR) && count > 0)
+		StdStream(CON_STDERR)->sputn(msg, std::strlen(msg));
 	if (stderr_redir) stderr_redir->write(msg, count);
 	PrintInternal (msg);
 
@@ -537,7 +540,7 @@ sint32 Console::vPrintf_err (const char *fmt, va_list argptr)
 // Print a text string to the console, and output to stderr
 void Console::PrintRaw_err (const char *txt, int n)
 {
-	if (std_output_enabled & CON_STDERR) std::fwrite(txt,n,1,stderr);
+	if (std_output_enabled & CON_STDERR) StdStream(CON_STDERR)->sputn(txt, n);
 	if (stderr_redir) stderr_redir->write(txt, n);
 	PrintRawInternal (txt, n);
 }
@@ -545,11 +548,18 @@ void Console::PrintRaw_err (const char *txt, int n)
 // putchar, and output to stderr
 void Console::Putchar_err (int c)
 {
-	if (std_output_enabled & CON_STDERR) fputc(c, stderr);
+	if (std_output_enabled & CON_STDERR) StdStream(CON_STDERR)->sputc(c);
 	if (stderr_redir) stderr_redir->write1(c);
 	PutcharInternal(c);
 }
 
+// Queue what has been put to stdout and stderr without an end of line
+void Console::FlushStd()
+{
+	StdStream(CON_STDOUT)->pubsync();
+	StdStream(CON_STDERR)->pubsync();
+}
+
 void Console::ScrollConsole(sint32 lines)
 {
 	display += lines;
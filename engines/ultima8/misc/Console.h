@@ -233,6 +233,9 @@ public:
 	// Print a text string to the console, and output to stderr
 	void	PrintRaw_err (const char *txt, int n);
 
+	// Queue what has been put to stdout and stderr without an end of line
+	void	FlushStd();
+
 
 	// Enable/Disable word wrapping
 	void	EnableWordWrap() { wordwrap = true; }
@@ -357,6 +360,7 @@ protected:
 	// Flush
 	virtual int sync()
 	{
+		con.FlushStd();
 		return 0;
 	}
 };
@@ -426,6 +430,7 @@ protected:
 	// Flush
 	virtual int sync()
 	{
+		con.FlushStd();
 		return 0;
 	}
 };
@@ -83,6 +83,11 @@ typedef signed EX_TYPE_INTPTR sintptr;
 //! 16-Bit ID of an Object
 typedef uint16 ObjId;
 
+//! A generation-checked reference to an object: (generation << 16) | objid.
+//! Unlike a plain ObjId, a handle never refers to a different object after
+//! its object is destroyed and the objid is reused. 0 is never valid.
+typedef uint32 ObjHandle;
+
 //! 16-Bit ID of a Process
 typedef uint16 ProcId;
 
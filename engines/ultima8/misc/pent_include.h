@@ -79,10 +79,13 @@ extern const std::string c_empty_string;
 #include "Errors.h"
 
 //
-// SDL3 with SDL2 compatibility layer
+// SDL3 with SDL2 compatibility layer. The unit tests (see tests/unit)
+// build the engine code they check without it.
 //
+#ifndef PENTAGRAM_NO_SDL
 #include <SDL3/SDL.h>
 #include "sdl2_compat.h"
+#endif
 
 
 //
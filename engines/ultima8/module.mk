@@ -8,6 +8,7 @@ LGUIPRODUCTS := pentagram
 
 pentagram_OBJ = \
 	$(KERNEL) \
+	$(JOBS) \
 	$(USECODE) \
 	$(FILESYS) \
 	$(GAMES) \
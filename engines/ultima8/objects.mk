@@ -11,9 +11,19 @@ KERNEL = \
 	kernel/Object.o \
 	kernel/ObjectManager.o \
 	kernel/Process.o \
+	kernel/ProcessProfiler.o \
+	kernel/ProcessQueue.o \
 	kernel/Pool.o \
 	kernel/SegmentedAllocator.o \
-	kernel/SegmentedPool.o
+	kernel/SegmentedPool.o \
+	kernel/SlabAllocator.o \
+	kernel/SlabPool.o \
+	kernel/WorkerPool.o
+
+# the job system and frame profiler, shared with Exult and the NPC library
+JOBS = \
+	../../shared/jobs/Job_system.o \
+	../../shared/profiler/Frame_profiler.o
 
 USECODE = \
 	usecode/BitSet.o \
@@ -22,6 +32,8 @@ USECODE = \
 	usecode/Usecode.o \
 	usecode/UsecodeFlex.o \
 	usecode/UCList.o \
+	usecode/UCCode.o \
+	usecode/UCProfiler.o \
 	usecode/UCStack.o
 
 COMPILE = \
@@ -37,11 +49,13 @@ FILESYS = \
 	filesys/ArchiveFile.o \
 	filesys/DirFile.o \
 	filesys/FileSystem.o \
+	filesys/MappedDataSource.o \
 	filesys/FlexFile.o \
 	filesys/RawArchive.o \
 	filesys/U8SaveFile.o \
 	filesys/Savegame.o \
 	filesys/SavegameWriter.o \
+	filesys/BackgroundSavegameWriter.o \
 	filesys/ZipFile.o \
 	filesys/data.o \
 	filesys/zip/unzip.o \
@@ -84,6 +98,8 @@ GRAPHICS = \
 	graphics/TexturePNG.o \
 	graphics/Shape.o \
 	graphics/ShapeFrame.o \
+	graphics/ShapeFrameCache.o \
+	graphics/SpanBlit.o \
 	graphics/SKFPlayer.o \
 	graphics/Palette.o \
 	graphics/PaletteManager.o \
@@ -146,6 +162,7 @@ MISC = \
 	misc/encoding.o \
 	misc/istring.o \
 	misc/Console.o \
+	../../shared/profiler/Async_log.o \
 	misc/idMan.o \
 	misc/md5.o \
 	misc/pent_include.o \
@@ -200,6 +217,7 @@ WIDGETS = \
 
 WORLD = \
 	world/CameraProcess.o \
+	world/CompiledLoopScript.o \
 	world/Container.o \
 	world/CreateItemProcess.o \
 	world/CurrentMap.o \
@@ -213,7 +231,9 @@ WORLD = \
 	world/Item.o \
 	world/ItemFactory.o \
 	world/ItemSorter.o \
+	world/LocationFilter.o \
 	world/Map.o \
+	world/MapPrefetcher.o \
 	world/MissileProcess.o \
 	world/MissileTracker.o \
 	world/MonsterEgg.o \
@@ -236,6 +256,7 @@ ACTORS = \
 	world/actors/AvatarMoverProcess.o \
 	world/actors/ClearFeignDeathProcess.o \
 	world/actors/CombatProcess.o \
+	world/actors/FlowField.o \
 	world/actors/GrantPeaceProcess.o \
 	world/actors/HealProcess.o \
 	world/actors/LoiterProcess.o \
@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2026 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// Stubs for what ItemSorter links against but doesn't use when it only
+// sorts items added without a shape (see test_item_sorter.cpp)
+//
+
+#include "pent_include.h"
+
+#include "GameData.h"
+#include "MainShapeArchive.h"
+#include "Shape.h"
+#include "ShapeFrame.h"
+#include "ShapeFrameCache.h"
+#include "RenderSurface.h"
+#include "MainActor.h"
+#include "getObject.h"
+#include "WorkerPool.h"
+
+console_ostream<char>		*ppout = 0;
+console_err_ostream<char>	*pperr = 0;
+
+GameData* GameData::gamedata = 0;
+
+Shape* ShapeArchive::getShape(uint32)
+{
+	return 0;
+}
+
+ShapeInfo* MainShapeArchive::getShapeInfo(uint32)
+{
+	return 0;
+}
+
+ShapeFrame* Shape::getFrame(unsigned int)
+{
+	return 0;
+}
+
+bool ShapeFrame::hasPoint(sint32, sint32) const
+{
+	return false;
+}
+
+bool ShapeFrameCache::frozen = false;
+
+const CachedFrame* ShapeFrameCache::get(ShapeFrame*, const Pentagram::Palette*,
+										bool)
+{
+	return 0;
+}
+
+RenderSurface::~RenderSurface()
+{
+}
+
+Shape* Item::getShapeObject() const
+{
+	return 0;
+}
+
+MainActor* getMainActor()
+{
+	return 0;
+}
+
+void MainActor::getWeaponOverlay(const WeaponOverlayFrame*& frame,
+								 uint32& shape)
+{
+	frame = 0;
+	shape = 0;
+}
+
+WorkerPool::WorkerPool(unsigned int threads_) : threads(threads_)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+}
+
+void WorkerPool::run(JobFunc func, void* data, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+		func(data, i);
+}
@@ -0,0 +1,130 @@
+/*
+Copyright (C) 2026 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// A minimal unit test framework, the same as the one of the gneural-net
+// tests. A test is a function returning 0 if it passed.
+//
+
+#ifndef TEST_FRAMEWORK_H
+#define TEST_FRAMEWORK_H
+
+#include <cstdio>
+
+// defined in test_runner.cpp
+extern int tests_run;
+extern int tests_passed;
+extern int tests_failed;
+extern const char *current_test_name;
+
+#define COLOR_RED		"\x1b[31m"
+#define COLOR_GREEN		"\x1b[32m"
+#define COLOR_YELLOW	"\x1b[33m"
+#define COLOR_RESET		"\x1b[0m"
+
+#define TEST_ASSERT(condition) do { \
+	if (!(condition)) { \
+		std::printf(COLOR_RED "  FAIL: %s:%d: Assertion failed: %s" \
+					COLOR_RESET "\n", __FILE__, __LINE__, #condition); \
+		return 1; \
+	} \
+} while (0)
+
+#define TEST_ASSERT_MSG(condition, msg) do { \
+	if (!(condition)) { \
+		std::printf(COLOR_RED "  FAIL: %s:%d: %s" COLOR_RESET "\n", \
+					__FILE__, __LINE__, msg); \
+		return 1; \
+	} \
+} while (0)
+
+#define TEST_ASSERT_EQUAL(expected, actual) do { \
+	if ((expected) != (actual)) { \
+		std::printf(COLOR_RED "  FAIL: %s:%d: Expected %ld, got %ld" \
+					COLOR_RESET "\n", __FILE__, __LINE__, \
+					static_cast<long>(expected), static_cast<long>(actual)); \
+		return 1; \
+	} \
+} while (0)
+
+#define TEST_ASSERT_TRUE(condition) TEST_ASSERT(condition)
+#define TEST_ASSERT_FALSE(condition) TEST_ASSERT(!(condition))
+
+#define RUN_TEST(test_func) do { \
+	current_test_name = #test_func; \
+	std::printf("  Running %s...", #test_func); \
+	std::fflush(stdout); \
+	tests_run++; \
+	if (test_func() == 0) { \
+		std::printf(COLOR_GREEN " PASS" COLOR_RESET "\n"); \
+		tests_passed++; \
+	} else { \
+		tests_failed++; \
+	} \
+} while (0)
+
+#define TEST_SUITE_BEGIN(name) do { \
+	std::printf("\n" COLOR_YELLOW "=== Test Suite: %s ===" COLOR_RESET "\n", \
+				name); \
+} while (0)
+
+#define TEST_SUITE_END() do { \
+	std::printf("\n"); \
+} while (0)
+
+#define PRINT_TEST_RESULTS() do { \
+	std::printf("\n" COLOR_YELLOW "==============================" \
+				COLOR_RESET "\n"); \
+	std::printf("Tests run: %d\n", tests_run); \
+	std::printf(COLOR_GREEN "Passed: %d" COLOR_RESET "\n", tests_passed); \
+	if (tests_failed > 0) \
+		std::printf(COLOR_RED "Failed: %d" COLOR_RESET "\n", tests_failed); \
+	else \
+		std::printf("Failed: 0\n"); \
+	std::printf(COLOR_YELLOW "==============================" \
+				COLOR_RESET "\n"); \
+} while (0)
+
+//! 0 if all tests passed, 1 otherwise
+#define TEST_RESULT() (tests_failed > 0 ? 1 : 0)
+
+//! A small deterministic random number generator, so every run checks the
+//! same cases
+class TestRandom
+{
+	uint32 state;
+public:
+	explicit TestRandom(uint32 seed) : state(seed ? seed : 1) { }
+
+	uint32 next() {
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	//! a number in [lo,hi]
+	sint32 range(sint32 lo, sint32 hi) {
+		uint32 span = static_cast<uint32>(hi) - static_cast<uint32>(lo);
+		uint32 r = (span == 0xFFFFFFFFU) ? next() : next() % (span + 1);
+		return static_cast<sint32>(static_cast<uint32>(lo) + r);
+	}
+};
+
+#endif
@@ -0,0 +1,277 @@
+/*
+Copyright (C) 2026 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// Checks that ItemSorter sorts the same with the screen bins as when every
+// new item is compared with the whole list: the same list, the same
+// dependencies in the same order, and the same painting order.
+//
+
+#include "pent_include.h"
+#include "test_framework.h"
+
+#include "ItemSorter.h"
+#include "Item.h"
+#include "ShapeInfo.h"
+#include "RenderSurface.h"
+#include "Rect.h"
+
+#include <vector>
+
+namespace {
+
+//! A surface that nothing is painted on. Everything is inside its
+//! clipping rect.
+class NullRenderSurface : public RenderSurface
+{
+public:
+	NullRenderSurface() { }
+
+	ECode BeginPainting() override { return ECode(); }
+	ECode EndPainting() override { return ECode(); }
+	Texture *GetSurfaceAsTexture() override { return 0; }
+	RenderSurface *CreateView() override { return 0; }
+	void SetOrigin(sint32, sint32) override { }
+	void GetOrigin(sint32 &x, sint32 &y) const override { x = y = 0; }
+	void GetSurfaceDims(Pentagram::Rect &r) const override
+		{ r.Set(0, 0, 640, 480); }
+	void GetClippingRect(Pentagram::Rect &r) const override
+		{ r.Set(0, 0, 640, 480); }
+	void SetClippingRect(const Pentagram::Rect &) override { }
+	sint16 CheckClipped(const Pentagram::Rect &) const override { return 0; }
+	void SetFlipped(bool) override { }
+	bool IsFlipped() const override { return false; }
+	void CreateNativePalette(Pentagram::Palette*) override { }
+	void Fill8(uint8, sint32, sint32, sint32, sint32) override { }
+	void Fill32(uint32, sint32, sint32, sint32, sint32) override { }
+	void FillAlpha(uint8, sint32, sint32, sint32, sint32) override { }
+	void FillBlended(uint32, sint32, sint32, sint32, sint32) override { }
+	void Paint(Shape*, uint32, sint32, sint32, bool) override { }
+	void PaintNoClip(Shape*, uint32, sint32, sint32, bool) override { }
+	void PaintTranslucent(Shape*, uint32, sint32, sint32, bool) override { }
+	void PaintMirrored(Shape*, uint32, sint32, sint32, bool, bool) override { }
+	void PaintInvisible(Shape*, uint32, sint32, sint32, bool, bool,
+						bool) override { }
+	void PaintHighlight(Shape*, uint32, sint32, sint32, bool, bool, uint32,
+						bool) override { }
+	void PaintHighlightInvis(Shape*, uint32, sint32, sint32, bool, bool,
+							 uint32, bool) override { }
+	void PaintMasked(Shape*, uint32, sint32, sint32, bool, bool, uint32,
+					 bool) override { }
+	void DrawLine32(uint32, sint32, sint32, sint32, sint32) override { }
+	void PrintTextFixed(FixedWidthFont *, const char *, int, int) override { }
+	void PrintCharFixed(FixedWidthFont *, int, int, int) override { }
+	void Blit(Texture *, sint32, sint32, sint32, sint32, sint32, sint32,
+			  bool) override { }
+	void FadedBlit(Texture *, sint32, sint32, sint32, sint32, sint32, sint32,
+				   uint32, bool) override { }
+	void MaskedBlit(Texture *, sint32, sint32, sint32, sint32, sint32, sint32,
+					uint32, bool) override { }
+	void StretchBlit(Texture *, sint32, sint32, sint32, sint32, sint32,
+					 sint32, sint32, sint32, bool, bool) override { }
+	bool ScalerBlit(Texture *, sint32, sint32, sint32, sint32, sint32,
+					sint32, sint32, sint32, const Pentagram::Scaler *,
+					bool) override { return false; }
+};
+
+struct SceneItem {
+	sint32 x, y, z;
+	uint32 flags, ext_flags;
+	sint32 xoff, yoff, width, height;
+};
+
+struct Scene {
+	sint32 camx, camy, camz;
+	std::vector<SceneItem> items;
+	std::vector<ShapeInfo> infos;	// one per item
+};
+
+struct SortOrder {
+	std::vector<uint16> list;
+	std::vector< std::vector<uint16> > depends;
+	std::vector<uint16> paint;
+};
+
+// A scene like a part of a map: items on a 32 unit grid (so many of them
+// line up or touch), standing on the ground or stacked, of all sizes
+void makeScene(TestRandom& rnd, unsigned int count, Scene& scene)
+{
+	scene.camx = rnd.range(-2048, 65536);
+	scene.camy = rnd.range(-2048, 65536);
+	scene.camz = rnd.range(0, 255);
+	scene.items.resize(count);
+	scene.infos.clear();
+	scene.infos.resize(count);
+
+	static const uint32 shapeflags[] = {
+		0, ShapeInfo::SI_SOLID, ShapeInfo::SI_OCCL,
+		ShapeInfo::SI_OCCL | ShapeInfo::SI_SOLID,
+		ShapeInfo::SI_FIXED | ShapeInfo::SI_LAND, ShapeInfo::SI_ROOF,
+		ShapeInfo::SI_DRAW, ShapeInfo::SI_TRANSL
+	};
+	const int nshapeflags = sizeof(shapeflags) / sizeof(shapeflags[0]);
+
+	for (unsigned int i = 0; i < count; ++i) {
+		ShapeInfo& info = scene.infos[i];
+		info.flags = shapeflags[rnd.range(0, nshapeflags - 1)];
+		info.x = rnd.range(0, 8);
+		info.y = rnd.range(0, 8);
+		info.z = rnd.range(0, 4) * rnd.range(0, 10);
+		info.animtype = rnd.range(0, 3) == 0;
+
+		SceneItem& si = scene.items[i];
+		si.x = scene.camx + 32 * rnd.range(-24, 24);
+		si.y = scene.camy + 32 * rnd.range(-24, 24);
+		si.z = 8 * rnd.range(0, 2) * rnd.range(0, 8);
+		si.flags = 0;
+		if (rnd.range(0, 3) == 0) si.flags |= Item::FLG_FLIPPED;
+		if (rnd.range(0, 15) == 0) si.flags |= Item::FLG_INVISIBLE;
+		si.ext_flags = 0;
+		if (rnd.range(0, 15) == 0) si.ext_flags |= Item::EXT_TRANSPARENT;
+
+		// the frame roughly covers the bounding box
+		si.xoff = (info.y * 32) / 4 + rnd.range(0, 4);
+		si.yoff = (info.x * 32 + info.y * 32) / 8 + info.z * 8 +
+			rnd.range(0, 4);
+		si.width = (info.x * 32 + info.y * 32) / 4 + rnd.range(1, 8);
+		si.height = si.yoff + rnd.range(1, 8);
+	}
+}
+
+void sortScene(const Scene& scene, bool binned, SortOrder& order)
+{
+	NullRenderSurface surf;
+	ItemSorter sorter;
+
+	bool old_binning = ItemSorter::IsBinning();
+	ItemSorter::SetBinning(binned);
+	sorter.BeginDisplayList(&surf, scene.camx, scene.camy, scene.camz);
+	ItemSorter::SetBinning(old_binning);
+
+	for (unsigned int i = 0; i < scene.items.size(); ++i) {
+		const SceneItem& si = scene.items[i];
+		sorter.AddItem(si.x, si.y, si.z, &scene.infos[i], si.xoff, si.yoff,
+					   si.width, si.height, si.flags, si.ext_flags,
+					   static_cast<uint16>(i + 1));
+	}
+
+	sorter.GetSortOrder(order.list, order.depends, order.paint);
+}
+
+int compareOrders(const SortOrder& expected, const SortOrder& actual)
+{
+	TEST_ASSERT_EQUAL(expected.list.size(), actual.list.size());
+	for (unsigned int i = 0; i < expected.list.size(); ++i)
+		TEST_ASSERT_EQUAL(expected.list[i], actual.list[i]);
+
+	TEST_ASSERT_EQUAL(expected.depends.size(), actual.depends.size());
+	for (unsigned int i = 0; i < expected.depends.size(); ++i) {
+		const std::vector<uint16>& e = expected.depends[i];
+		const std::vector<uint16>& a = actual.depends[i];
+		TEST_ASSERT_EQUAL(e.size(), a.size());
+		for (unsigned int j = 0; j < e.size(); ++j)
+			TEST_ASSERT_EQUAL(e[j], a[j]);
+	}
+
+	TEST_ASSERT_EQUAL(expected.paint.size(), actual.paint.size());
+	for (unsigned int i = 0; i < expected.paint.size(); ++i)
+		TEST_ASSERT_EQUAL(expected.paint[i], actual.paint[i]);
+	return 0;
+}
+
+int test_sorter_known_order()
+{
+	// a box standing on a floor tile, added before the tile
+	Scene scene;
+	scene.camx = scene.camy = 1024;
+	scene.camz = 0;
+	scene.items.resize(2);
+	scene.infos.resize(2);
+
+	scene.infos[0].x = scene.infos[0].y = 2;
+	scene.infos[0].z = 2;
+	scene.infos[0].flags = ShapeInfo::SI_SOLID;
+	SceneItem box = { 1024, 1024, 0, 0, 0, 16, 32, 32, 40 };
+	scene.items[0] = box;
+
+	scene.infos[1].x = scene.infos[1].y = 4;
+	scene.infos[1].z = 0;
+	scene.infos[1].flags = ShapeInfo::SI_FIXED | ShapeInfo::SI_LAND;
+	SceneItem tile = { 1088, 1088, 0, 0, 0, 32, 32, 64, 32 };
+	scene.items[1] = tile;
+
+	SortOrder binned, allpairs;
+	sortScene(scene, true, binned);
+	sortScene(scene, false, allpairs);
+
+	TEST_ASSERT_EQUAL(2, binned.paint.size());
+	TEST_ASSERT_EQUAL(2, binned.paint[0]);
+	TEST_ASSERT_EQUAL(1, binned.paint[1]);
+	return compareOrders(allpairs, binned);
+}
+
+int test_sorter_random_scenes()
+{
+	TestRandom rnd(21);
+	for (int q = 0; q < 300; ++q) {
+		Scene scene;
+		makeScene(rnd, rnd.range(1, 250), scene);
+
+		SortOrder binned, allpairs;
+		sortScene(scene, false, allpairs);
+		sortScene(scene, true, binned);
+		if (compareOrders(allpairs, binned)) return 1;
+	}
+	return 0;
+}
+
+int test_sorter_crowded_scenes()
+{
+	// Many items on few spots, so there are lots of ties and occlusions,
+	// and items spanning many bins
+	TestRandom rnd(42);
+	for (int q = 0; q < 100; ++q) {
+		Scene scene;
+		makeScene(rnd, rnd.range(100, 400), scene);
+		for (unsigned int i = 0; i < scene.items.size(); ++i) {
+			scene.items[i].x = scene.camx + 128 * rnd.range(-2, 2);
+			scene.items[i].y = scene.camy + 128 * rnd.range(-2, 2);
+			if (rnd.range(0, 7) == 0) {
+				scene.infos[i].x = rnd.range(16, 31);
+				scene.infos[i].y = rnd.range(16, 31);
+			}
+		}
+
+		SortOrder binned, allpairs;
+		sortScene(scene, false, allpairs);
+		sortScene(scene, true, binned);
+		if (compareOrders(allpairs, binned)) return 1;
+	}
+	return 0;
+}
+
+}
+
+void run_item_sorter_tests()
+{
+	TEST_SUITE_BEGIN("ItemSorter");
+	RUN_TEST(test_sorter_known_order);
+	RUN_TEST(test_sorter_random_scenes);
+	RUN_TEST(test_sorter_crowded_scenes);
+	TEST_SUITE_END();
+}
@@ -0,0 +1,218 @@
+/*
+Copyright (C) 2026 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// Checks that filterLocations (SSE2, NEON or scalar, whichever was built)
+// finds exactly what filterLocations_scalar finds.
+//
+
+#include "pent_include.h"
+#include "test_framework.h"
+
+#include "LocationFilter.h"
+
+#include <climits>
+#include <vector>
+
+namespace {
+
+// CurrentMap's findItems filters a cell in batches of at most this many
+const unsigned int BATCH = 64;
+
+// the sizes of a map as CurrentMap sees it
+const sint32 MAP_SIZE = 512 * 128;
+const sint32 MAX_FOOTPAD = 32 * 32;
+const sint32 MAX_HEIGHT = 8 * 255;
+
+struct Locations {
+	std::vector<sint32> x, y, z;
+
+	void add(sint32 x_, sint32 y_, sint32 z_) {
+		x.push_back(x_);
+		y.push_back(y_);
+		z.push_back(z_);
+	}
+	unsigned int size() const { return static_cast<unsigned int>(x.size()); }
+};
+
+// Filter the locations with both versions, batch by batch like findItems
+int compareFilters(const Locations& locs, const sint32 lo[3],
+				   const sint32 hi[3])
+{
+	for (unsigned int base = 0; base < locs.size(); base += BATCH) {
+		unsigned int n = locs.size() - base;
+		if (n > BATCH) n = BATCH;
+
+		uint32 expected[BATCH], actual[BATCH];
+		unsigned int ecount = Pentagram::filterLocations_scalar(
+			&locs.x[base], &locs.y[base], &locs.z[base], n, lo, hi, expected);
+		unsigned int acount = Pentagram::filterLocations(
+			&locs.x[base], &locs.y[base], &locs.z[base], n, lo, hi, actual);
+
+		TEST_ASSERT_EQUAL(ecount, acount);
+		for (unsigned int i = 0; i < ecount; ++i)
+			TEST_ASSERT_EQUAL(expected[i], actual[i]);
+	}
+	return 0;
+}
+
+// Items of a cell of the spatial index: near each other, on the ground
+// or stacked
+void makeCell(TestRandom& rnd, unsigned int n, Locations& locs)
+{
+	sint32 cx = rnd.range(0, MAP_SIZE - 1);
+	sint32 cy = rnd.range(0, MAP_SIZE - 1);
+	for (unsigned int i = 0; i < n; ++i)
+		locs.add(cx + rnd.range(0, 127), cy + rnd.range(0, 127),
+				 rnd.range(0, 15) * 8 * rnd.range(0, 4));
+}
+
+// The box isValidPosition looks at for an item of size (xd,yd,zd) at (x,y,z)
+void positionBox(sint32 x, sint32 y, sint32 z, sint32 xd, sint32 yd,
+				 sint32 lo[3], sint32 hi[3])
+{
+	lo[0] = x - xd;
+	lo[1] = y - yd;
+	lo[2] = z - MAX_HEIGHT;
+	hi[0] = x + MAX_FOOTPAD;
+	hi[1] = y + MAX_FOOTPAD;
+	hi[2] = INT_MAX;
+}
+
+// The box sweepTest looks at for a move from start to end (see sweepBounds)
+void sweepBox(const sint32 start[3], const sint32 end[3],
+			  const sint32 dims[3], sint32 lo[3], sint32 hi[3])
+{
+	const sint32 margin = 4;
+	for (int i = 0; i < 3; i++) {
+		lo[i] = (start[i] < end[i]) ? start[i] : end[i];
+		hi[i] = (start[i] > end[i]) ? start[i] : end[i];
+	}
+	lo[0] -= dims[0] + margin;
+	lo[1] -= dims[1] + margin;
+	lo[2] -= MAX_HEIGHT + margin;
+	hi[0] += MAX_FOOTPAD + margin;
+	hi[1] += MAX_FOOTPAD + margin;
+	hi[2] += dims[2] + margin;
+}
+
+int test_filter_known_answer()
+{
+	Locations locs;
+	locs.add(10, 10, 0);	// inside
+	locs.add(9, 10, 0);		// x too small
+	locs.add(20, 20, 8);	// on the upper corner
+	locs.add(21, 20, 8);	// x too large
+	locs.add(15, 15, -1);	// z too small
+	locs.add(15, 15, 9);	// z too large
+	locs.add(15, 9, 4);		// y too small
+	locs.add(15, 15, 4);	// inside, in the scalar tail of the SIMD version
+
+	const sint32 lo[3] = { 10, 10, 0 };
+	const sint32 hi[3] = { 20, 20, 8 };
+	uint32 hits[8];
+	unsigned int count = Pentagram::filterLocations(&locs.x[0], &locs.y[0],
+		&locs.z[0], locs.size(), lo, hi, hits);
+
+	TEST_ASSERT_EQUAL(3, count);
+	TEST_ASSERT_EQUAL(0, hits[0]);
+	TEST_ASSERT_EQUAL(2, hits[1]);
+	TEST_ASSERT_EQUAL(7, hits[2]);
+	return 0;
+}
+
+int test_filter_position_queries()
+{
+	TestRandom rnd(13);
+	for (int q = 0; q < 5000; ++q) {
+		Locations locs;
+		makeCell(rnd, rnd.range(0, 150), locs);
+		if (locs.size() == 0) continue;
+
+		// around one of the items, so there are hits
+		unsigned int pick = rnd.range(0, locs.size() - 1);
+		sint32 lo[3], hi[3];
+		positionBox(locs.x[pick] + rnd.range(-64, 64),
+					locs.y[pick] + rnd.range(-64, 64),
+					locs.z[pick] + rnd.range(-16, 16),
+					32 * rnd.range(1, 8), 32 * rnd.range(1, 8), lo, hi);
+		if (compareFilters(locs, lo, hi)) return 1;
+	}
+	return 0;
+}
+
+int test_filter_sweep_queries()
+{
+	TestRandom rnd(19);
+	for (int q = 0; q < 5000; ++q) {
+		Locations locs;
+		makeCell(rnd, rnd.range(0, 150), locs);
+		if (locs.size() == 0) continue;
+
+		unsigned int pick = rnd.range(0, locs.size() - 1);
+		sint32 start[3] = { locs.x[pick], locs.y[pick], locs.z[pick] + 64 };
+		sint32 end[3];
+		for (int i = 0; i < 3; i++)
+			end[i] = start[i] + rnd.range(-96, 96);
+		sint32 dims[3] = { 32 * rnd.range(1, 4), 32 * rnd.range(1, 4),
+						   8 * rnd.range(0, 16) };
+
+		sint32 lo[3], hi[3];
+		sweepBox(start, end, dims, lo, hi);
+		if (compareFilters(locs, lo, hi)) return 1;
+	}
+	return 0;
+}
+
+int test_filter_extreme_values()
+{
+	// The SIMD versions compare signed 32 bit lanes, so check the ends of
+	// the range and empty boxes too
+	const sint32 values[] = { INT_MIN, INT_MIN + 1, -1, 0, 1,
+							  INT_MAX - 1, INT_MAX };
+	const int nvalues = sizeof(values) / sizeof(values[0]);
+
+	Locations locs;
+	for (int i = 0; i < nvalues; ++i)
+		for (int j = 0; j < nvalues; ++j)
+			for (int k = 0; k < nvalues; k += 3)
+				locs.add(values[i], values[j], values[k]);
+
+	TestRandom rnd(23);
+	for (int q = 0; q < 2000; ++q) {
+		sint32 lo[3], hi[3];
+		for (int i = 0; i < 3; i++) {
+			lo[i] = values[rnd.range(0, nvalues - 1)];
+			hi[i] = values[rnd.range(0, nvalues - 1)];
+		}
+		if (compareFilters(locs, lo, hi)) return 1;
+	}
+	return 0;
+}
+
+}
+
+void run_location_filter_tests()
+{
+	TEST_SUITE_BEGIN("LocationFilter");
+	RUN_TEST(test_filter_known_answer);
+	RUN_TEST(test_filter_position_queries);
+	RUN_TEST(test_filter_sweep_queries);
+	RUN_TEST(test_filter_extreme_values);
+	TEST_SUITE_END();
+}
@@ -1,6 +1,5 @@
 /*
-Copyright (C) 2005 The Pentagram Team
-Copyright (C) 2010-2022 The Exult Team
+Copyright (C) 2026 The Pentagram team
 
 This program is free software; you can redistribute it and/or
 modify it under the terms of the GNU General Public License
@@ -17,25 +16,30 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#ifndef BILINEARSCALER_H_INCLUDED
-#define BILINEARSCALER_H_INCLUDED
+#include "pent_include.h"
+#include "test_framework.h"
 
-#include "ArbScaler.h"
+int tests_run = 0;
+int tests_passed = 0;
+int tests_failed = 0;
+const char *current_test_name = 0;
 
-namespace Pentagram { namespace BilinearScaler {
-	class Scaler : public ArbScaler {
-	public:
-		Scaler();
-		virtual bool ScaleArbitrary()
-				const;    //< supports arbitrary scaling of any degree
+void run_location_filter_tests();
+void run_item_sorter_tests();
+void run_sonarc_tests();
 
-		const char* ScalerName()
-				const override;    //< Name Of the Scaler (1 word)
-		const char* ScalerDesc() const override;    //< Desciption of the Scaler
-		const char* ScalerCopyright()
-				const override;    //< Scaler Copyright info
-	};
+int main()
+{
+	std::printf("\n");
+	std::printf("=====================================\n");
+	std::printf("  Pentagram Unit Test Suite\n");
+	std::printf("=====================================\n");
 
-}}    // namespace Pentagram::BilinearScaler
+	run_location_filter_tests();
+	run_item_sorter_tests();
+	run_sonarc_tests();
 
-#endif
+	PRINT_TEST_RESULTS();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,381 @@
+/*
+Copyright (C) 2026 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// Checks that SonarcAudioSample decodes exactly like the original Sonarc
+// decoder (with the LPC filter one tap at a time), frame by frame and
+// with decodeAll.
+//
+
+#include "pent_include.h"
+#include "test_framework.h"
+
+#include "SonarcAudioSample.h"
+
+#include <vector>
+
+using Pentagram::AudioSample;
+using Pentagram::SonarcAudioSample;
+
+namespace {
+
+//
+// The original decoder
+//
+
+int OneTable[256];
+
+void GenerateOneTable()
+{
+	for (int i = 0; i < 256; ++i)
+		OneTable[i] = 0;
+
+	for (int power = 2; power < 32; power *= 2)
+		for (int col = power-1; col < 16; col += power)
+			for (int row = 0; row < 16; ++row)
+				OneTable[row*16+col]++;
+
+	for (int i = 0; i < 16; ++i)
+		OneTable[i*16+15] += OneTable[i];
+}
+
+void decode_EC(int mode, int samplecount,
+			   const uint8* source, int sourcesize,
+			   uint8* dest)
+{
+	bool zerospecial = false;
+	uint32 data = 0;
+	int inputbits = 0; // current 'fill rate' of data window
+
+	if (mode >= 7) {
+		mode -= 7;
+		zerospecial = true;
+	}
+
+	while (samplecount) {
+		// fill data window
+		while (sourcesize && inputbits <= 24) {
+			data |= (*source++) << inputbits;
+			sourcesize--;
+			inputbits += 8;
+		}
+
+		if (zerospecial && !(data & 0x1)) {
+			*dest++ = 0x80; // output zero
+			data >>= 1;
+			inputbits--;
+		} else {
+			if (zerospecial) {
+				data >>= 1; // strip one
+				inputbits--;
+			}
+
+			uint8 lowByte = data & 0xFF;
+			int ones = OneTable[lowByte];
+
+			if (ones == 0) {
+				data >>= 1; // strip zero
+				// low byte contains (mode+1) bits of the sample
+				sint8 sample = data & 0xFF;
+				sample <<= (7 - mode);
+				sample >>= (7 - mode); // sign extend
+				*dest++ = (uint8)(sample+0x80);
+				data >>= mode+1;
+				inputbits -= mode+2;
+			} else if (ones < 7-mode) {
+				data >>= ones+1; // strip ones and zero
+				// low byte contains (mode+ones) bits of the sample
+				sint8 sample = data & 0xFF;
+				sample <<= (7-mode-ones);
+				sample &= 0x7F;
+				if (!(sample & 0x40))
+					sample |= 0x80; // reconstruct sign bit
+				sample >>= (7-mode-ones); // sign extend
+				*dest++ = (uint8)(sample+0x80);
+				data >>= (mode+ones);
+				inputbits -= mode+2*ones+1;
+			} else {
+				data >>= (7 - mode); // strip ones
+				// low byte contains 7 bits of the sample
+				sint8 sample = data & 0xFF;
+				sample &= 0x7F;
+				if (!(sample & 0x40))
+					sample |= 0x80; // reconstruct sign bit
+				*dest++ = (uint8)(sample+0x80);
+				data >>= 7;
+				inputbits -= 2*7-mode;
+			}
+		}
+		samplecount--;
+	}
+}
+
+void decode_LPC(int order, int nsamples, uint8* dest, const uint8* factors)
+{
+	uint8 *startdest = dest;
+	dest -= order;
+
+	for (int i = 0; i < nsamples; ++i) {
+		uint8* loopdest = dest++;
+		int accum = 0;
+		for (int j = order-1; j >= 0; --j) {
+			sint8 val1 = (loopdest<startdest)? 0: (*loopdest);
+			loopdest++;
+			val1 ^= 0x80;
+			sint16 val2 = factors[j*2] + (factors[j*2+1]<<8);
+			accum += (int)val1 * val2;
+		}
+
+		accum += 0x00000800;
+		*loopdest -= (sint8)((accum >> 12) & 0xFF);
+	}
+}
+
+int audio_decode(const uint8* source, uint8* dest)
+{
+	int size = source[0] + (source[1] << 8);
+	uint16 checksum = 0;
+	for (int i = 0; i < size/2; ++i) {
+		uint16 val = source[2*i] + (source[2*i+1] << 8);
+		checksum ^= val;
+	}
+
+	if (checksum != 0xACED) return -1;
+
+	int order = source[7];
+	int mode = source[6]-8;
+	int samplecount = source[2] + (source[3] << 8);
+
+	decode_EC(mode, samplecount,
+			  source+8+2*order, size-8-2*order,
+			  dest);
+	decode_LPC(order, samplecount, dest, source+8);
+
+	// Try to fix a number of clipped samples
+	for (int i = 1; i < samplecount; ++i)
+		if (dest[i] == 0 && dest[i-1] > 192) dest[i] = 0xFF;
+
+	return 0;
+}
+
+//
+// Making samples
+//
+
+// where the first frame starts in a sample
+const uint32 SAMPLE_HEADER = 0x20;
+
+// A frame of samplecount samples with random factors and error codes, and
+// a checksum that is right unless bad is set
+void makeFrame(TestRandom& rnd, int samplecount, int order, int mode,
+			   bool bad, std::vector<uint8>& frame)
+{
+	int ecbytes = rnd.range(0, samplecount * 2);
+	int size = 8 + 2*order + ecbytes;
+	if (size & 1) size++;
+	if (size == static_cast<int>(SAMPLE_HEADER)) size += 2;
+
+	frame.resize(size);
+	frame[0] = size & 0xFF;
+	frame[1] = size >> 8;
+	frame[2] = samplecount & 0xFF;
+	frame[3] = samplecount >> 8;
+	frame[4] = frame[5] = 0;
+	frame[6] = mode + 8;
+	frame[7] = order;
+
+	for (int j = 0; j < order; ++j) {
+		// mostly the size of real predictor factors, sometimes anything
+		sint32 factor = (rnd.range(0, 7) == 0) ? rnd.range(-32768, 32767)
+											   : rnd.range(-6000, 6000);
+		frame[8 + j*2] = factor & 0xFF;
+		frame[8 + j*2 + 1] = (factor >> 8) & 0xFF;
+	}
+	for (int i = 8 + 2*order; i < size; ++i)
+		frame[i] = rnd.range(0, 255);
+
+	// bytes 4 and 5 aren't used by the decoder: make the checksum right
+	uint16 checksum = 0;
+	for (int i = 0; i < size/2; ++i)
+		checksum ^= frame[2*i] + (frame[2*i+1] << 8);
+	checksum ^= 0xACED;
+	if (bad) checksum ^= 1;
+	frame[4] = checksum & 0xFF;
+	frame[5] = checksum >> 8;
+}
+
+// A sample of frames of frame_samples samples each (the last one may be
+// shorter). Also decodes it with the original decoder into expected.
+// Returns the buffer for a SonarcAudioSample.
+uint8* makeSample(TestRandom& rnd, int nframes, int frame_samples,
+				  int max_order, int bad_frame, uint32& size,
+				  std::vector<uint8>& expected)
+{
+	std::vector<uint8> data(SAMPLE_HEADER, 0);
+	expected.clear();
+
+	uint32 length = 0;
+	std::vector<uint8> frame;
+	std::vector<uint8> decoded;
+	for (int f = 0; f < nframes; ++f) {
+		int samplecount = frame_samples;
+		if (f == nframes - 1 && f > 0)
+			samplecount = rnd.range(1, frame_samples);
+
+		makeFrame(rnd, samplecount, rnd.range(0, max_order),
+				  rnd.range(0, 13), f == bad_frame, frame);
+		data.insert(data.end(), frame.begin(), frame.end());
+
+		decoded.assign(samplecount, 0x80);
+		if (audio_decode(&frame[0], &decoded[0]) != 0)
+			decoded.assign(samplecount, 0x80);
+		expected.insert(expected.end(), decoded.begin(), decoded.end());
+		length += samplecount;
+	}
+
+	data[0] = length & 0xFF;
+	data[1] = (length >> 8) & 0xFF;
+	data[2] = (length >> 16) & 0xFF;
+	data[3] = length >> 24;
+	data[4] = 11025 & 0xFF;
+	data[5] = 11025 >> 8;
+
+	size = static_cast<uint32>(data.size());
+	uint8 *buffer = new uint8[size];
+	for (uint32 i = 0; i < size; ++i)
+		buffer[i] = data[i];
+	return buffer;
+}
+
+// Decode all frames of sample with decompressFrame
+void decodeFrames(const AudioSample& sample, std::vector<uint8>& out)
+{
+	std::vector<uint8> decomp(sample.getDecompressorDataSize());
+	std::vector<uint8> frame(sample.getFrameSize() + 1);
+	out.clear();
+
+	sample.initDecompressor(&decomp[0]);
+	uint32 count;
+	while ((count = sample.decompressFrame(&decomp[0], &frame[0])) != 0)
+		out.insert(out.end(), frame.begin(), frame.begin() + count);
+}
+
+int compareBytes(const std::vector<uint8>& expected,
+				 const std::vector<uint8>& actual)
+{
+	TEST_ASSERT_EQUAL(expected.size(), actual.size());
+	for (unsigned int i = 0; i < expected.size(); ++i)
+		TEST_ASSERT_EQUAL(expected[i], actual[i]);
+	return 0;
+}
+
+//
+// Tests
+//
+
+int test_sonarc_frames()
+{
+	// Frames of all orders, including those past the unrolled ones, and
+	// frames shorter than their order
+	TestRandom rnd(86);
+	for (int q = 0; q < 3000; ++q) {
+		int frame_samples = (q % 4 == 0) ? rnd.range(1, 40)
+										 : rnd.range(1, 1024);
+		uint32 size;
+		std::vector<uint8> expected, actual;
+		uint8 *buffer = makeSample(rnd, rnd.range(1, 4), frame_samples, 32,
+								   -1, size, expected);
+		SonarcAudioSample sample(buffer, size);
+
+		decodeFrames(sample, actual);
+		if (compareBytes(expected, actual)) return 1;
+	}
+	return 0;
+}
+
+int test_sonarc_decode_all()
+{
+	TestRandom rnd(87);
+	for (int q = 0; q < 300; ++q) {
+		uint32 size;
+		std::vector<uint8> expected, actual;
+		uint8 *buffer = makeSample(rnd, rnd.range(1, 30),
+								   rnd.range(64, 2048), 24, -1, size,
+								   expected);
+		SonarcAudioSample sample(buffer, size);
+
+		AudioSample *all = sample.decodeAll(0x1000000);
+		TEST_ASSERT(all != 0);
+		TEST_ASSERT(all->isPCM());
+		decodeFrames(*all, actual);
+		delete all;
+		if (compareBytes(expected, actual)) return 1;
+	}
+	return 0;
+}
+
+int test_sonarc_bad_checksum()
+{
+	// decodeAll makes a frame that fails its checksum silent
+	TestRandom rnd(88);
+	for (int q = 0; q < 50; ++q) {
+		int nframes = rnd.range(2, 10);
+		int bad = rnd.range(0, nframes - 1);
+		uint32 size;
+		std::vector<uint8> expected, actual;
+		uint8 *buffer = makeSample(rnd, nframes, rnd.range(64, 512), 16,
+								   bad, size, expected);
+		SonarcAudioSample sample(buffer, size);
+
+		AudioSample *all = sample.decodeAll(0x1000000);
+		TEST_ASSERT(all != 0);
+		decodeFrames(*all, actual);
+		delete all;
+		if (compareBytes(expected, actual)) return 1;
+	}
+	return 0;
+}
+
+int test_sonarc_decode_all_limit()
+{
+	TestRandom rnd(89);
+	uint32 size;
+	std::vector<uint8> expected;
+	uint8 *buffer = makeSample(rnd, 4, 256, 8, -1, size, expected);
+	SonarcAudioSample sample(buffer, size);
+
+	TEST_ASSERT(sample.decodeAll(expected.size() - 1) == 0);
+	AudioSample *all = sample.decodeAll(expected.size());
+	TEST_ASSERT(all != 0);
+	delete all;
+	return 0;
+}
+
+}
+
+void run_sonarc_tests()
+{
+	GenerateOneTable();
+
+	TEST_SUITE_BEGIN("SonarcAudioSample");
+	RUN_TEST(test_sonarc_frames);
+	RUN_TEST(test_sonarc_decode_all);
+	RUN_TEST(test_sonarc_bad_checksum);
+	RUN_TEST(test_sonarc_decode_all_limit);
+	TEST_SUITE_END();
+}
@@ -10,10 +10,12 @@ pent_shp_OBJ   = \
 	$(CONVERT) \
 	$(MISC) \
 	filesys/FileSystem.o \
+	filesys/MappedDataSource.o \
 	graphics/Palette.o \
 	graphics/XFormBlend.o \
 	graphics/Shape.o \
-	graphics/ShapeFrame.o
+	graphics/ShapeFrame.o \
+	graphics/ShapeFrameCache.o
 
 PNG_CFLAGS := $(shell pkg-config --cflags libpng)
 PNG_LIBS := $(shell pkg-config --libs libpng)
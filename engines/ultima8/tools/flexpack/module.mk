@@ -17,6 +17,7 @@ flexpack_OBJ = \
 	$(SYSTEM) \
 	graphics/Shape.o \
 	graphics/ShapeFrame.o \
+	graphics/ShapeFrameCache.o \
 	kernel/CoreApp.o \
 	tools/flexpack/FlexWriter.o \
 	tools/flexpack/FlexPack.o
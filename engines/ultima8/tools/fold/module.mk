@@ -13,6 +13,7 @@ fold_OBJ = \
 	$(SYSTEM) \
 	kernel/CoreApp.o \
 	filesys/FileSystem.o \
+	filesys/MappedDataSource.o \
 	filesys/RawArchive.o \
 	filesys/Archive.o \
 	filesys/ArchiveFile.o \
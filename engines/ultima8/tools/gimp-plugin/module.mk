@@ -10,9 +10,11 @@ pentshp_OBJ = \
 	$(CONVERT) \
 	$(MISC) \
 	filesys/FileSystem.o \
+	filesys/MappedDataSource.o \
 	graphics/Palette.o \
 	graphics/Shape.o \
-	graphics/ShapeFrame.o
+	graphics/ShapeFrame.o \
+	graphics/ShapeFrameCache.o
 
 pentshp_CUST_OBJ = \
 	$(LPATH)/pentshp.o \
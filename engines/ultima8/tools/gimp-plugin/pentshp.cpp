@@ -31,6 +31,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ConvertShape.h"
 #include "Shape.h"
 #include "ShapeFrame.h"
+#include "ShapeFrameCache.h"
 #include "Palette.h"
 
 // And not too shockingly similiar to the exult plugin!
@@ -292,6 +293,7 @@ static void paintFrame(Shape * s, uint32 framenum, void * pixels,
 {
 	#define untformed_pal true
 	#define NO_CLIPPING
+	#define NO_SPAN_BLIT
 	#define uintX uint16
 	// EVIL!!!!!!
 	#define clip_window (*clip_window)
@@ -300,6 +302,7 @@ static void paintFrame(Shape * s, uint32 framenum, void * pixels,
 
 	#undef clip_window
 	#undef uintX
+	#undef NO_SPAN_BLIT
 	#undef NO_CLIPPING
 }
 
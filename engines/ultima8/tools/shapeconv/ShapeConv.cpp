@@ -25,10 +25,16 @@
 #include "Args.h"
 
 #include "ConvertShape.h"
+#include "WorkerPool.h"
+#include "IDataSource.h"
+#include "ODataSource.h"
 
 #include "crusader/ConvertShapeCrusader.h"
 #include "u8/ConvertShapeU8.h"
 
+#include <algorithm>
+#include <thread>
+
 const ConvertShapeFormat		AutoShapeFormat =
 {
 	"Auto Detected",
@@ -67,15 +73,85 @@ const ConvertShapeFormat *write_format = &U8ShapeFormat;
 int shapenum;
 #endif
 
-// Nasty yucky stuff
-void ConvertFlexes(IDataSource *readfile, ODataSource *writefile)
+// Detect the format of a shape, if it's to be auto detected
+bool DetectShapeFormat(IDataSource *readfile, uint32 read_size)
+{
+	if (read_format != &AutoShapeFormat) return true;
+
+	pout << "Auto detecting format..." << std::endl;
+
+	if (ConvertShape::Check(readfile, &U8ShapeFormat, read_size))
+		read_format = &U8ShapeFormat;
+	else if (ConvertShape::Check(readfile, &U82DShapeFormat, read_size))
+		read_format = &U82DShapeFormat;
+	else if (ConvertShape::Check(readfile, &U8SKFShapeFormat, read_size))
+		read_format = &U8SKFShapeFormat;
+	else if (ConvertShape::Check(readfile, &CrusaderShapeFormat, read_size))
+		read_format = &CrusaderShapeFormat;
+	else if (ConvertShape::Check(readfile, &Crusader2DShapeFormat, read_size))
+		read_format = &Crusader2DShapeFormat;
+	else if (ConvertShape::Check(readfile, &PentagramShapeFormat, read_size))
+		read_format = &PentagramShapeFormat;
+	else if (ConvertShape::Check(readfile, &U8CMPShapeFormat, read_size))
+		read_format = &U8CMPShapeFormat;
+	else
+	{
+		perr << "Error: Unable to detect shape format!" << std::endl;
+		return false;
+	}
+	pout << "Detected input format as: " << read_format->name << std::endl;
+	return true;
+}
+
+// Shapes converted at a time, before they're written out in order
+static const uint32 BATCH_SHAPES = 256;
+
+struct ConvertJob
+{
+	const uint8 *flex;			// The whole input flex
+	const uint32 *offsets;		// Of each shape in the batch
+	const uint32 *sizes;
+	OAutoBufferDataSource **converted;
+};
+
+static void ConvertFlexShape(void *data, unsigned int index)
+{
+	ConvertJob *job = static_cast<ConvertJob*>(data);
+	if (!job->sizes[index]) return;
+
+	IBufferDataSource source(job->flex + job->offsets[index], job->sizes[index]);
+	ConvertShape shape;
+	shape.Read(&source, read_format, job->sizes[index]);
+
+	OAutoBufferDataSource *dest = new OAutoBufferDataSource(job->sizes[index] + 1024);
+	uint32 write_size;
+	shape.Write(dest, write_format, write_size);
+	job->converted[index] = dest;
+}
+
+// Convert every shape in a flex. The flex is read in whole, the shapes are
+// converted a batch at a time on the job system's threads, and each batch is
+// written out in order once it's done, so the output doesn't depend on the
+// number of threads.
+void ConvertFlexes(IDataSource *readfile, ODataSource *writefile, uint32 threads)
 {
-	ConvertShape	shape;
 	uint32			i;
 
+	// Read in the whole flex
+	uint32 flex_size = readfile->getSize();
+	readfile->seek(0);
+	uint8 *flex = new uint8[flex_size];
+	readfile->read(flex, flex_size);
+
 	// Number of flex entries
 	readfile->seek(0x54);
 	uint32 num_entries = readfile->read4();
+	if (flex_size < 0x80 || num_entries > (flex_size - 0x80) / 8)
+	{
+		perr << "Error: Bad flex header!" << std::endl;
+		delete [] flex;
+		return;
+	}
 
 	// Write blank stuff for output 
 	for (i = 0; i < 0x52; i++) writefile->write1(0x1A);
@@ -90,72 +166,71 @@ void ConvertFlexes(IDataSource *readfile, ODataSource *writefile)
 	// Write blank index table
 	for (i = 0x58; i < write_offset; i++)  writefile->write1(0);
 
+	WorkerPool pool(threads > 1 ? threads - 1 : 0);
+
+	uint32 offsets[BATCH_SHAPES];
+	uint32 sizes[BATCH_SHAPES];
+	OAutoBufferDataSource *converted[BATCH_SHAPES];
+	ConvertJob job = { flex, offsets, sizes, converted };
+
 	// Convert shapes
 	con.Printf ("Convering %i shapes...\n", num_entries);
-	for (uint32 s = 0; s < num_entries; s++)
+	for (uint32 first = 0; first < num_entries; first += BATCH_SHAPES)
 	{
-#ifdef EXPORT_SHAPENUM
-		shapenum = s;
-#endif
+		uint32 count = num_entries - first;
+		if (count > BATCH_SHAPES) count = BATCH_SHAPES;
 
-		// Get the read offset and size
-		readfile->seek(0x80 + 8*s);
-		uint32 read_offset = readfile->read4();
-		uint32 read_size = readfile->read4();
-
-		if (!read_size) continue;
+		for (uint32 b = 0; b < count; b++)
+		{
+			// Get the read offset and size
+			const uint8 *entry = flex + 0x80 + 8*(first + b);
+			offsets[b] = entry[0] | (entry[1] << 8) | (entry[2] << 16) | (entry[3] << 24);
+			sizes[b] = entry[4] | (entry[5] << 8) | (entry[6] << 16) | (entry[7] << 24);
+			converted[b] = 0;
 
-		// Seek to shape
-		readfile->seek(read_offset);
+			if (sizes[b] && (offsets[b] > flex_size || sizes[b] > flex_size - offsets[b]))
+			{
+				perr << "Warning: Shape " << (first + b) << " is past the end of the flex" << std::endl;
+				sizes[b] = 0;
+			}
 
-		// Detect ShapeFormat
-		if (read_format == &AutoShapeFormat)
-		{
-			pout << "Auto detecting format..." << std::endl;
-
-			if (ConvertShape::Check(readfile, &U8ShapeFormat, read_size))
-				read_format = &U8ShapeFormat;
-			else if (ConvertShape::Check(readfile, &U82DShapeFormat, read_size))
-				read_format = &U82DShapeFormat;
-			else if (ConvertShape::Check(readfile, &U8SKFShapeFormat, read_size))
-				read_format = &U8SKFShapeFormat;
-			else if (ConvertShape::Check(readfile, &CrusaderShapeFormat, read_size))
-				read_format = &CrusaderShapeFormat;
-			else if (ConvertShape::Check(readfile, &Crusader2DShapeFormat, read_size))
-				read_format = &Crusader2DShapeFormat;
-			else if (ConvertShape::Check(readfile, &PentagramShapeFormat, read_size))
-				read_format = &PentagramShapeFormat;
-			else if (ConvertShape::Check(readfile, &U8CMPShapeFormat, read_size))
-				read_format = &U8CMPShapeFormat;
-			else
+			// Detect ShapeFormat from the first shape
+			if (sizes[b] && read_format == &AutoShapeFormat)
 			{
-				perr << "Error: Unable to detect shape format!" << std::endl;
-				return;
+				IBufferDataSource source(flex + offsets[b], sizes[b]);
+				if (!DetectShapeFormat(&source, sizes[b]))
+				{
+					delete [] flex;
+					return;
+				}
 			}
-			pout << "Detected input format as: " << read_format->name << std::endl;
 		}
-		
-		// Read shape
-		con.Printf ("Reading shape %i...\n", s);
-		shape.Read(readfile, read_format, read_size);
-
-		// Write shape
-		con.Printf ("Writing shape %i...\n", s);
-		writefile->seek(write_offset);
-		uint32 write_size;
-		shape.Write(writefile, write_format, write_size);
-
-		// Update the table
-		writefile->seek(0x80 + 8*s);
-		writefile->write4(write_offset);
-		writefile->write4(write_size);
-
-		// Update the write_offset
-		write_offset += write_size;
-
-		// Free it
-		shape.Free();
+
+		con.Printf ("Converting shapes %i to %i...\n", first, first + count - 1);
+		pool.run(ConvertFlexShape, &job, count);
+
+		for (uint32 b = 0; b < count; b++)
+		{
+			if (!converted[b]) continue;
+
+			// Write shape
+			uint32 write_size = converted[b]->getSize();
+			writefile->seek(write_offset);
+			writefile->write(converted[b]->getBuf(), write_size);
+
+			// Update the table
+			writefile->seek(0x80 + 8*(first + b));
+			writefile->write4(write_offset);
+			writefile->write4(write_size);
+
+			// Update the write_offset
+			write_offset += write_size;
+
+			// Free it
+			delete converted[b];
+		}
 	}
+	delete [] flex;
 	pout << "Done!" << std::endl;
 }
 
@@ -168,30 +243,7 @@ void ConvertShp(IDataSource *readfile, ODataSource *writefile)
 	uint32 read_size = readfile->getSize();
 
 	// Detect ShapeFormat
-	if (read_format == &AutoShapeFormat)
-	{
-		pout << "Auto detecting format..." << std::endl;
-		if (ConvertShape::Check(readfile, &U8ShapeFormat, read_size))
-			read_format = &U8ShapeFormat;
-		else if (ConvertShape::Check(readfile, &U82DShapeFormat, read_size))
-			read_format = &U82DShapeFormat;
-		else if (ConvertShape::Check(readfile, &U8SKFShapeFormat, read_size))
-			read_format = &U8SKFShapeFormat;
-		else if (ConvertShape::Check(readfile, &CrusaderShapeFormat, read_size))
-			read_format = &CrusaderShapeFormat;
-		else if (ConvertShape::Check(readfile, &Crusader2DShapeFormat, read_size))
-			read_format = &Crusader2DShapeFormat;
-		else if (ConvertShape::Check(readfile, &PentagramShapeFormat, read_size))
-			read_format = &PentagramShapeFormat;
-		else if (ConvertShape::Check(readfile, &U8CMPShapeFormat, read_size))
-			read_format = &U8CMPShapeFormat;
-		else
-		{
-			perr << "Error: Unable to detect shape format!" << std::endl;
-			return;
-		}
-		pout << "Detected input format as: " << read_format->name << std::endl;
-	}
+	if (!DetectShapeFormat(readfile, read_size)) return;
 
 	con.Printf ("Reading shape...\n");
 	shape.Read(readfile, read_format, read_size);
@@ -217,21 +269,24 @@ const ConvertShapeFormat *GetShapeFormat(const char *game)
 int main(int argc, char **argv)
 {
 	if (argc < 3) {
-		perr << "Usage: ShapeConv <inflx> <outflx> [--ifmt u8|u82D|u8skf|u8cmp|cru|cru2D|pent|auto] [--ofmt u8|u82D|u8skf|cru|cru2D|pent] [--singlefile]" << std::endl;
+		perr << "Usage: ShapeConv <inflx> <outflx> [--ifmt u8|u82D|u8skf|u8cmp|cru|cru2D|pent|auto] [--ofmt u8|u82D|u8skf|cru|cru2D|pent] [--singlefile] [--threads n]" << std::endl;
 		perr << std::endl;
 		perr << "Default input format: Auto Detect" << std::endl;
 		perr << "Default output format: Ultima 8" << std::endl;
+		perr << "Default threads: one per core" << std::endl;
 		return 1;
 	}
 
 	Args		parameters;
 	std::string	ifmt, ofmt;
 	bool		singlefile=false;
+	uint32		threads=0;
 	//bool		auto_detect=false; // Darke: UNUSED?
 
 	parameters.declare("--ifmt",		&ifmt,      "auto");
 	parameters.declare("--ofmt",		&ofmt,      "u8");
 	parameters.declare("--singlefile",	&singlefile, true);
+	parameters.declare("--threads",		&threads,    0);
 
 	parameters.process(argc, argv);
 
@@ -287,8 +342,11 @@ int main(int argc, char **argv)
 		return 1;
 	}
 
+	if (!threads)
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+
 	if (!singlefile)
-		ConvertFlexes(readfile, writefile);
+		ConvertFlexes(readfile, writefile, threads);
 	else
 		ConvertShp(readfile, writefile);
 
@@ -14,7 +14,9 @@ shapeconv_OBJ = \
 	$(ARGS) \
 	$(CONVERT) \
 	$(SYSTEM) \
-	kernel/CoreApp.o
+	$(JOBS) \
+	kernel/CoreApp.o \
+	kernel/WorkerPool.o
 
 # Common rules
 include $(srcdir)/common.mk
@@ -0,0 +1,135 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "UCCode.h"
+
+//! Sizes of the operands of an opcode, as a string of digits.
+//! Opcodes not listed have none, and so do the ones UCMachine doesn't know.
+static const char* operandSizes(uint8 opcode)
+{
+	switch (opcode) {
+	case 0x00: case 0x01: case 0x02: case 0x0A:
+	case 0x19: case 0x1A: case 0x1B:
+	case 0x3E: case 0x3F: case 0x40: case 0x41: case 0x43:
+	case 0x4B: case 0x4C: case 0x4D: case 0x5A:
+	case 0x62: case 0x63: case 0x64: case 0x65: case 0x66: case 0x67:
+	case 0x69: case 0x6E: case 0x6F: case 0x74:
+		return "1";
+	case 0x03: case 0x0E: case 0x38: case 0x42: case 0x44: case 0x45:
+	case 0x6C:
+		return "11";
+	case 0x09: case 0x70:
+		return "111";
+	case 0x0B: case 0x51: case 0x52: case 0x54:
+		return "2";
+	case 0x0C:
+		return "4";
+	case 0x0D:
+		return "2";		// followed by the string and its terminator
+	case 0x0F:
+		return "12";
+	case 0x11:
+		return "22";
+	case 0x4E: case 0x4F:
+		return "21";
+	case 0x57:
+		return "1122";
+	case 0x58:
+		return "22211";
+	case 0x75: case 0x76:
+		return "112";
+	default:
+		return "";
+	}
+}
+
+UCCode::UCCode(const uint8* data_, uint32 size_)
+	: data(data_), size(size_), index(size_, -1)
+{
+
+}
+
+UCCode::~UCCode()
+{
+
+}
+
+const UCInstruction& UCCode::decode(uint32 ip)
+{
+	static UCInstruction pastend = { 0, false, 0, 0, { 0, 0, 0, 0, 0 } };
+	if (ip >= size) return pastend;
+
+	sint32 first = static_cast<sint32>(instructions.size());
+
+	while (ip < size && index[ip] < 0) {
+		UCInstruction ins = { data[ip], false, 0, 0, { 0, 0, 0, 0, 0 } };
+		uint32 pos = ip + 1;
+		bool complete = true;
+
+		const char* sizes = operandSizes(ins.opcode);
+		for (unsigned int i = 0; sizes[i]; ++i) {
+			uint32 n = sizes[i] - '0';
+			if (pos + n > size) {
+				complete = false;
+				break;
+			}
+			uint32 val = 0;
+			for (uint32 b = 0; b < n; ++b)
+				val |= static_cast<uint32>(data[pos + b]) << (8 * b);
+			ins.op[i] = val;
+			pos += n;
+		}
+
+		if (complete && ins.opcode == 0x0D) {
+			// op[0] is the length, op[1] where the string is,
+			// op[2] the terminator
+			ins.op[1] = pos;
+			pos += ins.op[0];
+			if (pos < size)
+				ins.op[2] = data[pos++];
+			else
+				complete = false;
+		}
+
+		if (complete) {
+			ins.complete = true;
+			ins.next = static_cast<uint16>(pos);	// Truncates!!
+
+			// jumps are relative to the next instruction
+			if (ins.opcode == 0x51 || ins.opcode == 0x52)
+				ins.target = static_cast<uint16>(
+					pos + static_cast<sint16>(ins.op[0]));
+			else if (ins.opcode == 0x75 || ins.opcode == 0x76)
+				ins.target = static_cast<uint16>(
+					pos + static_cast<sint16>(ins.op[2]));
+		}
+
+		index[ip] = static_cast<sint32>(instructions.size());
+		instructions.push_back(ins);
+
+		// stop where execution can't just carry on to the next one
+		if (!complete || ins.opcode == 0x50 || ins.opcode == 0x52 ||
+			ins.opcode == 0x79 || ins.opcode == 0x7A)
+			break;
+		ip = pos;
+	}
+
+	return instructions[first];
+}
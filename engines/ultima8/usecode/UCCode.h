@@ -0,0 +1,63 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef UCCODE_H
+#define UCCODE_H
+
+#include <vector>
+
+//! A usecode instruction with its operands read out of the class
+struct UCInstruction
+{
+	uint8 opcode;
+	bool complete;		//!< false if it runs past the end of the class
+	uint16 next;		//!< offset of the instruction after this one
+	uint16 target;		//!< offset a jump goes to, if it is taken
+	uint32 op[5];		//!< operands, in the order they are encoded
+};
+
+//! The code of a usecode class, decoded into UCInstructions as it is run.
+//! Instructions are found by their offset (the ip of a UCProcess), so
+//! saved processes and jumps into any offset work as on the raw bytes.
+class UCCode
+{
+public:
+	UCCode(const uint8* data, uint32 size);
+	~UCCode();
+
+	//! get the instruction at offset ip, decoding it if it wasn't yet
+	const UCInstruction& get(uint32 ip) {
+		if (ip < size && index[ip] >= 0) return instructions[index[ip]];
+		return decode(ip);
+	}
+
+	//! the raw bytes, for the operands that don't fit in an UCInstruction
+	const uint8* getData() const { return data; }
+
+private:
+	//! decode from ip on until an instruction that was decoded before or
+	//! one that doesn't go on to the next
+	const UCInstruction& decode(uint32 ip);
+
+	const uint8* data;
+	uint32 size;
+	std::vector<sint32> index;	//!< instruction at each offset, or -1
+	std::vector<UCInstruction> instructions;
+};
+
+#endif
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <vector>
 #include <string>
+#include <algorithm>
 
 class IDataSource;
 class ODataSource;
@@ -75,6 +76,18 @@ class UCList
 		size++;
 	}
 
+	//! append a uint16 (usually an ObjId) to a list of elementsize 2
+	void append(uint16 v) {
+		assert(elementsize == 2);
+		elements.push_back(static_cast<uint8>(v & 0xFF));
+		elements.push_back(static_cast<uint8>(v >> 8));
+		size++;
+	}
+
+	void reserve(unsigned int capacity) {
+		elements.reserve(elementsize * capacity);
+	}
+
 	void remove(const uint8* e) {
 		// do we need to erase all occurences of e or just the first one?
 		// (deleting all, currently)
@@ -82,7 +95,7 @@ class UCList
 			bool equal = true;
 			for (unsigned int j = 0; j < elementsize && equal; j++)
 				equal = (elements[i*elementsize + j] == e[j]);
-			if (!equal) {
+			if (equal) {
 				elements.erase(elements.begin()+i*elementsize,
 							   elements.begin()+(i+1)*elementsize);
 				size--;
@@ -112,11 +125,43 @@ class UCList
 	void unionList(UCList& l) { // like append, but remove duplicates
 		// need to check if elementsizes match...
 		elements.reserve(elementsize * (size + l.size));
+		if (elementsize == 2 && l.elementsize == 2) {
+			// search a sorted copy instead of comparing every element
+			std::vector<uint16> sorted;
+			getSorted(sorted);
+			for (unsigned int i = 0; i < l.size; i++) {
+				uint16 v = l.getuint16(i);
+				std::vector<uint16>::iterator pos =
+					std::lower_bound(sorted.begin(), sorted.end(), v);
+				if (pos == sorted.end() || *pos != v) {
+					sorted.insert(pos, v);
+					append(v);
+				}
+			}
+			return;
+		}
 		for (unsigned int i = 0; i < l.size; i++)
 			if (!inList(l[i]))
 				append(l[i]);
 	}
 	void substractList(UCList& l) {
+		if (elementsize == 2 && l.elementsize == 2) {
+			// one pass over this list, keeping the order of what's left
+			std::vector<uint16> sorted;
+			l.getSorted(sorted);
+			unsigned int kept = 0;
+			for (unsigned int i = 0; i < size; i++) {
+				if (std::binary_search(sorted.begin(), sorted.end(),
+									   getuint16(i)))
+					continue;
+				elements[kept*2] = elements[i*2];
+				elements[kept*2+1] = elements[i*2+1];
+				kept++;
+			}
+			size = kept;
+			elements.resize(size * 2);
+			return;
+		}
 		for (unsigned int i = 0; i < l.size; i++)
 			remove(l[i]);
 	}
@@ -132,8 +177,8 @@ class UCList
 	}
 
 	void copyList(UCList& l) { // deep copy for list
-		free();
-		appendList(l);
+		elements = l.elements;
+		size = l.size;
 	}
 
 	void freeStrings();
@@ -151,6 +196,14 @@ class UCList
 
 private:
 	std::string& getString(uint32 index);
+
+	//! get the elements of a list of elementsize 2 as sorted uint16s
+	void getSorted(std::vector<uint16>& sorted) {
+		sorted.resize(size);
+		for (unsigned int i = 0; i < size; i++)
+			sorted[i] = getuint16(i);
+		std::sort(sorted.begin(), sorted.end());
+	}
 };
 
 #endif
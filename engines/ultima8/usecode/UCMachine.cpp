@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "UCMachine.h"
 #include "UCProcess.h"
 #include "Usecode.h"
+#include "UCCode.h"
 #include "Kernel.h"
 #include "DelayProcess.h"
 #include "CoreApp.h"
@@ -78,6 +79,7 @@ enum UCSegments {
 };
 
 UCMachine* UCMachine::ucmachine = 0;
+UCProcess* UCMachine::running = 0;
 
 UCMachine::UCMachine(Intrinsic *iset, unsigned int icount)
 {
@@ -97,6 +99,7 @@ UCMachine::UCMachine(Intrinsic *iset, unsigned int icount)
 
 	con.AddConsoleCommand("UCMachine::getGlobal", ConCmd_getGlobal);
 	con.AddConsoleCommand("UCMachine::setGlobal", ConCmd_setGlobal);
+	con.AddConsoleCommand("UCMachine::profile", ConCmd_profile);
 #ifdef DEBUG
 	con.AddConsoleCommand("UCMachine::traceObjID", ConCmd_traceObjID);
 	con.AddConsoleCommand("UCMachine::tracePID", ConCmd_tracePID);
@@ -117,6 +120,7 @@ UCMachine::~UCMachine()
 
 	con.RemoveConsoleCommand(UCMachine::ConCmd_getGlobal);
 	con.RemoveConsoleCommand(UCMachine::ConCmd_setGlobal);
+	con.RemoveConsoleCommand(UCMachine::ConCmd_profile);
 #ifdef DEBUG
 	con.RemoveConsoleCommand(UCMachine::ConCmd_traceObjID);
 	con.RemoveConsoleCommand(UCMachine::ConCmd_tracePID);
@@ -141,11 +145,11 @@ void UCMachine::reset()
 	globals->setSize(0x1000);
 
 	// clear strings, lists
-	std::map<uint16, UCList*>::iterator iter;
-	for (iter = listHeap.begin(); iter != listHeap.end(); ++iter)
-		delete (iter->second);
+	for (unsigned int i = 0; i < listHeap.size(); ++i)
+		delete listHeap[i];
 	listHeap.clear();
 	stringHeap.clear();
+	stringUsed.clear();
 }
 
 void UCMachine::loadIntrinsics(Intrinsic *i, unsigned int icount)
@@ -158,10 +162,14 @@ void UCMachine::execProcess(UCProcess* p)
 {
 	assert(p);
 
-	uint32 base = p->usecode->get_class_base_offset(p->classid);
-	IBufferDataSource cs(p->usecode->get_class(p->classid) + base,
-						 p->usecode->get_class_size(p->classid) - base);
-	cs.seek(p->ip);
+	UCProcess* previous = running;
+	running = p;
+
+	bool profiling = profiler.isRunning();
+	if (profiling)
+		profiler.beginSlice(p->pid, p->classid, p->ip);
+
+	UCCode* code = p->usecode->get_code(p->classid);
 
 #ifdef DEBUG
 	if (trace_show(p->pid, p->item_num, p->classid)) {
@@ -177,10 +185,20 @@ void UCMachine::execProcess(UCProcess* p)
 
 	while(!cede && !error && !p->is_terminated())
 	{
-		//! guard against reading past end of class
 		//! guard against other error conditions
 
-		uint8 opcode = cs.read1();
+		const UCInstruction& ins = code->get(p->ip);
+		if (!ins.complete) {
+			perr << "Reading past end of class " << std::hex << p->classid
+				 << std::dec << std::endl;
+			error = true;
+			break;
+		}
+
+		uint8 opcode = ins.opcode;
+		uint32 nextip = ins.next;
+
+		if (profiling) profiler.instruction();
 
 #ifdef DEBUG
 		uint16 trace_classid = p->classid;
@@ -205,7 +223,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x00:
 			// 00 xx
 			// pop 16 bit int, and assign LS 8 bit int into bp+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.pop2();
 			p->stack.assign1(p->bp+si8a, static_cast<uint8>(ui16a));
 			LOGPF(("pop byte\t%s = %02Xh\n", print_bp(si8a), ui16a));
@@ -214,7 +232,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x01:
 			// 01 xx
 			// pop 16 bit int into bp+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.pop2();
 			p->stack.assign2(p->bp+si8a, ui16a);
 			LOGPF(("pop\t\t%s = %04Xh\n", print_bp(si8a), ui16a));
@@ -223,7 +241,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x02:
 			// 02 xx
 			// pop 32 bit int into bp+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui32a = p->stack.pop4();
 			p->stack.assign4(p->bp+si8a, ui32a);
 			LOGPF(("pop dword\t%s = %08Xh\n", print_bp(si8a), ui32a));
@@ -233,8 +251,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// 03 xx yy
 			// pop yy bytes into bp+xx
 			{
-				si8a = static_cast<sint8>(cs.read1());
-				uint8 size = cs.read1();
+				si8a = static_cast<sint8>(ins.op[0]);
+				uint8 size = ins.op[1];
 				uint8 buf[256];
 				p->stack.pop(buf, size);
 				p->stack.assign(p->bp+si8a, buf, size);
@@ -256,9 +274,9 @@ void UCMachine::execProcess(UCProcess* p)
 			// 09 xx yy zz
 			// pop yy bytes into an element of list bp+xx (or slist if zz set)
 		{
-			si8a = static_cast<sint8>(cs.read1());
-			ui32a = cs.read1();
-			si8b = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
+			ui32a = ins.op[1];
+			si8b = static_cast<sint8>(ins.op[2]);
 			LOGPF(("assign element\t%s (%02X) (slist==%02X)\n",
 				   print_bp(si8a), ui32a, si8b));
 			ui16a = p->stack.pop2()-1; // index
@@ -291,7 +309,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x0A:
 			// 0A xx
 			// push sign-extended 8 bit xx onto the stack as 16 bit
-			ui16a = static_cast<sint8>(cs.read1());
+			ui16a = static_cast<sint8>(ins.op[0]);
 			p->stack.push2(ui16a);
 			LOGPF(("push byte\t%04Xh\n", ui16a));
 			break;
@@ -299,7 +317,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x0B:
 			// 0B xx xx
 			// push 16 bit xxxx onto the stack
-			ui16a = cs.read2();
+			ui16a = ins.op[0];
 			p->stack.push2(ui16a);
 			LOGPF(("push\t\t%04Xh\n", ui16a));
 			break;
@@ -307,7 +325,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x0C:
 			// 0C xx xx xx xx
 			// push 32 bit xxxxxxxx onto the stack
-			ui32a = cs.read4();
+			ui32a = ins.op[0];
 			p->stack.push4(ui32a);
 			LOGPF(("push dword\t%08Xh\n", ui32a));
 			break;
@@ -316,9 +334,9 @@ void UCMachine::execProcess(UCProcess* p)
 			// 0D xx xx yy ... yy 00
 			// push string (yy ... yy) of length xx xx onto the stack
 			{
-				ui16a = cs.read2();
+				ui16a = ins.op[0];
 				char *str = new char[ui16a+1];
-				cs.read(str, ui16a);
+				std::memcpy(str, code->getData() + ins.op[1], ui16a);
 				str[ui16a] = 0;
 
 				// REALLY MAJOR HACK:
@@ -332,7 +350,7 @@ void UCMachine::execProcess(UCProcess* p)
 
 
 				LOGPF(("push string\t\"%s\"\n", str));
-				ui16b = cs.read1();
+				ui16b = ins.op[2];
 				if (ui16b != 0) {
 					perr << "Zero terminator missing in push string"
 					     << std::endl;
@@ -348,8 +366,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// pop yy values of size xx and push the resulting list
 			// (list is created in reverse order)
 			{
-				ui16a = cs.read1();
-				ui16b = cs.read1();
+				ui16a = ins.op[0];
+				ui16b = ins.op[1];
 				UCList* l = new UCList(ui16a, ui16b);
 				p->stack.addSP(ui16a * (ui16b - 1));
 				for (unsigned int i = 0; i < ui16b; i++) {
@@ -372,8 +390,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// NB: do not actually pop these argument bytes
 			{
 				//! TODO
-				uint16 arg_bytes = cs.read1();
-				uint16 func = cs.read2();
+				uint16 arg_bytes = ins.op[0];
+				uint16 func = ins.op[1];
 				LOGPF(("calli\t\t%04Xh (%02Xh arg bytes) %s \n", func, arg_bytes, convuse->intrinsics()[func]));
 
 				// !constants
@@ -386,13 +404,15 @@ void UCMachine::execProcess(UCProcess* p)
 						intrinsics[func] == UCMachine::I_true) {
 //						perr << "Unhandled intrinsic \'" << convuse->intrinsics()[func] << "\' (" << std::hex << func << std::dec << ") called" << std::endl;
 					}
-					uint8 *argbuf = new uint8[arg_bytes];
+					// arg_bytes is a single byte, so this always fits.
+					// A copy, as the intrinsic may change the stack.
+					uint8 argbuf[256];
 					p->stack.pop(argbuf, arg_bytes);
 					p->stack.addSP(-arg_bytes); // don't really pop the args
 
+					if (profiling) profiler.beginIntrinsic(func, p->ip);
 					p->temp32 = intrinsics[func](argbuf, arg_bytes);
-
-					delete[] argbuf;
+					if (profiling) profiler.endIntrinsic();
 				}
 
 
@@ -416,22 +436,22 @@ void UCMachine::execProcess(UCProcess* p)
 			// Crusader:
 			// call function number yy yy of class xx xx
 			{
-				uint16 new_classid = cs.read2();
-				uint16 new_offset = cs.read2();
+				uint16 new_classid = ins.op[0];
+				uint16 new_offset = ins.op[1];
 				LOGPF(("call\t\t%04X:%04X\n", new_classid, new_offset));
 				if (GAME_IS_CRUSADER) {
 					new_offset = p->usecode->get_class_event(new_classid,
 															 new_offset);
 				}
 
-				p->ip = static_cast<uint16>(cs.getPos());	// Truncates!!
+				uint16 callip = p->ip;
+				p->ip = static_cast<uint16>(nextip);
 				p->call(new_classid, new_offset);
+				if (profiling) profiler.call(callip, p->classid, p->ip);
 
 				// Update the code segment
-				uint32 base = p->usecode->get_class_base_offset(p->classid);
-				cs.load(p->usecode->get_class(p->classid) + base,
-						p->usecode->get_class_size(p->classid) - base);
-				cs.seek(p->ip);
+				code = p->usecode->get_code(p->classid);
+				nextip = p->ip;
 
 				// Resume execution
 			}
@@ -484,6 +504,15 @@ void UCMachine::execProcess(UCProcess* p)
 				error = true;
 				break;
 			}
+			if (ui16b >= stringHeap.size()) {
+				stringHeap.resize(ui16b + 1);
+				stringUsed.resize(ui16b + 1);
+			}
+			if (!stringUsed[ui16b]) {
+				// appending to a freed string starts it anew
+				stringHeap[ui16b].clear();
+				stringUsed[ui16b] = true;
+			}
 			stringHeap[ui16b] += getString(ui16a);
 			freeString(ui16a);
 			p->stack.push2(ui16b);
@@ -532,7 +561,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x19:
 			// 19 02
 			// add two stringlists, removing duplicates
-			ui32a = cs.read1();
+			ui32a = ins.op[0];
 			if (ui32a != 2) {
 				perr << "Unhandled operand " << ui32a << " to union slist"
 				     << std::endl;
@@ -551,7 +580,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// substract string list
 			// NB: this one takes a length parameter in crusader. (not in U8)!!
 			// (or rather, it seems it takes one after all? -wjp,20030511)
-			ui32a = cs.read1(); // elementsize
+			ui32a = ins.op[0]; // elementsize
 			ui32a = 2;
 			ui16a = p->stack.pop2();
 			ui16b = p->stack.pop2();
@@ -566,7 +595,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// pop two lists from the stack and remove the 2nd from the 1st
 			// (free the originals? order?)
 			// only occurs in crusader.
-			ui32a = cs.read1(); // elementsize
+			ui32a = ins.op[0]; // elementsize
 			ui16a = p->stack.pop2();
 			ui16b = p->stack.pop2();
 			getList(ui16b)->substractList(*getList(ui16a));
@@ -926,8 +955,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// is element (size xx) in list? (or slist if yy is true)
 			// free list/slist afterwards
 
-			ui16a = cs.read1();
-			ui32a = cs.read1();
+			ui16a = ins.op[0];
+			ui32a = ins.op[1];
 			ui16b = p->stack.pop2();
 			if (ui32a) { // stringlist
 				if (ui16a != 2) {
@@ -1003,7 +1032,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x3E:
 			// 3E xx
 			// push the value of the unsigned 8 bit local var xx as 16 bit int
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access1(p->bp+si8a);
 			p->stack.push2(ui16a);
 			LOGPF(("push byte\t%s = %02Xh\n", print_bp(si8a), ui16a));
@@ -1012,7 +1041,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x3F:
 			// 3F xx
 			// push the value of the 16 bit local var xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->bp+si8a);
 			p->stack.push2(ui16a);
 			LOGPF(("push\t\t%s = %04Xh\n", print_bp(si8a), ui16a));
@@ -1021,7 +1050,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x40:
 			// 40 xx
 			// push the value of the 32 bit local var xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui32a = p->stack.access4(p->bp+si8a);
 			p->stack.push4(ui32a);
 			LOGPF(("push dword\t%s = %08Xh\n", print_bp(si8a), ui32a));
@@ -1032,7 +1061,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// push the string local var xx
 			// duplicating the string?
 			{
-				si8a = static_cast<sint8>(cs.read1());
+				si8a = static_cast<sint8>(ins.op[0]);
 				ui16a = p->stack.access2(p->bp+si8a);
 				p->stack.push2(duplicateString(ui16a));
 				LOGPF(("push string\t%s\n", print_bp(si8a)));
@@ -1044,8 +1073,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// push the list (with yy size elements) at BP+xx
 			// duplicating the list?
 			{
-				si8a = static_cast<sint8>(cs.read1());
-				ui16a = cs.read1();
+				si8a = static_cast<sint8>(ins.op[0]);
+				ui16a = ins.op[1];
 				ui16b = p->stack.access2(p->bp+si8a);
 				UCList* l = new UCList(ui16a);
 				if (getList(ui16b)) {
@@ -1068,8 +1097,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// push the stringlist local var xx
 			// duplicating the list, duplicating the strings in the list
 			{
-				si8a = static_cast<sint8>(cs.read1());
-//!U8				ui16a = cs.read1();
+				si8a = static_cast<sint8>(ins.op[0]);
+//!U8				ui16a = ins.op[1];
 				ui16a = 2;
 				ui16b = p->stack.access2(p->bp+si8a);
 				UCList* l = new UCList(ui16a);
@@ -1097,8 +1126,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// in two places in U8: once it pops into temp afterwards,
 			// once it is indeed freed. So, guessing we should duplicate.
 		{
-			ui32a = cs.read1();
-			ui32b = cs.read1();
+			ui32a = ins.op[0];
+			ui32b = ins.op[1];
 			ui16a = p->stack.pop2()-1; // index
 			ui16b = p->stack.pop2(); // list
 			UCList* l = getList(ui16b);
@@ -1122,8 +1151,8 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x45:
 			// 45 xx yy
 			// push huge of size yy from BP+xx
-			si8a = static_cast<sint8>(cs.read1());
-			ui16b = cs.read1();
+			si8a = static_cast<sint8>(ins.op[0]);
+			ui16b = ins.op[1];
 			p->stack.push(p->stack.access(p->bp+si8a), ui16b);
 			LOGPF(("push huge\t%s %02X\n", print_bp(si8a), ui16b));
 			break;
@@ -1131,7 +1160,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x4B:
 			// 4B xx
 			// push 32 bit pointer address of BP+XX
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			p->stack.push4(stackToPtr(p->pid, p->bp+si8a));
 			LOGPF(("push addr\t%s\n", print_bp(si8a)));
 			break;
@@ -1142,7 +1171,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// pops a 32 bit pointer off the stack and pushes xx bytes
 			// from the location referenced by the pointer
 			{
-				ui16a = cs.read1();
+				ui16a = ins.op[0];
 				ui32a = p->stack.pop4();
 
 				p->stack.addSP(-ui16a);
@@ -1166,7 +1195,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// pops a 32 bit pointer off the stack and pushes xx bytes
 			// from the location referenced by the pointer
 			{
-				ui16a = cs.read1();
+				ui16a = ins.op[0];
 				ui32a = p->stack.pop4();
 
 				if (assignPointer(ui32a, p->stack.access(), ui16a)) {
@@ -1182,8 +1211,8 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x4E:
 			// 4E xx xx yy
 			// push global xxxx size yy bits
-			ui16a = cs.read2();
-			ui16b = cs.read1();
+			ui16a = ins.op[0];
+			ui16b = ins.op[1];
 			// TODO: get flagname for output?
 
 			ui32a = globals->getBits(ui16a, ui16b);
@@ -1194,8 +1223,8 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x4F:
 			// 4F xx xx yy
 			// pop value into global xxxx size yy bits
-			ui16a = cs.read2();
-			ui16b = cs.read1();
+			ui16a = ins.op[0];
+			ui16b = ins.op[1];
 			// TODO: get flagname for output?
 			ui32a = p->stack.pop2();
 			globals->setBits(ui16a, ui16b, ui32a);
@@ -1214,6 +1243,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// 50
 			// return from function
 
+			if (profiling) profiler.ret();
+
 			if (p->ret()) { // returning from process
 				// TODO
 				LOGPF(("ret\t\tfrom process\n"));
@@ -1228,10 +1259,8 @@ void UCMachine::execProcess(UCProcess* p)
 				// return value is stored in temp32 register
 
 				// Update the code segment
-				uint32 base = p->usecode->get_class_base_offset(p->classid);
-				cs.load(p->usecode->get_class(p->classid) + base,
-						p->usecode->get_class_size(p->classid) - base);
-				cs.seek(p->ip);
+				code = p->usecode->get_code(p->classid);
+				nextip = p->ip;
 			}
 
 			// Resume execution
@@ -1240,26 +1269,24 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x51:
 			// 51 xx xx
 			// relative jump to xxxx if false
-			si16a = static_cast<sint16>(cs.read2());
+			si16a = static_cast<sint16>(ins.op[0]);
 			ui16b = p->stack.pop2();
 			if (!ui16b) {
-				ui16a = cs.getPos() + si16a;
-				cs.seek(ui16a);
+				nextip = ins.target;
 				LOGPF(("jne\t\t%04hXh\t(to %04X) (taken)\n", si16a,
-					   cs.getPos()));
+					   nextip));
 			} else {
 				LOGPF(("jne\t\t%04hXh\t(to %04X) (not taken)\n", si16a,
-					   cs.getPos()));
+					   nextip));
 			}
 			break;
 
 		case 0x52:
 			// 52 xx xx
 			// relative jump to xxxx
-			si16a = static_cast<sint16>(cs.read2());
-			ui16a = cs.getPos() + si16a;
-			cs.seek(ui16a);
-			LOGPF(("jmp\t\t%04hXh\t(to %04X)\n", si16a, cs.getPos()));
+			si16a = static_cast<sint16>(ins.op[0]);
+			nextip = ins.target;
+			LOGPF(("jmp\t\t%04hXh\t(to %04X)\n", si16a, nextip));
 			break;
 
 		case 0x53:
@@ -1291,7 +1318,6 @@ void UCMachine::execProcess(UCProcess* p)
 			// an 'implies'
 
 			{
-				cs.read2(); // skip the 01 01
 				ui16a = p->stack.pop2();
 				ui16b = p->stack.pop2();
 				p->stack.push2(ui16a); //!! which pid do we need to push!?
@@ -1331,10 +1357,10 @@ void UCMachine::execProcess(UCProcess* p)
 			// only remove the this pointer from stack (4 bytes)
 			// put PID of spawned process in temp			
 			{
-				int arg_bytes = cs.read1();
-				int this_size = cs.read1();
-				uint16 classid = cs.read2();
-				uint16 offset = cs.read2();
+				int arg_bytes = ins.op[0];
+				int this_size = ins.op[1];
+				uint16 classid = ins.op[2];
+				uint16 offset = ins.op[3];
 
 				uint32 thisptr = p->stack.pop4();
 				
@@ -1379,11 +1405,11 @@ void UCMachine::execProcess(UCProcess* p)
 			// uu = unknown (occurring values: 00, 02, 05)
 
 			{
-				uint16 classid = cs.read2();
-				uint16 offset = cs.read2();
-				uint16 delta = cs.read2();
-				int this_size = cs.read1();
-				uint32 unknown = cs.read1(); // ??
+				uint16 classid = ins.op[0];
+				uint16 offset = ins.op[1];
+				uint16 delta = ins.op[2];
+				int this_size = ins.op[3];
+				uint32 unknown = ins.op[4]; // ??
 				
 				LOGPF(("spawn inline\t%04X:%04X+%04X=%04X %02X %02X\n",
 					   classid,offset,delta,offset+delta,this_size, unknown));
@@ -1424,7 +1450,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// 5A xx
 			// init function. xx = local var size
 			// sets xx bytes on stack to 0, moving sp
-			ui16a = cs.read1();
+			ui16a = ins.op[0];
 			LOGPF(("init\t\t%02X\n", ui16a));
 			
 			if (ui16a & 1) ui16a++; // 16-bit align
@@ -1476,7 +1502,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x62:
 			// 62 xx
 			// free the string in var BP+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->bp+si8a);
 			freeString(ui16a);
 			LOGPF(("free string\t%s = %04X\n", print_bp(si8a), ui16a));
@@ -1485,7 +1511,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x63:
 			// 63 xx
 			// free the stringlist in var BP+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->bp+si8a);
 			freeStringList(ui16a);
 			LOGPF(("free slist\t%s = %04X\n", print_bp(si8a), ui16a));
@@ -1494,7 +1520,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x64:
 			// 64 xx
 			// free the list in var BP+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->bp+si8a);
 			freeList(ui16a);
 			LOGPF(("free list\t%s = %04X\n", print_bp(si8a), ui16a));
@@ -1505,7 +1531,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// free the string at SP+xx
 			// NB: sometimes there's a 32-bit string pointer at SP+xx
 			//     However, the low word of this is exactly the 16bit ref
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->stack.getSP()+si8a);
 			freeString(ui16a);
 			LOGPF(("free string\t%s = %04X\n", print_sp(si8a), ui16a));
@@ -1514,7 +1540,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x66:
 			// 66 xx
 			// free the list at SP+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->stack.getSP()+si8a);
 			freeList(ui16a);
 			LOGPF(("free list\t%s = %04X\n", print_sp(si8a), ui16a));
@@ -1523,7 +1549,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x67:
 			// 67 xx
 			// free the string list at SP+xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->stack.getSP()+si8a);
 			freeStringList(ui16a);
 			LOGPF(("free slist\t%s = %04x\n", print_sp(si8a), ui16a));
@@ -1532,7 +1558,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x69:
 			// 69 xx
 			// push the string in var BP+xx as 32 bit pointer			
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			ui16a = p->stack.access2(p->bp+si8a);
 			p->stack.push4(stringToPtr(ui16a));
 			LOGPF(("str to ptr\t%s\n", print_bp(si8a)));
@@ -1551,8 +1577,8 @@ void UCMachine::execProcess(UCProcess* p)
 			// yy = type (01 = string, 02 = slist, 03 = list)
 			// copy the (string/slist/list) in BP+xx to the current process,
 			// and add it to the "Free Me" list of the process
-			si8a = cs.read1(); // index
-			ui8a = cs.read1(); // type
+			si8a = ins.op[0]; // index
+			ui8a = ins.op[1]; // type
 			LOGPF(("param pid chg\t%s, type=%u\n", print_bp(si8a), ui8a));
 
 			ui16a = p->stack.access2(p->bp+si8a);
@@ -1596,7 +1622,7 @@ void UCMachine::execProcess(UCProcess* p)
 			// 6E xx
 			// substract xx from stack pointer
 			// (effect on SP is the same as popping xx bytes)
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			p->stack.addSP(-si8a);
 			LOGPF(("move sp\t\t%s%02Xh\n", si8a<0?"-":"", si8a<0?-si8a:si8a));
 			break;
@@ -1605,7 +1631,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x6F:
 			// 6F xx
 			// push 32 pointer address of SP-xx
-			si8a = static_cast<sint8>(cs.read1());
+			si8a = static_cast<sint8>(ins.op[0]);
 			p->stack.push4(stackToPtr(p->pid, static_cast<uint16>(p->stack.getSP() - si8a)));
 			LOGPF(("push addr\t%s\n", print_sp(-si8a)));
 			break;
@@ -1627,9 +1653,9 @@ void UCMachine::execProcess(UCProcess* p)
 			// yy == num bytes in string
 			// zz == type
 			{
-				si16a = cs.readXS(1);
-				uint32 scriptsize = cs.read1();
-				uint32 searchtype = cs.read1();
+				si16a = static_cast<sint8>(ins.op[0]);
+				uint32 scriptsize = ins.op[1];
+				uint32 searchtype = ins.op[2];
 
 				ui16a = p->stack.pop2();
 				ui16b = p->stack.pop2();
@@ -1652,7 +1678,7 @@ void UCMachine::execProcess(UCProcess* p)
 					break;
 				}
 
-				uint8* script = new uint8[scriptsize];
+				uint8 script[0x20];
 				p->stack.pop(script, scriptsize);
 
 				uint32 stacksize = 0;
@@ -1734,7 +1760,6 @@ void UCMachine::execProcess(UCProcess* p)
 				default:
 					perr << "Unhandled search type " << searchtype <<std::endl;
 					error = true;
-					delete[] script;
 					break;
 				}
 
@@ -1746,8 +1771,6 @@ void UCMachine::execProcess(UCProcess* p)
 				uint16 itemlistID = assignList(itemlist);
 				p->stack.push2(itemlistID);
 
-				delete[] script;
-
 				LOGPF(("loop\t\t%s %02X %02X\n", print_bp(si16a),
 					   scriptsize, searchtype));
 			}
@@ -1812,7 +1835,7 @@ void UCMachine::execProcess(UCProcess* p)
 		case 0x74:
 			// 74 xx
 			// add xx to the current 'loopscript'
-			ui8a = cs.read1();
+			ui8a = ins.op[0];
 			p->stack.push1(ui8a);
 			LOGPF(("loopscr\t\t%02X \"%c\"\n", ui8a, static_cast<char>(ui8a)));
 			break;
@@ -1857,9 +1880,9 @@ void UCMachine::execProcess(UCProcess* p)
 			// Strings are _not_ duplicated when putting them in the loopvar
 			// Lists _are_ freed afterwards
 
-			si8a = cs.read1();	// loop variable
-			ui32a = cs.read1(); // list size
-			si16a = cs.read2(); // jump offset
+			si8a = ins.op[0];	// loop variable
+			ui32a = ins.op[1]; // list size
+			si16a = ins.op[2]; // jump offset
 
 			ui16a = p->stack.access2(p->stack.getSP());		// Loop index
 			ui16b = p->stack.access2(p->stack.getSP()+2);	// Loop list
@@ -1893,8 +1916,7 @@ void UCMachine::execProcess(UCProcess* p)
 				p->stack.addSP(4);	// Pop list and counter
 
 				// jump out
-				ui16a = cs.getPos() + si16a;
-				cs.seek(ui16a);
+				nextip = ins.target;
 			}
 			else
 			{
@@ -1962,7 +1984,7 @@ void UCMachine::execProcess(UCProcess* p)
 
 		// write back IP (but preserve IP if there was an error)
 		if (!error)
-			p->ip = static_cast<uint16>(cs.getPos());	// TRUNCATES!
+			p->ip = static_cast<uint16>(nextip);	// TRUNCATES!
 
 		// check if we suspended ourselves
 		if((p->flags & Process::PROC_SUSPENDED)!=0)
@@ -1974,6 +1996,20 @@ void UCMachine::execProcess(UCProcess* p)
 		            p->pid, p->classid, p->ip);
 		p->terminateDeferred();
 	}
+
+	if (profiling)
+		profiler.endSlice(previous ? previous->pid : 0);
+	running = previous;
+}
+
+//static
+UCProcess* UCMachine::getStackProcess(uint16 pid)
+{
+	// intrinsics mostly get pointers into the stack of their caller
+	if (running && running->getPid() == pid)
+		return running;
+
+	return p_dynamic_cast<UCProcess*>(Kernel::get_instance()->getProcess(pid));
 }
 
 
@@ -1981,29 +2017,38 @@ std::string& UCMachine::getString(uint16 str)
 {
 	static std::string emptystring("");
 
-	std::map<uint16, std::string>::iterator iter = stringHeap.find(str);
-
-	if (iter != stringHeap.end())
-		return iter->second;
+	if (str < stringHeap.size() && stringUsed[str])
+		return stringHeap[str];
 
 	return emptystring;
 }
 
 UCList* UCMachine::getList(uint16 l)
 {
-	std::map<uint16, UCList*>::iterator iter = listHeap.find(l);
-
-	if (iter != listHeap.end())
-		return iter->second;
+	if (l < listHeap.size())
+		return listHeap[l];
 
 	return 0;
 }
 
 
+uint16 UCMachine::newString()
+{
+	uint16 id = stringIDs->getNewID();
+	if (id == 0) return 0;
+
+	if (id >= stringHeap.size()) {
+		stringHeap.resize(id + 1);
+		stringUsed.resize(id + 1);
+	}
+	stringUsed[id] = true;
+
+	return id;
+}
 
 uint16 UCMachine::assignString(const char* str)
 {
-	uint16 id = stringIDs->getNewID();
+	uint16 id = newString();
 	if (id == 0) return 0;
 
 	stringHeap[id] = str;
@@ -2013,7 +2058,13 @@ uint16 UCMachine::assignString(const char* str)
 
 uint16 UCMachine::duplicateString(uint16 str)
 {
-	return assignString(stringHeap[str].c_str());
+	// get the ID first; growing stringHeap moves the strings
+	uint16 id = newString();
+	if (id == 0) return 0;
+
+	stringHeap[id] = getString(str);
+
+	return id;
 }
 
 
@@ -2021,7 +2072,10 @@ uint16 UCMachine::assignList(UCList* l)
 {
 	uint16 id = listIDs->getNewID();
 	if (id == 0) return 0;
-	assert(listHeap.find(id) == listHeap.end());
+
+	if (id >= listHeap.size())
+		listHeap.resize(id + 1, 0);
+	assert(listHeap[id] == 0);
 
 	listHeap[id] = l;
 
@@ -2030,37 +2084,32 @@ uint16 UCMachine::assignList(UCList* l)
 
 void UCMachine::freeString(uint16 s)
 {
-	//! There's still a semi-bug in some places that string 0 can be assigned
-	//! (when something accesses stringHeap[0])
-	//! This may not be desirable, but OTOH the created string will be
-	//! empty, so not too much of a problem.
-	std::map<uint16, std::string>::iterator iter = stringHeap.find(s);
-	if (iter != stringHeap.end()) {
-		stringHeap.erase(iter);
+	if (s < stringHeap.size() && stringUsed[s]) {
+		stringUsed[s] = false;
 		stringIDs->clearID(s);
 	}
 }
 
 void UCMachine::freeList(uint16 l)
 {
-	std::map<uint16, UCList*>::iterator iter = listHeap.find(l);
-	if (iter != listHeap.end() && iter->second) {
-		iter->second->free();
-		delete iter->second;
-		listHeap.erase(iter);
+	UCList* list = getList(l);
+	if (list) {
+		list->free();
+		delete list;
+		listHeap[l] = 0;
 		listIDs->clearID(l);
 	}
 }
 
 void UCMachine::freeStringList(uint16 l)
 {
-	std::map<uint16, UCList*>::iterator iter = listHeap.find(l);
-	if (iter != listHeap.end() && iter->second) {
-		iter->second->freeStrings();
-		delete iter->second;
-		listHeap.erase(iter);
+	UCList* list = getList(l);
+	if (list) {
+		list->freeStrings();
+		delete list;
+		listHeap[l] = 0;
 		listIDs->clearID(l);
-	}	
+	}
 }
 
 //static
@@ -2122,8 +2171,7 @@ bool UCMachine::assignPointer(uint32 ptr, const uint8* data, uint32 size)
 
 	if (segment >= SEG_STACK_FIRST && segment <= SEG_STACK_LAST)
 	{
-		UCProcess *proc = p_dynamic_cast<UCProcess*>
-			(Kernel::get_instance()->getProcess(segment));
+		UCProcess *proc = getStackProcess(segment);
 		
 		// reference to the stack of pid 'segment'
 		if (!proc) {
@@ -2165,8 +2213,7 @@ bool UCMachine::dereferencePointer(uint32 ptr, uint8* data, uint32 size)
 	
 	if (segment >= SEG_STACK_FIRST && segment <= SEG_STACK_LAST)
 	{
-		UCProcess *proc = p_dynamic_cast<UCProcess*>
-			(Kernel::get_instance()->getProcess(segment));
+		UCProcess *proc = getStackProcess(segment);
 		
 		// reference to the stack of pid 'segment'
 		if (!proc) {
@@ -2212,8 +2259,7 @@ uint16 UCMachine::ptrToObject(uint32 ptr)
 	uint16 offset = static_cast<uint16>(ptr);
 	if (segment >= SEG_STACK_FIRST && segment <= SEG_STACK_LAST)
 	{
-		UCProcess *proc = p_dynamic_cast<UCProcess*>
-			(Kernel::get_instance()->getProcess(segment));
+		UCProcess *proc = getStackProcess(segment);
 
 		// reference to the stack of pid 'segment'
 		if (!proc) {
@@ -2242,33 +2288,80 @@ uint16 UCMachine::ptrToObject(uint32 ptr)
 	}
 }
 
+const char* UCMachine::getIntrinsicName(uint16 func) const
+{
+	const char* const* names = convuse->intrinsics();
+	for (unsigned int i = 0; names[i]; ++i)
+		if (i == func) return names[i];
+	return 0;
+}
+
+void UCMachine::ConCmd_profile(const Console::ArgvType &argv)
+{
+	UCProfiler& profiler = UCMachine::get_instance()->getProfiler();
+
+	if (argv.size() == 1) {
+		profiler.print(10);
+		return;
+	}
+
+	const std::string& cmd = argv[1];
+	if (cmd == "start") {
+		profiler.start();
+		pout << "Usecode profiler started" << std::endl;
+	} else if (cmd == "stop") {
+		profiler.stop();
+		pout << "Usecode profiler stopped" << std::endl;
+	} else if (cmd == "reset") {
+		profiler.reset();
+	} else if (cmd == "top" && argv.size() >= 3) {
+		profiler.print(static_cast<unsigned int>(strtol(argv[2].c_str(),
+														0, 0)));
+	} else if (cmd == "folded" || cmd == "foldedtime") {
+		std::string filename = "@home/usecode.folded";
+		if (argv.size() >= 3) filename = argv[2];
+
+		if (!profiler.writeFolded(filename, cmd == "foldedtime"))
+			pout << "Unable to open " << filename << std::endl;
+		else
+			pout << "Usecode call stacks written to " << filename
+				 << std::endl;
+	} else {
+		pout << "usage: UCMachine::profile [start|stop|reset|top <n>|"
+			 << "folded [<file>]|foldedtime [<file>]]" << std::endl;
+	}
+}
+
 void UCMachine::usecodeStats()
 {
 	pout << "Usecode Machine memory stats:" << std::endl;
-	pout << "Strings    : " << stringHeap.size() << "/65534" << std::endl;
+	unsigned int stringcount = 0, listcount = 0;
+	for (unsigned int i = 0; i < stringUsed.size(); ++i)
+		if (stringUsed[i]) stringcount++;
+	for (unsigned int i = 0; i < listHeap.size(); ++i)
+		if (listHeap[i]) listcount++;
+
+	pout << "Strings    : " << stringcount << "/65534" << std::endl;
 #ifdef DUMPHEAP
-	std::map<uint16, std::string>::iterator iter;
-	for (iter = stringHeap.begin(); iter != stringHeap.end(); ++iter)
-		pout << iter->first << ":" << iter->second << std::endl;
+	for (unsigned int i = 0; i < stringHeap.size(); ++i)
+		if (stringUsed[i])
+			pout << i << ":" << stringHeap[i] << std::endl;
 #endif
-	pout << "Lists      : " << listHeap.size() << "/65534" << std::endl;
+	pout << "Lists      : " << listcount << "/65534" << std::endl;
 #ifdef DUMPHEAP
-	std::map<uint16, UCList*>::iterator iterl;
-	for (iterl = listHeap.begin(); iterl != listHeap.end(); ++iterl) {
-		if (!iterl->second) {
-			pout << iterl->first << ": <null>" << std::endl;
-			continue;
-		}
-		if (iterl->second->getElementSize() == 2) {
-			pout << iterl->first << ":";
-			for (unsigned int i = 0; i < iterl->second->getSize(); ++i) {
-				if (i > 0) pout << ",";
-				pout << iterl->second->getuint16(i);
+	for (unsigned int i = 0; i < listHeap.size(); ++i) {
+		UCList* l = listHeap[i];
+		if (!l) continue;
+		if (l->getElementSize() == 2) {
+			pout << i << ":";
+			for (unsigned int j = 0; j < l->getSize(); ++j) {
+				if (j > 0) pout << ",";
+				pout << l->getuint16(j);
 			}				
 			pout << std::endl;
 		} else {
-			pout << iterl->first << ": " << iterl->second->getSize()
-				 << " elements of size " << iterl->second->getElementSize()
+			pout << i << ": " << l->getSize()
+				 << " elements of size " << l->getElementSize()
 				 << std::endl;
 		}
 	}
@@ -2283,27 +2376,35 @@ void UCMachine::saveGlobals(ODataSource* ods)
 void UCMachine::saveStrings(ODataSource* ods)
 {
 	stringIDs->save(ods);
-	ods->write4(static_cast<uint32>(stringHeap.size()));
 
-	std::map<uint16, std::string>::iterator iter;
-	for (iter = stringHeap.begin(); iter != stringHeap.end(); ++iter)
+	uint32 stringcount = 0;
+	for (unsigned int i = 0; i < stringUsed.size(); ++i)
+		if (stringUsed[i]) stringcount++;
+	ods->write4(stringcount);
+
+	for (unsigned int i = 0; i < stringHeap.size(); ++i)
 	{
-		ods->write2((*iter).first);
-		ods->write4((*iter).second.size());
-		ods->write((*iter).second.c_str(), (*iter).second.size());
+		if (!stringUsed[i]) continue;
+		ods->write2(static_cast<uint16>(i));
+		ods->write4(stringHeap[i].size());
+		ods->write(stringHeap[i].c_str(), stringHeap[i].size());
 	}
 }
 
 void UCMachine::saveLists(ODataSource* ods)
 {
 	listIDs->save(ods);
-	ods->write4(listHeap.size());
 
-	std::map<uint16, UCList*>::iterator iter;
-	for (iter = listHeap.begin(); iter != listHeap.end(); ++iter)
+	uint32 listcount = 0;
+	for (unsigned int i = 0; i < listHeap.size(); ++i)
+		if (listHeap[i]) listcount++;
+	ods->write4(listcount);
+
+	for (unsigned int i = 0; i < listHeap.size(); ++i)
 	{
-		ods->write2((*iter).first);
-		(*iter).second->save(ods);
+		if (!listHeap[i]) continue;
+		ods->write2(static_cast<uint16>(i));
+		listHeap[i]->save(ods);
 	}
 }
 
@@ -2321,6 +2422,11 @@ bool UCMachine::loadStrings(IDataSource* ids, uint32 version)
 	{
 		uint16 sid = ids->read2();
 		uint32 len = ids->read4();
+		if (sid >= stringHeap.size()) {
+			stringHeap.resize(sid + 1);
+			stringUsed.resize(sid + 1);
+		}
+		stringUsed[sid] = true;
 		if (len) {
 			char* buf = new char[len+1];
 			ids->read(buf, len);
@@ -2347,6 +2453,9 @@ bool UCMachine::loadLists(IDataSource* ids, uint32 version)
 		bool ret = l->load(ids, version);
 		if (!ret) return false;
 
+		if (lid >= listHeap.size())
+			listHeap.resize(lid + 1, 0);
+		delete listHeap[lid];
 		listHeap[lid] = l;
    	}
 
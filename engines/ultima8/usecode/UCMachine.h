@@ -19,10 +19,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef UCMACHINE_H
 #define UCMACHINE_H
 
-#include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "intrinsics.h"
+#include "UCProfiler.h"
 
 class Process;
 class UCProcess;
@@ -56,6 +58,11 @@ public:
 
 	void usecodeStats();
 
+	UCProfiler& getProfiler() { return profiler; }
+
+	//! get the name of intrinsic func, or 0 if it has none
+	const char* getIntrinsicName(uint16 func) const;
+
 	static uint32 listToPtr(uint16 l);
 	static uint32 stringToPtr(uint16 s);
 	static uint32 stackToPtr(uint16 pid, uint16 offset);
@@ -94,19 +101,35 @@ private:
 
 	BitSet* globals;
 
-	std::map<uint16, UCList*> listHeap;
-	std::map<uint16, std::string> stringHeap;
+	//! Lists and strings, indexed by their ID. A list is in use if it
+	//! isn't null, a string if its stringUsed flag is set. The strings
+	//! of freed IDs keep their buffers, so reusing an ID is cheap.
+	std::vector<UCList*> listHeap;
+	std::vector<std::string> stringHeap;
+	std::vector<bool> stringUsed;
 
 	uint16 assignString(const char* str);
 	uint16 assignList(UCList* l);
 
+	//! get a new string ID, with room for it in stringHeap
+	uint16 newString();
+
 	idMan* listIDs;
 	idMan* stringIDs;
 
 	static UCMachine* ucmachine;
 
+	//! the process execProcess is running, if any
+	static UCProcess* running;
+
+	//! get the process whose stack a pointer segment refers to
+	static UCProcess* getStackProcess(uint16 pid);
+
+	UCProfiler profiler;
+
 	static void		ConCmd_getGlobal(const Console::ArgvType &argv);
 	static void		ConCmd_setGlobal(const Console::ArgvType &argv);
+	static void		ConCmd_profile(const Console::ArgvType &argv);
 
 
 #ifdef DEBUG
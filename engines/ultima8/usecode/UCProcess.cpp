@@ -149,6 +149,8 @@ void UCProcess::terminate()
 
 	freeonterminate.clear();
 
+	UCMachine::get_instance()->getProfiler().endProcess(pid);
+
 	Process::terminate();
 }
 
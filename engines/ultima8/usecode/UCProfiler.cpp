@@ -0,0 +1,315 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "UCProfiler.h"
+#include "UCMachine.h"
+#include "Usecode.h"
+#include "GameData.h"
+#include "FileSystem.h"
+#include "ODataSource.h"
+
+#include <algorithm>
+#include <cstdio>
+
+UCProfiler::UCProfiler()
+	: running(false), frequency(1), current(0), lasttime(0), pendinginsns(0)
+{
+	reset();
+}
+
+UCProfiler::~UCProfiler()
+{
+
+}
+
+void UCProfiler::start()
+{
+	frequency = SDL_GetPerformanceFrequency();
+	if (frequency == 0) frequency = 1;
+	running = true;
+}
+
+void UCProfiler::stop()
+{
+	flush();
+	running = false;
+	current = 0;
+	stacks.clear();
+}
+
+void UCProfiler::reset()
+{
+	current = 0;
+	pendinginsns = 0;
+	stacks.clear();
+	functions.clear();
+	callsites.clear();
+	children.clear();
+
+	StackNode root = { 0, 0, 0, 0 };
+	nodes.clear();
+	nodes.push_back(root);
+}
+
+void UCProfiler::flush()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (current && !current->empty()) {
+		Uint64 time = now - lasttime;
+		Frame& top = current->back();
+		top.insns += pendinginsns;
+		top.time += time;
+		nodes[top.node].insns += pendinginsns;
+		nodes[top.node].time += time;
+		FunctionStats& stats = functions[top.key];
+		stats.insns += pendinginsns;
+		stats.time += time;
+	}
+	pendinginsns = 0;
+	lasttime = now;
+}
+
+void UCProfiler::push(uint32 key, uint16 callip)
+{
+	flush();
+
+	uint32 parent = 0;
+	if (!current->empty()) {
+		parent = current->back().node;
+
+		CallSite site;
+		site.caller = current->back().key;
+		site.ip = callip;
+		site.callee = key;
+		callsites[site]++;
+	}
+
+	std::pair<uint32, uint32> child(parent, key);
+	std::map<std::pair<uint32, uint32>, uint32>::iterator it =
+		children.find(child);
+	uint32 node;
+	if (it != children.end()) {
+		node = it->second;
+	} else {
+		node = static_cast<uint32>(nodes.size());
+		StackNode n = { key, parent, 0, 0 };
+		nodes.push_back(n);
+		children[child] = node;
+	}
+
+	Frame frame = { key, node, 0, 0, 0, 0 };
+	current->push_back(frame);
+
+	FunctionStats& stats = functions[key];
+	stats.calls++;
+	stats.active++;
+}
+
+void UCProfiler::pop()
+{
+	flush();
+	if (current->empty()) return;
+
+	Frame frame = current->back();
+	current->pop_back();
+
+	Uint64 inclinsns = frame.insns + frame.childinsns;
+	Uint64 incltime = frame.time + frame.childtime;
+
+	// count recursive calls only once, in the outermost one
+	FunctionStats& stats = functions[frame.key];
+	if (--stats.active == 0) {
+		stats.inclinsns += inclinsns;
+		stats.incltime += incltime;
+	}
+
+	if (!current->empty()) {
+		current->back().childinsns += inclinsns;
+		current->back().childtime += incltime;
+	}
+}
+
+void UCProfiler::beginSlice(uint16 pid, uint16 classid, uint16 ip)
+{
+	if (!running) return;
+
+	flush();
+	current = &stacks[pid];
+	if (current->empty())
+		push(functionKey(classid, ip), 0);
+}
+
+void UCProfiler::endSlice(uint16 previouspid)
+{
+	if (!running) return;
+
+	flush();
+	current = previouspid ? &stacks[previouspid] : 0;
+}
+
+void UCProfiler::call(uint16 callip, uint16 classid, uint16 offset)
+{
+	if (running && current) push(functionKey(classid, offset), callip);
+}
+
+void UCProfiler::ret()
+{
+	if (running && current) pop();
+}
+
+void UCProfiler::beginIntrinsic(uint16 func, uint16 callip)
+{
+	if (running && current) push(intrinsicKey(func), callip);
+}
+
+void UCProfiler::endIntrinsic()
+{
+	if (running && current) pop();
+}
+
+void UCProfiler::endProcess(uint16 pid)
+{
+	if (!running) return;
+
+	std::map<uint16, FrameStack>::iterator it = stacks.find(pid);
+	if (it == stacks.end()) return;
+
+	FrameStack* previous = current;
+	flush();
+	current = &it->second;
+	while (!current->empty())
+		pop();
+	current = (previous == &it->second) ? 0 : previous;
+	stacks.erase(it);
+}
+
+std::string UCProfiler::getName(uint32 key) const
+{
+	uint16 classid = static_cast<uint16>(key >> 16);
+	uint16 offset = static_cast<uint16>(key);
+	char buf[32];
+
+	if (classid == 0xFFFF) {
+		const char* name = UCMachine::get_instance()->getIntrinsicName(offset);
+		if (name) return name;
+		std::snprintf(buf, sizeof(buf), "Intrinsic%04X", offset);
+		return buf;
+	}
+
+	Usecode* usecode = GameData::get_instance()->getMainUsecode();
+	std::string name = usecode->get_class_name(classid);
+	std::snprintf(buf, sizeof(buf), "%04X", offset);
+	return name + "::" + buf;
+}
+
+std::string UCProfiler::getStack(uint32 node) const
+{
+	std::string stack = getName(nodes[node].key);
+	for (node = nodes[node].parent; node != 0; node = nodes[node].parent)
+		stack = getName(nodes[node].key) + ";" + stack;
+	return stack;
+}
+
+template<class T> static bool moreInsns(const T& a, const T& b)
+{
+	return a.second.insns > b.second.insns;
+}
+
+template<class T> static bool moreCalls(const T& a, const T& b)
+{
+	return a.second > b.second;
+}
+
+void UCProfiler::print(unsigned int topn)
+{
+	if (running) flush();
+
+	pout << "Usecode profile" << (running ? "" : " (stopped)") << std::endl;
+
+	// functions by instructions run in them, then intrinsics by calls
+	typedef std::pair<uint32, FunctionStats> Entry;
+	std::vector<Entry> funcs;
+	std::vector<std::pair<uint32, uint32> > intrinsics;
+	std::map<uint32, FunctionStats>::iterator it;
+	for (it = functions.begin(); it != functions.end(); ++it) {
+		if ((it->first >> 16) == 0xFFFF)
+			intrinsics.push_back(std::make_pair(it->first, it->second.calls));
+		else
+			funcs.push_back(*it);
+	}
+	std::sort(funcs.begin(), funcs.end(), moreInsns<Entry>);
+	std::sort(intrinsics.begin(), intrinsics.end(),
+			  moreCalls<std::pair<uint32, uint32> >);
+
+	pout.printf("%-28s %8s %10s %10s %9s %9s\n", "function", "calls",
+				"insns", "incl", "ms", "incl ms");
+	for (unsigned int i = 0; i < funcs.size() && i < topn; ++i) {
+		const FunctionStats& stats = funcs[i].second;
+		pout.printf("%-28s %8u %10llu %10llu %9.3f %9.3f\n",
+					getName(funcs[i].first).c_str(), stats.calls,
+					static_cast<unsigned long long>(stats.insns),
+					static_cast<unsigned long long>(stats.inclinsns),
+					toMillis(stats.time), toMillis(stats.incltime));
+	}
+
+	pout.printf("%-28s %8s %9s\n", "intrinsic", "calls", "ms");
+	for (unsigned int i = 0; i < intrinsics.size() && i < topn; ++i) {
+		const FunctionStats& stats = functions[intrinsics[i].first];
+		pout.printf("%-28s %8u %9.3f\n",
+					getName(intrinsics[i].first).c_str(), stats.calls,
+					toMillis(stats.incltime));
+	}
+
+	std::vector<std::pair<CallSite, uint32> > sites(callsites.begin(),
+												   callsites.end());
+	std::sort(sites.begin(), sites.end(),
+			  moreCalls<std::pair<CallSite, uint32> >);
+	pout << "Busiest call sites:" << std::endl;
+	for (unsigned int i = 0; i < sites.size() && i < topn; ++i) {
+		const CallSite& site = sites[i].first;
+		pout.printf("%8u  %s @%04X -> %s\n", sites[i].second,
+					getName(site.caller).c_str(), site.ip,
+					getName(site.callee).c_str());
+	}
+}
+
+bool UCProfiler::writeFolded(const std::string& filename, bool bytime)
+{
+	if (running) flush();
+
+	ODataSource* ods = FileSystem::get_instance()->WriteFile(filename, true);
+	if (!ods) return false;
+
+	for (uint32 i = 1; i < nodes.size(); ++i) {
+		Uint64 count = nodes[i].insns;
+		if (bytime)
+			count = static_cast<Uint64>(toMillis(nodes[i].time) * 1000.0);
+		if (count == 0) continue;
+
+		char buf[32];
+		std::snprintf(buf, sizeof(buf), " %llu\n",
+					  static_cast<unsigned long long>(count));
+		std::string line = getStack(i) + buf;
+		ods->write(line.c_str(), static_cast<uint32>(line.size()));
+	}
+
+	delete ods;
+	return true;
+}
@@ -0,0 +1,156 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef UCPROFILER_H
+#define UCPROFILER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "misc/sdl2_compat.h"
+
+//
+// UCProfiler. Counts the instructions run and the time spent in each usecode
+// function and intrinsic, following the calls of every UCProcess on a stack
+// of its own. Functions are known by class and offset, so the stacks of
+// processes that were already running when profiling started begin at
+// whatever function they were in.
+//
+
+class UCProfiler
+{
+public:
+	UCProfiler();
+	~UCProfiler();
+
+	void start();
+	void stop();
+	bool isRunning() const { return running; }
+
+	//! forget everything measured so far
+	void reset();
+
+	//! call when UCMachine starts running process pid at classid:ip
+	void beginSlice(uint16 pid, uint16 classid, uint16 ip);
+	//! call when UCMachine is done with it, with the pid of the process it
+	//! was running before, or 0
+	void endSlice(uint16 previouspid);
+
+	//! count an instruction of the current function
+	void instruction() { ++pendinginsns; }
+
+	//! call when the instruction at callip calls classid:offset
+	void call(uint16 callip, uint16 classid, uint16 offset);
+	//! call right before the current function returns
+	void ret();
+
+	//! call around intrinsic func, called from the instruction at callip
+	void beginIntrinsic(uint16 func, uint16 callip);
+	void endIntrinsic();
+
+	//! call when process pid terminates
+	void endProcess(uint16 pid);
+
+	//! print the 'topn' functions, intrinsics and call sites that ran the
+	//! most instructions or were called most to pout
+	void print(unsigned int topn);
+
+	//! Write the call stacks in the 'folded' format flame graph tools read:
+	//! one line per stack, with the instructions run in it (or the
+	//! microseconds spent, if bytime)
+	//! \return false if the file couldn't be opened
+	bool writeFolded(const std::string& filename, bool bytime);
+
+private:
+	//! A function is its class and offset, an intrinsic has class 0xFFFF
+	static uint32 functionKey(uint16 classid, uint16 offset)
+		{ return (static_cast<uint32>(classid) << 16) | offset; }
+	static uint32 intrinsicKey(uint16 func)
+		{ return 0xFFFF0000 | func; }
+
+	struct FunctionStats {
+		FunctionStats() : calls(0), active(0), insns(0), inclinsns(0),
+						  time(0), incltime(0) { }
+
+		uint32 calls;
+		uint32 active;			//!< calls that haven't returned yet
+		Uint64 insns;			//!< run in the function itself
+		Uint64 inclinsns;		//!< including the functions it called
+		Uint64 time;
+		Uint64 incltime;
+	};
+
+	//! a node in the tree of call stacks
+	struct StackNode {
+		uint32 key;
+		uint32 parent;			//!< index, the root is its own parent
+		Uint64 insns;
+		Uint64 time;
+	};
+
+	struct Frame {
+		uint32 key;
+		uint32 node;
+		Uint64 insns;			//!< run in the function itself so far
+		Uint64 childinsns;		//!< run in the functions it called
+		Uint64 time;
+		Uint64 childtime;
+	};
+
+	typedef std::vector<Frame> FrameStack;
+
+	struct CallSite {
+		uint32 caller;
+		uint16 ip;
+		uint32 callee;
+
+		bool operator<(const CallSite& o) const {
+			if (caller != o.caller) return caller < o.caller;
+			if (ip != o.ip) return ip < o.ip;
+			return callee < o.callee;
+		}
+	};
+
+	//! add what ran since the last transition to the current function
+	void flush();
+	void push(uint32 key, uint16 callip);
+	void pop();
+
+	std::string getName(uint32 key) const;
+	std::string getStack(uint32 node) const;
+
+	double toMillis(Uint64 ticks) const
+		{ return (ticks * 1000.0) / static_cast<double>(frequency); }
+
+	bool running;
+	Uint64 frequency;
+
+	FrameStack* current;		//!< stack of the process being run
+	Uint64 lasttime;			//!< when the last transition happened
+	uint32 pendinginsns;		//!< instructions since the last transition
+
+	std::map<uint16, FrameStack> stacks;	//!< per pid
+	std::map<uint32, FunctionStats> functions;
+	std::map<CallSite, uint32> callsites;
+
+	std::vector<StackNode> nodes;
+	std::map<std::pair<uint32, uint32>, uint32> children;
+};
+
+#endif
@@ -19,8 +19,33 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "pent_include.h"
 
 #include "Usecode.h"
+#include "UCCode.h"
 #include "CoreApp.h"
 
+Usecode::~Usecode()
+{
+	for (unsigned int i = 0; i < codes.size(); ++i)
+		delete codes[i];
+}
+
+UCCode* Usecode::get_code(uint32 classid)
+{
+	if (classid >= codes.size())
+		codes.resize(classid + 1, 0);
+
+	if (!codes[classid]) {
+		uint32 base = get_class_base_offset(classid);
+		uint32 size = get_class_size(classid);
+		if (size > base)
+			codes[classid] = new UCCode(get_class(classid) + base,
+										size - base);
+		else
+			codes[classid] = new UCCode(0, 0);
+	}
+
+	return codes[classid];
+}
+
 uint32 Usecode::get_class_event(uint32 classid, uint32 eventid)
 {
 	if (get_class_size(classid) == 0) return 0;
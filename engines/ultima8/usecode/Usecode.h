@@ -20,11 +20,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define USECODE_H
 
 #include <string>
+#include <vector>
+
+class UCCode;
 
 class Usecode {
 public:
 	Usecode() { }
-	virtual ~Usecode() { }
+	virtual ~Usecode();
 
 	virtual const uint8* get_class(uint32 classid)=0;
 	virtual uint32 get_class_size(uint32 classid)=0;
@@ -33,6 +36,13 @@ public:
 	virtual uint32 get_class_event_count(uint32 classid) = 0;
 
 	virtual uint32 get_class_event(uint32 classid, uint32 eventid);
+
+	//! get the code of a class after its base offset, decoded as it runs.
+	//! It is kept until the Usecode is deleted.
+	UCCode* get_code(uint32 classid);
+
+private:
+	std::vector<UCCode*> codes;
 };
 
 
@@ -0,0 +1,128 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef CHUNKBITSET_H
+#define CHUNKBITSET_H
+
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//
+// ChunkBitSet. One bit per chunk of a MAP_NUM_CHUNKS x MAP_NUM_CHUNKS map,
+// packed into 32 bit words row by row (bit cx&31 of word cy*WORDS+cx/32).
+//
+// The set chunks can be walked with findNext(), which skips empty words
+// and finds the next bit with a count-trailing-zeros instruction, so the
+// cost depends on the number of set chunks rather than the size of the map.
+//
+
+template<int N>
+class ChunkBitSet
+{
+public:
+	enum {
+		WORDS_PER_ROW = N / 32,
+		NUM_WORDS = N * WORDS_PER_ROW
+	};
+
+	ChunkBitSet() { clearAll(); }
+
+	bool test(int cx, int cy) const {
+		return (words[cy*WORDS_PER_ROW + cx/32] & (1U<<(cx&31))) != 0;
+	}
+
+	void set(int cx, int cy) {
+		uint32& w = words[cy*WORDS_PER_ROW + cx/32];
+		uint32 bit = 1U<<(cx&31);
+		if (!(w & bit)) { w |= bit; count++; }
+	}
+
+	void reset(int cx, int cy) {
+		uint32& w = words[cy*WORDS_PER_ROW + cx/32];
+		uint32 bit = 1U<<(cx&31);
+		if (w & bit) { w &= ~bit; count--; }
+	}
+
+	void clearAll() {
+		std::memset(words, 0, sizeof(words));
+		count = 0;
+	}
+
+	//! number of set chunks
+	unsigned int size() const { return count; }
+
+	//! Find the first set chunk with index (cy*N+cx) >= index.
+	//! \return false if there is none
+	bool findNext(unsigned int& index) const {
+		unsigned int w = index / 32;
+		if (w >= NUM_WORDS) return false;
+
+		uint32 bits = words[w] & (~0U << (index & 31));
+		while (!bits) {
+			if (++w >= NUM_WORDS) return false;
+			bits = words[w];
+		}
+
+		index = w*32 + ctz(bits);
+		return true;
+	}
+
+	static int getX(unsigned int index) { return index % N; }
+	static int getY(unsigned int index) { return index / N; }
+
+	//! raw access to the words (for saving and loading)
+	uint32 getWord(unsigned int i) const { return words[i]; }
+	void setWord(unsigned int i, uint32 w) {
+		count -= popcount(words[i]);
+		words[i] = w;
+		count += popcount(w);
+	}
+
+private:
+	static unsigned int ctz(uint32 v) {
+#if defined(__GNUC__)
+		return __builtin_ctz(v);
+#elif defined(_MSC_VER)
+		unsigned long i;
+		_BitScanForward(&i, v);
+		return i;
+#else
+		unsigned int i = 0;
+		while (!(v & 1)) { v >>= 1; i++; }
+		return i;
+#endif
+	}
+
+	static unsigned int popcount(uint32 v) {
+#if defined(__GNUC__)
+		return __builtin_popcount(v);
+#else
+		v = v - ((v >> 1) & 0x55555555);
+		v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+		return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+	}
+
+	uint32 words[NUM_WORDS];
+	unsigned int count;
+};
+
+#endif
@@ -0,0 +1,289 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+#include "CompiledLoopScript.h"
+
+#include "Item.h"
+#include "LoopScript.h"
+
+#include <iterator>
+
+// the interpreter this replaces had room for 32 values
+static const unsigned int MAX_DEPTH = 32;
+
+// pseudo tokens for the shape and frame lists ('A'-'Z' and 'a'-'z')
+static const uint8 OP_SHAPELIST = 'A';
+static const uint8 OP_FRAMELIST = 'a';
+
+std::map<std::string, CompiledLoopScript> CompiledLoopScript::cache;
+
+const CompiledLoopScript* CompiledLoopScript::get(const uint8* script,
+												  uint32 scriptsize)
+{
+	std::string key(reinterpret_cast<const char*>(script), scriptsize);
+	std::map<std::string, CompiledLoopScript>::iterator iter;
+	iter = cache.find(key);
+	if (iter == cache.end()) {
+		iter = cache.insert(std::make_pair(key, CompiledLoopScript())).first;
+		iter->second.compile(script, scriptsize);
+	}
+	return &iter->second;
+}
+
+namespace {
+
+//! What is known about a value on the stack while compiling. Used to
+//! find out if the script only matches some shapes.
+struct Term {
+	enum Kind { OTHER, SHAPE, CONSTANT, SHAPESET } kind;
+	uint16 value;
+	std::vector<uint16> shapes;		//!< sorted, for SHAPESET
+
+	explicit Term(Kind k = OTHER, uint16 v = 0) : kind(k), value(v) { }
+};
+
+}
+
+void CompiledLoopScript::compile(const uint8* script, uint32 scriptsize)
+{
+	std::vector<Term> terms;
+	terms.push_back(Term(Term::CONSTANT, 1)); // true if script is empty
+
+	uint32 i = 0;
+	while (i < scriptsize) {
+		Op op;
+		op.token = script[i];
+		op.value = 0;
+		op.count = 0;
+
+		unsigned int pops = 0;
+		Term result;
+
+		switch (script[i]) {
+		case LS_TOKEN_FALSE:
+		case LS_TOKEN_TRUE:
+			result = Term(Term::CONSTANT, script[i]);
+			break;
+
+		case LS_TOKEN_END:
+			// the result is the value on top of the stack
+			if (terms.back().kind == Term::SHAPESET) {
+				shapefilter = true;
+				shapes = terms.back().shapes;
+			}
+			ops.push_back(op);
+			valid = true;
+			return;
+
+		case LS_TOKEN_INT:
+			if (i + 2 >= scriptsize) {
+				perr.printf("Loopscript ends inside a constant\n");
+				return;
+			}
+			op.value = script[i+1] + (script[i+2]<<8);
+			result = Term(Term::CONSTANT, op.value);
+			i += 2;
+			break;
+
+		case LS_TOKEN_AND:
+		case LS_TOKEN_OR:
+		{
+			pops = 2;
+			if (terms.size() < 2) break;
+			const Term& a = terms[terms.size()-1];
+			const Term& b = terms[terms.size()-2];
+			if (script[i] == LS_TOKEN_AND) {
+				if (a.kind == Term::SHAPESET && b.kind == Term::SHAPESET) {
+					result.kind = Term::SHAPESET;
+					std::set_intersection(a.shapes.begin(), a.shapes.end(),
+										  b.shapes.begin(), b.shapes.end(),
+										  std::back_inserter(result.shapes));
+				} else if (a.kind == Term::SHAPESET) {
+					result = a;
+				} else if (b.kind == Term::SHAPESET) {
+					result = b;
+				}
+			} else if (a.kind == Term::SHAPESET &&
+					   b.kind == Term::SHAPESET) {
+				result.kind = Term::SHAPESET;
+				std::set_union(a.shapes.begin(), a.shapes.end(),
+							   b.shapes.begin(), b.shapes.end(),
+							   std::back_inserter(result.shapes));
+			}
+			break;
+		}
+
+		case LS_TOKEN_EQUAL:
+		{
+			pops = 2;
+			if (terms.size() < 2) break;
+			const Term& a = terms[terms.size()-1];
+			const Term& b = terms[terms.size()-2];
+			if (a.kind == Term::SHAPE && b.kind == Term::CONSTANT) {
+				result.kind = Term::SHAPESET;
+				result.shapes.push_back(b.value);
+			} else if (b.kind == Term::SHAPE && a.kind == Term::CONSTANT) {
+				result.kind = Term::SHAPESET;
+				result.shapes.push_back(a.value);
+			}
+			break;
+		}
+
+		case LS_TOKEN_NOT:
+			pops = 1;
+			break;
+
+		case LS_TOKEN_GREATER:
+		case LS_TOKEN_LESS:
+		case LS_TOKEN_GEQUAL:
+		case LS_TOKEN_LEQUAL:
+			pops = 2;
+			break;
+
+		case LS_TOKEN_STATUS:
+		case LS_TOKEN_Q:
+		case LS_TOKEN_NPCNUM:
+		case LS_TOKEN_FAMILY:
+		case LS_TOKEN_FRAME:
+			break;
+
+		case LS_TOKEN_SHAPE:
+			result.kind = Term::SHAPE;
+			break;
+
+		default:
+			if ((script[i] >= 'A' && script[i] <= 'Z') ||
+				(script[i] >= 'a' && script[i] <= 'z'))
+			{
+				bool shapelist = (script[i] <= 'Z');
+				op.token = shapelist ? OP_SHAPELIST : OP_FRAMELIST;
+				op.count = script[i] - (shapelist ? '@' : '`');
+				op.value = static_cast<uint16>(values.size());
+				if (i + 2 * op.count >= scriptsize) {
+					perr.printf("Loopscript ends inside a list\n");
+					return;
+				}
+				for (unsigned int j = 0; j < op.count; j++) {
+					values.push_back(script[i+1] + (script[i+2]<<8));
+					i += 2;
+				}
+				if (shapelist) {
+					result.kind = Term::SHAPESET;
+					result.shapes.assign(values.begin() + op.value,
+										 values.end());
+					std::sort(result.shapes.begin(), result.shapes.end());
+				}
+			} else {
+				// the interpreter ignored these, so do we
+				perr.printf("Unknown loopscript opcode %02X\n", script[i]);
+				i++;
+				continue;
+			}
+		}
+
+		if (terms.size() < pops) {
+			perr.printf("Loopscript stack underflow\n");
+			return;
+		}
+		terms.resize(terms.size() - pops);
+		terms.push_back(result);
+		if (terms.size() > MAX_DEPTH) {
+			perr.printf("Loopscript stack overflow\n");
+			return;
+		}
+
+		ops.push_back(op);
+		i++;
+	}
+
+	perr.printf("Didn't encounter $ in loopscript\n");
+}
+
+bool CompiledLoopScript::check(Item* item) const
+{
+	if (!valid) return false;
+
+	uint16 stack[MAX_DEPTH];
+	unsigned int sp = 0;
+	stack[sp++] = 1;
+
+	std::vector<Op>::const_iterator iter;
+	for (iter = ops.begin(); iter != ops.end(); ++iter) {
+		uint16 a, b;
+		switch (iter->token) {
+		case LS_TOKEN_FALSE:
+			stack[sp++] = 0; break;
+		case LS_TOKEN_TRUE:
+			stack[sp++] = 1; break;
+		case LS_TOKEN_END:
+			return stack[sp-1] != 0;
+		case LS_TOKEN_INT:
+			stack[sp++] = iter->value; break;
+		case LS_TOKEN_AND:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (a != 0 && b != 0); break;
+		case LS_TOKEN_OR:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (a != 0 || b != 0); break;
+		case LS_TOKEN_NOT:
+			stack[sp-1] = (stack[sp-1] == 0); break;
+		case LS_TOKEN_STATUS:
+			stack[sp++] = static_cast<uint16>(item->getFlags()); break;
+		case LS_TOKEN_Q:
+			stack[sp++] = item->getQuality(); break;
+		case LS_TOKEN_NPCNUM:
+			stack[sp++] = item->getNpcNum(); break;
+		case LS_TOKEN_EQUAL:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (b == a); break;
+		case LS_TOKEN_GREATER:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (b > a); break;
+		case LS_TOKEN_LESS:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (b < a); break;
+		case LS_TOKEN_GEQUAL:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (b >= a); break;
+		case LS_TOKEN_LEQUAL:
+			a = stack[--sp]; b = stack[sp-1];
+			stack[sp-1] = (b <= a); break;
+		case LS_TOKEN_FAMILY:
+			stack[sp++] = item->getFamily(); break;
+		case LS_TOKEN_SHAPE:
+			stack[sp++] = static_cast<uint16>(item->getShape()); break;
+		case LS_TOKEN_FRAME:
+			stack[sp++] = static_cast<uint16>(item->getFrame()); break;
+		case OP_SHAPELIST:
+		case OP_FRAMELIST:
+		{
+			uint32 v = (iter->token == OP_SHAPELIST) ? item->getShape()
+													 : item->getFrame();
+			bool match = false;
+			for (unsigned int j = 0; j < iter->count && !match; j++)
+				match = (v == values[iter->value + j]);
+			stack[sp++] = match;
+			break;
+		}
+		}
+	}
+
+	// not reached: compile() only accepts scripts ending in $
+	return false;
+}
@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef COMPILEDLOOPSCRIPT_H
+#define COMPILEDLOOPSCRIPT_H
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+class Item;
+
+//! A loopscript decoded once into a list of operations with their
+//! operands, so checking an item doesn't have to parse the script bytes.
+//! The compiled scripts are kept for the whole run; usecode builds its
+//! loopscripts from constants only, so there are few distinct ones.
+class CompiledLoopScript
+{
+public:
+	//! Get the compiled version of a loopscript, compiling it if needed
+	static const CompiledLoopScript* get(const uint8* script,
+										 uint32 scriptsize);
+
+	//! Check an item against the script
+	//! \return true if the item matches, false otherwise
+	bool check(Item* item) const;
+
+	//! false if the script can't match an item of the given shape, so
+	//! callers can skip items without looking at anything else
+	bool shapeMayMatch(uint32 shape) const {
+		if (!shapefilter) return true;
+		return std::binary_search(shapes.begin(), shapes.end(),
+								  static_cast<uint16>(shape));
+	}
+
+private:
+	CompiledLoopScript() : valid(false), shapefilter(false) { }
+
+	void compile(const uint8* script, uint32 scriptsize);
+
+	struct Op {
+		uint8 token;
+		uint16 value;		//!< LS_TOKEN_INT constant, or the first entry
+							//!< in values of a shape/frame list
+		uint16 count;		//!< number of entries of a shape/frame list
+	};
+
+	std::vector<Op> ops;
+	std::vector<uint16> values;
+
+	bool valid;			//!< false if the script can never match
+	bool shapefilter;	//!< true if matching items have one of shapes
+	std::vector<uint16> shapes;	//!< sorted
+
+	static std::map<std::string, CompiledLoopScript> cache;
+};
+
+#endif
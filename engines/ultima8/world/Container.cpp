@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ObjectManager.h"
 #include "UCMachine.h"
 #include "UCList.h"
+#include "CompiledLoopScript.h"
 #include "IDataSource.h"
 #include "ODataSource.h"
 #include "ItemFactory.h"
@@ -288,15 +289,15 @@ uint32 Container::getContentVolume()
 void Container::containerSearch(UCList* itemlist, const uint8* loopscript,
 								uint32 scriptsize, bool recurse)
 {
+	const CompiledLoopScript* script =
+		CompiledLoopScript::get(loopscript, scriptsize);
+
 	std::list<Item*>::iterator iter;
 	for (iter = contents.begin(); iter != contents.end(); ++iter) {
 		// check item against loopscript
-		if ((*iter)->checkLoopScript(loopscript, scriptsize)) {
-			uint16 objid = (*iter)->getObjId();
-			uint8 buf[2];
-			buf[0] = static_cast<uint8>(objid);
-			buf[1] = static_cast<uint8>(objid >> 8);
-			itemlist->append(buf);
+		if (script->shapeMayMatch((*iter)->getShape()) &&
+			script->check(*iter)) {
+			itemlist->append((*iter)->getObjId());
 		}
 
 		if (recurse) {
@@ -19,8 +19,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "pent_include.h"
 
 #include <climits>
+#include <algorithm>
 
 #include "CurrentMap.h"
+#include "LocationFilter.h"
 #include "Map.h"
 #include "Item.h"
 #include "GlobEgg.h"
@@ -30,6 +32,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Rect.h"
 #include "Container.h"
 #include "UCList.h"
+#include "CompiledLoopScript.h"
 #include "ShapeInfo.h"
 #include "TeleportEgg.h"
 #include "EggHatcherProcess.h"
@@ -45,22 +48,29 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ODataSource.h"
 
 using std::list; // too messy otherwise
+
 using Pentagram::Rect;
 typedef list<Item*> item_list;
 
+uint32 CurrentMap::fastAreaBudget = 2000;
+
 CurrentMap::CurrentMap()
-	: current_map(0), egghatcher(0),
+	: current_map(0), maxFootpad(0), maxHeight(0), changecount(1),
+	  cacheHits(0), cacheMisses(0), egghatcher(0),
 		fast_x_min(-1), fast_y_min(-1),
-		fast_x_max(-1), fast_y_max(-1)
+		fast_x_max(-1), fast_y_max(-1), fastQueuePos(0)
 {
 	items = new list<Item*>*[MAP_NUM_CHUNKS];
-	fast = new uint32*[MAP_NUM_CHUNKS];
+	cells = new ChunkCells*[MAP_NUM_CHUNKS];
 	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
 		items[i] = new list<Item*>[MAP_NUM_CHUNKS];
-		fast[i] = new uint32[MAP_NUM_CHUNKS/32];
-		std::memset(fast[i],false,sizeof(uint32)*MAP_NUM_CHUNKS/32);
+		cells[i] = new ChunkCells[MAP_NUM_CHUNKS];
 	}
 
+	clearCollisionCache();
+	resetFastState();
+	beginLoadStats(0);
+
 	if (GAME_IS_U8) {
 		mapChunkSize = 512;
 	} else if (GAME_IS_CRUSADER) {
@@ -77,10 +87,10 @@ CurrentMap::~CurrentMap()
 
 	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
 		delete[] items[i];
-		delete[] fast[i];
+		delete[] cells[i];
 	}
 	delete[] items;
-	delete[] fast;
+	delete[] cells;
 }
 
 void CurrentMap::clear()
@@ -92,10 +102,12 @@ void CurrentMap::clear()
 				delete *iter;
 			items[i][j].clear();
 		}
-		std::memset(fast[i],false,sizeof(uint32)*MAP_NUM_CHUNKS/32);
 	}
+	fast.clearAll();
+	clearIndex();
 
 	fast_x_min =  fast_y_min = fast_x_max = fast_y_max = -1;
+	resetFastState();
 	current_map = 0;
 
 	Process* ehp = Kernel::get_instance()->getProcess(egghatcher);
@@ -167,6 +179,7 @@ void CurrentMap::writeback()
 			items[i][j].clear();
 		}
 	}
+	clearIndex();
 
 	// delete egghatcher
 	Process* ehp = Kernel::get_instance()->getProcess(egghatcher);
@@ -190,9 +203,13 @@ void CurrentMap::loadItems(list<Item*> itemlist, bool callCacheIn)
 		// add item to internal object list
 		addItemToEnd(item);
 
-		if (callCacheIn)
+		if (callCacheIn) {
+			Uint64 start = SDL_GetPerformanceCounter();
 			item->callUsecodeEvent_cachein();
+			loadstats.cachein += SDL_GetPerformanceCounter() - start;
+		}
 	}
+	loadstats.itemcount += static_cast<uint32>(itemlist.size());
 }
 
 void CurrentMap::loadMap(Map* map)
@@ -202,19 +219,23 @@ void CurrentMap::loadMap(Map* map)
 
 	current_map = map;
 
+	calcShapeBounds();
 	createEggHatcher();
 
 	// Clear fast area
-	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
-		std::memset(fast[i],false,sizeof(uint32)*MAP_NUM_CHUNKS/32);
-	}
+	fast.clearAll();
 	fast_x_min = -1;
 	fast_y_min = -1;
 	fast_x_max = -1;
 	fast_y_max = -1;
+	resetFastState();
 
+	Uint64 start = SDL_GetPerformanceCounter();
 	loadItems(map->fixeditems, callCacheIn);
 	loadItems(map->dynamicitems, callCacheIn);
+	Uint64 now = SDL_GetPerformanceCounter();
+	loadstats.additems = now - start - loadstats.cachein;
+	start = now;
 
 	// we take control of the items in map, so clear the pointers
 	map->fixeditems.clear();
@@ -241,9 +262,19 @@ void CurrentMap::loadMap(Map* map)
 #endif
 		}
 	}
+
+	loadstats.npcs = SDL_GetPerformanceCounter() - start;
+	loadstats.fastpending = true;
 }
 
-void CurrentMap::addItem(Item* item)
+CurrentMap::LoadStats& CurrentMap::beginLoadStats(uint32 mapnum)
+{
+	std::memset(&loadstats, 0, sizeof(loadstats));
+	loadstats.mapnum = mapnum;
+	return loadstats;
+}
+
+bool CurrentMap::addItemToList(Item* item, bool atfront)
 {
 	sint32 ix, iy, iz;
 
@@ -253,14 +284,24 @@ void CurrentMap::addItem(Item* item)
 		iy < 0 || iy >= mapChunkSize*MAP_NUM_CHUNKS) {
 		perr << "Skipping item " << item->getObjId() << ": out of range (" 
 			 << ix << "," << iy << ")" << std::endl;
-		return;
+		return false;
 	}
 
 	sint32 cx = ix / mapChunkSize;
 	sint32 cy = iy / mapChunkSize;
 
-	items[cx][cy].push_front(item);
+	if (atfront)
+		items[cx][cy].push_front(item);
+	else
+		items[cx][cy].push_back(item);
+	addToIndex(item, cx, cy, atfront);
 	item->setExtFlag(Item::EXT_INCURMAP);
+	return true;
+}
+
+void CurrentMap::addItem(Item* item)
+{
+	if (!addItemToList(item, true)) return;
 
 	Egg* egg = p_dynamic_cast<Egg*>(item);
 	if (egg) {
@@ -272,22 +313,7 @@ void CurrentMap::addItem(Item* item)
 
 void CurrentMap::addItemToEnd(Item* item)
 {
-	sint32 ix, iy, iz;
-
-	item->getLocation(ix, iy, iz);
-
-	if (ix < 0 || ix >= mapChunkSize*MAP_NUM_CHUNKS || 
-		iy < 0 || iy >= mapChunkSize*MAP_NUM_CHUNKS) {
-		perr << "Skipping item " << item->getObjId() << ": out of range (" 
-			 << ix << "," << iy << ")" << std::endl;
-		return;
-	}
-
-	sint32 cx = ix / mapChunkSize;
-	sint32 cy = iy / mapChunkSize;
-
-	items[cx][cy].push_back(item);
-	item->setExtFlag(Item::EXT_INCURMAP);
+	if (!addItemToList(item, false)) return;
 
 	Egg* egg = p_dynamic_cast<Egg*>(item);
 	if (egg) {
@@ -324,9 +350,305 @@ void CurrentMap::removeItemFromList(Item* item, sint32 oldx, sint32 oldy)
 	sint32 cy = oldy / mapChunkSize;
 
 	items[cx][cy].remove(item);
+	removeFromIndex(item, oldx, oldy);
 	item->clearExtFlag(Item::EXT_INCURMAP);
 }
 
+void CurrentMap::updateItemLocation(Item* item, sint32 oldx, sint32 oldy)
+{
+	sint32 ix, iy, iz;
+	item->getLocation(ix, iy, iz);
+
+	sint32 cx = oldx / mapChunkSize;
+	sint32 cy = oldy / mapChunkSize;
+	// moving to another chunk has to go through removeItem/addItem
+	assert(cx == ix / mapChunkSize && cy == iy / mapChunkSize);
+
+	if (cx < 0 || cx >= MAP_NUM_CHUNKS || cy < 0 || cy >= MAP_NUM_CHUNKS)
+		return;
+
+	touchChunk(cx, cy);
+
+	if (p_dynamic_cast<Egg*>(item)) eggChanged();
+
+	ChunkCells& chunk = cells[cx][cy];
+	ItemCell& from = chunk.cells[getCell(cx, cy, oldx, oldy)];
+	ItemCell& to = chunk.cells[getCell(cx, cy, ix, iy)];
+
+	for (unsigned int i = 0; i < from.item.size(); ++i) {
+		if (from.item[i] != item) continue;
+
+		if (&from == &to) {
+			from.x[i] = ix;
+			from.y[i] = iy;
+			from.z[i] = iz;
+		} else {
+			sint32 seq = from.seq[i];
+			from.erase(i);
+			to.push_back(item, ix, iy, iz, seq);
+		}
+		return;
+	}
+}
+
+void CurrentMap::changeItemChunk(Item* item, sint32 oldx, sint32 oldy)
+{
+	removeItemFromList(item, oldx, oldy);
+	addItemToList(item, true);
+
+	if (p_dynamic_cast<Egg*>(item)) eggChanged();
+}
+
+void CurrentMap::eggChanged()
+{
+	EggHatcherProcess* ehp = p_dynamic_cast<EggHatcherProcess*>(
+		Kernel::get_instance()->getProcess(egghatcher));
+	if (ehp) ehp->invalidateTriggers();
+}
+
+void CurrentMap::ItemCell::push_back(Item* item_, sint32 x_, sint32 y_,
+									 sint32 z_, sint32 seq_)
+{
+	x.push_back(x_);
+	y.push_back(y_);
+	z.push_back(z_);
+	seq.push_back(seq_);
+	item.push_back(item_);
+}
+
+void CurrentMap::ItemCell::erase(unsigned int i)
+{
+	// order within a cell doesn't matter, so move the last entry here
+	unsigned int last = static_cast<unsigned int>(item.size()) - 1;
+	x[i] = x[last]; x.pop_back();
+	y[i] = y[last]; y.pop_back();
+	z[i] = z[last]; z.pop_back();
+	seq[i] = seq[last]; seq.pop_back();
+	item[i] = item[last]; item.pop_back();
+}
+
+void CurrentMap::ItemCell::clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	seq.clear();
+	item.clear();
+}
+
+int CurrentMap::getCell(sint32 cx, sint32 cy, sint32 x, sint32 y) const
+{
+	sint32 cellsize = mapChunkSize / MAP_CHUNK_CELLS;
+	sint32 lx = (x - cx*mapChunkSize) / cellsize;
+	sint32 ly = (y - cy*mapChunkSize) / cellsize;
+	if (lx < 0) lx = 0;
+	if (lx >= MAP_CHUNK_CELLS) lx = MAP_CHUNK_CELLS-1;
+	if (ly < 0) ly = 0;
+	if (ly >= MAP_CHUNK_CELLS) ly = MAP_CHUNK_CELLS-1;
+	return ly * MAP_CHUNK_CELLS + lx;
+}
+
+void CurrentMap::addToIndex(Item* item, sint32 cx, sint32 cy, bool atfront)
+{
+	sint32 ix, iy, iz;
+	item->getLocation(ix, iy, iz);
+
+	ChunkCells& chunk = cells[cx][cy];
+
+	sint32 seq = atfront ? --chunk.frontseq : ++chunk.backseq;
+	chunk.cells[getCell(cx, cy, ix, iy)].push_back(item, ix, iy, iz, seq);
+	touchChunk(cx, cy);
+}
+
+void CurrentMap::removeFromIndex(Item* item, sint32 x, sint32 y)
+{
+	sint32 cx = x / mapChunkSize;
+	sint32 cy = y / mapChunkSize;
+	ChunkCells& chunk = cells[cx][cy];
+
+	// look in the item's own cell first, then in the rest of the chunk
+	int first = getCell(cx, cy, x, y);
+	bool found = false;
+	for (int i = 0; i < MAP_CHUNK_CELLS*MAP_CHUNK_CELLS && !found; ++i) {
+		ItemCell& cell =
+			chunk.cells[(first + i) % (MAP_CHUNK_CELLS*MAP_CHUNK_CELLS)];
+		for (unsigned int j = 0; j < cell.item.size(); ++j) {
+			if (cell.item[j] == item) {
+				cell.erase(j);
+				found = true;
+				break;
+			}
+		}
+	}
+
+	if (items[cx][cy].empty())
+		chunk.frontseq = chunk.backseq = 0;
+	touchChunk(cx, cy);
+}
+
+void CurrentMap::clearIndex()
+{
+	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
+		for (unsigned int j = 0; j < MAP_NUM_CHUNKS; j++) {
+			for (int c = 0; c < MAP_CHUNK_CELLS*MAP_CHUNK_CELLS; ++c)
+				cells[i][j].cells[c].clear();
+			cells[i][j].frontseq = cells[i][j].backseq = 0;
+			cells[i][j].lastchange = 0;
+		}
+	}
+	changecount = 1;
+	clearCollisionCache();
+}
+
+void CurrentMap::findItems(sint32 cx, sint32 cy,
+						   const sint32 lo[3], const sint32 hi[3],
+						   std::vector<CellEntry>& out) const
+{
+	const ChunkCells& chunk = cells[cx][cy];
+
+	int first = getCell(cx, cy, lo[0], lo[1]);
+	int last = getCell(cx, cy, hi[0], hi[1]);
+
+	for (int ly = first / MAP_CHUNK_CELLS; ly <= last / MAP_CHUNK_CELLS; ++ly)
+		for (int lx = first % MAP_CHUNK_CELLS; lx <= last % MAP_CHUNK_CELLS;
+			 ++lx)
+		{
+			const ItemCell& cell = chunk.cells[ly * MAP_CHUNK_CELLS + lx];
+			const unsigned int n = static_cast<unsigned int>(cell.item.size());
+
+			// filter in batches, so the hits fit on the stack
+			uint32 hits[64];
+			for (unsigned int base = 0; base < n; base += 64) {
+				unsigned int batch = n - base;
+				if (batch > 64) batch = 64;
+
+				unsigned int count = Pentagram::filterLocations(
+					&cell.x[base], &cell.y[base], &cell.z[base], batch,
+					lo, hi, hits);
+
+				for (unsigned int i = 0; i < count; ++i) {
+					CellEntry entry;
+					entry.item = cell.item[base + hits[i]];
+					entry.seq = cell.seq[base + hits[i]];
+					out.push_back(entry);
+				}
+			}
+		}
+
+	std::sort(out.begin(), out.end(), CellEntrySeqLess);
+}
+
+void CurrentMap::itemChanged(Item* item)
+{
+	sint32 ix, iy, iz;
+	item->getLocation(ix, iy, iz);
+
+	if (ix < 0 || ix >= mapChunkSize*MAP_NUM_CHUNKS || 
+		iy < 0 || iy >= mapChunkSize*MAP_NUM_CHUNKS)
+		return;
+
+	touchChunk(ix / mapChunkSize, iy / mapChunkSize);
+}
+
+void CurrentMap::touchChunk(sint32 cx, sint32 cy)
+{
+	if (++changecount == 0) {
+		// wrapped around: forget everything
+		for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++)
+			for (unsigned int j = 0; j < MAP_NUM_CHUNKS; j++)
+				cells[i][j].lastchange = 0;
+		clearCollisionCache();
+		changecount = 1;
+	}
+	cells[cx][cy].lastchange = changecount;
+}
+
+bool CurrentMap::chunksChangedSince(int minx, int miny, int maxx, int maxy,
+									uint32 stamp) const
+{
+	for (int cx = minx; cx <= maxx; cx++)
+		for (int cy = miny; cy <= maxy; cy++)
+			if (cells[cx][cy].lastchange > stamp) return true;
+	return false;
+}
+
+void CurrentMap::clearCollisionCache()
+{
+	for (int i = 0; i < MAP_COLLISION_CACHE_SIZE; ++i)
+		collisionCache[i].stamp = 0;
+}
+
+void CurrentMap::ConCmd_collisionCache(const Console::ArgvType &argv)
+{
+	CurrentMap* map = World::get_instance()->getCurrentMap();
+
+	if (argv.size() == 2 && argv[1] == "reset") {
+		map->cacheHits = map->cacheMisses = 0;
+		map->clearCollisionCache();
+		pout << "Collision cache cleared" << std::endl;
+		return;
+	} else if (argv.size() != 1) {
+		pout << "usage: CurrentMap::collisionCache [reset]" << std::endl;
+		return;
+	}
+
+	uint32 total = map->cacheHits + map->cacheMisses;
+	unsigned int used = 0;
+	for (int i = 0; i < MAP_COLLISION_CACHE_SIZE; ++i)
+		if (map->collisionCache[i].stamp) used++;
+
+	pout << "Collision cache: " << MAP_COLLISION_CACHE_SIZE << " entries, "
+		 << used << " in use" << std::endl;
+	pout << "hits: " << map->cacheHits << ", misses: " << map->cacheMisses;
+	if (total)
+		pout << " (" << (map->cacheHits * 100.0 / total) << "% hits)";
+	pout << std::endl;
+}
+
+void CurrentMap::ConCmd_loadStats(const Console::ArgvType &argv)
+{
+	CurrentMap* map = World::get_instance()->getCurrentMap();
+	const LoadStats& stats = map->loadstats;
+	double ms = 1000.0 / SDL_GetPerformanceFrequency();
+
+	pout << "Last load of map " << stats.mapnum << ": " << stats.itemcount
+		 << " items" << std::endl;
+	if (stats.prefetched)
+		pout << "  fixed items:   prefetched (" << stats.decode * ms
+			 << " ms waiting)" << std::endl;
+	else
+		pout << "  decode:        " << stats.decode * ms << " ms" << std::endl
+			 << "  ItemFactory:   " << stats.create * ms << " ms" << std::endl;
+	pout << "  add items:     " << stats.additems * ms << " ms" << std::endl
+		 << "  cachein:       " << stats.cachein * ms << " ms" << std::endl
+		 << "  NPCs:          " << stats.npcs * ms << " ms" << std::endl;
+	if (stats.fastpending)
+		pout << "  fast area:     not set up yet" << std::endl;
+	else
+		pout << "  fast area:     " << stats.fastarea * ms << " ms" << std::endl;
+}
+
+void CurrentMap::calcShapeBounds()
+{
+	sint32 footpad = 0;
+	sint32 height = 0;
+
+	MainShapeArchive* mainshapes = GameData::get_instance()->getMainShapes();
+	for (uint32 i = 0; i < mainshapes->getCount(); ++i) {
+		ShapeInfo* si = mainshapes->getShapeInfo(i);
+		if (!si) continue;
+		//!! constants
+		sint32 fp = 32 * static_cast<sint32>(si->x > si->y ? si->x : si->y);
+		if (fp > footpad) footpad = fp;
+		sint32 h = 8 * static_cast<sint32>(si->z);
+		if (h > height) height = h;
+	}
+
+	// just in case
+	maxFootpad = footpad ? footpad : mapChunkSize;
+	maxHeight = height ? height : (1 << 16);
+}
+
 // Check to see if the chunk is on the screen 
 static inline bool ChunkOnScreen(sint32 cx, sint32 cy, sint32 sleft, sint32 stop, sint32 sright, sint32 sbot, int mapChunkSize)
 {
@@ -368,6 +690,8 @@ static inline void CalcFastAreaLimits( sint32 &sx_limit,
 
 void CurrentMap::updateFastArea(sint32 from_x, sint32 from_y, sint32 from_z, sint32 to_x, sint32 to_y, sint32 to_z)
 {
+	Uint64 loadstart = loadstats.fastpending ? SDL_GetPerformanceCounter() : 0;
+
 	int x_min = from_x;
 	int x_max = to_x;
 
@@ -402,9 +726,12 @@ void CurrentMap::updateFastArea(sint32 from_x, sint32 from_y, sint32 from_z, sin
 	sint32 sbot   = ((x_max + y_max)/8 - z_min) + (dims.h/2 + mapChunkSize/8);
 
 	// Don't do anything IF the regions are the same
+	// (apart from catching up on chunks queued earlier)
 	if (fast_x_min == sleft && fast_y_min == stop &&
-		fast_x_max == sright && fast_y_max == sbot )
+		fast_x_max == sright && fast_y_max == sbot ) {
+		processFastQueue();
 		return;
+	}
 
 	// Update the saved region
 	fast_x_min = sleft;
@@ -424,8 +751,38 @@ void CurrentMap::updateFastArea(sint32 from_x, sint32 from_y, sint32 from_z, sin
 	y_min = y_min/mapChunkSize - xy_limit;
 	y_max = y_max/mapChunkSize + xy_limit;
 
-	for (sint32 cy = 0; cy < MAP_NUM_CHUNKS; cy++) {
-		for (sint32 cx = 0; cx < MAP_NUM_CHUNKS; cx++) {
+	// Only chunks in the old or the new coarse area can change
+	sint32 scan_x_min = x_min, scan_x_max = x_max;
+	sint32 scan_y_min = y_min, scan_y_max = y_max;
+	if (fast_cx_min > fast_cx_max) {
+		// unknown old area: check everything
+		scan_x_min = scan_y_min = 0;
+		scan_x_max = scan_y_max = MAP_NUM_CHUNKS-1;
+	} else {
+		if (fast_cx_min < scan_x_min) scan_x_min = fast_cx_min;
+		if (fast_cx_max > scan_x_max) scan_x_max = fast_cx_max;
+		if (fast_cy_min < scan_y_min) scan_y_min = fast_cy_min;
+		if (fast_cy_max > scan_y_max) scan_y_max = fast_cy_max;
+	}
+	if (scan_x_min < 0) scan_x_min = 0;
+	if (scan_x_max >= MAP_NUM_CHUNKS) scan_x_max = MAP_NUM_CHUNKS-1;
+	if (scan_y_min < 0) scan_y_min = 0;
+	if (scan_y_max >= MAP_NUM_CHUNKS) scan_y_max = MAP_NUM_CHUNKS-1;
+
+	fast_cx_min = x_min;
+	fast_cx_max = x_max;
+	fast_cy_min = y_min;
+	fast_cy_max = y_max;
+
+	// The actually visible part of the fast area (without the border).
+	// Chunks entering it can't wait.
+	sint32 vleft  = sleft  + mapChunkSize/4;
+	sint32 vtop   = stop   + mapChunkSize/8;
+	sint32 vright = sright - mapChunkSize/4;
+	sint32 vbot   = sbot   - mapChunkSize/8;
+
+	for (sint32 cy = scan_y_min; cy <= scan_y_max; cy++) {
+		for (sint32 cx = scan_x_min; cx <= scan_x_max; cx++) {
 
 			// Coarse
 			bool want_fast = cx>=x_min && cx<=x_max && cy>=y_min && cy<=y_max;
@@ -433,22 +790,85 @@ void CurrentMap::updateFastArea(sint32 from_x, sint32 from_y, sint32 from_z, sin
 			// Fine
 			if (want_fast) want_fast = ChunkOnScreen(cx,cy,sleft,stop,sright,sbot,mapChunkSize);
 
+			if (want_fast)
+				fastState[cy][cx] |= FAST_WANTED;
+			else
+				fastState[cy][cx] &= ~FAST_WANTED;
+
 			bool currently_fast = isChunkFast(cx,cy);
 
 			// Don't do anything, they are the same
 			if (want_fast == currently_fast) continue;
 
-			// leave fast area
-			if (!want_fast) unsetChunkFast(cx,cy);
-			// Enter fast area
-			else setChunkFast(cx,cy);
+			if (fastAreaBudget == 0) {
+				// leave fast area
+				if (!want_fast) unsetChunkFast(cx,cy);
+				// Enter fast area
+				else setChunkFast(cx,cy);
+			} else if (want_fast && ChunkOnScreen(cx,cy,vleft,vtop,vright,vbot,
+												  mapChunkSize)) {
+				setChunkFast(cx,cy);
+			} else if (!(fastState[cy][cx] & FAST_QUEUED)) {
+				// the rest can be spread over the next few frames
+				fastState[cy][cx] |= FAST_QUEUED;
+				fastQueue.push_back(static_cast<uint16>(cy*MAP_NUM_CHUNKS+cx));
+			}
+		}
+	}
+
+	processFastQueue();
+
+	if (loadstart) {
+		loadstats.fastarea = SDL_GetPerformanceCounter() - loadstart;
+		loadstats.fastpending = false;
+	}
+}
+
+void CurrentMap::processFastQueue()
+{
+	if (fastQueuePos >= fastQueue.size()) return;
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 limit = (SDL_GetPerformanceFrequency() * fastAreaBudget) / 1000000;
+
+	while (fastQueuePos < fastQueue.size()) {
+		uint16 index = fastQueue[fastQueuePos++];
+		sint32 cx = index % MAP_NUM_CHUNKS;
+		sint32 cy = index / MAP_NUM_CHUNKS;
+
+		fastState[cy][cx] &= ~FAST_QUEUED;
+
+		// the chunk may have changed its mind since it was queued
+		bool want_fast = (fastState[cy][cx] & FAST_WANTED) != 0;
+		if (want_fast != isChunkFast(cx,cy)) {
+			if (want_fast)
+				setChunkFast(cx,cy);
+			else
+				unsetChunkFast(cx,cy);
 		}
+
+		if (fastAreaBudget && SDL_GetPerformanceCounter() - start > limit)
+			break;
+	}
+
+	if (fastQueuePos >= fastQueue.size()) {
+		fastQueue.clear();
+		fastQueuePos = 0;
 	}
 }
 
+void CurrentMap::resetFastState()
+{
+	std::memset(fastState, 0, sizeof(fastState));
+	fastQueue.clear();
+	fastQueuePos = 0;
+	fast_cx_min = fast_cy_min = 0;
+	fast_cx_max = fast_cy_max = -1;
+}
+
 void CurrentMap::setChunkFast(sint32 cx, sint32 cy)
 {
-	fast[cy][cx/32] |= 1<<(cx&31);
+	fast.set(cx,cy);
 
 	item_list::iterator iter;
 	for (iter = items[cx][cy].begin();
@@ -459,7 +879,7 @@ void CurrentMap::setChunkFast(sint32 cx, sint32 cy)
 
 void CurrentMap::unsetChunkFast(sint32 cx, sint32 cy)
 {
-	fast[cy][cx/32] &= ~(1<<(cx&31));
+	fast.reset(cx,cy);
 
 	item_list::iterator iter = items[cx][cy].begin();
 	while (iter != items[cx][cy].end())
@@ -486,27 +906,45 @@ void CurrentMap::areaSearch(UCList* itemlist, const uint8* loopscript,
 
 	Rect searchrange(x-xd-range,y-yd-range,2*range+xd,2*range+yd);
 
+	// Footpads extend from an item's location towards -x and -y, so only
+	// items located in [x1,x2]x[y1,y2] can overlap searchrange
+	sint32 lo[3] = { searchrange.x, searchrange.y, INT_MIN };
+	sint32 hi[3] = { searchrange.x + searchrange.w + getMaxFootpad(),
+					 searchrange.y + searchrange.h + getMaxFootpad(),
+					 INT_MAX };
+
 	int minx, miny, maxx, maxy;
 
-	minx = ((x-xd-range)/mapChunkSize) - 1;
-	maxx = ((x+range)/mapChunkSize) + 1;
-	miny = ((y-yd-range)/mapChunkSize) - 1;
-	maxy = ((y+range)/mapChunkSize) + 1;
+	minx = lo[0]/mapChunkSize;
+	maxx = hi[0]/mapChunkSize;
+	miny = lo[1]/mapChunkSize;
+	maxy = hi[1]/mapChunkSize;
 	if (minx < 0) minx = 0;
 	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
 	if (miny < 0) miny = 0;
 	if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
 
+	const CompiledLoopScript* script =
+		CompiledLoopScript::get(loopscript, scriptsize);
+
+	std::vector<CellEntry> found;
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::iterator iter;
-			for (iter = items[cx][cy].begin();
-				 iter != items[cx][cy].end(); ++iter) {
+			found.clear();
+			findItems(cx, cy, lo, hi, found);
 
-				Item* item = *iter;
+			std::vector<CellEntry>::iterator iter;
+			for (iter = found.begin(); iter != found.end(); ++iter) {
+
+				Item* item = iter->item;
 
 				if (item->getExtFlags() & Item::EXT_SPRITE) continue;
 
+				// containers of other shapes still need to be searched
+				bool candidate = script->shapeMayMatch(item->getShape());
+				if (!candidate && !recurse) continue;
+
 				// check if item is in range?
 				sint32 ix, iy, iz;
 				item->getLocation(ix, iy, iz);
@@ -528,17 +966,13 @@ void CurrentMap::areaSearch(UCList* itemlist, const uint8* loopscript,
 				if (!itemrect.Overlaps(searchrange)) continue;
 				
 				// check item against loopscript
-				if ((*iter)->checkLoopScript(loopscript, scriptsize)) {
-					uint16 objid = (*iter)->getObjId();
-					uint8 buf[2];
-					buf[0] = static_cast<uint8>(objid);
-					buf[1] = static_cast<uint8>(objid >> 8);
-					itemlist->append(buf);				
+				if (candidate && script->check(item)) {
+					itemlist->append(item->getObjId());
 				}
 
 				if (recurse) {
 					// recurse into child-containers
-					Container *container = p_dynamic_cast<Container*>(*iter);
+					Container *container = p_dynamic_cast<Container*>(item);
 					if (container)
 						container->containerSearch(itemlist, loopscript,
 												   scriptsize, recurse);
@@ -568,28 +1002,43 @@ void CurrentMap::surfaceSearch(UCList* itemlist, const uint8* loopscript,
 	Rect searchrange(origin[0] - dims[0], origin[1] - dims[1],
 					dims[0], dims[1]);
 
+	sint32 lo[3] = { searchrange.x, searchrange.y, INT_MIN };
+	sint32 hi[3] = { searchrange.x + searchrange.w + getMaxFootpad(),
+					 searchrange.y + searchrange.h + getMaxFootpad(),
+					 INT_MAX };
+
 	sint32 minx, miny, maxx, maxy;
 
-	minx = ((origin[0] - dims[0])/mapChunkSize) - 1;
-	maxx = ((origin[0])/mapChunkSize) + 1;
-	miny = ((origin[1] - dims[1])/mapChunkSize) - 1;
-	maxy = ((origin[1])/mapChunkSize) + 1;
+	minx = lo[0]/mapChunkSize;
+	maxx = hi[0]/mapChunkSize;
+	miny = lo[1]/mapChunkSize;
+	maxy = hi[1]/mapChunkSize;
 	if (minx < 0) minx = 0;
 	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
 	if (miny < 0) miny = 0;
 	if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
 
+	const CompiledLoopScript* script =
+		CompiledLoopScript::get(loopscript, scriptsize);
+
+	std::vector<CellEntry> found;
+
 	for (sint32 cx = minx; cx <= maxx; cx++) {
 		for (sint32 cy = miny; cy <= maxy; cy++) {
-			item_list::iterator iter;
-			for (iter = items[cx][cy].begin();
-				 iter != items[cx][cy].end(); ++iter) {
+			found.clear();
+			findItems(cx, cy, lo, hi, found);
 
-				Item* item = *iter;
+			std::vector<CellEntry>::iterator iter;
+			for (iter = found.begin(); iter != found.end(); ++iter) {
+
+				Item* item = iter->item;
 
 				if (item->getObjId() == check) continue;
 				if (item->getExtFlags() & Item::EXT_SPRITE) continue;
 
+				bool candidate = script->shapeMayMatch(item->getShape());
+				if (!candidate && !recurse) continue;
+
 				// check if item is in range?
 				sint32 ix, iy, iz;
 				item->getLocation(ix, iy, iz);
@@ -621,12 +1070,8 @@ void CurrentMap::surfaceSearch(UCList* itemlist, const uint8* loopscript,
 				if (!ok) continue;
 
 				// check item against loopscript
-				if ((*iter)->checkLoopScript(loopscript, scriptsize)) {
-					uint16 objid = (*iter)->getObjId();
-					uint8 buf[2];
-					buf[0] = static_cast<uint8>(objid);
-					buf[1] = static_cast<uint8>(objid >> 8);
-					itemlist->append(buf);
+				if (candidate && script->check(item)) {
+					itemlist->append(item->getObjId());
 				}
 			}
 		}
@@ -697,24 +1142,57 @@ bool CurrentMap::isValidPosition(sint32 x, sint32 y, sint32 z,
 	ObjId roof = 0;
 	sint32 roofz = 1 << 24; //!! semi-constant
 
+	// Only items located in this box can overlap, support or roof the box.
+	// (There's no upper z limit because of the roof.)
+	sint32 lo[3] = { x - xd, y - yd, z - getMaxHeight() };
+	sint32 hi[3] = { x + getMaxFootpad(), y + getMaxFootpad(), INT_MAX };
+
 	int minx, miny, maxx, maxy;
 
-	minx = ((x-xd)/mapChunkSize) - 1;
-	maxx = (x/mapChunkSize) + 1;
-	miny = ((y-yd)/mapChunkSize) - 1;
-	maxy = (y/mapChunkSize) + 1;
+	minx = (lo[0]/mapChunkSize);
+	maxx = (hi[0]/mapChunkSize);
+	miny = (lo[1]/mapChunkSize);
+	maxy = (hi[1]/mapChunkSize);
 	if (minx < 0) minx = 0;
 	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
 	if (miny < 0) miny = 0;
 	if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
 
+	// Same query as last time, and nothing changed in the chunks since?
+	uint32 hash = static_cast<uint32>(x) * 73856093U ^
+		static_cast<uint32>(y) * 19349663U ^
+		static_cast<uint32>(z) * 83492791U ^
+		static_cast<uint32>(xd + (yd << 8) + (zd << 16)) ^
+		shapeflags ^ (static_cast<uint32>(item_) << 12);
+	CollisionCacheEntry& entry =
+		collisionCache[(hash ^ (hash >> 16)) & (MAP_COLLISION_CACHE_SIZE-1)];
+	if (entry.stamp && entry.x == x && entry.y == y && entry.z == z &&
+		entry.startx == startx && entry.starty == starty &&
+		entry.startz == startz && entry.xd == xd && entry.yd == yd &&
+		entry.zd == zd && entry.shapeflags == shapeflags &&
+		entry.item == item_ &&
+		!chunksChangedSince(minx, miny, maxx, maxy, entry.stamp))
+	{
+		cacheHits++;
+		if (support_)
+			*support_ = entry.support;
+		if (roof_)
+			*roof_ = entry.roof;
+		return entry.valid;
+	}
+	cacheMisses++;
+
+	std::vector<CellEntry> found;
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::iterator iter;
-			for (iter = items[cx][cy].begin();
-				 iter != items[cx][cy].end(); ++iter)
+			found.clear();
+			findItems(cx, cy, lo, hi, found);
+
+			std::vector<CellEntry>::iterator iter;
+			for (iter = found.begin(); iter != found.end(); ++iter)
 			{
-				Item* item = *iter;
+				Item* item = iter->item;
 				if (item->getObjId() == item_) continue;
 				if (item->getExtFlags() & Item::EXT_SPRITE) continue;
 
@@ -775,6 +1253,16 @@ bool CurrentMap::isValidPosition(sint32 x, sint32 y, sint32 z,
 		}
 	}
 
+	entry.x = x; entry.y = y; entry.z = z;
+	entry.startx = startx; entry.starty = starty; entry.startz = startz;
+	entry.xd = xd; entry.yd = yd; entry.zd = zd;
+	entry.shapeflags = shapeflags;
+	entry.item = item_;
+	entry.stamp = changecount;
+	entry.valid = valid;
+	entry.support = support;
+	entry.roof = roof;
+
 	if (support_)
 		*support_ = support;
 	if (roof_)
@@ -820,24 +1308,33 @@ bool CurrentMap::scanForValidPosition(sint32 x, sint32 y, sint32 z, Item* item,
 	// next, we'll loop over all objects in the area, and mark the areas
 	// overlapped and supported by each object
 
+	// the masks cover offsets of -8 to 8 from (x,y,z)
+	sint32 lo[3] = { x - xd - 8, y - yd - 8, z - getMaxHeight() - 8 };
+	sint32 hi[3] = { x + getMaxFootpad() + 8, y + getMaxFootpad() + 8,
+					 z + zd + 8 };
+
 	int minx, miny, maxx, maxy;
 
-	minx = ((x-xd)/mapChunkSize) - 1;
-	maxx = (x/mapChunkSize) + 1;
-	miny = ((y-yd)/mapChunkSize) - 1;
-	maxy = (y/mapChunkSize) + 1;
+	minx = (lo[0]/mapChunkSize);
+	maxx = (hi[0]/mapChunkSize);
+	miny = (lo[1]/mapChunkSize);
+	maxy = (hi[1]/mapChunkSize);
 	if (minx < 0) minx = 0;
 	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
 	if (miny < 0) miny = 0;
 	if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
 
+	std::vector<CellEntry> found;
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::iterator iter;
-			for (iter = items[cx][cy].begin();
-				 iter != items[cx][cy].end(); ++iter)
+			found.clear();
+			findItems(cx, cy, lo, hi, found);
+
+			std::vector<CellEntry>::iterator iter;
+			for (iter = found.begin(); iter != found.end(); ++iter)
 			{
-				Item* citem = *iter;
+				Item* citem = iter->item;
 				if (citem->getObjId() == item->getObjId()) continue;
 				if (citem->getExtFlags() & Item::EXT_SPRITE) continue;
 
@@ -956,6 +1453,173 @@ bool CurrentMap::scanForValidPosition(sint32 x, sint32 y, sint32 z, Item* item,
 // skip will skip all items until item num skip is reached
 // Returns item hit or 0 if no hit.
 // end is set to the colision point
+void CurrentMap::sweepBounds(const sint32 start[3], const sint32 end[3],
+							 const sint32 dims[3], sint32 lo[3],
+							 sint32 hi[3]) const
+{
+	// Only items located in this box can be hit or touched anywhere along
+	// the sweep. The margin covers rounding in the extents in sweepItem.
+	const sint32 margin = 4;
+	for (int i = 0; i < 3; i++) {
+		lo[i] = (start[i] < end[i]) ? start[i] : end[i];
+		hi[i] = (start[i] > end[i]) ? start[i] : end[i];
+	}
+	lo[0] -= dims[0] + margin;
+	lo[1] -= dims[1] + margin;
+	lo[2] -= getMaxHeight() + margin;
+	hi[0] += getMaxFootpad() + margin;
+	hi[1] += getMaxFootpad() + margin;
+	hi[2] += dims[2] + margin;
+}
+
+bool CurrentMap::sweepChangedSince(const sint32 start[3], const sint32 end[3],
+								   const sint32 dims[3], uint32 stamp) const
+{
+	// changecount wrapped around since then (see touchChunk)
+	if (stamp > changecount) return true;
+
+	sint32 lo[3], hi[3];
+	sweepBounds(start, end, dims, lo, hi);
+
+	int minx, miny, maxx, maxy;
+	minx = (lo[0]/mapChunkSize);
+	maxx = (hi[0]/mapChunkSize);
+	miny = (lo[1]/mapChunkSize);
+	maxy = (hi[1]/mapChunkSize);
+
+	if (minx < 0) minx = 0;
+	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
+	if (miny < 0) miny = 0;
+	if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
+
+	return chunksChangedSince(minx, miny, maxx, maxy, stamp);
+}
+
+bool CurrentMap::sweepItem(const sint32 start[3], const sint32 dims[3],
+						   const sint32 vel[3], const sint32 ext[3],
+						   const sint32 centre[3], Item* other_item,
+						   sint32& first, sint32& last, bool& touch,
+						   bool& touch_floor, uint8& dirs)
+{
+	sint32 other[3], oext[3];
+	other_item->getLocation(other[0], other[1], other[2]);
+	other_item->getFootpadWorld(oext[0], oext[1], oext[2]);
+
+	// If the objects overlapped at the start, ignore collision.
+	// The -1 and +1 portions are to still consider collisions
+	// for items which were merely touching at the start for all
+	// intents and purposes, but partially overlapped due to an
+	// off-by-one error (hypothetically, but they do happen so
+	// protect against it).
+	if(/* not non-overlapping start position */
+	   !(start[0] <= other[0] - (oext[0]-1) ||
+		 start[0] - dims[0] >= other[0]-1 ||
+		 start[1] <= other[1] - (oext[1]-1) ||
+		 start[1] - dims[1] >= other[1]-1 ||
+		 start[2] + dims[2] <= other[2]+1 ||
+		 start[2] >= other[2] + (oext[2]-1)))
+	{
+		// Overlapped at the start, and not just touching so
+		// ignore collision
+		return false;
+	}
+
+	oext[0] /= 2; oext[1] /= 2; oext[2] /= 2;
+
+	// Put other into our coord frame
+	other[0] -= oext[0]+centre[0];
+	other[1] -= oext[1]+centre[1];
+	other[2] += oext[2]-centre[2];
+
+	//first times of overlap along each axis
+	sint32 u_1[3] = {0,0,0};
+
+	//last times of overlap along each axis 
+	sint32 u_0[3] = {0x4000,0x4000,0x4000}; // CONSTANTS
+
+	touch = false;
+	touch_floor = false;
+
+	//find the possible first and last times
+	//of overlap along each axis
+	for( long i=0 ; i<3 ; i++ )
+	{
+		sint32 A_max = ext[i];	
+		sint32 A_min = -ext[i];	
+		sint32 B_max = other[i]+oext[i];	
+		sint32 B_min = other[i]-oext[i];	
+
+		if ( vel[i] < 0 && A_max>=B_min )		// A_max>=B_min not required
+		{
+			// Special case: if moving item has zero height and
+			// other item is a 128x128 flat, then moving item is
+			// considered blocked by the flat
+			// FIXME: it might be better to make this extra check
+			// identical to the 'flats' special case in ItemSorter
+			if (A_max==B_min && !
+				(i == 2 && ext[i] == 0 && oext[i] == 0 &&
+				 oext[0] == 64 && oext[1] == 64))
+				touch = true; // touch at start
+			if (A_min+vel[i]==B_max) touch = true; // touch at end
+
+			// - want to know when rear of A passes front of B
+			u_0[i] = ((B_max - A_min)*0x4000) / vel[i];
+			// - want to know when front of A passes rear of B
+			u_1[i] = ((B_min - A_max)*0x4000) / vel[i]; 
+		}
+		else if( vel[i] > 0 && A_min<=B_max)	// A_min<=B_max not required
+		{
+			if (A_min==B_max) touch = true; // touch at start
+			if (A_max+vel[i]==B_min) touch = true; // touch at end
+
+			// + want to know when front of A passes rear of B
+			u_0[i] = ((B_min - A_max)*0x4000) / vel[i];
+			// + want to know when rear of A passes front of B
+			u_1[i] = ((B_max - A_min)*0x4000) / vel[i]; 
+		}
+		else if( vel[i] == 0 && A_max >= B_min && A_min <= B_max)
+		{
+			if (A_min==B_max || A_max==B_min) touch = true;
+			if (i == 2 && A_min == B_max) touch_floor = true;
+
+			u_0[i] = -1;
+			u_1[i] = 0x4000;
+		}
+		else
+		{
+			u_0[i] = 0x4001;
+			u_1[i] = -1;
+		}
+
+		if (u_1[i] >= u_0[i] && (u_0[i] > 0x4000 || u_1[i] < 0))
+		{
+			u_0[i] = 0x4001;
+			u_1[i] = -1;
+		}
+	}
+
+	//possible first time of overlap
+	first = u_0[0];
+	if (u_0[1] > first) first = u_0[1];
+	if (u_0[2] > first) first = u_0[2];
+
+	//possible last time of overlap
+	last = u_1[0];
+	if (u_1[1] < last) last = u_1[1];
+	if (u_1[2] < last) last = u_1[2];
+
+	// store directions in which we're being blocked
+	dirs = 0;
+	for (int i = 0; i <= 2; ++i)
+		if (first == u_0[i])
+			dirs |= (1 << i);
+
+	//they could have only collided if
+	//the first time of overlap occurred
+	//before the last time of overlap
+	return first <= last;
+}
+
 bool CurrentMap::sweepTest(const sint32 start[3], const sint32 end[3],
 						   const sint32 dims[3], uint32 shapeflags,
 						   ObjId item, bool blocking_only,
@@ -965,23 +1629,14 @@ bool CurrentMap::sweepTest(const sint32 start[3], const sint32 end[3],
 
 	int i;
 
-	int minx, miny, maxx, maxy;
-	minx = ((start[0]-dims[0])/mapChunkSize) - 1;
-	maxx = (start[0]/mapChunkSize) + 1;
-	miny = ((start[1]-dims[1])/mapChunkSize) - 1;
-	maxy = (start[1]/mapChunkSize) + 1;
+	sint32 lo[3], hi[3];
+	sweepBounds(start, end, dims, lo, hi);
 
-	{
-		int dminx, dminy, dmaxx, dmaxy;
-		dminx = ((end[0]-dims[0])/mapChunkSize) - 1;
-		dmaxx = (end[0]/mapChunkSize) + 1;
-		dminy = ((end[1]-dims[1])/mapChunkSize) - 1;
-		dmaxy = (end[1]/mapChunkSize) + 1;
-		if (dminx < minx) minx = dminx;
-		if (dmaxx > maxx) maxx = dmaxx;
-		if (dminy < miny) miny = dminy;
-		if (dmaxy > maxy) maxy = dmaxy;
-	}
+	int minx, miny, maxx, maxy;
+	minx = (lo[0]/mapChunkSize);
+	maxx = (hi[0]/mapChunkSize);
+	miny = (lo[1]/mapChunkSize);
+	maxy = (hi[1]/mapChunkSize);
 
 	if (minx < 0) minx = 0;
 	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
@@ -1011,13 +1666,17 @@ bool CurrentMap::sweepTest(const sint32 start[3], const sint32 end[3],
 	std::list<SweepItem>::iterator sw_it;
 	if (hit) sw_it = hit->end();
 
+	std::vector<CellEntry> found;
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::iterator iter;
-			for (iter = items[cx][cy].begin();
-				 iter != items[cx][cy].end(); ++iter)
+			found.clear();
+			findItems(cx, cy, lo, hi, found);
+
+			std::vector<CellEntry>::iterator iter;
+			for (iter = found.begin(); iter != found.end(); ++iter)
 			{
-				Item* other_item = *iter;
+				Item* other_item = iter->item;
 				if (other_item->getObjId()==item) continue;
 				if (other_item->getExtFlags() & Item::EXT_SPRITE) continue;
 
@@ -1030,160 +1689,183 @@ bool CurrentMap::sweepTest(const sint32 start[3], const sint32 end[3],
 				if (blocking_only && !blocking)
 					continue;
 
-				sint32 other[3], oext[3];
-				other_item->getLocation(other[0], other[1], other[2]);
-				other_item->getFootpadWorld(oext[0], oext[1], oext[2]);
-
-				// If the objects overlapped at the start, ignore collision.
-				// The -1 and +1 portions are to still consider collisions
-				// for items which were merely touching at the start for all
-				// intents and purposes, but partially overlapped due to an
-				// off-by-one error (hypothetically, but they do happen so
-				// protect against it).
-				if(/* not non-overlapping start position */
-				   !(start[0] <= other[0] - (oext[0]-1) ||
-					 start[0] - dims[0] >= other[0]-1 ||
-					 start[1] <= other[1] - (oext[1]-1) ||
-					 start[1] - dims[1] >= other[1]-1 ||
-					 start[2] + dims[2] <= other[2]+1 ||
-					 start[2] >= other[2] + (oext[2]-1)))
-				{
-					// Overlapped at the start, and not just touching so
-					// ignore collision
+				sint32 first, last;
+				bool touch, touch_floor;
+				uint8 dirs;
+				if (!sweepItem(start, dims, vel, ext, centre, other_item,
+							   first, last, touch, touch_floor, dirs))
 					continue;
-				}
 
-				oext[0] /= 2; oext[1] /= 2; oext[2] /= 2;
+				//pout << "Hit item " << other_item->getObjId() << " at first: " << first << "  last: " << last << std::endl;
 
-				// Put other into our coord frame
-				other[0] -= oext[0]+centre[0];
-				other[1] -= oext[1]+centre[1];
-				other[2] += oext[2]-centre[2];
+				if (!hit) return true;
 
-				//first times of overlap along each axis
-				sint32 u_1[3] = {0,0,0};
+				// Clamp
+				if (first < -1) first = -1;
+				if (last > 0x4000) last = 0x4000;
 
-				//last times of overlap along each axis 
-				sint32 u_0[3] = {0x4000,0x4000,0x4000}; // CONSTANTS
+				// Ok, what we want to do here is add to the list.
+				// Sorted by hit_time. 
 
-				bool touch = false;
-				bool touch_floor = false;
-
-				//find the possible first and last times
-				//of overlap along each axis
-				for( long i=0 ; i<3 ; i++ )
+				// Small speed up.
+				if (sw_it != hit->end())
 				{
-					sint32 A_max = ext[i];	
-					sint32 A_min = -ext[i];	
-					sint32 B_max = other[i]+oext[i];	
-					sint32 B_min = other[i]-oext[i];	
+					SweepItem &si = *sw_it;
+					if (si.hit_time > first) sw_it = hit->begin();
+				}
+				else
+					sw_it = hit->begin();
 
-					if ( vel[i] < 0 && A_max>=B_min )		// A_max>=B_min not required
-					{
-						// Special case: if moving item has zero height and
-						// other item is a 128x128 flat, then moving item is
-						// considered blocked by the flat
-						// FIXME: it might be better to make this extra check
-						// identical to the 'flats' special case in ItemSorter
-						if (A_max==B_min && !
-							(i == 2 && ext[i] == 0 && oext[i] == 0 &&
-							 oext[0] == 64 && oext[1] == 64))
-							touch = true; // touch at start
-						if (A_min+vel[i]==B_max) touch = true; // touch at end
-
-						// - want to know when rear of A passes front of B
-						u_0[i] = ((B_max - A_min)*0x4000) / vel[i];
-						// - want to know when front of A passes rear of B
-						u_1[i] = ((B_min - A_max)*0x4000) / vel[i]; 
-					}
-					else if( vel[i] > 0 && A_min<=B_max)	// A_min<=B_max not required
-					{
-						if (A_min==B_max) touch = true; // touch at start
-						if (A_max+vel[i]==B_min) touch = true; // touch at end
+				for (;sw_it != hit->end(); ++sw_it) 
+					if ((*sw_it).hit_time > first) break;
 
-						// + want to know when front of A passes rear of B
-						u_0[i] = ((B_min - A_max)*0x4000) / vel[i];
-						// + want to know when rear of A passes front of B
-						u_1[i] = ((B_max - A_min)*0x4000) / vel[i]; 
-					}
-					else if( vel[i] == 0 && A_max >= B_min && A_min <= B_max)
-					{
-						if (A_min==B_max || A_max==B_min) touch = true;
-						if (i == 2 && A_min == B_max) touch_floor = true;
+				// Now add it
+				sw_it = hit->insert(sw_it, SweepItem(other_item->getObjId(),first,last,touch,touch_floor,blocking,dirs));
+//					pout << "Hit item " << other_item->getObjId() << " at (" << first << "," << last << ")" << std::endl;
+//					pout << "hit item      (" << other[0] << ", " << other[1] << ", " << other[2] << ")" << std::endl;
+//					pout << "hit item time (" << u_0[0] << "-" << u_1[0] << ") (" << u_0[1] << "-" << u_1[1] << ") ("
+//						 << u_0[2] << "-" << u_1[2] << ")" << std::endl;
+//					pout << "touch: " << touch << ", floor: " << touch_floor << ", block: " << blocking << std::endl;
+			}
+		}
+	}
 
-						u_0[i] = -1;
-						u_1[i] = 0x4000;
-					}
-					else
-					{
-						u_0[i] = 0x4001;
-						u_1[i] = -1;
-					}
+	return hit && hit->size();
+}
 
-					if (u_1[i] >= u_0[i] && (u_0[i] > 0x4000 || u_1[i] < 0))
-					{
-						u_0[i] = 0x4001;
-						u_1[i] = -1;
-					}
-				}
 
-				//possible first time of overlap
-				sint32 first = u_0[0];
-				if (u_0[1] > first) first = u_0[1];
-				if (u_0[2] > first) first = u_0[2];
-
-				//possible last time of overlap
-				sint32 last = u_1[0];
-				if (u_1[1] < last) last = u_1[1];
-				if (u_1[2] < last) last = u_1[2];
-
-				// store directions in which we're being blocked
-				uint8 dirs = 0;
-				for (int i = 0; i <= 2; ++i)
-					if (first == u_0[i])
-						dirs |= (1 << i);
-
-				//they could have only collided if
-				//the first time of overlap occurred
-				//before the last time of overlap
-				if (first <= last)
-				{
-					//pout << "Hit item " << other_item->getObjId() << " at first: " << first << "  last: " << last << std::endl;
+//! sorts query indices by the chunk their sweep starts in
+struct SweepQueryChunkLess {
+	SweepQueryChunkLess(const CurrentMap::SweepQuery* q, int size)
+		: queries(q), chunksize(size) { }
+	sint32 key(unsigned int i) const {
+		return (queries[i].start[1] / chunksize) * MAP_NUM_CHUNKS +
+			(queries[i].start[0] / chunksize);
+	}
+	bool operator()(unsigned int a, unsigned int b) const {
+		sint32 ka = key(a), kb = key(b);
+		return (ka != kb) ? (ka < kb) : (a < b);
+	}
+	const CurrentMap::SweepQuery* queries;
+	int chunksize;
+};
+
+void CurrentMap::sweepTestBatch(SweepQuery* queries, unsigned int count)
+{
+	const uint32 blockflagmask = (ShapeInfo::SI_SOLID|ShapeInfo::SI_DAMAGING);
 
-					if (!hit) return true;
+	if (count == 0) return;
+
+	// Queries starting in the same chunk (a spilled container, an explosion)
+	// usually cover nearly the same area, so their candidates are collected
+	// in one pass over the union of their boxes.
+	std::vector<unsigned int> order(count);
+	std::vector<sint32> bounds(count * 6);
+	unsigned int q;
+	for (q = 0; q < count; q++) {
+		order[q] = q;
+		queries[q].hit = false;
+		sweepBounds(queries[q].start, queries[q].end, queries[q].dims,
+					&bounds[q*6], &bounds[q*6+3]);
+	}
+	SweepQueryChunkLess less(queries, mapChunkSize);
+	std::sort(order.begin(), order.end(), less);
+
+	std::vector<CellEntry> found;
+	std::vector<Item*> candidates;
+
+	unsigned int groupstart = 0;
+	while (groupstart < count) {
+		unsigned int groupend = groupstart + 1;
+		while (groupend < count &&
+			   less.key(order[groupend]) == less.key(order[groupstart]))
+			groupend++;
+
+		sint32 lo[3], hi[3];
+		int i;
+		for (i = 0; i < 3; i++) {
+			lo[i] = bounds[order[groupstart]*6 + i];
+			hi[i] = bounds[order[groupstart]*6 + 3 + i];
+		}
+		for (q = groupstart + 1; q < groupend; q++) {
+			const sint32* b = &bounds[order[q]*6];
+			for (i = 0; i < 3; i++) {
+				if (b[i] < lo[i]) lo[i] = b[i];
+				if (b[3+i] > hi[i]) hi[i] = b[3+i];
+			}
+		}
 
-					// Clamp
-					if (first < -1) first = -1;
-					if (last > 0x4000) last = 0x4000;
+		int minx, miny, maxx, maxy;
+		minx = (lo[0]/mapChunkSize);
+		maxx = (hi[0]/mapChunkSize);
+		miny = (lo[1]/mapChunkSize);
+		maxy = (hi[1]/mapChunkSize);
+		if (minx < 0) minx = 0;
+		if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
+		if (miny < 0) miny = 0;
+		if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
+
+		candidates.clear();
+		for (int cx = minx; cx <= maxx; cx++) {
+			for (int cy = miny; cy <= maxy; cy++) {
+				found.clear();
+				findItems(cx, cy, lo, hi, found);
+
+				std::vector<CellEntry>::iterator iter;
+				for (iter = found.begin(); iter != found.end(); ++iter) {
+					if (iter->item->getExtFlags() & Item::EXT_SPRITE) continue;
+					candidates.push_back(iter->item);
+				}
+			}
+		}
 
-					// Ok, what we want to do here is add to the list.
-					// Sorted by hit_time. 
+		for (q = groupstart; q < groupend; q++) {
+			SweepQuery& query = queries[order[q]];
+			const sint32* b = &bounds[order[q]*6];
 
-					// Small speed up.
-					if (sw_it != hit->end())
-					{
-						SweepItem &si = *sw_it;
-						if (si.hit_time > first) sw_it = hit->begin();
-					}
-					else
-						sw_it = hit->begin();
+			sint32 vel[3], ext[3], centre[3];
+			for (i = 0; i < 3; i++) {
+				vel[i] = query.end[i] - query.start[i];
+				ext[i] = query.dims[i]/2;
+			}
+			centre[0] = query.start[0] - ext[0];
+			centre[1] = query.start[1] - ext[1];
+			centre[2] = query.start[2] + ext[2];
 
-					for (;sw_it != hit->end(); ++sw_it) 
-						if ((*sw_it).hit_time > first) break;
+			std::vector<Item*>::iterator iter;
+			for (iter = candidates.begin(); iter != candidates.end(); ++iter)
+			{
+				Item* other_item = *iter;
+				if (other_item->getObjId() == query.item) continue;
 
-					// Now add it
-					sw_it = hit->insert(sw_it, SweepItem(other_item->getObjId(),first,last,touch,touch_floor,blocking,dirs));
-//					pout << "Hit item " << other_item->getObjId() << " at (" << first << "," << last << ")" << std::endl;
-//					pout << "hit item      (" << other[0] << ", " << other[1] << ", " << other[2] << ")" << std::endl;
-//					pout << "hit item time (" << u_0[0] << "-" << u_1[0] << ") (" << u_0[1] << "-" << u_1[1] << ") ("
-//						 << u_0[2] << "-" << u_1[2] << ")" << std::endl;
-//					pout << "touch: " << touch << ", floor: " << touch_floor << ", block: " << blocking << std::endl;
+				// only what sweepTest would have found for this query
+				sint32 ox, oy, oz;
+				other_item->getLocation(ox, oy, oz);
+				if (ox < b[0] || ox > b[3] || oy < b[1] || oy > b[4] ||
+					oz < b[2] || oz > b[5])
+					continue;
+
+				uint32 othershapeflags = other_item->getShapeInfo()->flags;
+				bool blocking = (othershapeflags & query.shapeflags &
+								 blockflagmask) != 0;
+				if (query.blocking_only && !blocking)
+					continue;
+
+				sint32 first, last;
+				bool touch, touch_floor;
+				uint8 dirs;
+				if (sweepItem(query.start, query.dims, vel, ext, centre,
+							  other_item, first, last, touch, touch_floor,
+							  dirs))
+				{
+					query.hit = true;
+					break;
 				}
 			}
 		}
-	}
 
-	return hit && hit->size();
+		groupstart = groupend;
+	}
 }
 
 
@@ -1197,23 +1879,31 @@ Item *CurrentMap::traceTopItem(sint32 x, sint32 y, sint32 ztop, sint32 zbot, Obj
 		zbot = temp;
 	}
 
+	// only items located in this box can cover (x,y) between zbot and ztop
+	sint32 lo[3] = { x, y, zbot - getMaxHeight() };
+	sint32 hi[3] = { x + getMaxFootpad(), y + getMaxFootpad(), ztop };
+
 	int minx, miny, maxx, maxy;
-	minx = (x/mapChunkSize);
-	maxx = (x/mapChunkSize) + 1;
-	miny = (y/mapChunkSize);
-	maxy = (y/mapChunkSize) + 1;
+	minx = (lo[0]/mapChunkSize);
+	maxx = (hi[0]/mapChunkSize);
+	miny = (lo[1]/mapChunkSize);
+	maxy = (hi[1]/mapChunkSize);
 	if (minx < 0) minx = 0;
 	if (maxx >= MAP_NUM_CHUNKS) maxx = MAP_NUM_CHUNKS-1;
 	if (miny < 0) miny = 0;
 	if (maxy >= MAP_NUM_CHUNKS) maxy = MAP_NUM_CHUNKS-1;
 
+	std::vector<CellEntry> found;
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::iterator iter;
-			for (iter = items[cx][cy].begin();
-				 iter != items[cx][cy].end(); ++iter)
+			found.clear();
+			findItems(cx, cy, lo, hi, found);
+
+			std::vector<CellEntry>::iterator iter;
+			for (iter = found.begin(); iter != found.end(); ++iter)
 			{
-				Item* item = *iter;
+				Item* item = iter->item;
 				if (item->getObjId() == ignore) continue;
 				if (item->getExtFlags() & Item::EXT_SPRITE) continue;
 
@@ -1250,29 +1940,29 @@ void CurrentMap::setWholeMapFast()
 			if (!isChunkFast(j,i)) setChunkFast(j,i);
 		}
 	}
+
+	// the next change of the fast area has to look at every chunk
+	resetFastState();
 }
 
 void CurrentMap::save(ODataSource* ods)
 {
-	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; ++i) {
-		for (unsigned int j = 0; j < MAP_NUM_CHUNKS/32; ++j) {
-			ods->write4(fast[i][j]);
-		}
+	for (unsigned int i = 0; i < FastChunks::NUM_WORDS; ++i) {
+		ods->write4(fast.getWord(i));
 	}
 }
 
 bool CurrentMap::load(IDataSource* ids, uint32 version)
 {
-	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; ++i) {
-		for (unsigned int j = 0; j < MAP_NUM_CHUNKS/32; ++j) {
-			fast[i][j] = ids->read4();
-		}
+	for (unsigned int i = 0; i < FastChunks::NUM_WORDS; ++i) {
+		fast.setWord(i, ids->read4());
 	}
 
 	fast_x_min = -1;
 	fast_y_min = -1;
 	fast_x_max = -1;
 	fast_y_max = -1;
+	resetFastState();
 
 	return true;
 }
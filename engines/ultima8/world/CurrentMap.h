@@ -20,7 +20,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define CURRENTMAP_H
 
 #include <list>
+#include <vector>
 #include "intrinsics.h"
+#include "ChunkBitSet.h"
 
 class Map;
 class Item;
@@ -32,6 +34,13 @@ class ODataSource;
 
 #define MAP_NUM_CHUNKS	64
 
+//! every chunk is split into MAP_CHUNK_CELLS x MAP_CHUNK_CELLS cells for
+//! the spatial index (see CurrentMap::findItems)
+#define MAP_CHUNK_CELLS	4
+
+//! number of entries in the isValidPosition result cache (a power of 2)
+#define MAP_COLLISION_CACHE_SIZE	256
+
 class CurrentMap
 {
 	friend class World;
@@ -45,7 +54,7 @@ public:
 
 	//! sets the currently loaded map, without any processing.
 	//! (Should only be used for loading.)
-	void setMap(Map* map) { current_map = map; }
+	void setMap(Map* map) { current_map = map; calcShapeBounds(); }
 
 	//! Get the map number of the CurrentMap
 	uint32 getNum() const;
@@ -61,6 +70,22 @@ public:
 	void removeItemFromList(Item* item, sint32 oldx, sint32 oldy);
 	void removeItem(Item* item);
 
+	//! Update the spatial index after an item in the CurrentMap moved
+	//! from (oldx,oldy) to a location in the same chunk.
+	void updateItemLocation(Item* item, sint32 oldx, sint32 oldy);
+
+	//! Move an item in the CurrentMap from the chunk of (oldx,oldy) to the
+	//! chunk of its current location. Unlike removeItem/addItem this only
+	//! updates the item lists and the spatial index.
+	void changeItemChunk(Item* item, sint32 oldx, sint32 oldy);
+
+	//! Tell the EggHatcherProcess that an egg moved or changed its range
+	void eggChanged();
+
+	//! Tell the CurrentMap that the shape or FLG_FLIPPED of an item in the
+	//! map changed, so cached collision results involving it are dropped.
+	void itemChanged(Item* item);
+
 	//! Update the fast area for the cameras position
 	void updateFastArea(sint32 from_x, sint32 from_y, sint32 from_z, sint32 to_x, sint32 to_y, sint32 to_z);
 
@@ -172,6 +197,28 @@ public:
 				   const sint32 dims[3], uint32 shapeflags,
 				   ObjId item, bool solid_only, std::list<SweepItem> *hit);
 
+	//! One sweep for sweepTestBatch
+	struct SweepQuery {
+		sint32 start[3], end[3], dims[3];
+		uint32 shapeflags;
+		ObjId item;
+		bool blocking_only;
+		bool hit;			//!< result: same as sweepTest(..., 0)
+	};
+
+	//! Perform a number of sweepTests without hit lists at once. Queries
+	//! starting in the same chunk share one pass over the spatial index.
+	//! Like sweepTest this only reads the map (see Kernel's parallel phase).
+	void sweepTestBatch(SweepQuery* queries, unsigned int count);
+
+	//! The current change stamp of the map, for sweepChangedSince
+	uint32 getChangeStamp() const { return changecount; }
+
+	//! Has anything changed since stamp in the chunks a sweepTest from
+	//! start to end would look at? If not, its result still holds.
+	bool sweepChangedSince(const sint32 start[3], const sint32 end[3],
+						   const sint32 dims[3], uint32 stamp) const;
+
 	TeleportEgg* findDestination(uint16 id);
 
 	// Not allowed to modify the list. Remember to use const_iterator
@@ -188,21 +235,141 @@ public:
 		// CONSTANTS!
 		if (cx < 0 || cy < 0 || cx >= MAP_NUM_CHUNKS || cy >= MAP_NUM_CHUNKS) 
 			return false;
-		return (fast[cy][cx/32]&(1<<(cx&31))) != 0;
+		return fast.test(cx,cy);
 	}
 
+	typedef ChunkBitSet<MAP_NUM_CHUNKS> FastChunks;
+
+	//! The chunks in the fast area. Use FastChunks::findNext to walk them.
+	const FastChunks& getFastChunks() const { return fast; }
+
 	// A simple trace to find the top item at a specific xy point
 	Item *traceTopItem(sint32 x, sint32 y, sint32 ztop, sint32 zbot, ObjId ignore, uint32 shflags);
 
 	// Set the entire map as being 'fast' 
 	void setWholeMapFast();
 
+	//! Set the time (in microseconds) updateFastArea may spend per call
+	//! entering and leaving chunks that aren't on screen yet.
+	//! 0 means everything is done right away.
+	static void setFastAreaBudget(uint32 usecs) { fastAreaBudget = usecs; }
+
 	void save(ODataSource* ods);
 	bool load(IDataSource* ids, uint32 version);
 
+	//! "CurrentMap::collisionCache" console command
+	static void ConCmd_collisionCache(const Console::ArgvType &argv);
+
+	//! Time spent in the phases of the last map switch
+	//! (performance counter ticks)
+	struct LoadStats {
+		uint32 mapnum;
+		bool prefetched;	//!< fixed items came from the MapPrefetcher
+		Uint64 decode;		//!< reading fixed items (without ItemFactory)
+		Uint64 create;		//!< ItemFactory, for the fixed items
+		Uint64 additems;	//!< assigning objids, adding to the map
+		Uint64 cachein;		//!< cachein usecode events
+		Uint64 npcs;		//!< scheduling and adding the NPCs
+		Uint64 fastarea;	//!< first fast area update after the load
+		uint32 itemcount;
+		bool fastpending;	//!< fastarea hasn't been measured yet
+	};
+
+	//! reset the load statistics for a switch to map 'mapnum'
+	LoadStats& beginLoadStats(uint32 mapnum);
+
+	//! "CurrentMap::loadStats" console command
+	static void ConCmd_loadStats(const Console::ArgvType &argv);
+
 	INTRINSIC(I_canExistAt);
 
 private:
+	//! An item found in the spatial index. seq has the same order as the
+	//! item's position in its chunk's item list.
+	struct CellEntry {
+		Item* item;
+		sint32 seq;
+	};
+
+	//! The items in a cell, stored as separate arrays so the location
+	//! checks in findItems don't have to touch the Items themselves.
+	//! The locations are updated on every move (see updateItemLocation).
+	struct ItemCell {
+		std::vector<sint32> x, y, z;
+		std::vector<sint32> seq;
+		std::vector<Item*> item;
+
+		void push_back(Item* item, sint32 x, sint32 y, sint32 z, sint32 seq);
+		void erase(unsigned int i);
+		void clear();
+	};
+
+	//! The spatial index of a chunk. The items are bucketed by the cell
+	//! their (x,y) location is in, their footpad isn't taken into account.
+	struct ChunkCells {
+		ChunkCells() : frontseq(0), backseq(0), lastchange(0) { }
+		ItemCell cells[MAP_CHUNK_CELLS*MAP_CHUNK_CELLS];
+		sint32 frontseq, backseq;
+		uint32 lastchange;	//!< value of changecount at the last change
+	};
+
+	static bool CellEntrySeqLess(const CellEntry& a, const CellEntry& b)
+		{ return a.seq < b.seq; }
+
+	//! get the index of the cell containing (x,y) in chunk (cx,cy)
+	int getCell(sint32 cx, sint32 cy, sint32 x, sint32 y) const;
+	//! add an item to the item list and the spatial index of its chunk
+	//! \return false if the item's location is out of range
+	bool addItemToList(Item* item, bool atfront);
+	void addToIndex(Item* item, sint32 cx, sint32 cy, bool atfront);
+	void removeFromIndex(Item* item, sint32 x, sint32 y);
+	void clearIndex();
+
+	//! the box (inclusive) of item locations sweepTest has to look at
+	void sweepBounds(const sint32 start[3], const sint32 end[3],
+					 const sint32 dims[3], sint32 lo[3], sint32 hi[3]) const;
+
+	//! sweep an item (see sweepTest) against other_item
+	//! \return true if they collide; first..last is the time of overlap
+	static bool sweepItem(const sint32 start[3], const sint32 dims[3],
+						  const sint32 vel[3], const sint32 ext[3],
+						  const sint32 centre[3], Item* other_item,
+						  sint32& first, sint32& last, bool& touch,
+						  bool& touch_floor, uint8& dirs);
+
+	//! Find all items in chunk (cx,cy) with a location inside the box
+	//! [lo,hi] (inclusive), in item list order.
+	void findItems(sint32 cx, sint32 cy, const sint32 lo[3],
+				   const sint32 hi[3], std::vector<CellEntry>& out) const;
+
+	//! the largest x or y footpad of any shape, in world coordinates
+	sint32 getMaxFootpad() const { return maxFootpad; }
+	//! the largest z footpad of any shape, in world coordinates
+	sint32 getMaxHeight() const { return maxHeight; }
+	//! compute maxFootpad and maxHeight. Called from the main thread when
+	//! a map is entered, so the sweeps in the parallel phase only read them.
+	void calcShapeBounds();
+
+	//! A cached isValidPosition result. It's valid as long as none of the
+	//! chunks it looked at changed after 'stamp'.
+	struct CollisionCacheEntry {
+		sint32 x, y, z, startx, starty, startz;
+		sint32 xd, yd, zd;
+		uint32 shapeflags;
+		ObjId item;
+		uint32 stamp;		//!< 0 = unused
+		bool valid;
+		Item* support;
+		ObjId roof;
+	};
+
+	//! mark chunk (cx,cy) as changed
+	void touchChunk(sint32 cx, sint32 cy);
+	//! has any chunk in the range changed since stamp?
+	bool chunksChangedSince(int minx, int miny, int maxx, int maxy,
+							uint32 stamp) const;
+	void clearCollisionCache();
+
 	void loadItems(std::list<Item*> itemlist, bool callCacheIn);
 	void createEggHatcher();
 
@@ -212,16 +379,50 @@ private:
 	// items[x][y]
 	std::list<Item*>** items;
 
+	// spatial index of the items. Kept in sync with the item lists.
+	// cells[x][y]
+	ChunkCells** cells;
+
+	// see getMaxFootpad and getMaxHeight. Set by calcShapeBounds.
+	sint32 maxFootpad, maxHeight;
+
+	// isValidPosition result cache. Only used from the main thread.
+	CollisionCacheEntry collisionCache[MAP_COLLISION_CACHE_SIZE];
+	uint32 changecount;		//!< incremented on every change to the map
+	uint32 cacheHits, cacheMisses;
+
+	LoadStats loadstats;
+
 	ProcId egghatcher;
 
-	// Fast area bit masks -> fast[ry][rx/32]&(1<<(rx&31));
-	uint32** fast;	
+	// Fast area bit masks
+	FastChunks fast;
 	sint32 fast_x_min, fast_y_min, fast_x_max, fast_y_max;
 
 	int mapChunkSize;
 
 	void setChunkFast(sint32 cx, sint32 cy);
 	void unsetChunkFast(sint32 cx, sint32 cy);
+
+	//! enter/leave queued chunks until the fastAreaBudget runs out
+	void processFastQueue();
+	//! forget the queue and the previous fast area
+	void resetFastState();
+
+	enum FastStateFlags {
+		FAST_WANTED = 0x01,		//!< chunk should be fast
+		FAST_QUEUED = 0x02		//!< chunk is in fastQueue
+	};
+
+	// fastState[cy][cx]
+	uint8 fastState[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
+	//! chunks (cy*MAP_NUM_CHUNKS+cx) waiting to enter or leave
+	std::vector<uint16> fastQueue;
+	unsigned int fastQueuePos;
+	//! coarse chunk limits of the previous fast area. min > max: unknown
+	sint32 fast_cx_min, fast_cy_min, fast_cx_max, fast_cy_max;
+
+	static uint32 fastAreaBudget;
 };
 
 #endif
@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "GUIApp.h"
 #include "getObject.h"
 #include "UCMachine.h"
+#include "World.h"
+#include "CurrentMap.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
@@ -99,6 +101,8 @@ uint32 Egg::I_setEggXRange(const uint8* args, unsigned int /*argsize*/)
 	if (!egg) return 0;
 
 	egg->setXRange(xr);
+	if (egg->getExtFlags() & Item::EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->eggChanged();
 	return 0;
 }
 
@@ -109,6 +113,8 @@ uint32 Egg::I_setEggYRange(const uint8* args, unsigned int /*argsize*/)
 	if (!egg) return 0;
 
 	egg->setYRange(yr);
+	if (egg->getExtFlags() & Item::EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->eggChanged();
 	return 0;
 }
 
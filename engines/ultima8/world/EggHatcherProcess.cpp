@@ -22,14 +22,31 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Egg.h"
 #include "MainActor.h"
 #include "TeleportEgg.h"
+#include "World.h"
 #include "getObject.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
 
+#include <algorithm>
+
 DEFINE_RUNTIME_CLASSTYPE_CODE(EggHatcherProcess,Process);
 
+//! distance (outside the egg's range) at which the teleporter's
+//! destination map is prefetched
+static const sint32 PREFETCH_RANGE = 32 * 16; // 16 tiles
+
+//! size of a trigger cell in world units
+static const sint32 TRIGGER_CELL_SIZE = 1024;
+
+static inline sint32 triggerCell(sint32 v)
+{
+	return (v < 0) ? 0 : v / TRIGGER_CELL_SIZE;
+}
+
 EggHatcherProcess::EggHatcherProcess()
+	: triggersDirty(true), cand_cx1(-1), cand_cy1(-1),
+	  cand_cx2(-1), cand_cy2(-1)
 {
 
 }
@@ -43,12 +60,73 @@ EggHatcherProcess::~EggHatcherProcess()
 void EggHatcherProcess::addEgg(uint16 egg)
 {
 	eggs.push_back(egg);
+	triggersDirty = true;
 }
 
 void EggHatcherProcess::addEgg(Egg* egg)
 {
 	assert(egg);
 	eggs.push_back(egg->getObjId());
+
+	if (!triggersDirty) {
+		indexEgg(static_cast<unsigned int>(eggs.size() - 1), egg);
+		cand_cx1 = -1; // candidates have to be collected again
+	}
+}
+
+void EggHatcherProcess::indexEgg(unsigned int index, Egg* egg)
+{
+	sint32 x,y,z;
+	egg->getLocation(x,y,z);
+
+	// everything run() checks lies within the prefetch range
+	sint32 x1 = x - 32 * egg->getXRange() - PREFETCH_RANGE;
+	sint32 x2 = x + 32 * egg->getXRange() + PREFETCH_RANGE - 1;
+	sint32 y1 = y - 32 * egg->getYRange() - PREFETCH_RANGE;
+	sint32 y2 = y + 32 * egg->getYRange() + PREFETCH_RANGE - 1;
+
+	for (sint32 cy = triggerCell(y1); cy <= triggerCell(y2); cy++)
+		for (sint32 cx = triggerCell(x1); cx <= triggerCell(x2); cx++)
+			triggers[(static_cast<uint32>(cy) << 16) | cx].push_back(index);
+}
+
+void EggHatcherProcess::rebuildTriggers()
+{
+	triggers.clear();
+
+	for (unsigned int i = 0; i < eggs.size(); i++) {
+		Egg* egg = p_dynamic_cast<Egg*>(getObject(eggs[i]));
+		if (egg) indexEgg(i, egg);
+	}
+
+	triggersDirty = false;
+	cand_cx1 = -1;
+}
+
+void EggHatcherProcess::findCandidates(sint32 cx1, sint32 cy1,
+									   sint32 cx2, sint32 cy2)
+{
+	candidates.clear();
+
+	for (sint32 cy = cy1; cy <= cy2; cy++) {
+		for (sint32 cx = cx1; cx <= cx2; cx++) {
+			std::map<uint32, std::vector<unsigned int> >::iterator it;
+			it = triggers.find((static_cast<uint32>(cy) << 16) | cx);
+			if (it == triggers.end()) continue;
+			candidates.insert(candidates.end(),
+							  it->second.begin(), it->second.end());
+		}
+	}
+
+	// keep the order in which the eggs were added, like a plain scan would
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()),
+					 candidates.end());
+
+	cand_cx1 = cx1;
+	cand_cy1 = cy1;
+	cand_cx2 = cx2;
+	cand_cy2 = cy2;
 }
 
 void EggHatcherProcess::run()
@@ -57,8 +135,40 @@ void EggHatcherProcess::run()
 	MainActor* av = getMainActor();
 	assert(av);
 
-	for (unsigned int i = 0; i < eggs.size(); i++) {
-		uint16 eggid = eggs[i];
+	// only look at the eggs whose range reaches the avatar's trigger cells
+	std::vector<unsigned int> current;
+	unsigned int i = 0;
+	sint32 ax,ay,az;
+	sint32 axs,ays,azs;
+	bool moved = true;
+
+	for (;;) {
+		// get avatar location
+		av->getLocation(ax,ay,az);
+		av->getFootpadWorld(axs,ays,azs);
+
+		sint32 cx1 = triggerCell(ax - axs), cx2 = triggerCell(ax);
+		sint32 cy1 = triggerCell(ay - ays), cy2 = triggerCell(ay);
+		if (moved) {
+			// a hatched egg can move the avatar. Carry on with the eggs
+			// near the new position that come after the last one checked.
+			unsigned int next = (i == 0) ? 0 : current[i - 1] + 1;
+			if (triggersDirty) rebuildTriggers();
+			if (cx1 != cand_cx1 || cy1 != cand_cy1 ||
+				cx2 != cand_cx2 || cy2 != cand_cy2)
+				findCandidates(cx1, cy1, cx2, cy2);
+
+			// hatching can add eggs and change candidates: work on a copy
+			current = candidates;
+			i = static_cast<unsigned int>(
+				std::lower_bound(current.begin(), current.end(), next)
+				- current.begin());
+		}
+		moved = false;
+
+		if (i >= current.size()) break;
+
+		uint16 eggid = eggs[current[i++]];
 		Egg* egg = p_dynamic_cast<Egg*>(getObject(eggid));
 		if (!egg) continue; // egg gone
 
@@ -71,18 +181,20 @@ void EggHatcherProcess::run()
 		sint32 y1 = y - 32 * egg->getYRange();
 		sint32 y2 = y + 32 * egg->getYRange();
 
-		// get avatar location
-		sint32 ax,ay,az;
-		sint32 axs,ays,azs;
-		av->getLocation(ax,ay,az);
-		av->getFootpadWorld(axs,ays,azs);
-
 		// 'justTeleported':
 		// if the avatar teleports, set the 'justTeleported' flag.
 		// if this is set, don't hatch any teleport eggs
 		// unset it when you're out of range of any teleport eggs
 		TeleportEgg* tegg = p_dynamic_cast<TeleportEgg*>(egg);
 
+		// start loading the destination map when the avatar gets close
+		if (tegg && tegg->isTeleporter() &&
+			x1 - PREFETCH_RANGE <= ax && ax-axs < x2 + PREFETCH_RANGE &&
+			y1 - PREFETCH_RANGE <= ay && ay-ays < y2 + PREFETCH_RANGE)
+		{
+			World::get_instance()->prefetchMap(tegg->getMapNum());
+		}
+
 		if (x1 <= ax && ax-axs < x2 && y1 <= ay && ay-ays < y2 &&
 			z - 48 < az && az <= z + 48) { // CONSTANTS!
 			if (tegg && tegg->isTeleporter()) nearteleporter = true;
@@ -90,6 +202,7 @@ void EggHatcherProcess::run()
 			if (tegg && av->hasJustTeleported()) continue;
 
 			egg->hatch();
+			moved = true;
 		}
 	}
 
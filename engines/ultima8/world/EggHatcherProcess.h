@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Process.h"
 
 #include <vector>
+#include <map>
 
 class Egg;
 
@@ -39,11 +40,29 @@ public:
 	void addEgg(Egg* egg);
 	void addEgg(uint16 egg);
 
+	//! An egg moved or changed its range: rebuild the trigger index
+	void invalidateTriggers() { triggersDirty = true; }
+
 	bool loadData(IDataSource* ids, uint32 version);
 private:
 	virtual void saveData(ODataSource* ods);
 
+	//! add eggs[index] to every trigger cell its range can reach
+	void indexEgg(unsigned int index, Egg* egg);
+	void rebuildTriggers();
+	//! collect the eggs that can trigger for the given world area
+	void findCandidates(sint32 cx1, sint32 cy1, sint32 cx2, sint32 cy2);
+
 	std::vector<uint16> eggs;
+
+	//! trigger cells (cy << 16 | cx), holding indices into eggs
+	std::map<uint32, std::vector<unsigned int> > triggers;
+	bool triggersDirty;
+
+	//! eggs near the avatar, in the order they were added
+	std::vector<unsigned int> candidates;
+	//! trigger cells covered by the avatar when candidates was built
+	sint32 cand_cx1, cand_cy1, cand_cx2, cand_cy2;
 };
 
 
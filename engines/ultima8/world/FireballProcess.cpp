@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Direction.h"
 #include "WeaponInfo.h"
 #include "getObject.h"
+#include "ObjectManager.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
@@ -52,7 +53,7 @@ FireballProcess::FireballProcess(Item* item, Item* target_)
 
 	item_num = item->getObjId();
 
-	target = target_->getObjId();
+	target = ObjectManager::get_instance()->getHandle(target_->getObjId());
 
 	type = 0x218; // CONSTANT!
 }
@@ -67,7 +68,7 @@ void FireballProcess::run()
 		return;
 	}
 
-	Item* t = getItem(target);
+	Item* t = getItemByHandle(target);
 	if (!t) {
 		terminate();
 		return;
@@ -208,7 +209,7 @@ void FireballProcess::saveData(ODataSource* ods)
 
 	ods->write4(static_cast<uint32>(xspeed));
 	ods->write4(static_cast<uint32>(yspeed));
-	ods->write2(target);
+	ods->write2(ObjectManager::getHandleObjId(target));
 	ods->write2(tail[0]);
 	ods->write2(tail[1]);
 	ods->write2(tail[2]);
@@ -221,7 +222,7 @@ bool FireballProcess::loadData(IDataSource* ids, uint32 version)
 
 	xspeed = static_cast<int>(ids->read4());
 	yspeed = static_cast<int>(ids->read4());
-	target = ids->read2();
+	target = ObjectManager::get_instance()->getLoadHandle(ids->read2());
 	tail[0] = ids->read2();
 	tail[1] = ids->read2();
 	tail[2] = ids->read2();
@@ -47,7 +47,7 @@ protected:
 
 	int xspeed, yspeed;
 	ObjId tail[3];
-	ObjId target;
+	ObjHandle target;
 	uint16 age;
 };
 
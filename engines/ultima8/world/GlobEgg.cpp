@@ -26,10 +26,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "CoreApp.h"
 #include "IDataSource.h"
 #include "ODataSource.h"
+#include "profiler/Frame_profiler.h"
 
 // p_dynamic_cast stuff
 DEFINE_RUNTIME_CLASSTYPE_CODE(GlobEgg,Item);
 
+GlobEgg::ExpandStats GlobEgg::expandstats = { 0, 0, 0 };
+
 GlobEgg::GlobEgg()
 {
 
@@ -45,11 +48,8 @@ GlobEgg::~GlobEgg()
 void GlobEgg::enterFastArea()
 {
 	uint32 coordmask = ~0x1FF;
-	unsigned int coordshift = 1;
-	if (GAME_IS_CRUSADER) {
+	if (GAME_IS_CRUSADER)
 		coordmask = ~0x3FF;
-		coordshift = 2;
-	}
 
 	// Expand it
 	if (!(flags & FLG_FASTAREA)) 
@@ -57,23 +57,30 @@ void GlobEgg::enterFastArea()
 		MapGlob* glob = GameData::get_instance()->getGlob(quality);
 		if (!glob) return;
 
-		std::vector<GlobItem>::iterator iter;
-		for (iter = glob->contents.begin(); iter!=glob->contents.end(); ++iter)
+		PROFILE_ZONE("GlobEgg::expand");
+		Uint64 start = SDL_GetPerformanceCounter();
+
+		// The template has the shape families and the offsets from the
+		// chunk corner already, see MapGlob::buildTemplate
+		const std::vector<GlobTemplateItem>& items = glob->getTemplate();
+		sint32 basex = x & coordmask;
+		sint32 basey = y & coordmask;
+
+		std::vector<GlobTemplateItem>::const_iterator iter;
+		for (iter = items.begin(); iter != items.end(); ++iter)
 		{
-			GlobItem& globitem = *iter;
-			Item* item = ItemFactory::createItem(globitem.shape,globitem.frame,
+			Item* item = ItemFactory::createItemOfFamily(iter->family,
+												 iter->shape, iter->frame,
 												 0,
 												 FLG_DISPOSABLE|FLG_FAST_ONLY,
 												 0, 0, 0, true);
 
-
-			// calculate object's world position
-			sint32 itemx = (x & coordmask) + (globitem.x << coordshift) + 1;
-			sint32 itemy = (y & coordmask) + (globitem.y << coordshift) + 1;
-			sint32 itemz = z + globitem.z;
-
-			item->move(itemx, itemy, itemz);
+			item->move(basex + iter->x, basey + iter->y, z + iter->z);
 		}
+
+		expandstats.expansions++;
+		expandstats.items += static_cast<uint32>(items.size());
+		expandstats.ticks += SDL_GetPerformanceCounter() - start;
 	}
 
 	Item::enterFastArea();
@@ -90,3 +97,27 @@ bool GlobEgg::loadData(IDataSource* ids, uint32 version)
 
 	return true;
 }
+
+void GlobEgg::ConCmd_expandStats(const Console::ArgvType &argv)
+{
+	if (argv.size() == 2 && argv[1] == "reset") {
+		expandstats.expansions = 0;
+		expandstats.items = 0;
+		expandstats.ticks = 0;
+		pout << "Glob expansion statistics cleared" << std::endl;
+		return;
+	} else if (argv.size() != 1) {
+		pout << "usage: GlobEgg::expandStats [reset]" << std::endl;
+		return;
+	}
+
+	double ms = 1000.0 / SDL_GetPerformanceFrequency();
+
+	pout << "Globs expanded: " << expandstats.expansions << ", "
+		 << expandstats.items << " items, " << expandstats.ticks * ms
+		 << " ms" << std::endl;
+	if (expandstats.expansions)
+		pout << "  per glob:      "
+			 << expandstats.ticks * ms / expandstats.expansions << " ms"
+			 << std::endl;
+}
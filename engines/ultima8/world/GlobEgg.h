@@ -37,8 +37,20 @@ public:
 	virtual void enterFastArea(); 
 
 	bool loadData(IDataSource* ids, uint32 version);
+
+	//! "GlobEgg::expandStats" console command
+	static void ConCmd_expandStats(const Console::ArgvType &argv);
+
 protected:
 	virtual void saveData(ODataSource* ods);
+
+	//! totals of the globs expanded, for ConCmd_expandStats
+	struct ExpandStats {
+		uint32 expansions;
+		uint32 items;
+		Uint64 ticks;		//!< creating and placing the items
+	};
+	static ExpandStats expandstats;
 };
 
 
@@ -37,13 +37,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 DEFINE_RUNTIME_CLASSTYPE_CODE(GravityProcess,Process);
 
 GravityProcess::GravityProcess()
-	: Process()
+	: Process(), restframes(0), stagedframe(0), stagedstamp(0)
 {
 
 }
 
 GravityProcess::GravityProcess(Item* item, int gravity_)
-	: xspeed(0), yspeed(0), zspeed(0)
+	: xspeed(0), yspeed(0), zspeed(0), restframes(0), stagedframe(0),
+	  stagedstamp(0)
 {
 	assert(item);
 
@@ -71,6 +72,7 @@ void GravityProcess::move(int xs, int ys, int zs)
 	xspeed += xs;
 	yspeed += ys;
 	zspeed += zs;
+	restframes = 0;
 }
 
 void GravityProcess::setGravity(int gravity_)
@@ -81,6 +83,73 @@ void GravityProcess::setGravity(int gravity_)
 		gravity = gravity_;
 }
 
+void GravityProcess::runParallel()
+{
+	stagedframe = 0;
+
+	Item* item = getItem(item_num);
+	if (!item) return;
+
+	item->getLocation(staged_from[0], staged_from[1], staged_from[2]);
+	staged_to[0] = staged_from[0] + xspeed;
+	staged_to[1] = staged_from[1] + yspeed;
+	staged_to[2] = staged_from[2] + zspeed;
+	stagedstamp = World::get_instance()->getCurrentMap()->getChangeStamp();
+
+	if (item->canMoveFreely(staged_to[0], staged_to[1], staged_to[2]))
+		stagedframe = Kernel::get_instance()->getFrameNum();
+}
+
+void GravityProcess::runParallelBatch(Process** procs, unsigned int count)
+{
+	std::vector<CurrentMap::SweepQuery> queries;
+	std::vector<GravityProcess*> staged;
+	queries.reserve(count);
+	staged.reserve(count);
+
+	for (unsigned int i = 0; i < count; i++) {
+		GravityProcess* p = static_cast<GravityProcess*>(procs[i]);
+		p->stagedframe = 0;
+
+		Item* item = getItem(p->item_num);
+		// contained items always teleport, see Item::canMoveFreely
+		if (!item || item->getParent()) continue;
+
+		item->getLocation(p->staged_from[0], p->staged_from[1],
+						  p->staged_from[2]);
+		p->staged_to[0] = p->staged_from[0] + p->xspeed;
+		p->staged_to[1] = p->staged_from[1] + p->yspeed;
+		p->staged_to[2] = p->staged_from[2] + p->zspeed;
+
+		CurrentMap::SweepQuery q;
+		for (int j = 0; j < 3; j++) {
+			q.start[j] = p->staged_from[j];
+			q.end[j] = p->staged_to[j];
+		}
+		item->getFootpadWorld(q.dims[0], q.dims[1], q.dims[2]);
+		q.shapeflags = item->getShapeInfo()->flags;
+		q.item = item->getObjId();
+		q.blocking_only = false;
+		q.hit = false;
+
+		queries.push_back(q);
+		staged.push_back(p);
+	}
+
+	if (queries.empty()) return;
+
+	CurrentMap* map = World::get_instance()->getCurrentMap();
+	uint32 stamp = map->getChangeStamp();
+	map->sweepTestBatch(&queries[0], static_cast<unsigned int>(queries.size()));
+
+	// run() still checks stagedstamp before trusting these results
+	uint32 framenum = Kernel::get_instance()->getFrameNum();
+	for (unsigned int i = 0; i < staged.size(); i++) {
+		staged[i]->stagedstamp = stamp;
+		if (!queries[i].hit) staged[i]->stagedframe = framenum;
+	}
+}
+
 void GravityProcess::run()
 {
 	// move item in (xs,ys,zs) direction
@@ -106,6 +175,19 @@ void GravityProcess::run()
 
 	sint32 ix,iy,iz;
 	item->getLocation(ix, iy, iz);
+
+	if (restframes > 0 && abs(ix - rest_at[0]) <= SLEEP_DISTANCE &&
+		abs(iy - rest_at[1]) <= SLEEP_DISTANCE &&
+		abs(iz - rest_at[2]) <= SLEEP_DISTANCE)
+	{
+		restframes++;
+	} else {
+		rest_at[0] = ix;
+		rest_at[1] = iy;
+		rest_at[2] = iz;
+		restframes = 1;
+	}
+
 	sint32 ixd,iyd,izd;
 	item->getFootpadWorld(ixd, iyd, izd);
 
@@ -146,9 +228,25 @@ void GravityProcess::run()
 
 //#define BOUNCE_DIAG
 
-	ObjId hititemid;
-	uint8 dirs;
-	sint32 dist = item->collideMove(tx,ty,tz, false, false, &hititemid, &dirs);
+	ObjId hititemid = 0;
+	uint8 dirs = 0;
+	sint32 dist;
+	sint32 dims[3] = { ixd, iyd, izd };
+	if (stagedframe == Kernel::get_instance()->getFrameNum() &&
+		ix == staged_from[0] && iy == staged_from[1] &&
+		iz == staged_from[2] && tx == staged_to[0] && ty == staged_to[1] &&
+		tz == staged_to[2] &&
+		!World::get_instance()->getCurrentMap()->sweepChangedSince(
+			staged_from, staged_to, dims, stagedstamp))
+	{
+		// runParallel() already found nothing in the way, and nothing
+		// it looked at was moved by an earlier run() in this frame
+		item->move(tx,ty,tz);
+		dist = 0x4000;
+	} else {
+		dist = item->collideMove(tx,ty,tz, false, false, &hititemid, &dirs);
+	}
+	stagedframe = 0;
 
 	if (dist == 0x4000 && !clipped) {
 		// normal move
@@ -162,6 +260,20 @@ void GravityProcess::run()
 	
 	// Item was blocked
 
+	// An item jittering on an uneven pile (see the bounces below) can
+	// keep going forever, so after a while it's left where it is.
+	// Item::grab() and Item::destroy() make it fall again if what's under
+	// it goes.
+	if (!actor && (dirs & 4) && zspeed < 0 && restframes >= SLEEP_FRAMES) {
+#ifdef BOUNCE_DIAG
+		pout << "item " << item_num << " bounce ["
+			 << Kernel::get_instance()->getFrameNum()
+			 << "]: resting" << std::endl;
+#endif
+		item->clearFlag(Item::FLG_BOUNCING);
+		terminateDeferred();
+		return;
+	}
 
 	// We behave differently depending on which direction was blocked.
 	// We only consider stopping to bounce when blocked purely in the
@@ -41,6 +41,11 @@ public:
 	virtual void run();
 	virtual void terminate();
 
+	virtual bool hasParallelPhase() const { return true; }
+	virtual void runParallel();
+	virtual ParallelBatchFunc getParallelBatch() const
+		{ return &runParallelBatch; }
+
 	virtual void dumpInfo();
 
 	bool loadData(IDataSource* ids, uint32 version);
@@ -49,8 +54,27 @@ protected:
 
 	void fallStopped();
 
+	//! runParallel() for many gravity processes with one sweepTestBatch
+	static void runParallelBatch(Process** procs, unsigned int count);
+
 	int gravity;
 	int xspeed, yspeed, zspeed;
+
+	//! An item that stays within SLEEP_DISTANCE of rest_at for
+	//! SLEEP_FRAMES frames, still hitting what's under it, is left to rest:
+	//! the process ends until something under the item is taken away.
+	//! Not saved; counting starts over after loading.
+	enum { SLEEP_FRAMES = 12, SLEEP_DISTANCE = 4 }; // CONSTANTS!
+	int restframes;
+	sint32 rest_at[3];
+
+	//! result of runParallel(): the item can move freely from staged_from
+	//! to staged_to. Only valid in frame stagedframe (0 = nothing staged),
+	//! and only if the map hasn't changed around the sweep since
+	//! stagedstamp (see CurrentMap::sweepChangedSince).
+	uint32 stagedframe;
+	uint32 stagedstamp;
+	sint32 staged_from[3], staged_to[3];
 };
 
 
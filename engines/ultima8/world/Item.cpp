@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ItemFactory.h"
 #include "CurrentMap.h"
 #include "UCStack.h"
+#include "CompiledLoopScript.h"
 #include "Direction.h"
 #include "BarkGump.h"
 #include "AskGump.h"
@@ -131,9 +132,31 @@ Item* Item::getTopItem()
 
 void Item::setLocation(sint32 X, sint32 Y, sint32 Z)
 {
+	sint32 oldx = x, oldy = y;
+
 	x = X;
 	y = Y;
 	z = Z;
+
+	if (extendedflags & EXT_INCURMAP) {
+		CurrentMap* map = World::get_instance()->getCurrentMap();
+		int mapChunkSize = map->getChunkSize();
+
+		if (oldx / mapChunkSize == X / mapChunkSize &&
+			oldy / mapChunkSize == Y / mapChunkSize)
+		{
+			map->updateItemLocation(this, oldx, oldy);
+		} else {
+			// keep the item lists consistent
+			map->changeItemChunk(this, oldx, oldy);
+		}
+	}
+}
+
+void Item::footpadChanged()
+{
+	if (extendedflags & EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->itemChanged(this);
 }
 
 void Item::move(sint32 X, sint32 Y, sint32 Z)
@@ -185,13 +208,20 @@ void Item::move(sint32 X, sint32 Y, sint32 Z)
 	// Unset all the various flags that no longer apply
 	flags &= ~(FLG_CONTAINED|FLG_EQUIPPED|FLG_ETHEREAL);
 
+	sint32 oldx = x, oldy = y;
+
 	// Set the location
 	x = X;
 	y = Y;
 	z = Z;
 
 	// Add it to the map if needed
-	if (!(extendedflags & EXT_INCURMAP))
+	if (extendedflags & EXT_INCURMAP)
+	{
+		// Still in the same chunk
+		map->updateItemLocation(this, oldx, oldy);
+	}
+	else
 	{
 		// Disposable fast only items get put at the end
 		// While normal items get put at start
@@ -654,179 +684,7 @@ uint32 Item::getVolume()
 
 bool Item::checkLoopScript(const uint8* script, uint32 scriptsize)
 {
-	// if really necessary this could be made static to prevent news/deletes
-	DynamicUCStack stack(0x40); // 64bytes should be plenty of room
-
-	unsigned int i = 0;
-
-	uint16 ui16a, ui16b;
-
-	stack.push2(1); // default to true if script is empty
-
-	while (i < scriptsize) {
-		switch(script[i]) {
-		case LS_TOKEN_FALSE: // false
-			stack.push2(0); break;
-
-		case LS_TOKEN_TRUE: // true
-			stack.push2(1); break;
-
-		case LS_TOKEN_END: // end
-			ui16a = stack.pop2();
-			return (ui16a != 0);
-
-		case LS_TOKEN_INT: // int
-			//! check for i out of bounds
-			ui16a = script[i+1] + (script[i+2]<<8);
-			stack.push2(ui16a);
-			i += 2;
-			break;
-
-		case LS_TOKEN_AND: // and
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16a != 0 && ui16b != 0)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;
-
-		case LS_TOKEN_OR: // or
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16a != 0 || ui16b != 0)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;			
-
-		case LS_TOKEN_NOT: // not
-			ui16a = stack.pop2();
-			if (ui16a != 0)
-				stack.push2(0);
-			else
-				stack.push2(1);
-			break;
-
-		case LS_TOKEN_STATUS: // item status
-			stack.push2(getFlags());
-			break;
-
-		case LS_TOKEN_Q: // item quality
-			stack.push2(getQuality());
-			break;
-
-		case LS_TOKEN_NPCNUM: // npc num
-			stack.push2(getNpcNum());
-			break;
-
-		case LS_TOKEN_EQUAL: // equal
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16a == ui16b)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;
-
-		case LS_TOKEN_GREATER: // greater than
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16b > ui16a)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;
-
-		case LS_TOKEN_LESS: // less than
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16b < ui16a)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;
-
-		case LS_TOKEN_GEQUAL: // greater or equal
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16b >= ui16a)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;
-
-		case LS_TOKEN_LEQUAL: // smaller or equal
-			ui16a = stack.pop2();
-			ui16b = stack.pop2();
-			if (ui16b <= ui16a)
-				stack.push2(1);
-			else
-				stack.push2(0);
-			break;
-
-		case LS_TOKEN_FAMILY: // item family
-			stack.push2(getFamily());
-			break;
-
-		case LS_TOKEN_SHAPE: // item shape
-			stack.push2(static_cast<uint16>(getShape()));
-			break;
-
-		case 'A': case 'B': case 'C': case 'D': case 'E':
-		case 'F': case 'G': case 'H': case 'I': case 'J':
-		case 'K': case 'L': case 'M': case 'N': case 'O':
-		case 'P': case 'Q': case 'R': case 'S': case 'T':
-		case 'U': case 'V': case 'W': case 'X': case 'Y': case 'Z':
-		{
-			bool match = false;
-			int count = script[i] - '@';
-			for (int j = 0; j < count; j++) {
-				//! check for i out of bounds
-				if (getShape() == static_cast<uint32>(script[i+1] + (script[i+2]<<8)))
-					match = true;
-				i += 2;
-			}
-			if (match)
-				stack.push2(1);
-			else
-				stack.push2(0);
-		}
-		break;
-
-		case LS_TOKEN_FRAME: // item frame
-			stack.push2(static_cast<uint16>(getFrame()));
-			break;
-
-		case 'a': case 'b': case 'c': case 'd': case 'e':
-		case 'f': case 'g': case 'h': case 'i': case 'j':
-		case 'k': case 'l': case 'm': case 'n': case 'o':
-		case 'p': case 'q': case 'r': case 's': case 't':
-		case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
-		{
-			bool match = false;
-			int count = script[i] - '`';
-			for (int j = 0; j < count; j++) {
-				//! check for i out of bounds
-				if (getFrame() == static_cast<uint32>(script[i+1] + (script[i+2]<<8)))
-					match = true;
-				i += 2;
-			}
-			if (match)
-				stack.push2(1);
-			else
-				stack.push2(0);
-		}
-		break;
-
-		default:
-			perr.printf("Unknown loopscript opcode %02X\n", script[i]);
-		}
-
-		i++;
-	}
-	perr.printf("Didn't encounter $ in loopscript\n");
-	return false;
+	return CompiledLoopScript::get(script, scriptsize)->check(this);
 }
 
 
@@ -1017,6 +875,26 @@ sint32 Item::collideMove(sint32 dx, sint32 dy, sint32 dz, bool teleport, bool fo
 	return 0;
 }
 
+bool Item::canMoveFreely(sint32 x, sint32 y, sint32 z)
+{
+	// contained items always teleport, see collideMove
+	if (parent) return false;
+
+	CurrentMap *map = World::get_instance()->getCurrentMap();
+
+	sint32 start[3];
+	getLocation(start[0], start[1], start[2]);
+	sint32 end[3] = { x, y, z };
+	sint32 dims[3];
+	getFootpadWorld(dims[0], dims[1], dims[2]);
+
+	std::list<CurrentMap::SweepItem> collisions;
+	map->sweepTest(start, end, dims, getShapeInfo()->flags, objid,
+				   false, &collisions);
+
+	return collisions.empty();
+}
+
 unsigned int Item::countNearby(uint32 shape, uint16 range)
 {
 	CurrentMap* currentmap = World::get_instance()->getCurrentMap();
@@ -1193,8 +1071,22 @@ void Item::destroy(bool delnow)
 		Container *p = getParentAsContainer();
 		if (p) p->removeItem(this);
 	} else if (extendedflags & EXT_INCURMAP) {
+		CurrentMap* map = World::get_instance()->getCurrentMap();
+
+		// items resting on us fall (their GravityProcess may have ended)
+		UCList uclist(2);
+		LOOPSCRIPT(script, LS_TOKEN_TRUE); // we want all items
+		map->surfaceSearch(&uclist, script, sizeof(script),
+						   this, true, false, false);
+
 		// remove self from CurrentMap
-		World::get_instance()->getCurrentMap()->removeItemFromList(this,x,y);
+		map->removeItemFromList(this,x,y);
+
+		for (uint32 i = 0; i < uclist.getSize(); i++)
+		{
+			Item *item = getItem(uclist.getuint16(i));
+			if (item) item->fall();
+		}
 	}
 		
 	if (extendedflags & Item::EXT_CAMERA)
@@ -1847,6 +1739,7 @@ bool Item::loadData(IDataSource* ids, uint32 version)
 	extendedflags = ids->read2();
 	flags = ids->read2();
 	shape = ids->read2();
+	cachedShapeInfo = getShapeInfoFromGameInstance();
 	frame = ids->read2();
 	x = ids->read2();
 	y = ids->read2();
@@ -2207,6 +2100,7 @@ uint32 Item::I_orStatus(const uint8* args, unsigned int /*argsize*/)
 	if (!item) return 0;
 
 	item->flags |= mask;
+	if (mask & FLG_FLIPPED) item->footpadChanged();
 	return 0;
 }
 
@@ -2217,6 +2111,7 @@ uint32 Item::I_andStatus(const uint8* args, unsigned int /*argsize*/)
 	if (!item) return 0;
 
 	item->flags &= mask;
+	if (!(mask & FLG_FLIPPED)) item->footpadChanged();
 	return 0;
 }
 
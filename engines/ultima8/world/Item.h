@@ -55,9 +55,10 @@ public:
 	//! in a container
 	Item* getTopItem();
 
-	//! Set item location. This strictly sets the location, and does not
-	//! even update CurrentMap
-	void setLocation(sint32 x, sint32 y, sint32 z); // this only sets the loc.
+	//! Set item location. If the item is in the CurrentMap, this only
+	//! keeps its item list entry and spatial index in sync; it does not
+	//! update the fast area or call any events.
+	void setLocation(sint32 x, sint32 y, sint32 z);
 
 	//! Move an item. This moves an item to the new location, and updates
 	//! CurrentMap and fastArea if necessary.
@@ -123,12 +124,14 @@ public:
 	inline uint16 getFlags() const { return flags; }
 
 	//! Set the flags set in the given mask.
-	void setFlag(uint32 mask) { flags |= mask; }
+	void setFlag(uint32 mask)
+		{ flags |= mask; if (mask & FLG_FLIPPED) footpadChanged(); }
 
 	virtual void setFlagRecursively(uint32 mask) { setFlag(mask); }
 
 	//! Clear the flags set in the given mask.
-	void clearFlag(uint32 mask) { flags &= ~mask; }
+	void clearFlag(uint32 mask)
+		{ flags &= ~mask; if (mask & FLG_FLIPPED) footpadChanged(); }
 
 	//! Set extendedflags
 	void setExtFlags(uint32 f) { extendedflags = f; }
@@ -147,7 +150,8 @@ public:
 
 	//! Set this Item's shape number
 	void setShape(uint32 shape_)
-		{ shape = shape_; cachedShapeInfo = 0; cachedShape = 0; }
+		{ shape = shape_; cachedShapeInfo = getShapeInfoFromGameInstance();
+		  cachedShape = 0; footpadChanged(); }
 
 	//! Get this Item's frame number
 	uint32 getFrame() const { return frame; }
@@ -177,7 +181,8 @@ public:
 	//! things depending on the family of this Item.
 	void setMapNum(uint16 mapnum_) { mapnum = mapnum_; }
 
-	//! Get the ShapeInfo object for this Item. (The pointer will be cached.)
+	//! Get the ShapeInfo object for this Item. The pointer is set whenever
+	//! the shape is, so this only reads (see Kernel's parallel phase).
 	inline ShapeInfo* getShapeInfo() const;
 
 	//! Get the ShapeInfo object for this Item from the game instance.
@@ -202,7 +207,7 @@ public:
 	//! Close this Item's gump, if any
 	void closeGump();
 
-	//! Destroy self.
+	//! Destroy self. Items resting on this Item fall.
 	virtual void destroy(bool delnow = false);
 
 	//! Check if this item overlaps another item in 3D world-space
@@ -249,6 +254,13 @@ public:
 	sint32 collideMove(sint32 x,sint32 y,sint32 z, bool teleport, bool force,
 					   ObjId* hititem=0, uint8* dirs=0);
 
+	//! Check if the object can move from its current location to (x,y,z)
+	//! without touching anything on the way. collideMove() to such a
+	//! destination is a plain move without events.
+	//! \note This only reads world state, so it is safe to call while the
+	//!       Kernel's parallel phase is running
+	bool canMoveFreely(sint32 x, sint32 y, sint32 z);
+
 	//! Make the item move up (delta>0) or down (delta<0),
 	//! including any items on top of it
 	//! \param delta distance in Z-direction to move
@@ -492,7 +504,7 @@ protected:
 	ObjId parent; // objid container this item is in (or 0 for top-level items)
 
 	mutable Shape *cachedShape;
-	mutable ShapeInfo *cachedShapeInfo;
+	ShapeInfo *cachedShapeInfo;
 
 	// This is stuff that is used for displaying and interpolation
 	struct Lerped
@@ -522,6 +534,9 @@ private:
 	//! Animate the item (called by setupLerp)
 	void animateItem();
 
+	//! Tell the CurrentMap that this item's footpad may have changed
+	void footpadChanged();
+
 public:
 	enum statusflags {
 		FLG_DISPOSABLE	 = 0x0002,	//!< Item is discarded on map change
@@ -554,8 +569,6 @@ public:
 
 inline ShapeInfo* Item::getShapeInfo() const
 {
-	if (!cachedShapeInfo)
-		cachedShapeInfo = getShapeInfoFromGameInstance();
 	return cachedShapeInfo;
 }
 
@@ -42,11 +42,19 @@ Item* ItemFactory::createItem(uint32 shape, uint32 frame, uint16 quality,
 		getShapeInfo(shape);
 	if (info == 0) return 0;
 
+	return createItemOfFamily(info->family, shape, frame, quality, flags,
+							  npcnum, mapnum, extendedflags, objid);
+}
+
+Item* ItemFactory::createItemOfFamily(uint32 family, uint32 shape,
+									  uint32 frame, uint16 quality,
+									  uint16 flags, uint16 npcnum,
+									  uint16 mapnum, uint32 extendedflags,
+									  bool objid)
+{
 	// New item, no lerping
 	extendedflags |= Item::EXT_LERP_NOPREV;
 
-	uint32 family = info->family;
-
 	switch (family) {
 	case ShapeInfo::SF_GENERIC:
 	case ShapeInfo::SF_QUALITY:
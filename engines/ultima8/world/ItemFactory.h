@@ -36,6 +36,15 @@ public:
 							uint16 flags, uint16 npcnum, uint16 mapnum,
 							uint32 extendedflags, bool objid);
 
+	//! create an item of the given ShapeInfo family, for callers that
+	//! have looked it up already (see MapGlob).
+	//! Returns 0 if there is no Item class for the family.
+	static Item* createItemOfFamily(uint32 family, uint32 shape,
+									uint32 frame, uint16 quality,
+									uint16 flags, uint16 npcnum,
+									uint16 mapnum, uint32 extendedflags,
+									bool objid);
+
 	//! create an actor.
 	//! If objid is set, assign actor an actor-objid
 	static Actor* createActor(uint32 shape, uint32 frame, uint16 quality,
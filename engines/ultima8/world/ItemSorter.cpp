@@ -27,6 +27,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "RenderSurface.h"
 #include "Rect.h"
 #include "GameData.h"
+#include "ShapeFrameCache.h"
+#include "WorkerPool.h"
+#include "profiler/Frame_profiler.h"
+
+#include <algorithm>
 
 // temp
 #include "WeaponOverlay.h"
@@ -39,7 +44,7 @@ using Pentagram::Rect;
 // This does NOT need to be in the header
 struct SortItem
 {
-	SortItem(SortItem *n) : next(n), prev(0), item_num(0), shape(0), order(-1), depends() { }
+	SortItem(SortItem *n) : next(n), prev(0), item_num(0), shape(0), order(-1), listpos(0), binmark(0), seen(0), seq(0), occluders(0), depends() { }
 
 	SortItem				*next;
 	SortItem				*prev;
@@ -104,6 +109,31 @@ struct SortItem
 
 	sint32	order;		// Rendering order. -1 is not yet drawn
 
+	uint32	listpos;	// Increases along the items list (see InsertSortItem)
+	uint32	binmark;	// Last InsertSortItem that looked at this item
+
+	int		bin_x1, bin_y1;	// Range of bins we are in (see GetBinRange)
+	int		bin_x2, bin_y2;
+
+	// Incremental mode
+	uint32	seen;		// Last frame this item was added in
+	uint32	seq;		// Breaks ties in the list order
+	uint32	occluders;	// Number of items occluding us
+
+	// A comparison with another item that had an effect on either of us
+	enum LinkType {
+		LINK_BEHIND,	// other is in our dependency list
+		LINK_FRONT,		// we are in other's dependency list
+		LINK_OCCLUDES,	// we occlude other
+		LINK_OCCLUDED	// other occludes us
+	};
+	struct Link {
+		SortItem	*other;
+		LinkType	type;
+		Link(SortItem *o, LinkType t) : other(o), type(t) { }
+	};
+	std::vector<Link> links;
+
 	// Note that std::priority_queue could be used here, BUT there is no guarentee that it's implementation
 	// will be friendly to insertions
 	// Alternatively i could use std::list, BUT there is no guarentee that it will keep wont delete
@@ -157,6 +187,23 @@ struct SortItem
 			tail = nn;
 		}
 
+		void remove(SortItem *other)
+		{
+			for (Node *n = list; n != 0; n = n->next)
+			{
+				if (n->val != other) continue;
+
+				if (n->prev) n->prev->next = n->next;
+				else list = n->next;
+				if (n->next) n->next->prev = n->prev;
+				else tail = n->prev;
+
+				n->next = unused;
+				unused = n;
+				return;
+			}
+		}
+
 		void insert_sorted(SortItem *other)
 		{
 			if (!unused) unused = new Node();
@@ -595,22 +642,26 @@ inline bool SortItem::operator<<(const SortItem& si2) const
 // ItemSorter
 //
 
+bool ItemSorter::use_incremental = false;
+bool ItemSorter::use_bins = true;
+WorkerPool* ItemSorter::paint_workers = 0;
+
 ItemSorter::ItemSorter() : 
-		shapes(0), surf(0), items(0), items_tail(0), items_unused(0), sort_limit(0)
+		shapes(0), surf(0), items(0), items_tail(0), items_unused(0), sort_limit(0),
+		bin_stamp(0), binned(true), incremental(false), inc_pending(false), frame_stamp(0),
+		inc_seq(0), dirty_all(true), dirty_surf(0), dirty_cam_sx(0),
+		dirty_cam_sy(0), reclip(false), overlay_shape(0), overlay_frame(0),
+		overlay_x(0), overlay_y(0)
 {
 	int i = 2048;
 	while (i--) items_unused = new SortItem(items_unused);
+
+	bins.resize(ITEMSORTER_BIN_GRID * ITEMSORTER_BIN_GRID);
 }
 
 ItemSorter::~ItemSorter()
 {
-	// 
-	if (items_tail) {
-		items_tail->next = items_unused;
-		items_unused = items;
-	}
-	items = 0;
-	items_tail = 0;
+	ClearDisplayList();
 
 	while (items_unused)
 	{
@@ -622,11 +673,16 @@ ItemSorter::~ItemSorter()
 	delete [] items;
 }
 
-void ItemSorter::BeginDisplayList(RenderSurface *rs,
-								  sint32 camx, sint32 camy, sint32 camz)
+void ItemSorter::ClearDisplayList()
 {
-	// Get the shapes, if required
-	if (!shapes) shapes = GameData::get_instance()->getMainShapes();
+	SortItem *it;
+	if (incremental) {
+		for (it = items; it != 0; it = it->next) {
+			it->depends.clear();
+			it->links.clear();
+			it->occluders = 0;
+		}
+	}
 
 	// 
 	if (items_tail) {
@@ -636,14 +692,68 @@ void ItemSorter::BeginDisplayList(RenderSurface *rs,
 	items = 0;
 	items_tail = 0;
 
-	// Set the RenderSurface, and reset the item list
+	// items that were added but never sorted in
+	std::vector<SortItem*>::iterator nit;
+	for (nit = inc_new.begin(); nit != inc_new.end(); ++nit) {
+		(*nit)->next = items_unused;
+		items_unused = *nit;
+	}
+	inc_new.clear();
+	inc_pending = false;
+
+	std::vector< std::vector<SortItem*> >::iterator bit;
+	for (bit = bins.begin(); bit != bins.end(); ++bit)
+		bit->clear();
+	records.clear();
+	inc_order.clear();
+	item_cache.clear();
+}
+
+void ItemSorter::BeginDisplayList(RenderSurface *rs,
+								  sint32 camx, sint32 camy, sint32 camz)
+{
+	// Get the shapes, if required (the unit tests have no GameData)
+	if (!shapes && GameData::get_instance())
+		shapes = GameData::get_instance()->getMainShapes();
+
+	// An unfinished incremental list is finished, so the next frame can
+	// start from it
+	if (inc_pending) FinishDisplayList();
+
+	// Reset the item list, unless we keep it
+	dirty_all = false;
+	if (!incremental || !use_incremental || ++frame_stamp == 0) {
+		ClearDisplayList();
+		frame_stamp = 1;
+		dirty_all = true;
+	}
+	incremental = use_incremental;
+	inc_pending = incremental;
+	binned = use_bins;
+
+	// Set the RenderSurface
 	surf = rs;
 	order_counter = 0;
+	reclip = false;
 
 	// Screenspace bounding box bottom x coord (RNB x coord)
 	cam_sx = (camx - camy)/4;
 	// Screenspace bounding box bottom extent  (RNB y coord)
 	cam_sy = (camx + camy)/8 - camz;
+
+	// Anything but items changing means a full repaint
+	Rect clip;
+	surf->GetClippingRect(clip);
+	if (surf != dirty_surf || !(clip == dirty_clip) ||
+		cam_sx != dirty_cam_sx || cam_sy != dirty_cam_sy)
+	{
+		dirty_all = true;
+	}
+	dirty_surf = surf;
+	dirty_clip = clip;
+	dirty_cam_sx = cam_sx;
+	dirty_cam_sy = cam_sy;
+	dirty.clear();
 }
 
 void ItemSorter::AddItem(sint32 x, sint32 y, sint32 z, uint32 shape_num, uint32 frame_num, uint32 flags, uint32 ext_flags, uint16 item_num)
@@ -666,15 +776,42 @@ void ItemSorter::AddItem(sint32 x, sint32 y, sint32 z, uint32 shape_num, uint32
 		return;
 	}
 
+	si->flags = flags;
+	si->ext_flags = ext_flags;
+
 	ShapeInfo *info = shapes->getShapeInfo(shape_num);
 
+	AddSortItem(si, x, y, z, info, frame->xoff, frame->yoff,
+				frame->width, frame->height);
+}
+
+void ItemSorter::AddItem(sint32 x, sint32 y, sint32 z, const ShapeInfo *info,
+						 sint32 xoff, sint32 yoff, sint32 width,
+						 sint32 height, uint32 flags, uint32 ext_flags,
+						 uint16 item_num)
+{
+	if (!items_unused) items_unused = new SortItem(0);
+	SortItem *si = items_unused;
+
+	si->item_num = item_num;
+	si->shape = 0;
+	si->shape_num = 0;
+	si->frame = 0;
+	si->flags = flags;
+	si->ext_flags = ext_flags;
+
+	AddSortItem(si, x, y, z, info, xoff, yoff, width, height);
+}
+
+void ItemSorter::AddSortItem(SortItem *si, sint32 x, sint32 y, sint32 z,
+							 const ShapeInfo *info, sint32 xoff, sint32 yoff,
+							 sint32 width, sint32 height)
+{
 	//if (info->is_editor && !show_editor_items) return;
 	//if (info->z > shape_max_height) return;
 
 	// Dimensions
 	sint32 xd, yd, zd;
-	si->flags = flags;
-	si->ext_flags = ext_flags;
 
 	// X and Y are flipped
 	if (si->flags & Item::FLG_FLIPPED) 
@@ -720,13 +857,13 @@ void ItemSorter::AddItem(sint32 x, sint32 y, sint32 z, uint32 shape_num, uint32
 //	si->sybot += sho2;
 
 	// Real Screenspace coords
-	si->sx = si->sxbot - frame->xoff;	// Left
-	si->sy = si->sybot - frame->yoff;	// Top
-	si->sx2 = si->sx + frame->width;	// Right
-	si->sy2 = si->sy + frame->height;	// Bottom
+	si->sx = si->sxbot - xoff;	// Left
+	si->sy = si->sybot - yoff;	// Top
+	si->sx2 = si->sx + width;	// Right
+	si->sy2 = si->sy + height;	// Bottom
 
 	// Do Clipping here
-	si->clipped = surf->CheckClipped(Rect (si->sx,si->sy, frame->width, frame->height));
+	si->clipped = surf->CheckClipped(Rect (si->sx,si->sy, width, height));
 	if (si->clipped < 0) return;
 
 	// These help out with sorting. We calc them now, so it will be faster
@@ -767,63 +904,8 @@ void ItemSorter::AddItem(sint32 x, sint32 y, sint32 z, uint32 shape_num, uint32
 	si->depends.clear();
 	//si->depends.erase(si->depends.begin(), si->depends.end());	// MSVC.Netism
 
-	// Iterate the list and compare shapes
-
-	// Ok, 
-	SortItem *addpoint = 0;
-	for (SortItem * si2 = items; si2 != 0; si2 = si2->next)
-	{
-		// Get the insert point... which is before the first item that has higher z than us
-		if (!addpoint && si->ListLessThan(si2)) addpoint = si2;
-
-		// Doesn't overlap
-		if (si2->occluded || !si->overlap(*si2)) continue;
-
-		// Attempt to find which is infront
-		if (*si < *si2)
-		{
-			// si2 occludes si (us)
-			if (si2->occl && si2->occludes(*si))
-			{
-				// No need to do any more checks, this isn't visible
-				si->occluded = true;
-				break;
-			}
-
-			// si1 is behind si2, so add it to si2's dependency list
-			si2->depends.insert_sorted(si);
-		}
-		else
-		{
-			// ss occludes si2. Sadly, we can't remove it from the list.
-			if (si->occl && si->occludes(*si2)) si2->occluded = true;
-			// si2 is behind si1, so add it to si1's dependency list
-			else si->depends.push_back(si2);
-		}
-	}
-
-	// Add it to the list
-	items_unused = items_unused->next;
-
-	// have a position
-	//addpoint = 0;
-	if (addpoint)
-	{
-		si->next = addpoint;
-		si->prev = addpoint->prev;
-		addpoint->prev = si;
-		if (si->prev) si->prev->next = si;
-		else items = si;
-	}
-	// Add it to the end of the list
-	else 
-	{
-		if (items_tail) items_tail->next = si;
-		if (!items) items = si;
-		si->next = 0;
-		si->prev = items_tail;
-		items_tail = si;
-	}
+	if (incremental) UpdateSortItem(si);
+	else InsertSortItem(si);
 }
 
 void ItemSorter::AddItem(Item *add)
@@ -955,9 +1037,240 @@ void ItemSorter::AddItem(Item *add)
 	si->depends.clear();
 	//si->depends.erase(si->depends.begin(), si->depends.end());	// MSVC.Netism
 
-	// Iterate the list and compare shapes
+	if (incremental) UpdateSortItem(si);
+	else InsertSortItem(si);
+#endif
+}
+
+bool ItemSorter::SortItemListLess::operator()(const SortItem* a,
+											  const SortItem* b) const
+{
+	return a->ListLessThan(b);
+}
+
+static inline bool SortItemListPosLess(const SortItem* a, const SortItem* b)
+{
+	return a->listpos < b->listpos;
+}
+
+bool ItemSorter::SortItemOrderLess::operator()(const SortItem* a,
+											   const SortItem* b) const
+{
+	if (a->ListLessThan(b)) return true;
+	if (b->ListLessThan(a)) return false;
+	return a->seq < b->seq;
+}
+
+// the bin containing screenspace coordinate v (relative to the world)
+static inline int GetBin(sint32 v)
+{
+	if (v >= 0) return v / ITEMSORTER_BIN_SIZE;
+	return -((ITEMSORTER_BIN_SIZE - 1 - v) / ITEMSORTER_BIN_SIZE);
+}
+
+static inline int GetBinIndex(int bx, int by)
+{
+	return (by & (ITEMSORTER_BIN_GRID-1)) * ITEMSORTER_BIN_GRID +
+		(bx & (ITEMSORTER_BIN_GRID-1));
+}
+
+void ItemSorter::GetBinRange(SortItem* si) const
+{
+	// the bounding box of the screenspace outline. Outlines can only
+	// overlap if these do (see SortItem::overlap). It is taken relative
+	// to the world so it doesn't change when the camera moves.
+	si->bin_x1 = GetBin(si->sxleft + cam_sx);
+	si->bin_x2 = GetBin(si->sxright + cam_sx);
+	si->bin_y1 = GetBin(si->sytop + cam_sy);
+	si->bin_y2 = GetBin(si->sybot + cam_sy);
+
+	// the grid wraps around, so every bin only has to be visited once
+	if (si->bin_x2 - si->bin_x1 >= ITEMSORTER_BIN_GRID)
+		si->bin_x2 = si->bin_x1 + ITEMSORTER_BIN_GRID - 1;
+	if (si->bin_y2 - si->bin_y1 >= ITEMSORTER_BIN_GRID)
+		si->bin_y2 = si->bin_y1 + ITEMSORTER_BIN_GRID - 1;
+}
+
+void ItemSorter::AddToBins(SortItem* si)
+{
+	for (int by = si->bin_y1; by <= si->bin_y2; by++)
+		for (int bx = si->bin_x1; bx <= si->bin_x2; bx++)
+			bins[GetBinIndex(bx, by)].push_back(si);
+}
+
+void ItemSorter::RemoveFromBins(SortItem* si)
+{
+	for (int by = si->bin_y1; by <= si->bin_y2; by++) {
+		for (int bx = si->bin_x1; bx <= si->bin_x2; bx++) {
+			std::vector<SortItem*>& bin = bins[GetBinIndex(bx, by)];
+			std::vector<SortItem*>::iterator bit;
+			bit = std::find(bin.begin(), bin.end(), si);
+			if (bit == bin.end()) continue;
+			*bit = bin.back();
+			bin.pop_back();
+		}
+	}
+}
+
+void ItemSorter::RelabelItems()
+{
+	unsigned int count = 0;
+	SortItem *it;
+	for (it = items; it != 0; it = it->next) count++;
+
+	uint32 gap = ITEMSORTER_LISTPOS_GAP;
+	if (count + 2 > 0xFFFFFFFFU / gap) gap = 0xFFFFFFFFU / (count + 2);
 
-	// Ok, 
+	uint32 pos = gap;
+	for (it = items; it != 0; it = it->next, pos += gap)
+		it->listpos = pos;
+}
+
+void ItemSorter::InsertSortItem(SortItem *si)
+{
+	if (!binned) {
+		InsertSortItemAllPairs(si);
+		return;
+	}
+
+	// Only the items sharing a bin with us can overlap us. Comparing with
+	// just those has to give exactly the same result as walking the whole
+	// list, so the comparisons (which only read) are done first, and the
+	// changes are then made as if the candidates were visited in list
+	// order: nothing after an item that occludes us, and our dependencies
+	// in list order.
+	GetBinRange(si);
+
+	if (++bin_stamp == 0) {
+		// wrapped around: forget all marks
+		for (SortItem *it = items; it != 0; it = it->next) it->binmark = 0;
+		bin_stamp = 1;
+	}
+
+	SortItem *stop = 0;
+	bin_inserts.clear();
+	bin_occluded.clear();
+	bin_depends.clear();
+
+	int bx, by;
+	for (by = si->bin_y1; by <= si->bin_y2; by++) {
+		for (bx = si->bin_x1; bx <= si->bin_x2; bx++) {
+			std::vector<SortItem*>& bin = bins[GetBinIndex(bx, by)];
+			std::vector<SortItem*>::iterator bit;
+			for (bit = bin.begin(); bit != bin.end(); ++bit)
+			{
+				SortItem *si2 = *bit;
+				if (si2->binmark == bin_stamp) continue;
+				si2->binmark = bin_stamp;
+
+				// Doesn't overlap
+				if (si2->occluded || !si->overlap(*si2)) continue;
+
+				// Attempt to find which is infront
+				if (*si < *si2)
+				{
+					// si2 occludes si (us)
+					if (si2->occl && si2->occludes(*si))
+					{
+						// No need to do any more checks, this isn't visible
+						if (!stop || si2->listpos < stop->listpos) stop = si2;
+					}
+					// si1 is behind si2, so add it to si2's dependency list
+					else bin_inserts.push_back(si2);
+				}
+				else
+				{
+					// ss occludes si2. Sadly, we can't remove it from the list.
+					if (si->occl && si->occludes(*si2))
+						bin_occluded.push_back(si2);
+					// si2 is behind si1, so add it to si1's dependency list
+					else bin_depends.push_back(si2);
+				}
+			}
+		}
+	}
+
+	const uint32 stoppos = stop ? stop->listpos : 0xFFFFFFFFU;
+	if (stop) si->occluded = true;
+
+	std::vector<SortItem*>::iterator it;
+	for (it = bin_inserts.begin(); it != bin_inserts.end(); ++it)
+		if ((*it)->listpos < stoppos) (*it)->depends.insert_sorted(si);
+	for (it = bin_occluded.begin(); it != bin_occluded.end(); ++it)
+		if ((*it)->listpos < stoppos) (*it)->occluded = true;
+
+	std::sort(bin_depends.begin(), bin_depends.end(), SortItemListPosLess);
+	for (it = bin_depends.begin(); it != bin_depends.end(); ++it) {
+		if ((*it)->listpos >= stoppos) break;
+		si->depends.push_back(*it);
+	}
+
+	// Get the insert point... which is before the first item in the list
+	// that has higher z than us. That item has a higher z than all items
+	// before it, which makes it one of the 'records'. If we are occluded
+	// only the items up to the one occluding us count, and we go at the
+	// end of the list otherwise.
+	SortItem *addpoint = 0;
+	RecordSet::iterator rec = records.upper_bound(si);
+	if (rec != records.end() && (!stop || (*rec)->listpos <= stop->listpos))
+		addpoint = *rec;
+
+	// Will we be a record ourselves?
+	bool record;
+	if (addpoint) {
+		record = (rec == records.begin());
+		if (!record) {
+			--rec;
+			record = (*rec)->ListLessThan(si);
+		}
+	} else {
+		record = records.empty() || (*records.rbegin())->ListLessThan(si);
+	}
+	if (record) records.insert(si);
+
+	// Add it to the list
+	items_unused = items_unused->next;
+
+	// have a position
+	//addpoint = 0;
+	if (addpoint)
+	{
+		si->next = addpoint;
+		si->prev = addpoint->prev;
+		addpoint->prev = si;
+		if (si->prev) si->prev->next = si;
+		else items = si;
+
+		uint32 before = si->prev ? si->prev->listpos : 0;
+		if (addpoint->listpos - before < 2)
+			RelabelItems();
+		else
+			si->listpos = before + (addpoint->listpos - before) / 2;
+	}
+	// Add it to the end of the list
+	else 
+	{
+		if (items_tail) items_tail->next = si;
+		if (!items) items = si;
+		si->next = 0;
+		si->prev = items_tail;
+		items_tail = si;
+
+		uint32 before = si->prev ? si->prev->listpos : 0;
+		if (before > 0xFFFFFFFFU - ITEMSORTER_LISTPOS_GAP)
+			RelabelItems();
+		else
+			si->listpos = before + ITEMSORTER_LISTPOS_GAP;
+	}
+
+	// An occluded item is skipped by all later comparisons
+	si->binmark = 0;
+	if (!si->occluded) AddToBins(si);
+}
+
+void ItemSorter::InsertSortItemAllPairs(SortItem *si)
+{
+	// Iterate the list and compare shapes
 	SortItem *addpoint = 0;
 	for (SortItem * si2 = items; si2 != 0; si2 = si2->next)
 	{
@@ -970,7 +1283,7 @@ void ItemSorter::AddItem(Item *add)
 		// Attempt to find which is infront
 		if (*si < *si2)
 		{
-			// si2 occludes ss
+			// si2 occludes si (us)
 			if (si2->occl && si2->occludes(*si))
 			{
 				// No need to do any more checks, this isn't visible
@@ -993,8 +1306,6 @@ void ItemSorter::AddItem(Item *add)
 	// Add it to the list
 	items_unused = items_unused->next;
 
-	// have a position
-	//addpoint = 0;
 	if (addpoint)
 	{
 		si->next = addpoint;
@@ -1012,18 +1323,346 @@ void ItemSorter::AddItem(Item *add)
 		si->prev = items_tail;
 		items_tail = si;
 	}
-#endif
+}
+
+void ItemSorter::UpdateSortItem(SortItem *si)
+{
+	SortItem *old = 0;
+	if (si->item_num < item_cache.size()) old = item_cache[si->item_num];
+
+	if (old && old->seen != frame_stamp &&
+		old->shape_num == si->shape_num && old->frame == si->frame &&
+		old->flags == si->flags && old->ext_flags == si->ext_flags &&
+		old->x == si->x && old->y == si->y && old->z == si->z)
+	{
+		// Unchanged. Only the camera may have moved, which moves everything
+		// on screen by the same amount and so doesn't change the sorting.
+		old->sx = si->sx; old->sx2 = si->sx2;
+		old->sy = si->sy; old->sy2 = si->sy2;
+		old->sxleft = si->sxleft; old->sxright = si->sxright;
+		old->sxtop = si->sxtop; old->sytop = si->sytop;
+		old->sxbot = si->sxbot; old->sybot = si->sybot;
+		old->clipped = si->clipped;
+		old->seen = frame_stamp;
+		return;
+	}
+
+	// A new SortItem. Any old one is dropped by FinishDisplayList
+	items_unused = items_unused->next;
+	si->seen = frame_stamp;
+	inc_new.push_back(si);
+}
+
+void ItemSorter::FinishDisplayList()
+{
+	inc_pending = false;
+
+	// Drop the items that weren't added this time. Their screen coords are
+	// still those of the previous frame, which is where they have to be
+	// painted over.
+	SortItem *it = items;
+	while (it != 0) {
+		SortItem *next = it->next;
+		if (it->seen != frame_stamp) {
+			AddDirtyRect(Rect(it->sx, it->sy, it->sx2-it->sx, it->sy2-it->sy));
+			UnlinkSortItem(it);
+		}
+		it = next;
+	}
+
+	std::vector<SortItem*>::iterator nit;
+	for (nit = inc_new.begin(); nit != inc_new.end(); ++nit) {
+		SortItem *si = *nit;
+		LinkSortItem(si);
+		AddDirtyRect(Rect(si->sx, si->sy, si->sx2-si->sx, si->sy2-si->sy));
+	}
+	inc_new.clear();
+
+	// The weapon overlay can change without the avatar changing
+	Rect old_overlay = overlay_rect;
+	overlay_rect.Set(0,0,0,0);
+	if (item_cache.size() > 1 && item_cache[1])
+		GetWeaponOverlayRect(item_cache[1], overlay_rect);
+	if (!(overlay_rect == old_overlay)) {
+		AddDirtyRect(old_overlay);
+		AddDirtyRect(overlay_rect);
+	}
+
+	for (it = items; it != 0; it = it->next) {
+		it->occluded = it->occluders != 0;
+		it->order = -1;
+	}
+}
+
+void ItemSorter::LinkSortItem(SortItem *si)
+{
+	// Unlike InsertSortItem all overlapping items are compared, including
+	// the occluded ones, since what occludes them may go away later.
+	// Every comparison that has an effect is remembered in the links of
+	// both items, so it can be undone when either of them is removed.
+	GetBinRange(si);
+
+	if (++bin_stamp == 0) {
+		// wrapped around: forget all marks
+		for (SortItem *it = items; it != 0; it = it->next) it->binmark = 0;
+		bin_stamp = 1;
+	}
+
+	si->occluders = 0;
+	si->links.clear();
+
+	for (int by = si->bin_y1; by <= si->bin_y2; by++) {
+		for (int bx = si->bin_x1; bx <= si->bin_x2; bx++) {
+			std::vector<SortItem*>& bin = bins[GetBinIndex(bx, by)];
+			std::vector<SortItem*>::iterator bit;
+			for (bit = bin.begin(); bit != bin.end(); ++bit)
+			{
+				SortItem *si2 = *bit;
+				if (si2->binmark == bin_stamp) continue;
+				si2->binmark = bin_stamp;
+
+				// Doesn't overlap
+				if (!si->overlap(*si2)) continue;
+
+				// Attempt to find which is infront
+				if (*si < *si2)
+				{
+					if (si2->occl && si2->occludes(*si))
+					{
+						si->occluders++;
+						si->links.push_back(SortItem::Link(si2, SortItem::LINK_OCCLUDED));
+						si2->links.push_back(SortItem::Link(si, SortItem::LINK_OCCLUDES));
+					}
+					else
+					{
+						si2->depends.insert_sorted(si);
+						si->links.push_back(SortItem::Link(si2, SortItem::LINK_FRONT));
+						si2->links.push_back(SortItem::Link(si, SortItem::LINK_BEHIND));
+					}
+				}
+				else
+				{
+					if (si->occl && si->occludes(*si2))
+					{
+						si2->occluders++;
+						si->links.push_back(SortItem::Link(si2, SortItem::LINK_OCCLUDES));
+						si2->links.push_back(SortItem::Link(si, SortItem::LINK_OCCLUDED));
+					}
+					else
+					{
+						si->depends.insert_sorted(si2);
+						si->links.push_back(SortItem::Link(si2, SortItem::LINK_BEHIND));
+						si2->links.push_back(SortItem::Link(si, SortItem::LINK_FRONT));
+					}
+				}
+			}
+		}
+	}
+
+	si->binmark = 0;
+	AddToBins(si);
+
+	// Add it to the list, before the first item that is greater
+	si->seq = ++inc_seq;
+	OrderSet::iterator oit = inc_order.insert(si).first;
+	++oit;
+	if (oit != inc_order.end())
+	{
+		SortItem *addpoint = *oit;
+		si->next = addpoint;
+		si->prev = addpoint->prev;
+		addpoint->prev = si;
+		if (si->prev) si->prev->next = si;
+		else items = si;
+	}
+	else
+	{
+		if (items_tail) items_tail->next = si;
+		if (!items) items = si;
+		si->next = 0;
+		si->prev = items_tail;
+		items_tail = si;
+	}
+
+	if (si->item_num) {
+		if (si->item_num >= item_cache.size())
+			item_cache.resize(si->item_num + 1, 0);
+		if (!item_cache[si->item_num]) item_cache[si->item_num] = si;
+	}
+}
+
+void ItemSorter::UnlinkSortItem(SortItem *si)
+{
+	// Undo our comparisons with the other items
+	std::vector<SortItem::Link>::iterator lit;
+	for (lit = si->links.begin(); lit != si->links.end(); ++lit)
+	{
+		SortItem *si2 = lit->other;
+
+		std::vector<SortItem::Link>::iterator oit;
+		for (oit = si2->links.begin(); oit != si2->links.end(); ++oit) {
+			if (oit->other == si) {
+				*oit = si2->links.back();
+				si2->links.pop_back();
+				break;
+			}
+		}
+
+		if (lit->type == SortItem::LINK_FRONT)
+			si2->depends.remove(si);
+		else if (lit->type == SortItem::LINK_OCCLUDES)
+			si2->occluders--;
+	}
+	si->links.clear();
+	si->depends.clear();
+	si->occluders = 0;
+
+	RemoveFromBins(si);
+	inc_order.erase(si);
+
+	if (si->prev) si->prev->next = si->next;
+	else items = si->next;
+	if (si->next) si->next->prev = si->prev;
+	else items_tail = si->prev;
+
+	if (si->item_num < item_cache.size() && item_cache[si->item_num] == si)
+		item_cache[si->item_num] = 0;
+
+	si->next = items_unused;
+	si->prev = 0;
+	items_unused = si;
+}
+
+void ItemSorter::AddDirtyRect(const Rect &r)
+{
+	if (dirty_all || !r.IsValid()) return;
+	dirty.push_back(r);
+}
+
+bool ItemSorter::GetWeaponOverlay(SortItem *si, Shape *&shape,
+								  uint32 &frame, sint32 &x, sint32 &y) const
+{
+	// FIXME: use highlight/invisibility, also add to Trace() ?
+	if (si->shape_num != 1 || si->item_num != 1) return false;
+
+	MainActor* av = getMainActor();
+	if (!av) return false;
+
+	const WeaponOverlayFrame* wo_frame = 0;
+	uint32 wo_shapenum;
+	av->getWeaponOverlay(wo_frame, wo_shapenum);
+	if (!wo_frame) return false;
+
+	shape = shapes->getShape(wo_shapenum);
+	if (!shape) return false;
+
+	frame = wo_frame->frame;
+	x = wo_frame->xoff;
+	y = wo_frame->yoff;
+	return true;
+}
+
+bool ItemSorter::GetWeaponOverlayRect(SortItem *si, Rect &r) const
+{
+	Shape *wo_shape;
+	uint32 wo_frame;
+	sint32 wo_x, wo_y;
+	if (!GetWeaponOverlay(si, wo_shape, wo_frame, wo_x, wo_y)) return false;
+
+	ShapeFrame* frame = wo_shape->getFrame(wo_frame);
+	if (!frame) return false;
+
+	r.Set(si->sxbot + wo_x - frame->xoff, si->sybot + wo_y - frame->yoff,
+		  frame->width, frame->height);
+	return true;
+}
+
+// Grow a to contain b. (Rect::Union gets y wrong)
+static inline void UniteRects(Rect &a, const Rect &b)
+{
+	sint32 x2 = a.x + a.w, y2 = a.y + a.h;
+	if (b.x < a.x) a.x = b.x;
+	if (b.y < a.y) a.y = b.y;
+	if (b.x + b.w > x2) x2 = b.x + b.w;
+	if (b.y + b.h > y2) y2 = b.y + b.h;
+	a.w = x2 - a.x;
+	a.h = y2 - a.y;
+}
+
+bool ItemSorter::GetDirtyRects(std::vector<Rect>& rects)
+{
+	if (inc_pending) FinishDisplayList();
+
+	rects.clear();
+	if (!incremental || dirty_all || sort_limit) return false;
+
+	// Clip to the surface, and merge the rects that overlap
+	std::vector<Rect>::iterator it;
+	for (it = dirty.begin(); it != dirty.end(); ++it)
+	{
+		Rect r = *it;
+		r.Intersect(dirty_clip);
+		if (!r.IsValid()) continue;
+
+		unsigned int i = 0;
+		while (i < rects.size()) {
+			if (rects[i].Overlaps(r)) {
+				// the grown rect may overlap ones checked before
+				UniteRects(r, rects[i]);
+				rects[i] = rects.back();
+				rects.pop_back();
+				i = 0;
+			} else {
+				i++;
+			}
+		}
+		rects.push_back(r);
+	}
+
+	// A full repaint is cheaper than many or large rects
+	sint32 area = 0;
+	for (it = rects.begin(); it != rects.end(); ++it)
+		area += it->w * it->h;
+
+	if (rects.size() > ITEMSORTER_MAX_DIRTY ||
+		area > dirty_clip.w * dirty_clip.h / 2)
+	{
+		rects.clear();
+		return false;
+	}
+
+	return true;
 }
 
 SortItem *prev = 0;
 
-void ItemSorter::PaintDisplayList(bool item_highlight)
+void ItemSorter::PaintDisplayList(bool item_highlight, bool reclip_items)
 {
+	PROFILE_ZONE("ItemSorter::PaintDisplayList");
+	if (inc_pending) FinishDisplayList();
+
 	prev = 0;
 	SortItem *it = items;
 	SortItem *end = 0;
+
+	// Painted before: start over
+	if (order_counter) {
+		for (; it != end; it = it->next) it->order = -1;
+		it = items;
+	}
+	reclip = reclip_items;
+
+	// Look up the weapon overlay now, not while painting
+	overlay_shape = 0;
+	for (; it != end; it = it->next) {
+		if (GetWeaponOverlay(it, overlay_shape, overlay_frame,
+							 overlay_x, overlay_y))
+			break;
+	}
+	it = items;
+
 	order_counter = 0;	// Reset the order_counter
-	while (it != end)
+	if (!PaintBands()) while (it != end)
 	{
 		if (it->order == -1) if (PaintSortItem(it)) return;
 		it = it->next;
@@ -1077,40 +1716,11 @@ bool ItemSorter::PaintSortItem(SortItem	*si)
 	order_counter++;
 
 	// Now paint us!
+	sint16 clipped = si->clipped;
+	if (reclip)
+		clipped = surf->CheckClipped(Rect(si->sx, si->sy, si->sx2 - si->sx, si->sy2 - si->sy));
 
-//	if (wire) si->info->draw_box_back(s, dispx, dispy, 255);
-
-	if (si->ext_flags & Item::EXT_HIGHLIGHT && si->ext_flags & Item::EXT_TRANSPARENT)
-		surf->PaintHighlightInvis(si->shape, si->frame, si->sxbot, si->sybot, si->trans, (si->flags&Item::FLG_FLIPPED)!=0, 0x7F00007F);
-	if (si->ext_flags & Item::EXT_HIGHLIGHT)
-		surf->PaintHighlight(si->shape, si->frame, si->sxbot, si->sybot, si->trans, (si->flags&Item::FLG_FLIPPED)!=0, 0x7F00007F);
-	else if (si->ext_flags & Item::EXT_TRANSPARENT)
-		surf->PaintInvisible(si->shape, si->frame, si->sxbot, si->sybot, si->trans, (si->flags&Item::FLG_FLIPPED)!=0);
-	else if (si->flags & Item::FLG_FLIPPED)
-		surf->PaintMirrored(si->shape, si->frame, si->sxbot, si->sybot, si->trans);
-	else if (si->trans)
-		surf->PaintTranslucent(si->shape, si->frame, si->sxbot, si->sybot);
-	else if (!si->clipped)
-		surf->PaintNoClip(si->shape, si->frame, si->sxbot, si->sybot);
-	else
-		surf->Paint(si->shape, si->frame, si->sxbot, si->sybot);
-		
-//	if (wire) si->info->draw_box_front(s, dispx, dispy, 255);
-
-	// weapon overlay
-	// FIXME: use highlight/invisibility, also add to Trace() ?
-	if (si->shape_num == 1 && si->item_num == 1) {
-		MainActor* av = getMainActor();
-		const WeaponOverlayFrame* wo_frame = 0;
-		uint32 wo_shapenum;
-		av->getWeaponOverlay(wo_frame, wo_shapenum);
-		if (wo_frame) {
-			Shape* wo_shape = GameData::get_instance()->getMainShapes()->getShape(wo_shapenum);
-			surf->Paint(wo_shape, wo_frame->frame,
-						si->sxbot + wo_frame->xoff,
-						si->sybot + wo_frame->yoff);
-		}
-	}
+	DrawSortItem(surf, si, clipped);
 
 	if (sort_limit) {
 		if (order_counter == sort_limit) {
@@ -1133,6 +1743,128 @@ bool ItemSorter::PaintSortItem(SortItem	*si)
 	return false;
 }
 
+void ItemSorter::DrawSortItem(RenderSurface *rs, SortItem *si, sint16 clipped)
+{
+//	if (wire) si->info->draw_box_back(s, dispx, dispy, 255);
+
+	if (clipped < 0)
+		;	// outside the part of the surface being painted
+	else if (si->ext_flags & Item::EXT_HIGHLIGHT)
+	{
+		if (si->ext_flags & Item::EXT_TRANSPARENT)
+			rs->PaintHighlightInvis(si->shape, si->frame, si->sxbot, si->sybot, si->trans, (si->flags&Item::FLG_FLIPPED)!=0, 0x7F00007F);
+		rs->PaintHighlight(si->shape, si->frame, si->sxbot, si->sybot, si->trans, (si->flags&Item::FLG_FLIPPED)!=0, 0x7F00007F);
+	}
+	else if (si->ext_flags & Item::EXT_TRANSPARENT)
+		rs->PaintInvisible(si->shape, si->frame, si->sxbot, si->sybot, si->trans, (si->flags&Item::FLG_FLIPPED)!=0);
+	else if (si->flags & Item::FLG_FLIPPED)
+		rs->PaintMirrored(si->shape, si->frame, si->sxbot, si->sybot, si->trans);
+	else if (si->trans)
+		rs->PaintTranslucent(si->shape, si->frame, si->sxbot, si->sybot);
+	else if (!clipped)
+		rs->PaintNoClip(si->shape, si->frame, si->sxbot, si->sybot);
+	else
+		rs->Paint(si->shape, si->frame, si->sxbot, si->sybot);
+		
+//	if (wire) si->info->draw_box_front(s, dispx, dispy, 255);
+
+	// weapon overlay (it can reach outside the avatar's frame)
+	if (overlay_shape && si->shape_num == 1 && si->item_num == 1) {
+		rs->Paint(overlay_shape, overlay_frame,
+				  si->sxbot + overlay_x, si->sybot + overlay_y);
+	}
+}
+
+void ItemSorter::SetPaintThreads(unsigned int threads)
+{
+	if (threads == GetPaintThreads()) return;
+
+	delete paint_workers;
+	paint_workers = 0;
+
+	// the calling thread paints a band as well
+	if (threads > 1)
+		paint_workers = new WorkerPool(threads - 1);
+}
+
+unsigned int ItemSorter::GetPaintThreads()
+{
+	return paint_workers ? paint_workers->getThreadCount() + 1 : 1;
+}
+
+bool ItemSorter::PaintBands()
+{
+	if (!paint_workers || sort_limit) return false;
+
+	Rect clip;
+	surf->GetClippingRect(clip);
+
+	int bands = static_cast<int>(paint_workers->getThreadCount()) + 1;
+	if (bands > clip.h / ITEMSORTER_MIN_BAND)
+		bands = clip.h / ITEMSORTER_MIN_BAND;
+	if (bands < 2) return false;
+
+	// Work out the painting order
+	SortItem *it;
+	for (it = items; it != 0; it = it->next)
+		if (it->order == -1) NullPaintSortItem(it);
+
+	paint_list.assign(order_counter, 0);
+	for (it = items; it != 0; it = it->next)
+		if (it->order >= 0) paint_list[it->order] = it;
+
+	// The frame cache can't change while the threads use it, so everything
+	// has to be decoded beforehand
+	std::vector<SortItem*>::iterator pit;
+	for (pit = paint_list.begin(); pit != paint_list.end(); ++pit)
+	{
+		SortItem *si = *pit;
+		ShapeFrame *frame = si->shape->getFrame(si->frame);
+		if (frame && si->shape->getPalette())
+			ShapeFrameCache::get(frame, si->shape->getPalette(), false);
+	}
+	if (overlay_shape && overlay_shape->getPalette()) {
+		ShapeFrame *frame = overlay_shape->getFrame(overlay_frame);
+		if (frame)
+			ShapeFrameCache::get(frame, overlay_shape->getPalette(), false);
+	}
+
+	for (int i = 0; i < bands; i++)
+	{
+		sint32 y1 = clip.y + clip.h * i / bands;
+		sint32 y2 = clip.y + clip.h * (i+1) / bands;
+
+		RenderSurface *rs = surf->CreateView();
+		rs->SetClippingRect(Rect(clip.x, y1, clip.w, y2 - y1));
+		band_surfs.push_back(rs);
+	}
+
+	ShapeFrameCache::setFrozen(true);
+	paint_workers->run(PaintBand_Static, this, bands);
+	ShapeFrameCache::setFrozen(false);
+
+	std::vector<RenderSurface*>::iterator bit;
+	for (bit = band_surfs.begin(); bit != band_surfs.end(); ++bit)
+		delete *bit;
+	band_surfs.clear();
+
+	return true;
+}
+
+void ItemSorter::PaintBand_Static(void *data, unsigned int index)
+{
+	ItemSorter *sorter = static_cast<ItemSorter*>(data);
+	RenderSurface *rs = sorter->band_surfs[index];
+
+	std::vector<SortItem*>::iterator it;
+	for (it = sorter->paint_list.begin(); it != sorter->paint_list.end(); ++it)
+	{
+		SortItem *si = *it;
+		sint16 clipped = rs->CheckClipped(Rect(si->sx, si->sy, si->sx2 - si->sx, si->sy2 - si->sy));
+		sorter->DrawSortItem(rs, si, clipped);
+	}
+}
+
 bool ItemSorter::NullPaintSortItem(SortItem	*si)
 {
 	// Don't paint this, or dependencies if occluded
@@ -1162,11 +1894,53 @@ bool ItemSorter::NullPaintSortItem(SortItem	*si)
 	return false;
 }
 
+void ItemSorter::GetSortOrder(std::vector<uint16> &list,
+							  std::vector< std::vector<uint16> > &depends,
+							  std::vector<uint16> &paint)
+{
+	SortItem *it;
+
+	if (inc_pending) FinishDisplayList();
+
+	if (!order_counter)	// If no order_counter we need to sort the items
+	{
+		for (it = items; it != 0; it = it->next)
+			if (it->order == -1) if (NullPaintSortItem(it)) break;
+	}
+
+	list.clear();
+	depends.clear();
+	std::vector<SortItem*> ordered;
+	for (it = items; it != 0; it = it->next)
+	{
+		list.push_back(it->item_num);
+		depends.push_back(std::vector<uint16>());
+
+		SortItem::DependsList::iterator dit = it->depends.begin();
+		SortItem::DependsList::iterator dend = it->depends.end();
+		for (; dit != dend; ++dit)
+			depends.back().push_back((*dit)->item_num);
+
+		if (it->order >= 0) {
+			if (ordered.size() <= static_cast<unsigned int>(it->order))
+				ordered.resize(it->order + 1);
+			ordered[it->order] = it;
+		}
+	}
+
+	paint.clear();
+	std::vector<SortItem*>::iterator oit;
+	for (oit = ordered.begin(); oit != ordered.end(); ++oit)
+		if (*oit) paint.push_back((*oit)->item_num);
+}
+
 uint16 ItemSorter::Trace(sint32 x, sint32 y, HitFace* face, bool item_highlight)
 {
 	SortItem *it;
 	SortItem *selected;
 
+	if (inc_pending) FinishDisplayList();
+
 	if (!order_counter)	// If no order_counter we need to sort the items
 	{
 		it = items;
@@ -19,9 +19,33 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef ITEMSORTER_H
 #define ITEMSORTER_H
 
+#include <vector>
+#include <set>
+#include "Rect.h"
+
+//! size (in pixels) of the screen tiles SortItems are binned into
+#define ITEMSORTER_BIN_SIZE		64
+
+//! number of bins along each side of the bin grid. The grid wraps around,
+//! so this has to be a power of two.
+#define ITEMSORTER_BIN_GRID		64
+
+//! spacing of SortItem::listpos values for items appended to the list
+#define ITEMSORTER_LISTPOS_GAP	0x10000
+
+//! more dirty rectangles than this are repainted as one full repaint
+#define ITEMSORTER_MAX_DIRTY	16
+
+//! surfaces are split into bands of at least this many lines to paint them
+//! on several threads
+#define ITEMSORTER_MIN_BAND		32
+
 class MainShapeArchive;
 class Item;
 class RenderSurface;
+class Shape;
+class ShapeInfo;
+class WorkerPool;
 struct SortItem;
 
 class ItemSorter
@@ -38,6 +62,86 @@ class ItemSorter
 
 	sint32		cam_sx, cam_sy;
 
+	//! Screen tiles of ITEMSORTER_BIN_SIZE pixels holding the items whose
+	//! outline touches them. Only items sharing a tile can overlap.
+	//! The tiles are fixed relative to the world (not the camera) and
+	//! wrap around every ITEMSORTER_BIN_GRID tiles.
+	std::vector< std::vector<SortItem*> > bins;
+	uint32		bin_stamp;		//!< incremented for every item inserted
+
+	static bool	use_bins;			//!< binning for the next display list
+	bool		binned;				//!< binning of the current display list
+
+	//! what InsertSortItem found, to be applied in list order
+	std::vector<SortItem*> bin_inserts, bin_occluded, bin_depends;
+
+	struct SortItemListLess {
+		bool operator()(const SortItem* a, const SortItem* b) const;
+	};
+	typedef std::set<SortItem*, SortItemListLess> RecordSet;
+
+	//! The items that are greater (see SortItem::ListLessThan) than all
+	//! items before them in the list. They are in list order.
+	RecordSet	records;
+
+	//
+	// Incremental mode. The SortItems are kept from frame to frame, keyed
+	// by item_num. An item added with the same shape, frame, flags and
+	// world position as in the previous frame keeps its SortItem and its
+	// dependencies; only new, changed and removed items are resorted.
+	//
+
+	static bool	use_incremental;	//!< mode for the next display list
+	bool		incremental;		//!< mode of the current display list
+	bool		inc_pending;		//!< FinishDisplayList still has to run
+	uint32		frame_stamp;		//!< incremented for every display list
+	uint32		inc_seq;
+
+	//! the items of the list indexed by item_num
+	std::vector<SortItem*> item_cache;
+
+	//! items added in this frame that have to be sorted in
+	std::vector<SortItem*> inc_new;
+
+	struct SortItemOrderLess {
+		bool operator()(const SortItem* a, const SortItem* b) const;
+	};
+	typedef std::set<SortItem*, SortItemOrderLess> OrderSet;
+
+	//! all items, in list order
+	OrderSet	inc_order;
+
+	//
+	// Dirty rectangles (incremental mode only). The areas of the surface
+	// where items were added, removed or changed since the previous
+	// display list. Everything is dirty if the camera, the surface or its
+	// clipping rect changed.
+	//
+
+	bool		dirty_all;
+	std::vector<Pentagram::Rect> dirty;
+	RenderSurface *dirty_surf;			//!< surface of the previous list
+	Pentagram::Rect dirty_clip;			//!< its clipping rect
+	sint32		dirty_cam_sx, dirty_cam_sy;	//!< camera of the previous list
+	Pentagram::Rect overlay_rect;		//!< the avatar's weapon overlay
+
+	bool		reclip;		//!< PaintSortItem checks the clipping rect again
+
+	//
+	// Painting on several threads. The painting order is worked out first,
+	// then each thread paints all items in its band of the surface in that
+	// order.
+	//
+
+	static WorkerPool *paint_workers;
+	std::vector<SortItem*> paint_list;		//!< the items in painting order
+	std::vector<RenderSurface*> band_surfs;	//!< views of surf, one per band
+
+	//! the avatar's weapon overlay in this frame
+	Shape		*overlay_shape;
+	uint32		overlay_frame;
+	sint32		overlay_x, overlay_y;	//!< relative to the avatar's sxbot,sybot
+
 public:
 	ItemSorter();
 	~ItemSorter();
@@ -53,18 +157,97 @@ public:
 	void AddItem(sint32 x, sint32 y, sint32 z, uint32 shape_num, uint32 frame_num, uint32 item_flags, uint32 ext_flags, uint16 item_num=0);
 	void AddItem(Item *);					// Add an Item. SetupLerp() MUST have been called
 
-	void PaintDisplayList(bool item_highlight=false);				// Finishes the display list and Paints
+	//! Add an item without a shape: its dimensions and flags come from
+	//! info, and its frame is width x height pixels with its origin at
+	//! (xoff,yoff), as in ShapeFrame. The display list can then only be
+	//! sorted (see GetSortOrder), not painted or traced.
+	void AddItem(sint32 x, sint32 y, sint32 z, const ShapeInfo *info,
+				 sint32 xoff, sint32 yoff, sint32 width, sint32 height,
+				 uint32 item_flags, uint32 ext_flags, uint16 item_num);
+
+	// Finishes the display list and Paints.
+	// reclip_items: the clipping rect of the surface was changed since the
+	// items were added, to paint part of the list. The list can be painted
+	// more than once.
+	void PaintDisplayList(bool item_highlight=false, bool reclip_items=false);
+
+	//! Get the areas of the surface that have to be repainted since the
+	//! previous display list was painted. Finishes the display list.
+	//! \return false if everything has to be repainted (always the case
+	//!         when not in incremental mode)
+	bool GetDirtyRects(std::vector<Pentagram::Rect>& rects);
 
 	// Trace and find an object. Returns objid.
 	// If face is non-NULL, also return the face of the 3d bbox (x,y) is on
 	uint16 Trace(sint32 x, sint32 y, HitFace* face = 0, bool item_highlight=false );
 
+	//! Get how the display list was sorted, by item_num: the items in list
+	//! order, the items each of them depends on (in the same order), and
+	//! the items in painting order. Occluded items aren't painted.
+	void GetSortOrder(std::vector<uint16> &list,
+					  std::vector< std::vector<uint16> > &depends,
+					  std::vector<uint16> &paint);
+
 	void IncSortLimit() { sort_limit++; }
 	void DecSortLimit() { if (sort_limit > 0) sort_limit--; }
 
+	//! Keep the display list from frame to frame instead of rebuilding it.
+	//! Takes effect at the next BeginDisplayList.
+	static void SetIncremental(bool inc) { use_incremental = inc; }
+	static bool IsIncremental() { return use_incremental; }
+
+	//! Compare new items with just the items sharing a screen tile with
+	//! them (see bins) rather than with the whole list. The sorting is the
+	//! same either way. Takes effect at the next BeginDisplayList, for
+	//! display lists that aren't incremental.
+	static void SetBinning(bool b) { use_bins = b; }
+	static bool IsBinning() { return use_bins; }
+
+	//! Paint the display list on this many threads, including the calling
+	//! one, each painting a band of the surface. 0 or 1 paints on the
+	//! calling thread only.
+	static void SetPaintThreads(unsigned int threads);
+	static unsigned int GetPaintThreads();
+
 private:
+	//! return all items to the unused list
+	void ClearDisplayList();
+	//! compare a new SortItem with the others and add it to the list
+	void InsertSortItem(SortItem *);
+	//! InsertSortItem without the bins: compare with every item in the list
+	void InsertSortItemAllPairs(SortItem *);
+	//! set up the bounding boxes and flags of si and add it to the list
+	void AddSortItem(SortItem *si, sint32 x, sint32 y, sint32 z,
+					 const ShapeInfo *info, sint32 xoff, sint32 yoff,
+					 sint32 width, sint32 height);
+	//! incremental mode: reuse the SortItem of an unchanged item, or
+	//! queue the new SortItem to be sorted in
+	void UpdateSortItem(SortItem *);
+	//! incremental mode: drop removed items and sort in the new ones
+	void FinishDisplayList();
+	void LinkSortItem(SortItem *);
+	void UnlinkSortItem(SortItem *);
+	void AddDirtyRect(const Pentagram::Rect &);
+	//! get the avatar's weapon overlay, if si is the avatar
+	bool GetWeaponOverlay(SortItem *si, Shape *&shape, uint32 &frame,
+						  sint32 &x, sint32 &y) const;
+	//! screen area of the avatar's weapon overlay, if si is the avatar
+	bool GetWeaponOverlayRect(SortItem *si, Pentagram::Rect &r) const;
+
+	void GetBinRange(SortItem *) const;
+	void AddToBins(SortItem *);
+	void RemoveFromBins(SortItem *);
+	//! respace the listpos values of all items
+	void RelabelItems();
+
 	bool PaintSortItem(SortItem	*);
 	bool NullPaintSortItem(SortItem	*);
+	//! paint just this item to rs
+	void DrawSortItem(RenderSurface *rs, SortItem *si, sint16 clipped);
+
+	//! paint the list on the paint_workers, if it is worth it
+	bool PaintBands();
+	static void PaintBand_Static(void *data, unsigned int index);
 };
 
 
@@ -0,0 +1,155 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "LocationFilter.h"
+
+#ifndef NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOCATIONFILTER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LOCATIONFILTER_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Pentagram {
+
+static inline unsigned int filterTail(const sint32* x, const sint32* y,
+									  const sint32* z, unsigned int i,
+									  unsigned int n,
+									  const sint32 lo[3], const sint32 hi[3],
+									  uint32* hits, unsigned int count)
+{
+	for (; i < n; ++i) {
+		if (x[i] < lo[0] || x[i] > hi[0] ||
+			y[i] < lo[1] || y[i] > hi[1] ||
+			z[i] < lo[2] || z[i] > hi[2])
+			continue;
+		hits[count++] = i;
+	}
+	return count;
+}
+
+unsigned int filterLocations_scalar(const sint32* x, const sint32* y,
+									const sint32* z, unsigned int n,
+									const sint32 lo[3], const sint32 hi[3],
+									uint32* hits)
+{
+	return filterTail(x, y, z, 0, n, lo, hi, hits, 0);
+}
+
+#if defined(LOCATIONFILTER_SSE2)
+
+unsigned int filterLocations(const sint32* x, const sint32* y,
+							 const sint32* z, unsigned int n,
+							 const sint32 lo[3], const sint32 hi[3],
+							 uint32* hits)
+{
+	const __m128i lox = _mm_set1_epi32(lo[0]);
+	const __m128i loy = _mm_set1_epi32(lo[1]);
+	const __m128i loz = _mm_set1_epi32(lo[2]);
+	const __m128i hix = _mm_set1_epi32(hi[0]);
+	const __m128i hiy = _mm_set1_epi32(hi[1]);
+	const __m128i hiz = _mm_set1_epi32(hi[2]);
+
+	unsigned int count = 0;
+	unsigned int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x+i));
+		__m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y+i));
+		__m128i vz = _mm_loadu_si128(reinterpret_cast<const __m128i*>(z+i));
+
+		// set for every lane that is outside the box
+		__m128i outside = _mm_or_si128(_mm_cmplt_epi32(vx, lox),
+									   _mm_cmpgt_epi32(vx, hix));
+		outside = _mm_or_si128(outside, _mm_cmplt_epi32(vy, loy));
+		outside = _mm_or_si128(outside, _mm_cmpgt_epi32(vy, hiy));
+		outside = _mm_or_si128(outside, _mm_cmplt_epi32(vz, loz));
+		outside = _mm_or_si128(outside, _mm_cmpgt_epi32(vz, hiz));
+
+		int inside = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF;
+		if (!inside) continue;
+
+		if (inside & 1) hits[count++] = i;
+		if (inside & 2) hits[count++] = i + 1;
+		if (inside & 4) hits[count++] = i + 2;
+		if (inside & 8) hits[count++] = i + 3;
+	}
+
+	return filterTail(x, y, z, i, n, lo, hi, hits, count);
+}
+
+#elif defined(LOCATIONFILTER_NEON)
+
+unsigned int filterLocations(const sint32* x, const sint32* y,
+							 const sint32* z, unsigned int n,
+							 const sint32 lo[3], const sint32 hi[3],
+							 uint32* hits)
+{
+	const int32x4_t lox = vdupq_n_s32(lo[0]);
+	const int32x4_t loy = vdupq_n_s32(lo[1]);
+	const int32x4_t loz = vdupq_n_s32(lo[2]);
+	const int32x4_t hix = vdupq_n_s32(hi[0]);
+	const int32x4_t hiy = vdupq_n_s32(hi[1]);
+	const int32x4_t hiz = vdupq_n_s32(hi[2]);
+
+	unsigned int count = 0;
+	unsigned int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		int32x4_t vx = vld1q_s32(x+i);
+		int32x4_t vy = vld1q_s32(y+i);
+		int32x4_t vz = vld1q_s32(z+i);
+
+		// set for every lane that is outside the box
+		uint32x4_t outside = vorrq_u32(vcltq_s32(vx, lox),
+									   vcgtq_s32(vx, hix));
+		outside = vorrq_u32(outside, vcltq_s32(vy, loy));
+		outside = vorrq_u32(outside, vcgtq_s32(vy, hiy));
+		outside = vorrq_u32(outside, vcltq_s32(vz, loz));
+		outside = vorrq_u32(outside, vcgtq_s32(vz, hiz));
+
+		uint32 lanes[4];
+		vst1q_u32(lanes, outside);
+		if ((lanes[0] & lanes[1] & lanes[2] & lanes[3]) != 0) continue;
+
+		if (!lanes[0]) hits[count++] = i;
+		if (!lanes[1]) hits[count++] = i + 1;
+		if (!lanes[2]) hits[count++] = i + 2;
+		if (!lanes[3]) hits[count++] = i + 3;
+	}
+
+	return filterTail(x, y, z, i, n, lo, hi, hits, count);
+}
+
+#else
+
+unsigned int filterLocations(const sint32* x, const sint32* y,
+							 const sint32* z, unsigned int n,
+							 const sint32 lo[3], const sint32 hi[3],
+							 uint32* hits)
+{
+	return filterTail(x, y, z, 0, n, lo, hi, hits, 0);
+}
+
+#endif
+
+}
@@ -0,0 +1,50 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//
+// LocationFilter finds the locations inside a box, for the packed
+// location arrays of the CurrentMap spatial index.
+//
+// There are SSE2 and NEON versions that test four locations at a time.
+// The scalar version is always available, and is used when neither is
+// (or when NO_SIMD is defined).
+//
+
+#ifndef LOCATIONFILTER_H
+#define LOCATIONFILTER_H
+
+namespace Pentagram {
+
+//! Find the locations (x[i],y[i],z[i]) with lo <= location <= hi.
+//! \param hits receives the indices of the matches, in increasing order.
+//!             It must have room for n entries.
+//! \return the number of matches
+unsigned int filterLocations(const sint32* x, const sint32* y,
+							 const sint32* z, unsigned int n,
+							 const sint32 lo[3], const sint32 hi[3],
+							 uint32* hits);
+
+//! Scalar version of filterLocations
+unsigned int filterLocations_scalar(const sint32* x, const sint32* y,
+									const sint32* z, unsigned int n,
+									const sint32 lo[3], const sint32 hi[3],
+									uint32* hits);
+
+}
+
+#endif
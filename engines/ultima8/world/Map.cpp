@@ -82,9 +82,20 @@ static void shiftCoordsToZ(sint32& x, sint32& y, sint32& z, sint32 newz)
 }
 
 
-void Map::loadFixed(IDataSource* ds)
+void Map::loadFixed(IDataSource* ds, Uint64* createticks)
 {
-	loadFixedFormatObjects(fixeditems, ds, Item::EXT_FIXED);
+	decodeFixed(mapnum, ds, fixeditems, createticks);
+}
+
+void Map::setFixed(std::list<Item*>& items)
+{
+	fixeditems.splice(fixeditems.end(), items);
+}
+
+void Map::decodeFixed(uint32 mapnum, IDataSource* ds,
+					  std::list<Item*>& fixeditems, Uint64* createticks)
+{
+	loadFixedFormatObjects(fixeditems, ds, Item::EXT_FIXED, createticks);
 
 
 	// U8 hack for missing ground tiles on map 25. See docs/u8bugs.txt
@@ -312,7 +323,7 @@ void Map::unloadFixed()
 }
 
 void Map::loadFixedFormatObjects(std::list<Item*>& itemlist, IDataSource* ds,
-								 uint32 extendedflags)
+								 uint32 extendedflags, Uint64* createticks)
 {
 	if (!ds) return;
 	uint32 size = ds->getSize();
@@ -359,8 +370,11 @@ void Map::loadFixedFormatObjects(std::list<Item*>& itemlist, IDataSource* ds,
 		pout << shape << "," << frame << ":\t(" << x << "," << y << "," << z << "),\t" << std::hex << flags << std::dec << ", " << quality << ", " << npcnum << ", " << mapnum << ", " << next << std::endl;
 #endif
 
+		Uint64 createstart = createticks ? SDL_GetPerformanceCounter() : 0;
 		Item *item = ItemFactory::createItem(shape,frame,quality,flags,npcnum,
 											 mapnum,extendedflags,false);
+		if (createticks)
+			*createticks += SDL_GetPerformanceCounter() - createstart;
 		if (!item) {
 			pout << shape << "," << frame << ":\t(" << x << "," << y << "," << z << "),\t" << std::hex << flags << std::dec << ", " << quality << ", " << npcnum << ", " << mapnum << ", " << next;
 
@@ -35,9 +35,20 @@ public:
 	void clear();
 
 	void loadNonFixed(IDataSource* ds);
-	void loadFixed(IDataSource* ds);
+	void loadFixed(IDataSource* ds, Uint64* createticks=0);
 	void unloadFixed();
 
+	//! use already decoded fixed items (see MapPrefetcher)
+	void setFixed(std::list<Item*>& items);
+
+	//! Decode the fixed items of map 'mapnum' into 'fixeditems'.
+	//! This only creates the Items, so it's safe to call from any thread.
+	//! \param createticks if set, the performance counter ticks spent in
+	//!                    ItemFactory are added to it
+	static void decodeFixed(uint32 mapnum, IDataSource* ds,
+							std::list<Item*>& fixeditems,
+							Uint64* createticks=0);
+
 	bool isEmpty()
 		{ return fixeditems.size() == 0 && dynamicitems.size() == 0; }
 
@@ -47,8 +58,8 @@ public:
 private:
 
 	// load items from something formatted like 'fixed.dat'
-	void loadFixedFormatObjects(std::list<Item*>& itemlist, IDataSource* ds,
-								uint32 extendedflags);
+	static void loadFixedFormatObjects(std::list<Item*>& itemlist, IDataSource* ds,
+								uint32 extendedflags, Uint64* createticks=0);
 
 	// Q: How should we store the items in a map.
 	// It might make things more efficient if we order them by 'chunk'
@@ -20,6 +20,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "MapGlob.h"
 #include "IDataSource.h"
+#include "MainShapeArchive.h"
+#include "ShapeInfo.h"
+#include "CoreApp.h"
 
 MapGlob::MapGlob()
 {
@@ -30,6 +33,7 @@ MapGlob::MapGlob()
 MapGlob::~MapGlob()
 {
 	contents.clear();
+	itemTemplate.clear();
 }
 
 void MapGlob::read(IDataSource* ds)
@@ -51,3 +55,49 @@ void MapGlob::read(IDataSource* ds)
 		contents[i] = item;
 	}
 }
+
+void MapGlob::buildTemplate(MainShapeArchive* shapes)
+{
+	unsigned int coordshift = 1;
+	if (GAME_IS_CRUSADER)
+		coordshift = 2;
+
+	itemTemplate.clear();
+	itemTemplate.reserve(contents.size());
+
+	std::vector<GlobItem>::iterator iter;
+	for (iter = contents.begin(); iter != contents.end(); ++iter)
+	{
+		ShapeInfo* info = shapes->getShapeInfo(iter->shape);
+		if (!info) continue;
+
+		switch (info->family) {
+		case ShapeInfo::SF_GENERIC:
+		case ShapeInfo::SF_QUALITY:
+		case ShapeInfo::SF_QUANTITY:
+		case ShapeInfo::SF_BREAKABLE:
+		case ShapeInfo::SF_REAGENT:
+		case ShapeInfo::SF_15:
+		case ShapeInfo::SF_CONTAINER:
+		case ShapeInfo::SF_GLOBEGG:
+		case ShapeInfo::SF_UNKEGG:
+		case ShapeInfo::SF_MONSTEREGG:
+		case ShapeInfo::SF_TELEPORTEGG:
+			break;
+		default:
+			continue;
+		}
+
+		GlobTemplateItem item;
+		item.x = static_cast<sint16>((iter->x << coordshift) + 1);
+		item.y = static_cast<sint16>((iter->y << coordshift) + 1);
+		item.z = static_cast<sint16>(iter->z);
+		item.shape = static_cast<uint16>(iter->shape);
+		item.frame = static_cast<uint8>(iter->frame);
+		item.family = static_cast<uint8>(info->family);
+		itemTemplate.push_back(item);
+	}
+
+	// only the template is needed from now on
+	std::vector<GlobItem>().swap(contents);
+}
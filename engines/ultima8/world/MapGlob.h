@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <vector>
 
 class IDataSource;
+class MainShapeArchive;
 
 struct GlobItem {
 	int x;
@@ -31,18 +32,35 @@ struct GlobItem {
 	int frame;
 };
 
+//! A glob item ready to be created: the family of its shape is looked up
+//! and its offset from the egg's chunk corner worked out once, at load.
+struct GlobTemplateItem {
+	sint16 x;
+	sint16 y;
+	sint16 z;
+	uint16 shape;
+	uint8 frame;
+	uint8 family;		//!< ShapeInfo family, for ItemFactory
+};
+
 class MapGlob
 {
-	friend class GlobEgg;
-
 public:
 	MapGlob();
 	~MapGlob();
 
 	void read(IDataSource* ds);
 
+	//! Build the template of the items read, once the shape info is
+	//! loaded. Items that ItemFactory can't create are left out.
+	void buildTemplate(MainShapeArchive* shapes);
+
+	const std::vector<GlobTemplateItem>& getTemplate() const
+		{ return itemTemplate; }
+
 private:
 	std::vector<GlobItem> contents;
+	std::vector<GlobTemplateItem> itemTemplate;
 };
 
 #endif
@@ -0,0 +1,131 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "MapPrefetcher.h"
+#include "Map.h"
+#include "Item.h"
+#include "GameData.h"
+#include "RawArchive.h"
+#include "IDataSource.h"
+
+MapPrefetcher::MapPrefetcher()
+	: counter(0)
+{
+	for (int i = 0; i < NUM_SLOTS; ++i) {
+		slots[i].mapnum = 0;
+		slots[i].ds = 0;
+		slots[i].thread = 0;
+		slots[i].lastused = 0;
+		slots[i].used = false;
+	}
+}
+
+MapPrefetcher::~MapPrefetcher()
+{
+	clear();
+}
+
+void MapPrefetcher::prefetch(uint32 mapnum)
+{
+	Slot* slot = 0;
+	for (int i = 0; i < NUM_SLOTS; ++i) {
+		if (slots[i].used && slots[i].mapnum == mapnum) {
+			slots[i].lastused = ++counter;
+			return; // already there
+		}
+
+		// use a free slot, or the least recently used one
+		if (!slot || !slots[i].used ||
+			(slot->used && slots[i].lastused < slot->lastused))
+			slot = &slots[i];
+	}
+
+	release(*slot);
+
+	// The archive isn't thread-safe, so the data is read right here.
+	// The decoding (which builds all the Items) is what takes the time.
+	IDataSource* ds = GameData::get_instance()->getFixed()
+		->get_datasource(mapnum);
+	if (!ds) return;
+
+	slot->mapnum = mapnum;
+	slot->ds = ds;
+	slot->lastused = ++counter;
+	slot->used = true;
+	slot->thread = SDL_CreateThread(threadMain, "MapPrefetcher",
+									static_cast<void*>(slot));
+	if (!slot->thread)
+		threadMain(static_cast<void*>(slot));
+}
+
+bool MapPrefetcher::take(uint32 mapnum, std::list<Item*>& items)
+{
+	for (int i = 0; i < NUM_SLOTS; ++i) {
+		Slot& slot = slots[i];
+		if (!slot.used || slot.mapnum != mapnum) continue;
+
+		wait(slot);
+		items.splice(items.end(), slot.items);
+		slot.used = false;
+
+		pout << "Using prefetched fixed items of map " << mapnum << std::endl;
+		return true;
+	}
+
+	return false;
+}
+
+void MapPrefetcher::clear()
+{
+	for (int i = 0; i < NUM_SLOTS; ++i)
+		release(slots[i]);
+}
+
+void MapPrefetcher::wait(Slot& slot)
+{
+	if (slot.thread) {
+		SDL_WaitThread(slot.thread, 0);
+		slot.thread = 0;
+	}
+}
+
+void MapPrefetcher::release(Slot& slot)
+{
+	wait(slot);
+
+	std::list<Item*>::iterator iter;
+	for (iter = slot.items.begin(); iter != slot.items.end(); ++iter)
+		delete *iter;
+	slot.items.clear();
+
+	slot.used = false;
+}
+
+int SDLCALL MapPrefetcher::threadMain(void* data)
+{
+	Slot* slot = static_cast<Slot*>(data);
+
+	Map::decodeFixed(slot->mapnum, slot->ds, slot->items);
+
+	delete slot->ds;
+	slot->ds = 0;
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2002-2006 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef MAPPREFETCHER_H
+#define MAPPREFETCHER_H
+
+#include <list>
+#include <SDL3/SDL.h>
+#include "misc/sdl2_compat.h"
+
+class Item;
+class IDataSource;
+
+//! Decodes the fixed items of maps the avatar is likely to teleport to
+//! on a background thread, so World::switchMap doesn't have to.
+//!
+//! The decoded items have no ObjIds and aren't in any list, so nothing
+//! else can see them until they're handed over with take().
+class MapPrefetcher
+{
+public:
+	MapPrefetcher();
+	~MapPrefetcher();
+
+	//! start decoding the fixed items of a map, unless that's already
+	//! been done or is in progress
+	void prefetch(uint32 mapnum);
+
+	//! get the prefetched fixed items of a map, waiting for the decoding
+	//! to finish if necessary.
+	//! \return false if the map wasn't prefetched
+	bool take(uint32 mapnum, std::list<Item*>& items);
+
+	//! delete all prefetched items
+	void clear();
+
+private:
+	enum { NUM_SLOTS = 4 };
+
+	struct Slot {
+		uint32 mapnum;
+		IDataSource* ds;
+		std::list<Item*> items;
+		SDL_Thread* thread;
+		uint32 lastused;
+		bool used;
+	};
+
+	static int SDLCALL threadMain(void* data);
+
+	//! wait for the slot's thread and delete its items
+	void release(Slot& slot);
+	void wait(Slot& slot);
+
+	Slot slots[NUM_SLOTS];
+	uint32 counter;
+};
+
+#endif
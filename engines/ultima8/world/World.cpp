@@ -67,6 +67,8 @@ void World::clear()
 {
 	unsigned int i;
 
+	prefetcher.clear();
+
 	for (i = 0; i < maps.size(); ++i) {
 		delete maps[i];
 	}
@@ -171,11 +173,26 @@ bool World::switchMap(uint32 newmap)
 	// Kill any processes that need killing (those with type != 1 && item != 0)
 	Kernel::get_instance()->killProcessesNotOfType(0, 1, true);
 
-	pout << "Loading Fixed items in map " << newmap << std::endl;
-	IDataSource *items = GameData::get_instance()->getFixed()
-		->get_datasource(newmap);
-	maps[newmap]->loadFixed(items);
-	delete items;
+	CurrentMap::LoadStats& stats = currentmap->beginLoadStats(newmap);
+	Uint64 decodestart = SDL_GetPerformanceCounter();
+
+	std::list<Item*> prefetched;
+	if (prefetcher.take(newmap, prefetched)) {
+		maps[newmap]->setFixed(prefetched);
+		stats.prefetched = true;
+	} else {
+		pout << "Loading Fixed items in map " << newmap << std::endl;
+		IDataSource *items = GameData::get_instance()->getFixed()
+			->get_datasource(newmap);
+		maps[newmap]->loadFixed(items, &stats.create);
+		delete items;
+	}
+
+	stats.decode = SDL_GetPerformanceCounter() - decodestart;
+	if (stats.decode > stats.create)
+		stats.decode -= stats.create;
+	else
+		stats.decode = 0;
 
 	currentmap->loadMap(maps[newmap]);
 
@@ -188,6 +205,14 @@ bool World::switchMap(uint32 newmap)
 	return true;
 }
 
+void World::prefetchMap(uint32 mapnum)
+{
+	if (mapnum >= maps.size() || maps[mapnum] == 0) return;
+	if (currentmap && currentmap->getNum() == mapnum) return;
+
+	prefetcher.prefetch(mapnum);
+}
+
 void World::loadNonFixed(IDataSource* ds)
 {
 	FlexFile* f = new FlexFile(ds);
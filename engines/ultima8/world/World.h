@@ -55,6 +55,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <vector>
 #include <list>
 
+#include "MapPrefetcher.h"
+
 class Map;
 class CurrentMap;
 class IDataSource;
@@ -95,6 +97,10 @@ public:
 	//! \return true if successful
 	bool switchMap(uint32 newmap);
 
+	//! start decoding the fixed items of a map the avatar is likely to
+	//! switch to (see MapPrefetcher)
+	void prefetchMap(uint32 mapnum);
+
 	//! push an item onto the ethereal void
 	void etherealPush(ObjId objid) { ethereal.push_front(objid); }
 
@@ -129,6 +135,8 @@ private:
 	CurrentMap* currentmap;
 
 	std::list<ObjId> ethereal;
+
+	MapPrefetcher prefetcher;
 };
 
 #endif
@@ -844,10 +844,11 @@ ProcId Actor::die(uint16 damageType)
 
 void Actor::killAllButCombatProcesses()
 {
-	// loop over all processes, keeping only the relevant ones
-	ProcessIter iter = Kernel::get_instance()->getProcessBeginIterator();
-	ProcessIter endproc = Kernel::get_instance()->getProcessEndIterator();
-	for (; iter != endproc; ++iter) {
+	// loop over all our processes, keeping only the relevant ones
+	std::vector<Process*> procs;
+	Kernel::get_instance()->getObjectProcesses(objid, procs);
+	std::vector<Process*>::iterator iter;
+	for (iter = procs.begin(); iter != procs.end(); ++iter) {
 		Process* p = *iter;
 		if (!p) continue;
 		if (p->getItemNum() != objid) continue;
@@ -877,10 +878,11 @@ ProcId Actor::killAllButFallAnims(bool death)
 		killAllButCombatProcesses();
 	}
 
-	// loop over all animation processes, keeping only the relevant ones
-	ProcessIter iter = Kernel::get_instance()->getProcessBeginIterator();
-	ProcessIter endproc = Kernel::get_instance()->getProcessEndIterator();
-	for (; iter != endproc; ++iter) {
+	// loop over all our animation processes, keeping only the relevant ones
+	std::vector<Process*> procs;
+	kernel->getObjectProcesses(objid, procs);
+	std::vector<Process*>::iterator iter;
+	for (iter = procs.begin(); iter != procs.end(); ++iter) {
 		ActorAnimProcess* p = p_dynamic_cast<ActorAnimProcess*>(*iter);
 		if (!p) continue;
 		if (p->getItemNum() != objid) continue;
@@ -54,6 +54,53 @@ void AnimAction::getAnimRange(unsigned int lastanim, int lastdir,
 	}
 }
 
+void AnimAction::buildTravelTables()
+{
+	for (unsigned int dir = 0; dir < 16; dir++) {
+		travel[dir].clear();
+		if (frames[dir].empty()) continue;
+
+		AnimTravel t = { 0, 0, 0 };
+		travel[dir].reserve(frames[dir].size() + 1);
+		travel[dir].push_back(t);
+		for (unsigned int i = 0; i < frames[dir].size(); i++) {
+			const AnimFrame& f = frames[dir][i];
+			t.deltadir += f.deltadir;
+			t.deltaz += f.deltaz;
+			if (!(f.flags & AnimFrame::AFF_ONGROUND)) t.offground++;
+			travel[dir].push_back(t);
+		}
+	}
+}
+
+AnimTravel AnimAction::getTravel(unsigned int dir, unsigned int startframe,
+								 unsigned int endframe) const
+{
+	const std::vector<AnimTravel>& t = travel[dir];
+	AnimTravel total = { 0, 0, 0 };
+	unsigned int frame = startframe;
+	if (t.size() != size + 1) return total;
+
+	// up to endframe, or to the last frame and then again after looping
+	for (int pass = 0; pass < 2 && frame != endframe; pass++) {
+		unsigned int stop = (endframe > frame) ? endframe : size;
+		if (frame < stop) {
+			total.deltadir += t[stop].deltadir - t[frame].deltadir;
+			total.deltaz += t[stop].deltaz - t[frame].deltaz;
+			total.offground += t[stop].offground - t[frame].offground;
+		}
+		if (stop == endframe) break;
+
+		// as AnimationTracker::getNextFrame()
+		if (flags & (AAF_LOOPING | AAF_LOOPING2)) // CHECKME: unknown flag
+			frame = 1;
+		else
+			frame = 0;
+	}
+
+	return total;
+}
+
 void AnimAction::getAnimRange(Actor* actor, int dir,
 							  unsigned int& startframe,
 							  unsigned int& endframe) const
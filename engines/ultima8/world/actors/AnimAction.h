@@ -41,6 +41,14 @@ struct AnimFrame
 	inline int attack_range() { return ((flags >> 2) & 0x07); }
 };
 
+//! The movement of a run of AnimFrames
+struct AnimTravel
+{
+	int deltadir;	// sum of AnimFrame::deltadir
+	int deltaz;		// sum of AnimFrame::deltaz
+	int offground;	// frames without AFF_ONGROUND
+};
+
 struct AnimAction {
 	uint32 shapenum;
 	uint32 action;
@@ -73,6 +81,18 @@ struct AnimAction {
 
 	unsigned int getDirCount() const;
 
+	//! return the movement of the frames played from startframe until
+	//! endframe, as AnimationTracker plays them (looping if necessary),
+	//! without going through the frames one by one
+	AnimTravel getTravel(unsigned int dir, unsigned int startframe,
+						 unsigned int endframe) const;
+
+	//! make the tables getTravel() uses; done when the frames are loaded
+	void buildTravelTables();
+
+	//! travel[dir][i] is the movement of frames 0 to i-1 in direction dir
+	std::vector<AnimTravel> travel[16];
+
 	enum AnimActionFlags {
 		AAF_TWOSTEP      = 0x0001,
 		AAF_ATTACK       = 0x0002,
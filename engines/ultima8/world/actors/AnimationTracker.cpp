@@ -147,18 +147,9 @@ void AnimationTracker::evaluateMaxAnimTravel(sint32& max_endx, sint32& max_endy,
 	else
 		testframe = getNextFrame(currentframe);
 
-	for(;;)
-	{
-		AnimFrame& f = animaction->frames[dir][testframe];
-		// determine movement for this frame
-		sint32 dx = 4 * x_fact[dir] * f.deltadir;
-		sint32 dy = 4 * y_fact[dir] * f.deltadir;
-		max_endx += dx;
-		max_endy += dy;
-		testframe = getNextFrame(testframe);
-		if(testframe == endframe)
-			return;
-	}
+	int deltadir = animaction->getTravel(dir, testframe, endframe).deltadir;
+	max_endx += 4 * x_fact[dir] * deltadir;
+	max_endy += 4 * y_fact[dir] * deltadir;
 }
 
 bool AnimationTracker::step()
@@ -303,6 +294,8 @@ bool AnimationTracker::step()
 										xd,yd,zd,
 										a->getShapeInfo()->flags,
 										actor, &support, 0);
+	// where support was found, so it needn't be looked for again below
+	sint32 supportx = tx, supporty = ty, supportz = tz;
 
 	if (GAME_IS_U8 && targetok && support)
 	{
@@ -393,11 +386,14 @@ bool AnimationTracker::step()
 	if (f.flags & AnimFrame::AFF_ONGROUND) {
 		// needs support
 
-		/*bool targetok = */ cm->isValidPosition(tx,ty,tz,
-												 startx,starty,startz,
-												 xd,yd,zd,
-												 a->getShapeInfo()->flags,
-												 actor, &support, 0);
+		// only look again if the step was adjusted since
+		if (tx != supportx || ty != supporty || tz != supportz) {
+			/*bool targetok = */ cm->isValidPosition(tx,ty,tz,
+													 startx,starty,startz,
+													 xd,yd,zd,
+													 a->getShapeInfo()->flags,
+													 actor, &support, 0);
+		}
 		
 
 		if (!support) {
@@ -430,24 +426,13 @@ AnimFrame* AnimationTracker::getAnimFrame()
 
 void AnimationTracker::setTargetedMode(sint32 x_, sint32 y_, sint32 z_)
 {
-	unsigned int i;
-	int totaldir = 0;
-	int totalz = 0;
-	int offGround = 0;
+	AnimTravel travel = animaction->getTravel(dir, startframe, endframe);
+	int offGround = travel.offground;
 	sint32 end_dx, end_dy, end_dz;
 
-	for (i=startframe; i != endframe; i = getNextFrame(i))
-	{
-		AnimFrame& f = animaction->frames[dir][i];
-		totaldir += f.deltadir;  // This line sometimes seg faults.. ????
-		totalz += f.deltaz;
-		if (!(f.flags & AnimFrame::AFF_ONGROUND))
-			++offGround;
-	}
-
-	end_dx = 4 * x_fact[dir] * totaldir;
-	end_dy = 4 * y_fact[dir] * totaldir;
-	end_dz = totalz;
+	end_dx = 4 * x_fact[dir] * travel.deltadir;
+	end_dy = 4 * y_fact[dir] * travel.deltadir;
+	end_dz = travel.deltaz;
 
 	if (offGround)
 	{
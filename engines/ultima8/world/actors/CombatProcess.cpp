@@ -29,15 +29,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Kernel.h"
 #include "DelayProcess.h"
 #include "PathfinderProcess.h"
+#include "FlowField.h"
 #include "ShapeInfo.h"
 #include "MonsterInfo.h"
 #include "getObject.h"
 #include "LoiterProcess.h"
 #include "AmbushProcess.h"
+#include "ObjectManager.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
 
+// closer to the target than this, the flow field is too coarse to follow
+static const sint32 FLOW_NEAR = 128;
+
 // p_dynamic_cast stuff
 DEFINE_RUNTIME_CLASSTYPE_CODE(CombatProcess,Process);
 
@@ -77,12 +82,12 @@ void CombatProcess::run()
 	if (!(a->getFlags() & Item::FLG_FASTAREA))
 		return;
 
-	Actor* t = getActor(target);
+	Actor* t = getActorByHandle(target);
 
 	if (!t || !isValidTarget(t)) {
 		// no target? try to find one
 
-		target = seekTarget();
+		target = ObjectManager::get_instance()->getHandle(seekTarget());
 
 		if (!target) {
 			waitForTarget();
@@ -90,10 +95,15 @@ void CombatProcess::run()
 		}
 
 		pout << "[COMBAT " << item_num << "] target found: "
-			 << target << std::endl;
+			 << ObjectManager::getHandleObjId(target) << std::endl;
 		combatmode = CM_WAITING;
 	}
 
+	// Far from the target, follow the flow field shared by everyone
+	// pursuing it. The Pathfinder is only needed where it can't help.
+	if (combatmode == CM_WAITING && followFlowField())
+		return;
+
 	int targetdir = getTargetDirection();
 	if (a->getDir() != targetdir) {
 		turnToDirection(targetdir);
@@ -103,8 +113,8 @@ void CombatProcess::run()
 	if (inAttackRange()) {
 		combatmode = CM_ATTACKING;
 
-		pout << "[COMBAT " << item_num << "] target (" << target
-			 << ") in range" << std::endl;
+		pout << "[COMBAT " << item_num << "] target ("
+			 << ObjectManager::getHandleObjId(target) << ") in range" << std::endl;
 
 		bool hasidle1 = a->hasAnim(Animation::idle1);
 		bool hasidle2 = a->hasAnim(Animation::idle2);
@@ -148,7 +158,8 @@ void CombatProcess::run()
 	} else if (combatmode != CM_PATHFINDING) {
 		// not in range? See if we can get in range
 
-		Process* pfproc = new PathfinderProcess(a, target, true);
+		Process* pfproc = new PathfinderProcess(a,
+			ObjectManager::getHandleObjId(target), true);
 		
 		waitFor(Kernel::get_instance()->addProcess(pfproc));
 		combatmode = CM_PATHFINDING;
@@ -161,21 +172,23 @@ void CombatProcess::run()
 
 ObjId CombatProcess::getTarget()
 {
-	Actor* t = getActor(target);
+	Actor* t = getActorByHandle(target);
 
 	if (!t || !isValidTarget(t))
 		target = 0;
 
-	return target;
+	return ObjectManager::getHandleObjId(target);
 }
 
 void CombatProcess::setTarget(ObjId newtarget)
 {
+	ObjHandle handle = ObjectManager::get_instance()->getHandle(newtarget);
+
 	if (fixedTarget == 0) {
-		fixedTarget = newtarget; // want to prevent seekTarget from changing it
+		fixedTarget = handle; // want to prevent seekTarget from changing it
 	}
 
-	target = newtarget;
+	target = handle;
 }
 
 bool CombatProcess::isValidTarget(Actor* target)
@@ -220,9 +233,9 @@ ObjId CombatProcess::seekTarget()
 	if (!a) return 0; // uh oh
 
 	if (fixedTarget) {
-		Actor* t = getActor(fixedTarget);
+		Actor* t = getActorByHandle(fixedTarget);
 		if (t && isValidTarget(t))
-			return fixedTarget; // no need to search
+			return t->getObjId(); // no need to search
 	}
 
 	UCList itemlist(2);
@@ -246,7 +259,7 @@ ObjId CombatProcess::seekTarget()
 int CombatProcess::getTargetDirection()
 {
 	Actor* a = getActor(item_num);
-	Actor* t = getActor(target);
+	Actor* t = getActorByHandle(target);
 
 	return a->getDirToItemCentre(*t);
 }
@@ -300,11 +313,40 @@ bool CombatProcess::inAttackRange()
 	}
 
 	ObjId hit = tracker.hitSomething();
-	if (hit == target) return true;
+	if (hit && hit == ObjectManager::getHandleObjId(target)) return true;
 
 	return false;
 }
 
+bool CombatProcess::followFlowField()
+{
+	Actor* a = getActor(item_num);
+	Actor* t = getActorByHandle(target);
+	ShapeInfo* shapeinfo = a->getShapeInfo();
+	MonsterInfo* mi = 0;
+	if (shapeinfo) mi = shapeinfo->monsterinfo;
+
+	if (mi && mi->ranged)
+		return false; // ranged attackers don't need to get closer
+
+	sint32 ax, ay, az, tx, ty, tz;
+	a->getCentre(ax, ay, az);
+	t->getCentre(tx, ty, tz);
+	if (abs(ax - tx) < FLOW_NEAR && abs(ay - ty) < FLOW_NEAR)
+		return false;
+
+	const FlowField* field = FlowField::get(t);
+	int dir = field->getDirection(ax, ay, a->getZ());
+	if (dir < 0)
+		return false;
+
+	if (a->tryAnim(Animation::advance, dir) != Animation::SUCCESS)
+		return false;
+
+	waitFor(a->doAnim(Animation::advance, dir));
+	return true;
+}
+
 void CombatProcess::waitForTarget()
 {
 	Actor* a = getActor(item_num);
@@ -335,15 +377,15 @@ void CombatProcess::waitForTarget()
 void CombatProcess::dumpInfo()
 {
 	Process::dumpInfo();
-	pout << "Target: " << target << std::endl;
+	pout << "Target: " << ObjectManager::getHandleObjId(target) << std::endl;
 }
 
 void CombatProcess::saveData(ODataSource* ods)
 {
 	Process::saveData(ods);
 
-	ods->write2(target);
-	ods->write2(fixedTarget);
+	ods->write2(ObjectManager::getHandleObjId(target));
+	ods->write2(ObjectManager::getHandleObjId(fixedTarget));
 	ods->write1(static_cast<uint8>(combatmode));
 }
 
@@ -351,8 +393,9 @@ bool CombatProcess::loadData(IDataSource* ids, uint32 version)
 {
 	if (!Process::loadData(ids, version)) return false;
 
-	target = ids->read2();
-	fixedTarget = ids->read2();
+	ObjectManager* objman = ObjectManager::get_instance();
+	target = objman->getLoadHandle(ids->read2());
+	fixedTarget = objman->getLoadHandle(ids->read2());
 	combatmode = static_cast<CombatMode>(ids->read1());
 
 	return true;
@@ -49,13 +49,19 @@ protected:
 	bool isValidTarget(Actor* target);
 	bool isEnemy(Actor* target);
 	bool inAttackRange();
+
+	//! take a step along the flow field leading to the target
+	//! \return false if the field can't help, see FlowField
+	bool followFlowField();
 	int getTargetDirection();
 
 	void turnToDirection(int direction);
 	void waitForTarget();
 
-	ObjId target;
-	ObjId fixedTarget;
+	//! handles, so a target that dies and has its objid reused by
+	//! something else is noticed
+	ObjHandle target;
+	ObjHandle fixedTarget;
 
 	enum CombatMode {
 		CM_WAITING = 0,
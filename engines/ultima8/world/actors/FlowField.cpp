@@ -0,0 +1,205 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+#include "FlowField.h"
+
+#include "Actor.h"
+#include "CurrentMap.h"
+#include "World.h"
+#include "Kernel.h"
+#include "ShapeInfo.h"
+#include "Direction.h"
+
+#include <queue>
+
+static const sint32 FIELD_CELL = 32;		// size of a cell
+static const int FIELD_RADIUS = 16;			// cells around the target cell
+static const int FIELD_SIZE = 2 * FIELD_RADIUS + 1;
+static const int FIELD_HEIGHT = 40;			// headroom a cell needs
+static const uint32 FIELD_LIFETIME = 30;	// frames a field is used
+static const uint16 UNREACHABLE = 0xFFFF;
+
+// step costs, roughly 2:3 for straight:diagonal
+static const uint16 COST_STRAIGHT = 2;
+static const uint16 COST_DIAGONAL = 3;
+
+std::map<ObjId, FlowField> FlowField::fields;
+
+FlowField::FlowField()
+	: mapnum(0), framenum(0), basex(0), basey(0), z(0), targetcell(-1)
+{
+
+}
+
+const FlowField* FlowField::get(Actor* target)
+{
+	uint32 now = Kernel::get_instance()->getFrameNum();
+	uint32 curmap = World::get_instance()->getCurrentMap()->getNum();
+
+	// drop the fields nobody asked for in a while
+	std::map<ObjId, FlowField>::iterator iter = fields.begin();
+	while (iter != fields.end()) {
+		if (iter->second.mapnum != curmap ||
+			now - iter->second.framenum > 4 * FIELD_LIFETIME)
+			fields.erase(iter++);
+		else
+			++iter;
+	}
+
+	FlowField& field = fields[target->getObjId()];
+
+	sint32 tx, ty, tz;
+	target->getCentre(tx, ty, tz);
+	if (field.targetcell < 0 || now - field.framenum > FIELD_LIFETIME ||
+		field.getCell(tx, ty) != field.targetcell || field.z != target->getZ())
+	{
+		field.compute(target);
+	}
+
+	return &field;
+}
+
+int FlowField::getCell(sint32 x, sint32 y) const
+{
+	sint32 dx = x - basex, dy = y - basey;
+	if (dx < 0 || dy < 0) return -1;
+
+	int cx = dx / FIELD_CELL, cy = dy / FIELD_CELL;
+	if (cx >= FIELD_SIZE || cy >= FIELD_SIZE) return -1;
+
+	return cy * FIELD_SIZE + cx;
+}
+
+bool FlowField::canStep(int cell, int dx, int dy) const
+{
+	int cx = cell % FIELD_SIZE + dx, cy = cell / FIELD_SIZE + dy;
+	if (cx < 0 || cy < 0 || cx >= FIELD_SIZE || cy >= FIELD_SIZE)
+		return false;
+
+	if (distance[cy * FIELD_SIZE + cx] == UNREACHABLE)
+		return false;
+
+	// don't cut corners
+	if (dx && dy) {
+		if (distance[cell + dx] == UNREACHABLE ||
+			distance[cell + dy * FIELD_SIZE] == UNREACHABLE)
+			return false;
+	}
+
+	return true;
+}
+
+void FlowField::compute(Actor* target)
+{
+	CurrentMap* cm = World::get_instance()->getCurrentMap();
+	uint32 shapeflags = target->getShapeInfo()->flags;
+
+	sint32 tx, ty, tz;
+	target->getCentre(tx, ty, tz);
+	z = target->getZ();
+
+	mapnum = cm->getNum();
+	framenum = Kernel::get_instance()->getFrameNum();
+	basex = tx - FIELD_CELL / 2 - FIELD_RADIUS * FIELD_CELL;
+	basey = ty - FIELD_CELL / 2 - FIELD_RADIUS * FIELD_CELL;
+	targetcell = FIELD_RADIUS * FIELD_SIZE + FIELD_RADIUS;
+
+	// A cell is open if a cell sized box standing on something fits in it.
+	// UNREACHABLE marks the blocked ones, 0xFFFE the open ones not reached
+	// yet.
+	distance.assign(FIELD_SIZE * FIELD_SIZE, UNREACHABLE);
+	for (int cy = 0; cy < FIELD_SIZE; ++cy) {
+		for (int cx = 0; cx < FIELD_SIZE; ++cx) {
+			int cell = cy * FIELD_SIZE + cx;
+			if (cell == targetcell) {
+				distance[cell] = UNREACHABLE - 1;
+				continue;
+			}
+
+			// item coordinates are the far corner of the box
+			sint32 x = basex + (cx + 1) * FIELD_CELL;
+			sint32 y = basey + (cy + 1) * FIELD_CELL;
+			Item* support = 0;
+			if (cm->isValidPosition(x, y, z, FIELD_CELL, FIELD_CELL,
+									FIELD_HEIGHT, shapeflags,
+									target->getObjId(), &support) &&
+				support)
+			{
+				distance[cell] = UNREACHABLE - 1;
+			}
+		}
+	}
+
+	typedef std::pair<uint16, int> QueueEntry;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+						std::greater<QueueEntry> > queue;
+
+	distance[targetcell] = 0;
+	queue.push(QueueEntry(0, targetcell));
+
+	while (!queue.empty()) {
+		QueueEntry entry = queue.top(); queue.pop();
+		int cell = entry.second;
+		if (entry.first != distance[cell]) continue; // already improved
+
+		for (int dir = 0; dir < 8; ++dir) {
+			int dx = x_fact[dir], dy = y_fact[dir];
+			if (!canStep(cell, dx, dy)) continue;
+
+			int next = cell + dy * FIELD_SIZE + dx;
+			uint16 d = distance[cell] +
+				((dx && dy) ? COST_DIAGONAL : COST_STRAIGHT);
+			if (d < distance[next]) {
+				distance[next] = d;
+				queue.push(QueueEntry(d, next));
+			}
+		}
+	}
+
+	// open cells that weren't reached are as good as blocked
+	for (unsigned int i = 0; i < distance.size(); ++i)
+		if (distance[i] == UNREACHABLE - 1)
+			distance[i] = UNREACHABLE;
+}
+
+int FlowField::getDirection(sint32 x, sint32 y, sint32 z_) const
+{
+	if (abs(z_ - z) > 8) return -1;
+
+	int cell = getCell(x, y);
+	if (cell < 0 || cell == targetcell)
+		return -1;
+
+	// The actor's own cell is usually blocked by the actor itself, so
+	// any reachable neighbour will do then.
+	int bestdir = -1;
+	uint16 best = distance[cell];
+	for (int dir = 0; dir < 8; ++dir) {
+		int dx = x_fact[dir], dy = y_fact[dir];
+		if (!canStep(cell, dx, dy)) continue;
+
+		uint16 d = distance[cell + dy * FIELD_SIZE + dx];
+		if (d < best) {
+			best = d;
+			bestdir = dir;
+		}
+	}
+
+	return bestdir;
+}
@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2007 The Pentagram team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <map>
+#include <vector>
+
+class Actor;
+
+//! The distances to a target actor from the cells of the area around it.
+//! Actors pursuing the same target share one field and walk downhill,
+//! instead of each searching a path of their own.
+//! Only cells at the target's height are in the field, so actors on
+//! stairs or ledges have to fall back to the Pathfinder.
+class FlowField
+{
+public:
+	FlowField();
+
+	//! Get the field leading to target. It is computed if there is none,
+	//! it is older than a few frames or the target left its cell.
+	static const FlowField* get(Actor* target);
+
+	//! Get the direction to step in from (x,y,z) to get closer to the
+	//! target, or -1 if the field can't lead there from that point
+	int getDirection(sint32 x, sint32 y, sint32 z) const;
+
+private:
+	void compute(Actor* target);
+
+	//! get the cell of a world point, or -1 if it is outside the field
+	int getCell(sint32 x, sint32 y) const;
+
+	//! true if a step from cell by (dx,dy) stays in the field and does
+	//! not cut a blocked corner
+	bool canStep(int cell, int dx, int dy) const;
+
+	uint32 mapnum;
+	uint32 framenum;		//!< when the field was computed
+	sint32 basex, basey;	//!< world coordinates of cell (0,0)
+	sint32 z;
+	int targetcell;
+
+	//! distance of each cell to the target cell, UNREACHABLE if blocked
+	std::vector<uint16> distance;
+
+	static std::map<ObjId, FlowField> fields;
+};
+
+#endif
@@ -45,6 +45,14 @@ struct PathNode
 // NOTE: this is just to keep some statistics
 static unsigned int expandednodes = 0;
 
+// alreadyVisited() range, and the size of the cubes visited points are
+// hashed by
+static const int VISITED_RANGE = 8;
+static const unsigned int VISITED_BUCKETS = 1024;
+
+static const unsigned int NODELIMIT_MIN = 30;	//! constant
+static const unsigned int NODELIMIT_MAX = 200;	//! constant
+
 void PathfindingState::load(Actor* actor)
 {
 	actor->getLocation(x, y, z);
@@ -117,6 +125,7 @@ bool PathNodeCmp::operator()(PathNode* n1, PathNode* n2)
 }
 
 Pathfinder::Pathfinder()
+	: expandtime(0), searchnodes(0), visited(VISITED_BUCKETS)
 {
 	expandednodes = 0;
 }
@@ -127,12 +136,6 @@ Pathfinder::~Pathfinder()
 	pout << "~Pathfinder: " << nodelist.size() << " nodes, "
 		 << expandednodes << " expanded nodes in " << expandtime << "ms." << std::endl;
 #endif
-
-	// clean up nodes
-	std::list<PathNode*>::iterator iter;
-	for (iter = nodelist.begin(); iter != nodelist.end(); ++iter)
-		delete *iter;
-	nodelist.clear();
 }
 
 void Pathfinder::init(Actor* actor_, PathfindingState* state)
@@ -181,17 +184,57 @@ bool Pathfinder::canReach()
 	return pathfind(path);
 }
 
+unsigned int Pathfinder::visitedBucket(sint32 cx, sint32 cy, sint32 cz)
+{
+	uint32 h = static_cast<uint32>(cx) * 73856093U;
+	h ^= static_cast<uint32>(cy) * 19349663U;
+	h ^= static_cast<uint32>(cz) * 83492791U;
+	return h % VISITED_BUCKETS;
+}
+
 bool Pathfinder::alreadyVisited(sint32 x, sint32 y, sint32 z)
 {
-	//! this may need optimization
+	// floor division, so negative coordinates get their own cubes too
+	sint32 cx = (x >= 0 ? x : x - (VISITED_RANGE - 1)) / VISITED_RANGE;
+	sint32 cy = (y >= 0 ? y : y - (VISITED_RANGE - 1)) / VISITED_RANGE;
+	sint32 cz = (z >= 0 ? z : z - (VISITED_RANGE - 1)) / VISITED_RANGE;
+
+	for (sint32 i = cx - 1; i <= cx + 1; ++i) {
+		for (sint32 j = cy - 1; j <= cy + 1; ++j) {
+			for (sint32 k = cz - 1; k <= cz + 1; ++k) {
+				const std::vector<VisitedPoint>& bucket =
+					visited[visitedBucket(i, j, k)];
+				for (unsigned int n = 0; n < bucket.size(); ++n) {
+					const VisitedPoint& p = bucket[n];
+					int distance = (p.x - x) * (p.x - x) +
+						(p.y - y) * (p.y - y) + (p.z - z) * (p.z - z);
+					if (distance < VISITED_RANGE * VISITED_RANGE)
+						return true;
+				}
+			}
+		}
+	}
 
-	std::list<PathfindingState>::iterator iter;
+	return false;
+}
 
-	for (iter = visited.begin(); iter != visited.end(); ++iter)
-		if (iter->checkPoint(x,y,z,8))
-			return true;
+void Pathfinder::addVisited(const PathfindingState& state)
+{
+	sint32 cx = (state.x >= 0 ? state.x : state.x - (VISITED_RANGE - 1))
+		/ VISITED_RANGE;
+	sint32 cy = (state.y >= 0 ? state.y : state.y - (VISITED_RANGE - 1))
+		/ VISITED_RANGE;
+	sint32 cz = (state.z >= 0 ? state.z : state.z - (VISITED_RANGE - 1))
+		/ VISITED_RANGE;
+
+	VisitedPoint p = { state.x, state.y, state.z };
+	visited[visitedBucket(cx, cy, cz)].push_back(p);
+}
 
-	return false;
+PathNode* Pathfinder::allocNode()
+{
+	nodelist.push_back(PathNode());
+	return &nodelist.back();
 }
 
 bool Pathfinder::checkTarget(PathNode* node)
@@ -371,8 +414,7 @@ static void drawpath(PathNode* to, uint32 rgb, bool done)
 void Pathfinder::newNode(PathNode* oldnode, PathfindingState& state,
 						 unsigned int steps)
 {
-	PathNode* newnode = new PathNode();
-	nodelist.push_back(newnode); // for garbage collection
+	PathNode* newnode = allocNode();
 	newnode->state = state;
 	newnode->parent = oldnode;
 	newnode->depth = oldnode->depth + 1;
@@ -504,14 +546,14 @@ void Pathfinder::expandNode(PathNode* node)
 			tracker.updateState(state);
 			if (!alreadyVisited(state.x, state.y, state.z)) {
 				newNode(node, state, 0);
-				visited.push_back(state);
+				addVisited(state);
 			}
 		}
 		else
 		{
 			// an obstruction was encountered, so generate a visited node to block
 			// future evaluation at the endpoint.
-			visited.push_back(state);
+			addVisited(state);
 		}
 
 		// TODO: maybe only allow partial steps close to target?
@@ -519,12 +561,29 @@ void Pathfinder::expandNode(PathNode* node)
 							   (!tracker.isDone() && targetitem)))
 		{
 			newNode(node, closeststate, beststeps);
-			visited.push_back(closeststate);
+			addVisited(closeststate);
 		}
 	}
 }
 
 bool Pathfinder::pathfind(std::vector<PathfindingAction>& path)
+{
+	beginSearch();
+
+	SearchResult result = continueSearch(NODELIMIT_MAX, path);
+
+#if 0
+	static sint32 pfcalls = 0;
+	static sint32 pftotaltime = 0;
+	pfcalls++;
+	pftotaltime += expandtime;
+	pout << "maxout average = " << (pftotaltime / pfcalls) << "ms." << std::endl;
+#endif
+
+	return result == SEARCH_FOUND;
+}
+
+void Pathfinder::beginSearch()
 {
 #if 0
 	pout << "Actor " << actor->getObjId();
@@ -549,25 +608,42 @@ bool Pathfinder::pathfind(std::vector<PathfindingAction>& path)
 	}
 #endif
 
-
-	path.clear();
-
-	PathNode* startnode = new PathNode();
+	PathNode* startnode = allocNode();
 	startnode->state = start;
 	startnode->cost = 0;
 	startnode->parent = 0;
 	startnode->depth = 0;
 	startnode->stepsfromparent = 0;
-	nodelist.push_back(startnode);
 	nodes.push(startnode);
 
-	unsigned int expandednodes = 0;
-	const unsigned int NODELIMIT_MIN = 30;	//! constant
-	const unsigned int NODELIMIT_MAX = 200;	//! constant
-	bool found = false;
+	searchnodes = 0;
+	expandtime = 0;
+}
+
+Pathfinder::SearchResult Pathfinder::continueSearch(unsigned int maxnodes,
+									std::vector<PathfindingAction>& path)
+{
+	path.clear();
+
+	unsigned int expanded = 0;
 	Uint32 starttime = SDL_GetTicks();
 
-	while (expandednodes < NODELIMIT_MAX && !nodes.empty() && !found) {
+	while (expanded < maxnodes) {
+		if (searchnodes >= NODELIMIT_MAX || nodes.empty())
+			break;
+
+		// the time limit covers all slices of the search, so a sliced
+		// search gives up at the same point as a whole one
+		if (searchnodes >= NODELIMIT_MIN && (searchnodes % 5) == 0 &&
+			!GUIApp::get_instance()->isHeadless())
+		{
+			// no time limit in headless mode, the search has to be
+			// reproducible
+			Uint32 elapsed_ms = expandtime + SDL_GetTicks() - starttime;
+			if (elapsed_ms > 350)
+				break;
+		}
+
 		PathNode* node = nodes.top(); nodes.pop();
 
 #if 0
@@ -578,75 +654,70 @@ bool Pathfinder::pathfind(std::vector<PathfindingAction>& path)
 
 		if (checkTarget(node)) {
 			// done!
+			buildPath(node, path);
+			expandtime += SDL_GetTicks() - starttime;
+			return SEARCH_FOUND;
+		}
 
-			// find path length
-			PathNode* n = node;
-			unsigned int length = 0;
-			while (n->parent) {
-				n = n->parent;
-				length++;
-			}
-#if 0
-			pout << "Pathfinder: path found (length = " << length << ")"
-				 << std::endl;
-#endif
-
-			unsigned int i = length;
-			if (length > 0) length++; // add space for final 'stand' action
-			path.resize(length);
-
-			// now backtrack through the nodes to assemble the final animation
-			while (node->parent) {
-				PathfindingAction action;
-				action.action = node->state.lastanim;
-				action.direction = node->state.direction;
-				action.steps = node->stepsfromparent;
-				path[--i] = action;
-#if 0
-				pout << "anim = " << node->state.lastanim << ", dir = "
-					 << node->state.direction << ", steps = "
-					 << node->stepsfromparent << std::endl;
-#endif
-
-				//TODO: check how turns work
-				//TODO: append final 'stand' animation
-
-				node = node->parent;
-			}
+		expandNode(node);
+		expanded++;
+		searchnodes++;
+	}
 
-			if (length) {
-				if (node->state.combat)
-					path[length-1].action = Animation::combatStand;
-				else
-					path[length-1].action = Animation::stand;
-				path[length-1].direction = path[length-2].direction;
-			}
+	expandtime += SDL_GetTicks() - starttime;
 
-			expandtime = SDL_GetTicks() - starttime;
-			return true;
-		}
+	if (expanded == maxnodes && searchnodes < NODELIMIT_MAX &&
+		!nodes.empty())
+		return SEARCH_PENDING;
 
-		expandNode(node);
-		expandednodes++;
+	return SEARCH_FAILED;
+}
 
-		if(expandednodes >= NODELIMIT_MIN && ((expandednodes) % 5) == 0)
-		{
-			Uint32 elapsed_ms = SDL_GetTicks() - starttime;
-			if(elapsed_ms > 350) break;
-		}
+void Pathfinder::buildPath(PathNode* node,
+						   std::vector<PathfindingAction>& path)
+{
+	// find path length
+	PathNode* n = node;
+	unsigned int length = 0;
+	while (n->parent) {
+		n = n->parent;
+		length++;
 	}
+#if 0
+	pout << "Pathfinder: path found (length = " << length << ")"
+		 << std::endl;
+#endif
 
-	expandtime = SDL_GetTicks() - starttime;
-
+	unsigned int i = length;
+	if (length > 0) length++; // add space for final 'stand' action
+	path.resize(length);
+
+	// now backtrack through the nodes to assemble the final animation
+	while (node->parent) {
+		PathfindingAction action;
+		action.action = node->state.lastanim;
+		action.direction = node->state.direction;
+		action.steps = node->stepsfromparent;
+		path[--i] = action;
 #if 0
-	static sint32 pfcalls = 0;
-	static sint32 pftotaltime = 0;
-	pfcalls++;
-	pftotaltime += expandtime;
-	pout << "maxout average = " << (pftotaltime / pfcalls) << "ms." << std::endl;
+		pout << "anim = " << node->state.lastanim << ", dir = "
+			 << node->state.direction << ", steps = "
+			 << node->stepsfromparent << std::endl;
 #endif
 
-	return false;
+		//TODO: check how turns work
+		//TODO: append final 'stand' animation
+
+		node = node->parent;
+	}
+
+	if (length) {
+		if (node->state.combat)
+			path[length-1].action = Animation::combatStand;
+		else
+			path[length-1].action = Animation::stand;
+		path[length-1].direction = path[length-2].direction;
+	}
 }
 
 
@@ -21,7 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <vector>
 #include <queue>
-#include <list>
+#include <deque>
 #include "Animation.h"
 
 class Actor;
@@ -72,6 +72,22 @@ public:
 	//! pathfind. If true, the found path is returned in path
 	bool pathfind(std::vector<PathfindingAction>& path);
 
+	enum SearchResult {
+		SEARCH_PENDING,
+		SEARCH_FOUND,
+		SEARCH_FAILED
+	};
+
+	//! Start a search that is continued in slices by continueSearch.
+	//! The actor and target item must stay valid until it is done.
+	void beginSearch();
+
+	//! Expand at most maxnodes more nodes of the search.
+	//! \return SEARCH_FOUND if the path was found and returned in path,
+	//!         SEARCH_PENDING if the search needs another slice
+	SearchResult continueSearch(unsigned int maxnodes,
+								std::vector<PathfindingAction>& path);
+
 #ifdef DEBUG
 	//! "visualDebug" console command
 	static void ConCmd_visualDebug(const Console::ArgvType &argv);
@@ -87,18 +103,35 @@ protected:
 	bool hitmode;
 	sint32 expandtime;
 
+	//! nodes expanded so far by the current search
+	unsigned int searchnodes;
+
 	sint32 actor_xd,actor_yd,actor_zd;
 
-	std::list<PathfindingState> visited;
+	//! A visited point. Only the location matters to alreadyVisited.
+	struct VisitedPoint {
+		sint32 x, y, z;
+	};
+
+	//! Visited points, hashed by the 8x8x8 cube they are in. A point
+	//! closer than 8 to another is always in the same or a neighbouring
+	//! cube. Cubes sharing a bucket only cost a few extra checks.
+	std::vector<std::vector<VisitedPoint> > visited;
 	std::priority_queue<PathNode*,std::vector<PathNode*>,PathNodeCmp> nodes;
 
-	std::list<PathNode*> nodelist;
+	//! All nodes of this search. A deque never moves its elements, so
+	//! nodes are allocated in blocks and freed together.
+	std::deque<PathNode> nodelist;
 
+	static unsigned int visitedBucket(sint32 cx, sint32 cy, sint32 cz);
 	bool alreadyVisited(sint32 x, sint32 y, sint32 z);
+	void addVisited(const PathfindingState& state);
+	PathNode* allocNode();
 	void newNode(PathNode* oldnode,PathfindingState& state,unsigned int steps);
 	void expandNode(PathNode* node);
 	unsigned int costHeuristic(PathNode* node);
 	bool checkTarget(PathNode* node);
+	void buildPath(PathNode* node, std::vector<PathfindingAction>& path);
 };
 
 #endif
@@ -21,7 +21,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "Actor.h"
 #include "Pathfinder.h"
+#include "Kernel.h"
 #include "getObject.h"
+#include "ObjectManager.h"
 
 #include "IDataSource.h"
 #include "ODataSource.h"
@@ -29,15 +31,19 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 static const unsigned int PATH_OK = 1;
 static const unsigned int PATH_FAILED = 0;
 
+//! most nodes one process expands in a frame
+static const unsigned int SEARCH_SLICE = 40;
+
 // p_dynamic_cast stuff
 DEFINE_RUNTIME_CLASSTYPE_CODE(PathfinderProcess,Process);
 
-PathfinderProcess::PathfinderProcess() : Process()
+PathfinderProcess::PathfinderProcess() : Process(), pf(0)
 {
 
 }
 
 PathfinderProcess::PathfinderProcess(Actor* actor_, ObjId item_, bool hit)
+	: pf(0)
 {
 	assert(actor_);
 	item_num = actor_->getObjId();
@@ -54,26 +60,11 @@ PathfinderProcess::PathfinderProcess(Actor* actor_, ObjId item_, bool hit)
 	}
 
 	currentstep = 0;
-	targetitem = item_;
+	targetitem = ObjectManager::get_instance()->getHandle(item_);
 	hitmode = hit;
 	assert(targetitem);
 
-	item->getLocation(targetx, targety, targetz);
-
-	Pathfinder pf;
-	pf.init(actor_);
-	pf.setTarget(item, hit);
-
-	bool ok = pf.pathfind(path);
-
-	if (!ok) {
-		perr << "PathfinderProcess: actor " << item_num
-			 << " failed to find path" << std::endl;
-		// can't get there...
-		result = PATH_FAILED;
-		terminateDeferred();
-		return;
-	}
+	startSearch(actor_);
 
 	// TODO: check if flag already set? kill other pathfinders?
 	actor_->setActorFlag(Actor::ACT_PATHFINDING);
@@ -81,6 +72,7 @@ PathfinderProcess::PathfinderProcess(Actor* actor_, ObjId item_, bool hit)
 
 PathfinderProcess::PathfinderProcess(Actor* actor_,
 									 sint32 x, sint32 y, sint32 z)
+	: pf(0)
 {
 	assert(actor_);
 	item_num = actor_->getObjId();
@@ -92,20 +84,7 @@ PathfinderProcess::PathfinderProcess(Actor* actor_,
 
 	currentstep = 0;
 
-	Pathfinder pf;
-	pf.init(actor_);
-	pf.setTarget(targetx, targety, targetz);
-
-	bool ok = pf.pathfind(path);
-
-	if (!ok) {
-		perr << "PathfinderProcess: actor " << item_num
-			 << " failed to find path" << std::endl;
-		// can't get there...
-		result = PATH_FAILED;
-		terminateDeferred();
-		return;
-	}
+	startSearch(actor_);
 
 	// TODO: check if flag already set? kill other pathfinders?
 	actor_->setActorFlag(Actor::ACT_PATHFINDING);
@@ -113,11 +92,77 @@ PathfinderProcess::PathfinderProcess(Actor* actor_,
 
 PathfinderProcess::~PathfinderProcess()
 {
+	delete pf;
+}
 
+bool PathfinderProcess::startSearch(Actor* actor)
+{
+	delete pf;
+	pf = new Pathfinder();
+	pf->init(actor);
+	if (targetitem) {
+		Item* item = getItemByHandle(targetitem);
+		if (!item) {
+			delete pf;
+			pf = 0;
+			return false;
+		}
+		if (hitmode && !actor->isInCombat()) {
+			// Actor exited combat mode
+			hitmode = false;
+		}
+		pf->setTarget(item, hitmode);
+		item->getLocation(targetx, targety, targetz);
+	} else {
+		pf->setTarget(targetx, targety, targetz);
+	}
+
+	pf->beginSearch();
+	path.clear();
+	currentstep = 0;
+	return true;
+}
+
+bool PathfinderProcess::continueSearch()
+{
+	// the pathfinder keeps pointers to both, so make sure they are still
+	// around before giving it another slice
+	if (!getActor(item_num) || (targetitem && !getItemByHandle(targetitem))) {
+		perr << "PathfinderProcess: target missing" << std::endl;
+		result = PATH_FAILED;
+		terminate();
+		return false;
+	}
+
+	unsigned int nodes = Kernel::get_instance()->takePathfindNodes(
+		SEARCH_SLICE);
+	if (nodes == 0)
+		return false; // out of budget, try again next frame
+
+	Pathfinder::SearchResult res = pf->continueSearch(nodes, path);
+	if (res == Pathfinder::SEARCH_PENDING)
+		return false;
+
+	delete pf;
+	pf = 0;
+
+	if (res == Pathfinder::SEARCH_FAILED) {
+		perr << "PathfinderProcess: actor " << item_num
+			 << " failed to find path" << std::endl;
+		// can't get there
+		result = PATH_FAILED;
+		terminate();
+		return false;
+	}
+
+	return true;
 }
 
 void PathfinderProcess::terminate()
 {
+	delete pf;
+	pf = 0;
+
 	Actor* actor = getActor(item_num);
 	if (actor) {
 		// TODO: only clear if it was set by us?
@@ -136,96 +181,87 @@ void PathfinderProcess::run()
 	if (!(actor->getFlags() & Item::FLG_FASTAREA)) return;
 
 
-	bool ok = true;
+	// if actor is still animating for whatever reason, wait until he stopped
+	// before starting a search, since the running animation may move the
+	// actor, which could break the found path.
+	if (actor->getActorFlags() & Actor::ACT_ANIMLOCK) {
+		perr << "PathfinderProcess: ANIMLOCK, waiting" << std::endl;
+		return;
+	}
 
-	if (targetitem) {
-		sint32 curx,cury,curz;
-		Item* item = getItem(targetitem);
-		if (!item) {
+	if (!pf && path.empty()) {
+		// loaded while searching, so start over
+		if (!startSearch(actor)) {
 			perr << "PathfinderProcess: target missing" << std::endl;
 			result = PATH_FAILED;
 			terminate();
 			return;
 		}
+	} else if (!pf) {
+		bool ok = true;
+
+		if (targetitem) {
+			sint32 curx,cury,curz;
+			Item* item = getItemByHandle(targetitem);
+			if (!item) {
+				perr << "PathfinderProcess: target missing" << std::endl;
+				result = PATH_FAILED;
+				terminate();
+				return;
+			}
 
-		item->getLocation(curx, cury, curz);
-		if (abs(curx - targetx) >= 32 || abs(cury - targety) >= 32 ||
-			abs(curz - targetz) >= 8)
-		{
-			// target moved
-			ok = false;
+			item->getLocation(curx, cury, curz);
+			if (abs(curx - targetx) >= 32 || abs(cury - targety) >= 32 ||
+				abs(curz - targetz) >= 8)
+			{
+				// target moved
+				ok = false;
+			}
 		}
-	}
 
-	if (ok && currentstep >= path.size()) {
-		// done
+		if (ok && currentstep >= path.size()) {
+			// done
 #if 0
-		pout << "PathfinderProcess: done" << std::endl;
+			pout << "PathfinderProcess: done" << std::endl;
 #endif
-		result = PATH_OK;
-		terminate();
-		return;
-	}
+			result = PATH_OK;
+			terminate();
+			return;
+		}
 
-	// try to take the next step
+		// try to take the next step
 
 #if 0
-	pout << "PathfinderProcess: trying step" << std::endl;
+		pout << "PathfinderProcess: trying step" << std::endl;
 #endif
 
-	// if actor is still animating for whatever reason, wait until he stopped
-	// FIXME: this should happen before the pathfinder is actually called,
-	// since the running animation may move the actor, which could break
-	// the found path.
-	if (actor->getActorFlags() & Actor::ACT_ANIMLOCK) {
-		perr << "PathfinderProcess: ANIMLOCK, waiting" << std::endl;
-		return;
-	}
-
-	if (ok) {
-		ok = actor->tryAnim(path[currentstep].action,
-							path[currentstep].direction,
-							path[currentstep].steps) == Animation::SUCCESS;
-	}
+		if (ok) {
+			ok = actor->tryAnim(path[currentstep].action,
+								path[currentstep].direction,
+								path[currentstep].steps) == Animation::SUCCESS;
+		}
 
-	if (!ok) {
+		if (!ok) {
 #if 0
-		pout << "PathfinderProcess: recalculating path" << std::endl;
+			pout << "PathfinderProcess: recalculating path" << std::endl;
 #endif
 
-		// need to redetermine path
-		ok = true;
-		Pathfinder pf;
-		pf.init(actor);
-		if (targetitem) {
-			Item* item = getItem(targetitem);
-			if (!item)
-				ok = false;
-			else {
-				if(hitmode && !actor->isInCombat()) {
-					// Actor exited combat mode
-					hitmode = false;
-				}
-				pf.setTarget(item, hitmode);
-				item->getLocation(targetx, targety, targetz);
+			// need to redetermine path
+			if (!startSearch(actor)) {
+				perr << "PathfinderProcess: actor " << item_num
+					 << " failed to find path" << std::endl;
+				// can't get there anymore
+				result = PATH_FAILED;
+				terminate();
+				return;
 			}
-		} else {
-			pf.setTarget(targetx, targety, targetz);
-		}
-		if (ok)
-			ok = pf.pathfind(path);
-
-		currentstep = 0;
-		if (!ok) {
-			perr << "PathfinderProcess: actor " << item_num
-				 << " failed to find path" << std::endl;
-			// can't get there anymore
-			result = PATH_FAILED;
-			terminate();
-			return;
 		}
 	}
 
+	// searches are spread over several frames, see Kernel::takePathfindNodes
+	if (pf && !continueSearch())
+		return;
+
 	if (currentstep >= path.size()) {
 #if 0
 		pout << "PathfinderProcess: done" << std::endl;
@@ -253,7 +289,7 @@ void PathfinderProcess::saveData(ODataSource* ods)
 {
 	Process::saveData(ods);
 
-	ods->write2(targetitem);
+	ods->write2(ObjectManager::getHandleObjId(targetitem));
 	ods->write2(static_cast<uint16>(targetx));
 	ods->write2(static_cast<uint16>(targety));
 	ods->write2(static_cast<uint16>(targetz));
@@ -271,7 +307,7 @@ bool PathfinderProcess::loadData(IDataSource* ids, uint32 version)
 {
 	if (!Process::loadData(ids, version)) return false;
 
-	targetitem = ids->read2();
+	targetitem = ObjectManager::get_instance()->getLoadHandle(ids->read2());
 	targetx = ids->read2();
 	targety = ids->read2();
 	targetz = ids->read2();
@@ -44,12 +44,25 @@ public:
 protected:
 	virtual void saveData(ODataSource* ods);
 
+	//! start searching for a path to the target
+	//! \return false if the target is gone
+	bool startSearch(Actor* actor);
+
+	//! continue the search with as many nodes as the kernel's pathfinding
+	//! budget allows this frame. Fails the process if no path was found.
+	//! \return true if the path was found
+	bool continueSearch();
+
 	sint32 targetx, targety, targetz;
-	ObjId targetitem;
+	ObjHandle targetitem;
 	bool hitmode;
 
 	std::vector<PathfindingAction> path;
 	unsigned int currentstep;
+
+	//! the search in progress, or 0. Searches are not saved: a process
+	//! loaded without a path starts a new one.
+	Pathfinder* pf;
 };
 
 
@@ -54,3 +54,13 @@ Gump* getGump(ObjId id)
 {
 	return p_dynamic_cast<Gump*>(ObjectManager::get_instance()->getObject(id));
 }
+
+Item* getItemByHandle(ObjHandle handle)
+{
+	return p_dynamic_cast<Item*>(ObjectManager::get_instance()->getObjectByHandle(handle));
+}
+
+Actor* getActorByHandle(ObjHandle handle)
+{
+	return p_dynamic_cast<Actor*>(ObjectManager::get_instance()->getObjectByHandle(handle));
+}
@@ -37,4 +37,9 @@ MainActor* getMainActor();
 
 Gump* getGump(ObjId id);
 
+// the same by ObjHandle: 0 if the object has been destroyed since
+
+Item* getItemByHandle(ObjHandle handle);
+Actor* getActorByHandle(ObjHandle handle);
+
 #endif
@@ -10,6 +10,7 @@
  */
 
 #include <SDL3/SDL.h>
+#include "gamemanifest.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -26,6 +27,7 @@ struct GameInfo {
     std::string executable;
     std::string dataPath;
     bool available;
+    std::string manifest;   // Saved manifest of dataPath, if any
 };
 
 class UltimaLauncher {
@@ -45,6 +47,7 @@ private:
     bool running = true;
     
     void detectGames();
+    void indexGame(GameInfo& game);
     void render();
     void handleEvents();
     void launchGame(const GameInfo& game);
@@ -64,7 +67,8 @@ UltimaLauncher::UltimaLauncher() {
             "exult",
             "exult",
             "ultima7",
-            false
+            false,
+            ""
         },
         {
             "u7si",
@@ -73,7 +77,8 @@ UltimaLauncher::UltimaLauncher() {
             "exult",
             "exult",
             "serpentisle",
-            false
+            false,
+            ""
         },
         {
             "u8",
@@ -82,7 +87,8 @@ UltimaLauncher::UltimaLauncher() {
             "scummvm",
             "scummvm --path=",
             "ultima8",
-            false
+            false,
+            ""
         }
     };
 }
@@ -137,12 +143,33 @@ void UltimaLauncher::detectGames() {
                 game.available = true;
                 game.dataPath = gamePath.string();
                 std::cout << "Found " << game.name << " at " << gamePath << std::endl;
+                indexGame(game);
                 break;
             }
         }
     }
 }
 
+void UltimaLauncher::indexGame(GameInfo& game) {
+    // Reuse the saved manifest while nothing was added or removed
+    const std::string cache = Game_manifest::cache_file(game.id);
+    const std::string root =
+        fs::absolute(game.dataPath).lexically_normal().generic_string();
+    Game_manifest manifest;
+    if (manifest.read(cache) && manifest.get_root() == root &&
+        manifest.is_current()) {
+        game.manifest = cache;
+        return;
+    }
+    if (!manifest.build(game.dataPath, game.id) || !manifest.write(cache)) {
+        std::cerr << "Couldn't index " << game.dataPath << std::endl;
+        return;
+    }
+    std::cout << "Indexed " << manifest.get_files().size() << " files of "
+              << game.name << std::endl;
+    game.manifest = cache;
+}
+
 void UltimaLauncher::render() {
     // Clear screen with dark blue background
     SDL_SetRenderDrawColor(renderer, 20, 20, 60, 255);
@@ -248,6 +275,13 @@ void UltimaLauncher::launchGame(const GameInfo& game) {
     }
     
     std::cout << "Launching: " << command << std::endl;
+
+    // The engine picks up what we know of its data from here
+    if (!game.manifest.empty()) {
+        SDL_setenv_unsafe("ULTIMA_GAME_MANIFEST", game.manifest.c_str(), 1);
+    } else {
+        SDL_unsetenv_unsafe("ULTIMA_GAME_MANIFEST");
+    }
     
     // Hide launcher window
     SDL_HideWindow(window);
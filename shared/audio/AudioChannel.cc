@@ -37,7 +37,22 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #	endif    // __GNUC__
 #endif
 
+#include <array>
+#include <cmath>
 #include <cstring>
+#include <memory>
+
+// Same SIMD selection as AudioMixer.cc, here for the sinc filter.
+#ifndef AUDIOMIXER_NO_SIMD
+#	if defined(__SSE2__) || defined(_M_X64) \
+			|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define AUDIOMIXER_USE_SSE2
+#		include <emmintrin.h>
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#		define AUDIOMIXER_USE_NEON
+#		include <arm_neon.h>
+#	endif
+#endif
 
 namespace Pentagram {
 
@@ -58,6 +73,134 @@ namespace Pentagram {
 // floating point, we approximate that by 27/32
 #define RANGE_REDUX(x) (((x) * 27) >> 5)
 
+	//
+	// Windowed sinc filters
+	//
+
+	// The filter for a fractional position is picked from SINC_PHASES
+	// precomputed ones, by the top bits of the 16.16 position.
+	constexpr int SINC_PHASE_BITS = 8;
+	constexpr int SINC_PHASES     = 1 << SINC_PHASE_BITS;
+	constexpr int SINC_TAPS       = AudioChannel::SINC_TAPS;
+	constexpr int SINC_SHIFT      = 14;    // Taps are 2.14 fixed point.
+
+	// Kaiser windowed sinc low pass filters with one cutoff, one for each
+	// phase.
+	struct Sinc_bank {
+		sint16 taps[SINC_PHASES][SINC_TAPS];
+	};
+
+	// Going up in rate (11025, 22050 or 44100 Hz to 48000 Hz), the filter
+	// only has to cut above the source's Nyquist frequency, so every
+	// ratio below 1 shares the first bank. Going down it has to cut lower,
+	// at the output's Nyquist, so there is a bank for each step of the
+	// source samples per output sample.
+	constexpr std::array<double, 6> sinc_max_speeds{1, 1.25, 1.5, 2, 3, 4};
+
+	static double Bessel_I0(double x) {
+		double sum  = 1;
+		double term = 1;
+		for (int k = 1; k < 32; k++) {
+			term *= (x / (2 * k)) * (x / (2 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	static void Build_sinc_bank(Sinc_bank& bank, double cutoff) {
+		constexpr double pi   = 3.14159265358979323846;
+		constexpr double beta = 7.0;
+		constexpr double half = SINC_TAPS / 2;
+		for (int phase = 0; phase < SINC_PHASES; phase++) {
+			// Tap k is for the source sample k - (half - 1) after the
+			// current one, and the output lies phase / SINC_PHASES past it.
+			double coeffs[SINC_TAPS];
+			double sum = 0;
+			for (int k = 0; k < SINC_TAPS; k++) {
+				const double t = k - (half - 1)
+								 - static_cast<double>(phase) / SINC_PHASES;
+				const double x = pi * cutoff * t;
+				const double sinc
+						= std::abs(x) < 1e-9 ? 1.0 : std::sin(x) / x;
+				const double r = t / half;
+				const double window
+						= r * r >= 1 ? 0.0
+									 : Bessel_I0(beta * std::sqrt(1 - r * r))
+											   / Bessel_I0(beta);
+				coeffs[k] = cutoff * sinc * window;
+				sum += coeffs[k];
+			}
+			// Scale to a gain of exactly 1, putting the rounding left over
+			// on the biggest tap.
+			int total   = 0;
+			int biggest = 0;
+			for (int k = 0; k < SINC_TAPS; k++) {
+				const int tap = static_cast<int>(
+						std::lround(coeffs[k] / sum * (1 << SINC_SHIFT)));
+				bank.taps[phase][k] = static_cast<sint16>(tap);
+				total += tap;
+				if (coeffs[k] > coeffs[biggest]) {
+					biggest = k;
+				}
+			}
+			bank.taps[phase][biggest] = static_cast<sint16>(
+					bank.taps[phase][biggest] + (1 << SINC_SHIFT) - total);
+		}
+	}
+
+	// The bank for a channel reading fp_speed source samples (16.16) per
+	// output sample.
+	static const Sinc_bank& Get_sinc_bank(int fp_speed) {
+		static const auto banks = [] {
+			auto banks_ = std::make_unique<Sinc_bank[]>(sinc_max_speeds.size());
+			for (size_t i = 0; i < sinc_max_speeds.size(); i++) {
+				// A little under Nyquist, as 16 taps can't cut sharply.
+				Build_sinc_bank(banks_[i], 0.92 / sinc_max_speeds[i]);
+			}
+			return banks_;
+		}();
+		size_t i = 0;
+		while (i + 1 < sinc_max_speeds.size()
+			   && fp_speed > sinc_max_speeds[i] * 0x10000) {
+			i++;
+		}
+		return banks[i];
+	}
+
+	// Sum of taps times samples, both SINC_TAPS long, in 2.14 fixed point.
+	static inline int Apply_sinc(const sint16* taps, const sint16* samples) {
+#if defined(AUDIOMIXER_USE_SSE2)
+		static_assert(SINC_TAPS == 16, "The SSE2 filter does 16 taps");
+		auto load = [](const sint16* p) {
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		};
+		__m128i sum = _mm_add_epi32(
+				_mm_madd_epi16(load(taps), load(samples)),
+				_mm_madd_epi16(load(taps + 8), load(samples + 8)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+		return _mm_cvtsi128_si32(sum);
+#elif defined(AUDIOMIXER_USE_NEON)
+		static_assert(SINC_TAPS == 16, "The NEON filter does 16 taps");
+		int32x4_t sum = vmull_s16(vld1_s16(taps), vld1_s16(samples));
+		sum = vmlal_s16(sum, vld1_s16(taps + 4), vld1_s16(samples + 4));
+		sum = vmlal_s16(sum, vld1_s16(taps + 8), vld1_s16(samples + 8));
+		sum = vmlal_s16(sum, vld1_s16(taps + 12), vld1_s16(samples + 12));
+		const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+		return vget_lane_s32(vpadd_s32(half, half), 0);
+#else
+		int sum = 0;
+		for (int k = 0; k < SINC_TAPS; k++) {
+			sum += taps[k] * samples[k];
+		}
+		return sum;
+#endif
+	}
+
+	void AudioChannel::prepareSinc() {
+		Get_sinc_bank(0);
+	}
+
 	AudioChannel::AudioChannel(uint32 sample_rate_, bool stereo_)
 			: sample_rate(sample_rate_), stereo(stereo_) {}
 
@@ -93,7 +236,6 @@ namespace Pentagram {
 				  << sample_->getRate() << " Hz -> " << sample_rate << " Hz"
 				  << std::endl;
 #endif
-		stop();
 		sample = sample_;
 
 		loop             = loop_;
@@ -110,7 +252,6 @@ namespace Pentagram {
 		if (!sample) {
 			return;
 		}
-		sample->IncRef();
 
 		// Lambda to round size up to next multiple of maximum alignment size,
 		// if needed.
@@ -142,7 +283,12 @@ namespace Pentagram {
 		frames[1] = frameptr + frame_size;
 
 		// Init the sample decompressor
-		sample->initDecompressor(decomp);
+		try {
+			sample->initDecompressor(decomp);
+		} catch (...) {
+			sample = nullptr;
+			throw;
+		}
 
 		// Reset counter and stuff
 		frame_evenodd = 0;
@@ -157,7 +303,17 @@ namespace Pentagram {
 		DecompressNextFrame();
 
 		// Setup resampler
-		if (sample->getBits() == 8 && !sample->isStereo()) {
+		if (resampler == AudioResampler::Sinc) {
+			// Silence before the start, then the first half of the taps'
+			// worth of the sample.
+			std::memset(sinc_hist, 0, sizeof(sinc_hist));
+			sinc_pos          = 0;
+			const uint32 step = (sample->getBits() / 8)
+								* (sample->isStereo() ? 2 : 1);
+			for (int i = 0; i <= SINC_TAPS / 2; i++) {
+				feedSinc(i * step);
+			}
+		} else if (sample->getBits() == 8 && !sample->isStereo()) {
 			uint8* src = frames[0];
 			int    a   = *(src + 0);
 			a          = (a | (a << 8)) - 32768;
@@ -170,7 +326,7 @@ namespace Pentagram {
 		}
 	}
 
-	void AudioChannel::resampleAndMix(sint16* stream, uint32 bytes) {
+	void AudioChannel::resampleAndMix(sint32* stream, uint32 samples) {
 		if (!sample || paused) {
 			return;
 		}
@@ -181,46 +337,44 @@ namespace Pentagram {
 		do {
 			int startpos = position;
 
-			// 8 bit resampling
-			if (sample->getBits() == 8) {
+			if (resampler == AudioResampler::Sinc) {
+				resampleFrameSinc(stream, samples);
+			} else if (sample->getBits() == 8) {    // 8 bit resampling
 				if (!sample->isStereo() && stereo) {
 					resampleFrameM8toS(
-							stream, bytes);    // Mono Sample to Stereo Output
+							stream, samples);    // Mono Sample to Stereo Output
 				} else if (!sample->isStereo() && !stereo) {
 					resampleFrameM8toM(
-							stream, bytes);    // Mono Sample to Stereo Output
+							stream, samples);    // Mono Sample to Stereo Output
 				} else if (sample->isStereo() && !stereo) {
 					resampleFrameS8toM(
-							stream, bytes);    // Stereo Sample to Mono Output
+							stream, samples);    // Stereo Sample to Mono Output
 				} else {
 					resampleFrameS8toS(
-							stream, bytes);    // Stereo Sample to Stereo Output
+							stream, samples);    // Stereo Sample to Stereo Output
 				}
 			} else if (sample->getBits() == 16) {
 				if (!sample->isStereo() && stereo) {
 					resampleFrameM16toS(
-							stream, bytes);    // Mono Sample to Stereo Output
+							stream, samples);    // Mono Sample to Stereo Output
 				} else if (!sample->isStereo() && !stereo) {
 					resampleFrameM16toM(
-							stream, bytes);    // Mono Sample to Mono Output
+							stream, samples);    // Mono Sample to Mono Output
 				} else if (sample->isStereo() && !stereo) {
 					resampleFrameS16toM(
-							stream, bytes);    // Stereo Sample to Mono Output
+							stream, samples);    // Stereo Sample to Mono Output
 				} else {
 					resampleFrameS16toS(
-							stream, bytes);    // Stereo Sample to Stereo Output
+							stream, samples);    // Stereo Sample to Stereo Output
 				}
 			}
 			overall_position
 					+= (position - startpos)
 					   / (sample->getBits() / (sample->isStereo() ? 4 : 8));
 			// We ran out of data
-			if (bytes || (position == frame0_size)) {
+			if (samples || (position == frame0_size)) {
 				// No more data
 				if (!frame1_size) {
-					if (sample) {
-						sample->Release();
-					}
 					sample = nullptr;
 					return;
 				}
@@ -235,7 +389,7 @@ namespace Pentagram {
 				DecompressNextFrame();
 			}
 
-		} while (bytes != 0);
+		} while (samples != 0);
 	}
 
 	uint32 AudioChannel::getPlaybackLength() const {
@@ -277,7 +431,7 @@ namespace Pentagram {
 	//
 
 	// Resample a frame of mono 8bit unsigned to Stereo 16bit
-	void AudioChannel::resampleFrameM8toS(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameM8toS(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -315,38 +469,21 @@ namespace Pentagram {
 					// Do the interpolation
 					const int result = interp_l.interpolate(fp_pos);
 
-					int lresult = *(stream + 0) + (result * lvol) / 256;
-					int rresult = *(stream + 1) + (result * rvol) / 256;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (lresult < -32768) {
-						lresult = -32768;
-					} else if (lresult > 32767) {
-						lresult = 32767;
-					}
-
-					if (rresult < -32768) {
-						rresult = -32768;
-					} else if (rresult > 32767) {
-						rresult = 32767;
-					}
-
-					*stream++ = lresult;
-					*stream++ = rresult;
-					bytes -= 4;
+					*stream++ += (result * lvol) / 256;
+					*stream++ += (result * rvol) / 256;
+					samples -= 2;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
 	// Resample a frame of mono 8bit unsigned to Mono 16bit
-	void AudioChannel::resampleFrameM8toM(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameM8toM(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -384,32 +521,20 @@ namespace Pentagram {
 			if (fp_pos < 0x10000) {
 				do {
 					// Do the interpolation
-					int result = (interp_l.interpolate(fp_pos) * volume) / 256;
-
-					result += *stream;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (result < -32768) {
-						result = -32768;
-					} else if (result > 32767) {
-						result = 32767;
-					}
-
-					*stream++ = result;
-					bytes -= 2;
+					*stream++ += (interp_l.interpolate(fp_pos) * volume) / 256;
+					samples--;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
 	// Resample a frame of stereo 8bit unsigned to Mono 16bit
-	void AudioChannel::resampleFrameS8toM(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameS8toM(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -448,34 +573,22 @@ namespace Pentagram {
 			if (fp_pos < 0x10000) {
 				do {
 					// Do the interpolation
-					int result = ((interp_l.interpolate(fp_pos) * lvol
-								   + interp_r.interpolate(fp_pos) * rvol))
+					*stream++ += (interp_l.interpolate(fp_pos) * lvol
+								  + interp_r.interpolate(fp_pos) * rvol)
 								 / 512;
-
-					result += *stream;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (result < -32768) {
-						result = -32768;
-					} else if (result > 32767) {
-						result = 32767;
-					}
-
-					*stream++ = result;
-					bytes -= 2;
+					samples--;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
 	// Resample a frame of stereo 8bit unsigned to Stereo 16bit
-	void AudioChannel::resampleFrameS8toS(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameS8toS(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -514,34 +627,15 @@ namespace Pentagram {
 			if (fp_pos < 0x10000) {
 				do {
 					// Do the interpolation
-					int lresult = *(stream + 0)
-								  + (interp_l.interpolate(fp_pos) * lvol) / 256;
-					int rresult = *(stream + 1)
-								  + (interp_r.interpolate(fp_pos) * rvol) / 256;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (lresult < -32768) {
-						lresult = -32768;
-					} else if (lresult > 32767) {
-						lresult = 32767;
-					}
-
-					if (rresult < -32768) {
-						rresult = -32768;
-					} else if (rresult > 32767) {
-						rresult = 32767;
-					}
-
-					*stream++ = lresult;
-					*stream++ = rresult;
-					bytes -= 4;
+					*stream++ += (interp_l.interpolate(fp_pos) * lvol) / 256;
+					*stream++ += (interp_r.interpolate(fp_pos) * rvol) / 256;
+					samples -= 2;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
@@ -551,7 +645,7 @@ namespace Pentagram {
 	//
 
 	// Resample a frame of mono 16bit unsigned to Stereo 16bit
-	void AudioChannel::resampleFrameM16toS(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameM16toS(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -587,38 +681,21 @@ namespace Pentagram {
 					// Do the interpolation
 					const int result = interp_l.interpolate(fp_pos);
 
-					int lresult = *(stream + 0) + (result * lvol) / 256;
-					int rresult = *(stream + 1) + (result * rvol) / 256;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (lresult < -32768) {
-						lresult = -32768;
-					} else if (lresult > 32767) {
-						lresult = 32767;
-					}
-
-					if (rresult < -32768) {
-						rresult = -32768;
-					} else if (rresult > 32767) {
-						rresult = 32767;
-					}
-
-					*stream++ = lresult;
-					*stream++ = rresult;
-					bytes -= 4;
+					*stream++ += (result * lvol) / 256;
+					*stream++ += (result * rvol) / 256;
+					samples -= 2;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
 	// Resample a frame of mono 16bit unsigned to Mono 16bit
-	void AudioChannel::resampleFrameM16toM(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameM16toM(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -654,32 +731,20 @@ namespace Pentagram {
 			if (fp_pos < 0x10000) {
 				do {
 					// Do the interpolation
-					int result = (interp_l.interpolate(fp_pos) * volume) / 256;
-
-					result += *stream;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (result < -32768) {
-						result = -32768;
-					} else if (result > 32767) {
-						result = 32767;
-					}
-
-					*stream++ = result;
-					bytes -= 2;
+					*stream++ += (interp_l.interpolate(fp_pos) * volume) / 256;
+					samples--;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
 	// Resample a frame of stereo 16bit unsigned to Mono 16bit
-	void AudioChannel::resampleFrameS16toM(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameS16toM(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -718,34 +783,22 @@ namespace Pentagram {
 			if (fp_pos < 0x10000) {
 				do {
 					// Do the interpolation
-					int result = ((interp_l.interpolate(fp_pos) * lvol
-								   + interp_r.interpolate(fp_pos) * rvol))
+					*stream++ += (interp_l.interpolate(fp_pos) * lvol
+								  + interp_r.interpolate(fp_pos) * rvol)
 								 / 512;
-
-					result += *stream;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (result < -32768) {
-						result = -32768;
-					} else if (result > 32767) {
-						result = 32767;
-					}
-
-					*stream++ = result;
-					bytes -= 2;
+					samples--;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
 	// Resample a frame of stereo 16bit unsigned to Stereo 16bit
-	void AudioChannel::resampleFrameS16toS(sint16*& stream, uint32& bytes) {
+	void AudioChannel::resampleFrameS16toS(sint32*& stream, uint32& samples) {
 		uint8* src  = frames[frame_evenodd];
 		uint8* src2 = frames[1 - frame_evenodd];
 
@@ -784,38 +837,104 @@ namespace Pentagram {
 			if (fp_pos < 0x10000) {
 				do {
 					// Do the interpolation
-					int lresult = *(stream + 0)
-								  + (interp_l.interpolate(fp_pos) * lvol) / 256;
-					int rresult = *(stream + 1)
-								  + (interp_r.interpolate(fp_pos) * rvol) / 256;
-
-					// Enforce range in case of an "overshot". Shouldn't happen
-					// since we scale down already, but safe is safe.
-					if (lresult < -32768) {
-						lresult = -32768;
-					} else if (lresult > 32767) {
-						lresult = 32767;
-					}
-
-					if (rresult < -32768) {
-						rresult = -32768;
-					} else if (rresult > 32767) {
-						rresult = 32767;
-					}
-
-					*stream++ = lresult;
-					*stream++ = rresult;
-					bytes -= 4;
+					*stream++ += (interp_l.interpolate(fp_pos) * lvol) / 256;
+					*stream++ += (interp_r.interpolate(fp_pos) * rvol) / 256;
+					samples -= 2;
 					fp_pos += fp_speed;
 
-				} while (fp_pos < 0x10000 && bytes != 0);
+				} while (fp_pos < 0x10000 && samples != 0);
 			}
 
-		} while (bytes != 0 && src != src_end);
+		} while (samples != 0 && src != src_end);
 
 		position = frame0_size - (src_end - src);
 	}
 
+	//
+	// Windowed sinc, any format
+	//
+
+	// Add the source sample at offset bytes into frame 0 to the sinc
+	// filter's input. It may lie in frame 1, or past the end of both.
+	void AudioChannel::feedSinc(uint32 offset) {
+		uint8* src = nullptr;
+		if (offset < frame0_size) {
+			src = frames[frame_evenodd] + offset;
+		} else if (offset - frame0_size < frame1_size) {
+			src = frames[1 - frame_evenodd] + offset - frame0_size;
+		}
+		int left  = 0;
+		int right = 0;
+		if (src && sample->getBits() == 8) {
+			left  = (src[0] | (src[0] << 8)) - 32768;
+			right = sample->isStereo() ? (src[1] | (src[1] << 8)) - 32768
+									   : left;
+		} else if (src) {
+			left  = ReadSample(src);
+			right = sample->isStereo() ? ReadSample(src + 2) : left;
+		}
+		sinc_hist[0][sinc_pos] = sinc_hist[0][sinc_pos + SINC_TAPS]
+				= static_cast<sint16>(left);
+		sinc_hist[1][sinc_pos] = sinc_hist[1][sinc_pos + SINC_TAPS]
+				= static_cast<sint16>(right);
+		sinc_pos = (sinc_pos + 1) % SINC_TAPS;
+	}
+
+	// Resample a frame of any format with the windowed sinc filter
+	void AudioChannel::resampleFrameSinc(sint32*& stream, uint32& samples) {
+		const bool   src_stereo = sample->isStereo();
+		const uint32 step = (sample->getBits() / 8) * (src_stereo ? 2 : 1);
+		// The filter's input runs this far ahead of the current sample.
+		const uint32 ahead = step * (SINC_TAPS / 2);
+
+		int lvol = this->lvol;
+		int rvol = this->rvol;
+
+		calculate2DVolume(lvol, rvol);
+
+		const int        volume = (rvol + lvol) / 2;
+		const Sinc_bank& bank   = Get_sinc_bank(fp_speed);
+
+		do {
+			// Add a new src sample (if required)
+			if (fp_pos >= 0x10000) {
+				position += step;
+				feedSinc(position + ahead);
+				fp_pos -= 0x10000;
+			}
+
+			if (fp_pos < 0x10000) {
+				do {
+					const sint16* taps
+							= bank.taps[fp_pos >> (16 - SINC_PHASE_BITS)];
+					const int left
+							= Apply_sinc(taps, sinc_hist[0] + sinc_pos)
+							  >> SINC_SHIFT;
+					const int right
+							= src_stereo ? Apply_sinc(
+												   taps,
+												   sinc_hist[1] + sinc_pos)
+												   >> SINC_SHIFT
+										 : left;
+					if (stereo) {
+						*stream++ += (left * lvol) / 256;
+						*stream++ += (right * rvol) / 256;
+						samples -= 2;
+					} else if (src_stereo) {
+						*stream++ += (left * lvol + right * rvol) / 512;
+						samples--;
+					} else {
+						*stream++ += (left * volume) / 256;
+						samples--;
+					}
+					fp_pos += fp_speed;
+
+				} while (fp_pos < 0x10000 && samples != 0);
+			}
+
+		} while (samples != 0 && position != frame0_size);
+	}
+
 	void AudioChannel::calculate2DVolume(int& lvol, int& rvol) {
 		if (distance > 255) {
 			lvol = 0;
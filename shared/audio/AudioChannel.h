@@ -24,6 +24,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 namespace Pentagram {
 
+	// How a channel brings its sample to the output rate.
+	enum class AudioResampler {
+		Cubic,    // Cubic interpolation. Cheap, and fine for 11-22 kHz sounds.
+		Sinc      // Windowed sinc. Fewer images and aliases, but costs more.
+	};
+
 	class AudioChannel {
 		// We have:
 		// 1x decompressor size
@@ -62,20 +68,31 @@ namespace Pentagram {
 		AudioChannel& operator=(const AudioChannel&) = delete;
 		AudioChannel& operator=(AudioChannel&&)      = default;
 
-		void stop() {
+		// Stops playing, handing the reference to the sample back to the
+		// caller. Returns nullptr if nothing was playing.
+		AudioSample* stop() {
+			AudioSample* old = sample;
 			if (sample) {
 				if (playdata) {
 					sample->freeDecompressor(decomp);
 				}
-				sample->Release();
 				sample = nullptr;
 			}
+			return old;
 		}
 
+		// The channel takes over the caller's reference to sample, and must
+		// be stopped. If the sample can't be started, the channel is left
+		// stopped, the reference stays with the caller and the exception
+		// is passed on.
 		void playSample(
 				AudioSample* sample, int loop, int priority, bool paused,
 				uint32 pitch_shift, int lvol, int rvol, sint32 instance_id);
-		void resampleAndMix(sint16* stream, uint32 bytes);
+		// Adds samples (not frames) of output to stream, a mixing bus that is
+		// clamped to 16 bits once all the channels are in. Once the sample
+		// runs out the channel stops, leaving the reference to the sample
+		// with whoever started it.
+		void resampleAndMix(sint32* stream, uint32 samples);
 
 		bool isPlaying() const {
 			return sample != nullptr;
@@ -147,6 +164,22 @@ namespace Pentagram {
 			return instance_id;
 		}
 
+		// Takes effect with the next playSample.
+		void setResampler(AudioResampler resampler_) {
+			resampler = resampler_;
+		}
+
+		AudioResampler getResampler() const {
+			return resampler;
+		}
+
+		// Source samples around the output the sinc filter looks at.
+		static constexpr int SINC_TAPS = 16;
+
+		// Builds the sinc filters now, so the audio callback doesn't have to
+		// the first time a channel uses them.
+		static void prepareSinc();
+
 	private:
 		//
 		void DecompressNextFrame();
@@ -235,14 +268,25 @@ namespace Pentagram {
 		int               fp_pos   = 0;
 		int               fp_speed = 0;
 
-		void resampleFrameM8toS(sint16*& stream, uint32& bytes);
-		void resampleFrameM8toM(sint16*& stream, uint32& bytes);
-		void resampleFrameS8toM(sint16*& stream, uint32& bytes);
-		void resampleFrameS8toS(sint16*& stream, uint32& bytes);
-		void resampleFrameM16toS(sint16*& stream, uint32& bytes);
-		void resampleFrameM16toM(sint16*& stream, uint32& bytes);
-		void resampleFrameS16toM(sint16*& stream, uint32& bytes);
-		void resampleFrameS16toS(sint16*& stream, uint32& bytes);
+		AudioResampler resampler = AudioResampler::Cubic;
+
+		// The sinc filter's input: the last SINC_TAPS source samples of each
+		// side, each written twice so the newest SINC_TAPS are always in one
+		// run starting at sinc_pos.
+		sint16 sinc_hist[2][2 * SINC_TAPS]{};
+		int    sinc_pos = 0;
+
+		void feedSinc(uint32 offset);
+		void resampleFrameSinc(sint32*& stream, uint32& samples);
+
+		void resampleFrameM8toS(sint32*& stream, uint32& samples);
+		void resampleFrameM8toM(sint32*& stream, uint32& samples);
+		void resampleFrameS8toM(sint32*& stream, uint32& samples);
+		void resampleFrameS8toS(sint32*& stream, uint32& samples);
+		void resampleFrameM16toS(sint32*& stream, uint32& samples);
+		void resampleFrameM16toM(sint32*& stream, uint32& samples);
+		void resampleFrameS16toM(sint32*& stream, uint32& samples);
+		void resampleFrameS16toS(sint32*& stream, uint32& samples);
 	};
 
 }    // namespace Pentagram
@@ -22,8 +22,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "AudioChannel.h"
 #include "Configuration.h"
+#include "Frame_profiler.h"
 #include "Midi.h"
 #include "MidiDriver.h"
+#include "StreamingAudioSample.h"
 
 #include <algorithm>
 #include <iostream>
@@ -45,6 +47,18 @@ static const SDL_AudioDeviceID EXSDL_AUDIO_DEVICE_DEFAULT_PLAYBACK
 #	pragma GCC diagnostic pop
 #endif    // __GNUC__
 
+// SIMD for the final clamp. AUDIOMIXER_NO_SIMD forces the plain version.
+#ifndef AUDIOMIXER_NO_SIMD
+#	if defined(__SSE2__) || defined(_M_X64) \
+			|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define AUDIOMIXER_USE_SSE2
+#		include <emmintrin.h>
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#		define AUDIOMIXER_USE_NEON
+#		include <arm_neon.h>
+#	endif
+#endif
+
 namespace Pentagram {
 	class SDLAudioDevice {
 	public:
@@ -83,7 +97,8 @@ AudioMixer* AudioMixer::the_audio_mixer = nullptr;
 
 AudioMixer::AudioMixer(int sample_rate_, bool stereo_, int num_channels_)
 		: audio_ok(false), sample_rate(sample_rate_), stereo(stereo_),
-		  midi(nullptr), midi_volume(255), id_counter(0) {
+		  midi(nullptr), midi_volume(255), id_counter(0), commands(256),
+		  finished(256 + num_channels_) {
 	the_audio_mixer = this;
 
 	std::cout << "Creating AudioMixer..." << std::endl;
@@ -135,9 +150,12 @@ AudioMixer::AudioMixer(int sample_rate_, bool stereo_, int num_channels_)
 			stereo      = obtained.channels == 2;
 
 			internal_buffer.resize(samples * 2);
+			mix_buffer.resize(samples * 2);
 			for (int i = 0; i < num_channels_; i++) {
 				channels.emplace_back(sample_rate, stereo);
 			}
+			views.resize(num_channels_);
+			status = std::make_unique<Channel_status[]>(num_channels_);
 		}
 
 		// GO GO GO!
@@ -156,6 +174,20 @@ AudioMixer::~AudioMixer() {
 	}
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
 
+	// The callback is gone, so the channels are ours now. Hand every sample
+	// back so the references are all dropped here.
+	apply_commands();
+	const int count = static_cast<int>(channels.size());
+	for (int i = 0; i < count; i++) {
+		const sint32 id = channels[i].getInstanceId();
+		finish(i, id, channels[i].stop());
+	}
+	collect_finished();
+	for (auto& view : views) {
+		clear_view(view);
+	}
+	trim_decoded(0, 0);
+
 	the_audio_mixer = nullptr;
 }
 
@@ -168,9 +200,12 @@ void AudioMixer::reset() {
 
 	midi->stop_music();
 
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	for (auto& channel : channels) {
-		channel.stop();
+	collect_finished();
+	Channel_command cmd{};
+	cmd.type = Channel_command::Stop_all;
+	post(cmd);
+	for (auto& view : views) {
+		clear_view(view);
 	}
 
 	if (stream) {
@@ -178,6 +213,144 @@ void AudioMixer::reset() {
 	}
 }
 
+/*
+ *  Game thread side.
+ */
+
+void AudioMixer::post(const Channel_command& cmd) {
+	if (commands.push(cmd)) {
+		return;
+	}
+	// The callback isn't keeping up (or the device is paused), so apply
+	// what is queued here, with the callback locked out.
+	const std::lock_guard<SDLAudioDevice> lock(*device);
+	apply_commands();
+	apply(cmd);
+}
+
+void AudioMixer::collect_finished() const {
+	Finished_sample done;
+	while (finished.pop(done)) {
+		Channel_view& view = views[done.channel];
+		if (view.instance_id == done.instance_id) {
+			clear_view(view);
+		}
+		done.sample->Release();
+	}
+}
+
+void AudioMixer::clear_view(Channel_view& view) const {
+	if (view.holds_ref) {
+		view.sample->Release();
+	}
+	view.sample    = nullptr;
+	view.holds_ref = false;
+}
+
+AudioSample* AudioMixer::get_decoded(AudioSample* sample) {
+	if (!decoded_limit || sample->isPCM()) {
+		return nullptr;
+	}
+
+	// Keep track of the last few hundred sounds, decoded or not.
+	constexpr const size_t max_tracked = 256;
+	auto found = decoded_index.find(sample->getSerial());
+	if (found == decoded_index.end()) {
+		trim_decoded(decoded_limit, max_tracked - 1);
+		decoded_lru.push_front(Decoded_sample{sample->getSerial()});
+		decoded_index[sample->getSerial()] = decoded_lru.begin();
+	} else {
+		decoded_lru.splice(decoded_lru.begin(), decoded_lru, found->second);
+	}
+	Decoded_sample& entry = decoded_lru.front();
+	entry.plays++;
+	if (entry.decoded) {
+		decoded_hits++;
+		return entry.decoded;
+	}
+	decoded_misses++;
+	// Only sounds played more than once are worth the memory, and only
+	// short ones: no single copy may take more than an eighth.
+	if (entry.plays < 2 || entry.too_long) {
+		return nullptr;
+	}
+	try {
+		entry.decoded = sample->decodeAll(decoded_limit / 8);
+	} catch (const std::exception& err) {
+		std::cerr << "Couldn't decode sample: " << err.what() << std::endl;
+	}
+	if (!entry.decoded) {
+		entry.too_long = true;
+		return nullptr;
+	}
+	decoded_bytes += entry.decoded->getBufferSize();
+	trim_decoded(decoded_limit, max_tracked);
+	return entry.decoded;
+}
+
+// Drop the least recently played sounds until the copies take at most
+// bytes and at most count sounds are tracked. The most recent one stays
+// unless count is 0.
+void AudioMixer::trim_decoded(uint32 bytes, size_t count) {
+	while (!decoded_lru.empty()
+		   && (decoded_lru.size() > count
+			   || (decoded_bytes > bytes && decoded_lru.size() > 1))) {
+		Decoded_sample& entry = decoded_lru.back();
+		if (entry.decoded) {
+			decoded_bytes -= entry.decoded->getBufferSize();
+			// A channel playing it holds a reference of its own.
+			entry.decoded->Release();
+		}
+		decoded_index.erase(entry.serial);
+		decoded_lru.pop_back();
+	}
+}
+
+void AudioMixer::setDecodedCacheLimit(uint32 bytes) {
+	decoded_limit = bytes;
+	trim_decoded(bytes, bytes ? decoded_lru.size() : 0);
+}
+
+void AudioMixer::getDecodedCacheStats(
+		uint32& bytes, int& count, uint32& hits, uint32& misses) const {
+	bytes = decoded_bytes;
+	count = static_cast<int>(std::count_if(
+			decoded_lru.cbegin(), decoded_lru.cend(), [](auto& entry) {
+				return entry.decoded != nullptr;
+			}));
+	hits   = decoded_hits;
+	misses = decoded_misses;
+}
+
+int AudioMixer::find_channel(sint32 instance_id) const {
+	if (instance_id < 0 || channels.empty() || !audio_ok) {
+		return -1;
+	}
+	collect_finished();
+	auto it = std::find_if(
+			views.cbegin(), views.cend(), [instance_id](auto& view) {
+				return view.sample && view.instance_id == instance_id;
+			});
+	return it != views.cend() ? static_cast<int>(it - views.cbegin()) : -1;
+}
+
+void AudioMixer::post_to(
+		sint32 instance_id, Channel_command::Type type, int arg1, int arg2) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
+		return;
+	}
+	Channel_command cmd{};
+	cmd.type        = type;
+	cmd.channel     = chan;
+	cmd.instance_id = instance_id;
+	cmd.loop        = arg1;
+	cmd.paused      = arg1 != 0;
+	cmd.arg1        = arg1;
+	cmd.arg2        = arg2;
+	post(cmd);
+}
+
 sint32 AudioMixer::playSample(
 		AudioSample* sample, int loop, int priority, bool paused,
 		uint32 pitch_shift_, int lvol, int rvol) {
@@ -185,42 +358,76 @@ sint32 AudioMixer::playSample(
 		return -1;
 	}
 
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto it = std::find_if(channels.begin(), channels.end(), [](auto& channel) {
-		return !channel.isPlaying();
+	collect_finished();
+	auto it = std::find_if(views.begin(), views.end(), [](auto& view) {
+		return !view.sample;
 	});
-	if (it == channels.end()) {
+	if (it == views.end()) {
 		it = std::min_element(
-				channels.begin(), channels.end(), [](auto& c1, auto& c2) {
-					return c1.getPriority() < c2.getPriority();
+				views.begin(), views.end(), [](auto& v1, auto& v2) {
+					return v1.priority < v2.priority;
 				});
 	}
-	if (it != channels.end()
-		&& (!it->isPlaying() || it->getPriority() < priority)) {
-		if (id_counter == std::numeric_limits<decltype(id_counter)>::max()) {
-			id_counter = 0;
-		} else {
-			++id_counter;
+	if (it->sample && it->priority >= priority) {
+		return -1;
+	}
+	if (id_counter == std::numeric_limits<decltype(id_counter)>::max()) {
+		id_counter = 0;
+	} else {
+		++id_counter;
+	}
+
+	// Long sounds (music, speech) are decoded ahead on another thread,
+	// short ones may come from a decoded copy.
+	AudioSample* streamed = nullptr;
+	if (sample && stream_ahead && sample->isStreamable()) {
+		try {
+			streamed = new StreamingAudioSample(sample, stream_ahead);
+		} catch (const std::exception& err) {
+			std::cerr << "Couldn't stream sample: " << err.what() << std::endl;
+			return -1;
 		}
-		it->playSample(
-				sample, loop, priority, paused, pitch_shift_, lvol, rvol,
-				id_counter);
-		return id_counter;
 	}
-	return -1;
+	AudioSample* decoded = sample && !streamed ? get_decoded(sample) : nullptr;
+
+	// The reference goes with the command to the channel. While it plays
+	// something else, the view keeps the sample itself alive.
+	AudioSample* play = streamed ? streamed : decoded ? decoded : sample;
+	if (play && !streamed) {
+		play->IncRef();
+	}
+	if (play != sample) {
+		sample->IncRef();
+	}
+	clear_view(*it);
+	*it             = Channel_view();
+	it->instance_id = id_counter;
+	it->sample      = sample;
+	it->holds_ref   = play != sample;
+	it->priority    = priority;
+	it->loop        = loop;
+	it->paused      = paused;
+	it->lvol        = lvol;
+	it->rvol        = rvol;
+
+	Channel_command cmd{};
+	cmd.type        = Channel_command::Play;
+	cmd.channel     = static_cast<int>(it - views.begin());
+	cmd.instance_id = id_counter;
+	cmd.sample      = play;
+	cmd.loop        = loop;
+	cmd.priority    = priority;
+	cmd.paused      = paused;
+	cmd.pitch_shift = pitch_shift_;
+	cmd.arg1        = lvol;
+	cmd.arg2        = rvol;
+	cmd.resampler   = resampler;
+	post(cmd);
+	return id_counter;
 }
 
 bool AudioMixer::isPlaying(sint32 instance_id) const {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
-		return false;
-	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	return it != channels.end() && it->isPlaying();
+	return find_channel(instance_id) >= 0;
 }
 
 bool AudioMixer::isPlaying(AudioSample* sample) const {
@@ -228,12 +435,10 @@ bool AudioMixer::isPlaying(AudioSample* sample) const {
 		return false;
 	}
 
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [sample](auto& channel) {
-                return channel.getSample() == sample;
-            });
-	return it != channels.end();
+	collect_finished();
+	return std::any_of(views.cbegin(), views.cend(), [sample](auto& view) {
+		return view.sample == sample;
+	});
 }
 
 bool AudioMixer::isPlayingVoice() const {
@@ -241,28 +446,19 @@ bool AudioMixer::isPlayingVoice() const {
 		return false;
 	}
 
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [](auto& channel) {
-                return channel.isPlaying()
-                       && channel.getSample()->isVocSample();
-            });
-	return it != channels.end();
+	collect_finished();
+	return std::any_of(views.cbegin(), views.cend(), [](auto& view) {
+		return view.sample && view.sample->isVocSample();
+	});
 }
 
 void AudioMixer::stopSample(sint32 instance_id) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return;
 	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->stop();
-	}
+	post_to(instance_id, Channel_command::Stop);
+	clear_view(views[chan]);
 }
 
 void AudioMixer::stopSample(AudioSample* sample) {
@@ -270,68 +466,52 @@ void AudioMixer::stopSample(AudioSample* sample) {
 		return;
 	}
 
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	for (auto& channel : channels) {
-		if (channel.getSample() == sample) {
-			channel.stop();
+	collect_finished();
+	for (auto& view : views) {
+		if (view.sample == sample) {
+			post_to(view.instance_id, Channel_command::Stop);
+			clear_view(view);
 		}
 	}
 }
 
 sint32 Pentagram::AudioMixer::getLoop(sint32 instance_id) const {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return 0;
 	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	return (it != channels.end()) ? it->getLoop() : 0;
+	// The channel counts down the loops as it plays them.
+	const Channel_status& st = status[chan];
+	if (st.instance_id == instance_id) {
+		const sint32 loop = st.loop;
+		if (st.instance_id == instance_id) {
+			return loop;
+		}
+	}
+	return views[chan].loop;
 }
 
 void Pentagram::AudioMixer::setLoop(sint32 instance_id, sint32 newloop) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return;
 	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->setLoop(newloop);
-	}
+	views[chan].loop = newloop;
+	post_to(instance_id, Channel_command::Set_loop, newloop);
 }
 
 void AudioMixer::setPaused(sint32 instance_id, bool paused) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return;
 	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->setPaused(paused);
-	}
+	views[chan].paused = paused;
+	post_to(instance_id, Channel_command::Set_paused, paused);
 }
 
 bool AudioMixer::isPaused(sint32 instance_id) const {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
-		return false;
-	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	return it != channels.end() && it->isPaused();
+	const int chan = find_channel(instance_id);
+	return chan >= 0 && views[chan].paused;
 }
 
 void AudioMixer::setPausedAll(bool paused) {
@@ -339,106 +519,179 @@ void AudioMixer::setPausedAll(bool paused) {
 		return;
 	}
 
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	for (auto& channel : channels) {
-		channel.setPaused(paused);
-
+	for (auto& view : views) {
+		view.paused = paused;
 	}
+	Channel_command cmd{};
+	cmd.type   = Channel_command::Set_paused_all;
+	cmd.paused = paused;
+	post(cmd);
 	// Forward it to midi too
 	midi->setMidiPausedAll(paused);
 }
 
 void AudioMixer::setVolume(sint32 instance_id, int lvol, int rvol) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return;
 	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->setVolume(lvol, rvol);
-	}
+	views[chan].lvol = lvol;
+	views[chan].rvol = rvol;
+	post_to(instance_id, Channel_command::Set_volume, lvol, rvol);
 }
 
 void AudioMixer::getVolume(sint32 instance_id, int& lvol, int& rvol) const {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
-		return;
-	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->getVolume(lvol, rvol);
+	const int chan = find_channel(instance_id);
+	if (chan >= 0) {
+		lvol = views[chan].lvol;
+		rvol = views[chan].rvol;
 	}
 }
 
 bool AudioMixer::set2DPosition(sint32 instance_id, int distance, int angle) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return false;
 	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->set2DPosition(distance, angle);
-		return it->isPlaying();
-	}
-	return false;
+	views[chan].distance = distance;
+	views[chan].angle    = angle;
+	post_to(instance_id, Channel_command::Set_2d_position, distance, angle);
+	return true;
 }
 
 void AudioMixer::get2DPosition(
 		sint32 instance_id, int& distance, int& angle) const {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
-		return;
-	}
-
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.cbegin(), channels.cend(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		it->get2DPosition(distance, angle);
+	const int chan = find_channel(instance_id);
+	if (chan >= 0) {
+		distance = views[chan].distance;
+		angle    = views[chan].angle;
 	}
 }
 
+// Until the callback has started the sample its length isn't known.
 uint32 Pentagram::AudioMixer::GetPlaybackLength(sint32 instance_id) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return UINT32_MAX;
 	}
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		return it->getPlaybackLength();
+	const Channel_status& st = status[chan];
+	if (st.instance_id == instance_id) {
+		const uint32 length = st.length;
+		if (st.instance_id == instance_id) {
+			return length;
+		}
 	}
 	return UINT32_MAX;
 }
 
 uint32 Pentagram::AudioMixer::GetPlaybackPosition(sint32 instance_id) {
-	if (instance_id < 0 || channels.empty() || !audio_ok) {
+	const int chan = find_channel(instance_id);
+	if (chan < 0) {
 		return UINT32_MAX;
 	}
-	const std::lock_guard<SDLAudioDevice> lock(*device);
-	auto                                  it = std::find_if(
-            channels.begin(), channels.end(), [instance_id](auto& channel) {
-                return channel.getInstanceId() == instance_id;
-            });
-	if (it != channels.end()) {
-		return it->getPlaybackPosition();
+	const Channel_status& st = status[chan];
+	if (st.instance_id == instance_id) {
+		const uint32 position = st.position;
+		if (st.instance_id == instance_id) {
+			return position;
+		}
+	}
+	return 0;
+}
+
+/*
+ *  Audio callback side.
+ */
+
+void AudioMixer::finish(int chan, sint32 instance_id, AudioSample* sample) {
+	// The ring has room for every sample the channels can hold plus every
+	// queued command, so this can't fail. If it somehow did, leaking the
+	// sample beats dropping its reference on this thread.
+	if (sample) {
+		finished.push(Finished_sample{chan, instance_id, sample});
+	}
+}
+
+void AudioMixer::publish(int chan) {
+	const AudioChannel& channel = channels[chan];
+	Channel_status&     st      = status[chan];
+	const sint32        id = channel.isPlaying() ? channel.getInstanceId() : -1;
+	// Readers check the id before and after reading, so it must not show
+	// a new id until the values are that sample's.
+	if (st.instance_id != id) {
+		st.instance_id = -1;
+	}
+	if (id >= 0) {
+		st.loop     = channel.getLoop();
+		st.position = channel.getPlaybackPosition();
+		st.length   = channel.getPlaybackLength();
+	}
+	st.instance_id = id;
+}
+
+void AudioMixer::apply(const Channel_command& cmd) {
+	if (cmd.type == Channel_command::Stop_all
+		|| cmd.type == Channel_command::Set_paused_all) {
+		const int count = static_cast<int>(channels.size());
+	for (int i = 0; i < count; i++) {
+			AudioChannel& channel = channels[i];
+			if (cmd.type == Channel_command::Set_paused_all) {
+				channel.setPaused(cmd.paused);
+			} else {
+				finish(i, channel.getInstanceId(), channel.stop());
+				publish(i);
+			}
+		}
+		return;
+	}
+
+	AudioChannel& channel = channels[cmd.channel];
+	if (cmd.type == Channel_command::Play) {
+		finish(cmd.channel, channel.getInstanceId(), channel.stop());
+		channel.setResampler(cmd.resampler);
+		try {
+			channel.playSample(
+					cmd.sample, cmd.loop, cmd.priority, cmd.paused,
+					cmd.pitch_shift, cmd.arg1, cmd.arg2, cmd.instance_id);
+		} catch (const std::exception& err) {
+			std::cerr << "Couldn't play sample: " << err.what() << std::endl;
+			finish(cmd.channel, cmd.instance_id, cmd.sample);
+		}
+		publish(cmd.channel);
+		return;
+	}
+
+	// The channel may have moved on to another sample since.
+	if (channel.getInstanceId() != cmd.instance_id) {
+		return;
+	}
+	switch (cmd.type) {
+	case Channel_command::Stop:
+		finish(cmd.channel, cmd.instance_id, channel.stop());
+		publish(cmd.channel);
+		break;
+	case Channel_command::Set_loop:
+		channel.setLoop(cmd.loop);
+		break;
+	case Channel_command::Set_paused:
+		channel.setPaused(cmd.paused);
+		break;
+	case Channel_command::Set_volume:
+		channel.setVolume(cmd.arg1, cmd.arg2);
+		break;
+	case Channel_command::Set_2d_position:
+		channel.set2DPosition(cmd.arg1, cmd.arg2);
+		break;
+	default:
+		break;
+	}
+}
+
+void AudioMixer::apply_commands() {
+	Channel_command cmd;
+	while (commands.pop(cmd)) {
+		apply(cmd);
 	}
-	return UINT32_MAX;
 }
 
 void AudioMixer::sdlAudioCallback(
@@ -472,19 +725,102 @@ void AudioMixer::sdlAudioCallback(
 			newlen * 2);    // mixer->internal_buffer.size() * 2); // len);
 }
 
+// Adds the mixed channels in bus to the samples in stream, clamping each
+// sum to 16 bits.
+static void Add_clamped(sint16* stream, const sint32* bus, uint32 samples) {
+	uint32 i = 0;
+#if defined(AUDIOMIXER_USE_SSE2)
+	for (; i + 8 <= samples; i += 8) {
+		const __m128i in
+				= _mm_loadu_si128(reinterpret_cast<const __m128i*>(stream + i));
+		// Sign extend the 16 bit samples to 32 bits.
+		const __m128i lo = _mm_add_epi32(
+				_mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(bus + i)));
+		const __m128i hi = _mm_add_epi32(
+				_mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(bus + i + 4)));
+		_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(stream + i), _mm_packs_epi32(lo, hi));
+	}
+#elif defined(AUDIOMIXER_USE_NEON)
+	for (; i + 8 <= samples; i += 8) {
+		const int16x8_t in = vld1q_s16(stream + i);
+		const int32x4_t lo = vaddw_s16(vld1q_s32(bus + i), vget_low_s16(in));
+		const int32x4_t hi
+				= vaddw_s16(vld1q_s32(bus + i + 4), vget_high_s16(in));
+		vst1q_s16(stream + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+#endif
+	for (; i < samples; i++) {
+		const sint32 sum = stream[i] + bus[i];
+		stream[i]        = static_cast<sint16>(std::clamp(sum, -32768, 32767));
+	}
+}
+
 void AudioMixer::MixAudio(sint16* stream, uint32 bytes) {
 	if (!audio_ok) {
 		return;
 	}
+	PROFILE_ZONE("AudioMixer::MixAudio");
 	std::memset(stream, 0, bytes);
 	if (midi) {
 		midi->produceSamples(stream, bytes);
 	}
-	for (auto& channel : channels) {
+	apply_commands();
+
+	// The channels add up in 32 bits, so they only need clamping once, when
+	// they are added to the MIDI output.
+	const uint32 samples = bytes / 2;
+	if (mix_buffer.size() < samples) {
+		mix_buffer.resize(samples);
+	}
+	bool      mixed = false;
+	const int count = static_cast<int>(channels.size());
+	for (int i = 0; i < count; i++) {
+		AudioChannel& channel = channels[i];
 		if (channel.isPlaying()) {
-			channel.resampleAndMix(stream, bytes);
+			if (!mixed) {
+				std::fill_n(mix_buffer.begin(), samples, 0);
+				mixed = true;
+			}
+			AudioSample* sample = channel.getSample();
+			const sint32 id     = channel.getInstanceId();
+			channel.resampleAndMix(mix_buffer.data(), samples);
+			if (!channel.isPlaying()) {
+				finish(i, id, sample);
+			}
+			publish(i);
 		}
 	}
+	if (mixed) {
+		Add_clamped(stream, mix_buffer.data(), samples);
+	}
+}
+
+void AudioMixer::pauseDevice(bool paused) {
+	if (!device) {
+		return;
+	}
+	if (paused) {
+		device->pause();
+		// Wait out a callback already under way.
+		const std::lock_guard<SDLAudioDevice> lock(*device);
+	} else {
+		device->unpause();
+	}
+}
+
+void AudioMixer::setResampler(AudioResampler resampler_) {
+	// Build the filters here rather than in the first callback using them.
+	if (resampler_ == AudioResampler::Sinc) {
+		AudioChannel::prepareSinc();
+	}
+	resampler = resampler_;
+}
+
+void AudioMixer::setStreamAhead(uint32 ms) {
+	stream_ahead = ms;
 }
 
 void AudioMixer::openMidiOutput() {
@@ -19,9 +19,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef AUDIOMIXER_H_INCLUDED
 #define AUDIOMIXER_H_INCLUDED
 
+#include "AudioChannel.h"
+#include "SPSCQueue.h"
 #include "common_types.h"
 
+#include <atomic>
+#include <list>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class MyMidiPlayer;
@@ -31,10 +36,14 @@ struct SDL_AudioStream;
 #define AUDIO_DEF_PITCH  0x10000
 
 namespace Pentagram {
-	class AudioChannel;
 	class AudioSample;
 	class SDLAudioDevice;
 
+	// The channels belong to the audio callback. The game thread doesn't
+	// touch them: it posts commands the callback applies before it mixes,
+	// and answers queries from what it asked for and what the callback
+	// reports back. All the methods must be called from the one game
+	// thread.
 	class AudioMixer {
 	public:
 		AudioMixer(int sample_rate, bool stereo, int num_channels);
@@ -88,6 +97,33 @@ namespace Pentagram {
 			return stereo;
 		}
 
+		// Used by the samples played from now on.
+		void setResampler(AudioResampler resampler_);
+
+		// Bytes kept for decoded copies of sounds, 0 to not keep any.
+		void setDecodedCacheLimit(uint32 bytes);
+
+		// How much the decoded copies take now, how many there are, and how
+		// often a play found or missed one.
+		void getDecodedCacheStats(
+				uint32& bytes, int& count, uint32& hits, uint32& misses) const;
+
+		// How far ahead long sounds are decoded, 0 to decode them in the
+		// audio callback.
+		void setStreamAhead(uint32 ms);
+
+		AudioResampler getResampler() const {
+			return resampler;
+		}
+
+		// Stop or restart the device calling back. While it is stopped,
+		// tools may call MixAudio themselves, on the game thread.
+		void pauseDevice(bool paused);
+
+		// Mix the next bytes of output into stream. Called by the audio
+		// callback.
+		void MixAudio(sint16* stream, uint32 bytes);
+
 	private:
 		bool                audio_ok;
 		uint32              sample_rate;
@@ -95,10 +131,109 @@ namespace Pentagram {
 		MyMidiPlayer*       midi;
 		int                 midi_volume;
 		std::vector<sint16> internal_buffer;
+		// The channels are summed here without clamping.
+		std::vector<sint32> mix_buffer;
+		AudioResampler      resampler    = AudioResampler::Cubic;
+		uint32              stream_ahead = 0;    // In ms.
 
 		std::vector<AudioChannel> channels;
 		sint32                    id_counter;
 
+		// A change to a channel, from the game thread to the callback.
+		struct Channel_command {
+			enum Type : uint8 {
+				Play,
+				Stop,
+				Stop_all,
+				Set_loop,
+				Set_paused,
+				Set_paused_all,
+				Set_volume,
+				Set_2d_position
+			};
+
+			Type           type;
+			int            channel;
+			sint32         instance_id;
+			AudioSample*   sample;    // Play: the reference the channel takes.
+			int            loop;
+			int            priority;
+			bool           paused;
+			uint32         pitch_shift;
+			int            arg1, arg2;    // Volume or 2D position.
+			AudioResampler resampler;
+		};
+
+		// A sample a channel is done with, from the callback to the game
+		// thread, which drops the reference.
+		struct Finished_sample {
+			int          channel;
+			sint32       instance_id;
+			AudioSample* sample;
+		};
+
+		// The game thread's idea of a channel: what it last asked for,
+		// until the callback says the sample finished.
+		struct Channel_view {
+			sint32       instance_id = -1;
+			AudioSample* sample      = nullptr;
+			// The channel plays a decoded copy or a stream of the sample,
+			// so the view holds the reference to sample.
+			bool         holds_ref   = false;
+			int          priority    = 0;
+			sint32       loop        = 0;
+			bool         paused      = false;
+			int          lvol = 0, rvol = 0;
+			int          distance = 0, angle = 0;
+		};
+
+		// What the callback publishes about a channel after each mix.
+		struct Channel_status {
+			std::atomic<sint32> instance_id{-1};
+			std::atomic<sint32> loop{0};
+			std::atomic<uint32> position{0};    // In ms.
+			std::atomic<uint32> length{0};      // In ms.
+		};
+
+		SPSCQueue<Channel_command>         commands;
+		mutable SPSCQueue<Finished_sample> finished;
+		mutable std::vector<Channel_view>  views;
+		std::unique_ptr<Channel_status[]>  status;
+
+		void post(const Channel_command& cmd);
+		void apply(const Channel_command& cmd);
+		void apply_commands();
+		void finish(int chan, sint32 instance_id, AudioSample* sample);
+		void publish(int chan);
+		void collect_finished() const;
+		void clear_view(Channel_view& view) const;
+		int  find_channel(sint32 instance_id) const;
+		void post_to(
+				sint32 instance_id, Channel_command::Type type, int arg1 = 0,
+				int arg2 = 0);
+
+		// Sounds played again and again (footsteps, hits) are decoded once
+		// on the game thread and played from the copy, which the channel
+		// only has to copy from. Copies are dropped least recently played
+		// first to stay under the limit.
+		struct Decoded_sample {
+			uint32       serial;
+			uint32       plays    = 0;
+			AudioSample* decoded  = nullptr;    // Holds a reference.
+			bool         too_long = false;
+		};
+
+		std::list<Decoded_sample> decoded_lru;    // Most recent first.
+		std::unordered_map<uint32, std::list<Decoded_sample>::iterator>
+				decoded_index;    // By serial.
+		uint32 decoded_limit  = 0;
+		uint32 decoded_bytes  = 0;
+		uint32 decoded_hits   = 0;
+		uint32 decoded_misses = 0;
+
+		AudioSample* get_decoded(AudioSample* sample);
+		void         trim_decoded(uint32 bytes, size_t count);
+
 		std::unique_ptr<SDLAudioDevice> device;
 
 		void        init_midi();
@@ -106,8 +241,6 @@ namespace Pentagram {
 				void* userdata, SDL_AudioStream* stream, int len, int maxlen);
 		SDL_AudioStream* stream;
 
-		void MixAudio(sint16* stream, uint32 bytes);
-
 		static AudioMixer* the_audio_mixer;
 	};
 
@@ -25,13 +25,52 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "VocAudioSample.h"
 #include "WavAudioSample.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
 namespace Pentagram {
 
+	static std::atomic<uint32> next_serial{0};
+
 	AudioSample::AudioSample(std::unique_ptr<uint8[]> buffer_, uint32 size_)
 			: bits(0), frame_size(0), decompressor_size(0),
 			  decompressor_align(0), buffer_limit(size_),
-			  buffer(std::move(buffer_)), refcount(1), sample_rate(0),
-			  stereo(false), length(0) {}
+			  buffer(std::move(buffer_)), refcount(1), serial(next_serial++),
+			  sample_rate(0), stereo(false), length(0) {}
+
+	AudioSample* AudioSample::decodeAll(uint32 max_bytes) const {
+		const size_t align = std::max<size_t>(decompressor_align, 1);
+		size_t       space = decompressor_size + align;
+		auto         decomp_buf = std::make_unique<uint8[]>(space);
+		void*        decomp     = decomp_buf.get();
+		std::align(align, decompressor_size, decomp, space);
+		auto frame = std::make_unique<uint8[]>(frame_size);
+
+		// This sets the rate and channels of some formats.
+		initDecompressor(decomp);
+		std::vector<uint8> pcm;
+		bool               fits = true;
+		while (const uint32 count = decompressFrame(decomp, frame.get())) {
+			if (pcm.size() + count > max_bytes) {
+				fits = false;
+				break;
+			}
+			pcm.insert(pcm.end(), frame.get(), frame.get() + count);
+		}
+		freeDecompressor(decomp);
+		if (!fits || pcm.empty()) {
+			return nullptr;
+		}
+
+		auto data = std::make_unique<uint8[]>(pcm.size());
+		std::memcpy(data.get(), pcm.data(), pcm.size());
+		// Frames come out as unsigned 8 bit or native signed 16 bit.
+		return new RawAudioSample(
+				std::move(data), pcm.size(), sample_rate, bits == 16, stereo,
+				bits);
+	}
 
 	AudioSample* AudioSample::createAudioSample(
 			std::unique_ptr<uint8[]> data, uint32 size) {
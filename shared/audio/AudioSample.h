@@ -39,6 +39,7 @@ namespace Pentagram {
 		std::unique_ptr<uint8[]> buffer;
 
 		uint32 refcount;
+		uint32 serial;
 
 		// these are mutable so the const method initDecompressor can change
 		// them as needed
@@ -75,6 +76,10 @@ namespace Pentagram {
 			return decompressor_align;
 		}
 
+		inline uint32 getBufferSize() const {
+			return buffer_limit;
+		}
+
 		//! get AudioSample length (in samples)
 		inline uint32 getPlaybackLength() const {
 			return length;
@@ -111,6 +116,27 @@ namespace Pentagram {
 			return false;
 		}
 
+		// True if the frames are stored as they are played, so decoding
+		// the whole sample ahead saves nothing.
+		virtual bool isPCM() const {
+			return false;
+		}
+
+		// True if decoding takes long enough that it is better done ahead,
+		// off the audio thread.
+		virtual bool isStreamable() const {
+			return false;
+		}
+
+		// Unlike the address, never shared with a sample deleted earlier.
+		uint32 getSerial() const {
+			return serial;
+		}
+
+		// Decode the whole sample into a new sample playing the same, or
+		// return nullptr if it decodes to more than max_bytes.
+		AudioSample* decodeAll(uint32 max_bytes) const;
+
 		static AudioSample* createAudioSample(
 				std::unique_ptr<uint8[]> data, uint32 size);
 	};
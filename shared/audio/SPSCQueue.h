@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+#ifndef SPSCQUEUE_H_INCLUDED
+#define SPSCQUEUE_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace Pentagram {
+
+	// A fixed size ring passing items from one thread to one other thread
+	// without locking. Only one thread may push and only one may pop, and
+	// neither ever waits: push fails when the ring is full.
+	template <typename T>
+	class SPSCQueue {
+	public:
+		// The ring holds at least min_size items.
+		explicit SPSCQueue(size_t min_size) {
+			size_t size = 2;
+			while (size < min_size) {
+				size <<= 1;
+			}
+			items = std::make_unique<T[]>(size);
+			mask  = size - 1;
+		}
+
+		SPSCQueue(const SPSCQueue&)            = delete;
+		SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+		// Producer side. Returns false, leaving the ring alone, if it is
+		// full.
+		bool push(const T& item) {
+			const size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head.load(std::memory_order_acquire) > mask) {
+				return false;
+			}
+			items[t & mask] = item;
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer side. Returns false if there is nothing to take.
+		bool pop(T& item) {
+			const size_t h = head.load(std::memory_order_relaxed);
+			if (h == tail.load(std::memory_order_acquire)) {
+				return false;
+			}
+			item = items[h & mask];
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Producer side, for runs of items. Returns how many fitted.
+		size_t push(const T* src, size_t count) {
+			const size_t t    = tail.load(std::memory_order_relaxed);
+			const size_t used = t - head.load(std::memory_order_acquire);
+			count             = std::min(count, mask + 1 - used);
+			const size_t first = std::min(count, mask + 1 - (t & mask));
+			std::copy_n(src, first, items.get() + (t & mask));
+			std::copy_n(src + first, count - first, items.get());
+			tail.store(t + count, std::memory_order_release);
+			return count;
+		}
+
+		// Consumer side, for runs of items. Returns how many were taken.
+		size_t pop(T* dst, size_t count) {
+			const size_t h = head.load(std::memory_order_relaxed);
+			count = std::min(count, tail.load(std::memory_order_acquire) - h);
+			const size_t first = std::min(count, mask + 1 - (h & mask));
+			std::copy_n(items.get() + (h & mask), first, dst);
+			std::copy_n(items.get(), count - first, dst + first);
+			head.store(h + count, std::memory_order_release);
+			return count;
+		}
+
+		bool empty() const {
+			return head.load(std::memory_order_acquire)
+				   == tail.load(std::memory_order_acquire);
+		}
+
+		// Items waiting. Exact only on the consumer side, which may find
+		// more than this on the producer side.
+		size_t size() const {
+			return tail.load(std::memory_order_acquire)
+				   - head.load(std::memory_order_acquire);
+		}
+
+		size_t capacity() const {
+			return mask + 1;
+		}
+
+	private:
+		std::unique_ptr<T[]> items;
+		size_t               mask;
+		// Kept apart so the two threads don't share a cache line.
+		alignas(64) std::atomic<size_t> head{0};    // Next to pop.
+		alignas(64) std::atomic<size_t> tail{0};    // Next to push.
+	};
+
+}    // namespace Pentagram
+
+#endif    // SPSCQUEUE_H_INCLUDED
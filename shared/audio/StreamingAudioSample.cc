@@ -0,0 +1,269 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "pent_include.h"
+
+#include "StreamingAudioSample.h"
+
+#include "SPSCQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Pentagram {
+
+	static std::atomic<uint32> underruns{0};
+
+	// The decoded frames of one play, passed to the callback in blocks of
+	// one frame. Blocks go round from empty to filled and back, so nothing
+	// is allocated once playing starts.
+	struct StreamingAudioSample::Stream {
+		struct Block {
+			uint32                   size;    // 0 marks the end of a pass.
+			uint32                   rate;
+			bool                     stereo;
+			std::unique_ptr<uint8[]> data;
+		};
+
+		const AudioSample*       inner;
+		std::unique_ptr<uint8[]> decomp_buf;
+		void*                    decomp;
+		std::vector<Block>       blocks;
+		SPSCQueue<Block*>        filled;    // Decoder to callback.
+		SPSCQueue<Block*>        empty;     // Callback to decoder.
+		bool                     at_start = true;    // Decoder only.
+		std::atomic<bool>        stopped{false};     // Callback is done.
+		std::atomic<bool>        finished{false};    // Nothing more to decode.
+
+		// Throws if inner can't be played.
+		Stream(const AudioSample* inner_, uint32 ahead_ms)
+				: inner(inner_), decomp(start_decoding()),
+				  blocks(block_count(ahead_ms)), filled(blocks.size()),
+				  empty(blocks.size()) {
+			for (auto& block : blocks) {
+				block.data = std::make_unique<uint8[]>(inner->getFrameSize());
+				empty.push(&block);
+			}
+		}
+
+		void* start_decoding() {
+			const size_t align
+					= std::max<size_t>(inner->getDecompressorAlignment(), 1);
+			size_t space = inner->getDecompressorDataSize() + align;
+			decomp_buf   = std::make_unique<uint8[]>(space);
+			void* data   = decomp_buf.get();
+			std::align(align, inner->getDecompressorDataSize(), data, space);
+			// This sets the rate and channels of some formats.
+			inner->initDecompressor(data);
+			return data;
+		}
+
+		// Enough for ahead_ms, plus the one being played.
+		size_t block_count(uint32 ahead_ms) const {
+			const uint64 bytes = uint64(ahead_ms) * inner->getRate()
+								 * (inner->isStereo() ? 2 : 1)
+								 * (inner->getBits() / 8) / 1000;
+			const uint32 frame = inner->getFrameSize();
+			return std::max<size_t>(2, (bytes + frame - 1) / frame + 1);
+		}
+
+		// Decode into the empty blocks. At the end of the sample, mark the
+		// end and go back to the start, so a looping channel goes on
+		// without a gap. Returns false if there was nothing to do.
+		bool fill(size_t max_blocks = SIZE_MAX) {
+			bool   busy = false;
+			Block* block;
+			while (max_blocks-- && !stopped && !finished && empty.pop(block)) {
+				busy = true;
+				block->size
+						= inner->decompressFrame(decomp, block->data.get());
+				block->rate   = inner->getRate();
+				block->stereo = inner->isStereo();
+				if (block->size) {
+					at_start = false;
+				} else if (at_start) {
+					// Nothing even after a rewind.
+					empty.push(block);
+					finished = true;
+					break;
+				} else {
+					inner->rewind(decomp);
+					at_start = true;
+				}
+				filled.push(block);
+			}
+			return busy;
+		}
+	};
+
+	namespace {
+
+		// The one thread decoding all the streams. Streams are added and
+		// removed by the game thread; the callback never waits on it.
+		class Stream_decoder {
+			using Stream = StreamingAudioSample::Stream;
+
+			std::vector<Stream*>    streams;
+			Stream*                 current = nullptr;
+			bool                    quit    = false;
+			std::mutex              mutex;
+			std::condition_variable wake;
+			std::condition_variable idle;
+			std::thread             thread;
+
+			void run() {
+				std::unique_lock<std::mutex> lock(mutex);
+				while (!quit) {
+					bool busy = false;
+					for (size_t i = 0; i < streams.size(); i++) {
+						current = streams[i];
+						lock.unlock();
+						busy |= current->fill();
+						lock.lock();
+						current = nullptr;
+						idle.notify_all();
+					}
+					if (!busy) {
+						// All caught up. A frame lasts 20 ms or more, so
+						// looking again in a few is soon enough.
+						wake.wait_for(lock, std::chrono::milliseconds(5));
+					}
+				}
+			}
+
+		public:
+			Stream_decoder() : thread(&Stream_decoder::run, this) {}
+
+			~Stream_decoder() {
+				{
+					const std::lock_guard<std::mutex> lock(mutex);
+					quit = true;
+				}
+				wake.notify_one();
+				thread.join();
+			}
+
+			void add(Stream* stream) {
+				{
+					const std::lock_guard<std::mutex> lock(mutex);
+					streams.push_back(stream);
+				}
+				wake.notify_one();
+			}
+
+			// Returns once the thread is done with the stream.
+			void remove(Stream* stream) {
+				std::unique_lock<std::mutex> lock(mutex);
+				streams.erase(
+						std::remove(streams.begin(), streams.end(), stream),
+						streams.end());
+				idle.wait(lock, [this, stream]() {
+					return current != stream;
+				});
+			}
+		};
+
+		Stream_decoder& decoder() {
+			static Stream_decoder the_decoder;
+			return the_decoder;
+		}
+
+	}    // namespace
+
+	StreamingAudioSample::StreamingAudioSample(
+			AudioSample* sample, uint32 ahead_ms)
+			: AudioSample(nullptr, 0), inner(sample) {
+		stream             = std::make_unique<Stream>(inner, ahead_ms);
+		inner->IncRef();
+		bits               = inner->getBits();
+		frame_size         = inner->getFrameSize();
+		decompressor_size  = sizeof(Stream*);
+		decompressor_align = alignof(Stream*);
+		sample_rate        = inner->getRate();
+		stereo             = inner->isStereo();
+		length             = inner->getPlaybackLength();
+
+		// Have the start ready before the thread gets to it.
+		stream->fill(2);
+		decoder().add(stream.get());
+	}
+
+	StreamingAudioSample::~StreamingAudioSample() {
+		decoder().remove(stream.get());
+		inner->freeDecompressor(stream->decomp);
+		stream.reset();
+		inner->Release();
+	}
+
+	void StreamingAudioSample::initDecompressor(void* DecompData) const {
+		*static_cast<Stream**>(DecompData) = stream.get();
+	}
+
+	uint32 StreamingAudioSample::decompressFrame(
+			void* DecompData, void* samples) const {
+		Stream* str = *static_cast<Stream**>(DecompData);
+		if (!str) {
+			return 0;
+		}
+		Stream::Block* block;
+		if (!str->filled.pop(block)) {
+			// Check again, it may have just finished.
+			const bool finished = str->finished;
+			if (!str->filled.pop(block)) {
+				if (finished) {
+					return 0;
+				}
+				underruns++;
+				std::memset(samples, bits == 8 ? 0x80 : 0, frame_size);
+				return frame_size;
+			}
+		}
+		const uint32 size = block->size;
+		if (size) {
+			std::memcpy(samples, block->data.get(), size);
+			sample_rate = block->rate;
+			stereo      = block->stereo;
+		}
+		str->empty.push(block);
+		return size;
+	}
+
+	void StreamingAudioSample::freeDecompressor(void* DecompData) const {
+		Stream*& str = *static_cast<Stream**>(DecompData);
+		if (str) {
+			str->stopped = true;
+			str          = nullptr;
+		}
+	}
+
+	void StreamingAudioSample::rewind(void* DecompData) const {
+		ignore_unused_variable_warning(DecompData);
+	}
+
+	uint32 StreamingAudioSample::getUnderruns() {
+		return underruns;
+	}
+
+}    // namespace Pentagram
@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+#ifndef STREAMINGAUDIOSAMPLE_H_INCLUDED
+#define STREAMINGAUDIOSAMPLE_H_INCLUDED
+
+#include "AudioSample.h"
+
+#include <memory>
+
+namespace Pentagram {
+
+	// Plays another sample, decoded ahead on a thread of its own so the
+	// audio callback only copies frames. If the decoder falls behind, the
+	// callback plays silence and counts an underrun rather than waiting.
+	// Each instance plays once, on one channel.
+	class StreamingAudioSample : public AudioSample {
+	public:
+		// Starts decoding sample, keeping ahead_ms of it ready. Holds a
+		// reference to sample until deleted.
+		StreamingAudioSample(AudioSample* sample, uint32 ahead_ms);
+		~StreamingAudioSample() override;
+
+		void   initDecompressor(void* DecompData) const override;
+		uint32 decompressFrame(void* DecompData, void* samples) const override;
+		void   freeDecompressor(void* DecompData) const override;
+		// The decoder goes back to the start by itself.
+		void rewind(void* DecompData) const override;
+
+		// Frames played as silence because they weren't decoded in time.
+		static uint32 getUnderruns();
+
+		struct Stream;
+
+	private:
+		AudioSample*            inner;
+		std::unique_ptr<Stream> stream;
+	};
+
+}    // namespace Pentagram
+
+#endif    // STREAMINGAUDIOSAMPLE_H_INCLUDED
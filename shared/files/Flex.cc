@@ -70,9 +70,28 @@ void Flex_header::write(
 	} else {
 		out->write4(EXULT_FLEX_MAGIC2 + static_cast<uint32>(vers));
 	}
-	for (size_t ii = 0; ii < FLEX_HEADER_PADDING + 2 * count; ii++) {
-		out->write4(0);
+	// Padding, and room for the table.
+	const string zeros(4 * (FLEX_HEADER_PADDING + 2 * count), '\0');
+	out->write(zeros);
+}
+
+/**
+ *  Gets a view of an object's data in place.
+ *  @param objnum   Number of object.
+ *  @return View of the object, or an empty view if the flex isn't in
+ *  memory or on any failure.
+ */
+tcb::span<const unsigned char> Flex::get_object_view(uint32 objnum) const {
+	const auto* view = dynamic_cast<const IBufferDataView*>(data.get());
+	if (!view || objnum >= object_list.size()) {
+		return {};
 	}
+	const Reference& ref = object_list[objnum];
+	if (ref.offset > view->getSize()
+		|| ref.size > view->getSize() - ref.offset) {
+		return {};
+	}
+	return {view->getData() + ref.offset, ref.size};
 }
 
 /**
@@ -113,10 +132,12 @@ void Flex::index_file() {
 
 	// We should already be there.
 	data->seek(start_pos + Flex_header::FLEX_HEADER_LEN);
+	IDataWindow table = data->lockWindow(size_t(hdr.count) * 8);
+	object_list.reserve(table.getSize() / 8);
 	for (uint32 c = 0; c < hdr.count; c++) {
 		Reference f;
-		f.offset = data->read4() + start_pos;
-		f.size   = data->read4();
+		f.offset = table.read4() + start_pos;
+		f.size   = table.read4();
 #if DEBUGFLEX
 		cout << "Item " << c << ": " << f.size << " bytes @ " << f.offset
 			 << endl;
@@ -155,13 +176,32 @@ bool Flex::is_flex(const std::string& fname) {
  *  Start writing out a new Flex file.
  */
 Flex_writer::Flex_writer(
-		OStreamDataSource&     o,        ///< Where to write.
+		ODataSource&           o,        ///< Where to write.
 		const char*            title,    ///< Flex title.
 		size_t                 cnt,      ///< Number of entries we'll write.
 		Flex_header::Flex_vers vers      ///< Version of flex file.
 		)
 		: dout(o), count(cnt), start_pos(dout.getPos()) {
-	// Write out header.
+	start(title, vers);
+}
+
+/**
+ *  Start writing out a new Flex file of our own.
+ *  May throw an exception if the file can't be opened.
+ */
+Flex_writer::Flex_writer(
+		const File_spec&       spec,     ///< File to write.
+		const char*            title,    ///< Flex title.
+		size_t                 cnt,      ///< Number of entries we'll write.
+		Flex_header::Flex_vers vers      ///< Version of flex file.
+		)
+		: file(std::make_unique<OBufferedFileDataSource>(spec)), dout(*file),
+		  count(cnt), start_pos(0) {
+	start(title, vers);
+}
+
+void Flex_writer::start(const char* title, Flex_header::Flex_vers vers) {
+	// Write out header, with room for the table.
 	Flex_header::write(&dout, title, count, vers);
 	// Create table.
 	table     = std::make_unique<uint8[]>(2 * count * 4);
@@ -179,8 +219,10 @@ Flex_writer::~Flex_writer() {
 
 void Flex_writer::flush() {
 	if (table) {
-		dout.seek(Flex_header::FLEX_HEADER_LEN);    // Write table.
+		const size_t end = dout.getPos();
+		dout.seek(start_pos + Flex_header::FLEX_HEADER_LEN);    // Write table.
 		dout.write(table.get(), 2 * count * 4);
+		dout.seek(end);
 		dout.flush();
 		table.reset();
 	}
@@ -24,6 +24,7 @@
 #include "U7file.h"
 #include "common_types.h"
 #include "exceptions.h"
+#include "span.h"
 
 #include <cstring>
 #include <iosfwd>
@@ -101,6 +102,13 @@ public:
 
 	size_t get_entry_info(uint32 objnum, size_t& len);
 
+	/// Gets the data of an object without copying it. This is only
+	/// possible if the whole flex is in memory (mapped or buffered).
+	/// @param objnum   Number of object.
+	/// @return View of the object data, valid while the flex is. Empty
+	/// if the flex isn't in memory, or on any failure.
+	tcb::span<const unsigned char> get_object_view(uint32 objnum) const;
+
 	const char* get_archive_type() override {
 		return "FLEX";
 	}
@@ -120,17 +128,24 @@ using FlexBuffer = U7DataBuffer<Flex>;
  *  This is for writing out a whole Flex file.
  */
 class Flex_writer {
-	OStreamDataSource&       dout;     // Or this, if non-0.
-	const size_t             count;    // # entries.
-	const size_t             start_pos;
+	std::unique_ptr<ODataSource> file;    // If writing a file of our own.
+	ODataSource&                 dout;    // Where to write.
+	const size_t                 count;   // # entries.
+	const size_t                 start_pos;
 	size_t                   cur_start;    // Start of cur. entry being written.
 	std::unique_ptr<uint8[]> table;        // Table of offsets & lengths.
 	uint8*                   tptr;         // ->into table.
-	void finish_object();                  // Finished writing out a section.
+	void start(const char* title, Flex_header::Flex_vers vers);
+	void finish_object();    // Finished writing out a section.
 
 public:
 	Flex_writer(
-			OStreamDataSource& o, const char* title, size_t cnt,
+			ODataSource& o, const char* title, size_t cnt,
+			Flex_header::Flex_vers vers = Flex_header::orig);
+	// Write a file in one pass, through a large buffer; the table is
+	// only written when done.  This is the fastest way to write a big flex.
+	Flex_writer(
+			const File_spec& spec, const char* title, size_t cnt,
 			Flex_header::Flex_vers vers = Flex_header::orig);
 	Flex_writer(const Flex_writer&) noexcept            = delete;
 	Flex_writer& operator=(const Flex_writer&) noexcept = delete;
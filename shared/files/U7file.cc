@@ -19,8 +19,43 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "U7fileman.h"
 #include "U7obj.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
+/**
+ *  Reads bytes at a given offset of the data. This is safe to call
+ *  from several threads: data in memory is copied without locking, and
+ *  other data sources are seeked and read under a lock.
+ *  @param offset   Offset of the bytes in the data.
+ *  @param len  Number of bytes to read; receives zero in any failure.
+ *  @param nullterminate    Whether to add a 0 after the bytes.
+ *  @return Buffer containing the bytes, or null on any failure.
+ */
+std::unique_ptr<unsigned char[]> U7file::read_at(
+		size_t offset, std::size_t& len, bool nullterminate) {
+	if (const auto* view = dynamic_cast<const IBufferDataView*>(data.get())) {
+		const size_t size = view->getSize();
+		if (offset >= size) {
+			len = 0;
+			return nullptr;
+		}
+		auto buf = std::make_unique<unsigned char[]>(
+				len + (nullterminate ? 1 : 0));
+		std::memcpy(
+				buf.get(), view->getData() + offset,
+				std::min(len, size - offset));
+		return buf;
+	}
+	const std::lock_guard<std::mutex> lock(data_mutex);
+	data->seek(offset);
+	if (!data->good()) {
+		len = 0;
+		return nullptr;
+	}
+	return data->readN(len, nullterminate);
+}
+
 File_data::File_data(const File_spec& spec) {
 	file  = U7FileManager::get_ptr()->get_file_object(spec, true);
 	patch = !spec.name.compare(1, sizeof("<PATCH>/") - 1, "<PATCH>/");
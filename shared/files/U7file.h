@@ -27,6 +27,7 @@
 #include "exceptions.h"
 
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -45,6 +46,8 @@ protected:
 	/// Pointer to the DataSource which will be used by
 	/// derived classes.
 	std::unique_ptr<IDataSource> data;
+	/// Serializes the seeks and reads of data if it isn't in memory.
+	std::mutex data_mutex;
 
 	/// Causes file/buffer information to be read. Or will do,
 	/// when it is implemented for derived classes.
@@ -89,15 +92,13 @@ public:
 			return nullptr;
 		}
 		const Reference ref = get_object_reference(objnum);
-		data->seek(ref.offset);
-		if (!data->good()) {
-			len = 0;
-			return nullptr;
-		}
-		len = ref.size;
-		return data->readN(len,nulllterminate);
+		len                 = ref.size;
+		return read_at(ref.offset, len, nulllterminate);
 	}
 
+	std::unique_ptr<unsigned char[]> read_at(
+			size_t offset, std::size_t& len, bool nullterminate = false);
+
 	virtual const char* get_archive_type() = 0;
 
 	/**
@@ -126,9 +127,20 @@ public:
 	/// This constructor treats the identifier as a file name and
 	/// opens the file if it exists. It also creates and initializes
 	/// the data source, or sets it to null if the file is not there.
+	/// Files in the static data directory are memory-mapped if
+	/// possible, as nothing rewrites them while they are open.
 	/// @param spec Name of file to open. Ignores the index portion.
 	explicit U7DataFile(const File_spec& spec) : T(spec) {
-		this->data = std::make_unique<IFileDataSource>(this->identifier.name);
+		if (this->identifier.name.compare(0, 9, "<STATIC>/") == 0) {
+			auto mapped = std::make_unique<IMappedDataSource>(this->identifier);
+			if (mapped->good()) {
+				this->data = std::move(mapped);
+			}
+		}
+		if (!this->data) {
+			this->data = std::make_unique<IFileDataSource>(
+					this->identifier.name);
+		}
 		if (this->data->good()) {
 			this->index_file();
 		}
@@ -21,6 +21,7 @@
 #include "endianio.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdio>
@@ -31,6 +32,96 @@
 
 class ODataSource;
 
+/**
+ * Non-virtual reader over a contiguous block of input, obtained with
+ * IDataSource::lockWindow. Reads past the end return -1 and set fail().
+ */
+class IDataWindow {
+	std::unique_ptr<unsigned char[]> owned;    // If copied out of a stream.
+	const unsigned char*             start;
+	const unsigned char*             ptr;
+	const unsigned char*             end;
+	bool                             failed = false;
+
+	bool check(size_t len) {
+		if (static_cast<size_t>(end - ptr) < len) {
+			failed = true;
+			ptr    = end;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	IDataWindow(const unsigned char* data, size_t len)
+			: start(data), ptr(data), end(data + len) {}
+
+	IDataWindow(std::unique_ptr<unsigned char[]> data, size_t len)
+			: owned(std::move(data)), start(owned.get()), ptr(start),
+			  end(start + len) {}
+
+	uint32 read1() {
+		return check(1) ? Read1(ptr) : -1;
+	}
+
+	uint16 read2() {
+		return check(2) ? little_endian::Read2(ptr) : -1;
+	}
+
+	uint16 read2high() {
+		return check(2) ? big_endian::Read2(ptr) : -1;
+	}
+
+	uint32 read4() {
+		return check(4) ? little_endian::Read4(ptr) : -1;
+	}
+
+	uint32 read4high() {
+		return check(4) ? big_endian::Read4(ptr) : -1;
+	}
+
+	void read(void* b, size_t len) {
+		if (check(len)) {
+			std::memcpy(b, ptr, len);
+			ptr += len;
+		}
+	}
+
+	// Get the next len bytes without copying them.
+	const unsigned char* take(size_t len) {
+		if (!check(len)) {
+			return nullptr;
+		}
+		const unsigned char* data = ptr;
+		ptr += len;
+		return data;
+	}
+
+	void seek(size_t pos) {
+		ptr = start + std::min<size_t>(pos, end - start);
+	}
+
+	void skip(size_t len) {
+		ptr += std::min<size_t>(len, end - ptr);
+	}
+
+	size_t getSize() const {
+		return end - start;
+	}
+
+	size_t getPos() const {
+		return ptr - start;
+	}
+
+	size_t getAvail() const {
+		return end - ptr;
+	}
+
+	bool fail() const {
+		return failed;
+	}
+};
+
 /**
  * Abstract input base class.
  */
@@ -65,6 +156,11 @@ public:
 
 	virtual std::unique_ptr<IDataSource> makeSource(size_t) = 0;
 
+	// Get the next len bytes (or what is left) for reading with
+	// non-virtual calls. This source must outlive the window, and is
+	// positioned after the bytes.
+	virtual IDataWindow lockWindow(size_t len);
+
 	virtual void   seek(size_t)         = 0;
 	virtual void   skip(std::streamoff) = 0;
 	virtual size_t getSize() const      = 0;
@@ -317,6 +413,8 @@ public:
 
 	std::unique_ptr<IDataSource> makeSource(size_t len) final;
 
+	IDataWindow lockWindow(size_t len) final;
+
 	void seek(size_t pos) final {
 		buf_ptr = buf + pos;
 	}
@@ -337,6 +435,10 @@ public:
 		return buf_ptr;
 	}
 
+	const unsigned char* getData() const {
+		return buf;
+	}
+
 	void clear_error() final {
 		failed = false;
 	}
@@ -412,6 +514,24 @@ public:
 	}
 };
 
+/**
+ * Buffer-based input data source which reads from a read-only memory
+ * mapping of a whole file. bad() is true if the file couldn't be mapped.
+ */
+class IMappedDataSource : public IBufferDataView {
+	std::unique_ptr<U7mapped_file> mapping;
+
+public:
+	explicit IMappedDataSource(const File_spec& spec)
+			: IBufferDataView(nullptr, 0),
+			  mapping(U7map_in(spec.name.c_str())) {
+		if (mapping) {
+			buf = buf_ptr = mapping->get_data();
+			size          = mapping->get_size();
+		}
+	}
+};
+
 /**
  * Abstract output base class.
  */
@@ -527,6 +647,118 @@ public:
 	}
 };
 
+/**
+ * File-based output data source for writing a large file in one pass.
+ * Output is gathered in a big buffer, which is written out when it is
+ * full, before seeking and on flush.
+ */
+class OBufferedFileDataSource : public ODataSource {
+	std::unique_ptr<std::ostream>    fout;
+	std::unique_ptr<unsigned char[]> buf;
+	unsigned char*                   buf_ptr;
+	unsigned char*                   buf_end;
+	size_t                           buf_pos = 0;    // File position of buf.
+
+	void write_buffer() {
+		const size_t len = buf_ptr - buf.get();
+		if (len > 0) {
+			fout->write(reinterpret_cast<const char*>(buf.get()), len);
+			buf_pos += len;
+			buf_ptr = buf.get();
+		}
+	}
+
+	void reserve(size_t len) {
+		if (static_cast<size_t>(buf_end - buf_ptr) < len) {
+			write_buffer();
+		}
+	}
+
+public:
+	explicit OBufferedFileDataSource(
+			const File_spec& spec, size_t bufsize = 1024 * 1024)
+			: fout(U7open_out(spec.name.c_str())),
+			  buf(std::make_unique<unsigned char[]>(bufsize)),
+			  buf_ptr(buf.get()), buf_end(buf.get() + bufsize) {}
+
+	~OBufferedFileDataSource() noexcept final {
+		write_buffer();
+	}
+
+	void write1(uint32 val) final {
+		reserve(1);
+		Write1(buf_ptr, val);
+	}
+
+	void write2(uint16 val) final {
+		reserve(2);
+		little_endian::Write2(buf_ptr, val);
+	}
+
+	void write2high(uint16 val) final {
+		reserve(2);
+		big_endian::Write2(buf_ptr, val);
+	}
+
+	void write4(uint32 val) final {
+		reserve(4);
+		little_endian::Write4(buf_ptr, val);
+	}
+
+	void write4high(uint32 val) final {
+		reserve(4);
+		big_endian::Write4(buf_ptr, val);
+	}
+
+	void write(const void* b, size_t len) final {
+		if (len >= static_cast<size_t>(buf_end - buf.get())) {
+			// Too big to be worth copying.
+			write_buffer();
+			fout->write(static_cast<const char*>(b), len);
+			buf_pos += len;
+			return;
+		}
+		reserve(len);
+		std::memcpy(buf_ptr, b, len);
+		buf_ptr += len;
+	}
+
+	void write(const std::string& s) final {
+		write(s.data(), s.size());
+	}
+
+	void seek(size_t pos) final {
+		write_buffer();
+		fout->seekp(pos);
+		buf_pos = pos;
+	}
+
+	void skip(std::streamoff pos) final {
+		seek(getPos() + pos);
+	}
+
+	size_t getSize() const final {
+		return getPos();
+	}
+
+	size_t getPos() const final {
+		return buf_pos + (buf_ptr - buf.get());
+	}
+
+	void flush() final {
+		write_buffer();
+		fout->flush();
+	}
+
+	bool good() const final {
+		return fout->good();
+	}
+
+	void clear_error() final {
+		fout->clear();
+	}
+};
+
 /**
  * Buffer-based output data source which does not own the buffer.
  */
@@ -629,6 +861,11 @@ inline void IDataSource::copy_to(ODataSource& dest) {
 	dest.write(data.get(), len);
 }
 
+inline IDataWindow IDataSource::lockWindow(size_t len) {
+	len = std::min(len, getAvail());
+	return IDataWindow(readN(len), len);
+}
+
 inline std::unique_ptr<IDataSource> IStreamDataSource::makeSource(size_t len) {
 	return std::make_unique<IBufferDataSource>(readN(len), len);
 }
@@ -643,6 +880,13 @@ inline std::unique_ptr<IDataSource> IBufferDataView::makeSource(size_t len) {
 	return std::make_unique<IBufferDataView>(ptr, len);
 }
 
+inline IDataWindow IBufferDataView::lockWindow(size_t len) {
+	len = std::min(len, getAvail());
+	const unsigned char* ptr = getPtr();
+	skip(len);
+	return IDataWindow(ptr, len);
+}
+
 inline void IBufferDataView::copy_to(ODataSource& dest) {
 	const size_t len = getAvail();
 	dest.write(getPtr(), len);
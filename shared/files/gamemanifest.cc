@@ -0,0 +1,410 @@
+/*
+ *  gamemanifest.cc - What the data directory of a game holds.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "gamemanifest.h"
+
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+// A data directory with more than this is probably not one.
+static const size_t max_entries = 20000;
+
+static const char* const manifest_magic = "ULTIMA GAME MANIFEST 1";
+
+// Flex header fields, as in Flex.h.
+static const uint32 flex_magic      = 0xffff1a00U;
+static const size_t flex_magic_pos  = 80;
+static const size_t flex_count_pos  = 84;
+static const size_t flex_header_len = 128;
+
+/*
+ *  Get the key of a path: lower case, with '/' separators and without
+ *  trailing ones.
+ */
+
+static std::string make_key(const std::string& path) {
+	std::string key = path;
+	for (auto& c : key) {
+		c = c == '\\' ? '/'
+					  : static_cast<char>(
+							  std::tolower(static_cast<unsigned char>(c)));
+	}
+	while (key.size() > 1 && key.back() == '/') {
+		key.pop_back();
+	}
+	return key;
+}
+
+/*
+ *  Get a path in full, so that different ways of naming one compare
+ *  the same.
+ */
+
+static std::string absolute(const std::string& path) {
+	std::error_code ec;
+	const fs::path  full = fs::absolute(path, ec).lexically_normal();
+	std::string     name = ec ? path : full.generic_string();
+	while (name.size() > 1 && name.back() == '/') {
+		name.pop_back();
+	}
+	return name;
+}
+
+static sint64 mtime_of(const fs::path& path, std::error_code& ec) {
+	return static_cast<sint64>(
+			fs::last_write_time(path, ec).time_since_epoch().count());
+}
+
+static uint32 read_le32(const unsigned char* buf) {
+	return buf[0] | (buf[1] << 8) | (buf[2] << 16)
+		   | (static_cast<uint32>(buf[3]) << 24);
+}
+
+/*
+ *  Get the CRC of a file the way crc32() in crc.cc does, and its entry
+ *  table if it's a flex.
+ */
+
+static bool read_file(const fs::path& path, Game_manifest::File& file) {
+	static const auto crc_tab = [] {
+		std::array<uint32, 256> tab{};
+		for (uint32 n = 0; n < 256; n++) {
+			uint32 c = n;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xedb88320U ^ (c >> 1) : c >> 1;
+			}
+			tab[n] = c;
+		}
+		return tab;
+	}();
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+	std::vector<unsigned char> buf(65536);
+	unsigned char              header[flex_header_len];
+	size_t                     have_header = 0;
+	uint32                     crc         = 0;
+	while (in) {
+		in.read(reinterpret_cast<char*>(buf.data()), buf.size());
+		const auto got = static_cast<size_t>(in.gcount());
+		for (size_t i = 0; i < got; i++) {
+			crc = crc_tab[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+		}
+		for (size_t i = 0; i < got && have_header < flex_header_len; i++) {
+			header[have_header++] = buf[i];
+		}
+	}
+	file.crc = crc;
+	file.flex.clear();
+	if (have_header < flex_header_len
+		|| read_le32(header + flex_magic_pos) != flex_magic) {
+		return true;
+	}
+	const uint32 count = read_le32(header + flex_count_pos);
+	if (flex_header_len + uint64(count) * 8 > file.size) {
+		return true;    // Not one after all.
+	}
+	in.clear();
+	in.seekg(flex_header_len);
+	std::vector<unsigned char> table(size_t(count) * 8);
+	if (!in.read(reinterpret_cast<char*>(table.data()), table.size())) {
+		return false;
+	}
+	file.flex.reserve(count);
+	for (uint32 i = 0; i < count; i++) {
+		file.flex.emplace_back(
+				read_le32(&table[i * 8]), read_le32(&table[i * 8 + 4]));
+	}
+	return true;
+}
+
+bool Game_manifest::build(const std::string& dir, const std::string& gm) {
+	std::error_code ec;
+	if (!fs::is_directory(dir, ec)) {
+		return false;
+	}
+	root = absolute(dir);
+	game = gm;
+	dirs.clear();
+	files.clear();
+	dirs.emplace_back(std::string(), mtime_of(root, ec));
+	fs::recursive_directory_iterator it(
+			root, fs::directory_options::skip_permission_denied, ec);
+	for (; !ec && it != fs::recursive_directory_iterator();
+		 it.increment(ec)) {
+		if (dirs.size() + files.size() >= max_entries) {
+			return false;
+		}
+		const std::string name
+				= it->path().lexically_relative(root).generic_string();
+		if (it->is_directory(ec)) {
+			dirs.emplace_back(name, mtime_of(it->path(), ec));
+			continue;
+		}
+		if (!it->is_regular_file(ec)) {
+			continue;
+		}
+		File file;
+		file.name  = name;
+		file.size  = it->file_size(ec);
+		file.mtime = mtime_of(it->path(), ec);
+		if (ec || !read_file(it->path(), file)) {
+			return false;
+		}
+		files.push_back(std::move(file));
+	}
+	if (ec) {
+		return false;
+	}
+	index_names();
+	return true;
+}
+
+/*
+ *  The format is a line per directory and file, with the name last so
+ *  that it may hold spaces; a flex has its entries on the line after.
+ */
+
+bool Game_manifest::read(const std::string& fname) {
+	std::ifstream in(fname);
+	std::string   line;
+	if (!std::getline(in, line) || line != manifest_magic) {
+		return false;
+	}
+	root.clear();
+	game.clear();
+	dirs.clear();
+	files.clear();
+	// The name after a number of fields and a space.
+	auto rest = [&line](std::istringstream& fields) {
+		const auto pos = fields.tellg();
+		if (pos < 0 || static_cast<size_t>(pos) >= line.size()) {
+			return std::string();
+		}
+		return line.substr(static_cast<size_t>(pos) + 1);
+	};
+	while (std::getline(in, line)) {
+		std::istringstream fields(line);
+		std::string        kind;
+		fields >> kind;
+		if (kind == "root") {
+			root = rest(fields);
+		} else if (kind == "game") {
+			fields >> game;
+		} else if (kind == "dir") {
+			sint64 mtime;
+			fields >> mtime;
+			dirs.emplace_back(rest(fields), mtime);
+		} else if (kind == "file") {
+			File file;
+			fields >> file.size >> file.mtime >> std::hex >> file.crc
+					>> std::dec;
+			file.name = rest(fields);
+			files.push_back(std::move(file));
+		} else if (kind == "flex" && !files.empty()) {
+			uint32 count;
+			fields >> count;
+			File& file = files.back();
+			file.flex.resize(count);
+			for (auto& entry : file.flex) {
+				fields >> entry.first >> entry.second;
+			}
+		} else {
+			return false;
+		}
+		if (fields.fail()) {
+			return false;
+		}
+	}
+	if (root.empty() || dirs.empty()
+		|| dirs.size() + files.size() > max_entries) {
+		return false;
+	}
+	index_names();
+	return true;
+}
+
+bool Game_manifest::write(const std::string& fname) const {
+	std::error_code ec;
+	fs::create_directories(fs::path(fname).parent_path(), ec);
+	// Write it all before it replaces an older one.
+	const std::string temp = fname + ".tmp";
+	{
+		std::ofstream out(temp);
+		out << manifest_magic << '\n';
+		out << "root " << root << '\n';
+		out << "game " << game << '\n';
+		for (const auto& dir : dirs) {
+			out << "dir " << dir.second << ' ' << dir.first << '\n';
+		}
+		for (const auto& file : files) {
+			out << "file " << file.size << ' ' << file.mtime << ' ' << std::hex
+				<< file.crc << std::dec << ' ' << file.name << '\n';
+			if (file.flex.empty()) {
+				continue;
+			}
+			out << "flex " << file.flex.size();
+			for (const auto& entry : file.flex) {
+				out << ' ' << entry.first << ' ' << entry.second;
+			}
+			out << '\n';
+		}
+		if (!out.flush()) {
+			fs::remove(temp, ec);
+			return false;
+		}
+	}
+	fs::rename(temp, fname, ec);
+	return !ec;
+}
+
+bool Game_manifest::is_current() const {
+	for (const auto& dir : dirs) {
+		std::error_code ec;
+		const fs::path  path = dir.first.empty() ? fs::path(root)
+												 : fs::path(root) / dir.first;
+		if (mtime_of(path, ec) != dir.second || ec) {
+			return false;
+		}
+	}
+	return !dirs.empty();
+}
+
+void Game_manifest::index_names() {
+	by_name.clear();
+	for (size_t i = 0; i < files.size(); i++) {
+		by_name.emplace(make_key(files[i].name), i);
+	}
+}
+
+bool Game_manifest::relative_key(
+		const std::string& path, std::string& key) const {
+	const std::string root_key = make_key(root);
+	key                        = make_key(absolute(path));
+	if (key == root_key) {
+		key.clear();
+		return true;
+	}
+	if (key.size() <= root_key.size()
+		|| key.compare(0, root_key.size(), root_key) != 0
+		|| key[root_key.size()] != '/') {
+		return false;
+	}
+	key.erase(0, root_key.size() + 1);
+	return true;
+}
+
+const Game_manifest::File* Game_manifest::find(const std::string& path) const {
+	std::string key;
+	if (!relative_key(path, key)) {
+		return nullptr;
+	}
+	auto it = by_name.find(key);
+	if (it == by_name.end()) {
+		return nullptr;
+	}
+	const File&     file = files[it->second];
+	const fs::path  real = fs::path(root) / file.name;
+	std::error_code ec;
+	if (fs::file_size(real, ec) != file.size || ec
+		|| mtime_of(real, ec) != file.mtime || ec) {
+		return nullptr;
+	}
+	return &file;
+}
+
+bool Game_manifest::list(
+		const std::string& dir, std::vector<std::string>& paths) const {
+	std::string key;
+	if (!relative_key(dir, key)) {
+		return false;
+	}
+	bool known = false;
+	for (const auto& d : dirs) {
+		known = known || make_key(d.first) == key;
+	}
+	if (!known) {
+		return false;
+	}
+	// Named as below dir, as it was given.
+	std::string prefix = dir;
+	while (prefix.size() > 1 && prefix.back() == '/') {
+		prefix.pop_back();
+	}
+	auto add_below = [&](const std::string& name) {
+		if (key.empty()) {
+			if (!name.empty()) {
+				paths.push_back(prefix + '/' + name);
+			}
+			return;
+		}
+		const std::string name_key = make_key(name);
+		if (name_key.size() > key.size()
+			&& name_key.compare(0, key.size(), key) == 0
+			&& name_key[key.size()] == '/') {
+			paths.push_back(prefix + name.substr(key.size()));
+		}
+	};
+	for (const auto& d : dirs) {
+		add_below(d.first);
+	}
+	for (const auto& file : files) {
+		add_below(file.name);
+	}
+	return true;
+}
+
+std::string Game_manifest::cache_file(const std::string& game) {
+#ifdef _WIN32
+	const char* base = std::getenv("LOCALAPPDATA");
+#else
+	const char* base = std::getenv("XDG_CACHE_HOME");
+#endif
+	std::string dir;
+	if (base != nullptr && *base != 0) {
+		dir = base;
+	} else if (const char* home = std::getenv("HOME")) {
+		dir = std::string(home) + "/.cache";
+	} else {
+		dir = ".";
+	}
+	return dir + "/ultima-launcher/" + game + ".manifest";
+}
+
+const Game_manifest* Game_manifest::from_environment() {
+	static const std::unique_ptr<Game_manifest> manifest = [] {
+		auto        found = std::make_unique<Game_manifest>();
+		const char* fname = std::getenv("ULTIMA_GAME_MANIFEST");
+		if (fname == nullptr || !found->read(fname) || !found->is_current()) {
+			found.reset();
+		}
+		return found;
+	}();
+	return manifest.get();
+}
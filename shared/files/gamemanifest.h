@@ -0,0 +1,111 @@
+/*
+ *  gamemanifest.h - What the data directory of a game holds.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef GAMEMANIFEST_H
+#define GAMEMANIFEST_H
+
+#include "common_types.h"
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ *  The files below a game's data directory, with their sizes, times,
+ *  CRCs and, for flexes, the entry tables.  The launcher builds one per
+ *  game and saves it; the engines it starts find it through the
+ *  ULTIMA_GAME_MANIFEST environment variable.  They can then index the
+ *  data directory, identify the game and open flexes without walking
+ *  the directory or reading files to find out what they are.
+ *
+ *  A manifest is current while the modification times of its
+ *  directories are unchanged, which is when no file was added, removed
+ *  or renamed.  A file rewritten in place is caught by find(), which
+ *  checks the size and time of the one file asked for.
+ */
+class Game_manifest {
+public:
+	struct File {
+		std::string name;     ///< Relative to the root, '/' separated.
+		uint64      size;
+		sint64      mtime;    ///< As std::filesystem gives it.
+		uint32      crc;      ///< As crc32() in Exult's crc.cc gives it.
+		/// The offset and size of each entry, if it's a flex.
+		std::vector<std::pair<uint32, uint32>> flex;
+	};
+
+	/// Describe a directory, reading every file below it.
+	/// @param dir  The game's data directory.
+	/// @param game  What the game was detected as, such as "u7bg".
+	/// @return false if it isn't a directory or has too many files.
+	bool build(const std::string& dir, const std::string& game);
+
+	bool read(const std::string& fname);
+	bool write(const std::string& fname) const;
+
+	/// Whether no files were added or removed since it was built.
+	bool is_current() const;
+
+	const std::string& get_root() const {
+		return root;
+	}
+
+	const std::string& get_game() const {
+		return game;
+	}
+
+	const std::vector<File>& get_files() const {
+		return files;
+	}
+
+	/// Find a file, if it's unchanged.
+	/// @param path  Its path, in any case.
+	/// @return The file, or nullptr if it isn't known or has changed.
+	const File* find(const std::string& path) const;
+
+	/// List the directories and files below one.
+	/// @param dir  The root or a directory below it.
+	/// @param paths  Gets their paths, starting with dir as given, as
+	///               Path_index::add_root wants them.
+	/// @return false if the directory isn't in the manifest.
+	bool list(const std::string& dir, std::vector<std::string>& paths) const;
+
+	/// Where the launcher keeps the manifest of a game.
+	static std::string cache_file(const std::string& game);
+
+	/// The manifest named by ULTIMA_GAME_MANIFEST, read once.
+	/// @return It, or nullptr if there is none or it isn't current.
+	static const Game_manifest* from_environment();
+
+private:
+	std::string                                 root;
+	std::string                                 game;
+	std::vector<std::pair<std::string, sint64>> dirs;    // Name, mtime.
+	std::vector<File>                           files;
+	/// Lower case name -> index in files.
+	std::unordered_map<std::string, size_t> by_name;
+
+	void index_names();
+	// Lower case name relative to the root, or false if not below it.
+	bool relative_key(const std::string& path, std::string& key) const;
+};
+
+#endif
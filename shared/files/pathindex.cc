@@ -0,0 +1,171 @@
+/*
+ *  pathindex.cc - Index of the files below read-only data directories.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "pathindex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+// A data directory with more than this is probably not one.
+static const size_t max_root_entries = 20000;
+
+/*
+ *  Get the key of a path: lower case, with '/' separators and without
+ *  trailing ones.
+ */
+
+static std::string make_key(const std::string& path) {
+	std::string key = path;
+	for (auto& c : key) {
+		c = c == '\\' ? '/'
+					  : static_cast<char>(
+							  std::tolower(static_cast<unsigned char>(c)));
+	}
+	while (key.size() > 1 && key.back() == '/') {
+		key.pop_back();
+	}
+	return key;
+}
+
+Path_index& Path_index::get() {
+	static Path_index index;
+	return index;
+}
+
+/*
+ *  Index a directory, replacing any earlier index of it.
+ */
+
+bool Path_index::add_root(const std::string& dir) {
+	std::error_code ec;
+	if (!fs::is_directory(dir, ec)) {
+		return false;
+	}
+	// Walk the tree before taking the lock.
+	std::vector<std::string> found;
+	fs::recursive_directory_iterator it(
+			dir, fs::directory_options::skip_permission_denied, ec);
+	for (; !ec && it != fs::recursive_directory_iterator();
+		 it.increment(ec)) {
+		if (found.size() >= max_root_entries) {
+			return false;
+		}
+		found.push_back(it->path().string());
+	}
+	if (ec) {
+		return false;
+	}
+	return add_root(dir, std::move(found));
+}
+
+bool Path_index::add_root(
+		const std::string& dir, std::vector<std::string> paths) {
+	if (paths.size() > max_root_entries) {
+		return false;
+	}
+	std::vector<std::pair<std::string, std::string>> found;
+	found.reserve(paths.size());
+	for (auto& name : paths) {
+		found.emplace_back(make_key(name), std::move(name));
+	}
+	const std::string root = make_key(dir);
+	remove_root(dir);
+	const std::unique_lock<std::shared_mutex> lock(mutex);
+	roots.push_back(root);
+	// Keep the first of names that only differ in case, like a lower
+	// case first search would.
+	std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+		return a.first != b.first ? a.first < b.first : a.second > b.second;
+	});
+	for (auto& entry : found) {
+		entries.emplace(std::move(entry.first), std::move(entry.second));
+	}
+	entries.emplace(root, dir);
+	return true;
+}
+
+void Path_index::remove_root(const std::string& dir) {
+	const std::string                         root = make_key(dir);
+	const std::unique_lock<std::shared_mutex> lock(mutex);
+	auto it = std::find(roots.begin(), roots.end(), root);
+	if (it == roots.end()) {
+		return;
+	}
+	roots.erase(it);
+	for (auto ent = entries.begin(); ent != entries.end();) {
+		if (ent->first.compare(0, root.size(), root) == 0
+			&& (ent->first.size() == root.size()
+				|| ent->first[root.size()] == '/')
+			&& !find_root(ent->first)) {
+			ent = entries.erase(ent);
+		} else {
+			++ent;
+		}
+	}
+}
+
+void Path_index::clear() {
+	const std::unique_lock<std::shared_mutex> lock(mutex);
+	roots.clear();
+	entries.clear();
+}
+
+const std::string* Path_index::find_root(const std::string& key) const {
+	for (const auto& root : roots) {
+		if (key.compare(0, root.size(), root) == 0
+			&& (key.size() == root.size() || key[root.size()] == '/')) {
+			return &root;
+		}
+	}
+	return nullptr;
+}
+
+Path_index::Result Path_index::find(std::string& path) const {
+	const std::string                         key = make_key(path);
+	const std::shared_lock<std::shared_mutex> lock(mutex);
+	if (roots.empty() || !find_root(key)) {
+		return not_indexed;
+	}
+	auto it = entries.find(key);
+	if (it == entries.end()) {
+		return missing;
+	}
+	path = it->second;
+	return found;
+}
+
+void Path_index::add_file(const std::string& path) {
+	const std::string                         key = make_key(path);
+	const std::unique_lock<std::shared_mutex> lock(mutex);
+	if (find_root(key)) {
+		entries.emplace(key, path);
+	}
+}
+
+void Path_index::remove_file(const std::string& path) {
+	const std::string                         key = make_key(path);
+	const std::unique_lock<std::shared_mutex> lock(mutex);
+	entries.erase(key);
+}
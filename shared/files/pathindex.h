@@ -0,0 +1,82 @@
+/*
+ *  pathindex.h - Index of the files below read-only data directories.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PATHINDEX_H
+#define PATHINDEX_H
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ *  An in-memory index of every file and directory below a few root
+ *  directories, looked up without regard to case. Both engines try a
+ *  name in lower case and then in upper case, one open per try; with
+ *  the data directories indexed, a name resolves with one lookup, and
+ *  a missing file fails without touching the disk.
+ *
+ *  Only directories nothing writes to behind our back should be added.
+ *  Files created or removed through the engines' own file routines are
+ *  reported with add_file and remove_file.
+ */
+class Path_index {
+public:
+	enum Result {
+		not_indexed,    ///< The path isn't below an indexed root.
+		missing,        ///< It is, but nothing has that name.
+		found           ///< It exists; the path was set to its real name.
+	};
+
+	static Path_index& get();
+
+	/// Index all files below a directory.
+	/// @param dir  The directory.
+	/// @return false if it isn't a directory or has too many files.
+	bool add_root(const std::string& dir);
+	/// Index a directory from a list of what is below it, such as a
+	/// Game_manifest gives, instead of walking it.
+	/// @param dir  The directory.
+	/// @param paths  The full paths of the directories and files below it.
+	/// @return false if there are too many.
+	bool add_root(const std::string& dir, std::vector<std::string> paths);
+	void remove_root(const std::string& dir);
+	void clear();
+
+	/// Look up a path.
+	/// @param path The path. Rewritten to the name on disk if found.
+	/// @return What is known about the path.
+	Result find(std::string& path) const;
+
+	void add_file(const std::string& path);
+	void remove_file(const std::string& path);
+
+private:
+	/// The indexed directories, with '/' separators and no trailing one.
+	std::vector<std::string> roots;
+	/// Lower case path with '/' separators -> path on disk.
+	std::unordered_map<std::string, std::string> entries;
+	mutable std::shared_mutex                     mutex;
+
+	// The root a path is below, or nullptr.
+	const std::string* find_root(const std::string& key) const;
+};
+
+#endif
@@ -29,8 +29,13 @@
 #include "fnames.h"
 #include "ignore_unused_variable_warning.h"
 #include "listfiles.h"
+#include "pathindex.h"
 #include <sys/stat.h>
 #include <unistd.h>
+#ifndef _WIN32
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#endif
 
 #include <cassert>
 #include <cctype>
@@ -286,6 +291,24 @@ static bool base_to_uppercase(string& str, int count) {
 	return todo <= 0;
 }
 
+/*
+ *  Look a system path up in the path index.
+ *
+ *  Output: -1 if it's known not to exist, 1 if it exists (name is then
+ *  its name on disk), 0 if it isn't below an indexed directory.
+ */
+
+static int lookup_indexed(string& name) {
+	switch (Path_index::get().find(name)) {
+	case Path_index::missing:
+		return -1;
+	case Path_index::found:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
 static void switch_slashes(string& name) {
 #ifdef _WIN32
 	for (char& X : name) {
@@ -326,6 +349,10 @@ std::unique_ptr<std::istream> U7open_in(
 	string                        name           = get_system_path(fname);
 	int                           uppercasecount = 0;
 	std::unique_ptr<std::istream> in;
+	const int                     known = lookup_indexed(name);
+	if (known < 0) {
+		throw file_open_exception(get_system_path(fname));
+	}
 	do {
 		try {
 			// std::cout << "trying: " << name << std::endl;
@@ -336,7 +363,7 @@ std::unique_ptr<std::istream> U7open_in(
 			// std::cout << "got it!" << std::endl;
 			return in;    // found it!
 		}
-	} while (base_to_uppercase(name, ++uppercasecount));
+	} while (!known && base_to_uppercase(name, ++uppercasecount));
 
 	// file not found.
 	throw file_open_exception(get_system_path(fname));
@@ -367,6 +394,7 @@ std::unique_ptr<std::ostream> U7open_out(
 	do {
 		out = ostream_factory(name.c_str(), mode);
 		if (out && out->good()) {
+			Path_index::get().add_file(name);
 			return out;    // found it!
 		}
 	} while (base_to_uppercase(name, ++uppercasecount));
@@ -378,8 +406,12 @@ std::unique_ptr<std::ostream> U7open_out(
 
 DIR* U7opendir(const char* fname    // May be converted to upper-case.
 ) {
-	string name           = get_system_path(fname);
-	int    uppercasecount = 0;
+	string    name           = get_system_path(fname);
+	int       uppercasecount = 0;
+	const int known          = lookup_indexed(name);
+	if (known < 0) {
+		return nullptr;
+	}
 
 	do {
 		DIR* dir = opendir(name.c_str());    // Try to open
@@ -395,7 +427,7 @@ DIR* U7opendir(const char* fname    // May be converted to upper-case.
 		if (dir) {
 			return dir;    // found it!
 		}
-	} while (base_to_uppercase(name, ++uppercasecount));
+	} while (!known && base_to_uppercase(name, ++uppercasecount));
 	return nullptr;
 }
 
@@ -407,6 +439,12 @@ DIR* U7opendir(const char* fname    // May be converted to upper-case.
 void U7remove(const char* fname    // May be converted to upper-case.
 ) {
 	string name = get_system_path(fname);
+	{
+		string indexed = name;
+		if (lookup_indexed(indexed) > 0) {
+			Path_index::get().remove_file(indexed);
+		}
+	}
 
 #if defined(_WIN32) && defined(UNICODE)
 	const char* n     = name.c_str();
@@ -468,12 +506,94 @@ std::unique_ptr<std::istream> U7open_static(
 	return nullptr;
 }
 
+/*
+ *  Map a file for reading,
+ *  trying the original name (lower case), and the upper case version
+ *  of the name.
+ *
+ *  Output: nullptr if it couldn't be mapped.
+ */
+
+std::unique_ptr<U7mapped_file> U7map_in(
+		const char* fname    // May be converted to upper-case.
+) {
+	string    name           = get_system_path(fname);
+	int       uppercasecount = 0;
+	const int known          = lookup_indexed(name);
+	if (known < 0) {
+		return nullptr;
+	}
+	do {
+#ifdef _WIN32
+		HANDLE file = CreateFileA(
+				name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			continue;
+		}
+		LARGE_INTEGER fsize;
+		HANDLE        mapping = nullptr;
+		if (GetFileSizeEx(file, &fsize) && fsize.QuadPart > 0) {
+			mapping = CreateFileMappingA(
+					file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		CloseHandle(file);    // The mapping keeps it open.
+		if (!mapping) {
+			return nullptr;
+		}
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view) {
+			CloseHandle(mapping);
+			return nullptr;
+		}
+		std::unique_ptr<U7mapped_file> mapped(new U7mapped_file());
+		mapped->data    = static_cast<const unsigned char*>(view);
+		mapped->size    = static_cast<size_t>(fsize.QuadPart);
+		mapped->mapping = mapping;
+		return mapped;
+#else
+		const int fd = open(name.c_str(), O_RDONLY);
+		if (fd < 0) {
+			continue;
+		}
+		struct stat sb;
+		void*       view = MAP_FAILED;
+		if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+			view = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		close(fd);    // The mapping keeps it open.
+		if (view == MAP_FAILED) {
+			return nullptr;
+		}
+		std::unique_ptr<U7mapped_file> mapped(new U7mapped_file());
+		mapped->data = static_cast<const unsigned char*>(view);
+		mapped->size = sb.st_size;
+		return mapped;
+#endif
+	} while (!known && base_to_uppercase(name, ++uppercasecount));
+	return nullptr;
+}
+
+U7mapped_file::~U7mapped_file() {
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mapping);
+#else
+	munmap(const_cast<unsigned char*>(data), size);
+#endif
+}
+
 /*
  *  See if a file exists.
  */
 
 bool U7exists(const char* fname    // May be converted to upper-case.
 ) {
+	string    name  = get_system_path(fname);
+	const int known = lookup_indexed(name);
+	if (known != 0) {
+		return known > 0;
+	}
 	try {
 		// First check if we can open it as a file.
 		if (U7open_in(fname)) {
@@ -154,6 +154,39 @@ std::unique_ptr<std::istream> U7open_static(
 );
 DIR* U7opendir(const char* fname    // May be converted to upper-case.
 );
+
+/*
+ *  A read-only memory mapping of a whole file.
+ */
+class U7mapped_file {
+	const unsigned char* data = nullptr;
+	size_t               size = 0;
+#ifdef _WIN32
+	void* mapping = nullptr;    // HANDLE of the file mapping.
+#endif
+
+	U7mapped_file() = default;
+	friend std::unique_ptr<U7mapped_file> U7map_in(const char* fname);
+
+public:
+	U7mapped_file(const U7mapped_file&)            = delete;
+	U7mapped_file& operator=(const U7mapped_file&) = delete;
+	~U7mapped_file();
+
+	const unsigned char* get_data() const {
+		return data;
+	}
+
+	size_t get_size() const {
+		return size;
+	}
+};
+
+// Map a file, trying the same names as U7open_in.  Returns nullptr if the
+// file can't be mapped (missing, empty, or not a plain file).
+std::unique_ptr<U7mapped_file> U7map_in(
+		const char* fname    // May be converted to upper-case.
+);
 void U7remove(const char* fname);
 
 bool U7exists(const char* fname);
@@ -0,0 +1,440 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "Job_system.h"
+
+#include "Frame_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+class Job_system::Task {
+public:
+	const char* name;
+	Task_func   func;
+	Affinity    affinity;
+
+	std::atomic<int>  pending{1};    // Unfinished tasks before it, plus one
+	std::atomic<bool> done{false};   //   until it has been submitted.
+
+	std::mutex            mutex;
+	bool                  finished = false;
+	std::vector<Task_ptr> dependents;    // Waiting for this one.
+
+	Task(const char* n, Task_func f, Affinity a)
+			: name(n), func(std::move(f)), affinity(a) {}
+};
+
+struct Job_system::Worker {
+	std::mutex           mutex;
+	std::deque<Task_ptr> tasks;    // Own at the back, stolen from the front.
+	std::thread          thread;
+};
+
+thread_local Job_system::Worker* Job_system::current = nullptr;
+
+namespace {
+	std::thread::id main_thread;
+
+	bool on_main_thread() {
+		return std::this_thread::get_id() == main_thread;
+	}
+
+	double elapsed_ms(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(
+					   std::chrono::steady_clock::now() - start)
+				.count();
+	}
+}    // namespace
+
+Job_system& Job_system::get() {
+	static Job_system jobs;
+	return jobs;
+}
+
+Job_system::Job_system() {
+	main_thread = std::this_thread::get_id();
+	set_threads(0);
+}
+
+Job_system::~Job_system() {
+	set_threads(1);
+}
+
+void Job_system::set_threads(int n) {
+	if (n <= 0) {
+		const int cores = static_cast<int>(std::thread::hardware_concurrency());
+		n               = std::clamp(cores, 1, 8);
+	}
+	if (n == num_threads) {
+		return;
+	}
+	{
+		const std::lock_guard<std::mutex> lock(sleep_mutex);
+		quit = true;
+	}
+	wake.notify_all();
+	for (auto& worker : workers) {
+		worker->thread.join();
+	}
+	// Anything still queued goes to whoever takes tasks next.
+	{
+		const std::lock_guard<std::mutex> lock(queue_mutex);
+		for (auto& worker : workers) {
+			for (auto& task : worker->tasks) {
+				injected.push_back(std::move(task));
+			}
+		}
+	}
+	workers.clear();
+	quit        = false;
+	num_threads = n;
+	for (int i = 1; i < n; i++) {
+		workers.push_back(std::make_unique<Worker>());
+	}
+	for (auto& worker : workers) {
+		Worker* self = worker.get();
+		self->thread = std::thread([this, self] {
+			PROFILE_THREAD("Job worker");
+			work(*self);
+		});
+	}
+}
+
+size_t Job_system::threads_for(size_t items, size_t per_thread) const {
+	const size_t most = items / std::max<size_t>(per_thread, 1);
+	return std::clamp<size_t>(most, 1, num_threads);
+}
+
+Job_system::Task_ptr Job_system::submit(
+		const char* name, Task_func func, std::initializer_list<Task_ptr> after,
+		Affinity affinity) {
+	return submit(name, std::move(func), std::vector<Task_ptr>(after), affinity);
+}
+
+Job_system::Task_ptr Job_system::submit(
+		const char* name, Task_func func, const std::vector<Task_ptr>& after,
+		Affinity affinity) {
+	auto task = std::make_shared<Task>(name, std::move(func), affinity);
+	for (const auto& before : after) {
+		if (!before) {
+			continue;
+		}
+		const std::lock_guard<std::mutex> lock(before->mutex);
+		if (!before->finished) {
+			++task->pending;
+			before->dependents.push_back(task);
+		}
+	}
+	if (--task->pending == 0) {
+		schedule(task);
+	}
+	return task;
+}
+
+bool Job_system::is_done(const Task_ptr& task) {
+	return !task || task->done;
+}
+
+void Job_system::wait(const Task_ptr& task) {
+	const bool on_main = on_main_thread();
+	while (!is_done(task)) {
+		if (Task_ptr next = take(on_main)) {
+			execute(next);
+			continue;
+		}
+		++waiting;
+		{
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			done.wait(lock, [&] {
+				return task->done || ready > 0 || (on_main && main_ready > 0);
+			});
+		}
+		--waiting;
+	}
+}
+
+void Job_system::run(
+		const char* name, size_t count, const std::function<void(size_t)>& job) {
+	if (count == 0) {
+		return;
+	}
+	const auto   start   = std::chrono::steady_clock::now();
+	const size_t helpers = std::min(count, size_t(num_threads)) - 1;
+	if (helpers == 0) {
+		for (size_t i = 0; i < count; i++) {
+			job(i);
+		}
+	} else {
+		// Whoever gets there first takes the next index.
+		std::atomic<size_t> next{0};
+		auto jobs = [&] {
+			for (size_t i = next++; i < count; i = next++) {
+				job(i);
+			}
+		};
+		std::vector<Task_ptr> helping;
+		helping.reserve(helpers);
+		for (size_t i = 0; i < helpers; i++) {
+			helping.push_back(submit(nullptr, jobs));
+		}
+		jobs();
+		for (const auto& task : helping) {
+			wait(task);
+		}
+	}
+	if (name && profiling) {
+		record(name, elapsed_ms(start));
+	}
+}
+
+void Job_system::parallel_for(
+		const char* name, size_t first, size_t last, size_t grain,
+		const std::function<void(size_t, size_t)>& body) {
+	if (last <= first) {
+		return;
+	}
+	grain             = std::max<size_t>(grain, 1);
+	const size_t runs = (last - first + grain - 1) / grain;
+	if (runs == 1 || num_threads == 1) {
+		const auto start = std::chrono::steady_clock::now();
+		body(first, last);
+		if (name && profiling) {
+			record(name, elapsed_ms(start));
+		}
+		return;
+	}
+	run(name, runs, [&](size_t i) {
+		const size_t begin = first + i * grain;
+		body(begin, std::min(last, begin + grain));
+	});
+}
+
+int Job_system::run_main_thread_tasks(std::chrono::microseconds budget) {
+	if (!on_main_thread()) {
+		return 0;
+	}
+	// Compared as is, the largest budget would overflow in nanoseconds.
+	const bool limited = budget != std::chrono::microseconds::max();
+	const auto start   = std::chrono::steady_clock::now();
+	int        count   = 0;
+	while (!limited || std::chrono::steady_clock::now() - start < budget) {
+		Task_ptr task;
+		{
+			const std::lock_guard<std::mutex> lock(queue_mutex);
+			if (!main_tasks.empty()) {
+				task = std::move(main_tasks.front());
+				main_tasks.pop_front();
+				--main_ready;
+			} else if (workers.empty() && !injected.empty()) {
+				// With no workers, nothing else would run these.
+				task = std::move(injected.front());
+				injected.pop_front();
+				--ready;
+			}
+		}
+		if (!task) {
+			break;
+		}
+		execute(task);
+		count++;
+	}
+	return count;
+}
+
+std::vector<Job_system::Task_stats> Job_system::get_stats() const {
+	const std::lock_guard<std::mutex> lock(stats_mutex);
+	return stats;
+}
+
+void Job_system::reset_stats() {
+	const std::lock_guard<std::mutex> lock(stats_mutex);
+	stats.clear();
+}
+
+void Job_system::report(std::ostream& out) const {
+	std::vector<Task_stats> all = get_stats();
+	std::sort(all.begin(), all.end(), [](const Task_stats& a, const Task_stats& b) {
+		return a.total_ms > b.total_ms;
+	});
+	out << "Jobs (" << num_threads << " threads):" << std::endl;
+	const auto flags = out.flags();
+	out << std::fixed << std::setprecision(3);
+	for (const auto& task : all) {
+		out << "  " << std::left << std::setw(28) << task.name << std::right
+			<< std::setw(8) << task.runs << " runs" << std::setw(12)
+			<< task.total_ms << " ms" << std::setw(10) << task.max_ms
+			<< " ms max" << std::endl;
+	}
+	out.flags(flags);
+}
+
+void Job_system::schedule(Task_ptr task) {
+	if (task->affinity == Affinity::main_thread) {
+		{
+			const std::lock_guard<std::mutex> lock(queue_mutex);
+			main_tasks.push_back(std::move(task));
+		}
+		++main_ready;
+	} else if (current) {
+		const std::lock_guard<std::mutex> lock(current->mutex);
+		current->tasks.push_back(std::move(task));
+		++ready;
+	} else {
+		const std::lock_guard<std::mutex> lock(queue_mutex);
+		injected.push_back(std::move(task));
+		++ready;
+	}
+	// Take the lock so no sleeper misses the count going up.
+	{ const std::lock_guard<std::mutex> lock(sleep_mutex); }
+	wake.notify_one();
+	if (waiting > 0) {
+		done.notify_all();
+	}
+}
+
+Job_system::Task_ptr Job_system::take(bool on_main) {
+	Task_ptr task;
+	if (on_main && main_ready > 0) {
+		const std::lock_guard<std::mutex> lock(queue_mutex);
+		if (!main_tasks.empty()) {
+			task = std::move(main_tasks.front());
+			main_tasks.pop_front();
+			--main_ready;
+			return task;
+		}
+	}
+	if (ready == 0) {
+		return nullptr;
+	}
+	if (current) {
+		const std::lock_guard<std::mutex> lock(current->mutex);
+		if (!current->tasks.empty()) {
+			task = std::move(current->tasks.back());
+			current->tasks.pop_back();
+			--ready;
+			return task;
+		}
+	}
+	{
+		const std::lock_guard<std::mutex> lock(queue_mutex);
+		if (!injected.empty()) {
+			task = std::move(injected.front());
+			injected.pop_front();
+			--ready;
+			return task;
+		}
+	}
+	// Steal the oldest task of another worker, starting after this one.
+	const size_t count = workers.size();
+	size_t       start = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (workers[i].get() == current) {
+			start = i + 1;
+			break;
+		}
+	}
+	for (size_t i = 0; i < count; i++) {
+		Worker& victim = *workers[(start + i) % count];
+		if (&victim == current) {
+			continue;
+		}
+		const std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			--ready;
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+void Job_system::execute(const Task_ptr& task) {
+	if (task->name) {
+		PROFILE_ZONE_NAMED(task->name);
+		if (profiling) {
+			const auto start = std::chrono::steady_clock::now();
+			task->func();
+			record(task->name, elapsed_ms(start));
+		} else {
+			task->func();
+		}
+	} else {
+		task->func();
+	}
+	task->func = nullptr;
+	finish(task);
+}
+
+void Job_system::finish(const Task_ptr& task) {
+	std::vector<Task_ptr> released;
+	{
+		const std::lock_guard<std::mutex> lock(task->mutex);
+		task->finished = true;
+		released.swap(task->dependents);
+	}
+	task->done = true;
+	for (auto& next : released) {
+		if (--next->pending == 0) {
+			schedule(std::move(next));
+		}
+	}
+	if (waiting > 0) {
+		{ const std::lock_guard<std::mutex> lock(sleep_mutex); }
+		done.notify_all();
+	}
+}
+
+void Job_system::work(Worker& self) {
+	current = &self;
+	while (true) {
+		if (Task_ptr task = take(false)) {
+			execute(task);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [&] {
+			return quit || ready > 0;
+		});
+		if (quit) {
+			break;
+		}
+	}
+	current = nullptr;
+}
+
+void Job_system::record(const char* name, double ms) {
+	const std::lock_guard<std::mutex> lock(stats_mutex);
+	auto it = std::find_if(stats.begin(), stats.end(), [name](const Task_stats& s) {
+		return s.name == name;
+	});
+	if (it == stats.end()) {
+		stats.push_back(Task_stats{name});
+		it = stats.end() - 1;
+	}
+	it->runs++;
+	it->total_ms += ms;
+	it->max_ms = std::max(it->max_ms, ms);
+}
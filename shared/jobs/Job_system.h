@@ -0,0 +1,171 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef INCL_JOB_SYSTEM_H
+#define INCL_JOB_SYSTEM_H 1
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ *  The one set of worker threads for the whole program, so the engines
+ *  and the NPC library share the cores rather than each starting threads
+ *  of their own.
+ *
+ *  Tasks run once the tasks they were submitted after have finished.  Each
+ *  worker keeps the tasks it submits to itself, newest first, and takes
+ *  the oldest from the others when it runs out.  A thread waiting on a
+ *  task runs other tasks meanwhile, so tasks may wait on tasks of their
+ *  own.  Main thread tasks only run in run_main_thread_tasks(), on the
+ *  thread that first got the job system, within a time budget per call.
+ *
+ *  With profiling on, the time spent in each named task is totalled.
+ */
+class Job_system {
+public:
+	using Task_func = std::function<void()>;
+
+	class Task;
+	using Task_ptr = std::shared_ptr<Task>;
+
+	enum class Affinity {
+		any,
+		main_thread
+	};
+
+	struct Task_stats {
+		std::string name;
+		std::uint64_t runs     = 0;
+		double        total_ms = 0;
+		double        max_ms   = 0;
+	};
+
+	// The job system shared by everything.
+	static Job_system& get();
+
+	Job_system(const Job_system&)            = delete;
+	Job_system& operator=(const Job_system&) = delete;
+
+	// Set how many threads run tasks, including the one waiting on them.
+	//   Zero, the default, picks one per CPU core (at most 8); one runs
+	//   everything on the threads that wait.  Only call this with no tasks
+	//   running.
+	void set_threads(int n);
+
+	int get_threads() const {
+		return num_threads;
+	}
+
+	// How many threads are worth giving items to, each to have at least
+	//   per_thread of them.
+	size_t threads_for(size_t items, size_t per_thread) const;
+
+	// Run func once every task in after has finished.  The name, which
+	//   must outlive the task, is what its time is totalled under; tasks
+	//   without one aren't timed.
+	Task_ptr submit(
+			const char* name, Task_func func,
+			std::initializer_list<Task_ptr> after = {},
+			Affinity affinity = Affinity::any);
+	Task_ptr submit(
+			const char* name, Task_func func, const std::vector<Task_ptr>& after,
+			Affinity affinity = Affinity::any);
+
+	static bool is_done(const Task_ptr& task);
+
+	// Return once the task has finished, running others meanwhile.
+	void wait(const Task_ptr& task);
+
+	// Call job(i) for each i in [0, count), returning when all are done.
+	void run(const char* name, size_t count, const std::function<void(size_t)>& job);
+
+	// Call body(begin, end) over [first, last) in runs of at least grain
+	//   items, returning when all are done.
+	void parallel_for(
+			const char* name, size_t first, size_t last, size_t grain,
+			const std::function<void(size_t, size_t)>& body);
+
+	// Run the main thread tasks that are ready until there are none left
+	//   or the budget is spent, returning how many ran.  The rest wait for
+	//   the next call.
+	int run_main_thread_tasks(
+			std::chrono::microseconds budget = std::chrono::microseconds::max());
+
+	// Per task timing.
+	void set_profiling(bool on) {
+		profiling = on;
+	}
+
+	bool get_profiling() const {
+		return profiling;
+	}
+
+	std::vector<Task_stats> get_stats() const;
+	void                    reset_stats();
+	void                    report(std::ostream& out) const;
+
+private:
+	struct Worker;
+
+	static thread_local Worker* current;    // The worker on this thread.
+
+	Job_system();
+	~Job_system();
+
+	int                                  num_threads = 1;
+	std::vector<std::unique_ptr<Worker>> workers;    // All but the waiters.
+	std::atomic<bool>                    quit{false};
+
+	// Ready tasks submitted from outside the workers, and main thread ones.
+	std::mutex            queue_mutex;
+	std::deque<Task_ptr>  injected;
+	std::deque<Task_ptr>  main_tasks;
+
+	// Sleeping and waking: ready counts the tasks any thread may take,
+	//   main_ready those in main_tasks.
+	std::mutex              sleep_mutex;
+	std::condition_variable wake;    // Workers wait for tasks here,
+	std::condition_variable done;    // and waiters for their task.
+	std::atomic<size_t>     ready{0};
+	std::atomic<size_t>     main_ready{0};
+	std::atomic<int>        waiting{0};
+
+	std::atomic<bool>       profiling{false};
+	mutable std::mutex      stats_mutex;
+	std::vector<Task_stats> stats;
+
+	void     schedule(Task_ptr task);
+	Task_ptr take(bool on_main);
+	void     execute(const Task_ptr& task);
+	void     finish(const Task_ptr& task);
+	void     work(Worker& self);
+	void     record(const char* name, double ms);
+};
+
+#endif
@@ -0,0 +1,403 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "Async_log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <thread>
+
+namespace {
+	const char* const level_names[] = {"trace",   "debug", "info",
+									   "warning", "error", "off"};
+
+	// Text of each thread, for stdout and stderr, until a line ends.
+	//   What is left when a thread ends is written then.
+	struct Pending_text {
+		std::string text[2];
+
+		~Pending_text() {
+			for (int i = 0; i < 2; i++) {
+				Async_log::get().write(
+						Async_log::Stream(i), text[i].data(), text[i].size());
+			}
+		}
+	};
+
+	class Line_buffer : public std::streambuf {
+		// Longer text without an end of line is queued anyway.
+		static constexpr size_t max_pending = 4096;
+
+		Async_log::Stream stream;
+
+		std::string& pending() {
+			static thread_local Pending_text text;
+			return text.text[stream];
+		}
+
+		// Queue up to the last end of line, or all of it.
+		void queue(std::string& text, bool all) {
+			size_t len = text.size();
+			if (!all && len < max_pending) {
+				const size_t eol = text.rfind('\n');
+				len              = eol == std::string::npos ? 0 : eol + 1;
+			}
+			if (len) {
+				Async_log::get().write(stream, text.data(), len);
+				text.erase(0, len);
+			}
+		}
+
+	public:
+		explicit Line_buffer(Async_log::Stream s) : stream(s) {}
+
+	protected:
+		int_type overflow(int_type c) override {
+			if (traits_type::eq_int_type(c, traits_type::eof())) {
+				return traits_type::not_eof(c);
+			}
+			std::string& text = pending();
+			text += traits_type::to_char_type(c);
+			if (c == '\n' || text.size() >= max_pending) {
+				queue(text, true);
+			}
+			return c;
+		}
+
+		std::streamsize xsputn(const char* str, std::streamsize n) override {
+			std::string& text = pending();
+			text.append(str, size_t(n));
+			if (std::memchr(str, '\n', size_t(n))
+				|| text.size() >= max_pending) {
+				queue(text, false);
+			}
+			return n;
+		}
+
+		int sync() override {
+			queue(pending(), true);
+			return 0;
+		}
+	};
+
+	std::string trim(const std::string& str) {
+		const size_t first = str.find_first_not_of(" \t");
+		if (first == std::string::npos) {
+			return std::string();
+		}
+		return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+	}
+}    // namespace
+
+Async_log& Async_log::get() {
+	// Never destroyed, as threads may still log while the program exits.
+	static Async_log* log = new Async_log;
+	return *log;
+}
+
+Async_log::Async_log() : ring(new Slot[ring_size]) {
+	for (size_t i = 0; i < ring_size; i++) {
+		ring[i].seq.store(i, std::memory_order_relaxed);
+	}
+	// Write what is left at exit, and whatever comes after at once, as
+	//   stdio is about to go.
+	std::atexit([] {
+		Async_log& log = get();
+		log.flush();
+		log.direct = true;
+		log.flush();
+	});
+	const char* spec = std::getenv("ULTIMA_LOG");
+	if (spec && *spec) {
+		set_levels(spec);
+	}
+}
+
+void Async_log::write(Stream stream, const char* text, size_t len) {
+	if (!len) {
+		return;
+	}
+	std::call_once(start_once, [this] {
+		start();
+	});
+	while (len) {
+		if (direct.load(std::memory_order_acquire)) {
+			write_direct(stream, text, len);
+			return;
+		}
+		// Take the slots for as much of it as the ring holds.
+		const size_t count
+				= std::min((len + slot_text - 1) / slot_text, ring_size);
+		size_t pos   = head.load(std::memory_order_relaxed);
+		bool   taken = false;
+		while (!taken) {
+			// The thread frees slots in order, so if the last one is free,
+			//   they all are.
+			const size_t last = pos + count - 1;
+			const size_t seq
+					= ring[last & (ring_size - 1)].seq.load(std::memory_order_acquire);
+			const auto diff = std::ptrdiff_t(seq - last);
+			if (diff == 0) {
+				taken = head.compare_exchange_weak(
+						pos, pos + count, std::memory_order_relaxed);
+			} else if (diff < 0) {
+				// Full: let the thread catch up.
+				wake_writer();
+				std::this_thread::yield();
+				if (direct.load(std::memory_order_acquire)) {
+					break;
+				}
+				pos = head.load(std::memory_order_relaxed);
+			} else {
+				pos = head.load(std::memory_order_relaxed);
+			}
+		}
+		if (!taken) {
+			continue;    // Gave up waiting, to write it at once.
+		}
+		for (size_t i = 0; i < count; i++) {
+			Slot&        slot = ring[(pos + i) & (ring_size - 1)];
+			const size_t n    = std::min(len, slot_text);
+			std::memcpy(slot.text, text, n);
+			slot.len    = std::uint16_t(n);
+			slot.stream = static_cast<unsigned char>(stream);
+			// Seq_cst, so that the thread sees it before sleeping or is
+			//   seen sleeping below.
+			slot.seq.store(pos + i + 1);
+			text += n;
+			len -= n;
+		}
+		if (sleeping.load()) {
+			wake_writer();
+		}
+	}
+}
+
+void Async_log::message(
+		const Log_category& category, Log_level level, const char* text,
+		size_t len) {
+	char         line[max_message + 64];
+	const size_t room = sizeof(line) - 1;
+	int          n    = std::snprintf(line, room, "[%s] ", category.get_name());
+	size_t       used = std::min(size_t(std::max(n, 0)), room - 1);
+	len               = std::min(len, room - used);
+	std::memcpy(line + used, text, len);
+	used += len;
+	line[used++] = '\n';
+	write(level >= Log_level::Warning ? Err : Out, line, used);
+}
+
+void Async_log::flush() {
+	const size_t target = head.load(std::memory_order_acquire);
+	if (running.load(std::memory_order_acquire)) {
+		std::unique_lock<std::mutex> lock(wake_mutex);
+		while (written.load(std::memory_order_acquire) < target
+			   && running.load(std::memory_order_acquire)) {
+			wake.notify_one();
+			drained.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+	std::fflush(stdout);
+	std::fflush(stderr);
+}
+
+std::streambuf* Async_log::get_streambuf(Stream stream) {
+	std::call_once(buffers_once, [this] {
+		streambufs[Out].reset(new Line_buffer(Out));
+		streambufs[Err].reset(new Line_buffer(Err));
+	});
+	return streambufs[stream].get();
+}
+
+void Async_log::take_over(std::ostream& out, Stream stream) {
+	out.flush();
+	out.rdbuf(get_streambuf(stream));
+	// Else std::cerr would queue each piece of a line by itself.
+	out.unsetf(std::ios_base::unitbuf);
+}
+
+bool Async_log::set_levels(const std::string& spec) {
+	bool   ok  = true;
+	size_t pos = 0;
+	while (pos <= spec.size()) {
+		size_t end = spec.find(',', pos);
+		if (end == std::string::npos) {
+			end = spec.size();
+		}
+		const std::string item = trim(spec.substr(pos, end - pos));
+		pos                    = end + 1;
+		if (item.empty()) {
+			continue;
+		}
+		const size_t eq   = item.find('=');
+		std::string  name = "*";
+		std::string  lev  = item;
+		if (eq != std::string::npos) {
+			name = trim(item.substr(0, eq));
+			lev  = trim(item.substr(eq + 1));
+		}
+		Log_level level;
+		if (name.empty() || !parse_level(lev, level)) {
+			ok = false;
+			continue;
+		}
+		std::lock_guard<std::mutex> lock(categories_mutex);
+		levels.emplace_back(name, level);
+		for (auto* category : categories) {
+			apply_level(category, name, level);
+		}
+	}
+	return ok;
+}
+
+void Async_log::add_category(Log_category* category) {
+	std::lock_guard<std::mutex> lock(categories_mutex);
+	categories.push_back(category);
+	for (const auto& level : levels) {
+		apply_level(category, level.first, level.second);
+	}
+}
+
+const char* Async_log::level_name(Log_level level) {
+	return level_names[int(level)];
+}
+
+bool Async_log::parse_level(const std::string& name, Log_level& level) {
+	std::string lower(name);
+	std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) {
+		return char(std::tolower(static_cast<unsigned char>(c)));
+	});
+	for (int i = 0; i <= int(Log_level::Off); i++) {
+		if (lower == level_names[i]) {
+			level = Log_level(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void Async_log::start() {
+	try {
+		running = true;
+		std::thread(&Async_log::run, this).detach();
+	} catch (const std::system_error&) {
+		// No threads here: just write at once.
+		running = false;
+		direct  = true;
+	}
+}
+
+/*
+ *  The thread writes what it finds, then flushes the streams and sleeps
+ *  until woken, or a while in case a wakeup was missed.
+ */
+
+void Async_log::run() {
+	for (;;) {
+		bool any = false;
+		while (write_ready()) {
+			any = true;
+		}
+		if (any) {
+			std::fflush(stdout);
+			std::fflush(stderr);
+		}
+		std::unique_lock<std::mutex> lock(wake_mutex);
+		drained.notify_all();
+		sleeping.store(true);
+		const Slot& next = ring[tail & (ring_size - 1)];
+		if (next.seq.load() != tail + 1) {
+			wake.wait_for(lock, std::chrono::milliseconds(50));
+		}
+		sleeping.store(false, std::memory_order_relaxed);
+	}
+}
+
+bool Async_log::write_ready() {
+	Slot& slot = ring[tail & (ring_size - 1)];
+	if (slot.seq.load(std::memory_order_acquire) != tail + 1) {
+		return false;
+	}
+	std::fwrite(slot.text, 1, slot.len, slot.stream == Err ? stderr : stdout);
+	slot.seq.store(tail + ring_size, std::memory_order_release);
+	++tail;
+	written.store(tail, std::memory_order_release);
+	return true;
+}
+
+void Async_log::wake_writer() {
+	std::lock_guard<std::mutex> lock(wake_mutex);
+	wake.notify_one();
+}
+
+void Async_log::write_direct(Stream stream, const char* text, size_t len) {
+	std::fwrite(text, 1, len, stream == Err ? stderr : stdout);
+}
+
+void Async_log::apply_level(
+		Log_category* category, const std::string& name, Log_level level) {
+	if (name == "*" || name == category->get_name()) {
+		category->set_level(level);
+	}
+}
+
+Log_category::Log_category(const char* n, Log_level lev, unsigned limit)
+		: name(n), level(int(lev)), per_second(limit) {
+	Async_log::get().add_category(this);
+}
+
+/*
+ *  Up to per_second messages each second; the next second starts with
+ *  a count of those that weren't.
+ */
+
+bool Log_category::allow() {
+	const std::int64_t now
+			= std::chrono::duration_cast<std::chrono::seconds>(
+					  std::chrono::steady_clock::now().time_since_epoch())
+					  .count();
+	std::int64_t was = window.load(std::memory_order_relaxed);
+	if (was != now
+		&& window.compare_exchange_strong(
+				was, now, std::memory_order_relaxed)) {
+		count.store(0, std::memory_order_relaxed);
+		const unsigned missed = suppressed.exchange(0, std::memory_order_relaxed);
+		if (missed) {
+			char      line[Async_log::max_message];
+			const int n = std::snprintf(
+					line, sizeof(line), "%u messages suppressed", missed);
+			Async_log::get().message(
+					*this, Log_level::Warning, line,
+					std::min(size_t(std::max(n, 0)), sizeof(line) - 1));
+		}
+	}
+	if (count.fetch_add(1, std::memory_order_relaxed) < per_second) {
+		return true;
+	}
+	suppressed.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
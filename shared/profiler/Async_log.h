@@ -0,0 +1,240 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef INCL_ASYNC_LOG_H
+#define INCL_ASYNC_LOG_H 1
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class Log_level : int {
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Off
+};
+
+class Log_category;
+
+/*
+ *  Text for stdout and stderr, written by a thread of its own so that
+ *  the engines don't wait on the terminal or a log file.  The engines'
+ *  console streams and the ULTIMA_LOG messages below go through it.
+ *
+ *  Writers take slots in a fixed ring without locking, and a write of
+ *  several slots gets them together, so it isn't broken up by others.
+ *  When the ring is full, writers wait for the thread to catch up
+ *  rather than lose text.  At exit, what is left is written, and later
+ *  text is written at once.
+ *
+ *  Levels of categories may be set with the ULTIMA_LOG environment
+ *  variable or the engines' settings, as "name=level,..."; "*" names
+ *  all categories.  The levels are trace, debug, info, warning, error
+ *  and off.
+ */
+class Async_log {
+public:
+	enum Stream {
+		Out,
+		Err
+	};
+
+	// Longest message of a category; the rest is cut off.
+	static constexpr size_t max_message = 1024;
+
+	// The log of the whole program.
+	static Async_log& get();
+
+	Async_log(const Async_log&)            = delete;
+	Async_log& operator=(const Async_log&) = delete;
+
+	// Queue text for stdout or stderr.
+	void write(Stream stream, const char* text, size_t len);
+
+	// Queue a line of a category: to stderr for warnings and errors,
+	//   else to stdout.
+	void message(
+			const Log_category& category, Log_level level, const char* text,
+			size_t len);
+
+	// Wait until all text queued so far has been written.
+	void flush();
+
+	// A stream buffer for stdout or stderr, which queues each thread's
+	//   text a line at a time, or on a flush.  Never destroyed.
+	std::streambuf* get_streambuf(Stream stream);
+
+	// Send a stream, such as std::cout, through get_streambuf().
+	void take_over(std::ostream& out, Stream stream);
+
+	// Set category levels from a "name=level,..." list.  Returns false
+	//   if some of it wasn't understood.
+	bool set_levels(const std::string& spec);
+
+	// Register a category; it gets the levels set so far.
+	void add_category(Log_category* category);
+
+	static const char* level_name(Log_level level);
+	static bool        parse_level(const std::string& name, Log_level& level);
+
+private:
+	static constexpr size_t ring_size = 1024;    // Slots, a power of 2.
+
+	struct Slot {
+		std::atomic<size_t> seq;
+		unsigned char       stream;
+		std::uint16_t       len;
+		char                text[256 - sizeof(size_t) - 4];
+	};
+
+	static constexpr size_t slot_text = sizeof(Slot::text);
+
+	std::unique_ptr<Slot[]> ring;
+	std::atomic<size_t>     head{0};    // Next slot to take.
+	size_t                  tail = 0;   // Next slot to write; the thread's.
+	std::atomic<size_t>     written{0};
+
+	std::once_flag                  buffers_once;
+	std::unique_ptr<std::streambuf> streambufs[2];
+
+	std::once_flag          start_once;
+	std::atomic<bool>       running{false};
+	std::atomic<bool>       direct{false};    // Write at once instead.
+	std::atomic<bool>       sleeping{false};
+	std::mutex              wake_mutex;
+	std::condition_variable wake;
+	std::condition_variable drained;
+
+	// Levels asked for, in order, for categories registered later.
+	std::mutex                                      categories_mutex;
+	std::vector<Log_category*>                      categories;
+	std::vector<std::pair<std::string, Log_level>> levels;
+
+	Async_log();
+
+	void start();
+	void run();
+	bool write_ready();
+	void wake_writer();
+	void write_direct(Stream stream, const char* text, size_t len);
+	void apply_level(
+			Log_category* category, const std::string& name, Log_level level);
+};
+
+/*
+ *  Messages of one part of a program, as "[name] text".  Declare one
+ *  static per category, and use ULTIMA_LOG: nothing is formatted for
+ *  a message below the category's level, or past its limit of
+ *  messages per second.  The name must outlive the category.
+ */
+class Log_category {
+public:
+	explicit Log_category(
+			const char* name, Log_level level = Log_level::Info,
+			unsigned per_second = 0);
+
+	Log_category(const Log_category&)            = delete;
+	Log_category& operator=(const Log_category&) = delete;
+
+	const char* get_name() const {
+		return name;
+	}
+
+	Log_level get_level() const {
+		return Log_level(level.load(std::memory_order_relaxed));
+	}
+
+	void set_level(Log_level lev) {
+		level.store(int(lev), std::memory_order_relaxed);
+	}
+
+	bool enabled(Log_level lev) const {
+		return int(lev) >= level.load(std::memory_order_relaxed);
+	}
+
+	// Whether a message of this level should be formatted now.
+	bool should_log(Log_level lev) {
+		return enabled(lev) && (!per_second || allow());
+	}
+
+private:
+	const char*               name;
+	std::atomic<int>          level;
+	const unsigned            per_second;    // 0 for no limit.
+	std::atomic<std::int64_t> window{-1};    // Second of the count.
+	std::atomic<unsigned>     count{0};
+	std::atomic<unsigned>     suppressed{0};
+
+	bool allow();
+};
+
+/*
+ *  One message, sent when it goes out of scope.
+ */
+class Log_line {
+	class Buffer : public std::streambuf {
+	public:
+		explicit Buffer(char* buf, size_t size) {
+			setp(buf, buf + size);
+		}
+
+		size_t size() const {
+			return pptr() - pbase();
+		}
+	};
+
+	Log_category& category;
+	Log_level     level;
+	char          text[Async_log::max_message];
+	Buffer        buffer;
+	std::ostream  out;
+
+public:
+	Log_line(Log_category& cat, Log_level lev)
+			: category(cat), level(lev), buffer(text, sizeof(text)),
+			  out(&buffer) {}
+
+	Log_line(const Log_line&)            = delete;
+	Log_line& operator=(const Log_line&) = delete;
+
+	~Log_line() {
+		Async_log::get().message(category, level, text, buffer.size());
+	}
+
+	std::ostream& stream() {
+		return out;
+	}
+};
+
+// ULTIMA_LOG(category, Info) << "text";  No newline is needed.
+#define ULTIMA_LOG(category, level)                   \
+	if (!(category).should_log(Log_level::level)) { \
+	} else                                            \
+		Log_line(category, Log_level::level).stream()
+
+#endif
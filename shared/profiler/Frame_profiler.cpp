@@ -0,0 +1,262 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "Frame_profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+thread_local std::shared_ptr<Frame_profiler::Thread_events>
+		Frame_profiler::current;
+
+namespace {
+	// A thread stops keeping events after this many, about 40MB of them.
+	const size_t max_thread_events = 1 << 20;
+
+	void write_string(std::ostream& out, const char* str) {
+		out << '"';
+		for (; *str; ++str) {
+			const unsigned char c = *str;
+			if (c == '"' || c == '\\') {
+				out << '\\' << c;
+			} else if (c < 0x20) {
+				out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+					<< int(c) << std::dec << std::setfill(' ');
+			} else {
+				out << c;
+			}
+		}
+		out << '"';
+	}
+
+	// Microseconds, as the trace has them.
+	void write_time(std::ostream& out, std::int64_t ns) {
+		out << ns / 1000 << '.' << std::setw(3) << std::setfill('0')
+			<< (ns % 1000 + 1000) % 1000 << std::setfill(' ');
+	}
+}    // namespace
+
+Frame_profiler& Frame_profiler::get() {
+	// Never destroyed, as threads may still record while the program
+	//   exits.
+	static Frame_profiler* profiler = new Frame_profiler;
+	return *profiler;
+}
+
+// The macros only get the profiler once it records, so look at
+//   ULTIMA_FRAME_TRACE before main().
+static const Frame_profiler& initial_profiler = Frame_profiler::get();
+
+Frame_profiler::Frame_profiler() {
+	// Programs that don't call finish() still get their trace.
+	std::atexit([] {
+		get().finish();
+	});
+	const char* fname = std::getenv("ULTIMA_FRAME_TRACE");
+	if (fname && *fname) {
+		start(fname);
+	}
+}
+
+bool Frame_profiler::start(const std::string& fname) {
+	if (!compiled_in()) {
+		return false;
+	}
+	recording = false;
+	{
+		std::lock_guard<std::mutex> lock(threads_mutex);
+		for (const auto& thread : threads) {
+			std::lock_guard<std::mutex> thread_lock(thread->mutex);
+			thread->events.clear();
+			thread->dropped = 0;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(alloc_mutex);
+		pool_bytes.clear();
+		alloc_sizes.clear();
+	}
+	trace_file = fname;
+	origin     = since_epoch(Clock::now());
+	last_frame = -1;
+	recording  = true;
+	return true;
+}
+
+/*
+ *  The events of each thread go out in the order they were kept, which
+ *  the viewers don't mind.  A zone is kept when it ends, so one holding
+ *  others comes after them.
+ */
+
+bool Frame_profiler::finish() {
+	if (!recording) {
+		return true;
+	}
+	recording = false;
+	std::ofstream out(trace_file.c_str());
+	if (!out) {
+		return false;
+	}
+	out << "{\"traceEvents\":[";
+	const char* sep = "\n";
+	std::lock_guard<std::mutex> lock(threads_mutex);
+	for (const auto& thread : threads) {
+		std::lock_guard<std::mutex> thread_lock(thread->mutex);
+		if (!thread->name.empty()) {
+			out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+				<< "\"tid\":" << thread->tid << ",\"args\":{\"name\":";
+			write_string(out, thread->name.c_str());
+			out << "}}";
+			sep = ",\n";
+		}
+		for (const auto& event : thread->events) {
+			out << sep << "{\"name\":";
+			write_string(out, event.name);
+			out << ",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":"
+				<< thread->tid << ",\"ts\":";
+			write_time(out, event.ts);
+			switch (event.phase) {
+			case 'X':
+				out << ",\"dur\":";
+				write_time(out, event.dur);
+				break;
+			case 'C':
+				out << ",\"args\":{\"value\":" << event.value << '}';
+				break;
+			default:
+				out << ",\"s\":\"g\"";
+				break;
+			}
+			out << '}';
+			sep = ",\n";
+		}
+		thread->events.clear();
+		if (thread->dropped) {
+			out << sep << "{\"name\":\"dropped events\",\"ph\":\"C\",\"pid\":1,"
+				<< "\"tid\":" << thread->tid << ",\"ts\":0,\"args\":{\"value\":"
+				<< thread->dropped << "}}";
+			thread->dropped = 0;
+		}
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+	return out.good();
+}
+
+void Frame_profiler::zone(const char* name, Clock::time_point begin) {
+	const std::int64_t ts = since_origin(begin);
+	add(Event{name, 'X', ts, since_origin(Clock::now()) - ts, 0});
+}
+
+void Frame_profiler::counter(const char* name, double value) {
+	add(Event{name, 'C', since_origin(Clock::now()), 0, value});
+}
+
+/*
+ *  A frame shows as a mark across all threads, and as a counter of the
+ *  time since the last one.
+ */
+
+void Frame_profiler::frame() {
+	const std::int64_t ts   = since_origin(Clock::now());
+	const std::int64_t last = last_frame.exchange(ts);
+	add(Event{"frame", 'i', ts, 0, 0});
+	if (last >= 0) {
+		add(Event{"frame ms", 'C', ts, 0, (ts - last) / 1e6});
+	}
+}
+
+/*
+ *  Allocations show as a counter of the bytes a pool has live.
+ */
+
+void Frame_profiler::alloc(const void* ptr, size_t size, const char* pool) {
+	if (!ptr) {
+		return;
+	}
+	double live;
+	{
+		std::lock_guard<std::mutex> lock(alloc_mutex);
+		alloc_sizes[ptr] = size;
+		live             = double(pool_bytes[pool] += size);
+	}
+	counter(pool, live);
+}
+
+void Frame_profiler::free(const void* ptr, const char* pool) {
+	double live;
+	{
+		std::lock_guard<std::mutex> lock(alloc_mutex);
+		auto                        it = alloc_sizes.find(ptr);
+		if (it == alloc_sizes.end()) {
+			return;    // From before start().
+		}
+		size_t& bytes = pool_bytes[pool];
+		bytes -= std::min(bytes, it->second);
+		live = double(bytes);
+		alloc_sizes.erase(it);
+	}
+	counter(pool, live);
+}
+
+void Frame_profiler::name_thread(const char* name) {
+	Thread_events&              thread = thread_events();
+	std::lock_guard<std::mutex> lock(thread.mutex);
+	thread.name = name;
+}
+
+Frame_profiler::Thread_events& Frame_profiler::thread_events() {
+	if (!current) {
+		auto                        thread = std::make_shared<Thread_events>();
+		std::lock_guard<std::mutex> lock(threads_mutex);
+		thread->tid = int(threads.size()) + 1;
+		threads.push_back(thread);
+		current = std::move(thread);
+	}
+	return *current;
+}
+
+void Frame_profiler::add(const Event& event) {
+	Thread_events&              thread = thread_events();
+	std::lock_guard<std::mutex> lock(thread.mutex);
+	if (!recording) {
+		return;    // Stopped since the caller looked.
+	}
+	if (thread.events.size() < max_thread_events) {
+		thread.events.push_back(event);
+	} else {
+		thread.dropped++;
+	}
+}
+
+std::int64_t Frame_profiler::since_epoch(Clock::time_point when) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   when.time_since_epoch())
+			.count();
+}
+
+std::int64_t Frame_profiler::since_origin(Clock::time_point when) const {
+	return since_epoch(when) - origin.load(std::memory_order_relaxed);
+}
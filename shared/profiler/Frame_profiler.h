@@ -0,0 +1,200 @@
+/*
+Copyright (C) 2026 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef INCL_FRAME_PROFILER_H
+#define INCL_FRAME_PROFILER_H 1
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ *  Timing of what the engines do each frame, for all of them and the NPC
+ *  library, to be looked at in chrome://tracing, Perfetto or Tracy.
+ *
+ *  The code is marked with the PROFILE_ macros below, which compile to
+ *  nothing unless the build defines ULTIMA_FRAME_TRACE or TRACY_ENABLE.
+ *  With TRACY_ENABLE they are Tracy's own, and Tracy's viewer connects
+ *  to the running engine.  With ULTIMA_FRAME_TRACE, a build can be sent
+ *  out as it is: nothing is kept until start() is called, from the
+ *  engine's settings or the ULTIMA_FRAME_TRACE environment variable, and
+ *  finish() writes what was kept as a Chrome trace.
+ *
+ *  Names must outlive the recording; string literals are best.
+ */
+class Frame_profiler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// The profiler of the whole program.  The first call starts it if
+	//   ULTIMA_FRAME_TRACE names a file.
+	static Frame_profiler& get();
+
+	Frame_profiler(const Frame_profiler&)            = delete;
+	Frame_profiler& operator=(const Frame_profiler&) = delete;
+
+	// Whether the PROFILE_ macros record anything in this build.
+	static constexpr bool compiled_in() {
+#ifdef ULTIMA_FRAME_TRACE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Start keeping events, for finish() to write to fname.  Returns
+	//   false if this build has no events to keep.
+	bool start(const std::string& fname);
+
+	// Stop, and write the events kept since start().  Returns false if
+	//   the file can't be written; true if there was nothing to do.
+	//   Called at exit if the program hasn't.
+	bool finish();
+
+	// Inline, so that code not being recorded only pays for the test.
+	static bool is_recording() {
+		return recording.load(std::memory_order_relaxed);
+	}
+
+	// What the macros call.
+	void zone(const char* name, Clock::time_point begin);
+	void counter(const char* name, double value);
+	void frame();
+	void alloc(const void* ptr, size_t size, const char* pool);
+	void free(const void* ptr, const char* pool);
+	void name_thread(const char* name);
+
+private:
+	struct Event {
+		const char*  name;
+		char         phase;    // As in the trace: 'X', 'C' or 'i'.
+		std::int64_t ts;       // Nanoseconds since start().
+		std::int64_t dur;
+		double       value;
+	};
+
+	// Each thread keeps its own events, locked only against finish().
+	struct Thread_events {
+		std::mutex         mutex;
+		int                tid;
+		std::string        name;
+		std::vector<Event> events;
+		size_t             dropped = 0;
+	};
+
+	static thread_local std::shared_ptr<Thread_events> current;
+
+	Frame_profiler();
+
+	static inline std::atomic<bool> recording{false};
+
+	// Nanoseconds since the clock's epoch, as threads may read them while
+	//   start() sets them.
+	std::atomic<std::int64_t> origin{0};
+	std::atomic<std::int64_t> last_frame{-1};    // Since origin.
+	std::string               trace_file;
+
+	std::mutex                                  threads_mutex;
+	std::vector<std::shared_ptr<Thread_events>> threads;
+
+	// Live bytes by pool, and what each pointer took from its pool.
+	std::mutex                              alloc_mutex;
+	std::unordered_map<const char*, size_t> pool_bytes;
+	std::unordered_map<const void*, size_t> alloc_sizes;
+
+	Thread_events& thread_events();
+	void           add(const Event& event);
+	std::int64_t   since_origin(Clock::time_point when) const;
+
+	static std::int64_t since_epoch(Clock::time_point when);
+};
+
+/*
+ *  Times from its creation to the end of its scope.
+ */
+class Profile_zone {
+	const char*                       name;
+	Frame_profiler::Clock::time_point begin;
+
+public:
+	explicit Profile_zone(const char* n)
+			: name(Frame_profiler::is_recording() ? n : nullptr) {
+		if (name) {
+			begin = Frame_profiler::Clock::now();
+		}
+	}
+
+	Profile_zone(const Profile_zone&)            = delete;
+	Profile_zone& operator=(const Profile_zone&) = delete;
+
+	~Profile_zone() {
+		if (name) {
+			Frame_profiler::get().zone(name, begin);
+		}
+	}
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT2(a, b)
+
+#if defined(TRACY_ENABLE)
+#	include <cstring>
+#	include <tracy/Tracy.hpp>
+#	define PROFILE_ZONE(name) ZoneScopedN(name)
+#	define PROFILE_ZONE_NAMED(name) \
+		ZoneScoped;                  \
+		ZoneName(name, std::strlen(name))
+#	define PROFILE_COUNTER(name, value) \
+		TracyPlot(name, static_cast<double>(value))
+#	define PROFILE_FRAME()                FrameMark
+#	define PROFILE_ALLOC(ptr, size, pool) TracyAllocN(ptr, size, pool)
+#	define PROFILE_FREE(ptr, pool)        TracyFreeN(ptr, pool)
+#	define PROFILE_THREAD(name)           tracy::SetThreadName(name)
+#elif defined(ULTIMA_FRAME_TRACE)
+#	define PROFILE_ZONE(name) \
+		Profile_zone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#	define PROFILE_ZONE_NAMED(name) PROFILE_ZONE(name)
+#	define PROFILE_IF_RECORDING(call)        \
+		do {                                   \
+			if (Frame_profiler::is_recording()) { \
+				Frame_profiler::get().call;    \
+			}                                  \
+		} while (0)
+#	define PROFILE_COUNTER(name, value) \
+		PROFILE_IF_RECORDING(counter(name, static_cast<double>(value)))
+#	define PROFILE_FRAME()                PROFILE_IF_RECORDING(frame())
+#	define PROFILE_ALLOC(ptr, size, pool) PROFILE_IF_RECORDING(alloc(ptr, size, pool))
+#	define PROFILE_FREE(ptr, pool)        PROFILE_IF_RECORDING(free(ptr, pool))
+#	define PROFILE_THREAD(name)           Frame_profiler::get().name_thread(name)
+#else
+#	define PROFILE_ZONE(name)             static_cast<void>(0)
+#	define PROFILE_ZONE_NAMED(name)       static_cast<void>(0)
+#	define PROFILE_COUNTER(name, value)   static_cast<void>(0)
+#	define PROFILE_FRAME()                static_cast<void>(0)
+#	define PROFILE_ALLOC(ptr, size, pool) static_cast<void>(0)
+#	define PROFILE_FREE(ptr, pool)        static_cast<void>(0)
+#	define PROFILE_THREAD(name)           static_cast<void>(0)
+#endif
+
+#endif
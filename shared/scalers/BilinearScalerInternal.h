@@ -25,6 +25,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <type_traits>
 #define COMPILE_ALL_BILINEAR_SCALERS
 
+// SSE2 is always there on x86-64 and NEON on 64 bit ARM, so the vector
+// versions of the filters below are picked at compile time. Define
+// BSI_NO_SIMD to use the plain C++ versions everywhere.
+#ifndef BSI_NO_SIMD
+#	if defined(__SSE2__) || defined(_M_X64) \
+			|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define BSI_USE_SSE2
+#		include <emmintrin.h>
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#		define BSI_USE_NEON
+#		include <arm_neon.h>
+#	endif
+#endif
+
 // Note BSI in these Macrsos is juat a standin for Bilinear Scaler Internal to
 // make sure they do not step on the toes of Macros that may have been defined
 // elsewhere
@@ -89,6 +103,104 @@ namespace Pentagram { namespace BilinearScaler {
 		return (b << 16) + (a - (b)) * fac;
 	}
 
+#ifdef BSI_USE_SSE2
+	// Filter the channels of 2 pixels of a 2x2 texel block at once, the first
+	// with horizontal coefficent fx1 and the second with fx2. Does exactly
+	// what the nested SimpleLerp8 calls do: the horizontal lerps can't exceed
+	// 16 bits so they are done in 16 bit lanes, and the vertical ones are
+	// widened to 32 bits. out gets the channels of the first pixel in
+	// bytes 0-3 and those of the second in bytes 4-7.
+	BSI_FORCE_INLINE void Lerp2x2BlockSIMD(
+			const uint8* const tl, const uint8* const bl, const uint8* const tr,
+			const uint8* const br, const uint_fast32_t fx1,
+			const uint_fast32_t fx2, const uint_fast32_t fy, uint8* out) {
+		auto load = [](const uint8* texel) {
+			int v;
+			std::memcpy(&v, texel, sizeof(v));
+			const __m128i c = _mm_unpacklo_epi8(
+					_mm_cvtsi32_si128(v), _mm_setzero_si128());
+			return _mm_unpacklo_epi64(c, c);
+		};
+		const short   x1   = static_cast<short>(fx1);
+		const short   x2   = static_cast<short>(fx2);
+		const short   y    = static_cast<short>(fy);
+		const __m128i vfx  = _mm_set_epi16(x2, x2, x2, x2, x1, x1, x1, x1);
+		const __m128i vnfx = _mm_sub_epi16(_mm_set1_epi16(256), vfx);
+		const __m128i vfy  = _mm_set1_epi16(y);
+		const __m128i vnfy = _mm_set1_epi16(static_cast<short>(256 - y));
+
+		const __m128i top = _mm_add_epi16(
+				_mm_mullo_epi16(load(tl), vfx),
+				_mm_mullo_epi16(load(tr), vnfx));
+		const __m128i bottom = _mm_add_epi16(
+				_mm_mullo_epi16(load(bl), vfx),
+				_mm_mullo_epi16(load(br), vnfx));
+
+		const __m128i top_lo    = _mm_mullo_epi16(top, vfy);
+		const __m128i top_hi    = _mm_mulhi_epu16(top, vfy);
+		const __m128i bottom_lo = _mm_mullo_epi16(bottom, vnfy);
+		const __m128i bottom_hi = _mm_mulhi_epu16(bottom, vnfy);
+
+		const __m128i first = _mm_srli_epi32(
+				_mm_add_epi32(
+						_mm_unpacklo_epi16(top_lo, top_hi),
+						_mm_unpacklo_epi16(bottom_lo, bottom_hi)),
+				16);
+		const __m128i second = _mm_srli_epi32(
+				_mm_add_epi32(
+						_mm_unpackhi_epi16(top_lo, top_hi),
+						_mm_unpackhi_epi16(bottom_lo, bottom_hi)),
+				16);
+		const __m128i packed = _mm_packs_epi32(first, second);
+		_mm_storel_epi64(
+				reinterpret_cast<__m128i*>(out),
+				_mm_packus_epi16(packed, packed));
+	}
+#elif defined(BSI_USE_NEON)
+	// Filter the channels of 2 pixels of a 2x2 texel block at once, the first
+	// with horizontal coefficent fx1 and the second with fx2. Does exactly
+	// what the nested SimpleLerp8 calls do: the horizontal lerps can't exceed
+	// 16 bits so they are done in 16 bit lanes, and the vertical ones are
+	// widened to 32 bits. out gets the channels of the first pixel in
+	// bytes 0-3 and those of the second in bytes 4-7.
+	BSI_FORCE_INLINE void Lerp2x2BlockSIMD(
+			const uint8* const tl, const uint8* const bl, const uint8* const tr,
+			const uint8* const br, const uint_fast32_t fx1,
+			const uint_fast32_t fx2, const uint_fast32_t fy, uint8* out) {
+		auto load = [](const uint8* texel) {
+			uint32 v;
+			std::memcpy(&v, texel, sizeof(v));
+			const uint16x4_t c = vget_low_u16(
+					vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(v))));
+			return vcombine_u16(c, c);
+		};
+		const uint16x8_t vfx = vcombine_u16(
+				vdup_n_u16(static_cast<uint16>(fx1)),
+				vdup_n_u16(static_cast<uint16>(fx2)));
+		const uint16x8_t vnfx = vsubq_u16(vdupq_n_u16(256), vfx);
+		const uint16x4_t vfy  = vdup_n_u16(static_cast<uint16>(fy));
+		const uint16x4_t vnfy = vdup_n_u16(static_cast<uint16>(256 - fy));
+
+		const uint16x8_t top
+				= vmlaq_u16(vmulq_u16(load(tl), vfx), load(tr), vnfx);
+		const uint16x8_t bottom
+				= vmlaq_u16(vmulq_u16(load(bl), vfx), load(br), vnfx);
+
+		const uint32x4_t first = vshrq_n_u32(
+				vmlal_u16(
+						vmull_u16(vget_low_u16(top), vfy),
+						vget_low_u16(bottom), vnfy),
+				16);
+		const uint32x4_t second = vshrq_n_u32(
+				vmlal_u16(
+						vmull_u16(vget_high_u16(top), vfy),
+						vget_high_u16(bottom), vnfy),
+				16);
+		vst1_u8(out,
+				vmovn_u16(vcombine_u16(vmovn_u32(first), vmovn_u32(second))));
+	}
+#endif
+
 	template <
 			class uintX, class Manip, class uintS,
 			typename limit_t = std::nullptr_t>
@@ -98,6 +210,13 @@ namespace Pentagram { namespace BilinearScaler {
 			const uint8* const br, const uint_fast32_t fx,
 			const uint_fast32_t fy, uint8* const pixel,
 			limit_t limit = nullptr) {
+#if defined(BSI_USE_SSE2) || defined(BSI_USE_NEON)
+		if (IsUnclipped(pixel, limit)) {
+			uint8 rgb[8];
+			Lerp2x2BlockSIMD(tl, bl, tr, br, fx, fx, fy, rgb);
+			WritePix<uintX>(pixel, Manip::rgb(rgb[0], rgb[1], rgb[2]), limit);
+		}
+#else
 		if (IsUnclipped(pixel, limit)) {
 			WritePix<uintX>(
 					pixel,
@@ -116,6 +235,7 @@ namespace Pentagram { namespace BilinearScaler {
 									>> 16),
 					limit);
 		}
+#endif
 	}
 
 	template <
@@ -135,10 +255,21 @@ namespace Pentagram { namespace BilinearScaler {
 			const uint8* const tl, const uint8* const bl, const uint8* const tr,
 			const uint8* const br, const uint_fast32_t x1, uint_fast32_t x2,
 			uint_fast32_t y, uint8* pixel, const limit_t limit = nullptr) {
+#if defined(BSI_USE_SSE2) || defined(BSI_USE_NEON)
+		if (IsUnclipped(pixel, limit)) {
+			uint8 rgb[8];
+			Lerp2x2BlockSIMD(tl, bl, tr, br, x1, x2, y, rgb);
+			WritePix<uintX>(pixel, Manip::rgb(rgb[0], rgb[1], rgb[2]), limit);
+			WritePix<uintX>(
+					pixel + sizeof(uintX), Manip::rgb(rgb[4], rgb[5], rgb[6]),
+					limit);
+		}
+#else
 		Interpolate2x2BlockTo1<uintX, Manip, uintS>(
 				tl, bl, tr, br, x1, y, pixel, limit);
 		Interpolate2x2BlockTo1<uintX, Manip, uintS>(
 				tl, bl, tr, br, x2, y, pixel + sizeof(uintX), limit);
+#endif
 	}
 
 	// Read 1 texel
@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2025 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "scale_bands.h"
+
+#include "Job_system.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+	int num_threads = 1;
+}    // namespace
+
+void Scaler_bands::set_threads(int n) {
+	if (n <= 0) {
+		const int cores = static_cast<int>(std::thread::hardware_concurrency());
+		n               = std::clamp(cores, 1, 8);
+	}
+	num_threads = n;
+	// The bands run on the job system, which needs the threads for them.
+	Job_system& jobs = Job_system::get();
+	if (jobs.get_threads() < n) {
+		jobs.set_threads(n);
+	}
+}
+
+int Scaler_bands::get_threads() {
+	return num_threads;
+}
+
+void Scaler_bands::run(int srcy, int srch, const Band_func& func) {
+	const int nbands
+			= std::min(num_threads, std::max(1, srch / min_band_rows));
+	if (nbands < 2) {
+		func(srcy, srch);
+		return;
+	}
+	const int band_rows = (srch + nbands - 1) / nbands;
+	const int num_bands = (srch + band_rows - 1) / band_rows;
+	Job_system::get().run("scaler", num_bands, [&](size_t band) {
+		const int y = srcy + static_cast<int>(band) * band_rows;
+		func(y, std::min(band_rows, srcy + srch - y));
+	});
+}
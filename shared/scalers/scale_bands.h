@@ -0,0 +1,48 @@
+/*
+Copyright (C) 2025 The Exult Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef INCL_SCALE_BANDS_H
+#define INCL_SCALE_BANDS_H 1
+
+#include <functional>
+
+/*
+ *  Runs a scaler over horizontal bands of the source rectangle, on the
+ *  job system's threads.  Each band still reads the rows around it from
+ *  the whole source, so the bands overlap by the rows the filter needs
+ *  while each writes only its own destination rows.
+ */
+class Scaler_bands {
+public:
+	// Band functions get the first source row and the number of rows.
+	using Band_func = std::function<void(int srcy, int srch)>;
+
+	// Bands shorter than this are not split any further.
+	static constexpr int min_band_rows = 16;
+
+	// Set how many threads scale, including the one calling run().
+	//   Zero picks one per CPU core (at most 8); one scales serially.
+	static void set_threads(int n);
+
+	static int get_threads();
+
+	// Scale rows srcy to srcy + srch - 1, returning when all bands are done.
+	static void run(int srcy, int srch, const Band_func& func);
+};
+
+#endif
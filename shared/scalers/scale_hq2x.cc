@@ -40,6 +40,7 @@
 #	include "common_types.h"
 #	include "imagewin.h"
 #	include "manip.h"
+#	include "scale_bands.h"
 #	include "scale_hq2x.h"
 
 #	include <cstdlib>
@@ -57,12 +58,15 @@ void Image_window::show_scaled8to16_Hq2x(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to16 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_Hq2x<uint16, Manip8to16>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_Hq2x<uint16, Manip8to16>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to555_Hq2x(
@@ -74,12 +78,15 @@ void Image_window::show_scaled8to555_Hq2x(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to555 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_Hq2x<uint16, Manip8to555>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_Hq2x<uint16, Manip8to555>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to565_Hq2x(
@@ -91,12 +98,15 @@ void Image_window::show_scaled8to565_Hq2x(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to565 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_Hq2x<uint16, Manip8to565>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_Hq2x<uint16, Manip8to565>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to32_Hq2x(
@@ -108,12 +118,15 @@ void Image_window::show_scaled8to32_Hq2x(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to32 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_Hq2x<uint32, Manip8to32>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint32*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_Hq2x<uint32, Manip8to32>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint32*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 #endif    // USE_HQ2X_SCALER
@@ -30,6 +30,7 @@
 #	include "common_types.h"
 #	include "imagewin.h"
 #	include "manip.h"
+#	include "scale_bands.h"
 #	include "scale_xbr.h"
 
 #	include <cstdlib>
@@ -47,12 +48,15 @@ void Image_window::show_scaled8to16_2xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to16 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to16, Scaler2xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to16, Scaler2xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to555_2xBR(
@@ -64,12 +68,15 @@ void Image_window::show_scaled8to555_2xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to555 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to555, Scaler2xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to555, Scaler2xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to565_2xBR(
@@ -81,12 +88,15 @@ void Image_window::show_scaled8to565_2xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to565 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to565, Scaler2xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to565, Scaler2xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to32_2xBR(
@@ -98,12 +108,15 @@ void Image_window::show_scaled8to32_2xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to32 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint32, Manip8to32, Scaler2xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint32*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint32, Manip8to32, Scaler2xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint32*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 //
@@ -118,12 +131,15 @@ void Image_window::show_scaled8to16_3xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to16 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to16, Scaler3xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to16, Scaler3xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to555_3xBR(
@@ -135,12 +151,15 @@ void Image_window::show_scaled8to555_3xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to555 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to555, Scaler3xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to555, Scaler3xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to565_3xBR(
@@ -152,12 +171,15 @@ void Image_window::show_scaled8to565_3xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to565 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to565, Scaler3xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to565, Scaler3xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to32_3xBR(
@@ -169,12 +191,15 @@ void Image_window::show_scaled8to32_3xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to32 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint32, Manip8to32, Scaler3xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint32*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint32, Manip8to32, Scaler3xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint32*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 //
@@ -189,12 +214,15 @@ void Image_window::show_scaled8to16_4xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to16 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to16, Scaler4xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to16, Scaler4xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to555_4xBR(
@@ -206,12 +234,15 @@ void Image_window::show_scaled8to555_4xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to555 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to555, Scaler4xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to555, Scaler4xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to565_4xBR(
@@ -223,12 +254,15 @@ void Image_window::show_scaled8to565_4xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to565 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint16, Manip8to565, Scaler4xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint16*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint16, Manip8to565, Scaler4xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint16*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 void Image_window::show_scaled8to32_4xBR(
@@ -240,12 +274,15 @@ void Image_window::show_scaled8to32_4xBR(
 			= SDL_GetSurfacePalette(paletted_surface);
 	const Manip8to32 manip(
 			paletted_surface_palette->colors, inter_surface_format);
-	Scale_xBR<uint32, Manip8to32, Scaler4xBR>(
-			static_cast<uint8*>(draw_surface->pixels), x + guard_band,
-			y + guard_band, w, h, ibuf->line_width, ibuf->height + guard_band,
-			static_cast<uint32*>(inter_surface->pixels),
-			inter_surface->pitch / inter_surface_format->bytes_per_pixel,
-			manip);
+	// Scale bands of rows on the scaler threads.
+	Scaler_bands::run(y + guard_band, h, [&](int srcy, int srch) {
+		Scale_xBR<uint32, Manip8to32, Scaler4xBR>(
+				static_cast<uint8*>(draw_surface->pixels), x + guard_band, srcy,
+				w, srch, ibuf->line_width, ibuf->height + guard_band,
+				static_cast<uint32*>(inter_surface->pixels),
+				inter_surface->pitch / inter_surface_format->bytes_per_pixel,
+				manip);
+	});
 }
 
 // calculate input matrix coordinates after rotation at compile time
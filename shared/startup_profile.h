@@ -0,0 +1,157 @@
+/*
+ *  startup_profile.h - Timing of the phases of engine startup.
+ *
+ *  Copyright (C) 2000-2022  The Exult Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ *  The phases of startup, in the order they were entered.  A phase
+ *  entered while another is running is nested in it.  Startup runs on one
+ *  thread, and so does this.
+ */
+class Startup_profile {
+	using Clock = std::chrono::steady_clock;
+
+	struct Phase {
+		std::string  name;
+		int          depth;
+		std::int64_t start;       // Microseconds since the first phase.
+		std::int64_t duration;    // -1 while it runs.
+	};
+
+	Clock::time_point  origin;
+	std::vector<Phase> phases;
+	int                depth = 0;
+
+	std::int64_t now() const {
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+					   Clock::now() - origin)
+				.count();
+	}
+
+public:
+	static Startup_profile& get() {
+		static Startup_profile profile;
+		return profile;
+	}
+
+	// Start a phase, returning its index for end().
+	size_t begin(const char* name) {
+		if (phases.empty()) {
+			origin = Clock::now();
+		}
+		phases.push_back(Phase{name, depth++, now(), -1});
+		return phases.size() - 1;
+	}
+
+	void end(size_t index) {
+		if (index < phases.size()) {
+			phases[index].duration = now() - phases[index].start;
+			depth                  = phases[index].depth;
+		}
+	}
+
+	bool empty() const {
+		return phases.empty();
+	}
+
+	void clear() {
+		phases.clear();
+		depth = 0;
+	}
+
+	// Print the tree of phases with their times.
+	void report(std::ostream& out) const {
+		const std::ios::fmtflags flags = out.flags();
+		const std::streamsize    prec  = out.precision();
+		out << "Startup times:" << std::endl;
+		for (const auto& phase : phases) {
+			out << "  " << std::string(2 * phase.depth, ' ') << phase.name
+				<< ": ";
+			if (phase.duration < 0) {
+				out << "(running)";
+			} else {
+				out << std::fixed << std::setprecision(1)
+					<< phase.duration / 1000.0 << " ms";
+			}
+			out << std::endl;
+		}
+		out.flags(flags);
+		out.precision(prec);
+	}
+
+	// Write the phases as a Chrome trace (for chrome://tracing or
+	// Perfetto).  Returns false if the file can't be written.
+	bool write_trace(const std::string& fname) const {
+		std::ofstream out(fname.c_str());
+		if (!out) {
+			return false;
+		}
+		out << "{\"traceEvents\":[";
+		const char* sep = "\n";
+		for (const auto& phase : phases) {
+			if (phase.duration < 0) {
+				continue;
+			}
+			out << sep << "{\"name\":\"";
+			for (const char c : phase.name) {
+				if (c == '"' || c == '\\') {
+					out << '\\';
+				}
+				out << c;
+			}
+			out << "\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+				<< "\"ts\":" << phase.start << ",\"dur\":" << phase.duration
+				<< '}';
+			sep = ",\n";
+		}
+		out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+		return out.good();
+	}
+};
+
+/*
+ *  Times one phase of startup, from its creation to the end of its scope.
+ */
+class Startup_phase {
+	size_t index;
+
+public:
+	explicit Startup_phase(const char* name)
+			: index(Startup_profile::get().begin(name)) {}
+
+	Startup_phase(const Startup_phase&)            = delete;
+	Startup_phase& operator=(const Startup_phase&) = delete;
+
+	~Startup_phase() {
+		Startup_profile::get().end(index);
+	}
+};
+
+#endif
@@ -813,7 +813,51 @@ class CoordinateTransformer:
         return (chunk_x, chunk_y, local_x, local_y)
 
 
+# =============================================================================
+# DATA FILE EXPORT (for the native converter)
+# =============================================================================
+
+def export_mapping(path):
+    """
+    Write the tables above as a plain text file for the C++ osm2ultima.
+    Each line is a table name followed by its key and value(s):
+        terrain <name> <shape>...
+        object <name> <shape>...
+        building <type> <component> <object name>
+        <tag>_terrain <value> <terrain name>
+        <tag>_object <value> <object name>
+    """
+    tables = [
+        ("landuse_terrain", OSM_LANDUSE_TO_TERRAIN),
+        ("natural_terrain", OSM_NATURAL_TO_TERRAIN),
+        ("surface_terrain", OSM_SURFACE_TO_TERRAIN),
+        ("highway_terrain", OSM_HIGHWAY_TO_TERRAIN),
+        ("waterway_terrain", OSM_WATERWAY_TO_TERRAIN),
+        ("amenity_object", OSM_AMENITY_TO_SHAPE),
+        ("natural_object", OSM_NATURAL_TO_SHAPE),
+        ("barrier_object", OSM_BARRIER_TO_SHAPE),
+        ("man_made_object", OSM_MAN_MADE_TO_SHAPE),
+    ]
+    with open(path, "w") as f:
+        f.write("# Generated by osm_shape_mapping.py --export; do not edit.\n")
+        for name, shapes in TERRAIN_SHAPES.items():
+            f.write(f"terrain {name} {' '.join(map(str, shapes))}\n")
+        for name, shapes in OBJECT_SHAPES.items():
+            f.write(f"object {name} {' '.join(map(str, shapes))}\n")
+        for building, components in OSM_BUILDING_TO_SHAPES.items():
+            for component, shape_name in components.items():
+                f.write(f"building {building} {component} {shape_name}\n")
+        for table, entries in tables:
+            for key, value in entries.items():
+                f.write(f"{table} {key} {value}\n")
+
+
 if __name__ == "__main__":
+    import sys
+    if len(sys.argv) == 3 and sys.argv[1] == "--export":
+        export_mapping(sys.argv[2])
+        sys.exit(0)
+
     # Test the mapping
     print("=== OSM to Ultima Shape Mapping Test ===\n")
     
@@ -0,0 +1,51 @@
+#!/bin/bash
+# Build a game data image for streaming to the web launcher
+# Usage: build-gameimage.sh <game-id> <game-data-dir>
+#
+# The image is served as assets/games/<game-id>.ext2 and mounted at /game.
+# CheerpX reads it with range requests, through the game data service
+# worker, so only the parts the engine reads are fetched.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+GAME_ID="$1"
+DATA_DIR="$2"
+OUTPUT_DIR="$SCRIPT_DIR/games"
+OUTPUT_FILE="$OUTPUT_DIR/$GAME_ID.ext2"
+
+if [ -z "$GAME_ID" ] || [ ! -d "$DATA_DIR" ]; then
+    echo "Usage: $0 <game-id> <game-data-dir>"
+    echo "  e.g. $0 u7bg ~/ultima7"
+    exit 1
+fi
+
+echo "=== Building Game Data Image ==="
+echo "Game: $GAME_ID"
+echo "Data: $DATA_DIR"
+echo "Output: $OUTPUT_FILE"
+
+# Check for required tools
+command -v genext2fs >/dev/null 2>&1 || { echo "Error: genext2fs not installed. Run: apt install genext2fs"; exit 1; }
+
+# Data size + 25% headroom for the filesystem itself
+DATA_SIZE=$(du -s "$DATA_DIR" | cut -f1)
+IMAGE_BLOCKS=$((DATA_SIZE * 5 / 4 + 1024))
+FILE_COUNT=$(find "$DATA_DIR" | wc -l)
+
+mkdir -p "$OUTPUT_DIR"
+echo "Creating ext2 image ($IMAGE_BLOCKS blocks)..."
+rm -f "$OUTPUT_FILE"
+genext2fs -d "$DATA_DIR" -b $IMAGE_BLOCKS -N $((FILE_COUNT + 64)) "$OUTPUT_FILE"
+
+# Block offsets change with the image, so an old list no longer fits
+if [ -f "$OUTPUT_DIR/$GAME_ID.prefetch" ]; then
+    echo "Removing prefetch list of the previous image..."
+    rm -f "$OUTPUT_DIR/$GAME_ID.prefetch"
+fi
+
+echo ""
+echo "=== Build Complete ==="
+ls -lh "$OUTPUT_FILE"
+echo ""
+echo "Record a prefetch list for it as described in web/README.md."
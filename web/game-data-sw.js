@@ -0,0 +1,135 @@
+/**
+ * Game Data Service Worker
+ * Answers the range requests CheerpX makes for streamed game images
+ * from the block cache, so the engines fetch only the parts of the game
+ * data they read, and each part only once
+ */
+
+importScripts('js/block-cache.js');
+
+// Game images, as cheerpx-engine.js names them
+const STREAMED_IMAGE = /\/assets\/games\/[^/]+\.ext2$/;
+
+self.addEventListener('install', () => {
+    self.skipWaiting();
+});
+
+self.addEventListener('activate', (event) => {
+    event.waitUntil(self.clients.claim());
+});
+
+self.addEventListener('fetch', (event) => {
+    const request = event.request;
+    const url = new URL(request.url);
+
+    if (url.origin !== self.location.origin ||
+        !STREAMED_IMAGE.test(url.pathname)) {
+        return;
+    }
+
+    if (request.method === 'HEAD') {
+        event.respondWith(serveHead(url.href));
+    } else if (request.method === 'GET' && request.headers.has('Range')) {
+        event.respondWith(serveRange(url.href, request.headers.get('Range')));
+    }
+});
+
+function headers(extra) {
+    return new Headers({
+        'Accept-Ranges': 'bytes',
+        'Content-Type': 'application/octet-stream',
+        'Cross-Origin-Resource-Policy': 'same-origin',
+        ...extra
+    });
+}
+
+async function serveHead(url) {
+    try {
+        const info = await BlockCache.open(url);
+        return new Response(null, {
+            status: 200,
+            headers: headers({ 'Content-Length': String(info.size) })
+        });
+    } catch (error) {
+        console.error('[GameDataSW]', error);
+        return new Response(null, { status: 404 });
+    }
+}
+
+async function serveRange(url, range) {
+    try {
+        const info = await BlockCache.open(url);
+
+        // A single range is all CheerpX asks for
+        const match = /^bytes=(\d*)-(\d*)$/.exec(range.trim());
+        if (!match || (match[1] === '' && match[2] === '')) {
+            return fetch(url);
+        }
+
+        let start;
+        let end;
+        if (match[1] === '') {
+            start = Math.max(info.size - parseInt(match[2], 10), 0);
+            end = info.size;
+        } else {
+            start = parseInt(match[1], 10);
+            end = match[2] === '' ? info.size
+                                  : Math.min(parseInt(match[2], 10) + 1, info.size);
+        }
+
+        if (start >= info.size || start >= end) {
+            return new Response(null, {
+                status: 416,
+                headers: headers({ 'Content-Range': `bytes */${info.size}` })
+            });
+        }
+
+        const data = await BlockCache.read(url, start, end);
+        return new Response(data, {
+            status: 206,
+            headers: headers({
+                'Content-Length': String(data.length),
+                'Content-Range': `bytes ${start}-${end - 1}/${info.size}`
+            })
+        });
+    } catch (error) {
+        console.error('[GameDataSW]', error);
+        return new Response(null, { status: 502 });
+    }
+}
+
+/**
+ * Requests from the page: { type, url, list }, answered on the port
+ * that comes with them
+ */
+self.addEventListener('message', (event) => {
+    const { type, url, list } = event.data || {};
+    const port = event.ports[0];
+    const reply = (message) => port && port.postMessage(message);
+
+    let work;
+    switch (type) {
+        case 'prefetch':
+            work = BlockCache.prefetch(url, list, (progress) => {
+                reply({ progress });
+            });
+            break;
+        case 'trace-start':
+            BlockCache.startTrace(url);
+            work = Promise.resolve(true);
+            break;
+        case 'trace-stop':
+            work = BlockCache.stopTrace();
+            break;
+        case 'clear':
+            work = BlockCache.clear(url);
+            break;
+        default:
+            return;
+    }
+
+    event.waitUntil(work.then(
+        (result) => reply({ done: true, result }),
+        (error) => reply({ done: true, error: String(error) })
+    ));
+});
@@ -0,0 +1,473 @@
+/**
+ * Block Cache
+ * Reads large game data images in fixed-size blocks through HTTP range
+ * requests, keeping the blocks in IndexedDB so later launches need no
+ * network at all. Used by the game data service worker, which answers
+ * the engine's range requests from it.
+ */
+
+const BlockCache = (function() {
+    'use strict';
+
+    const BLOCK_SIZE = 64 * 1024;
+    // Most blocks fetched by a single range request
+    const MAX_RUN = 32;
+    // Blocks also kept in memory, most recently used last
+    const MEMORY_BLOCKS = 256;
+
+    const DB_NAME = 'UltimaBlockCache';
+    const DB_VERSION = 1;
+    const STORE = 'blocks';
+
+    const LIST_MAGIC = '# Ultima prefetch list 1';
+
+    let db = null;
+    let dbPromise = null;
+    const images = new Map();       // url -> Promise<info>
+    const memory = new Map();       // key -> Uint8Array
+    const inFlight = new Map();     // key -> Promise<Uint8Array>
+    let trace = null;
+
+    /**
+     * Open the block database, or carry on with memory only if there is
+     * no IndexedDB here
+     */
+    async function openDB() {
+        if (db || typeof indexedDB === 'undefined') return db;
+        if (dbPromise) return dbPromise;
+
+        dbPromise = new Promise((resolve) => {
+            const request = indexedDB.open(DB_NAME, DB_VERSION);
+
+            request.onerror = () => {
+                console.warn('[BlockCache] No block database:', request.error);
+                resolve(null);
+            };
+
+            request.onsuccess = () => {
+                db = request.result;
+                resolve(db);
+            };
+
+            request.onupgradeneeded = (event) => {
+                const database = event.target.result;
+                if (!database.objectStoreNames.contains(STORE)) {
+                    database.createObjectStore(STORE);
+                }
+            };
+        });
+
+        return dbPromise;
+    }
+
+    /**
+     * Find the size and version of an image
+     * @param {string} url - Image URL
+     * @returns {Promise<Object>} { url, size, version, blocks }
+     */
+    function open(url) {
+        if (!images.has(url)) {
+            const info = probe(url);
+            images.set(url, info);
+            info.catch(() => images.delete(url));
+        }
+        return images.get(url);
+    }
+
+    async function probe(url) {
+        const response = await fetch(url, {
+            method: 'HEAD',
+            cache: 'no-cache'
+        });
+        if (!response.ok) {
+            throw new Error(`Cannot open ${url}: ${response.status}`);
+        }
+
+        const size = parseInt(response.headers.get('Content-Length'), 10);
+        if (!(size >= 0)) {
+            throw new Error(`No size for ${url}`);
+        }
+
+        // Blocks of an image that was rebuilt must not be mixed with
+        // the new one's
+        const version = response.headers.get('ETag') ||
+                        response.headers.get('Last-Modified') ||
+                        String(size);
+
+        return {
+            url,
+            size,
+            version,
+            blocks: Math.ceil(size / BLOCK_SIZE)
+        };
+    }
+
+    function blockKey(info, index) {
+        return `${info.url}|${info.version}|${index}`;
+    }
+
+    function remember(key, data) {
+        memory.delete(key);
+        memory.set(key, data);
+        if (memory.size > MEMORY_BLOCKS) {
+            memory.delete(memory.keys().next().value);
+        }
+    }
+
+    async function loadStored(keys) {
+        const database = await openDB();
+        if (!database) return keys.map(() => undefined);
+
+        return new Promise((resolve) => {
+            const tx = database.transaction(STORE, 'readonly');
+            const store = tx.objectStore(STORE);
+            const found = new Array(keys.length);
+
+            keys.forEach((key, i) => {
+                const request = store.get(key);
+                request.onsuccess = () => {
+                    found[i] = request.result &&
+                               new Uint8Array(request.result);
+                };
+            });
+
+            tx.oncomplete = () => resolve(found);
+            tx.onerror = () => resolve(found);
+        });
+    }
+
+    async function store(entries) {
+        const database = await openDB();
+        if (!database) return;
+
+        return new Promise((resolve) => {
+            const tx = database.transaction(STORE, 'readwrite');
+            const objects = tx.objectStore(STORE);
+            for (const [key, data] of entries) {
+                objects.put(data.buffer, key);
+            }
+            tx.oncomplete = () => resolve();
+            // A full quota only costs the next launch a fetch
+            tx.onerror = () => resolve();
+            tx.onabort = () => resolve();
+        });
+    }
+
+    /**
+     * Fetch a run of blocks with one range request
+     */
+    async function fetchRun(info, first, last) {
+        const start = first * BLOCK_SIZE;
+        const end = Math.min((last + 1) * BLOCK_SIZE, info.size);
+
+        const response = await fetch(info.url, {
+            headers: { Range: `bytes=${start}-${end - 1}` },
+            cache: 'no-store'
+        });
+
+        let bytes;
+        let base;
+        if (response.status === 206) {
+            bytes = new Uint8Array(await response.arrayBuffer());
+            base = first;
+        } else if (response.ok) {
+            // The server ignores ranges; keep all of it, as this is the
+            // only read there will be
+            bytes = new Uint8Array(await response.arrayBuffer());
+            base = 0;
+            last = info.blocks - 1;
+        } else {
+            throw new Error(`Range ${start}-${end - 1} of ${info.url}: ` +
+                            `${response.status}`);
+        }
+
+        const entries = [];
+        for (let index = base; index <= last; index++) {
+            const from = (index - base) * BLOCK_SIZE;
+            if (from >= bytes.length) break;
+            const data = bytes.slice(from, from + BLOCK_SIZE);
+            const key = blockKey(info, index);
+            remember(key, data);
+            entries.push([key, data]);
+        }
+        await store(entries);
+
+        const blocks = new Map();
+        for (const [key, data] of entries) {
+            blocks.set(key, data);
+        }
+        return blocks;
+    }
+
+    /**
+     * Get a number of blocks, fetching those in neither memory nor the
+     * database in as few requests as possible
+     * @param {Object} info - From open()
+     * @param {number[]} indices - Block numbers, ascending
+     * @returns {Promise<Uint8Array[]>} The blocks, in the same order
+     */
+    async function getBlocks(info, indices) {
+        const result = new Array(indices.length);
+        const waits = [];
+        let unknown = [];
+
+        indices.forEach((index, i) => {
+            const key = blockKey(info, index);
+            if (memory.has(key)) {
+                result[i] = memory.get(key);
+                remember(key, result[i]);
+            } else if (inFlight.has(key)) {
+                waits.push(inFlight.get(key).then(data => { result[i] = data; }));
+            } else {
+                unknown.push(i);
+            }
+        });
+
+        if (unknown.length > 0) {
+            const stored = await loadStored(
+                unknown.map(i => blockKey(info, indices[i])));
+            const missing = [];
+            unknown.forEach((i, n) => {
+                if (stored[n]) {
+                    result[i] = stored[n];
+                    remember(blockKey(info, indices[i]), stored[n]);
+                } else {
+                    missing.push(i);
+                }
+            });
+            unknown = missing;
+        }
+
+        // Another read may have started on these while the database was
+        // looked in
+        const fetching = [];
+        for (const i of unknown) {
+            const key = blockKey(info, indices[i]);
+            if (inFlight.has(key)) {
+                waits.push(inFlight.get(key).then(data => { result[i] = data; }));
+            } else {
+                fetching.push(i);
+            }
+        }
+
+        for (let n = 0; n < fetching.length;) {
+            // A run of consecutive blocks, not too long
+            let end = n + 1;
+            while (end < fetching.length && end - n < MAX_RUN &&
+                   indices[fetching[end]] === indices[fetching[end - 1]] + 1) {
+                end++;
+            }
+
+            const run = fetching.slice(n, end);
+            const first = indices[run[0]];
+            const last = indices[run[run.length - 1]];
+            const request = fetchRun(info, first, last);
+
+            for (const i of run) {
+                const key = blockKey(info, indices[i]);
+                const block = request.then(blocks => blocks.get(key));
+                inFlight.set(key, block);
+                waits.push(block.then(data => { result[i] = data; }));
+                block.catch(() => {}).finally(() => inFlight.delete(key));
+            }
+            n = end;
+        }
+
+        await Promise.all(waits);
+        return result;
+    }
+
+    function noteTrace(info, first, last) {
+        if (!trace || trace.url !== info.url) return;
+        for (let index = first; index <= last; index++) {
+            if (!trace.seen.has(index)) {
+                trace.seen.add(index);
+                trace.order.push(index);
+            }
+        }
+    }
+
+    /**
+     * Read part of an image
+     * @param {string} url - Image URL
+     * @param {number} start - First byte
+     * @param {number} end - Byte after the last
+     * @returns {Promise<Uint8Array>}
+     */
+    async function read(url, start, end) {
+        const info = await open(url);
+        end = Math.min(end, info.size);
+        if (start >= end) return new Uint8Array(0);
+
+        const first = Math.floor(start / BLOCK_SIZE);
+        const last = Math.floor((end - 1) / BLOCK_SIZE);
+        noteTrace(info, first, last);
+
+        const indices = [];
+        for (let index = first; index <= last; index++) {
+            indices.push(index);
+        }
+        const blocks = await getBlocks(info, indices);
+
+        const out = new Uint8Array(end - start);
+        let pos = 0;
+        blocks.forEach((data, n) => {
+            const base = (first + n) * BLOCK_SIZE;
+            const from = Math.max(start - base, 0);
+            const to = Math.min(end - base, data.length);
+            out.set(data.subarray(from, to), pos);
+            pos += to - from;
+        });
+        return out;
+    }
+
+    /**
+     * Parse a prefetch list
+     * @param {string} text - The list
+     * @param {Object} info - From open(), for the image it must be for
+     * @returns {number[][]|null} [first, last] block runs, or null if the
+     *                            list is for another build of the image
+     */
+    function parseList(text, info) {
+        const lines = text.split('\n').map(line => line.trim());
+        if (lines[0] !== LIST_MAGIC) return null;
+
+        const runs = [];
+        for (const line of lines.slice(1)) {
+            if (line === '' || line.startsWith('#')) continue;
+
+            const [word, value] = line.split(/\s+/);
+            if (word === 'size') {
+                if (parseInt(value, 10) !== info.size) return null;
+            } else if (word === 'block') {
+                if (parseInt(value, 10) !== BLOCK_SIZE) return null;
+            } else {
+                const [first, last = first] = word.split('-').map(Number);
+                if (first >= 0 && last >= first && last < info.blocks) {
+                    runs.push([first, last]);
+                }
+            }
+        }
+        return runs;
+    }
+
+    /**
+     * Fetch the blocks named in a prefetch list, in its order
+     * @param {string} url - Image URL
+     * @param {string} text - The list, as recorded by stopTrace()
+     * @param {Function} onProgress - Progress callback
+     * @returns {Promise<number>} Blocks in the list, or -1 if it doesn't
+     *                            fit the image
+     */
+    async function prefetch(url, text, onProgress = null) {
+        const info = await open(url);
+        const runs = parseList(text, info);
+        if (!runs) {
+            console.warn(`[BlockCache] Prefetch list is not for ${url}`);
+            return -1;
+        }
+
+        const total = runs.reduce((sum, [first, last]) => sum + last - first + 1, 0);
+        let done = 0;
+
+        for (const [first, last] of runs) {
+            for (let index = first; index <= last; index += MAX_RUN) {
+                const indices = [];
+                for (let i = index; i <= Math.min(last, index + MAX_RUN - 1); i++) {
+                    indices.push(i);
+                }
+                await getBlocks(info, indices);
+                done += indices.length;
+
+                if (onProgress) {
+                    onProgress({
+                        current: done,
+                        total,
+                        percent: Math.round((done / total) * 100)
+                    });
+                }
+            }
+        }
+
+        return total;
+    }
+
+    /**
+     * Start recording which blocks of an image are read, and in what
+     * order, to make a prefetch list from
+     * @param {string} url - Image URL
+     */
+    function startTrace(url) {
+        trace = { url, seen: new Set(), order: [] };
+    }
+
+    /**
+     * Stop recording
+     * @returns {Promise<string|null>} The prefetch list, or null if
+     *                                 nothing was being recorded
+     */
+    async function stopTrace() {
+        if (!trace) return null;
+        const { url, order } = trace;
+        trace = null;
+
+        const info = await open(url);
+        const lines = [
+            LIST_MAGIC,
+            `size ${info.size}`,
+            `block ${BLOCK_SIZE}`
+        ];
+
+        // Runs of consecutive blocks, in the order they were first read
+        for (let n = 0; n < order.length;) {
+            let end = n + 1;
+            while (end < order.length && order[end] === order[end - 1] + 1) {
+                end++;
+            }
+            const first = order[n];
+            const last = order[end - 1];
+            lines.push(first === last ? `${first}` : `${first}-${last}`);
+            n = end;
+        }
+
+        return lines.join('\n') + '\n';
+    }
+
+    /**
+     * Forget all the blocks of an image
+     * @param {string} url - Image URL
+     */
+    async function clear(url) {
+        for (const key of [...memory.keys()]) {
+            if (key.startsWith(`${url}|`)) memory.delete(key);
+        }
+        images.delete(url);
+
+        const database = await openDB();
+        if (!database) return;
+
+        return new Promise((resolve, reject) => {
+            const tx = database.transaction(STORE, 'readwrite');
+            const range = IDBKeyRange.bound(`${url}|`, `${url}|￿`);
+            tx.objectStore(STORE).delete(range);
+            tx.oncomplete = () => resolve();
+            tx.onerror = () => reject(tx.error);
+        });
+    }
+
+    // Public API
+    return {
+        open,
+        read,
+        prefetch,
+        startTrace,
+        stopTrace,
+        clear,
+        BLOCK_SIZE
+    };
+})();
+
+// Export for module systems
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = BlockCache;
+}
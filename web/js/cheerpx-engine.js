@@ -33,6 +33,12 @@ const CheerpXEngine = (function() {
         }
     };
 
+    // Game images streamed from the server, with their prefetch lists
+    const STREAMING = {
+        worker: 'game-data-sw.js',
+        images: 'assets/games'
+    };
+
     // State
     let cxInstance = null;
     let isLoaded = false;
@@ -136,6 +142,139 @@ const CheerpXEngine = (function() {
         console.log(`[CheerpX] Game data mounted at ${mountPoint}`);
     }
 
+    /**
+     * Start the service worker that streams game images, if this browser
+     * has service workers
+     * @returns {Promise<boolean>} Whether game images can be streamed
+     */
+    async function enableStreaming() {
+        if (!('serviceWorker' in navigator)) return false;
+
+        try {
+            await navigator.serviceWorker.register(STREAMING.worker);
+            await navigator.serviceWorker.ready;
+        } catch (error) {
+            console.warn('[CheerpX] Game data streaming unavailable:', error);
+            return false;
+        }
+
+        // The first time, the page is only controlled once the worker
+        // has claimed it
+        if (!navigator.serviceWorker.controller) {
+            await new Promise((resolve) => {
+                navigator.serviceWorker.addEventListener(
+                    'controllerchange', resolve, { once: true });
+            });
+        }
+        return true;
+    }
+
+    /**
+     * Send a request to the streaming service worker
+     * @param {Object} message - { type, url, list }
+     * @param {Function} onProgress - Progress callback
+     */
+    function streamRequest(message, onProgress = null) {
+        const worker = navigator.serviceWorker &&
+                       navigator.serviceWorker.controller;
+        if (!worker) {
+            return Promise.reject(new Error('Game data streaming not enabled'));
+        }
+
+        return new Promise((resolve, reject) => {
+            const channel = new MessageChannel();
+            channel.port1.onmessage = (event) => {
+                const { progress, done, result, error } = event.data;
+                if (progress && onProgress) onProgress(progress);
+                if (!done) return;
+                channel.port1.close();
+                if (error) reject(new Error(error));
+                else resolve(result);
+            };
+            worker.postMessage(message, [channel.port2]);
+        });
+    }
+
+    function gameImageUrl(gameId) {
+        return new URL(`${STREAMING.images}/${gameId}.ext2`, location.href).href;
+    }
+
+    /**
+     * Check whether the server has a streamed image of a game
+     * @param {string} gameId - Game identifier
+     */
+    async function hasStreamedGame(gameId) {
+        try {
+            const response = await fetch(gameImageUrl(gameId), { method: 'HEAD' });
+            return response.ok;
+        } catch (error) {
+            return false;
+        }
+    }
+
+    /**
+     * Mount a game image from the server, read in blocks as the engine
+     * needs them, and fetch the blocks a startup reads ahead of it
+     * @param {string} gameId - Game identifier
+     * @param {string} mountPoint - Mount path (e.g., '/game')
+     * @param {Function} onProgress - Prefetch progress callback
+     * @returns {Promise<number>} Resolves once the prefetch is done, with
+     *                            the blocks fetched, or -1 if there was
+     *                            no list for the image
+     */
+    async function mountStreamedGame(gameId, mountPoint = '/game', onProgress = null) {
+        if (!cxInstance) {
+            throw new Error('CheerpX not initialized');
+        }
+
+        const url = gameImageUrl(gameId);
+
+        // Reads go through the service worker; saved games go to the
+        // writable layer
+        const overlay = await CheerpX.OverlayDevice.create(
+            await CheerpX.HttpBytesDevice.create(url),
+            await CheerpX.IDBDevice.create(`game-saves-${gameId}`)
+        );
+        await cxInstance.mount(mountPoint, overlay);
+
+        console.log(`[CheerpX] Streaming ${gameId} at ${mountPoint}`);
+
+        const response = await fetch(`${STREAMING.images}/${gameId}.prefetch`);
+        if (!response.ok) return -1;
+
+        return streamRequest({
+            type: 'prefetch',
+            url,
+            list: await response.text()
+        }, onProgress);
+    }
+
+    /**
+     * Start recording the reads of a game image, to make its prefetch
+     * list from a startup
+     * @param {string} gameId - Game identifier
+     */
+    function startStartupTrace(gameId) {
+        return streamRequest({ type: 'trace-start', url: gameImageUrl(gameId) });
+    }
+
+    /**
+     * Stop recording
+     * @returns {Promise<string>} The prefetch list, to be saved as
+     *                            assets/games/<gameId>.prefetch
+     */
+    function stopStartupTrace() {
+        return streamRequest({ type: 'trace-stop' });
+    }
+
+    /**
+     * Drop the cached blocks of a game image
+     * @param {string} gameId - Game identifier
+     */
+    function clearStreamedGame(gameId) {
+        return streamRequest({ type: 'clear', url: gameImageUrl(gameId) });
+    }
+
     /**
      * Get engine configuration
      * @param {string} engineId - Engine identifier ('exult' or 'pentagram')
@@ -279,6 +418,12 @@ const CheerpXEngine = (function() {
         initLinux,
         createFilesystem,
         mountGameData,
+        enableStreaming,
+        hasStreamedGame,
+        mountStreamedGame,
+        startStartupTrace,
+        stopStartupTrace,
+        clearStreamedGame,
         run,
         attachDisplay,
         attachInput,